@@ -0,0 +1,31 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include <dlfcn.h>
+
+#include <CL/cl.h>
+#include <CL/cl_ext.h>
+
+#include "lazy_init.h"
+
+// Preloaded tool library goes first in the symbol lookup, so both the
+// application and the tool come here, the call is forwarded to the ICD
+// loader
+CL_API_ENTRY cl_int CL_API_CALL clGetPlatformIDs(
+    cl_uint num_entries, cl_platform_id* platforms,
+    cl_uint* num_platforms) CL_API_SUFFIX__VERSION_1_0 {
+  LazyInit();
+
+  using ClGetPlatformIDsFunction =
+    cl_int (CL_API_CALL *)(cl_uint, cl_platform_id*, cl_uint*);
+  static ClGetPlatformIDsFunction next =
+    reinterpret_cast<ClGetPlatformIDsFunction>(
+        dlsym(RTLD_NEXT, "clGetPlatformIDs"));
+  if (next == nullptr) {
+    return CL_PLATFORM_NOT_FOUND_KHR;
+  }
+  return next(num_entries, platforms, num_platforms);
+}
\ No newline at end of file
@@ -4,6 +4,10 @@
 // SPDX-License-Identifier: MIT
 // =============================================================
 
+#include <atomic>
+#include <mutex>
+
+#include "lazy_init.h"
 #include "tool.h"
 #include "utils.h"
 
@@ -30,12 +34,47 @@ static bool IsEnabled() {
   return false;
 }
 
+#if defined(PTI_LAZY_INIT)
+
+// Driver discovery is deferred until the application makes its first
+// runtime call, so processes (e.g. MPI ranks) that never use the GPU
+// do not pay for it
+static bool lazy_init_enabled = false;
+static std::atomic<bool> lazy_init_done(false);
+static std::mutex lazy_init_lock;
+static thread_local bool lazy_init_active = false;
+
+void LazyInit() {
+  if (!lazy_init_enabled || lazy_init_active ||
+      lazy_init_done.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  const std::lock_guard<std::mutex> lock(lazy_init_lock);
+  if (lazy_init_done.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  lazy_init_active = true;
+  EnableProfiling();
+  lazy_init_active = false;
+  lazy_init_done.store(true, std::memory_order_release);
+}
+
+void __attribute__((constructor)) Load() {
+  lazy_init_enabled = IsEnabled();
+}
+
+#else
+
 void __attribute__((constructor)) Load() {
   if (IsEnabled()) {
     EnableProfiling();
   }
 }
 
+#endif
+
 void __attribute__((destructor)) Unload() {
   DisableProfiling();
 }
@@ -0,0 +1,14 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_SAMPLES_LOADER_LAZY_INIT_H_
+#define PTI_SAMPLES_LOADER_LAZY_INIT_H_
+
+// Enables profiling on the first intercepted runtime call, nested calls
+// made by the tool itself during initialization are passed through
+void LazyInit();
+
+#endif  // PTI_SAMPLES_LOADER_LAZY_INIT_H_
\ No newline at end of file
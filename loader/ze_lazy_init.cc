@@ -0,0 +1,25 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include <dlfcn.h>
+
+#include <level_zero/ze_api.h>
+
+#include "lazy_init.h"
+
+// Preloaded tool library goes first in the symbol lookup, so both the
+// application and the tool come here, the call is forwarded to the loader
+ZE_APIEXPORT ze_result_t ZE_APICALL zeInit(ze_init_flags_t flags) {
+  LazyInit();
+
+  using ZeInitFunction = ze_result_t (ZE_APICALL *)(ze_init_flags_t);
+  static ZeInitFunction next =
+    reinterpret_cast<ZeInitFunction>(dlsym(RTLD_NEXT, "zeInit"));
+  if (next == nullptr) {
+    return ZE_RESULT_ERROR_UNINITIALIZED;
+  }
+  return next(flags);
+}
\ No newline at end of file
@@ -13,12 +13,15 @@
 #include <iomanip>
 #include <map>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include "cl_api_tracer.h"
 #include "cl_utils.h"
 #include "igc_binary_decoder.h"
 #include "gen_symbols_decoder.h"
+#include "kernel_binary_cache.h"
+#include "line_info_index.h"
 
 #define CL_PROGRAM_DEBUG_INFO_SIZES_INTEL 0x4101
 #define CL_PROGRAM_DEBUG_INFO_INTEL       0x4100
@@ -71,6 +74,9 @@ class ClDebugInfoCollector {
     if (tracer_ != nullptr) {
       delete tracer_;
     }
+    if (cache_ != nullptr) {
+      delete cache_;
+    }
   }
 
   void DisableTracing() {
@@ -111,31 +117,25 @@ class ClDebugInfoCollector {
       kernel_debug_info.source_info_list;
     PTI_ASSERT(source_info_list.size() > 0);
 
-    // Print instructions with no corresponding file
-    std::cerr << "=== File: Unknown ===" << std::endl;
+    // Each instruction is resolved once, then grouped by file and line
+    LineInfoIndex line_index(line_info, last_instruction_address);
+    std::vector<const Instruction*> unknown_list;
+    std::map< std::pair<uint32_t, uint32_t>,
+              std::vector<const Instruction*> > line_map;
     for (auto& instruction : instruction_list) {
-      bool found = false;
-
-      for (size_t l = 0; l < line_info.size(); ++l) {
-        int start_address = line_info[l].address;
-        int end_address = (l + 1 < line_info.size()) ?
-                          line_info[l + 1].address :
-                          last_instruction_address;
-
-        if (instruction.offset >= start_address &&
-            instruction.offset < end_address) {
-          found = true;
-          break;
-        }
+      const LineInfo* info = line_index.Find(instruction.offset);
+      if (info == nullptr) {
+        unknown_list.push_back(&instruction);
+      } else {
+        line_map[std::make_pair(info->file, info->line)].push_back(
+            &instruction);
       }
+    }
 
-      if (!found) {
-        std::cerr << "\t\t[" << "0x" << std::setw(5) <<
-          std::setfill('0') << std::hex << std::uppercase <<
-          instruction.offset << "] " << instruction.text;
-        callback(instruction.offset, callback_data);
-        std::cerr << std::endl;
-      }
+    // Print instructions with no corresponding file
+    std::cerr << "=== File: Unknown ===" << std::endl;
+    for (auto instruction : unknown_list) {
+      PrintInstruction(*instruction, callback, callback_data);
     }
 
     // Print info per file
@@ -147,24 +147,10 @@ class ClDebugInfoCollector {
       PTI_ASSERT(line_list.size() > 0);
 
       // Print instructions with no corresponding source line
-      for (size_t l = 0; l < line_info.size(); ++l) {
-        if (line_info[l].line == 0) {
-          int start_address = line_info[l].address;
-          int end_address = (l + 1 < line_info.size()) ?
-                            line_info[l + 1].address :
-                            last_instruction_address;
-
-          for (auto instruction : instruction_list) {
-            if (instruction.offset >= start_address &&
-                instruction.offset < end_address &&
-                source_info.file_id == line_info[l].file) {
-              std::cerr << "\t\t[" << "0x" << std::setw(5) <<
-                std::setfill('0') << std::hex << std::uppercase <<
-                instruction.offset << "] " << instruction.text;
-              callback(instruction.offset, callback_data);
-              std::cerr << std::endl;
-            }
-          }
+      auto it = line_map.find(std::make_pair(source_info.file_id, 0u));
+      if (it != line_map.end()) {
+        for (auto instruction : it->second) {
+          PrintInstruction(*instruction, callback, callback_data);
         }
       }
 
@@ -173,24 +159,10 @@ class ClDebugInfoCollector {
         std::cerr << "[" << std::setw(5) << std::setfill(' ') << std::dec <<
           line.number << "] " << line.text << std::endl;
 
-        for (size_t l = 0; l < line_info.size(); ++l) {
-          if (line_info[l].line == line.number) {
-            int start_address = line_info[l].address;
-            int end_address = (l + 1 < line_info.size()) ?
-                              line_info[l + 1].address :
-                              last_instruction_address;
-
-            for (auto instruction : instruction_list) {
-              if (instruction.offset >= start_address &&
-                  instruction.offset < end_address &&
-                  source_info.file_id == line_info[l].file) {
-                std::cerr << "\t\t[" << "0x" << std::setw(5) <<
-                  std::setfill('0') << std::hex << std::uppercase <<
-                  instruction.offset << "] " << instruction.text;
-                callback(instruction.offset, callback_data);
-                std::cerr << std::endl;
-              }
-            }
+        it = line_map.find(std::make_pair(source_info.file_id, line.number));
+        if (it != line_map.end()) {
+          for (auto instruction : it->second) {
+            PrintInstruction(*instruction, callback, callback_data);
           }
         }
       }
@@ -200,7 +172,18 @@ class ClDebugInfoCollector {
   }
 
  private: // Implementation Details
-  ClDebugInfoCollector(cl_device_id device) : device_(device) {
+  static void PrintInstruction(
+      const Instruction& instruction,
+      decltype(InstructionCallback)* callback, void* callback_data) {
+    std::cerr << "\t\t[" << "0x" << std::setw(5) <<
+      std::setfill('0') << std::hex << std::uppercase <<
+      instruction.offset << "] " << instruction.text;
+    callback(instruction.offset, callback_data);
+    std::cerr << std::endl;
+  }
+
+  ClDebugInfoCollector(cl_device_id device)
+      : device_(device), cache_(KernelBinaryCache::Create()) {
     PTI_ASSERT(device_ != nullptr);
   }
 
@@ -383,6 +366,52 @@ class ClDebugInfoCollector {
     return debug_symbols;
   }
 
+  static bool DecodeKernel(cl_kernel kernel, cl_device_id device,
+                           const std::string& kernel_name,
+                           const std::vector<uint8_t>& binary,
+                           KernelBinaryEntry* entry) {
+    PTI_ASSERT(kernel != nullptr);
+    PTI_ASSERT(device != nullptr);
+    PTI_ASSERT(entry != nullptr);
+
+    PTI_ASSERT(binary.size() < (std::numeric_limits<uint32_t>::max)());
+    ElfParser elf_parser(
+        binary.data(), static_cast<uint32_t>(binary.size()));
+    std::vector<uint8_t> igc_binary = elf_parser.GetGenBinary();
+    if (igc_binary.size() == 0) {
+      std::cerr << "[WARNING] Unable to get GEN binary" << std::endl;
+      return false;
+    }
+
+    IgcBinaryDecoder binary_decoder(igc_binary);
+    entry->instruction_list = binary_decoder.Disassemble(kernel_name);
+    if (entry->instruction_list.size() == 0) {
+      std::cerr << "[WARNING] Unable to decode kernel binary" << std::endl;
+      return false;
+    }
+
+    std::vector<uint8_t> symbols = GetDebugSymbols(kernel, device);
+    if (symbols.size() == 0) {
+      std::cerr << "[WARNING] Kernel symbols are not found" << std::endl;
+      return false;
+    }
+
+    GenSymbolsDecoder symbols_decoder(symbols);
+    entry->file_list = symbols_decoder.GetFileList(kernel_name);
+    if (entry->file_list.size() == 0) {
+      std::cerr << "[WARNING] Unable to find source files" << std::endl;
+      return false;
+    }
+
+    entry->line_info_list = symbols_decoder.GetLineInfo(kernel_name);
+    if (entry->line_info_list.size() == 0) {
+      std::cerr << "[WARNING] Unable to find kernel symbols" << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
  private: // Callbacks
 
   static void OnEnterBuildProgram(cl_callback_data* data) {
@@ -441,43 +470,18 @@ class ClDebugInfoCollector {
       return;
     }
 
-    PTI_ASSERT(binary.size() < (std::numeric_limits<uint32_t>::max)());
-    ElfParser elf_parser(
-        binary.data(), static_cast<uint32_t>(binary.size()));
-    std::vector<uint8_t> igc_binary = elf_parser.GetGenBinary();
-    if (igc_binary.size() == 0) {
-      std::cerr << "[WARNING] Unable to get GEN binary" << std::endl;
-      return;
-    }
-
-    IgcBinaryDecoder binary_decoder(igc_binary);
-    std::vector<Instruction> instruction_list =
-      binary_decoder.Disassemble(kernel_name);
-    if (instruction_list.size() == 0) {
-      std::cerr << "[WARNING] Unable to decode kernel binary" << std::endl;
-      return;
-    }
-
-    std::vector<uint8_t> symbols = GetDebugSymbols(*kernel, device);
-    if (symbols.size() == 0) {
-      std::cerr << "[WARNING] Kernel symbols are not found" << std::endl;
-      return;
-    }
-
-    GenSymbolsDecoder symbols_decoder(symbols);
-    std::vector<std::string> file_list =
-      symbols_decoder.GetFileList(kernel_name);
-    if (file_list.size() == 0) {
-      std::cerr << "[WARNING] Unable to find source files" << std::endl;
-      return;
+    KernelBinaryEntry entry;
+    uint64_t key = KernelBinaryCache::GetKey(binary, kernel_name);
+    if (collector->cache_ == nullptr || !collector->cache_->Load(key, &entry)) {
+      if (!DecodeKernel(*kernel, device, kernel_name, binary, &entry)) {
+        return;
+      }
+      if (collector->cache_ != nullptr) {
+        collector->cache_->Store(key, entry);
+      }
     }
 
-    std::vector<LineInfo> line_info_list =
-      symbols_decoder.GetLineInfo(kernel_name);
-    if (line_info_list.size() == 0) {
-      std::cerr << "[WARNING] Unable to find kernel symbols" << std::endl;
-      return;
-    }
+    const std::vector<std::string>& file_list = entry.file_list;
 
     std::vector<SourceFileInfo> source_info_list;
     for (size_t i = 0; i < file_list.size(); ++i) {
@@ -502,7 +506,8 @@ class ClDebugInfoCollector {
     }
 
     collector->AddKernel(
-        kernel_name, instruction_list, line_info_list, source_info_list);
+        kernel_name, entry.instruction_list, entry.line_info_list,
+        source_info_list);
   }
 
   static void Callback(
@@ -525,6 +530,7 @@ class ClDebugInfoCollector {
  private: // Data
   ClApiTracer* tracer_ = nullptr;
   cl_device_id device_ = nullptr;
+  KernelBinaryCache* cache_ = nullptr;
 
   std::mutex lock_;
   KernelDebugInfoMap kernel_debug_info_map_;
@@ -0,0 +1,254 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_SAMPLES_GPU_HOTSPOTS_HOTSPOT_REPORT_H_
+#define PTI_SAMPLES_GPU_HOTSPOTS_HOTSPOT_REPORT_H_
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gpu_inst_count_collector.h"
+#include "line_info_index.h"
+#include "ze_debug_info_collector.h"
+
+#define HOTSPOT_MAX_LINES  20
+#define HOTSPOT_MAX_BLOCKS 20
+
+struct BlockHotspot {
+  int32_t offset;
+  uint32_t instruction_count;
+  uint64_t execution_count; // Per kernel run
+  uint32_t first_line;
+  uint32_t last_line;
+};
+
+struct LineHotspot {
+  uint32_t file;
+  uint32_t line;
+  uint64_t instruction_count; // Executed per kernel run
+};
+
+// Joins GTPin basic block counters with the line table of the kernel:
+// each executed instruction is attributed to its source line through
+// LineInfoIndex, both tables are sorted by executed instructions
+class HotspotReport {
+ public:
+  static void Print(const KernelDataMap& kernel_data_map,
+                    const KernelDebugInfoMap* debug_info_map) {
+    iga_gen_t arch = utils::gtpin::GetArch(GTPin_GetGenVersion());
+    if (arch == IGA_GEN_INVALID) {
+      std::cerr << "[WARNING] Unknown GPU architecture" << std::endl;
+      return;
+    }
+
+    KernelBinaryCache* cache = KernelBinaryCache::Create();
+    for (auto& data : kernel_data_map) {
+      if (data.second.call_count == 0) {
+        continue;
+      }
+
+      KernelBinaryEntry entry;
+      uint64_t key = KernelBinaryCache::GetKey(
+          data.second.binary, data.second.name);
+      if (cache == nullptr || !cache->Load(key, &entry)) {
+        GenBinaryDecoder decoder(data.second.binary, arch);
+        entry.instruction_list = decoder.Disassemble();
+        if (cache != nullptr) {
+          cache->Store(key, entry);
+        }
+      }
+      PTI_ASSERT(entry.instruction_list.size() > 0);
+
+      const KernelDebugInfo* debug_info = nullptr;
+      if (debug_info_map != nullptr) {
+        auto it = debug_info_map->find(data.second.name);
+        if (it != debug_info_map->end()) {
+          debug_info = &(it->second);
+        }
+      }
+
+      PrintKernel(data.second, entry.instruction_list, debug_info);
+    }
+
+    if (cache != nullptr) {
+      delete cache;
+    }
+  }
+
+ private:
+  static void PrintKernel(const KernelData& kernel_data,
+                          const std::vector<Instruction>& instruction_list,
+                          const KernelDebugInfo* debug_info) {
+    PTI_ASSERT(kernel_data.call_count > 0);
+    PTI_ASSERT(kernel_data.block_map.size() > 0);
+
+    std::vector<BlockHotspot> block_list;
+    for (auto& block : kernel_data.block_map) {
+      block_list.push_back({block.first, 0,
+          block.second / kernel_data.call_count, 0, 0});
+    }
+
+    LineInfoIndex line_index(
+        (debug_info != nullptr) ?
+          debug_info->line_info_list : std::vector<LineInfo>(),
+        instruction_list.back().offset + 1);
+
+    std::map< std::pair<uint32_t, uint32_t>, uint64_t > line_map;
+    uint64_t total = 0;
+    size_t block_id = 0;
+    for (auto& instruction : instruction_list) {
+      while (block_id + 1 < block_list.size() &&
+             instruction.offset >= block_list[block_id + 1].offset) {
+        ++block_id;
+      }
+
+      BlockHotspot& block = block_list[block_id];
+      ++block.instruction_count;
+      total += block.execution_count;
+
+      const LineInfo* line_info = line_index.Find(instruction.offset);
+      if (line_info == nullptr) {
+        line_map[std::make_pair(0u, 0u)] += block.execution_count;
+        continue;
+      }
+
+      line_map[std::make_pair(line_info->file, line_info->line)] +=
+        block.execution_count;
+      if (line_info->line > 0) {
+        if (block.first_line == 0 || line_info->line < block.first_line) {
+          block.first_line = line_info->line;
+        }
+        block.last_line = (std::max)(block.last_line, line_info->line);
+      }
+    }
+
+    std::stringstream stream;
+    stream << "=== " << kernel_data.name << " (runs " <<
+      kernel_data.call_count << " times, " << total <<
+      " instructions per run) ===";
+    std::cerr << stream.str() << std::endl;
+
+    if (total == 0) {
+      std::cerr << std::endl;
+      return;
+    }
+
+    if (debug_info != nullptr) {
+      std::vector<LineHotspot> line_list;
+      for (auto& line : line_map) {
+        line_list.push_back({line.first.first, line.first.second,
+                             line.second});
+      }
+      PrintLines(line_list, total, *debug_info);
+    }
+
+    PrintBlocks(block_list, total);
+
+    std::cerr << std::endl;
+  }
+
+  static void PrintLines(std::vector<LineHotspot>& line_list, uint64_t total,
+                         const KernelDebugInfo& debug_info) {
+    std::sort(line_list.begin(), line_list.end(),
+        [](const LineHotspot& left, const LineHotspot& right) {
+          return left.instruction_count > right.instruction_count;
+        });
+
+    std::cerr << "== Source Lines: ==" << std::endl;
+    std::cerr << std::setw(20) << "Instructions" << "," <<
+      std::setw(10) << "Share(%)" << "," << " Location" << std::endl;
+
+    for (size_t i = 0; i < line_list.size() && i < HOTSPOT_MAX_LINES; ++i) {
+      const LineHotspot& line = line_list[i];
+      if (line.instruction_count == 0) {
+        break;
+      }
+      std::cerr << std::setw(20) << line.instruction_count << "," <<
+        std::setw(10) << std::fixed << std::setprecision(2) <<
+        100.0 * line.instruction_count / total << ", " <<
+        GetLocation(debug_info, line.file, line.line) << std::endl;
+    }
+  }
+
+  static void PrintBlocks(std::vector<BlockHotspot>& block_list,
+                          uint64_t total) {
+    std::sort(block_list.begin(), block_list.end(),
+        [](const BlockHotspot& left, const BlockHotspot& right) {
+          return left.execution_count * left.instruction_count >
+                 right.execution_count * right.instruction_count;
+        });
+
+    std::cerr << "== Basic Blocks: ==" << std::endl;
+    std::cerr << std::setw(10) << "Offset" << "," <<
+      std::setw(14) << "Instructions" << "," <<
+      std::setw(14) << "Executions" << "," <<
+      std::setw(20) << "Total" << "," <<
+      std::setw(10) << "Share(%)" << "," << " Lines" << std::endl;
+
+    for (size_t i = 0; i < block_list.size() && i < HOTSPOT_MAX_BLOCKS; ++i) {
+      const BlockHotspot& block = block_list[i];
+      uint64_t block_total = block.execution_count * block.instruction_count;
+      if (block_total == 0) {
+        break;
+      }
+
+      std::stringstream offset;
+      offset << "0x" << std::setw(4) << std::setfill('0') << std::hex <<
+        std::uppercase << block.offset;
+
+      std::cerr << std::setw(10) << offset.str() << "," <<
+        std::setw(14) << block.instruction_count << "," <<
+        std::setw(14) << block.execution_count << "," <<
+        std::setw(20) << block_total << "," <<
+        std::setw(10) << std::fixed << std::setprecision(2) <<
+        100.0 * block_total / total << ", ";
+      if (block.first_line > 0) {
+        std::cerr << block.first_line;
+        if (block.last_line > block.first_line) {
+          std::cerr << "-" << block.last_line;
+        }
+      } else {
+        std::cerr << "Unknown";
+      }
+      std::cerr << std::endl;
+    }
+  }
+
+  static std::string GetLocation(const KernelDebugInfo& debug_info,
+                                 uint32_t file, uint32_t line) {
+    if (file == 0) {
+      return "Unknown";
+    }
+
+    for (auto& source_info : debug_info.source_info_list) {
+      if (source_info.file_id != file) {
+        continue;
+      }
+
+      std::string location = source_info.file_name + ":" +
+        std::to_string(line);
+      for (auto& source_line : source_info.source_line_list) {
+        if (source_line.number == line) {
+          size_t start = source_line.text.find_first_not_of(" \t");
+          if (start != std::string::npos) {
+            location += " " + source_line.text.substr(start);
+          }
+          break;
+        }
+      }
+      return location;
+    }
+
+    return "File " + std::to_string(file) + ":" + std::to_string(line);
+  }
+};
+
+#endif // PTI_SAMPLES_GPU_HOTSPOTS_HOTSPOT_REPORT_H_
\ No newline at end of file
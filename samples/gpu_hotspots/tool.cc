@@ -0,0 +1,85 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include "hotspot_report.h"
+
+static GpuInstCountCollector* count_collector = nullptr;
+static ZeDebugInfoCollector* debug_info_collector = nullptr;
+
+// External Tool Interface ////////////////////////////////////////////////////
+
+extern "C"
+#if defined(_WIN32)
+__declspec(dllexport)
+#endif
+void Usage() {
+  std::cout <<
+    "Usage: ./gpu_hotspots[.exe] <application> <args>" <<
+    std::endl;
+}
+
+extern "C"
+#if defined(_WIN32)
+__declspec(dllexport)
+#endif
+int ParseArgs(int argc, char* argv[]) {
+  return 1;
+}
+
+extern "C"
+#if defined(_WIN32)
+__declspec(dllexport)
+#endif
+void SetToolEnv() {
+  utils::SetEnv("ZE_ENABLE_TRACING_LAYER", "1");
+  utils::SetEnv("ZET_ENABLE_API_TRACING_EXP", "1");
+  utils::SetEnv("ZET_ENABLE_PROGRAM_INSTRUMENTATION", "1");
+}
+
+// Internal Tool Functionality ////////////////////////////////////////////////
+
+static void PrintResults() {
+  PTI_ASSERT(count_collector != nullptr);
+
+  const KernelDataMap& kernel_data_map = count_collector->GetKernelDataMap();
+  if (kernel_data_map.size() == 0) {
+    std::cerr << "[WARNING] No kernels were collected" << std::endl;
+    return;
+  }
+
+  std::cerr << std::endl;
+  HotspotReport::Print(
+      kernel_data_map,
+      (debug_info_collector != nullptr) ?
+        &(debug_info_collector->GetKernelDebugInfoMap()) : nullptr);
+}
+
+// Internal Tool Interface ////////////////////////////////////////////////////
+
+void EnableProfiling() {
+  PTI_ASSERT(count_collector == nullptr);
+  count_collector = GpuInstCountCollector::Create();
+
+  // Source lines are only known for Level Zero modules
+  ze_result_t status = ZE_RESULT_SUCCESS;
+  status = zeInit(ZE_INIT_FLAG_GPU_ONLY);
+  if (status == ZE_RESULT_SUCCESS) {
+    debug_info_collector = ZeDebugInfoCollector::Create();
+  }
+}
+
+void DisableProfiling() {
+  if (debug_info_collector != nullptr) {
+    debug_info_collector->DisableTracing();
+  }
+  if (count_collector != nullptr) {
+    PrintResults();
+    delete count_collector;
+  }
+  if (debug_info_collector != nullptr) {
+    delete debug_info_collector;
+  }
+}
\ No newline at end of file
@@ -7,15 +7,20 @@
 #ifndef PTI_SAMPLES_GPU_INST_COUNT_GPU_INST_COUNT_COLLECTOR_H_
 #define PTI_SAMPLES_GPU_INST_COUNT_GPU_INST_COUNT_COLLECTOR_H_
 
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <vector>
 
 #include "gen_binary_decoder.h"
+#include "gtpin_kernel_selector.h"
+#include "gtpin_readback.h"
 #include "gtpin_utils.h"
+#include "kernel_binary_cache.h"
 
 struct KernelData {
   std::string name;
@@ -24,12 +29,18 @@ struct KernelData {
   std::map<int32_t, uint64_t> block_map;
 };
 
-struct MemoryLocation {
-  int32_t offset;
-  GTPinMem location;
+// Per-kernel counters are laid out densely by block ordinal at build time,
+// so GTPin buffers are summed into them with no lookups by offset and no
+// global lock
+struct KernelCounters {
+  KernelData kernel_data; // Block values are filled on results request
+  std::vector<int32_t> offset_list;
+  std::vector<GTPinMem> memory_list;
+  std::unique_ptr<std::atomic<uint64_t>[]> value_list;
+  std::atomic<uint32_t> call_count{0};
 };
 
-using KernelMemoryMap = std::map< GTPinKernel, std::vector<MemoryLocation> >;
+using KernelCountersMap = std::map<GTPinKernel, KernelCounters*>;
 using KernelDataMap = std::map<GTPinKernel, KernelData>;
 
 class GpuInstCountCollector {
@@ -38,10 +49,35 @@ class GpuInstCountCollector {
     return new GpuInstCountCollector();
   }
 
-  ~GpuInstCountCollector() {}
+  ~GpuInstCountCollector() {
+    if (readback_ != nullptr) {
+      delete readback_;
+    }
+    for (auto& counters : kernel_counters_map_) {
+      delete counters.second;
+    }
+  }
+
+  KernelDataMap GetKernelDataMap() const {
+    PTI_ASSERT(readback_ != nullptr);
+    readback_->Flush();
 
-  const KernelDataMap& GetKernelDataMap() const {
-    return kernel_data_map_;
+    KernelDataMap kernel_data_map;
+    const std::lock_guard<std::mutex> lock(lock_);
+    for (auto& counters : kernel_counters_map_) {
+      const KernelCounters* kernel_counters = counters.second;
+      PTI_ASSERT(kernel_counters != nullptr);
+
+      KernelData& kernel_data = kernel_data_map[counters.first];
+      kernel_data = kernel_counters->kernel_data;
+      kernel_data.call_count =
+        kernel_counters->call_count.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < kernel_counters->offset_list.size(); ++i) {
+        kernel_data.block_map[kernel_counters->offset_list[i]] =
+          kernel_counters->value_list[i].load(std::memory_order_relaxed);
+      }
+    }
+    return kernel_data_map;
   }
 
   static void PrintResults(const KernelDataMap& kernel_data_map) {
@@ -55,6 +91,7 @@ class GpuInstCountCollector {
       return;
     }
 
+    KernelBinaryCache* cache = KernelBinaryCache::Create();
     for (auto data : kernel_data_map) {
       if (data.second.call_count == 0) {
         continue;
@@ -67,9 +104,19 @@ class GpuInstCountCollector {
       std::string epilogue(prologue.size(), '=');
       std::cerr << prologue << std::endl;
 
-      GenBinaryDecoder decoder(data.second.binary, arch);
+      KernelBinaryEntry entry;
+      uint64_t key = KernelBinaryCache::GetKey(
+          data.second.binary, data.second.name);
+      if (cache == nullptr || !cache->Load(key, &entry)) {
+        GenBinaryDecoder decoder(data.second.binary, arch);
+        entry.instruction_list = decoder.Disassemble();
+        if (cache != nullptr) {
+          cache->Store(key, entry);
+        }
+      }
 
-      std::vector<Instruction> instruction_list = decoder.Disassemble();
+      const std::vector<Instruction>& instruction_list =
+        entry.instruction_list;
       PTI_ASSERT(instruction_list.size() > 0);
 
       std::vector< std::pair<int32_t, uint64_t> > block_list;
@@ -95,10 +142,17 @@ class GpuInstCountCollector {
 
       std::cerr << std::endl;
     }
+
+    if (cache != nullptr) {
+      delete cache;
+    }
   }
 
  private: // Implementation Details
   GpuInstCountCollector() {
+    readback_ = GTPinReadback::Create(sizeof(uint32_t), OnSnapshot, this);
+    PTI_ASSERT(readback_ != nullptr);
+
     utils::gtpin::KnobAddBool("silent_warnings", false);
 
     GTPin_OnKernelBuild(OnKernelBuild, this);
@@ -108,51 +162,44 @@ class GpuInstCountCollector {
     GTPIN_Start();
   }
 
-  void AddKernelMemoryList(
-      GTPinKernel kernel,
-      const std::vector<MemoryLocation>& kernel_memory_list) {
-    PTI_ASSERT(kernel_memory_list.size() > 0);
+  void AddKernelCounters(GTPinKernel kernel, KernelCounters* counters) {
+    PTI_ASSERT(counters != nullptr);
+    PTI_ASSERT(counters->offset_list.size() > 0);
     const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(kernel_memory_map_.count(kernel) == 0);
-    kernel_memory_map_[kernel] = kernel_memory_list;
+    PTI_ASSERT(kernel_counters_map_.count(kernel) == 0);
+    kernel_counters_map_[kernel] = counters;
   }
 
-  std::vector<MemoryLocation> GetKernelMemoryList(GTPinKernel kernel) {
+  // Counters are never removed before the collector is destroyed, so the
+  // pointer stays valid without the lock
+  KernelCounters* GetKernelCounters(GTPinKernel kernel) const {
     const std::lock_guard<std::mutex> lock(lock_);
-    auto it = kernel_memory_map_.find(kernel);
-    if (it == kernel_memory_map_.end()) {
-      return std::vector<MemoryLocation>();
+    auto it = kernel_counters_map_.find(kernel);
+    if (it == kernel_counters_map_.end()) {
+      return nullptr;
     }
     return it->second;
   }
 
-  void AddKernelData(GTPinKernel kernel, const KernelData& kernel_data) {
-    const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(kernel_data_map_.count(kernel) == 0);
-    kernel_data_map_[kernel] = kernel_data;
-  }
-
-  void AppendKernelBlockValue(
-      GTPinKernel kernel, int32_t offset, uint64_t value) {
-    PTI_ASSERT(offset >= 0);
-    const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(kernel_data_map_.count(kernel) == 1);
-    PTI_ASSERT(kernel_data_map_[kernel].block_map.count(offset) == 1);
-    kernel_data_map_[kernel].block_map[offset] += value;
-  }
-
-  void AppendKernelCallCount(GTPinKernel kernel, uint32_t call_count) {
-    const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(kernel_data_map_.count(kernel) == 1);
-    kernel_data_map_[kernel].call_count += call_count;
-  }
-
  private: // Callbacks
   static void OnKernelBuild(GTPinKernel kernel, void* data) {
     GTPINTOOL_STATUS status = GTPINTOOL_STATUS_SUCCESS;
 
-    std::vector<MemoryLocation> kernel_memory_list;
-    KernelData kernel_data{};
+    GpuInstCountCollector* collector =
+      reinterpret_cast<GpuInstCountCollector*>(data);
+    PTI_ASSERT(collector != nullptr);
+
+    char kernel_name[MAX_STR_SIZE];
+    status = GTPin_KernelGetName(kernel, MAX_STR_SIZE, kernel_name, nullptr);
+    PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+
+    if (!collector->selector_.OnBuild(kernel, kernel_name)) {
+      return;
+    }
+
+    KernelCounters* counters = new KernelCounters;
+    PTI_ASSERT(counters != nullptr);
+    KernelData& kernel_data = counters->kernel_data;
 
     for (GTPinBBL block = GTPin_BBLHead(kernel); GTPin_BBLValid(block);
          block = GTPin_BBLNext(block)) {
@@ -168,10 +215,14 @@ class GpuInstCountCollector {
       status = GTPin_OpcodeprofInstrument(head, mem);
       PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
 
-      kernel_memory_list.push_back({offset, mem});
+      counters->offset_list.push_back(offset);
+      counters->memory_list.push_back(mem);
+    }
 
-      PTI_ASSERT(kernel_data.block_map.count(offset) == 0);
-      kernel_data.block_map[offset] = 0;
+    size_t block_count = counters->offset_list.size();
+    counters->value_list.reset(new std::atomic<uint64_t>[block_count]);
+    for (size_t i = 0; i < block_count; ++i) {
+      counters->value_list[i].store(0, std::memory_order_relaxed);
     }
 
     uint32_t kernel_binary_size = 0;
@@ -185,59 +236,67 @@ class GpuInstCountCollector {
         reinterpret_cast<char*>(kernel_data.binary.data()), nullptr);
     PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
 
-    char kernel_name[MAX_STR_SIZE];
-    status = GTPin_KernelGetName(kernel, MAX_STR_SIZE, kernel_name, nullptr);
-    PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
-
     kernel_data.name = kernel_name;
     kernel_data.call_count = 0;
 
-    GpuInstCountCollector* collector =
-      reinterpret_cast<GpuInstCountCollector*>(data);
-    PTI_ASSERT(collector != nullptr);
-
-    collector->AddKernelMemoryList(kernel, kernel_memory_list);
-    collector->AddKernelData(kernel, kernel_data);
+    collector->AddKernelCounters(kernel, counters);
   }
 
   static void OnKernelRun(GTPinKernelExec kernel_exec, void* data) {
-    GTPINTOOL_STATUS status = GTPINTOOL_STATUS_SUCCESS;
-    GTPin_KernelProfilingActive(kernel_exec, 1);
-    PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+    GpuInstCountCollector* collector =
+      reinterpret_cast<GpuInstCountCollector*>(data);
+    PTI_ASSERT(collector != nullptr);
+    collector->selector_.OnRun(kernel_exec);
   }
 
   static void OnKernelComplete(GTPinKernelExec kernel_exec, void* data) {
-    GTPINTOOL_STATUS status = GTPINTOOL_STATUS_SUCCESS;
-
     GpuInstCountCollector* collector =
       reinterpret_cast<GpuInstCountCollector*>(data);
     PTI_ASSERT(collector != nullptr);
 
+    if (!collector->selector_.OnComplete(kernel_exec)) {
+      return;
+    }
+
     GTPinKernel kernel = GTPin_KernelExec_GetKernel(kernel_exec);
+    KernelCounters* counters = collector->GetKernelCounters(kernel);
+    if (counters == nullptr) {
+      return;
+    }
 
-    for (auto block : collector->GetKernelMemoryList(kernel)) {
-      uint32_t thread_count = GTPin_MemSampleLength(block.location);
-      PTI_ASSERT(thread_count > 0);
-
-      uint32_t total = 0, value = 0;
-      for (uint32_t tid = 0; tid < thread_count; ++tid) {
-          status = GTPin_MemRead(
-              block.location, tid, sizeof(uint32_t),
-              reinterpret_cast<char*>(&value), nullptr);
-          PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
-          total += value;
+    collector->readback_->Enqueue(counters, counters->memory_list);
+  }
+
+  // Called on readback thread
+  static void OnSnapshot(const GTPinSnapshot& snapshot, void* data) {
+    KernelCounters* counters =
+      reinterpret_cast<KernelCounters*>(snapshot.owner);
+    PTI_ASSERT(counters != nullptr);
+    PTI_ASSERT(snapshot.thread_count_list.size() ==
+               counters->offset_list.size());
+
+    const uint32_t* value =
+      reinterpret_cast<const uint32_t*>(snapshot.data.data());
+    for (size_t i = 0; i < snapshot.thread_count_list.size(); ++i) {
+      uint64_t total = 0;
+      for (uint32_t tid = 0; tid < snapshot.thread_count_list[i]; ++tid) {
+        total += value[tid];
       }
+      value += snapshot.thread_count_list[i];
 
-      collector->AppendKernelBlockValue(kernel, block.offset, total);
+      if (total > 0) {
+        counters->value_list[i].fetch_add(total, std::memory_order_relaxed);
+      }
     }
 
-    collector->AppendKernelCallCount(kernel, 1);
+    counters->call_count.fetch_add(1, std::memory_order_relaxed);
   }
 
  private: // Data
-  KernelMemoryMap kernel_memory_map_;
-  KernelDataMap kernel_data_map_;
-  std::mutex lock_;
+  KernelCountersMap kernel_counters_map_;
+  mutable std::mutex lock_;
+  GTPinReadback* readback_ = nullptr;
+  GTPinKernelSelector selector_;
 };
 
 #endif // PTI_SAMPLES_GPU_INST_COUNT_GPU_INST_COUNT_COLLECTOR_H_
\ No newline at end of file
@@ -15,7 +15,10 @@
 #include <vector>
 
 #include "gen_binary_decoder.h"
+#include "gtpin_kernel_selector.h"
+#include "gtpin_readback.h"
 #include "gtpin_utils.h"
+#include "kernel_binary_cache.h"
 
 struct PerfMonData {
   uint32_t freq;
@@ -36,12 +39,13 @@ struct KernelData {
   std::map<int32_t, PerfMonValue> block_map;
 };
 
-struct MemoryLocation {
-  int32_t offset;
-  GTPinMem location;
+struct KernelMemory {
+  GTPinKernel kernel;
+  std::vector<int32_t> offset_list;
+  std::vector<GTPinMem> memory_list;
 };
 
-using KernelMemoryMap = std::map< GTPinKernel, std::vector<MemoryLocation> >;
+using KernelMemoryMap = std::map<GTPinKernel, KernelMemory>;
 using KernelDataMap = std::map<GTPinKernel, KernelData>;
 
 class GpuPerfMonCollector {
@@ -50,9 +54,15 @@ class GpuPerfMonCollector {
     return new GpuPerfMonCollector();
   }
 
-  ~GpuPerfMonCollector() {}
+  ~GpuPerfMonCollector() {
+    if (readback_ != nullptr) {
+      delete readback_;
+    }
+  }
 
   const KernelDataMap& GetKernelDataMap() const {
+    PTI_ASSERT(readback_ != nullptr);
+    readback_->Flush();
     return kernel_data_map_;
   }
 
@@ -67,15 +77,25 @@ class GpuPerfMonCollector {
       return;
     }
 
+    KernelBinaryCache* cache = KernelBinaryCache::Create();
     for (auto data : kernel_data_map) {
       if (data.second.call_count == 0) {
         continue;
       }
 
-      GenBinaryDecoder decoder(data.second.binary, arch);
+      KernelBinaryEntry entry;
+      uint64_t key = KernelBinaryCache::GetKey(
+          data.second.binary, data.second.name);
+      if (cache == nullptr || !cache->Load(key, &entry)) {
+        GenBinaryDecoder decoder(data.second.binary, arch);
+        entry.instruction_list = decoder.Disassemble();
+        if (cache != nullptr) {
+          cache->Store(key, entry);
+        }
+      }
 
-      std::vector<Instruction> instruction_list =
-        decoder.Disassemble();
+      const std::vector<Instruction>& instruction_list =
+        entry.instruction_list;
       PTI_ASSERT(instruction_list.size() > 0);
 
       std::vector< std::pair<int32_t, PerfMonValue> > block_list;
@@ -130,10 +150,17 @@ class GpuPerfMonCollector {
         std::fixed << 100.0f * total_pm / total_cycles << "%" << std::endl;
       std::cerr << std::endl;
     }
+
+    if (cache != nullptr) {
+      delete cache;
+    }
   }
 
  private: // Implementation Details
   GpuPerfMonCollector() {
+    readback_ = GTPinReadback::Create(sizeof(PerfMonData), OnSnapshot, this);
+    PTI_ASSERT(readback_ != nullptr);
+
     utils::gtpin::KnobAddBool("silent_warnings", false);
     utils::gtpin::KnobAddInt("allow_sregs", 0);
     utils::gtpin::KnobAddInt("use_global_ra", 1);
@@ -145,22 +172,23 @@ class GpuPerfMonCollector {
     GTPIN_Start();
   }
 
-  void AddKernelMemoryList(
-      GTPinKernel kernel,
-      const std::vector<MemoryLocation>& kernel_memory_list) {
-    PTI_ASSERT(kernel_memory_list.size() > 0);
+  void AddKernelMemory(
+      GTPinKernel kernel, const KernelMemory& kernel_memory) {
+    PTI_ASSERT(kernel_memory.memory_list.size() > 0);
     const std::lock_guard<std::mutex> lock(lock_);
     PTI_ASSERT(kernel_memory_map_.count(kernel) == 0);
-    kernel_memory_map_[kernel] = kernel_memory_list;
+    kernel_memory_map_[kernel] = kernel_memory;
   }
 
-  std::vector<MemoryLocation> GetKernelMemoryList(GTPinKernel kernel) {
+  // Map entries are never removed, so the pointer stays valid without
+  // the lock
+  KernelMemory* GetKernelMemory(GTPinKernel kernel) {
     const std::lock_guard<std::mutex> lock(lock_);
     auto it = kernel_memory_map_.find(kernel);
     if (it == kernel_memory_map_.end()) {
-      return std::vector<MemoryLocation>();
+      return nullptr;
     }
-    return it->second;
+    return &(it->second);
   }
 
   void AddKernelData(GTPinKernel kernel, const KernelData& kernel_data) {
@@ -188,9 +216,22 @@ class GpuPerfMonCollector {
  private: // Callbacks
   static void OnKernelBuild(GTPinKernel kernel, void* data) {
     GTPINTOOL_STATUS status = GTPINTOOL_STATUS_SUCCESS;
+
+    GpuPerfMonCollector* collector =
+      reinterpret_cast<GpuPerfMonCollector*>(data);
+    PTI_ASSERT(collector != nullptr);
+
+    char kernel_name[MAX_STR_SIZE];
+    status = GTPin_KernelGetName(kernel, MAX_STR_SIZE, kernel_name, nullptr);
+    PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+
+    if (!collector->selector_.OnBuild(kernel, kernel_name)) {
+      return;
+    }
+
     uint32_t num_regs = GTPin_PerfmonAvailableRegInstrument(kernel);
 
-    std::vector<MemoryLocation> kernel_memory_list;
+    KernelMemory kernel_memory{kernel};
     KernelData kernel_data{};
 
     for (GTPinBBL block = GTPin_BBLHead(kernel); GTPin_BBLValid(block);
@@ -225,7 +266,8 @@ class GpuPerfMonCollector {
       status = GTPin_PerfmonInstrumentPost_Mem(tail, mem, num_regs);
       PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
 
-      kernel_memory_list.push_back({offset, mem});
+      kernel_memory.offset_list.push_back(offset);
+      kernel_memory.memory_list.push_back(mem);
 
       PTI_ASSERT(kernel_data.block_map.count(offset) == 0);
       kernel_data.block_map[offset] = {0, 0};
@@ -246,62 +288,78 @@ class GpuPerfMonCollector {
         nullptr);
     PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
 
-    char kernel_name[MAX_STR_SIZE];
-    status = GTPin_KernelGetName(kernel, MAX_STR_SIZE, kernel_name, nullptr);
-    PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
-
     kernel_data.name = kernel_name;
     kernel_data.call_count = 0;
 
-    GpuPerfMonCollector* collector =
-      reinterpret_cast<GpuPerfMonCollector*>(data);
-    PTI_ASSERT(collector != nullptr);
+    if (kernel_memory.memory_list.empty()) {
+      return;
+    }
 
-    collector->AddKernelMemoryList(kernel, kernel_memory_list);
+    collector->AddKernelMemory(kernel, kernel_memory);
     collector->AddKernelData(kernel, kernel_data);
   }
 
   static void OnKernelRun(GTPinKernelExec kernelExec, void* data) {
-    GTPINTOOL_STATUS status = GTPINTOOL_STATUS_SUCCESS;
-    GTPin_KernelProfilingActive(kernelExec, 1);
-    PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+    GpuPerfMonCollector* collector =
+      reinterpret_cast<GpuPerfMonCollector*>(data);
+    PTI_ASSERT(collector != nullptr);
+    collector->selector_.OnRun(kernelExec);
   }
 
   static void OnKernelComplete(GTPinKernelExec kernelExec, void* data) {
-    GTPINTOOL_STATUS status = GTPINTOOL_STATUS_SUCCESS;
-
     GpuPerfMonCollector* collector =
       reinterpret_cast<GpuPerfMonCollector*>(data);
     PTI_ASSERT(collector != nullptr);
 
+    if (!collector->selector_.OnComplete(kernelExec)) {
+      return;
+    }
+
     GTPinKernel kernel = GTPin_KernelExec_GetKernel(kernelExec);
+    KernelMemory* kernel_memory = collector->GetKernelMemory(kernel);
+    if (kernel_memory == nullptr) {
+      return;
+    }
+
+    collector->readback_->Enqueue(kernel_memory, kernel_memory->memory_list);
+  }
+
+  // Called on readback thread
+  static void OnSnapshot(const GTPinSnapshot& snapshot, void* data) {
+    GpuPerfMonCollector* collector =
+      reinterpret_cast<GpuPerfMonCollector*>(data);
+    PTI_ASSERT(collector != nullptr);
 
-    for (auto block : collector->GetKernelMemoryList(kernel)) {
-      uint32_t thread_count = GTPin_MemSampleLength(block.location);
-      PTI_ASSERT(thread_count > 0);
+    const KernelMemory* kernel_memory =
+      reinterpret_cast<const KernelMemory*>(snapshot.owner);
+    PTI_ASSERT(kernel_memory != nullptr);
+    PTI_ASSERT(snapshot.thread_count_list.size() ==
+               kernel_memory->offset_list.size());
 
+    const PerfMonData* value =
+      reinterpret_cast<const PerfMonData*>(snapshot.data.data());
+    for (size_t i = 0; i < snapshot.thread_count_list.size(); ++i) {
       uint64_t total_cycles = 0, total_pm = 0;
-      PerfMonData value{};
-      for (uint32_t tid = 0; tid < thread_count; ++tid) {
-          status = GTPin_MemRead(
-              block.location, tid, sizeof(PerfMonData),
-              reinterpret_cast<char*>(&value), nullptr);
-          PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
-          total_cycles += value.cycles;
-          total_pm += value.pm;
+      for (uint32_t tid = 0; tid < snapshot.thread_count_list[i]; ++tid) {
+        total_cycles += value[tid].cycles;
+        total_pm += value[tid].pm;
       }
+      value += snapshot.thread_count_list[i];
 
       collector->AppendKernelBlockValue(
-          kernel, block.offset, {total_cycles, total_pm});
+          kernel_memory->kernel, kernel_memory->offset_list[i],
+          {total_cycles, total_pm});
     }
 
-    collector->AppendKernelCallCount(kernel, 1);
+    collector->AppendKernelCallCount(kernel_memory->kernel, 1);
   }
 
  private: // Data
   KernelMemoryMap kernel_memory_map_;
   KernelDataMap kernel_data_map_;
   std::mutex lock_;
+  GTPinReadback* readback_ = nullptr;
+  GTPinKernelSelector selector_;
 };
 
 #endif // PTI_SAMPLES_GPU_PERFMON_READ_GPU_INST_COUNT_COLLECTOR_H_
\ No newline at end of file
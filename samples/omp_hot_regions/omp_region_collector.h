@@ -7,12 +7,14 @@
 #ifndef PTI_SAMPLES_OMP_HOT_REGIONS_OMP_REGION_COLLECTOR_H_
 #define PTI_SAMPLES_OMP_HOT_REGIONS_OMP_REGION_COLLECTOR_H_
 
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <mutex>
 #include <set>
 #include <thread>
+#include <vector>
 
 #include "pti_assert.h"
 #include "utils.h"
@@ -31,6 +33,7 @@ struct RegionInfo {
   uint64_t max_time;
   uint64_t call_count;
   size_t bytes_transferred;
+  uint64_t self_time; // Total time without nested regions
 
   bool operator>(const RegionInfo& r) const {
     if (total_time != r.total_time) {
@@ -49,47 +52,186 @@ struct RegionInfo {
 
 using RegionMap = std::map<uint64_t, RegionInfo>;
 
-class OmpRegionCollector {
+// Regions of one thread in an open-addressing hash table with linear
+// probing, slots with zero call count are free
+class RegionTable {
  public: // Interface
-  static OmpRegionCollector* Create() {
-    return new OmpRegionCollector();
+  RegionTable() : slot_list_(kInitialCapacity) {}
+
+  void Add(uint64_t id, RegionType type, uint64_t time,
+           uint64_t self_time, size_t bytes_transferred) {
+    if (2 * (count_ + 1) > slot_list_.size()) {
+      Grow();
+    }
+
+    Slot& slot = Find(id);
+    if (slot.info.call_count == 0) {
+      slot.id = id;
+      slot.info = {type, time, time, time, 1, bytes_transferred, self_time};
+      ++count_;
+      return;
+    }
+
+    RegionInfo& region = slot.info;
+    PTI_ASSERT(region.type == type);
+    region.total_time += time;
+    if (time < region.min_time) {
+      region.min_time = time;
+    }
+    if (time > region.max_time) {
+      region.max_time = time;
+    }
+    region.call_count += 1;
+    region.bytes_transferred += bytes_transferred;
+    region.self_time += self_time;
   }
 
-  ~OmpRegionCollector() {}
+  void MergeTo(RegionMap& region_map) const {
+    for (const Slot& slot : slot_list_) {
+      if (slot.info.call_count == 0) {
+        continue;
+      }
 
-  void AddRegion(
-      uint64_t ra, RegionType type, uint64_t time, size_t bytes_transferred) {
-    const std::lock_guard<std::mutex> lock(lock_);
-    uint64_t id = ra + type;
-    if (region_map_.count(id) == 0) {
-      region_map_[id] = {type, time, time, time, 1, bytes_transferred};
-    } else {
-      RegionInfo& region = region_map_[id];
-      PTI_ASSERT(region.type == type);
-      region.total_time += time;
-      if (time < region.min_time) {
-        region.min_time = time;
+      auto it = region_map.find(slot.id);
+      if (it == region_map.end()) {
+        region_map[slot.id] = slot.info;
+        continue;
+      }
+
+      RegionInfo& region = it->second;
+      PTI_ASSERT(region.type == slot.info.type);
+      region.total_time += slot.info.total_time;
+      if (slot.info.min_time < region.min_time) {
+        region.min_time = slot.info.min_time;
+      }
+      if (slot.info.max_time > region.max_time) {
+        region.max_time = slot.info.max_time;
       }
-      if (time > region.max_time) {
-        region.max_time = time;
+      region.call_count += slot.info.call_count;
+      region.bytes_transferred += slot.info.bytes_transferred;
+      region.self_time += slot.info.self_time;
+    }
+  }
+
+ private: // Implementation Details
+  struct Slot {
+    uint64_t id;
+    RegionInfo info;
+  };
+
+  // Code pointers are aligned and close to each other, so the bits are
+  // mixed before taking the low ones
+  static size_t Hash(uint64_t id) {
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdULL;
+    id ^= id >> 33;
+    return static_cast<size_t>(id);
+  }
+
+  Slot& Find(uint64_t id) {
+    size_t mask = slot_list_.size() - 1;
+    size_t index = Hash(id) & mask;
+    while (slot_list_[index].info.call_count != 0 &&
+           slot_list_[index].id != id) {
+      index = (index + 1) & mask;
+    }
+    return slot_list_[index];
+  }
+
+  void Grow() {
+    std::vector<Slot> slot_list(2 * slot_list_.size());
+    slot_list.swap(slot_list_);
+    for (const Slot& slot : slot_list) {
+      if (slot.info.call_count != 0) {
+        Find(slot.id) = slot;
+      }
+    }
+  }
+
+ private: // Data
+  static const size_t kInitialCapacity = 64; // Power of two
+
+  std::vector<Slot> slot_list_;
+  size_t count_ = 0;
+};
+
+// Regions are accumulated by each thread into its own table without any
+// locks, the tables are merged when the results are taken. Region begin
+// and end should be called by the same thread. With nested regions
+// enabled, the time of the regions that began and ended inside a region
+// on the same thread is excluded from its self time
+class OmpRegionCollector {
+ public: // Interface
+  static OmpRegionCollector* Create(bool nested = false) {
+    return new OmpRegionCollector(nested);
+  }
+
+  ~OmpRegionCollector() {
+    for (ThreadData* data : thread_list_) {
+      delete data;
+    }
+  }
+
+  bool IsNested() const {
+    return nested_;
+  }
+
+  void BeginRegion() {
+    ThreadData* data = GetThreadData();
+    PTI_ASSERT(data != nullptr);
+    data->stack.push_back({std::chrono::steady_clock::now(), 0});
+  }
+
+  void EndRegion(uint64_t ra, RegionType type, size_t bytes_transferred) {
+    std::chrono::steady_clock::time_point end =
+      std::chrono::steady_clock::now();
+
+    ThreadData* data = GetThreadData();
+    PTI_ASSERT(data != nullptr);
+    PTI_ASSERT(!data->stack.empty());
+    Frame frame = data->stack.back();
+    data->stack.pop_back();
+
+    std::chrono::duration<uint64_t, std::nano> time = end - frame.start;
+    uint64_t self_time = time.count();
+    if (nested_) {
+      self_time = (frame.child_time < self_time) ?
+        self_time - frame.child_time : 0;
+      if (!data->stack.empty()) {
+        data->stack.back().child_time += time.count();
       }
-      region.call_count += 1;
-      region.bytes_transferred += bytes_transferred;
     }
+
+    data->table.Add(
+        ra + type, type, time.count(), self_time, bytes_transferred);
+  }
+
+  void AddRegion(
+      uint64_t ra, RegionType type, uint64_t time, size_t bytes_transferred) {
+    ThreadData* data = GetThreadData();
+    PTI_ASSERT(data != nullptr);
+    data->table.Add(ra + type, type, time, time, bytes_transferred);
   }
 
-  const RegionMap& GetRegionMap() const {
-    return region_map_;
+  // Regions that are still running on other threads are not included
+  RegionMap GetRegionMap() const {
+    RegionMap region_map;
+    const std::lock_guard<std::mutex> lock(lock_);
+    for (const ThreadData* data : thread_list_) {
+      data->table.MergeTo(region_map);
+    }
+    return region_map;
   }
 
-  static void PrintRegionTable(const RegionMap& region_map) {
+  static void PrintRegionTable(
+      const RegionMap& region_map, bool nested = false) {
     std::set< std::pair<uint64_t, RegionInfo>,
               utils::Comparator > sorted_list(
         region_map.begin(), region_map.end());
 
     uint64_t total_duration = 0;
     for (auto& value : sorted_list) {
-      total_duration += value.second.total_time;
+      total_duration += value.second.self_time;
     }
 
     if (total_duration == 0) {
@@ -101,8 +243,11 @@ class OmpRegionCollector {
       std::setw(kCallsLength) << "Calls" << "," <<
       std::setw(kTransferredLength) <<
         "Transferred (bytes)" << "," <<
-      std::setw(kTimeLength) << "Time (ns)" << "," <<
-      std::setw(kPercentLength) << "Time (%)" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << ",";
+    if (nested) {
+      std::cerr << std::setw(kTimeLength) << "Self (ns)" << ",";
+    }
+    std::cerr << std::setw(kPercentLength) << "Time (%)" << "," <<
       std::setw(kTimeLength) << "Average (ns)" << "," <<
       std::setw(kTimeLength) << "Min (ns)" << "," <<
       std::setw(kTimeLength) << "Max (ns)" << std::endl;
@@ -113,17 +258,21 @@ class OmpRegionCollector {
       uint64_t call_count = value.second.call_count;
       size_t bytes_transferred = value.second.bytes_transferred;
       uint64_t duration = value.second.total_time;
+      uint64_t self_duration = value.second.self_time;
       uint64_t avg_duration = duration / call_count;
       uint64_t min_duration = value.second.min_time;
       uint64_t max_duration = value.second.max_time;
-      float percent_duration = 100.0f * duration / total_duration;
+      float percent_duration = 100.0f * self_duration / total_duration;
       std::cerr << std::setw(kRegionIDLength) << id << "," <<
         std::setw(kRegionTypeLength) << type << "," <<
         std::setw(kCallsLength) << call_count << "," <<
         std::setw(kTransferredLength) <<
           bytes_transferred << "," <<
-        std::setw(kTimeLength) << duration << "," <<
-        std::setw(kPercentLength) << std::setprecision(2) <<
+        std::setw(kTimeLength) << duration << ",";
+      if (nested) {
+        std::cerr << std::setw(kTimeLength) << self_duration << ",";
+      }
+      std::cerr << std::setw(kPercentLength) << std::setprecision(2) <<
           std::fixed << percent_duration << "," <<
         std::setw(kTimeLength) << avg_duration << "," <<
         std::setw(kTimeLength) << min_duration << "," <<
@@ -131,8 +280,36 @@ class OmpRegionCollector {
     }
   }
 
+  OmpRegionCollector(const OmpRegionCollector& copy) = delete;
+  OmpRegionCollector& operator=(const OmpRegionCollector& copy) = delete;
+
  private: // Implementation Details
-  OmpRegionCollector() {}
+  struct Frame {
+    std::chrono::steady_clock::time_point start;
+    uint64_t child_time;
+  };
+
+  struct ThreadData {
+    RegionTable table;
+    std::vector<Frame> stack;
+  };
+
+  explicit OmpRegionCollector(bool nested) : nested_(nested) {}
+
+  // Thread data is owned by the collector, so the regions of the threads
+  // that finished before the results are taken are kept
+  ThreadData* GetThreadData() {
+    thread_local const OmpRegionCollector* owner = nullptr;
+    thread_local ThreadData* data = nullptr;
+    if (owner != this) {
+      data = new ThreadData;
+      PTI_ASSERT(data != nullptr);
+      const std::lock_guard<std::mutex> lock(lock_);
+      thread_list_.push_back(data);
+      owner = this;
+    }
+    return data;
+  }
 
   static const char* GetTypeString(RegionType type) {
     switch(type) {
@@ -152,8 +329,9 @@ class OmpRegionCollector {
   }
 
  private: // Data
-  RegionMap region_map_;
-  std::mutex lock_;
+  bool nested_ = false;
+  std::vector<ThreadData*> thread_list_;
+  mutable std::mutex lock_;
 
   static const uint32_t kRegionIDLength = 20;
   static const uint32_t kRegionTypeLength = 20;
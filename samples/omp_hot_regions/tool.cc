@@ -5,50 +5,33 @@
 // =============================================================
 
 #include <chrono>
-#include <stack>
 
 #include <omp-tools.h>
 
 #include "omp_region_collector.h"
 
-using TimePoint = std::chrono::time_point<std::chrono::steady_clock>;
-static thread_local std::stack<TimePoint> time_point;
+// Set to 1 to report self time of the regions without nested ones
+#define NESTED_REGIONS_ENV "PTI_OMP_NESTED_REGIONS"
 
 static OmpRegionCollector* collector = nullptr;
 static std::chrono::steady_clock::time_point start;
 
 // Internal Tool Functionality ////////////////////////////////////////////////
 
-static void PushTimestamp() {
-  time_point.push(std::chrono::steady_clock::now());
-}
-
-static uint64_t PopTimestamp() {
-  TimePoint end = std::chrono::steady_clock::now();
-
-  PTI_ASSERT(time_point.size() > 0);
-  TimePoint start = time_point.top();
-  time_point.pop();
-
-  std::chrono::duration<uint64_t, std::nano> time = end - start;
-  return time.count();
-}
-
 static void ParallelBegin(
     ompt_data_t* task_data, const ompt_frame_t* task_frame,
     ompt_data_t* parallel_data, unsigned int requested_parallelism,
     int flags, const void* codeptr_ra) {
-  PushTimestamp();
+  PTI_ASSERT(collector != nullptr);
+  collector->BeginRegion();
 }
 
 static void ParallelEnd(
     ompt_data_t* parallel_data, ompt_data_t* task_data,
     int flags, const void* codeptr_ra) {
-  uint64_t time = PopTimestamp();
   PTI_ASSERT(collector != nullptr);
-  collector->AddRegion(
-      reinterpret_cast<uint64_t>(codeptr_ra),
-      REGION_TYPE_PARALLEL, time, 0);
+  collector->EndRegion(
+      reinterpret_cast<uint64_t>(codeptr_ra), REGION_TYPE_PARALLEL, 0);
 }
 
 static void Target(
@@ -59,14 +42,12 @@ static void Target(
     return;
   }
 
+  PTI_ASSERT(collector != nullptr);
   if (endpoint == ompt_scope_begin) {
-    PushTimestamp();
+    collector->BeginRegion();
   } else {
-    uint64_t time = PopTimestamp();
-    PTI_ASSERT(collector != nullptr);
-    collector->AddRegion(
-        reinterpret_cast<uint64_t>(codeptr_ra),
-        REGION_TYPE_TARGET, time, 0);
+    collector->EndRegion(
+        reinterpret_cast<uint64_t>(codeptr_ra), REGION_TYPE_TARGET, 0);
   }
 }
 
@@ -78,20 +59,17 @@ static void TargetDataOp(
     size_t bytes, const void *codeptr_ra) {
   if (optype == ompt_target_data_transfer_to_device ||
       optype == ompt_target_data_transfer_from_device) {
+    PTI_ASSERT(collector != nullptr);
     if (endpoint == ompt_scope_begin) {
-      PushTimestamp();
+      collector->BeginRegion();
+    } else if (optype == ompt_target_data_transfer_to_device) {
+      collector->EndRegion(
+          reinterpret_cast<uint64_t>(codeptr_ra),
+          REGION_TYPE_TRANSFER_TO_DEVICE, bytes);
     } else {
-      uint64_t time = PopTimestamp();
-      PTI_ASSERT(collector != nullptr);
-      if (optype == ompt_target_data_transfer_to_device) {
-        collector->AddRegion(
-            reinterpret_cast<uint64_t>(codeptr_ra),
-            REGION_TYPE_TRANSFER_TO_DEVICE, time, bytes);
-      } else if (optype == ompt_target_data_transfer_from_device) {
-        collector->AddRegion(
-            reinterpret_cast<uint64_t>(codeptr_ra),
-            REGION_TYPE_TRANSFER_FROM_DEVICE, time, bytes);
-      }
+      collector->EndRegion(
+          reinterpret_cast<uint64_t>(codeptr_ra),
+          REGION_TYPE_TRANSFER_FROM_DEVICE, bytes);
     }
   }
 }
@@ -101,14 +79,15 @@ static void PrintResults() {
   std::chrono::duration<uint64_t, std::nano> time = end - start;
 
   PTI_ASSERT(collector != nullptr);
-  const RegionMap& region_map = collector->GetRegionMap();
+  RegionMap region_map = collector->GetRegionMap();
   if (region_map.size() == 0) {
     return;
   }
 
+  // Self time equals total time if nested regions are not tracked
   uint64_t total_duration = 0;
   for (auto& value : region_map) {
-    total_duration += value.second.total_time;
+    total_duration += value.second.self_time;
   }
 
   std::cerr << std::endl;
@@ -119,7 +98,8 @@ static void PrintResults() {
   std::cerr << std::endl;
 
   if (total_duration > 0) {
-    OmpRegionCollector::PrintRegionTable(region_map);
+    OmpRegionCollector::PrintRegionTable(
+        region_map, collector->IsNested());
   }
 
   std::cerr << std::endl;
@@ -155,7 +135,8 @@ static int Initialize(
 
   PTI_ASSERT(collector == nullptr);
 
-  collector = OmpRegionCollector::Create();
+  collector = OmpRegionCollector::Create(
+      utils::GetEnv(NESTED_REGIONS_ENV) == "1");
   PTI_ASSERT(collector != nullptr);
   start = std::chrono::steady_clock::now();
 
@@ -11,6 +11,7 @@
 #include <iomanip>
 #include <map>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include <level_zero/layers/zel_tracing_api.h>
@@ -18,6 +19,8 @@
 #include "elf_parser.h"
 #include "gen_symbols_decoder.h"
 #include "igc_binary_decoder.h"
+#include "kernel_binary_cache.h"
+#include "line_info_index.h"
 #include "utils.h"
 #include "ze_utils.h"
 
@@ -86,31 +89,25 @@ class ZeDebugInfoCollector {
       kernel_debug_info.source_info_list;
     PTI_ASSERT(source_info_list.size() > 0);
 
-    // Print instructions with no corresponding file
-    std::cerr << "=== File: Unknown ===" << std::endl;
+    // Each instruction is resolved once, then grouped by file and line
+    LineInfoIndex line_index(line_info, last_instruction_address);
+    std::vector<const Instruction*> unknown_list;
+    std::map< std::pair<uint32_t, uint32_t>,
+              std::vector<const Instruction*> > line_map;
     for (auto& instruction : instruction_list) {
-      bool found = false;
-
-      for (size_t l = 0; l < line_info.size(); ++l) {
-        int start_address = line_info[l].address;
-        int end_address = (l + 1 < line_info.size()) ?
-                          line_info[l + 1].address :
-                          last_instruction_address;
-
-        if (instruction.offset >= start_address &&
-            instruction.offset < end_address) {
-          found = true;
-          break;
-        }
+      const LineInfo* info = line_index.Find(instruction.offset);
+      if (info == nullptr) {
+        unknown_list.push_back(&instruction);
+      } else {
+        line_map[std::make_pair(info->file, info->line)].push_back(
+            &instruction);
       }
+    }
 
-      if (!found) {
-        std::cerr << "\t\t[" << "0x" << std::setw(5) <<
-          std::setfill('0') << std::hex << std::uppercase <<
-          instruction.offset << "] " << instruction.text;
-        callback(instruction.offset, callback_data);
-        std::cerr << std::endl;
-      }
+    // Print instructions with no corresponding file
+    std::cerr << "=== File: Unknown ===" << std::endl;
+    for (auto instruction : unknown_list) {
+      PrintInstruction(*instruction, callback, callback_data);
     }
 
     // Print info per file
@@ -122,24 +119,10 @@ class ZeDebugInfoCollector {
       PTI_ASSERT(line_list.size() > 0);
 
       // Print instructions with no corresponding source line
-      for (size_t l = 0; l < line_info.size(); ++l) {
-        if (line_info[l].line == 0) {
-          int start_address = line_info[l].address;
-          int end_address = (l + 1 < line_info.size()) ?
-                            line_info[l + 1].address :
-                            last_instruction_address;
-
-          for (auto instruction : instruction_list) {
-            if (instruction.offset >= start_address &&
-                instruction.offset < end_address &&
-                source_info.file_id == line_info[l].file) {
-              std::cerr << "\t\t[" << "0x" << std::setw(5) <<
-                std::setfill('0') << std::hex << std::uppercase <<
-                instruction.offset << "] " << instruction.text;
-              callback(instruction.offset, callback_data);
-              std::cerr << std::endl;
-            }
-          }
+      auto it = line_map.find(std::make_pair(source_info.file_id, 0u));
+      if (it != line_map.end()) {
+        for (auto instruction : it->second) {
+          PrintInstruction(*instruction, callback, callback_data);
         }
       }
 
@@ -148,24 +131,10 @@ class ZeDebugInfoCollector {
         std::cerr << "[" << std::setw(5) << std::setfill(' ') << std::dec <<
           line.number << "] " << line.text << std::endl;
 
-        for (size_t l = 0; l < line_info.size(); ++l) {
-          if (line_info[l].line == line.number) {
-            int start_address = line_info[l].address;
-            int end_address = (l + 1 < line_info.size()) ?
-                              line_info[l + 1].address :
-                              last_instruction_address;
-
-            for (auto instruction : instruction_list) {
-              if (instruction.offset >= start_address &&
-                  instruction.offset < end_address &&
-                  source_info.file_id == line_info[l].file) {
-                std::cerr << "\t\t[" << "0x" << std::setw(5) <<
-                  std::setfill('0') << std::hex << std::uppercase <<
-                  instruction.offset << "] " << instruction.text;
-                callback(instruction.offset, callback_data);
-                std::cerr << std::endl;
-              }
-            }
+        it = line_map.find(std::make_pair(source_info.file_id, line.number));
+        if (it != line_map.end()) {
+          for (auto instruction : it->second) {
+            PrintInstruction(*instruction, callback, callback_data);
           }
         }
       }
@@ -179,6 +148,9 @@ class ZeDebugInfoCollector {
       ze_result_t status = zelTracerDestroy(tracer_);
       PTI_ASSERT(status == ZE_RESULT_SUCCESS);
     }
+    if (cache_ != nullptr) {
+      delete cache_;
+    }
   }
 
   void DisableTracing() {
@@ -193,7 +165,17 @@ class ZeDebugInfoCollector {
   }
 
  private: // Implementation Details
-  ZeDebugInfoCollector() {}
+  static void PrintInstruction(
+      const Instruction& instruction,
+      decltype(InstructionCallback)* callback, void* callback_data) {
+    std::cerr << "\t\t[" << "0x" << std::setw(5) <<
+      std::setfill('0') << std::hex << std::uppercase <<
+      instruction.offset << "] " << instruction.text;
+    callback(instruction.offset, callback_data);
+    std::cerr << std::endl;
+  }
+
+  ZeDebugInfoCollector() : cache_(KernelBinaryCache::Create()) {}
 
   void EnableTracing(zel_tracer_handle_t tracer) {
     PTI_ASSERT(tracer != nullptr);
@@ -247,34 +229,14 @@ class ZeDebugInfoCollector {
     return line_list;
   }
 
- private: // Callbacks
-  static void OnExitKernelCreate(ze_kernel_create_params_t *params,
-                                 ze_result_t result,
-                                 void *global_user_data,
-                                 void **instance_user_data) {
-    if (result != ZE_RESULT_SUCCESS) {
-      return;
-    }
-
-    ze_result_t status = ZE_RESULT_SUCCESS;
-
-    ze_module_handle_t module = *(params->phModule);
+  static bool DecodeKernel(ze_module_handle_t module,
+                           const char* kernel_name,
+                           const std::vector<uint8_t>& native_binary,
+                           KernelBinaryEntry* entry) {
     PTI_ASSERT(module != nullptr);
-
-    const ze_kernel_desc_t* desc = *(params->pdesc);
-    PTI_ASSERT(desc != nullptr);
-
-    const char* kernel_name = desc->pKernelName;
     PTI_ASSERT(kernel_name != nullptr);
-
-    size_t native_binary_size = 0;
-    status = zeModuleGetNativeBinary(module, &native_binary_size, nullptr);
-    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-
-    std::vector<uint8_t> native_binary(native_binary_size);
-    status = zeModuleGetNativeBinary(
-        module, &native_binary_size, native_binary.data());
-    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    PTI_ASSERT(entry != nullptr);
+    ze_result_t status = ZE_RESULT_SUCCESS;
 
     PTI_ASSERT(native_binary.size() < (std::numeric_limits<uint32_t>::max)());
     ElfParser elf_parser(native_binary.data(),
@@ -282,15 +244,14 @@ class ZeDebugInfoCollector {
     std::vector<uint8_t> igc_binary = elf_parser.GetGenBinary();
     if (igc_binary.size() == 0) {
       std::cerr << "[WARNING] Unable to get GEN binary" << std::endl;
-      return;
+      return false;
     }
 
     IgcBinaryDecoder binary_decoder(igc_binary);
-    std::vector<Instruction> instruction_list =
-      binary_decoder.Disassemble(kernel_name);
-    if (instruction_list.size() == 0) {
+    entry->instruction_list = binary_decoder.Disassemble(kernel_name);
+    if (entry->instruction_list.size() == 0) {
       std::cerr << "[WARNING] Unable to decode kernel binary" << std::endl;
-      return;
+      return false;
     }
 
     size_t debug_info_size = 0;
@@ -300,7 +261,7 @@ class ZeDebugInfoCollector {
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
     if (debug_info_size == 0) {
       std::cerr << "[WARNING] Unable to find kernel symbols" << std::endl;
-      return;
+      return false;
     }
 
     std::vector<uint8_t> debug_info(debug_info_size);
@@ -310,20 +271,67 @@ class ZeDebugInfoCollector {
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
 
     GenSymbolsDecoder symbols_decoder(debug_info);
-    std::vector<std::string> file_list =
-      symbols_decoder.GetFileList(kernel_name);
-    if (file_list.size() == 0) {
+    entry->file_list = symbols_decoder.GetFileList(kernel_name);
+    if (entry->file_list.size() == 0) {
       std::cerr << "[WARNING] Unable to find source files" << std::endl;
-      return;
+      return false;
     }
 
-    std::vector<LineInfo> line_info_list =
-      symbols_decoder.GetLineInfo(kernel_name);
-    if (line_info_list.size() == 0) {
+    entry->line_info_list = symbols_decoder.GetLineInfo(kernel_name);
+    if (entry->line_info_list.size() == 0) {
       std::cerr << "[WARNING] Unable to decode kernel line info" << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+ private: // Callbacks
+  static void OnExitKernelCreate(ze_kernel_create_params_t *params,
+                                 ze_result_t result,
+                                 void *global_user_data,
+                                 void **instance_user_data) {
+    if (result != ZE_RESULT_SUCCESS) {
       return;
     }
 
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    ze_module_handle_t module = *(params->phModule);
+    PTI_ASSERT(module != nullptr);
+
+    const ze_kernel_desc_t* desc = *(params->pdesc);
+    PTI_ASSERT(desc != nullptr);
+
+    const char* kernel_name = desc->pKernelName;
+    PTI_ASSERT(kernel_name != nullptr);
+
+    size_t native_binary_size = 0;
+    status = zeModuleGetNativeBinary(module, &native_binary_size, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    std::vector<uint8_t> native_binary(native_binary_size);
+    status = zeModuleGetNativeBinary(
+        module, &native_binary_size, native_binary.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    ZeDebugInfoCollector* collector =
+      reinterpret_cast<ZeDebugInfoCollector*>(global_user_data);
+    PTI_ASSERT(collector != nullptr);
+
+    KernelBinaryEntry entry;
+    uint64_t key = KernelBinaryCache::GetKey(native_binary, kernel_name);
+    if (collector->cache_ == nullptr || !collector->cache_->Load(key, &entry)) {
+      if (!DecodeKernel(module, kernel_name, native_binary, &entry)) {
+        return;
+      }
+      if (collector->cache_ != nullptr) {
+        collector->cache_->Store(key, entry);
+      }
+    }
+
+    const std::vector<std::string>& file_list = entry.file_list;
+
     std::vector<SourceFileInfo> source_info_list;
     for (size_t i = 0; i < file_list.size(); ++i) {
       std::vector<SourceLine> line_list = ReadSourceFile(file_list[i]);
@@ -343,15 +351,13 @@ class ZeDebugInfoCollector {
       return;
     }
 
-    ZeDebugInfoCollector* collector =
-      reinterpret_cast<ZeDebugInfoCollector*>(global_user_data);
-    PTI_ASSERT(collector != nullptr);
-    collector->AddKernel(kernel_name, instruction_list,
-                         line_info_list, source_info_list);
+    collector->AddKernel(kernel_name, entry.instruction_list,
+                         entry.line_info_list, source_info_list);
   }
 
  private:
   zel_tracer_handle_t tracer_ = nullptr;
+  KernelBinaryCache* cache_ = nullptr;
 
   std::mutex lock_;
   KernelDebugInfoMap kernel_debug_info_map_;
@@ -10,6 +10,7 @@
 
 #include "pti_assert.h"
 #include "utils.h"
+#include "ze_device_cache.h"
 #include "ze_utils.h"
 
 #define TAB "  "
@@ -364,17 +365,112 @@ void PrintDeviceInfo() {
   }
 }
 
+std::string EscapeJson(const std::string& value) {
+  std::string result;
+  for (char symbol : value) {
+    if (symbol == '"' || symbol == '\\') {
+      result += '\\';
+      result += symbol;
+    } else if (static_cast<unsigned char>(symbol) >= 0x20) {
+      result += symbol;
+    }
+  }
+  return result;
+}
+
+void PrintDeviceJson(ze_driver_handle_t driver, ze_device_handle_t device,
+                     const std::string& label, ZeDeviceCache* cache) {
+  ze_device_properties_t props{ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, };
+  ze_result_t status = zeDeviceGetProperties(device, &props);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  // Full query, so the dump also refreshes the cache entry
+  ZeDeviceId id = utils::ze::GetDeviceId(driver, device);
+  ZeDeviceCapabilities capabilities =
+    utils::ze::QueryDeviceCapabilities(device, true);
+  if (cache != nullptr) {
+    cache->Store(id, capabilities);
+  }
+
+  std::cout << "{\"device\": \"" << label << "\", " <<
+    "\"name\": \"" << EscapeJson(props.name) << "\", " <<
+    "\"uuid\": \"" << utils::ze::GetDeviceUuid(device) << "\", " <<
+    "\"driver_version\": " << id.driver_version << ", " <<
+    "\"timer_frequency\": " << capabilities.timer_frequency << ", " <<
+    "\"timestamp_mask\": " << capabilities.timestamp_mask << ", " <<
+    "\"global_timestamp_mask\": " <<
+      capabilities.global_timestamp_mask << ", " <<
+    "\"core_clock_rate\": " << capabilities.core_clock_rate << ", " <<
+    "\"flop_per_clock\": " << capabilities.flop_per_clock << ", " <<
+    "\"peak_compute\": " << capabilities.peak_compute << ", " <<
+    "\"peak_bandwidth\": " << capabilities.peak_bandwidth << ", " <<
+    "\"metric_groups\": [";
+  for (size_t i = 0; i < capabilities.metric_group_list.size(); ++i) {
+    const ZeMetricGroupInfo& group = capabilities.metric_group_list[i];
+    if (i > 0) {
+      std::cout << ", ";
+    }
+    std::cout << "{\"index\": " << i << ", " <<
+      "\"name\": \"" << EscapeJson(group.name) << "\", " <<
+      "\"sampling_type\": " << group.sampling_type << "}";
+  }
+  std::cout << "]}";
+}
+
+// Capabilities of all the devices and sub-devices, the same values the
+// tools take from the device cache (PTI_DEVICE_CACHE_DIR), which is filled
+// as well if enabled
+void PrintCapabilities() {
+  ZeDeviceCache* cache = ZeDeviceCache::Create();
+  bool first = true;
+
+  std::cout << "{\"devices\": [";
+  std::vector<ze_driver_handle_t> driver_list = utils::ze::GetDriverList();
+  for (size_t i = 0; i < driver_list.size(); ++i) {
+    std::vector<ze_device_handle_t> device_list =
+      utils::ze::GetDeviceList(driver_list[i]);
+    for (size_t j = 0; j < device_list.size(); ++j) {
+      std::vector<std::pair<ze_device_handle_t, std::string> > target_list;
+      target_list.push_back(std::make_pair(
+          device_list[j], std::to_string(i) + "." + std::to_string(j)));
+
+      std::vector<ze_device_handle_t> sub_device_list =
+        utils::ze::GetSubDeviceList(device_list[j]);
+      for (size_t k = 0; k < sub_device_list.size(); ++k) {
+        target_list.push_back(std::make_pair(
+            sub_device_list[k], std::to_string(i) + "." +
+            std::to_string(j) + "." + std::to_string(k)));
+      }
+
+      for (auto& target : target_list) {
+        std::cout << (first ? "\n" : ",\n");
+        PrintDeviceJson(driver_list[i], target.first, target.second, cache);
+        first = false;
+      }
+    }
+  }
+  std::cout << "\n]}" << std::endl;
+
+  delete cache;
+}
+
 int main(int argc, char *argv[]) {
   bool list_mode = false;
+  bool json_mode = false;
 
   for (size_t i = 1; i < argc; i++) {
     if (std::string(argv[i]).compare("-l") == 0) {
       list_mode = true;
+    } else if (std::string(argv[i]).compare("-j") == 0) {
+      json_mode = true;
     }
   }
 
   utils::SetEnv("NEOReadDebugKeys", "1");
   utils::SetEnv("UseCyclesPerSecondTimer", "1");
+  if (json_mode) {
+    utils::SetEnv("ZET_ENABLE_METRICS", "1");
+  }
 
   ze_result_t status = ZE_RESULT_SUCCESS;
   status = zeInit(ZE_INIT_FLAG_GPU_ONLY);
@@ -382,6 +478,8 @@ int main(int argc, char *argv[]) {
 
   if (list_mode) {
     PrintDeviceList();
+  } else if (json_mode) {
+    PrintCapabilities();
   } else {
     PrintDeviceInfo();
   }
@@ -0,0 +1,326 @@
+import datetime
+import importlib
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+import utils
+
+# Workload name, benchmark application, its mode and runtime
+workloads = [["ze_immediate", "ze_launch", "immediate", "ze"],
+             ["ze_regular", "ze_launch", "regular", "ze"],
+             ["ze_threads", "ze_launch", "threads", "ze"],
+             ["cl_storm", "cl_enqueue", "storm", "cl"],
+             ["cl_threads", "cl_enqueue", "threads", "cl"]]
+
+# Tool, its options and the runtimes it is measured for
+modes = [["onetrace", ["-h"], ["ze", "cl"]],
+         ["onetrace", ["-d"], ["ze", "cl"]],
+         ["onetrace", ["-c"], ["ze", "cl"]],
+         ["onetrace", ["-t"], ["ze", "cl"]],
+         ["onetrace", ["--chrome-call-logging"], ["ze", "cl"]],
+         ["onetrace", ["--chrome-device-timeline"], ["ze", "cl"]],
+         ["onetrace", ["--binary-trace"], ["ze", "cl"]],
+         ["onetrace", ["--wait-analysis"], ["ze", "cl"]],
+         ["ze_tracer", ["-h"], ["ze"]],
+         ["ze_tracer", ["-d"], ["ze"]],
+         ["ze_tracer", ["--chrome-call-logging"], ["ze"]],
+         ["ze_tracer", ["--chrome-device-timeline"], ["ze"]],
+         ["ze_tracer", ["--wait-analysis"], ["ze"]],
+         ["ze_tracer", ["--alloc-churn"], ["ze"]],
+         ["cl_tracer", ["-h"], ["cl"]],
+         ["cl_tracer", ["-d"], ["cl"]],
+         ["cl_tracer", ["--chrome-call-logging"], ["cl"]],
+         ["cl_tracer", ["--chrome-device-timeline"], ["cl"]],
+         ["cl_tracer", ["--wait-analysis"], ["cl"]],
+         ["oneprof", ["-m", "-s", "10"], ["ze"]],
+         ["oneprof", ["-k", "-s", "10"], ["ze"]]]
+
+def get_option(name, default):
+  for i in range(1, len(sys.argv) - 1):
+    if sys.argv[i] == name:
+      return sys.argv[i + 1]
+  return default
+
+def config(path):
+  p = subprocess.Popen(["cmake",\
+    "-DCMAKE_BUILD_TYPE=" + utils.get_build_flag(), ".."],\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.find("CMake Error") != -1:
+    return stderr
+  return None
+
+def build(path):
+  p = subprocess.Popen(["make"], cwd = path,\
+    stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.lower().find("error") != -1:
+    return stderr
+  return None
+
+def build_bench(name):
+  path = utils.get_bench_build_path(name)
+  log = config(path)
+  if log:
+    return None, log
+  log = build(path)
+  if log:
+    return None, log
+  return os.path.join(path, name), None
+
+def build_tool(name):
+  module = importlib.import_module("tools." + name)
+  path = utils.get_tool_build_path(name)
+  log = module.config(path)
+  if log:
+    return None, log
+  log = module.build(path)
+  if log:
+    return None, log
+  return os.path.join(path, name), None
+
+# Benchmark applications report the time of the measured loop only, so
+# tool loading and final reports are not counted (they are in wall time).
+# Startup time is the time from the launch until the runtime is ready,
+# it includes tool initialization
+def parse(stdout):
+  count = re.search(r"Launch count: (\d+)", stdout)
+  launch_time = re.search(r"Launch time: (\d+) ns", stdout)
+  startup_time = re.search(r"Startup time: (\d+) ns", stdout)
+  if not count or not launch_time:
+    return None, None, None
+  if startup_time:
+    startup_time = int(startup_time.group(1))
+  return int(count.group(1)), int(launch_time.group(1)), startup_time
+
+def run_once(command):
+  path = tempfile.mkdtemp()
+  env = os.environ.copy()
+  try:
+    start = time.time()
+    env["PTI_BENCH_START"] = str(int(start * 1e9))
+    p = subprocess.Popen(command, cwd = path, env = env,\
+      stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+    stdout, stderr = utils.run_process(p)
+    wall_time = int((time.time() - start) * 1e9)
+  finally:
+    shutil.rmtree(path, ignore_errors = True)
+  if p.returncode != 0 or not stdout:
+    return None, None, None, None, stderr if stderr else "application failed"
+  count, launch_time, startup_time = parse(stdout)
+  if count is None:
+    return None, None, None, None, stdout
+  return count, launch_time, startup_time, wall_time, None
+
+def median(values):
+  values = sorted(values)
+  middle = len(values) // 2
+  if len(values) % 2 == 1:
+    return values[middle]
+  return (values[middle - 1] + values[middle]) // 2
+
+def measure(command, repeat_count):
+  time_list = []
+  startup_time_list = []
+  wall_time_list = []
+  count = 0
+  for i in range(repeat_count):
+    count, launch_time, startup_time, wall_time, log = run_once(command)
+    if log:
+      return None, log
+    time_list.append(launch_time)
+    if startup_time is not None:
+      startup_time_list.append(startup_time)
+    wall_time_list.append(wall_time)
+  startup_time = None
+  if len(startup_time_list) == len(time_list):
+    startup_time = median(startup_time_list)
+  return {"calls": count,
+          "time": median(time_list),
+          "min_time": min(time_list),
+          "max_time": max(time_list),
+          "startup_time": startup_time,
+          "wall_time": median(wall_time_list),
+          "samples": time_list}, None
+
+# Offline replay of synthetic records through the reporting stages, needs
+# no device, so stage times are comparable between any machines
+def replay(repeat_count, record_count):
+  app_path, log = build_bench("trace_replay")
+  if log:
+    return None, log
+
+  stage_map = {}
+  result = None
+  for i in range(repeat_count):
+    path = tempfile.mkdtemp()
+    try:
+      p = subprocess.Popen([app_path, "--kernels", record_count,\
+        "--calls", str(2 * int(record_count)), "--reports", record_count,\
+        "--output", path], stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+      stdout, stderr = utils.run_process(p)
+    finally:
+      shutil.rmtree(path, ignore_errors = True)
+    if p.returncode != 0 or not stdout:
+      return None, stderr if stderr else "trace_replay failed"
+    result = json.loads(stdout)
+    for stage in result["stages"]:
+      stage_map.setdefault(stage["name"], []).append(stage["time"])
+
+  for stage in result["stages"]:
+    time_list = stage_map[stage["name"]]
+    stage["time"] = median(time_list)
+    stage["min_time"] = min(time_list)
+    stage["max_time"] = max(time_list)
+    stage["samples"] = time_list
+    stage["time_per_record"] = stage["time"] // max(stage["records"], 1)
+  return result, None
+
+def clean():
+  app_list = ["trace_replay"]
+  for workload in workloads:
+    if workload[1] not in app_list:
+      app_list.append(workload[1])
+  for app in app_list:
+    path = utils.get_bench_build_path(app)
+    if os.path.exists(path):
+      shutil.rmtree(path)
+
+def main():
+  for i in range(1, len(sys.argv)):
+    if sys.argv[i] == "-h" or sys.argv[i] == "--help":
+      print("Usage: python bench.py [-s <regex>] [-o <file>] " +\
+        "[-r <repeats>] [-n <launches>] [-t <threads>] " +\
+        "[--replay [<records>]] [-d] [-c]")
+      return
+
+  for i in range(1, len(sys.argv)):
+    if sys.argv[i] == "-c":
+      clean()
+      return
+
+  tmpl = get_option("-s", ".+")
+  output = get_option("-o", "bench.json")
+  repeat_count = int(get_option("-r", "5"))
+  launch_count = get_option("-n", "10000")
+  thread_count = get_option("-t", "8")
+
+  replay_count = None
+  for i in range(1, len(sys.argv)):
+    if sys.argv[i] == "--replay":
+      replay_count = "1000000"
+      if i + 1 < len(sys.argv) and sys.argv[i + 1].isdigit():
+        replay_count = sys.argv[i + 1]
+
+  apps = {}
+  tools = {}
+  results = []
+  errors = []
+
+  for workload in workloads:
+    name, app, mode, runtime = workload
+    mode_list = []
+    for tool, options, runtime_list in modes:
+      label = name + " " + tool + " " + " ".join(options)
+      if runtime in runtime_list and re.search(tmpl, label) != None:
+        mode_list.append([tool, options, label])
+    if re.search(tmpl, name) == None and not mode_list:
+      continue
+
+    if app not in apps:
+      apps[app] = build_bench(app)
+    app_path, log = apps[app]
+    if log:
+      errors.append({"workload": name, "error": log})
+      continue
+    app_command = [app_path, mode, launch_count, thread_count]
+
+    sys.stdout.write("Running benchmark " + name + "...")
+    sys.stdout.flush()
+    baseline, log = measure(app_command, repeat_count)
+    if log:
+      sys.stdout.write("FAILED\n")
+      errors.append({"workload": name, "error": log})
+      continue
+    sys.stdout.write(str(baseline["time"] // baseline["calls"]) + " ns\n")
+    baseline.update({"workload": name, "tool": None, "options": ""})
+    results.append(baseline)
+
+    for tool, options, label in mode_list:
+      if tool not in tools:
+        tools[tool] = build_tool(tool)
+      tool_path, log = tools[tool]
+      if log:
+        errors.append({"workload": name, "tool": tool, "error": log})
+        continue
+
+      sys.stdout.write("Running benchmark " + label + "...")
+      sys.stdout.flush()
+      result, log = measure([tool_path] + options + app_command,\
+        repeat_count)
+      if log:
+        sys.stdout.write("FAILED\n")
+        errors.append({"workload": name, "tool": tool,\
+          "options": " ".join(options), "error": log})
+        continue
+
+      overhead = (result["time"] - baseline["time"]) // result["calls"]
+      startup_overhead = None
+      if result["startup_time"] is not None and\
+         baseline["startup_time"] is not None:
+        startup_overhead = result["startup_time"] - baseline["startup_time"]
+      sys.stdout.write(str(overhead) + " ns per call")
+      if startup_overhead is not None:
+        sys.stdout.write(", " + str(startup_overhead) + " ns startup")
+      sys.stdout.write("\n")
+      result.update({"workload": name, "tool": tool,\
+        "options": " ".join(options),\
+        "overhead_per_call": overhead,\
+        "startup_overhead": startup_overhead,\
+        "slowdown": float(result["time"]) / baseline["time"]})
+      results.append(result)
+
+  replay_result = None
+  if replay_count:
+    sys.stdout.write("Running trace replay (" + replay_count +\
+      " kernels)...")
+    sys.stdout.flush()
+    replay_result, log = replay(repeat_count, replay_count)
+    if log:
+      sys.stdout.write("FAILED\n")
+      errors.append({"workload": "trace_replay", "error": log})
+    else:
+      sys.stdout.write("DONE\n")
+
+  f = open(os.path.join(utils.get_root_path(), "VERSION"))
+  version = f.read().strip()
+  f.close()
+
+  report = {"version": version,
+            "host": platform.node(),
+            "date": datetime.datetime.now().isoformat(),
+            "build": utils.get_build_flag(),
+            "repeats": repeat_count,
+            "launches": int(launch_count),
+            "threads": int(thread_count),
+            "results": results,
+            "replay": replay_result,
+            "errors": errors}
+  f = open(output, "wt")
+  json.dump(report, f, indent = 2)
+  f.close()
+
+  print("RESULTS: " + str(len(results)) + " / FAILED: " + str(len(errors)) +\
+    " (written to " + output + ")")
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,169 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include <string.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <CL/cl.h>
+
+#include "cl_utils.h"
+
+#define FINISH_PERIOD 1024
+
+const char* kKernelSource =
+  "__kernel void Empty(__global int* data) {\n"
+  "}";
+
+// Enqueues the empty kernel back to back with no events, waiting for the
+// queue every FINISH_PERIOD launches only, so host enqueue and tool
+// callback cost dominates
+static void RunStorm(cl_context context, cl_device_id device,
+                     cl_program program, unsigned enqueue_count) {
+  PTI_ASSERT(context != nullptr);
+  PTI_ASSERT(device != nullptr);
+  PTI_ASSERT(program != nullptr);
+  cl_int status = CL_SUCCESS;
+
+  cl_command_queue queue = clCreateCommandQueueWithProperties(
+    context, device, nullptr, &status);
+  PTI_ASSERT(status == CL_SUCCESS && queue != nullptr);
+
+  cl_kernel kernel = clCreateKernel(program, "Empty", &status);
+  PTI_ASSERT(status == CL_SUCCESS && kernel != nullptr);
+
+  cl_mem data = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_int),
+                               nullptr, &status);
+  PTI_ASSERT(status == CL_SUCCESS && data != nullptr);
+  status = clSetKernelArg(kernel, 0, sizeof(cl_mem), &data);
+  PTI_ASSERT(status == CL_SUCCESS);
+
+  size_t global_work_size[]{1};
+  for (unsigned i = 0; i < enqueue_count; ++i) {
+    status = clEnqueueNDRangeKernel(queue, kernel, 1, nullptr,
+                                    global_work_size, nullptr,
+                                    0, nullptr, nullptr);
+    PTI_ASSERT(status == CL_SUCCESS);
+    if ((i + 1) % FINISH_PERIOD == 0) {
+      status = clFinish(queue);
+      PTI_ASSERT(status == CL_SUCCESS);
+    }
+  }
+  status = clFinish(queue);
+  PTI_ASSERT(status == CL_SUCCESS);
+
+  status = clReleaseMemObject(data);
+  PTI_ASSERT(status == CL_SUCCESS);
+  status = clReleaseKernel(kernel);
+  PTI_ASSERT(status == CL_SUCCESS);
+  status = clReleaseCommandQueue(queue);
+  PTI_ASSERT(status == CL_SUCCESS);
+}
+
+// Each thread enqueues its share into its own queue
+static void RunThreads(cl_context context, cl_device_id device,
+                       cl_program program, unsigned enqueue_count,
+                       unsigned thread_count) {
+  std::vector<std::thread> thread_list;
+  for (unsigned i = 0; i < thread_count; ++i) {
+    unsigned count = enqueue_count / thread_count +
+      ((i < enqueue_count % thread_count) ? 1 : 0);
+    thread_list.push_back(std::thread(
+        RunStorm, context, device, program, count));
+  }
+  for (std::thread& thread : thread_list) {
+    thread.join();
+  }
+}
+
+// Time from the process launch by bench.py (PTI_BENCH_START, system clock
+// in ns) until the runtime is ready, so it covers tool loading and
+// initialization, zero if the start time is not given
+static uint64_t GetStartupTime() {
+  std::string value = utils::GetEnv("PTI_BENCH_START");
+  if (value.empty()) {
+    return 0;
+  }
+  uint64_t start = std::stoull(value);
+  uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  return (now > start) ? now - start : 0;
+}
+
+int main(int argc, char* argv[]) {
+  cl_device_id device = utils::cl::GetIntelDevice(CL_DEVICE_TYPE_GPU);
+  uint64_t startup_time = GetStartupTime();
+  if (device == nullptr) {
+    std::cout << "Unable to find target device" << std::endl;
+    return 0;
+  }
+
+  std::string mode = "storm";
+  if (argc > 1) {
+    mode = argv[1];
+  }
+  if (mode != "storm" && mode != "threads") {
+    std::cout << "Usage: ./cl_enqueue [storm|threads] " <<
+      "<enqueue_count> <thread_count>" << std::endl;
+    return 0;
+  }
+
+  unsigned enqueue_count = 10000;
+  if (argc > 2) {
+    enqueue_count = std::stoul(argv[2]);
+  }
+
+  unsigned thread_count = 8;
+  if (argc > 3) {
+    thread_count = std::stoul(argv[3]);
+  }
+  PTI_ASSERT(enqueue_count > 0 && thread_count > 0);
+
+  std::cout << "OpenCL Enqueue Benchmark (mode: " << mode <<
+    ", enqueues: " << enqueue_count << ")" << std::endl;
+  std::cout << "Target device: " << utils::cl::GetDeviceName(device) <<
+    std::endl;
+
+  cl_int status = CL_SUCCESS;
+  cl_context context = clCreateContext(nullptr, 1, &device, nullptr,
+                                       nullptr, &status);
+  PTI_ASSERT(status == CL_SUCCESS && context != nullptr);
+
+  cl_program program = clCreateProgramWithSource(context, 1, &kKernelSource,
+                                                 nullptr, &status);
+  PTI_ASSERT(status == CL_SUCCESS && program != nullptr);
+  status = clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr);
+  PTI_ASSERT(status == CL_SUCCESS);
+
+  // Warm-up enqueue keeps kernel creation and first submission out of
+  // timing
+  RunStorm(context, device, program, 1);
+
+  auto start = std::chrono::steady_clock::now();
+  if (mode == "storm") {
+    RunStorm(context, device, program, enqueue_count);
+  } else {
+    RunThreads(context, device, program, enqueue_count, thread_count);
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<uint64_t, std::nano> time = end - start;
+
+  status = clReleaseProgram(program);
+  PTI_ASSERT(status == CL_SUCCESS);
+  status = clReleaseContext(context);
+  PTI_ASSERT(status == CL_SUCCESS);
+
+  std::cout << "Launch count: " << enqueue_count << std::endl;
+  std::cout << "Launch time: " << time.count() << " ns" << std::endl;
+  if (startup_time > 0) {
+    std::cout << "Startup time: " << startup_time << " ns" << std::endl;
+  }
+  return 0;
+}
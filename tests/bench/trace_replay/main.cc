@@ -0,0 +1,494 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "binary_trace.h"
+#include "critical_path.h"
+#include "kernel_statistics.h"
+#include "logger.h"
+#include "metric_aggregator.h"
+#include "metric_attributor.h"
+#include "metric_report_store.h"
+#include "perfetto_trace.h"
+#include "queue_timing.h"
+#include "string_table.h"
+#include "trace_buffer.h"
+#include "trace_generator.h"
+#include "utils.h"
+
+struct StageResult {
+  std::string name;
+  uint64_t record_count;
+  uint64_t time; // ns
+  uint64_t output_size; // bytes of text or trace file
+};
+
+struct ReplayOptions {
+  uint32_t kernel_count = 1000000;
+  uint32_t call_count = 2000000;
+  uint32_t report_count = 1000000;
+  uint32_t kernel_name_count = 256;
+  uint32_t queue_count = 4;
+  uint32_t thread_count = 8;
+  std::string stage;
+  std::string output_path = ".";
+  bool keep_files = false;
+};
+
+// Drives the post-processing stages of the tools with synthetic records
+// offline, each stage is timed from the first record to the final report
+class TraceReplay {
+ public: // Interface
+  TraceReplay(const TraceGenerator& generator, const ReplayOptions& options)
+      : generator_(generator), options_(options) {
+    for (const std::string& name : generator_.GetKernelNameList()) {
+      kernel_name_id_list_.push_back(StringTable::Add(name));
+    }
+  }
+
+  std::vector<StageResult> Run() {
+    std::vector<StageResult> result_list;
+    RunStage("kernel_statistics", result_list,
+             [this](StageResult& result) { ReplayKernelStatistics(result); });
+    RunStage("queue_timing", result_list,
+             [this](StageResult& result) { ReplayQueueTiming(result); });
+    RunStage("critical_path", result_list,
+             [this](StageResult& result) { ReplayCriticalPath(result); });
+    RunStage("chrome_trace", result_list,
+             [this](StageResult& result) { ReplayChromeTrace(result); });
+    RunStage("binary_trace", result_list,
+             [this](StageResult& result) { ReplayBinaryTrace(result); });
+    RunStage("perfetto_trace", result_list,
+             [this](StageResult& result) { ReplayPerfettoTrace(result); });
+    RunStage("metric_attribution", result_list,
+             [this](StageResult& result) { ReplayMetricAttribution(result); });
+    RunStage("online_aggregation", result_list,
+             [this](StageResult& result) { ReplayOnlineAggregation(result); });
+    return result_list;
+  }
+
+  TraceReplay(const TraceReplay& copy) = delete;
+  TraceReplay& operator=(const TraceReplay& copy) = delete;
+
+ private: // Implementation
+  void RunStage(const std::string& name,
+                std::vector<StageResult>& result_list,
+                const std::function<void(StageResult&)>& stage) {
+    if (!options_.stage.empty() && options_.stage != name) {
+      return;
+    }
+
+    StageResult result{name, 0, 0, 0};
+    auto start = std::chrono::steady_clock::now();
+    stage(result);
+    auto end = std::chrono::steady_clock::now();
+    result.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        end - start).count();
+    result_list.push_back(result);
+  }
+
+  std::string GetFileName(const std::string& name) const {
+    return options_.output_path + "/replay." + name;
+  }
+
+  uint64_t TakeFile(const std::string& filename) const {
+    uint64_t size = utils::LoadBinaryFile(filename).size();
+    if (!options_.keep_files) {
+      remove(filename.c_str());
+    }
+    return size;
+  }
+
+  static void* GetQueue(uint32_t queue_id) {
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(queue_id + 1));
+  }
+
+  // Same as the device timing path of the kernel collectors
+  void ReplayKernelStatistics(StageResult& result) {
+    KernelStatistics statistics;
+    for (const SyntheticKernel& kernel : generator_.GetKernelList()) {
+      uint32_t name_id = kernel_name_id_list_[kernel.name_id];
+      statistics.Add(name_id, name_id, kernel.ended - kernel.started);
+    }
+
+    std::stringstream stream;
+    KernelStatistics::PrintTable(
+        statistics.GetInfoMap(KernelSampler()), stream);
+    result.record_count = generator_.GetKernelList().size();
+    result.output_size = stream.str().size();
+  }
+
+  void ReplayQueueTiming(StageResult& result) {
+    QueueTiming queue_timing;
+    for (const SyntheticKernel& kernel : generator_.GetKernelList()) {
+      queue_timing.AddCommand(
+          GetQueue(kernel.queue_id),
+          "GPU 0 Group 0 Index " + std::to_string(kernel.queue_id),
+          kernel.submitted, kernel.started, kernel.ended);
+    }
+
+    std::stringstream stream;
+    queue_timing.PrintTables(stream);
+    result.record_count = generator_.GetKernelList().size();
+    result.output_size = stream.str().size();
+  }
+
+  // Calls and kernels are merged in time order, as they come from the
+  // API and kernel collectors
+  void ReplayCriticalPath(StageResult& result) {
+    const std::vector<SyntheticCall>& call_list = generator_.GetCallList();
+    const std::vector<SyntheticKernel>& kernel_list =
+      generator_.GetKernelList();
+    const std::vector<std::string>& api_name_list =
+      generator_.GetApiNameList();
+    const std::vector<std::string>& kernel_name_list =
+      generator_.GetKernelNameList();
+
+    CriticalPathAnalyzer analyzer;
+    size_t call_id = 0;
+    for (const SyntheticKernel& kernel : kernel_list) {
+      while (call_id < call_list.size() &&
+             call_list[call_id].ended <= kernel.started) {
+        const SyntheticCall& call = call_list[call_id];
+        analyzer.AddCall(call.kernel_id, api_name_list[call.name_id],
+                         call.started, call.ended);
+        ++call_id;
+      }
+      analyzer.AddKernel(kernel.kernel_id, kernel_name_list[kernel.name_id],
+                         kernel.appended, kernel.submitted,
+                         kernel.started, kernel.ended);
+    }
+
+    for (; call_id < call_list.size(); ++call_id) {
+      const SyntheticCall& call = call_list[call_id];
+      analyzer.AddCall(call.kernel_id, api_name_list[call.name_id],
+                       call.started, call.ended);
+    }
+
+    std::stringstream stream;
+    analyzer.PrintResults(stream);
+    result.record_count = kernel_list.size() + call_list.size();
+    result.output_size = stream.str().size();
+  }
+
+  // Same record format as the Chrome device timeline and call logging
+  void ReplayChromeTrace(StageResult& result) {
+    const std::vector<std::string>& api_name_list =
+      generator_.GetApiNameList();
+    const std::vector<std::string>& kernel_name_list =
+      generator_.GetKernelNameList();
+    std::string filename = GetFileName("json");
+    uint32_t pid = utils::GetPid();
+
+    {
+      Logger logger(filename);
+      logger.Log("[\n");
+      for (const SyntheticCall& call : generator_.GetCallList()) {
+        TraceBuffer& buffer = TraceBuffer::Get();
+        buffer << "{\"ph\":\"X\", \"pid\":\"" << pid <<
+          "\", \"tid\":\"" << call.tid <<
+          "\", \"name\":\"" << api_name_list[call.name_id] <<
+          "\", \"ts\": " << call.started / NSEC_IN_USEC <<
+          ", \"dur\":" << (call.ended - call.started) / NSEC_IN_USEC <<
+          "},\n";
+        logger.Log(buffer.GetText());
+      }
+      for (const SyntheticKernel& kernel : generator_.GetKernelList()) {
+        TraceBuffer& buffer = TraceBuffer::Get();
+        buffer << "{\"ph\":\"X\", \"pid\":\"" << pid <<
+          "\", \"tid\":\"" <<
+            reinterpret_cast<uint64_t>(GetQueue(kernel.queue_id)) <<
+          "\", \"name\":\"" << kernel_name_list[kernel.name_id] <<
+          "\", \"ts\": " << kernel.started / NSEC_IN_USEC <<
+          ", \"dur\":" << (kernel.ended - kernel.started) / NSEC_IN_USEC <<
+          ", \"args\": {\"id\": \"" << kernel.kernel_id << "\"}"
+          "},\n";
+        logger.Log(buffer.GetText());
+      }
+      logger.Log("{}]\n");
+    }
+
+    result.record_count =
+      generator_.GetCallList().size() + generator_.GetKernelList().size();
+    result.output_size = TakeFile(filename);
+  }
+
+  void ReplayBinaryTrace(StageResult& result) {
+    const std::vector<std::string>& api_name_list =
+      generator_.GetApiNameList();
+    const std::vector<std::string>& kernel_name_list =
+      generator_.GetKernelNameList();
+    std::string filename = GetFileName("bin");
+
+    {
+      BinaryTraceWriter writer(
+          filename, utils::GetPid(), 0, 0, "trace_replay");
+      for (const SyntheticCall& call : generator_.GetCallList()) {
+        writer.WriteHostRecord(call.tid, call.kernel_id,
+                               api_name_list[call.name_id],
+                               call.started, call.ended);
+      }
+      for (const SyntheticKernel& kernel : generator_.GetKernelList()) {
+        writer.WriteDeviceRecord(GetQueue(kernel.queue_id), kernel.kernel_id,
+                                 kernel_name_list[kernel.name_id],
+                                 kernel.appended, kernel.submitted,
+                                 kernel.started, kernel.ended);
+      }
+    }
+
+    result.record_count =
+      generator_.GetCallList().size() + generator_.GetKernelList().size();
+    result.output_size = TakeFile(filename);
+  }
+
+  void ReplayPerfettoTrace(StageResult& result) {
+    const std::vector<std::string>& api_name_list =
+      generator_.GetApiNameList();
+    const std::vector<std::string>& kernel_name_list =
+      generator_.GetKernelNameList();
+    std::string filename = GetFileName("pftrace");
+
+    {
+      PerfettoTraceWriter writer(filename, utils::GetPid(), "trace_replay");
+      for (const SyntheticCall& call : generator_.GetCallList()) {
+        writer.WriteHostEvent(call.tid, call.kernel_id,
+                              api_name_list[call.name_id],
+                              call.started, call.ended);
+      }
+      for (const SyntheticKernel& kernel : generator_.GetKernelList()) {
+        writer.WriteDeviceEvent(GetQueue(kernel.queue_id), kernel.kernel_id,
+                                kernel_name_list[kernel.name_id],
+                                kernel.started, kernel.ended);
+      }
+    }
+
+    result.record_count =
+      generator_.GetCallList().size() + generator_.GetKernelList().size();
+    result.output_size = TakeFile(filename);
+  }
+
+  void GetMetricList(std::vector<std::string>& name_list,
+                     std::vector<zet_metric_type_t>& type_list) const {
+    for (const SyntheticMetric& metric : generator_.GetMetricList()) {
+      name_list.push_back(metric.name);
+      type_list.push_back(metric.type);
+    }
+  }
+
+  // Post-mortem attribution of Kernel Metrics and Aggregation modes,
+  // reports come in chunks as they are read from the metric storage
+  void ReplayMetricAttribution(StageResult& result) {
+    std::vector<std::string> name_list;
+    std::vector<zet_metric_type_t> type_list;
+    GetMetricList(name_list, type_list);
+    uint32_t report_size = static_cast<uint32_t>(name_list.size());
+    uint32_t time_id = static_cast<uint32_t>(
+        std::find(name_list.begin(), name_list.end(), "QueryBeginTime") -
+        name_list.begin());
+
+    const std::vector<zet_typed_value_t>& report_list =
+      generator_.GetReportList();
+    MetricReportStore report_store(report_size, time_id);
+    size_t chunk_size = kReportChunkSize * report_size;
+    for (size_t i = 0; i < report_list.size(); i += chunk_size) {
+      size_t end = (std::min)(i + chunk_size, report_list.size());
+      report_store.AddReports(std::vector<zet_typed_value_t>(
+          report_list.begin() + i, report_list.begin() + end));
+    }
+    report_store.Seal();
+
+    std::vector<MetricInterval> interval_list;
+    interval_list.reserve(generator_.GetKernelList().size());
+    for (const SyntheticKernel& kernel : generator_.GetKernelList()) {
+      interval_list.push_back({kernel.started, kernel.ended});
+    }
+
+    MetricAttributor attributor(name_list, type_list);
+    std::vector<std::vector<zet_typed_value_t> > aggregated_list =
+      attributor.Attribute(report_store, interval_list);
+
+    uint64_t value_count = 0;
+    for (auto& aggregated : aggregated_list) {
+      value_count += aggregated.size();
+    }
+    result.record_count = generator_.GetReportCount() + interval_list.size();
+    result.output_size = value_count * sizeof(zet_typed_value_t);
+  }
+
+  // Online Aggregation mode: chunks of reports and finished kernels are
+  // interleaved in time order
+  void ReplayOnlineAggregation(StageResult& result) {
+    std::vector<std::string> name_list;
+    std::vector<zet_metric_type_t> type_list;
+    GetMetricList(name_list, type_list);
+    uint32_t report_size = static_cast<uint32_t>(name_list.size());
+    uint32_t time_id = static_cast<uint32_t>(
+        std::find(name_list.begin(), name_list.end(), "QueryBeginTime") -
+        name_list.begin());
+
+    const std::vector<zet_typed_value_t>& report_list =
+      generator_.GetReportList();
+    const std::vector<SyntheticKernel>& kernel_list =
+      generator_.GetKernelList();
+    const std::vector<std::string>& kernel_name_list =
+      generator_.GetKernelNameList();
+
+    MetricAggregator aggregator(
+        std::vector<std::vector<std::string> >(1, name_list),
+        std::vector<std::vector<zet_metric_type_t> >(1, type_list));
+    size_t chunk_size = kReportChunkSize * report_size;
+    size_t kernel_id = 0;
+    for (size_t i = 0; i < report_list.size(); i += chunk_size) {
+      size_t end = (std::min)(i + chunk_size, report_list.size());
+      aggregator.AddReports(0, std::vector<zet_typed_value_t>(
+          report_list.begin() + i, report_list.begin() + end));
+
+      uint64_t last_time = report_list[end - report_size + time_id].value.ui64;
+      while (kernel_id < kernel_list.size() &&
+             kernel_list[kernel_id].ended <= last_time) {
+        const SyntheticKernel& kernel = kernel_list[kernel_id];
+        aggregator.AddKernelInterval(kernel_name_list[kernel.name_id], 0,
+                                     kernel.started, kernel.ended);
+        ++kernel_id;
+      }
+    }
+    for (; kernel_id < kernel_list.size(); ++kernel_id) {
+      const SyntheticKernel& kernel = kernel_list[kernel_id];
+      aggregator.AddKernelInterval(kernel_name_list[kernel.name_id], 0,
+                                   kernel.started, kernel.ended);
+    }
+    aggregator.Finalize();
+
+    result.record_count = generator_.GetReportCount() + kernel_list.size();
+    result.output_size = aggregator.GetAggregateMap().size() *
+      report_size * sizeof(zet_typed_value_t);
+  }
+
+ private: // Data
+  static const size_t kReportChunkSize = 4096;
+
+  const TraceGenerator& generator_;
+  const ReplayOptions& options_;
+  std::vector<uint32_t> kernel_name_id_list_;
+};
+
+static void Usage() {
+  std::cout <<
+    "Usage: ./trace_replay [options]" << std::endl;
+  std::cout << "Options:" << std::endl;
+  std::cout <<
+    "--kernels <N>        Number of kernel records (default is 1000000)" <<
+    std::endl;
+  std::cout <<
+    "--calls <N>          Number of API call records (default is 2000000)" <<
+    std::endl;
+  std::cout <<
+    "--reports <N>        Number of metric reports (default is 1000000)" <<
+    std::endl;
+  std::cout <<
+    "--kernel-names <N>   Number of distinct kernel names (default is 256)" <<
+    std::endl;
+  std::cout <<
+    "--queues <N>         Number of device queues (default is 4)" <<
+    std::endl;
+  std::cout <<
+    "--threads <N>        Number of host threads (default is 8)" <<
+    std::endl;
+  std::cout <<
+    "--stage <name>       Run only the given stage" <<
+    std::endl;
+  std::cout <<
+    "--output <path>      Folder for trace files (default is current one)" <<
+    std::endl;
+  std::cout <<
+    "--keep-files         Do not remove trace files after the run" <<
+    std::endl;
+}
+
+static bool ParseArgs(int argc, char* argv[], ReplayOptions& options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string option = argv[i];
+    if (option == "--keep-files") {
+      options.keep_files = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[++i];
+    if (option == "--kernels") {
+      options.kernel_count = std::stoul(value);
+    } else if (option == "--calls") {
+      options.call_count = std::stoul(value);
+    } else if (option == "--reports") {
+      options.report_count = std::stoul(value);
+    } else if (option == "--kernel-names") {
+      options.kernel_name_count = std::stoul(value);
+    } else if (option == "--queues") {
+      options.queue_count = std::stoul(value);
+    } else if (option == "--threads") {
+      options.thread_count = std::stoul(value);
+    } else if (option == "--stage") {
+      options.stage = value;
+    } else if (option == "--output") {
+      options.output_path = value;
+    } else {
+      return false;
+    }
+  }
+  return options.kernel_name_count > 0 && options.queue_count > 0 &&
+    options.thread_count > 0;
+}
+
+int main(int argc, char* argv[]) {
+  ReplayOptions options;
+  if (!ParseArgs(argc, argv, options)) {
+    Usage();
+    return 1;
+  }
+  if (options.call_count < options.kernel_count) {
+    options.call_count = options.kernel_count;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  TraceGenerator generator(
+      options.kernel_count, options.call_count, options.report_count,
+      options.kernel_name_count, options.queue_count, options.thread_count);
+  auto end = std::chrono::steady_clock::now();
+  uint64_t generation_time =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+  TraceReplay replay(generator, options);
+  std::vector<StageResult> result_list = replay.Run();
+
+  std::cout << "{\"kernels\": " << generator.GetKernelList().size() <<
+    ", \"calls\": " << generator.GetCallList().size() <<
+    ", \"reports\": " << generator.GetReportCount() <<
+    ", \"generation_time\": " << generation_time <<
+    ", \"stages\": [" << std::endl;
+  for (size_t i = 0; i < result_list.size(); ++i) {
+    const StageResult& result = result_list[i];
+    uint64_t record_time = (result.record_count > 0) ?
+      result.time / result.record_count : 0;
+    std::cout << "  {\"name\": \"" << result.name <<
+      "\", \"records\": " << result.record_count <<
+      ", \"time\": " << result.time <<
+      ", \"time_per_record\": " << record_time <<
+      ", \"output_size\": " << result.output_size << "}" <<
+      ((i + 1 < result_list.size()) ? "," : "") << std::endl;
+  }
+  std::cout << "]}" << std::endl;
+  return 0;
+}
@@ -0,0 +1,264 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TESTS_BENCH_TRACE_REPLAY_TRACE_GENERATOR_H_
+#define PTI_TESTS_BENCH_TRACE_REPLAY_TRACE_GENERATOR_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <level_zero/zet_api.h>
+
+#include "pti_assert.h"
+
+#define TRACE_GENERATOR_SEED 42
+#define TRACE_GENERATOR_API_COUNT 32
+#define TRACE_GENERATOR_MIN_DURATION 1000 // ns
+#define TRACE_GENERATOR_MAX_DURATION 1000000 // ns
+
+struct SyntheticKernel {
+  uint32_t name_id; // Index in the kernel name list
+  uint32_t queue_id;
+  uint64_t kernel_id;
+  uint64_t appended;
+  uint64_t submitted;
+  uint64_t started;
+  uint64_t ended;
+};
+
+struct SyntheticCall {
+  uint32_t name_id; // Index in the API name list
+  uint32_t tid;
+  uint64_t kernel_id; // Zero if the call gives no kernel
+  uint64_t started;
+  uint64_t ended;
+};
+
+struct SyntheticMetric {
+  std::string name;
+  zet_metric_type_t type;
+  zet_value_type_t value_type;
+};
+
+// Reproducible synthetic trace: kernels with log-uniform per-name base
+// durations are spread over several queues back to back with small gaps,
+// each kernel is appended by an API call of one of the threads and some
+// calls in between give no kernels. Metric reports of a streamer-like
+// layout cover the whole device span at a fixed sampling interval. All
+// the records are sorted by time, the way collectors deliver them
+class TraceGenerator {
+ public: // Interface
+  TraceGenerator(uint32_t kernel_count, uint32_t call_count,
+                 uint32_t report_count, uint32_t kernel_name_count,
+                 uint32_t queue_count, uint32_t thread_count)
+      : random_(TRACE_GENERATOR_SEED) {
+    PTI_ASSERT(kernel_name_count > 0);
+    PTI_ASSERT(queue_count > 0);
+    PTI_ASSERT(thread_count > 0);
+    PTI_ASSERT(call_count >= kernel_count);
+
+    GenerateNames(kernel_name_count);
+    GenerateKernels(kernel_count, queue_count);
+    GenerateCalls(call_count, thread_count);
+    GenerateReports(report_count);
+  }
+
+  const std::vector<std::string>& GetKernelNameList() const {
+    return kernel_name_list_;
+  }
+
+  const std::vector<std::string>& GetApiNameList() const {
+    return api_name_list_;
+  }
+
+  const std::vector<SyntheticKernel>& GetKernelList() const {
+    return kernel_list_;
+  }
+
+  const std::vector<SyntheticCall>& GetCallList() const {
+    return call_list_;
+  }
+
+  const std::vector<SyntheticMetric>& GetMetricList() const {
+    return metric_list_;
+  }
+
+  // Reports are stored one after another, GetMetricList() values each
+  const std::vector<zet_typed_value_t>& GetReportList() const {
+    return report_list_;
+  }
+
+  size_t GetReportCount() const {
+    if (metric_list_.empty()) {
+      return 0;
+    }
+    return report_list_.size() / metric_list_.size();
+  }
+
+  TraceGenerator(const TraceGenerator& copy) = delete;
+  TraceGenerator& operator=(const TraceGenerator& copy) = delete;
+
+ private: // Implementation
+  void GenerateNames(uint32_t kernel_name_count) {
+    std::uniform_real_distribution<double> distribution(
+        std::log(static_cast<double>(TRACE_GENERATOR_MIN_DURATION)),
+        std::log(static_cast<double>(TRACE_GENERATOR_MAX_DURATION)));
+    for (uint32_t i = 0; i < kernel_name_count; ++i) {
+      kernel_name_list_.push_back(
+          "SyntheticKernel" + std::to_string(i) + "<float, 256>");
+      base_duration_list_.push_back(
+          static_cast<uint64_t>(std::exp(distribution(random_))));
+    }
+    for (uint32_t i = 0; i < TRACE_GENERATOR_API_COUNT; ++i) {
+      api_name_list_.push_back(
+          (i == 0) ? "zeCommandListAppendLaunchKernel" :
+          "zeSyntheticCall" + std::to_string(i));
+    }
+  }
+
+  void GenerateKernels(uint32_t kernel_count, uint32_t queue_count) {
+    std::uniform_int_distribution<uint32_t> name_distribution(
+        0, static_cast<uint32_t>(kernel_name_list_.size()) - 1);
+    std::uniform_real_distribution<double> jitter_distribution(0.8, 1.2);
+    std::uniform_int_distribution<uint64_t> gap_distribution(100, 10000);
+
+    std::vector<uint64_t> queue_time_list(queue_count, kStartTime);
+    kernel_list_.reserve(kernel_count);
+    for (uint32_t i = 0; i < kernel_count; ++i) {
+      uint32_t name_id = name_distribution(random_);
+      uint32_t queue_id = i % queue_count;
+      uint64_t duration = static_cast<uint64_t>(
+          base_duration_list_[name_id] * jitter_distribution(random_));
+      uint64_t started = queue_time_list[queue_id] + gap_distribution(random_);
+      uint64_t submitted = started - gap_distribution(random_) / 2;
+      uint64_t appended = submitted - gap_distribution(random_) / 2;
+      kernel_list_.push_back({name_id, queue_id, i + 1ULL,
+                              appended, submitted, started,
+                              started + duration});
+      queue_time_list[queue_id] = started + duration;
+    }
+
+    std::sort(kernel_list_.begin(), kernel_list_.end(),
+              [](const SyntheticKernel& left, const SyntheticKernel& right) {
+                return left.started < right.started;
+              });
+  }
+
+  // Each kernel is appended by a call ending at its append time, the rest
+  // of the calls are spread between them
+  void GenerateCalls(uint32_t call_count, uint32_t thread_count) {
+    std::uniform_int_distribution<uint32_t> name_distribution(
+        1, TRACE_GENERATOR_API_COUNT - 1);
+    std::uniform_int_distribution<uint32_t> tid_distribution(
+        1, thread_count);
+    std::uniform_int_distribution<uint64_t> duration_distribution(
+        200, 5000);
+
+    call_list_.reserve(call_count);
+    for (const SyntheticKernel& kernel : kernel_list_) {
+      uint64_t duration = duration_distribution(random_);
+      call_list_.push_back({0, tid_distribution(random_), kernel.kernel_id,
+                            kernel.appended - duration, kernel.appended});
+    }
+
+    uint64_t end_time = GetEndTime();
+    std::uniform_int_distribution<uint64_t> time_distribution(
+        kStartTime, end_time);
+    while (call_list_.size() < call_count) {
+      uint64_t started = time_distribution(random_);
+      call_list_.push_back({name_distribution(random_),
+                            tid_distribution(random_), 0, started,
+                            started + duration_distribution(random_)});
+    }
+
+    std::sort(call_list_.begin(), call_list_.end(),
+              [](const SyntheticCall& left, const SyntheticCall& right) {
+                return left.started < right.started;
+              });
+  }
+
+  void GenerateReports(uint32_t report_count) {
+    metric_list_ = {
+        {"GpuTime", ZET_METRIC_TYPE_DURATION, ZET_VALUE_TYPE_UINT64},
+        {"GpuCoreClocks", ZET_METRIC_TYPE_EVENT, ZET_VALUE_TYPE_UINT64},
+        {"AvgGpuCoreFrequencyMHz", ZET_METRIC_TYPE_EVENT,
+         ZET_VALUE_TYPE_UINT64},
+        {"GpuBusy", ZET_METRIC_TYPE_RATIO, ZET_VALUE_TYPE_FLOAT32},
+        {"EuActive", ZET_METRIC_TYPE_RATIO, ZET_VALUE_TYPE_FLOAT32},
+        {"EuStall", ZET_METRIC_TYPE_RATIO, ZET_VALUE_TYPE_FLOAT32},
+        {"EuThreadOccupancy", ZET_METRIC_TYPE_RATIO, ZET_VALUE_TYPE_FLOAT32},
+        {"GtiReadThroughput", ZET_METRIC_TYPE_THROUGHPUT,
+         ZET_VALUE_TYPE_UINT64},
+        {"GtiWriteThroughput", ZET_METRIC_TYPE_THROUGHPUT,
+         ZET_VALUE_TYPE_UINT64},
+        {"QueryBeginTime", ZET_METRIC_TYPE_TIMESTAMP, ZET_VALUE_TYPE_UINT64},
+        {"ReportReason", ZET_METRIC_TYPE_RAW, ZET_VALUE_TYPE_UINT32}};
+    if (report_count == 0) {
+      return;
+    }
+
+    uint64_t span = GetEndTime() - kStartTime;
+    uint64_t interval = span / report_count;
+    if (interval == 0) {
+      interval = 1;
+    }
+    std::uniform_real_distribution<float> ratio_distribution(0.0f, 100.0f);
+    std::uniform_int_distribution<uint64_t> event_distribution(0, 1 << 20);
+
+    report_list_.reserve(
+        static_cast<size_t>(report_count) * metric_list_.size());
+    for (uint32_t i = 0; i < report_count; ++i) {
+      for (const SyntheticMetric& metric : metric_list_) {
+        zet_typed_value_t value{};
+        value.type = metric.value_type;
+        if (metric.name == "QueryBeginTime") {
+          value.value.ui64 = kStartTime + i * interval;
+        } else if (metric.name == "GpuTime") {
+          value.value.ui64 = interval;
+        } else if (metric.name == "GpuCoreClocks") {
+          value.value.ui64 = interval * kFrequency / 1000;
+        } else if (metric.name == "AvgGpuCoreFrequencyMHz") {
+          value.value.ui64 = kFrequency;
+        } else if (metric.name == "ReportReason") {
+          value.value.ui32 = 1;
+        } else if (metric.value_type == ZET_VALUE_TYPE_FLOAT32) {
+          value.value.fp32 = ratio_distribution(random_);
+        } else {
+          value.value.ui64 = event_distribution(random_);
+        }
+        report_list_.push_back(value);
+      }
+    }
+  }
+
+  uint64_t GetEndTime() const {
+    uint64_t end_time = kStartTime;
+    for (const SyntheticKernel& kernel : kernel_list_) {
+      end_time = (std::max)(end_time, kernel.ended);
+    }
+    return end_time;
+  }
+
+ private: // Data
+  static const uint64_t kStartTime = 1000000000ULL; // Leaves room for API
+  static const uint64_t kFrequency = 1000; // MHz
+
+  std::mt19937_64 random_;
+  std::vector<std::string> kernel_name_list_;
+  std::vector<uint64_t> base_duration_list_;
+  std::vector<std::string> api_name_list_;
+  std::vector<SyntheticKernel> kernel_list_;
+  std::vector<SyntheticCall> call_list_;
+  std::vector<SyntheticMetric> metric_list_;
+  std::vector<zet_typed_value_t> report_list_;
+};
+
+#endif // PTI_TESTS_BENCH_TRACE_REPLAY_TRACE_GENERATOR_H_
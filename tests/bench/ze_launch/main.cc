@@ -0,0 +1,295 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include <string.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ze_utils.h"
+#include "utils.h"
+
+#define ALIGN 64
+#define BATCH_SIZE 16
+
+// Kernel of 1x1 matrix multiplication runs a single work item, so the
+// launch time is defined by the host and driver path
+static ze_kernel_handle_t CreateKernel(ze_module_handle_t module,
+                                       ze_device_handle_t device,
+                                       ze_context_handle_t context,
+                                       std::vector<void*>& buffer_list) {
+  PTI_ASSERT(module != nullptr);
+  PTI_ASSERT(device != nullptr);
+  PTI_ASSERT(context != nullptr);
+
+  ze_result_t status = ZE_RESULT_SUCCESS;
+
+  ze_kernel_desc_t kernel_desc = {
+     ZE_STRUCTURE_TYPE_KERNEL_DESC, nullptr, 0, "GEMM"};
+  ze_kernel_handle_t kernel = nullptr;
+  status = zeKernelCreate(module, &kernel_desc, &kernel);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS && kernel != nullptr);
+
+  status = zeKernelSetGroupSize(kernel, 1, 1, 1);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  ze_device_mem_alloc_desc_t alloc_desc = {
+      ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC, nullptr, 0, 0};
+  for (uint32_t i = 0; i < 3; ++i) {
+    void* buffer = nullptr;
+    status = zeMemAllocDevice(context, &alloc_desc, sizeof(float),
+                              ALIGN, device, &buffer);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zeKernelSetArgumentValue(kernel, i, sizeof(buffer), &buffer);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    buffer_list.push_back(buffer);
+  }
+
+  unsigned size = 1;
+  status = zeKernelSetArgumentValue(kernel, 3, sizeof(size), &size);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  return kernel;
+}
+
+static void RunImmediate(ze_module_handle_t module,
+                         ze_device_handle_t device,
+                         ze_context_handle_t context,
+                         unsigned launch_count) {
+  ze_result_t status = ZE_RESULT_SUCCESS;
+
+  std::vector<void*> buffer_list;
+  ze_kernel_handle_t kernel =
+    CreateKernel(module, device, context, buffer_list);
+
+  ze_command_queue_desc_t cmd_queue_desc = {
+      ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC, nullptr, 0, 0, 0,
+      ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS, ZE_COMMAND_QUEUE_PRIORITY_NORMAL};
+  ze_command_list_handle_t cmd_list = nullptr;
+  status = zeCommandListCreateImmediate(
+      context, device, &cmd_queue_desc, &cmd_list);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  ze_event_pool_desc_t event_pool_desc = {
+      ZE_STRUCTURE_TYPE_EVENT_POOL_DESC, nullptr,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE, 1};
+  ze_event_pool_handle_t event_pool = nullptr;
+  status = zeEventPoolCreate(context, &event_pool_desc,
+                             0, nullptr, &event_pool);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  ze_event_desc_t event_desc = {
+      ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
+      ZE_EVENT_SCOPE_FLAG_HOST, ZE_EVENT_SCOPE_FLAG_HOST};
+  ze_event_handle_t event = nullptr;
+  status = zeEventCreate(event_pool, &event_desc, &event);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  ze_group_count_t dim = {1, 1, 1};
+  for (unsigned i = 0; i < launch_count; ++i) {
+    status = zeCommandListAppendLaunchKernel(
+        cmd_list, kernel, &dim, nullptr, 0, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+
+  status = zeCommandListAppendBarrier(cmd_list, event, 0, nullptr);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  status = zeEventHostSynchronize(event, UINT64_MAX);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  status = zeEventDestroy(event);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  status = zeEventPoolDestroy(event_pool);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  status = zeCommandListDestroy(cmd_list);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  status = zeKernelDestroy(kernel);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  for (void* buffer : buffer_list) {
+    status = zeMemFree(context, buffer);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+}
+
+// Command list is refilled with BATCH_SIZE launches for each execution,
+// so both append and submission paths are exercised
+static void RunRegular(ze_module_handle_t module,
+                       ze_device_handle_t device,
+                       ze_context_handle_t context,
+                       unsigned launch_count) {
+  ze_result_t status = ZE_RESULT_SUCCESS;
+
+  std::vector<void*> buffer_list;
+  ze_kernel_handle_t kernel =
+    CreateKernel(module, device, context, buffer_list);
+
+  ze_command_list_desc_t cmd_list_desc = {
+      ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC, nullptr, 0, 0};
+  ze_command_list_handle_t cmd_list = nullptr;
+  status = zeCommandListCreate(context, device, &cmd_list_desc, &cmd_list);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  ze_command_queue_desc_t cmd_queue_desc = {
+      ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC, nullptr, 0, 0, 0,
+      ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS, ZE_COMMAND_QUEUE_PRIORITY_NORMAL};
+  ze_command_queue_handle_t cmd_queue = nullptr;
+  status = zeCommandQueueCreate(context, device, &cmd_queue_desc, &cmd_queue);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS && cmd_queue != nullptr);
+
+  ze_group_count_t dim = {1, 1, 1};
+  unsigned launched = 0;
+  while (launched < launch_count) {
+    status = zeCommandListReset(cmd_list);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    for (unsigned i = 0; i < BATCH_SIZE && launched < launch_count; ++i) {
+      status = zeCommandListAppendLaunchKernel(
+          cmd_list, kernel, &dim, nullptr, 0, nullptr);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      ++launched;
+    }
+    status = zeCommandListClose(cmd_list);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    status = zeCommandQueueExecuteCommandLists(
+        cmd_queue, 1, &cmd_list, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zeCommandQueueSynchronize(cmd_queue, UINT64_MAX);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+
+  status = zeCommandQueueDestroy(cmd_queue);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  status = zeCommandListDestroy(cmd_list);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  status = zeKernelDestroy(kernel);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  for (void* buffer : buffer_list) {
+    status = zeMemFree(context, buffer);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+}
+
+// Each thread submits its share of launches into its own immediate
+// command list, so the tool locks are contended
+static void RunThreads(ze_module_handle_t module,
+                       ze_device_handle_t device,
+                       ze_context_handle_t context,
+                       unsigned launch_count, unsigned thread_count) {
+  std::vector<std::thread> thread_list;
+  for (unsigned i = 0; i < thread_count; ++i) {
+    unsigned count = launch_count / thread_count +
+      ((i < launch_count % thread_count) ? 1 : 0);
+    thread_list.push_back(std::thread(
+        RunImmediate, module, device, context, count));
+  }
+  for (std::thread& thread : thread_list) {
+    thread.join();
+  }
+}
+
+// Time from the process launch by bench.py (PTI_BENCH_START, system clock
+// in ns) until the runtime is ready, so it covers tool loading and
+// initialization, zero if the start time is not given
+static uint64_t GetStartupTime() {
+  std::string value = utils::GetEnv("PTI_BENCH_START");
+  if (value.empty()) {
+    return 0;
+  }
+  uint64_t start = std::stoull(value);
+  uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  return (now > start) ? now - start : 0;
+}
+
+int main(int argc, char* argv[]) {
+  ze_result_t status = ZE_RESULT_SUCCESS;
+  status = zeInit(ZE_INIT_FLAG_GPU_ONLY);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  ze_device_handle_t device = utils::ze::GetGpuDevice();
+  ze_driver_handle_t driver = utils::ze::GetGpuDriver();
+  uint64_t startup_time = GetStartupTime();
+  if (device == nullptr || driver == nullptr) {
+    std::cout << "Unable to find GPU device" << std::endl;
+    return 0;
+  }
+
+  std::string mode = "immediate";
+  if (argc > 1) {
+    mode = argv[1];
+  }
+  if (mode != "immediate" && mode != "regular" && mode != "threads") {
+    std::cout << "Usage: ./ze_launch [immediate|regular|threads] " <<
+      "<launch_count> <thread_count>" << std::endl;
+    return 0;
+  }
+
+  unsigned launch_count = 10000;
+  if (argc > 2) {
+    launch_count = std::stoul(argv[2]);
+  }
+
+  unsigned thread_count = 8;
+  if (argc > 3) {
+    thread_count = std::stoul(argv[3]);
+  }
+  PTI_ASSERT(launch_count > 0 && thread_count > 0);
+
+  std::string module_name = "gemm.spv";
+  std::vector<uint8_t> binary = utils::LoadBinaryFile(
+    utils::GetExecutablePath() + module_name);
+  if (binary.size() == 0) {
+    std::cout << "Unable to find module " << module_name << std::endl;
+    return 0;
+  }
+
+  ze_context_handle_t context = utils::ze::GetContext(driver);
+  PTI_ASSERT(context != nullptr);
+
+  ze_module_desc_t module_desc = {
+      ZE_STRUCTURE_TYPE_MODULE_DESC, nullptr,
+      ZE_MODULE_FORMAT_IL_SPIRV, static_cast<uint32_t>(binary.size()),
+      binary.data(), nullptr, nullptr};
+  ze_module_handle_t module = nullptr;
+  status = zeModuleCreate(context, device, &module_desc, &module, nullptr);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS && module != nullptr);
+
+  std::cout << "Level Zero Launch Benchmark (mode: " << mode <<
+    ", launches: " << launch_count << ")" << std::endl;
+  std::cout << "Target device: " << utils::ze::GetDeviceName(device) <<
+    std::endl;
+
+  // Warm-up launch keeps module build and first submission out of timing
+  RunImmediate(module, device, context, 1);
+
+  auto start = std::chrono::steady_clock::now();
+  if (mode == "immediate") {
+    RunImmediate(module, device, context, launch_count);
+  } else if (mode == "regular") {
+    RunRegular(module, device, context, launch_count);
+  } else {
+    RunThreads(module, device, context, launch_count, thread_count);
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<uint64_t, std::nano> time = end - start;
+
+  status = zeModuleDestroy(module);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  status = zeContextDestroy(context);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  std::cout << "Launch count: " << launch_count << std::endl;
+  std::cout << "Launch time: " << time.count() << " ns" << std::endl;
+  if (startup_time > 0) {
+    std::cout << "Startup time: " << startup_time << " ns" << std::endl;
+  }
+  return 0;
+}
@@ -15,8 +15,9 @@ samples = [["cl_gemm", "gpu", "cpu"],
            ["cl_hot_kernels", "cpu", "gpu", "dpc", "omp"],
            ["gpu_inst_count", "cl", "ze", "dpc"],
            ["gpu_perfmon_read", "cl", "ze", "dpc"],
+           ["gpu_hotspots", "ze", "dpc"],
            ["gpu_perfmon_set", None],
-           ["ze_info", "-a", "-l"],
+           ["ze_info", "-a", "-l", "-j"],
            ["ze_sysman", None],
            ["ze_gemm", None],
            ["ze_debug_info", "gpu", "dpc"],
@@ -31,13 +32,49 @@ samples = [["cl_gemm", "gpu", "cpu"],
            ["dpc_info", "-a", "-l"]]
 
 tools = [["gpuinfo", "-l", "-i", "-m"],
-         ["sysmon", "-p", "-l", "-d"],
+         ["sysmon", "-p", "-l", "-d", "-w", "-t", "-e"],
+         ["trace_daemon", "-h", "--node-trace"],
+         ["trace_analyzer", "-h"],
+         ["gtpin_prof", "-c", "-p", "-l", "-b", "--launch-limit",
+          "--kernel-include", "cl", "ze", "dpc"],
          ["onetrace",
           "-c", "-h", "-d", "-v", "-t",
           "--chrome-call-logging",
           "--chrome-device-timeline",
           "--chrome-kernel-timeline",
           "--chrome-device-stages",
+          "--async-logging",
+          "--binary-trace",
+          "--perfetto-trace",
+          "--batch-timestamps",
+          "--itt",
+          "--collector-api",
+          "--queue-timing",
+          "--dependency-graph",
+          "--call-stacks",
+          "--wait-analysis",
+          "--transfer-timing",
+          "--tile-timing",
+          "--module-dump",
+          "--memory-tracking",
+          "--alloc-churn",
+          "--save-tables",
+          "--overhead",
+          "--subtract-overhead",
+          "--overhead-budget",
+          "--critical-path",
+          "--node-trace",
+          "--sysman-counters",
+          "--kernel-energy",
+          "--omp-device",
+          "--sycl",
+          "--ring-buffer",
+          "--include-api",
+          "--kernel-sampling",
+          "--capture-kernel",
+          "--interval",
+          "--kernel-grouping",
+          "--compress",
           "cl", "ze", "omp"],
          ["cl_tracer",
           "-c", "-h", "-d", "-v", "-t",
@@ -45,6 +82,22 @@ tools = [["gpuinfo", "-l", "-i", "-m"],
           "--chrome-device-timeline",
           "--chrome-kernel-timeline",
           "--chrome-device-stages",
+          "--async-logging",
+          "--binary-trace",
+          "--perfetto-trace",
+          "--queue-timing",
+          "--dependency-graph",
+          "--call-stacks",
+          "--wait-analysis",
+          "--save-tables",
+          "--overhead",
+          "--node-trace",
+          "--include-api",
+          "--kernel-sampling",
+          "--capture-kernel",
+          "--interval",
+          "--kernel-grouping",
+          "--compress",
           "gpu", "dpc", "omp"],
          ["ze_tracer",
           "-c", "-h", "-d", "-v", "-t",
@@ -52,9 +105,39 @@ tools = [["gpuinfo", "-l", "-i", "-m"],
           "--chrome-device-timeline",
           "--chrome-kernel-timeline",
           "--chrome-device-stages",
+          "--async-logging",
+          "--binary-trace",
+          "--perfetto-trace",
+          "--batch-timestamps",
+          "--queue-timing",
+          "--dependency-graph",
+          "--call-stacks",
+          "--submission-spans",
+          "--wait-analysis",
+          "--transfer-timing",
+          "--tile-timing",
+          "--module-dump",
+          "--memory-tracking",
+          "--alloc-churn",
+          "--save-tables",
+          "--overhead",
+          "--subtract-overhead",
+          "--node-trace",
+          "--poll-interval",
+          "--include-api",
+          "--kernel-sampling",
+          "--capture-kernel",
+          "--capture-duration",
+          "--interval",
+          "--kernel-grouping",
+          "--compress",
           "dpc", "omp"],
         ["oneprof",
-         "-i", "-m", "-k", "-a", "cl", "ze", "omp"]]
+         "-i", "-m", "-k", "-a", "--online-aggregation",
+         "--sysman-counters", "--multiplex", "--query", "--roofline",
+         "--shared-metrics",
+         "--capture-kernel",
+         "cl", "ze", "omp"]]
 
 def remove_python_cache(path):
   files = os.listdir(path)
@@ -0,0 +1,93 @@
+import os
+import subprocess
+import sys
+
+from samples import dpc_gemm
+from samples import ze_gemm
+import utils
+
+def config(path):
+  p = subprocess.Popen(["cmake",\
+    "-DCMAKE_BUILD_TYPE=" + utils.get_build_flag(), ".."],\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.find("CMake Error") != -1:
+    return stderr
+  return None
+
+def build(path):
+  p = subprocess.Popen(["make"], cwd = path,\
+    stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.lower().find("error") != -1:
+    return stderr
+  return None
+
+def parse(output):
+  lines = output.split("\n")
+  total = 0
+  for line in lines:
+    items = [item.strip() for item in line.split(",")]
+    if len(items) < 6 or not items[0].startswith("0x"):
+      continue
+    value = int(items[3])
+    if value < 0:
+      return False
+    total += value
+  if total <= 0:
+    return False
+  return True
+
+def run(path, option):
+  if option == "ze":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./gpu_hotspots", app_file, "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  else:
+    app_folder = utils.get_sample_build_path("dpc_gemm")
+    app_file = os.path.join(app_folder, "dpc_gemm")
+    p = subprocess.Popen(["./gpu_hotspots", app_file, "gpu", "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  stdout, stderr = utils.run_process(p)
+  if not stdout:
+    return "stdout is empty"
+  if not stderr:
+    return "stderr is empty"
+  if stdout.find(" CORRECT") == -1:
+    return stdout
+  if stderr.find("== Basic Blocks: ==") == -1:
+    return stderr
+  if not parse(stderr):
+    return stderr
+  return None
+
+def main(option):
+  path = utils.get_sample_build_path("gpu_hotspots")
+  if option == "ze":
+    log = ze_gemm.main(None)
+    if log:
+      return log
+  else:
+    log = dpc_gemm.main("gpu")
+    if log:
+      return log
+  log = config(path)
+  if log:
+    return log
+  log = build(path)
+  if log:
+    return log
+  log = run(path, option)
+  if log:
+    return log
+
+if __name__ == "__main__":
+  option = "ze"
+  if len(sys.argv) > 1 and sys.argv[1] == "dpc":
+    option = "dpc"
+  log = main(option)
+  if log:
+    print(log)
\ No newline at end of file
@@ -1,3 +1,4 @@
+import json
 import os
 import subprocess
 import sys
@@ -49,6 +50,15 @@ def parse(output, option):
         count_drivers += 1
       if line.find("Device") != -1:
         count_devices += 1
+  elif option == "-j":
+    try:
+      devices = json.loads(output)["devices"]
+    except (ValueError, KeyError):
+      return False
+    for device in devices:
+      if device["timer_frequency"] == 0:
+        return False
+    return len(devices) > 0
   else:
     return False
   if count_drivers == 0 or count_devices == 0:
@@ -85,6 +95,8 @@ if __name__ == "__main__":
     option = "-a"
     if len(sys.argv) > 1 and sys.argv[1] == "-l":
         option = "-l"
+    if len(sys.argv) > 1 and sys.argv[1] == "-j":
+        option = "-j"
     log = main(option)
     if log:
         print(log)
\ No newline at end of file
@@ -38,6 +38,36 @@ def run(path, option):
     e = utils.add_env(None, "LIBOMPTARGET_PLUGIN", "OPENCL")
     p = subprocess.Popen(["./cl_tracer", "-h", "-d", "-t", app_file, "gpu", "1024", "1"],\
       env = e, cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--include-api":
+    app_folder = utils.get_sample_build_path("cl_gemm")
+    app_file = os.path.join(app_folder, "cl_gemm")
+    p = subprocess.Popen(["./cl_tracer", "-c", "--include-api", "clEnqueue*,clSet*", "--exclude-api", "clSetKernelArg", app_file, "cpu", "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--kernel-sampling":
+    app_folder = utils.get_sample_build_path("cl_gemm")
+    app_file = os.path.join(app_folder, "cl_gemm")
+    p = subprocess.Popen(["./cl_tracer", "-d", "--kernel-sampling", "2", app_file, "cpu", "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--capture-kernel":
+    app_folder = utils.get_sample_build_path("cl_gemm")
+    app_file = os.path.join(app_folder, "cl_gemm")
+    p = subprocess.Popen(["./cl_tracer", "-d", "--capture-kernel", "GEMM", app_file, "cpu", "1024", "2"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--interval":
+    app_folder = utils.get_sample_build_path("cl_gemm")
+    app_file = os.path.join(app_folder, "cl_gemm")
+    p = subprocess.Popen(["./cl_tracer", "-h", "-d", "--interval", "1", app_file, "cpu", "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--kernel-grouping":
+    app_folder = utils.get_sample_build_path("cl_gemm")
+    app_file = os.path.join(app_folder, "cl_gemm")
+    p = subprocess.Popen(["./cl_tracer", "-d", "--kernel-grouping", "local", app_file, "gpu", "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--compress":
+    app_folder = utils.get_sample_build_path("cl_gemm")
+    app_file = os.path.join(app_folder, "cl_gemm")
+    p = subprocess.Popen(["./cl_tracer", "-c", "-o", "compress.log", "--compress", "lz4", app_file, "cpu", "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
   else:
     app_folder = utils.get_sample_build_path("cl_gemm")
     app_file = os.path.join(app_folder, "cl_gemm")
@@ -56,6 +86,38 @@ def run(path, option):
     return stdout
   if stderr.find("WARNING") != -1:
     return stderr
+  if option == "--include-api":
+    if stderr.find("clEnqueueNDRangeKernel") == -1:
+      return stderr
+    if stderr.find("clSetKernelArg") != -1 or\
+        stderr.find("clCreateBuffer") != -1:
+      return stderr
+  if option == "--kernel-sampling":
+    if stderr.find("GEMM") == -1:
+      return stderr
+  if option == "--capture-kernel":
+    if stderr.find("GEMM") == -1:
+      return stderr
+  if option == "--interval":
+    csv_file = os.path.join(path, "clt_trace." + str(p.pid) + ".intervals.csv")
+    if not os.path.isfile(csv_file):
+      return csv_file + " is not found"
+    with open(csv_file) as f:
+      csv = f.read()
+    if not csv.startswith("Window,Start (ns),End (ns),Type,Name,") or\
+        csv.find(",Kernel,") == -1 or csv.find(",Function,") == -1:
+      return csv
+  if option == "--kernel-grouping":
+    if stderr.find("GEMM[SIMD") == -1:
+      return stderr
+  if option == "--compress":
+    log_file = os.path.join(path, "compress." + str(p.pid) + ".log.lz4")
+    if not os.path.isfile(log_file):
+      return log_file + " is not found"
+    with open(log_file, "rb") as f:
+      magic = f.read(4)
+    if magic != bytes.fromhex("04224d18"):
+      return log_file + " is not compressed with lz4"
   return None
 
 def main(option):
@@ -64,7 +126,7 @@ def main(option):
     log = dpc_gemm.main("cpu")
   elif option == "omp":
     log = omp_gemm.main("gpu")
-  elif option == "gpu":
+  elif option == "gpu" or option == "--kernel-grouping":
     log = cl_gemm.main("gpu")
   else:
     log = cl_gemm.main("cpu")
@@ -96,6 +158,38 @@ if __name__ == "__main__":
     option = "--chrome-kernel-timeline"
   if len(sys.argv) > 1 and sys.argv[1] == "--chrome-device-stages":
     option = "--chrome-device-stages"
+  if len(sys.argv) > 1 and sys.argv[1] == "--async-logging":
+    option = "--async-logging"
+  if len(sys.argv) > 1 and sys.argv[1] == "--binary-trace":
+    option = "--binary-trace"
+  if len(sys.argv) > 1 and sys.argv[1] == "--perfetto-trace":
+    option = "--perfetto-trace"
+  if len(sys.argv) > 1 and sys.argv[1] == "--queue-timing":
+    option = "--queue-timing"
+  if len(sys.argv) > 1 and sys.argv[1] == "--dependency-graph":
+    option = "--dependency-graph"
+  if len(sys.argv) > 1 and sys.argv[1] == "--call-stacks":
+    option = "--call-stacks"
+  if len(sys.argv) > 1 and sys.argv[1] == "--wait-analysis":
+    option = "--wait-analysis"
+  if len(sys.argv) > 1 and sys.argv[1] == "--save-tables":
+    option = "--save-tables"
+  if len(sys.argv) > 1 and sys.argv[1] == "--overhead":
+    option = "--overhead"
+  if len(sys.argv) > 1 and sys.argv[1] == "--node-trace":
+    option = "--node-trace"
+  if len(sys.argv) > 1 and sys.argv[1] == "--include-api":
+    option = "--include-api"
+  if len(sys.argv) > 1 and sys.argv[1] == "--kernel-sampling":
+    option = "--kernel-sampling"
+  if len(sys.argv) > 1 and sys.argv[1] == "--capture-kernel":
+    option = "--capture-kernel"
+  if len(sys.argv) > 1 and sys.argv[1] == "--interval":
+    option = "--interval"
+  if len(sys.argv) > 1 and sys.argv[1] == "--kernel-grouping":
+    option = "--kernel-grouping"
+  if len(sys.argv) > 1 and sys.argv[1] == "--compress":
+    option = "--compress"
   if len(sys.argv) > 1 and sys.argv[1] == "gpu":
     option = "gpu"
   if len(sys.argv) > 1 and sys.argv[1] == "dpc":
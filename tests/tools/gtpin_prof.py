@@ -0,0 +1,129 @@
+import os
+import subprocess
+import sys
+
+from samples import cl_gemm
+from samples import dpc_gemm
+from samples import ze_gemm
+import utils
+
+def config(path):
+  p = subprocess.Popen(["cmake",\
+    "-DCMAKE_BUILD_TYPE=" + utils.get_build_flag(), ".."],\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.find("CMake Error") != -1:
+    return stderr
+  return None
+
+def build(path):
+  p = subprocess.Popen(["make"], cwd = path,\
+    stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.lower().find("error") != -1:
+    return stderr
+  return None
+
+def parse(output):
+  lines = output.split("\n")
+  total = 0
+  for line in lines:
+    items = [item.strip() for item in line.split(",")]
+    if len(items) < 5 or not items[0].startswith("0x"):
+      continue
+    value = int(items[3])
+    if value < 0:
+      return False
+    total += value
+  if total <= 0:
+    return False
+  return True
+
+def get_binary_file(path):
+  for file in os.listdir(path):
+    if file.startswith("profile.") and file.endswith(".bin"):
+      return os.path.join(path, file)
+  return None
+
+def convert(path):
+  binary_file = get_binary_file(path)
+  if not binary_file:
+    return "binary profile is not found"
+  p = subprocess.Popen(["python", os.path.join(utils.get_root_path(),\
+    "tools", "gtpin_prof", "gtpin_prof_reader.py"), binary_file],\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  stdout, stderr = utils.run_process(p)
+  os.remove(binary_file)
+  if stderr:
+    return stderr
+  if len(stdout.split("\n")) < 3:
+    return stdout
+  return None
+
+def run(path, option):
+  if option == "cl":
+    app_folder = utils.get_sample_build_path("cl_gemm")
+    app_file = os.path.join(app_folder, "cl_gemm")
+    command = ["./gtpin_prof", app_file, "gpu", "1024", "1"]
+  elif option == "ze":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    command = ["./gtpin_prof", app_file, "1024", "1"]
+  else:
+    app_folder = utils.get_sample_build_path("dpc_gemm")
+    app_file = os.path.join(app_folder, "dpc_gemm")
+    if option == "-b":
+      command = ["./gtpin_prof", option, "profile.bin"]
+    elif option == "--launch-limit":
+      command = ["./gtpin_prof", option, "1"]
+    elif option == "--kernel-include":
+      command = ["./gtpin_prof", option, "*GEMM*"]
+    else:
+      command = ["./gtpin_prof", option]
+    command += [app_file, "gpu", "1024", "1"]
+  p = subprocess.Popen(command,\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  stdout, stderr = utils.run_process(p)
+  if not stdout:
+    return "stdout is empty"
+  if not stderr:
+    return "stderr is empty"
+  if stdout.find(" CORRECT") == -1:
+    return stdout
+  if stderr.find("WARNING") != -1:
+    return stderr
+  if option != "-p" and not parse(stderr):
+    return stderr
+  if option == "-b":
+    return convert(path)
+  return None
+
+def main(option):
+  path = utils.get_tool_build_path("gtpin_prof")
+  if option == "cl":
+    log = cl_gemm.main("gpu")
+  elif option == "ze":
+    log = ze_gemm.main(None)
+  else:
+    log = dpc_gemm.main("gpu")
+  if log:
+    return log
+  log = config(path)
+  if log:
+    return log
+  log = build(path)
+  if log:
+    return log
+  log = run(path, option)
+  if log:
+    return log
+
+if __name__ == "__main__":
+  option = "dpc"
+  if len(sys.argv) > 1:
+    option = sys.argv[1]
+  log = main(option)
+  if log:
+    print(log)
\ No newline at end of file
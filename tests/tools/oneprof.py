@@ -43,6 +43,28 @@ def run(path, option):
     app_file = os.path.join(app_folder, "omp_gemm")
     p = subprocess.Popen(["./oneprof", "-k", "-a", app_file, "gpu", "1024", "1"],\
       cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--sysman-counters":
+    app_folder = utils.get_sample_build_path("dpc_gemm")
+    app_file = os.path.join(app_folder, "dpc_gemm")
+    p = subprocess.Popen(["./oneprof", "-k", option, app_file, "gpu", "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--shared-metrics":
+    app_folder = utils.get_sample_build_path("dpc_gemm")
+    app_file = os.path.join(app_folder, "dpc_gemm")
+    p = subprocess.Popen(["./oneprof", "-k", option, app_file, "gpu", "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--multiplex":
+    app_folder = utils.get_sample_build_path("dpc_gemm")
+    app_file = os.path.join(app_folder, "dpc_gemm")
+    p = subprocess.Popen(["./oneprof", "-a", "-g",\
+      "ComputeBasic,ComputeExtended", "--multiplex-period", "10",\
+      app_file, "gpu", "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--capture-kernel":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./oneprof", "-k", "--capture-kernel", "GEMM", app_file, "1024", "2"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
   else:
     app_folder = utils.get_sample_build_path("dpc_gemm")
     app_file = os.path.join(app_folder, "dpc_gemm")
@@ -57,13 +79,16 @@ def run(path, option):
     return stdout
   if stderr.find("WARNING") != -1:
     return stderr
+  if option == "--capture-kernel":
+    if stderr.find("GEMM") == -1:
+      return stderr
   return None
 
 def main(option):
   path = utils.get_tool_build_path("oneprof")
   if option == "cl":
     log = cl_gemm.main("gpu")
-  elif option == "ze":
+  elif option == "ze" or option == "--capture-kernel":
     log = ze_gemm.main(None)
   elif option == "omp":
     log = omp_gemm.main("gpu")
@@ -89,6 +114,20 @@ if __name__ == "__main__":
     option = "-k"
   if len(sys.argv) > 1 and sys.argv[1] == "-a":
     option = "-a"
+  if len(sys.argv) > 1 and sys.argv[1] == "--online-aggregation":
+    option = "--online-aggregation"
+  if len(sys.argv) > 1 and sys.argv[1] == "--sysman-counters":
+    option = "--sysman-counters"
+  if len(sys.argv) > 1 and sys.argv[1] == "--multiplex":
+    option = "--multiplex"
+  if len(sys.argv) > 1 and sys.argv[1] == "--query":
+    option = "--query"
+  if len(sys.argv) > 1 and sys.argv[1] == "--roofline":
+    option = "--roofline"
+  if len(sys.argv) > 1 and sys.argv[1] == "--shared-metrics":
+    option = "--shared-metrics"
+  if len(sys.argv) > 1 and sys.argv[1] == "--capture-kernel":
+    option = "--capture-kernel"
   if len(sys.argv) > 1 and sys.argv[1] == "cl":
     option = "cl"
   if len(sys.argv) > 1 and sys.argv[1] == "ze":
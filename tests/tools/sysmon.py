@@ -1,9 +1,23 @@
 import os
 import subprocess
 import sys
+import time
+
+if sys.version_info.major > 2:
+  from urllib.request import urlopen
+else:
+  from urllib2 import urlopen
 
 import utils
 
+WATCH_INTERVAL = 100
+WATCH_COUNT = 5
+TOP_INTERVAL = 100
+TOP_COUNT = 5
+EXPORTER_PORT = 18091
+EXPORTER_INTERVAL = 100
+EXPORTER_TIMEOUT = 10
+
 def config(path):
   p = subprocess.Popen(["cmake",\
     "-DCMAKE_BUILD_TYPE=" + utils.get_build_flag(), ".."],\
@@ -54,10 +68,71 @@ def parse(output, option):
         total_eu_count += int(items[1].strip())
     if total_eu_count < 1:
       return False
+  elif option == "-w":
+    lines = [line for line in output.split("\n") if line]
+    if len(lines) != WATCH_COUNT + 1:
+      return False
+    if lines[0].find("Time(ms)") != 0:
+      return False
+    columns = len(lines[0].split(","))
+    for line in lines[1:]:
+      if len(line.split(",")) != columns:
+        return False
+  elif option == "-t":
+    lines = [line for line in output.split("\n") if line]
+    if len(lines) < 1:
+      return False
+    if lines[0].find("Time(ms)") != 0:
+      return False
+    columns = len(lines[0].split(","))
+    for line in lines[1:]:
+      if len(line.split(",")) < columns:
+        return False
   return True
 
+# Exporter runs until terminated, so the page is fetched while it serves
+def scrape(p):
+  for i in range(EXPORTER_TIMEOUT * 10):
+    if p.poll() is not None:
+      return None
+    try:
+      page = urlopen("http://localhost:" + str(EXPORTER_PORT) + "/metrics")
+      output = page.read()
+      if sys.version_info.major > 2:
+        output = str(output, "utf-8")
+      if output.find("# TYPE pti_gpu_frequency_mhz gauge") != -1:
+        return output
+    except IOError:
+      pass
+    time.sleep(0.1)
+  return None
+
+def run_exporter(path):
+  p = subprocess.Popen(["./sysmon", "-e", str(EXPORTER_PORT),\
+    str(EXPORTER_INTERVAL)], cwd = path,\
+    stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  output = scrape(p)
+  if p.poll() is None:
+    p.terminate()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.find("WARNING") != -1:
+    return stderr
+  if stderr and stderr.find("ERROR") != -1:
+    return stderr
+  if not output:
+    return "metrics page is unavailable"
+  return None
+
 def run(path, option):
-  p = subprocess.Popen(["./sysmon", option],\
+  if option == "-e":
+    return run_exporter(path)
+
+  command = ["./sysmon", option]
+  if option == "-w":
+    command += [str(WATCH_INTERVAL), str(WATCH_COUNT)]
+  elif option == "-t":
+    command += [str(TOP_INTERVAL), str(TOP_COUNT)]
+  p = subprocess.Popen(command,\
     cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
   stdout, stderr = utils.run_process(p)
   if stderr:
@@ -86,6 +161,12 @@ if __name__ == "__main__":
     option = "-l"
   elif len(sys.argv) > 1 and sys.argv[1] == "-d":
     option = "-d"
+  elif len(sys.argv) > 1 and sys.argv[1] == "-w":
+    option = "-w"
+  elif len(sys.argv) > 1 and sys.argv[1] == "-t":
+    option = "-t"
+  elif len(sys.argv) > 1 and sys.argv[1] == "-e":
+    option = "-e"
   log = main(option)
   if log:
     print(log)
\ No newline at end of file
@@ -0,0 +1,54 @@
+import os
+import subprocess
+import sys
+
+import utils
+
+def config(path):
+  p = subprocess.Popen(["cmake",\
+    "-DCMAKE_BUILD_TYPE=" + utils.get_build_flag(), ".."],\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.find("CMake Error") != -1:
+    return stderr
+  return None
+
+def build(path):
+  p = subprocess.Popen(["make"], cwd = path,\
+    stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.lower().find("error") != -1:
+    return stderr
+  return None
+
+def run(path, option):
+  p = subprocess.Popen(["./trace_analyzer", option],\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  stdout, stderr = utils.run_process(p)
+  if stderr:
+    return stderr
+  if not stdout:
+    return "stdout is empty"
+  if stdout.find("Usage") == -1:
+    return stdout
+  return None
+
+def main(option):
+  path = utils.get_tool_build_path("trace_analyzer")
+  log = config(path)
+  if log:
+    return log
+  log = build(path)
+  if log:
+    return log
+  log = run(path, option)
+  if log:
+    return log
+
+if __name__ == "__main__":
+  option = "-h"
+  log = main(option)
+  if log:
+    print(log)
\ No newline at end of file
@@ -0,0 +1,123 @@
+import os
+import signal
+import subprocess
+import sys
+import time
+
+from samples import dpc_gemm
+from tools import onetrace
+import utils
+
+def config(path):
+  p = subprocess.Popen(["cmake",\
+    "-DCMAKE_BUILD_TYPE=" + utils.get_build_flag(), ".."],\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.find("CMake Error") != -1:
+    return stderr
+  return None
+
+def build(path):
+  p = subprocess.Popen(["make"], cwd = path,\
+    stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  p.wait()
+  stdout, stderr = utils.run_process(p)
+  if stderr and stderr.lower().find("error") != -1:
+    return stderr
+  return None
+
+# Traced application streams its records through the daemon, and the node
+# trace stored by the daemon should hold them
+def run_node_trace(path):
+  tool_path = utils.get_tool_build_path("onetrace")
+  log = onetrace.config(tool_path)
+  if log:
+    return log
+  log = onetrace.build(tool_path)
+  if log:
+    return log
+
+  trace_file = os.path.join(path, "node_trace.bin")
+  if os.path.isfile(trace_file):
+    os.remove(trace_file)
+
+  daemon = subprocess.Popen(["./trace_daemon", "-o", trace_file],\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  time.sleep(1)
+
+  app_folder = utils.get_sample_build_path("dpc_gemm")
+  app_file = os.path.join(app_folder, "dpc_gemm")
+  p = subprocess.Popen(["./onetrace", "--node-trace", app_file, "gpu",\
+    "1024", "1"], cwd = tool_path,\
+    stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  stdout, stderr = utils.run_process(p)
+  daemon.send_signal(signal.SIGINT)
+  if not stdout:
+    utils.run_process(daemon)
+    return "stdout is empty"
+  if stdout.find(" CORRECT") == -1:
+    utils.run_process(daemon)
+    return stdout
+  if stderr and stderr.find("WARNING") != -1:
+    utils.run_process(daemon)
+    return stderr
+
+  stdout, stderr = utils.run_process(daemon)
+  if not stderr or stderr.find("[INFO] Node trace") == -1:
+    return stderr if stderr else "Node trace is not stored"
+  if stderr.find("[ERROR]") != -1 or stderr.find("dropped") != -1:
+    return stderr
+
+  sys.path.insert(0, os.path.join(utils.get_root_path(),\
+    os.path.join("tools", "utils")))
+  from binary_trace_converter import read_node_trace
+  try:
+    trace_list = read_node_trace(trace_file)
+  except ValueError as error:
+    return str(error)
+  if len(trace_list) == 0:
+    return "Node trace has no process streams"
+  for header, strings, records in trace_list:
+    if len(records) == 0:
+      return "Process " + str(header["pid"]) + " has no records"
+  return None
+
+def run(path, option):
+  if option == "--node-trace":
+    return run_node_trace(path)
+
+  p = subprocess.Popen(["./trace_daemon", option],\
+    cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  stdout, stderr = utils.run_process(p)
+  if stderr:
+    return stderr
+  if not stdout:
+    return "stdout is empty"
+  if stdout.find("Usage") == -1:
+    return stdout
+  return None
+
+def main(option):
+  path = utils.get_tool_build_path("trace_daemon")
+  if option == "--node-trace":
+    log = dpc_gemm.main("gpu")
+    if log:
+      return log
+  log = config(path)
+  if log:
+    return log
+  log = build(path)
+  if log:
+    return log
+  log = run(path, option)
+  if log:
+    return log
+
+if __name__ == "__main__":
+  option = "-h"
+  if len(sys.argv) > 1 and sys.argv[1] == "--node-trace":
+    option = "--node-trace"
+  log = main(option)
+  if log:
+    print(log)
\ No newline at end of file
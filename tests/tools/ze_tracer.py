@@ -37,6 +37,51 @@ def run(path, option):
     app_file = os.path.join(app_folder, "omp_gemm")
     p = subprocess.Popen(["./ze_tracer", "-h", "-d", "-t", app_file, "gpu", "1024", "1"],\
       cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--module-dump":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./ze_tracer", "--module-dump", ".", "-c", app_file, "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--poll-interval":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./ze_tracer", "-d", "--poll-interval", "100", app_file, "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--include-api":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./ze_tracer", "-c", "--include-api", "zeCommandList*,zeKernel*", "--exclude-api", "zeKernelSet*", app_file, "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--kernel-sampling":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./ze_tracer", "-d", "--kernel-sampling", "2", app_file, "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--capture-kernel":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./ze_tracer", "-d", "--capture-kernel", "GEMM", app_file, "1024", "2"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--capture-duration":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./ze_tracer", "-d", "--capture-delay", "1", "--capture-duration", "60000", app_file, "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--interval":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./ze_tracer", "-h", "-d", "--interval", "1", app_file, "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--kernel-grouping":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./ze_tracer", "-d", "--kernel-grouping", "local", app_file, "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
+  elif option == "--compress":
+    app_folder = utils.get_sample_build_path("ze_gemm")
+    app_file = os.path.join(app_folder, "ze_gemm")
+    p = subprocess.Popen(["./ze_tracer", "-c", "-o", "compress.log", "--compress", "zstd", app_file, "1024", "1"],\
+      cwd = path, stdout = subprocess.PIPE, stderr = subprocess.PIPE)
   else:
     app_folder = utils.get_sample_build_path("ze_gemm")
     app_file = os.path.join(app_folder, "ze_gemm")
@@ -51,6 +96,44 @@ def run(path, option):
     return stdout
   if stderr.find("WARNING") != -1:
     return stderr
+  if option == "--poll-interval":
+    if stderr.find("GEMM") == -1:
+      return stderr
+  if option == "--include-api":
+    if stderr.find("zeCommandListAppendLaunchKernel") == -1:
+      return stderr
+    if stderr.find("zeKernelSetArgumentValue") != -1 or\
+        stderr.find("zeMemAllocDevice") != -1:
+      return stderr
+  if option == "--kernel-sampling":
+    if stderr.find("GEMM") == -1:
+      return stderr
+  if option == "--capture-kernel":
+    if stderr.find("GEMM") == -1:
+      return stderr
+  if option == "--capture-duration":
+    if stderr.find("GEMM") == -1:
+      return stderr
+  if option == "--interval":
+    csv_file = os.path.join(path, "zet_trace." + str(p.pid) + ".intervals.csv")
+    if not os.path.isfile(csv_file):
+      return csv_file + " is not found"
+    with open(csv_file) as f:
+      csv = f.read()
+    if not csv.startswith("Window,Start (ns),End (ns),Type,Name,") or\
+        csv.find(",Kernel,") == -1 or csv.find(",Function,") == -1:
+      return csv
+  if option == "--kernel-grouping":
+    if stderr.find("GEMM[SIMD") == -1:
+      return stderr
+  if option == "--compress":
+    log_file = os.path.join(path, "compress." + str(p.pid) + ".log.zst")
+    if not os.path.isfile(log_file):
+      return log_file + " is not found"
+    with open(log_file, "rb") as f:
+      magic = f.read(4)
+    if magic != bytes.fromhex("28b52ffd"):
+      return log_file + " is not compressed with zstd"
   return None
 
 def main(option):
@@ -89,6 +172,58 @@ if __name__ == "__main__":
     option = "--chrome-kernel-timeline"
   if len(sys.argv) > 1 and sys.argv[1] == "--chrome-device-stages":
     option = "--chrome-device-stages"
+  if len(sys.argv) > 1 and sys.argv[1] == "--async-logging":
+    option = "--async-logging"
+  if len(sys.argv) > 1 and sys.argv[1] == "--binary-trace":
+    option = "--binary-trace"
+  if len(sys.argv) > 1 and sys.argv[1] == "--perfetto-trace":
+    option = "--perfetto-trace"
+  if len(sys.argv) > 1 and sys.argv[1] == "--batch-timestamps":
+    option = "--batch-timestamps"
+  if len(sys.argv) > 1 and sys.argv[1] == "--queue-timing":
+    option = "--queue-timing"
+  if len(sys.argv) > 1 and sys.argv[1] == "--dependency-graph":
+    option = "--dependency-graph"
+  if len(sys.argv) > 1 and sys.argv[1] == "--call-stacks":
+    option = "--call-stacks"
+  if len(sys.argv) > 1 and sys.argv[1] == "--submission-spans":
+    option = "--submission-spans"
+  if len(sys.argv) > 1 and sys.argv[1] == "--wait-analysis":
+    option = "--wait-analysis"
+  if len(sys.argv) > 1 and sys.argv[1] == "--transfer-timing":
+    option = "--transfer-timing"
+  if len(sys.argv) > 1 and sys.argv[1] == "--tile-timing":
+    option = "--tile-timing"
+  if len(sys.argv) > 1 and sys.argv[1] == "--module-dump":
+    option = "--module-dump"
+  if len(sys.argv) > 1 and sys.argv[1] == "--memory-tracking":
+    option = "--memory-tracking"
+  if len(sys.argv) > 1 and sys.argv[1] == "--alloc-churn":
+    option = "--alloc-churn"
+  if len(sys.argv) > 1 and sys.argv[1] == "--save-tables":
+    option = "--save-tables"
+  if len(sys.argv) > 1 and sys.argv[1] == "--overhead":
+    option = "--overhead"
+  if len(sys.argv) > 1 and sys.argv[1] == "--subtract-overhead":
+    option = "--subtract-overhead"
+  if len(sys.argv) > 1 and sys.argv[1] == "--node-trace":
+    option = "--node-trace"
+  if len(sys.argv) > 1 and sys.argv[1] == "--poll-interval":
+    option = "--poll-interval"
+  if len(sys.argv) > 1 and sys.argv[1] == "--include-api":
+    option = "--include-api"
+  if len(sys.argv) > 1 and sys.argv[1] == "--kernel-sampling":
+    option = "--kernel-sampling"
+  if len(sys.argv) > 1 and sys.argv[1] == "--capture-kernel":
+    option = "--capture-kernel"
+  if len(sys.argv) > 1 and sys.argv[1] == "--capture-duration":
+    option = "--capture-duration"
+  if len(sys.argv) > 1 and sys.argv[1] == "--interval":
+    option = "--interval"
+  if len(sys.argv) > 1 and sys.argv[1] == "--kernel-grouping":
+    option = "--kernel-grouping"
+  if len(sys.argv) > 1 and sys.argv[1] == "--compress":
+    option = "--compress"
   if len(sys.argv) > 1 and sys.argv[1] == "dpc":
     option = "dpc"
   if len(sys.argv) > 1 and sys.argv[1] == "omp":
@@ -29,6 +29,15 @@ def get_tool_build_path(name):
     os.mkdir(path)
   return path
 
+def get_bench_build_path(name):
+  path = os.path.join(get_script_path(), "bench")
+  path = os.path.join(path, name)
+  assert os.path.exists(path)
+  path = os.path.join(path, "build")
+  if not os.path.exists(path):
+    os.mkdir(path)
+  return path
+
 def get_build_utils_path():
   head, tail = os.path.split(get_script_path())
   path = os.path.join(head, "build_utils")
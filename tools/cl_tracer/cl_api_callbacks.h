@@ -4,6 +4,8 @@
 // SPDX-License-Identifier: MIT
 // =============================================================
 
+// Generated with gen_tracing_callbacks.py, do not edit
+
 #ifndef PTI_TOOLS_CL_TRACER_CL_API_CALLBACKS_H_
 #define PTI_TOOLS_CL_TRACER_CL_API_CALLBACKS_H_
 
@@ -11,111 +13,80 @@
 
 static thread_local cl_int current_error = CL_SUCCESS;
 
-static void clGetSupportedImageFormatsOnEnter(
+static void clBuildProgramOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetSupportedImageFormats* params =
-    reinterpret_cast<const cl_params_clGetSupportedImageFormats*>(
+  const cl_params_clBuildProgram* params =
+    reinterpret_cast<const cl_params_clBuildProgram*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " imageType = " << *(params->imageType);
-  stream << " numEntries = " << *(params->numEntries);
-  stream << " imageFormats = " << *(params->imageFormats);
-  stream << " numImageFormats = " << *(params->numImageFormats);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clBuildProgram, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->program));
+  record.AddArg(*(params->numDevices));
+  record.AddArg(*(params->deviceList));
+  record.AddString(*(params->options));
+  record.AddArg(*(params->funcNotify));
+  record.AddArg(*(params->userData));
+  collector->Log(record);
 }
 
-static void clGetSupportedImageFormatsOnExit(
+static void clBuildProgramOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clBuildProgram, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetKernelInfoOnEnter(
+static void clCloneKernelOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetKernelInfo* params =
-    reinterpret_cast<const cl_params_clGetKernelInfo*>(
+  const cl_params_clCloneKernel* params =
+    reinterpret_cast<const cl_params_clCloneKernel*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " kernel = " << *(params->kernel);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCloneKernel, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->sourceKernel));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clGetKernelInfoOnExit(
+static void clCloneKernelOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCloneKernel, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCloneKernel* params =
+    reinterpret_cast<const cl_params_clCloneKernel*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_kernel* result =
+    reinterpret_cast<cl_kernel*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
 static void clCompileProgramOnEnter(
@@ -126,884 +97,761 @@ static void clCompileProgramOnEnter(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " program = " << *(params->program);
-  stream << " numDevices = " << *(params->numDevices);
-  stream << " deviceList = " << *(params->deviceList);
-  if (*(params->options) == nullptr) {
-    stream << " options = " << "0";
-  } else if (strlen(*(params->options)) == 0) {
-    stream << " options = \"\"";
-  } else {
-    stream << " options = \"" << *(params->options) << "\"";
-  }
-  stream << " numInputHeaders = " << *(params->numInputHeaders);
-  stream << " inputHeaders = " << *(params->inputHeaders);
-  stream << " headerIncludeNames = " << *(params->headerIncludeNames);
-  stream << " funcNotify = " << *(params->funcNotify);
-  stream << " userData = " << *(params->userData);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCompileProgram, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->program));
+  record.AddArg(*(params->numDevices));
+  record.AddArg(*(params->deviceList));
+  record.AddString(*(params->options));
+  record.AddArg(*(params->numInputHeaders));
+  record.AddArg(*(params->inputHeaders));
+  record.AddArg(*(params->headerIncludeNames));
+  record.AddArg(*(params->funcNotify));
+  record.AddArg(*(params->userData));
+  collector->Log(record);
 }
 
 static void clCompileProgramOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCompileProgram, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clSetEventCallbackOnEnter(
+static void clCreateBufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clSetEventCallback* params =
-    reinterpret_cast<const cl_params_clSetEventCallback*>(
+  const cl_params_clCreateBuffer* params =
+    reinterpret_cast<const cl_params_clCreateBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " event = " << *(params->event);
-  stream << " commandExecCallbackType = " <<
-    *(params->commandExecCallbackType);
-  stream << " funcNotify = " << *(params->funcNotify);
-  stream << " userData = " << *(params->userData);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateBuffer, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->size));
+  record.AddArg(*(params->hostPtr));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clSetEventCallbackOnExit(
+static void clCreateBufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateBuffer, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateBuffer* params =
+    reinterpret_cast<const cl_params_clCreateBuffer*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clUnloadPlatformCompilerOnEnter(
+static void clCreateCommandQueueOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clUnloadPlatformCompiler* params =
-    reinterpret_cast<const cl_params_clUnloadPlatformCompiler*>(
+  const cl_params_clCreateCommandQueue* params =
+    reinterpret_cast<const cl_params_clCreateCommandQueue*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " platform = " << *(params->platform);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateCommandQueue, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->device));
+  record.AddArg(*(params->properties));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clUnloadPlatformCompilerOnExit(
+static void clCreateCommandQueueOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateCommandQueue, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateCommandQueue* params =
+    reinterpret_cast<const cl_params_clCreateCommandQueue*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_command_queue* result =
+    reinterpret_cast<cl_command_queue*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetPlatformIDsOnEnter(
+static void clCreateCommandQueueWithPropertiesOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetPlatformIDs* params =
-    reinterpret_cast<const cl_params_clGetPlatformIDs*>(
+  const cl_params_clCreateCommandQueueWithProperties* params =
+    reinterpret_cast<const cl_params_clCreateCommandQueueWithProperties*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " numEntries = " << *(params->numEntries);
-  stream << " platforms = " << *(params->platforms);
-  stream << " numPlatforms = " << *(params->numPlatforms);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateCommandQueueWithProperties, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->device));
+  record.AddArg(*(params->properties));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clGetPlatformIDsOnExit(
+static void clCreateCommandQueueWithPropertiesOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateCommandQueueWithProperties, data, start, end,
+      collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateCommandQueueWithProperties* params =
+    reinterpret_cast<const cl_params_clCreateCommandQueueWithProperties*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_command_queue* result =
+    reinterpret_cast<cl_command_queue*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clUnloadCompilerOnEnter(
+static void clCreateContextOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clUnloadCompiler* params =
-    reinterpret_cast<const cl_params_clUnloadCompiler*>(
+  const cl_params_clCreateContext* params =
+    reinterpret_cast<const cl_params_clCreateContext*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateContext, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->properties));
+  record.AddArg(*(params->numDevices));
+  record.AddArg(*(params->devices));
+  record.AddArg(*(params->funcNotify));
+  record.AddArg(*(params->userData));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clUnloadCompilerOnExit(
+static void clCreateContextOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateContext, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateContext* params =
+    reinterpret_cast<const cl_params_clCreateContext*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_context* result =
+    reinterpret_cast<cl_context*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueBarrierWithWaitListOnEnter(
+static void clCreateContextFromTypeOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueBarrierWithWaitList* params =
-    reinterpret_cast<const cl_params_clEnqueueBarrierWithWaitList*>(
+  const cl_params_clCreateContextFromType* params =
+    reinterpret_cast<const cl_params_clCreateContextFromType*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateContextFromType, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->properties));
+  record.AddArg(*(params->deviceType));
+  record.AddArg(*(params->funcNotify));
+  record.AddArg(*(params->userData));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clEnqueueBarrierWithWaitListOnExit(
+static void clCreateContextFromTypeOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateContextFromType, data, start, end,
+      collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateContextFromType* params =
+    reinterpret_cast<const cl_params_clCreateContextFromType*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_context* result =
+    reinterpret_cast<cl_context*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueMapBufferOnEnter(
+static void clCreateFromGLBufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueMapBuffer* params =
-    reinterpret_cast<const cl_params_clEnqueueMapBuffer*>(
+  const cl_params_clCreateFromGLBuffer* params =
+    reinterpret_cast<const cl_params_clCreateFromGLBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " buffer = " << *(params->buffer);
-  stream << " blockingMap = " << *(params->blockingMap);
-  stream << " mapFlags = " << *(params->mapFlags);
-  stream << " offset = " << *(params->offset);
-  stream << " cb = " << *(params->cb);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLBuffer, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->bufobj));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
   if (*(params->errcodeRet) == nullptr) {
     *(params->errcodeRet) = &current_error;
   }
 }
 
-static void clEnqueueMapBufferOnExit(
+static void clCreateFromGLBufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLBuffer, data, start, end, collector->NeedTid());
 
-  const cl_params_clEnqueueMapBuffer* params =
-    reinterpret_cast<const cl_params_clEnqueueMapBuffer*>(
+  const cl_params_clCreateFromGLBuffer* params =
+    reinterpret_cast<const cl_params_clCreateFromGLBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  void ** result =
-    reinterpret_cast<void **>(data->functionReturnValue);
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
   PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  record.AddArg(*result);
 
   PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateImage3DOnEnter(
+static void clCreateFromGLRenderbufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateImage3D* params =
-    reinterpret_cast<const cl_params_clCreateImage3D*>(
+  const cl_params_clCreateFromGLRenderbuffer* params =
+    reinterpret_cast<const cl_params_clCreateFromGLRenderbuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " imageFormat = " << *(params->imageFormat);
-  stream << " imageWidth = " << *(params->imageWidth);
-  stream << " imageHeight = " << *(params->imageHeight);
-  stream << " imageDepth = " << *(params->imageDepth);
-  stream << " imageRowPitch = " << *(params->imageRowPitch);
-  stream << " imageSlicePitch = " << *(params->imageSlicePitch);
-  stream << " hostPtr = " << *(params->hostPtr);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLRenderbuffer, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->renderbuffer));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
   if (*(params->errcodeRet) == nullptr) {
     *(params->errcodeRet) = &current_error;
   }
 }
 
-static void clCreateImage3DOnExit(
+static void clCreateFromGLRenderbufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLRenderbuffer, data, start, end,
+      collector->NeedTid());
 
-  const cl_params_clCreateImage3D* params =
-    reinterpret_cast<const cl_params_clCreateImage3D*>(
+  const cl_params_clCreateFromGLRenderbuffer* params =
+    reinterpret_cast<const cl_params_clCreateFromGLRenderbuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
   cl_mem* result =
     reinterpret_cast<cl_mem*>(data->functionReturnValue);
   PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  record.AddArg(*result);
 
   PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetKernelArgInfoOnEnter(
+static void clCreateFromGLTextureOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetKernelArgInfo* params =
-    reinterpret_cast<const cl_params_clGetKernelArgInfo*>(
+  const cl_params_clCreateFromGLTexture* params =
+    reinterpret_cast<const cl_params_clCreateFromGLTexture*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLTexture, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->target));
+  record.AddArg(*(params->miplevel));
+  record.AddArg(*(params->texture));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  stream << " kernel = " << *(params->kernel);
-  stream << " argIndx = " << *(params->argIndx);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clGetKernelArgInfoOnExit(
+static void clCreateFromGLTextureOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLTexture, data, start, end,
+      collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateFromGLTexture* params =
+    reinterpret_cast<const cl_params_clCreateFromGLTexture*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueSVMFreeOnEnter(
+static void clCreateFromGLTexture2DOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueSVMFree* params =
-    reinterpret_cast<const cl_params_clEnqueueSVMFree*>(
+  const cl_params_clCreateFromGLTexture2D* params =
+    reinterpret_cast<const cl_params_clCreateFromGLTexture2D*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " numSvmPointers = " << *(params->numSvmPointers);
-  stream << " svmPointers = " << *(params->svmPointers);
-  stream << " pfnFreeFunc = " << *(params->pfnFreeFunc);
-  stream << " userData = " << *(params->userData);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLTexture2D, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->target));
+  record.AddArg(*(params->miplevel));
+  record.AddArg(*(params->texture));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clEnqueueSVMFreeOnExit(
+static void clCreateFromGLTexture2DOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLTexture2D, data, start, end,
+      collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateFromGLTexture2D* params =
+    reinterpret_cast<const cl_params_clCreateFromGLTexture2D*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueCopyImageToBufferOnEnter(
+static void clCreateFromGLTexture3DOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueCopyImageToBuffer* params =
-    reinterpret_cast<const cl_params_clEnqueueCopyImageToBuffer*>(
+  const cl_params_clCreateFromGLTexture3D* params =
+    reinterpret_cast<const cl_params_clCreateFromGLTexture3D*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " srcImage = " << *(params->srcImage);
-  stream << " dstBuffer = " << *(params->dstBuffer);
-  stream << " srcOrigin = " << *(params->srcOrigin);
-  stream << " region = " << *(params->region);
-  stream << " dstOffset = " << *(params->dstOffset);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLTexture3D, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->target));
+  record.AddArg(*(params->miplevel));
+  record.AddArg(*(params->texture));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clEnqueueCopyImageToBufferOnExit(
+static void clCreateFromGLTexture3DOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateFromGLTexture3D, data, start, end,
+      collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateFromGLTexture3D* params =
+    reinterpret_cast<const cl_params_clCreateFromGLTexture3D*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetContextInfoOnEnter(
+static void clCreateImageOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetContextInfo* params =
-    reinterpret_cast<const cl_params_clGetContextInfo*>(
+  const cl_params_clCreateImage* params =
+    reinterpret_cast<const cl_params_clCreateImage*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateImage, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->imageFormat));
+  record.AddArg(*(params->imageDesc));
+  record.AddArg(*(params->hostPtr));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clGetContextInfoOnExit(
+static void clCreateImageOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateImage, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateImage* params =
+    reinterpret_cast<const cl_params_clCreateImage*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clRetainCommandQueueOnEnter(
+static void clCreateImage2DOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clRetainCommandQueue* params =
-    reinterpret_cast<const cl_params_clRetainCommandQueue*>(
+  const cl_params_clCreateImage2D* params =
+    reinterpret_cast<const cl_params_clCreateImage2D*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateImage2D, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->imageFormat));
+  record.AddArg(*(params->imageWidth));
+  record.AddArg(*(params->imageHeight));
+  record.AddArg(*(params->imageRowPitch));
+  record.AddArg(*(params->hostPtr));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clRetainCommandQueueOnExit(
+static void clCreateImage2DOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateImage2D, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateImage2D* params =
+    reinterpret_cast<const cl_params_clCreateImage2D*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
+
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueWriteImageOnEnter(
+static void clCreateImage3DOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueWriteImage* params =
-    reinterpret_cast<const cl_params_clEnqueueWriteImage*>(
+  const cl_params_clCreateImage3D* params =
+    reinterpret_cast<const cl_params_clCreateImage3D*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " image = " << *(params->image);
-  stream << " blockingWrite = " << *(params->blockingWrite);
-  stream << " origin = " << *(params->origin);
-  stream << " region = " << *(params->region);
-  stream << " inputRowPitch = " << *(params->inputRowPitch);
-  stream << " inputSlicePitch = " << *(params->inputSlicePitch);
-  stream << " ptr = " << *(params->ptr);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateImage3D, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->imageFormat));
+  record.AddArg(*(params->imageWidth));
+  record.AddArg(*(params->imageHeight));
+  record.AddArg(*(params->imageDepth));
+  record.AddArg(*(params->imageRowPitch));
+  record.AddArg(*(params->imageSlicePitch));
+  record.AddArg(*(params->hostPtr));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clEnqueueWriteImageOnExit(
+static void clCreateImage3DOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateImage3D, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateImage3D* params =
+    reinterpret_cast<const cl_params_clCreateImage3D*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueWaitForEventsOnEnter(
+static void clCreateKernelOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueWaitForEvents* params =
-    reinterpret_cast<const cl_params_clEnqueueWaitForEvents*>(
+  const cl_params_clCreateKernel* params =
+    reinterpret_cast<const cl_params_clCreateKernel*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateKernel, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->program));
+  record.AddString(*(params->kernelName));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
+
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
   }
-  stream << data->functionName << ":";
+}
+
+static void clCreateKernelOnExit(
+    cl_callback_data* data, uint64_t start, uint64_t end,
+    ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateKernel, data, start, end, collector->NeedTid());
 
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " numEvents = " << *(params->numEvents);
-  stream << " eventList = " << *(params->eventList);
-  stream << std::endl;
+  const cl_params_clCreateKernel* params =
+    reinterpret_cast<const cl_params_clCreateKernel*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_kernel* result =
+    reinterpret_cast<cl_kernel*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  collector->Log(stream.str());
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
+
+  collector->Log(record);
 }
 
-static void clEnqueueWaitForEventsOnExit(
+static void clCreateKernelsInProgramOnEnter(
+    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  const cl_params_clCreateKernelsInProgram* params =
+    reinterpret_cast<const cl_params_clCreateKernelsInProgram*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateKernelsInProgram, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->program));
+  record.AddArg(*(params->numKernels));
+  record.AddArg(*(params->kernels));
+  record.AddArg(*(params->numKernelsRet));
+  collector->Log(record);
+}
+
+static void clCreateKernelsInProgramOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateKernelsInProgram, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueSVMUnmapOnEnter(
+static void clCreatePipeOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueSVMUnmap* params =
-    reinterpret_cast<const cl_params_clEnqueueSVMUnmap*>(
+  const cl_params_clCreatePipe* params =
+    reinterpret_cast<const cl_params_clCreatePipe*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " svmPtr = " << *(params->svmPtr);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreatePipe, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->pipePacketSize));
+  record.AddArg(*(params->pipeMaxPackets));
+  record.AddArg(*(params->properties));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clEnqueueSVMUnmapOnExit(
+static void clCreatePipeOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreatePipe, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreatePipe* params =
+    reinterpret_cast<const cl_params_clCreatePipe*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
 static void clCreateProgramWithBinaryOnEnter(
@@ -1014,26 +862,17 @@ static void clCreateProgramWithBinaryOnEnter(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " numDevices = " << *(params->numDevices);
-  stream << " deviceList = " << *(params->deviceList);
-  stream << " lengths = " << *(params->lengths);
-  stream << " binaries = " << *(params->binaries);
-  stream << " binaryStatus = " << *(params->binaryStatus);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateProgramWithBinary, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->numDevices));
+  record.AddArg(*(params->deviceList));
+  record.AddArg(*(params->lengths));
+  record.AddArg(*(params->binaries));
+  record.AddArg(*(params->binaryStatus));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
   if (*(params->errcodeRet) == nullptr) {
     *(params->errcodeRet) = &current_error;
@@ -1044,16 +883,9 @@ static void clCreateProgramWithBinaryOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateProgramWithBinary, data, start, end,
+      collector->NeedTid());
 
   const cl_params_clCreateProgramWithBinary* params =
     reinterpret_cast<const cl_params_clCreateProgramWithBinary*>(
@@ -1063,6327 +895,7401 @@ static void clCreateProgramWithBinaryOnExit(
   cl_program* result =
     reinterpret_cast<cl_program*>(data->functionReturnValue);
   PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  record.AddArg(*result);
 
   PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueFillImageOnEnter(
+static void clCreateProgramWithBuiltInKernelsOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueFillImage* params =
-    reinterpret_cast<const cl_params_clEnqueueFillImage*>(
+  const cl_params_clCreateProgramWithBuiltInKernels* params =
+    reinterpret_cast<const cl_params_clCreateProgramWithBuiltInKernels*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " image = " << *(params->image);
-  stream << " fillColor = " << *(params->fillColor);
-  stream << " origin = " << *(params->origin);
-  stream << " region = " << *(params->region);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateProgramWithBuiltInKernels, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->numDevices));
+  record.AddArg(*(params->deviceList));
+  record.AddString(*(params->kernelNames));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clEnqueueFillImageOnExit(
+static void clCreateProgramWithBuiltInKernelsOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateProgramWithBuiltInKernels, data, start, end,
+      collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateProgramWithBuiltInKernels* params =
+    reinterpret_cast<const cl_params_clCreateProgramWithBuiltInKernels*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_program* result =
+    reinterpret_cast<cl_program*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateFromGLTexture2DOnEnter(
+static void clCreateProgramWithILOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateFromGLTexture2D* params =
-    reinterpret_cast<const cl_params_clCreateFromGLTexture2D*>(
+  const cl_params_clCreateProgramWithIL* params =
+    reinterpret_cast<const cl_params_clCreateProgramWithIL*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " target = " << *(params->target);
-  stream << " miplevel = " << *(params->miplevel);
-  stream << " texture = " << *(params->texture);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateProgramWithIL, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->il));
+  record.AddArg(*(params->length));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
   if (*(params->errcodeRet) == nullptr) {
     *(params->errcodeRet) = &current_error;
   }
 }
 
-static void clCreateFromGLTexture2DOnExit(
+static void clCreateProgramWithILOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateProgramWithIL, data, start, end,
+      collector->NeedTid());
 
-  const cl_params_clCreateFromGLTexture2D* params =
-    reinterpret_cast<const cl_params_clCreateFromGLTexture2D*>(
+  const cl_params_clCreateProgramWithIL* params =
+    reinterpret_cast<const cl_params_clCreateProgramWithIL*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  cl_program* result =
+    reinterpret_cast<cl_program*>(data->functionReturnValue);
   PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  record.AddArg(*result);
 
   PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clSetKernelExecInfoOnEnter(
+static void clCreateProgramWithSourceOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clSetKernelExecInfo* params =
-    reinterpret_cast<const cl_params_clSetKernelExecInfo*>(
+  const cl_params_clCreateProgramWithSource* params =
+    reinterpret_cast<const cl_params_clCreateProgramWithSource*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateProgramWithSource, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->count));
+  record.AddArg(*(params->strings));
+  record.AddArg(*(params->lengths));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  stream << " kernel = " << *(params->kernel);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clSetKernelExecInfoOnExit(
+static void clCreateProgramWithSourceOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateProgramWithSource, data, start, end,
+      collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateProgramWithSource* params =
+    reinterpret_cast<const cl_params_clCreateProgramWithSource*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  cl_program* result =
+    reinterpret_cast<cl_program*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
+
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueReleaseGLObjectsOnEnter(
+static void clCreateSamplerOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueReleaseGLObjects* params =
-    reinterpret_cast<const cl_params_clEnqueueReleaseGLObjects*>(
+  const cl_params_clCreateSampler* params =
+    reinterpret_cast<const cl_params_clCreateSampler*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " numObjects = " << *(params->numObjects);
-  stream << " memObjects = " << *(params->memObjects);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateSampler, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->normalizedCoords));
+  record.AddArg(*(params->addressingMode));
+  record.AddArg(*(params->filterMode));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clEnqueueReleaseGLObjectsOnExit(
+static void clCreateSamplerOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateSampler, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateSampler* params =
+    reinterpret_cast<const cl_params_clCreateSampler*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_sampler* result =
+    reinterpret_cast<cl_sampler*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetDeviceIDsOnEnter(
+static void clCreateSamplerWithPropertiesOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetDeviceIDs* params =
-    reinterpret_cast<const cl_params_clGetDeviceIDs*>(
+  const cl_params_clCreateSamplerWithProperties* params =
+    reinterpret_cast<const cl_params_clCreateSamplerWithProperties*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " platform = " << *(params->platform);
-  stream << " deviceType = " << *(params->deviceType);
-  stream << " numEntries = " << *(params->numEntries);
-  stream << " devices = " << *(params->devices);
-  stream << " numDevices = " << *(params->numDevices);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateSamplerWithProperties, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->samplerProperties));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clGetDeviceIDsOnExit(
+static void clCreateSamplerWithPropertiesOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateSamplerWithProperties, data, start, end,
+      collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateSamplerWithProperties* params =
+    reinterpret_cast<const cl_params_clCreateSamplerWithProperties*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_sampler* result =
+    reinterpret_cast<cl_sampler*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clReleaseMemObjectOnEnter(
+static void clCreateSubBufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clReleaseMemObject* params =
-    reinterpret_cast<const cl_params_clReleaseMemObject*>(
+  const cl_params_clCreateSubBuffer* params =
+    reinterpret_cast<const cl_params_clCreateSubBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " memobj = " << *(params->memobj);
-  stream << std::endl;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateSubBuffer, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->buffer));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->bufferCreateType));
+  record.AddArg(*(params->bufferCreateInfo));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
-  collector->Log(stream.str());
+  if (*(params->errcodeRet) == nullptr) {
+    *(params->errcodeRet) = &current_error;
+  }
 }
 
-static void clReleaseMemObjectOnExit(
+static void clCreateSubBufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateSubBuffer, data, start, end, collector->NeedTid());
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  const cl_params_clCreateSubBuffer* params =
+    reinterpret_cast<const cl_params_clCreateSubBuffer*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  cl_mem* result =
+    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  PTI_ASSERT(*(params->errcodeRet) != nullptr);
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetGLObjectInfoOnEnter(
+static void clCreateSubDevicesOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetGLObjectInfo* params =
-    reinterpret_cast<const cl_params_clGetGLObjectInfo*>(
+  const cl_params_clCreateSubDevices* params =
+    reinterpret_cast<const cl_params_clCreateSubDevices*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " memobj = " << *(params->memobj);
-  stream << " glObjectType = " << *(params->glObjectType);
-  stream << " glObjectName = " << *(params->glObjectName);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateSubDevices, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->inDevice));
+  record.AddArg(*(params->properties));
+  record.AddArg(*(params->numDevices));
+  record.AddArg(*(params->outDevices));
+  record.AddArg(*(params->numDevicesRet));
+  collector->Log(record);
 }
 
-static void clGetGLObjectInfoOnExit(
+static void clCreateSubDevicesOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateSubDevices, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateFromGLRenderbufferOnEnter(
+static void clCreateUserEventOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateFromGLRenderbuffer* params =
-    reinterpret_cast<const cl_params_clCreateFromGLRenderbuffer*>(
+  const cl_params_clCreateUserEvent* params =
+    reinterpret_cast<const cl_params_clCreateUserEvent*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " renderbuffer = " << *(params->renderbuffer);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateUserEvent, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
   if (*(params->errcodeRet) == nullptr) {
     *(params->errcodeRet) = &current_error;
   }
 }
 
-static void clCreateFromGLRenderbufferOnExit(
+static void clCreateUserEventOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clCreateUserEvent, data, start, end, collector->NeedTid());
 
-  const cl_params_clCreateFromGLRenderbuffer* params =
-    reinterpret_cast<const cl_params_clCreateFromGLRenderbuffer*>(
+  const cl_params_clCreateUserEvent* params =
+    reinterpret_cast<const cl_params_clCreateUserEvent*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  cl_event* result =
+    reinterpret_cast<cl_event*>(data->functionReturnValue);
   PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  record.AddArg(*result);
 
   PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clReleaseContextOnEnter(
+static void clEnqueueAcquireGLObjectsOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clReleaseContext* params =
-    reinterpret_cast<const cl_params_clReleaseContext*>(
+  const cl_params_clEnqueueAcquireGLObjects* params =
+    reinterpret_cast<const cl_params_clEnqueueAcquireGLObjects*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueAcquireGLObjects, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->numObjects));
+  record.AddArg(*(params->memObjects));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clReleaseContextOnExit(
+static void clEnqueueAcquireGLObjectsOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueAcquireGLObjects, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueUnmapMemObjectOnEnter(
+static void clEnqueueBarrierOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueUnmapMemObject* params =
-    reinterpret_cast<const cl_params_clEnqueueUnmapMemObject*>(
+  const cl_params_clEnqueueBarrier* params =
+    reinterpret_cast<const cl_params_clEnqueueBarrier*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " memobj = " << *(params->memobj);
-  stream << " mappedPtr = " << *(params->mappedPtr);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueBarrier, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  collector->Log(record);
 }
 
-static void clEnqueueUnmapMemObjectOnExit(
+static void clEnqueueBarrierOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueBarrier, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateContextOnEnter(
+static void clEnqueueBarrierWithWaitListOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateContext* params =
-    reinterpret_cast<const cl_params_clCreateContext*>(
+  const cl_params_clEnqueueBarrierWithWaitList* params =
+    reinterpret_cast<const cl_params_clEnqueueBarrierWithWaitList*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " properties = " << *(params->properties);
-  stream << " numDevices = " << *(params->numDevices);
-  stream << " devices = " << *(params->devices);
-  stream << " funcNotify = " << *(params->funcNotify);
-  stream << " userData = " << *(params->userData);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueBarrierWithWaitList, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clCreateContextOnExit(
+static void clEnqueueBarrierWithWaitListOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueBarrierWithWaitList, data, start, end,
+      collector->NeedTid());
 
-  const cl_params_clCreateContext* params =
-    reinterpret_cast<const cl_params_clCreateContext*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
-
-  cl_context* result =
-    reinterpret_cast<cl_context*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetHostTimerOnEnter(
+static void clEnqueueCopyBufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetHostTimer* params =
-    reinterpret_cast<const cl_params_clGetHostTimer*>(
+  const cl_params_clEnqueueCopyBuffer* params =
+    reinterpret_cast<const cl_params_clEnqueueCopyBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " device = " << *(params->device);
-  stream << " hostTimestamp = " << *(params->hostTimestamp);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyBuffer, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->srcBuffer));
+  record.AddArg(*(params->dstBuffer));
+  record.AddArg(*(params->srcOffset));
+  record.AddArg(*(params->dstOffset));
+  record.AddArg(*(params->cb));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clGetHostTimerOnExit(
+static void clEnqueueCopyBufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyBuffer, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetPipeInfoOnEnter(
+static void clEnqueueCopyBufferRectOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetPipeInfo* params =
-    reinterpret_cast<const cl_params_clGetPipeInfo*>(
+  const cl_params_clEnqueueCopyBufferRect* params =
+    reinterpret_cast<const cl_params_clEnqueueCopyBufferRect*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " pipe = " << *(params->pipe);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyBufferRect, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->srcBuffer));
+  record.AddArg(*(params->dstBuffer));
+  record.AddArg(*(params->srcOrigin));
+  record.AddArg(*(params->dstOrigin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->srcRowPitch));
+  record.AddArg(*(params->srcSlicePitch));
+  record.AddArg(*(params->dstRowPitch));
+  record.AddArg(*(params->dstSlicePitch));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clGetPipeInfoOnExit(
+static void clEnqueueCopyBufferRectOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyBufferRect, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueAcquireGLObjectsOnEnter(
+static void clEnqueueCopyBufferToImageOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueAcquireGLObjects* params =
-    reinterpret_cast<const cl_params_clEnqueueAcquireGLObjects*>(
+  const cl_params_clEnqueueCopyBufferToImage* params =
+    reinterpret_cast<const cl_params_clEnqueueCopyBufferToImage*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " numObjects = " << *(params->numObjects);
-  stream << " memObjects = " << *(params->memObjects);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyBufferToImage, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->srcBuffer));
+  record.AddArg(*(params->dstImage));
+  record.AddArg(*(params->srcOffset));
+  record.AddArg(*(params->dstOrigin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clEnqueueAcquireGLObjectsOnExit(
+static void clEnqueueCopyBufferToImageOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyBufferToImage, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetKernelWorkGroupInfoOnEnter(
+static void clEnqueueCopyImageOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetKernelWorkGroupInfo* params =
-    reinterpret_cast<const cl_params_clGetKernelWorkGroupInfo*>(
+  const cl_params_clEnqueueCopyImage* params =
+    reinterpret_cast<const cl_params_clEnqueueCopyImage*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " kernel = " << *(params->kernel);
-  stream << " device = " << *(params->device);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyImage, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->srcImage));
+  record.AddArg(*(params->dstImage));
+  record.AddArg(*(params->srcOrigin));
+  record.AddArg(*(params->dstOrigin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clGetKernelWorkGroupInfoOnExit(
+static void clEnqueueCopyImageOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyImage, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateImage2DOnEnter(
+static void clEnqueueCopyImageToBufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateImage2D* params =
-    reinterpret_cast<const cl_params_clCreateImage2D*>(
-        data->functionParams);
+  const cl_params_clEnqueueCopyImageToBuffer* params =
+    reinterpret_cast<const cl_params_clEnqueueCopyImageToBuffer*>(
+        data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " imageFormat = " << *(params->imageFormat);
-  stream << " imageWidth = " << *(params->imageWidth);
-  stream << " imageHeight = " << *(params->imageHeight);
-  stream << " imageRowPitch = " << *(params->imageRowPitch);
-  stream << " hostPtr = " << *(params->hostPtr);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyImageToBuffer, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->srcImage));
+  record.AddArg(*(params->dstBuffer));
+  record.AddArg(*(params->srcOrigin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->dstOffset));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clCreateImage2DOnExit(
+static void clEnqueueCopyImageToBufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateImage2D* params =
-    reinterpret_cast<const cl_params_clCreateImage2D*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueCopyImageToBuffer, data, start, end,
+      collector->NeedTid());
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateContextFromTypeOnEnter(
+static void clEnqueueFillBufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateContextFromType* params =
-    reinterpret_cast<const cl_params_clCreateContextFromType*>(
+  const cl_params_clEnqueueFillBuffer* params =
+    reinterpret_cast<const cl_params_clEnqueueFillBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " properties = " << *(params->properties);
-  stream << " deviceType = " << *(params->deviceType);
-  stream << " funcNotify = " << *(params->funcNotify);
-  stream << " userData = " << *(params->userData);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueFillBuffer, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->buffer));
+  record.AddArg(*(params->pattern));
+  record.AddArg(*(params->patternSize));
+  record.AddArg(*(params->offset));
+  record.AddArg(*(params->size));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clCreateContextFromTypeOnExit(
+static void clEnqueueFillBufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateContextFromType* params =
-    reinterpret_cast<const cl_params_clCreateContextFromType*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueFillBuffer, data, start, end, collector->NeedTid());
 
-  cl_context* result =
-    reinterpret_cast<cl_context*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clRetainProgramOnEnter(
+static void clEnqueueFillImageOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clRetainProgram* params =
-    reinterpret_cast<const cl_params_clRetainProgram*>(
+  const cl_params_clEnqueueFillImage* params =
+    reinterpret_cast<const cl_params_clEnqueueFillImage*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " program = " << *(params->program);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueFillImage, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->image));
+  record.AddArg(*(params->fillColor));
+  record.AddArg(*(params->origin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clRetainProgramOnExit(
+static void clEnqueueFillImageOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueFillImage, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateProgramWithSourceOnEnter(
+static void clEnqueueMapBufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateProgramWithSource* params =
-    reinterpret_cast<const cl_params_clCreateProgramWithSource*>(
+  const cl_params_clEnqueueMapBuffer* params =
+    reinterpret_cast<const cl_params_clEnqueueMapBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " count = " << *(params->count);
-  stream << " strings = " << *(params->strings);
-  stream << " lengths = " << *(params->lengths);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMapBuffer, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->buffer));
+  record.AddArg(*(params->blockingMap));
+  record.AddArg(*(params->mapFlags));
+  record.AddArg(*(params->offset));
+  record.AddArg(*(params->cb));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
   if (*(params->errcodeRet) == nullptr) {
     *(params->errcodeRet) = &current_error;
   }
 }
 
-static void clCreateProgramWithSourceOnExit(
+static void clEnqueueMapBufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMapBuffer, data, start, end, collector->NeedTid());
 
-  const cl_params_clCreateProgramWithSource* params =
-    reinterpret_cast<const cl_params_clCreateProgramWithSource*>(
+  const cl_params_clEnqueueMapBuffer* params =
+    reinterpret_cast<const cl_params_clEnqueueMapBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  cl_program* result =
-    reinterpret_cast<cl_program*>(data->functionReturnValue);
+  void** result =
+    reinterpret_cast<void**>(data->functionReturnValue);
   PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  record.AddArg(*result);
 
   PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
-
-  collector->Log(stream.str());
-}
-
-static void clGetMemObjectInfoOnEnter(
-    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetMemObjectInfo* params =
-    reinterpret_cast<const cl_params_clGetMemObjectInfo*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
-
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " memobj = " << *(params->memobj);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-}
-
-static void clGetMemObjectInfoOnExit(
-    cl_callback_data* data, uint64_t start, uint64_t end,
-    ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
-
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clLinkProgramOnEnter(
+static void clEnqueueMapImageOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clLinkProgram* params =
-    reinterpret_cast<const cl_params_clLinkProgram*>(
+  const cl_params_clEnqueueMapImage* params =
+    reinterpret_cast<const cl_params_clEnqueueMapImage*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " numDevices = " << *(params->numDevices);
-  stream << " deviceList = " << *(params->deviceList);
-  if (*(params->options) == nullptr) {
-    stream << " options = " << "0";
-  } else if (strlen(*(params->options)) == 0) {
-    stream << " options = \"\"";
-  } else {
-    stream << " options = \"" << *(params->options) << "\"";
-  }
-  stream << " numInputPrograms = " << *(params->numInputPrograms);
-  stream << " inputPrograms = " << *(params->inputPrograms);
-  stream << " funcNotify = " << *(params->funcNotify);
-  stream << " userData = " << *(params->userData);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMapImage, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->image));
+  record.AddArg(*(params->blockingMap));
+  record.AddArg(*(params->mapFlags));
+  record.AddArg(*(params->origin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->imageRowPitch));
+  record.AddArg(*(params->imageSlicePitch));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
   if (*(params->errcodeRet) == nullptr) {
     *(params->errcodeRet) = &current_error;
   }
 }
 
-static void clLinkProgramOnExit(
+static void clEnqueueMapImageOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMapImage, data, start, end, collector->NeedTid());
 
-  const cl_params_clLinkProgram* params =
-    reinterpret_cast<const cl_params_clLinkProgram*>(
+  const cl_params_clEnqueueMapImage* params =
+    reinterpret_cast<const cl_params_clEnqueueMapImage*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  cl_program* result =
-    reinterpret_cast<cl_program*>(data->functionReturnValue);
+  void** result =
+    reinterpret_cast<void**>(data->functionReturnValue);
   PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  record.AddArg(*result);
 
   PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateSamplerWithPropertiesOnEnter(
+static void clEnqueueMarkerOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateSamplerWithProperties* params =
-    reinterpret_cast<const cl_params_clCreateSamplerWithProperties*>(
+  const cl_params_clEnqueueMarker* params =
+    reinterpret_cast<const cl_params_clEnqueueMarker*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " samplerProperties = " << *(params->samplerProperties);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMarker, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clCreateSamplerWithPropertiesOnExit(
+static void clEnqueueMarkerOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateSamplerWithProperties* params =
-    reinterpret_cast<const cl_params_clCreateSamplerWithProperties*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMarker, data, start, end, collector->NeedTid());
 
-  cl_sampler* result =
-    reinterpret_cast<cl_sampler*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clRetainSamplerOnEnter(
+static void clEnqueueMarkerWithWaitListOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clRetainSampler* params =
-    reinterpret_cast<const cl_params_clRetainSampler*>(
+  const cl_params_clEnqueueMarkerWithWaitList* params =
+    reinterpret_cast<const cl_params_clEnqueueMarkerWithWaitList*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " sampler = " << *(params->sampler);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMarkerWithWaitList, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clRetainSamplerOnExit(
+static void clEnqueueMarkerWithWaitListOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMarkerWithWaitList, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateFromGLTexture3DOnEnter(
+static void clEnqueueMigrateMemObjectsOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateFromGLTexture3D* params =
-    reinterpret_cast<const cl_params_clCreateFromGLTexture3D*>(
+  const cl_params_clEnqueueMigrateMemObjects* params =
+    reinterpret_cast<const cl_params_clEnqueueMigrateMemObjects*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " target = " << *(params->target);
-  stream << " miplevel = " << *(params->miplevel);
-  stream << " texture = " << *(params->texture);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMigrateMemObjects, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->numMemObjects));
+  record.AddArg(*(params->memObjects));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clCreateFromGLTexture3DOnExit(
+static void clEnqueueMigrateMemObjectsOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateFromGLTexture3D* params =
-    reinterpret_cast<const cl_params_clCreateFromGLTexture3D*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueMigrateMemObjects, data, start, end,
+      collector->NeedTid());
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueMapImageOnEnter(
+static void clEnqueueNDRangeKernelOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueMapImage* params =
-    reinterpret_cast<const cl_params_clEnqueueMapImage*>(
+  const cl_params_clEnqueueNDRangeKernel* params =
+    reinterpret_cast<const cl_params_clEnqueueNDRangeKernel*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " image = " << *(params->image);
-  stream << " blockingMap = " << *(params->blockingMap);
-  stream << " mapFlags = " << *(params->mapFlags);
-  stream << " origin = " << *(params->origin);
-  stream << " region = " << *(params->region);
-  stream << " imageRowPitch = " << *(params->imageRowPitch);
-  stream << " imageSlicePitch = " << *(params->imageSlicePitch);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueNDRangeKernel, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->kernel));
+  record.AddArg(*(params->workDim));
+  record.AddArg(*(params->globalWorkOffset));
+  record.AddArray(*(params->globalWorkOffset), *(params->workDim));
+  record.AddArg(*(params->globalWorkSize));
+  record.AddArray(*(params->globalWorkSize), *(params->workDim));
+  record.AddArg(*(params->localWorkSize));
+  record.AddArray(*(params->localWorkSize), *(params->workDim));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clEnqueueMapImageOnExit(
+static void clEnqueueNDRangeKernelOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueNDRangeKernel, data, start, end,
+      collector->NeedTid());
 
-  const cl_params_clEnqueueMapImage* params =
-    reinterpret_cast<const cl_params_clEnqueueMapImage*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  record.AddArg(collector->GetKernelId());
 
-  void ** result =
-    reinterpret_cast<void **>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueWriteBufferOnEnter(
+static void clEnqueueNativeKernelOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueWriteBuffer* params =
-    reinterpret_cast<const cl_params_clEnqueueWriteBuffer*>(
+  const cl_params_clEnqueueNativeKernel* params =
+    reinterpret_cast<const cl_params_clEnqueueNativeKernel*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " buffer = " << *(params->buffer);
-  stream << " blockingWrite = " << *(params->blockingWrite);
-  stream << " offset = " << *(params->offset);
-  stream << " cb = " << *(params->cb);
-  stream << " ptr = " << *(params->ptr);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueNativeKernel, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->userFunc));
+  record.AddArg(*(params->args));
+  record.AddArg(*(params->cbArgs));
+  record.AddArg(*(params->numMemObjects));
+  record.AddArg(*(params->memList));
+  record.AddArg(*(params->argsMemLoc));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clEnqueueWriteBufferOnExit(
+static void clEnqueueNativeKernelOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  if (collector->GetKernelId() > 0) {
-    stream << "(" << collector->GetKernelId() << ")";
-  }
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueNativeKernel, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueCopyImageOnEnter(
+static void clEnqueueReadBufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueCopyImage* params =
-    reinterpret_cast<const cl_params_clEnqueueCopyImage*>(
+  const cl_params_clEnqueueReadBuffer* params =
+    reinterpret_cast<const cl_params_clEnqueueReadBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " srcImage = " << *(params->srcImage);
-  stream << " dstImage = " << *(params->dstImage);
-  stream << " srcOrigin = " << *(params->srcOrigin);
-  stream << " dstOrigin = " << *(params->dstOrigin);
-  stream << " region = " << *(params->region);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueReadBuffer, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->buffer));
+  record.AddArg(*(params->blockingRead));
+  record.AddArg(*(params->offset));
+  record.AddArg(*(params->cb));
+  record.AddArg(*(params->ptr));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clEnqueueCopyImageOnExit(
+static void clEnqueueReadBufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueReadBuffer, data, start, end, collector->NeedTid());
+
+  record.AddArg(collector->GetKernelId());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetExtensionFunctionAddressOnEnter(
+static void clEnqueueReadBufferRectOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetExtensionFunctionAddress* params =
-    reinterpret_cast<const cl_params_clGetExtensionFunctionAddress*>(
+  const cl_params_clEnqueueReadBufferRect* params =
+    reinterpret_cast<const cl_params_clEnqueueReadBufferRect*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  if (*(params->funcName) == nullptr) {
-    stream << " funcName = " << "0";
-  } else if (strlen(*(params->funcName)) == 0) {
-    stream << " funcName = \"\"";
-  } else {
-    stream << " funcName = \"" << *(params->funcName) << "\"";
-  }
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueReadBufferRect, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->buffer));
+  record.AddArg(*(params->blockingRead));
+  record.AddArg(*(params->bufferOrigin));
+  record.AddArg(*(params->hostOrigin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->bufferRowPitch));
+  record.AddArg(*(params->bufferSlicePitch));
+  record.AddArg(*(params->hostRowPitch));
+  record.AddArg(*(params->hostSlicePitch));
+  record.AddArg(*(params->ptr));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clGetExtensionFunctionAddressOnExit(
+static void clEnqueueReadBufferRectOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueReadBufferRect, data, start, end,
+      collector->NeedTid());
 
-  void** result =
-    reinterpret_cast<void**>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
-  stream << std::endl;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  collector->Log(stream.str());
+  record.AddArg(*error);
+
+  collector->Log(record);
 }
 
-static void clEnqueueReadBufferRectOnEnter(
+static void clEnqueueReadImageOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueReadBufferRect* params =
-    reinterpret_cast<const cl_params_clEnqueueReadBufferRect*>(
+  const cl_params_clEnqueueReadImage* params =
+    reinterpret_cast<const cl_params_clEnqueueReadImage*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " buffer = " << *(params->buffer);
-  stream << " blockingRead = " << *(params->blockingRead);
-  stream << " bufferOrigin = " << *(params->bufferOrigin);
-  stream << " hostOrigin = " << *(params->hostOrigin);
-  stream << " region = " << *(params->region);
-  stream << " bufferRowPitch = " << *(params->bufferRowPitch);
-  stream << " bufferSlicePitch = " << *(params->bufferSlicePitch);
-  stream << " hostRowPitch = " << *(params->hostRowPitch);
-  stream << " hostSlicePitch = " << *(params->hostSlicePitch);
-  stream << " ptr = " << *(params->ptr);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueReadImage, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->image));
+  record.AddArg(*(params->blockingRead));
+  record.AddArg(*(params->origin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->rowPitch));
+  record.AddArg(*(params->slicePitch));
+  record.AddArg(*(params->ptr));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clEnqueueReadBufferRectOnExit(
+static void clEnqueueReadImageOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueReadImage, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateSubDevicesOnEnter(
+static void clEnqueueReleaseGLObjectsOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateSubDevices* params =
-    reinterpret_cast<const cl_params_clCreateSubDevices*>(
+  const cl_params_clEnqueueReleaseGLObjects* params =
+    reinterpret_cast<const cl_params_clEnqueueReleaseGLObjects*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " inDevice = " << *(params->inDevice);
-  stream << " properties = " << *(params->properties);
-  stream << " numDevices = " << *(params->numDevices);
-  stream << " outDevices = " << *(params->outDevices);
-  stream << " numDevicesRet = " << *(params->numDevicesRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueReleaseGLObjects, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->numObjects));
+  record.AddArg(*(params->memObjects));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clCreateSubDevicesOnExit(
+static void clEnqueueReleaseGLObjectsOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueReleaseGLObjects, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetDeviceAndHostTimerOnEnter(
+static void clEnqueueSVMFreeOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetDeviceAndHostTimer* params =
-    reinterpret_cast<const cl_params_clGetDeviceAndHostTimer*>(
+  const cl_params_clEnqueueSVMFree* params =
+    reinterpret_cast<const cl_params_clEnqueueSVMFree*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " device = " << *(params->device);
-  stream << " deviceTimestamp = " << *(params->deviceTimestamp);
-  stream << " hostTimestamp = " << *(params->hostTimestamp);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMFree, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->numSvmPointers));
+  record.AddArg(*(params->svmPointers));
+  record.AddArg(*(params->pfnFreeFunc));
+  record.AddArg(*(params->userData));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clGetDeviceAndHostTimerOnExit(
+static void clEnqueueSVMFreeOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMFree, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clReleaseSamplerOnEnter(
+static void clEnqueueSVMMapOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clReleaseSampler* params =
-    reinterpret_cast<const cl_params_clReleaseSampler*>(
+  const cl_params_clEnqueueSVMMap* params =
+    reinterpret_cast<const cl_params_clEnqueueSVMMap*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " sampler = " << *(params->sampler);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMMap, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->blockingMap));
+  record.AddArg(*(params->mapFlags));
+  record.AddArg(*(params->svmPtr));
+  record.AddArg(*(params->size));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clReleaseSamplerOnExit(
+static void clEnqueueSVMMapOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMMap, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueTaskOnEnter(
+static void clEnqueueSVMMemFillOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueTask* params =
-    reinterpret_cast<const cl_params_clEnqueueTask*>(
+  const cl_params_clEnqueueSVMMemFill* params =
+    reinterpret_cast<const cl_params_clEnqueueSVMMemFill*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " kernel = " << *(params->kernel);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMMemFill, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->svmPtr));
+  record.AddArg(*(params->pattern));
+  record.AddArg(*(params->patternSize));
+  record.AddArg(*(params->size));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clEnqueueTaskOnExit(
+static void clEnqueueSVMMemFillOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMMemFill, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clFinishOnEnter(
+static void clEnqueueSVMMemcpyOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clFinish* params =
-    reinterpret_cast<const cl_params_clFinish*>(
+  const cl_params_clEnqueueSVMMemcpy* params =
+    reinterpret_cast<const cl_params_clEnqueueSVMMemcpy*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMMemcpy, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->blockingCopy));
+  record.AddArg(*(params->dstPtr));
+  record.AddArg(*(params->srcPtr));
+  record.AddArg(*(params->size));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clFinishOnExit(
+static void clEnqueueSVMMemcpyOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMMemcpy, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetEventInfoOnEnter(
+static void clEnqueueSVMMigrateMemOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetEventInfo* params =
-    reinterpret_cast<const cl_params_clGetEventInfo*>(
+  const cl_params_clEnqueueSVMMigrateMem* params =
+    reinterpret_cast<const cl_params_clEnqueueSVMMigrateMem*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " event = " << *(params->event);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMMigrateMem, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->numSvmPointers));
+  record.AddArg(*(params->svmPointers));
+  record.AddArg(*(params->sizes));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clGetEventInfoOnExit(
+static void clEnqueueSVMMigrateMemOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMMigrateMem, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetEventProfilingInfoOnEnter(
+static void clEnqueueSVMUnmapOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetEventProfilingInfo* params =
-    reinterpret_cast<const cl_params_clGetEventProfilingInfo*>(
+  const cl_params_clEnqueueSVMUnmap* params =
+    reinterpret_cast<const cl_params_clEnqueueSVMUnmap*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " event = " << *(params->event);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMUnmap, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->svmPtr));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clGetEventProfilingInfoOnExit(
+static void clEnqueueSVMUnmapOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueSVMUnmap, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clSetKernelArgSVMPointerOnEnter(
+static void clEnqueueTaskOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clSetKernelArgSVMPointer* params =
-    reinterpret_cast<const cl_params_clSetKernelArgSVMPointer*>(
+  const cl_params_clEnqueueTask* params =
+    reinterpret_cast<const cl_params_clEnqueueTask*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " kernel = " << *(params->kernel);
-  stream << " argIndex = " << *(params->argIndex);
-  stream << " argValue = " << *(params->argValue);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueTask, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->kernel));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clSetKernelArgSVMPointerOnExit(
+static void clEnqueueTaskOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueTask, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateImageOnEnter(
+static void clEnqueueUnmapMemObjectOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateImage* params =
-    reinterpret_cast<const cl_params_clCreateImage*>(
+  const cl_params_clEnqueueUnmapMemObject* params =
+    reinterpret_cast<const cl_params_clEnqueueUnmapMemObject*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " imageFormat = " << *(params->imageFormat);
-  stream << " imageDesc = " << *(params->imageDesc);
-  stream << " hostPtr = " << *(params->hostPtr);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueUnmapMemObject, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->memobj));
+  record.AddArg(*(params->mappedPtr));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clCreateImageOnExit(
+static void clEnqueueUnmapMemObjectOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateImage* params =
-    reinterpret_cast<const cl_params_clCreateImage*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueUnmapMemObject, data, start, end,
+      collector->NeedTid());
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueSVMMemcpyOnEnter(
+static void clEnqueueWaitForEventsOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueSVMMemcpy* params =
-    reinterpret_cast<const cl_params_clEnqueueSVMMemcpy*>(
+  const cl_params_clEnqueueWaitForEvents* params =
+    reinterpret_cast<const cl_params_clEnqueueWaitForEvents*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " blockingCopy = " << *(params->blockingCopy);
-  stream << " dstPtr = " << *(params->dstPtr);
-  stream << " srcPtr = " << *(params->srcPtr);
-  stream << " size = " << *(params->size);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueWaitForEvents, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->numEvents));
+  record.AddArg(*(params->eventList));
+  collector->Log(record);
 }
 
-static void clEnqueueSVMMemcpyOnExit(
+static void clEnqueueWaitForEventsOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueWaitForEvents, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clReleaseKernelOnEnter(
+static void clEnqueueWriteBufferOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clReleaseKernel* params =
-    reinterpret_cast<const cl_params_clReleaseKernel*>(
+  const cl_params_clEnqueueWriteBuffer* params =
+    reinterpret_cast<const cl_params_clEnqueueWriteBuffer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " kernel = " << *(params->kernel);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueWriteBuffer, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->buffer));
+  record.AddArg(*(params->blockingWrite));
+  record.AddArg(*(params->offset));
+  record.AddArg(*(params->cb));
+  record.AddArg(*(params->ptr));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clReleaseKernelOnExit(
+static void clEnqueueWriteBufferOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueWriteBuffer, data, start, end, collector->NeedTid());
+
+  record.AddArg(collector->GetKernelId());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueNativeKernelOnEnter(
+static void clEnqueueWriteBufferRectOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueNativeKernel* params =
-    reinterpret_cast<const cl_params_clEnqueueNativeKernel*>(
+  const cl_params_clEnqueueWriteBufferRect* params =
+    reinterpret_cast<const cl_params_clEnqueueWriteBufferRect*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " userFunc = " << *(params->userFunc);
-  stream << " args = " << *(params->args);
-  stream << " cbArgs = " << *(params->cbArgs);
-  stream << " numMemObjects = " << *(params->numMemObjects);
-  stream << " memList = " << *(params->memList);
-  stream << " argsMemLoc = " << *(params->argsMemLoc);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueWriteBufferRect, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->buffer));
+  record.AddArg(*(params->blockingWrite));
+  record.AddArg(*(params->bufferOrigin));
+  record.AddArg(*(params->hostOrigin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->bufferRowPitch));
+  record.AddArg(*(params->bufferSlicePitch));
+  record.AddArg(*(params->hostRowPitch));
+  record.AddArg(*(params->hostSlicePitch));
+  record.AddArg(*(params->ptr));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clEnqueueNativeKernelOnExit(
+static void clEnqueueWriteBufferRectOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueWriteBufferRect, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateKernelsInProgramOnEnter(
+static void clEnqueueWriteImageOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateKernelsInProgram* params =
-    reinterpret_cast<const cl_params_clCreateKernelsInProgram*>(
+  const cl_params_clEnqueueWriteImage* params =
+    reinterpret_cast<const cl_params_clEnqueueWriteImage*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " program = " << *(params->program);
-  stream << " numKernels = " << *(params->numKernels);
-  stream << " kernels = " << *(params->kernels);
-  stream << " numKernelsRet = " << *(params->numKernelsRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueWriteImage, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->image));
+  record.AddArg(*(params->blockingWrite));
+  record.AddArg(*(params->origin));
+  record.AddArg(*(params->region));
+  record.AddArg(*(params->inputRowPitch));
+  record.AddArg(*(params->inputSlicePitch));
+  record.AddArg(*(params->ptr));
+  record.AddArg(*(params->numEventsInWaitList));
+  record.AddArg(*(params->eventWaitList));
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clCreateKernelsInProgramOnExit(
+static void clEnqueueWriteImageOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clEnqueueWriteImage, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clSetCommandQueuePropertyOnEnter(
+static void clFinishOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clSetCommandQueueProperty* params =
-    reinterpret_cast<const cl_params_clSetCommandQueueProperty*>(
+  const cl_params_clFinish* params =
+    reinterpret_cast<const cl_params_clFinish*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " properties = " << *(params->properties);
-  stream << " enable = " << *(params->enable);
-  stream << " oldProperties = " << *(params->oldProperties);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clFinish, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  collector->Log(record);
 }
 
-static void clSetCommandQueuePropertyOnExit(
+static void clFinishOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clFinish, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetDeviceInfoOnEnter(
+static void clFlushOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetDeviceInfo* params =
-    reinterpret_cast<const cl_params_clGetDeviceInfo*>(
+  const cl_params_clFlush* params =
+    reinterpret_cast<const cl_params_clFlush*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " device = " << *(params->device);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clFlush, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  collector->Log(record);
 }
 
-static void clGetDeviceInfoOnExit(
+static void clFlushOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clFlush, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueNDRangeKernelOnEnter(
+static void clGetCommandQueueInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueNDRangeKernel* params =
-    reinterpret_cast<const cl_params_clEnqueueNDRangeKernel*>(
+  const cl_params_clGetCommandQueueInfo* params =
+    reinterpret_cast<const cl_params_clGetCommandQueueInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " kernel = " << *(params->kernel);
-  stream << " workDim = " << *(params->workDim);
-  stream << " globalWorkOffset = " << *(params->globalWorkOffset);
-  if (*(params->globalWorkOffset) != nullptr && *(params->workDim) > 0) {
-    stream << " {" << (*(params->globalWorkOffset))[0];
-    for (cl_uint i = 1; i < *(params->workDim); ++i) {
-      stream << ", " << (*(params->globalWorkOffset))[i];
-    }
-    stream << "}";
-  }
-  stream << " globalWorkSize = " << *(params->globalWorkSize);
-  if (*(params->globalWorkSize) != nullptr && *(params->workDim) > 0) {
-    stream << " {" << (*(params->globalWorkSize))[0];
-    for (cl_uint i = 1; i < *(params->workDim); ++i) {
-      stream << ", " << (*(params->globalWorkSize))[i];
-    }
-    stream << "}";
-  }
-  stream << " localWorkSize = " << *(params->localWorkSize);
-  if (*(params->localWorkSize) != nullptr && *(params->workDim) > 0) {
-    stream << " {" << (*(params->localWorkSize))[0];
-    for (cl_uint i = 1; i < *(params->workDim); ++i) {
-      stream << ", " << (*(params->localWorkSize))[i];
-    }
-    stream << "}";
-  }
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetCommandQueueInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clEnqueueNDRangeKernelOnExit(
+static void clGetCommandQueueInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  if (collector->GetKernelId() > 0) {
-    stream << "(" << collector->GetKernelId() << ")";
-  }
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetCommandQueueInfo, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clReleaseProgramOnEnter(
+static void clGetContextInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clReleaseProgram* params =
-    reinterpret_cast<const cl_params_clReleaseProgram*>(
+  const cl_params_clGetContextInfo* params =
+    reinterpret_cast<const cl_params_clGetContextInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " program = " << *(params->program);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetContextInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clReleaseProgramOnExit(
+static void clGetContextInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetContextInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateFromGLBufferOnEnter(
+static void clGetDeviceAndHostTimerOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateFromGLBuffer* params =
-    reinterpret_cast<const cl_params_clCreateFromGLBuffer*>(
+  const cl_params_clGetDeviceAndHostTimer* params =
+    reinterpret_cast<const cl_params_clGetDeviceAndHostTimer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " bufobj = " << *(params->bufobj);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetDeviceAndHostTimer, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->device));
+  record.AddArg(*(params->deviceTimestamp));
+  record.AddArg(*(params->hostTimestamp));
+  collector->Log(record);
 }
 
-static void clCreateFromGLBufferOnExit(
+static void clGetDeviceAndHostTimerOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateFromGLBuffer* params =
-    reinterpret_cast<const cl_params_clCreateFromGLBuffer*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetDeviceAndHostTimer, data, start, end,
+      collector->NeedTid());
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetGLTextureInfoOnEnter(
+static void clGetDeviceIDsOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetGLTextureInfo* params =
-    reinterpret_cast<const cl_params_clGetGLTextureInfo*>(
+  const cl_params_clGetDeviceIDs* params =
+    reinterpret_cast<const cl_params_clGetDeviceIDs*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " memobj = " << *(params->memobj);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetDeviceIDs, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->platform));
+  record.AddArg(*(params->deviceType));
+  record.AddArg(*(params->numEntries));
+  record.AddArg(*(params->devices));
+  record.AddArg(*(params->numDevices));
+  collector->Log(record);
 }
 
-static void clGetGLTextureInfoOnExit(
+static void clGetDeviceIDsOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetDeviceIDs, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clSetDefaultDeviceCommandQueueOnEnter(
+static void clGetDeviceInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clSetDefaultDeviceCommandQueue* params =
-    reinterpret_cast<const cl_params_clSetDefaultDeviceCommandQueue*>(
+  const cl_params_clGetDeviceInfo* params =
+    reinterpret_cast<const cl_params_clGetDeviceInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " device = " << *(params->device);
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetDeviceInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->device));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clSetDefaultDeviceCommandQueueOnExit(
+static void clGetDeviceInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetDeviceInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreatePipeOnEnter(
+static void clGetEventInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreatePipe* params =
-    reinterpret_cast<const cl_params_clCreatePipe*>(
+  const cl_params_clGetEventInfo* params =
+    reinterpret_cast<const cl_params_clGetEventInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " pipePacketSize = " << *(params->pipePacketSize);
-  stream << " pipeMaxPackets = " << *(params->pipeMaxPackets);
-  stream << " properties = " << *(params->properties);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetEventInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->event));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clCreatePipeOnExit(
+static void clGetEventInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreatePipe* params =
-    reinterpret_cast<const cl_params_clCreatePipe*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetEventInfo, data, start, end, collector->NeedTid());
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetPlatformInfoOnEnter(
+static void clGetEventProfilingInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetPlatformInfo* params =
-    reinterpret_cast<const cl_params_clGetPlatformInfo*>(
+  const cl_params_clGetEventProfilingInfo* params =
+    reinterpret_cast<const cl_params_clGetEventProfilingInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " platform = " << *(params->platform);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetEventProfilingInfo, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->event));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clGetPlatformInfoOnExit(
+static void clGetEventProfilingInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetEventProfilingInfo, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueReadBufferOnEnter(
+static void clGetExtensionFunctionAddressOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueReadBuffer* params =
-    reinterpret_cast<const cl_params_clEnqueueReadBuffer*>(
+  const cl_params_clGetExtensionFunctionAddress* params =
+    reinterpret_cast<const cl_params_clGetExtensionFunctionAddress*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " buffer = " << *(params->buffer);
-  stream << " blockingRead = " << *(params->blockingRead);
-  stream << " offset = " << *(params->offset);
-  stream << " cb = " << *(params->cb);
-  stream << " ptr = " << *(params->ptr);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetExtensionFunctionAddress, data, start, 0,
+      collector->NeedTid());
+  record.AddString(*(params->funcName));
+  collector->Log(record);
 }
 
-static void clEnqueueReadBufferOnExit(
+static void clGetExtensionFunctionAddressOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetExtensionFunctionAddress, data, start, end,
+      collector->NeedTid());
 
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  if (collector->GetKernelId() > 0) {
-    stream << "(" << collector->GetKernelId() << ")";
-  }
-  stream << " [" << (end - start) << " ns]";
-
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
-
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  void** result =
+    reinterpret_cast<void**>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clSetMemObjectDestructorCallbackOnEnter(
+static void clGetExtensionFunctionAddressForPlatformOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clSetMemObjectDestructorCallback* params =
-    reinterpret_cast<const cl_params_clSetMemObjectDestructorCallback*>(
+  const cl_params_clGetExtensionFunctionAddressForPlatform* params =
+    reinterpret_cast<const cl_params_clGetExtensionFunctionAddressForPlatform*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " memobj = " << *(params->memobj);
-  stream << " funcNotify = " << *(params->funcNotify);
-  stream << " userData = " << *(params->userData);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetExtensionFunctionAddressForPlatform, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->platform));
+  record.AddString(*(params->funcName));
+  collector->Log(record);
 }
 
-static void clSetMemObjectDestructorCallbackOnExit(
+static void clGetExtensionFunctionAddressForPlatformOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetExtensionFunctionAddressForPlatform, data, start, end,
+      collector->NeedTid());
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  void** result =
+    reinterpret_cast<void**>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetKernelSubGroupInfoOnEnter(
+static void clGetGLObjectInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetKernelSubGroupInfo* params =
-    reinterpret_cast<const cl_params_clGetKernelSubGroupInfo*>(
+  const cl_params_clGetGLObjectInfo* params =
+    reinterpret_cast<const cl_params_clGetGLObjectInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " kernel = " << *(params->kernel);
-  stream << " device = " << *(params->device);
-  stream << " paramName = " << *(params->paramName);
-  stream << " inputValueSize = " << *(params->inputValueSize);
-  stream << " inputValue = " << *(params->inputValue);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetGLObjectInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->memobj));
+  record.AddArg(*(params->glObjectType));
+  record.AddArg(*(params->glObjectName));
+  collector->Log(record);
 }
 
-static void clGetKernelSubGroupInfoOnExit(
+static void clGetGLObjectInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetGLObjectInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueCopyBufferRectOnEnter(
+static void clGetGLTextureInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueCopyBufferRect* params =
-    reinterpret_cast<const cl_params_clEnqueueCopyBufferRect*>(
+  const cl_params_clGetGLTextureInfo* params =
+    reinterpret_cast<const cl_params_clGetGLTextureInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " srcBuffer = " << *(params->srcBuffer);
-  stream << " dstBuffer = " << *(params->dstBuffer);
-  stream << " srcOrigin = " << *(params->srcOrigin);
-  stream << " dstOrigin = " << *(params->dstOrigin);
-  stream << " region = " << *(params->region);
-  stream << " srcRowPitch = " << *(params->srcRowPitch);
-  stream << " srcSlicePitch = " << *(params->srcSlicePitch);
-  stream << " dstRowPitch = " << *(params->dstRowPitch);
-  stream << " dstSlicePitch = " << *(params->dstSlicePitch);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetGLTextureInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->memobj));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clEnqueueCopyBufferRectOnExit(
+static void clGetGLTextureInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetGLTextureInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clWaitForEventsOnEnter(
+static void clGetHostTimerOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clWaitForEvents* params =
-    reinterpret_cast<const cl_params_clWaitForEvents*>(
+  const cl_params_clGetHostTimer* params =
+    reinterpret_cast<const cl_params_clGetHostTimer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " numEvents = " << *(params->numEvents);
-  stream << " eventList = " << *(params->eventList);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetHostTimer, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->device));
+  record.AddArg(*(params->hostTimestamp));
+  collector->Log(record);
 }
 
-static void clWaitForEventsOnExit(
+static void clGetHostTimerOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetHostTimer, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueSVMMigrateMemOnEnter(
+static void clGetImageInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueSVMMigrateMem* params =
-    reinterpret_cast<const cl_params_clEnqueueSVMMigrateMem*>(
+  const cl_params_clGetImageInfo* params =
+    reinterpret_cast<const cl_params_clGetImageInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " numSvmPointers = " << *(params->numSvmPointers);
-  stream << " svmPointers = " << *(params->svmPointers);
-  stream << " sizes = " << *(params->sizes);
-  stream << " flags = " << *(params->flags);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetImageInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->image));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clEnqueueSVMMigrateMemOnExit(
+static void clGetImageInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetImageInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clRetainKernelOnEnter(
+static void clGetKernelArgInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clRetainKernel* params =
-    reinterpret_cast<const cl_params_clRetainKernel*>(
+  const cl_params_clGetKernelArgInfo* params =
+    reinterpret_cast<const cl_params_clGetKernelArgInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " kernel = " << *(params->kernel);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetKernelArgInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->kernel));
+  record.AddArg(*(params->argIndx));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clRetainKernelOnExit(
+static void clGetKernelArgInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetKernelArgInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateCommandQueueWithPropertiesOnEnter(
+static void clGetKernelInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateCommandQueueWithProperties* params =
-    reinterpret_cast<const cl_params_clCreateCommandQueueWithProperties*>(
+  const cl_params_clGetKernelInfo* params =
+    reinterpret_cast<const cl_params_clGetKernelInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " device = " << *(params->device);
-  stream << " properties = " << *(params->properties);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetKernelInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->kernel));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clCreateCommandQueueWithPropertiesOnExit(
+static void clGetKernelInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateCommandQueueWithProperties* params =
-    reinterpret_cast<const cl_params_clCreateCommandQueueWithProperties*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetKernelInfo, data, start, end, collector->NeedTid());
 
-  cl_command_queue* result =
-    reinterpret_cast<cl_command_queue*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateProgramWithBuiltInKernelsOnEnter(
+static void clGetKernelSubGroupInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateProgramWithBuiltInKernels* params =
-    reinterpret_cast<const cl_params_clCreateProgramWithBuiltInKernels*>(
+  const cl_params_clGetKernelSubGroupInfo* params =
+    reinterpret_cast<const cl_params_clGetKernelSubGroupInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " numDevices = " << *(params->numDevices);
-  stream << " deviceList = " << *(params->deviceList);
-  if (*(params->kernelNames) == nullptr) {
-    stream << " kernelNames = " << "0";
-  } else if (strlen(*(params->kernelNames)) == 0) {
-    stream << " kernelNames = \"\"";
-  } else {
-    stream << " kernelNames = \"" << *(params->kernelNames) << "\"";
-  }
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetKernelSubGroupInfo, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->kernel));
+  record.AddArg(*(params->device));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->inputValueSize));
+  record.AddArg(*(params->inputValue));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clCreateProgramWithBuiltInKernelsOnExit(
+static void clGetKernelSubGroupInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateProgramWithBuiltInKernels* params =
-    reinterpret_cast<const cl_params_clCreateProgramWithBuiltInKernels*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetKernelSubGroupInfo, data, start, end,
+      collector->NeedTid());
 
-  cl_program* result =
-    reinterpret_cast<cl_program*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateBufferOnEnter(
+static void clGetKernelWorkGroupInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateBuffer* params =
-    reinterpret_cast<const cl_params_clCreateBuffer*>(
+  const cl_params_clGetKernelWorkGroupInfo* params =
+    reinterpret_cast<const cl_params_clGetKernelWorkGroupInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " size = " << *(params->size);
-  stream << " hostPtr = " << *(params->hostPtr);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetKernelWorkGroupInfo, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->kernel));
+  record.AddArg(*(params->device));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clCreateBufferOnExit(
+static void clGetKernelWorkGroupInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateBuffer* params =
-    reinterpret_cast<const cl_params_clCreateBuffer*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetKernelWorkGroupInfo, data, start, end,
+      collector->NeedTid());
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetProgramBuildInfoOnEnter(
+static void clGetMemObjectInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetProgramBuildInfo* params =
-    reinterpret_cast<const cl_params_clGetProgramBuildInfo*>(
+  const cl_params_clGetMemObjectInfo* params =
+    reinterpret_cast<const cl_params_clGetMemObjectInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " program = " << *(params->program);
-  stream << " device = " << *(params->device);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetMemObjectInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->memobj));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clGetProgramBuildInfoOnExit(
+static void clGetMemObjectInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetMemObjectInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueFillBufferOnEnter(
+static void clGetPipeInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueFillBuffer* params =
-    reinterpret_cast<const cl_params_clEnqueueFillBuffer*>(
+  const cl_params_clGetPipeInfo* params =
+    reinterpret_cast<const cl_params_clGetPipeInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " buffer = " << *(params->buffer);
-  stream << " pattern = " << *(params->pattern);
-  stream << " patternSize = " << *(params->patternSize);
-  stream << " offset = " << *(params->offset);
-  stream << " size = " << *(params->size);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetPipeInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->pipe));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clEnqueueFillBufferOnExit(
+static void clGetPipeInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetPipeInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueReadImageOnEnter(
+static void clGetPlatformIDsOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueReadImage* params =
-    reinterpret_cast<const cl_params_clEnqueueReadImage*>(
+  const cl_params_clGetPlatformIDs* params =
+    reinterpret_cast<const cl_params_clGetPlatformIDs*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " image = " << *(params->image);
-  stream << " blockingRead = " << *(params->blockingRead);
-  stream << " origin = " << *(params->origin);
-  stream << " region = " << *(params->region);
-  stream << " rowPitch = " << *(params->rowPitch);
-  stream << " slicePitch = " << *(params->slicePitch);
-  stream << " ptr = " << *(params->ptr);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetPlatformIDs, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->numEntries));
+  record.AddArg(*(params->platforms));
+  record.AddArg(*(params->numPlatforms));
+  collector->Log(record);
 }
 
-static void clEnqueueReadImageOnExit(
+static void clGetPlatformIDsOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetPlatformIDs, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueWriteBufferRectOnEnter(
+static void clGetPlatformInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueWriteBufferRect* params =
-    reinterpret_cast<const cl_params_clEnqueueWriteBufferRect*>(
+  const cl_params_clGetPlatformInfo* params =
+    reinterpret_cast<const cl_params_clGetPlatformInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " buffer = " << *(params->buffer);
-  stream << " blockingWrite = " << *(params->blockingWrite);
-  stream << " bufferOrigin = " << *(params->bufferOrigin);
-  stream << " hostOrigin = " << *(params->hostOrigin);
-  stream << " region = " << *(params->region);
-  stream << " bufferRowPitch = " << *(params->bufferRowPitch);
-  stream << " bufferSlicePitch = " << *(params->bufferSlicePitch);
-  stream << " hostRowPitch = " << *(params->hostRowPitch);
-  stream << " hostSlicePitch = " << *(params->hostSlicePitch);
-  stream << " ptr = " << *(params->ptr);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetPlatformInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->platform));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clEnqueueWriteBufferRectOnExit(
+static void clGetPlatformInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetPlatformInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueCopyBufferToImageOnEnter(
+static void clGetProgramBuildInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueCopyBufferToImage* params =
-    reinterpret_cast<const cl_params_clEnqueueCopyBufferToImage*>(
+  const cl_params_clGetProgramBuildInfo* params =
+    reinterpret_cast<const cl_params_clGetProgramBuildInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " srcBuffer = " << *(params->srcBuffer);
-  stream << " dstImage = " << *(params->dstImage);
-  stream << " srcOffset = " << *(params->srcOffset);
-  stream << " dstOrigin = " << *(params->dstOrigin);
-  stream << " region = " << *(params->region);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetProgramBuildInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->program));
+  record.AddArg(*(params->device));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clEnqueueCopyBufferToImageOnExit(
+static void clGetProgramBuildInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetProgramBuildInfo, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetExtensionFunctionAddressForPlatformOnEnter(
+static void clGetProgramInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetExtensionFunctionAddressForPlatform* params =
-    reinterpret_cast<
-      const cl_params_clGetExtensionFunctionAddressForPlatform*>(
-          data->functionParams);
+  const cl_params_clGetProgramInfo* params =
+    reinterpret_cast<const cl_params_clGetProgramInfo*>(
+        data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " platform = " << *(params->platform);
-  if (*(params->funcName) == nullptr) {
-    stream << " funcName = " << "0";
-  } else if (strlen(*(params->funcName)) == 0) {
-    stream << " funcName = \"\"";
-  } else {
-    stream << " funcName = \"" << *(params->funcName) << "\"";
-  }
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetProgramInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->program));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clGetExtensionFunctionAddressForPlatformOnExit(
+static void clGetProgramInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetProgramInfo, data, start, end, collector->NeedTid());
 
-  void** result =
-    reinterpret_cast<void**>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
-  stream << std::endl;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  collector->Log(stream.str());
+  record.AddArg(*error);
+
+  collector->Log(record);
 }
 
-static void clSetKernelArgOnEnter(
+static void clGetSamplerInfoOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clSetKernelArg* params =
-    reinterpret_cast<const cl_params_clSetKernelArg*>(
+  const cl_params_clGetSamplerInfo* params =
+    reinterpret_cast<const cl_params_clGetSamplerInfo*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " kernel = " << *(params->kernel);
-  stream << " argIndex = " << *(params->argIndex);
-  stream << " argSize = " << *(params->argSize);
-  stream << " argValue = " << *(params->argValue);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetSamplerInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->sampler));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  record.AddArg(*(params->paramValueSizeRet));
+  collector->Log(record);
 }
 
-static void clSetKernelArgOnExit(
+static void clGetSamplerInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetSamplerInfo, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clReleaseDeviceOnEnter(
+static void clGetSupportedImageFormatsOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clReleaseDevice* params =
-    reinterpret_cast<const cl_params_clReleaseDevice*>(
+  const cl_params_clGetSupportedImageFormats* params =
+    reinterpret_cast<const cl_params_clGetSupportedImageFormats*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " device = " << *(params->device);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetSupportedImageFormats, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->imageType));
+  record.AddArg(*(params->numEntries));
+  record.AddArg(*(params->imageFormats));
+  record.AddArg(*(params->numImageFormats));
+  collector->Log(record);
 }
 
-static void clReleaseDeviceOnExit(
+static void clGetSupportedImageFormatsOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clGetSupportedImageFormats, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateSubBufferOnEnter(
+static void clLinkProgramOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateSubBuffer* params =
-    reinterpret_cast<const cl_params_clCreateSubBuffer*>(
+  const cl_params_clLinkProgram* params =
+    reinterpret_cast<const cl_params_clLinkProgram*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " buffer = " << *(params->buffer);
-  stream << " flags = " << *(params->flags);
-  stream << " bufferCreateType = " << *(params->bufferCreateType);
-  stream << " bufferCreateInfo = " << *(params->bufferCreateInfo);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clLinkProgram, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->numDevices));
+  record.AddArg(*(params->deviceList));
+  record.AddString(*(params->options));
+  record.AddArg(*(params->numInputPrograms));
+  record.AddArg(*(params->inputPrograms));
+  record.AddArg(*(params->funcNotify));
+  record.AddArg(*(params->userData));
+  record.AddArg(*(params->errcodeRet));
+  collector->Log(record);
 
   if (*(params->errcodeRet) == nullptr) {
     *(params->errcodeRet) = &current_error;
   }
 }
 
-static void clCreateSubBufferOnExit(
+static void clLinkProgramOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clLinkProgram, data, start, end, collector->NeedTid());
 
-  const cl_params_clCreateSubBuffer* params =
-    reinterpret_cast<const cl_params_clCreateSubBuffer*>(
+  const cl_params_clLinkProgram* params =
+    reinterpret_cast<const cl_params_clLinkProgram*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
+  cl_program* result =
+    reinterpret_cast<cl_program*>(data->functionReturnValue);
   PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  record.AddArg(*result);
 
   PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(**(params->errcodeRet));
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueMigrateMemObjectsOnEnter(
+static void clReleaseCommandQueueOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueMigrateMemObjects* params =
-    reinterpret_cast<const cl_params_clEnqueueMigrateMemObjects*>(
+  const cl_params_clReleaseCommandQueue* params =
+    reinterpret_cast<const cl_params_clReleaseCommandQueue*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " numMemObjects = " << *(params->numMemObjects);
-  stream << " memObjects = " << *(params->memObjects);
-  stream << " flags = " << *(params->flags);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseCommandQueue, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  collector->Log(record);
 }
 
-static void clEnqueueMigrateMemObjectsOnExit(
+static void clReleaseCommandQueueOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseCommandQueue, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateCommandQueueOnEnter(
+static void clReleaseContextOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateCommandQueue* params =
-    reinterpret_cast<const cl_params_clCreateCommandQueue*>(
+  const cl_params_clReleaseContext* params =
+    reinterpret_cast<const cl_params_clReleaseContext*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " device = " << *(params->device);
-  stream << " properties = " << *(params->properties);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseContext, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  collector->Log(record);
 }
 
-static void clCreateCommandQueueOnExit(
+static void clReleaseContextOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
-
-  const cl_params_clCreateCommandQueue* params =
-    reinterpret_cast<const cl_params_clCreateCommandQueue*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseContext, data, start, end, collector->NeedTid());
 
-  cl_command_queue* result =
-    reinterpret_cast<cl_command_queue*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueSVMMemFillOnEnter(
+static void clReleaseDeviceOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueSVMMemFill* params =
-    reinterpret_cast<const cl_params_clEnqueueSVMMemFill*>(
+  const cl_params_clReleaseDevice* params =
+    reinterpret_cast<const cl_params_clReleaseDevice*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " svmPtr = " << *(params->svmPtr);
-  stream << " pattern = " << *(params->pattern);
-  stream << " patternSize = " << *(params->patternSize);
-  stream << " size = " << *(params->size);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseDevice, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->device));
+  collector->Log(record);
 }
 
-static void clEnqueueSVMMemFillOnExit(
+static void clReleaseDeviceOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseDevice, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clReleaseCommandQueueOnEnter(
+static void clReleaseEventOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clReleaseCommandQueue* params =
-    reinterpret_cast<const cl_params_clReleaseCommandQueue*>(
+  const cl_params_clReleaseEvent* params =
+    reinterpret_cast<const cl_params_clReleaseEvent*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseEvent, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clReleaseCommandQueueOnExit(
+static void clReleaseEventOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseEvent, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueCopyBufferOnEnter(
+static void clReleaseKernelOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueCopyBuffer* params =
-    reinterpret_cast<const cl_params_clEnqueueCopyBuffer*>(
+  const cl_params_clReleaseKernel* params =
+    reinterpret_cast<const cl_params_clReleaseKernel*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " srcBuffer = " << *(params->srcBuffer);
-  stream << " dstBuffer = " << *(params->dstBuffer);
-  stream << " srcOffset = " << *(params->srcOffset);
-  stream << " dstOffset = " << *(params->dstOffset);
-  stream << " cb = " << *(params->cb);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseKernel, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->kernel));
+  collector->Log(record);
 }
 
-static void clEnqueueCopyBufferOnExit(
+static void clReleaseKernelOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseKernel, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetCommandQueueInfoOnEnter(
+static void clReleaseMemObjectOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetCommandQueueInfo* params =
-    reinterpret_cast<const cl_params_clGetCommandQueueInfo*>(
+  const cl_params_clReleaseMemObject* params =
+    reinterpret_cast<const cl_params_clReleaseMemObject*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseMemObject, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->memobj));
+  collector->Log(record);
 }
 
-static void clGetCommandQueueInfoOnExit(
+static void clReleaseMemObjectOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseMemObject, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clBuildProgramOnEnter(
+static void clReleaseProgramOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clBuildProgram* params =
-    reinterpret_cast<const cl_params_clBuildProgram*>(
+  const cl_params_clReleaseProgram* params =
+    reinterpret_cast<const cl_params_clReleaseProgram*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " program = " << *(params->program);
-  stream << " numDevices = " << *(params->numDevices);
-  stream << " deviceList = " << *(params->deviceList);
-  if (*(params->options) == nullptr) {
-    stream << " options = " << "0";
-  } else if (strlen(*(params->options)) == 0) {
-    stream << " options = \"\"";
-  } else {
-    stream << " options = \"" << *(params->options) << "\"";
-  }
-  stream << " funcNotify = " << *(params->funcNotify);
-  stream << " userData = " << *(params->userData);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseProgram, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->program));
+  collector->Log(record);
 }
 
-static void clBuildProgramOnExit(
+static void clReleaseProgramOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseProgram, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clRetainContextOnEnter(
+static void clReleaseSamplerOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clRetainContext* params =
-    reinterpret_cast<const cl_params_clRetainContext*>(
+  const cl_params_clReleaseSampler* params =
+    reinterpret_cast<const cl_params_clReleaseSampler*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseSampler, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->sampler));
+  collector->Log(record);
 }
 
-static void clRetainContextOnExit(
+static void clReleaseSamplerOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clReleaseSampler, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueBarrierOnEnter(
+static void clRetainCommandQueueOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueBarrier* params =
-    reinterpret_cast<const cl_params_clEnqueueBarrier*>(
+  const cl_params_clRetainCommandQueue* params =
+    reinterpret_cast<const cl_params_clRetainCommandQueue*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainCommandQueue, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  collector->Log(record);
 }
 
-static void clEnqueueBarrierOnExit(
+static void clRetainCommandQueueOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainCommandQueue, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clRetainDeviceOnEnter(
+static void clRetainContextOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clRetainDevice* params =
-    reinterpret_cast<const cl_params_clRetainDevice*>(
+  const cl_params_clRetainContext* params =
+    reinterpret_cast<const cl_params_clRetainContext*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " device = " << *(params->device);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainContext, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  collector->Log(record);
 }
 
-static void clRetainDeviceOnExit(
+static void clRetainContextOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainContext, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueSVMMapOnEnter(
+static void clRetainDeviceOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueSVMMap* params =
-    reinterpret_cast<const cl_params_clEnqueueSVMMap*>(
+  const cl_params_clRetainDevice* params =
+    reinterpret_cast<const cl_params_clRetainDevice*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " blockingMap = " << *(params->blockingMap);
-  stream << " mapFlags = " << *(params->mapFlags);
-  stream << " svmPtr = " << *(params->svmPtr);
-  stream << " size = " << *(params->size);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainDevice, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->device));
+  collector->Log(record);
 }
 
-static void clEnqueueSVMMapOnExit(
+static void clRetainDeviceOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainDevice, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clRetainMemObjectOnEnter(
+static void clRetainEventOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clRetainMemObject* params =
-    reinterpret_cast<const cl_params_clRetainMemObject*>(
+  const cl_params_clRetainEvent* params =
+    reinterpret_cast<const cl_params_clRetainEvent*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " memobj = " << *(params->memobj);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainEvent, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->event));
+  collector->Log(record);
 }
 
-static void clRetainMemObjectOnExit(
+static void clRetainEventOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainEvent, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clSetUserEventStatusOnEnter(
+static void clRetainKernelOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clSetUserEventStatus* params =
-    reinterpret_cast<const cl_params_clSetUserEventStatus*>(
+  const cl_params_clRetainKernel* params =
+    reinterpret_cast<const cl_params_clRetainKernel*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " event = " << *(params->event);
-  stream << " executionStatus = " << *(params->executionStatus);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainKernel, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->kernel));
+  collector->Log(record);
 }
 
-static void clSetUserEventStatusOnExit(
+static void clRetainKernelOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainKernel, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateUserEventOnEnter(
+static void clRetainMemObjectOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateUserEvent* params =
-    reinterpret_cast<const cl_params_clCreateUserEvent*>(
+  const cl_params_clRetainMemObject* params =
+    reinterpret_cast<const cl_params_clRetainMemObject*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
-
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainMemObject, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->memobj));
+  collector->Log(record);
 }
 
-static void clCreateUserEventOnExit(
+static void clRetainMemObjectOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainMemObject, data, start, end, collector->NeedTid());
 
-  const cl_params_clCreateUserEvent* params =
-    reinterpret_cast<const cl_params_clCreateUserEvent*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
-
-  cl_event* result =
-    reinterpret_cast<cl_event*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetSamplerInfoOnEnter(
+static void clRetainProgramOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetSamplerInfo* params =
-    reinterpret_cast<const cl_params_clGetSamplerInfo*>(
+  const cl_params_clRetainProgram* params =
+    reinterpret_cast<const cl_params_clRetainProgram*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " sampler = " << *(params->sampler);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainProgram, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->program));
+  collector->Log(record);
 }
 
-static void clGetSamplerInfoOnExit(
+static void clRetainProgramOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainProgram, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueMarkerOnEnter(
+static void clRetainSamplerOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueMarker* params =
-    reinterpret_cast<const cl_params_clEnqueueMarker*>(
+  const cl_params_clRetainSampler* params =
+    reinterpret_cast<const cl_params_clRetainSampler*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainSampler, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->sampler));
+  collector->Log(record);
 }
 
-static void clEnqueueMarkerOnExit(
+static void clRetainSamplerOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clRetainSampler, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateKernelOnEnter(
+static void clSVMAllocOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateKernel* params =
-    reinterpret_cast<const cl_params_clCreateKernel*>(
+  const cl_params_clSVMAlloc* params =
+    reinterpret_cast<const cl_params_clSVMAlloc*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSVMAlloc, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->flags));
+  record.AddArg(*(params->size));
+  record.AddArg(*(params->alignment));
+  collector->Log(record);
+}
 
-  stream << " program = " << *(params->program);
-  if (*(params->kernelName) == nullptr) {
-    stream << " kernelName = " << "0";
-  } else if (strlen(*(params->kernelName)) == 0) {
-    stream << " kernelName = \"\"";
-  } else {
-    stream << " kernelName = \"" << *(params->kernelName) << "\"";
-  }
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
+static void clSVMAllocOnExit(
+    cl_callback_data* data, uint64_t start, uint64_t end,
+    ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSVMAlloc, data, start, end, collector->NeedTid());
 
-  collector->Log(stream.str());
+  void** result =
+    reinterpret_cast<void**>(data->functionReturnValue);
+  PTI_ASSERT(result != nullptr);
+  record.AddArg(*result);
 
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  collector->Log(record);
 }
 
-static void clCreateKernelOnExit(
+static void clSVMFreeOnEnter(
+    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  const cl_params_clSVMFree* params =
+    reinterpret_cast<const cl_params_clSVMFree*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSVMFree, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->svmPointer));
+  collector->Log(record);
+}
+
+static void clSVMFreeOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSVMFree, data, start, end, collector->NeedTid());
 
-  const cl_params_clCreateKernel* params =
-    reinterpret_cast<const cl_params_clCreateKernel*>(
+  collector->Log(record);
+}
+
+static void clSetCommandQueuePropertyOnEnter(
+    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  const cl_params_clSetCommandQueueProperty* params =
+    reinterpret_cast<const cl_params_clSetCommandQueueProperty*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  cl_kernel* result =
-    reinterpret_cast<cl_kernel*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetCommandQueueProperty, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->commandQueue));
+  record.AddArg(*(params->properties));
+  record.AddArg(*(params->enable));
+  record.AddArg(*(params->oldProperties));
+  collector->Log(record);
+}
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+static void clSetCommandQueuePropertyOnExit(
+    cl_callback_data* data, uint64_t start, uint64_t end,
+    ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetCommandQueueProperty, data, start, end,
+      collector->NeedTid());
+
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
+
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clGetProgramInfoOnEnter(
+static void clSetDefaultDeviceCommandQueueOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetProgramInfo* params =
-    reinterpret_cast<const cl_params_clGetProgramInfo*>(
+  const cl_params_clSetDefaultDeviceCommandQueue* params =
+    reinterpret_cast<const cl_params_clSetDefaultDeviceCommandQueue*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " program = " << *(params->program);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetDefaultDeviceCommandQueue, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->context));
+  record.AddArg(*(params->device));
+  record.AddArg(*(params->commandQueue));
+  collector->Log(record);
 }
 
-static void clGetProgramInfoOnExit(
+static void clSetDefaultDeviceCommandQueueOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetDefaultDeviceCommandQueue, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clSVMAllocOnEnter(
+static void clSetEventCallbackOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clSVMAlloc* params =
-    reinterpret_cast<const cl_params_clSVMAlloc*>(
+  const cl_params_clSetEventCallback* params =
+    reinterpret_cast<const cl_params_clSetEventCallback*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " size = " << *(params->size);
-  stream << " alignment = " << *(params->alignment);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetEventCallback, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->event));
+  record.AddArg(*(params->commandExecCallbackType));
+  record.AddArg(*(params->funcNotify));
+  record.AddArg(*(params->userData));
+  collector->Log(record);
 }
 
-static void clSVMAllocOnExit(
+static void clSetEventCallbackOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetEventCallback, data, start, end, collector->NeedTid());
 
-  void ** result =
-    reinterpret_cast<void **>(
-        data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
-  stream << std::endl;
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
+
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clRetainEventOnEnter(
+static void clSetKernelArgOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clRetainEvent* params =
-    reinterpret_cast<const cl_params_clRetainEvent*>(
+  const cl_params_clSetKernelArg* params =
+    reinterpret_cast<const cl_params_clSetKernelArg*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetKernelArg, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->kernel));
+  record.AddArg(*(params->argIndex));
+  record.AddArg(*(params->argSize));
+  record.AddArg(*(params->argValue));
+  collector->Log(record);
 }
 
-static void clRetainEventOnExit(
+static void clSetKernelArgOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetKernelArg, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCloneKernelOnEnter(
+static void clSetKernelArgSVMPointerOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCloneKernel* params =
-    reinterpret_cast<const cl_params_clCloneKernel*>(
+  const cl_params_clSetKernelArgSVMPointer* params =
+    reinterpret_cast<const cl_params_clSetKernelArgSVMPointer*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetKernelArgSVMPointer, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->kernel));
+  record.AddArg(*(params->argIndex));
+  record.AddArg(*(params->argValue));
+  collector->Log(record);
+}
 
-  stream << " sourceKernel = " << *(params->sourceKernel);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
+static void clSetKernelArgSVMPointerOnExit(
+    cl_callback_data* data, uint64_t start, uint64_t end,
+    ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetKernelArgSVMPointer, data, start, end,
+      collector->NeedTid());
 
-  collector->Log(stream.str());
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+  record.AddArg(*error);
+
+  collector->Log(record);
 }
 
-static void clCloneKernelOnExit(
+static void clSetKernelExecInfoOnEnter(
+    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  const cl_params_clSetKernelExecInfo* params =
+    reinterpret_cast<const cl_params_clSetKernelExecInfo*>(
+        data->functionParams);
+  PTI_ASSERT(params != nullptr);
+
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetKernelExecInfo, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->kernel));
+  record.AddArg(*(params->paramName));
+  record.AddArg(*(params->paramValueSize));
+  record.AddArg(*(params->paramValue));
+  collector->Log(record);
+}
+
+static void clSetKernelExecInfoOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetKernelExecInfo, data, start, end, collector->NeedTid());
 
-  const cl_params_clCloneKernel* params =
-    reinterpret_cast<const cl_params_clCloneKernel*>(
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
+
+  record.AddArg(*error);
+
+  collector->Log(record);
+}
+
+static void clSetMemObjectDestructorCallbackOnEnter(
+    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  const cl_params_clSetMemObjectDestructorCallback* params =
+    reinterpret_cast<const cl_params_clSetMemObjectDestructorCallback*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  cl_kernel* result =
-    reinterpret_cast<cl_kernel*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetMemObjectDestructorCallback, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->memobj));
+  record.AddArg(*(params->funcNotify));
+  record.AddArg(*(params->userData));
+  collector->Log(record);
+}
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+static void clSetMemObjectDestructorCallbackOnExit(
+    cl_callback_data* data, uint64_t start, uint64_t end,
+    ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetMemObjectDestructorCallback, data, start, end,
+      collector->NeedTid());
+
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
 
-  collector->Log(stream.str());
+  record.AddArg(*error);
+
+  collector->Log(record);
 }
 
-static void clGetImageInfoOnEnter(
+static void clSetUserEventStatusOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clGetImageInfo* params =
-    reinterpret_cast<const cl_params_clGetImageInfo*>(
+  const cl_params_clSetUserEventStatus* params =
+    reinterpret_cast<const cl_params_clSetUserEventStatus*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " image = " << *(params->image);
-  stream << " paramName = " << *(params->paramName);
-  stream << " paramValueSize = " << *(params->paramValueSize);
-  stream << " paramValue = " << *(params->paramValue);
-  stream << " paramValueSizeRet = " << *(params->paramValueSizeRet);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetUserEventStatus, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->event));
+  record.AddArg(*(params->executionStatus));
+  collector->Log(record);
 }
 
-static void clGetImageInfoOnExit(
+static void clSetUserEventStatusOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clSetUserEventStatus, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clFlushOnEnter(
+static void clUnloadCompilerOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clFlush* params =
-    reinterpret_cast<const cl_params_clFlush*>(
+  const cl_params_clUnloadCompiler* params =
+    reinterpret_cast<const cl_params_clUnloadCompiler*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clUnloadCompiler, data, start, 0, collector->NeedTid());
+  collector->Log(record);
 }
 
-static void clFlushOnExit(
+static void clUnloadCompilerOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clUnloadCompiler, data, start, end, collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clEnqueueMarkerWithWaitListOnEnter(
+static void clUnloadPlatformCompilerOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clEnqueueMarkerWithWaitList* params =
-    reinterpret_cast<const cl_params_clEnqueueMarkerWithWaitList*>(
+  const cl_params_clUnloadPlatformCompiler* params =
+    reinterpret_cast<const cl_params_clUnloadPlatformCompiler*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
-
-  stream << " commandQueue = " << *(params->commandQueue);
-  stream << " numEventsInWaitList = " << *(params->numEventsInWaitList);
-  stream << " eventWaitList = " << *(params->eventWaitList);
-  stream << " event = " << *(params->event);
-  stream << std::endl;
-
-  collector->Log(stream.str());
+  ClCallRecordWriter record(
+      CL_FUNCTION_clUnloadPlatformCompiler, data, start, 0,
+      collector->NeedTid());
+  record.AddArg(*(params->platform));
+  collector->Log(record);
 }
 
-static void clEnqueueMarkerWithWaitListOnExit(
+static void clUnloadPlatformCompilerOnExit(
     cl_callback_data* data, uint64_t start, uint64_t end,
     ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clUnloadPlatformCompiler, data, start, end,
+      collector->NeedTid());
 
   cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
   PTI_ASSERT(error != nullptr);
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+  record.AddArg(*error);
 
-  collector->Log(stream.str());
+  collector->Log(record);
 }
 
-static void clCreateProgramWithILOnEnter(
+static void clWaitForEventsOnEnter(
     cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
   PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateProgramWithIL* params =
-    reinterpret_cast<const cl_params_clCreateProgramWithIL*>(
+  const cl_params_clWaitForEvents* params =
+    reinterpret_cast<const cl_params_clWaitForEvents*>(
         data->functionParams);
   PTI_ASSERT(params != nullptr);
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+  ClCallRecordWriter record(
+      CL_FUNCTION_clWaitForEvents, data, start, 0, collector->NeedTid());
+  record.AddArg(*(params->numEvents));
+  record.AddArg(*(params->eventList));
+  collector->Log(record);
+}
+
+static void clWaitForEventsOnExit(
+    cl_callback_data* data, uint64_t start, uint64_t end,
+    ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  ClCallRecordWriter record(
+      CL_FUNCTION_clWaitForEvents, data, start, end, collector->NeedTid());
+
+  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
+  PTI_ASSERT(error != nullptr);
+
+  record.AddArg(*error);
+
+  collector->Log(record);
+}
+
+static void OnEnterFunction(
+    cl_function_id function, cl_callback_data* data,
+    uint64_t start, ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  switch (function) {
+    case CL_FUNCTION_clBuildProgram:
+      clBuildProgramOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCloneKernel:
+      clCloneKernelOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCompileProgram:
+      clCompileProgramOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateBuffer:
+      clCreateBufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateCommandQueue:
+      clCreateCommandQueueOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateCommandQueueWithProperties:
+      clCreateCommandQueueWithPropertiesOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateContext:
+      clCreateContextOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateContextFromType:
+      clCreateContextFromTypeOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLBuffer:
+      clCreateFromGLBufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLRenderbuffer:
+      clCreateFromGLRenderbufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLTexture:
+      clCreateFromGLTextureOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLTexture2D:
+      clCreateFromGLTexture2DOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLTexture3D:
+      clCreateFromGLTexture3DOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateImage:
+      clCreateImageOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateImage2D:
+      clCreateImage2DOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateImage3D:
+      clCreateImage3DOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateKernel:
+      clCreateKernelOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateKernelsInProgram:
+      clCreateKernelsInProgramOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreatePipe:
+      clCreatePipeOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateProgramWithBinary:
+      clCreateProgramWithBinaryOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateProgramWithBuiltInKernels:
+      clCreateProgramWithBuiltInKernelsOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateProgramWithIL:
+      clCreateProgramWithILOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateProgramWithSource:
+      clCreateProgramWithSourceOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateSampler:
+      clCreateSamplerOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateSamplerWithProperties:
+      clCreateSamplerWithPropertiesOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateSubBuffer:
+      clCreateSubBufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateSubDevices:
+      clCreateSubDevicesOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clCreateUserEvent:
+      clCreateUserEventOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueAcquireGLObjects:
+      clEnqueueAcquireGLObjectsOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueBarrier:
+      clEnqueueBarrierOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueBarrierWithWaitList:
+      clEnqueueBarrierWithWaitListOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyBuffer:
+      clEnqueueCopyBufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyBufferRect:
+      clEnqueueCopyBufferRectOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyBufferToImage:
+      clEnqueueCopyBufferToImageOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyImage:
+      clEnqueueCopyImageOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyImageToBuffer:
+      clEnqueueCopyImageToBufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueFillBuffer:
+      clEnqueueFillBufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueFillImage:
+      clEnqueueFillImageOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMapBuffer:
+      clEnqueueMapBufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMapImage:
+      clEnqueueMapImageOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMarker:
+      clEnqueueMarkerOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMarkerWithWaitList:
+      clEnqueueMarkerWithWaitListOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMigrateMemObjects:
+      clEnqueueMigrateMemObjectsOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueNDRangeKernel:
+      clEnqueueNDRangeKernelOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueNativeKernel:
+      clEnqueueNativeKernelOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueReadBuffer:
+      clEnqueueReadBufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueReadBufferRect:
+      clEnqueueReadBufferRectOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueReadImage:
+      clEnqueueReadImageOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueReleaseGLObjects:
+      clEnqueueReleaseGLObjectsOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMFree:
+      clEnqueueSVMFreeOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMMap:
+      clEnqueueSVMMapOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMMemFill:
+      clEnqueueSVMMemFillOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMMemcpy:
+      clEnqueueSVMMemcpyOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMMigrateMem:
+      clEnqueueSVMMigrateMemOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMUnmap:
+      clEnqueueSVMUnmapOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueTask:
+      clEnqueueTaskOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueUnmapMemObject:
+      clEnqueueUnmapMemObjectOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueWaitForEvents:
+      clEnqueueWaitForEventsOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueWriteBuffer:
+      clEnqueueWriteBufferOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueWriteBufferRect:
+      clEnqueueWriteBufferRectOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clEnqueueWriteImage:
+      clEnqueueWriteImageOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clFinish:
+      clFinishOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clFlush:
+      clFlushOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetCommandQueueInfo:
+      clGetCommandQueueInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetContextInfo:
+      clGetContextInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetDeviceAndHostTimer:
+      clGetDeviceAndHostTimerOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetDeviceIDs:
+      clGetDeviceIDsOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetDeviceInfo:
+      clGetDeviceInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetEventInfo:
+      clGetEventInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetEventProfilingInfo:
+      clGetEventProfilingInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetExtensionFunctionAddress:
+      clGetExtensionFunctionAddressOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetExtensionFunctionAddressForPlatform:
+      clGetExtensionFunctionAddressForPlatformOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetGLObjectInfo:
+      clGetGLObjectInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetGLTextureInfo:
+      clGetGLTextureInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetHostTimer:
+      clGetHostTimerOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetImageInfo:
+      clGetImageInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetKernelArgInfo:
+      clGetKernelArgInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetKernelInfo:
+      clGetKernelInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetKernelSubGroupInfo:
+      clGetKernelSubGroupInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetKernelWorkGroupInfo:
+      clGetKernelWorkGroupInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetMemObjectInfo:
+      clGetMemObjectInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetPipeInfo:
+      clGetPipeInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetPlatformIDs:
+      clGetPlatformIDsOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetPlatformInfo:
+      clGetPlatformInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetProgramBuildInfo:
+      clGetProgramBuildInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetProgramInfo:
+      clGetProgramInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetSamplerInfo:
+      clGetSamplerInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clGetSupportedImageFormats:
+      clGetSupportedImageFormatsOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clLinkProgram:
+      clLinkProgramOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clReleaseCommandQueue:
+      clReleaseCommandQueueOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clReleaseContext:
+      clReleaseContextOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clReleaseDevice:
+      clReleaseDeviceOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clReleaseEvent:
+      clReleaseEventOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clReleaseKernel:
+      clReleaseKernelOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clReleaseMemObject:
+      clReleaseMemObjectOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clReleaseProgram:
+      clReleaseProgramOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clReleaseSampler:
+      clReleaseSamplerOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clRetainCommandQueue:
+      clRetainCommandQueueOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clRetainContext:
+      clRetainContextOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clRetainDevice:
+      clRetainDeviceOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clRetainEvent:
+      clRetainEventOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clRetainKernel:
+      clRetainKernelOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clRetainMemObject:
+      clRetainMemObjectOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clRetainProgram:
+      clRetainProgramOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clRetainSampler:
+      clRetainSamplerOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSVMAlloc:
+      clSVMAllocOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSVMFree:
+      clSVMFreeOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSetCommandQueueProperty:
+      clSetCommandQueuePropertyOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSetDefaultDeviceCommandQueue:
+      clSetDefaultDeviceCommandQueueOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSetEventCallback:
+      clSetEventCallbackOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSetKernelArg:
+      clSetKernelArgOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSetKernelArgSVMPointer:
+      clSetKernelArgSVMPointerOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSetKernelExecInfo:
+      clSetKernelExecInfoOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSetMemObjectDestructorCallback:
+      clSetMemObjectDestructorCallbackOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clSetUserEventStatus:
+      clSetUserEventStatusOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clUnloadCompiler:
+      clUnloadCompilerOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clUnloadPlatformCompiler:
+      clUnloadPlatformCompilerOnEnter(data, start, collector);
+      break;
+    case CL_FUNCTION_clWaitForEvents:
+      clWaitForEventsOnEnter(data, start, collector);
+      break;
+    default:
+      break;
+  }
+}
+
+static void OnExitFunction(
+    cl_function_id function, cl_callback_data* data,
+    uint64_t start, uint64_t end, ClApiCollector* collector) {
+  PTI_ASSERT(collector != nullptr);
+  switch (function) {
+    case CL_FUNCTION_clBuildProgram:
+      clBuildProgramOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCloneKernel:
+      clCloneKernelOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCompileProgram:
+      clCompileProgramOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateBuffer:
+      clCreateBufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateCommandQueue:
+      clCreateCommandQueueOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateCommandQueueWithProperties:
+      clCreateCommandQueueWithPropertiesOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateContext:
+      clCreateContextOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateContextFromType:
+      clCreateContextFromTypeOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLBuffer:
+      clCreateFromGLBufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLRenderbuffer:
+      clCreateFromGLRenderbufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLTexture:
+      clCreateFromGLTextureOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLTexture2D:
+      clCreateFromGLTexture2DOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateFromGLTexture3D:
+      clCreateFromGLTexture3DOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateImage:
+      clCreateImageOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateImage2D:
+      clCreateImage2DOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateImage3D:
+      clCreateImage3DOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateKernel:
+      clCreateKernelOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateKernelsInProgram:
+      clCreateKernelsInProgramOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreatePipe:
+      clCreatePipeOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateProgramWithBinary:
+      clCreateProgramWithBinaryOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateProgramWithBuiltInKernels:
+      clCreateProgramWithBuiltInKernelsOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateProgramWithIL:
+      clCreateProgramWithILOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateProgramWithSource:
+      clCreateProgramWithSourceOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateSampler:
+      clCreateSamplerOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateSamplerWithProperties:
+      clCreateSamplerWithPropertiesOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateSubBuffer:
+      clCreateSubBufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateSubDevices:
+      clCreateSubDevicesOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clCreateUserEvent:
+      clCreateUserEventOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueAcquireGLObjects:
+      clEnqueueAcquireGLObjectsOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueBarrier:
+      clEnqueueBarrierOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueBarrierWithWaitList:
+      clEnqueueBarrierWithWaitListOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyBuffer:
+      clEnqueueCopyBufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyBufferRect:
+      clEnqueueCopyBufferRectOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyBufferToImage:
+      clEnqueueCopyBufferToImageOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyImage:
+      clEnqueueCopyImageOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueCopyImageToBuffer:
+      clEnqueueCopyImageToBufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueFillBuffer:
+      clEnqueueFillBufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueFillImage:
+      clEnqueueFillImageOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMapBuffer:
+      clEnqueueMapBufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMapImage:
+      clEnqueueMapImageOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMarker:
+      clEnqueueMarkerOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMarkerWithWaitList:
+      clEnqueueMarkerWithWaitListOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueMigrateMemObjects:
+      clEnqueueMigrateMemObjectsOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueNDRangeKernel:
+      clEnqueueNDRangeKernelOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueNativeKernel:
+      clEnqueueNativeKernelOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueReadBuffer:
+      clEnqueueReadBufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueReadBufferRect:
+      clEnqueueReadBufferRectOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueReadImage:
+      clEnqueueReadImageOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueReleaseGLObjects:
+      clEnqueueReleaseGLObjectsOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMFree:
+      clEnqueueSVMFreeOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMMap:
+      clEnqueueSVMMapOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMMemFill:
+      clEnqueueSVMMemFillOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMMemcpy:
+      clEnqueueSVMMemcpyOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMMigrateMem:
+      clEnqueueSVMMigrateMemOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueSVMUnmap:
+      clEnqueueSVMUnmapOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueTask:
+      clEnqueueTaskOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueUnmapMemObject:
+      clEnqueueUnmapMemObjectOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueWaitForEvents:
+      clEnqueueWaitForEventsOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueWriteBuffer:
+      clEnqueueWriteBufferOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueWriteBufferRect:
+      clEnqueueWriteBufferRectOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clEnqueueWriteImage:
+      clEnqueueWriteImageOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clFinish:
+      clFinishOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clFlush:
+      clFlushOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetCommandQueueInfo:
+      clGetCommandQueueInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetContextInfo:
+      clGetContextInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetDeviceAndHostTimer:
+      clGetDeviceAndHostTimerOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetDeviceIDs:
+      clGetDeviceIDsOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetDeviceInfo:
+      clGetDeviceInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetEventInfo:
+      clGetEventInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetEventProfilingInfo:
+      clGetEventProfilingInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetExtensionFunctionAddress:
+      clGetExtensionFunctionAddressOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetExtensionFunctionAddressForPlatform:
+      clGetExtensionFunctionAddressForPlatformOnExit(
+          data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetGLObjectInfo:
+      clGetGLObjectInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetGLTextureInfo:
+      clGetGLTextureInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetHostTimer:
+      clGetHostTimerOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetImageInfo:
+      clGetImageInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetKernelArgInfo:
+      clGetKernelArgInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetKernelInfo:
+      clGetKernelInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetKernelSubGroupInfo:
+      clGetKernelSubGroupInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetKernelWorkGroupInfo:
+      clGetKernelWorkGroupInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetMemObjectInfo:
+      clGetMemObjectInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetPipeInfo:
+      clGetPipeInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetPlatformIDs:
+      clGetPlatformIDsOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetPlatformInfo:
+      clGetPlatformInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetProgramBuildInfo:
+      clGetProgramBuildInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetProgramInfo:
+      clGetProgramInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetSamplerInfo:
+      clGetSamplerInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clGetSupportedImageFormats:
+      clGetSupportedImageFormatsOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clLinkProgram:
+      clLinkProgramOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clReleaseCommandQueue:
+      clReleaseCommandQueueOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clReleaseContext:
+      clReleaseContextOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clReleaseDevice:
+      clReleaseDeviceOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clReleaseEvent:
+      clReleaseEventOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clReleaseKernel:
+      clReleaseKernelOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clReleaseMemObject:
+      clReleaseMemObjectOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clReleaseProgram:
+      clReleaseProgramOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clReleaseSampler:
+      clReleaseSamplerOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clRetainCommandQueue:
+      clRetainCommandQueueOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clRetainContext:
+      clRetainContextOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clRetainDevice:
+      clRetainDeviceOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clRetainEvent:
+      clRetainEventOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clRetainKernel:
+      clRetainKernelOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clRetainMemObject:
+      clRetainMemObjectOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clRetainProgram:
+      clRetainProgramOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clRetainSampler:
+      clRetainSamplerOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSVMAlloc:
+      clSVMAllocOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSVMFree:
+      clSVMFreeOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSetCommandQueueProperty:
+      clSetCommandQueuePropertyOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSetDefaultDeviceCommandQueue:
+      clSetDefaultDeviceCommandQueueOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSetEventCallback:
+      clSetEventCallbackOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSetKernelArg:
+      clSetKernelArgOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSetKernelArgSVMPointer:
+      clSetKernelArgSVMPointerOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSetKernelExecInfo:
+      clSetKernelExecInfoOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSetMemObjectDestructorCallback:
+      clSetMemObjectDestructorCallbackOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clSetUserEventStatus:
+      clSetUserEventStatusOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clUnloadCompiler:
+      clUnloadCompilerOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clUnloadPlatformCompiler:
+      clUnloadPlatformCompilerOnExit(data, start, end, collector);
+      break;
+    case CL_FUNCTION_clWaitForEvents:
+      clWaitForEventsOnExit(data, start, end, collector);
+      break;
+    default:
+      break;
+  }
+}
+
+static void clBuildProgramFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clBuildProgram;
+  stream << " program = " << record.GetArg(&Params::program);
+  stream << " numDevices = " << record.GetArg(&Params::numDevices);
+  stream << " deviceList = " << record.GetArg(&Params::deviceList);
+  const char* options = record.GetString();
+  if (options == nullptr) {
+    stream << " options = " << "0";
+  } else if (strlen(options) == 0) {
+    stream << " options = \"\"";
+  } else {
+    stream << " options = \"" << options << "\"";
+  }
+  stream << " funcNotify = " << record.GetArg(&Params::funcNotify);
+  stream << " userData = " << record.GetArg(&Params::userData);
+}
+
+static void clBuildProgramFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCloneKernelFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCloneKernel;
+  stream << " sourceKernel = " << record.GetArg(&Params::sourceKernel);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCloneKernelFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_kernel>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCompileProgramFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCompileProgram;
+  stream << " program = " << record.GetArg(&Params::program);
+  stream << " numDevices = " << record.GetArg(&Params::numDevices);
+  stream << " deviceList = " << record.GetArg(&Params::deviceList);
+  const char* options = record.GetString();
+  if (options == nullptr) {
+    stream << " options = " << "0";
+  } else if (strlen(options) == 0) {
+    stream << " options = \"\"";
+  } else {
+    stream << " options = \"" << options << "\"";
+  }
+  stream << " numInputHeaders = " << record.GetArg(&Params::numInputHeaders);
+  stream << " inputHeaders = " << record.GetArg(&Params::inputHeaders);
+  stream << " headerIncludeNames = " <<
+    record.GetArg(&Params::headerIncludeNames);
+  stream << " funcNotify = " << record.GetArg(&Params::funcNotify);
+  stream << " userData = " << record.GetArg(&Params::userData);
+}
+
+static void clCompileProgramFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateBufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateBuffer;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " size = " << record.GetArg(&Params::size);
+  stream << " hostPtr = " << record.GetArg(&Params::hostPtr);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateBufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateCommandQueueFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateCommandQueue;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " device = " << record.GetArg(&Params::device);
+  stream << " properties = " << record.GetArg(&Params::properties);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateCommandQueueFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_command_queue>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateCommandQueueWithPropertiesFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateCommandQueueWithProperties;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " device = " << record.GetArg(&Params::device);
+  stream << " properties = " << record.GetArg(&Params::properties);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateCommandQueueWithPropertiesFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_command_queue>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateContextFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateContext;
+  stream << " properties = " << record.GetArg(&Params::properties);
+  stream << " numDevices = " << record.GetArg(&Params::numDevices);
+  stream << " devices = " << record.GetArg(&Params::devices);
+  stream << " funcNotify = " << record.GetArg(&Params::funcNotify);
+  stream << " userData = " << record.GetArg(&Params::userData);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateContextFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_context>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateContextFromTypeFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateContextFromType;
+  stream << " properties = " << record.GetArg(&Params::properties);
+  stream << " deviceType = " << record.GetArg(&Params::deviceType);
+  stream << " funcNotify = " << record.GetArg(&Params::funcNotify);
+  stream << " userData = " << record.GetArg(&Params::userData);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateContextFromTypeFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_context>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateFromGLBufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateFromGLBuffer;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " bufobj = " << record.GetArg(&Params::bufobj);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateFromGLBufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateFromGLRenderbufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateFromGLRenderbuffer;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " renderbuffer = " << record.GetArg(&Params::renderbuffer);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateFromGLRenderbufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateFromGLTextureFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateFromGLTexture;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " target = " << record.GetArg(&Params::target);
+  stream << " miplevel = " << record.GetArg(&Params::miplevel);
+  stream << " texture = " << record.GetArg(&Params::texture);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateFromGLTextureFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateFromGLTexture2DFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateFromGLTexture2D;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " target = " << record.GetArg(&Params::target);
+  stream << " miplevel = " << record.GetArg(&Params::miplevel);
+  stream << " texture = " << record.GetArg(&Params::texture);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateFromGLTexture2DFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateFromGLTexture3DFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateFromGLTexture3D;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " target = " << record.GetArg(&Params::target);
+  stream << " miplevel = " << record.GetArg(&Params::miplevel);
+  stream << " texture = " << record.GetArg(&Params::texture);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateFromGLTexture3DFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateImageFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateImage;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " imageFormat = " << record.GetArg(&Params::imageFormat);
+  stream << " imageDesc = " << record.GetArg(&Params::imageDesc);
+  stream << " hostPtr = " << record.GetArg(&Params::hostPtr);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateImageFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateImage2DFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateImage2D;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " imageFormat = " << record.GetArg(&Params::imageFormat);
+  stream << " imageWidth = " << record.GetArg(&Params::imageWidth);
+  stream << " imageHeight = " << record.GetArg(&Params::imageHeight);
+  stream << " imageRowPitch = " << record.GetArg(&Params::imageRowPitch);
+  stream << " hostPtr = " << record.GetArg(&Params::hostPtr);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateImage2DFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateImage3DFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateImage3D;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " imageFormat = " << record.GetArg(&Params::imageFormat);
+  stream << " imageWidth = " << record.GetArg(&Params::imageWidth);
+  stream << " imageHeight = " << record.GetArg(&Params::imageHeight);
+  stream << " imageDepth = " << record.GetArg(&Params::imageDepth);
+  stream << " imageRowPitch = " << record.GetArg(&Params::imageRowPitch);
+  stream << " imageSlicePitch = " << record.GetArg(&Params::imageSlicePitch);
+  stream << " hostPtr = " << record.GetArg(&Params::hostPtr);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateImage3DFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateKernelFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateKernel;
+  stream << " program = " << record.GetArg(&Params::program);
+  const char* kernel_name = record.GetString();
+  if (kernel_name == nullptr) {
+    stream << " kernelName = " << "0";
+  } else if (strlen(kernel_name) == 0) {
+    stream << " kernelName = \"\"";
+  } else {
+    stream << " kernelName = \"" << kernel_name << "\"";
+  }
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateKernelFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_kernel>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateKernelsInProgramFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateKernelsInProgram;
+  stream << " program = " << record.GetArg(&Params::program);
+  stream << " numKernels = " << record.GetArg(&Params::numKernels);
+  stream << " kernels = " << record.GetArg(&Params::kernels);
+  stream << " numKernelsRet = " << record.GetArg(&Params::numKernelsRet);
+}
+
+static void clCreateKernelsInProgramFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreatePipeFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreatePipe;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " pipePacketSize = " << record.GetArg(&Params::pipePacketSize);
+  stream << " pipeMaxPackets = " << record.GetArg(&Params::pipeMaxPackets);
+  stream << " properties = " << record.GetArg(&Params::properties);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreatePipeFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateProgramWithBinaryFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateProgramWithBinary;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " numDevices = " << record.GetArg(&Params::numDevices);
+  stream << " deviceList = " << record.GetArg(&Params::deviceList);
+  stream << " lengths = " << record.GetArg(&Params::lengths);
+  stream << " binaries = " << record.GetArg(&Params::binaries);
+  stream << " binaryStatus = " << record.GetArg(&Params::binaryStatus);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateProgramWithBinaryFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_program>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateProgramWithBuiltInKernelsFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateProgramWithBuiltInKernels;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " numDevices = " << record.GetArg(&Params::numDevices);
+  stream << " deviceList = " << record.GetArg(&Params::deviceList);
+  const char* kernel_names = record.GetString();
+  if (kernel_names == nullptr) {
+    stream << " kernelNames = " << "0";
+  } else if (strlen(kernel_names) == 0) {
+    stream << " kernelNames = \"\"";
+  } else {
+    stream << " kernelNames = \"" << kernel_names << "\"";
+  }
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateProgramWithBuiltInKernelsFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_program>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateProgramWithILFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateProgramWithIL;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " il = " << record.GetArg(&Params::il);
+  stream << " length = " << record.GetArg(&Params::length);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateProgramWithILFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_program>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateProgramWithSourceFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateProgramWithSource;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " count = " << record.GetArg(&Params::count);
+  stream << " strings = " << record.GetArg(&Params::strings);
+  stream << " lengths = " << record.GetArg(&Params::lengths);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateProgramWithSourceFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_program>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateSamplerFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateSampler;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " normalizedCoords = " << record.GetArg(&Params::normalizedCoords);
+  stream << " addressingMode = " << record.GetArg(&Params::addressingMode);
+  stream << " filterMode = " << record.GetArg(&Params::filterMode);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateSamplerFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_sampler>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateSamplerWithPropertiesFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateSamplerWithProperties;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " samplerProperties = " <<
+    record.GetArg(&Params::samplerProperties);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateSamplerWithPropertiesFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_sampler>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateSubBufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateSubBuffer;
+  stream << " buffer = " << record.GetArg(&Params::buffer);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " bufferCreateType = " << record.GetArg(&Params::bufferCreateType);
+  stream << " bufferCreateInfo = " << record.GetArg(&Params::bufferCreateInfo);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateSubBufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_mem>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateSubDevicesFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateSubDevices;
+  stream << " inDevice = " << record.GetArg(&Params::inDevice);
+  stream << " properties = " << record.GetArg(&Params::properties);
+  stream << " numDevices = " << record.GetArg(&Params::numDevices);
+  stream << " outDevices = " << record.GetArg(&Params::outDevices);
+  stream << " numDevicesRet = " << record.GetArg(&Params::numDevicesRet);
+}
+
+static void clCreateSubDevicesFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clCreateUserEventFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clCreateUserEvent;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clCreateUserEventFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_event>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueAcquireGLObjectsFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueAcquireGLObjects;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " numObjects = " << record.GetArg(&Params::numObjects);
+  stream << " memObjects = " << record.GetArg(&Params::memObjects);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueAcquireGLObjectsFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueBarrierFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueBarrier;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+}
+
+static void clEnqueueBarrierFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueBarrierWithWaitListFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueBarrierWithWaitList;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueBarrierWithWaitListFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueCopyBufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueCopyBuffer;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " srcBuffer = " << record.GetArg(&Params::srcBuffer);
+  stream << " dstBuffer = " << record.GetArg(&Params::dstBuffer);
+  stream << " srcOffset = " << record.GetArg(&Params::srcOffset);
+  stream << " dstOffset = " << record.GetArg(&Params::dstOffset);
+  stream << " cb = " << record.GetArg(&Params::cb);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueCopyBufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueCopyBufferRectFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueCopyBufferRect;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " srcBuffer = " << record.GetArg(&Params::srcBuffer);
+  stream << " dstBuffer = " << record.GetArg(&Params::dstBuffer);
+  stream << " srcOrigin = " << record.GetArg(&Params::srcOrigin);
+  stream << " dstOrigin = " << record.GetArg(&Params::dstOrigin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " srcRowPitch = " << record.GetArg(&Params::srcRowPitch);
+  stream << " srcSlicePitch = " << record.GetArg(&Params::srcSlicePitch);
+  stream << " dstRowPitch = " << record.GetArg(&Params::dstRowPitch);
+  stream << " dstSlicePitch = " << record.GetArg(&Params::dstSlicePitch);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueCopyBufferRectFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueCopyBufferToImageFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueCopyBufferToImage;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " srcBuffer = " << record.GetArg(&Params::srcBuffer);
+  stream << " dstImage = " << record.GetArg(&Params::dstImage);
+  stream << " srcOffset = " << record.GetArg(&Params::srcOffset);
+  stream << " dstOrigin = " << record.GetArg(&Params::dstOrigin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueCopyBufferToImageFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueCopyImageFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueCopyImage;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " srcImage = " << record.GetArg(&Params::srcImage);
+  stream << " dstImage = " << record.GetArg(&Params::dstImage);
+  stream << " srcOrigin = " << record.GetArg(&Params::srcOrigin);
+  stream << " dstOrigin = " << record.GetArg(&Params::dstOrigin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueCopyImageFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueCopyImageToBufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueCopyImageToBuffer;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " srcImage = " << record.GetArg(&Params::srcImage);
+  stream << " dstBuffer = " << record.GetArg(&Params::dstBuffer);
+  stream << " srcOrigin = " << record.GetArg(&Params::srcOrigin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " dstOffset = " << record.GetArg(&Params::dstOffset);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueCopyImageToBufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueFillBufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueFillBuffer;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " buffer = " << record.GetArg(&Params::buffer);
+  stream << " pattern = " << record.GetArg(&Params::pattern);
+  stream << " patternSize = " << record.GetArg(&Params::patternSize);
+  stream << " offset = " << record.GetArg(&Params::offset);
+  stream << " size = " << record.GetArg(&Params::size);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueFillBufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueFillImageFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueFillImage;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " image = " << record.GetArg(&Params::image);
+  stream << " fillColor = " << record.GetArg(&Params::fillColor);
+  stream << " origin = " << record.GetArg(&Params::origin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueFillImageFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueMapBufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueMapBuffer;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " buffer = " << record.GetArg(&Params::buffer);
+  stream << " blockingMap = " << record.GetArg(&Params::blockingMap);
+  stream << " mapFlags = " << record.GetArg(&Params::mapFlags);
+  stream << " offset = " << record.GetArg(&Params::offset);
+  stream << " cb = " << record.GetArg(&Params::cb);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clEnqueueMapBufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<void*>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueMapImageFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueMapImage;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " image = " << record.GetArg(&Params::image);
+  stream << " blockingMap = " << record.GetArg(&Params::blockingMap);
+  stream << " mapFlags = " << record.GetArg(&Params::mapFlags);
+  stream << " origin = " << record.GetArg(&Params::origin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " imageRowPitch = " << record.GetArg(&Params::imageRowPitch);
+  stream << " imageSlicePitch = " << record.GetArg(&Params::imageSlicePitch);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clEnqueueMapImageFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<void*>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueMarkerFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueMarker;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueMarkerFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueMarkerWithWaitListFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueMarkerWithWaitList;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueMarkerWithWaitListFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueMigrateMemObjectsFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueMigrateMemObjects;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " numMemObjects = " << record.GetArg(&Params::numMemObjects);
+  stream << " memObjects = " << record.GetArg(&Params::memObjects);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueMigrateMemObjectsFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueNDRangeKernelFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueNDRangeKernel;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+  stream << " workDim = " << record.GetArg(&Params::workDim);
+  stream << " globalWorkOffset = " << record.GetArg(&Params::globalWorkOffset);
+  cl_uint global_work_offset_count = record.GetArg<cl_uint>();
+  if (global_work_offset_count > 0) {
+    stream << " {" << record.GetArg<size_t>();
+    for (cl_uint i = 1; i < global_work_offset_count; ++i) {
+      stream << ", " << record.GetArg<size_t>();
+    }
+    stream << "}";
+  }
+  stream << " globalWorkSize = " << record.GetArg(&Params::globalWorkSize);
+  cl_uint global_work_size_count = record.GetArg<cl_uint>();
+  if (global_work_size_count > 0) {
+    stream << " {" << record.GetArg<size_t>();
+    for (cl_uint i = 1; i < global_work_size_count; ++i) {
+      stream << ", " << record.GetArg<size_t>();
+    }
+    stream << "}";
+  }
+  stream << " localWorkSize = " << record.GetArg(&Params::localWorkSize);
+  cl_uint local_work_size_count = record.GetArg<cl_uint>();
+  if (local_work_size_count > 0) {
+    stream << " {" << record.GetArg<size_t>();
+    for (cl_uint i = 1; i < local_work_size_count; ++i) {
+      stream << ", " << record.GetArg<size_t>();
+    }
+    stream << "}";
+  }
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueNDRangeKernelFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  uint64_t kernel_id = record.GetArg<uint64_t>();
+  if (kernel_id > 0) {
+    stream << "(" << kernel_id << ")";
+  }
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueNativeKernelFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueNativeKernel;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " userFunc = " << record.GetArg(&Params::userFunc);
+  stream << " args = " << record.GetArg(&Params::args);
+  stream << " cbArgs = " << record.GetArg(&Params::cbArgs);
+  stream << " numMemObjects = " << record.GetArg(&Params::numMemObjects);
+  stream << " memList = " << record.GetArg(&Params::memList);
+  stream << " argsMemLoc = " << record.GetArg(&Params::argsMemLoc);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueNativeKernelFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueReadBufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueReadBuffer;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " buffer = " << record.GetArg(&Params::buffer);
+  stream << " blockingRead = " << record.GetArg(&Params::blockingRead);
+  stream << " offset = " << record.GetArg(&Params::offset);
+  stream << " cb = " << record.GetArg(&Params::cb);
+  stream << " ptr = " << record.GetArg(&Params::ptr);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueReadBufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  uint64_t kernel_id = record.GetArg<uint64_t>();
+  if (kernel_id > 0) {
+    stream << "(" << kernel_id << ")";
+  }
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueReadBufferRectFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueReadBufferRect;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " buffer = " << record.GetArg(&Params::buffer);
+  stream << " blockingRead = " << record.GetArg(&Params::blockingRead);
+  stream << " bufferOrigin = " << record.GetArg(&Params::bufferOrigin);
+  stream << " hostOrigin = " << record.GetArg(&Params::hostOrigin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " bufferRowPitch = " << record.GetArg(&Params::bufferRowPitch);
+  stream << " bufferSlicePitch = " << record.GetArg(&Params::bufferSlicePitch);
+  stream << " hostRowPitch = " << record.GetArg(&Params::hostRowPitch);
+  stream << " hostSlicePitch = " << record.GetArg(&Params::hostSlicePitch);
+  stream << " ptr = " << record.GetArg(&Params::ptr);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueReadBufferRectFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueReadImageFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueReadImage;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " image = " << record.GetArg(&Params::image);
+  stream << " blockingRead = " << record.GetArg(&Params::blockingRead);
+  stream << " origin = " << record.GetArg(&Params::origin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " rowPitch = " << record.GetArg(&Params::rowPitch);
+  stream << " slicePitch = " << record.GetArg(&Params::slicePitch);
+  stream << " ptr = " << record.GetArg(&Params::ptr);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueReadImageFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueReleaseGLObjectsFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueReleaseGLObjects;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " numObjects = " << record.GetArg(&Params::numObjects);
+  stream << " memObjects = " << record.GetArg(&Params::memObjects);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueReleaseGLObjectsFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueSVMFreeFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueSVMFree;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " numSvmPointers = " << record.GetArg(&Params::numSvmPointers);
+  stream << " svmPointers = " << record.GetArg(&Params::svmPointers);
+  stream << " pfnFreeFunc = " << record.GetArg(&Params::pfnFreeFunc);
+  stream << " userData = " << record.GetArg(&Params::userData);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueSVMFreeFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueSVMMapFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueSVMMap;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " blockingMap = " << record.GetArg(&Params::blockingMap);
+  stream << " mapFlags = " << record.GetArg(&Params::mapFlags);
+  stream << " svmPtr = " << record.GetArg(&Params::svmPtr);
+  stream << " size = " << record.GetArg(&Params::size);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueSVMMapFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueSVMMemFillFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueSVMMemFill;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " svmPtr = " << record.GetArg(&Params::svmPtr);
+  stream << " pattern = " << record.GetArg(&Params::pattern);
+  stream << " patternSize = " << record.GetArg(&Params::patternSize);
+  stream << " size = " << record.GetArg(&Params::size);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueSVMMemFillFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueSVMMemcpyFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueSVMMemcpy;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " blockingCopy = " << record.GetArg(&Params::blockingCopy);
+  stream << " dstPtr = " << record.GetArg(&Params::dstPtr);
+  stream << " srcPtr = " << record.GetArg(&Params::srcPtr);
+  stream << " size = " << record.GetArg(&Params::size);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueSVMMemcpyFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueSVMMigrateMemFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueSVMMigrateMem;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " numSvmPointers = " << record.GetArg(&Params::numSvmPointers);
+  stream << " svmPointers = " << record.GetArg(&Params::svmPointers);
+  stream << " sizes = " << record.GetArg(&Params::sizes);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueSVMMigrateMemFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueSVMUnmapFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueSVMUnmap;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " svmPtr = " << record.GetArg(&Params::svmPtr);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueSVMUnmapFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueTaskFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueTask;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueTaskFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueUnmapMemObjectFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueUnmapMemObject;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " memobj = " << record.GetArg(&Params::memobj);
+  stream << " mappedPtr = " << record.GetArg(&Params::mappedPtr);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueUnmapMemObjectFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueWaitForEventsFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueWaitForEvents;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " numEvents = " << record.GetArg(&Params::numEvents);
+  stream << " eventList = " << record.GetArg(&Params::eventList);
+}
+
+static void clEnqueueWaitForEventsFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueWriteBufferFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueWriteBuffer;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " buffer = " << record.GetArg(&Params::buffer);
+  stream << " blockingWrite = " << record.GetArg(&Params::blockingWrite);
+  stream << " offset = " << record.GetArg(&Params::offset);
+  stream << " cb = " << record.GetArg(&Params::cb);
+  stream << " ptr = " << record.GetArg(&Params::ptr);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueWriteBufferFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  uint64_t kernel_id = record.GetArg<uint64_t>();
+  if (kernel_id > 0) {
+    stream << "(" << kernel_id << ")";
+  }
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueWriteBufferRectFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueWriteBufferRect;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " buffer = " << record.GetArg(&Params::buffer);
+  stream << " blockingWrite = " << record.GetArg(&Params::blockingWrite);
+  stream << " bufferOrigin = " << record.GetArg(&Params::bufferOrigin);
+  stream << " hostOrigin = " << record.GetArg(&Params::hostOrigin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " bufferRowPitch = " << record.GetArg(&Params::bufferRowPitch);
+  stream << " bufferSlicePitch = " << record.GetArg(&Params::bufferSlicePitch);
+  stream << " hostRowPitch = " << record.GetArg(&Params::hostRowPitch);
+  stream << " hostSlicePitch = " << record.GetArg(&Params::hostSlicePitch);
+  stream << " ptr = " << record.GetArg(&Params::ptr);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueWriteBufferRectFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clEnqueueWriteImageFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clEnqueueWriteImage;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " image = " << record.GetArg(&Params::image);
+  stream << " blockingWrite = " << record.GetArg(&Params::blockingWrite);
+  stream << " origin = " << record.GetArg(&Params::origin);
+  stream << " region = " << record.GetArg(&Params::region);
+  stream << " inputRowPitch = " << record.GetArg(&Params::inputRowPitch);
+  stream << " inputSlicePitch = " << record.GetArg(&Params::inputSlicePitch);
+  stream << " ptr = " << record.GetArg(&Params::ptr);
+  stream << " numEventsInWaitList = " <<
+    record.GetArg(&Params::numEventsInWaitList);
+  stream << " eventWaitList = " << record.GetArg(&Params::eventWaitList);
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clEnqueueWriteImageFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clFinishFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clFinish;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+}
+
+static void clFinishFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clFlushFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clFlush;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+}
+
+static void clFlushFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetCommandQueueInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetCommandQueueInfo;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetCommandQueueInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetContextInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetContextInfo;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetContextInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetDeviceAndHostTimerFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetDeviceAndHostTimer;
+  stream << " device = " << record.GetArg(&Params::device);
+  stream << " deviceTimestamp = " << record.GetArg(&Params::deviceTimestamp);
+  stream << " hostTimestamp = " << record.GetArg(&Params::hostTimestamp);
+}
+
+static void clGetDeviceAndHostTimerFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetDeviceIDsFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetDeviceIDs;
+  stream << " platform = " << record.GetArg(&Params::platform);
+  stream << " deviceType = " << record.GetArg(&Params::deviceType);
+  stream << " numEntries = " << record.GetArg(&Params::numEntries);
+  stream << " devices = " << record.GetArg(&Params::devices);
+  stream << " numDevices = " << record.GetArg(&Params::numDevices);
+}
+
+static void clGetDeviceIDsFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetDeviceInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetDeviceInfo;
+  stream << " device = " << record.GetArg(&Params::device);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetDeviceInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetEventInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetEventInfo;
+  stream << " event = " << record.GetArg(&Params::event);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetEventInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetEventProfilingInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetEventProfilingInfo;
+  stream << " event = " << record.GetArg(&Params::event);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetEventProfilingInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetExtensionFunctionAddressFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  const char* func_name = record.GetString();
+  if (func_name == nullptr) {
+    stream << " funcName = " << "0";
+  } else if (strlen(func_name) == 0) {
+    stream << " funcName = \"\"";
+  } else {
+    stream << " funcName = \"" << func_name << "\"";
+  }
+}
+
+static void clGetExtensionFunctionAddressFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<void*>();
+}
+
+static void clGetExtensionFunctionAddressForPlatformFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetExtensionFunctionAddressForPlatform;
+  stream << " platform = " << record.GetArg(&Params::platform);
+  const char* func_name = record.GetString();
+  if (func_name == nullptr) {
+    stream << " funcName = " << "0";
+  } else if (strlen(func_name) == 0) {
+    stream << " funcName = \"\"";
+  } else {
+    stream << " funcName = \"" << func_name << "\"";
+  }
+}
+
+static void clGetExtensionFunctionAddressForPlatformFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<void*>();
+}
+
+static void clGetGLObjectInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetGLObjectInfo;
+  stream << " memobj = " << record.GetArg(&Params::memobj);
+  stream << " glObjectType = " << record.GetArg(&Params::glObjectType);
+  stream << " glObjectName = " << record.GetArg(&Params::glObjectName);
+}
+
+static void clGetGLObjectInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetGLTextureInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetGLTextureInfo;
+  stream << " memobj = " << record.GetArg(&Params::memobj);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetGLTextureInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetHostTimerFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetHostTimer;
+  stream << " device = " << record.GetArg(&Params::device);
+  stream << " hostTimestamp = " << record.GetArg(&Params::hostTimestamp);
+}
+
+static void clGetHostTimerFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetImageInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetImageInfo;
+  stream << " image = " << record.GetArg(&Params::image);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetImageInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetKernelArgInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetKernelArgInfo;
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+  stream << " argIndx = " << record.GetArg(&Params::argIndx);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetKernelArgInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetKernelInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetKernelInfo;
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetKernelInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetKernelSubGroupInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetKernelSubGroupInfo;
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+  stream << " device = " << record.GetArg(&Params::device);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " inputValueSize = " << record.GetArg(&Params::inputValueSize);
+  stream << " inputValue = " << record.GetArg(&Params::inputValue);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetKernelSubGroupInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetKernelWorkGroupInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetKernelWorkGroupInfo;
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+  stream << " device = " << record.GetArg(&Params::device);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetKernelWorkGroupInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetMemObjectInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetMemObjectInfo;
+  stream << " memobj = " << record.GetArg(&Params::memobj);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetMemObjectInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetPipeInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetPipeInfo;
+  stream << " pipe = " << record.GetArg(&Params::pipe);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetPipeInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetPlatformIDsFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetPlatformIDs;
+  stream << " numEntries = " << record.GetArg(&Params::numEntries);
+  stream << " platforms = " << record.GetArg(&Params::platforms);
+  stream << " numPlatforms = " << record.GetArg(&Params::numPlatforms);
+}
+
+static void clGetPlatformIDsFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetPlatformInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetPlatformInfo;
+  stream << " platform = " << record.GetArg(&Params::platform);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetPlatformInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetProgramBuildInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetProgramBuildInfo;
+  stream << " program = " << record.GetArg(&Params::program);
+  stream << " device = " << record.GetArg(&Params::device);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetProgramBuildInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetProgramInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetProgramInfo;
+  stream << " program = " << record.GetArg(&Params::program);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetProgramInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetSamplerInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetSamplerInfo;
+  stream << " sampler = " << record.GetArg(&Params::sampler);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
+  stream << " paramValueSizeRet = " <<
+    record.GetArg(&Params::paramValueSizeRet);
+}
+
+static void clGetSamplerInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clGetSupportedImageFormatsFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clGetSupportedImageFormats;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " imageType = " << record.GetArg(&Params::imageType);
+  stream << " numEntries = " << record.GetArg(&Params::numEntries);
+  stream << " imageFormats = " << record.GetArg(&Params::imageFormats);
+  stream << " numImageFormats = " << record.GetArg(&Params::numImageFormats);
+}
+
+static void clGetSupportedImageFormatsFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clLinkProgramFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clLinkProgram;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " numDevices = " << record.GetArg(&Params::numDevices);
+  stream << " deviceList = " << record.GetArg(&Params::deviceList);
+  const char* options = record.GetString();
+  if (options == nullptr) {
+    stream << " options = " << "0";
+  } else if (strlen(options) == 0) {
+    stream << " options = \"\"";
+  } else {
+    stream << " options = \"" << options << "\"";
+  }
+  stream << " numInputPrograms = " << record.GetArg(&Params::numInputPrograms);
+  stream << " inputPrograms = " << record.GetArg(&Params::inputPrograms);
+  stream << " funcNotify = " << record.GetArg(&Params::funcNotify);
+  stream << " userData = " << record.GetArg(&Params::userData);
+  stream << " errcodeRet = " << record.GetArg(&Params::errcodeRet);
+}
+
+static void clLinkProgramFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<cl_program>();
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clReleaseCommandQueueFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clReleaseCommandQueue;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+}
+
+static void clReleaseCommandQueueFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clReleaseContextFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clReleaseContext;
+  stream << " context = " << record.GetArg(&Params::context);
+}
+
+static void clReleaseContextFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clReleaseDeviceFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clReleaseDevice;
+  stream << " device = " << record.GetArg(&Params::device);
+}
+
+static void clReleaseDeviceFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clReleaseEventFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clReleaseEvent;
+  stream << " event = " << record.GetArg(&Params::event);
+}
+
+static void clReleaseEventFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clReleaseKernelFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clReleaseKernel;
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+}
+
+static void clReleaseKernelFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clReleaseMemObjectFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clReleaseMemObject;
+  stream << " memobj = " << record.GetArg(&Params::memobj);
+}
+
+static void clReleaseMemObjectFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clReleaseProgramFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clReleaseProgram;
+  stream << " program = " << record.GetArg(&Params::program);
+}
+
+static void clReleaseProgramFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
+
+static void clReleaseSamplerFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clReleaseSampler;
+  stream << " sampler = " << record.GetArg(&Params::sampler);
+}
 
-  stream << " context = " << *(params->context);
-  stream << " il = " << *(params->il);
-  stream << " length = " << *(params->length);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
+static void clReleaseSamplerFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  collector->Log(stream.str());
+static void clRetainCommandQueueFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clRetainCommandQueue;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+}
 
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+static void clRetainCommandQueueFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
 }
 
-static void clCreateProgramWithILOnExit(
-    cl_callback_data* data, uint64_t start, uint64_t end,
-    ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+static void clRetainContextFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clRetainContext;
+  stream << " context = " << record.GetArg(&Params::context);
+}
 
-  const cl_params_clCreateProgramWithIL* params =
-    reinterpret_cast<const cl_params_clCreateProgramWithIL*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+static void clRetainContextFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  cl_program* result =
-    reinterpret_cast<cl_program*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+static void clRetainDeviceFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clRetainDevice;
+  stream << " device = " << record.GetArg(&Params::device);
+}
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+static void clRetainDeviceFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  collector->Log(stream.str());
+static void clRetainEventFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clRetainEvent;
+  stream << " event = " << record.GetArg(&Params::event);
 }
 
-static void clCreateSamplerOnEnter(
-    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateSampler* params =
-    reinterpret_cast<const cl_params_clCreateSampler*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+static void clRetainEventFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+static void clRetainKernelFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clRetainKernel;
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+}
 
-  stream << " context = " << *(params->context);
-  stream << " normalizedCoords = " << *(params->normalizedCoords);
-  stream << " addressingMode = " << *(params->addressingMode);
-  stream << " filterMode = " << *(params->filterMode);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
+static void clRetainKernelFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  collector->Log(stream.str());
+static void clRetainMemObjectFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clRetainMemObject;
+  stream << " memobj = " << record.GetArg(&Params::memobj);
+}
 
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+static void clRetainMemObjectFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
 }
 
-static void clCreateSamplerOnExit(
-    cl_callback_data* data, uint64_t start, uint64_t end,
-    ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+static void clRetainProgramFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clRetainProgram;
+  stream << " program = " << record.GetArg(&Params::program);
+}
 
-  const cl_params_clCreateSampler* params =
-    reinterpret_cast<const cl_params_clCreateSampler*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+static void clRetainProgramFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  cl_sampler* result =
-    reinterpret_cast<cl_sampler*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+static void clRetainSamplerFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clRetainSampler;
+  stream << " sampler = " << record.GetArg(&Params::sampler);
+}
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+static void clRetainSamplerFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  collector->Log(stream.str());
+static void clSVMAllocFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSVMAlloc;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " flags = " << record.GetArg(&Params::flags);
+  stream << " size = " << record.GetArg(&Params::size);
+  stream << " alignment = " << record.GetArg(&Params::alignment);
 }
 
-static void clCreateFromGLTextureOnEnter(
-    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  const cl_params_clCreateFromGLTexture* params =
-    reinterpret_cast<const cl_params_clCreateFromGLTexture*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+static void clSVMAllocFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  stream << " result = " << record.GetArg<void*>();
+}
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+static void clSVMFreeFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSVMFree;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " svmPointer = " << record.GetArg(&Params::svmPointer);
+}
 
-  stream << " context = " << *(params->context);
-  stream << " flags = " << *(params->flags);
-  stream << " target = " << *(params->target);
-  stream << " miplevel = " << *(params->miplevel);
-  stream << " texture = " << *(params->texture);
-  stream << " errcodeRet = " << *(params->errcodeRet);
-  stream << std::endl;
+static void clSVMFreeFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+}
 
-  collector->Log(stream.str());
+static void clSetCommandQueuePropertyFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSetCommandQueueProperty;
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+  stream << " properties = " << record.GetArg(&Params::properties);
+  stream << " enable = " << record.GetArg(&Params::enable);
+  stream << " oldProperties = " << record.GetArg(&Params::oldProperties);
+}
 
-  if (*(params->errcodeRet) == nullptr) {
-    *(params->errcodeRet) = &current_error;
-  }
+static void clSetCommandQueuePropertyFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
 }
 
-static void clCreateFromGLTextureOnExit(
-    cl_callback_data* data, uint64_t start, uint64_t end,
-    ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+static void clSetDefaultDeviceCommandQueueFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSetDefaultDeviceCommandQueue;
+  stream << " context = " << record.GetArg(&Params::context);
+  stream << " device = " << record.GetArg(&Params::device);
+  stream << " commandQueue = " << record.GetArg(&Params::commandQueue);
+}
 
-  const cl_params_clCreateFromGLTexture* params =
-    reinterpret_cast<const cl_params_clCreateFromGLTexture*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+static void clSetDefaultDeviceCommandQueueFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  cl_mem* result =
-    reinterpret_cast<cl_mem*>(data->functionReturnValue);
-  PTI_ASSERT(result != nullptr);
-  stream << " result = " << *result;
+static void clSetEventCallbackFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSetEventCallback;
+  stream << " event = " << record.GetArg(&Params::event);
+  stream << " commandExecCallbackType = " <<
+    record.GetArg(&Params::commandExecCallbackType);
+  stream << " funcNotify = " << record.GetArg(&Params::funcNotify);
+  stream << " userData = " << record.GetArg(&Params::userData);
+}
 
-  PTI_ASSERT(*(params->errcodeRet) != nullptr);
-  stream << " -> " << utils::cl::GetErrorString(**(params->errcodeRet));
-  stream << " (" << **(params->errcodeRet) << ")";
-  stream << std::endl;
+static void clSetEventCallbackFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  collector->Log(stream.str());
+static void clSetKernelArgFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSetKernelArg;
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+  stream << " argIndex = " << record.GetArg(&Params::argIndex);
+  stream << " argSize = " << record.GetArg(&Params::argSize);
+  stream << " argValue = " << record.GetArg(&Params::argValue);
 }
 
-static void clSVMFreeOnEnter(
-    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  const cl_params_clSVMFree* params =
-    reinterpret_cast<const cl_params_clSVMFree*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+static void clSetKernelArgFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+static void clSetKernelArgSVMPointerFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSetKernelArgSVMPointer;
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+  stream << " argIndex = " << record.GetArg(&Params::argIndex);
+  stream << " argValue = " << record.GetArg(&Params::argValue);
+}
 
-  stream << " context = " << *(params->context);
-  stream << " svmPointer = " << *(params->svmPointer);
-  stream << std::endl;
+static void clSetKernelArgSVMPointerFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  collector->Log(stream.str());
+static void clSetKernelExecInfoFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSetKernelExecInfo;
+  stream << " kernel = " << record.GetArg(&Params::kernel);
+  stream << " paramName = " << record.GetArg(&Params::paramName);
+  stream << " paramValueSize = " << record.GetArg(&Params::paramValueSize);
+  stream << " paramValue = " << record.GetArg(&Params::paramValue);
 }
 
-static void clSVMFreeOnExit(
-    cl_callback_data* data, uint64_t start, uint64_t end,
-    ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+static void clSetKernelExecInfoFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  stream << std::endl;
+static void clSetMemObjectDestructorCallbackFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSetMemObjectDestructorCallback;
+  stream << " memobj = " << record.GetArg(&Params::memobj);
+  stream << " funcNotify = " << record.GetArg(&Params::funcNotify);
+  stream << " userData = " << record.GetArg(&Params::userData);
+}
 
-  collector->Log(stream.str());
+static void clSetMemObjectDestructorCallbackFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
 }
 
-static void clReleaseEventOnEnter(
-    cl_callback_data* data, uint64_t start, ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  const cl_params_clReleaseEvent* params =
-    reinterpret_cast<const cl_params_clReleaseEvent*>(
-        data->functionParams);
-  PTI_ASSERT(params != nullptr);
+static void clSetUserEventStatusFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clSetUserEventStatus;
+  stream << " event = " << record.GetArg(&Params::event);
+  stream << " executionStatus = " << record.GetArg(&Params::executionStatus);
+}
 
-  std::stringstream stream;
-  stream << ">>>> [" << start << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName << ":";
+static void clSetUserEventStatusFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  stream << " event = " << *(params->event);
-  stream << std::endl;
+static void clUnloadCompilerFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+}
 
-  collector->Log(stream.str());
+static void clUnloadCompilerFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
 }
 
-static void clReleaseEventOnExit(
-    cl_callback_data* data, uint64_t start, uint64_t end,
-    ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
-  std::stringstream stream;
-  stream << "<<<< [" << end << "] ";
-  if (collector->NeedPid()) {
-    stream << "<PID:" << utils::GetPid() << "> ";
-  }
-  if (collector->NeedTid()) {
-    stream << "<TID:" << utils::GetTid() << "> ";
-  }
-  stream << data->functionName;
-  stream << " [" << (end - start) << " ns]";
+static void clUnloadPlatformCompilerFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clUnloadPlatformCompiler;
+  stream << " platform = " << record.GetArg(&Params::platform);
+}
 
-  cl_int* error = reinterpret_cast<cl_int*>(data->functionReturnValue);
-  PTI_ASSERT(error != nullptr);
+static void clUnloadPlatformCompilerFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
+}
 
-  stream << " -> " << utils::cl::GetErrorString(*error);
-  stream << " (" << *error << ")";
-  stream << std::endl;
+static void clWaitForEventsFormatEnter(
+    ClCallRecordReader& record, std::ostream& stream) {
+  using Params = cl_params_clWaitForEvents;
+  stream << " numEvents = " << record.GetArg(&Params::numEvents);
+  stream << " eventList = " << record.GetArg(&Params::eventList);
+}
 
-  collector->Log(stream.str());
+static void clWaitForEventsFormatExit(
+    ClCallRecordReader& record, std::ostream& stream) {
+  stream << " [" << (record.GetEnd() - record.GetStart()) << " ns]";
+  cl_int error = record.GetArg<cl_int>();
+  stream << " -> " << utils::cl::GetErrorString(error);
+  stream << " (" << error << ")";
 }
 
-static void OnEnterFunction(
-    cl_function_id function, cl_callback_data* data,
-    uint64_t start, ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
+static void FormatEnterFunction(
+    cl_function_id function, ClCallRecordReader& record,
+    std::ostream& stream) {
   switch (function) {
     case CL_FUNCTION_clBuildProgram:
-      clBuildProgramOnEnter(data, start, collector);
+      clBuildProgramFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCloneKernel:
-      clCloneKernelOnEnter(data, start, collector);
+      clCloneKernelFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCompileProgram:
-      clCompileProgramOnEnter(data, start, collector);
+      clCompileProgramFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateBuffer:
-      clCreateBufferOnEnter(data, start, collector);
+      clCreateBufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateCommandQueue:
-      clCreateCommandQueueOnEnter(data, start, collector);
+      clCreateCommandQueueFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateCommandQueueWithProperties:
-      clCreateCommandQueueWithPropertiesOnEnter(data, start, collector);
+      clCreateCommandQueueWithPropertiesFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateContext:
-      clCreateContextOnEnter(data, start, collector);
+      clCreateContextFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateContextFromType:
-      clCreateContextFromTypeOnEnter(data, start, collector);
+      clCreateContextFromTypeFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLBuffer:
-      clCreateFromGLBufferOnEnter(data, start, collector);
+      clCreateFromGLBufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLRenderbuffer:
-      clCreateFromGLRenderbufferOnEnter(data, start, collector);
+      clCreateFromGLRenderbufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLTexture:
-      clCreateFromGLTextureOnEnter(data, start, collector);
+      clCreateFromGLTextureFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLTexture2D:
-      clCreateFromGLTexture2DOnEnter(data, start, collector);
+      clCreateFromGLTexture2DFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLTexture3D:
-      clCreateFromGLTexture3DOnEnter(data, start, collector);
+      clCreateFromGLTexture3DFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateImage:
-      clCreateImageOnEnter(data, start, collector);
+      clCreateImageFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateImage2D:
-      clCreateImage2DOnEnter(data, start, collector);
+      clCreateImage2DFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateImage3D:
-      clCreateImage3DOnEnter(data, start, collector);
+      clCreateImage3DFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateKernel:
-      clCreateKernelOnEnter(data, start, collector);
+      clCreateKernelFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateKernelsInProgram:
-      clCreateKernelsInProgramOnEnter(data, start, collector);
+      clCreateKernelsInProgramFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreatePipe:
-      clCreatePipeOnEnter(data, start, collector);
+      clCreatePipeFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateProgramWithBinary:
-      clCreateProgramWithBinaryOnEnter(data, start, collector);
+      clCreateProgramWithBinaryFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateProgramWithBuiltInKernels:
-      clCreateProgramWithBuiltInKernelsOnEnter(data, start, collector);
+      clCreateProgramWithBuiltInKernelsFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateProgramWithIL:
-      clCreateProgramWithILOnEnter(data, start, collector);
+      clCreateProgramWithILFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateProgramWithSource:
-      clCreateProgramWithSourceOnEnter(data, start, collector);
+      clCreateProgramWithSourceFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateSampler:
-      clCreateSamplerOnEnter(data, start, collector);
+      clCreateSamplerFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateSamplerWithProperties:
-      clCreateSamplerWithPropertiesOnEnter(data, start, collector);
+      clCreateSamplerWithPropertiesFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateSubBuffer:
-      clCreateSubBufferOnEnter(data, start, collector);
+      clCreateSubBufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateSubDevices:
-      clCreateSubDevicesOnEnter(data, start, collector);
+      clCreateSubDevicesFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clCreateUserEvent:
-      clCreateUserEventOnEnter(data, start, collector);
+      clCreateUserEventFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueAcquireGLObjects:
-      clEnqueueAcquireGLObjectsOnEnter(data, start, collector);
+      clEnqueueAcquireGLObjectsFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueBarrier:
-      clEnqueueBarrierOnEnter(data, start, collector);
+      clEnqueueBarrierFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueBarrierWithWaitList:
-      clEnqueueBarrierWithWaitListOnEnter(data, start, collector);
+      clEnqueueBarrierWithWaitListFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyBuffer:
-      clEnqueueCopyBufferOnEnter(data, start, collector);
+      clEnqueueCopyBufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyBufferRect:
-      clEnqueueCopyBufferRectOnEnter(data, start, collector);
+      clEnqueueCopyBufferRectFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyBufferToImage:
-      clEnqueueCopyBufferToImageOnEnter(data, start, collector);
+      clEnqueueCopyBufferToImageFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyImage:
-      clEnqueueCopyImageOnEnter(data, start, collector);
+      clEnqueueCopyImageFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyImageToBuffer:
-      clEnqueueCopyImageToBufferOnEnter(data, start, collector);
+      clEnqueueCopyImageToBufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueFillBuffer:
-      clEnqueueFillBufferOnEnter(data, start, collector);
+      clEnqueueFillBufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueFillImage:
-      clEnqueueFillImageOnEnter(data, start, collector);
+      clEnqueueFillImageFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMapBuffer:
-      clEnqueueMapBufferOnEnter(data, start, collector);
+      clEnqueueMapBufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMapImage:
-      clEnqueueMapImageOnEnter(data, start, collector);
+      clEnqueueMapImageFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMarker:
-      clEnqueueMarkerOnEnter(data, start, collector);
+      clEnqueueMarkerFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMarkerWithWaitList:
-      clEnqueueMarkerWithWaitListOnEnter(data, start, collector);
+      clEnqueueMarkerWithWaitListFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMigrateMemObjects:
-      clEnqueueMigrateMemObjectsOnEnter(data, start, collector);
+      clEnqueueMigrateMemObjectsFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueNDRangeKernel:
-      clEnqueueNDRangeKernelOnEnter(data, start, collector);
+      clEnqueueNDRangeKernelFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueNativeKernel:
-      clEnqueueNativeKernelOnEnter(data, start, collector);
+      clEnqueueNativeKernelFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueReadBuffer:
-      clEnqueueReadBufferOnEnter(data, start, collector);
+      clEnqueueReadBufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueReadBufferRect:
-      clEnqueueReadBufferRectOnEnter(data, start, collector);
+      clEnqueueReadBufferRectFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueReadImage:
-      clEnqueueReadImageOnEnter(data, start, collector);
+      clEnqueueReadImageFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueReleaseGLObjects:
-      clEnqueueReleaseGLObjectsOnEnter(data, start, collector);
+      clEnqueueReleaseGLObjectsFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMFree:
-      clEnqueueSVMFreeOnEnter(data, start, collector);
+      clEnqueueSVMFreeFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMMap:
-      clEnqueueSVMMapOnEnter(data, start, collector);
+      clEnqueueSVMMapFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMMemFill:
-      clEnqueueSVMMemFillOnEnter(data, start, collector);
+      clEnqueueSVMMemFillFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMMemcpy:
-      clEnqueueSVMMemcpyOnEnter(data, start, collector);
+      clEnqueueSVMMemcpyFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMMigrateMem:
-      clEnqueueSVMMigrateMemOnEnter(data, start, collector);
+      clEnqueueSVMMigrateMemFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMUnmap:
-      clEnqueueSVMUnmapOnEnter(data, start, collector);
+      clEnqueueSVMUnmapFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueTask:
-      clEnqueueTaskOnEnter(data, start, collector);
+      clEnqueueTaskFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueUnmapMemObject:
-      clEnqueueUnmapMemObjectOnEnter(data, start, collector);
+      clEnqueueUnmapMemObjectFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueWaitForEvents:
-      clEnqueueWaitForEventsOnEnter(data, start, collector);
+      clEnqueueWaitForEventsFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueWriteBuffer:
-      clEnqueueWriteBufferOnEnter(data, start, collector);
+      clEnqueueWriteBufferFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueWriteBufferRect:
-      clEnqueueWriteBufferRectOnEnter(data, start, collector);
+      clEnqueueWriteBufferRectFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clEnqueueWriteImage:
-      clEnqueueWriteImageOnEnter(data, start, collector);
+      clEnqueueWriteImageFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clFinish:
-      clFinishOnEnter(data, start, collector);
+      clFinishFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clFlush:
-      clFlushOnEnter(data, start, collector);
+      clFlushFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetCommandQueueInfo:
-      clGetCommandQueueInfoOnEnter(data, start, collector);
+      clGetCommandQueueInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetContextInfo:
-      clGetContextInfoOnEnter(data, start, collector);
+      clGetContextInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetDeviceAndHostTimer:
-      clGetDeviceAndHostTimerOnEnter(data, start, collector);
+      clGetDeviceAndHostTimerFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetDeviceIDs:
-      clGetDeviceIDsOnEnter(data, start, collector);
+      clGetDeviceIDsFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetDeviceInfo:
-      clGetDeviceInfoOnEnter(data, start, collector);
+      clGetDeviceInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetEventInfo:
-      clGetEventInfoOnEnter(data, start, collector);
+      clGetEventInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetEventProfilingInfo:
-      clGetEventProfilingInfoOnEnter(data, start, collector);
+      clGetEventProfilingInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetExtensionFunctionAddress:
-      clGetExtensionFunctionAddressOnEnter(data, start, collector);
+      clGetExtensionFunctionAddressFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetExtensionFunctionAddressForPlatform:
-      clGetExtensionFunctionAddressForPlatformOnEnter(data, start, collector);
+      clGetExtensionFunctionAddressForPlatformFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetGLObjectInfo:
-      clGetGLObjectInfoOnEnter(data, start, collector);
+      clGetGLObjectInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetGLTextureInfo:
-      clGetGLTextureInfoOnEnter(data, start, collector);
+      clGetGLTextureInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetHostTimer:
-      clGetHostTimerOnEnter(data, start, collector);
+      clGetHostTimerFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetImageInfo:
-      clGetImageInfoOnEnter(data, start, collector);
+      clGetImageInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetKernelArgInfo:
-      clGetKernelArgInfoOnEnter(data, start, collector);
+      clGetKernelArgInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetKernelInfo:
-      clGetKernelInfoOnEnter(data, start, collector);
+      clGetKernelInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetKernelSubGroupInfo:
-      clGetKernelSubGroupInfoOnEnter(data, start, collector);
+      clGetKernelSubGroupInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetKernelWorkGroupInfo:
-      clGetKernelWorkGroupInfoOnEnter(data, start, collector);
+      clGetKernelWorkGroupInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetMemObjectInfo:
-      clGetMemObjectInfoOnEnter(data, start, collector);
+      clGetMemObjectInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetPipeInfo:
-      clGetPipeInfoOnEnter(data, start, collector);
+      clGetPipeInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetPlatformIDs:
-      clGetPlatformIDsOnEnter(data, start, collector);
+      clGetPlatformIDsFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetPlatformInfo:
-      clGetPlatformInfoOnEnter(data, start, collector);
+      clGetPlatformInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetProgramBuildInfo:
-      clGetProgramBuildInfoOnEnter(data, start, collector);
+      clGetProgramBuildInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetProgramInfo:
-      clGetProgramInfoOnEnter(data, start, collector);
+      clGetProgramInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetSamplerInfo:
-      clGetSamplerInfoOnEnter(data, start, collector);
+      clGetSamplerInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clGetSupportedImageFormats:
-      clGetSupportedImageFormatsOnEnter(data, start, collector);
+      clGetSupportedImageFormatsFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clLinkProgram:
-      clLinkProgramOnEnter(data, start, collector);
+      clLinkProgramFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clReleaseCommandQueue:
-      clReleaseCommandQueueOnEnter(data, start, collector);
+      clReleaseCommandQueueFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clReleaseContext:
-      clReleaseContextOnEnter(data, start, collector);
+      clReleaseContextFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clReleaseDevice:
-      clReleaseDeviceOnEnter(data, start, collector);
+      clReleaseDeviceFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clReleaseEvent:
-      clReleaseEventOnEnter(data, start, collector);
+      clReleaseEventFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clReleaseKernel:
-      clReleaseKernelOnEnter(data, start, collector);
+      clReleaseKernelFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clReleaseMemObject:
-      clReleaseMemObjectOnEnter(data, start, collector);
+      clReleaseMemObjectFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clReleaseProgram:
-      clReleaseProgramOnEnter(data, start, collector);
+      clReleaseProgramFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clReleaseSampler:
-      clReleaseSamplerOnEnter(data, start, collector);
+      clReleaseSamplerFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clRetainCommandQueue:
-      clRetainCommandQueueOnEnter(data, start, collector);
+      clRetainCommandQueueFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clRetainContext:
-      clRetainContextOnEnter(data, start, collector);
+      clRetainContextFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clRetainDevice:
-      clRetainDeviceOnEnter(data, start, collector);
+      clRetainDeviceFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clRetainEvent:
-      clRetainEventOnEnter(data, start, collector);
+      clRetainEventFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clRetainKernel:
-      clRetainKernelOnEnter(data, start, collector);
+      clRetainKernelFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clRetainMemObject:
-      clRetainMemObjectOnEnter(data, start, collector);
+      clRetainMemObjectFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clRetainProgram:
-      clRetainProgramOnEnter(data, start, collector);
+      clRetainProgramFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clRetainSampler:
-      clRetainSamplerOnEnter(data, start, collector);
+      clRetainSamplerFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSVMAlloc:
-      clSVMAllocOnEnter(data, start, collector);
+      clSVMAllocFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSVMFree:
-      clSVMFreeOnEnter(data, start, collector);
+      clSVMFreeFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSetCommandQueueProperty:
-      clSetCommandQueuePropertyOnEnter(data, start, collector);
+      clSetCommandQueuePropertyFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSetDefaultDeviceCommandQueue:
-      clSetDefaultDeviceCommandQueueOnEnter(data, start, collector);
+      clSetDefaultDeviceCommandQueueFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSetEventCallback:
-      clSetEventCallbackOnEnter(data, start, collector);
+      clSetEventCallbackFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSetKernelArg:
-      clSetKernelArgOnEnter(data, start, collector);
+      clSetKernelArgFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSetKernelArgSVMPointer:
-      clSetKernelArgSVMPointerOnEnter(data, start, collector);
+      clSetKernelArgSVMPointerFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSetKernelExecInfo:
-      clSetKernelExecInfoOnEnter(data, start, collector);
+      clSetKernelExecInfoFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSetMemObjectDestructorCallback:
-      clSetMemObjectDestructorCallbackOnEnter(data, start, collector);
+      clSetMemObjectDestructorCallbackFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clSetUserEventStatus:
-      clSetUserEventStatusOnEnter(data, start, collector);
+      clSetUserEventStatusFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clUnloadCompiler:
-      clUnloadCompilerOnEnter(data, start, collector);
+      clUnloadCompilerFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clUnloadPlatformCompiler:
-      clUnloadPlatformCompilerOnEnter(data, start, collector);
+      clUnloadPlatformCompilerFormatEnter(record, stream);
       break;
     case CL_FUNCTION_clWaitForEvents:
-      clWaitForEventsOnEnter(data, start, collector);
+      clWaitForEventsFormatEnter(record, stream);
       break;
     default:
       break;
   }
 }
 
-static void OnExitFunction(
-    cl_function_id function, cl_callback_data* data,
-    uint64_t start, uint64_t end, ClApiCollector* collector) {
-  PTI_ASSERT(collector != nullptr);
+static void FormatExitFunction(
+    cl_function_id function, ClCallRecordReader& record,
+    std::ostream& stream) {
   switch (function) {
     case CL_FUNCTION_clBuildProgram:
-      clBuildProgramOnExit(data, start, end, collector);
+      clBuildProgramFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCloneKernel:
-      clCloneKernelOnExit(data, start, end, collector);
+      clCloneKernelFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCompileProgram:
-      clCompileProgramOnExit(data, start, end, collector);
+      clCompileProgramFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateBuffer:
-      clCreateBufferOnExit(data, start, end, collector);
+      clCreateBufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateCommandQueue:
-      clCreateCommandQueueOnExit(data, start, end, collector);
+      clCreateCommandQueueFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateCommandQueueWithProperties:
-      clCreateCommandQueueWithPropertiesOnExit(data, start, end, collector);
+      clCreateCommandQueueWithPropertiesFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateContext:
-      clCreateContextOnExit(data, start, end, collector);
+      clCreateContextFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateContextFromType:
-      clCreateContextFromTypeOnExit(data, start, end, collector);
+      clCreateContextFromTypeFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLBuffer:
-      clCreateFromGLBufferOnExit(data, start, end, collector);
+      clCreateFromGLBufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLRenderbuffer:
-      clCreateFromGLRenderbufferOnExit(data, start, end, collector);
+      clCreateFromGLRenderbufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLTexture:
-      clCreateFromGLTextureOnExit(data, start, end, collector);
+      clCreateFromGLTextureFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLTexture2D:
-      clCreateFromGLTexture2DOnExit(data, start, end, collector);
+      clCreateFromGLTexture2DFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateFromGLTexture3D:
-      clCreateFromGLTexture3DOnExit(data, start, end, collector);
+      clCreateFromGLTexture3DFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateImage:
-      clCreateImageOnExit(data, start, end, collector);
+      clCreateImageFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateImage2D:
-      clCreateImage2DOnExit(data, start, end, collector);
+      clCreateImage2DFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateImage3D:
-      clCreateImage3DOnExit(data, start, end, collector);
+      clCreateImage3DFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateKernel:
-      clCreateKernelOnExit(data, start, end, collector);
+      clCreateKernelFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateKernelsInProgram:
-      clCreateKernelsInProgramOnExit(data, start, end, collector);
+      clCreateKernelsInProgramFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreatePipe:
-      clCreatePipeOnExit(data, start, end, collector);
+      clCreatePipeFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateProgramWithBinary:
-      clCreateProgramWithBinaryOnExit(data, start, end, collector);
+      clCreateProgramWithBinaryFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateProgramWithBuiltInKernels:
-      clCreateProgramWithBuiltInKernelsOnExit(data, start, end, collector);
+      clCreateProgramWithBuiltInKernelsFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateProgramWithIL:
-      clCreateProgramWithILOnExit(data, start, end, collector);
+      clCreateProgramWithILFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateProgramWithSource:
-      clCreateProgramWithSourceOnExit(data, start, end, collector);
+      clCreateProgramWithSourceFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateSampler:
-      clCreateSamplerOnExit(data, start, end, collector);
+      clCreateSamplerFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateSamplerWithProperties:
-      clCreateSamplerWithPropertiesOnExit(data, start, end, collector);
+      clCreateSamplerWithPropertiesFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateSubBuffer:
-      clCreateSubBufferOnExit(data, start, end, collector);
+      clCreateSubBufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateSubDevices:
-      clCreateSubDevicesOnExit(data, start, end, collector);
+      clCreateSubDevicesFormatExit(record, stream);
       break;
     case CL_FUNCTION_clCreateUserEvent:
-      clCreateUserEventOnExit(data, start, end, collector);
+      clCreateUserEventFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueAcquireGLObjects:
-      clEnqueueAcquireGLObjectsOnExit(data, start, end, collector);
+      clEnqueueAcquireGLObjectsFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueBarrier:
-      clEnqueueBarrierOnExit(data, start, end, collector);
+      clEnqueueBarrierFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueBarrierWithWaitList:
-      clEnqueueBarrierWithWaitListOnExit(data, start, end, collector);
+      clEnqueueBarrierWithWaitListFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyBuffer:
-      clEnqueueCopyBufferOnExit(data, start, end, collector);
+      clEnqueueCopyBufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyBufferRect:
-      clEnqueueCopyBufferRectOnExit(data, start, end, collector);
+      clEnqueueCopyBufferRectFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyBufferToImage:
-      clEnqueueCopyBufferToImageOnExit(data, start, end, collector);
+      clEnqueueCopyBufferToImageFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyImage:
-      clEnqueueCopyImageOnExit(data, start, end, collector);
+      clEnqueueCopyImageFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueCopyImageToBuffer:
-      clEnqueueCopyImageToBufferOnExit(data, start, end, collector);
+      clEnqueueCopyImageToBufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueFillBuffer:
-      clEnqueueFillBufferOnExit(data, start, end, collector);
+      clEnqueueFillBufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueFillImage:
-      clEnqueueFillImageOnExit(data, start, end, collector);
+      clEnqueueFillImageFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMapBuffer:
-      clEnqueueMapBufferOnExit(data, start, end, collector);
+      clEnqueueMapBufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMapImage:
-      clEnqueueMapImageOnExit(data, start, end, collector);
+      clEnqueueMapImageFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMarker:
-      clEnqueueMarkerOnExit(data, start, end, collector);
+      clEnqueueMarkerFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMarkerWithWaitList:
-      clEnqueueMarkerWithWaitListOnExit(data, start, end, collector);
+      clEnqueueMarkerWithWaitListFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueMigrateMemObjects:
-      clEnqueueMigrateMemObjectsOnExit(data, start, end, collector);
+      clEnqueueMigrateMemObjectsFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueNDRangeKernel:
-      clEnqueueNDRangeKernelOnExit(data, start, end, collector);
+      clEnqueueNDRangeKernelFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueNativeKernel:
-      clEnqueueNativeKernelOnExit(data, start, end, collector);
+      clEnqueueNativeKernelFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueReadBuffer:
-      clEnqueueReadBufferOnExit(data, start, end, collector);
+      clEnqueueReadBufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueReadBufferRect:
-      clEnqueueReadBufferRectOnExit(data, start, end, collector);
+      clEnqueueReadBufferRectFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueReadImage:
-      clEnqueueReadImageOnExit(data, start, end, collector);
+      clEnqueueReadImageFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueReleaseGLObjects:
-      clEnqueueReleaseGLObjectsOnExit(data, start, end, collector);
+      clEnqueueReleaseGLObjectsFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMFree:
-      clEnqueueSVMFreeOnExit(data, start, end, collector);
+      clEnqueueSVMFreeFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMMap:
-      clEnqueueSVMMapOnExit(data, start, end, collector);
+      clEnqueueSVMMapFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMMemFill:
-      clEnqueueSVMMemFillOnExit(data, start, end, collector);
+      clEnqueueSVMMemFillFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMMemcpy:
-      clEnqueueSVMMemcpyOnExit(data, start, end, collector);
+      clEnqueueSVMMemcpyFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMMigrateMem:
-      clEnqueueSVMMigrateMemOnExit(data, start, end, collector);
+      clEnqueueSVMMigrateMemFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueSVMUnmap:
-      clEnqueueSVMUnmapOnExit(data, start, end, collector);
+      clEnqueueSVMUnmapFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueTask:
-      clEnqueueTaskOnExit(data, start, end, collector);
+      clEnqueueTaskFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueUnmapMemObject:
-      clEnqueueUnmapMemObjectOnExit(data, start, end, collector);
+      clEnqueueUnmapMemObjectFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueWaitForEvents:
-      clEnqueueWaitForEventsOnExit(data, start, end, collector);
+      clEnqueueWaitForEventsFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueWriteBuffer:
-      clEnqueueWriteBufferOnExit(data, start, end, collector);
+      clEnqueueWriteBufferFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueWriteBufferRect:
-      clEnqueueWriteBufferRectOnExit(data, start, end, collector);
+      clEnqueueWriteBufferRectFormatExit(record, stream);
       break;
     case CL_FUNCTION_clEnqueueWriteImage:
-      clEnqueueWriteImageOnExit(data, start, end, collector);
+      clEnqueueWriteImageFormatExit(record, stream);
       break;
     case CL_FUNCTION_clFinish:
-      clFinishOnExit(data, start, end, collector);
+      clFinishFormatExit(record, stream);
       break;
     case CL_FUNCTION_clFlush:
-      clFlushOnExit(data, start, end, collector);
+      clFlushFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetCommandQueueInfo:
-      clGetCommandQueueInfoOnExit(data, start, end, collector);
+      clGetCommandQueueInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetContextInfo:
-      clGetContextInfoOnExit(data, start, end, collector);
+      clGetContextInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetDeviceAndHostTimer:
-      clGetDeviceAndHostTimerOnExit(data, start, end, collector);
+      clGetDeviceAndHostTimerFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetDeviceIDs:
-      clGetDeviceIDsOnExit(data, start, end, collector);
+      clGetDeviceIDsFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetDeviceInfo:
-      clGetDeviceInfoOnExit(data, start, end, collector);
+      clGetDeviceInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetEventInfo:
-      clGetEventInfoOnExit(data, start, end, collector);
+      clGetEventInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetEventProfilingInfo:
-      clGetEventProfilingInfoOnExit(data, start, end, collector);
+      clGetEventProfilingInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetExtensionFunctionAddress:
-      clGetExtensionFunctionAddressOnExit(data, start, end, collector);
+      clGetExtensionFunctionAddressFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetExtensionFunctionAddressForPlatform:
-      clGetExtensionFunctionAddressForPlatformOnExit(
-          data, start, end, collector);
+      clGetExtensionFunctionAddressForPlatformFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetGLObjectInfo:
-      clGetGLObjectInfoOnExit(data, start, end, collector);
+      clGetGLObjectInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetGLTextureInfo:
-      clGetGLTextureInfoOnExit(data, start, end, collector);
+      clGetGLTextureInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetHostTimer:
-      clGetHostTimerOnExit(data, start, end, collector);
+      clGetHostTimerFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetImageInfo:
-      clGetImageInfoOnExit(data, start, end, collector);
+      clGetImageInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetKernelArgInfo:
-      clGetKernelArgInfoOnExit(data, start, end, collector);
+      clGetKernelArgInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetKernelInfo:
-      clGetKernelInfoOnExit(data, start, end, collector);
+      clGetKernelInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetKernelSubGroupInfo:
-      clGetKernelSubGroupInfoOnExit(data, start, end, collector);
+      clGetKernelSubGroupInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetKernelWorkGroupInfo:
-      clGetKernelWorkGroupInfoOnExit(data, start, end, collector);
+      clGetKernelWorkGroupInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetMemObjectInfo:
-      clGetMemObjectInfoOnExit(data, start, end, collector);
+      clGetMemObjectInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetPipeInfo:
-      clGetPipeInfoOnExit(data, start, end, collector);
+      clGetPipeInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetPlatformIDs:
-      clGetPlatformIDsOnExit(data, start, end, collector);
+      clGetPlatformIDsFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetPlatformInfo:
-      clGetPlatformInfoOnExit(data, start, end, collector);
+      clGetPlatformInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetProgramBuildInfo:
-      clGetProgramBuildInfoOnExit(data, start, end, collector);
+      clGetProgramBuildInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetProgramInfo:
-      clGetProgramInfoOnExit(data, start, end, collector);
+      clGetProgramInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetSamplerInfo:
-      clGetSamplerInfoOnExit(data, start, end, collector);
+      clGetSamplerInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clGetSupportedImageFormats:
-      clGetSupportedImageFormatsOnExit(data, start, end, collector);
+      clGetSupportedImageFormatsFormatExit(record, stream);
       break;
     case CL_FUNCTION_clLinkProgram:
-      clLinkProgramOnExit(data, start, end, collector);
+      clLinkProgramFormatExit(record, stream);
       break;
     case CL_FUNCTION_clReleaseCommandQueue:
-      clReleaseCommandQueueOnExit(data, start, end, collector);
+      clReleaseCommandQueueFormatExit(record, stream);
       break;
     case CL_FUNCTION_clReleaseContext:
-      clReleaseContextOnExit(data, start, end, collector);
+      clReleaseContextFormatExit(record, stream);
       break;
     case CL_FUNCTION_clReleaseDevice:
-      clReleaseDeviceOnExit(data, start, end, collector);
+      clReleaseDeviceFormatExit(record, stream);
       break;
     case CL_FUNCTION_clReleaseEvent:
-      clReleaseEventOnExit(data, start, end, collector);
+      clReleaseEventFormatExit(record, stream);
       break;
     case CL_FUNCTION_clReleaseKernel:
-      clReleaseKernelOnExit(data, start, end, collector);
+      clReleaseKernelFormatExit(record, stream);
       break;
     case CL_FUNCTION_clReleaseMemObject:
-      clReleaseMemObjectOnExit(data, start, end, collector);
+      clReleaseMemObjectFormatExit(record, stream);
       break;
     case CL_FUNCTION_clReleaseProgram:
-      clReleaseProgramOnExit(data, start, end, collector);
+      clReleaseProgramFormatExit(record, stream);
       break;
     case CL_FUNCTION_clReleaseSampler:
-      clReleaseSamplerOnExit(data, start, end, collector);
+      clReleaseSamplerFormatExit(record, stream);
       break;
     case CL_FUNCTION_clRetainCommandQueue:
-      clRetainCommandQueueOnExit(data, start, end, collector);
+      clRetainCommandQueueFormatExit(record, stream);
       break;
     case CL_FUNCTION_clRetainContext:
-      clRetainContextOnExit(data, start, end, collector);
+      clRetainContextFormatExit(record, stream);
       break;
     case CL_FUNCTION_clRetainDevice:
-      clRetainDeviceOnExit(data, start, end, collector);
+      clRetainDeviceFormatExit(record, stream);
       break;
     case CL_FUNCTION_clRetainEvent:
-      clRetainEventOnExit(data, start, end, collector);
+      clRetainEventFormatExit(record, stream);
       break;
     case CL_FUNCTION_clRetainKernel:
-      clRetainKernelOnExit(data, start, end, collector);
+      clRetainKernelFormatExit(record, stream);
       break;
     case CL_FUNCTION_clRetainMemObject:
-      clRetainMemObjectOnExit(data, start, end, collector);
+      clRetainMemObjectFormatExit(record, stream);
       break;
     case CL_FUNCTION_clRetainProgram:
-      clRetainProgramOnExit(data, start, end, collector);
+      clRetainProgramFormatExit(record, stream);
       break;
     case CL_FUNCTION_clRetainSampler:
-      clRetainSamplerOnExit(data, start, end, collector);
+      clRetainSamplerFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSVMAlloc:
-      clSVMAllocOnExit(data, start, end, collector);
+      clSVMAllocFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSVMFree:
-      clSVMFreeOnExit(data, start, end, collector);
+      clSVMFreeFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSetCommandQueueProperty:
-      clSetCommandQueuePropertyOnExit(data, start, end, collector);
+      clSetCommandQueuePropertyFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSetDefaultDeviceCommandQueue:
-      clSetDefaultDeviceCommandQueueOnExit(data, start, end, collector);
+      clSetDefaultDeviceCommandQueueFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSetEventCallback:
-      clSetEventCallbackOnExit(data, start, end, collector);
+      clSetEventCallbackFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSetKernelArg:
-      clSetKernelArgOnExit(data, start, end, collector);
+      clSetKernelArgFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSetKernelArgSVMPointer:
-      clSetKernelArgSVMPointerOnExit(data, start, end, collector);
+      clSetKernelArgSVMPointerFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSetKernelExecInfo:
-      clSetKernelExecInfoOnExit(data, start, end, collector);
+      clSetKernelExecInfoFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSetMemObjectDestructorCallback:
-      clSetMemObjectDestructorCallbackOnExit(data, start, end, collector);
+      clSetMemObjectDestructorCallbackFormatExit(record, stream);
       break;
     case CL_FUNCTION_clSetUserEventStatus:
-      clSetUserEventStatusOnExit(data, start, end, collector);
+      clSetUserEventStatusFormatExit(record, stream);
       break;
     case CL_FUNCTION_clUnloadCompiler:
-      clUnloadCompilerOnExit(data, start, end, collector);
+      clUnloadCompilerFormatExit(record, stream);
       break;
     case CL_FUNCTION_clUnloadPlatformCompiler:
-      clUnloadPlatformCompilerOnExit(data, start, end, collector);
+      clUnloadPlatformCompilerFormatExit(record, stream);
       break;
     case CL_FUNCTION_clWaitForEvents:
-      clWaitForEventsOnExit(data, start, end, collector);
+      clWaitForEventsFormatExit(record, stream);
+      break;
+    default:
+      break;
+  }
+}
+
+static const char* GetFunctionName(cl_function_id function) {
+  switch (function) {
+    case CL_FUNCTION_clBuildProgram:
+      return "clBuildProgram";
+    case CL_FUNCTION_clCloneKernel:
+      return "clCloneKernel";
+    case CL_FUNCTION_clCompileProgram:
+      return "clCompileProgram";
+    case CL_FUNCTION_clCreateBuffer:
+      return "clCreateBuffer";
+    case CL_FUNCTION_clCreateCommandQueue:
+      return "clCreateCommandQueue";
+    case CL_FUNCTION_clCreateCommandQueueWithProperties:
+      return "clCreateCommandQueueWithProperties";
+    case CL_FUNCTION_clCreateContext:
+      return "clCreateContext";
+    case CL_FUNCTION_clCreateContextFromType:
+      return "clCreateContextFromType";
+    case CL_FUNCTION_clCreateFromGLBuffer:
+      return "clCreateFromGLBuffer";
+    case CL_FUNCTION_clCreateFromGLRenderbuffer:
+      return "clCreateFromGLRenderbuffer";
+    case CL_FUNCTION_clCreateFromGLTexture:
+      return "clCreateFromGLTexture";
+    case CL_FUNCTION_clCreateFromGLTexture2D:
+      return "clCreateFromGLTexture2D";
+    case CL_FUNCTION_clCreateFromGLTexture3D:
+      return "clCreateFromGLTexture3D";
+    case CL_FUNCTION_clCreateImage:
+      return "clCreateImage";
+    case CL_FUNCTION_clCreateImage2D:
+      return "clCreateImage2D";
+    case CL_FUNCTION_clCreateImage3D:
+      return "clCreateImage3D";
+    case CL_FUNCTION_clCreateKernel:
+      return "clCreateKernel";
+    case CL_FUNCTION_clCreateKernelsInProgram:
+      return "clCreateKernelsInProgram";
+    case CL_FUNCTION_clCreatePipe:
+      return "clCreatePipe";
+    case CL_FUNCTION_clCreateProgramWithBinary:
+      return "clCreateProgramWithBinary";
+    case CL_FUNCTION_clCreateProgramWithBuiltInKernels:
+      return "clCreateProgramWithBuiltInKernels";
+    case CL_FUNCTION_clCreateProgramWithIL:
+      return "clCreateProgramWithIL";
+    case CL_FUNCTION_clCreateProgramWithSource:
+      return "clCreateProgramWithSource";
+    case CL_FUNCTION_clCreateSampler:
+      return "clCreateSampler";
+    case CL_FUNCTION_clCreateSamplerWithProperties:
+      return "clCreateSamplerWithProperties";
+    case CL_FUNCTION_clCreateSubBuffer:
+      return "clCreateSubBuffer";
+    case CL_FUNCTION_clCreateSubDevices:
+      return "clCreateSubDevices";
+    case CL_FUNCTION_clCreateUserEvent:
+      return "clCreateUserEvent";
+    case CL_FUNCTION_clEnqueueAcquireGLObjects:
+      return "clEnqueueAcquireGLObjects";
+    case CL_FUNCTION_clEnqueueBarrier:
+      return "clEnqueueBarrier";
+    case CL_FUNCTION_clEnqueueBarrierWithWaitList:
+      return "clEnqueueBarrierWithWaitList";
+    case CL_FUNCTION_clEnqueueCopyBuffer:
+      return "clEnqueueCopyBuffer";
+    case CL_FUNCTION_clEnqueueCopyBufferRect:
+      return "clEnqueueCopyBufferRect";
+    case CL_FUNCTION_clEnqueueCopyBufferToImage:
+      return "clEnqueueCopyBufferToImage";
+    case CL_FUNCTION_clEnqueueCopyImage:
+      return "clEnqueueCopyImage";
+    case CL_FUNCTION_clEnqueueCopyImageToBuffer:
+      return "clEnqueueCopyImageToBuffer";
+    case CL_FUNCTION_clEnqueueFillBuffer:
+      return "clEnqueueFillBuffer";
+    case CL_FUNCTION_clEnqueueFillImage:
+      return "clEnqueueFillImage";
+    case CL_FUNCTION_clEnqueueMapBuffer:
+      return "clEnqueueMapBuffer";
+    case CL_FUNCTION_clEnqueueMapImage:
+      return "clEnqueueMapImage";
+    case CL_FUNCTION_clEnqueueMarker:
+      return "clEnqueueMarker";
+    case CL_FUNCTION_clEnqueueMarkerWithWaitList:
+      return "clEnqueueMarkerWithWaitList";
+    case CL_FUNCTION_clEnqueueMigrateMemObjects:
+      return "clEnqueueMigrateMemObjects";
+    case CL_FUNCTION_clEnqueueNDRangeKernel:
+      return "clEnqueueNDRangeKernel";
+    case CL_FUNCTION_clEnqueueNativeKernel:
+      return "clEnqueueNativeKernel";
+    case CL_FUNCTION_clEnqueueReadBuffer:
+      return "clEnqueueReadBuffer";
+    case CL_FUNCTION_clEnqueueReadBufferRect:
+      return "clEnqueueReadBufferRect";
+    case CL_FUNCTION_clEnqueueReadImage:
+      return "clEnqueueReadImage";
+    case CL_FUNCTION_clEnqueueReleaseGLObjects:
+      return "clEnqueueReleaseGLObjects";
+    case CL_FUNCTION_clEnqueueSVMFree:
+      return "clEnqueueSVMFree";
+    case CL_FUNCTION_clEnqueueSVMMap:
+      return "clEnqueueSVMMap";
+    case CL_FUNCTION_clEnqueueSVMMemFill:
+      return "clEnqueueSVMMemFill";
+    case CL_FUNCTION_clEnqueueSVMMemcpy:
+      return "clEnqueueSVMMemcpy";
+    case CL_FUNCTION_clEnqueueSVMMigrateMem:
+      return "clEnqueueSVMMigrateMem";
+    case CL_FUNCTION_clEnqueueSVMUnmap:
+      return "clEnqueueSVMUnmap";
+    case CL_FUNCTION_clEnqueueTask:
+      return "clEnqueueTask";
+    case CL_FUNCTION_clEnqueueUnmapMemObject:
+      return "clEnqueueUnmapMemObject";
+    case CL_FUNCTION_clEnqueueWaitForEvents:
+      return "clEnqueueWaitForEvents";
+    case CL_FUNCTION_clEnqueueWriteBuffer:
+      return "clEnqueueWriteBuffer";
+    case CL_FUNCTION_clEnqueueWriteBufferRect:
+      return "clEnqueueWriteBufferRect";
+    case CL_FUNCTION_clEnqueueWriteImage:
+      return "clEnqueueWriteImage";
+    case CL_FUNCTION_clFinish:
+      return "clFinish";
+    case CL_FUNCTION_clFlush:
+      return "clFlush";
+    case CL_FUNCTION_clGetCommandQueueInfo:
+      return "clGetCommandQueueInfo";
+    case CL_FUNCTION_clGetContextInfo:
+      return "clGetContextInfo";
+    case CL_FUNCTION_clGetDeviceAndHostTimer:
+      return "clGetDeviceAndHostTimer";
+    case CL_FUNCTION_clGetDeviceIDs:
+      return "clGetDeviceIDs";
+    case CL_FUNCTION_clGetDeviceInfo:
+      return "clGetDeviceInfo";
+    case CL_FUNCTION_clGetEventInfo:
+      return "clGetEventInfo";
+    case CL_FUNCTION_clGetEventProfilingInfo:
+      return "clGetEventProfilingInfo";
+    case CL_FUNCTION_clGetExtensionFunctionAddress:
+      return "clGetExtensionFunctionAddress";
+    case CL_FUNCTION_clGetExtensionFunctionAddressForPlatform:
+      return "clGetExtensionFunctionAddressForPlatform";
+    case CL_FUNCTION_clGetGLObjectInfo:
+      return "clGetGLObjectInfo";
+    case CL_FUNCTION_clGetGLTextureInfo:
+      return "clGetGLTextureInfo";
+    case CL_FUNCTION_clGetHostTimer:
+      return "clGetHostTimer";
+    case CL_FUNCTION_clGetImageInfo:
+      return "clGetImageInfo";
+    case CL_FUNCTION_clGetKernelArgInfo:
+      return "clGetKernelArgInfo";
+    case CL_FUNCTION_clGetKernelInfo:
+      return "clGetKernelInfo";
+    case CL_FUNCTION_clGetKernelSubGroupInfo:
+      return "clGetKernelSubGroupInfo";
+    case CL_FUNCTION_clGetKernelWorkGroupInfo:
+      return "clGetKernelWorkGroupInfo";
+    case CL_FUNCTION_clGetMemObjectInfo:
+      return "clGetMemObjectInfo";
+    case CL_FUNCTION_clGetPipeInfo:
+      return "clGetPipeInfo";
+    case CL_FUNCTION_clGetPlatformIDs:
+      return "clGetPlatformIDs";
+    case CL_FUNCTION_clGetPlatformInfo:
+      return "clGetPlatformInfo";
+    case CL_FUNCTION_clGetProgramBuildInfo:
+      return "clGetProgramBuildInfo";
+    case CL_FUNCTION_clGetProgramInfo:
+      return "clGetProgramInfo";
+    case CL_FUNCTION_clGetSamplerInfo:
+      return "clGetSamplerInfo";
+    case CL_FUNCTION_clGetSupportedImageFormats:
+      return "clGetSupportedImageFormats";
+    case CL_FUNCTION_clLinkProgram:
+      return "clLinkProgram";
+    case CL_FUNCTION_clReleaseCommandQueue:
+      return "clReleaseCommandQueue";
+    case CL_FUNCTION_clReleaseContext:
+      return "clReleaseContext";
+    case CL_FUNCTION_clReleaseDevice:
+      return "clReleaseDevice";
+    case CL_FUNCTION_clReleaseEvent:
+      return "clReleaseEvent";
+    case CL_FUNCTION_clReleaseKernel:
+      return "clReleaseKernel";
+    case CL_FUNCTION_clReleaseMemObject:
+      return "clReleaseMemObject";
+    case CL_FUNCTION_clReleaseProgram:
+      return "clReleaseProgram";
+    case CL_FUNCTION_clReleaseSampler:
+      return "clReleaseSampler";
+    case CL_FUNCTION_clRetainCommandQueue:
+      return "clRetainCommandQueue";
+    case CL_FUNCTION_clRetainContext:
+      return "clRetainContext";
+    case CL_FUNCTION_clRetainDevice:
+      return "clRetainDevice";
+    case CL_FUNCTION_clRetainEvent:
+      return "clRetainEvent";
+    case CL_FUNCTION_clRetainKernel:
+      return "clRetainKernel";
+    case CL_FUNCTION_clRetainMemObject:
+      return "clRetainMemObject";
+    case CL_FUNCTION_clRetainProgram:
+      return "clRetainProgram";
+    case CL_FUNCTION_clRetainSampler:
+      return "clRetainSampler";
+    case CL_FUNCTION_clSVMAlloc:
+      return "clSVMAlloc";
+    case CL_FUNCTION_clSVMFree:
+      return "clSVMFree";
+    case CL_FUNCTION_clSetCommandQueueProperty:
+      return "clSetCommandQueueProperty";
+    case CL_FUNCTION_clSetDefaultDeviceCommandQueue:
+      return "clSetDefaultDeviceCommandQueue";
+    case CL_FUNCTION_clSetEventCallback:
+      return "clSetEventCallback";
+    case CL_FUNCTION_clSetKernelArg:
+      return "clSetKernelArg";
+    case CL_FUNCTION_clSetKernelArgSVMPointer:
+      return "clSetKernelArgSVMPointer";
+    case CL_FUNCTION_clSetKernelExecInfo:
+      return "clSetKernelExecInfo";
+    case CL_FUNCTION_clSetMemObjectDestructorCallback:
+      return "clSetMemObjectDestructorCallback";
+    case CL_FUNCTION_clSetUserEventStatus:
+      return "clSetUserEventStatus";
+    case CL_FUNCTION_clUnloadCompiler:
+      return "clUnloadCompiler";
+    case CL_FUNCTION_clUnloadPlatformCompiler:
+      return "clUnloadPlatformCompiler";
+    case CL_FUNCTION_clWaitForEvents:
+      return "clWaitForEvents";
+    default:
       break;
+  }
+  return nullptr;
+}
+
+// API subsets the function belongs to, see API_SUBSET_*
+static uint32_t GetFunctionSubsets(cl_function_id function) {
+  switch (function) {
+    case CL_FUNCTION_clFinish:
+    case CL_FUNCTION_clWaitForEvents:
+      return API_SUBSET_WAIT;
     default:
       break;
   }
+  return 0;
 }
 
-#endif // PTI_TOOLS_CL_TRACER_CL_API_CALLBACKS_H_
\ No newline at end of file
+#endif // PTI_TOOLS_CL_TRACER_CL_API_CALLBACKS_H_
@@ -7,23 +7,38 @@
 #ifndef PTI_TOOLS_CL_TRACER_CL_API_COLLECTOR_H_
 #define PTI_TOOLS_CL_TRACER_CL_API_COLLECTOR_H_
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <mutex>
 #include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "api_filter.h"
 #include "cl_api_tracer.h"
+#include "cl_call_record.h"
 #include "cl_utils.h"
 #include "correlator.h"
+#include "latency_histogram.h"
+#include "logger.h"
+#include "thread_identity.h"
 #include "trace_guard.h"
 
+#define CL_CALL_BUFFER_SIZE    1048576
+#define CL_CALL_FLUSH_INTERVAL 10 // ms
+
 struct ClFunction {
   uint64_t total_time;
   uint64_t min_time;
   uint64_t max_time;
   uint64_t call_count;
+  LatencyHistogram time_histogram;
 
   bool operator>(const ClFunction& r) const {
     if (total_time != r.total_time) {
@@ -42,6 +57,16 @@ struct ClFunction {
 
 using ClFunctionInfoMap = std::map<std::string, ClFunction>;
 
+// Function names are string literals, so per-thread statistics are keyed
+// by pointer and merged by name only at report time
+struct ClThreadFunctionInfo {
+  std::mutex lock;
+  std::unordered_map<const char*, ClFunction> function_map;
+};
+
+using ClThreadFunctionInfoMap = std::map<
+    std::thread::id, ClThreadFunctionInfo*>;
+
 typedef void (*OnClFunctionFinishCallback)(
     void* data, uint64_t id, const std::string& name,
     uint64_t started, uint64_t ended);
@@ -54,6 +79,14 @@ static void OnEnterFunction(
 static void OnExitFunction(
     cl_function_id function, cl_callback_data* data,
     uint64_t start, uint64_t end, ClApiCollector* collector);
+static const char* GetFunctionName(cl_function_id function);
+static uint32_t GetFunctionSubsets(cl_function_id function);
+static void FormatEnterFunction(
+    cl_function_id function, ClCallRecordReader& record,
+    std::ostream& stream);
+static void FormatExitFunction(
+    cl_function_id function, ClCallRecordReader& record,
+    std::ostream& stream);
 
 class ClApiCollector {
  public: // User Interface
@@ -90,16 +123,74 @@ class ClApiCollector {
     if (tracer_ != nullptr) {
       delete tracer_;
     }
+
+    StopLogging();
+    for (LogBuffer* buffer : record_buffer_list_) {
+      delete buffer;
+    }
+
+    for (auto& value : thread_info_map_) {
+      delete value.second;
+    }
   }
 
   void DisableTracing() {
     PTI_ASSERT(tracer_ != nullptr);
-    bool disabled = tracer_->Disable();
-    PTI_ASSERT(disabled);
+    if (!paused_.exchange(true)) {
+      bool disabled = tracer_->Disable();
+      PTI_ASSERT(disabled);
+    }
+    StopLogging();
   }
 
-  const ClFunctionInfoMap& GetFunctionInfoMap() const {
-    return function_info_map_;
+  // Pauses and resumes tracing of API calls, e.g. outside the capture
+  // window, collected statistics and call log are kept
+  void SetTracingEnabled(bool enabled) {
+    PTI_ASSERT(tracer_ != nullptr);
+    if (paused_.exchange(!enabled) == !enabled) {
+      return;
+    }
+    bool done = enabled ? tracer_->Enable() : tracer_->Disable();
+    PTI_ASSERT(done);
+  }
+
+  // Switches call logging off and back on while tracing goes on, e.g. to
+  // keep the tool overhead down, no effect if call logging is not enabled
+  void SetCallLogging(bool enabled) {
+    call_logging_.store(
+        enabled && options_.call_tracing, std::memory_order_relaxed);
+  }
+
+  ClFunctionInfoMap GetFunctionInfoMap() const {
+    ClFunctionInfoMap function_info_map;
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    for (auto& thread_info : thread_info_map_) {
+      ClThreadFunctionInfo* info = thread_info.second;
+      PTI_ASSERT(info != nullptr);
+
+      const std::lock_guard<std::mutex> thread_lock(info->lock);
+      for (auto& value : info->function_map) {
+        const ClFunction& function = value.second;
+        auto it = function_info_map.find(value.first);
+        if (it == function_info_map.end()) {
+          function_info_map[value.first] = function;
+        } else {
+          ClFunction& total = it->second;
+          total.total_time += function.total_time;
+          if (function.min_time < total.min_time) {
+            total.min_time = function.min_time;
+          }
+          if (function.max_time > total.max_time) {
+            total.max_time = function.max_time;
+          }
+          total.call_count += function.call_count;
+          total.time_histogram.Merge(function.time_histogram);
+        }
+      }
+    }
+
+    return function_info_map;
   }
 
   uint64_t GetKernelId() const {
@@ -115,18 +206,50 @@ class ClApiCollector {
     return options_.need_pid;
   }
 
+  // Text goes through the same per-thread buffer as call records while
+  // call logging is active, so the order of one thread's output is kept
   void Log(const std::string& text) {
-    PTI_ASSERT(correlator_ != nullptr);
-    correlator_->Log(text);
+    if (logging_) {
+      ClCallRecordWriter record(text);
+      Log(record);
+    } else {
+      PTI_ASSERT(correlator_ != nullptr);
+      correlator_->Log(text);
+    }
+  }
+
+  // Records are formatted into text later on the logging thread, the
+  // ones that come after the thread is stopped are formatted in place
+  void Log(ClCallRecordWriter& record) {
+    const char* data = record.GetData();
+    size_t size = record.GetSize();
+
+    if (!logging_) {
+      std::stringstream stream;
+      ClCallRecordReader reader(data, size);
+      FormatRecord(reader, ThreadIdentity::GetPid(), stream);
+      PTI_ASSERT(correlator_ != nullptr);
+      correlator_->Log(stream.str());
+      return;
+    }
+
+    LogBuffer* buffer = GetThreadRecordBuffer();
+    PTI_ASSERT(buffer != nullptr);
+    PTI_ASSERT(size <= buffer->GetCapacity());
+    while (!buffer->Push(data, size)) {
+      logging_wakeup_.notify_one();
+      std::this_thread::yield();
+    }
   }
 
   ClApiCollector(const ClApiCollector& copy) = delete;
   ClApiCollector& operator=(const ClApiCollector& copy) = delete;
 
   void PrintFunctionsTable() const {
+    ClFunctionInfoMap function_info_map = GetFunctionInfoMap();
     std::set< std::pair<std::string, ClFunction>,
               utils::Comparator > sorted_list(
-        function_info_map_.begin(), function_info_map_.end());
+        function_info_map.begin(), function_info_map.end());
 
     uint64_t total_duration = 0;
     size_t max_name_length = kFunctionLength;
@@ -148,7 +271,11 @@ class ClApiCollector {
       std::setw(kPercentLength) << "Time (%)" << "," <<
       std::setw(kTimeLength) << "Average (ns)" << "," <<
       std::setw(kTimeLength) << "Min (ns)" << "," <<
-      std::setw(kTimeLength) << "Max (ns)" << std::endl;
+      std::setw(kTimeLength) << "Max (ns)" << "," <<
+      std::setw(kTimeLength) << "P50 (ns)" << "," <<
+      std::setw(kTimeLength) << "P90 (ns)" << "," <<
+      std::setw(kTimeLength) << "P99 (ns)" << "," <<
+      std::setw(kTimeLength) << "P99.9 (ns)" << std::endl;
 
     for (auto& value : sorted_list) {
       const std::string& function = value.first;
@@ -157,6 +284,7 @@ class ClApiCollector {
       uint64_t avg_duration = duration / call_count;
       uint64_t min_duration = value.second.min_time;
       uint64_t max_duration = value.second.max_time;
+      const LatencyHistogram& histogram = value.second.time_histogram;
       float percent_duration = 100.0f * duration / total_duration;
       stream << std::setw(max_name_length) << function << "," <<
         std::setw(kCallsLength) << call_count << "," <<
@@ -165,7 +293,16 @@ class ClApiCollector {
           std::fixed << percent_duration << "," <<
         std::setw(kTimeLength) << avg_duration << "," <<
         std::setw(kTimeLength) << min_duration << "," <<
-        std::setw(kTimeLength) << max_duration << std::endl;
+        std::setw(kTimeLength) << max_duration << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(50.0, min_duration, max_duration) << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(90.0, min_duration, max_duration) << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(99.0, min_duration, max_duration) << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(99.9, min_duration, max_duration) <<
+          std::endl;
     }
 
     PTI_ASSERT(correlator_ != nullptr);
@@ -182,7 +319,9 @@ class ClApiCollector {
       : correlator_(correlator),
         options_(options),
         callback_(callback),
-        callback_data_(callback_data) {
+        callback_data_(callback_data),
+        collector_id_(GetNextCollectorId()),
+        call_logging_(options.call_tracing) {
     PTI_ASSERT(correlator_ != nullptr);
     device_type_ = utils::cl::GetDeviceType(device);
     PTI_ASSERT(
@@ -190,30 +329,171 @@ class ClApiCollector {
         device_type_ == CL_DEVICE_TYPE_GPU);
   }
 
+  bool IsCallLogging() const {
+    return call_logging_.load(std::memory_order_relaxed);
+  }
+
   void EnableTracing(ClApiTracer* tracer) {
     PTI_ASSERT(tracer != nullptr);
     tracer_ = tracer;
 
+    // Filtered out functions are not traced by the runtime at all
+    ApiFilter filter(
+        options_.include_api, options_.exclude_api, options_.api_subsets);
     for (int id = 0; id < CL_FUNCTION_COUNT; ++id) {
-      bool set = tracer_->SetTracingFunction(static_cast<cl_function_id>(id));
+      cl_function_id function = static_cast<cl_function_id>(id);
+      const char* name = GetFunctionName(function);
+      if (name == nullptr) {
+        if (options_.api_subsets != 0) {
+          continue;
+        }
+      } else if (!filter.IsEnabled(name, GetFunctionSubsets(function))) {
+        continue;
+      }
+      bool set = tracer_->SetTracingFunction(function);
       PTI_ASSERT(set);
     }
 
+    if (options_.call_tracing) {
+      logging_ = true;
+      logging_thread_ = std::thread(&ClApiCollector::ProcessRecords, this);
+    }
+
     bool enabled = tracer_->Enable();
     PTI_ASSERT(enabled);
   }
 
+  void StopLogging() {
+    if (!logging_thread_.joinable()) {
+      return;
+    }
+
+    {
+      const std::lock_guard<std::mutex> lock(logging_lock_);
+      logging_stop_ = true;
+    }
+    logging_wakeup_.notify_one();
+    logging_thread_.join();
+    logging_ = false;
+  }
+
+  LogBuffer* GetThreadRecordBuffer() {
+    thread_local std::unordered_map<uint64_t, LogBuffer*> buffer_cache;
+    auto cached = buffer_cache.find(collector_id_);
+    if (cached != buffer_cache.end()) {
+      return cached->second;
+    }
+
+    LogBuffer* buffer = new LogBuffer(CL_CALL_BUFFER_SIZE);
+    PTI_ASSERT(buffer != nullptr);
+    {
+      const std::lock_guard<std::mutex> lock(logging_lock_);
+      record_buffer_list_.push_back(buffer);
+    }
+
+    buffer_cache[collector_id_] = buffer;
+    return buffer;
+  }
+
+  // Logging thread: wakes up periodically or when some thread runs out
+  // of buffer space, formats all the records and logs them at once
+  void ProcessRecords() {
+    std::vector<LogBuffer*> buffer_list;
+    std::vector<char> data;
+    std::stringstream stream;
+    uint32_t pid = ThreadIdentity::GetPid();
+
+    while (true) {
+      bool stop = false;
+      {
+        std::unique_lock<std::mutex> lock(logging_lock_);
+        logging_wakeup_.wait_for(
+            lock, std::chrono::milliseconds(CL_CALL_FLUSH_INTERVAL),
+            [this]{ return logging_stop_; });
+        stop = logging_stop_;
+        buffer_list = record_buffer_list_;
+      }
+
+      stream.str(std::string());
+      for (LogBuffer* buffer : buffer_list) {
+        data.clear();
+        buffer->Pop(data);
+
+        size_t offset = 0;
+        while (offset < data.size()) {
+          ClCallRecordReader record(
+              data.data() + offset, data.size() - offset);
+          FormatRecord(record, pid, stream);
+          offset += record.GetSize();
+        }
+      }
+
+      std::string text = stream.str();
+      if (!text.empty()) {
+        PTI_ASSERT(correlator_ != nullptr);
+        correlator_->Log(text);
+      }
+
+      if (stop) {
+        break;
+      }
+    }
+  }
+
+  void FormatRecord(
+      ClCallRecordReader& record, uint32_t pid, std::ostream& stream) const {
+    if (record.GetFunction() == kClCallRecordText) {
+      const char* text = record.GetString();
+      PTI_ASSERT(text != nullptr);
+      stream << text;
+      return;
+    }
+
+    bool enter = (record.GetSite() == CL_CALLBACK_SITE_ENTER);
+    if (enter) {
+      stream << ">>>> [" << record.GetStart() << "] ";
+    } else {
+      stream << "<<<< [" << record.GetEnd() << "] ";
+    }
+    if (NeedPid()) {
+      stream << "<PID:" << pid << "> ";
+    }
+    if (NeedTid()) {
+      stream << "<TID:" << record.GetTid() << "> ";
+    }
+    stream << record.GetName();
+
+    cl_function_id function = static_cast<cl_function_id>(
+        record.GetFunction());
+    if (enter) {
+      stream << ":";
+      FormatEnterFunction(function, record, stream);
+    } else {
+      FormatExitFunction(function, record, stream);
+    }
+    stream << std::endl;
+  }
+
   uint64_t GetTimestamp() const {
     PTI_ASSERT(correlator_ != nullptr);
     return correlator_->GetTimestamp();
   }
 
-  void AddFunctionTime(const std::string& name, uint64_t time) {
-    const std::lock_guard<std::mutex> lock(lock_);
-    if (function_info_map_.count(name) == 0) {
-      function_info_map_[name] = {time, time, time, 1};
+  // Each thread accumulates into its own buffer, so the lock taken here
+  // is contended only by a concurrent report
+  void AddFunctionTime(const char* name, uint64_t time) {
+    PTI_ASSERT(name != nullptr);
+    ClThreadFunctionInfo* info = GetThreadFunctionInfo();
+    PTI_ASSERT(info != nullptr);
+
+    const std::lock_guard<std::mutex> lock(info->lock);
+    auto it = info->function_map.find(name);
+    if (it == info->function_map.end()) {
+      ClFunction& function = info->function_map[name];
+      function = ClFunction{time, time, time, 1, {}};
+      function.time_histogram.Add(time);
     } else {
-      ClFunction& function = function_info_map_[name];
+      ClFunction& function = it->second;
       function.total_time += time;
       if (time < function.min_time) {
         function.min_time = time;
@@ -222,7 +502,41 @@ class ClApiCollector {
         function.max_time = time;
       }
       ++function.call_count;
+      function.time_histogram.Add(time);
+    }
+  }
+
+  // Collector IDs are never reused, so entries left by destroyed
+  // collectors are never hit again
+  ClThreadFunctionInfo* GetThreadFunctionInfo() {
+    thread_local std::unordered_map<uint64_t, ClThreadFunctionInfo*>
+      info_cache;
+    auto cached = info_cache.find(collector_id_);
+    if (cached != info_cache.end()) {
+      return cached->second;
+    }
+
+    ClThreadFunctionInfo* info = nullptr;
+    std::thread::id thread_id = std::this_thread::get_id();
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      auto it = thread_info_map_.find(thread_id);
+      if (it == thread_info_map_.end()) {
+        info = new ClThreadFunctionInfo;
+        PTI_ASSERT(info != nullptr);
+        thread_info_map_[thread_id] = info;
+      } else {
+        info = it->second;
+      }
     }
+
+    info_cache[collector_id_] = info;
+    return info;
+  }
+
+  static uint64_t GetNextCollectorId() {
+    static std::atomic<uint64_t> next_id(1);
+    return next_id.fetch_add(1, std::memory_order_relaxed);
   }
 
  private: // Callbacks
@@ -242,7 +556,7 @@ class ClApiCollector {
           callback_data->correlationData);
       start_time = collector->GetTimestamp();
 
-      if (collector->options_.call_tracing) {
+      if (collector->IsCallLogging()) {
         OnEnterFunction(function, callback_data, start_time, collector);
       }
     } else {
@@ -253,7 +567,7 @@ class ClApiCollector {
       collector->AddFunctionTime(
         callback_data->functionName, end_time - start_time);
 
-      if (collector->options_.call_tracing) {
+      if (collector->IsCallLogging()) {
         OnExitFunction(
             function, callback_data, start_time, end_time, collector);
       }
@@ -320,6 +634,7 @@ class ClApiCollector {
 
  private: // Data
   ClApiTracer* tracer_ = nullptr;
+  std::atomic<bool> paused_{false};
 
   Correlator* correlator_ = nullptr;
   ApiCollectorOptions options_ = {false, false, false};
@@ -328,8 +643,17 @@ class ClApiCollector {
   OnClFunctionFinishCallback callback_ = nullptr;
   void* callback_data_ = nullptr;
 
-  std::mutex lock_;
-  ClFunctionInfoMap function_info_map_;
+  uint64_t collector_id_ = 0;
+  std::atomic<bool> call_logging_{false};
+  ClThreadFunctionInfoMap thread_info_map_;
+  mutable std::mutex lock_;
+
+  std::atomic<bool> logging_{false};
+  std::thread logging_thread_;
+  std::mutex logging_lock_;
+  std::condition_variable logging_wakeup_;
+  std::vector<LogBuffer*> record_buffer_list_;
+  bool logging_stop_ = false;
 
   static const uint32_t kFunctionLength = 10;
   static const uint32_t kCallsLength = 12;
@@ -0,0 +1,218 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_CL_TRACER_CL_CALL_RECORD_H_
+#define PTI_TOOLS_CL_TRACER_CL_CALL_RECORD_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "cl_api_tracer.h"
+#include "pti_assert.h"
+#include "thread_identity.h"
+#include "utils.h"
+
+#define CL_CALL_STRING_SIZE 65536 // Longer strings are truncated
+#define CL_CALL_ARRAY_SIZE  3
+
+// Function ID of a record that carries already formatted text
+const uint32_t kClCallRecordText = CL_FUNCTION_COUNT;
+
+// Call logging record layout: the header is followed by raw argument
+// words, strings take a length word (or UINT64_MAX for nullptr) and
+// the text packed into words without terminating zero
+struct ClCallRecord {
+  uint32_t size; // Whole record in bytes, header included
+  uint32_t function;
+  uint32_t site;
+  uint32_t tid;
+  const char* name; // Function name literal provided by the runtime
+  uint64_t start;
+  uint64_t end;
+};
+
+static_assert(sizeof(ClCallRecord) % sizeof(uint64_t) == 0,
+              "Call record header is not word aligned");
+
+// Builds the record on the calling thread, all records of the thread
+// are built in the same buffer, so no memory is allocated per call
+class ClCallRecordWriter {
+ public:
+  ClCallRecordWriter(
+      cl_function_id function, const cl_callback_data* data,
+      uint64_t start, uint64_t end, bool need_tid)
+      : buffer_(GetThreadBuffer()) {
+    PTI_ASSERT(data != nullptr);
+    header_.function = function;
+    header_.site = data->site;
+    header_.tid = need_tid ? ThreadIdentity::GetTid() : 0;
+    header_.name = data->functionName;
+    header_.start = start;
+    header_.end = end;
+  }
+
+  explicit ClCallRecordWriter(const std::string& text)
+      : buffer_(GetThreadBuffer()) {
+    header_.function = kClCallRecordText;
+    AddString(text.c_str(), text.size());
+  }
+
+  template <typename T>
+  void AddArg(const T& value) {
+    static_assert(sizeof(T) <= sizeof(uint64_t),
+                  "Argument does not fit into a record word");
+    uint64_t word = 0;
+    memcpy(&word, &value, sizeof(T));
+    buffer_.push_back(word);
+  }
+
+  // First count values (at most CL_CALL_ARRAY_SIZE) are stored after
+  // the word with their number, nullptr array is stored as empty one
+  template <typename T>
+  void AddArray(const T* value_list, cl_uint count) {
+    if (value_list == nullptr) {
+      count = 0;
+    } else if (count > CL_CALL_ARRAY_SIZE) {
+      count = CL_CALL_ARRAY_SIZE;
+    }
+    AddArg(count);
+    for (cl_uint i = 0; i < count; ++i) {
+      AddArg(value_list[i]);
+    }
+  }
+
+  void AddString(const char* text) {
+    if (text == nullptr) {
+      buffer_.push_back(UINT64_MAX);
+    } else {
+      AddString(text, strlen(text));
+    }
+  }
+
+  const char* GetData() {
+    header_.size = static_cast<uint32_t>(buffer_.size() * sizeof(uint64_t));
+    memcpy(buffer_.data(), &header_, sizeof(ClCallRecord));
+    return reinterpret_cast<const char*>(buffer_.data());
+  }
+
+  size_t GetSize() const {
+    return buffer_.size() * sizeof(uint64_t);
+  }
+
+  ClCallRecordWriter(const ClCallRecordWriter& copy) = delete;
+  ClCallRecordWriter& operator=(const ClCallRecordWriter& copy) = delete;
+
+ private:
+  // Header words are reserved in front and filled in by GetData
+  static std::vector<uint64_t>& GetThreadBuffer() {
+    thread_local std::vector<uint64_t> buffer;
+    buffer.assign(sizeof(ClCallRecord) / sizeof(uint64_t), 0);
+    return buffer;
+  }
+
+  void AddString(const char* text, size_t size) {
+    if (size > CL_CALL_STRING_SIZE) {
+      size = CL_CALL_STRING_SIZE;
+    }
+    buffer_.push_back(size);
+    size_t offset = buffer_.size();
+    buffer_.resize(offset + (size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    if (size > 0) {
+      memcpy(buffer_.data() + offset, text, size);
+    }
+  }
+
+ private:
+  ClCallRecord header_{};
+  std::vector<uint64_t>& buffer_;
+};
+
+// Reads the record back on the logging thread. Arguments are taken in
+// the order they were added by the writer
+class ClCallRecordReader {
+ public:
+  ClCallRecordReader(const char* data, size_t size) : data_(data) {
+    PTI_ASSERT(data_ != nullptr);
+    PTI_ASSERT(size >= sizeof(ClCallRecord));
+    memcpy(&header_, data_, sizeof(ClCallRecord));
+    PTI_ASSERT(header_.size >= sizeof(ClCallRecord));
+    PTI_ASSERT(header_.size <= size);
+    offset_ = sizeof(ClCallRecord);
+  }
+
+  uint32_t GetSize() const {
+    return header_.size;
+  }
+
+  uint32_t GetFunction() const {
+    return header_.function;
+  }
+
+  uint32_t GetSite() const {
+    return header_.site;
+  }
+
+  uint32_t GetTid() const {
+    return header_.tid;
+  }
+
+  const char* GetName() const {
+    return header_.name;
+  }
+
+  uint64_t GetStart() const {
+    return header_.start;
+  }
+
+  uint64_t GetEnd() const {
+    return header_.end;
+  }
+
+  template <typename T>
+  T GetArg() {
+    PTI_ASSERT(offset_ + sizeof(uint64_t) <= header_.size);
+    T value;
+    memcpy(&value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(uint64_t);
+    return value;
+  }
+
+  // Argument type is taken from the field of the parameter structure
+  template <typename S, typename T>
+  typename std::remove_const<T>::type GetArg(T* S::* field) {
+    PTI_ASSERT(field != nullptr);
+    return GetArg<typename std::remove_const<T>::type>();
+  }
+
+  // Returned pointer is valid until the next call of GetString
+  const char* GetString() {
+    uint64_t size = GetArg<uint64_t>();
+    if (size == UINT64_MAX) {
+      return nullptr;
+    }
+
+    PTI_ASSERT(offset_ + size <= header_.size);
+    text_.assign(data_ + offset_, size);
+    offset_ += (size + sizeof(uint64_t) - 1) / sizeof(uint64_t) *
+      sizeof(uint64_t);
+    return text_.c_str();
+  }
+
+  ClCallRecordReader(const ClCallRecordReader& copy) = delete;
+  ClCallRecordReader& operator=(const ClCallRecordReader& copy) = delete;
+
+ private:
+  const char* data_ = nullptr;
+  ClCallRecord header_{};
+  size_t offset_ = 0;
+  std::string text_;
+};
+
+#endif // PTI_TOOLS_CL_TRACER_CL_CALL_RECORD_H_
@@ -14,6 +14,7 @@
 
 #include "cl_ext_collector.h"
 #include "cl_utils.h"
+#include "thread_identity.h"
 #include "trace_guard.h"
 
 static void* GetFunctionAddress(const char* function_name, cl_device_type device_type) {
@@ -54,10 +55,10 @@ static void* clHostMemAllocINTEL(
     std::stringstream stream;
     stream << ">>>> [" << start << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name << ":";
 
@@ -87,10 +88,10 @@ static void* clHostMemAllocINTEL(
     std::stringstream stream;
     stream << "<<<< [" << end << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name;
     stream << " [" << (end - start) << " ns]";
@@ -132,10 +133,10 @@ static void* clDeviceMemAllocINTEL(
     std::stringstream stream;
     stream << ">>>> [" << start << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name << ":";
 
@@ -167,10 +168,10 @@ static void* clDeviceMemAllocINTEL(
     std::stringstream stream;
     stream << "<<<< [" << end << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name;
     stream << " [" << (end - start) << " ns]";
@@ -212,10 +213,10 @@ static void* clSharedMemAllocINTEL(
     std::stringstream stream;
     stream << ">>>> [" << start << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name << ":";
 
@@ -247,10 +248,10 @@ static void* clSharedMemAllocINTEL(
     std::stringstream stream;
     stream << "<<<< [" << end << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name;
     stream << " [" << (end - start) << " ns]";
@@ -288,10 +289,10 @@ static cl_int clMemFreeINTEL(
     std::stringstream stream;
     stream << ">>>> [" << start << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name << ":";
 
@@ -314,10 +315,10 @@ static cl_int clMemFreeINTEL(
     std::stringstream stream;
     stream << "<<<< [" << end << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name;
     stream << " [" << (end - start) << " ns]";
@@ -356,10 +357,10 @@ static cl_int clGetMemAllocInfoINTEL(
     std::stringstream stream;
     stream << ">>>> [" << start << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name << ":";
 
@@ -388,10 +389,10 @@ static cl_int clGetMemAllocInfoINTEL(
     std::stringstream stream;
     stream << "<<<< [" << end << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name;
     stream << " [" << (end - start) << " ns]";
@@ -427,10 +428,10 @@ static cl_int clSetKernelArgMemPointerINTEL(
     std::stringstream stream;
     stream << ">>>> [" << start << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name << ":";
 
@@ -454,10 +455,10 @@ static cl_int clSetKernelArgMemPointerINTEL(
     std::stringstream stream;
     stream << "<<<< [" << end << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name;
     stream << " [" << (end - start) << " ns]";
@@ -498,10 +499,10 @@ static cl_int clEnqueueMemcpyINTEL(
     std::stringstream stream;
     stream << ">>>> [" << start << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name << ":";
 
@@ -532,10 +533,10 @@ static cl_int clEnqueueMemcpyINTEL(
     std::stringstream stream;
     stream << "<<<< [" << end << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name;
     stream << " [" << (end - start) << " ns]";
@@ -573,10 +574,10 @@ static cl_int clGetDeviceGlobalVariablePointerINTEL(
     std::stringstream stream;
     stream << ">>>> [" << start << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name << ":";
 
@@ -605,10 +606,10 @@ static cl_int clGetDeviceGlobalVariablePointerINTEL(
     std::stringstream stream;
     stream << "<<<< [" << end << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name;
     stream << " [" << (end - start) << " ns]";
@@ -647,10 +648,10 @@ static cl_int clGetKernelSuggestedLocalWorkSizeINTEL(
     std::stringstream stream;
     stream << ">>>> [" << start << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name << ":";
 
@@ -680,10 +681,10 @@ static cl_int clGetKernelSuggestedLocalWorkSizeINTEL(
     std::stringstream stream;
     stream << "<<<< [" << end << "] ";
     if (collector->NeedPid<DEVICE_TYPE>()) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
     }
     if (collector->NeedTid<DEVICE_TYPE>()) {
-      stream << "<TID:" << utils::GetTid() << "> ";
+      stream << "<TID:" << ThreadIdentity::GetTid() << "> ";
     }
     stream << function_name;
     stream << " [" << (end - start) << " ns]";
@@ -30,11 +30,11 @@ void ClExtCollector::AddFunctionTimeGPU(
 }
 
 bool ClExtCollector::IsCallTracingCPU() const {
-  return cpu_collector_->options_.call_tracing;
+  return cpu_collector_->IsCallLogging();
 }
 
 bool ClExtCollector::IsCallTracingGPU() const {
-  return gpu_collector_->options_.call_tracing;
+  return gpu_collector_->IsCallLogging();
 }
 
 bool ClExtCollector::NeedPidCPU() const {
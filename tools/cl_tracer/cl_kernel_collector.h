@@ -8,20 +8,44 @@
 #define PTI_TOOLS_CL_TRACER_CL_KERNEL_COLLECTOR_H_
 
 #include <atomic>
-#include <iomanip>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
-#include <list>
 #include <map>
 #include <mutex>
-#include <set>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cl_api_tracer.h"
 #include "cl_utils.h"
+#include "capture_control.h"
+#include "clock_domain.h"
+#include "completion_queue.h"
 #include "correlator.h"
+#include "dependency_graph.h"
+#include "flat_hash_map.h"
+#include "kernel_interval_store.h"
+#include "kernel_sampler.h"
+#include "kernel_statistics.h"
+#include "overhead.h"
+#include "queue_timing.h"
+#include "record_pool.h"
+#include "spsc_ring.h"
+#include "stack_table.h"
+#include "string_table.h"
 #include "trace_guard.h"
 
+#define CL_INSTANCE_RING_SIZE      4096
+#define CL_INSTANCE_DRAIN_INTERVAL 10 // ms
+#define CL_CLOCK_SYNC_INTERVAL     100000000 // ns
+#define CL_MAX_PENDING_INSTANCES   65536
+#define CL_BACKPRESSURE_TIMEOUT    100 // ms
+#define CL_CALLBACK_TIMEOUT        100 // ms
+
 class ClKernelCollector;
 
 enum ClKernelType {
@@ -36,7 +60,7 @@ struct ClEnqueueData {
 };
 
 struct ClKernelProps {
-  std::string name;
+  uint32_t name_id;
   size_t simd_width;
   size_t bytes_transferred;
   size_t global_size[3];
@@ -45,56 +69,37 @@ struct ClKernelProps {
 
 struct ClKernelInstance {
   cl_event event = nullptr;
+  cl_command_queue queue = nullptr;
+  bool own_event = false; // Created for the tracer, the app has no handle
   ClKernelProps props;
   uint64_t kernel_id = 0;
   cl_ulong host_sync = 0;
   cl_ulong device_sync = 0;
+  uint32_t stack_id = 0; // Host stack of the enqueue, see StackTable
+  // Set by the event callback, negative if the command was terminated
+  cl_int status = CL_COMPLETE;
+  CompletionQueue<ClKernelInstance>* completion_queue = nullptr;
+  ClKernelInstance* next_completed = nullptr;
 };
 
-struct ClKernelInfo {
-  uint64_t total_time;
-  uint64_t min_time;
-  uint64_t max_time;
-  uint64_t call_count;
-
-  bool operator>(const ClKernelInfo& r) const {
-    if (total_time != r.total_time) {
-      return total_time > r.total_time;
-    }
-    return call_count > r.call_count;
-  }
-
-  bool operator!=(const ClKernelInfo& r) const {
-    if (total_time == r.total_time) {
-      return call_count != r.call_count;
-    }
-    return true;
-  }
+// Profiling timestamps of a completed instance, device or host ones
+struct ClKernelTimestamps {
+  uint64_t queued;
+  uint64_t submitted;
+  uint64_t started;
+  uint64_t ended;
 };
 
-using ClKernelInfoMap = std::map<std::string, ClKernelInfo>;
-using ClKernelInstanceList = std::list<ClKernelInstance*>;
+using ClKernelInfo = KernelInfo;
 
-#ifdef PTI_KERNEL_INTERVALS
+using ClKernelInfoMap = KernelInfoMap;
+using ClInstanceSet = std::unordered_set<ClKernelInstance*>;
 
-struct ClDeviceInterval {
-  uint64_t start;
-  uint64_t end;
-  uint32_t sub_device_id;
-};
-
-struct ClKernelInterval {
-  std::string kernel_name;
-  cl_device_id device;
-  std::vector<ClDeviceInterval> device_interval_list;
-};
-
-using ClKernelIntervalList = std::vector<ClKernelInterval>;
-using ClDeviceMap = std::map<
+// Intervals are kept for root devices, in OpenCL host time
+using ClKernelIntervalStore = KernelIntervalStore<cl_device_id>;
+using ClDeviceMap = FlatHashMap<
     cl_device_id, std::vector<cl_device_id> >;
 
-#endif // PTI_KERNEL_INTERVALS
-
 typedef void (*OnClKernelFinishCallback)(
     void* data, void* queue,
     uint64_t id, const std::string& name,
@@ -103,18 +108,38 @@ typedef void (*OnClKernelFinishCallback)(
 
 class ClKernelCollector {
  public: // Interface
+
+  // Non-empty kernel sampling spec (see KernelSampler) makes the collector
+  // trace only a subset of launches of each kernel, memory transfers are
+  // not sampled. If capture control is given, only commands inside the
+  // capture window are traced. Queue timing mode keeps busy and idle time
+  // of each queue and device. Kernel intervals mode keeps the execution
+  // interval of every launch on each sub-device (see KernelIntervalStore).
+  // Dependency graph mode keeps the event dependencies of the commands of
+  // each queue and reports its critical path (see DependencyGraph).
+  // Call stacks mode captures the host stack of each enqueue and keeps
+  // kernel time per launching stack (see StackTable). Grouping selects
+  // the launch config parts the kernel table rows are told by
   static ClKernelCollector* Create(
       cl_device_id device,
       Correlator* correlator,
-      bool verbose,
+      KernelGrouping grouping,
       OnClKernelFinishCallback callback = nullptr,
-      void* callback_data = nullptr) {
+      void* callback_data = nullptr,
+      const std::string& kernel_sampling = std::string(),
+      CaptureControl* capture = nullptr,
+      bool queue_timing = false,
+      bool kernel_intervals = false,
+      bool dependency_graph = false,
+      bool call_stacks = false) {
     PTI_ASSERT(device != nullptr);
     PTI_ASSERT(correlator != nullptr);
     TraceGuard guard;
 
     ClKernelCollector* collector = new ClKernelCollector(
-        device, correlator, verbose, callback, callback_data);
+        device, correlator, grouping, callback, callback_data,
+        kernel_sampling, capture, queue_timing, kernel_intervals,
+        dependency_graph, call_stacks);
     PTI_ASSERT(collector != nullptr);
 
     ClApiTracer* tracer = new ClApiTracer(device, Callback, collector);
@@ -133,103 +158,146 @@ class ClKernelCollector {
   }
 
   ~ClKernelCollector() {
-#ifdef PTI_KERNEL_INTERVALS
-    ReleaseDeviceMap();
-#endif // PTI_KERNEL_INTERVALS
     if (tracer_ != nullptr) {
       delete tracer_;
     }
+
+    {
+      const std::lock_guard<std::mutex> lock(flush_lock_);
+      stop_ = true;
+    }
+    flush_wakeup_.notify_one();
+    processing_thread_.join();
+
+    // Callbacks of the instances that never completed may still come,
+    // so their queue is left alive in this case
+    if (pending_instance_count_.load(std::memory_order_relaxed) == 0) {
+      delete completion_queue_;
+    }
+
+    if (kernel_intervals_enabled_) {
+      ReleaseDeviceMap();
+    }
+  }
+
+  void PrintQueuesTable() const {
+    if (queue_timing_.IsEmpty()) {
+      return;
+    }
+
+    std::stringstream stream;
+    queue_timing_.PrintTables(stream);
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  void PrintDependencyTable() {
+    if (dependency_graph_.IsEmpty()) {
+      return;
+    }
+
+    std::stringstream stream;
+    dependency_graph_.PrintTables(stream);
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  void PrintStacksTable() const {
+    if (stack_table_.IsEmpty()) {
+      return;
+    }
+
+    std::stringstream stream;
+    stack_table_.PrintTables(stream);
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
   }
 
   void DisableTracing() {
     PTI_ASSERT(tracer_ != nullptr);
     bool disabled = tracer_->Disable();
     PTI_ASSERT(disabled);
+    ProcessKernelInstances(true);
+  }
+
+  // Returns once all the completed instances enqueued so far are reported
+  void Flush() {
+    ProcessKernelInstances(true);
   }
 
-  const ClKernelInfoMap& GetKernelInfoMap() const {
-    return kernel_info_map_;
+  // Thins the traced launches at run time, see KernelSampler::SetThrottle
+  void SetKernelThrottle(uint32_t period) {
+    sampler_.SetThrottle(period);
   }
 
-#ifdef PTI_KERNEL_INTERVALS
-  const ClKernelIntervalList& GetKernelIntervalList() const {
-    return kernel_interval_list_;
+  // Statistics of sampled kernels are scaled to all their launches
+  ClKernelInfoMap GetKernelInfoMap() const {
+    return kernel_statistics_.GetInfoMap(sampler_, grouping_, FormatConfig);
+  }
+
+  // Empty unless kernel intervals are enabled, should not be called
+  // while the intervals are still added
+  const ClKernelIntervalStore& GetKernelIntervalStore() const {
+    return kernel_interval_store_;
+  }
+
+  // Moves the intervals collected so far to the end of the given store,
+  // so that they can be processed while the application is still running
+  void TakeKernelIntervals(ClKernelIntervalStore* store) {
+    PTI_ASSERT(store != nullptr);
+    const std::lock_guard<std::mutex> lock(interval_lock_);
+    store->Splice(&kernel_interval_store_);
   }
-#endif // PTI_KERNEL_INTERVALS
 
   ClKernelCollector(const ClKernelCollector& copy) = delete;
   ClKernelCollector& operator=(const ClKernelCollector& copy) = delete;
 
   void PrintKernelsTable() const {
-    std::set< std::pair<std::string, ClKernelInfo>,
-              utils::Comparator > sorted_list(
-        kernel_info_map_.begin(), kernel_info_map_.end());
-
-    uint64_t total_duration = 0;
-    size_t max_name_length = kKernelLength;
-    for (auto& value : sorted_list) {
-      total_duration += value.second.total_time;
-      if (value.first.size() > max_name_length) {
-        max_name_length = value.first.size();
-      }
-    }
-
-    if (total_duration == 0) {
-      return;
-    }
-
     std::stringstream stream;
-    stream << std::setw(max_name_length) << "Kernel" << "," <<
-      std::setw(kCallsLength) << "Calls" << "," <<
-      std::setw(kTimeLength) << "Time (ns)" << "," <<
-      std::setw(kPercentLength) << "Time (%)" << "," <<
-      std::setw(kTimeLength) << "Average (ns)" << "," <<
-      std::setw(kTimeLength) << "Min (ns)" << "," <<
-      std::setw(kTimeLength) << "Max (ns)" << std::endl;
-
-    for (auto& value : sorted_list) {
-      const std::string& function = value.first;
-      uint64_t call_count = value.second.call_count;
-      uint64_t duration = value.second.total_time;
-      uint64_t avg_duration = duration / call_count;
-      uint64_t min_duration = value.second.min_time;
-      uint64_t max_duration = value.second.max_time;
-      float percent_duration = 100.0f * duration / total_duration;
-      stream << std::setw(max_name_length) << function << "," <<
-        std::setw(kCallsLength) << call_count << "," <<
-        std::setw(kTimeLength) << duration << "," <<
-        std::setw(kPercentLength) << std::setprecision(2) <<
-          std::fixed << percent_duration << "," <<
-        std::setw(kTimeLength) << avg_duration << "," <<
-        std::setw(kTimeLength) << min_duration << "," <<
-        std::setw(kTimeLength) << max_duration << std::endl;
+    KernelStatistics::PrintTable(GetKernelInfoMap(), stream);
+    if (stream.tellp() > 0) {
+      PTI_ASSERT(correlator_ != nullptr);
+      correlator_->Log(stream.str());
     }
-
-    PTI_ASSERT(correlator_ != nullptr);
-    correlator_->Log(stream.str());
   }
 
  private: // Implementation Details
   ClKernelCollector(
       cl_device_id device,
       Correlator* correlator,
-      bool verbose,
+      KernelGrouping grouping,
       OnClKernelFinishCallback callback,
-      void* callback_data)
+      void* callback_data,
+      const std::string& kernel_sampling,
+      CaptureControl* capture,
+      bool queue_timing,
+      bool kernel_intervals,
+      bool dependency_graph,
+      bool call_stacks)
       : device_(device),
         correlator_(correlator),
-        verbose_(verbose),
+        grouping_(grouping),
         callback_(callback),
         callback_data_(callback_data),
-        kernel_id_(1) {
+        kernel_id_(1),
+        sampler_(kernel_sampling),
+        capture_(capture),
+        queue_timing_enabled_(queue_timing),
+        kernel_intervals_enabled_(kernel_intervals),
+        instance_ring_group_(CL_INSTANCE_RING_SIZE),
+        completion_queue_(new CompletionQueue<ClKernelInstance>),
+        dependency_graph_enabled_(dependency_graph),
+        dependency_graph_("Queue"),
+        call_stacks_enabled_(call_stacks) {
     PTI_ASSERT(device_ != nullptr);
     PTI_ASSERT(correlator_ != nullptr);
-#ifdef PTI_KERNEL_INTERVALS
-    CreateDeviceMap();
-#endif // PTI_KERNEL_INTERVALS
+    PTI_ASSERT(completion_queue_ != nullptr);
+    if (kernel_intervals_enabled_) {
+      CreateDeviceMap();
+    }
+    processing_thread_ = std::thread(&ClKernelCollector::Process, this);
   }
 
-#ifdef PTI_KERNEL_INTERVALS
   void CreateDeviceMap() {
     cl_device_type type = utils::cl::GetDeviceType(device_);
     PTI_ASSERT(type == CL_DEVICE_TYPE_GPU);
@@ -238,19 +306,18 @@ class ClKernelCollector {
     for (auto device : device_list) {
       std::vector<cl_device_id> sub_device_list =
         utils::cl::CreateSubDeviceList(device);
-      PTI_ASSERT(device_map_.count(device) == 0);
+      PTI_ASSERT(device_map_.Find(device) == nullptr);
       device_map_[device] = sub_device_list;
     }
   }
 
   void ReleaseDeviceMap() {
-    for (auto it : device_map_) {
+    for (auto& it : device_map_) {
       if (!it.second.empty()) {
         utils::cl::ReleaseSubDeviceList(it.second);
       }
     }
   }
-#endif // PTI_KERNEL_INTERVALS
 
   void EnableTracing(ClApiTracer* tracer) {
     PTI_ASSERT(tracer != nullptr);
@@ -311,249 +378,557 @@ class ClKernelCollector {
     PTI_ASSERT(enabled);
   }
 
+  // Only the events of the application are in the wait lists, so the
+  // events made by the tool never resolve a wait
+  void AddDependencyNode(
+      const ClKernelInstance* instance,
+      cl_uint wait_event_count, const cl_event* wait_event_list) {
+    PTI_ASSERT(instance != nullptr);
+    PTI_ASSERT(instance->queue != nullptr);
+    dependency_graph_.AddNode(
+        instance->queue, instance->kernel_id, instance->props.name_id,
+        instance->event,
+        reinterpret_cast<const void* const*>(wait_event_list),
+        (wait_event_list == nullptr) ? 0 : wait_event_count,
+        utils::cl::IsCommandQueueInOrder(instance->queue));
+  }
+
+  // Enqueued instances are passed to the processing thread through the
+  // ring of the calling thread, so that enqueues from different threads
+  // never wait for each other or for the instance processing. Completion
+  // comes from the event callback, which is set only after the push, so
+  // the instance is always taken from the ring before it is processed
   void AddKernelInstance(ClKernelInstance* instance) {
     PTI_ASSERT(instance != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    kernel_instance_list_.push_back(instance);
+    PTI_ASSERT(instance->event != nullptr);
+    PTI_ASSERT(instance->queue != nullptr);
+    cl_command_queue queue = instance->queue;
+    cl_event event = instance->event;
+    instance->completion_queue = completion_queue_;
+    if (call_stacks_enabled_) {
+      instance->stack_id = stack_table_.Capture();
+    }
+
+    uint64_t count = pending_instance_count_.fetch_add(
+        1, std::memory_order_relaxed) + 1;
+    while (!instance_ring_group_.Push(instance)) {
+      flush_wakeup_.notify_one();
+      std::this_thread::yield();
+    }
+
+    cl_int status = clSetEventCallback(
+        event, CL_COMPLETE, OnEventComplete, instance);
+    PTI_ASSERT(status == CL_SUCCESS);
+
+    if (count > pending_instance_limit_.load(std::memory_order_relaxed)) {
+      WaitForPendingInstances(queue);
+    }
   }
 
-  static void ComputeHostTimestamps(
-      const ClKernelInstance* instance,
-      cl_ulong started,
-      cl_ulong ended,
-      uint64_t& host_queued,
-      uint64_t& host_submitted,
-      uint64_t& host_started,
-      uint64_t& host_ended) {
+  // Called by the driver on any of its threads (or right away inside
+  // clSetEventCallback if the command is already done), so the instance
+  // is only passed on to the processing thread
+  static void CL_CALLBACK OnEventComplete(
+      cl_event event, cl_int status, void* user_data) {
+    ClKernelInstance* instance =
+      reinterpret_cast<ClKernelInstance*>(user_data);
     PTI_ASSERT(instance != nullptr);
-    PTI_ASSERT(started < ended);
+    PTI_ASSERT(instance->event == event);
+    PTI_ASSERT(instance->completion_queue != nullptr);
+    instance->status = status;
+    instance->completion_queue->Push(instance);
+  }
+
+  // Each pending instance holds a retained event, so the application that
+  // never waits for its commands is slowed down to the device pace once
+  // there are too many of them: the enqueuing thread flushes its queue and
+  // waits until half of the instances are processed. The wait is bounded,
+  // as commands may depend on host actions (e.g. user events) that come
+  // later, and after a timeout the limit is doubled
+  void WaitForPendingInstances(cl_command_queue queue) {
+    PTI_ASSERT(queue != nullptr);
+    cl_int status = clFlush(queue);
+    PTI_ASSERT(status == CL_SUCCESS);
+
+    uint64_t limit = pending_instance_limit_.load(std::memory_order_relaxed);
+    std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(CL_BACKPRESSURE_TIMEOUT);
+    while (pending_instance_count_.load(std::memory_order_relaxed) >
+           limit / 2) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        pending_instance_limit_.compare_exchange_strong(limit, 2 * limit);
+        break;
+      }
+      ProcessKernelInstances(true);
+      std::this_thread::yield();
+    }
+  }
 
+  // The following helpers are called on the processing thread only
+  void InsertKernelInstance(ClKernelInstance* instance) {
+    PTI_ASSERT(instance != nullptr);
     PTI_ASSERT(instance->event != nullptr);
-    cl_event event = instance->event;
+    PTI_ASSERT(instance->queue != nullptr);
+    bool inserted = outstanding_instance_set_.insert(instance).second;
+    PTI_ASSERT(inserted);
+  }
 
-    cl_ulong queued =
-      utils::cl::GetEventTimestamp(event, CL_PROFILING_COMMAND_QUEUED);
-    PTI_ASSERT(queued > 0);
-    cl_ulong submitted =
-      utils::cl::GetEventTimestamp(event, CL_PROFILING_COMMAND_SUBMIT);
-    PTI_ASSERT(submitted > 0);
+  // Device time for the given host time comes from the clock model,
+  // the device is queried only once per sync interval. With kernel
+  // intervals the host time is taken from the OpenCL host timer instead
+  // of the correlator, so the device is queried on each call then
+  cl_ulong EstimateDeviceTimestamp(cl_ulong* host_time) {
+    PTI_ASSERT(host_time != nullptr);
+    if (!kernel_intervals_enabled_) {
+      const OverheadLockGuard lock(clock_lock_, OVERHEAD_CL_KERNEL);
+      if (clock_domain_.GetSampleCount() > 0 &&
+          *host_time < clock_domain_.GetLastSampleTime() +
+            CL_CLOCK_SYNC_INTERVAL) {
+        return clock_domain_.ToDevice(*host_time);
+      }
+    }
 
-    PTI_ASSERT(instance->device_sync <= queued);
-    uint64_t time_shift = queued - instance->device_sync;
+    cl_ulong host_start = correlator_->GetTimestamp();
+    cl_ulong host_timestamp = 0, device_sync = 0;
+    {
+      OverheadScope overhead(OVERHEAD_CL_KERNEL, OVERHEAD_TIMESTAMP_READ);
+      utils::cl::GetTimestamps(device_, &host_timestamp, &device_sync);
+    }
+    cl_ulong host_end = correlator_->GetTimestamp();
+    PTI_ASSERT(host_start <= host_end);
+    cl_ulong host_sync = host_start + (host_end - host_start) / 2;
+    if (kernel_intervals_enabled_) {
+      host_sync = *host_time = host_timestamp;
+    }
 
-    host_queued = instance->host_sync + time_shift;
-    PTI_ASSERT(queued <= submitted);
-    host_submitted = host_queued + (submitted - queued);
-    PTI_ASSERT(submitted <= started);
-    host_started = host_submitted + (started - submitted);
-    PTI_ASSERT(started <= ended);
-    host_ended = host_started + (ended - started);
+    const OverheadLockGuard lock(clock_lock_, OVERHEAD_CL_KERNEL);
+    if (clock_domain_.GetSampleCount() == 0 ||
+        host_sync >= clock_domain_.GetLastSampleTime() +
+          CL_CLOCK_SYNC_INTERVAL / 2) {
+      clock_domain_.AddSample(host_sync, device_sync);
+    }
+    if (kernel_intervals_enabled_) {
+      return device_sync;
+    }
+    return clock_domain_.ToDevice(*host_time);
   }
 
-  void ProcessKernelInstance(const ClKernelInstance* instance) {
+  // Queued and submitted times are needed only to get host timestamps
+  static void ReadKernelTimestamps(
+      const ClKernelInstance* instance, bool all,
+      ClKernelTimestamps* timestamps) {
     PTI_ASSERT(instance != nullptr);
+    PTI_ASSERT(timestamps != nullptr);
 
     PTI_ASSERT(instance->event != nullptr);
     cl_event event = instance->event;
+    OverheadScope overhead(OVERHEAD_CL_KERNEL, OVERHEAD_TIMESTAMP_READ);
+
+    timestamps->started =
+      utils::cl::GetEventTimestamp(event, CL_PROFILING_COMMAND_START);
+    timestamps->ended =
+      utils::cl::GetEventTimestamp(event, CL_PROFILING_COMMAND_END);
+    PTI_ASSERT(timestamps->started < timestamps->ended);
+
+    if (all) {
+      timestamps->queued =
+        utils::cl::GetEventTimestamp(event, CL_PROFILING_COMMAND_QUEUED);
+      PTI_ASSERT(timestamps->queued > 0);
+      timestamps->submitted =
+        utils::cl::GetEventTimestamp(event, CL_PROFILING_COMMAND_SUBMIT);
+      PTI_ASSERT(timestamps->submitted > 0);
+      PTI_ASSERT(timestamps->queued <= timestamps->submitted);
+      PTI_ASSERT(timestamps->submitted <= timestamps->started);
+    } else {
+      timestamps->queued = timestamps->submitted = timestamps->started;
+    }
+  }
 
-    cl_int event_status = utils::cl::GetEventStatus(event);
-    PTI_ASSERT(event_status == CL_COMPLETE);
+  // Queued time is never placed before the enqueue, as the device time
+  // of the enqueue is estimated
+  static void ShiftHostTimestamps(
+      const ClKernelInstance* instance, ClKernelTimestamps* timestamps) {
+    PTI_ASSERT(instance != nullptr);
+    PTI_ASSERT(timestamps != nullptr);
+
+    uint64_t time_shift = 0;
+    if (timestamps->queued < instance->host_sync) {
+      time_shift = instance->host_sync - timestamps->queued;
+    }
+
+    timestamps->queued += time_shift;
+    timestamps->submitted += time_shift;
+    timestamps->started += time_shift;
+    timestamps->ended += time_shift;
+    PTI_ASSERT(timestamps->queued <= timestamps->submitted);
+    PTI_ASSERT(timestamps->submitted <= timestamps->started);
+    PTI_ASSERT(timestamps->started <= timestamps->ended);
+  }
+
+  // Host timestamps are given if they are needed for the callback,
+  // queue timing or kernel intervals
+  void ProcessKernelInstance(
+      const ClKernelInstance* instance,
+      const ClKernelTimestamps& device_timestamps,
+      const ClKernelTimestamps* host_timestamps) {
+    PTI_ASSERT(instance != nullptr);
 
-    cl_command_queue queue = utils::cl::GetCommandQueue(event);
+    cl_command_queue queue = instance->queue;
     PTI_ASSERT(queue != nullptr);
 
-    cl_ulong started =
-      utils::cl::GetEventTimestamp(event, CL_PROFILING_COMMAND_START);
-    cl_ulong ended =
-      utils::cl::GetEventTimestamp(event, CL_PROFILING_COMMAND_END);
-    cl_ulong time = ended - started;
+    uint64_t time = device_timestamps.ended - device_timestamps.started;
     PTI_ASSERT(time > 0);
 
-    AddKernelInfo(&instance->props, time);
+    kernel_statistics_.Add(GetConfig(instance->props), time);
+    if (dependency_graph_enabled_) {
+      dependency_graph_.AddTime(
+          instance->kernel_id, 0,
+          device_timestamps.started, device_timestamps.ended);
+    }
+    if (call_stacks_enabled_) {
+      stack_table_.AddTime(
+          instance->stack_id, instance->props.name_id, time);
+    }
 
-#ifdef PTI_KERNEL_INTERVALS
-    cl_device_id device = utils::cl::GetDevice(queue);
-    PTI_ASSERT(device != nullptr);
-    AddKernelInterval(instance, device, started, ended);
-#endif // PTI_KERNEL_INTERVALS
+    if (kernel_intervals_enabled_) {
+      cl_device_id device = utils::cl::GetDevice(queue);
+      PTI_ASSERT(device != nullptr);
+      PTI_ASSERT(host_timestamps != nullptr);
+      const std::lock_guard<std::mutex> lock(interval_lock_);
+      AddKernelInterval(
+          instance, device,
+          host_timestamps->started, host_timestamps->ended);
+    }
 
-    if (callback_ != nullptr) {
-      uint64_t host_queued = 0, host_submitted = 0;
-      uint64_t host_started = 0, host_ended = 0;
-      ComputeHostTimestamps(
-          instance,
-          started, ended,
-          host_queued, host_submitted,
-          host_started, host_ended);
+    if (host_timestamps != nullptr) {
+      if (queue_timing_enabled_) {
+        queue_timing_.AddCommand(
+            queue, GetQueueEngine(queue),
+            host_timestamps->submitted,
+            host_timestamps->started,
+            host_timestamps->ended);
+      }
 
-      std::string name = instance->props.name;
-      PTI_ASSERT(!name.empty());
+      if (callback_ != nullptr) {
+        const std::string& name =
+          StringTable::Get(instance->props.name_id);
+        PTI_ASSERT(!name.empty());
 
-      callback_(
-          callback_data_, queue, instance->kernel_id, name,
-          host_queued, host_submitted, host_started, host_ended);
+        callback_(
+            callback_data_, queue, instance->kernel_id, name,
+            host_timestamps->queued, host_timestamps->submitted,
+            host_timestamps->started, host_timestamps->ended);
+      }
     }
 
-    cl_int status = clReleaseEvent(event);
-    PTI_ASSERT(status == CL_SUCCESS);
-
-    delete instance;
   }
 
-  void ProcessKernelInstance(cl_event event) {
-    PTI_ASSERT(event != nullptr);
-    cl_int event_status = utils::cl::GetEventStatus(event);
-    if (event_status != CL_COMPLETE) {
+  // Profiling info of all the completed instances is read in one pass,
+  // then converted to host time at once under a single clock lock, and
+  // only then the instances are processed one by one
+  void ProcessKernelInstanceBatch(
+      const std::vector<ClKernelInstance*>& instance_list) {
+    if (instance_list.empty()) {
       return;
     }
 
-    const std::lock_guard<std::mutex> lock(lock_);
-    for (auto it = kernel_instance_list_.begin();
-         it != kernel_instance_list_.end(); ++it) {
-      ClKernelInstance* instance = *it;
-      PTI_ASSERT(instance != nullptr);
-      PTI_ASSERT(instance->event != nullptr);
-      if (instance->event == event) {
-        ProcessKernelInstance(instance);
-        it = kernel_instance_list_.erase(it);
-        break;
+    bool host_time_needed = (callback_ != nullptr ||
+                             queue_timing_enabled_ ||
+                             kernel_intervals_enabled_);
+
+    size_t count = instance_list.size();
+    device_timestamp_list_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      ReadKernelTimestamps(
+          instance_list[i], host_time_needed, &device_timestamp_list_[i]);
+    }
+
+    if (host_time_needed) {
+      static_assert(sizeof(ClKernelTimestamps) == 4 * sizeof(uint64_t),
+                    "Timestamps are converted as a flat array");
+      host_timestamp_list_.resize(count);
+      {
+        const OverheadLockGuard lock(clock_lock_, OVERHEAD_CL_KERNEL);
+        clock_domain_.ToHost(
+            reinterpret_cast<const uint64_t*>(device_timestamp_list_.data()),
+            reinterpret_cast<uint64_t*>(host_timestamp_list_.data()),
+            4 * count);
+      }
+      for (size_t i = 0; i < count; ++i) {
+        ShiftHostTimestamps(instance_list[i], &host_timestamp_list_[i]);
       }
     }
+
+    for (size_t i = 0; i < count; ++i) {
+      ProcessKernelInstance(
+          instance_list[i], device_timestamp_list_[i],
+          host_time_needed ? &host_timestamp_list_[i] : nullptr);
+    }
+
+    // Events are released once all the instances of the batch are done:
+    // own events are destroyed, application ones lose the tracer reference
+    for (ClKernelInstance* instance : instance_list) {
+      cl_int status = clReleaseEvent(instance->event);
+      PTI_ASSERT(status == CL_SUCCESS);
+      RecordPool<ClKernelInstance>::Destroy(instance);
+    }
+    pending_instance_count_.fetch_sub(count, std::memory_order_relaxed);
   }
 
-  void ProcessKernelInstances() {
-    const std::lock_guard<std::mutex> lock(lock_);
+  // Engine is the device of the queue, OpenCL gives no finer control.
+  // The reference is valid until the engine of a new queue is added
+  const std::string& GetQueueEngine(cl_command_queue queue) {
+    PTI_ASSERT(queue != nullptr);
+    const std::string* found = queue_engine_map_.Find(queue);
+    if (found != nullptr) {
+      return *found;
+    }
 
-    auto it = kernel_instance_list_.begin();
-    while (it != kernel_instance_list_.end()) {
-      ClKernelInstance* instance = *it;
-      PTI_ASSERT(instance != nullptr);
+    cl_device_id device = utils::cl::GetDevice(queue);
+    PTI_ASSERT(device != nullptr);
+    std::stringstream engine;
+    engine << utils::cl::GetDeviceName(device);
+    if (device != device_) {
+      engine << " Sub-Device " << device;
+    }
+    return queue_engine_map_[queue] = engine.str();
+  }
 
-      PTI_ASSERT(instance->event != nullptr);
-      cl_int event_status = utils::cl::GetEventStatus(instance->event);
-      if (event_status == CL_COMPLETE) {
-        ProcessKernelInstance(instance);
-        it = kernel_instance_list_.erase(it);
-      } else {
-        ++it;
+  static bool IsInstanceComplete(const ClKernelInstance* instance) {
+    PTI_ASSERT(instance != nullptr);
+    PTI_ASSERT(instance->event != nullptr);
+    return utils::cl::GetEventStatus(instance->event) == CL_COMPLETE;
+  }
+
+  // Completed instances are taken before the rings are drained: each
+  // instance is pushed to its ring before the event callback is set, so
+  // all the completed ones are in the outstanding set by then. Instances
+  // of terminated commands have no profiling info and are just released
+  void ProcessCompletedInstances() {
+    completion_queue_->Drain([this](ClKernelInstance* instance) {
+      completed_instance_list_.push_back(instance);
+    });
+    instance_ring_group_.Drain([this](ClKernelInstance* instance) {
+      InsertKernelInstance(instance);
+    });
+
+    size_t count = 0;
+    for (ClKernelInstance* instance : completed_instance_list_) {
+      size_t erased = outstanding_instance_set_.erase(instance);
+      PTI_ASSERT(erased == 1);
+      if (instance->status == CL_COMPLETE) {
+        completed_instance_list_[count++] = instance;
+        continue;
       }
+
+      cl_int status = clReleaseEvent(instance->event);
+      PTI_ASSERT(status == CL_SUCCESS);
+      RecordPool<ClKernelInstance>::Destroy(instance);
+      pending_instance_count_.fetch_sub(1, std::memory_order_relaxed);
     }
+    completed_instance_list_.resize(count);
+
+    ProcessKernelInstanceBatch(completed_instance_list_);
+    completed_instance_list_.clear();
   }
 
-  std::string GetVerboseName(
-      const ClKernelProps* props) {
-    PTI_ASSERT(props != nullptr);
-    PTI_ASSERT(!props->name.empty());
+  // Callbacks may come later than the event status is changed, so the
+  // request that needs the results waits (for a bounded time) for the
+  // callbacks of the instances that are already complete. Only this wait
+  // looks at every outstanding instance, and it is short, as completed
+  // instances are processed all the time
+  void WaitForCompletedInstances() {
+    std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(CL_CALLBACK_TIMEOUT);
+    while (true) {
+      ProcessCompletedInstances();
+
+      bool pending = false;
+      for (const ClKernelInstance* instance : outstanding_instance_set_) {
+        if (IsInstanceComplete(instance)) {
+          pending = true;
+          break;
+        }
+      }
 
-    std::stringstream sstream;
-    if (props->simd_width > 0) {
-      sstream << props->name << "[SIMD" << props->simd_width << ", {" <<
-        props->global_size[0] << ", " <<
-        props->global_size[1] << ", " <<
-        props->global_size[2] << "}, {" <<
-        props->local_size[0] << ", " <<
-        props->local_size[1] << ", " <<
-        props->local_size[2] << "}]";
-    } else if (props->bytes_transferred > 0) {
-      sstream << props->name << "[" <<
-        std::to_string(props->bytes_transferred) << " bytes]";
+      if (!pending || std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
+      std::this_thread::yield();
     }
-
-    return sstream.str();
   }
 
-  void AddKernelInfo(const ClKernelProps* props, uint64_t time) {
-    PTI_ASSERT(props != nullptr);
+  // Processing thread owns the outstanding instances and kernel
+  // statistics. It takes new instances from the rings and the completed
+  // ones from the completion queue periodically and on request, so the
+  // work per wakeup depends on the number of completed instances only.
+  // The request is served after all the instances pushed before it are
+  // taken from the rings
+  void Process() {
+    TraceGuard guard; // Calls made here should not be traced
+
+    uint64_t flush_count = 0;
+    while (true) {
+      uint64_t flush_request = 0;
+      uint64_t sync_request = 0;
+      bool stop = false;
+      {
+        std::unique_lock<std::mutex> lock(flush_lock_);
+        flush_wakeup_.wait_for(
+            lock, std::chrono::milliseconds(CL_INSTANCE_DRAIN_INTERVAL),
+            [this, flush_count] {
+              return stop_ || flush_request_ != flush_count;
+            });
+        flush_request = flush_request_;
+        sync_request = sync_request_;
+        stop = stop_;
+      }
 
-    std::string name = props->name;
-    PTI_ASSERT(!name.empty());
+      if (sync_request > flush_count) {
+        WaitForCompletedInstances();
+      } else {
+        ProcessCompletedInstances();
+      }
+
+      if (flush_request != flush_count) {
+        flush_count = flush_request;
+        {
+          const std::lock_guard<std::mutex> lock(flush_lock_);
+          flush_count_ = flush_count;
+        }
+        flush_done_.notify_all();
+      }
+
+      if (stop) {
+        break;
+      }
+    }
+  }
 
-    if (verbose_) {
-      name = GetVerboseName(props);
+  // Collector holds its own reference to each event, so instances may be
+  // processed later than the application releases or waits for the event.
+  // The caller is blocked only if it needs the results right away, then
+  // the callbacks of the completed instances are waited for as well
+  void ProcessKernelInstances(bool wait) {
+    std::unique_lock<std::mutex> lock(flush_lock_);
+    uint64_t flush_request = ++flush_request_;
+    if (wait) {
+      sync_request_ = flush_request;
     }
+    flush_wakeup_.notify_one();
+    if (wait) {
+      flush_done_.wait(lock, [this, flush_request] {
+        return flush_count_ >= flush_request;
+      });
+    }
+  }
 
-    if (kernel_info_map_.count(name) == 0) {
-      kernel_info_map_[name] = {
-        time, time, time, 1};
-    } else {
-      ClKernelInfo& kernel = kernel_info_map_[name];
-      kernel.total_time += time;
-      if (time > kernel.max_time) {
-        kernel.max_time = time;
+  // Sizes are only taken from kernels, transfers are told by their size
+  static KernelConfig GetConfig(const ClKernelProps& props) {
+    KernelConfig config{};
+    config.name_id = props.name_id;
+    if (props.simd_width > 0) {
+      config.simd_width = static_cast<uint32_t>(props.simd_width);
+      for (int i = 0; i < 3; ++i) {
+        config.global_size[i] = props.global_size[i];
+        config.local_size[i] = props.local_size[i];
       }
-      if (time < kernel.min_time) {
-        kernel.min_time = time;
+    } else {
+      config.bytes_transferred = props.bytes_transferred;
+    }
+    return config;
+  }
+
+  static std::string FormatConfig(
+      const KernelConfig& config, KernelGrouping grouping) {
+    const std::string& name = StringTable::Get(config.name_id);
+    PTI_ASSERT(!name.empty());
+
+    std::stringstream sstream;
+    if (config.simd_width > 0) {
+      sstream << name << "[SIMD" << config.simd_width << ", {";
+      if (grouping == KERNEL_GROUPING_CONFIG) {
+        sstream <<
+          config.global_size[0] << ", " <<
+          config.global_size[1] << ", " <<
+          config.global_size[2] << "}, {";
       }
-      kernel.call_count += 1;
+      sstream <<
+        config.local_size[0] << ", " <<
+        config.local_size[1] << ", " <<
+        config.local_size[2] << "}]";
+    } else if (config.bytes_transferred > 0) {
+      sstream << name << "[" <<
+        std::to_string(config.bytes_transferred) << " bytes]";
+    } else {
+      sstream << name;
     }
+
+    return sstream.str();
+  }
+
+  // Grouped names are formatted once per launch config
+  uint32_t GetIntervalNameId(const ClKernelProps& props) {
+    if (grouping_ == KERNEL_GROUPING_NAME) {
+      return props.name_id;
+    }
+
+    KernelConfig config =
+      KernelStatistics::GetGroup(GetConfig(props), grouping_);
+    uint32_t* name_id = interval_name_map_.Find(config);
+    if (name_id != nullptr) {
+      return *name_id;
+    }
+    uint32_t id = StringTable::Add(FormatConfig(config, grouping_));
+    interval_name_map_[config] = id;
+    return id;
   }
 
-#ifdef PTI_KERNEL_INTERVALS
   void AddKernelInterval(
       const ClKernelInstance* instance,
       cl_device_id device,
-      uint64_t started, uint64_t ended) {
+      uint64_t host_started, uint64_t host_ended) {
     PTI_ASSERT(instance != nullptr);
     PTI_ASSERT(device != nullptr);
-    PTI_ASSERT(started < ended);
-
-    uint64_t host_queued = 0, host_submitted = 0;
-    uint64_t host_started = 0, host_ended = 0;
-    ComputeHostTimestamps(
-        instance,
-        started, ended,
-        host_queued, host_submitted,
-        host_started, host_ended);
-
-    std::string name = instance->props.name;
-    PTI_ASSERT(!name.empty());
+    PTI_ASSERT(host_started <= host_ended);
+
+    uint32_t name_id = GetIntervalNameId(instance->props);
+    PTI_ASSERT(!StringTable::Get(name_id).empty());
+
+    const std::vector<cl_device_id>* device_list = device_map_.Find(device);
+    if (device_list != nullptr &&
+        !device_list->empty()) { // Implicit Scaling
+      PTI_ASSERT(device_list->size() <
+                 (std::numeric_limits<uint32_t>::max)());
+      kernel_interval_store_.AddLaunch(
+          name_id, device, host_started, host_ended, 0,
+          static_cast<uint32_t>(device_list->size()));
+    } else if (device_list == nullptr) { // Subdevice
+      cl_device_id parent = utils::cl::GetDeviceParent(device);
+      PTI_ASSERT(parent != nullptr);
+
+      const std::vector<cl_device_id>* parent_list =
+        device_map_.Find(parent);
+      PTI_ASSERT(parent_list != nullptr);
+      const std::vector<cl_device_id>& sub_device_list = *parent_list;
+      PTI_ASSERT(!sub_device_list.empty());
 
-    if (verbose_) {
-      name = GetVerboseName(&instance->props);
-    }
-
-    if (device_map_.count(device) == 1 &&
-        !device_map_[device].empty()) { // Implicit Scaling
-      ClKernelInterval kernel_interval{
-          name, device, std::vector<ClDeviceInterval>()};
-      std::vector<cl_device_id> sub_device_list = device_map_[device];
       for (size_t i = 0; i < sub_device_list.size(); ++i) {
-        kernel_interval.device_interval_list.push_back(
-            {host_started, host_ended, static_cast<uint32_t>(i)});
-      }
-      kernel_interval_list_.push_back(kernel_interval);
-    } else { // Explicit Scaling
-      if (device_map_.count(device) == 0) { // Subdevice
-        cl_device_id parent = utils::cl::GetDeviceParent(device);
-        PTI_ASSERT(parent != nullptr);
-
-        PTI_ASSERT(device_map_.count(parent) == 1);
-        std::vector<cl_device_id> sub_device_list = device_map_[parent];
-        PTI_ASSERT(!sub_device_list.empty());
-
-        for (size_t i = 0; i < sub_device_list.size(); ++i) {
-          if (sub_device_list[i] == device) {
-            ClKernelInterval kernel_interval{
-                name, parent, std::vector<ClDeviceInterval>()};
-            kernel_interval.device_interval_list.push_back(
-                {host_started, host_ended, static_cast<uint32_t>(i)});
-            kernel_interval_list_.push_back(kernel_interval);
-            return;
-          }
-
-          PTI_ASSERT(0);
+        if (sub_device_list[i] == device) {
+          kernel_interval_store_.AddLaunch(
+              name_id, parent, host_started, host_ended,
+              static_cast<uint32_t>(i), 1);
+          return;
         }
-      } else { // Device with no subdevices
-        PTI_ASSERT(device_map_[device].empty());
-        ClKernelInterval kernel_interval{
-            name, device, std::vector<ClDeviceInterval>()};
-        kernel_interval.device_interval_list.push_back(
-            {host_started, host_ended, 0});
-        kernel_interval_list_.push_back(kernel_interval);
       }
+      PTI_ASSERT(0);
+    } else { // Device with no subdevices
+      kernel_interval_store_.AddLaunch(
+          name_id, device, host_started, host_ended, 0, 1);
     }
   }
-#endif // PTI_KERNEL_INTERVALS
 
   void CalculateKernelLocalSize(
       const cl_params_clEnqueueNDRangeKernel* params,
@@ -644,6 +1019,33 @@ class ClKernelCollector {
       static_cast<unsigned long>(CL_QUEUE_PROFILING_ENABLE);
   }
 
+  // Kernel launches are sampled by kernel name, other commands are
+  // traced inside the capture window
+  template <typename T>
+  bool TraceLaunch(const T* params) {
+    return capture_ == nullptr || capture_->IsActive();
+  }
+
+  bool TraceLaunch(const cl_params_clEnqueueNDRangeKernel* params) {
+    return TraceKernel(*(params->kernel));
+  }
+
+  bool TraceLaunch(const cl_params_clEnqueueTask* params) {
+    return TraceKernel(*(params->kernel));
+  }
+
+  bool TraceKernel(cl_kernel kernel) {
+    if (capture_ == nullptr && !sampler_.IsEnabled()) {
+      return true;
+    }
+    PTI_ASSERT(kernel != nullptr);
+    uint32_t name_id = StringTable::Add(utils::cl::GetKernelName(kernel));
+    if (capture_ != nullptr && !capture_->CheckLaunch(name_id)) {
+      return false;
+    }
+    return sampler_.Sample(name_id);
+  }
+
   template <typename T>
   static void OnEnterEnqueueKernel(
       cl_callback_data* data, ClKernelCollector* collector) {
@@ -651,19 +1053,19 @@ class ClKernelCollector {
     PTI_ASSERT(collector != nullptr);
     PTI_ASSERT(collector->device_ != nullptr);
 
-    ClEnqueueData* enqueue_data = new ClEnqueueData;
-    enqueue_data->event = nullptr;
-    enqueue_data->host_sync = collector->correlator_->GetTimestamp();
-
-    cl_ulong host_timestamp = 0;
-    utils::cl::GetTimestamps(
-        collector->device_, &host_timestamp, &enqueue_data->device_sync);
-#ifdef PTI_KERNEL_INTERVALS
-    enqueue_data->host_sync = host_timestamp;
-#endif
-
+    // Untraced command gets neither event nor timestamps
     const T* params = reinterpret_cast<const T*>(data->functionParams);
     PTI_ASSERT(params != nullptr);
+    if (!collector->TraceLaunch(params)) {
+      data->correlationData[0] = 0;
+      return;
+    }
+
+    ClEnqueueData* enqueue_data = RecordPool<ClEnqueueData>::Create();
+    enqueue_data->event = nullptr;
+    enqueue_data->host_sync = collector->correlator_->GetTimestamp();
+    enqueue_data->device_sync =
+      collector->EstimateDeviceTimestamp(&enqueue_data->host_sync);
 
     if (*(params->event) == nullptr) {
       *(params->event) = &(enqueue_data->event);
@@ -678,6 +1080,12 @@ class ClKernelCollector {
     PTI_ASSERT(data != nullptr);
     PTI_ASSERT(collector != nullptr);
 
+    if (data->correlationData[0] == 0) {
+      PTI_ASSERT(collector->correlator_ != nullptr);
+      collector->correlator_->SetKernelId(0);
+      return;
+    }
+
     cl_int* return_value =
       reinterpret_cast<cl_int*>(data->functionReturnValue);
     if (*return_value == CL_SUCCESS) {
@@ -685,23 +1093,29 @@ class ClKernelCollector {
       PTI_ASSERT(params != nullptr);
 
       PTI_ASSERT(*(params->event) != nullptr);
-      cl_int status = CL_SUCCESS;
+      ClEnqueueData* enqueue_data =
+        reinterpret_cast<ClEnqueueData*>(data->correlationData[0]);
+      PTI_ASSERT(enqueue_data != nullptr);
 
-      if (*(params->event) !=
-          reinterpret_cast<cl_event*>(data->correlationData)) {
-        status = clRetainEvent(**(params->event));
+      // Event of the application gets one more reference for the tracer
+      bool own_event = (*(params->event) == &(enqueue_data->event));
+      if (!own_event) {
+        cl_int status = clRetainEvent(**(params->event));
         PTI_ASSERT(status == CL_SUCCESS);
       }
 
-      ClKernelInstance* instance = new ClKernelInstance;
+      ClKernelInstance* instance = RecordPool<ClKernelInstance>::Create();
       PTI_ASSERT(instance != nullptr);
       instance->event = **(params->event);
+      instance->own_event = own_event;
 
       cl_kernel kernel = *(params->kernel);
-      instance->props.name = utils::cl::GetKernelName(kernel);
+      instance->props.name_id =
+        StringTable::Add(utils::cl::GetKernelName(kernel));
 
       cl_command_queue queue = *(params->commandQueue);
       PTI_ASSERT(queue != nullptr);
+      instance->queue = queue;
       cl_device_id device = utils::cl::GetDevice(queue);
       PTI_ASSERT(device != nullptr);
 
@@ -720,34 +1134,51 @@ class ClKernelCollector {
       PTI_ASSERT(collector->correlator_ != nullptr);
       collector->correlator_->SetKernelId(instance->kernel_id);
 
-      ClEnqueueData* enqueue_data =
-        reinterpret_cast<ClEnqueueData*>(data->correlationData[0]);
-      PTI_ASSERT(enqueue_data != nullptr);
       instance->device_sync = enqueue_data->device_sync;
       instance->host_sync = enqueue_data->host_sync;
 
+      if (collector->dependency_graph_enabled_) {
+        collector->AddDependencyNode(
+            instance, *(params->numEventsInWaitList),
+            *(params->eventWaitList));
+      }
       collector->AddKernelInstance(instance);
 
-      delete enqueue_data;
+      RecordPool<ClEnqueueData>::Destroy(enqueue_data);
     }
   }
 
   static void OnExitEnqueueTransfer(
-      std::string name, size_t bytes_transferred, cl_event* event,
+      std::string name, size_t bytes_transferred,
+      cl_command_queue queue, cl_event* event,
+      cl_uint wait_event_count, const cl_event* wait_event_list,
       cl_callback_data* data, ClKernelCollector* collector) {
-    PTI_ASSERT(event != nullptr);
     PTI_ASSERT(data != nullptr);
     PTI_ASSERT(collector != nullptr);
 
-    if (event != reinterpret_cast<cl_event*>(data->correlationData)) {
+    if (data->correlationData[0] == 0) {
+      PTI_ASSERT(collector->correlator_ != nullptr);
+      collector->correlator_->SetKernelId(0);
+      return;
+    }
+    PTI_ASSERT(event != nullptr);
+    ClEnqueueData* enqueue_data =
+      reinterpret_cast<ClEnqueueData*>(data->correlationData[0]);
+    PTI_ASSERT(enqueue_data != nullptr);
+
+    bool own_event = (event == &(enqueue_data->event));
+    if (!own_event) {
       cl_int status = clRetainEvent(*event);
       PTI_ASSERT(status == CL_SUCCESS);
     }
 
-    ClKernelInstance* instance = new ClKernelInstance;
+    ClKernelInstance* instance = RecordPool<ClKernelInstance>::Create();
     PTI_ASSERT(instance != nullptr);
     instance->event = *event;
-    instance->props.name = name;
+    instance->own_event = own_event;
+    PTI_ASSERT(queue != nullptr);
+    instance->queue = queue;
+    instance->props.name_id = StringTable::Add(name);
 
     instance->props.simd_width = 0;
     instance->props.bytes_transferred = bytes_transferred;
@@ -758,15 +1189,16 @@ class ClKernelCollector {
     PTI_ASSERT(collector->correlator_ != nullptr);
     collector->correlator_->SetKernelId(instance->kernel_id);
 
-    ClEnqueueData* enqueue_data =
-      reinterpret_cast<ClEnqueueData*>(data->correlationData[0]);
-    PTI_ASSERT(enqueue_data != nullptr);
     instance->device_sync = enqueue_data->device_sync;
     instance->host_sync = enqueue_data->host_sync;
 
+    if (collector->dependency_graph_enabled_) {
+      collector->AddDependencyNode(
+          instance, wait_event_count, wait_event_list);
+    }
     collector->AddKernelInstance(instance);
 
-    delete enqueue_data;
+    RecordPool<ClEnqueueData>::Destroy(enqueue_data);
   }
 
   static void OnExitEnqueueReadBuffer(
@@ -784,7 +1216,9 @@ class ClKernelCollector {
 
       OnExitEnqueueTransfer(
           "clEnqueueReadBuffer", *(params->cb),
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -803,7 +1237,9 @@ class ClKernelCollector {
 
       OnExitEnqueueTransfer(
           "clEnqueueWriteBuffer", *(params->cb),
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -822,7 +1258,9 @@ class ClKernelCollector {
 
       OnExitEnqueueTransfer(
           "clEnqueueCopyBuffer", *(params->cb),
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -841,7 +1279,9 @@ class ClKernelCollector {
 
       OnExitEnqueueTransfer(
           "clEnqueueFillBuffer", *(params->size),
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -864,7 +1304,9 @@ class ClKernelCollector {
 
       OnExitEnqueueTransfer(
           "clEnqueueReadBufferRect", bytes_transferred,
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -887,7 +1329,9 @@ class ClKernelCollector {
 
       OnExitEnqueueTransfer(
           "clEnqueueWriteBufferRect", bytes_transferred,
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -910,7 +1354,9 @@ class ClKernelCollector {
 
       OnExitEnqueueTransfer(
           "clEnqueueCopyBufferRect", bytes_transferred,
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -940,7 +1386,9 @@ class ClKernelCollector {
         region[0] * region[1] * region[2] * element_size;
       OnExitEnqueueTransfer(
           "clEnqueueReadImage", bytes_transferred,
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -970,7 +1418,9 @@ class ClKernelCollector {
         region[0] * region[1] * region[2] * element_size;
       OnExitEnqueueTransfer(
           "clEnqueueWriteImage", bytes_transferred,
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -998,8 +1448,11 @@ class ClKernelCollector {
 
       size_t bytes_transferred =
         region[0] * region[1] * region[2] * element_size;
-      OnExitEnqueueTransfer("clEnqueueCopyImage", bytes_transferred,
-                            *(params->event), data, collector);
+      OnExitEnqueueTransfer(
+          "clEnqueueCopyImage", bytes_transferred,
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -1029,7 +1482,9 @@ class ClKernelCollector {
         region[0] * region[1] * region[2] * element_size;
       OnExitEnqueueTransfer(
           "clEnqueueFillImage", bytes_transferred,
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -1059,7 +1514,9 @@ class ClKernelCollector {
         region[0] * region[1] * region[2] * element_size;
       OnExitEnqueueTransfer(
           "clEnqueueCopyImageToBuffer", bytes_transferred,
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
@@ -1089,18 +1546,20 @@ class ClKernelCollector {
         region[0] * region[1] * region[2] * element_size;
       OnExitEnqueueTransfer(
           "clEnqueueCopyBufferToImage", bytes_transferred,
-          *(params->event), data, collector);
+          *(params->commandQueue), *(params->event),
+          *(params->numEventsInWaitList), *(params->eventWaitList),
+          data, collector);
     }
   }
 
   static void OnExitFinish(ClKernelCollector* collector) {
     PTI_ASSERT(collector != nullptr);
-    collector->ProcessKernelInstances();
+    collector->ProcessKernelInstances(true);
   }
 
   static void OnExitReleaseCommandQueue(ClKernelCollector* collector) {
     PTI_ASSERT(collector != nullptr);
-    collector->ProcessKernelInstances();
+    collector->ProcessKernelInstances(true);
   }
 
   static void OnEnterReleaseEvent(
@@ -1114,7 +1573,7 @@ class ClKernelCollector {
     PTI_ASSERT(params != nullptr);
 
     if (*(params->event) != nullptr) {
-      collector->ProcessKernelInstance(*(params->event));
+      collector->ProcessKernelInstances(false);
     }
   }
 
@@ -1132,10 +1591,8 @@ class ClKernelCollector {
       PTI_ASSERT(params != nullptr);
 
       const cl_event* event_list = *(params->eventList);
-      if (event_list != nullptr) {
-        for (cl_uint i = 0; i < *(params->numEvents); ++i) {
-          collector->ProcessKernelInstance(event_list[i]);
-        }
+      if (event_list != nullptr && *(params->numEvents) > 0) {
+        collector->ProcessKernelInstances(false);
       }
     }
   }
@@ -1145,6 +1602,7 @@ class ClKernelCollector {
                       void* user_data) {
     if (TraceGuard::Inactive()) return;
     TraceGuard guard;
+    OverheadScope overhead(OVERHEAD_CL_KERNEL, OVERHEAD_CALLBACK);
 
     ClKernelCollector* collector =
       reinterpret_cast<ClKernelCollector*>(user_data);
@@ -1290,27 +1748,52 @@ class ClKernelCollector {
   ClApiTracer* tracer_ = nullptr;
   Correlator* correlator_ = nullptr;
 
-  bool verbose_ = false;
+  KernelGrouping grouping_ = KERNEL_GROUPING_NAME;
 
   std::atomic<uint64_t> kernel_id_;
+  KernelSampler sampler_;
+  CaptureControl* capture_ = nullptr;
+  bool queue_timing_enabled_ = false;
+  bool kernel_intervals_enabled_ = false;
   cl_device_id device_ = nullptr;
 
   OnClKernelFinishCallback callback_ = nullptr;
   void* callback_data_ = nullptr;
 
-  std::mutex lock_;
-  ClKernelInfoMap kernel_info_map_;
-  ClKernelInstanceList kernel_instance_list_;
+  SpscRingGroup<ClKernelInstance*> instance_ring_group_;
+  KernelStatistics kernel_statistics_;
+  QueueTiming queue_timing_;
+  FlatHashMap<cl_command_queue, std::string> queue_engine_map_;
+  CompletionQueue<ClKernelInstance>* completion_queue_ = nullptr;
+  ClInstanceSet outstanding_instance_set_;
+  std::vector<ClKernelInstance*> completed_instance_list_;
+  std::vector<ClKernelTimestamps> device_timestamp_list_;
+  std::vector<ClKernelTimestamps> host_timestamp_list_;
+  std::atomic<uint64_t> pending_instance_count_{0};
+  std::atomic<uint64_t> pending_instance_limit_{CL_MAX_PENDING_INSTANCES};
+
+  std::mutex clock_lock_;
+  ClockDomain clock_domain_{NSEC_IN_SEC, UINT64_MAX};
+
+  std::thread processing_thread_;
+  std::mutex flush_lock_;
+  std::condition_variable flush_wakeup_;
+  std::condition_variable flush_done_;
+  uint64_t flush_request_ = 0;
+  uint64_t sync_request_ = 0;
+  uint64_t flush_count_ = 0;
+  bool stop_ = false;
 
-#ifdef PTI_KERNEL_INTERVALS
   ClDeviceMap device_map_;
-  ClKernelIntervalList kernel_interval_list_;
-#endif // PTI_KERNEL_INTERVALS
+  std::mutex interval_lock_;
+  ClKernelIntervalStore kernel_interval_store_;
+  FlatHashMap<KernelConfig, uint32_t, KernelConfigHash> interval_name_map_;
+
+  bool dependency_graph_enabled_ = false;
+  DependencyGraph dependency_graph_;
 
-  static const uint32_t kKernelLength = 10;
-  static const uint32_t kCallsLength = 12;
-  static const uint32_t kTimeLength = 20;
-  static const uint32_t kPercentLength = 10;
+  bool call_stacks_enabled_ = false;
+  StackTable stack_table_;
 };
 
 #endif // PTI_TOOLS_CL_TRACER_CL_KERNEL_COLLECTOR_H_
\ No newline at end of file
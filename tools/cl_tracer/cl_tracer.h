@@ -15,12 +15,20 @@
 #include <sstream>
 #include <string>
 
+#include "binary_trace.h"
+#include "capture_control.h"
 #include "cl_ext_collector.h"
 #include "cl_ext_callbacks.h"
 #include "cl_api_collector.h"
 #include "cl_api_callbacks.h"
 #include "cl_kernel_collector.h"
+#include "interval_statistics.h"
+#include "overhead.h"
+#include "perfetto_trace.h"
+#include "table_store.h"
+#include "thread_identity.h"
 #include "trace_options.h"
+#include "trace_sink.h"
 #include "utils.h"
 
 const char* kChromeTraceFileName = "clt_trace";
@@ -38,12 +46,35 @@ class ClTracer {
     ClTracer* tracer = new ClTracer(options);
     PTI_ASSERT(tracer != nullptr);
 
+    tracer->capture_ = CaptureControl::Create(options.GetCaptureOptions());
+
+    if (tracer->CheckOption(TRACE_INTERVAL_STATS)) {
+      tracer->interval_file_name_ =
+        TraceOptions::GetIntervalsFileName(kChromeTraceFileName);
+      tracer->interval_statistics_ = IntervalStatistics::Create(
+          tracer->interval_file_name_, options.GetStatsInterval());
+    }
+
+    if (tracer->CheckOption(TRACE_WAIT_ANALYSIS)) {
+      tracer->wait_analysis_ = new WaitAnalysis;
+      PTI_ASSERT(tracer->wait_analysis_ != nullptr);
+    }
+
+    tracer->CreateSinks();
+
     if (tracer->CheckOption(TRACE_DEVICE_TIMING) ||
         tracer->CheckOption(TRACE_DEVICE_TIMING_VERBOSE) ||
+        tracer->CheckOption(TRACE_QUEUE_TIMING) ||
+        tracer->CheckOption(TRACE_DEPENDENCY_GRAPH) ||
+        tracer->CheckOption(TRACE_CALL_STACKS) ||
         tracer->CheckOption(TRACE_DEVICE_TIMELINE) ||
         tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE) ||
         tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE) ||
-        tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
+        tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES) ||
+        tracer->CheckOption(TRACE_BINARY_TRACE) ||
+        tracer->CheckOption(TRACE_PERFETTO_TRACE) ||
+        tracer->CheckOption(TRACE_INTERVAL_STATS) ||
+        tracer->CheckOption(TRACE_WAIT_ANALYSIS)) {
 
       PTI_ASSERT(!(tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE) &&
                    tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)));
@@ -54,37 +85,22 @@ class ClTracer {
       ClKernelCollector* gpu_kernel_collector = nullptr;
 
       OnClKernelFinishCallback callback = nullptr;
-      if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-          tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE) &&
-          tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        callback = DeviceAndChromeKernelStagesCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE)) {
-        callback = DeviceAndChromeDeviceCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE)) {
-        callback = DeviceAndChromeKernelCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        callback = DeviceAndChromeStagesCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        callback = ChromeKernelStagesCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE)) {
-        callback = DeviceTimelineCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE)) {
-        callback = ChromeDeviceCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE)) {
-        callback = ChromeKernelCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        callback = ChromeStagesCallback;
+      if (tracer->pipeline_.HasDeviceSinks()) {
+        callback = OnKernelFinish;
       }
 
+      KernelGrouping grouping = KERNEL_GROUPING_NAME;
+      bool parsed = KernelStatistics::ParseGrouping(
+          tracer->options_.GetKernelGrouping(), &grouping);
+      PTI_ASSERT(parsed);
+
       if (cpu_device != nullptr) {
         cpu_kernel_collector = ClKernelCollector::Create(
-            cpu_device, &tracer->correlator_,
-            tracer->CheckOption(TRACE_DEVICE_TIMING_VERBOSE),
-            callback, tracer);
+            cpu_device, &tracer->correlator_, grouping,
+            callback, tracer, tracer->options_.GetKernelSampling(),
+            tracer->capture_, tracer->CheckOption(TRACE_QUEUE_TIMING),
+            false, tracer->CheckOption(TRACE_DEPENDENCY_GRAPH),
+            tracer->CheckOption(TRACE_CALL_STACKS));
         if (cpu_kernel_collector == nullptr) {
           std::cerr <<
             "[WARNING] Unable to create kernel collector for CPU backend" <<
@@ -95,9 +111,11 @@ class ClTracer {
 
       if (gpu_device != nullptr) {
         gpu_kernel_collector = ClKernelCollector::Create(
-            gpu_device, &tracer->correlator_,
-            tracer->CheckOption(TRACE_DEVICE_TIMING_VERBOSE),
-            callback, tracer);
+            gpu_device, &tracer->correlator_, grouping,
+            callback, tracer, tracer->options_.GetKernelSampling(),
+            tracer->capture_, tracer->CheckOption(TRACE_QUEUE_TIMING),
+            false, tracer->CheckOption(TRACE_DEPENDENCY_GRAPH),
+            tracer->CheckOption(TRACE_CALL_STACKS));
         if (gpu_kernel_collector == nullptr) {
           std::cerr <<
             "[WARNING] Unable to create kernel collector for GPU backend" <<
@@ -112,22 +130,23 @@ class ClTracer {
       }
     }
 
-    if (tracer->CheckOption(TRACE_CALL_LOGGING) ||
-        tracer->CheckOption(TRACE_CHROME_CALL_LOGGING) ||
-        tracer->CheckOption(TRACE_HOST_TIMING)) {
+    if (tracer->NeedsFullApi() || tracer->GetApiSubsets() != 0) {
 
       ClApiCollector* cpu_api_collector = nullptr;
       ClApiCollector* gpu_api_collector = nullptr;
 
       OnClFunctionFinishCallback callback = nullptr;
-      if (tracer->CheckOption(TRACE_CHROME_CALL_LOGGING)) {
-        callback = ChromeLoggingCallback;
+      if (tracer->pipeline_.HasHostSinks()) {
+        callback = OnFunctionFinish;
       }
 
       ApiCollectorOptions cl_api_options{false, false, false};
       cl_api_options.call_tracing = tracer->CheckOption(TRACE_CALL_LOGGING);
       cl_api_options.need_tid = tracer->CheckOption(TRACE_TID);
       cl_api_options.need_pid = tracer->CheckOption(TRACE_PID);
+      cl_api_options.include_api = tracer->options_.GetIncludeApi();
+      cl_api_options.exclude_api = tracer->options_.GetExcludeApi();
+      cl_api_options.api_subsets = tracer->GetApiSubsets();
 
       if (cpu_device != nullptr) {
         cpu_api_collector = ClApiCollector::Create(
@@ -161,12 +180,20 @@ class ClTracer {
       ClExtCollector::Create(cpu_api_collector, gpu_api_collector);
     }
 
+    if (tracer->capture_ != nullptr) {
+      tracer->capture_->Start(OnCaptureChange, tracer);
+    }
+
     return tracer;
   }
 
   ~ClTracer() {
     total_execution_time_ = correlator_.GetTimestamp();
 
+    if (capture_ != nullptr) {
+      delete capture_;
+    }
+
     if (cpu_api_collector_ != nullptr) {
       cpu_api_collector_->DisableTracing();
     }
@@ -199,9 +226,19 @@ class ClTracer {
 
     ClExtCollector::Destroy();
 
+    if (wait_analysis_ != nullptr) {
+      delete wait_analysis_;
+    }
+
+    if (interval_statistics_ != nullptr) {
+      delete interval_statistics_;
+      std::cerr << "[INFO] Interval statistics were stored to " <<
+        interval_file_name_ << std::endl;
+    }
+
     if (CheckOption(TRACE_LOG_TO_FILE)) {
       std::cerr << "[INFO] Log was stored to " <<
-        options_.GetLogFileName() << std::endl;
+        correlator_.GetLogFileName() << std::endl;
     }
 
     if (chrome_logger_ != nullptr) {
@@ -209,38 +246,119 @@ class ClTracer {
       std::cerr << "[INFO] Timeline was stored to " <<
         chrome_trace_file_name_ << std::endl;
     }
+
+    if (binary_writer_ != nullptr) {
+      delete binary_writer_;
+      std::cerr << "[INFO] Binary trace was stored to " <<
+        binary_trace_file_name_ << std::endl;
+    }
+
+    if (perfetto_writer_ != nullptr) {
+      delete perfetto_writer_;
+      std::cerr << "[INFO] Perfetto trace was stored to " <<
+        perfetto_trace_file_name_ << std::endl;
+    }
   }
 
   bool CheckOption(unsigned option) {
     return options_.CheckFlag(option);
   }
 
+  // Modes that trace every API call, the others get callbacks for the
+  // subsets they need only
+  bool NeedsFullApi() {
+    return CheckOption(TRACE_CALL_LOGGING) ||
+           CheckOption(TRACE_CHROME_CALL_LOGGING) ||
+           CheckOption(TRACE_HOST_TIMING) ||
+           CheckOption(TRACE_BINARY_TRACE) ||
+           CheckOption(TRACE_PERFETTO_TRACE) ||
+           CheckOption(TRACE_INTERVAL_STATS);
+  }
+
+  // Zero if any of the enabled modes needs the whole API
+  uint32_t GetApiSubsets() {
+    if (NeedsFullApi()) {
+      return 0;
+    }
+
+    uint32_t subsets = 0;
+    if (CheckOption(TRACE_WAIT_ANALYSIS)) {
+      subsets |= API_SUBSET_WAIT;
+    }
+    return subsets;
+  }
+
   ClTracer(const ClTracer& copy) = delete;
   ClTracer& operator=(const ClTracer& copy) = delete;
 
  private:
   ClTracer(const TraceOptions& options)
-      : options_(options), correlator_(options.GetLogFileName()) {
+      : options_(options),
+        correlator_(
+            options.GetLogFileName(),
+            options.CheckFlag(TRACE_ASYNC_LOGGING),
+            options.GetLogBufferSize(),
+            options.GetCompression()) {
     if (CheckOption(TRACE_CHROME_CALL_LOGGING) ||
         CheckOption(TRACE_CHROME_DEVICE_TIMELINE) ||
         CheckOption(TRACE_CHROME_KERNEL_TIMELINE) ||
         CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
       chrome_trace_file_name_ =
         TraceOptions::GetChromeTraceFileName(kChromeTraceFileName);
-      chrome_logger_ = new Logger(chrome_trace_file_name_.c_str());
+      chrome_logger_ = new Logger(
+          chrome_trace_file_name_.c_str(),
+          CheckOption(TRACE_ASYNC_LOGGING),
+          options_.GetLogBufferSize(),
+          options_.GetCompression());
       PTI_ASSERT(chrome_logger_ != nullptr);
+      chrome_trace_file_name_ = chrome_logger_->GetFileName();
 
       std::stringstream stream;
       stream << "[" << std::endl;
       stream << "{\"ph\":\"M\", \"name\":\"process_name\", \"pid\":\"" <<
-        utils::GetPid() << "\", \"tid\":0, \"args\":{\"name\":\"" <<
+        ThreadIdentity::GetPid() << "\", \"tid\":0, \"args\":{\"name\":\"" <<
         utils::GetExecutableName() << "\"}}," << std::endl;
       stream << "{\"ph\":\"M\", \"name\":\"cl_tracer_start_time\", \"pid\":\"" <<
-        utils::GetPid() << "\", \"tid\":0, \"args\":{\"start_time\":\"" <<
+        ThreadIdentity::GetPid() <<
+        "\", \"tid\":0, \"args\":{\"start_time\":\"" <<
         correlator_.GetStartPoint() << "\"}}," << std::endl;
 
       chrome_logger_->Log(stream.str());
     }
+
+    if (CheckOption(TRACE_BINARY_TRACE)) {
+      ShmTraceRing* ring = nullptr;
+      if (CheckOption(TRACE_NODE_TRACE)) {
+        ring = ShmTraceRing::Create(
+            ThreadIdentity::GetPid(), SHM_TRACE_RING_SIZE);
+      }
+
+      if (ring != nullptr) {
+        binary_trace_file_name_ =
+          "node trace daemon (" + ring->GetName() + ")";
+        binary_writer_ = new BinaryTraceWriter(
+            ring, ThreadIdentity::GetPid(),
+            correlator_.GetStartPoint(), correlator_.GetEpochPoint(),
+            utils::GetExecutableName());
+      } else {
+        binary_trace_file_name_ =
+          TraceOptions::GetBinaryTraceFileName(kChromeTraceFileName);
+        binary_writer_ = new BinaryTraceWriter(
+            binary_trace_file_name_, ThreadIdentity::GetPid(),
+            correlator_.GetStartPoint(), correlator_.GetEpochPoint(),
+            utils::GetExecutableName());
+      }
+      PTI_ASSERT(binary_writer_ != nullptr);
+    }
+
+    if (CheckOption(TRACE_PERFETTO_TRACE)) {
+      perfetto_trace_file_name_ =
+        TraceOptions::GetPerfettoTraceFileName(kChromeTraceFileName);
+      perfetto_writer_ = new PerfettoTraceWriter(
+          perfetto_trace_file_name_, ThreadIdentity::GetPid(),
+          utils::GetExecutableName());
+      PTI_ASSERT(perfetto_writer_ != nullptr);
+    }
   }
 
   static uint64_t CalculateTotalTime(const ClApiCollector* collector) {
@@ -349,236 +467,241 @@ class ClTracer {
     correlator_.Log("\n");
   }
 
-  void Report() {
-    if (CheckOption(TRACE_HOST_TIMING)) {
-      ReportTiming(cpu_api_collector_, gpu_api_collector_, "API");
+  void PrintQueueTable(
+      const ClKernelCollector* collector, const char* device_type) {
+    PTI_ASSERT(collector != nullptr);
+    PTI_ASSERT(device_type != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "== " << device_type << " Backend: ==" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+    collector->PrintQueuesTable();
+  }
+
+  void ReportQueueTiming() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Queue Timing Results: ===" << std::endl;
+    correlator_.Log(stream.str());
+
+    if (cpu_kernel_collector_ != nullptr) {
+      PrintQueueTable(cpu_kernel_collector_, "CPU");
     }
-    if (CheckOption(TRACE_DEVICE_TIMING) ||
-        CheckOption(TRACE_DEVICE_TIMING_VERBOSE)) {
-      ReportTiming(cpu_kernel_collector_, gpu_kernel_collector_, "Device");
+    if (gpu_kernel_collector_ != nullptr) {
+      PrintQueueTable(gpu_kernel_collector_, "GPU");
     }
+
     correlator_.Log("\n");
   }
 
-  static void DeviceTimelineCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ClTracer* tracer = reinterpret_cast<ClTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
+  void PrintDependencyTable(
+      ClKernelCollector* collector, const char* device_type) {
+    PTI_ASSERT(collector != nullptr);
+    PTI_ASSERT(device_type != nullptr);
 
     std::stringstream stream;
-    if (tracer->CheckOption(TRACE_PID)) {
-      stream << "<PID:" << utils::GetPid() << "> ";
-    }
-    stream << "Device Timeline (queue: " << queue <<
-      "): " << name << "(" << id << ") [ns] = " <<
-      queued << " (queued) " <<
-      submitted << " (submit) " <<
-      started << " (start) " <<
-      ended << " (end)" << std::endl;
-    tracer->correlator_.Log(stream.str());
+    stream << std::endl;
+    stream << "== " << device_type << " Backend: ==" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+    collector->PrintDependencyTable();
   }
 
-  static void ChromeDeviceCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ClTracer* tracer = reinterpret_cast<ClTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
+  void PrintStacksTable(
+      ClKernelCollector* collector, const char* device_type) {
+    PTI_ASSERT(collector != nullptr);
+    PTI_ASSERT(device_type != nullptr);
 
     std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << reinterpret_cast<uint64_t>(queue) <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    stream << std::endl;
+    stream << "== " << device_type << " Backend: ==" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+    collector->PrintStacksTable();
   }
 
-  static void ChromeKernelCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ClTracer* tracer = reinterpret_cast<ClTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
-
+  void ReportCallStacks() {
     std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    stream << std::endl;
+    stream << "=== Call Stack Results: ===" << std::endl;
+    correlator_.Log(stream.str());
+
+    if (cpu_kernel_collector_ != nullptr) {
+      PrintStacksTable(cpu_kernel_collector_, "CPU");
+    }
+    if (gpu_kernel_collector_ != nullptr) {
+      PrintStacksTable(gpu_kernel_collector_, "GPU");
+    }
+
+    correlator_.Log("\n");
   }
 
-  static void ChromeStagesCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ClTracer* tracer = reinterpret_cast<ClTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
+  void ReportDependencyGraph() {
     std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Dependency Graph Results: ===" << std::endl;
+    correlator_.Log(stream.str());
+
+    if (cpu_kernel_collector_ != nullptr) {
+      PrintDependencyTable(cpu_kernel_collector_, "CPU");
+    }
+    if (gpu_kernel_collector_ != nullptr) {
+      PrintDependencyTable(gpu_kernel_collector_, "GPU");
+    }
 
-    std::string tid =
-      std::to_string(id) +
-      "." + std::to_string(reinterpret_cast<uint64_t>(queue));
-
-    PTI_ASSERT(submitted > queued);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Queued)" <<
-      "\", \"ts\": " << queued / NSEC_IN_USEC <<
-      ", \"dur\":" << (submitted - queued) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_runnable\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(started > submitted);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Submitted)" <<
-      "\", \"ts\": " << submitted / NSEC_IN_USEC <<
-      ", \"dur\":" << (started - submitted) / NSEC_IN_USEC <<
-      ", \"cname\":\"cq_build_running\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(ended > started);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Execution)" <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_iowait\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
+    correlator_.Log("\n");
   }
 
-  static void ChromeKernelStagesCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ClTracer* tracer = reinterpret_cast<ClTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
+  void ReportWaitAnalysis() {
+    PTI_ASSERT(wait_analysis_ != nullptr);
+
     std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Wait Analysis Results: ===" << std::endl;
+    stream << std::endl;
+    wait_analysis_->PrintTables(stream);
+    correlator_.Log(stream.str());
+  }
 
-    PTI_ASSERT(submitted > queued);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Queued)" <<
-      "\", \"ts\": " << queued / NSEC_IN_USEC <<
-      ", \"dur\":" << (submitted - queued) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_runnable\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(started > submitted);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Submitted)" <<
-      "\", \"ts\": " << submitted / NSEC_IN_USEC <<
-      ", \"dur\":" << (started - submitted) / NSEC_IN_USEC <<
-      ", \"cname\":\"cq_build_running\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(ended > started);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Execution)" <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_iowait\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
+  // Collected by all the tool collectors of the process when the
+  // PTI_OVERHEAD environment variable is set
+  void ReportOverhead() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Overhead Summary: ===" << std::endl;
+    stream << std::endl;
+    Overhead::PrintTable(stream);
+    correlator_.Log(stream.str());
   }
 
-  static void DeviceAndChromeDeviceCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    DeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ChromeDeviceCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+  void Report() {
+    if (CheckOption(TRACE_HOST_TIMING)) {
+      ReportTiming(cpu_api_collector_, gpu_api_collector_, "API");
+    }
+    if (CheckOption(TRACE_DEVICE_TIMING) ||
+        CheckOption(TRACE_DEVICE_TIMING_VERBOSE)) {
+      ReportTiming(cpu_kernel_collector_, gpu_kernel_collector_, "Device");
+    }
+    if (CheckOption(TRACE_QUEUE_TIMING)) {
+      ReportQueueTiming();
+    }
+    if (CheckOption(TRACE_DEPENDENCY_GRAPH)) {
+      ReportDependencyGraph();
+    }
+    if (CheckOption(TRACE_CALL_STACKS)) {
+      ReportCallStacks();
+    }
+    if (CheckOption(TRACE_WAIT_ANALYSIS)) {
+      ReportWaitAnalysis();
+    }
+    if (Overhead::IsEnabled()) {
+      ReportOverhead();
+    }
+    if (CheckOption(TRACE_SAVE_TABLES)) {
+      SaveTables();
+    }
+    correlator_.Log("\n");
   }
 
-  static void DeviceAndChromeKernelCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    DeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ChromeKernelCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+  // Timing tables are stored for run-to-run comparison with table_diff.py
+  void SaveTables() {
+    TableStore store("cl_tracer");
+    if (cpu_kernel_collector_ != nullptr) {
+      store.AddKernels("CL CPU", cpu_kernel_collector_->GetKernelInfoMap());
+    }
+    if (gpu_kernel_collector_ != nullptr) {
+      store.AddKernels("CL GPU", gpu_kernel_collector_->GetKernelInfoMap());
+    }
+    if (cpu_api_collector_ != nullptr) {
+      store.AddFunctions("CL CPU", cpu_api_collector_->GetFunctionInfoMap());
+    }
+    if (gpu_api_collector_ != nullptr) {
+      store.AddFunctions("CL GPU", gpu_api_collector_->GetFunctionInfoMap());
+    }
+
+    std::string filename =
+      TraceOptions::GetTablesFileName(kChromeTraceFileName);
+    if (store.Write(filename)) {
+      std::cerr << "[INFO] Timing tables were stored to " << filename <<
+        std::endl;
+    }
   }
 
-  static void DeviceAndChromeStagesCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    DeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ChromeStagesCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+  // API calls are not traced at all outside the capture window, while
+  // commands are filtered by the kernel collectors themselves
+  static void OnCaptureChange(void* data, bool active) {
+    ClTracer* tracer = reinterpret_cast<ClTracer*>(data);
+    PTI_ASSERT(tracer != nullptr);
+    if (tracer->cpu_api_collector_ != nullptr) {
+      tracer->cpu_api_collector_->SetTracingEnabled(active);
+    }
+    if (tracer->gpu_api_collector_ != nullptr) {
+      tracer->gpu_api_collector_->SetTracingEnabled(active);
+    }
   }
 
-  static void DeviceAndChromeKernelStagesCallback(
+  // Outputs of completed kernels and API calls, each record goes to them
+  // in the order of addition
+  void CreateSinks() {
+    if (binary_writer_ != nullptr) {
+      pipeline_.AddSink(
+          new BinaryTraceSink<uint64_t>(binary_writer_), true, true);
+    }
+    if (perfetto_writer_ != nullptr) {
+      pipeline_.AddSink(
+          new PerfettoTraceSink<uint64_t>(perfetto_writer_), true, true);
+    }
+    if (interval_statistics_ != nullptr) {
+      pipeline_.AddSink(
+          new IntervalStatisticsSink<uint64_t>(interval_statistics_),
+          true, true);
+    }
+    if (wait_analysis_ != nullptr) {
+      pipeline_.AddSink(
+          new WaitAnalysisSink<uint64_t>(wait_analysis_), true, true);
+    }
+    if (CheckOption(TRACE_DEVICE_TIMELINE)) {
+      pipeline_.AddSink(
+          new DeviceTimelineSink<uint64_t>(
+              &correlator_, "queued", true, CheckOption(TRACE_PID)),
+          true, false);
+    }
+    if (CheckOption(TRACE_CHROME_DEVICE_TIMELINE) ||
+        CheckOption(TRACE_CHROME_KERNEL_TIMELINE) ||
+        CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
+      pipeline_.AddSink(
+          new ChromeDeviceSink<uint64_t>(
+              chrome_logger_, "Queued",
+              CheckOption(TRACE_CHROME_KERNEL_TIMELINE),
+              CheckOption(TRACE_CHROME_DEVICE_STAGES)),
+          true, false);
+    }
+    if (CheckOption(TRACE_CHROME_CALL_LOGGING)) {
+      pipeline_.AddSink(
+          new ChromeHostSink<uint64_t>(chrome_logger_), false, true);
+    }
+  }
+
+  static void OnKernelFinish(
       void* data, void* queue,
       uint64_t id, const std::string& name,
       uint64_t queued, uint64_t submitted,
       uint64_t started, uint64_t ended) {
-    DeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ChromeKernelStagesCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+    ClTracer* tracer = reinterpret_cast<ClTracer*>(data);
+    PTI_ASSERT(tracer != nullptr);
+    tracer->pipeline_.AddDeviceRecord(
+        {queue, id, name, queued, submitted, started, ended});
   }
 
-  static void ChromeLoggingCallback(
+  static void OnFunctionFinish(
       void* data, uint64_t id, const std::string& name,
       uint64_t started, uint64_t ended) {
     ClTracer* tracer = reinterpret_cast<ClTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
-
-    std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" <<
-      utils::GetPid() << "\", \"tid\":\"" << utils::GetTid() <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    tracer->pipeline_.AddHostRecord(
+        {ThreadIdentity::GetTid(), id, name, started, ended});
   }
 
  private:
@@ -593,8 +716,23 @@ class ClTracer {
   ClKernelCollector* cpu_kernel_collector_ = nullptr;
   ClKernelCollector* gpu_kernel_collector_ = nullptr;
 
+  CaptureControl* capture_ = nullptr;
+
+  std::string interval_file_name_;
+  IntervalStatistics* interval_statistics_ = nullptr;
+
+  WaitAnalysis* wait_analysis_ = nullptr;
+
   std::string chrome_trace_file_name_;
   Logger* chrome_logger_ = nullptr;
+
+  std::string binary_trace_file_name_;
+  BinaryTraceWriter* binary_writer_ = nullptr;
+
+  std::string perfetto_trace_file_name_;
+  PerfettoTraceWriter* perfetto_writer_ = nullptr;
+
+  TraceSinkPipeline<uint64_t> pipeline_;
 };
 
 #endif // PTI_TOOLS_CL_TRACER_CL_TRACER_H_
\ No newline at end of file
@@ -0,0 +1,414 @@
+#==============================================================
+# Copyright (C) Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+# =============================================================
+
+# Generates cl_api_callbacks.h from OpenCL tracing headers (CL/tracing_types.h)
+# and OpenCL headers (CL/cl.h, CL/cl_gl.h), e.g. the ones fetched into the
+# build folder by GetOpenCLTracingHeaders and GetOpenCLHeaders
+
+import os
+import re
+import sys
+
+LINE_LIMIT = 80
+
+# Parse OpenCL Headers ########################################################
+
+def get_func_list(tracing_file):
+  tracing_file.seek(0)
+  data = tracing_file.read()
+  func_list = []
+  for func, value in re.findall(r"CL_FUNCTION_(cl\w+)\s*=\s*(\d+)", data):
+    func_list.append((int(value), func))
+  func_list.sort()
+  return [func for value, func in func_list]
+
+def split_fields(body):
+  field_list = []
+  field = ""
+  level = 0
+  for symbol in body:
+    if symbol == "(":
+      level += 1
+    elif symbol == ")":
+      assert level > 0
+      level -= 1
+    if symbol == ";" and level == 0:
+      field_list.append(field.strip())
+      field = ""
+    else:
+      field += symbol
+  assert not field.strip()
+  return field_list
+
+def remove_comments(data):
+  data = re.sub(r"/\*.*?\*/", "", data, flags=re.S)
+  return re.sub(r"//[^\n]*", "", data)
+
+# Field is a pointer to the argument: (name, type of the argument)
+def get_field(field):
+  field = " ".join(field.split())
+  match = re.match(r"^(.*)\(\s*(?:CL_CALLBACK\s*)?\*\s*(\*\s*\w+)\s*\)(.*)$",
+                   field)
+  if match:
+    name = match.group(2).replace("*", "").strip()
+    return name, match.group(1).strip() + "(*)" + match.group(3).strip()
+  match = re.match(r"^(.*?)\s*\*\s*(\w+)$", field)
+  assert match, field
+  return match.group(2), match.group(1).strip()
+
+def get_param_map(tracing_file):
+  tracing_file.seek(0)
+  data = remove_comments(tracing_file.read())
+  param_map = {}
+  for func, body in re.findall(
+      r"struct\s+_?cl_params_(cl\w+)\s*\{(.*?)\}", data, flags=re.S):
+    param_map[func] = [get_field(field) for field in split_fields(body)]
+  return param_map
+
+def get_result_map(cl_path):
+  result_map = {}
+  for name in ["cl.h", "cl_gl.h", "cl_ext.h"]:
+    file_path = os.path.join(cl_path, name)
+    if not os.path.isfile(file_path):
+      continue
+    with open(file_path, "rt") as f:
+      data = remove_comments(f.read())
+    for result, func in re.findall(
+        r"extern\s+CL_API_ENTRY\s+(?:\w*PREFIX\w*\s+)*" +
+        r"([\w\s\*]+?)\s*CL_API_CALL\s+(cl\w+)\s*\(", data):
+      result_map[func] = "".join(result.split())
+  return result_map
+
+# Generate Callbacks ##########################################################
+
+# Arrays recorded after the pointer to them: array -> number of items
+array_map = {
+  "clEnqueueNDRangeKernel": {"globalWorkOffset": "workDim",
+                             "globalWorkSize": "workDim",
+                             "localWorkSize": "workDim"}}
+
+# Functions traced by the kernel collector, kernel id is recorded for them
+kernel_id_list = ["clEnqueueNDRangeKernel", "clEnqueueReadBuffer",
+                  "clEnqueueWriteBuffer"]
+
+# Functions of each API subset (see API_SUBSET_* in api_filter.h), the modes
+# that need only these get no callbacks for the rest of the API. Wait list
+# is the OpenCL part of WaitAnalysis functions
+subset_map = {
+  "API_SUBSET_WAIT": ["clFinish", "clWaitForEvents"]}
+
+def get_subsets(func):
+  subset_list = []
+  for subset in sorted(subset_map.keys()):
+    if func in subset_map[subset]:
+      subset_list.append(subset)
+  return " | ".join(subset_list)
+
+def get_var_name(name):
+  return re.sub(r"([A-Z])", r"_\1", name).lower()
+
+def is_string(param_type):
+  return "".join(param_type.split()) == "constchar*"
+
+def has_error_code(params):
+  for name, param_type in params:
+    if name == "errcodeRet":
+      return True
+  return False
+
+def get_item_type(param_type):
+  param_type = "".join(param_type.replace("const", " ").split())
+  assert param_type.endswith("*")
+  return param_type[:-1]
+
+# Wraps "head tail" to "head\n<indent>tail" if it is too long, no space is
+# put after the opening bracket
+def write_wrapped(f, head, tail, indent):
+  separator = "" if head.endswith("(") else " "
+  if len(head) + len(separator) + len(tail) <= LINE_LIMIT:
+    f.write(head + separator + tail + "\n")
+  else:
+    f.write(head + "\n" + indent + tail + "\n")
+
+def gen_params(f, func):
+  struct_name = "cl_params_" + func
+  f.write("  const " + struct_name + "* params =\n")
+  cast = "    reinterpret_cast<const " + struct_name + "*>("
+  if len(cast) <= LINE_LIMIT:
+    f.write(cast + "\n")
+    f.write("        data->functionParams);\n")
+  else:
+    f.write("    reinterpret_cast<\n")
+    f.write("      const " + struct_name + "*>(\n")
+    f.write("          data->functionParams);\n")
+  f.write("  PTI_ASSERT(params != nullptr);\n")
+
+def gen_record(f, func, end):
+  f.write("  ClCallRecordWriter record(\n")
+  line = "      CL_FUNCTION_" + func + ", data, start, " + end + ","
+  write_wrapped(f, line, "collector->NeedTid());", "      ")
+
+def gen_enter_callback(f, func, params):
+  f.write("static void " + func + "OnEnter(\n")
+  f.write("    cl_callback_data* data, uint64_t start, " +
+          "ClApiCollector* collector) {\n")
+  f.write("  PTI_ASSERT(collector != nullptr);\n")
+  gen_params(f, func)
+  f.write("\n")
+  gen_record(f, func, "0")
+  arrays = array_map.get(func, {})
+  for name, param_type in params:
+    if is_string(param_type):
+      f.write("  record.AddString(*(params->" + name + "));\n")
+      continue
+    f.write("  record.AddArg(*(params->" + name + "));\n")
+    if name in arrays:
+      f.write("  record.AddArray(*(params->" + name + "), *(params->" +
+              arrays[name] + "));\n")
+  f.write("  collector->Log(record);\n")
+  if has_error_code(params):
+    f.write("\n")
+    f.write("  if (*(params->errcodeRet) == nullptr) {\n")
+    f.write("    *(params->errcodeRet) = &current_error;\n")
+    f.write("  }\n")
+  f.write("}\n")
+
+def gen_exit_callback(f, func, params, result):
+  f.write("static void " + func + "OnExit(\n")
+  f.write("    cl_callback_data* data, uint64_t start, uint64_t end,\n")
+  f.write("    ClApiCollector* collector) {\n")
+  f.write("  PTI_ASSERT(collector != nullptr);\n")
+  gen_record(f, func, "end")
+  f.write("\n")
+
+  if func in kernel_id_list:
+    f.write("  record.AddArg(collector->GetKernelId());\n")
+    f.write("\n")
+
+  if result == "cl_int":
+    f.write("  cl_int* error = " +
+            "reinterpret_cast<cl_int*>(data->functionReturnValue);\n")
+    f.write("  PTI_ASSERT(error != nullptr);\n")
+    f.write("\n")
+    f.write("  record.AddArg(*error);\n")
+    f.write("\n")
+  elif result != "void":
+    if has_error_code(params):
+      gen_params(f, func)
+      f.write("\n")
+    f.write("  " + result + "* result =\n")
+    f.write("    reinterpret_cast<" + result +
+            "*>(data->functionReturnValue);\n")
+    f.write("  PTI_ASSERT(result != nullptr);\n")
+    f.write("  record.AddArg(*result);\n")
+    f.write("\n")
+    if has_error_code(params):
+      f.write("  PTI_ASSERT(*(params->errcodeRet) != nullptr);\n")
+      f.write("  record.AddArg(**(params->errcodeRet));\n")
+      f.write("\n")
+
+  f.write("  collector->Log(record);\n")
+  f.write("}\n")
+
+def gen_callbacks(f, func_list, param_map, result_map):
+  for func in func_list:
+    assert func in param_map, func
+    gen_enter_callback(f, func, param_map[func])
+    f.write("\n")
+    gen_exit_callback(
+        f, func, param_map[func], result_map.get(func, "cl_int"))
+    f.write("\n")
+
+def gen_dispatcher(f, name, args, func_list, suffix, call_args, collector):
+  f.write("static void " + name + "(\n")
+  f.write(args)
+  if collector:
+    f.write("  PTI_ASSERT(collector != nullptr);\n")
+  f.write("  switch (function) {\n")
+  for func in func_list:
+    f.write("    case CL_FUNCTION_" + func + ":\n")
+    write_wrapped(f, "      " + func + suffix + "(",
+                  call_args + ");", "          ")
+    f.write("      break;\n")
+  f.write("    default:\n")
+  f.write("      break;\n")
+  f.write("  }\n")
+  f.write("}\n")
+  f.write("\n")
+
+def gen_string_format(f, name):
+  var_name = get_var_name(name)
+  f.write("  const char* " + var_name + " = record.GetString();\n")
+  f.write("  if (" + var_name + " == nullptr) {\n")
+  f.write("    stream << \" " + name + " = \" << \"0\";\n")
+  f.write("  } else if (strlen(" + var_name + ") == 0) {\n")
+  f.write("    stream << \" " + name + " = \\\"\\\"\";\n")
+  f.write("  } else {\n")
+  f.write("    stream << \" " + name + " = \\\"\" << " + var_name +
+          " << \"\\\"\";\n")
+  f.write("  }\n")
+
+def gen_array_format(f, name, param_type, count_type):
+  var_name = get_var_name(name) + "_count"
+  item_type = get_item_type(param_type)
+  f.write("  " + count_type + " " + var_name + " = record.GetArg<" +
+          count_type + ">();\n")
+  f.write("  if (" + var_name + " > 0) {\n")
+  f.write("    stream << \" {\" << record.GetArg<" + item_type + ">();\n")
+  f.write("    for (" + count_type + " i = 1; i < " + var_name +
+          "; ++i) {\n")
+  f.write("      stream << \", \" << record.GetArg<" + item_type + ">();\n")
+  f.write("    }\n")
+  f.write("    stream << \"}\";\n")
+  f.write("  }\n")
+
+def gen_enter_format(f, func, params):
+  f.write("static void " + func + "FormatEnter(\n")
+  f.write("    ClCallRecordReader& record, std::ostream& stream) {\n")
+  for name, param_type in params:
+    if not is_string(param_type):
+      f.write("  using Params = cl_params_" + func + ";\n")
+      break
+  param_types = dict(params)
+  arrays = array_map.get(func, {})
+  for name, param_type in params:
+    if is_string(param_type):
+      gen_string_format(f, name)
+      continue
+    write_wrapped(f, "  stream << \" " + name + " = \" <<",
+                  "record.GetArg(&Params::" + name + ");", "    ")
+    if name in arrays:
+      gen_array_format(
+          f, name, param_type, param_types[arrays[name]])
+  f.write("}\n")
+
+def gen_exit_format(f, func, params, result):
+  f.write("static void " + func + "FormatExit(\n")
+  f.write("    ClCallRecordReader& record, std::ostream& stream) {\n")
+  if func in kernel_id_list:
+    f.write("  uint64_t kernel_id = record.GetArg<uint64_t>();\n")
+    f.write("  if (kernel_id > 0) {\n")
+    f.write("    stream << \"(\" << kernel_id << \")\";\n")
+    f.write("  }\n")
+  f.write("  stream << \" [\" << (record.GetEnd() - record.GetStart()) " +
+          "<< \" ns]\";\n")
+  if result != "cl_int" and result != "void":
+    f.write("  stream << \" result = \" << record.GetArg<" + result +
+            ">();\n")
+  if result == "cl_int" or has_error_code(params):
+    f.write("  cl_int error = record.GetArg<cl_int>();\n")
+    f.write("  stream << \" -> \" << utils::cl::GetErrorString(error);\n")
+    f.write("  stream << \" (\" << error << \")\";\n")
+  f.write("}\n")
+
+def gen_formatters(f, func_list, param_map, result_map):
+  for func in func_list:
+    gen_enter_format(f, func, param_map[func])
+    f.write("\n")
+    gen_exit_format(
+        f, func, param_map[func], result_map.get(func, "cl_int"))
+    f.write("\n")
+
+def gen_function_name(f, func_list):
+  f.write("static const char* GetFunctionName(cl_function_id function) {\n")
+  f.write("  switch (function) {\n")
+  for func in func_list:
+    f.write("    case CL_FUNCTION_" + func + ":\n")
+    f.write("      return \"" + func + "\";\n")
+  f.write("    default:\n")
+  f.write("      break;\n")
+  f.write("  }\n")
+  f.write("  return nullptr;\n")
+  f.write("}\n")
+  f.write("\n")
+
+def gen_function_subsets(f, func_list):
+  f.write("// API subsets the function belongs to, see API_SUBSET_*\n")
+  f.write("static uint32_t GetFunctionSubsets(cl_function_id function) {\n")
+  f.write("  switch (function) {\n")
+  subset_funcs = {}
+  for func in func_list:
+    subsets = get_subsets(func)
+    if subsets:
+      subset_funcs.setdefault(subsets, []).append(func)
+  for subsets in sorted(subset_funcs.keys()):
+    for func in subset_funcs[subsets]:
+      f.write("    case CL_FUNCTION_" + func + ":\n")
+    f.write("      return " + subsets + ";\n")
+  f.write("    default:\n")
+  f.write("      break;\n")
+  f.write("  }\n")
+  f.write("  return 0;\n")
+  f.write("}\n")
+
+def gen_header(f, func_list, param_map, result_map):
+  f.write("//==============================================================\n")
+  f.write("// Copyright (C) Intel Corporation\n")
+  f.write("//\n")
+  f.write("// SPDX-License-Identifier: MIT\n")
+  f.write("// =============================================================\n")
+  f.write("\n")
+  f.write("// Generated with gen_tracing_callbacks.py, do not edit\n")
+  f.write("\n")
+  f.write("#ifndef PTI_TOOLS_CL_TRACER_CL_API_CALLBACKS_H_\n")
+  f.write("#define PTI_TOOLS_CL_TRACER_CL_API_CALLBACKS_H_\n")
+  f.write("\n")
+  f.write("#include <sstream>\n")
+  f.write("\n")
+  f.write("static thread_local cl_int current_error = CL_SUCCESS;\n")
+  f.write("\n")
+  gen_callbacks(f, func_list, param_map, result_map)
+  gen_dispatcher(f, "OnEnterFunction",
+                 "    cl_function_id function, cl_callback_data* data,\n" +
+                 "    uint64_t start, ClApiCollector* collector) {\n",
+                 func_list, "OnEnter", "data, start, collector", True)
+  gen_dispatcher(f, "OnExitFunction",
+                 "    cl_function_id function, cl_callback_data* data,\n" +
+                 "    uint64_t start, uint64_t end, " +
+                 "ClApiCollector* collector) {\n",
+                 func_list, "OnExit", "data, start, end, collector",
+                 True)
+  gen_formatters(f, func_list, param_map, result_map)
+  gen_dispatcher(f, "FormatEnterFunction",
+                 "    cl_function_id function, ClCallRecordReader& record,\n" +
+                 "    std::ostream& stream) {\n",
+                 func_list, "FormatEnter", "record, stream", False)
+  gen_dispatcher(f, "FormatExitFunction",
+                 "    cl_function_id function, ClCallRecordReader& record,\n" +
+                 "    std::ostream& stream) {\n",
+                 func_list, "FormatExit", "record, stream", False)
+  gen_function_name(f, func_list)
+  gen_function_subsets(f, func_list)
+  f.write("\n")
+  f.write("#endif // PTI_TOOLS_CL_TRACER_CL_API_CALLBACKS_H_\n")
+
+def main():
+  if len(sys.argv) < 3:
+    print("Usage: python gen_tracing_callbacks.py <output_include_path> " +
+          "<cl_include_path>")
+    return
+
+  dst_path = sys.argv[1]
+  if (not os.path.exists(dst_path)):
+    os.mkdir(dst_path)
+
+  dst_file_path = os.path.join(dst_path, "cl_api_callbacks.h")
+  if (os.path.isfile(dst_file_path)):
+    os.remove(dst_file_path)
+
+  cl_path = os.path.join(sys.argv[2], "CL")
+  tracing_file = open(os.path.join(cl_path, "tracing_types.h"), "rt")
+  func_list = get_func_list(tracing_file)
+  param_map = get_param_map(tracing_file)
+  result_map = get_result_map(cl_path)
+  tracing_file.close()
+
+  dst_file = open(dst_file_path, "wt")
+  gen_header(dst_file, func_list, param_map, result_map)
+  dst_file.close()
+
+if __name__ == "__main__":
+  main()
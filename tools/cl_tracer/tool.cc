@@ -36,6 +36,22 @@ void Usage() {
     "--device-timing-verbose [-v]   " <<
     "Report kernels execution time with SIMD width and global/local sizes" <<
     std::endl;
+  std::cout <<
+    "--queue-timing                 " <<
+    "Report busy/idle time and submission latency per queue and engine" <<
+    std::endl;
+  std::cout <<
+    "--dependency-graph             " <<
+    "Report critical path and unused parallelism of command dependencies" <<
+    std::endl;
+  std::cout <<
+    "--call-stacks                  " <<
+    "Report kernel time per host call stack of the launch" <<
+    std::endl;
+  std::cout <<
+    "--wait-analysis                " <<
+    "Report host time blocked in synchronization calls and its commands" <<
+    std::endl;
   std::cout <<
     "--device-timeline [-t]         " <<
     "Trace device activities" <<
@@ -68,6 +84,83 @@ void Usage() {
     "--pid                          " <<
     "Print process ID into host API and device activity trace" <<
     std::endl;
+  std::cout <<
+    "--async-logging                " <<
+    "Write logs and traces from a background thread" <<
+    std::endl;
+  std::cout <<
+    "--log-buffer-size <KB>         " <<
+    "Per-thread buffer size for asynchronous logging" <<
+    std::endl;
+  std::cout <<
+    "--compress <method>            " <<
+    "Compress log and timeline files in frames (zstd|lz4)" <<
+    std::endl;
+  std::cout <<
+    "--binary-trace                 " <<
+    "Dump host and device activities to binary file" <<
+    std::endl;
+  std::cout <<
+    "--node-trace                   " <<
+    "Send binary trace to node trace daemon if it runs" <<
+    std::endl;
+  std::cout <<
+    "--perfetto-trace               " <<
+    "Dump host and device activities to Perfetto file" <<
+    std::endl;
+  std::cout <<
+    "--include-api <patterns>       " <<
+    "Trace only API functions matching the patterns" <<
+    std::endl;
+  std::cout <<
+    "--exclude-api <patterns>       " <<
+    "Do not trace API functions matching the patterns" <<
+    std::endl;
+  std::cout <<
+    "--kernel-sampling <N|rate>     " <<
+    "Trace every N-th or random share of kernel launches" <<
+    std::endl;
+  std::cout <<
+    "--kernel-grouping <mode>       " <<
+    "Group kernel table rows by name, local size or full launch config " <<
+    "(name|local|config)" <<
+    std::endl;
+  std::cout <<
+    "--capture-delay <ms>           " <<
+    "Start capture after the given delay" <<
+    std::endl;
+  std::cout <<
+    "--capture-duration <ms>        " <<
+    "Stop capture after the given duration" <<
+    std::endl;
+  std::cout <<
+    "--capture-kernel <name>        " <<
+    "Start capture after the kernel launch" <<
+    std::endl;
+  std::cout <<
+    "--capture-kernel-count <N>     " <<
+    "Start capture after N-th kernel launch" <<
+    std::endl;
+  std::cout <<
+    "--capture-file <path>          " <<
+    "Capture while the given file exists" <<
+    std::endl;
+  std::cout <<
+    "--capture-signal               " <<
+    "Start/stop capture on SIGUSR1/SIGUSR2" <<
+    std::endl;
+  std::cout <<
+    "--interval <sec>               " <<
+    "Store timing statistics per time window to CSV file" <<
+    std::endl;
+  std::cout <<
+    "--save-tables                  " <<
+    "Store timing tables to JSON file for run-to-run comparison" <<
+    std::endl;
+  std::cout <<
+    "--overhead                     " <<
+    "Report time spent by the tool itself" <<
+    std::endl;
   std::cout <<
     "--version                      " <<
     "Print version" <<
@@ -97,6 +190,18 @@ int ParseArgs(int argc, char* argv[]) {
                strcmp(argv[i], "-v") == 0) {
       utils::SetEnv("CLT_DeviceTimingVerbose", "1");
       ++app_index;
+    } else if (strcmp(argv[i], "--queue-timing") == 0) {
+      utils::SetEnv("CLT_QueueTiming", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--dependency-graph") == 0) {
+      utils::SetEnv("CLT_DependencyGraph", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--call-stacks") == 0) {
+      utils::SetEnv("CLT_CallStacks", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--wait-analysis") == 0) {
+      utils::SetEnv("CLT_WaitAnalysis", "1");
+      ++app_index;
     } else if (strcmp(argv[i], "--device-timeline") == 0 ||
                strcmp(argv[i], "-t") == 0) {
       utils::SetEnv("CLT_DeviceTimeline", "1");
@@ -129,6 +234,161 @@ int ParseArgs(int argc, char* argv[]) {
     } else if (strcmp(argv[i], "--pid") == 0) {
       utils::SetEnv("CLT_Pid", "1");
       ++app_index;
+    } else if (strcmp(argv[i], "--async-logging") == 0) {
+      utils::SetEnv("CLT_AsyncLogging", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--log-buffer-size") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Log buffer size is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Log buffer size is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_LogBufferSize", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--compress") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Compression method is not specified" <<
+          std::endl;
+        return -1;
+      }
+      if (!StreamCompressor::IsMethod(argv[i])) {
+        std::cout << "[ERROR] Compression method is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_Compression", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--binary-trace") == 0) {
+      utils::SetEnv("CLT_BinaryTrace", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--node-trace") == 0) {
+      utils::SetEnv("CLT_BinaryTrace", "1");
+      utils::SetEnv("CLT_NodeTrace", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--perfetto-trace") == 0) {
+      utils::SetEnv("CLT_PerfettoTrace", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--include-api") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Included API patterns are not specified" <<
+          std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_IncludeApi", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--exclude-api") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Excluded API patterns are not specified" <<
+          std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_ExcludeApi", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--kernel-sampling") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Kernel sampling is not specified" << std::endl;
+        return -1;
+      }
+      if (!KernelSampler::IsValid(argv[i])) {
+        std::cout << "[ERROR] Kernel sampling is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_KernelSampling", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--kernel-grouping") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Kernel grouping is not specified" << std::endl;
+        return -1;
+      }
+      KernelGrouping grouping = KERNEL_GROUPING_NAME;
+      if (!KernelStatistics::ParseGrouping(argv[i], &grouping)) {
+        std::cout << "[ERROR] Kernel grouping is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_KernelGrouping", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-delay") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture delay is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture delay is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_CaptureDelay", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-duration") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture duration is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture duration is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_CaptureDuration", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-kernel") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture kernel is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_CaptureKernel", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-kernel-count") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture kernel count is not specified" <<
+          std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture kernel count is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_CaptureKernelCount", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-file") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture file is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_CaptureFile", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-signal") == 0) {
+      utils::SetEnv("CLT_CaptureSignal", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--interval") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Interval is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Interval is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("CLT_Interval", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--save-tables") == 0) {
+      utils::SetEnv("CLT_SaveTables", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--overhead") == 0) {
+      utils::SetEnv("PTI_OVERHEAD", "1");
+      ++app_index;
     } else if (strcmp(argv[i], "--version") == 0) {
 #ifdef PTI_VERSION
       std::cout << TOSTRING(PTI_VERSION) << std::endl;
@@ -167,72 +427,164 @@ void SetToolEnv() {}
 
 static TraceOptions ReadArgs() {
   std::string value;
-  uint32_t flags = 0;
+  uint64_t flags = 0;
   std::string log_file;
+  std::string include_api;
+  std::string exclude_api;
+  std::string kernel_sampling;
+  std::string kernel_grouping;
+  std::string compression;
+  uint32_t log_buffer_size = 0;
+  uint32_t stats_interval = 0;
 
   value = utils::GetEnv("CLT_CallLogging");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CALL_LOGGING);
+    flags |= (1ull << TRACE_CALL_LOGGING);
   }
 
   value = utils::GetEnv("CLT_HostTiming");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_HOST_TIMING);
+    flags |= (1ull << TRACE_HOST_TIMING);
   }
 
   value = utils::GetEnv("CLT_DeviceTiming");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_DEVICE_TIMING);
+    flags |= (1ull << TRACE_DEVICE_TIMING);
   }
 
   value = utils::GetEnv("CLT_DeviceTimingVerbose");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_DEVICE_TIMING_VERBOSE);
+    flags |= (1ull << TRACE_DEVICE_TIMING_VERBOSE);
+  }
+
+  value = utils::GetEnv("CLT_QueueTiming");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_QUEUE_TIMING);
+  }
+
+  value = utils::GetEnv("CLT_DependencyGraph");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_DEPENDENCY_GRAPH);
+  }
+
+  value = utils::GetEnv("CLT_CallStacks");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_CALL_STACKS);
+  }
+
+  value = utils::GetEnv("CLT_WaitAnalysis");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_WAIT_ANALYSIS);
+  }
+
+  value = utils::GetEnv("CLT_Interval");
+  if (!value.empty()) {
+    flags |= (1ull << TRACE_INTERVAL_STATS);
+    stats_interval = std::stoul(value);
+  }
+
+  value = utils::GetEnv("CLT_SaveTables");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_SAVE_TABLES);
   }
 
   value = utils::GetEnv("CLT_DeviceTimeline");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_DEVICE_TIMELINE);
+    flags |= (1ull << TRACE_DEVICE_TIMELINE);
   }
 
   value = utils::GetEnv("CLT_LogToFile");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_LOG_TO_FILE);
+    flags |= (1ull << TRACE_LOG_TO_FILE);
     log_file = utils::GetEnv("CLT_LogFilename");
     PTI_ASSERT(!log_file.empty());
   }
 
   value = utils::GetEnv("CLT_ChromeCallLogging");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_CALL_LOGGING);
+    flags |= (1ull << TRACE_CHROME_CALL_LOGGING);
   }
 
   value = utils::GetEnv("CLT_ChromeDeviceTimeline");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_DEVICE_TIMELINE);
+    flags |= (1ull << TRACE_CHROME_DEVICE_TIMELINE);
   }
 
   value = utils::GetEnv("CLT_ChromeKernelTimeline");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_KERNEL_TIMELINE);
+    flags |= (1ull << TRACE_CHROME_KERNEL_TIMELINE);
   }
 
   value = utils::GetEnv("CLT_ChromeDeviceStages");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_DEVICE_STAGES);
+    flags |= (1ull << TRACE_CHROME_DEVICE_STAGES);
   }
 
   value = utils::GetEnv("CLT_Tid");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_TID);
+    flags |= (1ull << TRACE_TID);
   }
 
   value = utils::GetEnv("CLT_Pid");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_PID);
+    flags |= (1ull << TRACE_PID);
+  }
+
+  value = utils::GetEnv("CLT_AsyncLogging");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_ASYNC_LOGGING);
+  }
+
+  value = utils::GetEnv("CLT_LogBufferSize");
+  if (!value.empty()) {
+    log_buffer_size = std::stoul(value);
+  }
+
+  value = utils::GetEnv("CLT_Compression");
+  if (!value.empty()) {
+    compression = value;
+  }
+
+  value = utils::GetEnv("CLT_BinaryTrace");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_BINARY_TRACE);
+  }
+
+  value = utils::GetEnv("CLT_NodeTrace");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_NODE_TRACE);
+  }
+
+  value = utils::GetEnv("CLT_PerfettoTrace");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_PERFETTO_TRACE);
+  }
+
+  value = utils::GetEnv("CLT_IncludeApi");
+  if (!value.empty()) {
+    include_api = value;
+  }
+
+  value = utils::GetEnv("CLT_ExcludeApi");
+  if (!value.empty()) {
+    exclude_api = value;
+  }
+
+  value = utils::GetEnv("CLT_KernelSampling");
+  if (!value.empty()) {
+    kernel_sampling = value;
+  }
+
+  value = utils::GetEnv("CLT_KernelGrouping");
+  if (!value.empty()) {
+    kernel_grouping = value;
   }
 
-  return TraceOptions(flags, log_file);
+  return TraceOptions(
+      flags, log_file, log_buffer_size, 0, 0, 0,
+      include_api, exclude_api, kernel_sampling,
+      CaptureOptions::Read("CLT_"), 0, 0, stats_interval,
+      kernel_grouping, compression);
 }
 
 void EnableProfiling() {
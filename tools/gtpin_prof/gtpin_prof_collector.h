@@ -0,0 +1,388 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_GTPIN_PROF_GTPIN_PROF_COLLECTOR_H_
+#define PTI_TOOLS_GTPIN_PROF_GTPIN_PROF_COLLECTOR_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gtpin_kernel_selector.h"
+#include "gtpin_prof_options.h"
+#include "gtpin_readback.h"
+#include "gtpin_utils.h"
+
+struct GTPinPerfMonRecord {
+  uint32_t freq;
+  uint32_t cycles;
+  uint32_t pm;
+  uint32_t skipped;
+};
+
+// Counters are laid out by block ordinal at build time and are only
+// updated by the readback threads
+struct GTPinKernelProfile {
+  std::string name;
+  std::vector<uint8_t> binary;
+  std::vector<int32_t> offset_list;
+  std::vector<GTPinMem> count_memory_list; // One per block
+  std::vector<uint32_t> perfmon_block_list; // Ordinals of measured blocks
+  std::vector<GTPinMem> perfmon_memory_list;
+  std::unique_ptr<std::atomic<uint64_t>[]> execution_list;
+  std::unique_ptr<std::atomic<uint64_t>[]> cycles_list;
+  std::unique_ptr<std::atomic<uint64_t>[]> pm_list;
+  std::atomic<uint32_t> profiled_count{0};
+};
+
+struct GTPinBlockResult {
+  int32_t offset;
+  uint64_t execution_count; // Summed over the profiled launches
+  uint64_t cycles;
+  uint64_t pm;
+};
+
+struct GTPinKernelResult {
+  std::string name;
+  std::vector<uint8_t> binary;
+  uint32_t launch_count;
+  uint32_t profiled_count;
+  std::vector<GTPinBlockResult> block_list;
+};
+
+using GTPinKernelProfileMap = std::map<GTPinKernel, GTPinKernelProfile*>;
+using GTPinKernelResultList = std::vector<GTPinKernelResult>;
+
+// Instruments the kernels and launches chosen by GTPinKernelSelector only
+class GTPinProfCollector {
+ public: // Interface
+  static GTPinProfCollector* Create(const GTPinProfOptions& options) {
+    GTPinProfCollector* collector = new GTPinProfCollector(options);
+    PTI_ASSERT(collector != nullptr);
+    return collector;
+  }
+
+  ~GTPinProfCollector() {
+    if (count_readback_ != nullptr) {
+      delete count_readback_;
+    }
+    if (perfmon_readback_ != nullptr) {
+      delete perfmon_readback_;
+    }
+    for (auto& profile : kernel_profile_map_) {
+      delete profile.second;
+    }
+  }
+
+  // Kernels are ordered by name
+  GTPinKernelResultList GetResultList() const {
+    if (count_readback_ != nullptr) {
+      count_readback_->Flush();
+    }
+    if (perfmon_readback_ != nullptr) {
+      perfmon_readback_->Flush();
+    }
+
+    std::multimap<std::string, GTPinKernelResult> result_map;
+    const std::lock_guard<std::mutex> lock(lock_);
+    for (auto& item : kernel_profile_map_) {
+      const GTPinKernelProfile* profile = item.second;
+      PTI_ASSERT(profile != nullptr);
+
+      GTPinKernelResult result{
+          profile->name, profile->binary,
+          selector_.GetLaunchCount(item.first),
+          profile->profiled_count.load(std::memory_order_relaxed)};
+      for (size_t i = 0; i < profile->offset_list.size(); ++i) {
+        result.block_list.push_back({
+            profile->offset_list[i],
+            profile->execution_list[i].load(std::memory_order_relaxed),
+            profile->cycles_list[i].load(std::memory_order_relaxed),
+            profile->pm_list[i].load(std::memory_order_relaxed)});
+      }
+      result_map.emplace(profile->name, std::move(result));
+    }
+
+    GTPinKernelResultList result_list;
+    for (auto& result : result_map) {
+      result_list.push_back(std::move(result.second));
+    }
+    return result_list;
+  }
+
+  GTPinProfCollector(const GTPinProfCollector& copy) = delete;
+  GTPinProfCollector& operator=(const GTPinProfCollector& copy) = delete;
+
+ private: // Implementation Details
+  explicit GTPinProfCollector(const GTPinProfOptions& options)
+      : options_(options),
+        selector_(options.GetKernelInclude(), options.GetKernelExclude(),
+                  options.GetLaunchLimit()) {
+    if (options_.CheckFlag(GTPIN_PROF_INST_COUNT)) {
+      count_readback_ = GTPinReadback::Create(
+          sizeof(uint32_t), OnCountSnapshot, this);
+    }
+    if (options_.CheckFlag(GTPIN_PROF_PERFMON)) {
+      perfmon_readback_ = GTPinReadback::Create(
+          sizeof(GTPinPerfMonRecord), OnPerfMonSnapshot, this);
+    }
+
+    utils::gtpin::KnobAddBool("silent_warnings", false);
+    if (options_.CheckFlag(GTPIN_PROF_PERFMON)) {
+      utils::gtpin::KnobAddInt("allow_sregs", 0);
+      utils::gtpin::KnobAddInt("use_global_ra", 1);
+    }
+
+    GTPin_OnKernelBuild(OnKernelBuild, this);
+    GTPin_OnKernelRun(OnKernelRun, this);
+    GTPin_OnKernelComplete(OnKernelComplete, this);
+
+    GTPIN_Start();
+  }
+
+  void AddKernelProfile(GTPinKernel kernel, GTPinKernelProfile* profile) {
+    PTI_ASSERT(profile != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    PTI_ASSERT(kernel_profile_map_.count(kernel) == 0);
+    kernel_profile_map_[kernel] = profile;
+  }
+
+  // Profiles are never removed before the collector is destroyed, so the
+  // pointer stays valid without the lock
+  GTPinKernelProfile* GetKernelProfile(GTPinKernel kernel) const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    auto it = kernel_profile_map_.find(kernel);
+    if (it == kernel_profile_map_.end()) {
+      return nullptr;
+    }
+    return it->second;
+  }
+
+  void InstrumentPerfMon(GTPinKernel kernel, GTPinKernelProfile* profile) {
+    PTI_ASSERT(profile != nullptr);
+    GTPINTOOL_STATUS status = GTPINTOOL_STATUS_SUCCESS;
+    uint32_t num_regs = GTPin_PerfmonAvailableRegInstrument(kernel);
+
+    uint32_t block_id = 0;
+    for (GTPinBBL block = GTPin_BBLHead(kernel); GTPin_BBLValid(block);
+         block = GTPin_BBLNext(block), ++block_id) {
+      GTPinINS head = GTPin_InsHead(block);
+      GTPinINS tail = GTPin_InsTail(block);
+      PTI_ASSERT(GTPin_InsValid(head) && GTPin_InsValid(tail));
+
+      if (GTPin_InsIsEOT(head)) {
+        continue;
+      }
+
+      if (GTPin_InsIsChangingIP(tail)) {
+        if (head == tail) {
+          continue;
+        }
+        tail = GTPin_InsPrev(tail);
+        PTI_ASSERT(GTPin_InsValid(tail));
+      }
+
+      status = GTPin_PerfmonInstrumentPre(head);
+      PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+
+      GTPinMem mem = nullptr;
+      status = GTPin_MemClaim(kernel, sizeof(GTPinPerfMonRecord), &mem);
+      PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+
+      status = GTPin_PerfmonInstrumentPost_Mem(tail, mem, num_regs);
+      PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+
+      profile->perfmon_block_list.push_back(block_id);
+      profile->perfmon_memory_list.push_back(mem);
+
+      if (num_regs > 0) {
+        --num_regs;
+      }
+    }
+  }
+
+  static std::unique_ptr<std::atomic<uint64_t>[]> MakeCounters(
+      size_t count) {
+    std::unique_ptr<std::atomic<uint64_t>[]> counters(
+        new std::atomic<uint64_t>[count]);
+    for (size_t i = 0; i < count; ++i) {
+      counters[i].store(0, std::memory_order_relaxed);
+    }
+    return counters;
+  }
+
+ private: // Callbacks
+  static void OnKernelBuild(GTPinKernel kernel, void* data) {
+    GTPINTOOL_STATUS status = GTPINTOOL_STATUS_SUCCESS;
+
+    GTPinProfCollector* collector =
+      reinterpret_cast<GTPinProfCollector*>(data);
+    PTI_ASSERT(collector != nullptr);
+
+    char kernel_name[MAX_STR_SIZE];
+    status = GTPin_KernelGetName(kernel, MAX_STR_SIZE, kernel_name, nullptr);
+    PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+
+    if (!collector->selector_.OnBuild(kernel, kernel_name)) {
+      return;
+    }
+
+    GTPinKernelProfile* profile = new GTPinKernelProfile;
+    PTI_ASSERT(profile != nullptr);
+    profile->name = kernel_name;
+
+    bool inst_count =
+      collector->options_.CheckFlag(GTPIN_PROF_INST_COUNT);
+    for (GTPinBBL block = GTPin_BBLHead(kernel); GTPin_BBLValid(block);
+         block = GTPin_BBLNext(block)) {
+      GTPinINS head = GTPin_InsHead(block);
+      PTI_ASSERT(GTPin_InsValid(head));
+      profile->offset_list.push_back(GTPin_InsOffset(head));
+
+      if (inst_count) {
+        GTPinMem mem = nullptr;
+        status = GTPin_MemClaim(kernel, sizeof(uint32_t), &mem);
+        PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+        PTI_ASSERT(mem != nullptr);
+
+        status = GTPin_OpcodeprofInstrument(head, mem);
+        PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+
+        profile->count_memory_list.push_back(mem);
+      }
+    }
+
+    if (profile->offset_list.empty()) {
+      delete profile;
+      return;
+    }
+
+    if (collector->options_.CheckFlag(GTPIN_PROF_PERFMON)) {
+      collector->InstrumentPerfMon(kernel, profile);
+    }
+
+    size_t block_count = profile->offset_list.size();
+    profile->execution_list = MakeCounters(block_count);
+    profile->cycles_list = MakeCounters(block_count);
+    profile->pm_list = MakeCounters(block_count);
+
+    uint32_t kernel_binary_size = 0;
+    status = GTPin_GetKernelBinary(kernel, 0, nullptr, &kernel_binary_size);
+    PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+    PTI_ASSERT(kernel_binary_size > 0);
+
+    profile->binary.resize(kernel_binary_size);
+    status = GTPin_GetKernelBinary(
+        kernel, kernel_binary_size,
+        reinterpret_cast<char*>(profile->binary.data()), nullptr);
+    PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+
+    collector->AddKernelProfile(kernel, profile);
+  }
+
+  static void OnKernelRun(GTPinKernelExec kernel_exec, void* data) {
+    GTPinProfCollector* collector =
+      reinterpret_cast<GTPinProfCollector*>(data);
+    PTI_ASSERT(collector != nullptr);
+
+    collector->selector_.OnRun(kernel_exec);
+  }
+
+  static void OnKernelComplete(GTPinKernelExec kernel_exec, void* data) {
+    GTPinProfCollector* collector =
+      reinterpret_cast<GTPinProfCollector*>(data);
+    PTI_ASSERT(collector != nullptr);
+
+    if (!collector->selector_.OnComplete(kernel_exec)) {
+      return;
+    }
+
+    GTPinKernel kernel = GTPin_KernelExec_GetKernel(kernel_exec);
+    GTPinKernelProfile* profile = collector->GetKernelProfile(kernel);
+    if (profile == nullptr) {
+      return;
+    }
+
+    if (!profile->count_memory_list.empty()) {
+      PTI_ASSERT(collector->count_readback_ != nullptr);
+      collector->count_readback_->Enqueue(
+          profile, profile->count_memory_list);
+    }
+    if (!profile->perfmon_memory_list.empty()) {
+      PTI_ASSERT(collector->perfmon_readback_ != nullptr);
+      collector->perfmon_readback_->Enqueue(
+          profile, profile->perfmon_memory_list);
+    }
+
+    profile->profiled_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Called on readback thread
+  static void OnCountSnapshot(const GTPinSnapshot& snapshot, void* data) {
+    GTPinKernelProfile* profile =
+      reinterpret_cast<GTPinKernelProfile*>(snapshot.owner);
+    PTI_ASSERT(profile != nullptr);
+    PTI_ASSERT(snapshot.thread_count_list.size() ==
+               profile->offset_list.size());
+
+    const uint32_t* value =
+      reinterpret_cast<const uint32_t*>(snapshot.data.data());
+    for (size_t i = 0; i < snapshot.thread_count_list.size(); ++i) {
+      uint64_t total = 0;
+      for (uint32_t tid = 0; tid < snapshot.thread_count_list[i]; ++tid) {
+        total += value[tid];
+      }
+      value += snapshot.thread_count_list[i];
+
+      if (total > 0) {
+        profile->execution_list[i].fetch_add(
+            total, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Called on readback thread
+  static void OnPerfMonSnapshot(const GTPinSnapshot& snapshot, void* data) {
+    GTPinKernelProfile* profile =
+      reinterpret_cast<GTPinKernelProfile*>(snapshot.owner);
+    PTI_ASSERT(profile != nullptr);
+    PTI_ASSERT(snapshot.thread_count_list.size() ==
+               profile->perfmon_block_list.size());
+
+    const GTPinPerfMonRecord* value =
+      reinterpret_cast<const GTPinPerfMonRecord*>(snapshot.data.data());
+    for (size_t i = 0; i < snapshot.thread_count_list.size(); ++i) {
+      uint64_t total_cycles = 0, total_pm = 0;
+      for (uint32_t tid = 0; tid < snapshot.thread_count_list[i]; ++tid) {
+        total_cycles += value[tid].cycles;
+        total_pm += value[tid].pm;
+      }
+      value += snapshot.thread_count_list[i];
+
+      uint32_t block_id = profile->perfmon_block_list[i];
+      PTI_ASSERT(block_id < profile->offset_list.size());
+      profile->cycles_list[block_id].fetch_add(
+          total_cycles, std::memory_order_relaxed);
+      profile->pm_list[block_id].fetch_add(
+          total_pm, std::memory_order_relaxed);
+    }
+  }
+
+ private: // Data
+  GTPinProfOptions options_;
+  GTPinKernelSelector selector_;
+
+  GTPinReadback* count_readback_ = nullptr;
+  GTPinReadback* perfmon_readback_ = nullptr;
+
+  mutable std::mutex lock_;
+  GTPinKernelProfileMap kernel_profile_map_;
+};
+
+#endif // PTI_TOOLS_GTPIN_PROF_GTPIN_PROF_COLLECTOR_H_
\ No newline at end of file
@@ -0,0 +1,103 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_GTPIN_PROF_GTPIN_PROF_OPTIONS_H_
+#define PTI_TOOLS_GTPIN_PROF_GTPIN_PROF_OPTIONS_H_
+
+#include <sstream>
+#include <string>
+
+#include "pti_assert.h"
+#include "utils.h"
+
+#define GTPIN_PROF_INST_COUNT   0
+#define GTPIN_PROF_PERFMON      1
+#define GTPIN_PROF_SOURCE_LINES 2
+
+class GTPinProfOptions {
+ public:
+  GTPinProfOptions(
+      uint32_t flags,
+      uint32_t launch_limit,
+      const std::string& kernel_include,
+      const std::string& kernel_exclude,
+      const std::string& binary_file,
+      const std::string& log_file)
+      : flags_(flags),
+        launch_limit_(launch_limit),
+        kernel_include_(kernel_include),
+        kernel_exclude_(kernel_exclude),
+        binary_file_(binary_file),
+        log_file_(log_file) {}
+
+  bool CheckFlag(uint32_t flag) const {
+    return (flags_ & (1 << flag));
+  }
+
+  uint32_t GetFlags() const {
+    return flags_;
+  }
+
+  // Zero means no limit
+  uint32_t GetLaunchLimit() const {
+    return launch_limit_;
+  }
+
+  const std::string& GetKernelInclude() const {
+    return kernel_include_;
+  }
+
+  const std::string& GetKernelExclude() const {
+    return kernel_exclude_;
+  }
+
+  std::string GetBinaryFileName() const {
+    return GetFileName(binary_file_);
+  }
+
+  std::string GetLogFileName() const {
+    return GetFileName(log_file_);
+  }
+
+ private:
+  static std::string GetFileName(const std::string& file) {
+    if (file.empty()) {
+      return std::string();
+    }
+
+    std::stringstream result;
+
+    size_t pos = file.find_first_of('.');
+    if (pos == std::string::npos) {
+      result << file;
+    } else {
+      result << file.substr(0, pos);
+    }
+
+    result << "." + std::to_string(utils::GetPid());
+
+    std::string rank = utils::GetEnv("PMI_RANK");
+    if (!rank.empty()) {
+      result << "." + rank;
+    }
+
+    if (pos != std::string::npos) {
+      result << file.substr(pos);
+    }
+
+    return result.str();
+  }
+
+ private:
+  uint32_t flags_;
+  uint32_t launch_limit_;
+  std::string kernel_include_;
+  std::string kernel_exclude_;
+  std::string binary_file_;
+  std::string log_file_;
+};
+
+#endif // PTI_TOOLS_GTPIN_PROF_GTPIN_PROF_OPTIONS_H_
\ No newline at end of file
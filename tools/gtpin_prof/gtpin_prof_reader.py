@@ -0,0 +1,81 @@
+#==============================================================
+# Copyright (C) Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+# =============================================================
+
+# Converts binary results produced with --binary-output option of
+# gtpin_prof into CSV, one line per basic block
+#
+# Usage: python gtpin_prof_reader.py <input.bin> [<output.csv>]
+
+import struct
+import sys
+
+MAGIC = b"PTIGTPRF"
+VERSION = 1
+
+HEADER_FORMAT = "<8sIIII"
+KERNEL_FORMAT = "<IIII"
+BLOCK_FORMAT = "<iIIIIIQQQ"
+
+def read_profile(filename):
+  with open(filename, "rb") as f:
+    data = f.read()
+
+  offset = struct.calcsize(HEADER_FORMAT)
+  if len(data) < offset:
+    raise ValueError("File is too small to be a GTPin profile")
+  magic, version, flags, kernel_count, reserved = \
+    struct.unpack_from(HEADER_FORMAT, data, 0)
+  if magic != MAGIC:
+    raise ValueError("Unknown file format")
+  if version != VERSION:
+    raise ValueError("Unsupported GTPin profile version " + str(version))
+
+  kernels = []
+  kernel_size = struct.calcsize(KERNEL_FORMAT)
+  block_size = struct.calcsize(BLOCK_FORMAT)
+  for i in range(kernel_count):
+    name_size, block_count, launch_count, profiled_count = \
+      struct.unpack_from(KERNEL_FORMAT, data, offset)
+    offset += kernel_size
+    name = data[offset:offset + name_size].decode("utf-8", "replace")
+    offset += name_size
+
+    blocks = []
+    for j in range(block_count):
+      blocks.append(struct.unpack_from(BLOCK_FORMAT, data, offset))
+      offset += block_size
+    kernels.append((name, launch_count, profiled_count, blocks))
+
+  return flags, kernels
+
+def write_csv(kernels, output):
+  output.write("Kernel,Launches,Profiled,Offset,Instructions,Lanes," +
+    "FirstLine,LastLine,Executions,Cycles,PM\n")
+  for name, launch_count, profiled_count, blocks in kernels:
+    for (block_offset, instructions, lanes, first_line, last_line,
+         reserved, executions, cycles, pm) in blocks:
+      output.write("\"" + name + "\"," + str(launch_count) + "," +
+        str(profiled_count) + "," + hex(block_offset) + "," +
+        str(instructions) + "," + str(lanes) + "," +
+        str(first_line) + "," + str(last_line) + "," +
+        str(executions) + "," + str(cycles) + "," + str(pm) + "\n")
+
+def main():
+  if len(sys.argv) < 2:
+    print("Usage: python gtpin_prof_reader.py <input.bin> [<output.csv>]")
+    return 1
+
+  flags, kernels = read_profile(sys.argv[1])
+  if len(sys.argv) > 2:
+    output = open(sys.argv[2], "w")
+    write_csv(kernels, output)
+    output.close()
+  else:
+    write_csv(kernels, sys.stdout)
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
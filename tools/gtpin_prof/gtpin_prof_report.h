@@ -0,0 +1,357 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_GTPIN_PROF_GTPIN_PROF_REPORT_H_
+#define PTI_TOOLS_GTPIN_PROF_GTPIN_PROF_REPORT_H_
+
+#include <ctype.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dwarf_state_machine.h"
+#include "gen_binary_decoder.h"
+#include "gtpin_prof_collector.h"
+#include "gtpin_prof_options.h"
+#include "kernel_binary_cache.h"
+#include "line_info_index.h"
+#include "logger.h"
+
+// Binary result layout (little-endian, see gtpin_prof_reader.py):
+//   GTPinProfHeader
+//   kernel_count times: GTPinProfKernel, char[name_size] (not terminated),
+//   GTPinProfBlock[block_count]
+// Block values are summed over the profiled launches; lines are zero if
+// unknown
+
+#define GTPIN_PROF_VERSION 1
+
+#pragma pack(push, 1)
+struct GTPinProfHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t flags; // GTPIN_PROF_* bits of the collection
+  uint32_t kernel_count;
+  uint32_t reserved;
+};
+
+struct GTPinProfKernel {
+  uint32_t name_size;
+  uint32_t block_count;
+  uint32_t launch_count;
+  uint32_t profiled_count;
+};
+
+struct GTPinProfBlock {
+  int32_t offset;
+  uint32_t instruction_count;
+  uint32_t lane_count; // Sum of execution sizes of the block instructions
+  uint32_t first_line;
+  uint32_t last_line;
+  uint32_t reserved;
+  uint64_t execution_count;
+  uint64_t cycles;
+  uint64_t pm;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(GTPinProfHeader) == 24,
+              "Unexpected GTPin profile header size");
+static_assert(sizeof(GTPinProfBlock) == 48,
+              "Unexpected GTPin profile block size");
+
+const char kGTPinProfMagic[8] = {'P', 'T', 'I', 'G', 'T', 'P', 'R', 'F'};
+
+// Static properties of a block taken from the disassembly and line table
+struct GTPinBlockInfo {
+  uint32_t instruction_count;
+  uint32_t lane_count;
+  uint32_t first_line;
+  uint32_t last_line;
+};
+
+using GTPinBlockInfoList = std::vector<GTPinBlockInfo>;
+using GTPinLineInfoMap = std::map<std::string, std::vector<LineInfo> >;
+
+class GTPinProfReport {
+ public: // Interface
+  // Returns block info lists in the order of the results, lists are empty
+  // for the kernels that can't be disassembled
+  static std::vector<GTPinBlockInfoList> Analyze(
+      const GTPinKernelResultList& result_list,
+      const GTPinLineInfoMap* line_info_map) {
+    std::vector<GTPinBlockInfoList> info_list(result_list.size());
+
+    iga_gen_t arch = utils::gtpin::GetArch(GTPin_GetGenVersion());
+    if (arch == IGA_GEN_INVALID) {
+      std::cerr << "[WARNING] Unknown GPU architecture" << std::endl;
+      return info_list;
+    }
+
+    KernelBinaryCache* cache = KernelBinaryCache::Create();
+    for (size_t i = 0; i < result_list.size(); ++i) {
+      const GTPinKernelResult& result = result_list[i];
+      if (result.profiled_count == 0) {
+        continue;
+      }
+
+      KernelBinaryEntry entry;
+      uint64_t key = KernelBinaryCache::GetKey(result.binary, result.name);
+      if (cache == nullptr || !cache->Load(key, &entry)) {
+        GenBinaryDecoder decoder(result.binary, arch);
+        entry.instruction_list = decoder.Disassemble();
+        if (cache != nullptr) {
+          cache->Store(key, entry);
+        }
+      }
+      if (entry.instruction_list.empty()) {
+        continue;
+      }
+
+      const std::vector<LineInfo>* line_info_list = nullptr;
+      if (line_info_map != nullptr) {
+        auto it = line_info_map->find(result.name);
+        if (it != line_info_map->end()) {
+          line_info_list = &(it->second);
+        }
+      }
+
+      info_list[i] = GetBlockInfoList(
+          result, entry.instruction_list, line_info_list);
+    }
+
+    if (cache != nullptr) {
+      delete cache;
+    }
+    return info_list;
+  }
+
+  static void Print(
+      const GTPinKernelResultList& result_list,
+      const std::vector<GTPinBlockInfoList>& info_list,
+      const GTPinProfOptions& options, Logger* logger) {
+    PTI_ASSERT(result_list.size() == info_list.size());
+    PTI_ASSERT(logger != nullptr);
+
+    for (size_t i = 0; i < result_list.size(); ++i) {
+      if (result_list[i].profiled_count == 0) {
+        continue;
+      }
+      PrintKernel(result_list[i], info_list[i], options, logger);
+    }
+  }
+
+  static void WriteBinary(
+      const std::string& filename,
+      const GTPinKernelResultList& result_list,
+      const std::vector<GTPinBlockInfoList>& info_list,
+      const GTPinProfOptions& options) {
+    PTI_ASSERT(!filename.empty());
+    PTI_ASSERT(result_list.size() == info_list.size());
+
+    std::ofstream file(filename, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+      std::cerr << "[WARNING] Unable to create file " << filename <<
+        std::endl;
+      return;
+    }
+
+    GTPinProfHeader header{};
+    memcpy(header.magic, kGTPinProfMagic, sizeof(header.magic));
+    header.version = GTPIN_PROF_VERSION;
+    header.flags = options.GetFlags();
+    header.kernel_count = static_cast<uint32_t>(result_list.size());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (size_t i = 0; i < result_list.size(); ++i) {
+      const GTPinKernelResult& result = result_list[i];
+
+      GTPinProfKernel kernel{
+          static_cast<uint32_t>(result.name.size()),
+          static_cast<uint32_t>(result.block_list.size()),
+          result.launch_count, result.profiled_count};
+      file.write(reinterpret_cast<const char*>(&kernel), sizeof(kernel));
+      file.write(result.name.data(), result.name.size());
+
+      for (size_t j = 0; j < result.block_list.size(); ++j) {
+        const GTPinBlockResult& block = result.block_list[j];
+        GTPinBlockInfo info = GetInfo(info_list[i], j);
+        GTPinProfBlock value{
+            block.offset, info.instruction_count, info.lane_count,
+            info.first_line, info.last_line, 0,
+            block.execution_count, block.cycles, block.pm};
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+      }
+    }
+
+    file.close();
+    std::cerr << "[INFO] GTPin profile is stored in " << filename <<
+      std::endl;
+  }
+
+ private: // Implementation
+  // Instructions are assigned to the closest block that starts before them
+  static GTPinBlockInfoList GetBlockInfoList(
+      const GTPinKernelResult& result,
+      const std::vector<Instruction>& instruction_list,
+      const std::vector<LineInfo>* line_info_list) {
+    PTI_ASSERT(!instruction_list.empty());
+    const std::vector<GTPinBlockResult>& block_list = result.block_list;
+    GTPinBlockInfoList info_list(block_list.size(), GTPinBlockInfo{});
+    if (block_list.empty()) {
+      return info_list;
+    }
+
+    LineInfoIndex line_index(
+        (line_info_list != nullptr) ?
+          *line_info_list : std::vector<LineInfo>(),
+        instruction_list.back().offset + 1);
+
+    size_t block_id = 0;
+    for (const Instruction& instruction : instruction_list) {
+      while (block_id + 1 < block_list.size() &&
+             instruction.offset >= block_list[block_id + 1].offset) {
+        ++block_id;
+      }
+
+      GTPinBlockInfo& info = info_list[block_id];
+      ++info.instruction_count;
+      info.lane_count += GetExecSize(instruction.text);
+
+      const LineInfo* line_info = line_index.Find(instruction.offset);
+      if (line_info != nullptr && line_info->line > 0) {
+        if (info.first_line == 0 || line_info->line < info.first_line) {
+          info.first_line = line_info->line;
+        }
+        info.last_line = (std::max)(info.last_line, line_info->line);
+      }
+    }
+
+    return info_list;
+  }
+
+  // Execution size is the first "(<N>|" or "(<N>)" group of the IGA text,
+  // e.g. "(W&f0.0) add (16|M0) ...", it is one for non-SIMD instructions
+  static uint32_t GetExecSize(const std::string& text) {
+    size_t pos = text.find('(');
+    while (pos != std::string::npos) {
+      size_t end = pos + 1;
+      while (end < text.size() && isdigit(text[end])) {
+        ++end;
+      }
+      if (end > pos + 1 && end < text.size() &&
+          (text[end] == '|' || text[end] == ')')) {
+        return std::stoul(text.substr(pos + 1, end - pos - 1));
+      }
+      pos = text.find('(', end);
+    }
+    return 1;
+  }
+
+  static GTPinBlockInfo GetInfo(
+      const GTPinBlockInfoList& info_list, size_t block_id) {
+    if (block_id < info_list.size()) {
+      return info_list[block_id];
+    }
+    return GTPinBlockInfo{};
+  }
+
+  static void PrintKernel(
+      const GTPinKernelResult& result, const GTPinBlockInfoList& info_list,
+      const GTPinProfOptions& options, Logger* logger) {
+    PTI_ASSERT(result.profiled_count > 0);
+    bool inst_count = options.CheckFlag(GTPIN_PROF_INST_COUNT);
+    bool perfmon = options.CheckFlag(GTPIN_PROF_PERFMON);
+    bool source_lines = options.CheckFlag(GTPIN_PROF_SOURCE_LINES);
+
+    uint64_t total_cycles = 0;
+    for (const GTPinBlockResult& block : result.block_list) {
+      total_cycles += block.cycles;
+    }
+
+    std::stringstream stream;
+    stream << "=== " << result.name << " (runs " << result.launch_count <<
+      " times, profiled " << result.profiled_count << ") ===" << std::endl;
+
+    stream << std::setw(10) << "Offset" << "," <<
+      std::setw(14) << "Instructions";
+    if (inst_count) {
+      stream << "," << std::setw(14) << "Executions" <<
+        "," << std::setw(20) << "Inst Executed" <<
+        "," << std::setw(20) << "SIMD Lanes";
+    }
+    if (perfmon) {
+      stream << "," << std::setw(20) << "Cycles" <<
+        "," << std::setw(10) << "PM(%)";
+    }
+    if (source_lines) {
+      stream << "," << " Lines";
+    }
+    stream << std::endl;
+
+    // Values are per profiled launch
+    uint64_t total_instructions = 0, total_lanes = 0;
+    for (size_t i = 0; i < result.block_list.size(); ++i) {
+      const GTPinBlockResult& block = result.block_list[i];
+      GTPinBlockInfo info = GetInfo(info_list, i);
+      uint64_t executions = block.execution_count / result.profiled_count;
+      uint64_t instructions = executions * info.instruction_count;
+      uint64_t lanes = executions * info.lane_count;
+      total_instructions += instructions;
+      total_lanes += lanes;
+
+      std::stringstream offset;
+      offset << "0x" << std::setw(4) << std::setfill('0') << std::hex <<
+        std::uppercase << block.offset;
+
+      stream << std::setw(10) << offset.str() << "," <<
+        std::setw(14) << info.instruction_count;
+      if (inst_count) {
+        stream << "," << std::setw(14) << executions <<
+          "," << std::setw(20) << instructions <<
+          "," << std::setw(20) << lanes;
+      }
+      if (perfmon) {
+        stream << "," << std::setw(20) <<
+          block.cycles / result.profiled_count << "," << std::setw(10) <<
+          std::fixed << std::setprecision(2) <<
+          ((total_cycles > 0) ? 100.0 * block.pm / total_cycles : 0.0);
+      }
+      if (source_lines) {
+        stream << ", ";
+        if (info.first_line > 0) {
+          stream << info.first_line;
+          if (info.last_line > info.first_line) {
+            stream << "-" << info.last_line;
+          }
+        } else {
+          stream << "Unknown";
+        }
+      }
+      stream << std::endl;
+    }
+
+    if (inst_count) {
+      stream << "Total instructions executed: " << total_instructions <<
+        ", SIMD lanes: " << total_lanes << std::endl;
+    }
+    if (perfmon) {
+      stream << "Total cycles: " << total_cycles / result.profiled_count <<
+        std::endl;
+    }
+    stream << std::endl;
+
+    logger->Log(stream.str());
+  }
+};
+
+#endif // PTI_TOOLS_GTPIN_PROF_GTPIN_PROF_REPORT_H_
\ No newline at end of file
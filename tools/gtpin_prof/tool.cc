@@ -0,0 +1,266 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include <iostream>
+
+#include "gtpin_prof_report.h"
+#include "ze_debug_info_collector.h"
+
+static GTPinProfOptions* options = nullptr;
+static GTPinProfCollector* collector = nullptr;
+static ZeDebugInfoCollector* debug_info_collector = nullptr;
+
+// External Tool Interface ////////////////////////////////////////////////////
+
+extern "C"
+#if defined(_WIN32)
+__declspec(dllexport)
+#endif
+void Usage() {
+  std::cout <<
+    "Usage: ./gtpin_prof[.exe] [options] <application> <args>" <<
+    std::endl;
+  std::cout << "Options:" << std::endl;
+  std::cout <<
+    "--inst-count [-c]              " <<
+    "Count executed instructions and SIMD lanes per basic block " <<
+    "(default if no other metric is selected)" <<
+    std::endl;
+  std::cout <<
+    "--perfmon [-p]                 " <<
+    "Collect EU cycles per basic block" <<
+    std::endl;
+  std::cout <<
+    "--source-lines [-l]            " <<
+    "Map basic blocks to source lines (Level Zero modules only)" <<
+    std::endl;
+  std::cout <<
+    "--kernel-include <patterns>    " <<
+    "Instrument only the kernels matching comma-separated patterns" <<
+    std::endl;
+  std::cout <<
+    "--kernel-exclude <patterns>    " <<
+    "Do not instrument the kernels matching comma-separated patterns" <<
+    std::endl;
+  std::cout <<
+    "--launch-limit <N>             " <<
+    "Instrument only the first N launches of each kernel" <<
+    std::endl;
+  std::cout <<
+    "--binary-output [-b] <file>    " <<
+    "Store the results into binary file" <<
+    std::endl;
+  std::cout <<
+    "--output [-o] <file>           " <<
+    "Print console logs into the file" <<
+    std::endl;
+  std::cout <<
+    "--version                      " <<
+    "Print version" <<
+    std::endl;
+}
+
+extern "C"
+#if defined(_WIN32)
+__declspec(dllexport)
+#endif
+int ParseArgs(int argc, char* argv[]) {
+  int app_index = 1;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--inst-count") == 0 ||
+        strcmp(argv[i], "-c") == 0) {
+      utils::SetEnv("GTPROF_InstCount", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--perfmon") == 0 ||
+               strcmp(argv[i], "-p") == 0) {
+      utils::SetEnv("GTPROF_PerfMon", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--source-lines") == 0 ||
+               strcmp(argv[i], "-l") == 0) {
+      utils::SetEnv("GTPROF_SourceLines", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--kernel-include") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Kernel patterns are not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("GTPROF_KernelInclude", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--kernel-exclude") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Kernel patterns are not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("GTPROF_KernelExclude", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--launch-limit") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Launch limit is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Launch limit is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("GTPROF_LaunchLimit", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--binary-output") == 0 ||
+               strcmp(argv[i], "-b") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Binary file name is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("GTPROF_BinaryFilename", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--output") == 0 ||
+               strcmp(argv[i], "-o") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Log file name is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("GTPROF_LogFilename", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--version") == 0) {
+#ifdef PTI_VERSION
+      std::cout << TOSTRING(PTI_VERSION) << std::endl;
+#endif
+      return 0;
+    } else {
+      break;
+    }
+  }
+  return app_index;
+}
+
+extern "C"
+#if defined(_WIN32)
+__declspec(dllexport)
+#endif
+void SetToolEnv() {
+  utils::SetEnv("ZE_ENABLE_TRACING_LAYER", "1");
+  utils::SetEnv("ZET_ENABLE_API_TRACING_EXP", "1");
+  utils::SetEnv("ZET_ENABLE_PROGRAM_INSTRUMENTATION", "1");
+}
+
+// Internal Tool Functionality ////////////////////////////////////////////////
+
+static GTPinProfOptions ReadArgs() {
+  std::string value;
+  uint32_t flags = 0;
+  uint32_t launch_limit = 0;
+  std::string kernel_include, kernel_exclude;
+  std::string binary_file, log_file;
+
+  value = utils::GetEnv("GTPROF_InstCount");
+  if (!value.empty()) {
+    flags |= (1 << GTPIN_PROF_INST_COUNT);
+  }
+
+  value = utils::GetEnv("GTPROF_PerfMon");
+  if (!value.empty()) {
+    flags |= (1 << GTPIN_PROF_PERFMON);
+  }
+
+  if (flags == 0) {
+    flags |= (1 << GTPIN_PROF_INST_COUNT);
+  }
+
+  value = utils::GetEnv("GTPROF_SourceLines");
+  if (!value.empty()) {
+    flags |= (1 << GTPIN_PROF_SOURCE_LINES);
+  }
+
+  kernel_include = utils::GetEnv("GTPROF_KernelInclude");
+  kernel_exclude = utils::GetEnv("GTPROF_KernelExclude");
+
+  value = utils::GetEnv("GTPROF_LaunchLimit");
+  if (!value.empty()) {
+    launch_limit = std::stoul(value);
+  }
+
+  binary_file = utils::GetEnv("GTPROF_BinaryFilename");
+  log_file = utils::GetEnv("GTPROF_LogFilename");
+
+  return GTPinProfOptions(
+      flags, launch_limit, kernel_include, kernel_exclude,
+      binary_file, log_file);
+}
+
+static GTPinLineInfoMap GetLineInfoMap() {
+  GTPinLineInfoMap line_info_map;
+  if (debug_info_collector == nullptr) {
+    return line_info_map;
+  }
+
+  for (auto& item : debug_info_collector->GetKernelDebugInfoMap()) {
+    line_info_map[item.first] = item.second.line_info_list;
+  }
+  return line_info_map;
+}
+
+static void PrintResults() {
+  PTI_ASSERT(options != nullptr);
+  PTI_ASSERT(collector != nullptr);
+
+  GTPinKernelResultList result_list = collector->GetResultList();
+  if (result_list.empty()) {
+    std::cerr << "[WARNING] No kernels were instrumented" << std::endl;
+    return;
+  }
+
+  GTPinLineInfoMap line_info_map = GetLineInfoMap();
+  std::vector<GTPinBlockInfoList> info_list = GTPinProfReport::Analyze(
+      result_list,
+      options->CheckFlag(GTPIN_PROF_SOURCE_LINES) ? &line_info_map : nullptr);
+
+  Logger logger(options->GetLogFileName());
+  logger.Log("\n");
+  GTPinProfReport::Print(result_list, info_list, *options, &logger);
+
+  std::string binary_file = options->GetBinaryFileName();
+  if (!binary_file.empty()) {
+    GTPinProfReport::WriteBinary(
+        binary_file, result_list, info_list, *options);
+  }
+}
+
+// Internal Tool Interface ////////////////////////////////////////////////////
+
+void EnableProfiling() {
+  PTI_ASSERT(collector == nullptr);
+  options = new GTPinProfOptions(ReadArgs());
+  PTI_ASSERT(options != nullptr);
+  collector = GTPinProfCollector::Create(*options);
+
+  if (options->CheckFlag(GTPIN_PROF_SOURCE_LINES)) {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    status = zeInit(ZE_INIT_FLAG_GPU_ONLY);
+    if (status == ZE_RESULT_SUCCESS) {
+      debug_info_collector = ZeDebugInfoCollector::Create();
+    }
+  }
+}
+
+void DisableProfiling() {
+  if (debug_info_collector != nullptr) {
+    debug_info_collector->DisableTracing();
+  }
+  if (collector != nullptr) {
+    PrintResults();
+    delete collector;
+  }
+  if (debug_info_collector != nullptr) {
+    delete debug_info_collector;
+  }
+  if (options != nullptr) {
+    delete options;
+  }
+}
\ No newline at end of file
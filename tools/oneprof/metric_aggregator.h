@@ -0,0 +1,384 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ONEPROF_METRIC_AGGREGATOR_H_
+#define PTI_TOOLS_ONEPROF_METRIC_AGGREGATOR_H_
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "pti_assert.h"
+#include "ze_utils.h"
+
+#define METRIC_RETENTION_TIME 1000000000 // ns
+
+enum MetricAggregationType {
+  METRIC_AGGREGATION_NONE = 0,
+  METRIC_AGGREGATION_TOTAL = 1,
+  METRIC_AGGREGATION_AVERAGE = 2,
+  METRIC_AGGREGATION_FIRST = 3
+};
+
+struct MetricAggregate {
+  uint64_t instance_count;
+  uint64_t report_count;
+  uint64_t total_clocks;
+  uint64_t total_time; // Sum of interval durations, ns
+  uint64_t covered_time; // Same for the intervals having reports
+  std::vector<zet_typed_value_t> value_list;
+};
+
+// Per-kernel aggregates for each metric stream. This is a sub-device id
+// for a single metric group, see MetricCollector::GetStreamId otherwise
+using MetricAggregateMap =
+  std::map<std::string, std::vector<MetricAggregate> >;
+
+// Folds metric reports into per-kernel aggregates while they are streamed.
+// Only the reports of the last METRIC_RETENTION_TIME are kept to match
+// kernel intervals that are not yet completed, older ones are dropped, so
+// memory usage doesn't depend on run length. Metrics are aggregated the
+// same way as for post-mortem aggregation: clock-weighted averages for
+// ratios and durations, totals for events and throughputs. If metric
+// groups are multiplexed, intervals are added to the streams of every
+// group and get reports only from the groups active while they run.
+class MetricAggregator {
+ public: // Interface
+  MetricAggregator(
+      const std::vector<std::vector<std::string> >& metric_list,
+      const std::vector<std::vector<zet_metric_type_t> >& metric_type_list)
+      : sub_device_list_(metric_list.size()) {
+    PTI_ASSERT(!metric_list.empty());
+    PTI_ASSERT(metric_list.size() == metric_type_list.size());
+
+    for (size_t i = 0; i < metric_list.size(); ++i) {
+      PTI_ASSERT(!metric_list[i].empty());
+      PTI_ASSERT(metric_list[i].size() == metric_type_list[i].size());
+
+      SubDeviceData& sub_device = sub_device_list_[i];
+      sub_device.report_size = metric_list[i].size();
+      sub_device.time_id = GetMetricId(metric_list[i], "QueryBeginTime");
+      PTI_ASSERT(sub_device.time_id < sub_device.report_size);
+      sub_device.clocks_id = GetMetricId(metric_list[i], "GpuCoreClocks");
+      PTI_ASSERT(sub_device.clocks_id < sub_device.report_size);
+
+      for (size_t j = 0; j < metric_list[i].size(); ++j) {
+        sub_device.type_list.push_back(
+            GetAggregationType(metric_list[i][j], metric_type_list[i][j]));
+      }
+    }
+  }
+
+  void AddReports(
+      uint32_t sub_device_id,
+      const std::vector<zet_typed_value_t>& report_chunk) {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    SubDeviceData& sub_device = sub_device_list_[sub_device_id];
+
+    size_t report_count = report_chunk.size() / sub_device.report_size;
+    PTI_ASSERT(report_count * sub_device.report_size == report_chunk.size());
+    if (report_count == 0) {
+      return;
+    }
+
+    for (size_t i = 0; i < report_count; ++i) {
+      const zet_typed_value_t* report =
+        report_chunk.data() + i * sub_device.report_size;
+      PTI_ASSERT(report[sub_device.time_id].type == ZET_VALUE_TYPE_UINT64);
+      uint64_t time = report[sub_device.time_id].value.ui64;
+
+      sub_device.time_list.push_back(time);
+      sub_device.value_list.insert(
+          sub_device.value_list.end(),
+          report, report + sub_device.report_size);
+      sub_device.last_time = (std::max)(sub_device.last_time, time);
+    }
+
+    // Reports are in time order, so all the reports of the intervals that
+    // ended before the last one are already here
+    auto it = sub_device.pending_list.begin();
+    while (it != sub_device.pending_list.end()) {
+      if (it->end <= sub_device.last_time) {
+        Aggregate(sub_device_id, it->name, it->start, it->end);
+        it = sub_device.pending_list.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    uint64_t limit = 0;
+    if (sub_device.last_time > METRIC_RETENTION_TIME) {
+      limit = sub_device.last_time - METRIC_RETENTION_TIME;
+    }
+    for (auto& interval : sub_device.pending_list) {
+      limit = (std::min)(limit, interval.start);
+    }
+
+    while (!sub_device.time_list.empty() &&
+           sub_device.time_list.front() < limit) {
+      sub_device.dropped_time = sub_device.time_list.front();
+      sub_device.time_list.pop_front();
+      sub_device.value_list.erase(
+          sub_device.value_list.begin(),
+          sub_device.value_list.begin() + sub_device.report_size);
+    }
+  }
+
+  // Interval timestamps are expected in the metric time domain
+  void AddKernelInterval(
+      const std::string& name, uint32_t sub_device_id,
+      uint64_t start, uint64_t end) {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    PTI_ASSERT(start < end);
+    SubDeviceData& sub_device = sub_device_list_[sub_device_id];
+
+    if (sub_device.dropped_time > 0 && start <= sub_device.dropped_time) {
+      ++incomplete_count_;
+    }
+
+    if (end <= sub_device.last_time) {
+      Aggregate(sub_device_id, name, start, end);
+    } else {
+      sub_device.pending_list.push_back({name, start, end});
+    }
+  }
+
+  // Aggregates the rest of the intervals with the reports already received
+  void Finalize() {
+    for (uint32_t i = 0; i < sub_device_list_.size(); ++i) {
+      for (auto& interval : sub_device_list_[i].pending_list) {
+        Aggregate(i, interval.name, interval.start, interval.end);
+      }
+      sub_device_list_[i].pending_list.clear();
+    }
+  }
+
+  const MetricAggregateMap& GetAggregateMap() const {
+    return aggregate_map_;
+  }
+
+  // Number of intervals that started before the oldest kept report
+  uint64_t GetIncompleteCount() const {
+    return incomplete_count_;
+  }
+
+  std::vector<zet_typed_value_t> GetAggregatedReport(
+      uint32_t sub_device_id, const MetricAggregate& aggregate) const {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    const SubDeviceData& sub_device = sub_device_list_[sub_device_id];
+    PTI_ASSERT(aggregate.value_list.size() == sub_device.report_size);
+
+    std::vector<zet_typed_value_t> report = aggregate.value_list;
+    if (aggregate.total_clocks == 0) {
+      return report;
+    }
+
+    for (size_t i = 0; i < report.size(); ++i) {
+      if (sub_device.type_list[i] != METRIC_AGGREGATION_AVERAGE) {
+        continue;
+      }
+      if (report[i].type == ZET_VALUE_TYPE_UINT64) {
+        report[i].value.ui64 /= aggregate.total_clocks;
+      } else {
+        PTI_ASSERT(report[i].type == ZET_VALUE_TYPE_FLOAT64);
+        report[i].value.fp64 /= aggregate.total_clocks;
+      }
+    }
+
+    return report;
+  }
+
+  // Totals are extrapolated from the intervals sampled by the stream to
+  // all the intervals of the kernel, assuming each launch behaves alike
+  std::vector<zet_typed_value_t> GetScaledReport(
+      uint32_t sub_device_id, const MetricAggregate& aggregate) const {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    const SubDeviceData& sub_device = sub_device_list_[sub_device_id];
+
+    std::vector<zet_typed_value_t> report =
+      GetAggregatedReport(sub_device_id, aggregate);
+    if (aggregate.covered_time == 0 ||
+        aggregate.covered_time == aggregate.total_time) {
+      return report;
+    }
+
+    double scale = static_cast<double>(aggregate.total_time) /
+      aggregate.covered_time;
+    for (size_t i = 0; i < report.size(); ++i) {
+      if (sub_device.type_list[i] != METRIC_AGGREGATION_TOTAL) {
+        continue;
+      }
+      if (report[i].type == ZET_VALUE_TYPE_UINT64) {
+        report[i].value.ui64 =
+          static_cast<uint64_t>(report[i].value.ui64 * scale);
+      } else {
+        PTI_ASSERT(report[i].type == ZET_VALUE_TYPE_FLOAT64);
+        report[i].value.fp64 *= scale;
+      }
+    }
+
+    return report;
+  }
+
+  // Defines how values of the metric are combined over several reports
+  static MetricAggregationType GetAggregationType(
+      const std::string& name, zet_metric_type_t type) {
+    if (name == "GpuTime") {
+      return METRIC_AGGREGATION_TOTAL;
+    }
+    if (name == "AvgGpuCoreFrequencyMHz") {
+      return METRIC_AGGREGATION_AVERAGE;
+    }
+    if (name == "ReportReason") {
+      return METRIC_AGGREGATION_FIRST;
+    }
+
+    switch (type) {
+      case ZET_METRIC_TYPE_DURATION:
+      case ZET_METRIC_TYPE_RATIO:
+        return METRIC_AGGREGATION_AVERAGE;
+      case ZET_METRIC_TYPE_THROUGHPUT:
+      case ZET_METRIC_TYPE_EVENT:
+        return METRIC_AGGREGATION_TOTAL;
+      case ZET_METRIC_TYPE_TIMESTAMP:
+      case ZET_METRIC_TYPE_RAW:
+        return METRIC_AGGREGATION_FIRST;
+      case ZET_METRIC_TYPE_EVENT_WITH_RANGE:
+      case ZET_METRIC_TYPE_FLAG:
+        return METRIC_AGGREGATION_NONE;
+      default:
+        PTI_ASSERT(0);
+        break;
+    }
+
+    return METRIC_AGGREGATION_NONE;
+  }
+
+  MetricAggregator(const MetricAggregator& copy) = delete;
+  MetricAggregator& operator=(const MetricAggregator& copy) = delete;
+
+ private: // Implementation
+  struct PendingInterval {
+    std::string name;
+    uint64_t start;
+    uint64_t end;
+  };
+
+  struct SubDeviceData {
+    uint32_t report_size = 0;
+    uint32_t time_id = 0;
+    uint32_t clocks_id = 0;
+    std::vector<MetricAggregationType> type_list;
+
+    std::deque<uint64_t> time_list;
+    std::deque<zet_typed_value_t> value_list;
+    uint64_t last_time = 0;
+    uint64_t dropped_time = 0;
+
+    std::vector<PendingInterval> pending_list;
+  };
+
+  static uint32_t GetMetricId(
+      const std::vector<std::string>& metric_list,
+      const std::string& metric_name) {
+    auto it = std::find(metric_list.begin(), metric_list.end(), metric_name);
+    return it - metric_list.begin();
+  }
+
+  static void AddValue(
+      zet_typed_value_t& total, const zet_typed_value_t& value,
+      uint64_t weight) {
+    switch (value.type) {
+      case ZET_VALUE_TYPE_UINT32:
+        total.type = ZET_VALUE_TYPE_UINT64;
+        total.value.ui64 += value.value.ui32 * weight;
+        break;
+      case ZET_VALUE_TYPE_UINT64:
+        total.type = ZET_VALUE_TYPE_UINT64;
+        total.value.ui64 += value.value.ui64 * weight;
+        break;
+      case ZET_VALUE_TYPE_FLOAT32:
+        total.type = ZET_VALUE_TYPE_FLOAT64;
+        total.value.fp64 += value.value.fp32 * weight;
+        break;
+      case ZET_VALUE_TYPE_FLOAT64:
+        total.type = ZET_VALUE_TYPE_FLOAT64;
+        total.value.fp64 += value.value.fp64 * weight;
+        break;
+      default:
+        PTI_ASSERT(0);
+        break;
+    }
+  }
+
+  void Aggregate(
+      uint32_t sub_device_id, const std::string& name,
+      uint64_t start, uint64_t end) {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    const SubDeviceData& sub_device = sub_device_list_[sub_device_id];
+
+    std::vector<MetricAggregate>& aggregate_list = aggregate_map_[name];
+    if (aggregate_list.empty()) {
+      aggregate_list.resize(sub_device_list_.size());
+      for (size_t i = 0; i < sub_device_list_.size(); ++i) {
+        aggregate_list[i] = MetricAggregate{
+            0, 0, 0, 0, 0, std::vector<zet_typed_value_t>(
+                sub_device_list_[i].report_size, zet_typed_value_t())};
+      }
+    }
+
+    MetricAggregate& aggregate = aggregate_list[sub_device_id];
+    ++aggregate.instance_count;
+    aggregate.total_time += end - start;
+
+    size_t first = std::lower_bound(
+        sub_device.time_list.begin(), sub_device.time_list.end(), start) -
+      sub_device.time_list.begin();
+    size_t last = std::upper_bound(
+        sub_device.time_list.begin() + first,
+        sub_device.time_list.end(), end) -
+      sub_device.time_list.begin();
+    if (first < last) {
+      aggregate.covered_time += end - start;
+    }
+
+    for (size_t i = first; i < last; ++i) {
+      auto report = sub_device.value_list.begin() + i * sub_device.report_size;
+
+      const zet_typed_value_t& clocks = report[sub_device.clocks_id];
+      PTI_ASSERT(clocks.type == ZET_VALUE_TYPE_UINT64);
+      aggregate.total_clocks += clocks.value.ui64;
+
+      for (size_t j = 0; j < sub_device.report_size; ++j) {
+        switch (sub_device.type_list[j]) {
+          case METRIC_AGGREGATION_TOTAL:
+            AddValue(aggregate.value_list[j], report[j], 1);
+            break;
+          case METRIC_AGGREGATION_AVERAGE:
+            AddValue(aggregate.value_list[j], report[j], clocks.value.ui64);
+            break;
+          case METRIC_AGGREGATION_FIRST:
+            if (aggregate.report_count == 0) {
+              aggregate.value_list[j] = report[j];
+            }
+            break;
+          default:
+            break;
+        }
+      }
+      ++aggregate.report_count;
+    }
+  }
+
+ private: // Data
+  std::vector<SubDeviceData> sub_device_list_;
+  MetricAggregateMap aggregate_map_;
+  uint64_t incomplete_count_ = 0;
+};
+
+#endif // PTI_TOOLS_ONEPROF_METRIC_AGGREGATOR_H_
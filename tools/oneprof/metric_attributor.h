@@ -0,0 +1,262 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ONEPROF_METRIC_ATTRIBUTOR_H_
+#define PTI_TOOLS_ONEPROF_METRIC_ATTRIBUTOR_H_
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "metric_aggregator.h"
+#include "metric_column_store.h"
+#include "metric_report_store.h"
+#include "pti_assert.h"
+#include "ze_utils.h"
+
+// Kernel interval in the metric time domain
+struct MetricInterval {
+  uint64_t start;
+  uint64_t end;
+};
+
+// Splits the reports of one metric stream between kernel intervals in a
+// single sweep over reports and intervals sorted by time. A report covers
+// [QueryBeginTime, QueryBeginTime + GpuTime] (till the next report if
+// there is no GpuTime), each interval gets the share of the report equal
+// to its overlap with this window divided by the larger of the window
+// length and the summed overlap of all the intervals. So kernels running
+// concurrently split the report instead of counting it twice, and kernels
+// shorter than the sampling interval get an interpolated part of the
+// report they fall into. Values are then summed over the columns of
+// MetricColumnStore
+class MetricAttributor {
+ public: // Interface
+  MetricAttributor(
+      const std::vector<std::string>& metric_list,
+      const std::vector<zet_metric_type_t>& metric_type_list)
+      : report_size_(metric_list.size()) {
+    PTI_ASSERT(!metric_list.empty());
+    PTI_ASSERT(metric_list.size() == metric_type_list.size());
+
+    time_id_ = GetMetricId(metric_list, "QueryBeginTime");
+    PTI_ASSERT(time_id_ < report_size_);
+    clocks_id_ = GetMetricId(metric_list, "GpuCoreClocks");
+    PTI_ASSERT(clocks_id_ < report_size_);
+    duration_id_ = GetMetricId(metric_list, "GpuTime");
+
+    for (size_t i = 0; i < metric_list.size(); ++i) {
+      type_list_.push_back(MetricAggregator::GetAggregationType(
+          metric_list[i], metric_type_list[i]));
+    }
+  }
+
+  // Returns an aggregated report for each interval in the given order,
+  // empty if the interval doesn't overlap with any report
+  std::vector<std::vector<zet_typed_value_t> > Attribute(
+      const MetricReportStore& report_store,
+      const std::vector<MetricInterval>& interval_list) const {
+    PTI_ASSERT(report_store.GetReportSize() == report_size_);
+
+    std::vector<Share> share_list = GetShareList(report_store, interval_list);
+
+    bool empty = true;
+    for (auto& share : share_list) {
+      if (!share.weight_list.empty()) {
+        empty = false;
+        break;
+      }
+    }
+
+    std::vector<std::vector<zet_typed_value_t> > result_list(
+        share_list.size());
+    if (empty) {
+      return result_list;
+    }
+
+    MetricColumnStore column_store(report_store);
+    for (size_t i = 0; i < share_list.size(); ++i) {
+      if (!share_list[i].weight_list.empty()) {
+        result_list[i] = GetReport(report_store, column_store, share_list[i]);
+      }
+    }
+    return result_list;
+  }
+
+  MetricAttributor(const MetricAttributor& copy) = delete;
+  MetricAttributor& operator=(const MetricAttributor& copy) = delete;
+
+ private: // Implementation
+  // Weights of the reports first, first + 1, ... for one interval. The
+  // reports overlapping with an interval are contiguous as report windows
+  // are sorted and don't overlap
+  struct Share {
+    size_t first = 0;
+    std::vector<double> weight_list;
+  };
+
+  static uint32_t GetMetricId(
+      const std::vector<std::string>& metric_list,
+      const std::string& metric_name) {
+    auto it = std::find(metric_list.begin(), metric_list.end(), metric_name);
+    return it - metric_list.begin();
+  }
+
+  static uint64_t GetValue(const zet_typed_value_t& value) {
+    PTI_ASSERT(value.type == ZET_VALUE_TYPE_UINT64);
+    return value.value.ui64;
+  }
+
+  uint64_t GetReportEnd(
+      const MetricReportStore& report_store, size_t report_id) const {
+    const zet_typed_value_t* report = report_store.GetReport(report_id);
+    uint64_t begin = GetValue(report[time_id_]);
+    if (duration_id_ < report_size_ &&
+        report[duration_id_].type == ZET_VALUE_TYPE_UINT64) {
+      return begin + report[duration_id_].value.ui64;
+    }
+    if (report_id + 1 < report_store.GetReportCount()) {
+      return GetValue(report_store.GetReport(report_id + 1)[time_id_]);
+    }
+    return begin;
+  }
+
+  static void AddWeight(Share& share, size_t report_id, double weight) {
+    if (share.weight_list.empty()) {
+      share.first = report_id;
+    }
+    PTI_ASSERT(report_id >= share.first + share.weight_list.size());
+    share.weight_list.resize(report_id - share.first, 0.0);
+    share.weight_list.push_back(weight);
+  }
+
+  // Sweeps over the report windows keeping the list of intervals that may
+  // overlap with the current one
+  std::vector<Share> GetShareList(
+      const MetricReportStore& report_store,
+      const std::vector<MetricInterval>& interval_list) const {
+    std::vector<Share> share_list(interval_list.size());
+
+    std::vector<size_t> order(interval_list.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+        [&interval_list](size_t left, size_t right) {
+          return interval_list[left].start < interval_list[right].start;
+        });
+
+    std::vector<size_t> active_list;
+    std::vector<uint64_t> overlap_list;
+    size_t next = 0;
+
+    size_t report_count = report_store.GetReportCount();
+    for (size_t i = 0; i < report_count; ++i) {
+      uint64_t begin = GetValue(report_store.GetReport(i)[time_id_]);
+      uint64_t end = GetReportEnd(report_store, i);
+      if (end <= begin) {
+        continue;
+      }
+
+      size_t j = 0;
+      while (j < active_list.size()) {
+        if (interval_list[active_list[j]].end <= begin) {
+          active_list[j] = active_list.back();
+          active_list.pop_back();
+        } else {
+          ++j;
+        }
+      }
+
+      while (next < order.size() && interval_list[order[next]].start < end) {
+        active_list.push_back(order[next]);
+        ++next;
+      }
+
+      overlap_list.resize(active_list.size());
+      uint64_t total_overlap = 0;
+      for (j = 0; j < active_list.size(); ++j) {
+        const MetricInterval& interval = interval_list[active_list[j]];
+        uint64_t left = (std::max)(begin, interval.start);
+        uint64_t right = (std::min)(end, interval.end);
+        overlap_list[j] = (right > left) ? right - left : 0;
+        total_overlap += overlap_list[j];
+      }
+      if (total_overlap == 0) {
+        continue;
+      }
+
+      double scale = static_cast<double>(
+          (std::max)(total_overlap, end - begin));
+      for (j = 0; j < active_list.size(); ++j) {
+        if (overlap_list[j] > 0) {
+          AddWeight(share_list[active_list[j]], i, overlap_list[j] / scale);
+        }
+      }
+    }
+
+    return share_list;
+  }
+
+  // Integer metrics stay integer, as for the other aggregation modes
+  std::vector<zet_typed_value_t> GetReport(
+      const MetricReportStore& report_store,
+      const MetricColumnStore& column_store,
+      const Share& share) const {
+    PTI_ASSERT(!share.weight_list.empty());
+    size_t count = share.weight_list.size();
+
+    const double* clocks = column_store.GetColumn(clocks_id_) + share.first;
+    std::vector<double> clocks_weight_list(count);
+    double total_clocks = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+      clocks_weight_list[i] = clocks[i] * share.weight_list[i];
+      total_clocks += clocks_weight_list[i];
+    }
+
+    const zet_typed_value_t* first = report_store.GetReport(share.first);
+    std::vector<zet_typed_value_t> report(report_size_);
+    for (uint32_t i = 0; i < report_size_; ++i) {
+      double value = 0.0;
+      switch (type_list_[i]) {
+        case METRIC_AGGREGATION_TOTAL:
+          value = column_store.GetWeightedSum(
+              i, share.first, share.weight_list.data(), count);
+          break;
+        case METRIC_AGGREGATION_AVERAGE:
+          if (total_clocks > 0.0) {
+            value = column_store.GetWeightedSum(
+                i, share.first, clocks_weight_list.data(), count) /
+              total_clocks;
+          }
+          break;
+        case METRIC_AGGREGATION_FIRST:
+          report[i] = first[i];
+          continue;
+        default:
+          continue;
+      }
+
+      zet_value_type_t type = column_store.GetType(i);
+      if (type == ZET_VALUE_TYPE_UINT32 || type == ZET_VALUE_TYPE_UINT64) {
+        report[i].type = ZET_VALUE_TYPE_UINT64;
+        report[i].value.ui64 = static_cast<uint64_t>(value + 0.5);
+      } else {
+        report[i].type = ZET_VALUE_TYPE_FLOAT64;
+        report[i].value.fp64 = value;
+      }
+    }
+    return report;
+  }
+
+ private: // Data
+  uint32_t report_size_ = 0;
+  uint32_t time_id_ = 0;
+  uint32_t clocks_id_ = 0;
+  uint32_t duration_id_ = 0;
+  std::vector<MetricAggregationType> type_list_;
+};
+
+#endif // PTI_TOOLS_ONEPROF_METRIC_ATTRIBUTOR_H_
\ No newline at end of file
@@ -0,0 +1,527 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ONEPROF_METRIC_BROKER_H_
+#define PTI_TOOLS_ONEPROF_METRIC_BROKER_H_
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "pti_assert.h"
+#include "utils.h"
+
+// Shared metric protocol: the first oneprof process on a device creates
+// shared memory named METRIC_BROKER_PREFIX<uid>.<device uuid>, becomes the
+// owner of the device metric streamers and publishes every raw chunk it
+// reads into the slots of the region. Other processes on the device
+// subscribe to it instead of opening their own streamers and pick the
+// reports of their kernel intervals out of the shared stream. The owner
+// keeps streaming until all the live subscribers detach
+
+#define METRIC_BROKER_PREFIX "pti_metrics."
+#define METRIC_BROKER_VERSION 1
+#define METRIC_BROKER_SLOT_COUNT 32
+#define METRIC_BROKER_MAX_CLIENTS 64
+#define METRIC_BROKER_GROUP_LIST_SIZE 1024
+#define METRIC_BROKER_OPEN_ATTEMPTS 100
+#define METRIC_BROKER_POLL_INTERVAL 10 // ms
+#define METRIC_BROKER_FLUSH_TIMEOUT 2000 // ms
+
+const char kMetricBrokerMagic[8] = {'P', 'T', 'I', 'M', 'E', 'T', 'R', 'B'};
+
+struct MetricBrokerHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t owner_pid;
+  uint32_t sampling_interval;
+  uint32_t slot_count;
+  uint64_t slot_size;
+  char group_list[METRIC_BROKER_GROUP_LIST_SIZE]; // Comma-separated
+  std::atomic<uint64_t> head; // Chunks published
+  std::atomic<uint64_t> flush_request; // Collection time, see Flush
+  std::atomic<uint64_t> flush_time; // Collection time, see Flush
+  std::atomic<uint32_t> closed;
+  std::atomic<uint32_t> ready; // Set once the header is complete
+  std::atomic<uint32_t> client_list[METRIC_BROKER_MAX_CLIENTS]; // PIDs
+};
+
+// Sequence is 2 * chunk + 2 once the chunk is written, odd while it is
+// being written, so readers see if the slot was reused under them
+struct MetricBrokerSlot {
+  std::atomic<uint64_t> sequence;
+  uint32_t sub_device_id;
+  uint32_t group_id;
+  uint32_t size;
+  uint32_t reserved;
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "Metric broker needs lock-free atomics");
+
+enum MetricBrokerRole {
+  METRIC_BROKER_OWNER = 0,
+  METRIC_BROKER_CLIENT = 1
+};
+
+// Single-producer multiple-consumer chunk ring in shared memory. The
+// owner never waits for the clients: a client that falls behind by more
+// than METRIC_BROKER_SLOT_COUNT chunks loses the overwritten ones
+class MetricBroker {
+ public: // Interface
+  // Returns nullptr if the broker can't be created or the owner collects
+  // other groups or sampling interval
+  static MetricBroker* Create(
+      const std::string& device_uuid, const std::string& group_list,
+      uint32_t sampling_interval, uint64_t slot_size) {
+#if defined(_WIN32)
+    std::cerr << "[WARNING] Shared metrics are not supported on Windows" <<
+      std::endl;
+    return nullptr;
+#else
+    PTI_ASSERT(!device_uuid.empty());
+    PTI_ASSERT(sampling_interval > 0);
+    PTI_ASSERT(slot_size > 0);
+    if (group_list.size() >= METRIC_BROKER_GROUP_LIST_SIZE) {
+      std::cerr << "[WARNING] Metric group list is too long to be " <<
+        "shared" << std::endl;
+      return nullptr;
+    }
+
+    std::string name = GetBrokerName(device_uuid);
+    for (uint32_t i = 0; i < METRIC_BROKER_OPEN_ATTEMPTS; ++i) {
+      int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      if (fd >= 0) {
+        return CreateOwner(
+            name, fd, group_list, sampling_interval, slot_size);
+      }
+      if (errno != EEXIST) {
+        std::cerr << "[WARNING] Unable to create shared memory " << name <<
+          std::endl;
+        return nullptr;
+      }
+
+      bool retry = false;
+      MetricBroker* broker = CreateClient(
+          name, group_list, sampling_interval, slot_size, &retry);
+      if (broker != nullptr || !retry) {
+        return broker;
+      }
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(METRIC_BROKER_POLL_INTERVAL));
+    }
+
+    std::cerr << "[WARNING] Unable to attach to metric broker " << name <<
+      std::endl;
+    return nullptr;
+#endif
+  }
+
+  ~MetricBroker() {
+#if !defined(_WIN32)
+    if (role_ == METRIC_BROKER_OWNER) {
+      header_->closed.store(1, std::memory_order_release);
+      shm_unlink(name_.c_str());
+    } else {
+      RemoveClient();
+    }
+    munmap(header_, size_);
+#endif
+  }
+
+  MetricBrokerRole GetRole() const {
+    return role_;
+  }
+
+  uint32_t GetOwnerPid() const {
+    return header_->owner_pid;
+  }
+
+ public: // Owner Interface
+  // Chunks larger than the slot are not published
+  void Publish(const uint8_t* data, uint32_t size,
+               uint32_t sub_device_id, uint32_t group_id) {
+    PTI_ASSERT(role_ == METRIC_BROKER_OWNER);
+    PTI_ASSERT(data != nullptr);
+    if (size == 0 || size > header_->slot_size) {
+      return;
+    }
+
+    uint64_t chunk = header_->head.load(std::memory_order_relaxed);
+    MetricBrokerSlot* slot = GetSlot(chunk);
+    slot->sequence.store(2 * chunk + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->sub_device_id = sub_device_id;
+    slot->group_id = group_id;
+    slot->size = size;
+    memcpy(GetSlotData(slot), data, size);
+    slot->sequence.store(2 * chunk + 2, std::memory_order_release);
+    header_->head.store(chunk + 1, std::memory_order_release);
+  }
+
+  // Clients of dead processes are dropped on the way
+  uint32_t GetClientCount() {
+    PTI_ASSERT(role_ == METRIC_BROKER_OWNER);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < METRIC_BROKER_MAX_CLIENTS; ++i) {
+      uint32_t pid = header_->client_list[i].load(std::memory_order_acquire);
+      if (pid == 0) {
+        continue;
+      }
+      if (!IsAlive(pid)) {
+        header_->client_list[i].compare_exchange_strong(pid, 0);
+        continue;
+      }
+      ++count;
+    }
+    return count;
+  }
+
+  // Returns true if some client waits for the streamers to be read, the
+  // owner should read all of them and call CompleteFlush then
+  bool IsFlushRequested() const {
+    PTI_ASSERT(role_ == METRIC_BROKER_OWNER);
+    return header_->flush_request.load(std::memory_order_acquire) >
+      header_->flush_time.load(std::memory_order_relaxed);
+  }
+
+  // Time is taken before the streamers were read
+  void CompleteFlush(uint64_t time) {
+    PTI_ASSERT(role_ == METRIC_BROKER_OWNER);
+    header_->flush_time.store(time, std::memory_order_release);
+  }
+
+ public: // Client Interface
+  // Copies the next chunk into the buffer of slot size, returns false if
+  // there is no new chunk
+  bool Read(uint8_t* buffer, uint32_t* size,
+            uint32_t* sub_device_id, uint32_t* group_id) {
+    PTI_ASSERT(role_ == METRIC_BROKER_CLIENT);
+    PTI_ASSERT(buffer != nullptr && size != nullptr);
+    PTI_ASSERT(sub_device_id != nullptr && group_id != nullptr);
+
+    while (true) {
+      uint64_t head = header_->head.load(std::memory_order_acquire);
+      if (next_chunk_ == head) {
+        return false;
+      }
+      if (head - next_chunk_ > header_->slot_count) {
+        lost_count_ += head - header_->slot_count - next_chunk_;
+        next_chunk_ = head - header_->slot_count;
+      }
+
+      uint64_t chunk = next_chunk_++;
+      MetricBrokerSlot* slot = GetSlot(chunk);
+      uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+      if (sequence != 2 * chunk + 2) {
+        ++lost_count_;
+        continue;
+      }
+
+      *sub_device_id = slot->sub_device_id;
+      *group_id = slot->group_id;
+      *size = slot->size;
+      PTI_ASSERT(*size <= header_->slot_size);
+      memcpy(buffer, GetSlotData(slot), *size);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot->sequence.load(std::memory_order_relaxed) != sequence) {
+        ++lost_count_;
+        continue;
+      }
+      return true;
+    }
+  }
+
+  // Asks the owner to read all the streamers after the given collection
+  // time, reports the device took before it are published once
+  // IsFlushed returns true for the same time
+  void Flush(uint64_t time) {
+    PTI_ASSERT(role_ == METRIC_BROKER_CLIENT);
+    uint64_t request = header_->flush_request.load(std::memory_order_relaxed);
+    while (request < time &&
+           !header_->flush_request.compare_exchange_weak(request, time)) {
+    }
+  }
+
+  bool IsFlushed(uint64_t time) const {
+    PTI_ASSERT(role_ == METRIC_BROKER_CLIENT);
+    return header_->flush_time.load(std::memory_order_acquire) >= time;
+  }
+
+  // Returns true if the owner will publish no more chunks
+  bool IsOwnerGone() const {
+    PTI_ASSERT(role_ == METRIC_BROKER_CLIENT);
+    return header_->closed.load(std::memory_order_acquire) != 0 ||
+      !IsAlive(header_->owner_pid);
+  }
+
+  uint64_t GetLostCount() const {
+    return lost_count_;
+  }
+
+  MetricBroker(const MetricBroker& copy) = delete;
+  MetricBroker& operator=(const MetricBroker& copy) = delete;
+
+ private: // Implementation
+  MetricBroker(const std::string& name, void* data, size_t size,
+               MetricBrokerRole role)
+      : name_(name), size_(size), role_(role),
+        header_(reinterpret_cast<MetricBrokerHeader*>(data)) {
+    PTI_ASSERT(header_ != nullptr);
+  }
+
+  static std::string GetBrokerName(const std::string& device_uuid) {
+#if defined(_WIN32)
+    return std::string();
+#else
+    return "/" + std::string(METRIC_BROKER_PREFIX) +
+      std::to_string(getuid()) + "." + device_uuid;
+#endif
+  }
+
+  static size_t GetRegionSize(uint32_t slot_count, uint64_t slot_size) {
+    return kSlotOffset + slot_count * (kSlotHeaderSize + slot_size);
+  }
+
+  static bool IsAlive(uint32_t pid) {
+#if defined(_WIN32)
+    return false;
+#else
+    return pid != 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+#endif
+  }
+
+  MetricBrokerSlot* GetSlot(uint64_t chunk) const {
+    uint64_t index = chunk % header_->slot_count;
+    return reinterpret_cast<MetricBrokerSlot*>(
+        reinterpret_cast<uint8_t*>(header_) + kSlotOffset +
+        index * (kSlotHeaderSize + header_->slot_size));
+  }
+
+  static uint8_t* GetSlotData(MetricBrokerSlot* slot) {
+    return reinterpret_cast<uint8_t*>(slot) + kSlotHeaderSize;
+  }
+
+#if !defined(_WIN32)
+  static MetricBroker* CreateOwner(
+      const std::string& name, int fd, const std::string& group_list,
+      uint32_t sampling_interval, uint64_t slot_size) {
+    size_t size = GetRegionSize(METRIC_BROKER_SLOT_COUNT, slot_size);
+    if (ftruncate(fd, size) != 0) {
+      std::cerr << "[WARNING] Unable to allocate shared memory " << name <<
+        std::endl;
+      close(fd);
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      std::cerr << "[WARNING] Unable to map shared memory " << name <<
+        std::endl;
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+
+    MetricBroker* broker =
+      new MetricBroker(name, data, size, METRIC_BROKER_OWNER);
+    PTI_ASSERT(broker != nullptr);
+
+    // New region is zero-filled, so all the slots are empty
+    MetricBrokerHeader* header = broker->header_;
+    memcpy(header->magic, kMetricBrokerMagic, sizeof(header->magic));
+    header->version = METRIC_BROKER_VERSION;
+    header->owner_pid = utils::GetPid();
+    header->sampling_interval = sampling_interval;
+    header->slot_count = METRIC_BROKER_SLOT_COUNT;
+    header->slot_size = slot_size;
+    strncpy(header->group_list, group_list.c_str(),
+            METRIC_BROKER_GROUP_LIST_SIZE - 1);
+    header->head.store(0, std::memory_order_relaxed);
+    header->flush_request.store(0, std::memory_order_relaxed);
+    header->flush_time.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    header->ready.store(1, std::memory_order_release);
+    return broker;
+  }
+
+  // Several clients may find the same stale region, and a new owner may
+  // create the next one once it is removed. The region is removed only if
+  // the name still refers to it, the check and the removal are done under
+  // the lock of the stale region itself (owners never take it)
+  static void UnlinkStale(const std::string& name, int fd) {
+    if (flock(fd, LOCK_EX) != 0) {
+      return;
+    }
+
+    struct stat stale;
+    if (fstat(fd, &stale) == 0) {
+      int current_fd = shm_open(name.c_str(), O_RDONLY, 0600);
+      if (current_fd >= 0) {
+        struct stat current;
+        if (fstat(current_fd, &current) == 0 &&
+            current.st_dev == stale.st_dev &&
+            current.st_ino == stale.st_ino) {
+          shm_unlink(name.c_str());
+        }
+        close(current_fd);
+      }
+    }
+
+    flock(fd, LOCK_UN);
+  }
+
+  // Sets retry if the region is not complete yet or is left from an owner
+  // that is gone, the stale one is removed then
+  static MetricBroker* CreateClient(
+      const std::string& name, const std::string& group_list,
+      uint32_t sampling_interval, uint64_t slot_size, bool* retry) {
+    PTI_ASSERT(retry != nullptr);
+    *retry = true;
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+      return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        static_cast<size_t>(info.st_size) < kSlotOffset) {
+      close(fd);
+      return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      return nullptr;
+    }
+
+    MetricBroker* broker =
+      new MetricBroker(name, data, size, METRIC_BROKER_CLIENT);
+    PTI_ASSERT(broker != nullptr);
+
+    MetricBrokerHeader* header = broker->header_;
+    if (header->ready.load(std::memory_order_acquire) == 0) {
+      close(fd);
+      delete broker;
+      return nullptr;
+    }
+
+    if (memcmp(header->magic, kMetricBrokerMagic,
+               sizeof(header->magic)) != 0 ||
+        header->version != METRIC_BROKER_VERSION ||
+        header->slot_size != slot_size ||
+        GetRegionSize(header->slot_count, header->slot_size) != size) {
+      std::cerr << "[WARNING] Metric broker " << name <<
+        " has unsupported format" << std::endl;
+      close(fd);
+      delete broker;
+      *retry = false;
+      return nullptr;
+    }
+
+    if (broker->IsOwnerGone()) {
+      // Owner unlinks the region itself when it closes normally
+      if (!IsAlive(header->owner_pid)) {
+        UnlinkStale(name, fd);
+      }
+      close(fd);
+      delete broker;
+      return nullptr;
+    }
+    close(fd);
+
+    if (group_list != header->group_list ||
+        sampling_interval != header->sampling_interval) {
+      std::cerr << "[WARNING] Metric broker (PID " << header->owner_pid <<
+        ") collects " << header->group_list << " every " <<
+        header->sampling_interval << " ns, while " << group_list <<
+        " every " << sampling_interval << " ns is requested" << std::endl;
+      delete broker;
+      *retry = false;
+      return nullptr;
+    }
+
+    if (!broker->AddClient()) {
+      std::cerr << "[WARNING] Metric broker has too many clients" <<
+        std::endl;
+      delete broker;
+      *retry = false;
+      return nullptr;
+    }
+
+    // Owner could close before it saw the client
+    if (broker->IsOwnerGone()) {
+      delete broker;
+      return nullptr;
+    }
+
+    // Chunks published before the client came have no kernels of it
+    broker->next_chunk_ = header->head.load(std::memory_order_acquire);
+    return broker;
+  }
+#endif
+
+  bool AddClient() {
+    uint32_t pid = utils::GetPid();
+    for (uint32_t i = 0; i < METRIC_BROKER_MAX_CLIENTS; ++i) {
+      uint32_t empty = 0;
+      if (header_->client_list[i].compare_exchange_strong(empty, pid)) {
+        client_id_ = i;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void RemoveClient() {
+    if (client_id_ < METRIC_BROKER_MAX_CLIENTS) {
+      header_->client_list[client_id_].store(0, std::memory_order_release);
+      client_id_ = METRIC_BROKER_MAX_CLIENTS;
+    }
+  }
+
+ private: // Data
+  static const size_t kSlotOffset = 4096;
+  static const size_t kSlotHeaderSize = 64;
+
+  std::string name_;
+  size_t size_ = 0;
+  MetricBrokerRole role_ = METRIC_BROKER_OWNER;
+  MetricBrokerHeader* header_ = nullptr;
+
+  uint64_t next_chunk_ = 0;
+  uint64_t lost_count_ = 0;
+  uint32_t client_id_ = METRIC_BROKER_MAX_CLIENTS;
+};
+
+static_assert(sizeof(MetricBrokerHeader) <= 4096,
+              "Unexpected metric broker header size");
+static_assert(sizeof(MetricBrokerSlot) <= 64,
+              "Unexpected metric broker slot header size");
+
+#endif // PTI_TOOLS_ONEPROF_METRIC_BROKER_H_
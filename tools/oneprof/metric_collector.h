@@ -9,19 +9,37 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "metric_broker.h"
+#include "metric_report_store.h"
+#include "metric_scheduler.h"
 #include "metric_storage.h"
+#include "overhead.h"
+#include "work_stealing_pool.h"
+#include "ze_device_cache.h"
 #include "ze_utils.h"
 
 #define MAX_REPORT_SIZE 256
 #define REPORT_COUNT    4096
 #define CHUNK_SIZE      (REPORT_COUNT * MAX_REPORT_SIZE)
-#define WAIT_DELAY      10000000
+
+typedef void (*OnMetricReportsCallback)(
+    void* data, uint32_t sub_device_id, uint32_t group_id,
+    const std::vector<zet_typed_value_t>& report_chunk);
+
+struct MetricStreamStats {
+  uint64_t total_size;
+  uint64_t read_count;
+  uint64_t empty_read_count;
+  uint64_t dropped_count;
+};
 
 enum CollectorState {
   COLLECTOR_STATE_IDLE = 0,
@@ -29,17 +47,27 @@ enum CollectorState {
   COLLECTOR_STATE_DISABLED = 2
 };
 
+// Streams metrics of one or several groups. Only one group can be active
+// on a device at a time, so several groups are time-multiplexed: the
+// collector thread switches to the next group every multiplex_period ns.
+// Reports of each group and sub-device are kept in a separate stream.
+// Shared collector takes its reports from the metric broker of the device
+// if another process owns it, or becomes the owner otherwise
 class MetricCollector {
  public: // Interface
   static MetricCollector* Create(
       ze_driver_handle_t driver,
       ze_device_handle_t device,
-      const char* group_name,
-      uint32_t sampling_interval) {
+      const std::vector<std::string>& group_name_list,
+      uint32_t sampling_interval,
+      bool store_reports = true,
+      uint64_t multiplex_period = 0,
+      bool shared = false) {
     PTI_ASSERT(driver != nullptr);
     PTI_ASSERT(device != nullptr);
-    PTI_ASSERT(group_name != nullptr);
+    PTI_ASSERT(!group_name_list.empty());
     PTI_ASSERT(sampling_interval > 0);
+    PTI_ASSERT(group_name_list.size() == 1 || multiplex_period > 0);
 
     ze_context_handle_t context = utils::ze::GetContext(driver);
     PTI_ASSERT(context != nullptr);
@@ -50,33 +78,120 @@ class MetricCollector {
       sub_device_list.push_back(device);
     }
 
-    std::vector<zet_metric_group_handle_t> metric_group_list;
+    // Group indexes may come from the device cache
+    std::vector<ZeDeviceCapabilities> capabilities_list;
     for (auto sub_device : sub_device_list) {
-      zet_metric_group_handle_t group = utils::ze::FindMetricGroup(
-          sub_device, group_name,
-          ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_TIME_BASED);
-      if (group == nullptr) {
-        std::cerr << "[WARNING] Unable to find target metric group: " <<
-          group_name << std::endl;
+      capabilities_list.push_back(
+          utils::ze::GetDeviceCapabilities(driver, sub_device, true));
+    }
+
+    // Groups are stored stream by stream, see GetStreamId
+    std::vector<zet_metric_group_handle_t> metric_group_list;
+    for (auto& group_name : group_name_list) {
+      for (size_t i = 0; i < sub_device_list.size(); ++i) {
+        zet_metric_group_handle_t group = utils::ze::FindMetricGroup(
+            capabilities_list[i], sub_device_list[i], group_name.c_str(),
+            ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_TIME_BASED);
+        if (group == nullptr) {
+          std::cerr << "[WARNING] Unable to find target metric group: " <<
+            group_name << std::endl;
+          return nullptr;
+        }
+        metric_group_list.push_back(group);
+      }
+    }
+    PTI_ASSERT(metric_group_list.size() ==
+               sub_device_list.size() * group_name_list.size());
+
+    MetricBroker* broker = nullptr;
+    if (shared) {
+      std::string group_list;
+      for (auto& group_name : group_name_list) {
+        if (!group_list.empty()) {
+          group_list += ",";
+        }
+        group_list += group_name;
+      }
+
+      broker = MetricBroker::Create(
+          utils::ze::GetDeviceUuid(device), group_list,
+          sampling_interval, CHUNK_SIZE);
+      if (broker == nullptr) {
         return nullptr;
       }
-      metric_group_list.push_back(group);
+
+      if (broker->GetRole() == METRIC_BROKER_OWNER) {
+        std::cerr << "[INFO] Metric streamers of the device are shared " <<
+          "with other processes" << std::endl;
+      } else {
+        std::cerr << "[INFO] Metrics are taken from the collection of " <<
+          "process " << broker->GetOwnerPid() << std::endl;
+      }
     }
-    PTI_ASSERT(metric_group_list.size() == sub_device_list.size());
 
     return new MetricCollector(
-        context, sub_device_list, metric_group_list, sampling_interval);
+        context, sub_device_list, group_name_list, metric_group_list,
+        sampling_interval, store_reports, multiplex_period, broker);
   }
 
   void DisableCollection() {
     DisableMetrics();
 
-    PTI_ASSERT(metric_storage_ != nullptr);
-    delete metric_storage_;
-    metric_storage_ = nullptr;
+    if (broker_ != nullptr) {
+      if (broker_->GetLostCount() > 0) {
+        std::cerr << "[WARNING] " << broker_->GetLostCount() <<
+          " shared metric chunks were lost (metric broker overflow)" <<
+          std::endl;
+      }
+      delete broker_;
+      broker_ = nullptr;
+    }
+
+    if (metric_storage_ != nullptr) {
+      delete metric_storage_;
+      metric_storage_ = nullptr;
+
+      metric_reader_ = new MetricReader(GetStreamCount());
+      PTI_ASSERT(metric_reader_ != nullptr);
+    }
+  }
 
-    metric_reader_ = new MetricReader(sub_device_list_.size());
-    PTI_ASSERT(metric_reader_ != nullptr);
+  // Available after collection is disabled, empty if streaming failed,
+  // indexed by stream (see GetStreamId)
+  const std::vector<MetricStreamStats>& GetStreamStatsList() const {
+    PTI_ASSERT(collector_state_ == COLLECTOR_STATE_DISABLED);
+    return stream_stats_list_;
+  }
+
+  uint32_t GetSubDeviceCount() const {
+    return static_cast<uint32_t>(sub_device_list_.size());
+  }
+
+  uint32_t GetGroupCount() const {
+    return static_cast<uint32_t>(group_name_list_.size());
+  }
+
+  const std::string& GetGroupName(uint32_t group_id) const {
+    PTI_ASSERT(group_id < group_name_list_.size());
+    return group_name_list_[group_id];
+  }
+
+  uint32_t GetStreamCount() const {
+    return GetSubDeviceCount() * GetGroupCount();
+  }
+
+  uint32_t GetStreamId(uint32_t sub_device_id, uint32_t group_id) const {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    PTI_ASSERT(group_id < group_name_list_.size());
+    return group_id * GetSubDeviceCount() + sub_device_id;
+  }
+
+  // Callback is called from the collector thread with calculated reports
+  // as soon as they are read from the streamer
+  void SetReportCallback(OnMetricReportsCallback callback, void* data) {
+    const std::lock_guard<std::mutex> lock(callback_lock_);
+    report_callback_ = callback;
+    report_callback_data_ = data;
   }
 
   ~MetricCollector() {
@@ -91,8 +206,15 @@ class MetricCollector {
       delete metric_storage_;
     }
 
-    PTI_ASSERT(metric_reader_ != nullptr);
-    delete metric_reader_;
+    if (metric_reader_ != nullptr) {
+      delete metric_reader_;
+    }
+
+    for (auto report_store : report_store_list_) {
+      if (report_store != nullptr) {
+        delete report_store;
+      }
+    }
   }
 
   void ResetReportReader() {
@@ -100,68 +222,60 @@ class MetricCollector {
     metric_reader_->Reset();
   }
 
-  std::vector<zet_typed_value_t> GetReportChunk(uint32_t sub_device_id) const {
-    ze_result_t status = ZE_RESULT_SUCCESS;
-    std::vector<zet_typed_value_t> report_chunk;
-
-    PTI_ASSERT(sub_device_id < sub_device_list_.size());
-    PTI_ASSERT(sub_device_list_.size() == metric_group_list_.size());
-    PTI_ASSERT(!metric_group_list_.empty());
+  std::vector<zet_typed_value_t> GetReportChunk(
+      uint32_t sub_device_id, uint32_t group_id = 0) const {
+    uint32_t stream_id = GetStreamId(sub_device_id, group_id);
     PTI_ASSERT(metric_storage_ == nullptr);
     PTI_ASSERT(metric_reader_ != nullptr);
 
-    std::vector<uint8_t> metric_data =
-      metric_reader_->ReadChunk(CHUNK_SIZE, sub_device_id);
-    if (metric_data.empty()) {
-      return report_chunk;
+    uint32_t data_size = 0;
+    const uint8_t* data =
+      metric_reader_->ReadChunk(CHUNK_SIZE, stream_id, &data_size);
+    if (data == nullptr) {
+      return std::vector<zet_typed_value_t>();
     }
 
-    uint32_t value_count = 0;
-    status = zetMetricGroupCalculateMetricValues(
-        metric_group_list_[sub_device_id],
-        ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
-        metric_data.size(), metric_data.data(), &value_count, nullptr);
-    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-    PTI_ASSERT(value_count > 0);
-
-    report_chunk.resize(value_count);
-    status = zetMetricGroupCalculateMetricValues(
-        metric_group_list_[sub_device_id],
-        ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
-        metric_data.size(), metric_data.data(),
-        &value_count, report_chunk.data());
-    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-    report_chunk.resize(value_count);
+    return CalculateReports(data, data_size, stream_id);
+  }
 
-    return report_chunk;
+  // Calculated reports are built on the first request and then reused
+  const MetricReportStore* GetReportStore(
+      uint32_t sub_device_id, uint32_t group_id = 0) {
+    uint32_t stream_id = GetStreamId(sub_device_id, group_id);
+    PTI_ASSERT(stream_id < report_store_list_.size());
+    if (report_store_list_[stream_id] == nullptr) {
+      CreateReportStores();
+    }
+    PTI_ASSERT(report_store_list_[stream_id] != nullptr);
+    return report_store_list_[stream_id];
   }
 
-  uint32_t GetReportSize(uint32_t sub_device_id) const {
-    PTI_ASSERT(sub_device_id < sub_device_list_.size());
-    PTI_ASSERT(sub_device_list_.size() == metric_group_list_.size());
-    PTI_ASSERT(!metric_group_list_.empty());
+  uint32_t GetReportSize(
+      uint32_t sub_device_id, uint32_t group_id = 0) const {
+    uint32_t stream_id = GetStreamId(sub_device_id, group_id);
+    PTI_ASSERT(stream_id < metric_group_list_.size());
 
     zet_metric_group_properties_t group_props{};
     group_props.stype = ZET_STRUCTURE_TYPE_METRIC_GROUP_PROPERTIES;
     ze_result_t status = zetMetricGroupGetProperties(
-        metric_group_list_[sub_device_id], &group_props);
+        metric_group_list_[stream_id], &group_props);
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
     return group_props.metricCount;
   }
 
-  std::vector<std::string> GetMetricList(uint32_t sub_device_id) const {
+  std::vector<std::string> GetMetricList(
+      uint32_t sub_device_id, uint32_t group_id = 0) const {
     ze_result_t status = ZE_RESULT_SUCCESS;
 
-    PTI_ASSERT(sub_device_id < sub_device_list_.size());
-    PTI_ASSERT(sub_device_list_.size() == metric_group_list_.size());
-    PTI_ASSERT(!metric_group_list_.empty());
+    uint32_t stream_id = GetStreamId(sub_device_id, group_id);
+    PTI_ASSERT(stream_id < metric_group_list_.size());
 
-    uint32_t metric_count = GetReportSize(sub_device_id);
+    uint32_t metric_count = GetReportSize(sub_device_id, group_id);
     PTI_ASSERT(metric_count > 0);
 
     std::vector<zet_metric_handle_t> metric_list(metric_count);
     status = zetMetricGet(
-        metric_group_list_[sub_device_id], &metric_count, metric_list.data());
+        metric_group_list_[stream_id], &metric_count, metric_list.data());
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
     PTI_ASSERT(metric_count == metric_list.size());
 
@@ -177,19 +291,19 @@ class MetricCollector {
     return name_list;
   }
 
-  std::vector<zet_metric_type_t> GetMetricTypeList(uint32_t sub_device_id) const {
+  std::vector<zet_metric_type_t> GetMetricTypeList(
+      uint32_t sub_device_id, uint32_t group_id = 0) const {
     ze_result_t status = ZE_RESULT_SUCCESS;
 
-    PTI_ASSERT(sub_device_id < sub_device_list_.size());
-    PTI_ASSERT(sub_device_list_.size() == metric_group_list_.size());
-    PTI_ASSERT(!metric_group_list_.empty());
+    uint32_t stream_id = GetStreamId(sub_device_id, group_id);
+    PTI_ASSERT(stream_id < metric_group_list_.size());
 
-    uint32_t metric_count = GetReportSize(sub_device_id);
+    uint32_t metric_count = GetReportSize(sub_device_id, group_id);
     PTI_ASSERT(metric_count > 0);
 
     std::vector<zet_metric_handle_t> metric_list(metric_count);
     status = zetMetricGet(
-        metric_group_list_[sub_device_id], &metric_count, metric_list.data());
+        metric_group_list_[stream_id], &metric_count, metric_list.data());
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
     PTI_ASSERT(metric_count == metric_list.size());
 
@@ -212,33 +326,135 @@ class MetricCollector {
   MetricCollector(
       ze_context_handle_t context,
       const std::vector<ze_device_handle_t>& sub_device_list,
+      const std::vector<std::string>& group_name_list,
       const std::vector<zet_metric_group_handle_t>& metric_group_list,
-      uint32_t sampling_interval)
+      uint32_t sampling_interval,
+      bool store_reports,
+      uint64_t multiplex_period,
+      MetricBroker* broker)
       : context_(context),
         sub_device_list_(sub_device_list),
+        group_name_list_(group_name_list),
         metric_group_list_(metric_group_list),
-        sampling_interval_(sampling_interval) {
+        sampling_interval_(sampling_interval),
+        multiplex_period_(multiplex_period),
+        broker_(broker) {
     PTI_ASSERT(context_ != nullptr);
     PTI_ASSERT(!sub_device_list_.empty());
-    PTI_ASSERT(!metric_group_list_.empty());
+    PTI_ASSERT(!group_name_list_.empty());
+    PTI_ASSERT(metric_group_list_.size() == GetStreamCount());
     PTI_ASSERT(sampling_interval_ > 0);
 
-    metric_storage_ = new MetricStorage(sub_device_list_.size());
-    PTI_ASSERT(metric_storage_ != nullptr);
-
-    for (size_t i = 0; i < sub_device_list_.size(); ++i) {
-      metric_buffer_.push_back(std::vector<uint8_t>(CHUNK_SIZE));
+    if (store_reports) {
+      metric_storage_ = new MetricStorage(GetStreamCount());
+      PTI_ASSERT(metric_storage_ != nullptr);
+    } else {
+      for (size_t i = 0; i < sub_device_list_.size(); ++i) {
+        metric_buffer_.push_back(std::vector<uint8_t>(CHUNK_SIZE));
+      }
     }
 
+    report_store_list_.resize(GetStreamCount(), nullptr);
+
     EnableMetrics();
   }
 
+  // Raw chunks of all the sub-devices are calculated in parallel, then
+  // stores are filled chunk by chunk and sorted by report time if needed
+  void CreateReportStores() {
+    PTI_ASSERT(metric_storage_ == nullptr);
+    PTI_ASSERT(metric_reader_ != nullptr);
+    PTI_ASSERT(report_store_list_.size() == GetStreamCount());
+
+    std::vector<std::vector<std::vector<zet_typed_value_t> > > chunk_list(
+        GetStreamCount());
+    std::vector<std::function<void()> > task_list;
+    for (uint32_t i = 0; i < GetStreamCount(); ++i) {
+      if (report_store_list_[i] != nullptr) {
+        continue;
+      }
+
+      uint32_t chunk_count = metric_reader_->GetChunkCount(CHUNK_SIZE, i);
+      chunk_list[i].resize(chunk_count);
+      for (uint32_t j = 0; j < chunk_count; ++j) {
+        task_list.push_back([this, i, j, &chunk_list]() {
+          uint32_t data_size = 0;
+          const uint8_t* data =
+            metric_reader_->GetChunk(CHUNK_SIZE, j, i, &data_size);
+          PTI_ASSERT(data != nullptr);
+          chunk_list[i][j] = CalculateReports(data, data_size, i);
+        });
+      }
+    }
+
+    WorkStealingPool pool;
+    pool.Run(task_list);
+
+    for (uint32_t i = 0; i < GetStreamCount(); ++i) {
+      if (report_store_list_[i] != nullptr) {
+        continue;
+      }
+
+      std::vector<std::string> metric_list = GetMetricList(
+          i % GetSubDeviceCount(), i / GetSubDeviceCount());
+      PTI_ASSERT(!metric_list.empty());
+
+      auto it = std::find(
+          metric_list.begin(), metric_list.end(), "QueryBeginTime");
+      PTI_ASSERT(it != metric_list.end());
+
+      MetricReportStore* report_store = new MetricReportStore(
+          metric_list.size(), it - metric_list.begin());
+      PTI_ASSERT(report_store != nullptr);
+
+      for (auto& report_chunk : chunk_list[i]) {
+        report_store->AddReports(report_chunk);
+        std::vector<zet_typed_value_t>().swap(report_chunk);
+      }
+      report_store->Seal();
+
+      report_store_list_[i] = report_store;
+    }
+  }
+
+  std::vector<zet_typed_value_t> CalculateReports(
+      const uint8_t* data, uint32_t data_size, uint32_t stream_id) const {
+    PTI_ASSERT(data != nullptr);
+    PTI_ASSERT(data_size > 0);
+    PTI_ASSERT(stream_id < metric_group_list_.size());
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    std::vector<zet_typed_value_t> report_chunk;
+
+    uint32_t value_count = 0;
+    status = zetMetricGroupCalculateMetricValues(
+        metric_group_list_[stream_id],
+        ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+        data_size, data, &value_count, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    PTI_ASSERT(value_count > 0);
+
+    report_chunk.resize(value_count);
+    status = zetMetricGroupCalculateMetricValues(
+        metric_group_list_[stream_id],
+        ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+        data_size, data, &value_count, report_chunk.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    report_chunk.resize(value_count);
+
+    return report_chunk;
+  }
+
   void EnableMetrics() {
     PTI_ASSERT(collector_thread_ == nullptr);
     PTI_ASSERT(collector_state_ == COLLECTOR_STATE_IDLE);
 
     collector_state_.store(COLLECTOR_STATE_IDLE, std::memory_order_release);
-    collector_thread_ = new std::thread(Collect, this);
+    if (broker_ != nullptr && broker_->GetRole() == METRIC_BROKER_CLIENT) {
+      collector_thread_ = new std::thread(Subscribe, this);
+    } else {
+      collector_thread_ = new std::thread(Collect, this);
+    }
     PTI_ASSERT(collector_thread_ != nullptr);
 
     while (collector_state_.load(std::memory_order_acquire) !=
@@ -256,76 +472,338 @@ class MetricCollector {
     delete collector_thread_;
   }
 
+  // Streamer writes reports right into the storage, no extra copy needed;
+  // without storage reports go to a temporary buffer
+  uint8_t* GetMetricBuffer(uint32_t sub_device_id, uint32_t group_id) {
+    if (metric_storage_ == nullptr) {
+      PTI_ASSERT(sub_device_id < metric_buffer_.size());
+      return metric_buffer_[sub_device_id].data();
+    }
+    return metric_storage_->GetBuffer(
+        CHUNK_SIZE, GetStreamId(sub_device_id, group_id));
+  }
+
   void AppendMetrics(
-      const uint8_t* storage, uint32_t size, uint32_t sub_device_id) {
-    PTI_ASSERT(storage != nullptr);
+      const uint8_t* data, uint32_t size,
+      uint32_t sub_device_id, uint32_t group_id) {
+    PTI_ASSERT(data != nullptr);
     PTI_ASSERT(size > 0);
-    metric_storage_->Dump(storage, size, sub_device_id);
+    uint32_t stream_id = GetStreamId(sub_device_id, group_id);
+
+    const OverheadLockGuard lock(callback_lock_, OVERHEAD_METRIC);
+    if (report_callback_ != nullptr) {
+      report_callback_(
+          report_callback_data_, sub_device_id, group_id,
+          CalculateReports(data, size, stream_id));
+    }
+
+    if (metric_storage_ != nullptr) {
+      OverheadScope overhead(OVERHEAD_METRIC, OVERHEAD_IO, size);
+      metric_storage_->Commit(size, stream_id);
+    }
   }
 
-  uint8_t* GetMetricBuffer(size_t sub_device_id) {
-    PTI_ASSERT(sub_device_id < metric_buffer_.size());
-    return metric_buffer_[sub_device_id].data();
+  // Reads all the data available in the streamer, returns its size
+  static uint64_t CollectChunk(
+      MetricCollector* collector,
+      zet_metric_streamer_handle_t metric_streamer,
+      uint32_t sub_device_id,
+      uint32_t group_id,
+      bool* dropped) {
+    PTI_ASSERT(collector != nullptr);
+    PTI_ASSERT(metric_streamer != nullptr);
+    PTI_ASSERT(dropped != nullptr);
+
+    uint64_t total_size = 0;
+    *dropped = false;
+    while (true) {
+      uint8_t* storage = collector->GetMetricBuffer(sub_device_id, group_id);
+      PTI_ASSERT(storage != nullptr);
+
+      size_t data_size = CHUNK_SIZE;
+      ze_result_t status = ZE_RESULT_SUCCESS;
+      {
+        OverheadScope overhead(OVERHEAD_METRIC, OVERHEAD_TIMESTAMP_READ);
+        status = zetMetricStreamerReadData(
+            metric_streamer, REPORT_COUNT, &data_size, storage);
+        overhead.SetBytes(data_size);
+      }
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS ||
+                 status == ZE_RESULT_WARNING_DROPPED_DATA);
+      if (status == ZE_RESULT_WARNING_DROPPED_DATA) {
+        *dropped = true;
+      }
+      if (data_size == 0) {
+        break;
+      }
+      PTI_ASSERT(data_size <= CHUNK_SIZE);
+
+      if (collector->broker_ != nullptr) {
+        collector->broker_->Publish(
+            storage, data_size, sub_device_id, group_id);
+      }
+      collector->AppendMetrics(storage, data_size, sub_device_id, group_id);
+      total_size += data_size;
+    }
+
+    return total_size;
+  }
+
+  static uint64_t GetCollectionTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Owner of the shared streamers goes on until its clients detach
+  bool IsCollectionDisabled() {
+    if (collector_state_.load(std::memory_order_acquire) !=
+        COLLECTOR_STATE_DISABLED) {
+      return false;
+    }
+    if (broker_ == nullptr) {
+      return true;
+    }
+
+    uint32_t client_count = broker_->GetClientCount();
+    if (client_count > 0 && !waiting_for_clients_) {
+      std::cerr << "[INFO] Waiting for " << client_count <<
+        " processes to detach from shared metrics" << std::endl;
+      waiting_for_clients_ = true;
+    }
+    return client_count == 0;
   }
 
-  static void CollectChunk(
+  // Streamers are read when the scheduler expects them to be half-full or
+  // when they notify that REPORT_COUNT reports are ready; between reads
+  // the thread sleeps on the notification event of the earliest one.
+  // Returns true if collection is disabled, false if the deadline of the
+  // multiplexing window (if non-zero) has come
+  static bool CollectChunks(
       MetricCollector* collector,
+      uint32_t group_id,
+      uint64_t deadline,
+      MetricScheduler* scheduler,
       const std::vector<ze_event_handle_t>& event_list,
       const std::vector<zet_metric_streamer_handle_t>& metric_streamer_list) {
     PTI_ASSERT(collector != nullptr);
-    ze_result_t status = ZE_RESULT_SUCCESS;
+    PTI_ASSERT(scheduler != nullptr);
+    PTI_ASSERT(event_list.size() == metric_streamer_list.size());
+    uint32_t sub_device_count = metric_streamer_list.size();
+
+    MetricBroker* broker = collector->broker_;
+    bool disabled = false;
+    bool expired = false;
+    while (!disabled && !expired) {
+      disabled = collector->IsCollectionDisabled();
+      expired = (deadline > 0 && GetCollectionTime() >= deadline);
+
+      if (!disabled && !expired) {
+        uint64_t wait_time = 0;
+        uint64_t now = GetCollectionTime();
+        uint32_t next = scheduler->GetNextSubDevice(now, &wait_time);
+        if (deadline > 0) {
+          wait_time = (std::min)(wait_time, deadline - now);
+        }
+        // Clients may ask for the streamers to be read at any time
+        if (broker != nullptr) {
+          wait_time = (std::min)(
+              wait_time, static_cast<uint64_t>(METRIC_BROKER_POLL_INTERVAL) *
+                NSEC_IN_MSEC);
+        }
+        if (wait_time > 0) {
+          ze_result_t status = zeEventHostSynchronize(
+              event_list[next], wait_time);
+          PTI_ASSERT(status == ZE_RESULT_SUCCESS ||
+                     status == ZE_RESULT_NOT_READY);
+        }
+      }
 
-    for (size_t i = 0; i < event_list.size(); ++i) {
-      uint8_t* storage = collector->GetMetricBuffer(i);
-      PTI_ASSERT(storage != nullptr);
+      bool flushing = (broker != nullptr && broker->IsFlushRequested());
+      uint64_t flush_time = GetCollectionTime();
+
+      for (uint32_t i = 0; i < sub_device_count; ++i) {
+        ze_result_t status = zeEventQueryStatus(event_list[i]);
+        PTI_ASSERT(status == ZE_RESULT_SUCCESS ||
+                   status == ZE_RESULT_NOT_READY);
+        bool notified = (status == ZE_RESULT_SUCCESS);
+        if (notified) {
+          status = zeEventHostReset(event_list[i]);
+          PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+        }
+
+        // The last pass reads all the remaining data
+        uint64_t now = GetCollectionTime();
+        if (disabled || expired || notified || flushing ||
+            scheduler->IsReadRequired(i, now)) {
+          bool dropped = false;
+          uint64_t size = CollectChunk(
+              collector, metric_streamer_list[i], i, group_id, &dropped);
+          scheduler->Update(i, GetCollectionTime(), size, dropped);
+        }
+      }
 
-      status = zeEventHostSynchronize(event_list[i], WAIT_DELAY);
-      PTI_ASSERT(status == ZE_RESULT_SUCCESS || status == ZE_RESULT_NOT_READY);
-      if (status == ZE_RESULT_SUCCESS) {
-        status = zeEventHostReset(event_list[i]);
-        PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      if (flushing) {
+        broker->CompleteFlush(flush_time);
       }
+    }
+
+    return disabled;
+  }
+
+  // Activates the group on all the sub-devices and opens the streamers,
+  // returns false if some of them can't be opened
+  static bool OpenStreamers(
+      MetricCollector* collector, uint32_t group_id,
+      const std::vector<ze_event_handle_t>& event_list,
+      std::vector<zet_metric_streamer_handle_t>* metric_streamer_list) {
+    PTI_ASSERT(collector != nullptr);
+    PTI_ASSERT(metric_streamer_list != nullptr);
+    PTI_ASSERT(metric_streamer_list->empty());
+    PTI_ASSERT(event_list.size() == collector->sub_device_list_.size());
 
-      size_t data_size = 0;
-      status = zetMetricStreamerReadData(
-          metric_streamer_list[i], REPORT_COUNT, &data_size, nullptr);
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    for (uint32_t i = 0; i < collector->sub_device_list_.size(); ++i) {
+      zet_metric_group_handle_t group =
+        collector->metric_group_list_[collector->GetStreamId(i, group_id)];
+      status = zetContextActivateMetricGroups(
+          collector->context_, collector->sub_device_list_[i], 1, &group);
       PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-      PTI_ASSERT(data_size > 0);
-      PTI_ASSERT(data_size <= CHUNK_SIZE);
 
-      while (true) {
-        status = zetMetricStreamerReadData(
-            metric_streamer_list[i], REPORT_COUNT, &data_size, storage);
-        PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-        if (data_size == 0) {
-          break;
-        }
-        collector->AppendMetrics(storage, data_size, i);
+      zet_metric_streamer_desc_t metric_streamer_desc = {
+          ZET_STRUCTURE_TYPE_METRIC_STREAMER_DESC,
+          nullptr,
+          REPORT_COUNT,
+          collector->sampling_interval_};
+      zet_metric_streamer_handle_t metric_streamer = nullptr;
+      status = zetMetricStreamerOpen(
+          collector->context_, collector->sub_device_list_[i],
+          group, &metric_streamer_desc, event_list[i], &metric_streamer);
+      if (status != ZE_RESULT_SUCCESS) {
+        std::cout <<
+          "[WARNING] Sampling interval is not supported" << std::endl;
+        return false;
       }
+
+      metric_streamer_list->push_back(metric_streamer);
     }
+
+    return true;
   }
 
-  static void Collect(MetricCollector* collector) {
+  static void CloseStreamers(
+      MetricCollector* collector,
+      const std::vector<ze_event_handle_t>& event_list,
+      std::vector<zet_metric_streamer_handle_t>* metric_streamer_list) {
     PTI_ASSERT(collector != nullptr);
-
-    PTI_ASSERT(collector->context_ != nullptr);
-    PTI_ASSERT(!collector->metric_group_list_.empty());
-    PTI_ASSERT(collector->sub_device_list_.size() ==
-               collector->metric_group_list_.size());
+    PTI_ASSERT(metric_streamer_list != nullptr);
 
     ze_result_t status = ZE_RESULT_SUCCESS;
+    for (auto metric_streamer : *metric_streamer_list) {
+      status = zetMetricStreamerClose(metric_streamer);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    }
+    metric_streamer_list->clear();
+
+    // Notifications of the closed streamers should not wake up the next
+    // ones
+    for (auto event : event_list) {
+      status = zeEventHostReset(event);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    }
 
-    for (size_t i = 0; i < collector->sub_device_list_.size(); ++i) {
+    for (auto sub_device : collector->sub_device_list_) {
       status = zetContextActivateMetricGroups(
-          collector->context_, collector->sub_device_list_[i],
-          1, &collector->metric_group_list_[i]);
+          collector->context_, sub_device, 0, nullptr);
       PTI_ASSERT(status == ZE_RESULT_SUCCESS);
     }
+  }
+
+  // Copies all the chunks published by the owner since the last call
+  static void ReadSharedChunks(
+      MetricCollector* collector, std::vector<uint8_t>* buffer) {
+    PTI_ASSERT(collector != nullptr);
+    PTI_ASSERT(buffer != nullptr && buffer->size() == CHUNK_SIZE);
+    MetricBroker* broker = collector->broker_;
+    PTI_ASSERT(broker != nullptr);
+
+    uint32_t size = 0;
+    uint32_t sub_device_id = 0;
+    uint32_t group_id = 0;
+    while (broker->Read(buffer->data(), &size, &sub_device_id, &group_id)) {
+      if (sub_device_id >= collector->GetSubDeviceCount() ||
+          group_id >= collector->GetGroupCount()) {
+        continue;
+      }
+
+      uint8_t* storage = collector->GetMetricBuffer(sub_device_id, group_id);
+      PTI_ASSERT(storage != nullptr);
+      memcpy(storage, buffer->data(), size);
+      collector->AppendMetrics(storage, size, sub_device_id, group_id);
+
+      MetricStreamStats& stats = collector->stream_stats_list_[
+          collector->GetStreamId(sub_device_id, group_id)];
+      stats.total_size += size;
+      ++stats.read_count;
+    }
+  }
+
+  // Client side of the shared collection: chunks are taken from the
+  // broker until collection is disabled, then the owner is asked to read
+  // its streamers once more, so the reports of the last kernels come too
+  static void Subscribe(MetricCollector* collector) {
+    PTI_ASSERT(collector != nullptr);
+    MetricBroker* broker = collector->broker_;
+    PTI_ASSERT(broker != nullptr);
+
+    collector->stream_stats_list_.assign(
+        collector->GetStreamCount(), MetricStreamStats{0, 0, 0, 0});
+    std::vector<uint8_t> buffer(CHUNK_SIZE);
+
+    collector->collector_state_.store(
+        COLLECTOR_STATE_ENABLED, std::memory_order_release);
+
+    while (collector->collector_state_.load(std::memory_order_acquire) !=
+           COLLECTOR_STATE_DISABLED) {
+      ReadSharedChunks(collector, &buffer);
+      if (broker->IsOwnerGone()) {
+        break;
+      }
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(METRIC_BROKER_POLL_INTERVAL));
+    }
+
+    uint64_t flush_time = GetCollectionTime();
+    uint64_t deadline = flush_time +
+      static_cast<uint64_t>(METRIC_BROKER_FLUSH_TIMEOUT) * NSEC_IN_MSEC;
+    broker->Flush(flush_time);
+    while (!broker->IsFlushed(flush_time) && !broker->IsOwnerGone() &&
+           GetCollectionTime() < deadline) {
+      ReadSharedChunks(collector, &buffer);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    bool flushed = broker->IsFlushed(flush_time);
+    ReadSharedChunks(collector, &buffer);
+    if (!flushed) {
+      std::cerr << "[WARNING] Metric broker (PID " <<
+        broker->GetOwnerPid() << ") stopped or did not respond, " <<
+        "metrics of the last kernels may be missing" << std::endl;
+    }
+  }
+
+  static void Collect(MetricCollector* collector) {
+    PTI_ASSERT(collector != nullptr);
+
+    PTI_ASSERT(collector->context_ != nullptr);
+    PTI_ASSERT(collector->metric_group_list_.size() ==
+               collector->GetStreamCount());
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
 
     PTI_ASSERT(collector->sub_device_list_.size() <
                (std::numeric_limits<uint32_t>::max)());
-    uint32_t sub_device_count =
-      static_cast<uint32_t>(collector->sub_device_list_.size());
+    uint32_t sub_device_count = collector->GetSubDeviceCount();
+    uint32_t group_count = collector->GetGroupCount();
 
     ze_event_pool_desc_t event_pool_desc = {
         ZE_STRUCTURE_TYPE_EVENT_POOL_DESC, nullptr,
@@ -337,7 +815,6 @@ class MetricCollector {
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
 
     std::vector<ze_event_handle_t> event_list;
-    std::vector<zet_metric_streamer_handle_t> metric_streamer_list;
     for (uint32_t i = 0; i < sub_device_count; ++i) {
       ze_event_desc_t event_desc = {
           ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
@@ -346,40 +823,70 @@ class MetricCollector {
       status = zeEventCreate(event_pool, &event_desc, &event);
       PTI_ASSERT(status == ZE_RESULT_SUCCESS);
       event_list.push_back(event);
+    }
 
-      zet_metric_streamer_desc_t metric_streamer_desc = {
-          ZET_STRUCTURE_TYPE_METRIC_STREAMER_DESC,
-          nullptr,
-          REPORT_COUNT,
-          collector->sampling_interval_};
-      zet_metric_streamer_handle_t metric_streamer = nullptr;
-      status = zetMetricStreamerOpen(
-          collector->context_, collector->sub_device_list_[i],
-          collector->metric_group_list_[i], &metric_streamer_desc,
-          event, &metric_streamer);
-      if (status != ZE_RESULT_SUCCESS) {
-        std::cout <<
-          "[WARNING] Sampling interval is not supported" << std::endl;
-        break;
-      }
-
-      metric_streamer_list.push_back(metric_streamer);
+    // Each group keeps its own read schedule, as fill rates differ
+    std::vector<MetricScheduler*> scheduler_list;
+    for (uint32_t i = 0; i < group_count; ++i) {
+      MetricScheduler* scheduler = new MetricScheduler(
+          sub_device_count, collector->sampling_interval_, CHUNK_SIZE / 2,
+          GetCollectionTime());
+      PTI_ASSERT(scheduler != nullptr);
+      scheduler_list.push_back(scheduler);
     }
 
+    std::vector<zet_metric_streamer_handle_t> metric_streamer_list;
+    bool streaming = OpenStreamers(
+        collector, 0, event_list, &metric_streamer_list);
+    bool started = streaming;
+
     collector->collector_state_.store(
         COLLECTOR_STATE_ENABLED, std::memory_order_release);
 
-    if (metric_streamer_list.size() == sub_device_count) {
-      while (collector->collector_state_.load(std::memory_order_acquire) !=
-            COLLECTOR_STATE_DISABLED) {
-        CollectChunk(collector, event_list, metric_streamer_list);
+    uint32_t group_id = 0;
+    while (streaming) {
+      uint64_t deadline = 0;
+      if (group_count > 1) {
+        deadline = GetCollectionTime() + collector->multiplex_period_;
       }
-      CollectChunk(collector, event_list, metric_streamer_list);
+
+      scheduler_list[group_id]->Restart(GetCollectionTime());
+      bool disabled = CollectChunks(
+          collector, group_id, deadline, scheduler_list[group_id],
+          event_list, metric_streamer_list);
+      if (disabled) {
+        break;
+      }
+
+      CloseStreamers(collector, event_list, &metric_streamer_list);
+      group_id = (group_id + 1) % group_count;
+      streaming = OpenStreamers(
+          collector, group_id, event_list, &metric_streamer_list);
     }
 
-    for (auto metric_streamer : metric_streamer_list) {
-      status = zetMetricStreamerClose(metric_streamer);
-      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    CloseStreamers(collector, event_list, &metric_streamer_list);
+
+    collector->stream_stats_list_.clear();
+    if (started) {
+      for (uint32_t i = 0; i < group_count; ++i) {
+        const MetricScheduler* scheduler = scheduler_list[i];
+        for (uint32_t j = 0; j < sub_device_count; ++j) {
+          collector->stream_stats_list_.push_back({
+              scheduler->GetTotalSize(j), scheduler->GetReadCount(j),
+              scheduler->GetEmptyReadCount(j),
+              scheduler->GetDroppedCount(j)});
+          if (scheduler->GetDroppedCount(j) > 0) {
+            std::cerr << "[WARNING] Metric reports were dropped " <<
+              scheduler->GetDroppedCount(j) << " times on sub-device " <<
+              j << " for group " << collector->GetGroupName(i) <<
+              " (streamer buffer overflow)" << std::endl;
+          }
+        }
+      }
+    }
+
+    for (auto scheduler : scheduler_list) {
+      delete scheduler;
     }
 
     for (auto event : event_list) {
@@ -389,12 +896,6 @@ class MetricCollector {
 
     status = zeEventPoolDestroy(event_pool);
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-
-    for (auto sub_device : collector->sub_device_list_) {
-      status = zetContextActivateMetricGroups(
-          collector->context_,sub_device, 0, nullptr);
-      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-    }
   }
 
  private: // Data
@@ -404,13 +905,24 @@ class MetricCollector {
   std::thread* collector_thread_ = nullptr;
   std::atomic<CollectorState> collector_state_{COLLECTOR_STATE_IDLE};
 
+  std::vector<std::string> group_name_list_;
   std::vector<zet_metric_group_handle_t> metric_group_list_;
   MetricStorage* metric_storage_ = nullptr;
   MetricReader* metric_reader_ = nullptr;
+  std::vector<MetricReportStore*> report_store_list_;
 
   std::vector<std::vector<uint8_t> > metric_buffer_;
+  std::vector<MetricStreamStats> stream_stats_list_;
+
+  std::mutex callback_lock_;
+  OnMetricReportsCallback report_callback_ = nullptr;
+  void* report_callback_data_ = nullptr;
 
   uint32_t sampling_interval_ = 0;
+  uint64_t multiplex_period_ = 0;
+
+  MetricBroker* broker_ = nullptr;
+  bool waiting_for_clients_ = false;
 };
 
 #endif // PTI_TOOLS_ONEPROF_METRIC_COLLECTOR_H_
\ No newline at end of file
@@ -0,0 +1,117 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ONEPROF_METRIC_COLUMN_STORE_H_
+#define PTI_TOOLS_ONEPROF_METRIC_COLUMN_STORE_H_
+
+#include <vector>
+
+#include "metric_report_store.h"
+#include "pti_assert.h"
+#include "ze_utils.h"
+
+// Structure-of-arrays copy of a report store: a column of doubles for each
+// metric, converted from typed values in a single pass. Window aggregation
+// over the columns has no per-value type dispatch and reads contiguous
+// memory, so it can be vectorized by the compiler. The copy is built only
+// for aggregation, raw reports are still printed from the report store
+class MetricColumnStore {
+ public: // Interface
+  explicit MetricColumnStore(const MetricReportStore& report_store)
+      : report_count_(report_store.GetReportCount()),
+        metric_count_(report_store.GetReportSize()),
+        type_list_(metric_count_, ZET_VALUE_TYPE_UINT64),
+        value_list_(report_count_ * metric_count_) {
+    if (report_count_ == 0) {
+      return;
+    }
+
+    const zet_typed_value_t* report = report_store.GetReport(0);
+    for (uint32_t i = 0; i < metric_count_; ++i) {
+      type_list_[i] = report[i].type;
+    }
+
+    for (size_t j = 0; j < report_count_; ++j) {
+      report = report_store.GetReport(j);
+      for (uint32_t i = 0; i < metric_count_; ++i) {
+        value_list_[i * report_count_ + j] = GetDouble(report[i]);
+      }
+    }
+  }
+
+  size_t GetReportCount() const {
+    return report_count_;
+  }
+
+  uint32_t GetMetricCount() const {
+    return metric_count_;
+  }
+
+  // Value type of the metric in the first report
+  zet_value_type_t GetType(uint32_t metric_id) const {
+    PTI_ASSERT(metric_id < metric_count_);
+    return type_list_[metric_id];
+  }
+
+  const double* GetColumn(uint32_t metric_id) const {
+    PTI_ASSERT(metric_id < metric_count_);
+    return value_list_.data() + metric_id * report_count_;
+  }
+
+  // Sum of weight_list[i] * value of report first + i over count reports.
+  // Four partial sums keep the loop free of a serial dependency
+  double GetWeightedSum(
+      uint32_t metric_id, size_t first,
+      const double* weight_list, size_t count) const {
+    PTI_ASSERT(first + count <= report_count_);
+    PTI_ASSERT(weight_list != nullptr || count == 0);
+    const double* column = GetColumn(metric_id) + first;
+
+    double sum[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      sum[0] += column[i] * weight_list[i];
+      sum[1] += column[i + 1] * weight_list[i + 1];
+      sum[2] += column[i + 2] * weight_list[i + 2];
+      sum[3] += column[i + 3] * weight_list[i + 3];
+    }
+    for (; i < count; ++i) {
+      sum[0] += column[i] * weight_list[i];
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  }
+
+  MetricColumnStore(const MetricColumnStore& copy) = delete;
+  MetricColumnStore& operator=(const MetricColumnStore& copy) = delete;
+
+ private: // Implementation
+  static double GetDouble(const zet_typed_value_t& value) {
+    switch (value.type) {
+      case ZET_VALUE_TYPE_UINT32:
+        return value.value.ui32;
+      case ZET_VALUE_TYPE_UINT64:
+        return static_cast<double>(value.value.ui64);
+      case ZET_VALUE_TYPE_FLOAT32:
+        return value.value.fp32;
+      case ZET_VALUE_TYPE_FLOAT64:
+        return value.value.fp64;
+      case ZET_VALUE_TYPE_BOOL8:
+        return value.value.b8;
+      default:
+        PTI_ASSERT(0);
+        break;
+    }
+    return 0.0;
+  }
+
+ private: // Data
+  size_t report_count_ = 0;
+  uint32_t metric_count_ = 0;
+  std::vector<zet_value_type_t> type_list_;
+  std::vector<double> value_list_; // Column-major
+};
+
+#endif // PTI_TOOLS_ONEPROF_METRIC_COLUMN_STORE_H_
\ No newline at end of file
@@ -0,0 +1,700 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ONEPROF_METRIC_QUERY_COLLECTOR_H_
+#define PTI_TOOLS_ONEPROF_METRIC_QUERY_COLLECTOR_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <level_zero/layers/zel_tracing_api.h>
+
+#include "metric_aggregator.h"
+#include "ze_device_cache.h"
+#include "ze_utils.h"
+
+#define QUERY_POOL_SIZE  4096
+#define QUERY_READ_DELAY 10 // ms
+
+struct MetricQueryResult {
+  uint64_t call_count;
+  std::vector<zet_typed_value_t> value_list;
+};
+
+using MetricQueryResultMap = std::map<std::string, MetricQueryResult>;
+
+struct MetricQueryStats {
+  uint64_t query_count; // Queries read and calculated
+  uint64_t skipped_count; // Launches not wrapped, all the queries were in use
+  uint64_t lost_count; // Queries not completed by the end of collection
+};
+
+// Wraps every kernel append with the begin and end of an event-based
+// metric query, so counters are attributed to the kernel exactly. Queries
+// and their completion events come from a fixed pool: the worker thread
+// wakes up every QUERY_READ_DELAY ms, takes all the completed queries at
+// once and then calculates and folds their results per kernel name. As a
+// regular command list may be executed again, its queries are returned to
+// the pool only when it is reset or destroyed, and each query is read
+// once; queries of immediate command lists are returned right after
+// reading. If all the queries are in use, the launch is not profiled
+class MetricQueryCollector {
+ public: // Interface
+  static MetricQueryCollector* Create(
+      ze_driver_handle_t driver,
+      ze_device_handle_t device,
+      const char* group_name,
+      uint32_t pool_size = QUERY_POOL_SIZE) {
+    PTI_ASSERT(driver != nullptr);
+    PTI_ASSERT(device != nullptr);
+    PTI_ASSERT(group_name != nullptr);
+    PTI_ASSERT(pool_size > 0);
+
+    zet_metric_group_handle_t group = utils::ze::FindMetricGroup(
+        utils::ze::GetDeviceCapabilities(driver, device, true), device,
+        group_name, ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_EVENT_BASED);
+    if (group == nullptr) {
+      std::cerr << "[WARNING] Unable to find target metric group: " <<
+        group_name << std::endl;
+      return nullptr;
+    }
+
+    ze_context_handle_t context = utils::ze::GetContext(driver);
+    PTI_ASSERT(context != nullptr);
+
+    MetricQueryCollector* collector = new MetricQueryCollector(
+        device, context, group, pool_size);
+    PTI_ASSERT(collector != nullptr);
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    zel_tracer_desc_t tracer_desc = {
+        ZEL_STRUCTURE_TYPE_TRACER_EXP_DESC, nullptr, collector};
+    zel_tracer_handle_t tracer = nullptr;
+    status = zelTracerCreate(&tracer_desc, &tracer);
+    if (status != ZE_RESULT_SUCCESS) {
+      std::cerr << "[WARNING] Unable to create Level Zero tracer" << std::endl;
+      delete collector;
+      return nullptr;
+    }
+
+    collector->EnableMetrics();
+    collector->EnableTracing(tracer);
+    return collector;
+  }
+
+  ~MetricQueryCollector() {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    PTI_ASSERT(!thread_.joinable());
+
+    if (tracer_ != nullptr) {
+      status = zelTracerDestroy(tracer_);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    }
+
+    if (metric_query_pool_ != nullptr) {
+      DisableMetrics();
+    }
+
+    PTI_ASSERT(context_ != nullptr);
+    status = zeContextDestroy(context_);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+
+  // Stops wrapping new launches and reads the rest of the queries, the
+  // ones that are still not completed are counted as lost
+  void DisableCollection() {
+    PTI_ASSERT(tracer_ != nullptr);
+    ze_result_t status = zelTracerSetEnabled(tracer_, false);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  // Available after collection is disabled
+  const MetricQueryResultMap& GetResultMap() const {
+    PTI_ASSERT(!thread_.joinable());
+    return result_map_;
+  }
+
+  MetricQueryStats GetStats() const {
+    PTI_ASSERT(!thread_.joinable());
+    return stats_;
+  }
+
+  std::vector<std::string> GetMetricList() const {
+    return metric_list_;
+  }
+
+  // Totals are summed over the calls, averages and ratios are the mean of
+  // per-call values
+  std::vector<zet_typed_value_t> GetReport(
+      const MetricQueryResult& result) const {
+    PTI_ASSERT(result.value_list.size() == type_list_.size());
+    std::vector<zet_typed_value_t> report = result.value_list;
+    if (result.call_count == 0) {
+      return report;
+    }
+
+    for (size_t i = 0; i < report.size(); ++i) {
+      if (type_list_[i] != METRIC_AGGREGATION_AVERAGE) {
+        continue;
+      }
+      if (report[i].type == ZET_VALUE_TYPE_UINT64) {
+        report[i].value.ui64 /= result.call_count;
+      } else {
+        PTI_ASSERT(report[i].type == ZET_VALUE_TYPE_FLOAT64);
+        report[i].value.fp64 /= result.call_count;
+      }
+    }
+
+    return report;
+  }
+
+  MetricQueryCollector(const MetricQueryCollector& copy) = delete;
+  MetricQueryCollector& operator=(const MetricQueryCollector& copy) = delete;
+
+ private: // Implementation
+  struct QuerySlot {
+    zet_metric_query_handle_t query;
+    ze_event_handle_t event;
+  };
+
+  // Command list is null if the slot can be recycled once it's read,
+  // kernel name is empty if the launch failed and the result is not needed
+  struct PendingQuery {
+    uint32_t slot_id;
+    ze_command_list_handle_t command_list;
+    std::string kernel_name;
+    bool released;
+  };
+
+  struct QueryData {
+    std::string kernel_name;
+    std::vector<uint8_t> raw_data;
+  };
+
+  struct InstanceData {
+    uint32_t slot_id;
+  };
+
+  MetricQueryCollector(
+      ze_device_handle_t device, ze_context_handle_t context,
+      zet_metric_group_handle_t group, uint32_t pool_size)
+      : device_(device), context_(context),
+        metric_group_(group), pool_size_(pool_size) {
+    PTI_ASSERT(device_ != nullptr);
+    PTI_ASSERT(context_ != nullptr);
+    PTI_ASSERT(metric_group_ != nullptr);
+    PTI_ASSERT(pool_size_ > 0);
+
+    uint32_t metric_count = 0;
+    ze_result_t status = zetMetricGet(metric_group_, &metric_count, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    PTI_ASSERT(metric_count > 0);
+
+    std::vector<zet_metric_handle_t> metric_list(metric_count);
+    status = zetMetricGet(metric_group_, &metric_count, metric_list.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    for (auto metric : metric_list) {
+      zet_metric_properties_t metric_props{
+          ZET_STRUCTURE_TYPE_METRIC_PROPERTIES, };
+      status = zetMetricGetProperties(metric, &metric_props);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      metric_list_.push_back(metric_props.name);
+      type_list_.push_back(MetricAggregator::GetAggregationType(
+          metric_props.name, metric_props.metricType));
+    }
+  }
+
+  void EnableTracing(zel_tracer_handle_t tracer) {
+    PTI_ASSERT(tracer != nullptr);
+    tracer_ = tracer;
+
+    zet_core_callbacks_t prologue_callbacks{};
+    zet_core_callbacks_t epilogue_callbacks{};
+
+    prologue_callbacks.CommandList.pfnAppendLaunchKernelCb =
+      OnEnterCommandListAppendLaunch<
+          ze_command_list_append_launch_kernel_params_t>;
+    epilogue_callbacks.CommandList.pfnAppendLaunchKernelCb =
+      OnExitCommandListAppendLaunch<
+          ze_command_list_append_launch_kernel_params_t>;
+
+    prologue_callbacks.CommandList.pfnAppendLaunchCooperativeKernelCb =
+      OnEnterCommandListAppendLaunch<
+          ze_command_list_append_launch_cooperative_kernel_params_t>;
+    epilogue_callbacks.CommandList.pfnAppendLaunchCooperativeKernelCb =
+      OnExitCommandListAppendLaunch<
+          ze_command_list_append_launch_cooperative_kernel_params_t>;
+
+    prologue_callbacks.CommandList.pfnAppendLaunchKernelIndirectCb =
+      OnEnterCommandListAppendLaunch<
+          ze_command_list_append_launch_kernel_indirect_params_t>;
+    epilogue_callbacks.CommandList.pfnAppendLaunchKernelIndirectCb =
+      OnExitCommandListAppendLaunch<
+          ze_command_list_append_launch_kernel_indirect_params_t>;
+
+    epilogue_callbacks.CommandList.pfnCreateImmediateCb =
+      OnExitCommandListCreateImmediate;
+    epilogue_callbacks.CommandList.pfnResetCb = OnExitCommandListReset;
+    epilogue_callbacks.CommandList.pfnDestroyCb = OnExitCommandListDestroy;
+    epilogue_callbacks.Kernel.pfnDestroyCb = OnExitKernelDestroy;
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    status = zelTracerSetPrologues(tracer_, &prologue_callbacks);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zelTracerSetEpilogues(tracer_, &epilogue_callbacks);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zelTracerSetEnabled(tracer_, true);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+
+  // Queries and events are created once for the whole pool
+  void EnableMetrics() {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    status = zetContextActivateMetricGroups(
+        context_, device_, 1, &metric_group_);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    zet_metric_query_pool_desc_t metric_query_pool_desc = {
+        ZET_STRUCTURE_TYPE_METRIC_QUERY_POOL_DESC, nullptr,
+        ZET_METRIC_QUERY_POOL_TYPE_PERFORMANCE, pool_size_};
+    status = zetMetricQueryPoolCreate(
+        context_, device_, metric_group_,
+        &metric_query_pool_desc, &metric_query_pool_);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    PTI_ASSERT(metric_query_pool_ != nullptr);
+
+    ze_event_pool_desc_t event_pool_desc = {
+        ZE_STRUCTURE_TYPE_EVENT_POOL_DESC, nullptr,
+        ZE_EVENT_POOL_FLAG_HOST_VISIBLE, pool_size_};
+    status = zeEventPoolCreate(
+        context_, &event_pool_desc, 0, nullptr, &event_pool_);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    PTI_ASSERT(event_pool_ != nullptr);
+
+    for (uint32_t i = 0; i < pool_size_; ++i) {
+      QuerySlot slot{nullptr, nullptr};
+      status = zetMetricQueryCreate(metric_query_pool_, i, &slot.query);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+      ze_event_desc_t event_desc = {
+          ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+          ZE_EVENT_SCOPE_FLAG_HOST, ZE_EVENT_SCOPE_FLAG_HOST};
+      status = zeEventCreate(event_pool_, &event_desc, &slot.event);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+      slot_list_.push_back(slot);
+      free_slot_list_.push_back(pool_size_ - i - 1);
+    }
+
+    thread_ = std::thread(&MetricQueryCollector::Run, this);
+  }
+
+  void DisableMetrics() {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    for (auto& slot : slot_list_) {
+      status = zeEventDestroy(slot.event);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      status = zetMetricQueryDestroy(slot.query);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    }
+    slot_list_.clear();
+
+    PTI_ASSERT(event_pool_ != nullptr);
+    status = zeEventPoolDestroy(event_pool_);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    PTI_ASSERT(metric_query_pool_ != nullptr);
+    status = zetMetricQueryPoolDestroy(metric_query_pool_);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    status = zetContextActivateMetricGroups(context_, device_, 0, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+
+  // Returns false if all the queries are in flight
+  bool AcquireSlot(uint32_t* slot_id) {
+    PTI_ASSERT(slot_id != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    if (free_slot_list_.empty()) {
+      ++stats_.skipped_count;
+      return false;
+    }
+    *slot_id = free_slot_list_.back();
+    free_slot_list_.pop_back();
+    return true;
+  }
+
+  // Should be called under the lock
+  void RecycleSlot(uint32_t slot_id) {
+    const QuerySlot& slot = slot_list_[slot_id];
+    ze_result_t status = zetMetricQueryReset(slot.query);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zeEventHostReset(slot.event);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    free_slot_list_.push_back(slot_id);
+  }
+
+  void AddPendingQuery(
+      uint32_t slot_id, ze_command_list_handle_t command_list,
+      ze_kernel_handle_t kernel, bool launched) {
+    PTI_ASSERT(command_list != nullptr);
+    PTI_ASSERT(kernel != nullptr);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    std::string kernel_name;
+    if (launched) {
+      auto it = kernel_name_map_.find(kernel);
+      if (it == kernel_name_map_.end()) {
+        it = kernel_name_map_.emplace(
+            kernel, utils::ze::GetKernelName(kernel)).first;
+      }
+      kernel_name = it->second;
+    }
+
+    if (immediate_set_.count(command_list) > 0) {
+      command_list = nullptr;
+    }
+    pending_list_.push_back({slot_id, command_list, kernel_name, false});
+  }
+
+  void AddImmediateCommandList(ze_command_list_handle_t command_list) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    immediate_set_.insert(command_list);
+  }
+
+  // The command list is not executed at the moment, so its queries that
+  // are not completed yet will never be
+  void ReleaseCommandList(ze_command_list_handle_t command_list) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    for (auto& query : pending_list_) {
+      if (query.command_list == command_list) {
+        query.command_list = nullptr;
+        query.released = true;
+      }
+    }
+
+    auto it = done_map_.find(command_list);
+    if (it != done_map_.end()) {
+      for (uint32_t slot_id : it->second) {
+        RecycleSlot(slot_id);
+      }
+      done_map_.erase(it);
+    }
+  }
+
+  void RemoveCommandList(ze_command_list_handle_t command_list) {
+    ReleaseCommandList(command_list);
+    const std::lock_guard<std::mutex> lock(lock_);
+    immediate_set_.erase(command_list);
+  }
+
+  void RemoveKernelName(ze_kernel_handle_t kernel) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    kernel_name_map_.erase(kernel);
+  }
+
+  // Takes raw results of all the completed queries, slots are returned
+  // to the pool or kept until their command list is reset
+  std::vector<QueryData> ReadCompletedQueries(bool last) {
+    std::vector<QueryData> query_data_list;
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    auto it = pending_list_.begin();
+    while (it != pending_list_.end()) {
+      const QuerySlot& slot = slot_list_[it->slot_id];
+      ze_result_t status = zeEventQueryStatus(slot.event);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS ||
+                 status == ZE_RESULT_NOT_READY);
+      if (status != ZE_RESULT_SUCCESS) {
+        if (it->released) {
+          RecycleSlot(it->slot_id);
+          it = pending_list_.erase(it);
+        } else if (last) {
+          if (!it->kernel_name.empty()) {
+            ++stats_.lost_count;
+          }
+          it = pending_list_.erase(it);
+        } else {
+          ++it;
+        }
+        continue;
+      }
+
+      if (!it->kernel_name.empty()) {
+        query_data_list.push_back(ReadQuery(slot, it->kernel_name));
+      }
+
+      if (it->command_list == nullptr) {
+        RecycleSlot(it->slot_id);
+      } else {
+        done_map_[it->command_list].push_back(it->slot_id);
+      }
+      it = pending_list_.erase(it);
+    }
+
+    return query_data_list;
+  }
+
+  static QueryData ReadQuery(
+      const QuerySlot& slot, const std::string& kernel_name) {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    size_t raw_size = 0;
+    status = zetMetricQueryGetData(slot.query, &raw_size, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    PTI_ASSERT(raw_size > 0);
+
+    QueryData query_data{kernel_name, std::vector<uint8_t>(raw_size)};
+    status = zetMetricQueryGetData(
+        slot.query, &raw_size, query_data.raw_data.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    return query_data;
+  }
+
+  std::vector<zet_typed_value_t> Calculate(
+      const std::vector<uint8_t>& raw_data) const {
+    PTI_ASSERT(!raw_data.empty());
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    uint32_t value_count = 0;
+    status = zetMetricGroupCalculateMetricValues(
+        metric_group_, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+        raw_data.size(), raw_data.data(), &value_count, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    PTI_ASSERT(value_count > 0);
+
+    std::vector<zet_typed_value_t> report(value_count);
+    status = zetMetricGroupCalculateMetricValues(
+        metric_group_, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+        raw_data.size(), raw_data.data(), &value_count, report.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    PTI_ASSERT(value_count == metric_list_.size());
+
+    return report;
+  }
+
+  static void AddValue(
+      zet_typed_value_t& total, const zet_typed_value_t& value) {
+    switch (value.type) {
+      case ZET_VALUE_TYPE_UINT32:
+        total.type = ZET_VALUE_TYPE_UINT64;
+        total.value.ui64 += value.value.ui32;
+        break;
+      case ZET_VALUE_TYPE_UINT64:
+        total.type = ZET_VALUE_TYPE_UINT64;
+        total.value.ui64 += value.value.ui64;
+        break;
+      case ZET_VALUE_TYPE_FLOAT32:
+        total.type = ZET_VALUE_TYPE_FLOAT64;
+        total.value.fp64 += value.value.fp32;
+        break;
+      case ZET_VALUE_TYPE_FLOAT64:
+        total.type = ZET_VALUE_TYPE_FLOAT64;
+        total.value.fp64 += value.value.fp64;
+        break;
+      default:
+        PTI_ASSERT(0);
+        break;
+    }
+  }
+
+  // Called on the worker thread only, so results need no lock
+  void AddResult(
+      const std::string& kernel_name,
+      const std::vector<zet_typed_value_t>& report) {
+    PTI_ASSERT(report.size() == type_list_.size());
+
+    MetricQueryResult& result = result_map_[kernel_name];
+    if (result.value_list.empty()) {
+      result.call_count = 0;
+      result.value_list.resize(report.size(), zet_typed_value_t());
+    }
+
+    for (size_t i = 0; i < report.size(); ++i) {
+      switch (type_list_[i]) {
+        case METRIC_AGGREGATION_TOTAL:
+        case METRIC_AGGREGATION_AVERAGE:
+          AddValue(result.value_list[i], report[i]);
+          break;
+        case METRIC_AGGREGATION_FIRST:
+          if (result.call_count == 0) {
+            result.value_list[i] = report[i];
+          }
+          break;
+        default:
+          break;
+      }
+    }
+    ++result.call_count;
+  }
+
+  void Run() {
+    bool last = false;
+    while (!last) {
+      {
+        std::unique_lock<std::mutex> lock(lock_);
+        cv_.wait_for(lock, std::chrono::milliseconds(QUERY_READ_DELAY),
+                     [this] { return stop_; });
+        last = stop_;
+      }
+
+      std::vector<QueryData> query_data_list = ReadCompletedQueries(last);
+      for (auto& query_data : query_data_list) {
+        AddResult(query_data.kernel_name, Calculate(query_data.raw_data));
+      }
+      stats_.query_count += query_data_list.size();
+    }
+  }
+
+ private: // Callbacks
+  template <typename Params>
+  static void OnEnterCommandListAppendLaunch(
+      Params* params, ze_result_t result,
+      void* global_data, void** instance_data) {
+    MetricQueryCollector* collector =
+      reinterpret_cast<MetricQueryCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+    *instance_data = nullptr;
+
+    uint32_t slot_id = 0;
+    if (!collector->AcquireSlot(&slot_id)) {
+      return;
+    }
+
+    ze_command_list_handle_t command_list = *(params->phCommandList);
+    PTI_ASSERT(command_list != nullptr);
+
+    ze_result_t status = zetCommandListAppendMetricQueryBegin(
+        command_list, collector->slot_list_[slot_id].query);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    InstanceData* data = new InstanceData{slot_id};
+    PTI_ASSERT(data != nullptr);
+    *instance_data = reinterpret_cast<void*>(data);
+  }
+
+  // The end of the query is appended even if the launch failed, to keep
+  // begin and end paired, but the result of such a query is not used
+  template <typename Params>
+  static void OnExitCommandListAppendLaunch(
+      Params* params, ze_result_t result,
+      void* global_data, void** instance_data) {
+    InstanceData* data = reinterpret_cast<InstanceData*>(*instance_data);
+    if (data == nullptr) {
+      return;
+    }
+
+    MetricQueryCollector* collector =
+      reinterpret_cast<MetricQueryCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+
+    ze_command_list_handle_t command_list = *(params->phCommandList);
+    PTI_ASSERT(command_list != nullptr);
+
+    const QuerySlot& slot = collector->slot_list_[data->slot_id];
+    ze_result_t status = zetCommandListAppendMetricQueryEnd(
+        command_list, slot.query, slot.event, 0, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    collector->AddPendingQuery(
+        data->slot_id, command_list, *(params->phKernel),
+        result == ZE_RESULT_SUCCESS);
+    delete data;
+  }
+
+  static void OnExitCommandListCreateImmediate(
+      ze_command_list_create_immediate_params_t* params, ze_result_t result,
+      void* global_data, void** instance_data) {
+    if (result == ZE_RESULT_SUCCESS) {
+      MetricQueryCollector* collector =
+        reinterpret_cast<MetricQueryCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->AddImmediateCommandList(**(params->pphCommandList));
+    }
+  }
+
+  static void OnExitCommandListReset(
+      ze_command_list_reset_params_t* params, ze_result_t result,
+      void* global_data, void** instance_data) {
+    if (result == ZE_RESULT_SUCCESS) {
+      MetricQueryCollector* collector =
+        reinterpret_cast<MetricQueryCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->ReleaseCommandList(*(params->phCommandList));
+    }
+  }
+
+  static void OnExitCommandListDestroy(
+      ze_command_list_destroy_params_t* params, ze_result_t result,
+      void* global_data, void** instance_data) {
+    if (result == ZE_RESULT_SUCCESS) {
+      MetricQueryCollector* collector =
+        reinterpret_cast<MetricQueryCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->RemoveCommandList(*(params->phCommandList));
+    }
+  }
+
+  static void OnExitKernelDestroy(
+      ze_kernel_destroy_params_t* params, ze_result_t result,
+      void* global_data, void** instance_data) {
+    if (result == ZE_RESULT_SUCCESS) {
+      MetricQueryCollector* collector =
+        reinterpret_cast<MetricQueryCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->RemoveKernelName(*(params->phKernel));
+    }
+  }
+
+ private: // Data
+  ze_device_handle_t device_ = nullptr;
+  ze_context_handle_t context_ = nullptr;
+  zel_tracer_handle_t tracer_ = nullptr;
+
+  zet_metric_group_handle_t metric_group_ = nullptr;
+  zet_metric_query_pool_handle_t metric_query_pool_ = nullptr;
+  ze_event_pool_handle_t event_pool_ = nullptr;
+  uint32_t pool_size_ = 0;
+
+  std::vector<std::string> metric_list_;
+  std::vector<MetricAggregationType> type_list_;
+
+  // Slot list is filled before tracing starts and is not changed then
+  std::vector<QuerySlot> slot_list_;
+
+  std::mutex lock_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::vector<uint32_t> free_slot_list_;
+  std::vector<PendingQuery> pending_list_;
+  std::map<ze_command_list_handle_t, std::vector<uint32_t> > done_map_;
+  std::set<ze_command_list_handle_t> immediate_set_;
+  std::map<ze_kernel_handle_t, std::string> kernel_name_map_;
+  MetricQueryStats stats_{0, 0, 0};
+
+  std::thread thread_;
+  MetricQueryResultMap result_map_;
+};
+
+#endif // PTI_TOOLS_ONEPROF_METRIC_QUERY_COLLECTOR_H_
\ No newline at end of file
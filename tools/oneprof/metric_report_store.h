@@ -0,0 +1,112 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ONEPROF_METRIC_REPORT_STORE_H_
+#define PTI_TOOLS_ONEPROF_METRIC_REPORT_STORE_H_
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "pti_assert.h"
+#include "ze_utils.h"
+
+// Calculated metric reports of one sub-device, sorted by report time.
+// Built once from the raw stream, so that reports of any time window can
+// be found with a binary search over the time index
+class MetricReportStore {
+ public: // Interface
+  MetricReportStore(uint32_t report_size, uint32_t report_time_id)
+      : report_size_(report_size), report_time_id_(report_time_id) {
+    PTI_ASSERT(report_size_ > 0);
+    PTI_ASSERT(report_time_id_ < report_size_);
+  }
+
+  void AddReports(const std::vector<zet_typed_value_t>& report_chunk) {
+    PTI_ASSERT(!sealed_);
+    size_t report_count = report_chunk.size() / report_size_;
+    PTI_ASSERT(report_count * report_size_ == report_chunk.size());
+
+    for (size_t i = 0; i < report_count; ++i) {
+      const zet_typed_value_t* report =
+        report_chunk.data() + i * report_size_;
+      PTI_ASSERT(report[report_time_id_].type == ZET_VALUE_TYPE_UINT64);
+      time_list_.push_back(report[report_time_id_].value.ui64);
+    }
+    value_list_.insert(
+        value_list_.end(), report_chunk.begin(), report_chunk.end());
+  }
+
+  // Streamer reports normally come in time order, so sorting is needed
+  // only if the stream has some reordered reports
+  void Seal() {
+    PTI_ASSERT(!sealed_);
+    sealed_ = true;
+
+    if (std::is_sorted(time_list_.begin(), time_list_.end())) {
+      return;
+    }
+
+    std::vector<size_t> order(time_list_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [this](size_t left, size_t right) {
+          return time_list_[left] < time_list_[right];
+        });
+
+    std::vector<uint64_t> time_list(time_list_.size());
+    std::vector<zet_typed_value_t> value_list(value_list_.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      time_list[i] = time_list_[order[i]];
+      std::copy(
+          value_list_.begin() + order[i] * report_size_,
+          value_list_.begin() + (order[i] + 1) * report_size_,
+          value_list.begin() + i * report_size_);
+    }
+    time_list_.swap(time_list);
+    value_list_.swap(value_list);
+  }
+
+  uint32_t GetReportSize() const {
+    return report_size_;
+  }
+
+  size_t GetReportCount() const {
+    return time_list_.size();
+  }
+
+  const zet_typed_value_t* GetReport(size_t report_id) const {
+    PTI_ASSERT(report_id < time_list_.size());
+    return value_list_.data() + report_id * report_size_;
+  }
+
+  // Returns [first, last) range of reports with time within [start, end]
+  void FindReports(
+      uint64_t start, uint64_t end, size_t* first, size_t* last) const {
+    PTI_ASSERT(sealed_);
+    PTI_ASSERT(first != nullptr && last != nullptr);
+    PTI_ASSERT(start <= end);
+
+    *first = std::lower_bound(time_list_.begin(), time_list_.end(), start) -
+      time_list_.begin();
+    *last = std::upper_bound(
+        time_list_.begin() + *first, time_list_.end(), end) -
+      time_list_.begin();
+  }
+
+  MetricReportStore(const MetricReportStore& copy) = delete;
+  MetricReportStore& operator=(const MetricReportStore& copy) = delete;
+
+ private: // Data
+  uint32_t report_size_ = 0;
+  uint32_t report_time_id_ = 0;
+  bool sealed_ = false;
+
+  std::vector<uint64_t> time_list_;
+  std::vector<zet_typed_value_t> value_list_;
+};
+
+#endif // PTI_TOOLS_ONEPROF_METRIC_REPORT_STORE_H_
@@ -0,0 +1,149 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ONEPROF_METRIC_SCHEDULER_H_
+#define PTI_TOOLS_ONEPROF_METRIC_SCHEDULER_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "pti_assert.h"
+
+#define MIN_READ_DELAY  1000000  // ns
+#define MAX_READ_DELAY  50000000 // ns
+
+// Decides when each metric streamer should be read next. The delay is
+// chosen so that about target_size bytes are collected between two reads,
+// based on the observed fill rate of the streamer, and is never shorter
+// than the sampling interval. Overflows make the next read happen as soon
+// as possible. Time is in ns and is provided by the caller.
+class MetricScheduler {
+ public: // Interface
+  MetricScheduler(
+      uint32_t sub_device_count, uint64_t sampling_interval,
+      uint64_t target_size, uint64_t now)
+      : sub_device_list_(sub_device_count),
+        target_size_(target_size),
+        min_delay_((std::max)(
+            sampling_interval, static_cast<uint64_t>(MIN_READ_DELAY))),
+        max_delay_((std::max)(
+            min_delay_, static_cast<uint64_t>(MAX_READ_DELAY))) {
+    PTI_ASSERT(sub_device_count > 0);
+    PTI_ASSERT(target_size_ > 0);
+    Restart(now);
+  }
+
+  // Should be called when the streamers are reopened after a pause, e.g.
+  // on metric group switch; observed fill rates are kept
+  void Restart(uint64_t now) {
+    for (auto& sub_device : sub_device_list_) {
+      sub_device.last_read_time = now;
+      sub_device.next_read_time = now + min_delay_;
+    }
+  }
+
+  // Returns sub-device to be read first and time to wait before that
+  uint32_t GetNextSubDevice(uint64_t now, uint64_t* wait_time) const {
+    PTI_ASSERT(wait_time != nullptr);
+    uint32_t next = 0;
+    for (uint32_t i = 1; i < sub_device_list_.size(); ++i) {
+      if (sub_device_list_[i].next_read_time <
+          sub_device_list_[next].next_read_time) {
+        next = i;
+      }
+    }
+
+    uint64_t next_read_time = sub_device_list_[next].next_read_time;
+    *wait_time = (next_read_time > now) ? next_read_time - now : 0;
+    return next;
+  }
+
+  bool IsReadRequired(uint32_t sub_device_id, uint64_t now) const {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    return sub_device_list_[sub_device_id].next_read_time <= now;
+  }
+
+  void Update(
+      uint32_t sub_device_id, uint64_t now, uint64_t size, bool dropped) {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    SubDeviceData& sub_device = sub_device_list_[sub_device_id];
+
+    ++sub_device.read_count;
+    sub_device.total_size += size;
+    if (size == 0) {
+      ++sub_device.empty_read_count;
+    }
+    if (dropped) {
+      ++sub_device.dropped_count;
+    }
+
+    uint64_t elapsed = now - sub_device.last_read_time;
+    sub_device.last_read_time = now;
+    if (elapsed > 0) {
+      // Exponential moving average, each new sample has weight of 1/4
+      double rate = static_cast<double>(size) / elapsed;
+      sub_device.fill_rate = (sub_device.fill_rate == 0.0) ?
+        rate : (3.0 * sub_device.fill_rate + rate) / 4.0;
+    }
+
+    uint64_t delay = max_delay_;
+    if (dropped) {
+      delay = min_delay_;
+    } else if (sub_device.fill_rate > 0.0) {
+      double target_delay = target_size_ / sub_device.fill_rate;
+      if (target_delay < static_cast<double>(max_delay_)) {
+        delay = (std::max)(static_cast<uint64_t>(target_delay), min_delay_);
+      }
+    }
+    sub_device.next_read_time = now + delay;
+  }
+
+  uint64_t GetReadCount(uint32_t sub_device_id) const {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    return sub_device_list_[sub_device_id].read_count;
+  }
+
+  uint64_t GetEmptyReadCount(uint32_t sub_device_id) const {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    return sub_device_list_[sub_device_id].empty_read_count;
+  }
+
+  // Number of reads that reported lost data due to buffer overflow
+  uint64_t GetDroppedCount(uint32_t sub_device_id) const {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    return sub_device_list_[sub_device_id].dropped_count;
+  }
+
+  uint64_t GetTotalSize(uint32_t sub_device_id) const {
+    PTI_ASSERT(sub_device_id < sub_device_list_.size());
+    return sub_device_list_[sub_device_id].total_size;
+  }
+
+  MetricScheduler(const MetricScheduler& copy) = delete;
+  MetricScheduler& operator=(const MetricScheduler& copy) = delete;
+
+ private: // Implementation
+  struct SubDeviceData {
+    uint64_t last_read_time = 0;
+    uint64_t next_read_time = 0;
+    double fill_rate = 0.0; // bytes per ns
+
+    uint64_t read_count = 0;
+    uint64_t empty_read_count = 0;
+    uint64_t dropped_count = 0;
+    uint64_t total_size = 0;
+  };
+
+ private: // Data
+  std::vector<SubDeviceData> sub_device_list_;
+  uint64_t target_size_ = 0;
+  uint64_t min_delay_ = 0;
+  uint64_t max_delay_ = 0;
+};
+
+#endif // PTI_TOOLS_ONEPROF_METRIC_SCHEDULER_H_
@@ -7,14 +7,39 @@
 #ifndef PTI_TOOLS_ONEPROF_METRIC_STORAGE_H_
 #define PTI_TOOLS_ONEPROF_METRIC_STORAGE_H_
 
-#include <cstring>
+#if defined(_WIN32)
 #include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "utils.h"
 
 #define CACHE_SIZE 16777216
 
+inline std::string GetMetricFileName(uint32_t storage_id) {
+  return std::string("data.") + std::to_string(utils::GetPid()) +
+    "." + std::to_string(storage_id) + ".bin";
+}
+
+// Both storage implementations have the same interface: the collector
+// asks for a buffer, lets the streamer fill it and commits the filled
+// part; the reader returns pointers to stored data that remain valid
+// until the next ReadChunk call for the same storage. GetChunk gives
+// random access to the chunks and may be called from several threads,
+// its pointer is valid until the next GetChunk call on the same thread
+
+#if defined(_WIN32)
+
 struct CacheBuffer {
   std::vector<uint8_t> buffer = std::vector<uint8_t>(CACHE_SIZE);
   size_t used_size = 0;
@@ -24,12 +49,10 @@ class MetricStorage {
  public:
   MetricStorage(uint32_t count) {
     for (uint32_t i = 0; i < count; ++i) {
-      std::string filename =
-        std::string("data.") + std::to_string(utils::GetPid()) +
-        "." + std::to_string(i) + ".bin";
       storage_.emplace(
           storage_.end(),
-          std::ofstream(filename, std::ios::out | std::ios::binary));
+          std::ofstream(GetMetricFileName(i),
+                        std::ios::out | std::ios::binary));
       PTI_ASSERT(storage_.back().is_open());
 
       cache_.emplace_back(CacheBuffer());
@@ -40,12 +63,7 @@ class MetricStorage {
     PTI_ASSERT(storage_.size() == cache_.size());
 
     for (size_t i = 0; i < cache_.size(); ++i) {
-      if (cache_[i].used_size > 0) {
-        const char* buffer = reinterpret_cast<const char*>(
-            cache_[i].buffer.data());
-        storage_[i].write(
-            buffer, cache_[i].used_size * sizeof(uint8_t));
-      }
+      Flush(i);
     }
 
     for (auto& storage : storage_) {
@@ -53,27 +71,37 @@ class MetricStorage {
     }
   }
 
-  void Dump(const uint8_t* data, uint32_t size, uint32_t storage_id) {
-    PTI_ASSERT(data != nullptr);
+  uint8_t* GetBuffer(uint32_t size, uint32_t storage_id) {
     PTI_ASSERT(size > 0);
-    PTI_ASSERT(storage_id < storage_.size());
     PTI_ASSERT(storage_id < cache_.size());
+    PTI_ASSERT(size <= cache_[storage_id].buffer.size());
 
     if (cache_[storage_id].used_size + size >
         cache_[storage_id].buffer.size()) {
+      Flush(storage_id);
+    }
+
+    return cache_[storage_id].buffer.data() + cache_[storage_id].used_size;
+  }
+
+  void Commit(uint32_t size, uint32_t storage_id) {
+    PTI_ASSERT(storage_id < cache_.size());
+    PTI_ASSERT(cache_[storage_id].used_size + size <=
+               cache_[storage_id].buffer.size());
+    cache_[storage_id].used_size += size;
+  }
+
+ private:
+  void Flush(size_t storage_id) {
+    PTI_ASSERT(storage_id < storage_.size());
+    PTI_ASSERT(storage_id < cache_.size());
+    if (cache_[storage_id].used_size > 0) {
       const char* buffer = reinterpret_cast<const char*>(
           cache_[storage_id].buffer.data());
       storage_[storage_id].write(
           buffer, cache_[storage_id].used_size * sizeof(uint8_t));
       cache_[storage_id].used_size = 0;
     }
-
-    PTI_ASSERT(cache_[storage_id].used_size + size <=
-               cache_[storage_id].buffer.size());
-    memcpy(
-        cache_[storage_id].buffer.data() + cache_[storage_id].used_size,
-        data, size * sizeof(uint8_t));
-    cache_[storage_id].used_size += size;
   }
 
  private:
@@ -83,14 +111,12 @@ class MetricStorage {
 
 class MetricReader {
  public:
-  MetricReader(uint32_t count) {
+  MetricReader(uint32_t count) : buffer_(count) {
     for (uint32_t i = 0; i < count; ++i) {
-      std::string filename =
-        std::string("data.") + std::to_string(utils::GetPid()) +
-        "." + std::to_string(i) + ".bin";
       storage_.emplace(
           storage_.end(),
-          std::ifstream(filename, std::ios::in | std::ios::binary));
+          std::ifstream(GetMetricFileName(i),
+                        std::ios::in | std::ios::binary));
       PTI_ASSERT(storage_.back().is_open());
     }
   }
@@ -102,18 +128,62 @@ class MetricReader {
     }
   }
 
-  std::vector<uint8_t> ReadChunk(uint32_t size, uint32_t storage_id) {
+  // Returns nullptr once all the data is read
+  const uint8_t* ReadChunk(
+      uint32_t size, uint32_t storage_id, uint32_t* chunk_size) {
     PTI_ASSERT(storage_id < storage_.size());
+    PTI_ASSERT(chunk_size != nullptr);
+    *chunk_size = 0;
     if (storage_[storage_id].eof()) {
-      return std::vector<uint8_t>();
+      return nullptr;
     }
 
-    std::vector<uint8_t> data(size);
+    std::vector<uint8_t>& data = buffer_[storage_id];
+    data.resize(size);
     storage_[storage_id].read(reinterpret_cast<char*>(data.data()), size);
-    if (storage_[storage_id].gcount() < size) {
-      data.resize(storage_[storage_id].gcount());
+    *chunk_size = static_cast<uint32_t>(storage_[storage_id].gcount());
+    if (*chunk_size == 0) {
+      return nullptr;
     }
-    return data;
+    return data.data();
+  }
+
+  uint32_t GetChunkCount(uint32_t size, uint32_t storage_id) {
+    PTI_ASSERT(size > 0);
+    PTI_ASSERT(storage_id < storage_.size());
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    std::ifstream& storage = storage_[storage_id];
+    std::streampos position = storage.tellg();
+    storage.clear();
+    storage.seekg(0, storage.end);
+    uint64_t total_size = storage.tellg();
+    storage.seekg(position);
+    return static_cast<uint32_t>((total_size + size - 1) / size);
+  }
+
+  const uint8_t* GetChunk(
+      uint32_t size, uint32_t chunk_id, uint32_t storage_id,
+      uint32_t* chunk_size) {
+    PTI_ASSERT(storage_id < storage_.size());
+    PTI_ASSERT(chunk_size != nullptr);
+
+    thread_local std::vector<uint8_t> data;
+    data.resize(size);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    std::ifstream& storage = storage_[storage_id];
+    std::streampos position = storage.tellg();
+    storage.clear();
+    storage.seekg(static_cast<uint64_t>(chunk_id) * size, storage.beg);
+    storage.read(reinterpret_cast<char*>(data.data()), size);
+    *chunk_size = static_cast<uint32_t>(storage.gcount());
+    storage.clear();
+    storage.seekg(position);
+    if (*chunk_size == 0) {
+      return nullptr;
+    }
+    return data.data();
   }
 
   ~MetricReader() {
@@ -124,6 +194,176 @@ class MetricReader {
 
  private:
   std::vector<std::ifstream> storage_;
+  std::vector<std::vector<uint8_t> > buffer_;
+  std::mutex lock_;
+};
+
+#else // _WIN32
+
+struct MappedBuffer {
+  int file = -1;
+  uint8_t* data = nullptr;
+  size_t capacity = 0;
+  size_t used_size = 0;
+};
+
+// Streamer data goes directly into the mapped file, which grows twice
+// each time it runs out of space
+class MetricStorage {
+ public:
+  MetricStorage(uint32_t count) : storage_(count) {
+    for (uint32_t i = 0; i < count; ++i) {
+      storage_[i].file = open(
+          GetMetricFileName(i).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      PTI_ASSERT(storage_[i].file >= 0);
+    }
+  }
+
+  ~MetricStorage() {
+    for (auto& storage : storage_) {
+      if (storage.data != nullptr) {
+        int status = munmap(storage.data, storage.capacity);
+        PTI_ASSERT(status == 0);
+      }
+
+      int status = ftruncate(storage.file, storage.used_size);
+      PTI_ASSERT(status == 0);
+      close(storage.file);
+    }
+  }
+
+  uint8_t* GetBuffer(uint32_t size, uint32_t storage_id) {
+    PTI_ASSERT(size > 0);
+    PTI_ASSERT(storage_id < storage_.size());
+    MappedBuffer& storage = storage_[storage_id];
+
+    if (storage.used_size + size > storage.capacity) {
+      Grow(storage, storage.used_size + size);
+    }
+
+    return storage.data + storage.used_size;
+  }
+
+  void Commit(uint32_t size, uint32_t storage_id) {
+    PTI_ASSERT(storage_id < storage_.size());
+    PTI_ASSERT(storage_[storage_id].used_size + size <=
+               storage_[storage_id].capacity);
+    storage_[storage_id].used_size += size;
+  }
+
+ private:
+  static void Grow(MappedBuffer& storage, size_t required_size) {
+    size_t capacity = (std::max)(
+        (std::max)(storage.capacity * 2, required_size),
+        static_cast<size_t>(CACHE_SIZE));
+
+    if (storage.data != nullptr) {
+      int status = munmap(storage.data, storage.capacity);
+      PTI_ASSERT(status == 0);
+    }
+
+    int status = ftruncate(storage.file, capacity);
+    PTI_ASSERT(status == 0);
+
+    void* data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, storage.file, 0);
+    PTI_ASSERT(data != MAP_FAILED);
+
+    storage.data = static_cast<uint8_t*>(data);
+    storage.capacity = capacity;
+  }
+
+ private:
+  std::vector<MappedBuffer> storage_;
 };
 
-#endif // PTI_TOOLS_ONEPROF_METRIC_STORAGE_H_
\ No newline at end of file
+// Data is read in place from the read-only mapping of each file
+class MetricReader {
+ public:
+  MetricReader(uint32_t count) : storage_(count), offset_(count, 0) {
+    for (uint32_t i = 0; i < count; ++i) {
+      MappedBuffer& storage = storage_[i];
+      storage.file = open(GetMetricFileName(i).c_str(), O_RDONLY);
+      PTI_ASSERT(storage.file >= 0);
+
+      struct stat file_stat{};
+      int status = fstat(storage.file, &file_stat);
+      PTI_ASSERT(status == 0);
+      storage.used_size = storage.capacity = file_stat.st_size;
+
+      if (storage.capacity > 0) {
+        void* data = mmap(nullptr, storage.capacity, PROT_READ,
+                          MAP_PRIVATE, storage.file, 0);
+        PTI_ASSERT(data != MAP_FAILED);
+        storage.data = static_cast<uint8_t*>(data);
+      }
+    }
+  }
+
+  void Reset() {
+    std::fill(offset_.begin(), offset_.end(), 0);
+  }
+
+  // Returns nullptr once all the data is read
+  const uint8_t* ReadChunk(
+      uint32_t size, uint32_t storage_id, uint32_t* chunk_size) {
+    PTI_ASSERT(storage_id < storage_.size());
+    PTI_ASSERT(chunk_size != nullptr);
+
+    const MappedBuffer& storage = storage_[storage_id];
+    PTI_ASSERT(offset_[storage_id] <= storage.used_size);
+    *chunk_size = static_cast<uint32_t>((std::min)(
+        static_cast<size_t>(size), storage.used_size - offset_[storage_id]));
+    if (*chunk_size == 0) {
+      return nullptr;
+    }
+
+    const uint8_t* data = storage.data + offset_[storage_id];
+    offset_[storage_id] += *chunk_size;
+    return data;
+  }
+
+  uint32_t GetChunkCount(uint32_t size, uint32_t storage_id) const {
+    PTI_ASSERT(size > 0);
+    PTI_ASSERT(storage_id < storage_.size());
+    return static_cast<uint32_t>(
+        (storage_[storage_id].used_size + size - 1) / size);
+  }
+
+  // Mapping is read-only, so no locking is needed here
+  const uint8_t* GetChunk(
+      uint32_t size, uint32_t chunk_id, uint32_t storage_id,
+      uint32_t* chunk_size) const {
+    PTI_ASSERT(storage_id < storage_.size());
+    PTI_ASSERT(chunk_size != nullptr);
+
+    const MappedBuffer& storage = storage_[storage_id];
+    size_t offset = static_cast<size_t>(chunk_id) * size;
+    if (offset >= storage.used_size) {
+      *chunk_size = 0;
+      return nullptr;
+    }
+
+    *chunk_size = static_cast<uint32_t>((std::min)(
+        static_cast<size_t>(size), storage.used_size - offset));
+    return storage.data + offset;
+  }
+
+  ~MetricReader() {
+    for (auto& storage : storage_) {
+      if (storage.data != nullptr) {
+        int status = munmap(storage.data, storage.capacity);
+        PTI_ASSERT(status == 0);
+      }
+      close(storage.file);
+    }
+  }
+
+ private:
+  std::vector<MappedBuffer> storage_;
+  std::vector<size_t> offset_;
+};
+
+#endif // _WIN32
+
+#endif // PTI_TOOLS_ONEPROF_METRIC_STORAGE_H_
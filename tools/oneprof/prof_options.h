@@ -9,7 +9,9 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
+#include "capture_control.h"
 #include "pti_assert.h"
 #include "utils.h"
 
@@ -17,6 +19,12 @@
 #define PROF_KERNEL_METRICS    1
 #define PROF_KERNEL_INTERVALS  2
 #define PROF_AGGREGATION       3
+#define PROF_ONLINE_AGGREGATION 4
+#define PROF_ITT               5
+#define PROF_SYSMAN_COUNTERS   6
+#define PROF_METRIC_QUERY      7
+#define PROF_ROOFLINE          8
+#define PROF_SHARED_METRICS    9
 
 class ProfOptions {
  public:
@@ -25,12 +33,18 @@ class ProfOptions {
       uint32_t device_id,
       uint32_t sampling_interval,
       const std::string& metric_group,
-      const std::string& log_file)
+      uint64_t multiplex_period,
+      const std::string& log_file,
+      const std::string& arrow_file = std::string(),
+      const CaptureOptions& capture = CaptureOptions())
       : flags_(flags),
         device_id_(device_id),
         sampling_interval_(sampling_interval),
         metric_group_(metric_group),
-        log_file_(log_file) {}
+        multiplex_period_(multiplex_period),
+        log_file_(log_file),
+        arrow_file_(arrow_file),
+        capture_(capture) {}
 
   bool CheckFlag(uint32_t flag) const {
     return (flags_ & (1 << flag));
@@ -48,18 +62,57 @@ class ProfOptions {
     return metric_group_;
   }
 
+  // Several comma-separated groups are collected in turns
+  std::vector<std::string> GetMetricGroupList() const {
+    std::vector<std::string> group_list;
+    std::stringstream stream(metric_group_);
+    std::string group;
+    while (std::getline(stream, group, ',')) {
+      if (!group.empty()) {
+        group_list.push_back(group);
+      }
+    }
+    return group_list;
+  }
+
+  // Time each metric group is collected before switching to the next one,
+  // in ns
+  uint64_t GetMultiplexPeriod() const {
+    return multiplex_period_;
+  }
+
+  // Conditions of the capture window, see CaptureControl
+  const CaptureOptions& GetCaptureOptions() const {
+    return capture_;
+  }
+
   std::string GetLogFileName() const {
     if (log_file_.empty()) {
       return std::string();
     }
+    return GetUniqueFileName(log_file_);
+  }
+
+  bool IsArrowOutput() const {
+    return !arrow_file_.empty();
+  }
 
+  // Each exported table goes to its own file, e.g. data.<pid>.raw.arrow
+  std::string GetArrowFileName(const std::string& table) const {
+    PTI_ASSERT(!arrow_file_.empty());
+    PTI_ASSERT(!table.empty());
+    return GetUniqueFileName(arrow_file_ + "." + table + ".arrow");
+  }
+
+ private:
+  static std::string GetUniqueFileName(const std::string& file_name) {
     std::stringstream result;
 
-    size_t pos = log_file_.find_first_of('.');
+    size_t pos = file_name.find_first_of('.');
     if (pos == std::string::npos) {
-      result << log_file_;
+      result << file_name;
     } else {
-      result << log_file_.substr(0, pos);
+      result << file_name.substr(0, pos);
     }
 
     result << "." + std::to_string(utils::GetPid());
@@ -70,7 +123,7 @@ class ProfOptions {
     }
 
     if (pos != std::string::npos) {
-      result << log_file_.substr(pos);
+      result << file_name.substr(pos);
     }
 
     return result.str();
@@ -81,7 +134,10 @@ class ProfOptions {
   uint32_t device_id_;
   uint32_t sampling_interval_;
   std::string log_file_;
+  std::string arrow_file_;
   std::string metric_group_;
+  uint64_t multiplex_period_;
+  CaptureOptions capture_;
 };
 
 #endif // PTI_TOOLS_ONEPROF_PROF_OPTIONS_H_
\ No newline at end of file
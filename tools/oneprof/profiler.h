@@ -7,18 +7,31 @@
 #ifndef PTI_TOOLS_ONEPROF_PROFILER_H_
 #define PTI_TOOLS_ONEPROF_PROFILER_H_
 
+#include <limits>
+#include <mutex>
 #include <sstream>
 
+#include "arrow_writer.h"
+#include "capture_control.h"
+#include "itt_collector.h"
 #include "logger.h"
+#include "metric_aggregator.h"
+#include "metric_attributor.h"
 #include "metric_collector.h"
+#include "metric_query_collector.h"
+#include "overhead.h"
 #include "prof_options.h"
 #include "prof_utils.h"
+#include "roofline.h"
+#include "sysman_sampler.h"
+#include "thread_identity.h"
+#include "ze_device_cache.h"
 #include "cl_kernel_collector.h"
 #include "ze_kernel_collector.h"
 
 namespace detail {
 
-template <typename KernelInterval>
+template <typename Store>
 uint64_t ConvertTimestamp(
     uint64_t timestamp, uint64_t device_freq,
     uint64_t host_sync, uint64_t device_sync) {
@@ -26,7 +39,7 @@ uint64_t ConvertTimestamp(
 }
 
 template <>
-uint64_t ConvertTimestamp<ClKernelInterval>(
+uint64_t ConvertTimestamp<ClKernelIntervalStore>(
     uint64_t timestamp, uint64_t device_freq,
     uint64_t host_sync, uint64_t device_sync) {
   PTI_ASSERT(timestamp > host_sync);
@@ -37,6 +50,18 @@ uint64_t ConvertTimestamp<ClKernelInterval>(
 
 } // namespace detail
 
+struct IttTaskInterval {
+  std::string domain;
+  std::string name;
+  uint32_t tid;
+  uint64_t start;
+  uint64_t end;
+};
+
+// Attributed reports of each metric stream, one per device interval
+using StreamReportList =
+  std::vector<std::vector<std::vector<zet_typed_value_t> > >;
+
 class Profiler {
  public:
   static Profiler* Create(const ProfOptions& options) {
@@ -57,12 +82,82 @@ class Profiler {
         options, options.GetDeviceId(), sub_device_count);
     PTI_ASSERT(profiler != nullptr);
 
+    CaptureOptions capture_options = options.GetCaptureOptions();
+    capture_options.external = profiler->CheckOption(PROF_ITT);
+    profiler->capture_ = CaptureControl::Create(capture_options);
+
+    if (profiler->CheckOption(PROF_ITT)) {
+      profiler->itt_collector_ = IttCollector::Create(
+          &(profiler->correlator_), profiler->capture_,
+          OnIttTaskFinish, profiler);
+      if (profiler->itt_collector_ == nullptr) {
+        delete profiler;
+        return nullptr;
+      }
+    }
+
+    if (profiler->CheckOption(PROF_SYSMAN_COUNTERS)) {
+      profiler->sysman_sampler_ = SysmanSampler::Create(
+          GetSysmanTimestamp, profiler);
+      if (profiler->sysman_sampler_ != nullptr &&
+          profiler->device_id_ >=
+            profiler->sysman_sampler_->GetDeviceCount()) {
+        delete profiler->sysman_sampler_;
+        profiler->sysman_sampler_ = nullptr;
+      }
+    }
+
+    if (profiler->CheckOption(PROF_METRIC_QUERY)) {
+      // Streamer and query collection can't share the device
+      if (profiler->CheckOption(PROF_RAW_METRICS) ||
+          profiler->CheckOption(PROF_KERNEL_METRICS) ||
+          profiler->CheckOption(PROF_AGGREGATION) ||
+          profiler->CheckOption(PROF_ONLINE_AGGREGATION) ||
+          profiler->CheckOption(PROF_ROOFLINE)) {
+        std::cout << "[WARNING] Metric queries can't be combined with " <<
+          "metric stream collection" << std::endl;
+        delete profiler;
+        return nullptr;
+      }
+
+      std::vector<std::string> group_list = options.GetMetricGroupList();
+      if (group_list.size() != 1) {
+        std::cout << "[WARNING] Metric queries need exactly one " <<
+          "metric group" << std::endl;
+        delete profiler;
+        return nullptr;
+      }
+
+      profiler->metric_query_collector_ = MetricQueryCollector::Create(
+          driver, device, group_list.front().c_str());
+      if (profiler->metric_query_collector_ == nullptr) {
+        std::cout <<
+          "[WARNING] Unable to create metric query collector" << std::endl;
+        delete profiler;
+        return nullptr;
+      }
+    }
+
     if (profiler->CheckOption(PROF_RAW_METRICS) ||
         profiler->CheckOption(PROF_KERNEL_METRICS) ||
-        profiler->CheckOption(PROF_AGGREGATION)) {
-      MetricCollector* metric_collector = MetricCollector::Create(
-          driver, device, options.GetMetricGroup().c_str(),
-          options.GetSamplingInterval());
+        profiler->CheckOption(PROF_AGGREGATION) ||
+        profiler->CheckOption(PROF_ONLINE_AGGREGATION) ||
+        profiler->CheckOption(PROF_ROOFLINE)) {
+      // Raw stream is kept on disk only for post-mortem processing
+      bool store_reports =
+        profiler->CheckOption(PROF_RAW_METRICS) ||
+        profiler->CheckOption(PROF_KERNEL_METRICS) ||
+        profiler->CheckOption(PROF_AGGREGATION);
+      std::vector<std::string> group_list = options.GetMetricGroupList();
+      MetricCollector* metric_collector = nullptr;
+      if (group_list.empty()) {
+        std::cout << "[WARNING] Metric group is not specified" << std::endl;
+      } else {
+        metric_collector = MetricCollector::Create(
+            driver, device, group_list, options.GetSamplingInterval(),
+            store_reports, options.GetMultiplexPeriod(),
+            profiler->CheckOption(PROF_SHARED_METRICS));
+      }
       if (metric_collector == nullptr) {
         std::cout <<
           "[WARNING] Unable to create metric collector" << std::endl;
@@ -73,14 +168,28 @@ class Profiler {
         delete profiler;
         return nullptr;
       }
+
+      if (profiler->CheckOption(PROF_ROOFLINE) &&
+          !profiler->HasRooflineMetrics()) {
+        std::cout << "[WARNING] Roofline needs Fpu0Active, Fpu1Active, " <<
+          "GtiReadThroughput and GtiWriteThroughput metrics " <<
+          "(e.g. ComputeBasic group)" << std::endl;
+        delete profiler;
+        return nullptr;
+      }
     }
 
     if (profiler->CheckOption(PROF_KERNEL_INTERVALS) ||
         profiler->CheckOption(PROF_KERNEL_METRICS) ||
-        profiler->CheckOption(PROF_AGGREGATION)) {
+        profiler->CheckOption(PROF_AGGREGATION) ||
+        profiler->CheckOption(PROF_ONLINE_AGGREGATION) ||
+        profiler->CheckOption(PROF_ROOFLINE)) {
 
       ZeKernelCollector* ze_kernel_collector = ZeKernelCollector::Create(
-          &(profiler->correlator_), true);
+          &(profiler->correlator_), KERNEL_GROUPING_CONFIG, nullptr,
+          nullptr, 0, false,
+          std::string(), profiler->capture_,
+          false, false, false, nullptr, true);
       if (ze_kernel_collector == nullptr) {
         std::cout <<
           "[WARNING] Unable to create Level Zero kernel collector" <<
@@ -95,7 +204,9 @@ class Profiler {
           "[WARNING] Unable to find target OpenCL device" << std::endl;
       } else {
         cl_kernel_collector = ClKernelCollector::Create(
-            device, &(profiler->correlator_), true);
+            device, &(profiler->correlator_), KERNEL_GROUPING_CONFIG,
+            nullptr, nullptr,
+            std::string(), profiler->capture_, false, true);
         if (cl_kernel_collector == nullptr) {
           std::cout <<
             "[WARNING] Unable to create OpenCL kernel collector" <<
@@ -103,6 +214,7 @@ class Profiler {
         }
       }
       profiler->cl_kernel_collector_ = cl_kernel_collector;
+      profiler->cl_device_ = device;
 
       if (profiler->ze_kernel_collector_ == nullptr &&
           profiler->cl_kernel_collector_ == nullptr) {
@@ -111,31 +223,88 @@ class Profiler {
       }
     }
 
+    // Roofline takes per-kernel totals from the online aggregates
+    if (profiler->IsOnlineAggregation() ||
+        profiler->CheckOption(PROF_ROOFLINE)) {
+      PTI_ASSERT(profiler->metric_collector_ != nullptr);
+      MetricCollector* metric_collector = profiler->metric_collector_;
+
+      // Aggregator lists are indexed by stream
+      std::vector<std::vector<std::string> > metric_list;
+      std::vector<std::vector<zet_metric_type_t> > metric_type_list;
+      for (uint32_t i = 0; i < metric_collector->GetGroupCount(); ++i) {
+        for (uint32_t j = 0; j < sub_device_count; ++j) {
+          metric_list.push_back(metric_collector->GetMetricList(j, i));
+          metric_type_list.push_back(
+              metric_collector->GetMetricTypeList(j, i));
+        }
+      }
+
+      profiler->metric_aggregator_ =
+        new MetricAggregator(metric_list, metric_type_list);
+      PTI_ASSERT(profiler->metric_aggregator_ != nullptr);
+
+      metric_collector->SetReportCallback(OnMetricReports, profiler);
+    }
+
+    if (profiler->capture_ != nullptr) {
+      profiler->capture_->Start(OnCaptureChange, profiler);
+    }
+
     return profiler;
   }
 
   ~Profiler() {
+    if (itt_collector_ != nullptr) {
+      itt_collector_->DisableTracing();
+    }
+    if (capture_ != nullptr) {
+      delete capture_;
+    }
     if (metric_collector_ != nullptr) {
       metric_collector_->DisableCollection();
     }
+    if (metric_query_collector_ != nullptr) {
+      metric_query_collector_->DisableCollection();
+    }
     if (ze_kernel_collector_ != nullptr) {
       ze_kernel_collector_->DisableTracing();
     }
     if (cl_kernel_collector_ != nullptr) {
       cl_kernel_collector_->DisableTracing();
     }
+    if (sysman_sampler_ != nullptr) {
+      sysman_sampler_->Stop();
+    }
+
+    if (metric_aggregator_ != nullptr) {
+      AggregateKernelIntervals();
+      metric_aggregator_->Finalize();
+    }
 
     Report();
 
+    if (itt_collector_ != nullptr) {
+      delete itt_collector_;
+    }
     if (metric_collector_ != nullptr) {
       delete metric_collector_;
     }
+    if (metric_query_collector_ != nullptr) {
+      delete metric_query_collector_;
+    }
     if (ze_kernel_collector_ != nullptr) {
       delete ze_kernel_collector_;
     }
     if (cl_kernel_collector_ != nullptr) {
       delete cl_kernel_collector_;
     }
+    if (metric_aggregator_ != nullptr) {
+      delete metric_aggregator_;
+    }
+    if (sysman_sampler_ != nullptr) {
+      delete sysman_sampler_;
+    }
 
     if (!options_.GetLogFileName().empty()) {
       std::cerr << "[INFO] Log was stored to " <<
@@ -147,6 +316,19 @@ class Profiler {
     return options_.CheckFlag(option);
   }
 
+  bool IsMultiplexed() const {
+    return metric_collector_ != nullptr &&
+      metric_collector_->GetGroupCount() > 1;
+  }
+
+  // Per-kernel estimates for multiplexed groups are built online, as
+  // each stream has gaps while other groups are collected
+  bool IsOnlineAggregation() {
+    return CheckOption(PROF_ONLINE_AGGREGATION) ||
+      (IsMultiplexed() &&
+       (CheckOption(PROF_KERNEL_METRICS) || CheckOption(PROF_AGGREGATION)));
+  }
+
   Profiler(const Profiler& copy) = delete;
   Profiler& operator=(const Profiler& copy) = delete;
 
@@ -167,10 +349,162 @@ class Profiler {
     ze_result_t result = zeDeviceGetGlobalTimestamps(
         device, &host_sync_, &device_sync_);
     PTI_ASSERT(result == ZE_RESULT_SUCCESS);
-    device_sync_ &= utils::ze::GetDeviceTimestampMask(device);
 
-    device_freq_ = utils::ze::GetDeviceTimerFrequency(device);
+    // Timer constants and roofline peaks may come from the device cache
+    ze_capabilities_ = utils::ze::GetDeviceCapabilities(
+        GetZeDriver(device_id_), device);
+    device_sync_ &= ze_capabilities_.timestamp_mask;
+
+    device_freq_ = ze_capabilities_.timer_frequency;
     PTI_ASSERT(device_freq_ > 0);
+
+    core_clock_rate_ = ze_capabilities_.core_clock_rate;
+
+    ze_device_ = device;
+  }
+
+  // Metric stream is not interrupted, so only the kernels launched inside
+  // the capture window are reported and matched with metrics
+  static void OnCaptureChange(void* data, bool active) {
+    PTI_ASSERT(data != nullptr);
+  }
+
+  // Sysman samples are taken in the device time domain of the metrics
+  // and the kernel intervals
+  static uint64_t GetSysmanTimestamp(void* data) {
+    Profiler* profiler = reinterpret_cast<Profiler*>(data);
+    PTI_ASSERT(profiler != nullptr);
+    uint64_t timestamp =
+      utils::ze::GetDeviceTimestamp(profiler->ze_device_) &
+      profiler->ze_capabilities_.timestamp_mask;
+    uint64_t freq = profiler->device_freq_;
+    return timestamp / freq * static_cast<uint64_t>(NSEC_IN_SEC) +
+      timestamp % freq * static_cast<uint64_t>(NSEC_IN_SEC) / freq;
+  }
+
+  // Task intervals are kept in host time, as OpenCL kernel intervals
+  static void OnIttTaskFinish(
+      void* data, const std::string& domain, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    Profiler* profiler = reinterpret_cast<Profiler*>(data);
+    PTI_ASSERT(profiler != nullptr);
+    const std::lock_guard<std::mutex> lock(profiler->itt_lock_);
+    profiler->itt_task_list_.push_back(
+        {domain, name, ThreadIdentity::GetTid(), started, ended});
+  }
+
+  static void OnMetricReports(
+      void* data, uint32_t sub_device_id, uint32_t group_id,
+      const std::vector<zet_typed_value_t>& report_chunk) {
+    Profiler* profiler = reinterpret_cast<Profiler*>(data);
+    PTI_ASSERT(profiler != nullptr);
+    PTI_ASSERT(profiler->metric_collector_ != nullptr);
+    PTI_ASSERT(profiler->metric_aggregator_ != nullptr);
+
+    profiler->metric_aggregator_->AddReports(
+        profiler->metric_collector_->GetStreamId(sub_device_id, group_id),
+        report_chunk);
+    profiler->AggregateKernelIntervals();
+  }
+
+  // Intervals are taken from kernel collectors to keep their memory
+  // constant; they are kept here only if post-mortem reports need them
+  bool KeepKernelIntervals() {
+    return CheckOption(PROF_KERNEL_INTERVALS) ||
+      CheckOption(PROF_KERNEL_METRICS) ||
+      CheckOption(PROF_AGGREGATION);
+  }
+
+  void AggregateKernelIntervals() {
+    PTI_ASSERT(metric_aggregator_ != nullptr);
+
+    if (ze_kernel_collector_ != nullptr) {
+      ZeKernelIntervalStore store;
+      ze_kernel_collector_->TakeKernelIntervals(&store);
+      AggregateKernelIntervals(store, ze_device_);
+      if (KeepKernelIntervals()) {
+        ze_kernel_interval_store_.Splice(&store);
+      }
+    }
+
+    if (cl_kernel_collector_ != nullptr) {
+      ClKernelIntervalStore store;
+      cl_kernel_collector_->TakeKernelIntervals(&store);
+      AggregateKernelIntervals(store, cl_device_);
+      if (KeepKernelIntervals()) {
+        cl_kernel_interval_store_.Splice(&store);
+      }
+    }
+  }
+
+  template <typename Store>
+  void AggregateKernelIntervals(
+      const Store& store, typename Store::Device device) {
+    ForEachTargetLaunch(store, device,
+        [this](const KernelIntervalRecord* interval_list, uint32_t count) {
+          const std::string& name = StringTable::Get(interval_list[0].name_id);
+          for (uint32_t j = 0; j < count; ++j) {
+            const KernelIntervalRecord& interval = interval_list[j];
+            for (uint32_t i = 0; i < metric_collector_->GetGroupCount(); ++i) {
+              metric_aggregator_->AddKernelInterval(
+                  name,
+                  metric_collector_->GetStreamId(interval.sub_device_id, i),
+                  ConvertTimestamp<Store>(interval.start),
+                  ConvertTimestamp<Store>(interval.end));
+            }
+          }
+        });
+  }
+
+  // Launches of the given root device only, none for null device
+  template <typename Store, typename F>
+  static void ForEachTargetLaunch(
+      const Store& store, typename Store::Device device, F visitor) {
+    if (device == nullptr) {
+      return;
+    }
+    store.ForEachLaunch(
+        [&store, device, &visitor](
+            const KernelIntervalRecord* interval_list, uint32_t count) {
+          if (store.GetDevice(interval_list[0].device_index) == device) {
+            visitor(interval_list, count);
+          }
+        });
+  }
+
+  const ZeKernelIntervalStore& GetZeKernelIntervalStore() const {
+    PTI_ASSERT(ze_kernel_collector_ != nullptr);
+    if (metric_aggregator_ != nullptr) {
+      return ze_kernel_interval_store_;
+    }
+    return ze_kernel_collector_->GetKernelIntervalStore();
+  }
+
+  const ClKernelIntervalStore& GetClKernelIntervalStore() const {
+    PTI_ASSERT(cl_kernel_collector_ != nullptr);
+    if (metric_aggregator_ != nullptr) {
+      return cl_kernel_interval_store_;
+    }
+    return cl_kernel_collector_->GetKernelIntervalStore();
+  }
+
+  // Target device of the reports, null if there is no such device
+  ze_device_handle_t GetZeTargetDevice() const {
+    std::vector<ze_device_handle_t> device_list =
+      utils::ze::GetDeviceList();
+    if (device_list.empty()) {
+      return nullptr;
+    }
+    return device_list[device_id_];
+  }
+
+  cl_device_id GetClTargetDevice() const {
+    std::vector<cl_device_id> device_list =
+      utils::cl::GetDeviceList(CL_DEVICE_TYPE_GPU);
+    if (device_list.empty()) {
+      return nullptr;
+    }
+    return device_list[device_id_];
   }
 
   static void PrintTypedValue(
@@ -198,6 +532,36 @@ class Profiler {
     }
   }
 
+  // Reports of multiplexed groups are tagged with the group name
+  std::string GetReportHeader(
+      uint32_t sub_device_id, uint32_t group_id) const {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    std::vector<std::string> metric_list =
+      metric_collector_->GetMetricList(sub_device_id, group_id);
+    PTI_ASSERT(!metric_list.empty());
+
+    std::stringstream header;
+    header << "SubDeviceId,";
+    if (IsMultiplexed()) {
+      header << "Group,";
+    }
+    for (auto& metric : metric_list) {
+      header << metric << ",";
+    }
+    header << std::endl;
+    return header.str();
+  }
+
+  void PrintReportPrefix(
+      std::stringstream& stream,
+      uint32_t sub_device_id, uint32_t group_id) const {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    stream << sub_device_id << ",";
+    if (IsMultiplexed()) {
+      stream << metric_collector_->GetGroupName(group_id) << ",";
+    }
+  }
+
   void Report() {
     correlator_.Log("\n");
     correlator_.Log("=== Profiling Results ===\n");
@@ -207,20 +571,56 @@ class Profiler {
       correlator_.GetTimestamp() << " ns" << std::endl;
     correlator_.Log(header.str());
 
+    if (metric_collector_ != nullptr) {
+      const std::vector<MetricStreamStats>& stats_list =
+        metric_collector_->GetStreamStatsList();
+      for (size_t i = 0; i < stats_list.size(); ++i) {
+        uint32_t sub_device_id = i % sub_device_count_;
+        uint32_t group_id = i / sub_device_count_;
+        std::stringstream stats;
+        stats << "Metric Stream (SubDeviceId " << sub_device_id;
+        if (IsMultiplexed()) {
+          stats << ", Group " << metric_collector_->GetGroupName(group_id);
+        }
+        stats << "): " <<
+          stats_list[i].total_size << " bytes, " <<
+          stats_list[i].read_count << " reads (" <<
+          stats_list[i].empty_read_count << " empty), " <<
+          stats_list[i].dropped_count << " overflows" << std::endl;
+        correlator_.Log(stats.str());
+      }
+    }
+
+    if (metric_query_collector_ != nullptr) {
+      MetricQueryStats stats = metric_query_collector_->GetStats();
+      std::stringstream line;
+      line << "Metric Query: " << stats.query_count << " queries, " <<
+        stats.skipped_count << " skipped (pool exhausted), " <<
+        stats.lost_count << " lost" << std::endl;
+      correlator_.Log(line.str());
+    }
+
     if (metric_collector_ != nullptr &&
+        CheckOption(PROF_RAW_METRICS) && options_.IsArrowOutput()) {
+      ExportRawMetrics();
+    } else if (metric_collector_ != nullptr &&
         CheckOption(PROF_RAW_METRICS)) {
       correlator_.Log("\n");
       correlator_.Log("== Raw Metrics ==\n");
       correlator_.Log("\n");
-      for (uint32_t i = 0; i < sub_device_count_; ++i) {
-        ReportRawMetrics(i);
-        correlator_.Log("\n");
+      for (uint32_t i = 0; i < metric_collector_->GetGroupCount(); ++i) {
+        for (uint32_t j = 0; j < sub_device_count_; ++j) {
+          ReportRawMetrics(j, i);
+          correlator_.Log("\n");
+        }
       }
     }
 
-    if (CheckOption(PROF_KERNEL_INTERVALS)) {
+    if (CheckOption(PROF_KERNEL_INTERVALS) && options_.IsArrowOutput()) {
+      ExportKernelIntervals();
+    } else if (CheckOption(PROF_KERNEL_INTERVALS)) {
       if (ze_kernel_collector_ != nullptr) {
-        if (!ze_kernel_collector_->GetKernelIntervalList().empty()) {
+        if (!GetZeKernelIntervalStore().IsEmpty()) {
           correlator_.Log("\n");
           correlator_.Log("== Raw Kernel Intervals (Level Zero) ==\n");
           correlator_.Log("\n");
@@ -228,7 +628,7 @@ class Profiler {
         }
       }
       if (cl_kernel_collector_ != nullptr) {
-        if (!cl_kernel_collector_->GetKernelIntervalList().empty()) {
+        if (!GetClKernelIntervalStore().IsEmpty()) {
           correlator_.Log("\n");
           correlator_.Log("== Raw Kernel Intervals (OpenCL) ==\n");
           correlator_.Log("\n");
@@ -237,10 +637,21 @@ class Profiler {
       }
     }
 
+    if (sysman_sampler_ != nullptr) {
+      correlator_.Log("\n");
+      correlator_.Log("== Sysman Counters ==\n");
+      correlator_.Log("\n");
+      ReportSysmanCounters();
+    }
+
+    if (itt_collector_ != nullptr) {
+      ReportIttTasks();
+    }
+
     if (metric_collector_ != nullptr &&
         CheckOption(PROF_KERNEL_METRICS)) {
       if (ze_kernel_collector_ != nullptr) {
-        if (!ze_kernel_collector_->GetKernelIntervalList().empty()) {
+        if (!GetZeKernelIntervalStore().IsEmpty()) {
           correlator_.Log("\n");
           correlator_.Log("== Kernel Metrics (Level Zero) ==\n");
           correlator_.Log("\n");
@@ -248,7 +659,7 @@ class Profiler {
         }
       }
       if (cl_kernel_collector_ != nullptr) {
-        if (!cl_kernel_collector_->GetKernelIntervalList().empty()) {
+        if (!GetClKernelIntervalStore().IsEmpty()) {
           correlator_.Log("\n");
           correlator_.Log("== Kernel Metrics (OpenCL) ==\n");
           correlator_.Log("\n");
@@ -258,9 +669,12 @@ class Profiler {
     }
 
     if (metric_collector_ != nullptr &&
+        CheckOption(PROF_AGGREGATION) && options_.IsArrowOutput()) {
+      ExportAggregatedMetrics();
+    } else if (metric_collector_ != nullptr &&
         CheckOption(PROF_AGGREGATION)) {
       if (ze_kernel_collector_ != nullptr) {
-        if (!ze_kernel_collector_->GetKernelIntervalList().empty()) {
+        if (!GetZeKernelIntervalStore().IsEmpty()) {
           correlator_.Log("\n");
           correlator_.Log("== Aggregated Metrics (Level Zero) ==\n");
           correlator_.Log("\n");
@@ -268,7 +682,7 @@ class Profiler {
         }
       }
       if (cl_kernel_collector_ != nullptr) {
-        if (!cl_kernel_collector_->GetKernelIntervalList().empty()) {
+        if (!GetClKernelIntervalStore().IsEmpty()) {
           correlator_.Log("\n");
           correlator_.Log("== Aggregated Metrics (OpenCL) ==\n");
           correlator_.Log("\n");
@@ -276,32 +690,114 @@ class Profiler {
         }
       }
     }
+
+    if (metric_aggregator_ != nullptr && IsOnlineAggregation()) {
+      correlator_.Log("\n");
+      if (IsMultiplexed()) {
+        correlator_.Log("== Multiplexed Metrics ==\n");
+      } else {
+        correlator_.Log("== Online Aggregated Metrics ==\n");
+      }
+      correlator_.Log("\n");
+      ReportOnlineAggregatedMetrics();
+    }
+
+    if (metric_aggregator_ != nullptr && CheckOption(PROF_ROOFLINE)) {
+      ReportRoofline();
+    }
+
+    if (metric_query_collector_ != nullptr) {
+      correlator_.Log("\n");
+      correlator_.Log("== Kernel Query Metrics ==\n");
+      correlator_.Log("\n");
+      ReportQueryMetrics();
+    }
+
+    if (Overhead::IsEnabled()) {
+      correlator_.Log("\n");
+      correlator_.Log("== Overhead Summary ==\n");
+      correlator_.Log("\n");
+      std::stringstream stream;
+      Overhead::PrintTable(stream);
+      correlator_.Log(stream.str());
+    }
+  }
+
+  void ReportIttTasks() {
+    const std::lock_guard<std::mutex> lock(itt_lock_);
+    if (itt_task_list_.empty()) {
+      return;
+    }
+
+    correlator_.Log("\n");
+    correlator_.Log("== Raw ITT Tasks ==\n");
+    correlator_.Log("\n");
+
+    std::stringstream header;
+    header << "Domain,";
+    header << "Name,";
+    header << "ThreadId,";
+    header << "Start,";
+    header << "End,";
+    header << std::endl;
+    correlator_.Log(header.str());
+
+    for (auto& task : itt_task_list_) {
+      std::stringstream line;
+      line << task.domain << ",";
+      line << task.name << ",";
+      line << task.tid << ",";
+      line << ConvertTimestamp<ClKernelIntervalStore>(task.start) << ",";
+      line << ConvertTimestamp<ClKernelIntervalStore>(task.end) << ",";
+      line << std::endl;
+      correlator_.Log(line.str());
+    }
+
+    correlator_.Log("\n");
+    correlator_.Log("== ITT Regions ==\n");
+    correlator_.Log("\n");
+    itt_collector_->PrintRegionsTable();
   }
 
-  template <typename KernelInterval>
+  template <typename Store>
   uint64_t ConvertTimestamp(uint64_t timestamp) const {
-    return detail::ConvertTimestamp<KernelInterval>(
+    return detail::ConvertTimestamp<Store>(
         timestamp, device_freq_, host_sync_, device_sync_);
   }
 
-  template <typename KernelInterval>
-  void ReportKernelInterval(const KernelInterval& interval) {
+  template <typename Store>
+  void ReportKernelInterval(
+      const KernelIntervalRecord* interval_list, uint32_t count) {
     std::stringstream stream;
-    stream << "Kernel," << interval.kernel_name << "," << std::endl;
+    stream << "Kernel," << StringTable::Get(interval_list[0].name_id) <<
+      "," << std::endl;
     correlator_.Log(stream.str());
 
     std::stringstream header;
     header << "SubDeviceId,";
     header << "Start,";
     header << "End,";
+    if (sysman_sampler_ != nullptr) {
+      header << "Frequency(MHz),";
+      header << "Power(W),";
+    }
     header << std::endl;
     correlator_.Log(header.str());
 
-    for (auto& device_interval : interval.device_interval_list) {
+    for (uint32_t i = 0; i < count; ++i) {
+      const KernelIntervalRecord& interval = interval_list[i];
+      uint64_t start = ConvertTimestamp<Store>(interval.start);
+      uint64_t end = ConvertTimestamp<Store>(interval.end);
       std::stringstream line;
-      line << device_interval.sub_device_id << ",";
-      line << ConvertTimestamp<KernelInterval>(device_interval.start) << ",";
-      line << ConvertTimestamp<KernelInterval>(device_interval.end) << ",";
+      line << interval.sub_device_id << ",";
+      line << start << ",";
+      line << end << ",";
+      if (sysman_sampler_ != nullptr) {
+        PrintSysmanValue(line, sysman_sampler_->GetAverage(
+            device_id_, &SysmanCounterSample::frequency, start, end));
+        PrintSysmanValue(line, sysman_sampler_->GetAverage(
+            device_id_, &SysmanCounterSample::power, start, end));
+      }
       line << std::endl;
       correlator_.Log(line.str());
     }
@@ -309,149 +805,102 @@ class Profiler {
     correlator_.Log("\n");
   }
 
-  void ReportClKernelIntervals() {
-    PTI_ASSERT(cl_kernel_collector_ != nullptr);
-
-    std::vector<cl_device_id> device_list =
-      utils::cl::GetDeviceList(CL_DEVICE_TYPE_GPU);
-    if (device_list.empty()) {
-      return;
+  static void PrintSysmanValue(std::stringstream& stream, double value) {
+    if (value >= 0) {
+      stream << value;
     }
+    stream << ",";
+  }
 
-    const ClKernelIntervalList& interval_list =
-      cl_kernel_collector_->GetKernelIntervalList();
-    if (interval_list.empty()) {
-      return;
-    }
+  void ReportSysmanCounters() {
+    PTI_ASSERT(sysman_sampler_ != nullptr);
 
-    for (auto& interval : interval_list) {
-      if (device_list[device_id_] != interval.device) {
-        continue;
-      }
+    std::stringstream header;
+    header << "Timestamp,";
+    header << "Frequency(MHz),";
+    header << "Power(W),";
+    header << "Temperature(C),";
+    header << "ThrottleReasons,";
+    header << std::endl;
+    correlator_.Log(header.str());
 
-      ReportKernelInterval(interval);
+    for (auto& sample : sysman_sampler_->GetCounterList(device_id_)) {
+      std::stringstream line;
+      line << sample.timestamp << ",";
+      PrintSysmanValue(line, sample.frequency);
+      PrintSysmanValue(line, sample.power);
+      PrintSysmanValue(line, sample.temperature);
+      line << "0x" << std::hex << sample.throttle_reasons << ",";
+      line << std::endl;
+      correlator_.Log(line.str());
     }
   }
 
+  void ReportClKernelIntervals() {
+    PTI_ASSERT(cl_kernel_collector_ != nullptr);
+    ForEachTargetLaunch(GetClKernelIntervalStore(), GetClTargetDevice(),
+        [this](const KernelIntervalRecord* interval_list, uint32_t count) {
+          ReportKernelInterval<ClKernelIntervalStore>(interval_list, count);
+        });
+  }
+
   void ReportZeKernelIntervals() {
     PTI_ASSERT(ze_kernel_collector_ != nullptr);
-
-    std::vector<ze_device_handle_t> device_list =
-      utils::ze::GetDeviceList();
-    if (device_list.empty()) {
-      return;
-    }
-
-    const ZeKernelIntervalList& interval_list =
-      ze_kernel_collector_->GetKernelIntervalList();
-    if (interval_list.empty()) {
-      return;
-    }
-
-    for (auto& kernel_interval : interval_list) {
-      if (device_list[device_id_] != kernel_interval.device) {
-        continue;
-      }
-
-      ReportKernelInterval(kernel_interval);
-    }
+    ForEachTargetLaunch(GetZeKernelIntervalStore(), GetZeTargetDevice(),
+        [this](const KernelIntervalRecord* interval_list, uint32_t count) {
+          ReportKernelInterval<ZeKernelIntervalStore>(interval_list, count);
+        });
   }
 
-  void ReportRawMetrics(uint32_t sub_device_id) {
+  void ReportRawMetrics(uint32_t sub_device_id, uint32_t group_id) {
     PTI_ASSERT(sub_device_id < sub_device_count_);
     PTI_ASSERT(metric_collector_ != nullptr);
 
-    uint32_t report_size = metric_collector_->GetReportSize(sub_device_id);
+    uint32_t report_size =
+      metric_collector_->GetReportSize(sub_device_id, group_id);
     PTI_ASSERT(report_size > 0);
 
-    std::vector<std::string> metric_list =
-      metric_collector_->GetMetricList(sub_device_id);
-    PTI_ASSERT(!metric_list.empty());
-    PTI_ASSERT(metric_list.size() == report_size);
-
-    std::stringstream header;
-    header << "SubDeviceId,";
-    for (auto& metric : metric_list) {
-      header << metric << ",";
-    }
-    header << std::endl;
-    correlator_.Log(header.str());
-
-    metric_collector_->ResetReportReader();
-    while (true) {
-      std::vector<zet_typed_value_t> report_chunk =
-        metric_collector_->GetReportChunk(sub_device_id);
-      if (report_chunk.empty()) {
-        break;
-      }
+    correlator_.Log(GetReportHeader(sub_device_id, group_id));
 
-      uint32_t report_count = report_chunk.size() / report_size;
-      PTI_ASSERT(report_count * report_size == report_chunk.size());
+    // Reports are calculated in parallel and come in time order
+    const MetricReportStore* report_store =
+      metric_collector_->GetReportStore(sub_device_id, group_id);
+    PTI_ASSERT(report_store != nullptr);
+    PTI_ASSERT(report_store->GetReportSize() == report_size);
 
-      for (int i = 0; i < report_count; ++i) {
-        std::stringstream line;
-        line << sub_device_id << ",";
-        const zet_typed_value_t* report =
-          report_chunk.data() + i * report_size;
-        for (int j = 0; j < report_size; ++j) {
-          PrintTypedValue(line, report[j]);
-          line << ",";
-        }
-        line << std::endl;
-        correlator_.Log(line.str());
+    for (size_t i = 0; i < report_store->GetReportCount(); ++i) {
+      std::stringstream line;
+      PrintReportPrefix(line, sub_device_id, group_id);
+      const zet_typed_value_t* report = report_store->GetReport(i);
+      for (int j = 0; j < report_size; ++j) {
+        PrintTypedValue(line, report[j]);
+        line << ",";
       }
+      line << std::endl;
+      correlator_.Log(line.str());
     }
   }
 
   std::vector<zet_typed_value_t> GetMetricInterval(
       uint64_t start, uint64_t end,
-      uint32_t sub_device_id, uint32_t report_time_id) const {
+      uint32_t sub_device_id, uint32_t group_id) const {
     PTI_ASSERT(start < end);
     PTI_ASSERT(sub_device_id < sub_device_count_);
     PTI_ASSERT(metric_collector_ != nullptr);
 
-    std::vector<zet_typed_value_t> target_list;
-    uint32_t report_size = metric_collector_->GetReportSize(sub_device_id);
-    PTI_ASSERT(report_size > 0);
-
-    metric_collector_->ResetReportReader();
-    while (true) {
-      std::vector<zet_typed_value_t> report_chunk =
-        metric_collector_->GetReportChunk(sub_device_id);
-      if (report_chunk.empty()) {
-        break;
-      }
-
-      uint32_t report_count = report_chunk.size() / report_size;
-      PTI_ASSERT(report_count * report_size == report_chunk.size());
+    const MetricReportStore* report_store =
+      metric_collector_->GetReportStore(sub_device_id, group_id);
+    PTI_ASSERT(report_store != nullptr);
 
-      const zet_typed_value_t* first_report = report_chunk.data();
-      PTI_ASSERT(first_report[report_time_id].type == ZET_VALUE_TYPE_UINT64);
-      if (first_report[report_time_id].value.ui64 > end) {
-        continue;
-      }
-
-      const zet_typed_value_t* last_report =
-        report_chunk.data() + (report_count - 1) * report_size;
-      PTI_ASSERT(last_report[report_time_id].type == ZET_VALUE_TYPE_UINT64);
-      if (last_report[report_time_id].value.ui64 < start) {
-        continue;
-      }
-
-      for (int i = 0; i < report_count; ++i) {
-        const zet_typed_value_t* report =
-          report_chunk.data() + i * report_size;
-        zet_typed_value_t report_time = report[report_time_id];
-        PTI_ASSERT(report_time.type == ZET_VALUE_TYPE_UINT64);
-        if (report_time.value.ui64 >= start && report_time.value.ui64 <= end) {
-          for (int j = 0; j < report_size; ++j) {
-            target_list.push_back(report[j]);
-          }
-        }
-      }
+    size_t first = 0, last = 0;
+    report_store->FindReports(start, end, &first, &last);
+    if (first == last) {
+      return std::vector<zet_typed_value_t>();
     }
 
-    return target_list;
+    const zet_typed_value_t* report = report_store->GetReport(first);
+    return std::vector<zet_typed_value_t>(
+        report, report + (last - first) * report_store->GetReportSize());
   }
 
   static size_t GetMetricId(
@@ -465,52 +914,45 @@ class Profiler {
     return metric_list.size();
   }
 
-  template <typename KernelInterval>
-  void ReportKernelMetrics(const KernelInterval& interval) {
+  // With multiplexing, the interval usually has reports of a single group
+  template <typename Store>
+  void ReportKernelMetrics(
+      const KernelIntervalRecord* interval_list, uint32_t count) {
     std::stringstream stream;
-    stream << "Kernel," << interval.kernel_name << "," << std::endl;
+    stream << "Kernel," << StringTable::Get(interval_list[0].name_id) <<
+      "," << std::endl;
     correlator_.Log(stream.str());
-    for (auto& device_interval : interval.device_interval_list) {
-      uint32_t report_size =
-        metric_collector_->GetReportSize(device_interval.sub_device_id);
-      PTI_ASSERT(report_size > 0);
-
-      std::vector<std::string> metric_list =
-        metric_collector_->GetMetricList(device_interval.sub_device_id);
-      PTI_ASSERT(!metric_list.empty());
-      PTI_ASSERT(metric_list.size() == report_size);
-
-      size_t report_time_id = GetMetricId(metric_list, "QueryBeginTime");
-      PTI_ASSERT(report_time_id < metric_list.size());
-
-      std::vector<zet_typed_value_t> report_list = GetMetricInterval(
-          ConvertTimestamp<KernelInterval>(device_interval.start),
-          ConvertTimestamp<KernelInterval>(device_interval.end),
-          device_interval.sub_device_id, report_time_id);
-      uint32_t report_count = report_list.size() / report_size;
-      PTI_ASSERT(report_count * report_size == report_list.size());
-
-      if (report_count > 0) {
-        std::stringstream header;
-        header << "SubDeviceId,";
-        for (auto& metric : metric_list) {
-          header << metric << ",";
+    for (uint32_t k = 0; k < count; ++k) {
+      const KernelIntervalRecord& interval = interval_list[k];
+      uint32_t sub_device_id = interval.sub_device_id;
+      for (uint32_t g = 0; g < metric_collector_->GetGroupCount(); ++g) {
+        uint32_t report_size =
+          metric_collector_->GetReportSize(sub_device_id, g);
+        PTI_ASSERT(report_size > 0);
+
+        std::vector<zet_typed_value_t> report_list = GetMetricInterval(
+            ConvertTimestamp<Store>(interval.start),
+            ConvertTimestamp<Store>(interval.end),
+            sub_device_id, g);
+        uint32_t report_count = report_list.size() / report_size;
+        PTI_ASSERT(report_count * report_size == report_list.size());
+
+        if (report_count > 0) {
+          correlator_.Log(GetReportHeader(sub_device_id, g));
         }
-        header << std::endl;
-        correlator_.Log(header.str());
-      }
 
-      for (int i = 0; i < report_count; ++i) {
-        std::stringstream line;
-        line << device_interval.sub_device_id << ",";
-        const zet_typed_value_t* report =
-          report_list.data() + i * report_size;
-        for (int j = 0; j < report_size; ++j) {
-          PrintTypedValue(line, report[j]);
-          line << ",";
+        for (int i = 0; i < report_count; ++i) {
+          std::stringstream line;
+          PrintReportPrefix(line, sub_device_id, g);
+          const zet_typed_value_t* report =
+            report_list.data() + i * report_size;
+          for (int j = 0; j < report_size; ++j) {
+            PrintTypedValue(line, report[j]);
+            line << ",";
+          }
+          line << std::endl;
+          correlator_.Log(line.str());
         }
-        line << std::endl;
-        correlator_.Log(line.str());
       }
     }
     correlator_.Log("\n");
@@ -519,398 +961,755 @@ class Profiler {
   void ReportZeKernelMetrics() {
     PTI_ASSERT(metric_collector_ != nullptr);
     PTI_ASSERT(ze_kernel_collector_ != nullptr);
+    ForEachTargetLaunch(GetZeKernelIntervalStore(), GetZeTargetDevice(),
+        [this](const KernelIntervalRecord* interval_list, uint32_t count) {
+          ReportKernelMetrics<ZeKernelIntervalStore>(interval_list, count);
+        });
+  }
 
-    std::vector<ze_device_handle_t> device_list =
-      utils::ze::GetDeviceList();
-    if (device_list.empty()) {
-      return;
-    }
+  void ReportClKernelMetrics() {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    PTI_ASSERT(cl_kernel_collector_ != nullptr);
+    ForEachTargetLaunch(GetClKernelIntervalStore(), GetClTargetDevice(),
+        [this](const KernelIntervalRecord* interval_list, uint32_t count) {
+          ReportKernelMetrics<ClKernelIntervalStore>(interval_list, count);
+        });
+  }
+
+  // Reports of each stream are attributed to all the kernel intervals at
+  // once, so overlapping kernels share them. Resulting reports of each
+  // stream follow the order of launches and their device intervals
+  template <typename Store>
+  StreamReportList AttributeMetrics(
+      const Store& store, typename Store::Device device) const {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    uint32_t group_count = metric_collector_->GetGroupCount();
+
+    std::vector<std::vector<MetricInterval> > stream_interval_list(
+        metric_collector_->GetStreamCount());
+    ForEachTargetLaunch(store, device,
+        [&](const KernelIntervalRecord* interval_list, uint32_t count) {
+          for (uint32_t i = 0; i < count; ++i) {
+            const KernelIntervalRecord& interval = interval_list[i];
+            for (uint32_t g = 0; g < group_count; ++g) {
+              uint32_t stream_id =
+                metric_collector_->GetStreamId(interval.sub_device_id, g);
+              stream_interval_list[stream_id].push_back(
+                  {ConvertTimestamp<Store>(interval.start),
+                   ConvertTimestamp<Store>(interval.end)});
+            }
+          }
+        });
 
-    const ZeKernelIntervalList& interval_list =
-      ze_kernel_collector_->GetKernelIntervalList();
-    for (auto& kernel_interval : interval_list) {
-      if (device_list[device_id_] != kernel_interval.device) {
+    StreamReportList stream_report_list(stream_interval_list.size());
+    for (uint32_t i = 0; i < stream_interval_list.size(); ++i) {
+      if (stream_interval_list[i].empty()) {
         continue;
       }
 
-      ReportKernelMetrics(kernel_interval);
+      uint32_t sub_device_id = i % sub_device_count_;
+      uint32_t group_id = i / sub_device_count_;
+      const MetricReportStore* report_store =
+        metric_collector_->GetReportStore(sub_device_id, group_id);
+      PTI_ASSERT(report_store != nullptr);
+
+      MetricAttributor attributor(
+          metric_collector_->GetMetricList(sub_device_id, group_id),
+          metric_collector_->GetMetricTypeList(sub_device_id, group_id));
+      stream_report_list[i] =
+        attributor.Attribute(*report_store, stream_interval_list[i]);
     }
+
+    return stream_report_list;
   }
 
-  void ReportClKernelMetrics() {
+  template <typename Store>
+  void ReportAggregatedMetrics(
+      const Store& store, typename Store::Device device) {
     PTI_ASSERT(metric_collector_ != nullptr);
-    PTI_ASSERT(cl_kernel_collector_ != nullptr);
+    uint32_t group_count = metric_collector_->GetGroupCount();
+    StreamReportList stream_report_list = AttributeMetrics(store, device);
+
+    std::vector<size_t> position_list(stream_report_list.size(), 0);
+    ForEachTargetLaunch(store, device,
+        [&](const KernelIntervalRecord* interval_list, uint32_t count) {
+          std::stringstream stream;
+          stream << "Kernel," << StringTable::Get(interval_list[0].name_id) <<
+            "," << std::endl;
+          correlator_.Log(stream.str());
+
+          for (uint32_t k = 0; k < count; ++k) {
+            uint32_t sub_device_id = interval_list[k].sub_device_id;
+            for (uint32_t g = 0; g < group_count; ++g) {
+              uint32_t stream_id =
+                metric_collector_->GetStreamId(sub_device_id, g);
+              PTI_ASSERT(position_list[stream_id] <
+                         stream_report_list[stream_id].size());
+              const std::vector<zet_typed_value_t>& report =
+                stream_report_list[stream_id][position_list[stream_id]++];
+              if (report.empty()) {
+                continue;
+              }
+
+              correlator_.Log(GetReportHeader(sub_device_id, g));
+
+              std::stringstream line;
+              PrintReportPrefix(line, sub_device_id, g);
+              for (auto& value : report) {
+                PrintTypedValue(line, value);
+                line << ",";
+              }
+              line << std::endl;
+              correlator_.Log(line.str());
+            }
+          }
+          correlator_.Log("\n");
+        });
+  }
 
-    std::vector<cl_device_id> device_list =
-      utils::cl::GetDeviceList(CL_DEVICE_TYPE_GPU);
-    if (device_list.empty()) {
-      return;
+  void ReportQueryMetrics() {
+    PTI_ASSERT(metric_query_collector_ != nullptr);
+
+    std::stringstream header;
+    header << "Calls,";
+    for (auto& metric : metric_query_collector_->GetMetricList()) {
+      header << metric << ",";
     }
+    header << std::endl;
 
-    const ClKernelIntervalList& interval_list =
-      cl_kernel_collector_->GetKernelIntervalList();
-    for (auto& kernel_interval : interval_list) {
-      if (device_list[device_id_] != kernel_interval.device) {
-        continue;
+    for (auto& item : metric_query_collector_->GetResultMap()) {
+      std::stringstream stream;
+      stream << "Kernel," << item.first << "," << std::endl;
+      correlator_.Log(stream.str());
+      correlator_.Log(header.str());
+
+      std::stringstream line;
+      line << item.second.call_count << ",";
+      for (auto& value : metric_query_collector_->GetReport(item.second)) {
+        PrintTypedValue(line, value);
+        line << ",";
       }
+      line << std::endl;
+      correlator_.Log(line.str());
+      correlator_.Log("\n");
+    }
 
-      ReportKernelMetrics(kernel_interval);
+    if (metric_query_collector_->GetStats().skipped_count > 0) {
+      std::cerr << "[WARNING] Some kernel launches were not profiled, " <<
+        "as all the metric queries were in use" << std::endl;
     }
   }
 
-  static zet_typed_value_t ComputeAverageValue(
-      uint32_t metric_id,
-      const std::vector<zet_typed_value_t>& report_list,
-      uint32_t report_size,
-      uint64_t total_clocks,
-      uint32_t gpu_clocks_id) {
-    PTI_ASSERT(report_list.size() > 0);
-    PTI_ASSERT(report_size > 0);
-    PTI_ASSERT(metric_id < report_size);
-    PTI_ASSERT(gpu_clocks_id < report_size);
-    PTI_ASSERT(total_clocks > 0);
-
-    uint32_t report_count = report_list.size() / report_size;
-    PTI_ASSERT(report_count * report_size == report_list.size());
-
-    const zet_typed_value_t* report = report_list.data();
-    switch (report[metric_id].type) {
-      case ZET_VALUE_TYPE_UINT32: {
-        zet_typed_value_t total;
-        total.type = ZET_VALUE_TYPE_UINT64;
-        total.value.ui64 = 0;
-
-        for (int j = 0; j < report_count; ++j) {
-          report = report_list.data() + j * report_size;
-          zet_typed_value_t value = report[metric_id];
-          PTI_ASSERT(value.type == ZET_VALUE_TYPE_UINT32);
-          zet_typed_value_t clocks = report[gpu_clocks_id];
-          PTI_ASSERT(clocks.type == ZET_VALUE_TYPE_UINT64);
-          total.value.ui64 += value.value.ui32 * clocks.value.ui64;
+  void ReportOnlineAggregatedMetrics() {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    PTI_ASSERT(metric_aggregator_ != nullptr);
+
+    for (auto& item : metric_aggregator_->GetAggregateMap()) {
+      std::stringstream stream;
+      stream << "Kernel," << item.first << "," << std::endl;
+      correlator_.Log(stream.str());
+
+      // Multiplexed groups get totals scaled to the whole kernel time and
+      // the share of the time they have sampled
+      const std::vector<MetricAggregate>& aggregate_list = item.second;
+      PTI_ASSERT(aggregate_list.size() ==
+                 metric_collector_->GetStreamCount());
+      for (uint32_t i = 0; i < aggregate_list.size(); ++i) {
+        const MetricAggregate& aggregate = aggregate_list[i];
+        if (aggregate.report_count == 0) {
+          continue;
+        }
+
+        uint32_t sub_device_id = i % sub_device_count_;
+        uint32_t group_id = i / sub_device_count_;
+        std::vector<std::string> metric_list =
+          metric_collector_->GetMetricList(sub_device_id, group_id);
+        PTI_ASSERT(!metric_list.empty());
+
+        std::stringstream header;
+        header << "SubDeviceId,";
+        if (IsMultiplexed()) {
+          header << "Group,Coverage(%),";
         }
-        total.value.ui64 /= total_clocks;
-        return total;
-      }
-      case ZET_VALUE_TYPE_UINT64: {
-        zet_typed_value_t total;
-        total.type = ZET_VALUE_TYPE_UINT64;
-        total.value.ui64 = 0;
-
-        for (int j = 0; j < report_count; ++j) {
-          report = report_list.data() + j * report_size;
-          zet_typed_value_t value = report[metric_id];
-          PTI_ASSERT(value.type == ZET_VALUE_TYPE_UINT64);
-          zet_typed_value_t clocks = report[gpu_clocks_id];
-          PTI_ASSERT(clocks.type == ZET_VALUE_TYPE_UINT64);
-          total.value.ui64 += value.value.ui64 * clocks.value.ui64;
+        for (auto& metric : metric_list) {
+          header << metric << ",";
         }
-        total.value.ui64 /= total_clocks;
-        return total;
-      }
-      case ZET_VALUE_TYPE_FLOAT32: {
-        zet_typed_value_t total;
-        total.type = ZET_VALUE_TYPE_FLOAT64;
-        total.value.fp64 = 0.0;
-
-        for (int j = 0; j < report_count; ++j) {
-          report = report_list.data() + j * report_size;
-          zet_typed_value_t value = report[metric_id];
-          PTI_ASSERT(value.type == ZET_VALUE_TYPE_FLOAT32);
-          zet_typed_value_t clocks = report[gpu_clocks_id];
-          PTI_ASSERT(clocks.type == ZET_VALUE_TYPE_UINT64);
-          total.value.fp64 += value.value.fp32 * clocks.value.ui64;
+        header << std::endl;
+        correlator_.Log(header.str());
+
+        std::vector<zet_typed_value_t> report = IsMultiplexed() ?
+          metric_aggregator_->GetScaledReport(i, aggregate) :
+          metric_aggregator_->GetAggregatedReport(i, aggregate);
+        PTI_ASSERT(report.size() == metric_list.size());
+
+        std::stringstream line;
+        PrintReportPrefix(line, sub_device_id, group_id);
+        if (IsMultiplexed()) {
+          PTI_ASSERT(aggregate.total_time > 0);
+          line << 100.0 * aggregate.covered_time / aggregate.total_time <<
+            ",";
         }
-        total.value.fp64 /= total_clocks;
-        return total;
-      }
-      case ZET_VALUE_TYPE_FLOAT64: {
-        zet_typed_value_t total;
-        total.type = ZET_VALUE_TYPE_FLOAT64;
-        total.value.fp64 = 0.0;
-
-        for (int j = 0; j < report_count; ++j) {
-          report = report_list.data() + j * report_size;
-          zet_typed_value_t value = report[metric_id];
-          PTI_ASSERT(value.type == ZET_VALUE_TYPE_FLOAT64);
-          zet_typed_value_t clocks = report[gpu_clocks_id];
-          PTI_ASSERT(clocks.type == ZET_VALUE_TYPE_UINT64);
-          total.value.fp64 += value.value.fp64 * clocks.value.ui64;
+        for (auto& value : report) {
+          PrintTypedValue(line, value);
+          line << ",";
         }
-        total.value.fp64 /= total_clocks;
-        return total;
+        line << std::endl;
+        correlator_.Log(line.str());
       }
-      default: {
+      correlator_.Log("\n");
+    }
+
+    if (metric_aggregator_->GetIncompleteCount() > 0) {
+      std::cerr << "[WARNING] Metrics of " <<
+        metric_aggregator_->GetIncompleteCount() <<
+        " kernel intervals were partially dropped before aggregation" <<
+        std::endl;
+    }
+  }
+
+  // Metrics may come from any of multiplexed groups
+  bool HasRooflineMetrics() const {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    bool compute = false, memory = false;
+    for (uint32_t i = 0; i < metric_collector_->GetGroupCount(); ++i) {
+      std::vector<std::string> metric_list =
+        metric_collector_->GetMetricList(0, i);
+      compute = compute ||
+        (GetMetricId(metric_list, "Fpu0Active") < metric_list.size() &&
+         GetMetricId(metric_list, "Fpu1Active") < metric_list.size());
+      memory = memory ||
+        (GetMetricId(metric_list, "GtiReadThroughput") < metric_list.size() &&
+         GetMetricId(metric_list, "GtiWriteThroughput") < metric_list.size());
+    }
+    return compute && memory;
+  }
+
+  static bool GetMetricValue(
+      const std::vector<std::string>& metric_list,
+      const std::vector<zet_typed_value_t>& report,
+      const std::string& metric_name, double* value) {
+    PTI_ASSERT(value != nullptr);
+    PTI_ASSERT(metric_list.size() == report.size());
+    size_t id = GetMetricId(metric_list, metric_name);
+    if (id == metric_list.size()) {
+      return false;
+    }
+    *value = GetDoubleValue(report[id]);
+    return true;
+  }
+
+  static double GetDoubleValue(const zet_typed_value_t& value) {
+    switch (value.type) {
+      case ZET_VALUE_TYPE_UINT32:
+        return value.value.ui32;
+      case ZET_VALUE_TYPE_UINT64:
+        return static_cast<double>(value.value.ui64);
+      case ZET_VALUE_TYPE_FLOAT32:
+        return value.value.fp32;
+      case ZET_VALUE_TYPE_FLOAT64:
+        return value.value.fp64;
+      case ZET_VALUE_TYPE_BOOL8:
+        return value.value.b8;
+      default:
         PTI_ASSERT(0);
         break;
+    }
+    return 0.0;
+  }
+
+  // Work of the kernel on the sub-device is estimated from the first
+  // groups that sampled it: FLOP as the average activity of both FPU
+  // pipes times the FLOP the EUs do per clock at the average frequency,
+  // bytes as the GTI traffic (totals are scaled to the whole kernel time).
+  // Returns false if no group has sampled the kernel
+  bool GetRooflineWork(
+      const std::vector<MetricAggregate>& aggregate_list,
+      uint32_t sub_device_id, uint64_t time,
+      double* flop, double* bytes) const {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    PTI_ASSERT(metric_aggregator_ != nullptr);
+    PTI_ASSERT(flop != nullptr && bytes != nullptr);
+
+    bool compute = false, memory = false;
+    for (uint32_t g = 0; g < metric_collector_->GetGroupCount(); ++g) {
+      uint32_t stream_id =
+        metric_collector_->GetStreamId(sub_device_id, g);
+      PTI_ASSERT(stream_id < aggregate_list.size());
+      const MetricAggregate& aggregate = aggregate_list[stream_id];
+      if (aggregate.report_count == 0) {
+        continue;
+      }
+
+      std::vector<std::string> metric_list =
+        metric_collector_->GetMetricList(sub_device_id, g);
+      std::vector<zet_typed_value_t> report =
+        metric_aggregator_->GetScaledReport(stream_id, aggregate);
+
+      double fpu0 = 0, fpu1 = 0, frequency = 0;
+      if (!compute &&
+          GetMetricValue(metric_list, report, "Fpu0Active", &fpu0) &&
+          GetMetricValue(metric_list, report, "Fpu1Active", &fpu1)) {
+        if (!GetMetricValue(
+                metric_list, report, "AvgGpuCoreFrequencyMHz", &frequency)) {
+          frequency = core_clock_rate_;
+        }
+        double flop_per_clock =
+          ze_capabilities_.flop_per_clock / sub_device_count_;
+        *flop = (fpu0 + fpu1) / 200.0 * flop_per_clock *
+          frequency * 1e6 * time / NSEC_IN_SEC;
+        compute = true;
+      }
+
+      double read = 0, write = 0;
+      if (!memory &&
+          GetMetricValue(metric_list, report, "GtiReadThroughput", &read) &&
+          GetMetricValue(metric_list, report, "GtiWriteThroughput", &write)) {
+        *bytes = read + write;
+        memory = true;
       }
     }
 
-    return zet_typed_value_t();
+    return compute && memory;
   }
 
-  static zet_typed_value_t ComputeTotalValue(
-      uint32_t metric_id,
-      const std::vector<zet_typed_value_t>& report_list,
-      uint32_t report_size) {
-    PTI_ASSERT(report_list.size() > 0);
-    PTI_ASSERT(report_size > 0);
-    PTI_ASSERT(metric_id < report_size);
-
-    uint32_t report_count = report_list.size() / report_size;
-    PTI_ASSERT(report_count * report_size == report_list.size());
-
-    const zet_typed_value_t* report = report_list.data();
-    switch (report[metric_id].type) {
-      case ZET_VALUE_TYPE_UINT32: {
-        zet_typed_value_t total;
-        total.type = ZET_VALUE_TYPE_UINT64;
-        total.value.ui64 = 0;
-
-        for (int j = 0; j < report_count; ++j) {
-          report = report_list.data() + j * report_size;
-          zet_typed_value_t value = report[metric_id];
-          PTI_ASSERT(value.type == ZET_VALUE_TYPE_UINT32);
-          total.value.ui64 += value.value.ui32;
-        }
-        return total;
-      }
-      case ZET_VALUE_TYPE_UINT64: {
-        zet_typed_value_t total;
-        total.type = ZET_VALUE_TYPE_UINT64;
-        total.value.ui64 = 0;
-
-        for (int j = 0; j < report_count; ++j) {
-          report = report_list.data() + j * report_size;
-          zet_typed_value_t value = report[metric_id];
-          PTI_ASSERT(value.type == ZET_VALUE_TYPE_UINT64);
-          total.value.ui64 += value.value.ui64;
-        }
-        return total;
-      }
-      case ZET_VALUE_TYPE_FLOAT32: {
-        zet_typed_value_t total;
-        total.type = ZET_VALUE_TYPE_FLOAT64;
-        total.value.fp64 = 0.0;
-
-        for (int j = 0; j < report_count; ++j) {
-          report = report_list.data() + j * report_size;
-          zet_typed_value_t value = report[metric_id];
-          PTI_ASSERT(value.type == ZET_VALUE_TYPE_FLOAT32);
-          total.value.fp64 += value.value.fp32;
+  // Kernels run on several sub-devices at once, so their work is summed
+  // and the time is the longest one
+  void ReportRoofline() {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    PTI_ASSERT(metric_aggregator_ != nullptr);
+
+    double peak_compute = ze_capabilities_.peak_compute;
+    double peak_memory = ze_capabilities_.peak_bandwidth;
+    Roofline roofline(peak_compute, peak_memory);
+
+    uint64_t skipped_count = 0;
+    for (auto& item : metric_aggregator_->GetAggregateMap()) {
+      const std::vector<MetricAggregate>& aggregate_list = item.second;
+      PTI_ASSERT(aggregate_list.size() ==
+                 metric_collector_->GetStreamCount());
+
+      uint64_t total_time = 0;
+      double total_flop = 0, total_bytes = 0;
+      bool sampled = true;
+      for (uint32_t i = 0; i < sub_device_count_; ++i) {
+        // Intervals are added to the streams of all the groups
+        uint64_t time =
+          aggregate_list[metric_collector_->GetStreamId(i, 0)].total_time;
+        if (time == 0) {
+          continue;
         }
-        return total;
-      }
-      case ZET_VALUE_TYPE_FLOAT64: {
-        zet_typed_value_t total;
-        total.type = ZET_VALUE_TYPE_FLOAT64;
-        total.value.fp64 = 0.0;
-
-        for (int j = 0; j < report_count; ++j) {
-          report = report_list.data() + j * report_size;
-          zet_typed_value_t value = report[metric_id];
-          PTI_ASSERT(value.type == ZET_VALUE_TYPE_FLOAT64);
-          total.value.fp64 += value.value.fp64;
+
+        double flop = 0, bytes = 0;
+        if (!GetRooflineWork(aggregate_list, i, time, &flop, &bytes)) {
+          sampled = false;
+          break;
         }
-        return total;
+        total_time = (std::max)(total_time, time);
+        total_flop += flop;
+        total_bytes += bytes;
       }
-      default: {
-        PTI_ASSERT(0);
-        break;
+
+      if (!sampled || total_time == 0) {
+        ++skipped_count;
+        continue;
       }
+      roofline.AddKernel(item.first, total_time, total_flop, total_bytes);
+    }
+
+    correlator_.Log("\n");
+    correlator_.Log("== Roofline ==\n");
+    correlator_.Log("\n");
+
+    std::stringstream peaks;
+    peaks << "Peak Compute: ";
+    if (peak_compute > 0) {
+      peaks << peak_compute / NSEC_IN_SEC << " GFLOP/s" << std::endl;
+    } else {
+      peaks << "unknown" << std::endl;
+    }
+    peaks << "Peak Memory Bandwidth: ";
+    if (peak_memory > 0) {
+      peaks << peak_memory / NSEC_IN_SEC << " GB/s" << std::endl;
+    } else {
+      peaks << "unknown" << std::endl;
+    }
+    if (roofline.HasCeilings()) {
+      peaks << "Ridge Point: " << peak_compute / peak_memory <<
+        " FLOP/B" << std::endl;
+    }
+    peaks << std::endl;
+    correlator_.Log(peaks.str());
+
+    if (!roofline.IsEmpty()) {
+      std::stringstream table;
+      roofline.PrintKernelTable(table);
+      correlator_.Log(table.str());
+
+      correlator_.Log("\n");
+      correlator_.Log("== Roofline Plot ==\n");
+      correlator_.Log("\n");
+      std::stringstream plot;
+      roofline.PrintPlotData(plot);
+      correlator_.Log(plot.str());
     }
 
-    return zet_typed_value_t();
+    if (skipped_count > 0) {
+      std::cerr << "[INFO] " << skipped_count << " kernels got no " <<
+        "metric reports and are left out of roofline, a smaller " <<
+        "sampling interval may help" << std::endl;
+    }
   }
 
-  std::vector<zet_typed_value_t> GetAggregatedMetrics(
-      uint64_t start, uint64_t end,
-      uint32_t sub_device_id,
-      uint32_t report_time_id,
-      uint32_t gpu_clocks_id) const {
-    PTI_ASSERT(start < end);
-    PTI_ASSERT(sub_device_id < sub_device_count_);
+  void ReportZeAggregatedMetrics() {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    ReportAggregatedMetrics(GetZeKernelIntervalStore(), GetZeTargetDevice());
+  }
 
-    uint32_t report_size =
-      metric_collector_->GetReportSize(sub_device_id);
-    PTI_ASSERT(report_size > 0);
+  void ReportClAggregatedMetrics() {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    ReportAggregatedMetrics(GetClKernelIntervalStore(), GetClTargetDevice());
+  }
 
-    std::vector<std::string> metric_list =
-      metric_collector_->GetMetricList(sub_device_id);
-    PTI_ASSERT(metric_list.size() == report_size);
-
-    std::vector<zet_metric_type_t> metric_type_list =
-      metric_collector_->GetMetricTypeList(sub_device_id);
-    PTI_ASSERT(metric_type_list.size() == report_size);
-
-    std::vector<zet_typed_value_t> report_list =
-      GetMetricInterval(start, end, sub_device_id, report_time_id);
-    uint32_t report_count = report_list.size() / report_size;
-    PTI_ASSERT(report_count * report_size == report_list.size());
-    if (report_count == 0) {
-      return std::vector<zet_typed_value_t>();
+  static ArrowType GetArrowType(zet_value_type_t type, bool aggregated) {
+    switch (type) {
+      case ZET_VALUE_TYPE_UINT32:
+      case ZET_VALUE_TYPE_BOOL8:
+        return aggregated ? ARROW_TYPE_UINT64 : ARROW_TYPE_UINT32;
+      case ZET_VALUE_TYPE_UINT64:
+        return ARROW_TYPE_UINT64;
+      case ZET_VALUE_TYPE_FLOAT32:
+        return aggregated ? ARROW_TYPE_FLOAT64 : ARROW_TYPE_FLOAT32;
+      case ZET_VALUE_TYPE_FLOAT64:
+        return ARROW_TYPE_FLOAT64;
+      default:
+        PTI_ASSERT(0);
+        break;
     }
+    return ARROW_TYPE_UINT64;
+  }
 
-    uint64_t total_clocks = 0;
-    for (uint32_t i = 0; i < report_count; ++i) {
-      const zet_typed_value_t* report = report_list.data() + i * report_size;
-      PTI_ASSERT(report[gpu_clocks_id].type == ZET_VALUE_TYPE_UINT64);
-      total_clocks += report[gpu_clocks_id].value.ui64;
+  static void AppendTypedValue(
+      ArrowWriter* writer, uint32_t field_id, const zet_typed_value_t& value) {
+    PTI_ASSERT(writer != nullptr);
+    switch (value.type) {
+      case ZET_VALUE_TYPE_UINT32:
+        writer->Append(field_id, static_cast<uint64_t>(value.value.ui32));
+        break;
+      case ZET_VALUE_TYPE_UINT64:
+        writer->Append(field_id, static_cast<uint64_t>(value.value.ui64));
+        break;
+      case ZET_VALUE_TYPE_FLOAT32:
+        writer->Append(field_id, static_cast<double>(value.value.fp32));
+        break;
+      case ZET_VALUE_TYPE_FLOAT64:
+        writer->Append(field_id, value.value.fp64);
+        break;
+      case ZET_VALUE_TYPE_BOOL8:
+        writer->Append(field_id, static_cast<uint64_t>(value.value.b8));
+        break;
+      default:
+        PTI_ASSERT(0);
+        break;
     }
+  }
 
-    std::vector<zet_typed_value_t> aggregated_report(report_size);
+  // Metric columns take the value types of the first report of the group,
+  // aggregated ones are widened as the aggregation does. Returns an empty
+  // list if the group has no reports
+  std::vector<ArrowField> GetMetricFieldList(
+      uint32_t group_id, bool aggregated) const {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    std::vector<ArrowField> field_list;
 
-    for (uint32_t i = 0; i < report_size; ++i) {
-      if (metric_list[i] == "GpuTime") {
-        aggregated_report[i] = ComputeTotalValue(
-            i, report_list, report_size);
+    for (uint32_t i = 0; i < sub_device_count_; ++i) {
+      const MetricReportStore* report_store =
+        metric_collector_->GetReportStore(i, group_id);
+      PTI_ASSERT(report_store != nullptr);
+      if (report_store->GetReportCount() == 0) {
         continue;
       }
-      if (metric_list[i] == "AvgGpuCoreFrequencyMHz") {
-        aggregated_report[i] = ComputeAverageValue(
-            i, report_list, report_size, total_clocks, gpu_clocks_id);
-        continue;
-      }
-      if (metric_list[i] == "ReportReason") {
-        aggregated_report[i] = report_list.data()[i];
-        continue;
-      }
-      switch (metric_type_list[i]) {
-        case ZET_METRIC_TYPE_DURATION:
-        case ZET_METRIC_TYPE_RATIO:
-          aggregated_report[i] =
-            ComputeAverageValue(
-                i, report_list, report_size, total_clocks, gpu_clocks_id);
-          break;
-        case ZET_METRIC_TYPE_THROUGHPUT:
-        case ZET_METRIC_TYPE_EVENT:
-          aggregated_report[i] = ComputeTotalValue(
-              i, report_list, report_size);
-          break;
-        case ZET_METRIC_TYPE_TIMESTAMP:
-        case ZET_METRIC_TYPE_RAW:
-          aggregated_report[i] = report_list.data()[i];
-          break;
-        case ZET_METRIC_TYPE_EVENT_WITH_RANGE:
-        case ZET_METRIC_TYPE_FLAG:
-          break;
-        default:
-          PTI_ASSERT(0);
-          break;
+
+      std::vector<std::string> metric_list =
+        metric_collector_->GetMetricList(i, group_id);
+      PTI_ASSERT(metric_list.size() == report_store->GetReportSize());
+      const zet_typed_value_t* report = report_store->GetReport(0);
+      for (size_t j = 0; j < metric_list.size(); ++j) {
+        field_list.push_back(
+            {metric_list[j], GetArrowType(report[j].type, aggregated)});
       }
+      break;
     }
 
-    return aggregated_report;
+    return field_list;
   }
 
-  template <typename KernelInterval>
-  void ReportAggregatedMetrics(const KernelInterval& interval) {
-    std::stringstream stream;
-    stream << "Kernel," << interval.kernel_name << "," << std::endl;
-    correlator_.Log(stream.str());
-    for (auto& device_interval : interval.device_interval_list) {
-      uint32_t report_size =
-        metric_collector_->GetReportSize(device_interval.sub_device_id);
-      PTI_ASSERT(report_size > 0);
-
-      std::vector<std::string> metric_list =
-        metric_collector_->GetMetricList(device_interval.sub_device_id);
-      PTI_ASSERT(!metric_list.empty());
-      PTI_ASSERT(metric_list.size() == report_size);
+  std::string GetArrowTableName(
+      const std::string& table, uint32_t group_id) const {
+    if (!IsMultiplexed()) {
+      return table;
+    }
+    PTI_ASSERT(metric_collector_ != nullptr);
+    return table + "." + metric_collector_->GetGroupName(group_id);
+  }
 
-      size_t report_time_id = GetMetricId(metric_list, "QueryBeginTime");
-      PTI_ASSERT(report_time_id < metric_list.size());
+  void ReportArrowFile(const std::string& filename) {
+    std::cerr << "[INFO] Arrow table is stored in " << filename << std::endl;
+  }
 
-      size_t gpu_clocks_id = GetMetricId(metric_list, "GpuCoreClocks");
-      PTI_ASSERT(gpu_clocks_id < metric_list.size());
+  // Reports are written straight from the report store, one table per
+  // metric group
+  void ExportRawMetrics() {
+    PTI_ASSERT(metric_collector_ != nullptr);
 
-      std::vector<zet_typed_value_t> report_list = GetAggregatedMetrics(
-          ConvertTimestamp<KernelInterval>(device_interval.start),
-          ConvertTimestamp<KernelInterval>(device_interval.end),
-          device_interval.sub_device_id, report_time_id, gpu_clocks_id);
-      uint32_t report_count = report_list.size() / report_size;
-      PTI_ASSERT(report_count * report_size == report_list.size());
+    for (uint32_t g = 0; g < metric_collector_->GetGroupCount(); ++g) {
+      std::vector<ArrowField> field_list = GetMetricFieldList(g, false);
+      if (field_list.empty()) {
+        continue;
+      }
+      field_list.insert(
+          field_list.begin(), {"SubDeviceId", ARROW_TYPE_UINT32});
 
-      if (report_count > 0) {
-        std::stringstream header;
-        header << "SubDeviceId,";
-        for (auto& metric : metric_list) {
-          header << metric << ",";
-        }
-        header << std::endl;
-        correlator_.Log(header.str());
+      std::string filename =
+        options_.GetArrowFileName(GetArrowTableName("raw", g));
+      ArrowWriter* writer = ArrowWriter::Create(filename, field_list);
+      if (writer == nullptr) {
+        continue;
       }
 
-      for (int i = 0; i < report_count; ++i) {
-        std::stringstream line;
-        line << device_interval.sub_device_id << ",";
-        const zet_typed_value_t* report =
-          report_list.data() + i * report_size;
-        for (int j = 0; j < report_size; ++j) {
-          PrintTypedValue(line, report[j]);
-          line << ",";
+      for (uint32_t i = 0; i < sub_device_count_; ++i) {
+        const MetricReportStore* report_store =
+          metric_collector_->GetReportStore(i, g);
+        PTI_ASSERT(report_store != nullptr);
+        uint32_t report_size = report_store->GetReportSize();
+        PTI_ASSERT(report_size + 1 == field_list.size());
+
+        for (size_t j = 0; j < report_store->GetReportCount(); ++j) {
+          const zet_typed_value_t* report = report_store->GetReport(j);
+          writer->Append(0, static_cast<uint64_t>(i));
+          for (uint32_t k = 0; k < report_size; ++k) {
+            AppendTypedValue(writer, k + 1, report[k]);
+          }
+          writer->EndRow();
         }
-        line << std::endl;
-        correlator_.Log(line.str());
       }
+
+      delete writer;
+      ReportArrowFile(filename);
     }
-    correlator_.Log("\n");
   }
 
-  void ReportZeAggregatedMetrics() {
-    PTI_ASSERT(metric_collector_ != nullptr);
-    PTI_ASSERT(ze_kernel_collector_ != nullptr);
+  template <typename Store>
+  void ExportKernelIntervals(
+      const Store& store, typename Store::Device device,
+      uint32_t runtime_id, const ArrowDictionary& dictionary,
+      ArrowWriter* writer) {
+    PTI_ASSERT(writer != nullptr);
+    ForEachTargetLaunch(store, device,
+        [&](const KernelIntervalRecord* interval_list, uint32_t count) {
+          uint32_t name_id =
+            dictionary.Find(StringTable::Get(interval_list[0].name_id));
+          for (uint32_t i = 0; i < count; ++i) {
+            const KernelIntervalRecord& interval = interval_list[i];
+            uint64_t start = ConvertTimestamp<Store>(interval.start);
+            uint64_t end = ConvertTimestamp<Store>(interval.end);
+            writer->Append(0, static_cast<uint64_t>(name_id));
+            writer->Append(1, static_cast<uint64_t>(runtime_id));
+            writer->Append(2, static_cast<uint64_t>(interval.sub_device_id));
+            writer->Append(3, start);
+            writer->Append(4, end);
+            if (sysman_sampler_ != nullptr) {
+              writer->Append(5, GetSysmanValue(sysman_sampler_->GetAverage(
+                  device_id_, &SysmanCounterSample::frequency, start, end)));
+              writer->Append(6, GetSysmanValue(sysman_sampler_->GetAverage(
+                  device_id_, &SysmanCounterSample::power, start, end)));
+            }
+            writer->EndRow();
+          }
+        });
+  }
 
-    std::vector<ze_device_handle_t> device_list =
-      utils::ze::GetDeviceList();
-    if (device_list.empty()) {
-      return;
+  // Names of the target device launches both runtimes have collected
+  ArrowDictionary GetKernelDictionary() const {
+    ArrowDictionary dictionary;
+    auto add = [&dictionary](
+        const KernelIntervalRecord* interval_list, uint32_t count) {
+      dictionary.Add(StringTable::Get(interval_list[0].name_id));
+    };
+    if (ze_kernel_collector_ != nullptr) {
+      ForEachTargetLaunch(
+          GetZeKernelIntervalStore(), GetZeTargetDevice(), add);
     }
+    if (cl_kernel_collector_ != nullptr) {
+      ForEachTargetLaunch(
+          GetClKernelIntervalStore(), GetClTargetDevice(), add);
+    }
+    return dictionary;
+  }
 
-    const ZeKernelIntervalList& interval_list =
-      ze_kernel_collector_->GetKernelIntervalList();
-    for (auto& kernel_interval : interval_list) {
-      if (device_list[device_id_] != kernel_interval.device) {
-        continue;
-      }
+  void ExportKernelIntervals(const ArrowDictionary& dictionary,
+                             ArrowWriter* writer) {
+    if (ze_kernel_collector_ != nullptr) {
+      ExportKernelIntervals(GetZeKernelIntervalStore(), GetZeTargetDevice(),
+                            0, dictionary, writer);
+    }
+    if (cl_kernel_collector_ != nullptr) {
+      ExportKernelIntervals(GetClKernelIntervalStore(), GetClTargetDevice(),
+                            1, dictionary, writer);
+    }
+  }
 
-      ReportAggregatedMetrics(kernel_interval);
+  // Unknown values are stored as NaN, as the columns are not nullable
+  static double GetSysmanValue(double value) {
+    if (value >= 0) {
+      return value;
     }
+    return std::numeric_limits<double>::quiet_NaN();
   }
 
-  void ReportClAggregatedMetrics() {
-    PTI_ASSERT(metric_collector_ != nullptr);
-    PTI_ASSERT(cl_kernel_collector_ != nullptr);
+  void ExportKernelIntervals() {
+    ArrowDictionary dictionary = GetKernelDictionary();
+
+    std::vector<ArrowField> field_list = {
+        {"Kernel", ARROW_TYPE_DICTIONARY},
+        {"Runtime", ARROW_TYPE_DICTIONARY},
+        {"SubDeviceId", ARROW_TYPE_UINT32},
+        {"Start", ARROW_TYPE_UINT64},
+        {"End", ARROW_TYPE_UINT64}};
+    if (sysman_sampler_ != nullptr) {
+      field_list.push_back({"Frequency(MHz)", ARROW_TYPE_FLOAT64});
+      field_list.push_back({"Power(W)", ARROW_TYPE_FLOAT64});
+    }
 
-    std::vector<cl_device_id> device_list =
-      utils::cl::GetDeviceList(CL_DEVICE_TYPE_GPU);
-    if (device_list.empty()) {
+    std::string filename = options_.GetArrowFileName("kernels");
+    ArrowWriter* writer = ArrowWriter::Create(filename, field_list);
+    if (writer == nullptr) {
+      return;
+    }
+
+    writer->SetDictionary(0, dictionary.GetValueList());
+    writer->SetDictionary(1, {"Level Zero", "OpenCL"});
+    ExportKernelIntervals(dictionary, writer);
+
+    delete writer;
+    ReportArrowFile(filename);
+  }
+
+  // Writer list is indexed by metric group, null for empty groups
+  template <typename Store>
+  void ExportAggregatedMetrics(
+      const Store& store, typename Store::Device device,
+      const ArrowDictionary& dictionary,
+      const std::vector<ArrowWriter*>& writer_list) {
+    PTI_ASSERT(metric_collector_ != nullptr);
+    if (store.IsEmpty()) {
       return;
     }
 
-    const ClKernelIntervalList& interval_list =
-      cl_kernel_collector_->GetKernelIntervalList();
-    for (auto& kernel_interval : interval_list) {
-      if (device_list[device_id_] != kernel_interval.device) {
+    uint32_t group_count = metric_collector_->GetGroupCount();
+    PTI_ASSERT(writer_list.size() == group_count);
+    StreamReportList stream_report_list = AttributeMetrics(store, device);
+
+    std::vector<size_t> position_list(stream_report_list.size(), 0);
+    ForEachTargetLaunch(store, device,
+        [&](const KernelIntervalRecord* interval_list, uint32_t count) {
+          uint32_t name_id =
+            dictionary.Find(StringTable::Get(interval_list[0].name_id));
+          for (uint32_t k = 0; k < count; ++k) {
+            uint32_t sub_device_id = interval_list[k].sub_device_id;
+            for (uint32_t g = 0; g < group_count; ++g) {
+              uint32_t stream_id =
+                metric_collector_->GetStreamId(sub_device_id, g);
+              PTI_ASSERT(position_list[stream_id] <
+                         stream_report_list[stream_id].size());
+              const std::vector<zet_typed_value_t>& report =
+                stream_report_list[stream_id][position_list[stream_id]++];
+              if (report.empty() || writer_list[g] == nullptr) {
+                continue;
+              }
+
+              ArrowWriter* writer = writer_list[g];
+              writer->Append(0, static_cast<uint64_t>(name_id));
+              writer->Append(1, static_cast<uint64_t>(sub_device_id));
+              for (uint32_t j = 0; j < report.size(); ++j) {
+                AppendTypedValue(writer, j + 2, report[j]);
+              }
+              writer->EndRow();
+            }
+          }
+        });
+  }
+
+  // One row per device interval of each kernel run, one table per group
+  void ExportAggregatedMetrics() {
+    PTI_ASSERT(metric_collector_ != nullptr);
+
+    ArrowDictionary dictionary = GetKernelDictionary();
+
+    std::vector<ArrowWriter*> writer_list(
+        metric_collector_->GetGroupCount(), nullptr);
+    std::vector<std::string> filename_list(writer_list.size());
+    for (uint32_t g = 0; g < writer_list.size(); ++g) {
+      std::vector<ArrowField> field_list = GetMetricFieldList(g, true);
+      if (field_list.empty()) {
         continue;
       }
+      field_list.insert(field_list.begin(), {
+          {"Kernel", ARROW_TYPE_DICTIONARY},
+          {"SubDeviceId", ARROW_TYPE_UINT32}});
+
+      filename_list[g] =
+        options_.GetArrowFileName(GetArrowTableName("aggregated", g));
+      writer_list[g] = ArrowWriter::Create(filename_list[g], field_list);
+      if (writer_list[g] != nullptr) {
+        writer_list[g]->SetDictionary(0, dictionary.GetValueList());
+      }
+    }
 
-      ReportAggregatedMetrics(kernel_interval);
+    if (ze_kernel_collector_ != nullptr) {
+      ExportAggregatedMetrics(GetZeKernelIntervalStore(), GetZeTargetDevice(),
+                              dictionary, writer_list);
+    }
+    if (cl_kernel_collector_ != nullptr) {
+      ExportAggregatedMetrics(GetClKernelIntervalStore(), GetClTargetDevice(),
+                              dictionary, writer_list);
+    }
+
+    for (uint32_t g = 0; g < writer_list.size(); ++g) {
+      if (writer_list[g] != nullptr) {
+        delete writer_list[g];
+        ReportArrowFile(filename_list[g]);
+      }
     }
   }
 
  private:
   ProfOptions options_;
   MetricCollector* metric_collector_ = nullptr;
+  MetricQueryCollector* metric_query_collector_ = nullptr;
   ZeKernelCollector* ze_kernel_collector_ = nullptr;
   ClKernelCollector* cl_kernel_collector_ = nullptr;
+  MetricAggregator* metric_aggregator_ = nullptr;
+  CaptureControl* capture_ = nullptr;
+  IttCollector* itt_collector_ = nullptr;
+  SysmanSampler* sysman_sampler_ = nullptr;
   Correlator correlator_;
 
+  ze_device_handle_t ze_device_ = nullptr;
+  ZeDeviceCapabilities ze_capabilities_;
+  cl_device_id cl_device_ = nullptr;
+  ZeKernelIntervalStore ze_kernel_interval_store_;
+  ClKernelIntervalStore cl_kernel_interval_store_;
+
+  std::vector<IttTaskInterval> itt_task_list_;
+  std::mutex itt_lock_;
+
   uint32_t device_id_ = 0;
   uint32_t sub_device_count_ = 0;
 
   uint64_t host_sync_ = 0;
   uint64_t device_sync_ = 0;
   uint64_t device_freq_ = 0;
+  uint32_t core_clock_rate_ = 0; // MHz
 };
 
 #endif // PTI_TOOLS_ONEPROF_PROFILER_H_
\ No newline at end of file
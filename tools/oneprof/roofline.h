@@ -0,0 +1,180 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ONEPROF_ROOFLINE_H_
+#define PTI_TOOLS_ONEPROF_ROOFLINE_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "pti_assert.h"
+#include "utils.h"
+
+#define ROOFLINE_PLOT_MARGIN 10.0 // Ceilings go this far past the points
+
+// Places kernels on the roofline of the device: operational intensity
+// (FLOP per byte of memory traffic) against achieved FLOP/s. A kernel is
+// memory-bound if its intensity is below the ridge point, where memory
+// bandwidth ceiling meets the compute one, and compute-bound otherwise.
+// Attainment is the share of the ceiling above the kernel that it reaches.
+// Unknown peaks (zero) leave the ceilings out
+class Roofline {
+ public: // Interface
+  // Peaks are in FLOP/s and bytes/s
+  Roofline(double peak_compute, double peak_memory)
+      : peak_compute_(peak_compute), peak_memory_(peak_memory) {
+    PTI_ASSERT(peak_compute_ >= 0 && peak_memory_ >= 0);
+  }
+
+  // Work done by all the runs of the kernel, time is in ns
+  void AddKernel(const std::string& name, uint64_t time,
+                 double flop, double bytes) {
+    PTI_ASSERT(time > 0);
+    PTI_ASSERT(flop >= 0 && bytes >= 0);
+    kernel_list_.push_back({name, time, flop, bytes});
+  }
+
+  bool IsEmpty() const {
+    return kernel_list_.empty();
+  }
+
+  bool HasCeilings() const {
+    return peak_compute_ > 0 && peak_memory_ > 0;
+  }
+
+  // Kernels go from the longest one, so the top of the list is where
+  // the time goes and the bottleneck tells what limits it
+  void PrintKernelTable(std::ostream& stream) const {
+    std::vector<Kernel> kernel_list = kernel_list_;
+    std::sort(kernel_list.begin(), kernel_list.end(),
+              [](const Kernel& left, const Kernel& right) {
+                return left.time > right.time;
+              });
+
+    uint64_t total_time = 0;
+    for (const Kernel& kernel : kernel_list) {
+      total_time += kernel.time;
+    }
+
+    stream << "Kernel,Time(ns),Time(%),GFLOP/s,GB/s,Intensity(FLOP/B)," <<
+      "Attainable(GFLOP/s),Attainment(%),Bottleneck," << std::endl;
+    for (const Kernel& kernel : kernel_list) {
+      stream << kernel.name << ",";
+      stream << kernel.time << ",";
+      stream << 100.0 * kernel.time / total_time << ",";
+      stream << GetPerformance(kernel) << ",";
+      stream << kernel.bytes / kernel.time << ",";
+      if (kernel.bytes > 0) {
+        stream << GetIntensity(kernel);
+      }
+      stream << ",";
+      if (HasCeilings() && kernel.bytes > 0) {
+        double attainable = GetAttainable(GetIntensity(kernel));
+        stream << attainable << ",";
+        stream << 100.0 * GetPerformance(kernel) / attainable << ",";
+      } else {
+        stream << ",,";
+      }
+      stream << GetBottleneck(kernel) << ",";
+      stream << std::endl;
+    }
+  }
+
+  // Points of the ceilings and of the kernels, in FLOP/B and GFLOP/s,
+  // for a log-log plot. Kernels with no memory traffic have no intensity
+  // and are left out
+  void PrintPlotData(std::ostream& stream) const {
+    stream << "Series,Name,Intensity(FLOP/B),Performance(GFLOP/s)," <<
+      std::endl;
+
+    if (HasCeilings()) {
+      double ridge = GetRidgePoint();
+      double left = ridge;
+      double right = ridge;
+      for (const Kernel& kernel : kernel_list_) {
+        if (kernel.bytes > 0 && kernel.flop > 0) {
+          left = (std::min)(left, GetIntensity(kernel));
+          right = (std::max)(right, GetIntensity(kernel));
+        }
+      }
+      left /= ROOFLINE_PLOT_MARGIN;
+      right *= ROOFLINE_PLOT_MARGIN;
+
+      double peak = GetAttainable(right);
+      stream << "Ceiling,Memory," << left << "," << GetAttainable(left) <<
+        "," << std::endl;
+      stream << "Ceiling,Memory," << ridge << "," << peak << "," <<
+        std::endl;
+      stream << "Ceiling,Compute," << ridge << "," << peak << "," <<
+        std::endl;
+      stream << "Ceiling,Compute," << right << "," << peak << "," <<
+        std::endl;
+    }
+
+    for (const Kernel& kernel : kernel_list_) {
+      if (kernel.bytes > 0) {
+        stream << "Kernel," << kernel.name << "," << GetIntensity(kernel) <<
+          "," << GetPerformance(kernel) << "," << std::endl;
+      }
+    }
+  }
+
+  Roofline(const Roofline& copy) = delete;
+  Roofline& operator=(const Roofline& copy) = delete;
+
+ private: // Implementation
+  struct Kernel {
+    std::string name;
+    uint64_t time; // ns
+    double flop;
+    double bytes;
+  };
+
+  static double GetIntensity(const Kernel& kernel) {
+    PTI_ASSERT(kernel.bytes > 0);
+    return kernel.flop / kernel.bytes;
+  }
+
+  // GFLOP/s, as FLOP per ns
+  static double GetPerformance(const Kernel& kernel) {
+    PTI_ASSERT(kernel.time > 0);
+    return kernel.flop / kernel.time;
+  }
+
+  double GetRidgePoint() const {
+    PTI_ASSERT(HasCeilings());
+    return peak_compute_ / peak_memory_;
+  }
+
+  // GFLOP/s the device allows at the given intensity
+  double GetAttainable(double intensity) const {
+    PTI_ASSERT(HasCeilings());
+    return (std::min)(peak_compute_, intensity * peak_memory_) /
+      static_cast<double>(NSEC_IN_SEC);
+  }
+
+  // Kernels with no memory traffic are compute-bound at any peaks
+  std::string GetBottleneck(const Kernel& kernel) const {
+    if (kernel.bytes == 0) {
+      return "Compute";
+    }
+    if (!HasCeilings()) {
+      return std::string();
+    }
+    return (GetIntensity(kernel) < GetRidgePoint()) ? "Memory" : "Compute";
+  }
+
+ private: // Data
+  double peak_compute_ = 0;
+  double peak_memory_ = 0;
+  std::vector<Kernel> kernel_list_;
+};
+
+#endif // PTI_TOOLS_ONEPROF_ROOFLINE_H_
@@ -35,13 +35,45 @@ void Usage() {
     "--aggregation [-a]               " <<
     "Aggregate metrics for each kernel" <<
     std::endl;
+  std::cout <<
+    "--online-aggregation             " <<
+    "Aggregate metrics for each kernel while application is running" <<
+    std::endl;
+  std::cout <<
+    "--query                          " <<
+    "Collect metrics for each kernel launch with metric queries" <<
+    std::endl;
+  std::cout <<
+    "--roofline                       " <<
+    "Place kernels on the device roofline by operational intensity " <<
+    "and achieved FLOP/s" <<
+    std::endl;
+  std::cout <<
+    "--shared-metrics                 " <<
+    "Share metric streamers of the device between processes " <<
+    "(e.g. MPI ranks)" <<
+    std::endl;
+  std::cout <<
+    "--itt                            " <<
+    "Collect ITT tasks and honor ITT pause/resume" <<
+    std::endl;
+  std::cout <<
+    "--sysman-counters                " <<
+    "Sample GPU frequency, power, temperature and throttle reasons, " <<
+    "add average frequency and power to kernel intervals" <<
+    std::endl;
   std::cout <<
     "--device [-d] <ID>               " <<
     "Target device for profiling (default is 0)" <<
     std::endl;
   std::cout <<
     "--group [-g] <NAME>              " <<
-    "Target metric group to collect (default is ComputeBasic)" <<
+    "Target metric group to collect (default is ComputeBasic), " <<
+    "several comma-separated groups are multiplexed" <<
+    std::endl;
+  std::cout <<
+    "--multiplex-period <ms>          " <<
+    "Time to collect each of multiplexed groups (default is 100 ms)" <<
     std::endl;
   std::cout <<
     "--sampling-interval [-s] <VALUE> " <<
@@ -51,6 +83,35 @@ void Usage() {
     "--output [-o] <filename>         " <<
     "Print console logs into the file" <<
     std::endl;
+  std::cout <<
+    "--arrow-output <filename>        " <<
+    "Store raw metrics, kernel intervals and aggregated metrics " <<
+    "into Apache Arrow files instead of the log" <<
+    std::endl;
+  std::cout <<
+    "--capture-delay <ms>             " <<
+    "Start capture after the given delay" <<
+    std::endl;
+  std::cout <<
+    "--capture-duration <ms>          " <<
+    "Stop capture after the given duration" <<
+    std::endl;
+  std::cout <<
+    "--capture-kernel <name>          " <<
+    "Start capture after the kernel launch" <<
+    std::endl;
+  std::cout <<
+    "--capture-kernel-count <N>       " <<
+    "Start capture after N-th kernel launch" <<
+    std::endl;
+  std::cout <<
+    "--capture-file <path>            " <<
+    "Capture while the given file exists" <<
+    std::endl;
+  std::cout <<
+    "--capture-signal                 " <<
+    "Start/stop capture on SIGUSR1/SIGUSR2" <<
+    std::endl;
   std::cout <<
     "--device-list                    " <<
     "Print list of available devices" <<
@@ -59,6 +120,10 @@ void Usage() {
     "--metric-list                    " <<
     "Print list of available metrics" <<
     std::endl;
+  std::cout <<
+    "--overhead                       " <<
+    "Report time spent by the tool itself" <<
+    std::endl;
   std::cout <<
     "--version                        " <<
     "Print version" <<
@@ -90,6 +155,24 @@ int ParseArgs(int argc, char* argv[]) {
                strcmp(argv[i], "-a") == 0) {
       utils::SetEnv("ONEPROF_Aggregation", "1");
       ++app_index;
+    } else if (strcmp(argv[i], "--online-aggregation") == 0) {
+      utils::SetEnv("ONEPROF_OnlineAggregation", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--query") == 0) {
+      utils::SetEnv("ONEPROF_MetricQuery", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--roofline") == 0) {
+      utils::SetEnv("ONEPROF_Roofline", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--shared-metrics") == 0) {
+      utils::SetEnv("ONEPROF_SharedMetrics", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--itt") == 0) {
+      utils::SetEnv("ONEPROF_Itt", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--sysman-counters") == 0) {
+      utils::SetEnv("ONEPROF_SysmanCounters", "1");
+      ++app_index;
     } else if (strcmp(argv[i], "--device") == 0 ||
                strcmp(argv[i], "-d") == 0) {
       ++i;
@@ -108,6 +191,18 @@ int ParseArgs(int argc, char* argv[]) {
       }
       utils::SetEnv("ONEPROF_MetricGroup", argv[i]);
       app_index += 2;
+    } else if (strcmp(argv[i], "--multiplex-period") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Multiplex period is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Multiplex period is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONEPROF_MultiplexPeriod", argv[i]);
+      app_index += 2;
     } else if (strcmp(argv[i], "--sampling-interval") == 0 ||
                strcmp(argv[i], "-s") == 0) {
       ++i;
@@ -126,12 +221,79 @@ int ParseArgs(int argc, char* argv[]) {
       }
       utils::SetEnv("ONEPROF_LogFilename", argv[i]);
       app_index += 2;
+    } else if (strcmp(argv[i], "--arrow-output") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Arrow file name is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONEPROF_ArrowFilename", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-delay") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture delay is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture delay is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONEPROF_CaptureDelay", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-duration") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture duration is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture duration is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONEPROF_CaptureDuration", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-kernel") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture kernel is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONEPROF_CaptureKernel", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-kernel-count") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture kernel count is not specified" <<
+          std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture kernel count is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONEPROF_CaptureKernelCount", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-file") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture file is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONEPROF_CaptureFile", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-signal") == 0) {
+      utils::SetEnv("ONEPROF_CaptureSignal", "1");
+      ++app_index;
     } else if (strcmp(argv[i], "--device-list") == 0) {
       PrintDeviceList();
       return 0;
     } else if (strcmp(argv[i], "--metric-list") == 0) {
       metric_list = true;
       ++app_index;
+    } else if (strcmp(argv[i], "--overhead") == 0) {
+      utils::SetEnv("PTI_OVERHEAD", "1");
+      ++app_index;
     } else if (strcmp(argv[i], "--version") == 0) {
 #ifdef PTI_VERSION
       std::cout << TOSTRING(PTI_VERSION) << std::endl;
@@ -170,7 +332,9 @@ static ProfOptions ReadArgs() {
   uint32_t device_id = 0;
   uint32_t sampling_interval = 1000000;
   std::string metric_group("ComputeBasic");
+  uint64_t multiplex_period = 100000000;
   std::string log_file;
+  std::string arrow_file;
 
   value = utils::GetEnv("ONEPROF_RawMetrics");
   if (!value.empty()) {
@@ -192,16 +356,54 @@ static ProfOptions ReadArgs() {
     flags |= (1 << PROF_AGGREGATION);
   }
 
+  value = utils::GetEnv("ONEPROF_OnlineAggregation");
+  if (!value.empty()) {
+    flags |= (1 << PROF_ONLINE_AGGREGATION);
+  }
+
+  value = utils::GetEnv("ONEPROF_MetricQuery");
+  if (!value.empty()) {
+    flags |= (1 << PROF_METRIC_QUERY);
+  }
+
+  value = utils::GetEnv("ONEPROF_Roofline");
+  if (!value.empty()) {
+    flags |= (1 << PROF_ROOFLINE);
+  }
+
+  value = utils::GetEnv("ONEPROF_SharedMetrics");
+  if (!value.empty()) {
+    flags |= (1 << PROF_SHARED_METRICS);
+  }
+
+  value = utils::GetEnv("ONEPROF_Itt");
+  if (!value.empty()) {
+    flags |= (1 << PROF_ITT);
+  }
+
+  value = utils::GetEnv("ONEPROF_SysmanCounters");
+  if (!value.empty()) {
+    flags |= (1 << PROF_SYSMAN_COUNTERS);
+  }
+
   value = utils::GetEnv("ONEPROF_MetricGroup");
   if (!value.empty()) {
     metric_group = value;
   }
 
+  value = utils::GetEnv("ONEPROF_MultiplexPeriod");
+  if (!value.empty()) {
+    multiplex_period = std::stoull(value);
+    multiplex_period *= 1000000;
+  }
+
   value = utils::GetEnv("ONEPROF_LogFilename");
   if (!value.empty()) {
     log_file = value;
   }
 
+  arrow_file = utils::GetEnv("ONEPROF_ArrowFilename");
+
   value = utils::GetEnv("ONEPROF_DeviceId");
   if (!value.empty()) {
     device_id = std::stoul(value);
@@ -214,7 +416,8 @@ static ProfOptions ReadArgs() {
   }
 
   return ProfOptions(
-      flags, device_id, sampling_interval, metric_group, log_file);
+      flags, device_id, sampling_interval, metric_group, multiplex_period,
+      log_file, arrow_file, CaptureOptions::Read("ONEPROF_"));
 }
 
 void EnableProfiling() {
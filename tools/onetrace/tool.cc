@@ -35,6 +35,42 @@ void Usage() {
     "--device-timing-verbose [-v]   " <<
     "Report kernels execution time with SIMD width and global/local sizes" <<
     std::endl;
+  std::cout <<
+    "--queue-timing                 " <<
+    "Report busy/idle time and submission latency per queue and engine" <<
+    std::endl;
+  std::cout <<
+    "--dependency-graph             " <<
+    "Report critical path and unused parallelism of command dependencies" <<
+    std::endl;
+  std::cout <<
+    "--call-stacks                  " <<
+    "Report kernel time per host call stack of the launch" <<
+    std::endl;
+  std::cout <<
+    "--wait-analysis                " <<
+    "Report host time blocked in synchronization calls and its commands" <<
+    std::endl;
+  std::cout <<
+    "--transfer-timing              " <<
+    "Report memory transfer bandwidth per direction and engine" <<
+    std::endl;
+  std::cout <<
+    "--tile-timing                  " <<
+    "Report per-tile busy time and load imbalance of kernels" <<
+    std::endl;
+  std::cout <<
+    "--memory-tracking              " <<
+    "Track USM allocations and report peak footprint per device" <<
+    std::endl;
+  std::cout <<
+    "--alloc-churn                  " <<
+    "Report short-lived allocations and pooling savings" <<
+    std::endl;
+  std::cout <<
+    "--critical-path                " <<
+    "Report host-bound vs device-bound breakdown of kernel path" <<
+    std::endl;
   std::cout <<
     "--device-timeline [-t]         " <<
     "Trace device activities" <<
@@ -67,6 +103,149 @@ void Usage() {
     "--pid                          " <<
     "Print process ID into host API and device activity trace" <<
     std::endl;
+  std::cout <<
+    "--async-logging                " <<
+    "Write logs and traces from a background thread" <<
+    std::endl;
+  std::cout <<
+    "--log-buffer-size <KB>         " <<
+    "Per-thread buffer size for asynchronous logging" <<
+    std::endl;
+  std::cout <<
+    "--compress <method>            " <<
+    "Compress log and timeline files in frames (zstd|lz4)" <<
+    std::endl;
+  std::cout <<
+    "--binary-trace                 " <<
+    "Dump host and device activities to binary file" <<
+    std::endl;
+  std::cout <<
+    "--node-trace                   " <<
+    "Send binary trace to node trace daemon if it runs" <<
+    std::endl;
+  std::cout <<
+    "--perfetto-trace               " <<
+    "Dump host and device activities to Perfetto file" <<
+    std::endl;
+  std::cout <<
+    "--ring-buffer <MB>             " <<
+    "Keep recent activities in memory, dump on SIGUSR1 or exit" <<
+    std::endl;
+  std::cout <<
+    "--ring-buffer-trigger <us>     " <<
+    "Dump ring buffer once a kernel runs longer than the given time" <<
+    std::endl;
+  std::cout <<
+    "--poll-interval <us>           " <<
+    "Read out finished kernels every given time" <<
+    std::endl;
+  std::cout <<
+    "--batch-timestamps             " <<
+    "Read kernel timestamps of command list at once" <<
+    std::endl;
+  std::cout <<
+    "--include-api <patterns>       " <<
+    "Trace only API functions matching the patterns" <<
+    std::endl;
+  std::cout <<
+    "--exclude-api <patterns>       " <<
+    "Do not trace API functions matching the patterns" <<
+    std::endl;
+  std::cout <<
+    "--kernel-sampling <N|rate>     " <<
+    "Trace every N-th or random share of kernel launches" <<
+    std::endl;
+  std::cout <<
+    "--module-dump <directory>      " <<
+    "Dump binaries and debug info of built modules into the directory" <<
+    std::endl;
+  std::cout <<
+    "--kernel-grouping <mode>       " <<
+    "Group kernel table rows by name, local size or full launch config " <<
+    "(name|local|config)" <<
+    std::endl;
+  std::cout <<
+    "--capture-delay <ms>           " <<
+    "Start capture after the given delay" <<
+    std::endl;
+  std::cout <<
+    "--capture-duration <ms>        " <<
+    "Stop capture after the given duration" <<
+    std::endl;
+  std::cout <<
+    "--capture-kernel <name>        " <<
+    "Start capture after the kernel launch" <<
+    std::endl;
+  std::cout <<
+    "--capture-kernel-count <N>     " <<
+    "Start capture after N-th kernel launch" <<
+    std::endl;
+  std::cout <<
+    "--capture-file <path>          " <<
+    "Capture while the given file exists" <<
+    std::endl;
+  std::cout <<
+    "--capture-signal               " <<
+    "Start/stop capture on SIGUSR1/SIGUSR2" <<
+    std::endl;
+  std::cout <<
+    "--itt                          " <<
+    "Collect ITT tasks and honor ITT pause/resume" <<
+    std::endl;
+  std::cout <<
+    "--collector-api                " <<
+    "Let the application start/stop collection and read stats" <<
+    std::endl;
+  std::cout <<
+    "--omp-device                   " <<
+    "Trace OpenMP offload regions on device through OMPT buffers" <<
+    std::endl;
+  std::cout <<
+    "--sycl                         " <<
+    "Trace SYCL tasks through XPTI and attribute API calls and " <<
+    "kernels to them" <<
+    std::endl;
+  std::cout <<
+    "--sysman-counters              " <<
+    "Sample GPU frequency, power, temperature and throttle reasons " <<
+    "into Chrome/binary trace and per-kernel frequency table" <<
+    std::endl;
+  std::cout <<
+    "--kernel-energy                " <<
+    "Sample GPU energy counters and report energy per kernel" <<
+    std::endl;
+  std::cout <<
+    "--telemetry <port>             " <<
+    "Stream kernel, transfer and API aggregates to TCP subscribers" <<
+    std::endl;
+  std::cout <<
+    "--telemetry-interval <ms>      " <<
+    "Period of telemetry updates (1000 ms by default)" <<
+    std::endl;
+  std::cout <<
+    "--telemetry-address <ip>       " <<
+    "Address to serve telemetry on (127.0.0.1 by default)" <<
+    std::endl;
+  std::cout <<
+    "--interval <sec>               " <<
+    "Store timing statistics per time window to CSV file" <<
+    std::endl;
+  std::cout <<
+    "--save-tables                  " <<
+    "Store timing tables to JSON file for run-to-run comparison" <<
+    std::endl;
+  std::cout <<
+    "--overhead                     " <<
+    "Report time spent by the tool itself" <<
+    std::endl;
+  std::cout <<
+    "--subtract-overhead            " <<
+    "Report tool overhead and take it out of host API timings" <<
+    std::endl;
+  std::cout <<
+    "--overhead-budget <percent>    " <<
+    "Reduce tracing detail while tool overhead is over the budget" <<
+    std::endl;
   std::cout <<
     "--version                      " <<
     "Print version" <<
@@ -96,6 +275,33 @@ int ParseArgs(int argc, char* argv[]) {
                strcmp(argv[i], "-v") == 0) {
       utils::SetEnv("ONETRACE_DeviceTimingVerbose", "1");
       ++app_index;
+    } else if (strcmp(argv[i], "--queue-timing") == 0) {
+      utils::SetEnv("ONETRACE_QueueTiming", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--dependency-graph") == 0) {
+      utils::SetEnv("ONETRACE_DependencyGraph", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--call-stacks") == 0) {
+      utils::SetEnv("ONETRACE_CallStacks", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--wait-analysis") == 0) {
+      utils::SetEnv("ONETRACE_WaitAnalysis", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--transfer-timing") == 0) {
+      utils::SetEnv("ONETRACE_TransferTiming", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--tile-timing") == 0) {
+      utils::SetEnv("ONETRACE_TileTiming", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--memory-tracking") == 0) {
+      utils::SetEnv("ONETRACE_MemoryTracking", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--alloc-churn") == 0) {
+      utils::SetEnv("ONETRACE_AllocChurn", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--critical-path") == 0) {
+      utils::SetEnv("ONETRACE_CriticalPath", "1");
+      ++app_index;
     } else if (strcmp(argv[i], "--device-timeline") == 0 ||
                strcmp(argv[i], "-t") == 0) {
       utils::SetEnv("ONETRACE_DeviceTimeline", "1");
@@ -128,6 +334,287 @@ int ParseArgs(int argc, char* argv[]) {
     } else if (strcmp(argv[i], "--pid") == 0) {
       utils::SetEnv("ONETRACE_Pid", "1");
       ++app_index;
+    } else if (strcmp(argv[i], "--async-logging") == 0) {
+      utils::SetEnv("ONETRACE_AsyncLogging", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--log-buffer-size") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Log buffer size is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Log buffer size is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_LogBufferSize", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--compress") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Compression method is not specified" <<
+          std::endl;
+        return -1;
+      }
+      if (!StreamCompressor::IsMethod(argv[i])) {
+        std::cout << "[ERROR] Compression method is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_Compression", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--binary-trace") == 0) {
+      utils::SetEnv("ONETRACE_BinaryTrace", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--node-trace") == 0) {
+      utils::SetEnv("ONETRACE_BinaryTrace", "1");
+      utils::SetEnv("ONETRACE_NodeTrace", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--perfetto-trace") == 0) {
+      utils::SetEnv("ONETRACE_PerfettoTrace", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--ring-buffer") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Ring buffer size is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Ring buffer size is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_RingBuffer", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--ring-buffer-trigger") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Ring buffer trigger is not specified" <<
+          std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Ring buffer trigger is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_RingBufferTrigger", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--poll-interval") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Poll interval is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Poll interval is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_PollInterval", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--batch-timestamps") == 0) {
+      utils::SetEnv("ONETRACE_BatchTimestamps", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--include-api") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Included API patterns are not specified" <<
+          std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_IncludeApi", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--exclude-api") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Excluded API patterns are not specified" <<
+          std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_ExcludeApi", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--kernel-sampling") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Kernel sampling is not specified" << std::endl;
+        return -1;
+      }
+      if (!KernelSampler::IsValid(argv[i])) {
+        std::cout << "[ERROR] Kernel sampling is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_KernelSampling", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--module-dump") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Module dump directory is not specified" <<
+          std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_ModuleDump", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--kernel-grouping") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Kernel grouping is not specified" << std::endl;
+        return -1;
+      }
+      KernelGrouping grouping = KERNEL_GROUPING_NAME;
+      if (!KernelStatistics::ParseGrouping(argv[i], &grouping)) {
+        std::cout << "[ERROR] Kernel grouping is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_KernelGrouping", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-delay") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture delay is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture delay is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_CaptureDelay", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-duration") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture duration is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture duration is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_CaptureDuration", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-kernel") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture kernel is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_CaptureKernel", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-kernel-count") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture kernel count is not specified" <<
+          std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture kernel count is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_CaptureKernelCount", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-file") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture file is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_CaptureFile", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-signal") == 0) {
+      utils::SetEnv("ONETRACE_CaptureSignal", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--itt") == 0) {
+      utils::SetEnv("ONETRACE_Itt", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--collector-api") == 0) {
+      utils::SetEnv("ONETRACE_CollectorApi", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--omp-device") == 0) {
+      utils::SetEnv("ONETRACE_OmpDevice", "1");
+      utils::SetEnv(OMP_DEVICE_TRACING_ENV, "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--sycl") == 0) {
+      utils::SetEnv("ONETRACE_Sycl", "1");
+      if (!SyclCollector::SetSubscriberLibrary()) {
+        std::cerr << "[WARNING] Unable to register SYCL subscriber" <<
+          std::endl;
+      }
+      ++app_index;
+    } else if (strcmp(argv[i], "--sysman-counters") == 0) {
+      utils::SetEnv("ONETRACE_SysmanCounters", "1");
+      utils::SetEnv("ZES_ENABLE_SYSMAN", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--kernel-energy") == 0) {
+      utils::SetEnv("ONETRACE_KernelEnergy", "1");
+      utils::SetEnv("ZES_ENABLE_SYSMAN", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--telemetry") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Telemetry port is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) < 0 || atoi(argv[i]) > 65535) {
+        std::cout << "[ERROR] Telemetry port is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_Telemetry", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--telemetry-interval") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Telemetry interval is not specified" <<
+          std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Telemetry interval is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_TelemetryInterval", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--telemetry-address") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Telemetry address is not specified" <<
+          std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_TelemetryAddress", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--interval") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Interval is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Interval is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_Interval", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--save-tables") == 0) {
+      utils::SetEnv("ONETRACE_SaveTables", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--overhead") == 0) {
+      utils::SetEnv("PTI_OVERHEAD", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--subtract-overhead") == 0) {
+      utils::SetEnv("PTI_OVERHEAD", "subtract");
+      ++app_index;
+    } else if (strcmp(argv[i], "--overhead-budget") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Overhead budget is not specified" << std::endl;
+        return -1;
+      }
+      if (atof(argv[i]) <= 0 || atof(argv[i]) >= 100) {
+        std::cout << "[ERROR] Overhead budget is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ONETRACE_OverheadBudget", argv[i]);
+      if (utils::GetEnv("PTI_OVERHEAD").empty()) {
+        utils::SetEnv("PTI_OVERHEAD", "1");
+      }
+      app_index += 2;
     } else if (strcmp(argv[i], "--version") == 0) {
 #ifdef PTI_VERSION
       std::cout << TOSTRING(PTI_VERSION) << std::endl;
@@ -170,72 +657,275 @@ void SetToolEnv() {
 
 static TraceOptions ReadArgs() {
   std::string value;
-  uint32_t flags = 0;
+  uint64_t flags = 0;
   std::string log_file;
+  std::string include_api;
+  std::string exclude_api;
+  std::string kernel_sampling;
+  std::string module_dump_path;
+  std::string kernel_grouping;
+  std::string compression;
+  std::string telemetry_address;
+  uint32_t log_buffer_size = 0;
+  uint32_t ring_buffer_size = 0;
+  uint32_t ring_buffer_trigger = 0;
+  uint32_t poll_interval = 0;
+  uint32_t telemetry_port = 0;
+  uint32_t telemetry_interval = 0;
+  uint32_t stats_interval = 0;
+  double overhead_budget = 0.0;
 
   value = utils::GetEnv("ONETRACE_CallLogging");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CALL_LOGGING);
+    flags |= (1ull << TRACE_CALL_LOGGING);
   }
 
   value = utils::GetEnv("ONETRACE_HostTiming");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_HOST_TIMING);
+    flags |= (1ull << TRACE_HOST_TIMING);
   }
 
   value = utils::GetEnv("ONETRACE_DeviceTiming");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_DEVICE_TIMING);
+    flags |= (1ull << TRACE_DEVICE_TIMING);
   }
 
   value = utils::GetEnv("ONETRACE_DeviceTimingVerbose");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_DEVICE_TIMING_VERBOSE);
+    flags |= (1ull << TRACE_DEVICE_TIMING_VERBOSE);
+  }
+
+  value = utils::GetEnv("ONETRACE_QueueTiming");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_QUEUE_TIMING);
+  }
+
+  value = utils::GetEnv("ONETRACE_DependencyGraph");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_DEPENDENCY_GRAPH);
+  }
+
+  value = utils::GetEnv("ONETRACE_CallStacks");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_CALL_STACKS);
+  }
+
+  value = utils::GetEnv("ONETRACE_WaitAnalysis");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_WAIT_ANALYSIS);
+  }
+
+  value = utils::GetEnv("ONETRACE_TransferTiming");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_TRANSFER_TIMING);
+  }
+
+  value = utils::GetEnv("ONETRACE_TileTiming");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_TILE_TIMING);
+  }
+
+  value = utils::GetEnv("ONETRACE_MemoryTracking");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_MEMORY_TRACKING);
+  }
+
+  value = utils::GetEnv("ONETRACE_AllocChurn");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_ALLOC_CHURN);
+  }
+
+  value = utils::GetEnv("ONETRACE_Interval");
+  if (!value.empty()) {
+    flags |= (1ull << TRACE_INTERVAL_STATS);
+    stats_interval = std::stoul(value);
+  }
+
+  value = utils::GetEnv("ONETRACE_SaveTables");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_SAVE_TABLES);
+  }
+
+  value = utils::GetEnv("ONETRACE_CriticalPath");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_CRITICAL_PATH);
   }
 
   value = utils::GetEnv("ONETRACE_DeviceTimeline");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_DEVICE_TIMELINE);
+    flags |= (1ull << TRACE_DEVICE_TIMELINE);
   }
 
   value = utils::GetEnv("ONETRACE_LogToFile");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_LOG_TO_FILE);
+    flags |= (1ull << TRACE_LOG_TO_FILE);
     log_file = utils::GetEnv("ONETRACE_LogFilename");
     PTI_ASSERT(!log_file.empty());
   }
 
   value = utils::GetEnv("ONETRACE_ChromeCallLogging");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_CALL_LOGGING);
+    flags |= (1ull << TRACE_CHROME_CALL_LOGGING);
   }
 
   value = utils::GetEnv("ONETRACE_ChromeDeviceTimeline");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_DEVICE_TIMELINE);
+    flags |= (1ull << TRACE_CHROME_DEVICE_TIMELINE);
   }
 
   value = utils::GetEnv("ONETRACE_ChromeKernelTimeline");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_KERNEL_TIMELINE);
+    flags |= (1ull << TRACE_CHROME_KERNEL_TIMELINE);
   }
 
   value = utils::GetEnv("ONETRACE_ChromeDeviceStages");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_DEVICE_STAGES);
+    flags |= (1ull << TRACE_CHROME_DEVICE_STAGES);
   }
 
   value = utils::GetEnv("ONETRACE_Tid");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_TID);
+    flags |= (1ull << TRACE_TID);
   }
 
   value = utils::GetEnv("ONETRACE_Pid");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_PID);
+    flags |= (1ull << TRACE_PID);
+  }
+
+  value = utils::GetEnv("ONETRACE_AsyncLogging");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_ASYNC_LOGGING);
+  }
+
+  value = utils::GetEnv("ONETRACE_LogBufferSize");
+  if (!value.empty()) {
+    log_buffer_size = std::stoul(value);
+  }
+
+  value = utils::GetEnv("ONETRACE_Compression");
+  if (!value.empty()) {
+    compression = value;
+  }
+
+  value = utils::GetEnv("ONETRACE_OverheadBudget");
+  if (!value.empty()) {
+    flags |= (1ull << TRACE_OVERHEAD_BUDGET);
+    overhead_budget = std::stod(value);
   }
 
-  return TraceOptions(flags, log_file);
+  value = utils::GetEnv("ONETRACE_BinaryTrace");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_BINARY_TRACE);
+  }
+
+  value = utils::GetEnv("ONETRACE_NodeTrace");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_NODE_TRACE);
+  }
+
+  value = utils::GetEnv("ONETRACE_PerfettoTrace");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_PERFETTO_TRACE);
+  }
+
+  value = utils::GetEnv("ONETRACE_RingBuffer");
+  if (!value.empty()) {
+    flags |= (1ull << TRACE_RING_BUFFER);
+    ring_buffer_size = std::stoul(value);
+  }
+
+  value = utils::GetEnv("ONETRACE_RingBufferTrigger");
+  if (!value.empty()) {
+    ring_buffer_trigger = std::stoul(value);
+  }
+
+  value = utils::GetEnv("ONETRACE_PollInterval");
+  if (!value.empty()) {
+    poll_interval = std::stoul(value);
+  }
+
+  value = utils::GetEnv("ONETRACE_BatchTimestamps");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_BATCH_TIMESTAMPS);
+  }
+
+  value = utils::GetEnv("ONETRACE_IncludeApi");
+  if (!value.empty()) {
+    include_api = value;
+  }
+
+  value = utils::GetEnv("ONETRACE_ExcludeApi");
+  if (!value.empty()) {
+    exclude_api = value;
+  }
+
+  value = utils::GetEnv("ONETRACE_KernelSampling");
+  if (!value.empty()) {
+    kernel_sampling = value;
+  }
+
+  value = utils::GetEnv("ONETRACE_ModuleDump");
+  if (!value.empty()) {
+    flags |= (1ull << TRACE_MODULE_DUMP);
+    module_dump_path = value;
+  }
+
+  value = utils::GetEnv("ONETRACE_KernelGrouping");
+  if (!value.empty()) {
+    kernel_grouping = value;
+  }
+
+  value = utils::GetEnv("ONETRACE_Itt");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_ITT);
+  }
+
+  value = utils::GetEnv("ONETRACE_CollectorApi");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_COLLECTOR_API);
+  }
+
+  value = utils::GetEnv("ONETRACE_OmpDevice");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_OMP_DEVICE);
+  }
+
+  value = utils::GetEnv("ONETRACE_Sycl");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_SYCL);
+  }
+
+  value = utils::GetEnv("ONETRACE_SysmanCounters");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_SYSMAN_COUNTERS);
+  }
+
+  value = utils::GetEnv("ONETRACE_KernelEnergy");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_KERNEL_ENERGY);
+  }
+
+  value = utils::GetEnv("ONETRACE_Telemetry");
+  if (!value.empty()) {
+    flags |= (1ull << TRACE_TELEMETRY);
+    telemetry_port = std::stoul(value);
+  }
+
+  value = utils::GetEnv("ONETRACE_TelemetryInterval");
+  if (!value.empty()) {
+    telemetry_interval = std::stoul(value);
+  }
+
+  telemetry_address = utils::GetEnv("ONETRACE_TelemetryAddress");
+
+  return TraceOptions(
+      flags, log_file, log_buffer_size,
+      ring_buffer_size, ring_buffer_trigger, poll_interval,
+      include_api, exclude_api, kernel_sampling,
+      CaptureOptions::Read("ONETRACE_"),
+      telemetry_port, telemetry_interval, stats_interval, kernel_grouping,
+      compression, overhead_budget, module_dump_path, telemetry_address);
 }
 
 void EnableProfiling() {
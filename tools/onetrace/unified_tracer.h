@@ -9,24 +9,56 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <vector>
 
+#include "binary_trace.h"
+#include "capture_control.h"
 #include "cl_ext_collector.h"
 #include "cl_ext_callbacks.h"
 #include "cl_api_collector.h"
 #include "cl_api_callbacks.h"
 #include "cl_kernel_collector.h"
+#include "collector_api.h"
+#include "critical_path.h"
+#include "energy_sampler.h"
+#include "flight_recorder.h"
+#include "interval_statistics.h"
+#include "itt_collector.h"
+#include "kernel_energy.h"
+#include "omp_device_collector.h"
+#include "overhead.h"
+#include "overhead_governor.h"
+#include "perfetto_trace.h"
+#include "sycl_collector.h"
+#include "sysman_sampler.h"
+#include "table_store.h"
+#include "telemetry_server.h"
+#include "thread_identity.h"
+#include "trace_buffer.h"
 #include "trace_options.h"
+#include "trace_sink.h"
 #include "utils.h"
 #include "ze_api_collector.h"
 #include "ze_kernel_collector.h"
+#include "ze_module_collector.h"
 
 const char* kChromeTraceFileName = "onetrace";
 
+struct KernelFrequency {
+  uint64_t call_count;
+  double total;
+  double min;
+  double max;
+};
+
 class UnifiedTracer {
  public:
   static UnifiedTracer* Create(const TraceOptions& options) {
@@ -40,12 +72,140 @@ class UnifiedTracer {
     UnifiedTracer* tracer = new UnifiedTracer(options);
     PTI_ASSERT(tracer != nullptr);
 
+    CaptureOptions capture_options = options.GetCaptureOptions();
+    capture_options.external = tracer->CheckOption(TRACE_ITT) ||
+      tracer->CheckOption(TRACE_COLLECTOR_API);
+    capture_options.paused = tracer->CheckOption(TRACE_COLLECTOR_API);
+    tracer->capture_ = CaptureControl::Create(capture_options);
+
+    // Ranges of the collector API are ITT tasks
+    if (tracer->CheckOption(TRACE_ITT) ||
+        tracer->CheckOption(TRACE_COLLECTOR_API)) {
+      OnIttTaskFinishCallback callback = nullptr;
+      if (tracer->chrome_logger_ != nullptr ||
+          tracer->binary_writer_ != nullptr ||
+          tracer->perfetto_writer_ != nullptr) {
+        callback = IttTaskCallback;
+      }
+      tracer->itt_collector_ = IttCollector::Create(
+          &tracer->correlator_, tracer->capture_, callback, tracer);
+      if (tracer->itt_collector_ == nullptr) {
+        delete tracer;
+        return nullptr;
+      }
+    }
+
+    if (tracer->CheckOption(TRACE_COLLECTOR_API)) {
+      tracer->collector_api_ = CollectorApi::Create(
+          tracer->capture_, OnCollectorFlush, tracer);
+    }
+
+    if (tracer->CheckOption(TRACE_OMP_DEVICE)) {
+      OnOmpDeviceRecordCallback callback = nullptr;
+      if (tracer->CheckOption(TRACE_DEVICE_TIMELINE)) {
+        callback = OmpDeviceTimelineCallback;
+      }
+      tracer->omp_device_collector_ = OmpDeviceCollector::Create(
+          &tracer->correlator_, callback, tracer);
+      if (tracer->omp_device_collector_ == nullptr) {
+        delete tracer;
+        return nullptr;
+      }
+    }
+
+    if (tracer->CheckOption(TRACE_SYCL)) {
+      OnSyclTaskFinishCallback callback = nullptr;
+      if (tracer->chrome_logger_ != nullptr ||
+          tracer->binary_writer_ != nullptr ||
+          tracer->perfetto_writer_ != nullptr) {
+        callback = IttTaskCallback;
+      }
+      tracer->sycl_collector_ = SyclCollector::Create(
+          &tracer->correlator_, callback, tracer);
+      if (tracer->sycl_collector_ == nullptr) {
+        delete tracer;
+        return nullptr;
+      }
+    }
+
+    if (tracer->CheckOption(TRACE_CRITICAL_PATH)) {
+      tracer->critical_path_ = new CriticalPathAnalyzer;
+      PTI_ASSERT(tracer->critical_path_ != nullptr);
+    }
+
+    if (tracer->CheckOption(TRACE_SYSMAN_COUNTERS)) {
+      tracer->sysman_sampler_ = SysmanSampler::Create(
+          GetSysmanTimestamp, &tracer->correlator_);
+    }
+
+    if (tracer->CheckOption(TRACE_KERNEL_ENERGY)) {
+      tracer->energy_sampler_ = EnergySampler::Create(
+          GetSysmanTimestamp, &tracer->correlator_);
+      if (tracer->energy_sampler_ != nullptr) {
+        tracer->kernel_energy_ = new KernelEnergy;
+        PTI_ASSERT(tracer->kernel_energy_ != nullptr);
+      }
+    }
+
+    if (tracer->CheckOption(TRACE_TELEMETRY)) {
+      tracer->telemetry_ = TelemetryServer::Create(
+          kChromeTraceFileName, tracer->options_.GetTelemetryPort(),
+          tracer->options_.GetTelemetryInterval(),
+          tracer->options_.GetTelemetryAddress());
+      if (tracer->telemetry_ != nullptr) {
+        std::cerr << "[INFO] Telemetry is served on port " <<
+          tracer->telemetry_->GetPort() << std::endl;
+      }
+    }
+
+    if (tracer->CheckOption(TRACE_INTERVAL_STATS)) {
+      tracer->interval_file_name_ =
+        TraceOptions::GetIntervalsFileName(kChromeTraceFileName);
+      tracer->interval_statistics_ = IntervalStatistics::Create(
+          tracer->interval_file_name_, options.GetStatsInterval());
+    }
+
+    // One analysis takes the waits and commands of both backends
+    if (tracer->CheckOption(TRACE_WAIT_ANALYSIS)) {
+      tracer->wait_analysis_ = new WaitAnalysis;
+      PTI_ASSERT(tracer->wait_analysis_ != nullptr);
+    }
+
+    if (tracer->CheckOption(TRACE_MODULE_DUMP)) {
+      tracer->ze_module_collector_ = ZeModuleCollector::Create(
+          tracer->options_.GetModuleDumpPath());
+      if (tracer->ze_module_collector_ == nullptr) {
+        std::cerr <<
+          "[WARNING] Unable to create module collector for L0 backend" <<
+          std::endl;
+      }
+    }
+
+    tracer->CreateSinks(&tracer->ze_pipeline_, "append", "Appended");
+    tracer->CreateSinks(&tracer->cl_pipeline_, "queued", "Queued");
+
     if (tracer->CheckOption(TRACE_DEVICE_TIMING) ||
         tracer->CheckOption(TRACE_DEVICE_TIMING_VERBOSE) ||
+        tracer->CheckOption(TRACE_QUEUE_TIMING) ||
+        tracer->CheckOption(TRACE_DEPENDENCY_GRAPH) ||
+        tracer->CheckOption(TRACE_CALL_STACKS) ||
+        tracer->CheckOption(TRACE_TRANSFER_TIMING) ||
+        tracer->CheckOption(TRACE_TILE_TIMING) ||
+        tracer->CheckOption(TRACE_MEMORY_TRACKING) ||
+        tracer->CheckOption(TRACE_CRITICAL_PATH) ||
         tracer->CheckOption(TRACE_DEVICE_TIMELINE) ||
         tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE) ||
         tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE) ||
-        tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
+        tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES) ||
+        tracer->CheckOption(TRACE_BINARY_TRACE) ||
+        tracer->CheckOption(TRACE_PERFETTO_TRACE) ||
+        tracer->CheckOption(TRACE_RING_BUFFER) ||
+        tracer->CheckOption(TRACE_TELEMETRY) ||
+        tracer->CheckOption(TRACE_INTERVAL_STATS) ||
+        tracer->CheckOption(TRACE_WAIT_ANALYSIS) ||
+        tracer->CheckOption(TRACE_KERNEL_ENERGY) ||
+        tracer->CheckOption(TRACE_COLLECTOR_API) ||
+        tracer->CheckOption(TRACE_SYCL)) {
 
       PTI_ASSERT(!(tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE) &&
                    tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)));
@@ -57,46 +217,31 @@ class UnifiedTracer {
       ClKernelCollector* cl_gpu_kernel_collector = nullptr;
 
       OnZeKernelFinishCallback ze_callback = nullptr;
+      if (tracer->ze_pipeline_.HasDeviceSinks()) {
+        ze_callback = OnZeKernelFinish;
+      }
       OnClKernelFinishCallback cl_callback = nullptr;
-      if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-          tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE) &&
-          tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        ze_callback = ZeDeviceAndChromeKernelStagesCallback;
-        cl_callback = ClDeviceAndChromeKernelStagesCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE)) {
-        ze_callback = ZeDeviceAndChromeDeviceCallback;
-        cl_callback = ClDeviceAndChromeDeviceCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE)) {
-        ze_callback = ZeDeviceAndChromeKernelCallback;
-        cl_callback = ClDeviceAndChromeKernelCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        ze_callback = ZeDeviceAndChromeStagesCallback;
-        cl_callback = ClDeviceAndChromeStagesCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        ze_callback = ZeChromeKernelStagesCallback;
-        cl_callback = ClChromeKernelStagesCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE)) {
-        ze_callback = ZeDeviceTimelineCallback;
-        cl_callback = ClDeviceTimelineCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE)) {
-        ze_callback = ZeChromeDeviceCallback;
-        cl_callback = ClChromeDeviceCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE)) {
-        ze_callback = ZeChromeKernelCallback;
-        cl_callback = ClChromeKernelCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        ze_callback = ZeChromeStagesCallback;
-        cl_callback = ClChromeStagesCallback;
-      }
-
-      bool verbose = tracer->CheckOption(TRACE_DEVICE_TIMING_VERBOSE);
+      if (tracer->cl_pipeline_.HasDeviceSinks()) {
+        cl_callback = OnClKernelFinish;
+      }
+
+      KernelGrouping grouping = KERNEL_GROUPING_NAME;
+      bool parsed = KernelStatistics::ParseGrouping(
+          tracer->options_.GetKernelGrouping(), &grouping);
+      PTI_ASSERT(parsed);
 
       ze_kernel_collector = ZeKernelCollector::Create(
-          &tracer->correlator_, verbose, ze_callback, tracer);
+          &tracer->correlator_, grouping, ze_callback, tracer,
+          tracer->options_.GetPollInterval(),
+          tracer->CheckOption(TRACE_BATCH_TIMESTAMPS),
+          tracer->options_.GetKernelSampling(), tracer->capture_,
+          tracer->CheckOption(TRACE_QUEUE_TIMING),
+          tracer->CheckOption(TRACE_TRANSFER_TIMING),
+          tracer->CheckOption(TRACE_MEMORY_TRACKING),
+          OnMemoryUsage, false,
+          tracer->CheckOption(TRACE_TILE_TIMING),
+          tracer->CheckOption(TRACE_DEPENDENCY_GRAPH),
+          tracer->CheckOption(TRACE_CALL_STACKS));
       if (ze_kernel_collector == nullptr) {
         std::cerr <<
           "[WARNING] Unable to create kernel collector for L0 backend" <<
@@ -106,7 +251,11 @@ class UnifiedTracer {
 
       if (cl_cpu_device != nullptr) {
         cl_cpu_kernel_collector = ClKernelCollector::Create(
-            cl_cpu_device, &tracer->correlator_, verbose, cl_callback, tracer);
+            cl_cpu_device, &tracer->correlator_, grouping, cl_callback, tracer,
+            tracer->options_.GetKernelSampling(), tracer->capture_,
+            tracer->CheckOption(TRACE_QUEUE_TIMING), false,
+            tracer->CheckOption(TRACE_DEPENDENCY_GRAPH),
+            tracer->CheckOption(TRACE_CALL_STACKS));
         if (cl_cpu_kernel_collector == nullptr) {
           std::cerr <<
             "[WARNING] Unable to create kernel collector for CL CPU backend" <<
@@ -117,7 +266,11 @@ class UnifiedTracer {
 
       if (cl_gpu_device != nullptr) {
         cl_gpu_kernel_collector = ClKernelCollector::Create(
-            cl_gpu_device, &tracer->correlator_, verbose, cl_callback, tracer);
+            cl_gpu_device, &tracer->correlator_, grouping, cl_callback, tracer,
+            tracer->options_.GetKernelSampling(), tracer->capture_,
+            tracer->CheckOption(TRACE_QUEUE_TIMING), false,
+            tracer->CheckOption(TRACE_DEPENDENCY_GRAPH),
+            tracer->CheckOption(TRACE_CALL_STACKS));
         if (cl_gpu_kernel_collector == nullptr) {
           std::cerr <<
             "[WARNING] Unable to create kernel collector for CL GPU backend" <<
@@ -134,28 +287,32 @@ class UnifiedTracer {
       }
     }
 
-    if (tracer->CheckOption(TRACE_CALL_LOGGING) ||
-        tracer->CheckOption(TRACE_CHROME_CALL_LOGGING) ||
-        tracer->CheckOption(TRACE_HOST_TIMING)) {
+    if (tracer->NeedsFullApi() || tracer->GetApiSubsets() != 0) {
 
       ZeApiCollector* ze_api_collector = nullptr;
       ClApiCollector* cl_cpu_api_collector = nullptr;
       ClApiCollector* cl_gpu_api_collector = nullptr;
 
       OnZeFunctionFinishCallback ze_callback = nullptr;
+      if (tracer->ze_pipeline_.HasHostSinks()) {
+        ze_callback = OnZeFunctionFinish;
+      }
       OnClFunctionFinishCallback cl_callback = nullptr;
-      if (tracer->CheckOption(TRACE_CHROME_CALL_LOGGING)) {
-        ze_callback = ZeChromeLoggingCallback;
-        cl_callback = ClChromeLoggingCallback;
+      if (tracer->cl_pipeline_.HasHostSinks()) {
+        cl_callback = OnClFunctionFinish;
       }
 
       ApiCollectorOptions options{false, false, false};
       options.call_tracing = tracer->CheckOption(TRACE_CALL_LOGGING);
       options.need_tid = tracer->CheckOption(TRACE_TID);
       options.need_pid = tracer->CheckOption(TRACE_PID);
+      options.include_api = tracer->options_.GetIncludeApi();
+      options.exclude_api = tracer->options_.GetExcludeApi();
+      options.api_subsets = tracer->GetApiSubsets();
 
       ze_api_collector = ZeApiCollector::Create(
-          &tracer->correlator_, options, ze_callback, tracer);
+          &tracer->correlator_, options, ze_callback, tracer,
+          tracer->CheckOption(TRACE_ALLOC_CHURN));
       if (ze_api_collector == nullptr) {
         std::cerr << "[WARNING] Unable to create L0 API collector" <<
           std::endl;
@@ -196,12 +353,46 @@ class UnifiedTracer {
       ClExtCollector::Create(cl_cpu_api_collector, cl_gpu_api_collector);
     }
 
+    if (tracer->CheckOption(TRACE_OVERHEAD_BUDGET)) {
+      // All the launches are counted from the start to keep the scale
+      // of the throttled kernels right
+      tracer->SetKernelThrottle(1);
+      tracer->overhead_governor_ = OverheadGovernor::Create(
+          tracer->options_.GetOverheadBudget(),
+          GetOverheadLevelList().size() - 1, OnOverheadLevel, tracer);
+    }
+
+    if (tracer->capture_ != nullptr) {
+      tracer->capture_->Start(OnCaptureChange, tracer);
+    }
+
     return tracer;
   }
 
   ~UnifiedTracer() {
     total_execution_time_ = correlator_.GetTimestamp();
 
+    if (overhead_governor_ != nullptr) {
+      delete overhead_governor_;
+      overhead_governor_ = nullptr;
+    }
+
+    if (collector_api_ != nullptr) {
+      collector_api_->DisableTracing();
+    }
+    if (itt_collector_ != nullptr) {
+      itt_collector_->DisableTracing();
+    }
+    if (omp_device_collector_ != nullptr) {
+      omp_device_collector_->DisableTracing();
+    }
+    if (sycl_collector_ != nullptr) {
+      sycl_collector_->DisableTracing();
+    }
+    if (capture_ != nullptr) {
+      delete capture_;
+    }
+
     if (cl_cpu_api_collector_ != nullptr) {
       cl_cpu_api_collector_->DisableTracing();
     }
@@ -211,6 +402,9 @@ class UnifiedTracer {
     if (ze_api_collector_ != nullptr) {
       ze_api_collector_->DisableTracing();
     }
+    if (ze_module_collector_ != nullptr) {
+      ze_module_collector_->DisableTracing();
+    }
 
     if (cl_cpu_kernel_collector_ != nullptr) {
       cl_cpu_kernel_collector_->DisableTracing();
@@ -219,8 +413,35 @@ class UnifiedTracer {
       cl_gpu_kernel_collector_->DisableTracing();
     }
 
+    if (sysman_sampler_ != nullptr) {
+      sysman_sampler_->Stop();
+    }
+    if (energy_sampler_ != nullptr) {
+      energy_sampler_->Stop();
+    }
+
     Report();
+    if (sysman_sampler_ != nullptr) {
+      WriteSysmanCounters();
+      delete sysman_sampler_;
+      sysman_sampler_ = nullptr;
+    }
 
+    if (itt_collector_ != nullptr) {
+      delete itt_collector_;
+    }
+    if (collector_api_ != nullptr) {
+      delete collector_api_;
+    }
+    if (omp_device_collector_ != nullptr) {
+      delete omp_device_collector_;
+    }
+    if (sycl_collector_ != nullptr) {
+      delete sycl_collector_;
+    }
+    if (critical_path_ != nullptr) {
+      delete critical_path_;
+    }
     if (cl_cpu_api_collector_ != nullptr) {
       delete cl_cpu_api_collector_;
     }
@@ -230,6 +451,9 @@ class UnifiedTracer {
     if (ze_api_collector_ != nullptr) {
       delete ze_api_collector_;
     }
+    if (ze_module_collector_ != nullptr) {
+      delete ze_module_collector_;
+    }
 
     if (cl_cpu_kernel_collector_ != nullptr) {
       delete cl_cpu_kernel_collector_;
@@ -240,9 +464,27 @@ class UnifiedTracer {
 
     ClExtCollector::Destroy();
 
+    if (telemetry_ != nullptr) {
+      delete telemetry_;
+    }
+    if (wait_analysis_ != nullptr) {
+      delete wait_analysis_;
+    }
+    if (kernel_energy_ != nullptr) {
+      delete kernel_energy_;
+    }
+    if (energy_sampler_ != nullptr) {
+      delete energy_sampler_;
+    }
+    if (interval_statistics_ != nullptr) {
+      delete interval_statistics_;
+      std::cerr << "[INFO] Interval statistics were stored to " <<
+        interval_file_name_ << std::endl;
+    }
+
     if (CheckOption(TRACE_LOG_TO_FILE)) {
       std::cerr << "[INFO] Log was stored to " <<
-        options_.GetLogFileName() << std::endl;
+        correlator_.GetLogFileName() << std::endl;
     }
 
     if (chrome_logger_ != nullptr) {
@@ -250,38 +492,292 @@ class UnifiedTracer {
       std::cerr << "[INFO] Timeline was stored to " <<
         chrome_trace_file_name_ << std::endl;
     }
+
+    if (binary_writer_ != nullptr) {
+      delete binary_writer_;
+      std::cerr << "[INFO] Binary trace was stored to " <<
+        binary_trace_file_name_ << std::endl;
+    }
+
+    if (perfetto_writer_ != nullptr) {
+      delete perfetto_writer_;
+      std::cerr << "[INFO] Perfetto trace was stored to " <<
+        perfetto_trace_file_name_ << std::endl;
+    }
+
+    if (flight_recorder_ != nullptr) {
+      delete flight_recorder_;
+    }
   }
 
   bool CheckOption(uint32_t option) {
     return options_.CheckFlag(option);
   }
 
+  // Modes that trace every API call, the others get callbacks for the
+  // subsets they need only
+  bool NeedsFullApi() {
+    return CheckOption(TRACE_CALL_LOGGING) ||
+           CheckOption(TRACE_CHROME_CALL_LOGGING) ||
+           CheckOption(TRACE_HOST_TIMING) ||
+           CheckOption(TRACE_CRITICAL_PATH) ||
+           CheckOption(TRACE_BINARY_TRACE) ||
+           CheckOption(TRACE_PERFETTO_TRACE) ||
+           CheckOption(TRACE_RING_BUFFER) ||
+           CheckOption(TRACE_TELEMETRY) ||
+           CheckOption(TRACE_INTERVAL_STATS) ||
+           CheckOption(TRACE_COLLECTOR_API) ||
+           CheckOption(TRACE_SYCL);
+  }
+
+  // Zero if any of the enabled modes needs the whole API
+  uint32_t GetApiSubsets() {
+    if (NeedsFullApi()) {
+      return 0;
+    }
+
+    uint32_t subsets = 0;
+    if (CheckOption(TRACE_ALLOC_CHURN)) {
+      subsets |= API_SUBSET_ALLOC;
+    }
+    if (CheckOption(TRACE_WAIT_ANALYSIS)) {
+      subsets |= API_SUBSET_WAIT;
+    }
+    return subsets;
+  }
+
   UnifiedTracer(const UnifiedTracer& copy) = delete;
   UnifiedTracer& operator=(const UnifiedTracer& copy) = delete;
 
  private:
   UnifiedTracer(const TraceOptions& options)
-      : options_(options), correlator_(options.GetLogFileName()) {
+      : options_(options),
+        correlator_(
+            options.GetLogFileName(),
+            options.CheckFlag(TRACE_ASYNC_LOGGING),
+            options.GetLogBufferSize(),
+            options.GetCompression()) {
     if (CheckOption(TRACE_CHROME_CALL_LOGGING) ||
         CheckOption(TRACE_CHROME_DEVICE_TIMELINE) ||
         CheckOption(TRACE_CHROME_KERNEL_TIMELINE) ||
         CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
       chrome_trace_file_name_ =
         TraceOptions::GetChromeTraceFileName(kChromeTraceFileName);
-      chrome_logger_ = new Logger(chrome_trace_file_name_.c_str());
+      chrome_logger_ = new Logger(
+          chrome_trace_file_name_.c_str(),
+          CheckOption(TRACE_ASYNC_LOGGING),
+          options_.GetLogBufferSize(),
+          options_.GetCompression());
       PTI_ASSERT(chrome_logger_ != nullptr);
+      chrome_trace_file_name_ = chrome_logger_->GetFileName();
 
       std::stringstream stream;
       stream << "[" << std::endl;
       stream << "{\"ph\":\"M\", \"name\":\"process_name\", \"pid\":\"" <<
-        utils::GetPid() << "\", \"tid\":0, \"args\":{\"name\":\"" <<
+        ThreadIdentity::GetPid() << "\", \"tid\":0, \"args\":{\"name\":\"" <<
         utils::GetExecutableName() << "\"}}," << std::endl;
       stream << "{\"ph\":\"M\", \"name\":\"onetrace_start_time\", \"pid\":\"" <<
-        utils::GetPid() << "\", \"tid\":0, \"args\":{\"start_time\":\"" <<
+        ThreadIdentity::GetPid() <<
+        "\", \"tid\":0, \"args\":{\"start_time\":\"" <<
         correlator_.GetStartPoint() << "\"}}," << std::endl;
 
       chrome_logger_->Log(stream.str());
     }
+
+    if (CheckOption(TRACE_BINARY_TRACE)) {
+      ShmTraceRing* ring = nullptr;
+      if (CheckOption(TRACE_NODE_TRACE)) {
+        ring = ShmTraceRing::Create(
+            ThreadIdentity::GetPid(), SHM_TRACE_RING_SIZE);
+      }
+
+      if (ring != nullptr) {
+        binary_trace_file_name_ =
+          "node trace daemon (" + ring->GetName() + ")";
+        binary_writer_ = new BinaryTraceWriter(
+            ring, ThreadIdentity::GetPid(),
+            correlator_.GetStartPoint(), correlator_.GetEpochPoint(),
+            utils::GetExecutableName());
+      } else {
+        binary_trace_file_name_ =
+          TraceOptions::GetBinaryTraceFileName(kChromeTraceFileName);
+        binary_writer_ = new BinaryTraceWriter(
+            binary_trace_file_name_, ThreadIdentity::GetPid(),
+            correlator_.GetStartPoint(), correlator_.GetEpochPoint(),
+            utils::GetExecutableName());
+      }
+      PTI_ASSERT(binary_writer_ != nullptr);
+    }
+
+    if (CheckOption(TRACE_PERFETTO_TRACE)) {
+      perfetto_trace_file_name_ =
+        TraceOptions::GetPerfettoTraceFileName(kChromeTraceFileName);
+      perfetto_writer_ = new PerfettoTraceWriter(
+          perfetto_trace_file_name_, ThreadIdentity::GetPid(),
+          utils::GetExecutableName());
+      PTI_ASSERT(perfetto_writer_ != nullptr);
+    }
+
+    if (CheckOption(TRACE_RING_BUFFER)) {
+      flight_recorder_ = new FlightRecorder(
+          options_.GetRingBufferSize(),
+          std::string(kChromeTraceFileName) + "_ring", ThreadIdentity::GetPid(),
+          correlator_.GetStartPoint(), correlator_.GetEpochPoint(),
+          utils::GetExecutableName());
+      PTI_ASSERT(flight_recorder_ != nullptr);
+#if !defined(_WIN32)
+      FlightRecorder::EnableSignal(SIGUSR1);
+#endif
+    }
+  }
+
+  static uint64_t GetSysmanTimestamp(void* data) {
+    Correlator* correlator = reinterpret_cast<Correlator*>(data);
+    PTI_ASSERT(correlator != nullptr);
+    return correlator->GetTimestamp();
+  }
+
+  // Device of the kernel queue is not known here, so the frequency of the
+  // first GPU is taken
+  void AddKernelFrequency(
+      const std::string& name, uint64_t started, uint64_t ended) {
+    PTI_ASSERT(sysman_sampler_ != nullptr);
+    double frequency = sysman_sampler_->GetAverage(
+        0, &SysmanCounterSample::frequency, started, ended);
+    if (frequency < 0) {
+      return;
+    }
+
+    const std::lock_guard<std::mutex> lock(kernel_frequency_lock_);
+    auto it = kernel_frequency_map_.find(name);
+    if (it == kernel_frequency_map_.end()) {
+      kernel_frequency_map_[name] = {1, frequency, frequency, frequency};
+    } else {
+      KernelFrequency& value = it->second;
+      ++value.call_count;
+      value.total += frequency;
+      value.min = std::min(value.min, frequency);
+      value.max = std::max(value.max, frequency);
+    }
+  }
+
+  void ReportKernelFrequency() {
+    const size_t kFrequencyLength = 20;
+    const size_t kCallsLength = 12;
+
+    size_t max_name_length = std::string("Kernel").size();
+    for (auto& value : kernel_frequency_map_) {
+      max_name_length = std::max(max_name_length, value.first.size());
+    }
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Kernel Frequency Results (GPU 0): ===" << std::endl;
+    stream << std::endl;
+    stream << std::setw(max_name_length) << "Kernel" << "," <<
+      std::setw(kCallsLength) << "Calls" << "," <<
+      std::setw(kFrequencyLength) << "Average (MHz)" << "," <<
+      std::setw(kFrequencyLength) << "Min (MHz)" << "," <<
+      std::setw(kFrequencyLength) << "Max (MHz)" << std::endl;
+
+    stream << std::fixed << std::setprecision(1);
+    for (auto& value : kernel_frequency_map_) {
+      const KernelFrequency& frequency = value.second;
+      stream << std::setw(max_name_length) << value.first << "," <<
+        std::setw(kCallsLength) << frequency.call_count << "," <<
+        std::setw(kFrequencyLength) <<
+        frequency.total / frequency.call_count << "," <<
+        std::setw(kFrequencyLength) << frequency.min << "," <<
+        std::setw(kFrequencyLength) << frequency.max << std::endl;
+    }
+
+    correlator_.Log(stream.str());
+    correlator_.Log("\n");
+  }
+
+  void ReportKernelEnergy() {
+    PTI_ASSERT(energy_sampler_ != nullptr);
+    PTI_ASSERT(kernel_energy_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Kernel Energy Results (GPU 0): ===" << std::endl;
+    stream << std::endl;
+    kernel_energy_->PrintTable(*energy_sampler_, stream);
+    correlator_.Log(stream.str());
+    correlator_.Log("\n");
+  }
+
+  // Samples are kept by the sampler until the end, so they are written
+  // as counter tracks at once
+  void WriteSysmanCounters() {
+    PTI_ASSERT(sysman_sampler_ != nullptr);
+    if (chrome_logger_ == nullptr && binary_writer_ == nullptr) {
+      return;
+    }
+
+    const std::vector<std::pair<const char*, double SysmanCounterSample::*> >
+      counter_list = {
+        {"Frequency (MHz)", &SysmanCounterSample::frequency},
+        {"Power (W)", &SysmanCounterSample::power},
+        {"Temperature (C)", &SysmanCounterSample::temperature}};
+
+    for (uint32_t i = 0; i < sysman_sampler_->GetDeviceCount(); ++i) {
+      for (auto& sample : sysman_sampler_->GetCounterList(i)) {
+        for (auto& counter : counter_list) {
+          WriteSysmanCounter(i, counter.first, sample.timestamp,
+                             sample.*(counter.second));
+        }
+        if (sample.frequency >= 0) {
+          WriteSysmanCounter(i, "Throttle Reasons", sample.timestamp,
+                             sample.throttle_reasons);
+        }
+      }
+    }
+  }
+
+  void WriteSysmanCounter(
+      uint32_t device_id, const char* name, uint64_t timestamp,
+      double value) {
+    if (value < 0) {
+      return;
+    }
+
+    if (chrome_logger_ != nullptr) {
+      std::stringstream stream;
+      stream << "{\"ph\":\"C\", \"pid\":\"" << ThreadIdentity::GetPid() <<
+        "\", \"name\":\"GPU " << device_id << " " << name <<
+        "\", \"ts\": " << timestamp / NSEC_IN_USEC <<
+        ", \"args\": {\"value\": " << value << "}},\n";
+      chrome_logger_->Log(stream.str());
+    }
+
+    if (binary_writer_ != nullptr) {
+      binary_writer_->WriteCounterRecord(device_id, name, timestamp, value);
+    }
+  }
+
+  // Footprint counter track of the device (or host) pool, called on each
+  // allocation and free from the application thread
+  static void OnMemoryUsage(
+      void* data, uint32_t pool, uint64_t timestamp, uint64_t bytes) {
+    UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
+    PTI_ASSERT(tracer != nullptr);
+    double value = static_cast<double>(bytes) / BYTES_IN_MBYTES;
+
+    if (tracer->chrome_logger_ != nullptr) {
+      std::stringstream stream;
+      stream << "{\"ph\":\"C\", \"pid\":\"" << ThreadIdentity::GetPid() <<
+        "\", \"name\":\"" << MemoryTracker::GetPoolName(pool) <<
+        " Memory (MB)\", \"ts\": " << timestamp / NSEC_IN_USEC <<
+        ", \"args\": {\"value\": " << value << "}},\n";
+      tracer->chrome_logger_->Log(stream.str());
+    }
+
+    if (tracer->binary_writer_ != nullptr) {
+      tracer->binary_writer_->WriteCounterRecord(
+          pool, "Memory (MB)", timestamp, value);
+    }
   }
 
   static uint64_t CalculateTotalTime(const ZeApiCollector* collector) {
@@ -475,6 +971,184 @@ class UnifiedTracer {
     correlator_.Log("\n");
   }
 
+  template <class Collector>
+  void PrintQueueTable(const Collector* collector, const char* device_type) {
+    PTI_ASSERT(collector != nullptr);
+    PTI_ASSERT(device_type != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "== " << device_type << " Backend: ==" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+    collector->PrintQueuesTable();
+  }
+
+  void ReportQueueTiming() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Queue Timing Results: ===" << std::endl;
+    correlator_.Log(stream.str());
+
+    if (ze_kernel_collector_ != nullptr) {
+      PrintQueueTable(ze_kernel_collector_, "L0");
+    }
+    if (cl_cpu_kernel_collector_ != nullptr) {
+      PrintQueueTable(cl_cpu_kernel_collector_, "CL CPU");
+    }
+    if (cl_gpu_kernel_collector_ != nullptr) {
+      PrintQueueTable(cl_gpu_kernel_collector_, "CL GPU");
+    }
+
+    correlator_.Log("\n");
+  }
+
+  template <class Collector>
+  void PrintDependencyTable(Collector* collector, const char* device_type) {
+    PTI_ASSERT(collector != nullptr);
+    PTI_ASSERT(device_type != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "== " << device_type << " Backend: ==" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+    collector->PrintDependencyTable();
+  }
+
+  template <class Collector>
+  void PrintStacksTable(Collector* collector, const char* device_type) {
+    PTI_ASSERT(collector != nullptr);
+    PTI_ASSERT(device_type != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "== " << device_type << " Backend: ==" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+    collector->PrintStacksTable();
+  }
+
+  void ReportCallStacks() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Call Stack Results: ===" << std::endl;
+    correlator_.Log(stream.str());
+
+    if (ze_kernel_collector_ != nullptr) {
+      PrintStacksTable(ze_kernel_collector_, "L0");
+    }
+    if (cl_cpu_kernel_collector_ != nullptr) {
+      PrintStacksTable(cl_cpu_kernel_collector_, "CL CPU");
+    }
+    if (cl_gpu_kernel_collector_ != nullptr) {
+      PrintStacksTable(cl_gpu_kernel_collector_, "CL GPU");
+    }
+
+    correlator_.Log("\n");
+  }
+
+  void ReportDependencyGraph() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Dependency Graph Results: ===" << std::endl;
+    correlator_.Log(stream.str());
+
+    if (ze_kernel_collector_ != nullptr) {
+      PrintDependencyTable(ze_kernel_collector_, "L0");
+    }
+    if (cl_cpu_kernel_collector_ != nullptr) {
+      PrintDependencyTable(cl_cpu_kernel_collector_, "CL CPU");
+    }
+    if (cl_gpu_kernel_collector_ != nullptr) {
+      PrintDependencyTable(cl_gpu_kernel_collector_, "CL GPU");
+    }
+
+    correlator_.Log("\n");
+  }
+
+  // Memory types are known for Level Zero backend only
+  void ReportTransferTiming() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Transfer Timing Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    if (ze_kernel_collector_ != nullptr) {
+      ze_kernel_collector_->PrintTransfersTable();
+    }
+
+    correlator_.Log("\n");
+  }
+
+  // Tiles are known for Level Zero backend only
+  void ReportTileTiming() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Tile Timing Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    if (ze_kernel_collector_ != nullptr) {
+      ze_kernel_collector_->PrintTilesTable();
+    }
+
+    correlator_.Log("\n");
+  }
+
+  // Allocations are tracked for Level Zero backend only
+  void ReportMemoryTracking() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Memory Tracking Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    if (ze_kernel_collector_ != nullptr) {
+      ze_kernel_collector_->PrintMemoryTable();
+    }
+
+    correlator_.Log("\n");
+  }
+
+  // Allocation calls are paired for Level Zero backend only
+  void ReportAllocChurn() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Allocation Churn Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    if (ze_api_collector_ != nullptr) {
+      ze_api_collector_->PrintChurnTable();
+    }
+
+    correlator_.Log("\n");
+  }
+
+  void ReportWaitAnalysis() {
+    PTI_ASSERT(wait_analysis_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Wait Analysis Results: ===" << std::endl;
+    stream << std::endl;
+    wait_analysis_->PrintTables(stream);
+    correlator_.Log(stream.str());
+  }
+
+  // Collected by all the tool collectors of the process when the
+  // PTI_OVERHEAD environment variable is set
+  void ReportOverhead() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Overhead Summary: ===" << std::endl;
+    stream << std::endl;
+    Overhead::PrintTable(stream);
+    correlator_.Log(stream.str());
+  }
+
   void Report() {
     if (CheckOption(TRACE_HOST_TIMING)) {
       ReportTiming(
@@ -491,452 +1165,503 @@ class UnifiedTracer {
           cl_gpu_kernel_collector_,
           "Device");
     }
+    if (CheckOption(TRACE_QUEUE_TIMING)) {
+      ReportQueueTiming();
+    }
+    if (CheckOption(TRACE_DEPENDENCY_GRAPH)) {
+      ReportDependencyGraph();
+    }
+    if (CheckOption(TRACE_CALL_STACKS)) {
+      ReportCallStacks();
+    }
+    if (CheckOption(TRACE_TRANSFER_TIMING)) {
+      ReportTransferTiming();
+    }
+    if (CheckOption(TRACE_TILE_TIMING)) {
+      ReportTileTiming();
+    }
+    if (CheckOption(TRACE_MEMORY_TRACKING)) {
+      ReportMemoryTracking();
+    }
+    if (CheckOption(TRACE_WAIT_ANALYSIS)) {
+      ReportWaitAnalysis();
+    }
+    if (CheckOption(TRACE_ALLOC_CHURN)) {
+      ReportAllocChurn();
+    }
+    if (Overhead::IsEnabled()) {
+      ReportOverhead();
+    }
+    if (itt_collector_ != nullptr) {
+      std::stringstream stream;
+      stream << std::endl;
+      stream << "=== ITT Region Results: ===" << std::endl;
+      stream << std::endl;
+      correlator_.Log(stream.str());
+      itt_collector_->PrintRegionsTable();
+      correlator_.Log("\n");
+    }
+    if (omp_device_collector_ != nullptr) {
+      std::stringstream stream;
+      stream << std::endl;
+      stream << "=== OpenMP Device Results: ===" << std::endl;
+      stream << std::endl;
+      stream << "Total Device Records: " <<
+        omp_device_collector_->GetRecordCount() << std::endl;
+      stream << std::endl;
+      correlator_.Log(stream.str());
+      omp_device_collector_->PrintRegionsTable();
+      correlator_.Log("\n");
+    }
+    if (sycl_collector_ != nullptr) {
+      std::stringstream stream;
+      stream << std::endl;
+      stream << "=== SYCL Results: ===" << std::endl;
+      stream << std::endl;
+      correlator_.Log(stream.str());
+      sycl_collector_->PrintTasksTable();
+      correlator_.Log("\n");
+    }
+    if (!kernel_frequency_map_.empty()) {
+      ReportKernelFrequency();
+    }
+    if (kernel_energy_ != nullptr && !kernel_energy_->IsEmpty()) {
+      ReportKernelEnergy();
+    }
+    if (critical_path_ != nullptr) {
+      std::stringstream stream;
+      stream << std::endl;
+      stream << "=== Critical Path Results: ===" << std::endl;
+      stream << std::endl;
+      critical_path_->PrintResults(stream);
+      stream << std::endl;
+      correlator_.Log(stream.str());
+    }
+    if (CheckOption(TRACE_SAVE_TABLES)) {
+      SaveTables();
+    }
     correlator_.Log("\n");
   }
 
-  static void ZeDeviceTimelineCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
-
-    std::stringstream stream;
-    if (tracer->CheckOption(TRACE_PID)) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+  // Timing tables of all the backends are stored for run-to-run
+  // comparison with table_diff.py
+  void SaveTables() {
+    TableStore store("onetrace");
+    if (ze_kernel_collector_ != nullptr) {
+      store.AddKernels("L0", ze_kernel_collector_->GetKernelInfoMap());
+    }
+    if (cl_cpu_kernel_collector_ != nullptr) {
+      store.AddKernels(
+          "CL CPU", cl_cpu_kernel_collector_->GetKernelInfoMap());
+    }
+    if (cl_gpu_kernel_collector_ != nullptr) {
+      store.AddKernels(
+          "CL GPU", cl_gpu_kernel_collector_->GetKernelInfoMap());
+    }
+    if (ze_api_collector_ != nullptr) {
+      store.AddFunctions("L0", ze_api_collector_->GetFunctionInfoMap());
+    }
+    if (cl_cpu_api_collector_ != nullptr) {
+      store.AddFunctions(
+          "CL CPU", cl_cpu_api_collector_->GetFunctionInfoMap());
+    }
+    if (cl_gpu_api_collector_ != nullptr) {
+      store.AddFunctions(
+          "CL GPU", cl_gpu_api_collector_->GetFunctionInfoMap());
     }
-    stream << "Device Timeline (queue: " << queue <<
-      "): " << name << " [ns] = " <<
-      queued << " (append) " <<
-      submitted << " (submit) " <<
-      started << " (start) " <<
-      ended << " (end)" << std::endl;
 
-    tracer->correlator_.Log(stream.str());
+    std::string filename =
+      TraceOptions::GetTablesFileName(kChromeTraceFileName);
+    if (store.Write(filename)) {
+      std::cerr << "[INFO] Timing tables were stored to " << filename <<
+        std::endl;
+    }
   }
 
-  static void ClDeviceTimelineCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
+  // API calls are not traced at all outside the capture window, while
+  // device commands are filtered by the kernel collectors themselves
+  static void OnCaptureChange(void* data, bool active) {
     UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
-
-    std::stringstream stream;
-    if (tracer->CheckOption(TRACE_PID)) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+    if (tracer->ze_api_collector_ != nullptr) {
+      tracer->ze_api_collector_->SetTracingEnabled(active);
+    }
+    if (tracer->cl_cpu_api_collector_ != nullptr) {
+      tracer->cl_cpu_api_collector_->SetTracingEnabled(active);
+    }
+    if (tracer->cl_gpu_api_collector_ != nullptr) {
+      tracer->cl_gpu_api_collector_->SetTracingEnabled(active);
     }
-    stream << "Device Timeline (queue: " << queue <<
-      "): " << name << " [ns] = " <<
-      queued << " (queued) " <<
-      submitted << " (submit) " <<
-      started << " (start) " <<
-      ended << " (end)" << std::endl;
+  }
 
-    tracer->correlator_.Log(stream.str());
+  // Detail the overhead governor keeps at each level, the first one is
+  // the full detail asked for
+  struct OverheadLevel {
+    const char* name;
+    bool call_logging;
+    uint32_t kernel_throttle; // Every N-th launch of each kernel is traced
+    uint32_t sampling_scale; // Counter sampling interval is N times longer
+  };
+
+  static const std::vector<OverheadLevel>& GetOverheadLevelList() {
+    static const std::vector<OverheadLevel> level_list = {
+        {"full detail", true, 1, 1},
+        {"call logging off", false, 1, 1},
+        {"1/10 of kernel launches, 4x sampling interval", false, 10, 4},
+        {"1/100 of kernel launches, 16x sampling interval", false, 100, 16}};
+    return level_list;
   }
 
-  static void ZeChromeDeviceCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
+  void SetKernelThrottle(uint32_t period) {
+    if (ze_kernel_collector_ != nullptr) {
+      ze_kernel_collector_->SetKernelThrottle(period);
+    }
+    if (cl_cpu_kernel_collector_ != nullptr) {
+      cl_cpu_kernel_collector_->SetKernelThrottle(period);
+    }
+    if (cl_gpu_kernel_collector_ != nullptr) {
+      cl_gpu_kernel_collector_->SetKernelThrottle(period);
+    }
+  }
+
+  // Each change goes to the log and to the timeline as a counter track
+  static void OnOverheadLevel(void* data, uint32_t level, double overhead) {
     UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
+    PTI_ASSERT(level < GetOverheadLevelList().size());
+    const OverheadLevel& detail = GetOverheadLevelList()[level];
 
-    std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << reinterpret_cast<uint64_t>(queue) <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
+    if (tracer->ze_api_collector_ != nullptr) {
+      tracer->ze_api_collector_->SetCallLogging(detail.call_logging);
+    }
+    if (tracer->cl_cpu_api_collector_ != nullptr) {
+      tracer->cl_cpu_api_collector_->SetCallLogging(detail.call_logging);
+    }
+    if (tracer->cl_gpu_api_collector_ != nullptr) {
+      tracer->cl_gpu_api_collector_->SetCallLogging(detail.call_logging);
+    }
+    tracer->SetKernelThrottle(detail.kernel_throttle);
+    if (tracer->sysman_sampler_ != nullptr) {
+      tracer->sysman_sampler_->SetIntervalScale(detail.sampling_scale);
+    }
+    if (tracer->energy_sampler_ != nullptr) {
+      tracer->energy_sampler_->SetIntervalScale(detail.sampling_scale);
+    }
+
+    uint64_t timestamp = tracer->correlator_.GetTimestamp();
+    std::stringstream message;
+    message << "[INFO] Tool overhead is " << std::setprecision(2) <<
+      std::fixed << overhead * 100 << "%, detail level " << level <<
+      " (" << detail.name << ") at " << timestamp << " ns" << std::endl;
+    tracer->correlator_.Log(message.str());
 
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    if (tracer->chrome_logger_ != nullptr) {
+      std::stringstream stream;
+      stream << "{\"ph\":\"C\", \"pid\":\"" << ThreadIdentity::GetPid() <<
+        "\", \"name\":\"Overhead Level\", \"ts\": " <<
+        timestamp / NSEC_IN_USEC <<
+        ", \"args\": {\"value\": " << level << "}},\n";
+      tracer->chrome_logger_->Log(stream.str());
+    }
+    if (tracer->binary_writer_ != nullptr) {
+      tracer->binary_writer_->WriteCounterRecord(
+          0, "Overhead Level", timestamp, level);
+    }
   }
 
-  static void ClChromeDeviceCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
+  // Completed commands are reported to all the sinks before it returns
+  static void OnCollectorFlush(void* data) {
     UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
-
-    std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << reinterpret_cast<uint64_t>(queue) <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    if (tracer->ze_kernel_collector_ != nullptr) {
+      tracer->ze_kernel_collector_->Flush();
+    }
+    if (tracer->cl_cpu_kernel_collector_ != nullptr) {
+      tracer->cl_cpu_kernel_collector_->Flush();
+    }
+    if (tracer->cl_gpu_kernel_collector_ != nullptr) {
+      tracer->cl_gpu_kernel_collector_->Flush();
+    }
   }
 
-  static void ZeChromeKernelCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
+  // Kernels are reported with their target region ID, as OMPT kernel
+  // records don't carry the code pointer
+  static void OmpDeviceTimelineCallback(
+      void* data, const OmpDeviceRecord& record) {
     UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
 
     std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
+    if (tracer->CheckOption(TRACE_PID)) {
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
+    }
+    stream << "OpenMP Device Timeline (device: " << record.device_num <<
+      "): " << OmpDeviceCollector::GetTypeString(record.type) <<
+      " (target: " << record.target_id << ") [ns] = " <<
+      record.start << " (start) " <<
+      record.end << " (end)" << std::endl;
 
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    tracer->correlator_.Log(stream.str());
   }
 
-  static void ClChromeKernelCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
+  // Records of both backends that go to the ring buffer and the
+  // analyses of onetrace itself
+  template <typename Id>
+  class AnalysisSink final : public TraceSink<Id> {
+   public:
+    explicit AnalysisSink(UnifiedTracer* tracer) : tracer_(tracer) {
+      PTI_ASSERT(tracer_ != nullptr);
+    }
 
-    std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
+    void AddDeviceRecord(const DeviceRecord<Id>& record) override {
+      tracer_->AnalyzeDeviceRecord(record);
+    }
 
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
-  }
+    void AddHostRecord(const HostRecord<Id>& record) override {
+      tracer_->AnalyzeHostRecord(record);
+    }
 
-  static void ZeChromeStagesCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    std::stringstream stream;
+   private:
+    UnifiedTracer* tracer_ = nullptr;
+  };
+
+  // Outputs of completed commands and API calls of one backend, each
+  // record goes to them in the order of addition
+  template <typename Id>
+  void CreateSinks(TraceSinkPipeline<Id>* pipeline,
+                   const char* queued_label, const char* queued_stage) {
+    PTI_ASSERT(pipeline != nullptr);
+    if (binary_writer_ != nullptr) {
+      pipeline->AddSink(new BinaryTraceSink<Id>(binary_writer_), true, true);
+    }
+    if (perfetto_writer_ != nullptr) {
+      pipeline->AddSink(
+          new PerfettoTraceSink<Id>(perfetto_writer_), true, true);
+    }
 
-    std::string tid = id + "." +
-      std::to_string(reinterpret_cast<uint64_t>(queue));
-
-    PTI_ASSERT(submitted > appended);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Appended)" <<
-      "\", \"ts\": " << appended / NSEC_IN_USEC <<
-      ", \"dur\":" << (submitted - appended) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_runnable\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(started > submitted);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Submitted)" <<
-      "\", \"ts\": " << submitted / NSEC_IN_USEC <<
-      ", \"dur\":" << (started - submitted) / NSEC_IN_USEC <<
-      ", \"cname\":\"cq_build_running\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(ended > started);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Execution)" <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_iowait\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-  }
-
-  static void ClChromeStagesCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    std::stringstream stream;
+    bool device_analysis = flight_recorder_ != nullptr ||
+      itt_collector_ != nullptr || omp_device_collector_ != nullptr ||
+      sycl_collector_ != nullptr || critical_path_ != nullptr ||
+      sysman_sampler_ != nullptr || kernel_energy_ != nullptr;
+    bool host_analysis = flight_recorder_ != nullptr ||
+      sycl_collector_ != nullptr || critical_path_ != nullptr;
+    if (device_analysis || host_analysis) {
+      pipeline->AddSink(
+          new AnalysisSink<Id>(this), device_analysis, host_analysis);
+    }
 
-    std::string tid =
-      std::to_string(id) +
-      "." + std::to_string(reinterpret_cast<uint64_t>(queue));
-
-    PTI_ASSERT(submitted > queued);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Queued)" <<
-      "\", \"ts\": " << queued / NSEC_IN_USEC <<
-      ", \"dur\":" << (submitted - queued) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_runnable\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(started > submitted);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Submitted)" <<
-      "\", \"ts\": " << submitted / NSEC_IN_USEC <<
-      ", \"dur\":" << (started - submitted) / NSEC_IN_USEC <<
-      ", \"cname\":\"cq_build_running\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(ended > started);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Execution)" <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_iowait\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-  }
-
-  static void ZeChromeKernelStagesCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    std::stringstream stream;
+    if (telemetry_ != nullptr) {
+      pipeline->AddSink(new TelemetrySink<Id>(telemetry_), true, true);
+    }
+    if (interval_statistics_ != nullptr) {
+      pipeline->AddSink(
+          new IntervalStatisticsSink<Id>(interval_statistics_), true, true);
+    }
+    if (wait_analysis_ != nullptr) {
+      pipeline->AddSink(new WaitAnalysisSink<Id>(wait_analysis_), true, true);
+    }
+    if (collector_api_ != nullptr) {
+      pipeline->AddSink(new CollectorApiSink<Id>(collector_api_), true, true);
+    }
+    if (CheckOption(TRACE_DEVICE_TIMELINE)) {
+      pipeline->AddSink(
+          new DeviceTimelineSink<Id>(
+              &correlator_, queued_label, false, CheckOption(TRACE_PID)),
+          true, false);
+    }
+    if (CheckOption(TRACE_CHROME_DEVICE_TIMELINE) ||
+        CheckOption(TRACE_CHROME_KERNEL_TIMELINE) ||
+        CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
+      pipeline->AddSink(
+          new ChromeDeviceSink<Id>(
+              chrome_logger_, queued_stage,
+              CheckOption(TRACE_CHROME_KERNEL_TIMELINE),
+              CheckOption(TRACE_CHROME_DEVICE_STAGES)),
+          true, false);
+    }
+    if (CheckOption(TRACE_CHROME_CALL_LOGGING)) {
+      pipeline->AddSink(new ChromeHostSink<Id>(chrome_logger_), false, true);
+    }
+  }
 
-    PTI_ASSERT(submitted > appended);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Appended)" <<
-      "\", \"ts\": " << appended / NSEC_IN_USEC <<
-      ", \"dur\":" << (submitted - appended) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_runnable\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(started > submitted);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Submitted)" <<
-      "\", \"ts\": " << submitted / NSEC_IN_USEC <<
-      ", \"dur\":" << (started - submitted) / NSEC_IN_USEC <<
-      ", \"cname\":\"cq_build_running\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(ended > started);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Execution)" <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_iowait\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-  }
-
-  static void ClChromeKernelStagesCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
+  static void IttTaskCallback(
+      void* data, const std::string& domain, const std::string& name,
       uint64_t started, uint64_t ended) {
     UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    std::stringstream stream;
 
-    PTI_ASSERT(submitted > queued);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Queued)" <<
-      "\", \"ts\": " << queued / NSEC_IN_USEC <<
-      ", \"dur\":" << (submitted - queued) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_runnable\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(started > submitted);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Submitted)" <<
-      "\", \"ts\": " << submitted / NSEC_IN_USEC <<
-      ", \"dur\":" << (started - submitted) / NSEC_IN_USEC <<
-      ", \"cname\":\"cq_build_running\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(ended > started);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Execution)" <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_iowait\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-  }
-
-  static void ZeDeviceAndChromeDeviceCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ZeDeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ZeChromeDeviceCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+    if (tracer->chrome_logger_ != nullptr) {
+      TraceBuffer& buffer = TraceBuffer::Get();
+      AddChromeThreadName(buffer);
+      buffer << "{\"ph\":\"X\", \"pid\":\"" <<
+        ThreadIdentity::GetPid() << "\", \"tid\":\"" <<
+        ThreadIdentity::GetTid() << "\", \"name\":\"" << name <<
+        "\", \"cat\":\"" << domain <<
+        "\", \"ts\": " << started / NSEC_IN_USEC <<
+        ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
+        "},\n";
+      tracer->chrome_logger_->Log(buffer.GetText());
+    }
+    if (tracer->binary_writer_ != nullptr) {
+      tracer->binary_writer_->WriteHostRecord(
+          ThreadIdentity::GetTid(), domain, name, started, ended);
+    }
+    if (tracer->perfetto_writer_ != nullptr) {
+      tracer->perfetto_writer_->WriteHostEvent(
+          ThreadIdentity::GetTid(), domain, name, started, ended);
+    }
   }
 
-  static void ClDeviceAndChromeDeviceCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
+  // Kernels running longer than the trigger time request a ring dump,
+  // which is done later by the flight recorder thread
+  template <typename T>
+  void RecordDeviceEvent(
+      void* queue, const T& id, const std::string& name,
       uint64_t queued, uint64_t submitted,
       uint64_t started, uint64_t ended) {
-    ClDeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ClChromeDeviceCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+    PTI_ASSERT(flight_recorder_ != nullptr);
+    flight_recorder_->AddRecord(BinaryTraceWriter::MakeDeviceRecord(
+        queue, id, name, queued, submitted, started, ended));
+
+    uint64_t trigger = options_.GetRingBufferTrigger();
+    if (trigger > 0 && ended - started > trigger) {
+      flight_recorder_->RequestDump();
+    }
   }
 
-  static void ZeDeviceAndChromeKernelCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ZeDeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ZeChromeKernelCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+  void AnalyzeDeviceRecord(const DeviceRecord<std::string>& record) {
+    if (flight_recorder_ != nullptr) {
+      RecordDeviceEvent(record.queue, record.id, record.name, record.queued,
+                        record.submitted, record.started, record.ended);
+    }
+    if (itt_collector_ != nullptr) {
+      itt_collector_->AddKernel(
+          record.name, record.queued, record.started, record.ended);
+    }
+    if (omp_device_collector_ != nullptr) {
+      omp_device_collector_->AddKernel(
+          record.name, record.started, record.ended);
+    }
+    if (sycl_collector_ != nullptr) {
+      // Device command ID is "<kernel id>.<call id>"
+      sycl_collector_->AddKernel(
+          std::strtoull(record.id.c_str(), nullptr, 10),
+          record.started, record.ended);
+    }
+    if (critical_path_ != nullptr) {
+      // Device command ID is "<kernel id>.<call id>"
+      critical_path_->AddKernel(
+          std::strtoull(record.id.c_str(), nullptr, 10), record.name,
+          record.queued, record.submitted, record.started, record.ended);
+    }
+    if (sysman_sampler_ != nullptr) {
+      AddKernelFrequency(record.name, record.started, record.ended);
+    }
+    if (kernel_energy_ != nullptr) {
+      // Device of the kernel queue is not known here, so the energy of
+      // the first GPU is split
+      kernel_energy_->AddKernel(record.name, record.started, record.ended);
+    }
   }
 
-  static void ClDeviceAndChromeKernelCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ClDeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ClChromeKernelCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+  void AnalyzeDeviceRecord(const DeviceRecord<uint64_t>& record) {
+    if (flight_recorder_ != nullptr) {
+      RecordDeviceEvent(record.queue, record.id, record.name, record.queued,
+                        record.submitted, record.started, record.ended);
+    }
+    if (itt_collector_ != nullptr) {
+      itt_collector_->AddKernel(
+          record.name, record.queued, record.started, record.ended);
+    }
+    if (omp_device_collector_ != nullptr) {
+      omp_device_collector_->AddKernel(
+          record.name, record.started, record.ended);
+    }
+    if (sycl_collector_ != nullptr) {
+      sycl_collector_->AddKernel(record.id, record.started, record.ended);
+    }
+    if (critical_path_ != nullptr) {
+      critical_path_->AddKernel(
+          record.id, record.name, record.queued, record.submitted,
+          record.started, record.ended);
+    }
   }
 
-  static void ZeDeviceAndChromeStagesCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ZeDeviceTimelineCallback(
-        data, queue, id, name, appended, submitted, started, ended);
-    ZeChromeStagesCallback(
-        data, queue, id, name, appended, submitted, started, ended);
+  void AnalyzeHostRecord(const HostRecord<std::string>& record) {
+    if (flight_recorder_ != nullptr) {
+      flight_recorder_->AddRecord(BinaryTraceWriter::MakeHostRecord(
+          record.tid, record.id, record.name, record.started, record.ended));
+    }
+    if (critical_path_ != nullptr || sycl_collector_ != nullptr) {
+      // Only append calls give a single kernel ID, submissions give lists
+      const std::string& id = record.id;
+      uint64_t kernel_id = 0;
+      if (!id.empty() &&
+          id.find_first_not_of("0123456789") == std::string::npos) {
+        kernel_id = std::strtoull(id.c_str(), nullptr, 10);
+      }
+      if (sycl_collector_ != nullptr) {
+        sycl_collector_->AddCall(kernel_id, record.started, record.ended);
+      }
+      if (critical_path_ != nullptr) {
+        critical_path_->AddCall(
+            kernel_id, record.name, record.started, record.ended);
+      }
+    }
   }
 
-  static void ClDeviceAndChromeStagesCallback(
-      void* data, void* queue,
-      uint64_t id, const std::string& name,
-      uint64_t queued, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ClDeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ClChromeStagesCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+  void AnalyzeHostRecord(const HostRecord<uint64_t>& record) {
+    if (flight_recorder_ != nullptr) {
+      flight_recorder_->AddRecord(BinaryTraceWriter::MakeHostRecord(
+          record.tid, record.id, record.name, record.started, record.ended));
+    }
+    if (sycl_collector_ != nullptr) {
+      sycl_collector_->AddCall(record.id, record.started, record.ended);
+    }
+    if (critical_path_ != nullptr) {
+      critical_path_->AddCall(
+          record.id, record.name, record.started, record.ended);
+    }
   }
 
-  static void ZeDeviceAndChromeKernelStagesCallback(
+  static void OnZeKernelFinish(
       void* data, void* queue,
       const std::string& id, const std::string& name,
       uint64_t appended, uint64_t submitted,
       uint64_t started, uint64_t ended) {
-    ZeDeviceTimelineCallback(
-        data, queue, id, name, appended, submitted, started, ended);
-    ZeChromeKernelStagesCallback(
-        data, queue, id, name, appended, submitted, started, ended);
+    UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
+    PTI_ASSERT(tracer != nullptr);
+    tracer->ze_pipeline_.AddDeviceRecord(
+        {queue, id, name, appended, submitted, started, ended});
   }
 
-  static void ClDeviceAndChromeKernelStagesCallback(
+  static void OnClKernelFinish(
       void* data, void* queue,
       uint64_t id, const std::string& name,
       uint64_t queued, uint64_t submitted,
       uint64_t started, uint64_t ended) {
-    ClDeviceTimelineCallback(
-        data, queue, id, name, queued, submitted, started, ended);
-    ClChromeKernelStagesCallback(
-        data, queue, id, name, queued, submitted, started, ended);
+    UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
+    PTI_ASSERT(tracer != nullptr);
+    tracer->cl_pipeline_.AddDeviceRecord(
+        {queue, id, name, queued, submitted, started, ended});
   }
 
-  static void ZeChromeLoggingCallback(
+  static void OnZeFunctionFinish(
       void* data, const std::string& id, const std::string& name,
       uint64_t started, uint64_t ended) {
     UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
-
-    std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" <<
-      utils::GetPid() << "\", \"tid\":\"" << utils::GetTid() <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    tracer->ze_pipeline_.AddHostRecord(
+        {ThreadIdentity::GetTid(), id, name, started, ended});
   }
 
-  static void ClChromeLoggingCallback(
+  static void OnClFunctionFinish(
       void* data, uint64_t id, const std::string& name,
       uint64_t started, uint64_t ended) {
     UnifiedTracer* tracer = reinterpret_cast<UnifiedTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
-
-    std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" <<
-      utils::GetPid() << "\", \"tid\":\"" << utils::GetTid() <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    tracer->cl_pipeline_.AddHostRecord(
+        {ThreadIdentity::GetTid(), id, name, started, ended});
   }
 
  private:
@@ -950,11 +1675,44 @@ class UnifiedTracer {
   ClApiCollector* cl_gpu_api_collector_ = nullptr;
 
   ZeKernelCollector* ze_kernel_collector_ = nullptr;
+  ZeModuleCollector* ze_module_collector_ = nullptr;
   ClKernelCollector* cl_cpu_kernel_collector_ = nullptr;
   ClKernelCollector* cl_gpu_kernel_collector_ = nullptr;
 
+  CaptureControl* capture_ = nullptr;
+  IttCollector* itt_collector_ = nullptr;
+  CollectorApi* collector_api_ = nullptr;
+  OverheadGovernor* overhead_governor_ = nullptr;
+  OmpDeviceCollector* omp_device_collector_ = nullptr;
+  SyclCollector* sycl_collector_ = nullptr;
+  CriticalPathAnalyzer* critical_path_ = nullptr;
+
+  SysmanSampler* sysman_sampler_ = nullptr;
+  std::mutex kernel_frequency_lock_;
+  std::map<std::string, KernelFrequency> kernel_frequency_map_;
+
+  EnergySampler* energy_sampler_ = nullptr;
+  KernelEnergy* kernel_energy_ = nullptr;
+
   std::string chrome_trace_file_name_;
   Logger* chrome_logger_ = nullptr;
+
+  std::string binary_trace_file_name_;
+  BinaryTraceWriter* binary_writer_ = nullptr;
+
+  std::string perfetto_trace_file_name_;
+  PerfettoTraceWriter* perfetto_writer_ = nullptr;
+
+  FlightRecorder* flight_recorder_ = nullptr;
+  TelemetryServer* telemetry_ = nullptr;
+
+  std::string interval_file_name_;
+  IntervalStatistics* interval_statistics_ = nullptr;
+
+  WaitAnalysis* wait_analysis_ = nullptr;
+
+  TraceSinkPipeline<std::string> ze_pipeline_;
+  TraceSinkPipeline<uint64_t> cl_pipeline_;
 };
 
 #endif // PTI_TOOLS_ONETRACE_UNIFIED_TRACER_H_
\ No newline at end of file
@@ -1,13 +1,24 @@
+#include <signal.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <level_zero/ze_api.h>
 #include <level_zero/zes_api.h>
 
+#include "metrics_server.h"
+#include "sysman_device.h"
 #include "utils.h"
 #include "ze_utils.h"
 
@@ -25,12 +36,30 @@
 #define MEMORY_LENGTH   24
 #define ENGINES_LENGTH  12
 
+#define MAX_WATCH_INTERVAL 3600000 // ms
+#define DEFAULT_EXPORTER_INTERVAL 1000 // ms
+#define DEFAULT_DETAILS_INTERVAL 500 // ms
+#define DETAILS_SAMPLE_COUNT 5
+#define DEFAULT_TOP_PROCESS_COUNT 10
+
 enum Mode {
   MODE_PROCESSES,
   MODE_DEVICE_LIST,
-  MODE_DETAILS
+  MODE_DETAILS,
+  MODE_WATCH,
+  MODE_TOP,
+  MODE_EXPORTER
+};
+
+// Snapshots of the device counters taken over the details interval
+struct DeviceActivity {
+  SysmanDevice* device;
+  std::vector<SysmanSample> sample_list;
+  std::map<uint32_t, zes_process_state_t> process_map;
 };
 
+static std::atomic<bool> stop(false);
+
 static void Usage() {
   std::cout <<
     "Usage: ./sysmon [options]" <<
@@ -45,8 +74,33 @@ static void Usage() {
     "Print list of devices and subdevices" <<
     std::endl;
   std::cout <<
-    "--details [-d]      " <<
-    "Print detailed information for all of the devices and subdevices" <<
+    "--details [-d] [interval]" << std::endl <<
+    "                    " <<
+    "Print detailed information for all of the devices and subdevices, " <<
+    "power, engine utilization and processes are sampled over " <<
+    "<interval> ms (" << DEFAULT_DETAILS_INTERVAL << " by default)" <<
+    std::endl;
+  std::cout <<
+    "--watch [-w] <interval> [count]" << std::endl <<
+    "                    " <<
+    "Print CSV line with frequency, temperature, memory, power and " <<
+    "engine utilization of all the devices every <interval> ms " <<
+    "(until Ctrl+C or <count> lines)" <<
+    std::endl;
+  std::cout <<
+    "--top [-t] <interval> [count] [processes]" << std::endl <<
+    "                    " <<
+    "Print CSV lines with memory and estimated engine usage of the " <<
+    "busiest <processes> (" << DEFAULT_TOP_PROCESS_COUNT << " by " <<
+    "default) of each device every <interval> ms (until Ctrl+C or " <<
+    "<count> intervals)" <<
+    std::endl;
+  std::cout <<
+    "--exporter [-e] <port> [interval]" << std::endl <<
+    "                    " <<
+    "Serve device telemetry in Prometheus text format on " <<
+    "http://<host>:<port>/metrics, sampled every <interval> ms (" <<
+    DEFAULT_EXPORTER_INTERVAL << " by default)" <<
     std::endl;
   std::cout <<
     "--help [-h]         " <<
@@ -257,6 +311,37 @@ static std::string GetProcessName(uint32_t pid) {
   return process_name;
 }
 
+// Names are read from /proc once per process, the entries of the
+// processes not seen since the previous prune are dropped, so a reused
+// PID gets its name read again
+class ProcessNameCache {
+ public: // Interface
+  const std::string& Get(uint32_t pid) {
+    auto it = name_map_.find(pid);
+    if (it == name_map_.end()) {
+      it = name_map_.emplace(
+          pid, std::make_pair(GetProcessName(pid), generation_)).first;
+    }
+    it->second.second = generation_;
+    return it->second.first;
+  }
+
+  void Prune() {
+    for (auto it = name_map_.begin(); it != name_map_.end();) {
+      if (it->second.second != generation_) {
+        it = name_map_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    ++generation_;
+  }
+
+ private: // Data
+  std::map<uint32_t, std::pair<std::string, uint64_t> > name_map_;
+  uint64_t generation_ = 0;
+};
+
 static std::string GetEnginesString (uint64_t engines) {
   std::string engines_string;
   std::bitset<6> bits(engines);
@@ -864,28 +949,6 @@ void PrintEngineInfo(
   status = zesDeviceEnumEngineGroups(device, &engine_groups_count, nullptr);
   PTI_ASSERT(status == ZE_RESULT_SUCCESS);
 
-  std::map<int, std::string> engine_types = {
-    {ZES_ENGINE_GROUP_ALL,"ALL"},
-    {ZES_ENGINE_GROUP_COMPUTE_ALL, "COMPUTE_ALL"},
-    {ZES_ENGINE_GROUP_MEDIA_ALL, "MEDIA_ALL"},
-    {ZES_ENGINE_GROUP_COPY_ALL, "COPY_ALL"},
-    {ZES_ENGINE_GROUP_COMPUTE_SINGLE, "COMPUTE_SINGLE"},
-    {ZES_ENGINE_GROUP_RENDER_SINGLE, "RENDER_SINGLE"},
-    {ZES_ENGINE_GROUP_MEDIA_DECODE_SINGLE,
-    "MEDIA_DECODE_SINGLE"},
-    {ZES_ENGINE_GROUP_MEDIA_ENCODE_SINGLE,
-    "MEDIA_ENCODE_SINGLE"},
-    {ZES_ENGINE_GROUP_COPY_SINGLE, "COPY_SINGLE"},
-    {ZES_ENGINE_GROUP_MEDIA_ENHANCEMENT_SINGLE,
-    "MEDIA_ENHANCEMENT_SINGLE"},
-    {ZES_ENGINE_GROUP_3D_SINGLE, "3D_SINGLE"},
-    {ZES_ENGINE_GROUP_3D_RENDER_COMPUTE_ALL,
-    "3D_RENDER_COMPUTE_ALL"},
-    {ZES_ENGINE_GROUP_RENDER_ALL, "GROUP_RENDER_ALL"},
-    {ZES_ENGINE_GROUP_3D_ALL, "3D_ALL"},
-    {ZES_ENGINE_GROUP_FORCE_UINT32, "FORCE_UINT32"}
-  };
-
   if (engine_groups_count > 0) {
     std::vector<zes_engine_handle_t> engine_groups(engine_groups_count);
     status = zesDeviceEnumEngineGroups(
@@ -916,7 +979,7 @@ void PrintEngineInfo(
 
       std::string engines;
       for (auto items : engine_map) {
-        engines += engine_types[items.first] + "(" +
+        engines += SysmanDevice::GetEngineName(items.first) + "(" +
           std::to_string(items.second) + ");";
       }
 
@@ -1049,8 +1112,115 @@ void PrintTemperatureInfo(
   }
 }
 
+// Average is taken over the whole interval, peak is the largest value
+// between two consecutive snapshots
+template <typename Counter, typename Rate>
+static std::string GetActivityString(
+    const std::vector<SysmanSample>& sample_list,
+    std::vector<Counter> SysmanSample::* counter_list, size_t index,
+    Rate rate) {
+  PTI_ASSERT(sample_list.size() > 1);
+  double average = rate((sample_list.front().*counter_list)[index],
+                        (sample_list.back().*counter_list)[index]);
+  if (average < 0) {
+    return UNKNOWN;
+  }
+
+  double peak = average;
+  for (size_t i = 1; i < sample_list.size(); ++i) {
+    double value = rate((sample_list[i - 1].*counter_list)[index],
+                        (sample_list[i].*counter_list)[index]);
+    if (value > peak) {
+      peak = value;
+    }
+  }
+
+  return ToString(average) + " (peak " + ToString(peak) + ")";
+}
+
+static void PrintPowerActivity(
+    const DeviceActivity& activity, uint32_t subdevice_id = UINT32_MAX) {
+  const std::vector<SysmanPower>& power_list =
+    activity.device->GetPowerList();
+  for (size_t i = 0; i < power_list.size(); ++i) {
+    const SysmanPower& power = power_list[i];
+    if ((power.on_subdevice && power.subdevice_id == subdevice_id) ||
+        (!power.on_subdevice && subdevice_id == UINT32_MAX)) {
+      std::cout << std::setw(TEXT_WIDTH) << std::left << "Power(W)," <<
+        GetActivityString(activity.sample_list, &SysmanSample::energy_list,
+                          i, SysmanDevice::GetPower) << std::endl;
+    }
+  }
+}
+
+static void PrintEngineActivity(
+    const DeviceActivity& activity, uint32_t subdevice_id = UINT32_MAX) {
+  const std::vector<SysmanEngine>& engine_list =
+    activity.device->GetEngineList();
+  for (size_t i = 0; i < engine_list.size(); ++i) {
+    const SysmanEngine& engine = engine_list[i];
+    if ((engine.on_subdevice && engine.subdevice_id == subdevice_id) ||
+        (!engine.on_subdevice && subdevice_id == UINT32_MAX)) {
+      std::string name = SysmanDevice::GetEngineName(engine.type) +
+        " Busy(%),";
+      std::cout << std::setw(TEXT_WIDTH) << std::left << name <<
+        GetActivityString(activity.sample_list, &SysmanSample::engine_list,
+                          i, SysmanDevice::GetBusy) << std::endl;
+    }
+  }
+}
+
+// Sysman reports no per-process utilization, so each process is shown
+// with the engines it used and its peak memory over the interval
+static void PrintProcessActivity(const DeviceActivity& activity) {
+  std::cout << std::setw(TEXT_WIDTH) << std::left << "Active Processes," <<
+    activity.process_map.size() << std::endl;
+  for (auto& item : activity.process_map) {
+    const zes_process_state_t& process = item.second;
+    std::string name = "Process " + std::to_string(process.processId) + ",";
+    std::cout << std::setw(TEXT_WIDTH) << std::left << name <<
+      GetProcessName(process.processId) << "; " <<
+      GetEnginesString(process.engines) << "; " <<
+      ToString(process.memSize / BYTES_IN_MB) << " MB device; " <<
+      ToString(process.sharedSize / BYTES_IN_MB) << " MB shared" <<
+      std::endl;
+  }
+}
+
+static void SampleActivity(
+    std::vector<DeviceActivity>& activity_list, uint32_t interval) {
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < DETAILS_SAMPLE_COUNT; ++i) {
+    if (i > 0) {
+      deadline += std::chrono::milliseconds(
+          interval / (DETAILS_SAMPLE_COUNT - 1));
+      std::this_thread::sleep_until(deadline);
+    }
+
+    for (auto& activity : activity_list) {
+      activity.sample_list.emplace_back();
+      activity.device->Sample(&activity.sample_list.back());
+
+      for (auto& state :
+           GetDeviceProcesses(activity.device->GetDevice())) {
+        auto it = activity.process_map.find(state.processId);
+        if (it == activity.process_map.end()) {
+          activity.process_map[state.processId] = state;
+          continue;
+        }
+        zes_process_state_t& process = it->second;
+        process.engines |= state.engines;
+        process.memSize = std::max(process.memSize, state.memSize);
+        process.sharedSize = std::max(process.sharedSize, state.sharedSize);
+      }
+    }
+  }
+}
+
 static void PrintSubdeviceDetails(
-    zes_device_handle_t device, uint32_t subdevice_id) {
+    zes_device_handle_t device, uint32_t subdevice_id,
+    const DeviceActivity& activity) {
   PTI_ASSERT(device != nullptr);
 
   std::vector<zes_device_handle_t> subdevice_list =
@@ -1087,16 +1257,19 @@ static void PrintSubdeviceDetails(
 
   PrintFrequencyInfo(device, subdevice_id);
   PrintPowerInfo(device, subdevice_id);
+  PrintPowerActivity(activity, subdevice_id);
   PrintFirmwareInfo(device, subdevice_id);
   PrintMemoryInfo(device, subdevice_id);
   PrintEngineInfo(device, subdevice_id);
+  PrintEngineActivity(activity, subdevice_id);
   PrintFabricPortInfo(device, subdevice_id);
   PrintFanInfo(device, subdevice_id);
   PrintTemperatureInfo(device, subdevice_id);
 }
 
 static void PrintDetails(ze_driver_handle_t driver,
-    zes_device_handle_t device, uint32_t device_id) {
+    zes_device_handle_t device, uint32_t device_id,
+    const DeviceActivity& activity) {
   PTI_ASSERT(device != nullptr);
   ze_result_t status = ZE_RESULT_SUCCESS;
 
@@ -1172,26 +1345,657 @@ static void PrintDetails(ze_driver_handle_t driver,
 
   PrintFrequencyInfo(device);
   PrintPowerInfo(device);
+  PrintPowerActivity(activity);
   PrintFirmwareInfo(device);
   PrintMemoryInfo(device);
   PrintEngineInfo(device);
+  PrintEngineActivity(activity);
   PrintFabricPortInfo(device);
   PrintFanInfo(device);
   PrintTemperatureInfo(device);
+  PrintProcessActivity(activity);
 
   if (props.numSubdevices > 0) {
     for (size_t subdevice = 0; subdevice < props.numSubdevices; ++subdevice) {
       std::cout << std::setw(DEL_WIDTH) << std::setfill('-') <<
         '-' << std::setfill(' ') << std::endl;
-      PrintSubdeviceDetails(device, subdevice);
+      PrintSubdeviceDetails(device, subdevice, activity);
     }
   }
 
   std::cout << std::endl;
 }
 
+// All the devices are sampled at once, so the details are printed after
+// a single interval
+static void Details(uint32_t interval) {
+  std::vector<ze_driver_handle_t> driver_list;
+  std::vector<DeviceActivity> activity_list;
+  for (auto driver : utils::ze::GetDriverList()) {
+    for (auto device : utils::ze::GetDeviceList(driver)) {
+      driver_list.push_back(driver);
+      activity_list.push_back({new SysmanDevice(device), });
+    }
+  }
+
+  SampleActivity(activity_list, interval);
+
+  for (size_t i = 0; i < activity_list.size(); ++i) {
+    PrintDetails(driver_list[i], activity_list[i].device->GetDevice(), i,
+                 activity_list[i]);
+    delete activity_list[i].device;
+  }
+}
+
+static void Stop(int signal) {
+  stop.store(true, std::memory_order_release);
+}
+
+static std::string GetWatchValue(double value) {
+  return (value < 0) ? UNKNOWN : ToString(value);
+}
+
+static std::string GetWatchPrefix(
+    uint32_t device_id, bool on_subdevice, uint32_t subdevice_id) {
+  std::string prefix = "GPU" + std::to_string(device_id);
+  if (on_subdevice) {
+    prefix += "." + std::to_string(subdevice_id);
+  }
+  return prefix;
+}
+
+static void PrintWatchHeader(
+    const std::vector<SysmanDevice*>& device_list) {
+  std::cout << "Time(ms)";
+  for (uint32_t i = 0; i < device_list.size(); ++i) {
+    std::string prefix = GetWatchPrefix(i, false, 0);
+    std::cout << "," << prefix << " Frequency(MHz)" <<
+      "," << prefix << " Temperature(C)" <<
+      "," << prefix << " Memory Used(MB)";
+
+    for (auto& power : device_list[i]->GetPowerList()) {
+      std::cout << "," <<
+        GetWatchPrefix(i, power.on_subdevice, power.subdevice_id) <<
+        " Power(W)";
+    }
+
+    // Engines of the same type are numbered in the order of enumeration
+    std::map<std::string, uint32_t> engine_count;
+    for (auto& engine : device_list[i]->GetEngineList()) {
+      std::string name =
+        GetWatchPrefix(i, engine.on_subdevice, engine.subdevice_id) + " " +
+        SysmanDevice::GetEngineName(engine.type);
+      uint32_t index = engine_count[name]++;
+      if (index > 0) {
+        name += "#" + std::to_string(index);
+      }
+      std::cout << "," << name << "(%)";
+    }
+  }
+  std::cout << std::endl;
+}
+
+static void PrintWatchLine(
+    const std::vector<SysmanDevice*>& device_list,
+    const std::vector<SysmanSample>& prev_list,
+    const std::vector<SysmanSample>& next_list,
+    uint64_t start) {
+  PTI_ASSERT(device_list.size() == prev_list.size());
+  PTI_ASSERT(device_list.size() == next_list.size());
+  PTI_ASSERT(!next_list.empty());
+
+  std::cout << (next_list[0].timestamp - start) / 1000000;
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    const SysmanSample& prev = prev_list[i];
+    const SysmanSample& next = next_list[i];
+
+    std::cout << "," << GetWatchValue(next.frequency) <<
+      "," << GetWatchValue(next.temperature) <<
+      "," << (next.memory_size == 0 ? UNKNOWN :
+        ToString((next.memory_size - next.memory_free) / BYTES_IN_MB));
+
+    for (size_t j = 0; j < next.energy_list.size(); ++j) {
+      std::cout << "," << GetWatchValue(SysmanDevice::GetPower(
+          prev.energy_list[j], next.energy_list[j]));
+    }
+
+    for (size_t j = 0; j < next.engine_list.size(); ++j) {
+      std::cout << "," << GetWatchValue(SysmanDevice::GetBusy(
+          prev.engine_list[j], next.engine_list[j]));
+    }
+  }
+  std::cout << std::endl;
+}
+
+// Sysman handles are enumerated once, each interval queries the current
+// state and counters only, rates are taken from consecutive samples
+static void Watch(uint32_t interval, uint32_t count) {
+  std::vector<SysmanDevice*> device_list;
+  for (auto driver : utils::ze::GetDriverList()) {
+    for (auto device : utils::ze::GetDeviceList(driver)) {
+      device_list.push_back(new SysmanDevice(device));
+    }
+  }
+
+  if (device_list.empty()) {
+    std::cerr << "[WARNING] No devices found" << std::endl;
+    return;
+  }
+
+  signal(SIGINT, Stop);
+  signal(SIGTERM, Stop);
+
+  PrintWatchHeader(device_list);
+
+  std::vector<SysmanSample> prev_list(device_list.size());
+  std::vector<SysmanSample> next_list(device_list.size());
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    device_list[i]->Sample(&prev_list[i]);
+  }
+  uint64_t start = prev_list[0].timestamp;
+
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::now();
+  for (uint32_t line = 0; count == 0 || line < count; ++line) {
+    deadline += std::chrono::milliseconds(interval);
+    std::this_thread::sleep_until(deadline);
+    if (stop.load(std::memory_order_acquire)) {
+      break;
+    }
+
+    for (size_t i = 0; i < device_list.size(); ++i) {
+      device_list[i]->Sample(&next_list[i]);
+    }
+    PrintWatchLine(device_list, prev_list, next_list, start);
+    prev_list.swap(next_list);
+  }
+
+  for (auto device : device_list) {
+    delete device;
+  }
+}
+
+enum EngineClass {
+  ENGINE_CLASS_COMPUTE = 0,
+  ENGINE_CLASS_COPY,
+  ENGINE_CLASS_MEDIA,
+  ENGINE_CLASS_COUNT
+};
+
+// Usage of a process on a device over the last interval, engine usage is
+// estimated, as Sysman reports only the engine types a process uses
+struct ProcessUsage {
+  zes_process_state_t state;
+  int64_t memory_delta = 0; // Bytes since the previous interval
+  uint64_t peak_size = 0; // Device memory
+  double busy[ENGINE_CLASS_COUNT]; // Share of the engine class, %
+  double busy_max = SYSMAN_UNKNOWN; // Over the classes
+  double busy_time = 0.0; // Since the process was seen first, % * ns
+  uint64_t known_time = 0; // Part of the above with known busy, ns
+};
+
+// Aggregate groups are counted as well, so that the class busy is the
+// busy time of its busiest engine group
+static int GetEngineClass(zes_engine_group_t type) {
+  switch (type) {
+    case ZES_ENGINE_GROUP_COMPUTE_ALL:
+    case ZES_ENGINE_GROUP_COMPUTE_SINGLE:
+    case ZES_ENGINE_GROUP_RENDER_SINGLE:
+    case ZES_ENGINE_GROUP_RENDER_ALL:
+    case ZES_ENGINE_GROUP_3D_SINGLE:
+    case ZES_ENGINE_GROUP_3D_ALL:
+    case ZES_ENGINE_GROUP_3D_RENDER_COMPUTE_ALL:
+      return ENGINE_CLASS_COMPUTE;
+    case ZES_ENGINE_GROUP_COPY_ALL:
+    case ZES_ENGINE_GROUP_COPY_SINGLE:
+      return ENGINE_CLASS_COPY;
+    case ZES_ENGINE_GROUP_MEDIA_ALL:
+    case ZES_ENGINE_GROUP_MEDIA_DECODE_SINGLE:
+    case ZES_ENGINE_GROUP_MEDIA_ENCODE_SINGLE:
+    case ZES_ENGINE_GROUP_MEDIA_ENHANCEMENT_SINGLE:
+      return ENGINE_CLASS_MEDIA;
+    default:
+      break;
+  }
+  return -1;
+}
+
+// Some drivers report compute work of a process as OTHER engine type
+static bool UsesEngineClass(zes_engine_type_flags_t engines, int type) {
+  switch (type) {
+    case ENGINE_CLASS_COMPUTE:
+      return (engines & (ZES_ENGINE_TYPE_FLAG_OTHER |
+                         ZES_ENGINE_TYPE_FLAG_COMPUTE |
+                         ZES_ENGINE_TYPE_FLAG_3D |
+                         ZES_ENGINE_TYPE_FLAG_RENDER)) != 0;
+    case ENGINE_CLASS_COPY:
+      return (engines & ZES_ENGINE_TYPE_FLAG_DMA) != 0;
+    case ENGINE_CLASS_MEDIA:
+      return (engines & ZES_ENGINE_TYPE_FLAG_MEDIA) != 0;
+    default:
+      break;
+  }
+  return false;
+}
+
+// Busy time of each engine class over the interval is split evenly
+// between the processes that use the class, processes that are gone are
+// dropped
+static void UpdateProcessUsage(
+    const SysmanDevice& device,
+    const SysmanSample& prev, const SysmanSample& next,
+    const std::vector<zes_process_state_t>& state_list,
+    std::map<uint32_t, ProcessUsage>* usage_map) {
+  PTI_ASSERT(usage_map != nullptr);
+
+  double class_busy[ENGINE_CLASS_COUNT];
+  std::fill(class_busy, class_busy + ENGINE_CLASS_COUNT, SYSMAN_UNKNOWN);
+  const std::vector<SysmanEngine>& engine_list = device.GetEngineList();
+  for (size_t i = 0; i < engine_list.size(); ++i) {
+    int type = GetEngineClass(engine_list[i].type);
+    if (type < 0) {
+      continue;
+    }
+    double busy = SysmanDevice::GetBusy(
+        prev.engine_list[i], next.engine_list[i]);
+    class_busy[type] = std::max(class_busy[type], busy);
+  }
+
+  uint32_t user_count[ENGINE_CLASS_COUNT] = {0};
+  for (auto& state : state_list) {
+    for (int i = 0; i < ENGINE_CLASS_COUNT; ++i) {
+      if (UsesEngineClass(state.engines, i)) {
+        ++user_count[i];
+      }
+    }
+  }
+
+  std::map<uint32_t, ProcessUsage> next_map;
+  uint64_t time = next.timestamp - prev.timestamp;
+  for (auto& state : state_list) {
+    ProcessUsage usage;
+    auto it = usage_map->find(state.processId);
+    if (it != usage_map->end()) {
+      usage = it->second;
+      usage.memory_delta = static_cast<int64_t>(state.memSize) -
+        static_cast<int64_t>(usage.state.memSize);
+    }
+    usage.state = state;
+    usage.peak_size = std::max(usage.peak_size, state.memSize);
+
+    usage.busy_max = SYSMAN_UNKNOWN;
+    for (int i = 0; i < ENGINE_CLASS_COUNT; ++i) {
+      usage.busy[i] = 0.0;
+      if (class_busy[i] < 0) {
+        usage.busy[i] = SYSMAN_UNKNOWN;
+      } else if (UsesEngineClass(state.engines, i)) {
+        PTI_ASSERT(user_count[i] > 0);
+        usage.busy[i] = class_busy[i] / user_count[i];
+      }
+      usage.busy_max = std::max(usage.busy_max, usage.busy[i]);
+    }
+    if (usage.busy_max >= 0) {
+      usage.busy_time += usage.busy_max * time;
+      usage.known_time += time;
+    }
+
+    next_map[state.processId] = usage;
+  }
+  usage_map->swap(next_map);
+}
+
+static void PrintTopHeader() {
+  std::cout << "Time(ms),GPU,PID,Device Memory(MB),Memory Delta(MB)," <<
+    "Peak Memory(MB),Shared Memory(MB),Compute(%),Copy(%),Media(%)," <<
+    "Busy(%),Average Busy(%),Engines,Executable" << std::endl;
+}
+
+static void PrintTopLines(
+    uint32_t device_id, uint64_t time,
+    const std::map<uint32_t, ProcessUsage>& usage_map,
+    uint32_t process_count, ProcessNameCache* name_cache) {
+  PTI_ASSERT(name_cache != nullptr);
+
+  std::vector<const ProcessUsage*> usage_list;
+  for (auto& item : usage_map) {
+    usage_list.push_back(&item.second);
+  }
+  std::sort(usage_list.begin(), usage_list.end(),
+            [](const ProcessUsage* left, const ProcessUsage* right) {
+              if (left->busy_max != right->busy_max) {
+                return left->busy_max > right->busy_max;
+              }
+              return left->state.memSize > right->state.memSize;
+            });
+  if (usage_list.size() > process_count) {
+    usage_list.resize(process_count);
+  }
+
+  for (const ProcessUsage* usage : usage_list) {
+    double average = (usage->known_time == 0) ? SYSMAN_UNKNOWN :
+      usage->busy_time / usage->known_time;
+    std::cout << time << "," << device_id << "," <<
+      usage->state.processId << "," <<
+      ToString(usage->state.memSize / BYTES_IN_MB) << "," <<
+      ToString(usage->memory_delta / BYTES_IN_MB) << "," <<
+      ToString(usage->peak_size / BYTES_IN_MB) << "," <<
+      ToString(usage->state.sharedSize / BYTES_IN_MB);
+    for (int i = 0; i < ENGINE_CLASS_COUNT; ++i) {
+      std::cout << "," << GetWatchValue(usage->busy[i]);
+    }
+    std::cout << "," << GetWatchValue(usage->busy_max) <<
+      "," << GetWatchValue(average) <<
+      "," << GetEnginesString(usage->state.engines) <<
+      "," << name_cache->Get(usage->state.processId) << std::endl;
+  }
+}
+
+// Like Watch mode, but per process: the process list and the engine
+// counters are sampled once per interval, and executable names are read
+// from /proc only for new processes
+static void Top(uint32_t interval, uint32_t count, uint32_t process_count) {
+  std::vector<SysmanDevice*> device_list;
+  for (auto driver : utils::ze::GetDriverList()) {
+    for (auto device : utils::ze::GetDeviceList(driver)) {
+      device_list.push_back(new SysmanDevice(device));
+    }
+  }
+
+  if (device_list.empty()) {
+    std::cerr << "[WARNING] No devices found" << std::endl;
+    return;
+  }
+
+  signal(SIGINT, Stop);
+  signal(SIGTERM, Stop);
+
+  PrintTopHeader();
+
+  std::vector<SysmanSample> prev_list(device_list.size());
+  std::vector<SysmanSample> next_list(device_list.size());
+  std::vector< std::map<uint32_t, ProcessUsage> > usage_list(
+      device_list.size());
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    device_list[i]->Sample(&prev_list[i]);
+  }
+  uint64_t start = prev_list[0].timestamp;
+  ProcessNameCache name_cache;
+
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::now();
+  for (uint32_t line = 0; count == 0 || line < count; ++line) {
+    deadline += std::chrono::milliseconds(interval);
+    std::this_thread::sleep_until(deadline);
+    if (stop.load(std::memory_order_acquire)) {
+      break;
+    }
+
+    for (size_t i = 0; i < device_list.size(); ++i) {
+      device_list[i]->Sample(&next_list[i]);
+      UpdateProcessUsage(
+          *device_list[i], prev_list[i], next_list[i],
+          GetDeviceProcesses(device_list[i]->GetDevice()),
+          &usage_list[i]);
+      PrintTopLines(
+          i, (next_list[i].timestamp - start) / 1000000,
+          usage_list[i], process_count, &name_cache);
+    }
+    name_cache.Prune();
+    prev_list.swap(next_list);
+  }
+
+  for (auto device : device_list) {
+    delete device;
+  }
+}
+
+// Label values may come from process command lines
+static std::string EscapeLabel(const std::string& value) {
+  std::string escaped;
+  for (char symbol : value) {
+    if (symbol == '\\' || symbol == '"') {
+      escaped += '\\';
+      escaped += symbol;
+    } else if (symbol == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += symbol;
+    }
+  }
+  return escaped;
+}
+
+static std::string GetMetricLabels(
+    uint32_t device_id, bool on_subdevice, uint32_t subdevice_id) {
+  std::string labels = "gpu=\"" + std::to_string(device_id) + "\"";
+  if (on_subdevice) {
+    labels += ",subdevice=\"" + std::to_string(subdevice_id) + "\"";
+  }
+  return labels;
+}
+
+static std::string GetPowerLabels(
+    uint32_t device_id, uint32_t domain_id, const SysmanPower& power) {
+  return GetMetricLabels(device_id, power.on_subdevice, power.subdevice_id) +
+    ",domain=\"" + std::to_string(domain_id) + "\"";
+}
+
+static std::string GetProcessLabels(
+    uint32_t device_id, const zes_process_state_t& process,
+    ProcessNameCache* name_cache) {
+  PTI_ASSERT(name_cache != nullptr);
+  return GetMetricLabels(device_id, false, 0) +
+    ",pid=\"" + std::to_string(process.processId) + "\"" +
+    ",name=\"" + EscapeLabel(name_cache->Get(process.processId)) + "\"";
+}
+
+static void AddMetricHeader(
+    std::stringstream& page, const std::string& name,
+    const std::string& type, const std::string& help) {
+  page << "# HELP " << name << " " << help << "\n";
+  page << "# TYPE " << name << " " << type << "\n";
+}
+
+static void AddMetric(
+    std::stringstream& page, const std::string& name,
+    const std::string& labels, double value) {
+  if (value >= 0) {
+    page << name << "{" << labels << "} " << value << "\n";
+  }
+}
+
+// Metrics of unavailable queries are omitted rather than reported as zero
+static std::string GetMetricsPage(
+    const std::vector<SysmanDevice*>& device_list,
+    const std::vector<SysmanSample>& prev_list,
+    const std::vector<SysmanSample>& next_list,
+    const std::vector< std::vector<zes_process_state_t> >& process_list,
+    ProcessNameCache* name_cache) {
+  PTI_ASSERT(device_list.size() == prev_list.size());
+  PTI_ASSERT(device_list.size() == next_list.size());
+  PTI_ASSERT(device_list.size() == process_list.size());
+  std::stringstream page;
+  page.precision(std::numeric_limits<double>::digits10);
+
+  AddMetricHeader(page, "pti_gpu_frequency_mhz", "gauge",
+                  "Actual GPU frequency");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    AddMetric(page, "pti_gpu_frequency_mhz",
+              GetMetricLabels(i, false, 0), next_list[i].frequency);
+  }
+
+  AddMetricHeader(page, "pti_gpu_throttle_reasons", "gauge",
+                  "Frequency throttle reason flags");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    if (next_list[i].frequency >= 0) {
+      AddMetric(page, "pti_gpu_throttle_reasons",
+                GetMetricLabels(i, false, 0),
+                next_list[i].throttle_reasons);
+    }
+  }
+
+  AddMetricHeader(page, "pti_gpu_temperature_celsius", "gauge",
+                  "GPU core temperature");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    AddMetric(page, "pti_gpu_temperature_celsius",
+              GetMetricLabels(i, false, 0), next_list[i].temperature);
+  }
+
+  AddMetricHeader(page, "pti_gpu_memory_size_bytes", "gauge",
+                  "Device memory size");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    if (next_list[i].memory_size > 0) {
+      AddMetric(page, "pti_gpu_memory_size_bytes",
+                GetMetricLabels(i, false, 0), next_list[i].memory_size);
+    }
+  }
+
+  AddMetricHeader(page, "pti_gpu_memory_used_bytes", "gauge",
+                  "Device memory in use");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    const SysmanSample& sample = next_list[i];
+    if (sample.memory_size > 0) {
+      AddMetric(page, "pti_gpu_memory_used_bytes",
+                GetMetricLabels(i, false, 0),
+                sample.memory_size - sample.memory_free);
+    }
+  }
+
+  AddMetricHeader(page, "pti_gpu_energy_joules_total", "counter",
+                  "Energy consumed by the power domain");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    const std::vector<SysmanPower>& power_list =
+      device_list[i]->GetPowerList();
+    for (size_t j = 0; j < power_list.size(); ++j) {
+      const zes_power_energy_counter_t& energy = next_list[i].energy_list[j];
+      if (energy.timestamp > 0) {
+        AddMetric(page, "pti_gpu_energy_joules_total",
+                  GetPowerLabels(i, j, power_list[j]),
+                  energy.energy / 1000000.0);
+      }
+    }
+  }
+
+  AddMetricHeader(page, "pti_gpu_power_watts", "gauge",
+                  "Average power over the last sampling interval");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    const std::vector<SysmanPower>& power_list =
+      device_list[i]->GetPowerList();
+    for (size_t j = 0; j < power_list.size(); ++j) {
+      AddMetric(page, "pti_gpu_power_watts",
+                GetPowerLabels(i, j, power_list[j]),
+                SysmanDevice::GetPower(prev_list[i].energy_list[j],
+                                       next_list[i].energy_list[j]));
+    }
+  }
+
+  AddMetricHeader(page, "pti_gpu_engine_busy_percent", "gauge",
+                  "Engine group utilization over the last sampling interval");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    const std::vector<SysmanEngine>& engine_list =
+      device_list[i]->GetEngineList();
+    for (size_t j = 0; j < engine_list.size(); ++j) {
+      std::string labels = GetMetricLabels(
+          i, engine_list[j].on_subdevice, engine_list[j].subdevice_id) +
+        ",engine=\"" + SysmanDevice::GetEngineName(engine_list[j].type) +
+        "\",index=\"" + std::to_string(j) + "\"";
+      AddMetric(page, "pti_gpu_engine_busy_percent", labels,
+                SysmanDevice::GetBusy(prev_list[i].engine_list[j],
+                                      next_list[i].engine_list[j]));
+    }
+  }
+
+  AddMetricHeader(page, "pti_gpu_process_memory_bytes", "gauge",
+                  "Device memory allocated by the process");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    for (auto& process : process_list[i]) {
+      AddMetric(page, "pti_gpu_process_memory_bytes",
+                GetProcessLabels(i, process, name_cache), process.memSize);
+    }
+  }
+
+  AddMetricHeader(page, "pti_gpu_process_shared_memory_bytes", "gauge",
+                  "Shared memory allocated by the process");
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    for (auto& process : process_list[i]) {
+      AddMetric(page, "pti_gpu_process_shared_memory_bytes",
+                GetProcessLabels(i, process, name_cache),
+                process.sharedSize);
+    }
+  }
+  name_cache->Prune();
+
+  return page.str();
+}
+
+// The page is rebuilt once per interval, scrapes only copy it out
+static void Export(uint16_t port, uint32_t interval) {
+  std::vector<SysmanDevice*> device_list;
+  for (auto driver : utils::ze::GetDriverList()) {
+    for (auto device : utils::ze::GetDeviceList(driver)) {
+      device_list.push_back(new SysmanDevice(device));
+    }
+  }
+
+  if (device_list.empty()) {
+    std::cerr << "[WARNING] No devices found" << std::endl;
+    return;
+  }
+
+  MetricsServer* server = MetricsServer::Create(port);
+  if (server == nullptr) {
+    for (auto device : device_list) {
+      delete device;
+    }
+    return;
+  }
+
+  signal(SIGINT, Stop);
+  signal(SIGTERM, Stop);
+
+  std::vector<SysmanSample> prev_list(device_list.size());
+  std::vector<SysmanSample> next_list(device_list.size());
+  std::vector< std::vector<zes_process_state_t> > process_list(
+      device_list.size());
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    device_list[i]->Sample(&prev_list[i]);
+  }
+
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    process_list[i] = GetDeviceProcesses(device_list[i]->GetDevice());
+  }
+  ProcessNameCache name_cache;
+  server->SetPage(GetMetricsPage(
+      device_list, prev_list, prev_list, process_list, &name_cache));
+  std::cerr << "[INFO] Serving metrics on port " << port << std::endl;
+
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::now();
+  while (!stop.load(std::memory_order_acquire)) {
+    deadline += std::chrono::milliseconds(interval);
+    std::this_thread::sleep_until(deadline);
+
+    for (size_t i = 0; i < device_list.size(); ++i) {
+      device_list[i]->Sample(&next_list[i]);
+      process_list[i] = GetDeviceProcesses(device_list[i]->GetDevice());
+    }
+    server->SetPage(GetMetricsPage(
+        device_list, prev_list, next_list, process_list, &name_cache));
+    prev_list.swap(next_list);
+  }
+
+  delete server;
+  for (auto device : device_list) {
+    delete device;
+  }
+}
+
 int main(int argc, char* argv[]) {
   Mode mode = MODE_PROCESSES;
+  uint32_t interval = 0;
+  uint32_t count = 0;
+  uint32_t port = 0;
+  uint32_t process_count = 0;
   ze_result_t status = ZE_RESULT_SUCCESS;
 
   if (argc > 1) {
@@ -1208,6 +2012,59 @@ int main(int argc, char* argv[]) {
     } else if (std::string(argv[1]) == "--details" ||
                std::string(argv[1]) == "-d") {
       mode = MODE_DETAILS;
+      interval = DEFAULT_DETAILS_INTERVAL;
+      if (argc > 2) {
+        interval = strtoul(argv[2], nullptr, 10);
+      }
+      if (interval == 0 || interval > MAX_WATCH_INTERVAL) {
+        std::cout << "[ERROR] Invalid details interval" << std::endl;
+        Usage();
+        return 0;
+      }
+    } else if ((std::string(argv[1]) == "--watch" ||
+                std::string(argv[1]) == "-w") && argc > 2) {
+      mode = MODE_WATCH;
+      interval = strtoul(argv[2], nullptr, 10);
+      if (argc > 3) {
+        count = strtoul(argv[3], nullptr, 10);
+      }
+      if (interval == 0 || interval > MAX_WATCH_INTERVAL) {
+        std::cout << "[ERROR] Invalid watch interval" << std::endl;
+        Usage();
+        return 0;
+      }
+    } else if ((std::string(argv[1]) == "--top" ||
+                std::string(argv[1]) == "-t") && argc > 2) {
+      mode = MODE_TOP;
+      interval = strtoul(argv[2], nullptr, 10);
+      if (argc > 3) {
+        count = strtoul(argv[3], nullptr, 10);
+      }
+      process_count = DEFAULT_TOP_PROCESS_COUNT;
+      if (argc > 4) {
+        process_count = strtoul(argv[4], nullptr, 10);
+      }
+      if (interval == 0 || interval > MAX_WATCH_INTERVAL ||
+          process_count == 0) {
+        std::cout << "[ERROR] Invalid top interval or process count" <<
+          std::endl;
+        Usage();
+        return 0;
+      }
+    } else if ((std::string(argv[1]) == "--exporter" ||
+                std::string(argv[1]) == "-e") && argc > 2) {
+      mode = MODE_EXPORTER;
+      port = strtoul(argv[2], nullptr, 10);
+      interval = DEFAULT_EXPORTER_INTERVAL;
+      if (argc > 3) {
+        interval = strtoul(argv[3], nullptr, 10);
+      }
+      if (port == 0 || port > UINT16_MAX ||
+          interval == 0 || interval > MAX_WATCH_INTERVAL) {
+        std::cout << "[ERROR] Invalid exporter port or interval" << std::endl;
+        Usage();
+        return 0;
+      }
     } else if (std::string(argv[1]) == "--version") {
 #ifdef PTI_VERSION
       std::cout << TOSTRING(PTI_VERSION) << std::endl;
@@ -1228,22 +2085,33 @@ int main(int argc, char* argv[]) {
       PrintDeviceList();
       break;
     }
-    case MODE_DETAILS:
+    case MODE_DETAILS: {
+      Details(interval);
+      break;
+    }
     case MODE_PROCESSES: {
       uint32_t device_id = 0;
       for (auto driver : utils::ze::GetDriverList()) {
         for (auto device : utils::ze::GetDeviceList(driver)) {
-          if(mode == MODE_PROCESSES) {
-            PrintShorInfo(driver, device, device_id);
-            PrintProcesses(device);
-          } else {
-            PrintDetails(driver, device, device_id);
-          }
+          PrintShorInfo(driver, device, device_id);
+          PrintProcesses(device);
           ++device_id;
         }
       }
       break;
     }
+    case MODE_WATCH: {
+      Watch(interval, count);
+      break;
+    }
+    case MODE_TOP: {
+      Top(interval, count, process_count);
+      break;
+    }
+    case MODE_EXPORTER: {
+      Export(static_cast<uint16_t>(port), interval);
+      break;
+    }
     default:
       break;
   }
@@ -0,0 +1,158 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_SYSMON_METRICS_SERVER_H_
+#define PTI_TOOLS_SYSMON_METRICS_SERVER_H_
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "pti_assert.h"
+
+#define METRICS_PATH "/metrics"
+#define METRICS_CONTENT_TYPE "text/plain; version=0.0.4"
+#define METRICS_POLL_TIMEOUT 100 // ms
+#define METRICS_IO_TIMEOUT 1 // s
+#define METRICS_REQUEST_SIZE 4096
+
+// Minimal HTTP server for Prometheus scrapes. The page is prepared by the
+// sampling loop and only copied to the socket on a request, so a scrape
+// never touches the device
+class MetricsServer {
+ public: // Interface
+  // Returns nullptr if the port can't be listened
+  static MetricsServer* Create(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      std::cerr << "[ERROR] Unable to create socket" << std::endl;
+      return nullptr;
+    }
+
+    int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+      std::cerr << "[ERROR] Unable to listen port " << port << std::endl;
+      close(fd);
+      return nullptr;
+    }
+
+    MetricsServer* server = new MetricsServer(fd);
+    PTI_ASSERT(server != nullptr);
+    return server;
+  }
+
+  ~MetricsServer() {
+    stop_.store(true, std::memory_order_release);
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    close(fd_);
+  }
+
+  void SetPage(std::string page) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    page_.swap(page);
+  }
+
+  MetricsServer(const MetricsServer& copy) = delete;
+  MetricsServer& operator=(const MetricsServer& copy) = delete;
+
+ private: // Implementation
+  explicit MetricsServer(int fd) : fd_(fd) {
+    thread_ = std::thread(&MetricsServer::Serve, this);
+  }
+
+  void Serve() {
+    pollfd listener{fd_, POLLIN, 0};
+    while (!stop_.load(std::memory_order_acquire)) {
+      listener.revents = 0;
+      if (poll(&listener, 1, METRICS_POLL_TIMEOUT) <= 0) {
+        continue;
+      }
+
+      int client = accept(fd_, nullptr, nullptr);
+      if (client < 0) {
+        continue;
+      }
+
+      // Slow or stalled clients must not block the next scrape forever
+      timeval timeout{METRICS_IO_TIMEOUT, 0};
+      setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+      setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+      Respond(client);
+      close(client);
+    }
+  }
+
+  void Respond(int client) {
+    char request[METRICS_REQUEST_SIZE];
+    ssize_t size = recv(client, request, sizeof(request) - 1, 0);
+    if (size <= 0) {
+      return;
+    }
+    request[size] = '\0';
+
+    std::string line(request, strcspn(request, "\r\n"));
+    std::string path;
+    if (line.compare(0, 4, "GET ") == 0) {
+      path = line.substr(4, line.find(' ', 4) - 4);
+    }
+
+    if (path != METRICS_PATH && path != "/") {
+      Send(client, "HTTP/1.1 404 Not Found\r\n"
+           "Content-Length: 0\r\nConnection: close\r\n\r\n");
+      return;
+    }
+
+    std::string response;
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      response = "HTTP/1.1 200 OK\r\n"
+        "Content-Type: " METRICS_CONTENT_TYPE "\r\n"
+        "Content-Length: " + std::to_string(page_.size()) + "\r\n"
+        "Connection: close\r\n\r\n" + page_;
+    }
+    Send(client, response);
+  }
+
+  static void Send(int client, const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+      ssize_t size = send(client, data.data() + offset,
+                          data.size() - offset, MSG_NOSIGNAL);
+      if (size <= 0) {
+        return;
+      }
+      offset += size;
+    }
+  }
+
+ private: // Data
+  int fd_ = -1;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+  std::mutex lock_;
+  std::string page_;
+};
+
+#endif // PTI_TOOLS_SYSMON_METRICS_SERVER_H_
\ No newline at end of file
@@ -0,0 +1,255 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "trace_analyzer.h"
+#include "utils.h"
+
+#define NSEC_IN_USEC 1000
+
+struct AnalyzerOptions {
+  std::vector<std::string> filename_list;
+  std::vector<std::string> diff_filename_list; // Files after --diff
+  std::string output;
+  uint32_t top = 0;
+  bool by_p99 = false;
+  uint64_t window = 0; // ns
+  uint32_t thread_count = 0;
+};
+
+static void Usage() {
+  std::cout <<
+    "Usage: ./trace_analyzer [options] <trace.bin> [<trace.bin> ...] " <<
+    "[--diff <trace.bin> [<trace.bin> ...]]" <<
+    std::endl;
+  std::cout << "Options:" << std::endl;
+  std::cout <<
+    "--top <N>                   " <<
+    "Report N kernels and functions only (all by default)" <<
+    std::endl;
+  std::cout <<
+    "--sort <total|p99>          " <<
+    "Pick the top entries by total time or by P99 (total by default)" <<
+    std::endl;
+  std::cout <<
+    "--window <us>               " <<
+    "Report statistics of time windows of the given length" <<
+    std::endl;
+  std::cout <<
+    "--diff <trace.bin> ...      " <<
+    "Compare the traces before the option against the traces after it" <<
+    std::endl;
+  std::cout <<
+    "--threads <N>               " <<
+    "Number of threads (one per hardware thread by default)" <<
+    std::endl;
+  std::cout <<
+    "--output [-o] <filename>    " <<
+    "Print the report into a file instead of stdout" <<
+    std::endl;
+  std::cout <<
+    "--help [-h]                 " <<
+    "Print help message" <<
+    std::endl;
+  std::cout <<
+    "--version                   " <<
+    "Print version" <<
+    std::endl;
+  std::cout <<
+    "Summarizes binary traces of --binary-trace option of " <<
+    "onetrace/ze_tracer/cl_tracer, several traces of one run " <<
+    "(e.g. MPI ranks) are merged" << std::endl;
+}
+
+// Returns 1 if the command line is invalid, -1 if nothing is to be done
+static int ParseArgs(int argc, char* argv[], AnalyzerOptions* options) {
+  bool diff = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string option = argv[i];
+    if (option == "--help" || option == "-h") {
+      Usage();
+      return -1;
+    } else if (option == "--version") {
+#ifdef PTI_VERSION
+      std::cout << TOSTRING(PTI_VERSION) << std::endl;
+#endif
+      return -1;
+    } else if (option == "--top" && i + 1 < argc) {
+      options->top = std::stoul(argv[++i]);
+    } else if (option == "--sort" && i + 1 < argc) {
+      std::string key = argv[++i];
+      if (key != "total" && key != "p99") {
+        return 1;
+      }
+      options->by_p99 = (key == "p99");
+    } else if (option == "--window" && i + 1 < argc) {
+      options->window = std::stoull(argv[++i]) * NSEC_IN_USEC;
+      if (options->window == 0) {
+        return 1;
+      }
+    } else if (option == "--threads" && i + 1 < argc) {
+      options->thread_count = std::stoul(argv[++i]);
+    } else if ((option == "--output" || option == "-o") && i + 1 < argc) {
+      options->output = argv[++i];
+    } else if (option == "--diff" && !diff) {
+      diff = true;
+    } else if (option.size() > 1 && option[0] == '-') {
+      return 1;
+    } else if (diff) {
+      options->diff_filename_list.push_back(option);
+    } else {
+      options->filename_list.push_back(option);
+    }
+  }
+
+  if (options->filename_list.empty() ||
+      (diff && options->diff_filename_list.empty())) {
+    return 1;
+  }
+  return 0;
+}
+
+static void ReportTraces(const TraceSummary& summary,
+                         const std::string& title, std::ostream& stream) {
+  stream << std::endl;
+  stream << "=== " << title << ": ===" << std::endl;
+  stream << std::endl;
+  TraceAnalyzer::PrintTraceList(summary, stream);
+}
+
+static void ReportTiming(const KernelInfoMap& info_map,
+                         const AnalyzerOptions& options,
+                         const std::string& title,
+                         const std::string& column, std::ostream& stream) {
+  if (info_map.empty()) {
+    return;
+  }
+
+  std::string total = "Total " + title + " Time (ns): ";
+  stream << std::endl;
+  stream << "=== " << title << " Timing Results: ===" << std::endl;
+  stream << std::endl;
+  stream << total << std::setw(20) <<
+    TraceAnalyzer::GetTotalTime(info_map) << std::endl;
+  stream << std::endl;
+  KernelStatistics::PrintTable(
+      TraceAnalyzer::SelectTop(info_map, options.top, options.by_p99),
+      stream, column, TraceAnalyzer::GetTotalTime(info_map),
+      options.by_p99);
+}
+
+static void ReportQueues(const TraceSummary& summary,
+                         std::ostream& stream) {
+  if (summary.queue_map.empty()) {
+    return;
+  }
+
+  stream << std::endl;
+  stream << "=== Queue Timing Results: ===" << std::endl;
+  stream << std::endl;
+  TraceAnalyzer::PrintQueuesTable(summary, stream);
+}
+
+static void ReportWindows(const TraceSummary& summary,
+                          const AnalyzerOptions& options,
+                          std::ostream& stream) {
+  if (options.window == 0 || summary.window_map.empty()) {
+    return;
+  }
+
+  stream << std::endl;
+  stream << "=== Time Window Results: ===" << std::endl;
+  stream << std::endl;
+  TraceAnalyzer::PrintWindowsTable(summary, options.window, stream);
+}
+
+static void ReportDiff(const KernelInfoMap& base_map,
+                       const KernelInfoMap& info_map,
+                       const AnalyzerOptions& options,
+                       const std::string& title,
+                       const std::string& column, std::ostream& stream) {
+  if (base_map.empty() && info_map.empty()) {
+    return;
+  }
+
+  stream << std::endl;
+  stream << "=== " << title << " Timing Diff (B - A): ===" << std::endl;
+  stream << std::endl;
+  stream << "Total " << title << " Time A (ns): " << std::setw(20) <<
+    TraceAnalyzer::GetTotalTime(base_map) << std::endl;
+  stream << "Total " << title << " Time B (ns): " << std::setw(20) <<
+    TraceAnalyzer::GetTotalTime(info_map) << std::endl;
+  stream << std::endl;
+  TraceAnalyzer::PrintDiffTable(
+      base_map, info_map, options.top, column, stream);
+}
+
+int main(int argc, char* argv[]) {
+  AnalyzerOptions options;
+  int status = ParseArgs(argc, argv, &options);
+  if (status < 0) {
+    return 0;
+  }
+  if (status > 0) {
+    std::cout << "[ERROR] Invalid command line" << std::endl;
+    Usage();
+    return 0;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  TraceAnalyzer analyzer(options.window, options.thread_count);
+  TraceSummary summary;
+  if (!analyzer.Analyze(options.filename_list, &summary)) {
+    return 0;
+  }
+  TraceSummary diff_summary;
+  bool diff = !options.diff_filename_list.empty();
+  if (diff && !analyzer.Analyze(options.diff_filename_list, &diff_summary)) {
+    return 0;
+  }
+  auto end = std::chrono::steady_clock::now();
+  uint64_t time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      end - start).count();
+
+  std::stringstream stream;
+  if (diff) {
+    ReportTraces(summary, "Traces A", stream);
+    ReportTraces(diff_summary, "Traces B", stream);
+    ReportDiff(summary.kernel_map, diff_summary.kernel_map, options,
+               "Device", "Kernel", stream);
+    ReportDiff(summary.function_map, diff_summary.function_map, options,
+               "API", "Function", stream);
+  } else {
+    ReportTraces(summary, "Traces", stream);
+    ReportTiming(summary.function_map, options, "API", "Function", stream);
+    ReportTiming(summary.kernel_map, options, "Device", "Kernel", stream);
+    ReportQueues(summary, stream);
+    ReportWindows(summary, options, stream);
+  }
+
+  if (options.output.empty()) {
+    std::cout << stream.str();
+  } else {
+    std::ofstream file(options.output);
+    if (!file.is_open()) {
+      std::cerr << "[ERROR] Unable to create " << options.output << std::endl;
+      return 0;
+    }
+    file << stream.str();
+  }
+
+  std::cerr << "[INFO] " << summary.record_count + diff_summary.record_count <<
+    " records were analyzed in " << time << " ms with " <<
+    analyzer.GetThreadCount() << " threads" << std::endl;
+  return 0;
+}
@@ -0,0 +1,524 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_TRACE_ANALYZER_TRACE_ANALYZER_H_
+#define PTI_TOOLS_TRACE_ANALYZER_TRACE_ANALYZER_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binary_trace.h"
+#include "kernel_sampler.h"
+#include "kernel_statistics.h"
+#include "latency_histogram.h"
+#include "pti_assert.h"
+#include "queue_timing.h"
+#include "string_table.h"
+#include "trace_index.h"
+#include "work_stealing_pool.h"
+
+struct AnalyzerQueueInfo {
+  uint64_t command_count = 0;
+  uint64_t first_start = 0;
+  uint64_t last_end = 0;
+  uint64_t busy_time = 0;
+  uint64_t total_latency = 0;
+  uint64_t min_latency = 0;
+  uint64_t max_latency = 0;
+  LatencyHistogram latency_histogram; // Submission to start
+};
+
+struct AnalyzerWindowInfo {
+  uint64_t kernel_count = 0; // Kernels started in the window
+  uint64_t device_time = 0;  // Kernel time within the window, all queues
+  uint64_t call_count = 0;
+  uint64_t host_time = 0;
+};
+
+// Trace index in the run and the queue handle of its process
+using AnalyzerQueueKey = std::pair<uint32_t, uint64_t>;
+using AnalyzerQueueMap = std::map<AnalyzerQueueKey, AnalyzerQueueInfo>;
+using AnalyzerWindowMap = std::map<uint64_t, AnalyzerWindowInfo>;
+
+// Merged results of all the traces of one run. Kernel and function maps
+// are keyed by StringTable IDs
+struct TraceSummary {
+  std::vector<TraceIndex*> trace_list; // Owned by TraceAnalyzer
+  std::vector<uint64_t> offset_list;   // Trace start against the run start
+  KernelInfoMap kernel_map;
+  KernelInfoMap function_map;
+  AnalyzerQueueMap queue_map;
+  AnalyzerWindowMap window_map;
+  uint64_t record_count = 0;
+};
+
+// Summarizes binary traces: the traces are mapped and indexed, then their
+// chunks are aggregated in parallel into per-kernel, per-function,
+// per-queue and (optionally) per-time-window statistics and merged. The
+// tables follow the layout of the tracers' reports
+class TraceAnalyzer {
+ public: // Interface
+  // Window is in ns, zero disables time windows
+  TraceAnalyzer(uint64_t window, uint32_t thread_count)
+      : window_(window), pool_(thread_count) {}
+
+  ~TraceAnalyzer() {
+    for (TraceIndex* index : index_list_) {
+      delete index;
+    }
+  }
+
+  uint32_t GetThreadCount() const {
+    return pool_.GetThreadCount();
+  }
+
+  // Traces of a run (e.g. MPI ranks) are merged in one summary
+  bool Analyze(const std::vector<std::string>& filename_list,
+               TraceSummary* summary) {
+    PTI_ASSERT(summary != nullptr);
+    PTI_ASSERT(!filename_list.empty());
+
+    std::vector<TraceIndex*> trace_list(filename_list.size(), nullptr);
+    std::vector<std::function<void()> > task_list;
+    for (size_t i = 0; i < filename_list.size(); ++i) {
+      task_list.push_back([&filename_list, &trace_list, i]() {
+        trace_list[i] = TraceIndex::Create(filename_list[i]);
+      });
+    }
+    pool_.Run(task_list);
+
+    bool success = true;
+    for (TraceIndex* index : trace_list) {
+      if (index == nullptr) {
+        success = false;
+      } else {
+        index_list_.push_back(index);
+      }
+    }
+    if (!success) {
+      return false;
+    }
+
+    summary->trace_list = trace_list;
+    summary->offset_list = GetOffsetList(trace_list);
+
+    std::mutex lock;
+    task_list.clear();
+    for (uint32_t i = 0; i < trace_list.size(); ++i) {
+      for (const TraceChunk& chunk : trace_list[i]->GetChunkList()) {
+        task_list.push_back([this, summary, &lock, i, chunk]() {
+          ChunkResult result;
+          ProcessChunk(*summary->trace_list[i], chunk,
+                       summary->offset_list[i], &result);
+          const std::lock_guard<std::mutex> guard(lock);
+          Merge(*summary->trace_list[i], i, result, summary);
+        });
+      }
+    }
+    pool_.Run(task_list);
+
+    for (TraceIndex* index : trace_list) {
+      summary->record_count += index->GetRecordCount();
+    }
+    return true;
+  }
+
+  static uint64_t GetTotalTime(const KernelInfoMap& info_map) {
+    uint64_t total_time = 0;
+    for (auto& value : info_map) {
+      total_time += value.second.total_time;
+    }
+    return total_time;
+  }
+
+  // Zero count keeps all the entries
+  static KernelInfoMap SelectTop(
+      const KernelInfoMap& info_map, uint32_t count, bool by_p99) {
+    if (count == 0 || info_map.size() <= count) {
+      return info_map;
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t> > key_list;
+    for (auto& value : info_map) {
+      uint64_t key = by_p99 ?
+        KernelStatistics::GetP99(value.second) : value.second.total_time;
+      key_list.emplace_back(key, value.first);
+    }
+    std::partial_sort(key_list.begin(), key_list.begin() + count,
+                      key_list.end(),
+                      std::greater<std::pair<uint64_t, uint32_t> >());
+
+    KernelInfoMap top_map;
+    for (uint32_t i = 0; i < count; ++i) {
+      top_map.emplace(key_list[i].second, info_map.at(key_list[i].second));
+    }
+    return top_map;
+  }
+
+  static void PrintTraceList(
+      const TraceSummary& summary, std::ostream& stream) {
+    for (size_t i = 0; i < summary.trace_list.size(); ++i) {
+      const TraceIndex* index = summary.trace_list[i];
+      stream << "Trace " << index->GetFilename() << " (" <<
+        index->GetProcessName() << ", " << index->GetPid();
+      if (index->GetRank() != kBinaryNoRank) {
+        stream << ", rank " << index->GetRank();
+      }
+      stream << "): " << index->GetRecordCount() << " records, " <<
+        "start offset " << summary.offset_list[i] << " ns, span " <<
+        index->GetEndTime() - index->GetStartTime() << " ns" << std::endl;
+    }
+  }
+
+  static void PrintQueuesTable(
+      const TraceSummary& summary, std::ostream& stream) {
+    if (summary.queue_map.empty()) {
+      return;
+    }
+
+    bool several = summary.trace_list.size() > 1;
+    stream << std::setw(kQueueLength) << "Queue" << "," <<
+      std::setw(kCountLength) << "Commands" << "," <<
+      std::setw(kTimeLength) << "Span (ns)" << "," <<
+      std::setw(kTimeLength) << "Busy (ns)" << "," <<
+      std::setw(kPercentLength) << "Busy (%)" << "," <<
+      std::setw(kTimeLength) << "Latency Avg (ns)" << "," <<
+      std::setw(kTimeLength) << "Latency P50 (ns)" << "," <<
+      std::setw(kTimeLength) << "Latency P99 (ns)" << "," <<
+      std::setw(kTimeLength) << "Latency Max (ns)" << std::endl;
+
+    for (auto& value : summary.queue_map) {
+      const AnalyzerQueueInfo& info = value.second;
+      uint64_t span = info.last_end - info.first_start;
+      float busy_percent = (span > 0) ?
+        100.0f * info.busy_time / span : 100.0f;
+
+      // Queue handles are unique within a process only
+      std::stringstream queue;
+      if (several) {
+        queue << summary.trace_list[value.first.first]->GetPid() << ":";
+      }
+      queue << "0x" << std::hex << value.first.second;
+      stream << std::setw(kQueueLength) << queue.str() << "," <<
+        std::setw(kCountLength) << info.command_count << "," <<
+        std::setw(kTimeLength) << span << "," <<
+        std::setw(kTimeLength) << info.busy_time << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << busy_percent << "," <<
+        std::setw(kTimeLength) <<
+          info.total_latency / info.command_count << "," <<
+        std::setw(kTimeLength) << info.latency_histogram.GetPercentile(
+            50.0, info.min_latency, info.max_latency) << "," <<
+        std::setw(kTimeLength) << info.latency_histogram.GetPercentile(
+            99.0, info.min_latency, info.max_latency) << "," <<
+        std::setw(kTimeLength) << info.max_latency << std::endl;
+    }
+  }
+
+  // Device time is summed over the queues, so several busy queues give
+  // more than 100%
+  static void PrintWindowsTable(
+      const TraceSummary& summary, uint64_t window, std::ostream& stream) {
+    if (summary.window_map.empty() || window == 0) {
+      return;
+    }
+
+    stream << std::setw(kTimeLength) << "Window (ns)" << "," <<
+      std::setw(kCountLength) << "Kernels" << "," <<
+      std::setw(kTimeLength) << "Device (ns)" << "," <<
+      std::setw(kPercentLength) << "Device (%)" << "," <<
+      std::setw(kCountLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Host (ns)" << std::endl;
+
+    for (auto& value : summary.window_map) {
+      const AnalyzerWindowInfo& info = value.second;
+      stream << std::setw(kTimeLength) << value.first * window << "," <<
+        std::setw(kCountLength) << info.kernel_count << "," <<
+        std::setw(kTimeLength) << info.device_time << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << 100.0f * info.device_time / window << "," <<
+        std::setw(kCountLength) << info.call_count << "," <<
+        std::setw(kTimeLength) << info.host_time << std::endl;
+    }
+  }
+
+  // Rows are ordered by the absolute change of the total time, names
+  // missed in one of the runs have zero time there
+  static void PrintDiffTable(
+      const KernelInfoMap& base_map, const KernelInfoMap& info_map,
+      uint32_t count, const std::string& title, std::ostream& stream) {
+    static const KernelInfo empty{};
+
+    std::map<uint32_t, std::pair<const KernelInfo*, const KernelInfo*> >
+      pair_map;
+    for (auto& value : base_map) {
+      pair_map[value.first] = std::make_pair(&value.second, &empty);
+    }
+    for (auto& value : info_map) {
+      auto it = pair_map.find(value.first);
+      if (it == pair_map.end()) {
+        pair_map[value.first] = std::make_pair(&empty, &value.second);
+      } else {
+        it->second.second = &value.second;
+      }
+    }
+    if (pair_map.empty()) {
+      return;
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t> > key_list;
+    size_t max_name_length = kNameLength;
+    for (auto& value : pair_map) {
+      uint64_t base = value.second.first->total_time;
+      uint64_t time = value.second.second->total_time;
+      key_list.emplace_back(
+          (time > base) ? time - base : base - time, value.first);
+      max_name_length =
+        (std::max)(max_name_length, StringTable::Get(value.first).size());
+    }
+    std::sort(key_list.begin(), key_list.end(),
+              std::greater<std::pair<uint64_t, uint32_t> >());
+    if (count > 0 && key_list.size() > count) {
+      key_list.resize(count);
+    }
+
+    stream << std::setw(max_name_length) << title << "," <<
+      std::setw(kCountLength) << "Calls (A)" << "," <<
+      std::setw(kCountLength) << "Calls (B)" << "," <<
+      std::setw(kTimeLength) << "Time A (ns)" << "," <<
+      std::setw(kTimeLength) << "Time B (ns)" << "," <<
+      std::setw(kTimeLength) << "Delta (ns)" << "," <<
+      std::setw(kPercentLength) << "Delta (%)" << "," <<
+      std::setw(kTimeLength) << "P99 A (ns)" << "," <<
+      std::setw(kTimeLength) << "P99 B (ns)" << std::endl;
+
+    for (auto& key : key_list) {
+      const KernelInfo& base = *pair_map[key.second].first;
+      const KernelInfo& info = *pair_map[key.second].second;
+      int64_t delta = static_cast<int64_t>(info.total_time) -
+        static_cast<int64_t>(base.total_time);
+
+      std::stringstream percent;
+      if (base.total_time > 0) {
+        percent << std::setprecision(2) << std::fixed <<
+          100.0f * delta / base.total_time;
+      } else {
+        percent << "-";
+      }
+
+      stream << std::setw(max_name_length) <<
+          StringTable::Get(key.second) << "," <<
+        std::setw(kCountLength) << base.call_count << "," <<
+        std::setw(kCountLength) << info.call_count << "," <<
+        std::setw(kTimeLength) << base.total_time << "," <<
+        std::setw(kTimeLength) << info.total_time << "," <<
+        std::setw(kTimeLength) << delta << "," <<
+        std::setw(kPercentLength) << percent.str() << "," <<
+        std::setw(kTimeLength) << ((base.call_count > 0) ?
+          KernelStatistics::GetP99(base) : 0) << "," <<
+        std::setw(kTimeLength) << ((info.call_count > 0) ?
+          KernelStatistics::GetP99(info) : 0) << std::endl;
+    }
+  }
+
+  TraceAnalyzer(const TraceAnalyzer& copy) = delete;
+  TraceAnalyzer& operator=(const TraceAnalyzer& copy) = delete;
+
+ private: // Implementation
+  // Chunk results refer to the names by the IDs local to the trace
+  struct ChunkResult {
+    KernelStatistics kernels;
+    KernelStatistics functions;
+    std::map<uint64_t, AnalyzerQueueInfo> queue_map;
+    std::map<uint64_t, BusyTimeTracker> busy_time_map;
+    AnalyzerWindowMap window_map;
+  };
+
+  // Version 2 traces keep the wall clock time of the start point, so the
+  // traces of different nodes are aligned up to clock synchronization.
+  // Older traces fall back to the monotonic start point (single node)
+  static std::vector<uint64_t> GetOffsetList(
+      const std::vector<TraceIndex*>& trace_list) {
+    bool use_epoch = true;
+    for (const TraceIndex* index : trace_list) {
+      if (index->GetEpochPoint() == 0) {
+        use_epoch = false;
+      }
+    }
+
+    std::vector<uint64_t> start_list;
+    for (const TraceIndex* index : trace_list) {
+      start_list.push_back(
+          use_epoch ? index->GetEpochPoint() : index->GetStartPoint());
+    }
+    uint64_t base = *std::min_element(start_list.begin(), start_list.end());
+
+    std::vector<uint64_t> offset_list;
+    for (uint64_t start : start_list) {
+      offset_list.push_back(start - base);
+    }
+    return offset_list;
+  }
+
+  void ProcessChunk(const TraceIndex& index, const TraceChunk& chunk,
+                    uint64_t offset, ChunkResult* result) const {
+    PTI_ASSERT(result != nullptr);
+
+    BinaryTraceRecord record{};
+    for (size_t position = chunk.begin; position < chunk.end;
+         position += TraceIndex::GetRecordSize(record)) {
+      index.ReadRecord(position, &record);
+      if (record.type != BINARY_RECORD_DEVICE &&
+          record.type != BINARY_RECORD_HOST) {
+        continue;
+      }
+
+      uint64_t ended = (std::max)(record.started, record.ended);
+      uint64_t time = ended - record.started;
+      if (record.type == BINARY_RECORD_HOST) {
+        result->functions.Add(record.name_id, time);
+        if (window_ > 0) {
+          AddWindows(record.started + offset, ended + offset, false,
+                     &result->window_map);
+        }
+        continue;
+      }
+
+      result->kernels.Add(record.name_id, time);
+      if (window_ > 0) {
+        AddWindows(record.started + offset, ended + offset, true,
+                   &result->window_map);
+      }
+
+      uint64_t latency = (record.started > record.submitted) ?
+        record.started - record.submitted : 0;
+      AnalyzerQueueInfo& queue = result->queue_map[record.queue];
+      if (queue.command_count == 0) {
+        queue.first_start = record.started;
+        queue.last_end = ended;
+        queue.min_latency = latency;
+        queue.max_latency = latency;
+      }
+      ++queue.command_count;
+      queue.first_start = (std::min)(queue.first_start, record.started);
+      queue.last_end = (std::max)(queue.last_end, ended);
+      queue.total_latency += latency;
+      queue.min_latency = (std::min)(queue.min_latency, latency);
+      queue.max_latency = (std::max)(queue.max_latency, latency);
+      queue.latency_histogram.Add(latency);
+      result->busy_time_map[record.queue].Add(record.started, ended);
+    }
+
+    // Busy time is the union of the command intervals within the chunk,
+    // commands of one queue rarely overlap across chunk bounds
+    for (auto& value : result->busy_time_map) {
+      value.second.Flush();
+      result->queue_map[value.first].busy_time = value.second.GetBusyTime();
+    }
+  }
+
+  // Record time is split between the windows it crosses
+  void AddWindows(uint64_t started, uint64_t ended, bool device,
+                  AnalyzerWindowMap* window_map) const {
+    PTI_ASSERT(window_map != nullptr);
+    PTI_ASSERT(window_ > 0);
+
+    uint64_t first = started / window_;
+    uint64_t last = (ended > started) ? (ended - 1) / window_ : first;
+    for (uint64_t i = first; i <= last; ++i) {
+      uint64_t begin = (std::max)(started, i * window_);
+      uint64_t end = (std::min)(ended, (i + 1) * window_);
+      AnalyzerWindowInfo& info = (*window_map)[i];
+      if (device) {
+        info.kernel_count += (i == first) ? 1 : 0;
+        info.device_time += end - begin;
+      } else {
+        info.call_count += (i == first) ? 1 : 0;
+        info.host_time += end - begin;
+      }
+    }
+  }
+
+  static void MergeInfo(const KernelInfo& info, KernelInfo* total) {
+    PTI_ASSERT(total != nullptr);
+    if (total->call_count == 0) {
+      *total = info;
+      return;
+    }
+    KernelStatistics::Merge(info, total);
+  }
+
+  static void MergeInfoMap(const TraceIndex& index,
+                           const KernelInfoMap& info_map,
+                           KernelInfoMap* total_map) {
+    PTI_ASSERT(total_map != nullptr);
+    for (auto& value : info_map) {
+      uint32_t id = StringTable::Add(index.GetName(value.first));
+      KernelInfo& total = (*total_map)[id];
+      MergeInfo(value.second, &total);
+      total.name_id = id;
+    }
+  }
+
+  void Merge(const TraceIndex& index, uint32_t trace_id,
+             const ChunkResult& result, TraceSummary* summary) const {
+    PTI_ASSERT(summary != nullptr);
+    KernelSampler sampler;
+    MergeInfoMap(index, result.kernels.GetInfoMap(sampler),
+                 &summary->kernel_map);
+    MergeInfoMap(index, result.functions.GetInfoMap(sampler),
+                 &summary->function_map);
+
+    for (auto& value : result.queue_map) {
+      const AnalyzerQueueInfo& info = value.second;
+      AnalyzerQueueInfo& total =
+        summary->queue_map[std::make_pair(trace_id, value.first)];
+      if (total.command_count == 0) {
+        total = info;
+        continue;
+      }
+      total.command_count += info.command_count;
+      total.first_start = (std::min)(total.first_start, info.first_start);
+      total.last_end = (std::max)(total.last_end, info.last_end);
+      total.busy_time += info.busy_time;
+      total.total_latency += info.total_latency;
+      total.min_latency = (std::min)(total.min_latency, info.min_latency);
+      total.max_latency = (std::max)(total.max_latency, info.max_latency);
+      total.latency_histogram.Merge(info.latency_histogram);
+    }
+
+    for (auto& value : result.window_map) {
+      AnalyzerWindowInfo& total = summary->window_map[value.first];
+      total.kernel_count += value.second.kernel_count;
+      total.device_time += value.second.device_time;
+      total.call_count += value.second.call_count;
+      total.host_time += value.second.host_time;
+    }
+  }
+
+ private: // Data
+  static const uint32_t kNameLength = 10;
+  static const uint32_t kQueueLength = 20;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kPercentLength = 10;
+
+  uint64_t window_ = 0;
+  WorkStealingPool pool_;
+  std::vector<TraceIndex*> index_list_;
+};
+
+#endif // PTI_TOOLS_TRACE_ANALYZER_TRACE_ANALYZER_H_
@@ -0,0 +1,246 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_TRACE_ANALYZER_TRACE_INDEX_H_
+#define PTI_TOOLS_TRACE_ANALYZER_TRACE_INDEX_H_
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "binary_trace.h"
+#include "pti_assert.h"
+#include "shm_trace_ring.h"
+
+#define TRACE_INDEX_CHUNK_SIZE (64 * 1024 * 1024)
+#define TRACE_INDEX_HEADER_V1_SIZE 32
+
+// Part of the record stream, both bounds are record offsets
+struct TraceChunk {
+  size_t begin;
+  size_t end;
+};
+
+// Read-only view of a binary trace mapped into memory. Names are stored
+// in line with variable length, so record bounds can't be found at an
+// arbitrary offset: a single pass over the record types collects the
+// names, the time range and splits the records into chunks of about
+// TRACE_INDEX_CHUNK_SIZE bytes, which can be processed in parallel then
+class TraceIndex {
+ public: // Interface
+  static TraceIndex* Create(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      std::cerr << "[ERROR] Unable to open " << filename << std::endl;
+      return nullptr;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 ||
+        static_cast<size_t>(info.st_size) < TRACE_INDEX_HEADER_V1_SIZE) {
+      std::cerr << "[ERROR] File " << filename <<
+        " is too small to be a binary trace" << std::endl;
+      close(fd);
+      return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      std::cerr << "[ERROR] Unable to map " << filename << std::endl;
+      return nullptr;
+    }
+
+    TraceIndex* index = new TraceIndex(
+        filename, static_cast<const char*>(data), size);
+    if (!index->Build()) {
+      delete index;
+      return nullptr;
+    }
+    return index;
+  }
+
+  ~TraceIndex() {
+    munmap(const_cast<char*>(data_), size_);
+  }
+
+  const std::string& GetFilename() const {
+    return filename_;
+  }
+
+  uint32_t GetVersion() const {
+    return header_.version;
+  }
+
+  uint32_t GetPid() const {
+    return header_.pid;
+  }
+
+  uint32_t GetRank() const {
+    return header_.rank;
+  }
+
+  uint64_t GetStartPoint() const {
+    return header_.start_point;
+  }
+
+  // Zero for version 1 traces
+  uint64_t GetEpochPoint() const {
+    return header_.epoch_point;
+  }
+
+  const std::string& GetProcessName() const {
+    return GetName(header_.process_name_id);
+  }
+
+  uint64_t GetRecordCount() const {
+    return record_count_;
+  }
+
+  // Time range of the records, relative to the trace start point
+  uint64_t GetStartTime() const {
+    return (record_count_ > 0) ? start_time_ : 0;
+  }
+
+  uint64_t GetEndTime() const {
+    return end_time_;
+  }
+
+  uint64_t GetSize() const {
+    return size_;
+  }
+
+  const std::vector<TraceChunk>& GetChunkList() const {
+    return chunk_list_;
+  }
+
+  // Name of the ID local to this trace, empty if it was not written
+  const std::string& GetName(uint32_t id) const {
+    static const std::string empty;
+    return (id < name_list_.size()) ? name_list_[id] : empty;
+  }
+
+  // Offset is expected to be a record bound, records are not aligned
+  void ReadRecord(size_t offset, BinaryTraceRecord* record) const {
+    PTI_ASSERT(record != nullptr);
+    PTI_ASSERT(offset + sizeof(BinaryTraceRecord) <= size_);
+    memcpy(record, data_ + offset, sizeof(BinaryTraceRecord));
+  }
+
+  // Name text follows the name record itself
+  static size_t GetRecordSize(const BinaryTraceRecord& record) {
+    if (record.type == BINARY_RECORD_STRING) {
+      return sizeof(BinaryTraceRecord) + static_cast<size_t>(record.kernel_id);
+    }
+    return sizeof(BinaryTraceRecord);
+  }
+
+  TraceIndex(const TraceIndex& copy) = delete;
+  TraceIndex& operator=(const TraceIndex& copy) = delete;
+
+ private: // Implementation
+  TraceIndex(const std::string& filename, const char* data, size_t size)
+      : filename_(filename), data_(data), size_(size) {}
+
+  bool Build() {
+    if (memcmp(data_, kNodeTraceMagic, sizeof(kNodeTraceMagic)) == 0) {
+      std::cerr << "[ERROR] File " << filename_ << " is a node trace, " <<
+        "split it with binary_trace_merger.py first" << std::endl;
+      return false;
+    }
+    if (memcmp(data_, kBinaryTraceMagic, sizeof(kBinaryTraceMagic)) != 0) {
+      std::cerr << "[ERROR] File " << filename_ <<
+        " is not a binary trace" << std::endl;
+      return false;
+    }
+
+    // Version 1 header has no rank and epoch point
+    size_t header_size = sizeof(BinaryTraceHeader);
+    memcpy(&header_, data_, TRACE_INDEX_HEADER_V1_SIZE);
+    if (header_.version == 1) {
+      header_size = TRACE_INDEX_HEADER_V1_SIZE;
+      header_.rank = kBinaryNoRank;
+      header_.epoch_point = 0;
+    } else if (header_.version == BINARY_TRACE_VERSION &&
+               size_ >= sizeof(BinaryTraceHeader)) {
+      memcpy(&header_, data_, sizeof(BinaryTraceHeader));
+    } else {
+      std::cerr << "[ERROR] Unsupported binary trace version " <<
+        header_.version << " of " << filename_ << std::endl;
+      return false;
+    }
+
+    madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+
+    size_t offset = header_size;
+    size_t chunk_begin = offset;
+    BinaryTraceRecord record{};
+    while (offset + sizeof(BinaryTraceRecord) <= size_) {
+      ReadRecord(offset, &record);
+      size_t record_size = GetRecordSize(record);
+      if (offset + record_size > size_) {
+        break;
+      }
+
+      if (record.type == BINARY_RECORD_STRING) {
+        if (record.name_id >= name_list_.size()) {
+          name_list_.resize(record.name_id + 1);
+        }
+        name_list_[record.name_id].assign(
+            data_ + offset + sizeof(BinaryTraceRecord),
+            static_cast<size_t>(record.kernel_id));
+      } else {
+        if (record.started < start_time_) {
+          start_time_ = record.started;
+        }
+        if (record.ended > end_time_) {
+          end_time_ = record.ended;
+        }
+        ++record_count_;
+      }
+
+      offset += record_size;
+      if (offset - chunk_begin >= TRACE_INDEX_CHUNK_SIZE) {
+        chunk_list_.push_back({chunk_begin, offset});
+        chunk_begin = offset;
+      }
+    }
+
+    if (offset > chunk_begin) {
+      chunk_list_.push_back({chunk_begin, offset});
+    }
+    if (offset < size_) {
+      std::cerr << "[WARNING] Trace " << filename_ << " is truncated, " <<
+        size_ - offset << " bytes at the end are skipped" << std::endl;
+    }
+
+    madvise(const_cast<char*>(data_), size_, MADV_NORMAL);
+    return true;
+  }
+
+ private: // Data
+  std::string filename_;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+
+  BinaryTraceHeader header_{};
+  std::vector<std::string> name_list_;
+  std::vector<TraceChunk> chunk_list_;
+  uint64_t record_count_ = 0;
+  uint64_t start_time_ = (std::numeric_limits<uint64_t>::max)();
+  uint64_t end_time_ = 0;
+};
+
+#endif // PTI_TOOLS_TRACE_ANALYZER_TRACE_INDEX_H_
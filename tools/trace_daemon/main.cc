@@ -0,0 +1,305 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shm_trace_ring.h"
+#include "stream_compressor.h"
+#include "utils.h"
+
+#define DEFAULT_POLL_INTERVAL 10 // ms
+#define SHM_PATH "/dev/shm"
+#define FRAME_SIZE (4 * 1024 * 1024) // Node trace bytes per compressed frame
+
+struct TraceStream {
+  ShmTraceRing* ring;
+  uint32_t index;
+};
+
+// Node trace is written as is, or compressed in frames with a seek table
+// at the end (see StreamCompressor)
+struct NodeTraceFile {
+  std::ofstream file;
+  StreamCompressor* compressor;
+  std::vector<char> frame; // Data not compressed yet
+};
+
+static std::atomic<bool> stop(false);
+
+static void Usage() {
+  std::cout <<
+    "Usage: ./trace_daemon [options]" <<
+    std::endl;
+  std::cout << "Options:" << std::endl;
+  std::cout <<
+    "--output [-o] <filename>    " <<
+    "Node trace file name (node_trace.<pid>.bin by default)" <<
+    std::endl;
+  std::cout <<
+    "--poll-interval <ms>        " <<
+    "Ring polling interval (" << DEFAULT_POLL_INTERVAL <<
+    " ms by default)" <<
+    std::endl;
+  std::cout <<
+    "--compress <method>         " <<
+    "Compress node trace in frames (zstd|lz4)" <<
+    std::endl;
+  std::cout <<
+    "--help [-h]                 " <<
+    "Print help message" <<
+    std::endl;
+  std::cout <<
+    "--version                   " <<
+    "Print version" <<
+    std::endl;
+  std::cout <<
+    "Collects binary traces of the processes run with --node-trace " <<
+    "option of onetrace/ze_tracer/cl_tracer into a single file " <<
+    "until SIGINT or SIGTERM" << std::endl;
+}
+
+static void Stop(int) {
+  stop.store(true, std::memory_order_release);
+}
+
+// Daemon PID is published for the tools to find out it runs
+static bool Register() {
+  std::string name = ShmTraceRing::GetDaemonName();
+  if (ShmTraceRing::GetDaemonPid() != 0) {
+    std::cerr << "[ERROR] Node trace daemon is already running" << std::endl;
+    return false;
+  }
+
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    std::cerr << "[ERROR] Unable to create shared memory " << name <<
+      std::endl;
+    return false;
+  }
+
+  uint32_t pid = utils::GetPid();
+  ssize_t size = write(fd, &pid, sizeof(pid));
+  close(fd);
+  if (size != sizeof(pid)) {
+    std::cerr << "[ERROR] Unable to write shared memory " << name <<
+      std::endl;
+    shm_unlink(name.c_str());
+    return false;
+  }
+  return true;
+}
+
+static void Unregister() {
+  shm_unlink(ShmTraceRing::GetDaemonName().c_str());
+}
+
+static std::vector<std::string> GetRingList() {
+  std::vector<std::string> ring_list;
+  std::string prefix = ShmTraceRing::GetRingName(0);
+  prefix = prefix.substr(1, prefix.size() - 2); // Strip '/' and PID
+
+  DIR* dir = opendir(SHM_PATH);
+  if (dir == nullptr) {
+    return ring_list;
+  }
+
+  struct dirent* entry = nullptr;
+  while ((entry = readdir(dir)) != nullptr) {
+    std::string name = entry->d_name;
+    if (name.compare(0, prefix.size(), prefix) == 0) {
+      ring_list.push_back("/" + name);
+    }
+  }
+
+  closedir(dir);
+  return ring_list;
+}
+
+static void WriteFrame(NodeTraceFile& output) {
+  PTI_ASSERT(output.compressor != nullptr);
+  if (output.frame.empty()) {
+    return;
+  }
+
+  std::vector<char> data;
+  output.compressor->AddFrame(
+      output.frame.data(), output.frame.size(), &data);
+  output.file.write(data.data(), data.size());
+  output.frame.clear();
+}
+
+static void WriteData(NodeTraceFile& output, const char* data, size_t size) {
+  if (output.compressor == nullptr) {
+    output.file.write(data, size);
+    return;
+  }
+
+  output.frame.insert(output.frame.end(), data, data + size);
+  if (output.frame.size() >= FRAME_SIZE) {
+    WriteFrame(output);
+  }
+}
+
+static void CloseFile(NodeTraceFile& output) {
+  if (output.compressor != nullptr) {
+    WriteFrame(output);
+    std::vector<char> data;
+    output.compressor->AddSeekTable(&data);
+    output.file.write(data.data(), data.size());
+    delete output.compressor;
+    output.compressor = nullptr;
+  }
+  output.file.close();
+}
+
+static void WriteChunk(
+    NodeTraceFile& output, uint32_t index, const std::vector<char>& data) {
+  NodeTraceChunk chunk{index, static_cast<uint32_t>(data.size())};
+  WriteData(output, reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+  WriteData(output, data.data(), data.size());
+}
+
+static bool IsProcessAlive(uint32_t pid) {
+  return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// Ring of a finished (or crashed) process is drained and removed
+static uint64_t Poll(
+    std::map<std::string, TraceStream>& stream_map, uint32_t& stream_count,
+    NodeTraceFile& output, bool final) {
+  for (const std::string& name : GetRingList()) {
+    if (stream_map.count(name) == 0) {
+      ShmTraceRing* ring = ShmTraceRing::Open(name);
+      if (ring != nullptr) {
+        stream_map[name] = {ring, stream_count};
+        ++stream_count;
+      }
+    }
+  }
+
+  uint64_t total_size = 0;
+  std::vector<char> data;
+  for (auto it = stream_map.begin(); it != stream_map.end();) {
+    ShmTraceRing* ring = it->second.ring;
+    bool closed = ring->IsClosed() || !IsProcessAlive(ring->GetPid());
+
+    data.clear();
+    ring->Read(&data);
+    if (!data.empty()) {
+      WriteChunk(output, it->second.index, data);
+      total_size += data.size();
+    }
+
+    if (closed || final) {
+      if (ring->GetDropped() > 0) {
+        std::cerr << "[WARNING] Process " << ring->GetPid() << " dropped " <<
+          ring->GetDropped() << " bytes of binary trace" << std::endl;
+      }
+      ring->Unlink();
+      delete ring;
+      it = stream_map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return total_size;
+}
+
+int main(int argc, char* argv[]) {
+  std::string filename =
+    "node_trace." + std::to_string(utils::GetPid()) + ".bin";
+  std::string compression;
+  uint32_t poll_interval = DEFAULT_POLL_INTERVAL;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string option = argv[i];
+    if (option == "--help" || option == "-h") {
+      Usage();
+      return 0;
+    } else if (option == "--version") {
+#ifdef PTI_VERSION
+      std::cout << TOSTRING(PTI_VERSION) << std::endl;
+#endif
+      return 0;
+    } else if ((option == "--output" || option == "-o") && i + 1 < argc) {
+      filename = argv[++i];
+    } else if (option == "--poll-interval" && i + 1 < argc) {
+      poll_interval = std::stoul(argv[++i]);
+    } else if (option == "--compress" && i + 1 < argc) {
+      compression = argv[++i];
+      if (!StreamCompressor::IsMethod(compression)) {
+        std::cout << "[ERROR] Compression method is invalid" << std::endl;
+        return 0;
+      }
+    } else {
+      std::cout << "[ERROR] Invalid command line" << std::endl;
+      Usage();
+      return 0;
+    }
+  }
+
+  NodeTraceFile output{std::ofstream(), nullptr, std::vector<char>()};
+  if (!compression.empty()) {
+    output.compressor = StreamCompressor::Create(compression);
+    if (output.compressor != nullptr) {
+      filename += output.compressor->GetFileExt();
+    }
+  }
+
+  output.file.open(filename, std::ios::out | std::ios::binary);
+  if (!output.file.is_open()) {
+    std::cerr << "[ERROR] Unable to create " << filename << std::endl;
+    return 0;
+  }
+
+  NodeTraceHeader header{};
+  memcpy(header.magic, kNodeTraceMagic, sizeof(header.magic));
+  header.version = SHM_TRACE_VERSION;
+  WriteData(output, reinterpret_cast<const char*>(&header), sizeof(header));
+
+  if (!Register()) {
+    CloseFile(output);
+    return 0;
+  }
+  signal(SIGINT, Stop);
+  signal(SIGTERM, Stop);
+
+  std::map<std::string, TraceStream> stream_map;
+  uint32_t stream_count = 0;
+  uint64_t total_size = 0;
+  while (!stop.load(std::memory_order_acquire)) {
+    uint64_t size = Poll(stream_map, stream_count, output, false);
+    total_size += size;
+    if (size == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(poll_interval));
+    }
+  }
+
+  Unregister();
+  total_size += Poll(stream_map, stream_count, output, true);
+  CloseFile(output);
+
+  std::cerr << "[INFO] Node trace (" << stream_count << " processes, " <<
+    total_size << " bytes) was stored to " << filename << std::endl;
+  return 0;
+}
@@ -0,0 +1,252 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_ALLOCATION_CHURN_H_
+#define PTI_TOOLS_UTILS_ALLOCATION_CHURN_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "callsite_cache.h"
+#include "latency_histogram.h"
+#include "memory_tracker.h"
+#include "pti_assert.h"
+#include "transfer_timing.h"
+
+#define ALLOCATION_CHURN_SHORT_LIFETIME 1000000 // ns
+#define ALLOCATION_CHURN_ENTRY_COUNT    20
+
+struct AllocationChurnInfo {
+  uint64_t alloc_count = 0;
+  uint64_t free_count = 0;
+  uint64_t alloc_time = 0; // Spent in allocation calls
+  uint64_t free_time = 0;
+  uint64_t short_count = 0; // Freed within ALLOCATION_CHURN_SHORT_LIFETIME
+  uint64_t min_lifetime = 0;
+  uint64_t max_lifetime = 0;
+  LatencyHistogram lifetime_histogram;
+  uint64_t live_count = 0;
+  uint64_t max_live_count = 0;
+};
+
+// Callsite ID, size class, memory type
+using AllocationChurnKey = std::tuple<uint32_t, uint64_t, TransferMemoryType>;
+using AllocationChurnInfoMap =
+  std::map<AllocationChurnKey, AllocationChurnInfo>;
+
+// Pairs allocation and free calls by pointer and groups them by callsite,
+// power of two size class and memory type. Lifetime is taken from the end
+// of the allocation call to the start of the free call. A pooling
+// allocator per group would call the driver only for the blocks that are
+// live at the same time (max live count), so the time of the other calls
+// is the estimated savings. Thread-safe
+class AllocationChurn {
+ public: // Interface
+  void AddAllocation(
+      const void* ptr, size_t size, TransferMemoryType type,
+      uint64_t started, uint64_t ended) {
+    if (ptr == nullptr || size == 0) {
+      return;
+    }
+    PTI_ASSERT(started <= ended);
+
+    AllocationChurnKey key =
+      std::make_tuple(callsite_cache_.Get(), GetSizeClass(size), type);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    live_map_[ptr] = std::make_pair(key, ended);
+
+    AllocationChurnInfo& info = info_map_[key];
+    ++info.alloc_count;
+    info.alloc_time += ended - started;
+    ++info.live_count;
+    if (info.live_count > info.max_live_count) {
+      info.max_live_count = info.live_count;
+    }
+  }
+
+  // Frees of the pointers allocated before tracing started are skipped
+  void AddFree(const void* ptr, uint64_t started, uint64_t ended) {
+    PTI_ASSERT(started <= ended);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    auto it = live_map_.find(ptr);
+    if (it == live_map_.end()) {
+      return;
+    }
+    AllocationChurnKey key = it->second.first;
+    uint64_t allocated = it->second.second;
+    live_map_.erase(it);
+
+    uint64_t lifetime = (started > allocated) ? started - allocated : 0;
+    AllocationChurnInfo& info = info_map_[key];
+    if (info.free_count == 0) {
+      info.min_lifetime = lifetime;
+      info.max_lifetime = lifetime;
+    }
+    ++info.free_count;
+    info.free_time += ended - started;
+    if (lifetime < ALLOCATION_CHURN_SHORT_LIFETIME) {
+      ++info.short_count;
+    }
+    if (lifetime < info.min_lifetime) {
+      info.min_lifetime = lifetime;
+    }
+    if (lifetime > info.max_lifetime) {
+      info.max_lifetime = lifetime;
+    }
+    info.lifetime_histogram.Add(lifetime);
+    PTI_ASSERT(info.live_count > 0);
+    --info.live_count;
+  }
+
+  bool IsEmpty() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return info_map_.empty();
+  }
+
+  void PrintTable(std::ostream& stream) const {
+    AllocationChurnInfoMap info_map;
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      info_map = info_map_;
+    }
+
+    std::vector< std::pair<uint64_t, AllocationChurnKey> > sorted_list;
+    uint64_t total_time = 0;
+    uint64_t total_savings = 0;
+    for (auto& value : info_map) {
+      const AllocationChurnInfo& info = value.second;
+      total_time += info.alloc_time + info.free_time;
+      if (info.free_count == 0) {
+        continue;
+      }
+      uint64_t savings = GetSavings(info);
+      total_savings += savings;
+      sorted_list.emplace_back(savings, value.first);
+    }
+    if (sorted_list.empty()) {
+      return;
+    }
+
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              [](const std::pair<uint64_t, AllocationChurnKey>& left,
+                 const std::pair<uint64_t, AllocationChurnKey>& right) {
+                if (left.first != right.first) {
+                  return left.first > right.first;
+                }
+                return left.second < right.second;
+              });
+    if (sorted_list.size() > ALLOCATION_CHURN_ENTRY_COUNT) {
+      sorted_list.resize(ALLOCATION_CHURN_ENTRY_COUNT);
+    }
+
+    size_t max_name_length = kCallsiteLength;
+    for (auto& value : sorted_list) {
+      const std::string& name =
+        CallsiteCache::GetName(std::get<0>(value.second));
+      if (name.size() > max_name_length) {
+        max_name_length = name.size();
+      }
+    }
+
+    stream << std::setw(max_name_length) << "Callsite" << "," <<
+      std::setw(kTypeLength) << "Type" << "," <<
+      std::setw(kSizeLength) << "Size Class (bytes)" << "," <<
+      std::setw(kCountLength) << "Allocations" << "," <<
+      std::setw(kCountLength) << "Frees" << "," <<
+      std::setw(kTimeLength) << "Alloc Time (ns)" << "," <<
+      std::setw(kTimeLength) << "Free Time (ns)" << "," <<
+      std::setw(kCountLength) << "Short-Lived" << "," <<
+      std::setw(kTimeLength) << "Min Life (ns)" << "," <<
+      std::setw(kTimeLength) << "P50 Life (ns)" << "," <<
+      std::setw(kTimeLength) << "P90 Life (ns)" << "," <<
+      std::setw(kTimeLength) << "Max Life (ns)" << "," <<
+      std::setw(kCountLength) << "Max Live" << "," <<
+      std::setw(kTimeLength) << "Savings (ns)" << std::endl;
+
+    for (auto& value : sorted_list) {
+      const AllocationChurnInfo& info = info_map.at(value.second);
+      stream << std::setw(max_name_length) <<
+          CallsiteCache::GetName(std::get<0>(value.second)) << "," <<
+        std::setw(kTypeLength) <<
+          MemoryTracker::GetTypeName(std::get<2>(value.second)) << "," <<
+        std::setw(kSizeLength) << std::get<1>(value.second) << "," <<
+        std::setw(kCountLength) << info.alloc_count << "," <<
+        std::setw(kCountLength) << info.free_count << "," <<
+        std::setw(kTimeLength) << info.alloc_time << "," <<
+        std::setw(kTimeLength) << info.free_time << "," <<
+        std::setw(kCountLength) << info.short_count << "," <<
+        std::setw(kTimeLength) << info.min_lifetime << "," <<
+        std::setw(kTimeLength) << GetPercentile(info, 50.0) << "," <<
+        std::setw(kTimeLength) << GetPercentile(info, 90.0) << "," <<
+        std::setw(kTimeLength) << info.max_lifetime << "," <<
+        std::setw(kCountLength) << info.max_live_count << "," <<
+        std::setw(kTimeLength) << value.first << std::endl;
+    }
+
+    stream << std::endl;
+    stream << "Pooling allocator could save " << total_savings <<
+      " ns of " << total_time << " ns spent in allocation and free calls";
+    if (total_time > 0) {
+      stream << " (" << std::setprecision(2) << std::fixed <<
+        100.0f * total_savings / total_time << "%)";
+    }
+    stream << std::endl;
+  }
+
+  // Sizes are rounded up to the next power of two
+  static uint64_t GetSizeClass(uint64_t size) {
+    uint64_t size_class = 1;
+    while (size_class < size && size_class < (1ULL << 63)) {
+      size_class <<= 1;
+    }
+    return size_class;
+  }
+
+ private: // Implementation
+  static uint64_t GetSavings(const AllocationChurnInfo& info) {
+    PTI_ASSERT(info.alloc_count > 0);
+    uint64_t pooled = std::min(info.max_live_count, info.alloc_count);
+    uint64_t savings =
+      info.alloc_time / info.alloc_count * (info.alloc_count - pooled);
+    if (info.free_count > pooled) {
+      savings += info.free_time / info.free_count *
+        (info.free_count - pooled);
+    }
+    return savings;
+  }
+
+  static uint64_t GetPercentile(
+      const AllocationChurnInfo& info, double percent) {
+    return info.lifetime_histogram.GetPercentile(
+        percent, info.min_lifetime, info.max_lifetime);
+  }
+
+ private: // Data
+  AllocationChurnInfoMap info_map_;
+  std::unordered_map<const void*, std::pair<AllocationChurnKey, uint64_t> >
+    live_map_;
+  CallsiteCache callsite_cache_;
+  mutable std::mutex lock_;
+
+  static const uint32_t kCallsiteLength = 10;
+  static const uint32_t kTypeLength = 8;
+  static const uint32_t kSizeLength = 20;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kTimeLength = 20;
+};
+
+#endif // PTI_TOOLS_UTILS_ALLOCATION_CHURN_H_
@@ -0,0 +1,124 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_API_FILTER_H_
+#define PTI_TOOLS_UTILS_API_FILTER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "pti_assert.h"
+
+#define API_FILTER_SEPARATOR ','
+
+// Subsets of the API functions for the modes that need only a few of them
+#define API_SUBSET_ALLOC 0x1 // Memory allocation and free calls
+#define API_SUBSET_WAIT  0x2 // Host synchronization calls
+
+// Selects API functions to trace by name. Both lists are comma-separated
+// glob patterns ('*' matches any sequence, '?' matches any symbol), e.g.
+// "zeCommandListAppend*,zeCommandQueue*". Function is traced if it matches
+// any include pattern (or the include list is empty) and does not match
+// any exclude pattern. The filter is expected to be evaluated once per
+// function while tracing is set up, not on each call. Non-zero subset
+// mask (API_SUBSET_*) also leaves out the functions of no given subset,
+// so that these get no callbacks at all
+class ApiFilter {
+ public: // Interface
+  ApiFilter(const std::string& include_list,
+            const std::string& exclude_list,
+            uint32_t subset_mask = 0)
+      : include_list_(Split(include_list)),
+        exclude_list_(Split(exclude_list)),
+        subset_mask_(subset_mask) {}
+
+  bool IsEmpty() const {
+    return include_list_.empty() && exclude_list_.empty() &&
+      subset_mask_ == 0;
+  }
+
+  // Function subsets are the API_SUBSET_* the function belongs to
+  bool IsEnabled(const char* name, uint32_t function_subsets = 0) const {
+    PTI_ASSERT(name != nullptr);
+    if (subset_mask_ != 0 && (subset_mask_ & function_subsets) == 0) {
+      return false;
+    }
+    if (!include_list_.empty() && !MatchAny(include_list_, name)) {
+      return false;
+    }
+    return !MatchAny(exclude_list_, name);
+  }
+
+ private: // Implementation
+  static std::vector<std::string> Split(const std::string& list) {
+    std::vector<std::string> pattern_list;
+    size_t start = 0;
+    while (start <= list.size()) {
+      size_t end = list.find(API_FILTER_SEPARATOR, start);
+      if (end == std::string::npos) {
+        end = list.size();
+      }
+      std::string pattern = Trim(list.substr(start, end - start));
+      if (!pattern.empty()) {
+        pattern_list.push_back(pattern);
+      }
+      start = end + 1;
+    }
+    return pattern_list;
+  }
+
+  static std::string Trim(const std::string& value) {
+    size_t start = value.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+      return std::string();
+    }
+    size_t end = value.find_last_not_of(" \t");
+    return value.substr(start, end - start + 1);
+  }
+
+  static bool MatchAny(
+      const std::vector<std::string>& pattern_list, const char* name) {
+    for (const std::string& pattern : pattern_list) {
+      if (Match(pattern.c_str(), name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Iterative glob matching, backtracks to the last '*' only
+  static bool Match(const char* pattern, const char* name) {
+    const char* star = nullptr;
+    const char* resume = nullptr;
+    while (*name != '\0') {
+      if (*pattern == '*') {
+        star = pattern++;
+        resume = name;
+      } else if (*pattern == '?' || *pattern == *name) {
+        ++pattern;
+        ++name;
+      } else if (star != nullptr) {
+        pattern = star + 1;
+        name = ++resume;
+      } else {
+        return false;
+      }
+    }
+    while (*pattern == '*') {
+      ++pattern;
+    }
+    return *pattern == '\0';
+  }
+
+ private: // Data
+  std::vector<std::string> include_list_;
+  std::vector<std::string> exclude_list_;
+  uint32_t subset_mask_ = 0;
+};
+
+#endif // PTI_TOOLS_UTILS_API_FILTER_H_
@@ -0,0 +1,580 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_ARROW_WRITER_H_
+#define PTI_TOOLS_UTILS_ARROW_WRITER_H_
+
+#include <string.h>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "pti_assert.h"
+
+// Writes a table in Apache Arrow IPC streaming format (metadata version
+// V5, little-endian), so it can be loaded without parsing, e.g. with
+// pyarrow.ipc.open_stream(file).read_pandas(). Rows are buffered by
+// columns and flushed as a record batch every ARROW_BATCH_SIZE rows.
+// Columns are non-nullable; string columns are dictionary-encoded with
+// int32 indices, their dictionaries are to be set before the first row
+
+#define ARROW_BATCH_SIZE 65536
+
+enum ArrowType {
+  ARROW_TYPE_UINT32 = 0,
+  ARROW_TYPE_UINT64 = 1,
+  ARROW_TYPE_FLOAT32 = 2,
+  ARROW_TYPE_FLOAT64 = 3,
+  ARROW_TYPE_DICTIONARY = 4
+};
+
+struct ArrowField {
+  std::string name;
+  ArrowType type;
+};
+
+// Distinct strings of a dictionary column in the order of their first use
+class ArrowDictionary {
+ public:
+  uint32_t Add(const std::string& value) {
+    auto it = index_map_.find(value);
+    if (it != index_map_.end()) {
+      return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(value_list_.size());
+    index_map_[value] = index;
+    value_list_.push_back(value);
+    return index;
+  }
+
+  uint32_t Find(const std::string& value) const {
+    auto it = index_map_.find(value);
+    PTI_ASSERT(it != index_map_.end());
+    return it->second;
+  }
+
+  const std::vector<std::string>& GetValueList() const {
+    return value_list_;
+  }
+
+ private:
+  std::map<std::string, uint32_t> index_map_;
+  std::vector<std::string> value_list_;
+};
+
+namespace arrow_detail {
+
+// Minimal FlatBuffers builder: like the reference one it writes the
+// buffer back to front, so objects are created before the ones that
+// refer to them, and offsets are measured from the end of the buffer
+class FlatBuilder {
+ public:
+  size_t GetSize() const {
+    return buffer_.size();
+  }
+
+  void Align(size_t alignment) {
+    while (buffer_.size() % alignment != 0) {
+      Prepend<uint8_t>(0);
+    }
+  }
+
+  template <typename T>
+  void Prepend(T value) {
+    uint8_t bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    buffer_.insert(buffer_.begin(), bytes, bytes + sizeof(T));
+  }
+
+  void PrependOffset(size_t offset) {
+    Align(4);
+    PTI_ASSERT(offset <= buffer_.size());
+    Prepend<uint32_t>(static_cast<uint32_t>(buffer_.size() + 4 - offset));
+  }
+
+  size_t CreateString(const std::string& value) {
+    while ((buffer_.size() + value.size() + 1) % 4 != 0) {
+      Prepend<uint8_t>(0);
+    }
+    Prepend<uint8_t>(0);
+    buffer_.insert(buffer_.begin(), value.begin(), value.end());
+    Prepend<uint32_t>(static_cast<uint32_t>(value.size()));
+    return buffer_.size();
+  }
+
+  size_t CreateOffsetVector(const std::vector<size_t>& offset_list) {
+    for (size_t i = offset_list.size(); i > 0; --i) {
+      PrependOffset(offset_list[i - 1]);
+    }
+    Align(4);
+    Prepend<uint32_t>(static_cast<uint32_t>(offset_list.size()));
+    return buffer_.size();
+  }
+
+  // Vector of structs made of two int64 values, like FieldNode or Buffer
+  size_t CreatePairVector(
+      const std::vector<std::pair<int64_t, int64_t> >& pair_list) {
+    Align(8);
+    for (size_t i = pair_list.size(); i > 0; --i) {
+      Prepend<int64_t>(pair_list[i - 1].second);
+      Prepend<int64_t>(pair_list[i - 1].first);
+    }
+    Prepend<uint32_t>(static_cast<uint32_t>(pair_list.size()));
+    return buffer_.size();
+  }
+
+  void StartTable() {
+    PTI_ASSERT(field_list_.empty());
+    table_end_ = buffer_.size();
+  }
+
+  template <typename T>
+  void AddField(uint16_t id, T value) {
+    Align(sizeof(T));
+    Prepend<T>(value);
+    field_list_.push_back(std::make_pair(id, buffer_.size()));
+  }
+
+  void AddOffsetField(uint16_t id, size_t offset) {
+    PrependOffset(offset);
+    field_list_.push_back(std::make_pair(id, buffer_.size()));
+  }
+
+  // Vtable is placed right before the table, so its offset is positive
+  size_t EndTable() {
+    Align(4);
+    Prepend<int32_t>(0);
+    size_t table = buffer_.size();
+
+    uint16_t field_count = 0;
+    for (auto& field : field_list_) {
+      if (field.first + 1 > field_count) {
+        field_count = field.first + 1;
+      }
+    }
+
+    std::vector<uint16_t> vtable(field_count, 0);
+    for (auto& field : field_list_) {
+      vtable[field.first] = static_cast<uint16_t>(table - field.second);
+    }
+    for (size_t i = vtable.size(); i > 0; --i) {
+      Prepend<uint16_t>(vtable[i - 1]);
+    }
+    Prepend<uint16_t>(static_cast<uint16_t>(table - table_end_));
+    Prepend<uint16_t>(static_cast<uint16_t>(2 * (field_count + 2)));
+
+    int32_t vtable_offset = static_cast<int32_t>(buffer_.size() - table);
+    memcpy(buffer_.data() + buffer_.size() - table,
+           &vtable_offset, sizeof(vtable_offset));
+
+    field_list_.clear();
+    return table;
+  }
+
+  // Root offset goes first, the whole buffer is aligned to 8 bytes
+  const std::vector<uint8_t>& Finish(size_t root) {
+    while ((buffer_.size() + 4) % 8 != 0) {
+      Prepend<uint8_t>(0);
+    }
+    PrependOffset(root);
+    return buffer_;
+  }
+
+ private:
+  std::vector<uint8_t> buffer_;
+  std::vector<std::pair<uint16_t, size_t> > field_list_;
+  size_t table_end_ = 0;
+};
+
+} // namespace arrow_detail
+
+class ArrowWriter {
+ public: // Interface
+  static ArrowWriter* Create(
+      const std::string& filename,
+      const std::vector<ArrowField>& field_list,
+      uint32_t batch_size = ARROW_BATCH_SIZE) {
+    PTI_ASSERT(!filename.empty());
+    PTI_ASSERT(!field_list.empty());
+    PTI_ASSERT(batch_size > 0);
+
+    ArrowWriter* writer = new ArrowWriter(filename, field_list, batch_size);
+    PTI_ASSERT(writer != nullptr);
+    if (!writer->file_.is_open()) {
+      std::cerr << "[WARNING] Unable to create file " << filename <<
+        std::endl;
+      delete writer;
+      return nullptr;
+    }
+    return writer;
+  }
+
+  ~ArrowWriter() {
+    Close();
+  }
+
+  void SetDictionary(
+      uint32_t field_id, const std::vector<std::string>& value_list) {
+    PTI_ASSERT(field_id < field_list_.size());
+    PTI_ASSERT(field_list_[field_id].type == ARROW_TYPE_DICTIONARY);
+    PTI_ASSERT(!started_);
+    dictionary_list_[field_id] = value_list;
+  }
+
+  // Values are converted to the column type, dictionary columns take
+  // the index of the string in the dictionary
+  void Append(uint32_t field_id, uint64_t value) {
+    PTI_ASSERT(field_id < field_list_.size());
+    switch (field_list_[field_id].type) {
+      case ARROW_TYPE_UINT32:
+        Push(field_id, static_cast<uint32_t>(value));
+        break;
+      case ARROW_TYPE_UINT64:
+        Push(field_id, value);
+        break;
+      case ARROW_TYPE_FLOAT32:
+        Push(field_id, static_cast<float>(value));
+        break;
+      case ARROW_TYPE_FLOAT64:
+        Push(field_id, static_cast<double>(value));
+        break;
+      case ARROW_TYPE_DICTIONARY:
+        PTI_ASSERT(value < dictionary_list_[field_id].size());
+        Push(field_id, static_cast<int32_t>(value));
+        break;
+      default:
+        PTI_ASSERT(0);
+        break;
+    }
+  }
+
+  void Append(uint32_t field_id, double value) {
+    PTI_ASSERT(field_id < field_list_.size());
+    switch (field_list_[field_id].type) {
+      case ARROW_TYPE_UINT32:
+        Push(field_id, static_cast<uint32_t>(value));
+        break;
+      case ARROW_TYPE_UINT64:
+        Push(field_id, static_cast<uint64_t>(value));
+        break;
+      case ARROW_TYPE_FLOAT32:
+        Push(field_id, static_cast<float>(value));
+        break;
+      case ARROW_TYPE_FLOAT64:
+        Push(field_id, value);
+        break;
+      default:
+        PTI_ASSERT(0);
+        break;
+    }
+  }
+
+  // Every column should get exactly one value per row
+  void EndRow() {
+    if (!started_) {
+      WriteSchema();
+      WriteDictionaries();
+      started_ = true;
+    }
+
+    ++row_count_;
+    for (size_t i = 0; i < column_list_.size(); ++i) {
+      PTI_ASSERT(column_list_[i].size() ==
+                 row_count_ * GetWidth(field_list_[i].type));
+    }
+
+    if (row_count_ == batch_size_) {
+      WriteRecordBatch();
+    }
+  }
+
+  // Writes the rest of the rows and the end-of-stream marker
+  void Close() {
+    if (!file_.is_open()) {
+      return;
+    }
+
+    if (!started_) {
+      WriteSchema();
+      WriteDictionaries();
+      started_ = true;
+    }
+    if (row_count_ > 0) {
+      WriteRecordBatch();
+    }
+
+    uint32_t eos[2] = {0xFFFFFFFF, 0};
+    file_.write(reinterpret_cast<const char*>(eos), sizeof(eos));
+    file_.close();
+  }
+
+  ArrowWriter(const ArrowWriter& copy) = delete;
+  ArrowWriter& operator=(const ArrowWriter& copy) = delete;
+
+ private: // Implementation
+  // Values of Arrow flatbuffer enums and unions
+  enum {
+    MESSAGE_SCHEMA = 1,
+    MESSAGE_DICTIONARY_BATCH = 2,
+    MESSAGE_RECORD_BATCH = 3
+  };
+
+  enum {
+    TYPE_INT = 2,
+    TYPE_FLOATING_POINT = 3,
+    TYPE_UTF8 = 5
+  };
+
+  enum {
+    PRECISION_SINGLE = 1,
+    PRECISION_DOUBLE = 2
+  };
+
+  static const int16_t kMetadataVersion = 4; // V5
+
+  using PairList = std::vector<std::pair<int64_t, int64_t> >;
+
+  ArrowWriter(
+      const std::string& filename,
+      const std::vector<ArrowField>& field_list,
+      uint32_t batch_size)
+      : file_(filename, std::ios::out | std::ios::binary | std::ios::trunc),
+        field_list_(field_list),
+        batch_size_(batch_size),
+        column_list_(field_list.size()),
+        dictionary_list_(field_list.size()) {}
+
+  static size_t GetWidth(ArrowType type) {
+    switch (type) {
+      case ARROW_TYPE_UINT32:
+      case ARROW_TYPE_FLOAT32:
+      case ARROW_TYPE_DICTIONARY:
+        return 4;
+      case ARROW_TYPE_UINT64:
+      case ARROW_TYPE_FLOAT64:
+        return 8;
+      default:
+        PTI_ASSERT(0);
+        break;
+    }
+    return 0;
+  }
+
+  template <typename T>
+  void Push(uint32_t field_id, T value) {
+    std::vector<uint8_t>& column = column_list_[field_id];
+    size_t size = column.size();
+    column.resize(size + sizeof(T));
+    memcpy(column.data() + size, &value, sizeof(T));
+  }
+
+  static size_t GetPadding(size_t size) {
+    return (8 - size % 8) % 8;
+  }
+
+  static size_t CreateInt(
+      arrow_detail::FlatBuilder& builder, int32_t bit_width, bool is_signed) {
+    builder.StartTable();
+    builder.AddField<int32_t>(0, bit_width);
+    builder.AddField<uint8_t>(1, is_signed ? 1 : 0);
+    return builder.EndTable();
+  }
+
+  static size_t CreateField(
+      arrow_detail::FlatBuilder& builder,
+      const ArrowField& field, int64_t dictionary_id) {
+    size_t name = builder.CreateString(field.name);
+    size_t children = builder.CreateOffsetVector(std::vector<size_t>());
+
+    uint8_t type_type = TYPE_INT;
+    size_t type = 0;
+    size_t dictionary = 0;
+    switch (field.type) {
+      case ARROW_TYPE_UINT32:
+        type = CreateInt(builder, 32, false);
+        break;
+      case ARROW_TYPE_UINT64:
+        type = CreateInt(builder, 64, false);
+        break;
+      case ARROW_TYPE_FLOAT32:
+      case ARROW_TYPE_FLOAT64:
+        type_type = TYPE_FLOATING_POINT;
+        builder.StartTable();
+        builder.AddField<int16_t>(0,
+            (field.type == ARROW_TYPE_FLOAT32) ?
+              PRECISION_SINGLE : PRECISION_DOUBLE);
+        type = builder.EndTable();
+        break;
+      case ARROW_TYPE_DICTIONARY: {
+        type_type = TYPE_UTF8;
+        builder.StartTable();
+        type = builder.EndTable();
+
+        size_t index_type = CreateInt(builder, 32, true);
+        builder.StartTable();
+        builder.AddField<int64_t>(0, dictionary_id);
+        builder.AddOffsetField(1, index_type);
+        dictionary = builder.EndTable();
+        break;
+      }
+      default:
+        PTI_ASSERT(0);
+        break;
+    }
+
+    builder.StartTable();
+    builder.AddOffsetField(0, name);
+    builder.AddField<uint8_t>(1, 0); // Non-nullable
+    builder.AddField<uint8_t>(2, type_type);
+    builder.AddOffsetField(3, type);
+    if (dictionary != 0) {
+      builder.AddOffsetField(4, dictionary);
+    }
+    builder.AddOffsetField(5, children);
+    return builder.EndTable();
+  }
+
+  static size_t CreateRecordBatch(
+      arrow_detail::FlatBuilder& builder, int64_t length,
+      const PairList& node_list, const PairList& buffer_list) {
+    size_t nodes = builder.CreatePairVector(node_list);
+    size_t buffers = builder.CreatePairVector(buffer_list);
+    builder.StartTable();
+    builder.AddField<int64_t>(0, length);
+    builder.AddOffsetField(1, nodes);
+    builder.AddOffsetField(2, buffers);
+    return builder.EndTable();
+  }
+
+  // Encapsulated message: continuation marker, metadata size, flatbuffer
+  // padded to 8 bytes, then the body
+  void WriteMessage(
+      arrow_detail::FlatBuilder& builder, uint8_t header_type,
+      size_t header, const std::vector<uint8_t>& body) {
+    builder.StartTable();
+    builder.AddField<int16_t>(0, kMetadataVersion);
+    builder.AddField<uint8_t>(1, header_type);
+    builder.AddOffsetField(2, header);
+    builder.AddField<int64_t>(3, static_cast<int64_t>(body.size()));
+    size_t message = builder.EndTable();
+
+    const std::vector<uint8_t>& metadata = builder.Finish(message);
+    PTI_ASSERT(metadata.size() % 8 == 0);
+
+    uint32_t prefix[2] = {
+        0xFFFFFFFF, static_cast<uint32_t>(metadata.size())};
+    file_.write(reinterpret_cast<const char*>(prefix), sizeof(prefix));
+    file_.write(reinterpret_cast<const char*>(metadata.data()),
+                metadata.size());
+    if (!body.empty()) {
+      file_.write(reinterpret_cast<const char*>(body.data()), body.size());
+    }
+  }
+
+  static void AddBuffer(
+      std::vector<uint8_t>& body, PairList& buffer_list,
+      const uint8_t* data, size_t size) {
+    buffer_list.push_back(std::make_pair(
+        static_cast<int64_t>(body.size()), static_cast<int64_t>(size)));
+    body.insert(body.end(), data, data + size);
+    body.resize(body.size() + GetPadding(size), 0);
+  }
+
+  void WriteSchema() {
+    arrow_detail::FlatBuilder builder;
+
+    std::vector<size_t> field_offset_list;
+    for (size_t i = 0; i < field_list_.size(); ++i) {
+      field_offset_list.push_back(
+          CreateField(builder, field_list_[i], static_cast<int64_t>(i)));
+    }
+    size_t fields = builder.CreateOffsetVector(field_offset_list);
+
+    builder.StartTable();
+    builder.AddField<int16_t>(0, 0); // Little-endian
+    builder.AddOffsetField(1, fields);
+    size_t schema = builder.EndTable();
+
+    WriteMessage(builder, MESSAGE_SCHEMA, schema, std::vector<uint8_t>());
+  }
+
+  // Dictionary of a column has the same id as the column
+  void WriteDictionaries() {
+    for (size_t i = 0; i < field_list_.size(); ++i) {
+      if (field_list_[i].type != ARROW_TYPE_DICTIONARY) {
+        continue;
+      }
+
+      const std::vector<std::string>& value_list = dictionary_list_[i];
+      std::vector<int32_t> offset_list(1, 0);
+      std::string data;
+      for (auto& value : value_list) {
+        data += value;
+        offset_list.push_back(static_cast<int32_t>(data.size()));
+      }
+
+      std::vector<uint8_t> body;
+      PairList buffer_list;
+      AddBuffer(body, buffer_list, nullptr, 0);
+      AddBuffer(body, buffer_list,
+                reinterpret_cast<const uint8_t*>(offset_list.data()),
+                offset_list.size() * sizeof(int32_t));
+      AddBuffer(body, buffer_list,
+                reinterpret_cast<const uint8_t*>(data.data()), data.size());
+
+      int64_t length = static_cast<int64_t>(value_list.size());
+      arrow_detail::FlatBuilder builder;
+      size_t data_batch = CreateRecordBatch(
+          builder, length, PairList(1, std::make_pair(length, 0)),
+          buffer_list);
+
+      builder.StartTable();
+      builder.AddField<int64_t>(0, static_cast<int64_t>(i));
+      builder.AddOffsetField(1, data_batch);
+      size_t dictionary_batch = builder.EndTable();
+
+      WriteMessage(builder, MESSAGE_DICTIONARY_BATCH, dictionary_batch, body);
+    }
+  }
+
+  // Each column has an empty validity bitmap and a buffer of values
+  void WriteRecordBatch() {
+    PTI_ASSERT(row_count_ > 0);
+
+    std::vector<uint8_t> body;
+    PairList node_list;
+    PairList buffer_list;
+    for (auto& column : column_list_) {
+      node_list.push_back(
+          std::make_pair(static_cast<int64_t>(row_count_), 0));
+      AddBuffer(body, buffer_list, nullptr, 0);
+      AddBuffer(body, buffer_list, column.data(), column.size());
+      column.clear();
+    }
+
+    arrow_detail::FlatBuilder builder;
+    size_t record_batch = CreateRecordBatch(
+        builder, static_cast<int64_t>(row_count_), node_list, buffer_list);
+    WriteMessage(builder, MESSAGE_RECORD_BATCH, record_batch, body);
+
+    row_count_ = 0;
+  }
+
+ private: // Data
+  std::ofstream file_;
+  std::vector<ArrowField> field_list_;
+  uint32_t batch_size_ = 0;
+  bool started_ = false;
+
+  uint32_t row_count_ = 0;
+  std::vector<std::vector<uint8_t> > column_list_;
+  std::vector<std::vector<std::string> > dictionary_list_;
+};
+
+#endif // PTI_TOOLS_UTILS_ARROW_WRITER_H_
\ No newline at end of file
@@ -0,0 +1,165 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_ATOMIC_STAT_TABLE_H_
+#define PTI_TOOLS_UTILS_ATOMIC_STAT_TABLE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <limits>
+#include <string>
+
+#include "pti_assert.h"
+
+#define ATOMIC_STAT_TABLE_SIZE 2048 // Distinct names, power of two
+#define ATOMIC_STAT_BUCKET_COUNT 42 // [0, 1), [1, 2), [2, 4) ... [2^40, inf)
+
+// Fixed-size open-addressing table of per-name call statistics, updated
+// with relaxed atomic operations from any thread. A name takes its slot
+// with a single compare-and-swap of its hash, the only allocation is the
+// copy of the name made by the thread that won the slot. If the table is
+// full the value is counted as dropped
+class AtomicStatTable {
+ public: // Interface
+  struct Snapshot {
+    uint64_t call_count;
+    uint64_t total_time;
+    uint64_t min_time;
+    uint64_t max_time;
+    uint64_t bucket_list[ATOMIC_STAT_BUCKET_COUNT];
+  };
+
+  AtomicStatTable() {
+    Reset();
+  }
+
+  ~AtomicStatTable() {
+    for (uint32_t i = 0; i < ATOMIC_STAT_TABLE_SIZE; ++i) {
+      delete slot_list_[i].name.load(std::memory_order_acquire);
+    }
+  }
+
+  void Add(const std::string& name, uint64_t time) {
+    uint64_t hash = GetHash(name);
+    for (uint32_t i = 0; i < ATOMIC_STAT_TABLE_SIZE; ++i) {
+      Slot& slot = slot_list_[(hash + i) & (ATOMIC_STAT_TABLE_SIZE - 1)];
+      uint64_t key = slot.key.load(std::memory_order_acquire);
+      if (key == 0) {
+        if (slot.key.compare_exchange_strong(
+                key, hash, std::memory_order_acq_rel)) {
+          slot.name.store(new std::string(name), std::memory_order_release);
+          key = hash;
+        }
+      }
+      if (key == hash) {
+        slot.call_count.fetch_add(1, std::memory_order_relaxed);
+        slot.total_time.fetch_add(time, std::memory_order_relaxed);
+        slot.bucket_list[GetBucket(time)].fetch_add(
+            1, std::memory_order_relaxed);
+        // Extremes are rarely updated once the name is warmed up
+        uint64_t value = slot.min_time.load(std::memory_order_relaxed);
+        while (time < value && !slot.min_time.compare_exchange_weak(
+                   value, time, std::memory_order_relaxed)) {}
+        value = slot.max_time.load(std::memory_order_relaxed);
+        while (time > value && !slot.max_time.compare_exchange_weak(
+                   value, time, std::memory_order_relaxed)) {}
+        return;
+      }
+    }
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Returns nullptr for free slots and for the ones still being taken
+  const std::string* Read(uint32_t index, Snapshot* snapshot) const {
+    PTI_ASSERT(index < ATOMIC_STAT_TABLE_SIZE);
+    PTI_ASSERT(snapshot != nullptr);
+    const Slot& slot = slot_list_[index];
+    const std::string* name = slot.name.load(std::memory_order_acquire);
+    if (name == nullptr) {
+      return nullptr;
+    }
+    snapshot->call_count = slot.call_count.load(std::memory_order_relaxed);
+    snapshot->total_time = slot.total_time.load(std::memory_order_relaxed);
+    snapshot->min_time = slot.min_time.load(std::memory_order_relaxed);
+    snapshot->max_time = slot.max_time.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < ATOMIC_STAT_BUCKET_COUNT; ++i) {
+      snapshot->bucket_list[i] =
+        slot.bucket_list[i].load(std::memory_order_relaxed);
+    }
+    return name;
+  }
+
+  uint64_t GetDroppedCount() const {
+    return dropped_count_.load(std::memory_order_relaxed);
+  }
+
+  // Clears the statistics but keeps the names in their slots, must not
+  // run concurrently with Add
+  void Reset() {
+    for (uint32_t i = 0; i < ATOMIC_STAT_TABLE_SIZE; ++i) {
+      Slot& slot = slot_list_[i];
+      slot.call_count.store(0, std::memory_order_relaxed);
+      slot.total_time.store(0, std::memory_order_relaxed);
+      slot.min_time.store((std::numeric_limits<uint64_t>::max)(),
+                          std::memory_order_relaxed);
+      slot.max_time.store(0, std::memory_order_relaxed);
+      for (uint32_t j = 0; j < ATOMIC_STAT_BUCKET_COUNT; ++j) {
+        slot.bucket_list[j].store(0, std::memory_order_relaxed);
+      }
+    }
+    dropped_count_.store(0, std::memory_order_relaxed);
+  }
+
+  // Values of the bucket are in [lower, upper), the last bucket has no
+  // upper bound and is given with zero
+  static void GetBucketBounds(uint32_t index, uint64_t* lower,
+                              uint64_t* upper) {
+    PTI_ASSERT(index < ATOMIC_STAT_BUCKET_COUNT);
+    PTI_ASSERT(lower != nullptr && upper != nullptr);
+    *lower = (index == 0) ? 0 : (1ull << (index - 1));
+    *upper = (index < ATOMIC_STAT_BUCKET_COUNT - 1) ? (1ull << index) : 0;
+  }
+
+  AtomicStatTable(const AtomicStatTable& copy) = delete;
+  AtomicStatTable& operator=(const AtomicStatTable& copy) = delete;
+
+ private: // Implementation
+  struct Slot {
+    std::atomic<uint64_t> key{0};
+    std::atomic<const std::string*> name{nullptr};
+    std::atomic<uint64_t> call_count;
+    std::atomic<uint64_t> total_time;
+    std::atomic<uint64_t> min_time;
+    std::atomic<uint64_t> max_time;
+    std::atomic<uint64_t> bucket_list[ATOMIC_STAT_BUCKET_COUNT];
+  };
+
+  // FNV-1a, zero marks a free slot
+  static uint64_t GetHash(const std::string& name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char symbol : name) {
+      hash ^= static_cast<unsigned char>(symbol);
+      hash *= 1099511628211ull;
+    }
+    return (hash == 0) ? 1 : hash;
+  }
+
+  static uint32_t GetBucket(uint64_t time) {
+    uint32_t index = 0;
+    while (time > 0 && index < ATOMIC_STAT_BUCKET_COUNT - 1) {
+      time >>= 1;
+      ++index;
+    }
+    return index;
+  }
+
+ private: // Data
+  Slot slot_list_[ATOMIC_STAT_TABLE_SIZE];
+  std::atomic<uint64_t> dropped_count_{0};
+};
+
+#endif // PTI_TOOLS_UTILS_ATOMIC_STAT_TABLE_H_
@@ -0,0 +1,397 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_BINARY_TRACE_H_
+#define PTI_TOOLS_UTILS_BINARY_TRACE_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pti_assert.h"
+#include "shm_trace_ring.h"
+#include "string_table.h"
+#include "utils.h"
+
+// Binary trace layout (little-endian, see binary_trace_converter.py):
+//   BinaryTraceHeader, then a stream of BinaryTraceRecord entries.
+// A BINARY_RECORD_STRING entry introduces a name: its kernel_id field holds
+// the length of the text that immediately follows it. Every other record
+// refers to names only through name_id, and each name is written once,
+// before its first use. BINARY_RECORD_COUNTER entry is a sample of a
+// device counter (e.g. GPU frequency): queue is the device index, started
+// and ended are the sample time and kernel_id keeps the bits of the double
+// value. Version 1 header has no rank and epoch point (its last 12 bytes
+// are reserved and absent respectively).
+
+#define BINARY_TRACE_VERSION 2
+
+enum BinaryRecordType {
+  BINARY_RECORD_STRING = 0,
+  BINARY_RECORD_DEVICE = 1,
+  BINARY_RECORD_HOST = 2,
+  BINARY_RECORD_COUNTER = 3
+};
+
+struct BinaryTraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t pid;
+  uint64_t start_point;
+  uint32_t process_name_id;
+  uint32_t rank;        // MPI rank (PMI_RANK), kBinaryNoRank if not set
+  uint64_t epoch_point; // Wall clock time of the start point, ns
+};
+
+struct BinaryTraceRecord {
+  uint32_t type;
+  uint32_t name_id;
+  uint64_t kernel_id; // String ID if call_id is kBinaryIdString
+  uint64_t call_id;
+  uint64_t queue;     // Thread ID for host records
+  uint64_t appended;
+  uint64_t submitted;
+  uint64_t started;
+  uint64_t ended;
+};
+
+static_assert(sizeof(BinaryTraceHeader) == 40,
+              "Unexpected binary trace header size");
+static_assert(sizeof(BinaryTraceRecord) == 64,
+              "Unexpected binary trace record size");
+
+const char kBinaryTraceMagic[8] = {'P', 'T', 'I', 'T', 'R', 'A', 'C', 'E'};
+const uint64_t kBinaryIdString = (std::numeric_limits<uint64_t>::max)();
+const uint32_t kBinaryNoRank = (std::numeric_limits<uint32_t>::max)();
+
+class BinaryTraceWriter {
+ public:
+  BinaryTraceWriter(
+      const std::string& filename, uint32_t pid, uint64_t start_point,
+      uint64_t epoch_point, const std::string& process_name) {
+    PTI_ASSERT(!filename.empty());
+    file_.open(filename, std::ios::out | std::ios::binary);
+    PTI_ASSERT(file_.is_open());
+    WriteHeader(pid, start_point, epoch_point, process_name);
+  }
+
+  // Streams the trace to the node trace daemon, takes the ring ownership
+  BinaryTraceWriter(
+      ShmTraceRing* ring, uint32_t pid, uint64_t start_point,
+      uint64_t epoch_point, const std::string& process_name)
+      : ring_(ring), flush_size_(kRingFlushSize) {
+    PTI_ASSERT(ring_ != nullptr);
+    WriteHeader(pid, start_point, epoch_point, process_name);
+  }
+
+  ~BinaryTraceWriter() {
+    if (ring_ != nullptr) {
+      FlushRing(true);
+      if (dropped_ > 0) {
+        std::cerr << "[WARNING] " << dropped_ << " bytes of binary trace " <<
+          "were dropped, node trace daemon did not keep up" << std::endl;
+      }
+      delete ring_;
+    } else {
+      const std::lock_guard<std::mutex> lock(lock_);
+      Flush();
+      file_.close();
+    }
+  }
+
+  // Level Zero kernels are identified as "<kernel_id>.<call_id>"
+  void WriteDeviceRecord(
+      void* queue, const std::string& id, const std::string& name,
+      uint64_t appended, uint64_t submitted,
+      uint64_t started, uint64_t ended) {
+    WriteRecord(MakeDeviceRecord(
+        queue, id, name, appended, submitted, started, ended));
+  }
+
+  void WriteDeviceRecord(
+      void* queue, uint64_t id, const std::string& name,
+      uint64_t queued, uint64_t submitted,
+      uint64_t started, uint64_t ended) {
+    WriteRecord(MakeDeviceRecord(
+        queue, id, name, queued, submitted, started, ended));
+  }
+
+  void WriteHostRecord(
+      uint64_t tid, const std::string& id, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    WriteRecord(MakeHostRecord(tid, id, name, started, ended));
+  }
+
+  void WriteHostRecord(
+      uint64_t tid, uint64_t id, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    WriteRecord(MakeHostRecord(tid, id, name, started, ended));
+  }
+
+  void WriteCounterRecord(
+      uint32_t device_id, const std::string& name,
+      uint64_t timestamp, double value) {
+    WriteRecord(MakeCounterRecord(device_id, name, timestamp, value));
+  }
+
+  // Strings referred by the record are taken from StringTable and written
+  // before the record itself if they were not written yet
+  void WriteRecord(const BinaryTraceRecord& record) {
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      AddString(record.name_id);
+      if (record.call_id == kBinaryIdString) {
+        AddString(static_cast<uint32_t>(record.kernel_id));
+      }
+      AddRecord(record);
+      if (ring_ == nullptr || buffer_.size() < flush_size_) {
+        return;
+      }
+    }
+    FlushRing(false);
+  }
+
+  static BinaryTraceRecord MakeDeviceRecord(
+      void* queue, const std::string& id, const std::string& name,
+      uint64_t appended, uint64_t submitted,
+      uint64_t started, uint64_t ended) {
+    BinaryTraceRecord record{};
+    record.type = BINARY_RECORD_DEVICE;
+    record.name_id = StringTable::Add(name);
+    SetId(&record, id);
+    record.queue = reinterpret_cast<uint64_t>(queue);
+    record.appended = appended;
+    record.submitted = submitted;
+    record.started = started;
+    record.ended = ended;
+    return record;
+  }
+
+  static BinaryTraceRecord MakeDeviceRecord(
+      void* queue, uint64_t id, const std::string& name,
+      uint64_t queued, uint64_t submitted,
+      uint64_t started, uint64_t ended) {
+    BinaryTraceRecord record{};
+    record.type = BINARY_RECORD_DEVICE;
+    record.name_id = StringTable::Add(name);
+    record.kernel_id = id;
+    record.queue = reinterpret_cast<uint64_t>(queue);
+    record.appended = queued;
+    record.submitted = submitted;
+    record.started = started;
+    record.ended = ended;
+    return record;
+  }
+
+  static BinaryTraceRecord MakeHostRecord(
+      uint64_t tid, const std::string& id, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    BinaryTraceRecord record{};
+    record.type = BINARY_RECORD_HOST;
+    record.name_id = StringTable::Add(name);
+    SetId(&record, id);
+    record.queue = tid;
+    record.started = started;
+    record.ended = ended;
+    return record;
+  }
+
+  static BinaryTraceRecord MakeHostRecord(
+      uint64_t tid, uint64_t id, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    BinaryTraceRecord record{};
+    record.type = BINARY_RECORD_HOST;
+    record.name_id = StringTable::Add(name);
+    record.kernel_id = id;
+    record.queue = tid;
+    record.started = started;
+    record.ended = ended;
+    return record;
+  }
+
+  static BinaryTraceRecord MakeCounterRecord(
+      uint32_t device_id, const std::string& name,
+      uint64_t timestamp, double value) {
+    static_assert(sizeof(value) == sizeof(BinaryTraceRecord::kernel_id),
+                  "Unexpected counter value size");
+    BinaryTraceRecord record{};
+    record.type = BINARY_RECORD_COUNTER;
+    record.name_id = StringTable::Add(name);
+    memcpy(&record.kernel_id, &value, sizeof(value));
+    record.queue = device_id;
+    record.started = timestamp;
+    record.ended = timestamp;
+    return record;
+  }
+
+  BinaryTraceWriter(const BinaryTraceWriter& copy) = delete;
+  BinaryTraceWriter& operator=(const BinaryTraceWriter& copy) = delete;
+
+ private:
+  void WriteHeader(
+      uint32_t pid, uint64_t start_point, uint64_t epoch_point,
+      const std::string& process_name) {
+    buffer_.reserve(flush_size_);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    process_name_id_ = StringTable::Add(process_name);
+
+    memcpy(header_.magic, kBinaryTraceMagic, sizeof(header_.magic));
+    header_.version = BINARY_TRACE_VERSION;
+    header_.pid = pid;
+    header_.start_point = start_point;
+    header_.process_name_id = process_name_id_;
+    header_.rank = GetRank();
+    header_.epoch_point = epoch_point;
+    AddHeader();
+
+    AddString(process_name_id_);
+  }
+
+  void AddHeader() {
+    const char* data = reinterpret_cast<const char*>(&header_);
+    buffer_.insert(buffer_.end(), data, data + sizeof(header_));
+    header_pending_ = true;
+  }
+
+  static uint32_t GetRank() {
+    std::string rank = utils::GetEnv("PMI_RANK");
+    if (rank.empty()) {
+      return kBinaryNoRank;
+    }
+    return static_cast<uint32_t>(strtoul(rank.c_str(), nullptr, 10));
+  }
+
+  // Both "N" and "N.M" are stored as numbers, anything else (e.g. a list
+  // of kernels of one command list submission) goes to the string table
+  static void SetId(BinaryTraceRecord* record, const std::string& id) {
+    PTI_ASSERT(record != nullptr);
+    PTI_ASSERT(!id.empty());
+
+    char* end = nullptr;
+    record->kernel_id = strtoull(id.c_str(), &end, 10);
+    if (*end == '\0') {
+      record->call_id = 0;
+      return;
+    }
+
+    if (*end == '.') {
+      const char* call = end + 1;
+      record->call_id = strtoull(call, &end, 10);
+      if (*end == '\0' && end != call) {
+        return;
+      }
+    }
+
+    record->kernel_id = StringTable::Add(id);
+    record->call_id = kBinaryIdString;
+  }
+
+  void AddString(uint32_t id) {
+    if (id >= written_.size()) {
+      written_.resize(id + 1, false);
+    }
+
+    if (!written_[id]) {
+      const std::string& str = StringTable::Get(id);
+      BinaryTraceRecord record{};
+      record.type = BINARY_RECORD_STRING;
+      record.name_id = id;
+      record.kernel_id = str.size();
+      AddRecord(record);
+      buffer_.insert(buffer_.end(), str.begin(), str.end());
+      written_[id] = true;
+    }
+  }
+
+  void AddRecord(const BinaryTraceRecord& record) {
+    const char* data = reinterpret_cast<const char*>(&record);
+    buffer_.insert(buffer_.end(), data, data + sizeof(record));
+    if (ring_ == nullptr && buffer_.size() >= flush_size_) {
+      Flush();
+    }
+  }
+
+  void Flush() {
+    PTI_ASSERT(ring_ == nullptr);
+    if (!buffer_.empty()) {
+      file_.write(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+  }
+
+  // Chunks go to the ring one at a time and in order, while the buffer
+  // lock is held only to take the chunk, so the other threads keep adding
+  // records while the daemon is waited for. The daemon drains the ring in
+  // the background and is given a little time before the data is dropped.
+  // The records added meanwhile may refer to the names of the dropped
+  // chunk, so they are dropped too, and the stream goes on with the header
+  // (if it was lost) and the process name
+  void FlushRing(bool force) {
+    PTI_ASSERT(ring_ != nullptr);
+    const std::lock_guard<std::mutex> ring_lock(ring_lock_);
+
+    std::vector<char> chunk;
+    bool has_header = false;
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      if (buffer_.empty() || (!force && buffer_.size() < flush_size_)) {
+        return; // Taken by another thread already
+      }
+      chunk.swap(buffer_);
+      buffer_.reserve(flush_size_);
+      has_header = header_pending_;
+      header_pending_ = false;
+    }
+
+    for (uint32_t i = 0; i < kRingRetryCount; ++i) {
+      if (ring_->Write(chunk.data(), chunk.size())) {
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    size_t size = chunk.size() + buffer_.size();
+    buffer_.clear();
+    written_.clear();
+    if (has_header) {
+      size -= sizeof(header_);
+      AddHeader();
+    }
+    AddString(process_name_id_);
+    ring_->AddDropped(size);
+    dropped_ += size;
+  }
+
+ private:
+  static const size_t kBufferSize = 1024 * 1024;
+  static const size_t kRingFlushSize = 64 * 1024;
+  static const uint32_t kRingRetryCount = 100;
+
+  std::mutex lock_;
+  std::mutex ring_lock_; // Taken before lock_
+  std::ofstream file_;
+  ShmTraceRing* ring_ = nullptr;
+  BinaryTraceHeader header_{};
+  bool header_pending_ = false; // Header is in the buffer
+  uint32_t process_name_id_ = 0;
+  size_t flush_size_ = kBufferSize;
+  uint64_t dropped_ = 0;
+  std::vector<char> buffer_;
+  std::vector<bool> written_;
+};
+
+#endif // PTI_TOOLS_UTILS_BINARY_TRACE_H_
@@ -0,0 +1,204 @@
+#==============================================================
+# Copyright (C) Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+# =============================================================
+
+# Converts binary traces produced with --binary-trace option of
+# onetrace/ze_tracer/cl_tracer into Chrome JSON or device timeline text
+#
+# Usage: python binary_trace_converter.py [--chrome | --device-timeline]
+#   <input.bin> [<output>]
+
+import struct
+import subprocess
+import sys
+
+MAGIC = b"PTITRACE"
+
+HEADER_FORMATS = {1 : "<8sIIQII", 2 : "<8sIIQIIQ"}
+RECORD_FORMAT = "<IIQQQQQQQ"
+RECORD_SIZE = struct.calcsize(RECORD_FORMAT)
+
+RECORD_STRING = 0
+RECORD_DEVICE = 1
+RECORD_HOST = 2
+RECORD_COUNTER = 3
+
+ID_STRING = 0xffffffffffffffff
+NO_RANK = 0xffffffff
+
+NSEC_IN_USEC = 1000
+
+NODE_MAGIC = b"PTINODE\0"
+NODE_HEADER_FORMAT = "<8sII"
+NODE_CHUNK_FORMAT = "<II"
+
+# Files compressed with --compress option are unpacked with the command line
+# tool of the same method
+COMPRESSED_MAGICS = {b"\x28\xb5\x2f\xfd" : "zstd", b"\x04\x22\x4d\x18" : "lz4"}
+
+def read_file(filename):
+  with open(filename, "rb") as f:
+    data = f.read()
+  method = COMPRESSED_MAGICS.get(data[:4])
+  if method is not None:
+    data = subprocess.check_output([method, "-dc", filename])
+  return data
+
+def read_trace(filename):
+  data = read_file(filename)
+  if data[:len(NODE_MAGIC)] == NODE_MAGIC:
+    raise ValueError("Node trace has several processes, " +
+      "use binary_trace_merger.py")
+  return parse_trace(data)
+
+# Node trace (see shm_trace_ring.h) is split into process streams, each
+# of them is a regular binary trace
+def read_node_trace(filename):
+  data = read_file(filename)
+
+  offset = struct.calcsize(NODE_HEADER_FORMAT)
+  if len(data) < offset:
+    raise ValueError("File is too small to be a node trace")
+  magic, version, reserved = struct.unpack_from(NODE_HEADER_FORMAT, data, 0)
+  if magic != NODE_MAGIC:
+    raise ValueError("Unknown file format")
+
+  streams = {}
+  chunk_size = struct.calcsize(NODE_CHUNK_FORMAT)
+  while offset + chunk_size <= len(data):
+    stream, size = struct.unpack_from(NODE_CHUNK_FORMAT, data, offset)
+    offset += chunk_size
+    streams.setdefault(stream, []).append(data[offset:offset + size])
+    offset += size
+
+  return [parse_trace(b"".join(streams[stream]))
+          for stream in sorted(streams)]
+
+def is_node_trace(filename):
+  return read_file(filename)[:len(NODE_MAGIC)] == NODE_MAGIC
+
+def parse_trace(data):
+  if len(data) < struct.calcsize(HEADER_FORMATS[1]):
+    raise ValueError("File is too small to be a binary trace")
+  magic, version = struct.unpack_from("<8sI", data, 0)
+  if magic != MAGIC:
+    raise ValueError("Unknown file format")
+  if version not in HEADER_FORMATS:
+    raise ValueError("Unsupported binary trace version " + str(version))
+
+  header_size = struct.calcsize(HEADER_FORMATS[version])
+  if len(data) < header_size:
+    raise ValueError("File is too small to be a binary trace")
+  fields = struct.unpack_from(HEADER_FORMATS[version], data, 0)
+  pid, start_point, process_name_id = fields[2], fields[3], fields[4]
+  rank = fields[5] if version > 1 else NO_RANK
+  epoch_point = fields[6] if version > 1 else None
+
+  strings = {}
+  records = []
+  offset = header_size
+  while offset + RECORD_SIZE <= len(data):
+    record = struct.unpack_from(RECORD_FORMAT, data, offset)
+    offset += RECORD_SIZE
+    if record[0] == RECORD_STRING:
+      size = record[2]
+      strings[record[1]] = data[offset:offset + size].decode("utf-8", "replace")
+      offset += size
+    else:
+      records.append(record)
+
+  header = {"pid" : pid, "start_point" : start_point,
+            "process_name" : strings.get(process_name_id, ""),
+            "rank" : None if rank == NO_RANK else rank,
+            "epoch_point" : epoch_point}
+  return header, strings, records
+
+def get_id(strings, record):
+  kernel_id = record[2]
+  call_id = record[3]
+  if call_id == ID_STRING:
+    return strings[kernel_id]
+  if call_id == 0:
+    return str(kernel_id)
+  return str(kernel_id) + "." + str(call_id)
+
+def get_counter_value(record):
+  return struct.unpack("<d", struct.pack("<Q", record[2]))[0]
+
+# Counter samples become Chrome counter tracks, one per device and name
+def get_counter_event(pid, strings, record, offset = 0):
+  return ("{\"ph\":\"C\", \"pid\":\"" + str(pid) +
+    "\", \"name\":\"GPU " + str(record[4]) + " " + strings[record[1]] +
+    "\", \"ts\": " + str((record[7] + offset) // NSEC_IN_USEC) +
+    ", \"args\": {\"value\": " + str(get_counter_value(record)) + "}}")
+
+def write_chrome(header, strings, records, output):
+  pid = header["pid"]
+  events = []
+  events.append("{\"ph\":\"M\", \"name\":\"process_name\", \"pid\":\"" +
+    str(pid) + "\", \"tid\":0, \"args\":{\"name\":\"" +
+    header["process_name"] + "\"}}")
+  events.append("{\"ph\":\"M\", \"name\":\"start_time\", \"pid\":\"" +
+    str(pid) + "\", \"tid\":0, \"args\":{\"start_time\":\"" +
+    str(header["start_point"]) + "\"}}")
+
+  for record in records:
+    if record[0] == RECORD_COUNTER:
+      events.append(get_counter_event(pid, strings, record))
+      continue
+    name = strings[record[1]]
+    started = record[7]
+    ended = record[8]
+    events.append("{\"ph\":\"X\", \"pid\":\"" + str(pid) +
+      "\", \"tid\":\"" + str(record[4]) +
+      "\", \"name\":\"" + name +
+      "\", \"ts\": " + str(started // NSEC_IN_USEC) +
+      ", \"dur\":" + str((ended - started) // NSEC_IN_USEC) +
+      ", \"args\": {\"id\": \"" + get_id(strings, record) + "\"}}")
+
+  output.write("[\n" + ",\n".join(events) + "\n]\n")
+
+def write_device_timeline(header, strings, records, output):
+  for record in records:
+    if record[0] != RECORD_DEVICE:
+      continue
+    output.write("Device Timeline (queue: " + hex(record[4]) + "): " +
+      strings[record[1]] + "(" + get_id(strings, record) + ") [ns] = " +
+      str(record[5]) + " (append) " +
+      str(record[6]) + " (submit) " +
+      str(record[7]) + " (start) " +
+      str(record[8]) + " (end)\n")
+
+def main():
+  mode = "--chrome"
+  args = sys.argv[1:]
+  if len(args) > 0 and (args[0] == "--chrome" or
+                        args[0] == "--device-timeline"):
+    mode = args[0]
+    args = args[1:]
+
+  if len(args) < 1 or len(args) > 2:
+    print("Usage: python binary_trace_converter.py " +
+      "[--chrome | --device-timeline] <input.bin> [<output>]")
+    return 1
+
+  header, strings, records = read_trace(args[0])
+
+  if len(args) == 2:
+    output = open(args[1], "w")
+  else:
+    output = sys.stdout
+
+  if mode == "--chrome":
+    write_chrome(header, strings, records, output)
+  else:
+    write_device_timeline(header, strings, records, output)
+
+  if output != sys.stdout:
+    output.close()
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
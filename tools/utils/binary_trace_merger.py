@@ -0,0 +1,177 @@
+#==============================================================
+# Copyright (C) Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+# =============================================================
+
+# Merges binary traces of the ranks of one MPI job (or of any set of
+# processes) produced with --binary-trace option of
+# onetrace/ze_tracer/cl_tracer, or node traces of trace_daemon, into a
+# single time-aligned Chrome JSON, or reduces them into a job-level
+# summary of kernels and API calls
+#
+# Usage: python binary_trace_merger.py [--chrome | --summary]
+#   <output> <input.bin> [<input.bin> ...]
+
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from binary_trace_converter import read_trace, read_node_trace, get_id
+from binary_trace_converter import is_node_trace, get_counter_event
+from binary_trace_converter import RECORD_DEVICE, RECORD_HOST, RECORD_COUNTER
+from binary_trace_converter import NSEC_IN_USEC
+
+NAME_LENGTH = 10
+COUNT_LENGTH = 12
+TIME_LENGTH = 20
+
+# Node traces of trace_daemon bring all the processes of the node
+def read_ranks(filename_list):
+  trace_list = []
+  for filename in filename_list:
+    if is_node_trace(filename):
+      trace_list += read_node_trace(filename)
+    else:
+      trace_list.append(read_trace(filename))
+
+  rank_list = []
+  for header, strings, records in trace_list:
+    rank = header["rank"]
+    if rank is None:
+      rank = header["pid"]
+    rank_list.append((rank, header, strings, records))
+  rank_list.sort(key = lambda value : value[0])
+  return rank_list
+
+# Timestamps of each rank are relative to its own start point. Version 2
+# traces keep the wall clock time of the start point, so the per-rank
+# offset is taken from it and is good across nodes up to clock
+# synchronization. Older traces fall back to the monotonic start point,
+# that is only comparable on a single node
+def get_offsets(rank_list):
+  use_epoch = all(value[1]["epoch_point"] is not None for value in rank_list)
+  if not use_epoch:
+    sys.stderr.write("[INFO] Some of the traces have no wall clock " +
+      "start, they are aligned by monotonic time of a single node\n")
+
+  key = "epoch_point" if use_epoch else "start_point"
+  base = min(value[1][key] for value in rank_list)
+  return [value[1][key] - base for value in rank_list]
+
+def write_chrome(rank_list, output):
+  events = []
+  offsets = get_offsets(rank_list)
+  for (rank, header, strings, records), offset in zip(rank_list, offsets):
+    events.append("{\"ph\":\"M\", \"name\":\"process_name\", \"pid\":\"" +
+      str(rank) + "\", \"tid\":0, \"args\":{\"name\":\"Rank " + str(rank) +
+      " (" + header["process_name"] + ", " + str(header["pid"]) + ")\"}}")
+    events.append("{\"ph\":\"M\", \"name\":\"process_sort_index\", " +
+      "\"pid\":\"" + str(rank) + "\", \"tid\":0, \"args\":{\"sort_index\":" +
+      str(rank) + "}}")
+
+    for record in records:
+      if record[0] == RECORD_COUNTER:
+        events.append(get_counter_event(rank, strings, record, offset))
+        continue
+      name = strings[record[1]]
+      started = record[7] + offset
+      ended = record[8] + offset
+      events.append("{\"ph\":\"X\", \"pid\":\"" + str(rank) +
+        "\", \"tid\":\"" + str(record[4]) +
+        "\", \"name\":\"" + name +
+        "\", \"ts\": " + str(started // NSEC_IN_USEC) +
+        ", \"dur\":" + str((ended - started) // NSEC_IN_USEC) +
+        ", \"args\": {\"id\": \"" + get_id(strings, record) + "\"}}")
+
+  output.write("[\n" + ",\n".join(events) + "\n]\n")
+
+# Per-rank totals of each name: {name : {rank : [calls, time]}}
+def collect(rank_list, record_type):
+  totals = {}
+  for rank, header, strings, records in rank_list:
+    for record in records:
+      if record[0] != record_type:
+        continue
+      name = strings[record[1]]
+      value = totals.setdefault(name, {}).setdefault(rank, [0, 0])
+      value[0] += 1
+      value[1] += record[8] - record[7]
+  return totals
+
+# Time columns are taken over the ranks that call the function, slowest
+# rank is the one with the largest total time
+def write_table(title, column, totals, rank_count, output):
+  if len(totals) == 0:
+    return
+
+  name_length = max([NAME_LENGTH] + [len(name) for name in totals])
+  output.write("\n== " + title + ": ==\n\n")
+  output.write(column.rjust(name_length) + "," +
+    "Ranks".rjust(COUNT_LENGTH) + "," +
+    "Calls".rjust(COUNT_LENGTH) + "," +
+    "Total Time (ns)".rjust(TIME_LENGTH) + "," +
+    "Rank Min (ns)".rjust(TIME_LENGTH) + "," +
+    "Rank Max (ns)".rjust(TIME_LENGTH) + "," +
+    "Rank Mean (ns)".rjust(TIME_LENGTH) + "," +
+    "Slowest Rank".rjust(COUNT_LENGTH) + "\n")
+
+  table = []
+  for name, ranks in totals.items():
+    times = [value[1] for value in ranks.values()]
+    calls = sum(value[0] for value in ranks.values())
+    slowest = max(ranks, key = lambda rank : ranks[rank][1])
+    table.append((sum(times), name, len(ranks), calls,
+                  min(times), max(times), sum(times) // len(times), slowest))
+  table.sort(key = lambda value : (-value[0], value[1]))
+
+  for total, name, ranks, calls, low, high, mean, slowest in table:
+    output.write(name.rjust(name_length) + "," +
+      (str(ranks) + "/" + str(rank_count)).rjust(COUNT_LENGTH) + "," +
+      str(calls).rjust(COUNT_LENGTH) + "," +
+      str(total).rjust(TIME_LENGTH) + "," +
+      str(low).rjust(TIME_LENGTH) + "," +
+      str(high).rjust(TIME_LENGTH) + "," +
+      str(mean).rjust(TIME_LENGTH) + "," +
+      str(slowest).rjust(COUNT_LENGTH) + "\n")
+
+def write_summary(rank_list, output):
+  offsets = get_offsets(rank_list)
+  output.write("=== Job Summary: ===\n\n")
+  output.write("Ranks: " + str(len(rank_list)) + "\n")
+  for (rank, header, strings, records), offset in zip(rank_list, offsets):
+    span = max([record[8] for record in records] + [0])
+    output.write("Rank " + str(rank) + " (" + header["process_name"] +
+      ", " + str(header["pid"]) + "): start offset " + str(offset) +
+      " ns, span " + str(span) + " ns\n")
+
+  write_table("Kernels", "Kernel", collect(rank_list, RECORD_DEVICE),
+              len(rank_list), output)
+  write_table("API Calls", "Function", collect(rank_list, RECORD_HOST),
+              len(rank_list), output)
+
+def main():
+  mode = "--chrome"
+  args = sys.argv[1:]
+  if len(args) > 0 and (args[0] == "--chrome" or args[0] == "--summary"):
+    mode = args[0]
+    args = args[1:]
+
+  if len(args) < 2:
+    print("Usage: python binary_trace_merger.py " +
+      "[--chrome | --summary] <output> <input.bin> [<input.bin> ...]")
+    return 1
+
+  rank_list = read_ranks(args[1:])
+
+  output = open(args[0], "w")
+  if mode == "--chrome":
+    write_chrome(rank_list, output)
+  else:
+    write_summary(rank_list, output)
+  output.close()
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
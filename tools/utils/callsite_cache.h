@@ -0,0 +1,138 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_CALLSITE_CACHE_H_
+#define PTI_TOOLS_UTILS_CALLSITE_CACHE_H_
+
+#if !defined(_WIN32)
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "string_table.h"
+
+#define CALLSITE_CACHE_STACK_DEPTH 32
+
+// Callsite of a runtime call is the first frame of the calling thread
+// outside the tool and the runtime libraries, named "symbol+offset
+// (module)" and kept in the string table. Frames are resolved once per
+// return address. Thread-safe
+class CallsiteCache {
+ public: // Interface
+  // Zero if the callsite is not known
+  uint32_t Get() {
+#if !defined(_WIN32)
+    void* frame_list[CALLSITE_CACHE_STACK_DEPTH];
+    int count = backtrace(frame_list, CALLSITE_CACHE_STACK_DEPTH);
+
+    const char* tool = GetToolModule();
+    for (int i = 1; i < count; ++i) {
+      {
+        const std::lock_guard<std::mutex> lock(lock_);
+        auto it = frame_map_.find(frame_list[i]);
+        if (it != frame_map_.end()) {
+          if (it->second == kSkippedFrame) {
+            continue;
+          }
+          return it->second;
+        }
+      }
+
+      uint32_t callsite_id = GetFrameName(frame_list[i], tool);
+      const std::lock_guard<std::mutex> lock(lock_);
+      frame_map_[frame_list[i]] = callsite_id;
+      if (callsite_id != kSkippedFrame) {
+        return callsite_id;
+      }
+    }
+#endif
+    return 0;
+  }
+
+  static const std::string& GetName(uint32_t callsite_id) {
+    static const std::string unknown = "<unknown>";
+    return (callsite_id == 0) ? unknown : StringTable::Get(callsite_id);
+  }
+
+#if !defined(_WIN32)
+  // Module the tool is loaded from, nullptr if not known
+  static const char* GetToolModule() {
+    Dl_info tool_info{};
+    if (dladdr(reinterpret_cast<void*>(&CallsiteCache::GetName),
+               &tool_info) == 0) {
+      return nullptr;
+    }
+    return tool_info.dli_fname;
+  }
+
+  // Frames of the tool itself and of the runtime stack under the
+  // application are skipped
+  static bool IsRuntimeModule(const char* module, const char* tool) {
+    if (module == nullptr) {
+      return false;
+    }
+    if (tool != nullptr && strcmp(module, tool) == 0) {
+      return true;
+    }
+    const char* runtime_list[] = {
+        "libze_", "libpi_", "libur_", "libsycl", "libomptarget",
+        "libOpenCL", "libigdrcl"};
+    for (const char* runtime : runtime_list) {
+      if (strstr(module, runtime) != nullptr) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Frame name id in the string table, kSkippedFrame for the frames
+  // of the tool and the runtimes or of an unknown module
+  static uint32_t GetFrameName(void* frame, const char* tool) {
+    Dl_info info{};
+    if (dladdr(frame, &info) == 0) {
+      return kSkippedFrame;
+    }
+    if (IsRuntimeModule(info.dli_fname, tool)) {
+      return kSkippedFrame;
+    }
+
+    std::string module = (info.dli_fname == nullptr) ? "" : info.dli_fname;
+    size_t slash = module.find_last_of('/');
+    if (slash != std::string::npos) {
+      module = module.substr(slash + 1);
+    }
+
+    std::stringstream stream;
+    uintptr_t address = reinterpret_cast<uintptr_t>(frame);
+    if (info.dli_sname != nullptr && info.dli_saddr != nullptr) {
+      stream << info.dli_sname << "+0x" << std::hex <<
+        address - reinterpret_cast<uintptr_t>(info.dli_saddr);
+    } else {
+      stream << "0x" << std::hex <<
+        address - reinterpret_cast<uintptr_t>(info.dli_fbase);
+    }
+    stream << " (" << module << ")";
+    return StringTable::Add(stream.str());
+  }
+#endif
+
+  static const uint32_t kSkippedFrame = 0xFFFFFFFF;
+
+ private: // Data
+
+  std::unordered_map<void*, uint32_t> frame_map_;
+  std::mutex lock_;
+};
+
+#endif // PTI_TOOLS_UTILS_CALLSITE_CACHE_H_
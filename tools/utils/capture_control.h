@@ -0,0 +1,348 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_CAPTURE_CONTROL_H_
+#define PTI_TOOLS_UTILS_CAPTURE_CONTROL_H_
+
+#if !defined(_WIN32)
+#include <signal.h>
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "pti_assert.h"
+#include "string_table.h"
+#include "utils.h"
+
+#define CAPTURE_CONTROL_POLL_INTERVAL 50 // ms
+
+// Conditions of the capture window, capture is on from the very start
+// if no start condition is given
+struct CaptureOptions {
+  uint32_t delay = 0; // ms from tool start, 0 if not used
+  uint32_t duration = 0; // ms from capture start, 0 for no limit
+  std::string kernel; // Capture starts after the launch of the kernel
+  uint32_t kernel_count = 1; // ... with the given number
+  std::string control_file; // Capture is on while the file exists
+  bool signal = false; // SIGUSR1 starts capture, SIGUSR2 stops it
+  bool external = false; // Application pauses and resumes capture (ITT)
+  bool paused = false; // Capture is off until the application resumes it
+
+  bool IsEnabled() const {
+    return duration > 0 || external || HasStartCondition();
+  }
+
+  bool HasStartCondition() const {
+    return delay > 0 || !kernel.empty() || !control_file.empty() ||
+      signal || paused;
+  }
+
+  // Options are passed from the launcher through environment variables
+  // with the tool-specific prefix
+  static CaptureOptions Read(const std::string& prefix) {
+    CaptureOptions options;
+    std::string value;
+
+    value = utils::GetEnv((prefix + "CaptureDelay").c_str());
+    if (!value.empty()) {
+      options.delay = std::stoul(value);
+    }
+
+    value = utils::GetEnv((prefix + "CaptureDuration").c_str());
+    if (!value.empty()) {
+      options.duration = std::stoul(value);
+    }
+
+    options.kernel = utils::GetEnv((prefix + "CaptureKernel").c_str());
+
+    value = utils::GetEnv((prefix + "CaptureKernelCount").c_str());
+    if (!value.empty()) {
+      options.kernel_count = std::stoul(value);
+      PTI_ASSERT(options.kernel_count > 0);
+    }
+
+    options.control_file = utils::GetEnv((prefix + "CaptureFile").c_str());
+
+    value = utils::GetEnv((prefix + "CaptureSignal").c_str());
+    if (!value.empty() && value == "1") {
+      options.signal = true;
+    }
+
+    return options;
+  }
+};
+
+typedef void (*OnCaptureChangeCallback)(void* data, bool active);
+
+// Turns data collection on and off according to the capture options.
+// Collectors check IsActive (or CheckLaunch for kernels) on their hot
+// paths, while the owner is notified about each transition from the
+// control thread to switch off the tracing of API calls completely.
+// If the control file is given, it alone starts and stops the capture
+// (with respect to duration), other start conditions are ignored.
+// Once the capture is stopped by duration, it is never started again.
+// The application itself may pause and resume the capture as well
+class CaptureControl {
+ public: // Interface
+  // Returns nullptr if the whole run is to be captured
+  static CaptureControl* Create(const CaptureOptions& options) {
+    if (!options.IsEnabled()) {
+      return nullptr;
+    }
+    CaptureControl* control = new CaptureControl(options);
+    PTI_ASSERT(control != nullptr);
+    return control;
+  }
+
+  ~CaptureControl() {
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      stop_ = true;
+    }
+    wakeup_.notify_one();
+    if (control_thread_.joinable()) {
+      control_thread_.join();
+    }
+  }
+
+  // Callback is called once with the initial state right away and then
+  // on each transition from the control thread
+  void Start(OnCaptureChangeCallback callback, void* data) {
+    PTI_ASSERT(callback != nullptr);
+    PTI_ASSERT(!control_thread_.joinable());
+    const std::lock_guard<std::mutex> lock(state_lock_);
+    callback_ = callback;
+    callback_data_ = data;
+    callback_(callback_data_, IsActive());
+    control_thread_ = std::thread(&CaptureControl::Run, this);
+  }
+
+  bool IsActive() const {
+    return active_.load(std::memory_order_acquire);
+  }
+
+  // Called for each kernel launch, returns true if the launch is inside
+  // the capture window. The trigger launch itself is not captured
+  bool CheckLaunch(uint32_t name_id) {
+    if (IsActive()) {
+      return true;
+    }
+
+    if (!options_.kernel.empty() && options_.control_file.empty() &&
+        name_id == kernel_id_) {
+      uint64_t count = kernel_count_.fetch_add(
+          1, std::memory_order_relaxed) + 1;
+      if (count == options_.kernel_count) {
+        kernel_triggered_.store(true, std::memory_order_release);
+        wakeup_.notify_one();
+      }
+    }
+    return false;
+  }
+
+  // Requests from the application (e.g. __itt_pause and __itt_resume)
+  // take effect right away on the calling thread
+  void Pause() {
+    PTI_ASSERT(options_.external);
+    const std::lock_guard<std::mutex> lock(state_lock_);
+    if (IsActive()) {
+      SetActive(false);
+    }
+  }
+
+  void Resume() {
+    PTI_ASSERT(options_.external);
+    const std::lock_guard<std::mutex> lock(state_lock_);
+    if (!IsActive() && !finished_) {
+      window_start_ = std::chrono::steady_clock::now();
+      SetActive(true);
+    }
+  }
+
+  CaptureControl(const CaptureControl& copy) = delete;
+  CaptureControl& operator=(const CaptureControl& copy) = delete;
+
+ private: // Implementation
+  explicit CaptureControl(const CaptureOptions& options)
+      : options_(options),
+        start_time_(std::chrono::steady_clock::now()),
+        window_start_(start_time_) {
+    active_ = !options_.HasStartCondition();
+    if (!options_.kernel.empty()) {
+      kernel_id_ = StringTable::Add(options_.kernel);
+    }
+    if (options_.signal) {
+      SetSignalHandlers();
+    }
+  }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!stop_) {
+      wakeup_.wait_for(
+          lock, std::chrono::milliseconds(CAPTURE_CONTROL_POLL_INTERVAL),
+          [this] {
+            return stop_ ||
+              kernel_triggered_.load(std::memory_order_acquire);
+          });
+      if (stop_) {
+        break;
+      }
+      lock.unlock();
+      Update();
+      lock.lock();
+    }
+  }
+
+  void Update() {
+    const std::lock_guard<std::mutex> lock(state_lock_);
+    bool triggered =
+      kernel_triggered_.exchange(false, std::memory_order_acq_rel);
+    if (finished_) {
+      return;
+    }
+
+    std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+    if (!IsActive()) {
+      bool start = false;
+      if (!options_.control_file.empty()) {
+        start = IsFileExist(options_.control_file);
+      } else {
+        if (options_.delay > 0 && !delay_passed_ &&
+            now - start_time_ >= std::chrono::milliseconds(options_.delay)) {
+          delay_passed_ = true;
+          start = true;
+        }
+        if (triggered) {
+          start = true;
+        }
+      }
+      if (options_.signal &&
+          GetStartSignal().exchange(false, std::memory_order_acq_rel)) {
+        start = true;
+      }
+      GetStopSignal().store(false, std::memory_order_release);
+
+      if (start) {
+        window_start_ = now;
+        SetActive(true);
+      }
+    } else {
+      bool stop = false;
+      if (options_.duration > 0 &&
+          now - window_start_ >= std::chrono::milliseconds(options_.duration)) {
+        stop = true;
+        finished_ = true;
+      }
+      if (!options_.control_file.empty() &&
+          !IsFileExist(options_.control_file)) {
+        stop = true;
+      }
+      if (options_.signal &&
+          GetStopSignal().exchange(false, std::memory_order_acq_rel)) {
+        stop = true;
+      }
+      GetStartSignal().store(false, std::memory_order_release);
+
+      if (stop) {
+        SetActive(false);
+      }
+    }
+  }
+
+  // Owner is not notified until the control is started
+  void SetActive(bool active) {
+    if (active) {
+      active_.store(true, std::memory_order_release);
+      if (callback_ != nullptr) {
+        callback_(callback_data_, true);
+      }
+    } else {
+      if (callback_ != nullptr) {
+        callback_(callback_data_, false);
+      }
+      active_.store(false, std::memory_order_release);
+    }
+  }
+
+  static bool IsFileExist(const std::string& path) {
+    std::ifstream file(path);
+    return file.good();
+  }
+
+  static std::atomic<bool>& GetStartSignal() {
+    static std::atomic<bool> received{false};
+    return received;
+  }
+
+  static std::atomic<bool>& GetStopSignal() {
+    static std::atomic<bool> received{false};
+    return received;
+  }
+
+  // Handlers only raise the flags, the state is changed by the control
+  // thread. Handlers set by the application before are replaced
+  static void SetSignalHandlers() {
+#if !defined(_WIN32)
+    struct sigaction action = {};
+    action.sa_handler = OnSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    int status = sigaction(SIGUSR1, &action, nullptr);
+    PTI_ASSERT(status == 0);
+    status = sigaction(SIGUSR2, &action, nullptr);
+    PTI_ASSERT(status == 0);
+#else
+    std::cerr << "[WARNING] Capture signals are not supported" << std::endl;
+#endif
+  }
+
+#if !defined(_WIN32)
+  static void OnSignal(int signal) {
+    if (signal == SIGUSR1) {
+      GetStartSignal().store(true, std::memory_order_release);
+    } else if (signal == SIGUSR2) {
+      GetStopSignal().store(true, std::memory_order_release);
+    }
+  }
+#endif
+
+ private: // Data
+  CaptureOptions options_;
+  std::atomic<bool> active_{false};
+
+  OnCaptureChangeCallback callback_ = nullptr;
+  void* callback_data_ = nullptr;
+
+  uint32_t kernel_id_ = 0;
+  std::atomic<uint64_t> kernel_count_{0};
+  std::atomic<bool> kernel_triggered_{false};
+
+  // Guarded by the state lock
+  std::mutex state_lock_;
+  std::chrono::steady_clock::time_point start_time_;
+  std::chrono::steady_clock::time_point window_start_;
+  bool delay_passed_ = false;
+  bool finished_ = false;
+
+  std::thread control_thread_;
+  std::mutex lock_;
+  std::condition_variable wakeup_;
+  bool stop_ = false;
+};
+
+#endif // PTI_TOOLS_UTILS_CAPTURE_CONTROL_H_
@@ -0,0 +1,194 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_CLOCK_DOMAIN_H_
+#define PTI_TOOLS_UTILS_CLOCK_DOMAIN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+
+#include "pti_assert.h"
+#include "utils.h"
+
+#define CLOCK_DOMAIN_SAMPLE_COUNT 16
+
+// Linear model that maps device timer ticks to host time in ns and back.
+// The model is a least squares fit over the latest (host, device) sync
+// samples, so the drift between the clocks is followed over long runs.
+// Device timestamps may wrap around timestamp_mask, samples and the model
+// itself use unwrapped (monotonic) ticks. The class is not thread-safe,
+// the caller is responsible for synchronization
+class ClockDomain {
+ public: // Interface
+  ClockDomain(uint64_t frequency, uint64_t timestamp_mask)
+      : timestamp_mask_(timestamp_mask),
+        nominal_slope_(static_cast<double>(frequency) / NSEC_IN_SEC) {
+    PTI_ASSERT(frequency > 0);
+    PTI_ASSERT(timestamp_mask_ > 0);
+    slope_ = nominal_slope_;
+  }
+
+  // Host time is in ns, device time is a raw (masked) timer value
+  void AddSample(uint64_t host_time, uint64_t device_time) {
+    uint64_t device = device_time & timestamp_mask_;
+    if (!sample_list_.empty()) {
+      device = Unwrap(device, host_time);
+    }
+
+    if (!sample_list_.empty() && host_time <= sample_list_.back().host) {
+      return;
+    }
+
+    sample_list_.push_back({host_time, device});
+    if (sample_list_.size() > CLOCK_DOMAIN_SAMPLE_COUNT) {
+      sample_list_.pop_front();
+    }
+    Fit();
+  }
+
+  size_t GetSampleCount() const {
+    return sample_list_.size();
+  }
+
+  uint64_t GetLastSampleTime() const {
+    PTI_ASSERT(!sample_list_.empty());
+    return sample_list_.back().host;
+  }
+
+  uint64_t GetTimestampMask() const {
+    return timestamp_mask_;
+  }
+
+  // Returns unwrapped device ticks for the given host time
+  uint64_t ToDevice(uint64_t host_time) const {
+    PTI_ASSERT(!sample_list_.empty());
+    double shift = Distance(host_time, host_base_);
+    return Shift(device_base_, intercept_ + slope_ * shift);
+  }
+
+  // Takes unwrapped device ticks, returns host time in ns
+  uint64_t ToHost(uint64_t device_time) const {
+    PTI_ASSERT(!sample_list_.empty());
+    double shift = Distance(device_time, device_base_);
+    return Shift(host_base_, (shift - intercept_) / slope_);
+  }
+
+  // Bulk version of the conversion above, the loop has no branches and
+  // no calls, so the compiler is free to vectorize it. Device values are
+  // expected to be not earlier than the first sample of the model
+  void ToHost(const uint64_t* device_time, uint64_t* host_time,
+              size_t count) const {
+    PTI_ASSERT(count == 0 || !sample_list_.empty());
+    PTI_ASSERT(count == 0 || (device_time != nullptr && host_time != nullptr));
+    const double scale = 1.0 / slope_;
+    const double offset = 0.5 - intercept_ * scale;
+    const uint64_t device_base = device_base_;
+    const uint64_t host_base = host_base_;
+    for (size_t i = 0; i < count; ++i) {
+      double shift = static_cast<double>(
+          static_cast<int64_t>(device_time[i] - device_base));
+      host_time[i] = host_base +
+        static_cast<uint64_t>(static_cast<int64_t>(offset + shift * scale));
+    }
+  }
+
+  // Restores the high bits of the masked device timestamp, choosing the
+  // value that is closest to the one expected at host_hint time
+  uint64_t Unwrap(uint64_t device_time, uint64_t host_hint) const {
+    PTI_ASSERT(!sample_list_.empty());
+    device_time &= timestamp_mask_;
+    if (timestamp_mask_ == UINT64_MAX) {
+      return device_time;
+    }
+
+    uint64_t period = timestamp_mask_ + 1;
+    uint64_t expected = ToDevice(host_hint);
+    uint64_t epoch = expected & ~timestamp_mask_;
+    uint64_t value = epoch + device_time;
+    if (value > expected && value - expected > period / 2 &&
+        value >= period) {
+      value -= period;
+    } else if (value < expected && expected - value > period / 2) {
+      value += period;
+    }
+    return value;
+  }
+
+  ClockDomain(const ClockDomain& copy) = default;
+  ClockDomain& operator=(const ClockDomain& copy) = default;
+
+ private: // Implementation
+  struct Sample {
+    uint64_t host;
+    uint64_t device;
+  };
+
+  // Differences are taken in integers first, so that large absolute
+  // timestamps do not lose precision in double
+  static double Distance(uint64_t value, uint64_t base) {
+    return static_cast<double>(static_cast<int64_t>(value - base));
+  }
+
+  static uint64_t Shift(uint64_t base, double shift) {
+    int64_t delta = static_cast<int64_t>(
+        (shift < 0.0) ? shift - 0.5 : shift + 0.5);
+    if (delta < 0 && static_cast<uint64_t>(-delta) > base) {
+      return 0;
+    }
+    return base + static_cast<uint64_t>(delta);
+  }
+
+  // Model is device = device_base_ + intercept_ + slope_ * (host -
+  // host_base_), with the first sample taken as a base
+  void Fit() {
+    PTI_ASSERT(!sample_list_.empty());
+    host_base_ = sample_list_.front().host;
+    device_base_ = sample_list_.front().device;
+
+    if (sample_list_.size() == 1) {
+      slope_ = nominal_slope_;
+      intercept_ = 0.0;
+      return;
+    }
+
+    double count = static_cast<double>(sample_list_.size());
+    double mean_x = 0.0, mean_y = 0.0;
+    for (const Sample& sample : sample_list_) {
+      mean_x += Distance(sample.host, host_base_);
+      mean_y += Distance(sample.device, device_base_);
+    }
+    mean_x /= count;
+    mean_y /= count;
+
+    double sum_xx = 0.0, sum_xy = 0.0;
+    for (const Sample& sample : sample_list_) {
+      double x = Distance(sample.host, host_base_) - mean_x;
+      double y = Distance(sample.device, device_base_) - mean_y;
+      sum_xx += x * x;
+      sum_xy += x * y;
+    }
+
+    slope_ = (sum_xx > 0.0) ? sum_xy / sum_xx : 0.0;
+    if (slope_ <= 0.0) {
+      slope_ = nominal_slope_;
+    }
+    intercept_ = mean_y - slope_ * mean_x;
+  }
+
+ private: // Data
+  uint64_t timestamp_mask_ = 0;
+  double nominal_slope_ = 0.0; // ticks per ns
+
+  std::deque<Sample> sample_list_;
+  uint64_t host_base_ = 0;
+  uint64_t device_base_ = 0;
+  double slope_ = 0.0;
+  double intercept_ = 0.0;
+};
+
+#endif // PTI_TOOLS_UTILS_CLOCK_DOMAIN_H_
@@ -0,0 +1,85 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include "collector_api.h"
+
+extern "C" {
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+uint32_t ptiCollectorGetVersion(void) {
+  return PTI_COLLECTOR_API_VERSION;
+}
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+pti_collector_result_t ptiCollectorStart(void) {
+  return CollectorApi::OnStart();
+}
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+pti_collector_result_t ptiCollectorStop(void) {
+  return CollectorApi::OnStop();
+}
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+pti_collector_result_t ptiCollectorPushRange(const char* name) {
+  return CollectorApi::OnPushRange(name);
+}
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+pti_collector_result_t ptiCollectorPopRange(void) {
+  return CollectorApi::OnPopRange();
+}
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+pti_collector_result_t ptiCollectorFlush(void) {
+  return CollectorApi::OnFlush();
+}
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+pti_collector_result_t ptiCollectorGetKernelStats(
+    pti_collector_stats_t* stats_list, uint32_t* count) {
+  return CollectorApi::OnGetKernelStats(stats_list, count);
+}
+
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+pti_collector_result_t ptiCollectorGetApiStats(
+    pti_collector_stats_t* stats_list, uint32_t* count) {
+  return CollectorApi::OnGetApiStats(stats_list, count);
+}
+
+} // extern "C"
@@ -0,0 +1,209 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_COLLECTOR_API_H_
+#define PTI_TOOLS_UTILS_COLLECTOR_API_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+#include "atomic_stat_table.h"
+#include "capture_control.h"
+#include "itt_collector.h"
+#include "pti_assert.h"
+#include "pti_collector.h"
+
+#define COLLECTOR_API_RANGE_DOMAIN "pti"
+
+typedef void (*OnCollectorFlushCallback)(void* data);
+
+// Tool side of pti_collector.h: the tool library exports the entry points
+// (see collector_api.cc) and they are served by the registered instance.
+// Start and stop resume and pause the capture, so the capture must start
+// paused and be external. Ranges are ITT tasks of their own domain and
+// need ITT collector to be created. Aggregates are kept in lock-free
+// tables, so the application may read them at any time
+class CollectorApi {
+ public: // User Interface
+  static CollectorApi* Create(
+      CaptureControl* capture,
+      OnCollectorFlushCallback callback,
+      void* callback_data) {
+    PTI_ASSERT(capture != nullptr);
+    PTI_ASSERT(callback != nullptr);
+    CollectorApi* api = new CollectorApi(capture, callback, callback_data);
+    PTI_ASSERT(api != nullptr);
+
+    CollectorApi* previous = nullptr;
+    bool registered = GetInstance().compare_exchange_strong(
+        previous, api, std::memory_order_acq_rel);
+    PTI_ASSERT(registered);
+    return api;
+  }
+
+  ~CollectorApi() {
+    DisableTracing();
+  }
+
+  void DisableTracing() {
+    CollectorApi* api = this;
+    GetInstance().compare_exchange_strong(
+        api, nullptr, std::memory_order_acq_rel);
+  }
+
+  void AddKernel(const std::string& name, uint64_t time) {
+    kernel_table_.Add(name, time);
+  }
+
+  void AddFunction(const std::string& name, uint64_t time) {
+    function_table_.Add(name, time);
+  }
+
+  CollectorApi(const CollectorApi& copy) = delete;
+  CollectorApi& operator=(const CollectorApi& copy) = delete;
+
+ public: // C Interface
+  static pti_collector_result_t OnStart() {
+    CollectorApi* api = GetInstance().load(std::memory_order_acquire);
+    if (api == nullptr) {
+      return PTI_COLLECTOR_ERROR_NOT_ENABLED;
+    }
+    api->capture_->Resume();
+    return PTI_COLLECTOR_SUCCESS;
+  }
+
+  static pti_collector_result_t OnStop() {
+    CollectorApi* api = GetInstance().load(std::memory_order_acquire);
+    if (api == nullptr) {
+      return PTI_COLLECTOR_ERROR_NOT_ENABLED;
+    }
+    api->capture_->Pause();
+    return PTI_COLLECTOR_SUCCESS;
+  }
+
+  static pti_collector_result_t OnPushRange(const char* name) {
+    if (name == nullptr) {
+      return PTI_COLLECTOR_ERROR_INVALID_ARGUMENT;
+    }
+    CollectorApi* api = GetInstance().load(std::memory_order_acquire);
+    if (api == nullptr) {
+      return PTI_COLLECTOR_ERROR_NOT_ENABLED;
+    }
+    IttCollector::OnTaskBegin(
+        api->domain_, IttCollector::CreateStringHandle(name));
+    return PTI_COLLECTOR_SUCCESS;
+  }
+
+  static pti_collector_result_t OnPopRange() {
+    CollectorApi* api = GetInstance().load(std::memory_order_acquire);
+    if (api == nullptr) {
+      return PTI_COLLECTOR_ERROR_NOT_ENABLED;
+    }
+    IttCollector::OnTaskEnd(api->domain_);
+    return PTI_COLLECTOR_SUCCESS;
+  }
+
+  static pti_collector_result_t OnFlush() {
+    CollectorApi* api = GetInstance().load(std::memory_order_acquire);
+    if (api == nullptr) {
+      return PTI_COLLECTOR_ERROR_NOT_ENABLED;
+    }
+    api->callback_(api->callback_data_);
+    return PTI_COLLECTOR_SUCCESS;
+  }
+
+  static pti_collector_result_t OnGetKernelStats(
+      pti_collector_stats_t* stats_list, uint32_t* count) {
+    CollectorApi* api = GetInstance().load(std::memory_order_acquire);
+    if (api == nullptr) {
+      return PTI_COLLECTOR_ERROR_NOT_ENABLED;
+    }
+    return ReadStats(api->kernel_table_, stats_list, count);
+  }
+
+  static pti_collector_result_t OnGetApiStats(
+      pti_collector_stats_t* stats_list, uint32_t* count) {
+    CollectorApi* api = GetInstance().load(std::memory_order_acquire);
+    if (api == nullptr) {
+      return PTI_COLLECTOR_ERROR_NOT_ENABLED;
+    }
+    return ReadStats(api->function_table_, stats_list, count);
+  }
+
+ private: // Implementation Details
+  CollectorApi(
+      CaptureControl* capture,
+      OnCollectorFlushCallback callback,
+      void* callback_data)
+      : capture_(capture),
+        callback_(callback),
+        callback_data_(callback_data),
+        domain_(IttCollector::CreateDomain(COLLECTOR_API_RANGE_DOMAIN)) {
+    PTI_ASSERT(domain_ != nullptr);
+  }
+
+  static std::atomic<CollectorApi*>& GetInstance() {
+    static std::atomic<CollectorApi*> instance{nullptr};
+    return instance;
+  }
+
+  // Entries are read one by one while they may be updated, so the values
+  // of one entry may be a few calls apart
+  static pti_collector_result_t ReadStats(
+      const AtomicStatTable& table,
+      pti_collector_stats_t* stats_list, uint32_t* count) {
+    if (count == nullptr) {
+      return PTI_COLLECTOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    uint32_t stats_count = 0;
+    AtomicStatTable::Snapshot snapshot{};
+    for (uint32_t i = 0; i < ATOMIC_STAT_TABLE_SIZE; ++i) {
+      if (stats_list != nullptr && stats_count >= *count) {
+        break;
+      }
+      const std::string* name = table.Read(i, &snapshot);
+      if (name == nullptr || snapshot.call_count == 0) {
+        continue;
+      }
+
+      if (stats_list != nullptr) {
+        pti_collector_stats_t& stats = stats_list[stats_count];
+        size_t length = name->size();
+        if (length >= PTI_COLLECTOR_NAME_SIZE) {
+          length = PTI_COLLECTOR_NAME_SIZE - 1;
+        }
+        memcpy(stats.name, name->data(), length);
+        stats.name[length] = '\0';
+        stats.call_count = snapshot.call_count;
+        stats.total_time = snapshot.total_time;
+        stats.min_time = (std::min)(snapshot.min_time, snapshot.max_time);
+        stats.max_time = snapshot.max_time;
+      }
+      ++stats_count;
+    }
+
+    *count = stats_count;
+    return PTI_COLLECTOR_SUCCESS;
+  }
+
+ private: // Data
+  CaptureControl* capture_ = nullptr;
+
+  OnCollectorFlushCallback callback_ = nullptr;
+  void* callback_data_ = nullptr;
+
+  const IttDomain* domain_ = nullptr;
+
+  AtomicStatTable kernel_table_;
+  AtomicStatTable function_table_;
+};
+
+#endif // PTI_TOOLS_UTILS_COLLECTOR_API_H_
@@ -0,0 +1,70 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_COMPLETION_QUEUE_H_
+#define PTI_TOOLS_UTILS_COMPLETION_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include "pti_assert.h"
+
+// Lock-free queue for any number of producer threads (e.g. the ones the
+// driver calls completion callbacks on) and a single consumer. Records are
+// linked through their own next_completed field, so a push never allocates
+// and never blocks. The consumer takes all the records at once, so there
+// is no ABA problem for the producers
+template <typename T>
+class CompletionQueue {
+ public: // Interface
+  void Push(T* record) {
+    PTI_ASSERT(record != nullptr);
+    T* head = head_.load(std::memory_order_relaxed);
+    do {
+      record->next_completed = head;
+    } while (!head_.compare_exchange_weak(
+        head, record, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  // Consumer side, calls f for each record taken from the queue in the
+  // order of push
+  template <typename F>
+  size_t Drain(F f) {
+    T* head = head_.exchange(nullptr, std::memory_order_acquire);
+
+    T* list = nullptr;
+    while (head != nullptr) {
+      T* next = head->next_completed;
+      head->next_completed = list;
+      list = head;
+      head = next;
+    }
+
+    size_t count = 0;
+    while (list != nullptr) {
+      T* next = list->next_completed;
+      list->next_completed = nullptr;
+      f(list);
+      list = next;
+      ++count;
+    }
+    return count;
+  }
+
+  bool IsEmpty() const {
+    return head_.load(std::memory_order_acquire) == nullptr;
+  }
+
+  CompletionQueue() = default;
+  CompletionQueue(const CompletionQueue& copy) = delete;
+  CompletionQueue& operator=(const CompletionQueue& copy) = delete;
+
+ private: // Data
+  std::atomic<T*> head_{nullptr};
+};
+
+#endif // PTI_TOOLS_UTILS_COMPLETION_QUEUE_H_
@@ -8,11 +8,13 @@
 #define PTI_TOOLS_UTILS_CORRELATOR_H_
 
 #include <chrono>
-#include <map>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include <level_zero/ze_api.h>
 
+#include "flat_hash_map.h"
 #include "logger.h"
 #include "pti_assert.h"
 
@@ -22,23 +24,37 @@
 #define PTI_CLOCK std::chrono::steady_clock
 #endif
 
+#define CORRELATOR_ID_LIST_CAPACITY 64 // Commands per list reserved upfront
+
 using TimePoint = std::chrono::time_point<PTI_CLOCK>;
 
 struct ApiCollectorOptions {
   bool call_tracing;
   bool need_tid;
   bool need_pid;
+  std::string include_api; // API filter patterns, see ApiFilter
+  std::string exclude_api;
+  uint32_t api_subsets; // Zero for all the functions, see ApiFilter
 };
 
 class Correlator {
  public:
-  Correlator(const std::string& log_file)
-      : logger_(log_file), base_time_(PTI_CLOCK::now()) {}
+  Correlator(const std::string& log_file, bool async_logging = false,
+             size_t log_buffer_size = Logger::kDefaultBufferSize,
+             const std::string& compression = std::string())
+      : logger_(log_file, async_logging, log_buffer_size, compression),
+        base_time_(PTI_CLOCK::now()),
+        epoch_point_(GetEpochTime()) {}
 
   void Log(const std::string& text) {
     logger_.Log(text);
   }
 
+  // Compression method may add an extension to the given name
+  const std::string& GetLogFileName() const {
+    return logger_.GetFileName();
+  }
+
   uint64_t GetTimestamp() const {
     std::chrono::duration<uint64_t, std::nano> timestamp =
       PTI_CLOCK::now() - base_time_;
@@ -51,6 +67,12 @@ class Correlator {
     return start_point.count();
   }
 
+  // Wall clock time of the start point, is used to align the traces of
+  // different processes and nodes
+  uint64_t GetEpochPoint() const {
+    return epoch_point_;
+  }
+
   uint64_t GetKernelId() const {
     return kernel_id_;
   }
@@ -59,70 +81,95 @@ class Correlator {
     kernel_id_ = kernel_id;
   }
 
-  std::vector<uint64_t> GetKernelId(
-      ze_command_list_handle_t command_list) {
-    PTI_ASSERT(command_list != nullptr);
-    if (kernel_id_map_.count(command_list) > 0) {
-      return kernel_id_map_[command_list];
-    } else {
-      return std::vector<uint64_t>();
-    }
-  }
+  // Kernel IDs of the commands appended to a command list and call IDs
+  // of their last submission are kept side by side, appends and
+  // submissions come from any thread, so the lists are guarded by a lock
 
-  void CreateKernelIdList(ze_command_list_handle_t command_list) {
-    PTI_ASSERT(kernel_id_map_.count(command_list) == 0);
-    kernel_id_map_[command_list] = std::vector<uint64_t>();
+  void CreateIdList(ze_command_list_handle_t command_list) {
+    PTI_ASSERT(command_list != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    PTI_ASSERT(id_list_map_.Find(command_list) == nullptr);
+    IdList& id_list = id_list_map_[command_list];
+    id_list.kernel_id_list.reserve(CORRELATOR_ID_LIST_CAPACITY);
+    id_list.call_id_list.reserve(CORRELATOR_ID_LIST_CAPACITY);
   }
 
-  void RemoveKernelIdList(ze_command_list_handle_t command_list) {
-    PTI_ASSERT(kernel_id_map_.count(command_list) == 1);
-    kernel_id_map_.erase(command_list);
+  void RemoveIdList(ze_command_list_handle_t command_list) {
+    PTI_ASSERT(command_list != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    bool removed = id_list_map_.Erase(command_list);
+    PTI_ASSERT(removed);
   }
 
-  void ResetKernelIdList(ze_command_list_handle_t command_list) {
-    PTI_ASSERT(kernel_id_map_.count(command_list) == 1);
-    kernel_id_map_[command_list].clear();
+  // Capacity is kept for the commands appended after the reset
+  void ResetIdList(ze_command_list_handle_t command_list) {
+    PTI_ASSERT(command_list != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    IdList& id_list = GetIdList(command_list);
+    id_list.kernel_id_list.clear();
+    id_list.call_id_list.clear();
   }
 
   void AddKernelId(ze_command_list_handle_t command_list, uint64_t kernel_id) {
-    PTI_ASSERT(kernel_id_map_.count(command_list) == 1);
-    kernel_id_map_[command_list].push_back(kernel_id);
+    PTI_ASSERT(command_list != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    GetIdList(command_list).kernel_id_list.push_back(kernel_id);
   }
 
-  std::vector<uint64_t> GetCallId(
-      ze_command_list_handle_t command_list) {
+  // Call IDs of a regular command list are replaced on each execution
+  void ResetCallIdList(ze_command_list_handle_t command_list) {
     PTI_ASSERT(command_list != nullptr);
-    if (call_id_map_.count(command_list) > 0) {
-      return call_id_map_[command_list];
-    } else {
-      return std::vector<uint64_t>();
-    }
+    const std::lock_guard<std::mutex> lock(lock_);
+    GetIdList(command_list).call_id_list.clear();
   }
 
-  void CreateCallIdList(ze_command_list_handle_t command_list) {
-    PTI_ASSERT(call_id_map_.count(command_list) == 0);
-    call_id_map_[command_list] = std::vector<uint64_t>();
+  void AddCallId(ze_command_list_handle_t command_list, uint64_t call_id) {
+    PTI_ASSERT(command_list != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    GetIdList(command_list).call_id_list.push_back(call_id);
   }
 
-  void RemoveCallIdList(ze_command_list_handle_t command_list) {
-    PTI_ASSERT(call_id_map_.count(command_list) == 1);
-    call_id_map_.erase(command_list);
+  // Visits kernel and call ID of each command of the list in place, under
+  // the lock, so the visitor must not call the correlator back. Lists
+  // unknown to the correlator have no commands
+  template <typename F>
+  void ForEachKernelCall(ze_command_list_handle_t command_list, F visitor) {
+    PTI_ASSERT(command_list != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    const IdList* id_list = id_list_map_.Find(command_list);
+    if (id_list == nullptr) {
+      return;
+    }
+    PTI_ASSERT(id_list->kernel_id_list.size() ==
+               id_list->call_id_list.size());
+    for (size_t i = 0; i < id_list->kernel_id_list.size(); ++i) {
+      visitor(id_list->kernel_id_list[i], id_list->call_id_list[i]);
+    }
   }
 
-  void ResetCallIdList(ze_command_list_handle_t command_list) {
-    PTI_ASSERT(call_id_map_.count(command_list) == 1);
-    call_id_map_[command_list].clear();
+ private:
+  struct IdList {
+    std::vector<uint64_t> kernel_id_list;
+    std::vector<uint64_t> call_id_list;
+  };
+
+  IdList& GetIdList(ze_command_list_handle_t command_list) {
+    IdList* id_list = id_list_map_.Find(command_list);
+    PTI_ASSERT(id_list != nullptr);
+    return *id_list;
   }
 
-  void AddCallId(ze_command_list_handle_t command_list, uint64_t call_id) {
-    PTI_ASSERT(call_id_map_.count(command_list) == 1);
-    call_id_map_[command_list].push_back(call_id);
+  static uint64_t GetEpochTime() {
+    std::chrono::duration<uint64_t, std::nano> epoch_time =
+      std::chrono::system_clock::now().time_since_epoch();
+    return epoch_time.count();
   }
 
  private:
   TimePoint base_time_;
-  std::map<ze_command_list_handle_t, std::vector<uint64_t> > kernel_id_map_;
-  std::map<ze_command_list_handle_t, std::vector<uint64_t> > call_id_map_;
+  uint64_t epoch_point_;
+  std::mutex lock_;
+  FlatHashMap<ze_command_list_handle_t, IdList> id_list_map_;
 
   Logger logger_;
 
@@ -0,0 +1,402 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_CRITICAL_PATH_H_
+#define PTI_TOOLS_UTILS_CRITICAL_PATH_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pti_assert.h"
+#include "string_table.h"
+
+#define CRITICAL_PATH_REORDER_WINDOW 1024
+#define CRITICAL_PATH_CALL_HISTORY_SIZE 65536
+#define CRITICAL_PATH_PENDING_CALL_SIZE 65536
+#define CRITICAL_PATH_TOP_COUNT 10
+#define CRITICAL_PATH_IDLE_THRESHOLD 20 // % of device span
+#define CRITICAL_PATH_HOST_THRESHOLD 50 // % of device idle time
+
+// Time of each stage of the kernel path and device idle time right
+// before the kernel start, split by whether the kernel was not submitted
+// yet (host-bound) or was submitted but not started (device-bound)
+struct CriticalPathStages {
+  uint64_t call_count = 0;
+  uint64_t host_call_count = 0;
+  uint64_t host_call_time = 0; // API call that appended the kernel
+  uint64_t append_to_submit_time = 0;
+  uint64_t submit_to_start_time = 0;
+  uint64_t execution_time = 0;
+  uint64_t host_idle_time = 0;
+  uint64_t device_idle_time = 0;
+
+  void Add(const CriticalPathStages& stages) {
+    call_count += stages.call_count;
+    host_call_count += stages.host_call_count;
+    host_call_time += stages.host_call_time;
+    append_to_submit_time += stages.append_to_submit_time;
+    submit_to_start_time += stages.submit_to_start_time;
+    execution_time += stages.execution_time;
+    host_idle_time += stages.host_idle_time;
+    device_idle_time += stages.device_idle_time;
+  }
+};
+
+// Follows each kernel from the host API call that appended (enqueued) it
+// through submission to the device start and end, and finds the host
+// activity behind device idle time. API calls are linked to kernels by
+// the kernel ID given by the correlator. Kernels are processed in the
+// order of their start within a bounded reorder window, and the device
+// is idle when no kernel of any queue is running. Host-bound idle time
+// is attributed to API calls of all the threads running at that time
+// (from a bounded history of the latest calls), the rest of it is spent
+// in the application code
+class CriticalPathAnalyzer {
+ public: // Interface
+  // Kernel ID is zero for the calls that give no kernel
+  void AddCall(uint64_t kernel_id, const std::string& name,
+               uint64_t started, uint64_t ended) {
+    PTI_ASSERT(started <= ended);
+    uint32_t name_id = StringTable::Add(name);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    call_history_.push_back({name_id, started, ended});
+    if (call_history_.size() > CRITICAL_PATH_CALL_HISTORY_SIZE) {
+      call_history_.pop_front();
+    }
+    if (ended - started > max_call_time_) {
+      max_call_time_ = ended - started;
+    }
+
+    if (kernel_id > 0) {
+      pending_call_map_[kernel_id] = ended - started;
+      if (pending_call_map_.size() > CRITICAL_PATH_PENDING_CALL_SIZE) {
+        pending_call_map_.erase(pending_call_map_.begin());
+      }
+    }
+  }
+
+  void AddKernel(uint64_t kernel_id, const std::string& name,
+                 uint64_t appended, uint64_t submitted,
+                 uint64_t started, uint64_t ended) {
+    PTI_ASSERT(appended <= submitted);
+    PTI_ASSERT(started <= ended);
+    uint32_t name_id = StringTable::Add(name);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    CriticalPathStages& stages = stage_map_[name_id];
+    ++stages.call_count;
+    stages.append_to_submit_time += submitted - appended;
+    stages.submit_to_start_time +=
+      (started > submitted) ? started - submitted : 0;
+    stages.execution_time += ended - started;
+
+    // Append of a regular command list is counted for its first execution
+    auto it = pending_call_map_.find(kernel_id);
+    if (it != pending_call_map_.end()) {
+      ++stages.host_call_count;
+      stages.host_call_time += it->second;
+      pending_call_map_.erase(it);
+    }
+
+    window_.push({started, ended, submitted, name_id});
+    if (window_.size() > CRITICAL_PATH_REORDER_WINDOW) {
+      ProcessKernel(window_.top());
+      window_.pop();
+    }
+  }
+
+  void PrintResults(std::ostream& stream) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    while (!window_.empty()) {
+      ProcessKernel(window_.top());
+      window_.pop();
+    }
+
+    if (stage_map_.empty()) {
+      return;
+    }
+
+    CriticalPathStages total;
+    for (auto& value : stage_map_) {
+      total.Add(value.second);
+    }
+
+    PrintSummary(stream, total);
+    PrintStagesTable(stream, total);
+    PrintKernelsTable(stream);
+    PrintContributorsTable(stream, total);
+  }
+
+ private: // Implementation
+  struct CallRecord {
+    uint32_t name_id;
+    uint64_t started;
+    uint64_t ended;
+  };
+
+  struct KernelRecord {
+    uint64_t started;
+    uint64_t ended;
+    uint64_t submitted;
+    uint32_t name_id;
+
+    bool operator>(const KernelRecord& r) const {
+      return started > r.started;
+    }
+  };
+
+  void ProcessKernel(const KernelRecord& record) {
+    if (!started_) {
+      started_ = true;
+      first_start_ = busy_start_ = record.started;
+      last_end_ = record.ended;
+      return;
+    }
+
+    if (record.started > last_end_) {
+      CriticalPathStages& stages = stage_map_[record.name_id];
+      uint64_t host_idle = 0;
+      if (record.submitted > last_end_) {
+        host_idle = std::min(record.submitted, record.started) - last_end_;
+        AttributeHostIdle(last_end_, last_end_ + host_idle);
+      }
+      stages.host_idle_time += host_idle;
+      stages.device_idle_time += record.started - last_end_ - host_idle;
+
+      busy_time_ += last_end_ - busy_start_;
+      busy_start_ = record.started;
+    }
+
+    if (record.ended > last_end_) {
+      last_end_ = record.ended;
+    }
+  }
+
+  // Calls are kept in the order of completion, which is close enough
+  // to the order of their end times to search them
+  void AttributeHostIdle(uint64_t start, uint64_t end) {
+    PTI_ASSERT(start < end);
+    auto it = std::lower_bound(
+        call_history_.begin(), call_history_.end(), start,
+        [](const CallRecord& record, uint64_t time) {
+          return record.ended < time;
+        });
+
+    std::vector< std::pair<uint64_t, uint64_t> > covered_list;
+    for (; it != call_history_.end(); ++it) {
+      if (it->ended > end + max_call_time_) {
+        break;
+      }
+      uint64_t covered_start = std::max(it->started, start);
+      uint64_t covered_end = std::min(it->ended, end);
+      if (covered_start < covered_end) {
+        function_idle_map_[it->name_id] += covered_end - covered_start;
+        covered_list.emplace_back(covered_start, covered_end);
+      }
+    }
+
+    std::sort(covered_list.begin(), covered_list.end());
+    uint64_t covered = 0;
+    uint64_t covered_end = start;
+    for (auto& interval : covered_list) {
+      if (interval.second <= covered_end) {
+        continue;
+      }
+      covered += interval.second - std::max(interval.first, covered_end);
+      covered_end = interval.second;
+    }
+    PTI_ASSERT(covered <= end - start);
+    application_idle_time_ += end - start - covered;
+  }
+
+  void PrintSummary(std::ostream& stream, const CriticalPathStages& total) {
+    uint64_t span = last_end_ - first_start_;
+    uint64_t busy = busy_time_ + (last_end_ - busy_start_);
+    uint64_t idle = total.host_idle_time + total.device_idle_time;
+    float idle_percent = (span > 0) ? 100.0f * idle / span : 0.0f;
+    float host_percent = (idle > 0) ?
+      100.0f * total.host_idle_time / idle : 0.0f;
+
+    std::string title = "Waiting for Host Submission (ns): ";
+    const size_t title_width = title.size();
+    stream << std::setw(title_width) << "Kernels: " <<
+      std::setw(kTimeLength) << total.call_count << std::endl;
+    stream << std::setw(title_width) << "Device Span (ns): " <<
+      std::setw(kTimeLength) << span << std::endl;
+    stream << std::setw(title_width) << "Device Busy (ns): " <<
+      std::setw(kTimeLength) << busy << std::endl;
+    stream << std::setw(title_width) << "Device Idle (ns): " <<
+      std::setw(kTimeLength) << idle << std::endl;
+    stream << std::setw(title_width) << title <<
+      std::setw(kTimeLength) << total.host_idle_time << std::endl;
+    stream << std::setw(title_width) << "Waiting for Device Start (ns): " <<
+      std::setw(kTimeLength) << total.device_idle_time << std::endl;
+    stream << std::endl;
+
+    stream << "Device is idle " << std::setprecision(2) << std::fixed <<
+      idle_percent << "% of its span, " << host_percent <<
+      "% of the idle time waits for host submission: ";
+    if (idle_percent >= CRITICAL_PATH_IDLE_THRESHOLD &&
+        host_percent >= CRITICAL_PATH_HOST_THRESHOLD) {
+      stream << "HOST-BOUND";
+    } else {
+      stream << "DEVICE-BOUND";
+    }
+    stream << std::endl;
+  }
+
+  void PrintStagesTable(
+      std::ostream& stream, const CriticalPathStages& total) {
+    struct Stage {
+      const char* name;
+      uint64_t time;
+      uint64_t count;
+    };
+    const Stage stage_list[] = {
+      {"Host API Call", total.host_call_time, total.host_call_count},
+      {"Append to Submit", total.append_to_submit_time, total.call_count},
+      {"Submit to Start", total.submit_to_start_time, total.call_count},
+      {"Execution", total.execution_time, total.call_count}};
+
+    stream << std::endl;
+    stream << "== Kernel Path Stages: ==" << std::endl;
+    stream << std::endl;
+    stream << std::setw(kStageLength) << "Stage" << "," <<
+      std::setw(kCountLength) << "Count" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kTimeLength) << "Average (ns)" << std::endl;
+    for (const Stage& stage : stage_list) {
+      stream << std::setw(kStageLength) << stage.name << "," <<
+        std::setw(kCountLength) << stage.count << "," <<
+        std::setw(kTimeLength) << stage.time << "," <<
+        std::setw(kTimeLength) <<
+          (stage.count > 0 ? stage.time / stage.count : 0) << std::endl;
+    }
+  }
+
+  // Kernels are sorted by the device idle time before them
+  void PrintKernelsTable(std::ostream& stream) const {
+    std::vector< std::pair<uint64_t, uint32_t> > sorted_list;
+    size_t max_name_length = kKernelLength;
+    for (auto& value : stage_map_) {
+      const CriticalPathStages& stages = value.second;
+      sorted_list.emplace_back(
+          stages.host_idle_time + stages.device_idle_time, value.first);
+      const std::string& name = StringTable::Get(value.first);
+      if (name.size() > max_name_length) {
+        max_name_length = name.size();
+      }
+    }
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              std::greater< std::pair<uint64_t, uint32_t> >());
+
+    stream << std::endl;
+    stream << "== Kernels: ==" << std::endl;
+    stream << std::endl;
+    stream << std::setw(max_name_length) << "Kernel" << "," <<
+      std::setw(kCountLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Host Call (ns)" << "," <<
+      std::setw(kTimeLength) << "Append to Submit (ns)" << "," <<
+      std::setw(kTimeLength) << "Submit to Start (ns)" << "," <<
+      std::setw(kTimeLength) << "Execution (ns)" << "," <<
+      std::setw(kTimeLength) << "Host Idle (ns)" << "," <<
+      std::setw(kTimeLength) << "Device Idle (ns)" << std::endl;
+    for (auto& value : sorted_list) {
+      const CriticalPathStages& stages = stage_map_.at(value.second);
+      stream << std::setw(max_name_length) <<
+          StringTable::Get(value.second) << "," <<
+        std::setw(kCountLength) << stages.call_count << "," <<
+        std::setw(kTimeLength) << stages.host_call_time << "," <<
+        std::setw(kTimeLength) << stages.append_to_submit_time << "," <<
+        std::setw(kTimeLength) << stages.submit_to_start_time << "," <<
+        std::setw(kTimeLength) << stages.execution_time << "," <<
+        std::setw(kTimeLength) << stages.host_idle_time << "," <<
+        std::setw(kTimeLength) << stages.device_idle_time << std::endl;
+    }
+  }
+
+  // Calls of concurrent threads may cover the same idle time, so the
+  // shares may sum up to more than 100%
+  void PrintContributorsTable(
+      std::ostream& stream, const CriticalPathStages& total) const {
+    if (total.host_idle_time == 0) {
+      return;
+    }
+
+    std::vector< std::pair<uint64_t, std::string> > sorted_list;
+    for (auto& value : function_idle_map_) {
+      sorted_list.emplace_back(value.second, StringTable::Get(value.first));
+    }
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              std::greater< std::pair<uint64_t, std::string> >());
+    if (sorted_list.size() > CRITICAL_PATH_TOP_COUNT) {
+      sorted_list.resize(CRITICAL_PATH_TOP_COUNT);
+    }
+    sorted_list.emplace_back(application_idle_time_, "<Application>");
+
+    size_t max_name_length = kFunctionLength;
+    for (auto& value : sorted_list) {
+      if (value.second.size() > max_name_length) {
+        max_name_length = value.second.size();
+      }
+    }
+
+    stream << std::endl;
+    stream << "== Top Host Contributors to Device Idle: ==" << std::endl;
+    stream << std::endl;
+    stream << std::setw(max_name_length) << "Function" << "," <<
+      std::setw(kTimeLength) << "Idle (ns)" << "," <<
+      std::setw(kPercentLength) << "Idle (%)" << std::endl;
+    for (auto& value : sorted_list) {
+      float percent = 100.0f * value.first / total.host_idle_time;
+      stream << std::setw(max_name_length) << value.second << "," <<
+        std::setw(kTimeLength) << value.first << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << percent << std::endl;
+    }
+  }
+
+ private: // Data
+  std::mutex lock_;
+
+  std::deque<CallRecord> call_history_;
+  uint64_t max_call_time_ = 0;
+  std::map<uint64_t, uint64_t> pending_call_map_; // Kernel ID to call time
+
+  std::priority_queue<
+      KernelRecord, std::vector<KernelRecord>,
+      std::greater<KernelRecord> > window_;
+  std::map<uint32_t, CriticalPathStages> stage_map_;
+  std::map<uint32_t, uint64_t> function_idle_map_;
+  uint64_t application_idle_time_ = 0;
+
+  bool started_ = false;
+  uint64_t first_start_ = 0;
+  uint64_t busy_start_ = 0;
+  uint64_t last_end_ = 0;
+  uint64_t busy_time_ = 0;
+
+  static const uint32_t kStageLength = 16;
+  static const uint32_t kKernelLength = 10;
+  static const uint32_t kFunctionLength = 10;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kTimeLength = 22;
+  static const uint32_t kPercentLength = 10;
+};
+
+#endif // PTI_TOOLS_UTILS_CRITICAL_PATH_H_
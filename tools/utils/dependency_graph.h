@@ -0,0 +1,440 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_DEPENDENCY_GRAPH_H_
+#define PTI_TOOLS_UTILS_DEPENDENCY_GRAPH_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "pti_assert.h"
+#include "string_table.h"
+
+#define DEPENDENCY_GRAPH_MAX_NODES 1024 // Per graph
+#define DEPENDENCY_GRAPH_MAX_GRAPHS 64 // Kept per queue before folding
+#define DEPENDENCY_GRAPH_MAX_EXECUTIONS 16 // Open executions per graph
+#define DEPENDENCY_GRAPH_PATH_LENGTH 8 // Names shown per critical path
+
+struct DependencyNode {
+  uint64_t id;
+  uint32_t name_id;
+  std::vector<uint32_t> pred_list; // Earlier nodes of the same graph
+  uint64_t time = 0; // Summed over the executions
+  uint64_t count = 0;
+};
+
+struct DependencyInterval {
+  uint64_t start;
+  uint64_t end;
+};
+
+struct DependencyGraphData {
+  std::vector<DependencyNode> node_list;
+  // Last node that signals the event, so that a reused event is
+  // resolved to its latest signal
+  std::unordered_map<const void*, uint32_t> signal_map;
+  uint64_t external_count = 0; // Waits on events from outside the graph
+  uint32_t barrier_index = 0; // Last barrier node plus one, zero for none
+  std::map<uint64_t, DependencyInterval> execution_map;
+  uint64_t execution_count = 0; // Folded from the execution map
+  uint64_t span_time = 0; // Of the folded executions
+  bool closed = false;
+};
+
+struct DependencyInfo {
+  uint32_t index = 0; // Order the queue was seen in, for the label
+  uint64_t graph_count = 0;
+  uint64_t node_count = 0;
+  uint64_t edge_count = 0;
+  uint64_t redundant_count = 0; // Implied by other edges
+  uint64_t external_count = 0;
+  uint64_t execution_count = 0;
+  uint64_t work_time = 0;
+  uint64_t span_time = 0;
+  uint64_t critical_time = 0;
+  uint64_t max_critical_time = 0; // Of a single graph execution
+  std::vector<uint32_t> critical_path; // Name ids of the longest one
+  std::vector<DependencyGraphData*> graph_list; // Not folded yet
+};
+
+// Dependency graphs of the commands of each queue (or command list): a
+// node per command, with an edge to the command signalling each event it
+// waits on, and to the previous command for in-order queues. A barrier
+// depends on the commands before it that have no dependent commands yet,
+// and the commands after it depend on the barrier. A graph is
+// what is submitted at once - the contents of a command list, or a window
+// of DEPENDENCY_GRAPH_MAX_NODES commands for the queues that execute them
+// directly. The critical path of a graph is its longest chain by the
+// average command time. Work over the critical path is the parallelism the
+// dependencies allow, work over the span of an execution is the achieved
+// one, so a large gap points to the commands that serialize for no reason.
+// Redundant edges are the ones implied by the other edges of the command
+class DependencyGraph {
+ public: // Interface
+  explicit DependencyGraph(const std::string& label) : label_(label) {}
+
+  ~DependencyGraph() {
+    for (auto& value : info_map_) {
+      for (DependencyGraphData* graph : value.second.graph_list) {
+        delete graph;
+      }
+    }
+  }
+
+  void AddNode(const void* key, uint64_t node_id, uint32_t name_id,
+               const void* signal_event,
+               const void* const* wait_list, uint32_t wait_count,
+               bool in_order = false, bool barrier = false) {
+    PTI_ASSERT(key != nullptr);
+    PTI_ASSERT(wait_count == 0 || wait_list != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+
+    DependencyGraphData* graph = GetOpenGraph(key);
+    PTI_ASSERT(graph != nullptr);
+    uint32_t index = static_cast<uint32_t>(graph->node_list.size());
+
+    DependencyNode node;
+    node.id = node_id;
+    node.name_id = name_id;
+    if (in_order && index > 0) {
+      node.pred_list.push_back(index - 1);
+    } else if (barrier) {
+      AddBarrierEdges(*graph, &node.pred_list);
+    } else if (graph->barrier_index > 0) {
+      node.pred_list.push_back(graph->barrier_index - 1);
+    }
+    for (uint32_t i = 0; i < wait_count; ++i) {
+      if (wait_list[i] == nullptr) {
+        continue;
+      }
+      auto it = graph->signal_map.find(wait_list[i]);
+      if (it == graph->signal_map.end()) {
+        ++graph->external_count;
+      } else if (std::find(node.pred_list.begin(), node.pred_list.end(),
+                           it->second) == node.pred_list.end()) {
+        node.pred_list.push_back(it->second);
+      }
+    }
+    graph->node_list.push_back(std::move(node));
+    if (barrier) {
+      graph->barrier_index = index + 1;
+    }
+
+    if (signal_event != nullptr) {
+      graph->signal_map[signal_event] = index;
+    }
+    node_map_[node_id] = std::make_pair(graph, index);
+  }
+
+  // Next command of the queue starts a new graph, e.g. on command list
+  // reset
+  void ResetGraph(const void* key) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    auto it = info_map_.find(key);
+    if (it != info_map_.end() && !it->second.graph_list.empty()) {
+      it->second.graph_list.back()->closed = true;
+    }
+  }
+
+  // Execution key tells the executions of the same graph apart, e.g. the
+  // submission time of a command list
+  void AddTime(uint64_t node_id, uint64_t execution,
+               uint64_t start, uint64_t end) {
+    PTI_ASSERT(start <= end);
+    const std::lock_guard<std::mutex> lock(lock_);
+
+    auto it = node_map_.find(node_id);
+    if (it == node_map_.end()) {
+      return;
+    }
+    DependencyGraphData* graph = it->second.first;
+    PTI_ASSERT(graph != nullptr);
+    PTI_ASSERT(it->second.second < graph->node_list.size());
+
+    DependencyNode& node = graph->node_list[it->second.second];
+    node.time += end - start;
+    ++node.count;
+
+    auto result = graph->execution_map.find(execution);
+    if (result == graph->execution_map.end()) {
+      graph->execution_map[execution] = {start, end};
+      if (graph->execution_map.size() > DEPENDENCY_GRAPH_MAX_EXECUTIONS) {
+        auto oldest = graph->execution_map.begin();
+        ++graph->execution_count;
+        graph->span_time += oldest->second.end - oldest->second.start;
+        graph->execution_map.erase(oldest);
+      }
+    } else {
+      result->second.start = (std::min)(result->second.start, start);
+      result->second.end = (std::max)(result->second.end, end);
+    }
+  }
+
+  bool IsEmpty() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return info_map_.empty();
+  }
+
+  // Folds the graphs that are kept open, so is called once all the
+  // command times are added
+  void PrintTables(std::ostream& stream) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    if (info_map_.empty()) {
+      return;
+    }
+
+    std::vector<DependencyInfo*> info_list;
+    for (auto& value : info_map_) {
+      DependencyInfo& info = value.second;
+      for (DependencyGraphData* graph : info.graph_list) {
+        FoldGraph(graph, &info);
+      }
+      info.graph_list.clear();
+      info_list.push_back(&info);
+    }
+    node_map_.clear();
+
+    std::sort(info_list.begin(), info_list.end(),
+              [](const DependencyInfo* left, const DependencyInfo* right) {
+                return left->work_time > right->work_time;
+              });
+
+    stream << std::setw(kLabelLength) << label_ << "," <<
+      std::setw(kCountLength) << "Graphs" << "," <<
+      std::setw(kCountLength) << "Commands" << "," <<
+      std::setw(kCountLength) << "Edges" << "," <<
+      std::setw(kCountLength) << "Redundant" << "," <<
+      std::setw(kCountLength) << "External" << "," <<
+      std::setw(kCountLength) << "Executions" << "," <<
+      std::setw(kTimeLength) << "Work (ns)" << "," <<
+      std::setw(kTimeLength) << "Span (ns)" << "," <<
+      std::setw(kTimeLength) << "Critical Path (ns)" << "," <<
+      std::setw(kRatioLength) << "Achieved" << "," <<
+      std::setw(kRatioLength) << "Available" << std::endl;
+
+    for (const DependencyInfo* info : info_list) {
+      float achieved = (info->span_time > 0) ?
+        static_cast<float>(info->work_time) / info->span_time : 0.0f;
+      float available = (info->critical_time > 0) ?
+        static_cast<float>(info->work_time) / info->critical_time : 0.0f;
+
+      stream << std::setw(kLabelLength) << GetLabel(*info) << "," <<
+        std::setw(kCountLength) << info->graph_count << "," <<
+        std::setw(kCountLength) << info->node_count << "," <<
+        std::setw(kCountLength) << info->edge_count << "," <<
+        std::setw(kCountLength) << info->redundant_count << "," <<
+        std::setw(kCountLength) << info->external_count << "," <<
+        std::setw(kCountLength) << info->execution_count << "," <<
+        std::setw(kTimeLength) << info->work_time << "," <<
+        std::setw(kTimeLength) << info->span_time << "," <<
+        std::setw(kTimeLength) << info->critical_time << "," <<
+        std::setw(kRatioLength) << std::setprecision(2) <<
+          std::fixed << achieved << "," <<
+        std::setw(kRatioLength) << std::setprecision(2) <<
+          std::fixed << available << std::endl;
+    }
+
+    stream << std::endl;
+    for (const DependencyInfo* info : info_list) {
+      if (info->critical_path.empty()) {
+        continue;
+      }
+      stream << "Critical path of " << GetLabel(*info) << " (" <<
+        info->max_critical_time << " ns): ";
+      size_t count = (std::min)(
+          info->critical_path.size(),
+          static_cast<size_t>(DEPENDENCY_GRAPH_PATH_LENGTH));
+      for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+          stream << " -> ";
+        }
+        stream << StringTable::Get(info->critical_path[i]);
+      }
+      if (info->critical_path.size() > count) {
+        stream << " -> ... (" << info->critical_path.size() - count <<
+          " more)";
+      }
+      stream << std::endl;
+    }
+  }
+
+  DependencyGraph(const DependencyGraph& copy) = delete;
+  DependencyGraph& operator=(const DependencyGraph& copy) = delete;
+
+ private: // Implementation
+  DependencyGraphData* GetOpenGraph(const void* key) {
+    auto it = info_map_.find(key);
+    if (it == info_map_.end()) {
+      DependencyInfo info;
+      info.index = static_cast<uint32_t>(info_map_.size());
+      it = info_map_.emplace(key, std::move(info)).first;
+    }
+
+    DependencyInfo& info = it->second;
+    if (info.graph_list.empty() || info.graph_list.back()->closed ||
+        info.graph_list.back()->node_list.size() >=
+          DEPENDENCY_GRAPH_MAX_NODES) {
+      // Commands of the oldest graphs are expected to be finished by now
+      if (info.graph_list.size() >= DEPENDENCY_GRAPH_MAX_GRAPHS) {
+        DependencyGraphData* oldest = info.graph_list.front();
+        FoldGraph(oldest, &info);
+        info.graph_list.erase(info.graph_list.begin());
+      }
+      info.graph_list.push_back(new DependencyGraphData);
+    }
+    return info.graph_list.back();
+  }
+
+  // Edges to the last barrier or the commands after it that nothing
+  // depends on, the rest of them are reached through these
+  static void AddBarrierEdges(const DependencyGraphData& graph,
+                              std::vector<uint32_t>* pred_list) {
+    PTI_ASSERT(pred_list != nullptr);
+    uint32_t first = graph.barrier_index;
+    uint32_t count = static_cast<uint32_t>(graph.node_list.size());
+    if (first == count) {
+      if (first > 0) {
+        pred_list->push_back(first - 1);
+      }
+      return;
+    }
+
+    std::vector<bool> has_succ(count - first, false);
+    for (uint32_t i = first; i < count; ++i) {
+      for (uint32_t pred : graph.node_list[i].pred_list) {
+        if (pred >= first) {
+          has_succ[pred - first] = true;
+        }
+      }
+    }
+    for (uint32_t i = first; i < count; ++i) {
+      if (!has_succ[i - first]) {
+        pred_list->push_back(i);
+      }
+    }
+  }
+
+  // Takes the graph statistics into the queue ones and deletes the graph
+  void FoldGraph(DependencyGraphData* graph, DependencyInfo* info) {
+    PTI_ASSERT(graph != nullptr);
+    PTI_ASSERT(info != nullptr);
+
+    for (auto& value : graph->execution_map) {
+      ++graph->execution_count;
+      graph->span_time += value.second.end - value.second.start;
+    }
+    graph->execution_map.clear();
+
+    const std::vector<DependencyNode>& node_list = graph->node_list;
+    uint32_t node_count = static_cast<uint32_t>(node_list.size());
+    uint32_t word_count = (node_count + 63) / 64;
+
+    // Predecessors are always earlier nodes, so a single pass in the
+    // order of the nodes gives the longest paths and the ancestor sets
+    std::vector<uint64_t> path_time(node_count, 0);
+    std::vector<uint32_t> path_pred(node_count, node_count);
+    std::vector<uint64_t> ancestor_list(
+        static_cast<size_t>(node_count) * word_count, 0);
+    uint64_t work_time = 0, critical_time = 0;
+    uint32_t critical_node = node_count;
+
+    for (uint32_t i = 0; i < node_count; ++i) {
+      const DependencyNode& node = node_list[i];
+      work_time += node.time;
+      info->edge_count += node.pred_list.size();
+
+      uint64_t* ancestors = &ancestor_list[
+          static_cast<size_t>(i) * word_count];
+      uint64_t start_time = 0;
+      for (uint32_t pred : node.pred_list) {
+        PTI_ASSERT(pred < i);
+        const uint64_t* pred_ancestors = &ancestor_list[
+            static_cast<size_t>(pred) * word_count];
+        for (uint32_t j = 0; j < word_count; ++j) {
+          ancestors[j] |= pred_ancestors[j];
+        }
+        if (path_time[pred] > start_time || path_pred[i] == node_count) {
+          start_time = path_time[pred];
+          path_pred[i] = pred;
+        }
+      }
+
+      for (uint32_t pred : node.pred_list) {
+        if (IsSet(ancestors, pred)) {
+          ++info->redundant_count;
+        }
+      }
+      for (uint32_t pred : node.pred_list) {
+        ancestors[pred / 64] |= (1ull << (pred % 64));
+      }
+
+      uint64_t time = (node.count > 0) ? node.time / node.count : 0;
+      path_time[i] = start_time + time;
+      if (critical_node == node_count || path_time[i] > critical_time) {
+        critical_time = path_time[i];
+        critical_node = i;
+      }
+    }
+
+    ++info->graph_count;
+    info->node_count += node_count;
+    info->external_count += graph->external_count;
+    info->execution_count += graph->execution_count;
+    info->work_time += work_time;
+    info->span_time += graph->span_time;
+    info->critical_time += critical_time * graph->execution_count;
+
+    if (critical_node < node_count &&
+        (info->critical_path.empty() ||
+         critical_time > info->max_critical_time)) {
+      info->max_critical_time = critical_time;
+      info->critical_path.clear();
+      for (uint32_t i = critical_node; i < node_count; i = path_pred[i]) {
+        info->critical_path.push_back(node_list[i].name_id);
+      }
+      std::reverse(info->critical_path.begin(), info->critical_path.end());
+    }
+
+    for (const DependencyNode& node : node_list) {
+      auto it = node_map_.find(node.id);
+      if (it != node_map_.end() && it->second.first == graph) {
+        node_map_.erase(it);
+      }
+    }
+    delete graph;
+  }
+
+  static bool IsSet(const uint64_t* bit_list, uint32_t index) {
+    return (bit_list[index / 64] & (1ull << (index % 64))) != 0;
+  }
+
+  std::string GetLabel(const DependencyInfo& info) const {
+    return label_ + " " + std::to_string(info.index);
+  }
+
+ private: // Data
+  std::string label_;
+  mutable std::mutex lock_;
+  std::map<const void*, DependencyInfo> info_map_;
+  std::unordered_map<
+      uint64_t, std::pair<DependencyGraphData*, uint32_t> > node_map_;
+
+  static const uint32_t kLabelLength = 12;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kRatioLength = 10;
+};
+
+#endif // PTI_TOOLS_UTILS_DEPENDENCY_GRAPH_H_
@@ -0,0 +1,209 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_ENERGY_SAMPLER_H_
+#define PTI_TOOLS_UTILS_ENERGY_SAMPLER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pti_assert.h"
+#include "sysman_device.h"
+#include "sysman_sampler.h"
+#include "ze_utils.h"
+
+#define ENERGY_SAMPLER_INTERVAL 1 // ms
+
+// Energy the device has used since the first sample
+struct EnergySample {
+  uint64_t timestamp; // In the time domain of the sampler clock, ns
+  double energy; // J
+};
+
+// Background thread that polls only the energy counters of one device,
+// much more often than SysmanSampler does, so the energy may be taken
+// over kernel intervals. Device level power domains are used if there are
+// any, otherwise subdevice domains are summed up. Energy between samples
+// is interpolated linearly
+class EnergySampler {
+ public: // Interface
+  static EnergySampler* Create(
+      OnSysmanTimestamp clock, void* clock_data, uint32_t device_id = 0,
+      uint32_t interval = ENERGY_SAMPLER_INTERVAL) {
+    PTI_ASSERT(clock != nullptr);
+    PTI_ASSERT(interval > 0);
+
+    std::vector<ze_device_handle_t> device_list =
+      utils::ze::GetDeviceList();
+    if (device_id >= device_list.size()) {
+      std::cerr << "[WARNING] Unable to find device for energy sampling" <<
+        std::endl;
+      return nullptr;
+    }
+
+    SysmanDevice* device = new SysmanDevice(device_list[device_id]);
+    PTI_ASSERT(device != nullptr);
+
+    std::vector<size_t> power_id_list;
+    const std::vector<SysmanPower>& power_list = device->GetPowerList();
+    for (bool on_subdevice : {false, true}) {
+      for (size_t i = 0; i < power_list.size(); ++i) {
+        if (power_list[i].on_subdevice == on_subdevice) {
+          power_id_list.push_back(i);
+        }
+      }
+      if (!power_id_list.empty()) {
+        break;
+      }
+    }
+
+    if (power_id_list.empty()) {
+      std::cerr << "[WARNING] Unable to find power domains for energy " <<
+        "sampling" << std::endl;
+      delete device;
+      return nullptr;
+    }
+
+    EnergySampler* sampler = new EnergySampler(
+        device, power_id_list, clock, clock_data, interval);
+    PTI_ASSERT(sampler != nullptr);
+    return sampler;
+  }
+
+  ~EnergySampler() {
+    Stop();
+    delete device_;
+  }
+
+  void Stop() {
+    stop_.store(true, std::memory_order_release);
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  // Samples are taken that many times less often from the next one on,
+  // e.g. to keep the tool overhead down
+  void SetIntervalScale(uint32_t scale) {
+    PTI_ASSERT(scale > 0);
+    interval_scale_.store(scale, std::memory_order_relaxed);
+  }
+
+  // Energy in J used between the given points, out of the sampled range
+  // the closest sample is taken
+  double GetEnergy(uint64_t start, uint64_t end) const {
+    PTI_ASSERT(start <= end);
+    const std::lock_guard<std::mutex> lock(lock_);
+    return GetEnergyAt(end) - GetEnergyAt(start);
+  }
+
+  // Energy in J used from the first sample to the last one
+  double GetTotalEnergy() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    if (sample_list_.empty()) {
+      return 0.0;
+    }
+    return sample_list_.back().energy;
+  }
+
+  EnergySampler(const EnergySampler& copy) = delete;
+  EnergySampler& operator=(const EnergySampler& copy) = delete;
+
+ private: // Implementation
+  EnergySampler(
+      SysmanDevice* device, const std::vector<size_t>& power_id_list,
+      OnSysmanTimestamp clock, void* clock_data, uint32_t interval)
+      : device_(device), power_id_list_(power_id_list),
+        clock_(clock), clock_data_(clock_data), interval_(interval) {
+    PTI_ASSERT(device_ != nullptr);
+    PTI_ASSERT(!power_id_list_.empty());
+    thread_ = std::thread(&EnergySampler::Run, this);
+  }
+
+  double GetEnergyAt(uint64_t timestamp) const {
+    if (sample_list_.empty()) {
+      return 0.0;
+    }
+
+    auto next = std::lower_bound(
+        sample_list_.begin(), sample_list_.end(), timestamp,
+        [](const EnergySample& sample, uint64_t timestamp) {
+          return sample.timestamp < timestamp;
+        });
+    if (next == sample_list_.end()) {
+      return sample_list_.back().energy;
+    }
+    if (next == sample_list_.begin() || next->timestamp == timestamp) {
+      return next->energy;
+    }
+
+    auto prev = next - 1;
+    PTI_ASSERT(prev->timestamp < timestamp && timestamp < next->timestamp);
+    return prev->energy + (next->energy - prev->energy) *
+      (timestamp - prev->timestamp) / (next->timestamp - prev->timestamp);
+  }
+
+  // Counters that fail to be read keep their last value, so the energy
+  // never goes down
+  void Run() {
+    std::vector<uint64_t> first_list(power_id_list_.size(), 0);
+    std::vector<uint64_t> last_list(power_id_list_.size(), 0);
+    std::vector<bool> known_list(power_id_list_.size(), false);
+
+    std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now();
+    while (!stop_.load(std::memory_order_acquire)) {
+      uint64_t timestamp = clock_(clock_data_);
+
+      uint64_t total = 0;
+      for (size_t i = 0; i < power_id_list_.size(); ++i) {
+        zes_power_energy_counter_t energy{};
+        if (device_->SampleEnergy(power_id_list_[i], &energy)) {
+          if (!known_list[i]) {
+            first_list[i] = energy.energy;
+            known_list[i] = true;
+          }
+          last_list[i] = (std::max)(last_list[i], energy.energy);
+        }
+        if (known_list[i]) {
+          total += last_list[i] - first_list[i];
+        }
+      }
+
+      {
+        const std::lock_guard<std::mutex> lock(lock_);
+        // Counters are in uJ
+        sample_list_.push_back({timestamp, total / 1000000.0});
+      }
+
+      deadline += std::chrono::milliseconds(
+          interval_ * interval_scale_.load(std::memory_order_relaxed));
+      std::this_thread::sleep_until(deadline);
+    }
+  }
+
+ private: // Data
+  SysmanDevice* device_ = nullptr;
+  std::vector<size_t> power_id_list_;
+  OnSysmanTimestamp clock_ = nullptr;
+  void* clock_data_ = nullptr;
+  uint32_t interval_ = ENERGY_SAMPLER_INTERVAL;
+
+  std::atomic<uint32_t> interval_scale_{1};
+
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+
+  mutable std::mutex lock_;
+  std::vector<EnergySample> sample_list_;
+};
+
+#endif // PTI_TOOLS_UTILS_ENERGY_SAMPLER_H_
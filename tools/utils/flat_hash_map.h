@@ -0,0 +1,186 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_FLAT_HASH_MAP_H_
+#define PTI_TOOLS_UTILS_FLAT_HASH_MAP_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "pti_assert.h"
+
+#define FLAT_HASH_MAP_MIN_CAPACITY 16 // Slots, power of two
+
+// Open-addressing hash map with linear probing. Entries are kept densely
+// in one array in insertion order (removal moves the last entry into the
+// hole), the slot array only holds entry indices with hash fragments, so
+// a lookup touches one or two cache lines and large values are never
+// moved on growth. References to the values are invalidated by insertion
+// and removal. The class is not thread-safe
+template <typename K, typename V, typename H = std::hash<K> >
+class FlatHashMap {
+ public: // Interface
+  using Entry = std::pair<K, V>;
+  using Iterator = typename std::vector<Entry>::iterator;
+  using ConstIterator = typename std::vector<Entry>::const_iterator;
+
+  FlatHashMap() : slot_list_(FLAT_HASH_MAP_MIN_CAPACITY) {}
+
+  // Returns nullptr if there is no such key
+  V* Find(const K& key) {
+    uint32_t slot = FindSlot(key, GetHash(key));
+    if (slot_list_[slot].index == kEmpty) {
+      return nullptr;
+    }
+    return &entry_list_[slot_list_[slot].index].second;
+  }
+
+  const V* Find(const K& key) const {
+    return const_cast<FlatHashMap*>(this)->Find(key);
+  }
+
+  // Value is default-constructed for a new key
+  V& operator[](const K& key) {
+    uint64_t hash = GetHash(key);
+    uint32_t slot = FindSlot(key, hash);
+    if (slot_list_[slot].index != kEmpty) {
+      return entry_list_[slot_list_[slot].index].second;
+    }
+
+    if ((entry_list_.size() + 1) * 4 > slot_list_.size() * 3) {
+      Grow();
+      slot = FindSlot(key, hash);
+    }
+    PTI_ASSERT(entry_list_.size() < kEmpty);
+    slot_list_[slot].index = static_cast<uint32_t>(entry_list_.size());
+    slot_list_[slot].hash = static_cast<uint32_t>(hash);
+    entry_list_.emplace_back(key, V());
+    return entry_list_.back().second;
+  }
+
+  // Returns false if there is no such key
+  bool Erase(const K& key) {
+    uint32_t slot = FindSlot(key, GetHash(key));
+    uint32_t index = slot_list_[slot].index;
+    if (index == kEmpty) {
+      return false;
+    }
+    RemoveSlot(slot);
+
+    uint32_t last = static_cast<uint32_t>(entry_list_.size() - 1);
+    if (index != last) {
+      const K& moved = entry_list_[last].first;
+      uint32_t moved_slot = FindSlot(moved, GetHash(moved));
+      PTI_ASSERT(slot_list_[moved_slot].index == last);
+      slot_list_[moved_slot].index = index;
+      entry_list_[index] = std::move(entry_list_[last]);
+    }
+    entry_list_.pop_back();
+    return true;
+  }
+
+  void Clear() {
+    entry_list_.clear();
+    slot_list_.assign(FLAT_HASH_MAP_MIN_CAPACITY, Slot());
+  }
+
+  size_t GetSize() const {
+    return entry_list_.size();
+  }
+
+  bool IsEmpty() const {
+    return entry_list_.empty();
+  }
+
+  Iterator begin() { return entry_list_.begin(); }
+  Iterator end() { return entry_list_.end(); }
+  ConstIterator begin() const { return entry_list_.begin(); }
+  ConstIterator end() const { return entry_list_.end(); }
+
+ private: // Implementation
+  static const uint32_t kEmpty = (std::numeric_limits<uint32_t>::max)();
+
+  struct Slot {
+    uint32_t index = kEmpty;
+    uint32_t hash = 0; // Lower bits of the full hash
+  };
+
+  // Standard hashes of integers and pointers are identity functions,
+  // their low bits are spread before the slot is taken from them
+  uint64_t GetHash(const K& key) const {
+    uint64_t hash = static_cast<uint64_t>(hasher_(key));
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  uint32_t GetMask() const {
+    return static_cast<uint32_t>(slot_list_.size() - 1);
+  }
+
+  // Slot of the key, or the free slot it would take
+  uint32_t FindSlot(const K& key, uint64_t hash) const {
+    uint32_t mask = GetMask();
+    uint32_t slot = static_cast<uint32_t>(hash) & mask;
+    while (true) {
+      const Slot& current = slot_list_[slot];
+      if (current.index == kEmpty) {
+        return slot;
+      }
+      if (current.hash == static_cast<uint32_t>(hash) &&
+          entry_list_[current.index].first == key) {
+        return slot;
+      }
+      slot = (slot + 1) & mask;
+    }
+  }
+
+  // Backward shift deletion: the following slots of the probe chain are
+  // moved into the hole if it lies between their home slot and them
+  void RemoveSlot(uint32_t slot) {
+    uint32_t mask = GetMask();
+    uint32_t hole = slot;
+    uint32_t next = (hole + 1) & mask;
+    while (slot_list_[next].index != kEmpty) {
+      uint32_t home = slot_list_[next].hash & mask;
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        slot_list_[hole] = slot_list_[next];
+        hole = next;
+      }
+      next = (next + 1) & mask;
+    }
+    slot_list_[hole] = Slot();
+  }
+
+  void Grow() {
+    std::vector<Slot> slot_list(slot_list_.size() * 2);
+    slot_list_.swap(slot_list);
+    uint32_t mask = GetMask();
+    for (const Slot& current : slot_list) {
+      if (current.index == kEmpty) {
+        continue;
+      }
+      // Only the lower 32 bits of the hash are kept, enough for the mask
+      uint32_t slot = current.hash & mask;
+      while (slot_list_[slot].index != kEmpty) {
+        slot = (slot + 1) & mask;
+      }
+      slot_list_[slot] = current;
+    }
+  }
+
+ private: // Data
+  std::vector<Slot> slot_list_;
+  std::vector<Entry> entry_list_;
+  H hasher_;
+};
+
+#endif // PTI_TOOLS_UTILS_FLAT_HASH_MAP_H_
@@ -0,0 +1,147 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_FLIGHT_RECORDER_H_
+#define PTI_TOOLS_UTILS_FLIGHT_RECORDER_H_
+
+#if !defined(_WIN32)
+#include <signal.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "binary_trace.h"
+#include "pti_assert.h"
+#include "trace_options.h"
+
+const uint32_t kFlightRecorderPollInterval = 100; // ms
+
+// Keeps the most recent binary trace records in a fixed-size ring.
+// The ring is stored into a binary trace file (see binary_trace.h) on
+// request, on signal or in destructor; records are kept after each dump.
+class FlightRecorder {
+ public: // Interface
+  FlightRecorder(
+      size_t size, const std::string& filename, uint32_t pid,
+      uint64_t start_point, uint64_t epoch_point,
+      const std::string& process_name)
+      : record_list_((std::max)(size / sizeof(BinaryTraceRecord),
+                                static_cast<size_t>(1))),
+        filename_(filename), pid_(pid), start_point_(start_point),
+        epoch_point_(epoch_point), process_name_(process_name) {
+    PTI_ASSERT(!filename_.empty());
+    dumper_ = std::thread(&FlightRecorder::Poll, this);
+  }
+
+  ~FlightRecorder() {
+    stop_.store(true, std::memory_order_release);
+    dumper_.join();
+    Dump();
+  }
+
+  void AddRecord(const BinaryTraceRecord& record) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    record_list_[record_count_ % record_list_.size()] = record;
+    ++record_count_;
+  }
+
+  // Safe to call from tracing callbacks: the dump itself is done by
+  // the background thread
+  void RequestDump() {
+    dump_requested_.store(true, std::memory_order_release);
+  }
+
+#if !defined(_WIN32)
+  // Makes the given signal trigger a dump of every flight recorder
+  static void EnableSignal(int signal_number) {
+    struct sigaction action{};
+    action.sa_handler = OnSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    int status = sigaction(signal_number, &action, nullptr);
+    PTI_ASSERT(status == 0);
+  }
+#endif
+
+  FlightRecorder(const FlightRecorder& copy) = delete;
+  FlightRecorder& operator=(const FlightRecorder& copy) = delete;
+
+ private: // Implementation
+  static std::atomic<bool>& GetSignalRequest() {
+    static std::atomic<bool> signal_request(false);
+    return signal_request;
+  }
+
+#if !defined(_WIN32)
+  static void OnSignal(int) {
+    GetSignalRequest().store(true, std::memory_order_release);
+  }
+#endif
+
+  void Poll() {
+    while (!stop_.load(std::memory_order_acquire)) {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(kFlightRecorderPollInterval));
+      if (dump_requested_.exchange(false, std::memory_order_acq_rel) ||
+          GetSignalRequest().exchange(false, std::memory_order_acq_rel)) {
+        Dump();
+      }
+    }
+  }
+
+  void Dump() {
+    std::vector<BinaryTraceRecord> record_list;
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      size_t capacity = record_list_.size();
+      size_t count = (std::min)(record_count_, capacity);
+      record_list.reserve(count);
+      for (size_t i = record_count_ - count; i < record_count_; ++i) {
+        record_list.push_back(record_list_[i % capacity]);
+      }
+    }
+
+    std::string filename = TraceOptions::GetBinaryTraceFileName(
+        (filename_ + "_" + std::to_string(dump_count_)).c_str());
+    ++dump_count_;
+
+    {
+      BinaryTraceWriter writer(
+          filename, pid_, start_point_, epoch_point_, process_name_);
+      for (const BinaryTraceRecord& record : record_list) {
+        writer.WriteRecord(record);
+      }
+    }
+
+    std::cerr << "[INFO] Ring buffer (" << record_list.size() <<
+      " records) was stored to " << filename << std::endl;
+  }
+
+ private: // Data
+  std::mutex lock_;
+  std::vector<BinaryTraceRecord> record_list_;
+  size_t record_count_ = 0;
+
+  std::string filename_;
+  uint32_t pid_ = 0;
+  uint64_t start_point_ = 0;
+  uint64_t epoch_point_ = 0;
+  std::string process_name_;
+  uint32_t dump_count_ = 0;
+
+  std::thread dumper_;
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> dump_requested_{false};
+};
+
+#endif // PTI_TOOLS_UTILS_FLIGHT_RECORDER_H_
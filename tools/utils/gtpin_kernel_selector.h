@@ -0,0 +1,120 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_GTPIN_KERNEL_SELECTOR_H_
+#define PTI_TOOLS_UTILS_GTPIN_KERNEL_SELECTOR_H_
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "api_filter.h"
+#include "gtpin_utils.h"
+#include "utils.h"
+
+#define GTPIN_KERNEL_INCLUDE_ENV      "PTI_KERNEL_INCLUDE"
+#define GTPIN_KERNEL_EXCLUDE_ENV      "PTI_KERNEL_EXCLUDE"
+#define GTPIN_KERNEL_LAUNCH_LIMIT_ENV "PTI_KERNEL_LAUNCH_LIMIT"
+
+// Decides which kernels GTPin collectors instrument and which launches
+// are profiled. Kernels are selected by name filter (see ApiFilter for
+// the pattern syntax) when they are built, the others are not
+// instrumented at all. Only the first launch_limit launches of a selected
+// kernel are profiled (no limit if zero), the rest of them and all the
+// launches of other kernels run the original binary
+class GTPinKernelSelector {
+ public: // Interface
+  // Takes the settings from PTI_KERNEL_INCLUDE, PTI_KERNEL_EXCLUDE and
+  // PTI_KERNEL_LAUNCH_LIMIT variables
+  GTPinKernelSelector()
+      : GTPinKernelSelector(utils::GetEnv(GTPIN_KERNEL_INCLUDE_ENV),
+                            utils::GetEnv(GTPIN_KERNEL_EXCLUDE_ENV),
+                            GetLaunchLimit()) {}
+
+  GTPinKernelSelector(const std::string& include_list,
+                      const std::string& exclude_list,
+                      uint32_t launch_limit)
+      : filter_(include_list, exclude_list), launch_limit_(launch_limit) {}
+
+  // Should be called from OnKernelBuild, returns true if the kernel is
+  // to be instrumented
+  bool OnBuild(GTPinKernel kernel, const char* name) {
+    PTI_ASSERT(name != nullptr);
+    if (!filter_.IsEnabled(name)) {
+      return false;
+    }
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    launch_map_[kernel] = 0;
+    return true;
+  }
+
+  // Should be called from OnKernelRun, enables or disables profiling of
+  // the launch
+  bool OnRun(GTPinKernelExec kernel_exec) {
+    bool active = IsActive(kernel_exec);
+    GTPin_KernelProfilingActive(kernel_exec, active ? 1 : 0);
+    return active;
+  }
+
+  // Should be called from OnKernelComplete, returns true if the launch was
+  // profiled, so its buffers are valid
+  bool OnComplete(GTPinKernelExec kernel_exec) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return active_exec_set_.erase(kernel_exec) > 0;
+  }
+
+  // Number of launches of the selected kernel, including unprofiled ones
+  uint32_t GetLaunchCount(GTPinKernel kernel) const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    auto it = launch_map_.find(kernel);
+    if (it == launch_map_.end()) {
+      return 0;
+    }
+    return it->second;
+  }
+
+  GTPinKernelSelector(const GTPinKernelSelector& copy) = delete;
+  GTPinKernelSelector& operator=(const GTPinKernelSelector& copy) = delete;
+
+ private: // Implementation
+  static uint32_t GetLaunchLimit() {
+    std::string value = utils::GetEnv(GTPIN_KERNEL_LAUNCH_LIMIT_ENV);
+    if (value.empty()) {
+      return 0;
+    }
+    return std::stoul(value);
+  }
+
+  bool IsActive(GTPinKernelExec kernel_exec) {
+    GTPinKernel kernel = GTPin_KernelExec_GetKernel(kernel_exec);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    auto it = launch_map_.find(kernel);
+    if (it == launch_map_.end()) {
+      return false;
+    }
+
+    uint32_t launch = it->second++;
+    if (launch_limit_ > 0 && launch >= launch_limit_) {
+      return false;
+    }
+
+    active_exec_set_.insert(kernel_exec);
+    return true;
+  }
+
+ private: // Data
+  ApiFilter filter_;
+  uint32_t launch_limit_ = 0;
+
+  mutable std::mutex lock_;
+  std::map<GTPinKernel, uint32_t> launch_map_;
+  std::set<GTPinKernelExec> active_exec_set_;
+};
+
+#endif // PTI_TOOLS_UTILS_GTPIN_KERNEL_SELECTOR_H_
\ No newline at end of file
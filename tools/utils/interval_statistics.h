@@ -0,0 +1,193 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_INTERVAL_STATISTICS_H_
+#define PTI_TOOLS_UTILS_INTERVAL_STATISTICS_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "atomic_stat_table.h"
+#include "pti_assert.h"
+
+// Kernel and API timing aggregated per time window into a CSV time series
+// (one row per name and window). Calls are added to one of two buffers,
+// each window the timer thread makes the other buffer active, waits for
+// the calls still running on the previous one and writes it out, so the
+// calls never wait for the output
+class IntervalStatistics {
+ public: // Interface
+  // Returns nullptr if the output file can't be created
+  static IntervalStatistics* Create(const std::string& filename,
+                                    uint32_t interval) {
+    PTI_ASSERT(interval > 0);
+    IntervalStatistics* statistics =
+      new IntervalStatistics(filename, interval);
+    PTI_ASSERT(statistics != nullptr);
+    if (!statistics->file_.is_open()) {
+      std::cerr << "[WARNING] Unable to create " << filename << std::endl;
+      delete statistics;
+      return nullptr;
+    }
+    statistics->thread_ = std::thread(&IntervalStatistics::Run, statistics);
+    return statistics;
+  }
+
+  // The last (partial) window is written on destruction
+  ~IntervalStatistics() {
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      stop_ = true;
+    }
+    condition_.notify_one();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    if (dropped_count_ > 0) {
+      std::cerr << "[WARNING] " << dropped_count_ << " calls of names " <<
+        "above " << ATOMIC_STAT_TABLE_SIZE << " per window were not " <<
+        "included into interval statistics" << std::endl;
+    }
+  }
+
+  void AddKernel(const std::string& name, uint64_t time) {
+    Buffer* buffer = Acquire();
+    buffer->kernel_table.Add(name, time);
+    buffer->writer_count.fetch_sub(1, std::memory_order_release);
+  }
+
+  void AddFunction(const std::string& name, uint64_t time) {
+    Buffer* buffer = Acquire();
+    buffer->function_table.Add(name, time);
+    buffer->writer_count.fetch_sub(1, std::memory_order_release);
+  }
+
+  IntervalStatistics(const IntervalStatistics& copy) = delete;
+  IntervalStatistics& operator=(const IntervalStatistics& copy) = delete;
+
+ private: // Implementation
+  struct Buffer {
+    std::atomic<uint32_t> writer_count{0};
+    AtomicStatTable kernel_table;
+    AtomicStatTable function_table;
+  };
+
+  IntervalStatistics(const std::string& filename, uint32_t interval)
+      : file_(filename), interval_(interval) {
+    start_ = std::chrono::steady_clock::now();
+    file_ << "Window,Start (ns),End (ns),Type,Name,Calls,Time (ns)," <<
+      "Average (ns),Min (ns),Max (ns)" << std::endl;
+  }
+
+  // The buffer is registered before it is checked to be still active,
+  // so the timer thread either sees the call or the call sees the swap
+  Buffer* Acquire() {
+    while (true) {
+      uint32_t index = active_.load(std::memory_order_seq_cst);
+      Buffer* buffer = &buffer_list_[index];
+      buffer->writer_count.fetch_add(1, std::memory_order_seq_cst);
+      if (active_.load(std::memory_order_seq_cst) == index) {
+        return buffer;
+      }
+      buffer->writer_count.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  void Run() {
+    uint32_t window = 0;
+    auto begin = start_;
+    bool stop = false;
+    while (!stop) {
+      {
+        std::unique_lock<std::mutex> lock(lock_);
+        stop = condition_.wait_until(
+            lock, begin + std::chrono::seconds(interval_),
+            [this] { return stop_; });
+      }
+      auto end = std::chrono::steady_clock::now();
+
+      uint32_t index = active_.load(std::memory_order_seq_cst);
+      active_.store(1 - index, std::memory_order_seq_cst);
+      Buffer& buffer = buffer_list_[index];
+      while (buffer.writer_count.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+      }
+
+      Write(window, begin, end, "Kernel", buffer.kernel_table);
+      Write(window, begin, end, "Function", buffer.function_table);
+      file_.flush();
+      dropped_count_ += buffer.kernel_table.GetDroppedCount() +
+        buffer.function_table.GetDroppedCount();
+      buffer.kernel_table.Reset();
+      buffer.function_table.Reset();
+
+      ++window;
+      begin = end;
+    }
+  }
+
+  void Write(uint32_t window, std::chrono::steady_clock::time_point begin,
+             std::chrono::steady_clock::time_point end, const char* type,
+             const AtomicStatTable& table) {
+    uint64_t begin_time =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          begin - start_).count();
+    uint64_t end_time =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          end - start_).count();
+    for (uint32_t i = 0; i < ATOMIC_STAT_TABLE_SIZE; ++i) {
+      AtomicStatTable::Snapshot snapshot;
+      const std::string* name = table.Read(i, &snapshot);
+      if (name == nullptr || snapshot.call_count == 0) {
+        continue;
+      }
+      file_ << window << "," << begin_time << "," << end_time << "," <<
+        type << "," << Quote(*name) << "," << snapshot.call_count << "," <<
+        snapshot.total_time << "," <<
+        snapshot.total_time / snapshot.call_count << "," <<
+        snapshot.min_time << "," << snapshot.max_time << "\n";
+    }
+  }
+
+  // Kernel names may have commas and quotes inside template arguments
+  static std::string Quote(const std::string& str) {
+    if (str.find_first_of(",\"") == std::string::npos) {
+      return str;
+    }
+    std::string result = "\"";
+    for (char symbol : str) {
+      if (symbol == '"') {
+        result += '"';
+      }
+      result += symbol;
+    }
+    return result + "\"";
+  }
+
+ private: // Data
+  std::ofstream file_;
+  uint32_t interval_; // s
+  std::chrono::steady_clock::time_point start_;
+
+  std::atomic<uint32_t> active_{0};
+  Buffer buffer_list_[2];
+  uint64_t dropped_count_ = 0;
+
+  std::mutex lock_;
+  std::condition_variable condition_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+#endif // PTI_TOOLS_UTILS_INTERVAL_STATISTICS_H_
@@ -0,0 +1,79 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#if !defined(_WIN32)
+#include <dlfcn.h>
+#endif
+
+#include "itt_collector.h"
+#include "utils.h"
+
+#if !defined(_WIN32)
+
+// ITT static part of the application loads the library named by this
+// variable and takes all the entry points below from it by name
+#define ITT_COLLECTOR_LIBRARY_ENV "INTEL_LIBITTNOTIFY64"
+
+bool IttCollector::SetCollectorLibrary() {
+  Dl_info info{};
+  int status = dladdr(
+      reinterpret_cast<void*>(&IttCollector::SetCollectorLibrary), &info);
+  if (status == 0 || info.dli_fname == nullptr) {
+    return false;
+  }
+  utils::SetEnv(ITT_COLLECTOR_LIBRARY_ENV, info.dli_fname);
+  return true;
+}
+
+extern "C" {
+
+// Presence of the version symbol makes ITT static part resolve all the
+// other entry points by name, missing ones stay no-op
+__attribute__((visibility("default")))
+const char* __itt_api_version() {
+  return "PTI ITT Collector";
+}
+
+__attribute__((visibility("default")))
+IttDomain* __itt_domain_create(const char* name) {
+  return IttCollector::CreateDomain(name);
+}
+
+__attribute__((visibility("default")))
+IttStringHandle* __itt_string_handle_create(const char* name) {
+  return IttCollector::CreateStringHandle(name);
+}
+
+__attribute__((visibility("default")))
+void __itt_task_begin(
+    const IttDomain* domain, IttId id, IttId parent, IttStringHandle* name) {
+  IttCollector::OnTaskBegin(domain, name);
+}
+
+__attribute__((visibility("default")))
+void __itt_task_end(const IttDomain* domain) {
+  IttCollector::OnTaskEnd(domain);
+}
+
+__attribute__((visibility("default")))
+void __itt_pause() {
+  IttCollector::OnPause();
+}
+
+__attribute__((visibility("default")))
+void __itt_resume() {
+  IttCollector::OnResume();
+}
+
+} // extern "C"
+
+#else
+
+bool IttCollector::SetCollectorLibrary() {
+  return false;
+}
+
+#endif
@@ -0,0 +1,466 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_ITT_COLLECTOR_H_
+#define PTI_TOOLS_UTILS_ITT_COLLECTOR_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "capture_control.h"
+#include "correlator.h"
+#include "pti_assert.h"
+#include "string_table.h"
+
+#define ITT_REGION_HISTORY_SIZE 65536
+
+// Objects handed out to the application through ITT API, the layout
+// follows ___itt_domain, ___itt_string_handle and ___itt_id from
+// ittnotify.h, so the application side of ITT can use them as is
+struct IttDomain {
+  volatile int flags; // Calls for the domain are made only if non-zero
+  const char* nameA;
+  void* nameW;
+  int extra1;
+  void* extra2;
+  IttDomain* next;
+};
+
+struct IttStringHandle {
+  const char* strA;
+  void* strW;
+  int extra1;
+  void* extra2;
+  IttStringHandle* next;
+};
+
+struct IttId {
+  unsigned long long d1;
+  unsigned long long d2;
+  unsigned long long d3;
+};
+
+struct IttKernelInfo {
+  uint64_t total_time;
+  uint64_t call_count;
+};
+
+struct IttRegionInfo {
+  uint64_t total_time;
+  uint64_t min_time;
+  uint64_t max_time;
+  uint64_t call_count;
+  std::map<std::string, IttKernelInfo> kernel_info_map;
+};
+
+using IttRegionInfoMap = std::map<uint32_t, IttRegionInfo>;
+
+typedef void (*OnIttTaskFinishCallback)(
+    void* data, const std::string& domain, const std::string& name,
+    uint64_t started, uint64_t ended);
+
+// Collector side of ITT API: the tool library exports ITT entry points
+// (see itt_collector.cc) and the application loads it as ITT collector.
+// Tasks are reported as host regions, kernels are attributed to the
+// innermost region that was open when the kernel was appended, and
+// __itt_pause/__itt_resume stop and start the capture
+class IttCollector {
+ public: // User Interface
+  static IttCollector* Create(
+      Correlator* correlator,
+      CaptureControl* capture,
+      OnIttTaskFinishCallback callback = nullptr,
+      void* callback_data = nullptr) {
+    PTI_ASSERT(correlator != nullptr);
+    IttCollector* collector = new IttCollector(
+        correlator, capture, callback, callback_data);
+    PTI_ASSERT(collector != nullptr);
+
+    if (!SetCollectorLibrary()) {
+      std::cerr << "[WARNING] Unable to register ITT collector" << std::endl;
+      delete collector;
+      return nullptr;
+    }
+
+    IttCollector* previous = nullptr;
+    bool registered = GetInstance().compare_exchange_strong(
+        previous, collector, std::memory_order_acq_rel);
+    PTI_ASSERT(registered);
+    return collector;
+  }
+
+  ~IttCollector() {
+    DisableTracing();
+  }
+
+  void DisableTracing() {
+    IttCollector* collector = this;
+    GetInstance().compare_exchange_strong(
+        collector, nullptr, std::memory_order_acq_rel);
+  }
+
+  // Called for each finished kernel with host timestamps
+  void AddKernel(const std::string& name, uint64_t appended,
+                 uint64_t started, uint64_t ended) {
+    PTI_ASSERT(started <= ended);
+    const std::lock_guard<std::mutex> lock(lock_);
+
+    const Region* region = nullptr;
+    for (const Region& open : open_list_) {
+      if (open.start <= appended &&
+          (region == nullptr || open.start > region->start)) {
+        region = &open;
+      }
+    }
+
+    // History is ordered by region end, so only the regions closed after
+    // the kernel was appended are checked
+    auto it = std::lower_bound(
+        history_.begin(), history_.end(), appended,
+        [](const Region& closed, uint64_t time) {
+          return closed.end < time;
+        });
+    for (; it != history_.end(); ++it) {
+      if (it->start <= appended &&
+          (region == nullptr || it->start > region->start)) {
+        region = &(*it);
+      }
+    }
+
+    if (region == nullptr) {
+      return;
+    }
+
+    IttKernelInfo& info =
+      region_info_map_[region->name_id].kernel_info_map[name];
+    info.total_time += ended - started;
+    ++info.call_count;
+  }
+
+  IttRegionInfoMap GetRegionInfoMap() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return region_info_map_;
+  }
+
+  void PrintRegionsTable() const {
+    IttRegionInfoMap region_info_map = GetRegionInfoMap();
+    if (region_info_map.empty()) {
+      return;
+    }
+
+    std::vector< std::pair<std::string, const IttRegionInfo*> > sorted_list;
+    size_t max_name_length = kRegionLength;
+    for (auto& value : region_info_map) {
+      const std::string& name = StringTable::Get(value.first);
+      sorted_list.emplace_back(name, &value.second);
+      if (name.size() > max_name_length) {
+        max_name_length = name.size();
+      }
+    }
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              [](const std::pair<std::string, const IttRegionInfo*>& left,
+                 const std::pair<std::string, const IttRegionInfo*>& right) {
+                if (left.second->total_time != right.second->total_time) {
+                  return left.second->total_time > right.second->total_time;
+                }
+                return left.first < right.first;
+              });
+
+    std::stringstream stream;
+    stream << std::setw(max_name_length) << "Region" << "," <<
+      std::setw(kCallsLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kTimeLength) << "Average (ns)" << "," <<
+      std::setw(kTimeLength) << "Min (ns)" << "," <<
+      std::setw(kTimeLength) << "Max (ns)" << std::endl;
+
+    for (auto& value : sorted_list) {
+      const IttRegionInfo& info = *(value.second);
+      if (info.call_count == 0) { // Kernels of a region not closed yet
+        continue;
+      }
+      stream << std::setw(max_name_length) << value.first << "," <<
+        std::setw(kCallsLength) << info.call_count << "," <<
+        std::setw(kTimeLength) << info.total_time << "," <<
+        std::setw(kTimeLength) << info.total_time / info.call_count << "," <<
+        std::setw(kTimeLength) << info.min_time << "," <<
+        std::setw(kTimeLength) << info.max_time << std::endl;
+    }
+
+    for (auto& value : sorted_list) {
+      const IttRegionInfo& info = *(value.second);
+      if (info.kernel_info_map.empty()) {
+        continue;
+      }
+      stream << std::endl;
+      stream << "== Kernels of Region " << value.first << ": ==" <<
+        std::endl;
+      stream << std::endl;
+      PrintKernelsTable(stream, info.kernel_info_map);
+    }
+
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  IttCollector(const IttCollector& copy) = delete;
+  IttCollector& operator=(const IttCollector& copy) = delete;
+
+ public: // ITT Interface
+  // Domains and string handles are never released, since the application
+  // may keep them up to the very end of the process
+  static IttDomain* CreateDomain(const char* name) {
+    if (name == nullptr) {
+      return nullptr;
+    }
+    const std::lock_guard<std::mutex> lock(GetHandleLock());
+    std::map<std::string, IttDomain*>& domain_map = GetDomainMap();
+    auto it = domain_map.find(name);
+    if (it != domain_map.end()) {
+      return it->second;
+    }
+    IttDomain* domain = new IttDomain{};
+    PTI_ASSERT(domain != nullptr);
+    domain->flags = 1;
+    domain->nameA = StringTable::Get(StringTable::Add(name)).c_str();
+    domain_map[name] = domain;
+    return domain;
+  }
+
+  static IttStringHandle* CreateStringHandle(const char* name) {
+    if (name == nullptr) {
+      return nullptr;
+    }
+    const std::lock_guard<std::mutex> lock(GetHandleLock());
+    std::map<std::string, IttStringHandle*>& handle_map = GetHandleMap();
+    auto it = handle_map.find(name);
+    if (it != handle_map.end()) {
+      return it->second;
+    }
+    IttStringHandle* handle = new IttStringHandle{};
+    PTI_ASSERT(handle != nullptr);
+    uint32_t name_id = StringTable::Add(name);
+    handle->strA = StringTable::Get(name_id).c_str();
+    handle->extra1 = static_cast<int>(name_id);
+    handle_map[name] = handle;
+    return handle;
+  }
+
+  static void OnTaskBegin(
+      const IttDomain* domain, const IttStringHandle* name) {
+    IttCollector* collector = GetInstance().load(std::memory_order_acquire);
+    if (collector != nullptr) {
+      collector->BeginTask(domain, name);
+    }
+  }
+
+  static void OnTaskEnd(const IttDomain* domain) {
+    IttCollector* collector = GetInstance().load(std::memory_order_acquire);
+    if (collector != nullptr) {
+      collector->EndTask(domain);
+    }
+  }
+
+  static void OnPause() {
+    IttCollector* collector = GetInstance().load(std::memory_order_acquire);
+    if (collector != nullptr && collector->capture_ != nullptr) {
+      collector->capture_->Pause();
+    }
+  }
+
+  static void OnResume() {
+    IttCollector* collector = GetInstance().load(std::memory_order_acquire);
+    if (collector != nullptr && collector->capture_ != nullptr) {
+      collector->capture_->Resume();
+    }
+  }
+
+ private: // Implementation Details
+  struct Region {
+    uint32_t name_id;
+    uint64_t start;
+    uint64_t end;
+  };
+
+  struct Task {
+    const IttDomain* domain;
+    std::list<Region>::iterator region; // open_list_.end() if not traced
+  };
+
+  IttCollector(
+      Correlator* correlator,
+      CaptureControl* capture,
+      OnIttTaskFinishCallback callback,
+      void* callback_data)
+      : correlator_(correlator),
+        capture_(capture),
+        callback_(callback),
+        callback_data_(callback_data) {}
+
+  static std::atomic<IttCollector*>& GetInstance() {
+    static std::atomic<IttCollector*> instance{nullptr};
+    return instance;
+  }
+
+  static std::mutex& GetHandleLock() {
+    static std::mutex lock;
+    return lock;
+  }
+
+  static std::map<std::string, IttDomain*>& GetDomainMap() {
+    static std::map<std::string, IttDomain*> domain_map;
+    return domain_map;
+  }
+
+  static std::map<std::string, IttStringHandle*>& GetHandleMap() {
+    static std::map<std::string, IttStringHandle*> handle_map;
+    return handle_map;
+  }
+
+  // Task stack of the calling thread, tasks are nested within a thread
+  static std::vector<Task>& GetTaskStack() {
+    thread_local std::vector<Task> task_stack;
+    return task_stack;
+  }
+
+  // Points ITT static part of the application to the tool library,
+  // defined in itt_collector.cc
+  static bool SetCollectorLibrary();
+
+  void BeginTask(const IttDomain* domain, const IttStringHandle* name) {
+    std::vector<Task>& task_stack = GetTaskStack();
+    if (name == nullptr ||
+        (capture_ != nullptr && !capture_->IsActive())) {
+      const std::lock_guard<std::mutex> lock(lock_);
+      task_stack.push_back({domain, open_list_.end()});
+      return;
+    }
+
+    uint32_t name_id = static_cast<uint32_t>(name->extra1);
+    const std::lock_guard<std::mutex> lock(lock_);
+    open_list_.push_back({name_id, correlator_->GetTimestamp(), 0});
+    task_stack.push_back({domain, std::prev(open_list_.end())});
+  }
+
+  void EndTask(const IttDomain* domain) {
+    std::vector<Task>& task_stack = GetTaskStack();
+    if (task_stack.empty()) {
+      return;
+    }
+    Task task = task_stack.back();
+    task_stack.pop_back();
+
+    Region region{0, 0, 0};
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      if (task.region == open_list_.end()) {
+        return;
+      }
+
+      // End time is taken under the lock to keep the history ordered
+      region = *(task.region);
+      region.end = correlator_->GetTimestamp();
+      open_list_.erase(task.region);
+
+      history_.push_back(region);
+      if (history_.size() > ITT_REGION_HISTORY_SIZE) {
+        history_.pop_front();
+      }
+
+      uint64_t time = region.end - region.start;
+      IttRegionInfo& info = region_info_map_[region.name_id];
+      if (info.call_count == 0) {
+        info.min_time = time;
+        info.max_time = time;
+      } else {
+        info.min_time = std::min(info.min_time, time);
+        info.max_time = std::max(info.max_time, time);
+      }
+      info.total_time += time;
+      ++info.call_count;
+    }
+
+    if (callback_ != nullptr) {
+      PTI_ASSERT(task.domain != nullptr && task.domain->nameA != nullptr);
+      callback_(callback_data_, task.domain->nameA,
+                StringTable::Get(region.name_id), region.start, region.end);
+    }
+  }
+
+  static void PrintKernelsTable(
+      std::stringstream& stream,
+      const std::map<std::string, IttKernelInfo>& kernel_info_map) {
+    std::vector< std::pair<std::string, IttKernelInfo> > sorted_list(
+        kernel_info_map.begin(), kernel_info_map.end());
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              [](const std::pair<std::string, IttKernelInfo>& left,
+                 const std::pair<std::string, IttKernelInfo>& right) {
+                if (left.second.total_time != right.second.total_time) {
+                  return left.second.total_time > right.second.total_time;
+                }
+                return left.first < right.first;
+              });
+
+    uint64_t total_duration = 0;
+    size_t max_name_length = kKernelLength;
+    for (auto& value : sorted_list) {
+      total_duration += value.second.total_time;
+      if (value.first.size() > max_name_length) {
+        max_name_length = value.first.size();
+      }
+    }
+
+    stream << std::setw(max_name_length) << "Kernel" << "," <<
+      std::setw(kCallsLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kPercentLength) << "Time (%)" << "," <<
+      std::setw(kTimeLength) << "Average (ns)" << std::endl;
+
+    for (auto& value : sorted_list) {
+      uint64_t duration = value.second.total_time;
+      uint64_t call_count = value.second.call_count;
+      float percent_duration = (total_duration == 0) ?
+        0.0f : 100.0f * duration / total_duration;
+      stream << std::setw(max_name_length) << value.first << "," <<
+        std::setw(kCallsLength) << call_count << "," <<
+        std::setw(kTimeLength) << duration << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << percent_duration << "," <<
+        std::setw(kTimeLength) << duration / call_count << std::endl;
+    }
+  }
+
+ private: // Data
+  Correlator* correlator_ = nullptr;
+  CaptureControl* capture_ = nullptr;
+
+  OnIttTaskFinishCallback callback_ = nullptr;
+  void* callback_data_ = nullptr;
+
+  std::list<Region> open_list_;
+  std::deque<Region> history_;
+  IttRegionInfoMap region_info_map_;
+  mutable std::mutex lock_;
+
+  static const uint32_t kRegionLength = 10;
+  static const uint32_t kKernelLength = 10;
+  static const uint32_t kCallsLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kPercentLength = 10;
+};
+
+#endif // PTI_TOOLS_UTILS_ITT_COLLECTOR_H_
@@ -0,0 +1,171 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_KERNEL_ENERGY_H_
+#define PTI_TOOLS_UTILS_KERNEL_ENERGY_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "energy_sampler.h"
+#include "kernel_interval_store.h"
+#include "pti_assert.h"
+#include "string_table.h"
+#include "utils.h"
+
+// Splits the energy the device has used while kernels ran between them.
+// Kernel intervals are cut at every start and end of any kernel, the
+// energy of each piece is shared equally by the kernels running during
+// it, so overlapping kernels get energy in proportion to their overlap
+// and the energy of idle time goes to no one. Thread-safe
+class KernelEnergy {
+ public: // Interface
+  void AddKernel(const std::string& name, uint64_t started, uint64_t ended) {
+    PTI_ASSERT(started <= ended);
+    if (started == ended) {
+      return;
+    }
+    uint32_t name_id = StringTable::Add(name);
+    const std::lock_guard<std::mutex> lock(lock_);
+    kernel_store_.AddLaunch(name_id, 0, started, ended, 0, 1);
+  }
+
+  bool IsEmpty() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return kernel_store_.IsEmpty();
+  }
+
+  void PrintTable(const EnergySampler& sampler, std::ostream& stream) const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    if (kernel_store_.IsEmpty()) {
+      return;
+    }
+
+    std::vector<uint64_t> point_list;
+    kernel_store_.ForEachLaunch(
+        [&](const KernelIntervalRecord* interval_list, uint32_t count) {
+          point_list.push_back(interval_list[0].start);
+          point_list.push_back(interval_list[0].end);
+        });
+    std::sort(point_list.begin(), point_list.end());
+    point_list.erase(std::unique(point_list.begin(), point_list.end()),
+                     point_list.end());
+
+    // Number of kernels that start minus the ones that end at each point
+    std::vector<int64_t> delta_list(point_list.size(), 0);
+    kernel_store_.ForEachLaunch(
+        [&](const KernelIntervalRecord* interval_list, uint32_t count) {
+          ++delta_list[GetPointId(point_list, interval_list[0].start)];
+          --delta_list[GetPointId(point_list, interval_list[0].end)];
+        });
+
+    // Energy a kernel running from the first point gets up to each point
+    std::vector<double> share_list(point_list.size(), 0.0);
+    int64_t active_count = 0;
+    for (size_t i = 0; i + 1 < point_list.size(); ++i) {
+      active_count += delta_list[i];
+      PTI_ASSERT(active_count >= 0);
+      share_list[i + 1] = share_list[i];
+      if (active_count > 0) {
+        share_list[i + 1] += sampler.GetEnergy(
+            point_list[i], point_list[i + 1]) / active_count;
+      }
+    }
+
+    std::map<uint32_t, EnergyInfo> kernel_map;
+    double total_energy = 0.0;
+    kernel_store_.ForEachLaunch(
+        [&](const KernelIntervalRecord* interval_list, uint32_t count) {
+          const KernelIntervalRecord& interval = interval_list[0];
+          double energy =
+            share_list[GetPointId(point_list, interval.end)] -
+            share_list[GetPointId(point_list, interval.start)];
+          EnergyInfo& kernel = kernel_map[interval.name_id];
+          ++kernel.call_count;
+          kernel.time += interval.end - interval.start;
+          kernel.energy += energy;
+          total_energy += energy;
+        });
+
+    std::vector<std::pair<uint32_t, EnergyInfo> > kernel_list(
+        kernel_map.begin(), kernel_map.end());
+    std::sort(kernel_list.begin(), kernel_list.end(),
+              [](const std::pair<uint32_t, EnergyInfo>& left,
+                 const std::pair<uint32_t, EnergyInfo>& right) {
+                return left.second.energy > right.second.energy;
+              });
+
+    size_t max_name_length = kKernelLength;
+    for (const auto& value : kernel_list) {
+      size_t length = StringTable::Get(value.first).size();
+      if (length > max_name_length) {
+        max_name_length = length;
+      }
+    }
+
+    double device_energy = sampler.GetTotalEnergy();
+    stream << "Total Device Energy (J): " << std::setprecision(6) <<
+      std::fixed << device_energy << std::endl;
+    stream << "Total Kernel Energy (J): " << total_energy << std::endl;
+    stream << std::endl;
+
+    stream << std::setw(max_name_length) << "Kernel" << "," <<
+      std::setw(kCallsLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kEnergyLength) << "Energy (J)" << "," <<
+      std::setw(kPercentLength) << "Energy (%)" << "," <<
+      std::setw(kEnergyLength) << "Average Power (W)" << std::endl;
+    for (const auto& value : kernel_list) {
+      const EnergyInfo& kernel = value.second;
+      double percent = (total_energy > 0.0) ?
+        100.0 * kernel.energy / total_energy : 0.0;
+      double power = kernel.energy * NSEC_IN_SEC / kernel.time;
+      stream << std::setw(max_name_length) <<
+        StringTable::Get(value.first) << "," <<
+        std::setw(kCallsLength) << kernel.call_count << "," <<
+        std::setw(kTimeLength) << kernel.time << "," <<
+        std::setw(kEnergyLength) << std::setprecision(6) << std::fixed <<
+          kernel.energy << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) << std::fixed <<
+          percent << "," <<
+        std::setw(kEnergyLength) << std::setprecision(3) << std::fixed <<
+          power << std::endl;
+    }
+  }
+
+ private: // Implementation
+  struct EnergyInfo {
+    uint64_t call_count = 0;
+    uint64_t time = 0; // ns
+    double energy = 0.0; // J
+  };
+
+  static size_t GetPointId(const std::vector<uint64_t>& point_list,
+                           uint64_t point) {
+    auto it = std::lower_bound(point_list.begin(), point_list.end(), point);
+    PTI_ASSERT(it != point_list.end() && *it == point);
+    return it - point_list.begin();
+  }
+
+ private: // Data
+  mutable std::mutex lock_;
+  KernelIntervalStore<uint32_t> kernel_store_;
+
+  static const uint32_t kKernelLength = 6;
+  static const uint32_t kCallsLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kEnergyLength = 20;
+  static const uint32_t kPercentLength = 12;
+};
+
+#endif // PTI_TOOLS_UTILS_KERNEL_ENERGY_H_
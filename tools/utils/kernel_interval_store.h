@@ -0,0 +1,251 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_KERNEL_INTERVAL_STORE_H_
+#define PTI_TOOLS_UTILS_KERNEL_INTERVAL_STORE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "pti_assert.h"
+
+#define KERNEL_INTERVAL_CHUNK_SIZE 4096 // Records, 128 KB
+#define KERNEL_INTERVAL_MEMORY_CHUNKS 256 // Kept in memory before spilling
+
+// Execution of a kernel launch on one (sub-)device. Records of the same
+// launch go one after another, the first one gives their count
+struct KernelIntervalRecord {
+  uint64_t start; // ns
+  uint64_t end; // ns
+  uint32_t name_id; // See StringTable
+  uint32_t device_index; // See KernelIntervalStore::GetDevice
+  uint32_t sub_device_id;
+  uint32_t interval_count; // Zero for all but the first record of a launch
+};
+
+static_assert(sizeof(KernelIntervalRecord) == 32,
+              "Kernel interval record should be 32 bytes");
+
+// Append-only store of kernel intervals in fixed-size chunks, so millions
+// of launches take 32 bytes per device interval and no small allocations.
+// Once the chunks in memory go over the limit, the oldest ones are moved
+// to an anonymous temporary file and read back chunk by chunk on each
+// visit. The store is not thread-safe
+template <typename D>
+class KernelIntervalStore {
+ public: // Interface
+  using Device = D;
+
+  // Zero chunk count keeps all the records in memory
+  explicit KernelIntervalStore(
+      uint32_t memory_chunk_count = KERNEL_INTERVAL_MEMORY_CHUNKS)
+      : memory_chunk_count_(memory_chunk_count) {}
+
+  ~KernelIntervalStore() {
+    if (spill_file_ != nullptr) {
+      fclose(spill_file_);
+    }
+  }
+
+  // The launch ran from start to end on the given number of consecutive
+  // sub-devices of the root device
+  void AddLaunch(uint32_t name_id, Device device, uint64_t start,
+                 uint64_t end, uint32_t sub_device_id,
+                 uint32_t sub_device_count) {
+    PTI_ASSERT(sub_device_count > 0);
+    PTI_ASSERT(sub_device_count <= KERNEL_INTERVAL_CHUNK_SIZE);
+    Chunk& chunk = GetChunk(sub_device_count);
+    uint32_t device_index = GetDeviceIndex(device);
+    for (uint32_t i = 0; i < sub_device_count; ++i) {
+      chunk.push_back({start, end, name_id, device_index,
+                       sub_device_id + i, (i == 0) ? sub_device_count : 0});
+    }
+    ++launch_count_;
+  }
+
+  // Visitor takes the records of each launch, in the order of addition:
+  // void(const KernelIntervalRecord* interval_list, uint32_t count)
+  template <typename F>
+  void ForEachLaunch(F visitor) const {
+    Chunk chunk;
+    for (const SpilledChunk& spilled : spilled_list_) {
+      ReadChunk(spilled, &chunk);
+      VisitChunk(chunk, visitor);
+    }
+    for (const Chunk& chunk : chunk_list_) {
+      VisitChunk(chunk, visitor);
+    }
+  }
+
+  const Device& GetDevice(uint32_t device_index) const {
+    PTI_ASSERT(device_index < device_list_.size());
+    return device_list_[device_index];
+  }
+
+  // Moves all the records of the other store to the end of this one
+  void Splice(KernelIntervalStore* other) {
+    PTI_ASSERT(other != nullptr && other != this);
+
+    std::vector<uint32_t> index_list;
+    bool same_devices = true;
+    for (uint32_t i = 0; i < other->device_list_.size(); ++i) {
+      index_list.push_back(GetDeviceIndex(other->device_list_[i]));
+      same_devices = same_devices && index_list.back() == i;
+    }
+
+    Chunk chunk;
+    for (const SpilledChunk& spilled : other->spilled_list_) {
+      other->ReadChunk(spilled, &chunk);
+      AddChunk(&chunk, same_devices ? nullptr : &index_list);
+    }
+    for (Chunk& chunk : other->chunk_list_) {
+      AddChunk(&chunk, same_devices ? nullptr : &index_list);
+    }
+    launch_count_ += other->launch_count_;
+    other->Clear();
+  }
+
+  void Clear() {
+    chunk_list_.clear();
+    spilled_list_.clear();
+    if (spill_file_ != nullptr) {
+      fclose(spill_file_);
+      spill_file_ = nullptr;
+    }
+    spill_size_ = 0;
+    launch_count_ = 0;
+  }
+
+  uint64_t GetLaunchCount() const {
+    return launch_count_;
+  }
+
+  bool IsEmpty() const {
+    return launch_count_ == 0;
+  }
+
+  KernelIntervalStore(const KernelIntervalStore& copy) = delete;
+  KernelIntervalStore& operator=(const KernelIntervalStore& copy) = delete;
+
+ private: // Implementation
+  using Chunk = std::vector<KernelIntervalRecord>;
+
+  struct SpilledChunk {
+    uint64_t offset; // bytes
+    uint32_t record_count;
+  };
+
+  // Few devices are in use, so the table is searched linearly
+  uint32_t GetDeviceIndex(const Device& device) {
+    for (uint32_t i = 0; i < device_list_.size(); ++i) {
+      if (device_list_[i] == device) {
+        return i;
+      }
+    }
+    PTI_ASSERT(device_list_.size() < (std::numeric_limits<uint32_t>::max)());
+    device_list_.push_back(device);
+    return static_cast<uint32_t>(device_list_.size() - 1);
+  }
+
+  // Records of a launch never cross chunk boundaries
+  Chunk& GetChunk(uint32_t record_count) {
+    if (chunk_list_.empty() ||
+        chunk_list_.back().size() + record_count >
+          KERNEL_INTERVAL_CHUNK_SIZE) {
+      chunk_list_.emplace_back();
+      chunk_list_.back().reserve(KERNEL_INTERVAL_CHUNK_SIZE);
+      Spill();
+    }
+    return chunk_list_.back();
+  }
+
+  // Chunk is taken as a whole, its device indices are remapped if needed
+  void AddChunk(Chunk* chunk, const std::vector<uint32_t>* index_list) {
+    PTI_ASSERT(chunk != nullptr);
+    if (index_list != nullptr) {
+      for (KernelIntervalRecord& record : *chunk) {
+        PTI_ASSERT(record.device_index < index_list->size());
+        record.device_index = (*index_list)[record.device_index];
+      }
+    }
+    chunk_list_.emplace_back();
+    chunk_list_.back().swap(*chunk);
+    Spill();
+  }
+
+  // All the chunks but the last one (that is being filled) may go to
+  // the file, the first chunks go first to keep the order of records
+  void Spill() {
+    if (memory_chunk_count_ == 0) {
+      return;
+    }
+
+    while (chunk_list_.size() > memory_chunk_count_ &&
+           chunk_list_.size() > 1) {
+      if (spill_file_ == nullptr) {
+        spill_file_ = tmpfile();
+        if (spill_file_ == nullptr) {
+          std::cerr << "[WARNING] Unable to create temporary file, " <<
+            "kernel intervals are kept in memory" << std::endl;
+          memory_chunk_count_ = 0;
+          return;
+        }
+      }
+
+      const Chunk& chunk = chunk_list_.front();
+      PTI_ASSERT(!chunk.empty());
+      size_t written = fwrite(chunk.data(), sizeof(KernelIntervalRecord),
+                              chunk.size(), spill_file_);
+      PTI_ASSERT(written == chunk.size());
+      spilled_list_.push_back(
+          {spill_size_, static_cast<uint32_t>(chunk.size())});
+      spill_size_ += chunk.size() * sizeof(KernelIntervalRecord);
+      chunk_list_.pop_front();
+    }
+  }
+
+  void ReadChunk(const SpilledChunk& spilled, Chunk* chunk) const {
+    PTI_ASSERT(chunk != nullptr);
+    PTI_ASSERT(spill_file_ != nullptr);
+    chunk->resize(spilled.record_count);
+    int status = fseek(spill_file_, static_cast<long>(spilled.offset),
+                       SEEK_SET);
+    PTI_ASSERT(status == 0);
+    size_t read = fread(chunk->data(), sizeof(KernelIntervalRecord),
+                        chunk->size(), spill_file_);
+    PTI_ASSERT(read == chunk->size());
+    // Writes continue at the end of the file
+    status = fseek(spill_file_, 0, SEEK_END);
+    PTI_ASSERT(status == 0);
+  }
+
+  template <typename F>
+  static void VisitChunk(const Chunk& chunk, F& visitor) {
+    size_t i = 0;
+    while (i < chunk.size()) {
+      uint32_t count = chunk[i].interval_count;
+      PTI_ASSERT(count > 0 && i + count <= chunk.size());
+      visitor(chunk.data() + i, count);
+      i += count;
+    }
+  }
+
+ private: // Data
+  std::deque<Chunk> chunk_list_;
+  std::vector<SpilledChunk> spilled_list_;
+  std::vector<Device> device_list_;
+  FILE* spill_file_ = nullptr;
+  uint64_t spill_size_ = 0; // bytes
+  uint64_t launch_count_ = 0;
+  uint32_t memory_chunk_count_ = 0;
+};
+
+#endif // PTI_TOOLS_UTILS_KERNEL_INTERVAL_STORE_H_
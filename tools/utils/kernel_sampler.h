@@ -0,0 +1,157 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_KERNEL_SAMPLER_H_
+#define PTI_TOOLS_UTILS_KERNEL_SAMPLER_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "pti_assert.h"
+
+#define KERNEL_SAMPLER_SEED 0x9e3779b97f4a7c15ull
+
+// Selects kernel launches to instrument. The sampling spec is either an
+// integer period N (every N-th launch of each kernel is taken, starting
+// from the first one) or a rate in (0, 1) (each launch is taken with the
+// given probability). Statistics of the taken launches are scaled back
+// to all the launches of the kernel with GetScale. On top of the spec the
+// launches may be throttled at run time, see SetThrottle
+class KernelSampler {
+ public: // Interface
+  explicit KernelSampler(const std::string& spec = std::string()) {
+    if (!spec.empty()) {
+      bool valid = Parse(spec, &period_, &rate_);
+      PTI_ASSERT(valid);
+    }
+  }
+
+  static bool IsValid(const std::string& spec) {
+    uint32_t period = 0;
+    double rate = 0.0;
+    return Parse(spec, &period, &rate);
+  }
+
+  bool IsEnabled() const {
+    return period_ > 1 || rate_ < 1.0 ||
+      throttled_.load(std::memory_order_relaxed);
+  }
+
+  // Of the launches the spec takes, every N-th one of each kernel is
+  // traced. Once set, all the launches are counted to keep the scale
+  // right, so it should be set before the first launch (with N = 1)
+  void SetThrottle(uint32_t period) {
+    PTI_ASSERT(period > 0);
+    throttle_period_.store(period, std::memory_order_relaxed);
+    throttled_.store(true, std::memory_order_relaxed);
+  }
+
+  // Called once per launch, returns true if the launch is to be traced
+  bool Sample(uint32_t name_id) {
+    if (!IsEnabled()) {
+      return true;
+    }
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    Counter& counter = counter_map_[name_id];
+    bool sampled = true;
+    if (period_ > 1) {
+      sampled = (counter.launch_count % period_ == 0);
+    } else if (rate_ < 1.0) {
+      sampled = (GetNextRandom() < rate_);
+    }
+    ++counter.launch_count;
+
+    uint32_t throttle_period =
+      throttle_period_.load(std::memory_order_relaxed);
+    if (sampled && throttle_period > 1) {
+      sampled = (counter.throttle_count % throttle_period == 0);
+      ++counter.throttle_count;
+    }
+    if (sampled) {
+      ++counter.sample_count;
+    }
+    return sampled;
+  }
+
+  // Ratio of all the launches of the kernel to the traced ones
+  double GetScale(uint32_t name_id) const {
+    if (!IsEnabled()) {
+      return 1.0;
+    }
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    auto it = counter_map_.find(name_id);
+    if (it == counter_map_.end() || it->second.sample_count == 0) {
+      return 1.0;
+    }
+    return static_cast<double>(it->second.launch_count) /
+      it->second.sample_count;
+  }
+
+  KernelSampler(const KernelSampler& copy) = delete;
+  KernelSampler& operator=(const KernelSampler& copy) = delete;
+
+ private: // Implementation
+  struct Counter {
+    uint64_t launch_count = 0;
+    uint64_t sample_count = 0;
+    uint64_t throttle_count = 0;
+  };
+
+  static bool Parse(const std::string& spec, uint32_t* period, double* rate) {
+    PTI_ASSERT(period != nullptr && rate != nullptr);
+    if (spec.empty()) {
+      return false;
+    }
+
+    if (spec.find('.') == std::string::npos) {
+      char* end = nullptr;
+      unsigned long value = strtoul(spec.c_str(), &end, 10);
+      if (*end != '\0' || value == 0 || value > UINT32_MAX) {
+        return false;
+      }
+      *period = static_cast<uint32_t>(value);
+      *rate = 1.0;
+      return true;
+    }
+
+    char* end = nullptr;
+    double value = strtod(spec.c_str(), &end);
+    if (*end != '\0' || !(value > 0.0) || value > 1.0) {
+      return false;
+    }
+    *period = 1;
+    *rate = value;
+    return true;
+  }
+
+  // Fixed seed keeps the selection the same from run to run
+  double GetNextRandom() {
+    random_state_ ^= random_state_ << 13;
+    random_state_ ^= random_state_ >> 7;
+    random_state_ ^= random_state_ << 17;
+    return static_cast<double>(random_state_ >> 11) /
+      static_cast<double>(1ull << 53);
+  }
+
+ private: // Data
+  uint32_t period_ = 1;
+  double rate_ = 1.0;
+  std::atomic<uint32_t> throttle_period_{1};
+  std::atomic<bool> throttled_{false};
+
+  mutable std::mutex lock_;
+  std::unordered_map<uint32_t, Counter> counter_map_;
+  uint64_t random_state_ = KERNEL_SAMPLER_SEED;
+};
+
+#endif // PTI_TOOLS_UTILS_KERNEL_SAMPLER_H_
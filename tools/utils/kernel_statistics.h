@@ -0,0 +1,306 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_KERNEL_STATISTICS_H_
+#define PTI_TOOLS_UTILS_KERNEL_STATISTICS_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flat_hash_map.h"
+#include "kernel_sampler.h"
+#include "latency_histogram.h"
+#include "pti_assert.h"
+#include "string_table.h"
+#include "utils.h"
+
+struct KernelInfo {
+  uint64_t total_time;
+  uint64_t min_time;
+  uint64_t max_time;
+  uint64_t call_count;
+  uint32_t name_id; // Kernel name, differs from the key if grouped by config
+  LatencyHistogram time_histogram;
+
+  bool operator>(const KernelInfo& r) const {
+    if (total_time != r.total_time) {
+      return total_time > r.total_time;
+    }
+    return call_count > r.call_count;
+  }
+
+  bool operator!=(const KernelInfo& r) const {
+    if (total_time == r.total_time) {
+      return call_count != r.call_count;
+    }
+    return true;
+  }
+};
+
+// Key is the kernel name, or the name with the launch config if requested
+using KernelInfoMap = std::map<uint32_t, KernelInfo>;
+
+// Launch config of a device command, the aggregation key. Sizes of
+// non-kernel commands are zero
+struct KernelConfig {
+  uint32_t name_id;
+  uint32_t simd_width;
+  uint64_t bytes_transferred;
+  uint64_t global_size[3]; // Group count for Level Zero
+  uint64_t local_size[3];
+
+  bool operator==(const KernelConfig& r) const {
+    return name_id == r.name_id && simd_width == r.simd_width &&
+      bytes_transferred == r.bytes_transferred &&
+      global_size[0] == r.global_size[0] &&
+      global_size[1] == r.global_size[1] &&
+      global_size[2] == r.global_size[2] &&
+      local_size[0] == r.local_size[0] &&
+      local_size[1] == r.local_size[1] &&
+      local_size[2] == r.local_size[2];
+  }
+};
+
+struct KernelConfigHash {
+  size_t operator()(const KernelConfig& config) const {
+    uint64_t hash = config.name_id;
+    hash = hash * 31 + config.simd_width;
+    hash = hash * 31 + config.bytes_transferred;
+    for (int i = 0; i < 3; ++i) {
+      hash = hash * 31 + config.global_size[i];
+      hash = hash * 31 + config.local_size[i];
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+// Part of the launch config the report rows are told by
+enum KernelGrouping {
+  KERNEL_GROUPING_NAME,
+  KERNEL_GROUPING_LOCAL_SIZE, // SIMD width and local size
+  KERNEL_GROUPING_CONFIG // SIMD width, global/local sizes, bytes
+};
+
+// Backend-specific name of the grouped config, e.g. "name[SIMD32 ...]"
+typedef std::string (*KernelConfigFormatter)(
+    const KernelConfig& config, KernelGrouping grouping);
+
+// Backend-neutral aggregation of device command durations and the kernel
+// table shared by all the kernel collectors. Durations are kept per launch
+// config and grouped into the report at the end, so no names are built
+// per command. The class is not thread-safe, durations are expected from
+// the processing thread
+class KernelStatistics {
+ public: // Interface
+  void Add(const KernelConfig& config, uint64_t time) {
+    KernelInfo* kernel = config_map_.Find(config);
+    if (kernel == nullptr) {
+      kernel = &config_map_[config];
+      *kernel = KernelInfo{time, time, time, 1, config.name_id, {}};
+      kernel->time_histogram.Add(time);
+    } else {
+      kernel->total_time += time;
+      if (time > kernel->max_time) {
+        kernel->max_time = time;
+      }
+      if (time < kernel->min_time) {
+        kernel->min_time = time;
+      }
+      kernel->call_count += 1;
+      kernel->time_histogram.Add(time);
+    }
+  }
+
+  // Commands known by the name only
+  void Add(uint32_t name_id, uint64_t time) {
+    KernelConfig config{};
+    config.name_id = name_id;
+    Add(config, time);
+  }
+
+  // Statistics of sampled kernels are scaled to all their launches. The
+  // formatter is only called for the groups finer than the name
+  KernelInfoMap GetInfoMap(
+      const KernelSampler& sampler,
+      KernelGrouping grouping = KERNEL_GROUPING_NAME,
+      KernelConfigFormatter formatter = nullptr) const {
+    PTI_ASSERT(grouping == KERNEL_GROUPING_NAME || formatter != nullptr);
+
+    KernelInfoMap info_map;
+    for (auto& value : config_map_) {
+      uint32_t info_id = value.first.name_id;
+      if (grouping != KERNEL_GROUPING_NAME) {
+        info_id = StringTable::Add(
+            formatter(GetGroup(value.first, grouping), grouping));
+      }
+
+      auto it = info_map.find(info_id);
+      if (it == info_map.end()) {
+        info_map.emplace(info_id, value.second);
+      } else {
+        Merge(value.second, &(it->second));
+      }
+    }
+
+    if (sampler.IsEnabled()) {
+      for (auto& value : info_map) {
+        KernelInfo& info = value.second;
+        double scale = sampler.GetScale(info.name_id);
+        info.total_time = static_cast<uint64_t>(info.total_time * scale);
+        info.call_count = static_cast<uint64_t>(info.call_count * scale + 0.5);
+      }
+    }
+    return info_map;
+  }
+
+  // Returns false if the grouping is unknown
+  static bool ParseGrouping(const std::string& value,
+                            KernelGrouping* grouping) {
+    PTI_ASSERT(grouping != nullptr);
+    if (value == "name") {
+      *grouping = KERNEL_GROUPING_NAME;
+    } else if (value == "local") {
+      *grouping = KERNEL_GROUPING_LOCAL_SIZE;
+    } else if (value == "config") {
+      *grouping = KERNEL_GROUPING_CONFIG;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // Fields of the config out of the group are reset to zero
+  static KernelConfig GetGroup(const KernelConfig& config,
+                               KernelGrouping grouping) {
+    KernelConfig group{};
+    group.name_id = config.name_id;
+    if (grouping == KERNEL_GROUPING_NAME) {
+      return group;
+    }
+    group.simd_width = config.simd_width;
+    for (int i = 0; i < 3; ++i) {
+      group.local_size[i] = config.local_size[i];
+    }
+    if (grouping == KERNEL_GROUPING_LOCAL_SIZE) {
+      return group;
+    }
+    return config;
+  }
+
+  static void Merge(const KernelInfo& info, KernelInfo* total) {
+    PTI_ASSERT(total != nullptr);
+    total->total_time += info.total_time;
+    total->min_time = (std::min)(total->min_time, info.min_time);
+    total->max_time = (std::max)(total->max_time, info.max_time);
+    total->call_count += info.call_count;
+    total->time_histogram.Merge(info.time_histogram);
+  }
+
+  static uint64_t GetP99(const KernelInfo& info) {
+    return info.time_histogram.GetPercentile(
+        99.0, info.min_time, info.max_time);
+  }
+
+  // Nothing is printed if no time is collected. The same layout serves
+  // host functions with a different first column title. Percents are
+  // taken of the given total time (e.g. if only some rows are passed),
+  // zero total takes the sum of the rows. Rows go by total time, or by
+  // 99th percentile if requested
+  static void PrintTable(
+      const KernelInfoMap& info_map, std::ostream& stream,
+      const std::string& title = "Kernel", uint64_t total_time = 0,
+      bool by_p99 = false) {
+    std::set< std::pair<std::string, KernelInfo>,
+              utils::Comparator > sorted_set;
+    for (auto& value : info_map) {
+      sorted_set.emplace(StringTable::Get(value.first), value.second);
+    }
+
+    std::vector< std::pair<std::string, KernelInfo> > sorted_list(
+        sorted_set.begin(), sorted_set.end());
+    if (by_p99) {
+      std::stable_sort(
+          sorted_list.begin(), sorted_list.end(),
+          [](const std::pair<std::string, KernelInfo>& left,
+             const std::pair<std::string, KernelInfo>& right) {
+            return GetP99(left.second) > GetP99(right.second);
+          });
+    }
+
+    uint64_t total_duration = total_time;
+    size_t max_name_length = kKernelLength;
+    for (auto& value : sorted_list) {
+      if (total_time == 0) {
+        total_duration += value.second.total_time;
+      }
+      if (value.first.size() > max_name_length) {
+        max_name_length = value.first.size();
+      }
+    }
+
+    if (total_duration == 0) {
+      return;
+    }
+
+    stream << std::setw(max_name_length) << title << "," <<
+      std::setw(kCallsLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kPercentLength) << "Time (%)" << "," <<
+      std::setw(kTimeLength) << "Average (ns)" << "," <<
+      std::setw(kTimeLength) << "Min (ns)" << "," <<
+      std::setw(kTimeLength) << "Max (ns)" << "," <<
+      std::setw(kTimeLength) << "P50 (ns)" << "," <<
+      std::setw(kTimeLength) << "P90 (ns)" << "," <<
+      std::setw(kTimeLength) << "P99 (ns)" << "," <<
+      std::setw(kTimeLength) << "P99.9 (ns)" << std::endl;
+
+    for (auto& value : sorted_list) {
+      const std::string& function = value.first;
+      uint64_t call_count = value.second.call_count;
+      uint64_t duration = value.second.total_time;
+      uint64_t avg_duration = duration / call_count;
+      uint64_t min_duration = value.second.min_time;
+      uint64_t max_duration = value.second.max_time;
+      const LatencyHistogram& histogram = value.second.time_histogram;
+      float percent_duration = 100.0f * duration / total_duration;
+      stream << std::setw(max_name_length) << function << "," <<
+        std::setw(kCallsLength) << call_count << "," <<
+        std::setw(kTimeLength) << duration << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << percent_duration << "," <<
+        std::setw(kTimeLength) << avg_duration << "," <<
+        std::setw(kTimeLength) << min_duration << "," <<
+        std::setw(kTimeLength) << max_duration << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(50.0, min_duration, max_duration) << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(90.0, min_duration, max_duration) << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(99.0, min_duration, max_duration) << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(99.9, min_duration, max_duration) <<
+          std::endl;
+    }
+  }
+
+ private: // Data
+  FlatHashMap<KernelConfig, KernelInfo, KernelConfigHash> config_map_;
+
+  static const uint32_t kKernelLength = 10;
+  static const uint32_t kCallsLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kPercentLength = 10;
+};
+
+#endif // PTI_TOOLS_UTILS_KERNEL_STATISTICS_H_
@@ -0,0 +1,154 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_LATENCY_HISTOGRAM_H_
+#define PTI_TOOLS_UTILS_LATENCY_HISTOGRAM_H_
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <stdint.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "pti_assert.h"
+
+#define LATENCY_HISTOGRAM_SUB_BITS 4 // 16 buckets per power of two
+#define LATENCY_HISTOGRAM_MAX_BITS 40 // ~18 minutes in ns, larger are clamped
+
+// Log-linear (HDR-style) histogram of durations. Values below 16 have
+// their own buckets, each next power of two range is split into 16 equal
+// buckets, so the relative error of a percentile is within 1/32 (bucket
+// midpoint is reported). Memory is fixed and the update is O(1)
+class LatencyHistogram {
+ public: // Interface
+  void Add(uint64_t value) {
+    ++bucket_list_[GetIndex(value)];
+  }
+
+  void Merge(const LatencyHistogram& histogram) {
+    for (uint32_t i = 0; i < kBucketCount; ++i) {
+      bucket_list_[i] += histogram.bucket_list_[i];
+    }
+  }
+
+  // Percent is in [0, 100], exact minimum and maximum bound the estimate
+  uint64_t GetPercentile(
+      double percent, uint64_t min_value, uint64_t max_value) const {
+    PTI_ASSERT(percent >= 0.0 && percent <= 100.0);
+    PTI_ASSERT(min_value <= max_value);
+
+    uint64_t count = 0;
+    for (uint64_t bucket : bucket_list_) {
+      count += bucket;
+    }
+    if (count == 0) {
+      return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percent * count / 100.0));
+    if (rank == 0) {
+      rank = 1;
+    }
+
+    uint64_t value = max_value;
+    uint64_t current = 0;
+    for (uint32_t i = 0; i < kBucketCount; ++i) {
+      current += bucket_list_[i];
+      if (current >= rank) {
+        // The last bucket also holds all the larger values
+        value = (i < kBucketCount - 1) ? GetMidpoint(i) : max_value;
+        break;
+      }
+    }
+
+    if (value < min_value) {
+      return min_value;
+    }
+    if (value > max_value) {
+      return max_value;
+    }
+    return value;
+  }
+
+  // Non-empty buckets as (index, count) pairs, see GetBucketBounds
+  std::vector<std::pair<uint32_t, uint64_t> > GetBucketList() const {
+    std::vector<std::pair<uint32_t, uint64_t> > bucket_list;
+    for (uint32_t i = 0; i < kBucketCount; ++i) {
+      if (bucket_list_[i] > 0) {
+        bucket_list.emplace_back(i, bucket_list_[i]);
+      }
+    }
+    return bucket_list;
+  }
+
+  // Values of the bucket are in [lower, upper), the last bucket has no
+  // upper bound and gives the maximum value
+  static void GetBucketBounds(uint32_t index, uint64_t* lower,
+                              uint64_t* upper) {
+    PTI_ASSERT(index < kBucketCount);
+    PTI_ASSERT(lower != nullptr && upper != nullptr);
+    if (index < kSubCount) {
+      *lower = index;
+      *upper = index + 1;
+      return;
+    }
+    uint32_t shift = index / kSubCount - 1;
+    *lower = static_cast<uint64_t>(kSubCount + index % kSubCount) << shift;
+    *upper = (index < kBucketCount - 1) ? *lower + (1ull << shift) :
+      (std::numeric_limits<uint64_t>::max)();
+  }
+
+ private: // Implementation
+  static constexpr uint32_t kSubCount = 1u << LATENCY_HISTOGRAM_SUB_BITS;
+  static constexpr uint32_t kBucketCount = kSubCount *
+    (LATENCY_HISTOGRAM_MAX_BITS - LATENCY_HISTOGRAM_SUB_BITS + 1);
+
+  static uint32_t GetMostSignificantBit(uint64_t value) {
+    PTI_ASSERT(value != 0);
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+  }
+
+  static uint32_t GetIndex(uint64_t value) {
+    if (value < kSubCount) {
+      return static_cast<uint32_t>(value);
+    }
+    uint32_t bit = GetMostSignificantBit(value);
+    if (bit >= LATENCY_HISTOGRAM_MAX_BITS) {
+      return kBucketCount - 1;
+    }
+    uint32_t shift = bit - LATENCY_HISTOGRAM_SUB_BITS;
+    return (shift + 1) * kSubCount +
+      static_cast<uint32_t>((value >> shift) - kSubCount);
+  }
+
+  static uint64_t GetMidpoint(uint32_t index) {
+    PTI_ASSERT(index < kBucketCount);
+    if (index < kSubCount) {
+      return index;
+    }
+    uint32_t shift = index / kSubCount - 1;
+    uint64_t lower = static_cast<uint64_t>(kSubCount + index % kSubCount) <<
+      shift;
+    return lower + ((1ull << shift) >> 1);
+  }
+
+ private: // Data
+  std::array<uint64_t, kBucketCount> bucket_list_{};
+};
+
+#endif // PTI_TOOLS_UTILS_LATENCY_HISTOGRAM_H_
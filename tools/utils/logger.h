@@ -7,40 +7,300 @@
 #ifndef PTI_TOOLS_UTILS_LOGGER_H_
 #define PTI_TOOLS_UTILS_LOGGER_H_
 
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <fstream>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "overhead.h"
 #include "pti_assert.h"
+#include "stream_compressor.h"
+
+const uint32_t kLoggerFlushInterval = 10; // ms
+const size_t kLoggerFrameSize = 4 * 1024 * 1024; // Before compression
+
+// Single-producer single-consumer byte ring: the owning thread appends
+// whole log records, the writer thread takes everything published so far
+class LogBuffer {
+ public:
+  LogBuffer(size_t capacity) : data_(capacity), head_(0), tail_(0) {
+    PTI_ASSERT(capacity > 0);
+  }
+
+  size_t GetCapacity() const {
+    return data_.size();
+  }
+
+  bool Push(const char* text, size_t size) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    if (data_.size() - (head - tail) < size) {
+      return false;
+    }
+
+    size_t offset = head % data_.size();
+    size_t part = (std::min)(size, data_.size() - offset);
+    memcpy(data_.data() + offset, text, part);
+    memcpy(data_.data(), text + part, size - part);
 
+    head_.store(head + size, std::memory_order_release);
+    return true;
+  }
+
+  void Pop(std::vector<char>& output) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t head = head_.load(std::memory_order_acquire);
+    if (head == tail) {
+      return;
+    }
+
+    size_t size = head - tail;
+    size_t offset = tail % data_.size();
+    size_t part = (std::min)(size, data_.size() - offset);
+    output.insert(output.end(),
+                  data_.begin() + offset, data_.begin() + offset + part);
+    output.insert(output.end(),
+                  data_.begin(), data_.begin() + (size - part));
+
+    tail_.store(head, std::memory_order_release);
+  }
+
+  LogBuffer(const LogBuffer& copy) = delete;
+  LogBuffer& operator=(const LogBuffer& copy) = delete;
+
+ private:
+  std::vector<char> data_;
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+};
+
+// Compressed files (see StreamCompressor) get the extension of the method
+// and are always written from the background thread, which collects the
+// records into frames of kLoggerFrameSize
 class Logger {
  public:
-  Logger(const std::string& filename) {
-    if (!filename.empty()) {
-      file_.open(filename);
+  static const size_t kDefaultBufferSize = 1024 * 1024;
+
+  Logger(const std::string& filename,
+         bool async = false, size_t buffer_size = kDefaultBufferSize,
+         const std::string& compression = std::string())
+      : filename_(filename), async_(async), buffer_size_(buffer_size),
+        logger_id_(GetNextId()) {
+    if (!filename_.empty() && !compression.empty()) {
+      compressor_ = StreamCompressor::Create(compression);
+      if (compressor_ != nullptr) {
+        filename_ += compressor_->GetFileExt();
+        async_ = true;
+      }
+    }
+
+    if (!filename_.empty()) {
+      file_.open(filename_, (compressor_ != nullptr) ?
+                 std::ios::out | std::ios::binary : std::ios::out);
       PTI_ASSERT(file_.is_open());
     }
+
+    if (async_) {
+      PTI_ASSERT(buffer_size_ > 0);
+      writer_ = std::thread(&Logger::Write, this);
+    }
   }
 
   ~Logger() {
+    if (async_) {
+      {
+        const std::lock_guard<std::mutex> lock(buffer_lock_);
+        stop_ = true;
+      }
+      writer_cv_.notify_one();
+      writer_.join();
+
+      for (LogBuffer* buffer : buffer_list_) {
+        delete buffer;
+      }
+    }
+
+    if (compressor_ != nullptr) {
+      WriteFrame();
+      std::vector<char> output;
+      compressor_->AddSeekTable(&output);
+      file_.write(output.data(), output.size());
+      delete compressor_;
+    }
+
     if (file_.is_open()) {
       file_.close();
     }
   }
 
   void Log(const std::string& text) {
-    if (file_.is_open()) {
-      const std::lock_guard<std::mutex> lock(lock_);
+    if (async_) {
+      LogAsync(text);
+    } else if (file_.is_open()) {
+      const OverheadLockGuard lock(lock_, OVERHEAD_LOGGER);
+      OverheadScope overhead(OVERHEAD_LOGGER, OVERHEAD_IO, text.size());
       file_ << text << std::flush;
     } else {
+      OverheadScope overhead(OVERHEAD_LOGGER, OVERHEAD_IO, text.size());
       std::cerr << text << std::flush;
     }
   }
 
+  // Empty if the records go to stderr
+  const std::string& GetFileName() const {
+    return filename_;
+  }
+
+  Logger(const Logger& copy) = delete;
+  Logger& operator=(const Logger& copy) = delete;
+
+ private:
+  static uint64_t GetNextId() {
+    static std::atomic<uint64_t> next_id(1);
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Logger IDs are never reused, so entries left by destroyed loggers
+  // are never hit again
+  LogBuffer* GetThreadBuffer() {
+    thread_local std::unordered_map<uint64_t, LogBuffer*> buffer_cache;
+    auto it = buffer_cache.find(logger_id_);
+    if (it != buffer_cache.end()) {
+      return it->second;
+    }
+
+    LogBuffer* buffer = new LogBuffer(buffer_size_);
+    PTI_ASSERT(buffer != nullptr);
+    {
+      const std::lock_guard<std::mutex> lock(buffer_lock_);
+      buffer_list_.push_back(buffer);
+    }
+
+    buffer_cache[logger_id_] = buffer;
+    return buffer;
+  }
+
+  void LogAsync(const std::string& text) {
+    LogBuffer* buffer = GetThreadBuffer();
+    PTI_ASSERT(buffer != nullptr);
+
+    if (text.size() > buffer->GetCapacity()) {
+      // Record doesn't fit the ring at all: drain own buffer to keep
+      // the order of this thread's records and write it directly
+      const std::lock_guard<std::mutex> lock(lock_);
+      std::vector<char> output;
+      buffer->Pop(output);
+      output.insert(output.end(), text.begin(), text.end());
+      Output(output);
+      return;
+    }
+
+    while (!buffer->Push(text.data(), text.size())) {
+      drain_requested_.store(true, std::memory_order_release);
+      writer_cv_.notify_one();
+      std::this_thread::yield();
+    }
+  }
+
+  void Output(const std::vector<char>& output) {
+    if (output.empty()) {
+      return;
+    }
+
+    if (compressor_ != nullptr) {
+      frame_.insert(frame_.end(), output.begin(), output.end());
+      if (frame_.size() >= kLoggerFrameSize) {
+        WriteFrame();
+      }
+      return;
+    }
+
+    OverheadScope overhead(OVERHEAD_LOGGER, OVERHEAD_IO, output.size());
+    if (file_.is_open()) {
+      file_.write(output.data(), output.size());
+      file_.flush();
+    } else {
+      std::cerr.write(output.data(), output.size());
+      std::cerr.flush();
+    }
+  }
+
+  void WriteFrame() {
+    PTI_ASSERT(compressor_ != nullptr);
+    if (frame_.empty()) {
+      return;
+    }
+
+    OverheadScope overhead(OVERHEAD_LOGGER, OVERHEAD_IO, frame_.size());
+    std::vector<char> output;
+    compressor_->AddFrame(frame_.data(), frame_.size(), &output);
+    file_.write(output.data(), output.size());
+    file_.flush();
+    frame_.clear();
+  }
+
+  // Background writer: wakes up periodically or when some producer runs
+  // out of space, collects all published records and issues one write
+  void Write() {
+    std::vector<LogBuffer*> buffer_list;
+    std::vector<char> output;
+
+    while (true) {
+      bool stop = false;
+      {
+        std::unique_lock<std::mutex> lock(buffer_lock_);
+        writer_cv_.wait_for(
+            lock, std::chrono::milliseconds(kLoggerFlushInterval),
+            [this]{
+              return stop_ ||
+                drain_requested_.load(std::memory_order_acquire);
+            });
+        drain_requested_.store(false, std::memory_order_relaxed);
+        stop = stop_;
+        buffer_list = buffer_list_;
+      }
+
+      {
+        const std::lock_guard<std::mutex> lock(lock_);
+        output.clear();
+        for (LogBuffer* buffer : buffer_list) {
+          buffer->Pop(output);
+        }
+        Output(output);
+      }
+
+      if (stop) {
+        break;
+      }
+    }
+  }
+
  private:
   std::mutex lock_;
+  std::string filename_;
   std::ofstream file_;
+  StreamCompressor* compressor_ = nullptr;
+  std::vector<char> frame_; // Records not compressed yet
+
+  bool async_ = false;
+  size_t buffer_size_ = 0;
+  uint64_t logger_id_ = 0;
+
+  std::thread writer_;
+  std::condition_variable writer_cv_;
+  std::mutex buffer_lock_;
+  std::vector<LogBuffer*> buffer_list_;
+  bool stop_ = false;
+  std::atomic<bool> drain_requested_{false}; // Some producer ring is full
 };
 
-#endif // PTI_TOOLS_UTILS_LOGGER_H_
\ No newline at end of file
+#endif // PTI_TOOLS_UTILS_LOGGER_H_
@@ -0,0 +1,336 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_MEMORY_TRACKER_H_
+#define PTI_TOOLS_UTILS_MEMORY_TRACKER_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "callsite_cache.h"
+#include "pti_assert.h"
+#include "transfer_timing.h"
+
+#define MEMORY_TRACKER_HOST_POOL      0xFFFFFFFF
+#define MEMORY_TRACKER_CALLSITE_COUNT 20
+
+struct MemoryAllocation {
+  uintptr_t end;
+  TransferMemoryType type;
+  uint32_t pool; // Device index or MEMORY_TRACKER_HOST_POOL
+  uint32_t callsite_id;
+  uint64_t time;
+  bool counted; // Allocated while tracing, so it is in the footprint
+};
+
+struct MemoryPoolInfo {
+  uint64_t alloc_count = 0;
+  uint64_t free_count = 0;
+  uint64_t total_bytes = 0;
+  uint64_t current_bytes = 0;
+  uint64_t peak_bytes = 0;
+  uint64_t peak_time = 0;
+  uint64_t max_size = 0;
+};
+
+struct MemoryCallsiteInfo {
+  TransferMemoryType type = TRANSFER_MEMORY_UNKNOWN;
+  uint64_t alloc_count = 0;
+  uint64_t total_bytes = 0;
+  uint64_t free_count = 0;
+  uint64_t total_lifetime = 0; // Of the freed allocations
+  uint64_t live_count = 0;
+  uint64_t live_bytes = 0;
+};
+
+using MemoryAllocationMap = std::map<uintptr_t, MemoryAllocation>;
+using MemoryPoolInfoMap = std::map<uint32_t, MemoryPoolInfo>;
+using MemoryCallsiteKey = std::pair<uint32_t, TransferMemoryType>;
+using MemoryCallsiteInfoMap = std::map<MemoryCallsiteKey, MemoryCallsiteInfo>;
+
+typedef void (*OnMemoryUsageCallback)(
+    void* data, uint32_t pool, uint64_t timestamp, uint64_t bytes);
+
+// Live allocations as an interval map keyed by the base address, so any
+// pointer into an allocation is resolved in O(log n). Footprint of each
+// pool (device or host) is updated on every allocation and free and is
+// passed to the callback to build a counter track. Allocations found by
+// the backend after the fact (made before tracing started) may be added
+// as ranges only, they are resolved but not counted. Thread-safe
+class MemoryTracker {
+ public: // Interface
+  explicit MemoryTracker(
+      OnMemoryUsageCallback callback = nullptr, void* callback_data = nullptr)
+      : callback_(callback), callback_data_(callback_data) {}
+
+  void AddAllocation(
+      const void* ptr, size_t size, TransferMemoryType type,
+      uint32_t pool, uint32_t callsite_id, uint64_t timestamp) {
+    if (ptr == nullptr || size == 0) {
+      return;
+    }
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(ptr);
+    uint64_t current_bytes = 0;
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      Erase(start, timestamp); // Range was freed without being traced
+      allocation_map_[start] =
+        {start + size, type, pool, callsite_id, timestamp, true};
+
+      MemoryPoolInfo& pool_info = pool_info_map_[pool];
+      ++pool_info.alloc_count;
+      pool_info.total_bytes += size;
+      pool_info.current_bytes += size;
+      if (pool_info.current_bytes > pool_info.peak_bytes) {
+        pool_info.peak_bytes = pool_info.current_bytes;
+        pool_info.peak_time = timestamp;
+      }
+      if (size > pool_info.max_size) {
+        pool_info.max_size = size;
+      }
+      current_bytes = pool_info.current_bytes;
+
+      MemoryCallsiteInfo& callsite_info =
+        callsite_info_map_[std::make_pair(callsite_id, type)];
+      callsite_info.type = type;
+      ++callsite_info.alloc_count;
+      callsite_info.total_bytes += size;
+      ++callsite_info.live_count;
+      callsite_info.live_bytes += size;
+    }
+
+    if (callback_ != nullptr) {
+      callback_(callback_data_, pool, timestamp, current_bytes);
+    }
+  }
+
+  void AddRange(const void* base, size_t size, TransferMemoryType type) {
+    if (base == nullptr || size == 0) {
+      return;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(base);
+    const std::lock_guard<std::mutex> lock(lock_);
+    allocation_map_[start] = {
+        start + size, type, MEMORY_TRACKER_HOST_POOL, 0, 0, false};
+  }
+
+  // Pointer should be the base of the allocation, unknown ones are skipped
+  void RemoveAllocation(const void* ptr, uint64_t timestamp) {
+    uintptr_t start = reinterpret_cast<uintptr_t>(ptr);
+    uint32_t pool = 0;
+    uint64_t current_bytes = 0;
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      if (!Erase(start, timestamp, &pool, &current_bytes)) {
+        return;
+      }
+    }
+
+    if (callback_ != nullptr) {
+      callback_(callback_data_, pool, timestamp, current_bytes);
+    }
+  }
+
+  bool Find(const void* ptr, MemoryAllocation* allocation) const {
+    PTI_ASSERT(allocation != nullptr);
+    uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    auto it = allocation_map_.upper_bound(address);
+    if (it == allocation_map_.begin()) {
+      return false;
+    }
+    --it;
+    if (address >= it->second.end) {
+      return false;
+    }
+    *allocation = it->second;
+    return true;
+  }
+
+  bool IsEmpty() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return pool_info_map_.empty();
+  }
+
+  static std::string GetPoolName(uint32_t pool) {
+    if (pool == MEMORY_TRACKER_HOST_POOL) {
+      return "Host";
+    }
+    return "GPU " + std::to_string(pool);
+  }
+
+  static const char* GetTypeName(TransferMemoryType type) {
+    switch (type) {
+      case TRANSFER_MEMORY_HOST:
+        return "Host";
+      case TRANSFER_MEMORY_DEVICE:
+        return "Device";
+      case TRANSFER_MEMORY_SHARED:
+        return "Shared";
+      default:
+        break;
+    }
+    return "Unknown";
+  }
+
+  void PrintTables(std::ostream& stream) const {
+    MemoryPoolInfoMap pool_info_map;
+    MemoryCallsiteInfoMap callsite_info_map;
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      pool_info_map = pool_info_map_;
+      callsite_info_map = callsite_info_map_;
+    }
+    if (pool_info_map.empty()) {
+      return;
+    }
+
+    stream << std::setw(kPoolLength) << "Pool" << "," <<
+      std::setw(kCountLength) << "Allocations" << "," <<
+      std::setw(kCountLength) << "Frees" << "," <<
+      std::setw(kBytesLength) << "Allocated (bytes)" << "," <<
+      std::setw(kBytesLength) << "Max Size (bytes)" << "," <<
+      std::setw(kBytesLength) << "Peak (bytes)" << "," <<
+      std::setw(kBytesLength) << "Peak Time (ns)" << "," <<
+      std::setw(kBytesLength) << "Live (bytes)" << std::endl;
+
+    for (auto& value : pool_info_map) {
+      const MemoryPoolInfo& info = value.second;
+      stream << std::setw(kPoolLength) << GetPoolName(value.first) << "," <<
+        std::setw(kCountLength) << info.alloc_count << "," <<
+        std::setw(kCountLength) << info.free_count << "," <<
+        std::setw(kBytesLength) << info.total_bytes << "," <<
+        std::setw(kBytesLength) << info.max_size << "," <<
+        std::setw(kBytesLength) << info.peak_bytes << "," <<
+        std::setw(kBytesLength) << info.peak_time << "," <<
+        std::setw(kBytesLength) << info.current_bytes << std::endl;
+    }
+
+    // Callsites that allocate the most are on top, short average lifetime
+    // with many allocations means churn, live bytes at the end mean leaks
+    std::vector< std::pair<MemoryCallsiteKey, MemoryCallsiteInfo> >
+      sorted_list(callsite_info_map.begin(), callsite_info_map.end());
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              [](const std::pair<MemoryCallsiteKey, MemoryCallsiteInfo>& l,
+                 const std::pair<MemoryCallsiteKey, MemoryCallsiteInfo>& r) {
+                if (l.second.total_bytes != r.second.total_bytes) {
+                  return l.second.total_bytes > r.second.total_bytes;
+                }
+                return l.first < r.first;
+              });
+    if (sorted_list.size() > MEMORY_TRACKER_CALLSITE_COUNT) {
+      sorted_list.resize(MEMORY_TRACKER_CALLSITE_COUNT);
+    }
+
+    size_t max_name_length = kCallsiteLength;
+    for (auto& value : sorted_list) {
+      const std::string& name = CallsiteCache::GetName(value.first.first);
+      if (name.size() > max_name_length) {
+        max_name_length = name.size();
+      }
+    }
+
+    stream << std::endl;
+    stream << std::setw(max_name_length) << "Callsite" << "," <<
+      std::setw(kTypeLength) << "Type" << "," <<
+      std::setw(kCountLength) << "Allocations" << "," <<
+      std::setw(kBytesLength) << "Allocated (bytes)" << "," <<
+      std::setw(kCountLength) << "Frees" << "," <<
+      std::setw(kBytesLength) << "Avg Lifetime (ns)" << "," <<
+      std::setw(kCountLength) << "Live" << "," <<
+      std::setw(kBytesLength) << "Live (bytes)" << std::endl;
+
+    for (auto& value : sorted_list) {
+      const MemoryCallsiteInfo& info = value.second;
+      uint64_t lifetime = (info.free_count > 0) ?
+        info.total_lifetime / info.free_count : 0;
+      stream << std::setw(max_name_length) <<
+          CallsiteCache::GetName(value.first.first) << "," <<
+        std::setw(kTypeLength) << GetTypeName(info.type) << "," <<
+        std::setw(kCountLength) << info.alloc_count << "," <<
+        std::setw(kBytesLength) << info.total_bytes << "," <<
+        std::setw(kCountLength) << info.free_count << "," <<
+        std::setw(kBytesLength) << lifetime << "," <<
+        std::setw(kCountLength) << info.live_count << "," <<
+        std::setw(kBytesLength) << info.live_bytes << std::endl;
+    }
+  }
+
+  // See CallsiteCache
+  uint32_t GetCallsite() {
+    return callsite_cache_.Get();
+  }
+
+  MemoryTracker(const MemoryTracker& copy) = delete;
+  MemoryTracker& operator=(const MemoryTracker& copy) = delete;
+
+ private: // Implementation
+  // Lock should be held
+  bool Erase(uintptr_t start, uint64_t timestamp,
+             uint32_t* pool = nullptr, uint64_t* current_bytes = nullptr) {
+    auto it = allocation_map_.find(start);
+    if (it == allocation_map_.end()) {
+      return false;
+    }
+
+    MemoryAllocation allocation = it->second;
+    allocation_map_.erase(it);
+    if (!allocation.counted) {
+      return false;
+    }
+
+    uint64_t size = allocation.end - start;
+    MemoryPoolInfo& pool_info = pool_info_map_[allocation.pool];
+    ++pool_info.free_count;
+    PTI_ASSERT(pool_info.current_bytes >= size);
+    pool_info.current_bytes -= size;
+
+    MemoryCallsiteInfo& callsite_info = callsite_info_map_[
+        std::make_pair(allocation.callsite_id, allocation.type)];
+    ++callsite_info.free_count;
+    if (timestamp > allocation.time) {
+      callsite_info.total_lifetime += timestamp - allocation.time;
+    }
+    PTI_ASSERT(callsite_info.live_count > 0);
+    --callsite_info.live_count;
+    callsite_info.live_bytes -= size;
+
+    if (pool != nullptr) {
+      *pool = allocation.pool;
+    }
+    if (current_bytes != nullptr) {
+      *current_bytes = pool_info.current_bytes;
+    }
+    return true;
+  }
+
+ private: // Data
+  OnMemoryUsageCallback callback_ = nullptr;
+  void* callback_data_ = nullptr;
+
+  MemoryAllocationMap allocation_map_;
+  MemoryPoolInfoMap pool_info_map_;
+  MemoryCallsiteInfoMap callsite_info_map_;
+  CallsiteCache callsite_cache_;
+  mutable std::mutex lock_;
+
+  static const uint32_t kPoolLength = 8;
+  static const uint32_t kCallsiteLength = 10;
+  static const uint32_t kTypeLength = 8;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kBytesLength = 20;
+};
+
+#endif // PTI_TOOLS_UTILS_MEMORY_TRACKER_H_
\ No newline at end of file
@@ -0,0 +1,359 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include "omp_device_collector.h"
+#include "utils.h"
+
+#if defined(PTI_OMPT)
+
+#include <omp-tools.h>
+
+namespace {
+
+// Entry points of a device and the point the time bases were aligned at
+struct OmpDevice {
+  ompt_device_t* device;
+  ompt_flush_trace_t flush_trace;
+  ompt_stop_trace_t stop_trace;
+  ompt_get_record_ompt_t get_record_ompt;
+  ompt_advance_buffer_cursor_t advance_buffer_cursor;
+  ompt_translate_time_t translate_time;
+  ompt_device_time_t device_base;
+  uint64_t host_base;
+};
+
+// Begin records of target regions that are not closed yet
+struct OmpTarget {
+  uint64_t codeptr;
+  uint64_t start;
+};
+
+std::mutex device_lock;
+std::map<int, OmpDevice> device_map;
+std::map<uint64_t, OmpTarget> target_map;
+
+std::mutex buffer_lock;
+std::vector<char*> free_buffer_list;
+
+uint64_t GetHostTime(const OmpDevice& device, ompt_device_time_t time) {
+  if (device.translate_time == nullptr) {
+    return device.host_base + (time - device.device_base);
+  }
+  double delta =
+    device.translate_time(device.device, time) -
+    device.translate_time(device.device, device.device_base);
+  return device.host_base + static_cast<int64_t>(delta * NSEC_IN_SEC);
+}
+
+void BufferRequest(int device_num, ompt_buffer_t** buffer, size_t* bytes) {
+  PTI_ASSERT(buffer != nullptr && bytes != nullptr);
+  char* data = nullptr;
+  {
+    const std::lock_guard<std::mutex> lock(buffer_lock);
+    if (!free_buffer_list.empty()) {
+      data = free_buffer_list.back();
+      free_buffer_list.pop_back();
+    }
+  }
+  if (data == nullptr) {
+    data = new char[OMP_DEVICE_BUFFER_SIZE];
+    PTI_ASSERT(data != nullptr);
+  }
+  *buffer = data;
+  *bytes = OMP_DEVICE_BUFFER_SIZE;
+}
+
+bool GetRecord(
+    const OmpDevice& device, const ompt_record_ompt_t* record,
+    OmpDeviceRecord& result) {
+  result = OmpDeviceRecord{};
+  result.target_id = record->target_id;
+  result.start = GetHostTime(device, record->time);
+
+  switch (record->type) {
+    case ompt_callback_target: {
+      const ompt_record_target_t& target = record->record.target;
+      result.type = OMP_DEVICE_RECORD_TARGET;
+      result.device_num = target.device_num;
+      result.target_id = target.target_id;
+      if (target.endpoint == ompt_scope_begin) {
+        target_map[target.target_id] = {
+            reinterpret_cast<uint64_t>(target.codeptr_ra), result.start};
+        return false;
+      }
+      auto it = target_map.find(target.target_id);
+      if (it == target_map.end()) {
+        return false;
+      }
+      result.codeptr = it->second.codeptr;
+      result.end = result.start;
+      result.start = it->second.start;
+      target_map.erase(it);
+      break;
+    }
+    case ompt_callback_target_data_op: {
+      const ompt_record_target_data_op_t& data_op =
+        record->record.target_data_op;
+      switch (data_op.optype) {
+        case ompt_target_data_transfer_to_device:
+        case ompt_target_data_transfer_to_device_async:
+          result.type = OMP_DEVICE_RECORD_TRANSFER_TO_DEVICE;
+          result.device_num = data_op.dest_device_num;
+          break;
+        case ompt_target_data_transfer_from_device:
+        case ompt_target_data_transfer_from_device_async:
+          result.type = OMP_DEVICE_RECORD_TRANSFER_FROM_DEVICE;
+          result.device_num = data_op.src_device_num;
+          break;
+        case ompt_target_data_alloc:
+        case ompt_target_data_alloc_async:
+          result.type = OMP_DEVICE_RECORD_ALLOC;
+          result.device_num = data_op.dest_device_num;
+          break;
+        case ompt_target_data_delete:
+        case ompt_target_data_delete_async:
+          result.type = OMP_DEVICE_RECORD_DELETE;
+          result.device_num = data_op.src_device_num;
+          break;
+        default:
+          return false;
+      }
+      result.codeptr = reinterpret_cast<uint64_t>(data_op.codeptr_ra);
+      result.end = GetHostTime(device, data_op.end_time);
+      result.bytes = data_op.bytes;
+      break;
+    }
+    case ompt_callback_target_submit:
+      result.type = OMP_DEVICE_RECORD_KERNEL;
+      result.end = GetHostTime(device, record->record.target_kernel.end_time);
+      break;
+    default:
+      return false;
+  }
+
+  if (result.end < result.start) {
+    result.end = result.start;
+  }
+  return true;
+}
+
+// Runtime returns buffers from its own threads, so the records are
+// decoded off the application threads and passed to the collector at once
+void BufferComplete(
+    int device_num, ompt_buffer_t* buffer, size_t bytes,
+    ompt_buffer_cursor_t begin, int buffer_owned) {
+  std::vector<OmpDeviceRecord> record_list;
+
+  if (bytes > 0) {
+    const std::lock_guard<std::mutex> lock(device_lock);
+    auto it = device_map.find(device_num);
+    if (it != device_map.end()) {
+      const OmpDevice& device = it->second;
+      PTI_ASSERT(device.get_record_ompt != nullptr);
+      PTI_ASSERT(device.advance_buffer_cursor != nullptr);
+
+      ompt_buffer_cursor_t cursor = begin;
+      while (true) {
+        const ompt_record_ompt_t* record =
+          device.get_record_ompt(buffer, cursor);
+        if (record == nullptr) {
+          break;
+        }
+
+        OmpDeviceRecord result;
+        if (GetRecord(device, record, result)) {
+          if (result.type == OMP_DEVICE_RECORD_KERNEL) {
+            result.device_num = device_num;
+          }
+          record_list.push_back(result);
+        }
+
+        ompt_buffer_cursor_t next = 0;
+        if (!device.advance_buffer_cursor(
+                device.device, buffer, bytes, cursor, &next)) {
+          break;
+        }
+        cursor = next;
+      }
+    }
+  }
+
+  OmpDeviceCollector::OnRecords(record_list);
+
+  if (buffer_owned && buffer != nullptr) {
+    const std::lock_guard<std::mutex> lock(buffer_lock);
+    free_buffer_list.push_back(static_cast<char*>(buffer));
+  }
+}
+
+template <typename T>
+T Lookup(ompt_function_lookup_t lookup, const char* name) {
+  PTI_ASSERT(lookup != nullptr);
+  return reinterpret_cast<T>(lookup(name));
+}
+
+void DeviceInitialize(
+    int device_num, const char* type, ompt_device_t* device,
+    ompt_function_lookup_t lookup, const char* documentation) {
+  if (!OmpDeviceCollector::IsEnabled() || device == nullptr) {
+    return;
+  }
+
+  ompt_set_trace_ompt_t set_trace_ompt =
+    Lookup<ompt_set_trace_ompt_t>(lookup, "ompt_set_trace_ompt");
+  ompt_start_trace_t start_trace =
+    Lookup<ompt_start_trace_t>(lookup, "ompt_start_trace");
+  ompt_get_device_time_t get_device_time =
+    Lookup<ompt_get_device_time_t>(lookup, "ompt_get_device_time");
+
+  OmpDevice info{};
+  info.device = device;
+  info.flush_trace = Lookup<ompt_flush_trace_t>(lookup, "ompt_flush_trace");
+  info.stop_trace = Lookup<ompt_stop_trace_t>(lookup, "ompt_stop_trace");
+  info.get_record_ompt =
+    Lookup<ompt_get_record_ompt_t>(lookup, "ompt_get_record_ompt");
+  info.advance_buffer_cursor = Lookup<ompt_advance_buffer_cursor_t>(
+      lookup, "ompt_advance_buffer_cursor");
+  info.translate_time =
+    Lookup<ompt_translate_time_t>(lookup, "ompt_translate_time");
+
+  if (set_trace_ompt == nullptr || start_trace == nullptr ||
+      get_device_time == nullptr || info.get_record_ompt == nullptr ||
+      info.advance_buffer_cursor == nullptr) {
+    std::cerr << "[WARNING] OpenMP device tracing is not supported for " <<
+      "device " << device_num << " (" << (type ? type : "unknown") << ")" <<
+      std::endl;
+    return;
+  }
+
+  set_trace_ompt(device, 1, ompt_callback_target);
+  set_trace_ompt(device, 1, ompt_callback_target_data_op);
+  set_trace_ompt(device, 1, ompt_callback_target_submit);
+
+  info.device_base = get_device_time(device);
+  info.host_base = OmpDeviceCollector::GetTimestamp();
+  {
+    const std::lock_guard<std::mutex> lock(device_lock);
+    device_map[device_num] = info;
+  }
+
+  if (!start_trace(device, BufferRequest, BufferComplete)) {
+    std::cerr << "[WARNING] Unable to start OpenMP device tracing for " <<
+      "device " << device_num << std::endl;
+    const std::lock_guard<std::mutex> lock(device_lock);
+    device_map.erase(device_num);
+  }
+}
+
+// Device is still valid here, so its trace is stopped and the buffers
+// are returned before it goes away
+void DeviceFinalize(int device_num) {
+  OmpDevice device{};
+  {
+    const std::lock_guard<std::mutex> lock(device_lock);
+    auto it = device_map.find(device_num);
+    if (it == device_map.end()) {
+      return;
+    }
+    device = it->second;
+  }
+
+  if (device.stop_trace != nullptr) {
+    device.stop_trace(device.device);
+  }
+
+  const std::lock_guard<std::mutex> lock(device_lock);
+  device_map.erase(device_num);
+}
+
+int Initialize(
+    ompt_function_lookup_t lookup, int initial_device_num,
+    ompt_data_t* tool_data) {
+  ompt_set_callback_t set_callback =
+    Lookup<ompt_set_callback_t>(lookup, "ompt_set_callback");
+  if (set_callback == nullptr) {
+    std::cerr << "[WARNING] Unable to enable OpenMP device tracing" <<
+      std::endl;
+    return 0;
+  }
+
+  ompt_set_result_t result = set_callback(
+      ompt_callback_device_initialize,
+      reinterpret_cast<ompt_callback_t>(DeviceInitialize));
+  if (result != ompt_set_always) {
+    std::cerr << "[WARNING] Unable to enable OpenMP device tracing" <<
+      std::endl;
+    return 0;
+  }
+  set_callback(
+      ompt_callback_device_finalize,
+      reinterpret_cast<ompt_callback_t>(DeviceFinalize));
+
+  return 1;
+}
+
+void Finalize(ompt_data_t* tool_data) {
+  std::vector<int> device_list;
+  {
+    const std::lock_guard<std::mutex> lock(device_lock);
+    for (auto& value : device_map) {
+      device_list.push_back(value.first);
+    }
+  }
+  for (int device_num : device_list) {
+    DeviceFinalize(device_num);
+  }
+}
+
+} // namespace
+
+bool OmpDeviceCollector::IsSupported() {
+  return true;
+}
+
+void OmpDeviceCollector::FlushTrace() {
+  std::vector<OmpDevice> device_list;
+  {
+    const std::lock_guard<std::mutex> lock(device_lock);
+    for (auto& value : device_map) {
+      device_list.push_back(value.second);
+    }
+  }
+  for (const OmpDevice& device : device_list) {
+    if (device.flush_trace != nullptr) {
+      device.flush_trace(device.device);
+    }
+  }
+}
+
+extern "C" {
+
+// OpenMP runtime takes the tool from the first ompt_start_tool it finds
+// in the process. It may start before the collector is created (e.g. with
+// lazy initialization), so the request is taken from the environment, and
+// devices initialized while there is no collector are not traced
+__attribute__((visibility("default")))
+ompt_start_tool_result_t* ompt_start_tool(
+    unsigned int omp_version, const char* runtime_version) {
+  if (!OmpDeviceCollector::IsEnabled() &&
+      utils::GetEnv(OMP_DEVICE_TRACING_ENV) != "1") {
+    return nullptr;
+  }
+  static ompt_start_tool_result_t result = {Initialize, Finalize, {0}};
+  return &result;
+}
+
+} // extern "C"
+
+#else
+
+bool OmpDeviceCollector::IsSupported() {
+  return false;
+}
+
+void OmpDeviceCollector::FlushTrace() {}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,415 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_OMP_DEVICE_COLLECTOR_H_
+#define PTI_TOOLS_UTILS_OMP_DEVICE_COLLECTOR_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "correlator.h"
+#include "pti_assert.h"
+#include "string_table.h"
+
+// Size of a trace buffer handed out to OpenMP runtime, in bytes
+#define OMP_DEVICE_BUFFER_SIZE (1 << 20)
+
+// Makes the tool library register as OMPT tool at runtime start
+#define OMP_DEVICE_TRACING_ENV "PTI_OMP_DEVICE_TRACING"
+
+enum OmpDeviceRecordType {
+  OMP_DEVICE_RECORD_TARGET = 0,
+  OMP_DEVICE_RECORD_KERNEL = 1,
+  OMP_DEVICE_RECORD_TRANSFER_TO_DEVICE = 2,
+  OMP_DEVICE_RECORD_TRANSFER_FROM_DEVICE = 3,
+  OMP_DEVICE_RECORD_ALLOC = 4,
+  OMP_DEVICE_RECORD_DELETE = 5
+};
+
+// Device activity in the time base of the correlator. Kernels don't carry
+// the code pointer in OMPT, it's taken from the target region of the same
+// target_id
+struct OmpDeviceRecord {
+  OmpDeviceRecordType type;
+  int device_num;
+  uint64_t target_id;
+  uint64_t codeptr;
+  uint64_t start;
+  uint64_t end;
+  uint64_t bytes;
+};
+
+struct OmpKernelInfo {
+  uint64_t total_time;
+  uint64_t call_count;
+};
+
+struct OmpRegionInfo {
+  uint64_t total_time;
+  uint64_t min_time;
+  uint64_t max_time;
+  uint64_t call_count;
+  uint64_t bytes_transferred;
+  std::map<std::string, OmpKernelInfo> kernel_info_map;
+};
+
+// Region is identified by its code pointer and record type
+using OmpRegionKey = std::pair<uint64_t, OmpDeviceRecordType>;
+using OmpRegionInfoMap = std::map<OmpRegionKey, OmpRegionInfo>;
+
+typedef void (*OnOmpDeviceRecordCallback)(
+    void* data, const OmpDeviceRecord& record);
+
+// Device tracing side of OMPT: the tool library exports ompt_start_tool
+// (see omp_device_collector.cc), enables ompt_set_trace_ompt records for
+// each offload device and hands tool-owned buffers to the runtime. The
+// runtime fills them on the device side and returns them filled, so no
+// host callbacks are made per target region, and records are decoded a
+// buffer at a time. Level Zero kernels are attributed to the OpenMP kernel
+// record that covers their middle point
+class OmpDeviceCollector {
+ public: // User Interface
+  static OmpDeviceCollector* Create(
+      Correlator* correlator,
+      OnOmpDeviceRecordCallback callback = nullptr,
+      void* callback_data = nullptr) {
+    PTI_ASSERT(correlator != nullptr);
+    if (!IsSupported()) {
+      std::cerr << "[WARNING] OpenMP device tracing is not supported" <<
+        std::endl;
+      return nullptr;
+    }
+
+    OmpDeviceCollector* collector = new OmpDeviceCollector(
+        correlator, callback, callback_data);
+    PTI_ASSERT(collector != nullptr);
+
+    OmpDeviceCollector* previous = nullptr;
+    bool registered = GetInstance().compare_exchange_strong(
+        previous, collector, std::memory_order_acq_rel);
+    PTI_ASSERT(registered);
+    return collector;
+  }
+
+  ~OmpDeviceCollector() {
+    DisableTracing();
+  }
+
+  // Buffers that are still held by the runtime are flushed first, so
+  // the records of the devices that are alive are not lost
+  void DisableTracing() {
+    if (GetInstance().load(std::memory_order_acquire) != this) {
+      return;
+    }
+    FlushTrace();
+    OmpDeviceCollector* collector = this;
+    GetInstance().compare_exchange_strong(
+        collector, nullptr, std::memory_order_acq_rel);
+  }
+
+  // Called for each finished Level Zero kernel with host timestamps
+  void AddKernel(const std::string& name, uint64_t started, uint64_t ended) {
+    PTI_ASSERT(started <= ended);
+    uint32_t name_id = StringTable::Add(name);
+    const std::lock_guard<std::mutex> lock(lock_);
+    kernel_list_.push_back({name_id, started, ended});
+  }
+
+  uint64_t GetRecordCount() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return record_list_.size();
+  }
+
+  OmpRegionInfoMap GetRegionInfoMap() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+
+    std::map<uint64_t, uint64_t> codeptr_map; // target_id -> codeptr
+    for (const OmpDeviceRecord& record : record_list_) {
+      if (record.type == OMP_DEVICE_RECORD_TARGET && record.codeptr != 0) {
+        codeptr_map[record.target_id] = record.codeptr;
+      }
+    }
+
+    OmpRegionInfoMap region_info_map;
+    std::vector<std::pair<const OmpDeviceRecord*, OmpRegionInfo*> >
+      kernel_record_list;
+    for (const OmpDeviceRecord& record : record_list_) {
+      uint64_t codeptr = record.codeptr;
+      if (codeptr == 0) {
+        auto it = codeptr_map.find(record.target_id);
+        if (it != codeptr_map.end()) {
+          codeptr = it->second;
+        }
+      }
+
+      OmpRegionInfo& info = region_info_map[{codeptr, record.type}];
+      uint64_t time = record.end - record.start;
+      if (info.call_count == 0) {
+        info.min_time = time;
+        info.max_time = time;
+      } else {
+        info.min_time = (std::min)(info.min_time, time);
+        info.max_time = (std::max)(info.max_time, time);
+      }
+      info.total_time += time;
+      info.bytes_transferred += record.bytes;
+      ++info.call_count;
+
+      if (record.type == OMP_DEVICE_RECORD_KERNEL) {
+        kernel_record_list.emplace_back(&record, &info);
+      }
+    }
+
+    std::sort(kernel_record_list.begin(), kernel_record_list.end(),
+              [](const std::pair<const OmpDeviceRecord*, OmpRegionInfo*>& l,
+                 const std::pair<const OmpDeviceRecord*, OmpRegionInfo*>& r) {
+                return l.first->start < r.first->start;
+              });
+
+    for (const Kernel& kernel : kernel_list_) {
+      uint64_t middle = kernel.start + (kernel.end - kernel.start) / 2;
+      auto it = std::upper_bound(
+          kernel_record_list.begin(), kernel_record_list.end(), middle,
+          [](uint64_t time,
+             const std::pair<const OmpDeviceRecord*, OmpRegionInfo*>& r) {
+            return time < r.first->start;
+          });
+      if (it == kernel_record_list.begin()) {
+        continue;
+      }
+      --it;
+      if (it->first->end < middle) {
+        continue;
+      }
+      OmpKernelInfo& kernel_info =
+        it->second->kernel_info_map[StringTable::Get(kernel.name_id)];
+      kernel_info.total_time += kernel.end - kernel.start;
+      ++kernel_info.call_count;
+    }
+
+    return region_info_map;
+  }
+
+  void PrintRegionsTable() const {
+    OmpRegionInfoMap region_info_map = GetRegionInfoMap();
+    if (region_info_map.empty()) {
+      return;
+    }
+
+    std::vector< std::pair<OmpRegionKey, const OmpRegionInfo*> >
+      sorted_list;
+    for (auto& value : region_info_map) {
+      sorted_list.emplace_back(value.first, &value.second);
+    }
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              [](const std::pair<OmpRegionKey, const OmpRegionInfo*>& left,
+                 const std::pair<OmpRegionKey, const OmpRegionInfo*>& right) {
+                if (left.second->total_time != right.second->total_time) {
+                  return left.second->total_time > right.second->total_time;
+                }
+                return left.first < right.first;
+              });
+
+    std::stringstream stream;
+    stream << std::setw(kRegionLength) << "Region" << "," <<
+      std::setw(kTypeLength) << "Type" << "," <<
+      std::setw(kCallsLength) << "Calls" << "," <<
+      std::setw(kTransferredLength) << "Transferred (bytes)" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kTimeLength) << "Average (ns)" << "," <<
+      std::setw(kTimeLength) << "Min (ns)" << "," <<
+      std::setw(kTimeLength) << "Max (ns)" << std::endl;
+
+    for (auto& value : sorted_list) {
+      const OmpRegionInfo& info = *(value.second);
+      PTI_ASSERT(info.call_count > 0);
+      stream << std::setw(kRegionLength) << GetRegionName(value.first) <<
+        "," << std::setw(kTypeLength) << GetTypeString(value.first.second) <<
+        "," << std::setw(kCallsLength) << info.call_count << "," <<
+        std::setw(kTransferredLength) << info.bytes_transferred << "," <<
+        std::setw(kTimeLength) << info.total_time << "," <<
+        std::setw(kTimeLength) << info.total_time / info.call_count << "," <<
+        std::setw(kTimeLength) << info.min_time << "," <<
+        std::setw(kTimeLength) << info.max_time << std::endl;
+    }
+
+    for (auto& value : sorted_list) {
+      const OmpRegionInfo& info = *(value.second);
+      if (info.kernel_info_map.empty()) {
+        continue;
+      }
+      stream << std::endl;
+      stream << "== Kernels of OpenMP Region " <<
+        GetRegionName(value.first) << ": ==" << std::endl;
+      stream << std::endl;
+      PrintKernelsTable(stream, info.kernel_info_map);
+    }
+
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  static const char* GetTypeString(OmpDeviceRecordType type) {
+    switch (type) {
+      case OMP_DEVICE_RECORD_TARGET:
+        return "Target";
+      case OMP_DEVICE_RECORD_KERNEL:
+        return "Kernel";
+      case OMP_DEVICE_RECORD_TRANSFER_TO_DEVICE:
+        return "TransferToDevice";
+      case OMP_DEVICE_RECORD_TRANSFER_FROM_DEVICE:
+        return "TransferFromDevice";
+      case OMP_DEVICE_RECORD_ALLOC:
+        return "Alloc";
+      case OMP_DEVICE_RECORD_DELETE:
+        return "Delete";
+      default:
+        PTI_ASSERT(0);
+        break;
+    }
+    return "";
+  }
+
+  OmpDeviceCollector(const OmpDeviceCollector& copy) = delete;
+  OmpDeviceCollector& operator=(const OmpDeviceCollector& copy) = delete;
+
+ public: // OMPT Interface
+  static bool IsEnabled() {
+    return GetInstance().load(std::memory_order_acquire) != nullptr;
+  }
+
+  static uint64_t GetTimestamp() {
+    OmpDeviceCollector* collector =
+      GetInstance().load(std::memory_order_acquire);
+    if (collector == nullptr) {
+      return 0;
+    }
+    PTI_ASSERT(collector->correlator_ != nullptr);
+    return collector->correlator_->GetTimestamp();
+  }
+
+  // Takes the records decoded from one completed buffer
+  static void OnRecords(const std::vector<OmpDeviceRecord>& record_list) {
+    OmpDeviceCollector* collector =
+      GetInstance().load(std::memory_order_acquire);
+    if (collector != nullptr && !record_list.empty()) {
+      collector->AddRecords(record_list);
+    }
+  }
+
+ private: // Implementation Details
+  struct Kernel {
+    uint32_t name_id;
+    uint64_t start;
+    uint64_t end;
+  };
+
+  OmpDeviceCollector(
+      Correlator* correlator,
+      OnOmpDeviceRecordCallback callback,
+      void* callback_data)
+      : correlator_(correlator),
+        callback_(callback),
+        callback_data_(callback_data) {}
+
+  static std::atomic<OmpDeviceCollector*>& GetInstance() {
+    static std::atomic<OmpDeviceCollector*> instance{nullptr};
+    return instance;
+  }
+
+  // Both are defined in omp_device_collector.cc, the latter makes the
+  // runtime return all the buffers it holds for the devices alive
+  static bool IsSupported();
+  static void FlushTrace();
+
+  void AddRecords(const std::vector<OmpDeviceRecord>& record_list) {
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      record_list_.insert(
+          record_list_.end(), record_list.begin(), record_list.end());
+    }
+
+    if (callback_ != nullptr) {
+      for (const OmpDeviceRecord& record : record_list) {
+        callback_(callback_data_, record);
+      }
+    }
+  }
+
+  static std::string GetRegionName(const OmpRegionKey& key) {
+    if (key.first == 0) {
+      return "<unknown>";
+    }
+    std::stringstream name;
+    name << "0x" << std::hex << key.first;
+    return name.str();
+  }
+
+  static void PrintKernelsTable(
+      std::stringstream& stream,
+      const std::map<std::string, OmpKernelInfo>& kernel_info_map) {
+    std::vector< std::pair<std::string, OmpKernelInfo> > sorted_list(
+        kernel_info_map.begin(), kernel_info_map.end());
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              [](const std::pair<std::string, OmpKernelInfo>& left,
+                 const std::pair<std::string, OmpKernelInfo>& right) {
+                if (left.second.total_time != right.second.total_time) {
+                  return left.second.total_time > right.second.total_time;
+                }
+                return left.first < right.first;
+              });
+
+    size_t max_name_length = kKernelLength;
+    for (auto& value : sorted_list) {
+      if (value.first.size() > max_name_length) {
+        max_name_length = value.first.size();
+      }
+    }
+
+    stream << std::setw(max_name_length) << "Kernel" << "," <<
+      std::setw(kCallsLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kTimeLength) << "Average (ns)" << std::endl;
+
+    for (auto& value : sorted_list) {
+      uint64_t duration = value.second.total_time;
+      uint64_t call_count = value.second.call_count;
+      stream << std::setw(max_name_length) << value.first << "," <<
+        std::setw(kCallsLength) << call_count << "," <<
+        std::setw(kTimeLength) << duration << "," <<
+        std::setw(kTimeLength) << duration / call_count << std::endl;
+    }
+  }
+
+ private: // Data
+  Correlator* correlator_ = nullptr;
+
+  OnOmpDeviceRecordCallback callback_ = nullptr;
+  void* callback_data_ = nullptr;
+
+  std::vector<OmpDeviceRecord> record_list_;
+  std::vector<Kernel> kernel_list_;
+  mutable std::mutex lock_;
+
+  static const uint32_t kRegionLength = 20;
+  static const uint32_t kTypeLength = 20;
+  static const uint32_t kKernelLength = 10;
+  static const uint32_t kCallsLength = 12;
+  static const uint32_t kTransferredLength = 20;
+  static const uint32_t kTimeLength = 20;
+};
+
+#endif // PTI_TOOLS_UTILS_OMP_DEVICE_COLLECTOR_H_
\ No newline at end of file
@@ -0,0 +1,340 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_OVERHEAD_H_
+#define PTI_TOOLS_UTILS_OVERHEAD_H_
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "pti_assert.h"
+#include "utils.h"
+
+// "1" collects the tool overhead, "subtract" also takes the overhead of
+// the tool callbacks out of host API timings
+#define OVERHEAD_ENV "PTI_OVERHEAD"
+#define OVERHEAD_CALIBRATION_TIME 5 // ms
+
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+#define OVERHEAD_TSC
+#endif
+
+enum OverheadSource {
+  OVERHEAD_ZE_API = 0,
+  OVERHEAD_ZE_KERNEL,
+  OVERHEAD_CL_KERNEL,
+  OVERHEAD_METRIC,
+  OVERHEAD_LOGGER,
+  OVERHEAD_SOURCE_COUNT
+};
+
+enum OverheadKind {
+  OVERHEAD_CALLBACK = 0,   // Tool code run inside application API calls
+  OVERHEAD_LOCK_WAIT,      // Blocked on a contended tool lock
+  OVERHEAD_EVENT_CREATE,   // Events and pools made by the tool
+  OVERHEAD_TIMESTAMP_READ, // Device timestamps and metrics read back
+  OVERHEAD_BINARY_READ,    // Module binaries read back
+  OVERHEAD_IO,             // Log and trace output, with bytes
+  OVERHEAD_KIND_COUNT
+};
+
+// Process-wide self-profiling of the tool: each source and kind keeps call
+// count, time in TSC ticks (steady clock where there is no TSC) and bytes
+// in relaxed atomic counters, so the cost of a disabled probe is a single
+// branch. Ticks are converted into ns at report time with the rate
+// calibrated against the steady clock on first use
+class Overhead {
+ public: // Interface
+  static bool IsEnabled() {
+    return GetMode() != kModeDisabled;
+  }
+
+  static bool IsSubtractEnabled() {
+    return GetMode() == kModeSubtract;
+  }
+
+  static uint64_t GetTicks() {
+#if defined(OVERHEAD_TSC)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  static uint64_t GetTime(uint64_t ticks) {
+    return static_cast<uint64_t>(ticks * GetNsPerTick());
+  }
+
+  static void Add(OverheadSource source, OverheadKind kind,
+                  uint64_t ticks, uint64_t bytes = 0) {
+    PTI_ASSERT(source < OVERHEAD_SOURCE_COUNT);
+    PTI_ASSERT(kind < OVERHEAD_KIND_COUNT);
+    Counter& counter = GetCounter(source, kind);
+    counter.count.fetch_add(1, std::memory_order_relaxed);
+    counter.ticks.fetch_add(ticks, std::memory_order_relaxed);
+    if (kind != OVERHEAD_CALLBACK && GetCallbackDepth() == 0) {
+      counter.outside_ticks.fetch_add(ticks, std::memory_order_relaxed);
+    }
+    if (bytes > 0) {
+      counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  }
+
+  // Callback ticks of the calling thread since the last reset, so that
+  // the API collector takes the cost of all the tool callbacks out of
+  // the call time
+  static void ResetCallTicks() {
+    GetCallTicks() = 0;
+  }
+
+  static uint64_t TakeCallTime() {
+    uint64_t ticks = GetCallTicks();
+    GetCallTicks() = 0;
+    return GetTime(ticks);
+  }
+
+  static void AddCallTicks(uint64_t ticks) {
+    GetCallTicks() += ticks;
+  }
+
+  // Number of callback scopes entered by the calling thread
+  static uint32_t& GetCallbackDepth() {
+    thread_local uint32_t depth = 0;
+    return depth;
+  }
+
+  // Time the tool spent on itself so far, in ns. Work done inside
+  // callbacks is a part of callback time, and lock wait is not busy time
+  static uint64_t GetTotalTime() {
+    uint64_t total_time = 0;
+    for (uint32_t i = 0; i < OVERHEAD_SOURCE_COUNT; ++i) {
+      for (uint32_t j = 0; j < OVERHEAD_KIND_COUNT; ++j) {
+        const Counter& counter = GetCounter(
+            static_cast<OverheadSource>(i), static_cast<OverheadKind>(j));
+        if (j == OVERHEAD_CALLBACK) {
+          total_time += GetTime(
+              counter.ticks.load(std::memory_order_relaxed));
+        } else if (j != OVERHEAD_LOCK_WAIT) {
+          total_time += GetTime(
+              counter.outside_ticks.load(std::memory_order_relaxed));
+        }
+      }
+    }
+    return total_time;
+  }
+
+  static void PrintTable(std::ostream& stream) {
+    stream << std::setw(kSourceLength) << "Source" << "," <<
+      std::setw(kKindLength) << "Kind" << "," <<
+      std::setw(kCountLength) << "Count" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kTimeLength) << "Average (ns)" << "," <<
+      std::setw(kBytesLength) << "Bytes" << std::endl;
+
+    for (uint32_t i = 0; i < OVERHEAD_SOURCE_COUNT; ++i) {
+      for (uint32_t j = 0; j < OVERHEAD_KIND_COUNT; ++j) {
+        const Counter& counter = GetCounter(
+            static_cast<OverheadSource>(i), static_cast<OverheadKind>(j));
+        uint64_t count = counter.count.load(std::memory_order_relaxed);
+        if (count == 0) {
+          continue;
+        }
+        uint64_t time =
+          GetTime(counter.ticks.load(std::memory_order_relaxed));
+        stream << std::setw(kSourceLength) << GetSourceName(i) << "," <<
+          std::setw(kKindLength) << GetKindName(j) << "," <<
+          std::setw(kCountLength) << count << "," <<
+          std::setw(kTimeLength) << time << "," <<
+          std::setw(kTimeLength) << time / count << "," <<
+          std::setw(kBytesLength) <<
+            counter.bytes.load(std::memory_order_relaxed) << std::endl;
+      }
+    }
+
+    stream << std::endl;
+    stream << "Total tool time: " << GetTotalTime() << " ns";
+    if (IsSubtractEnabled()) {
+      stream << " (callback time is subtracted from host API timings)";
+    }
+    stream << std::endl;
+  }
+
+ private: // Implementation
+  struct Counter {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> outside_ticks{0}; // Not inside a callback
+    std::atomic<uint64_t> bytes{0};
+  };
+
+  static const int kModeDisabled = 0;
+  static const int kModeEnabled = 1;
+  static const int kModeSubtract = 2;
+
+  static int GetMode() {
+    static const int mode = ReadMode();
+    return mode;
+  }
+
+  static int ReadMode() {
+    std::string value = utils::GetEnv(OVERHEAD_ENV);
+    if (value == "subtract") {
+      return kModeSubtract;
+    }
+    return (value == "1") ? kModeEnabled : kModeDisabled;
+  }
+
+  static Counter& GetCounter(OverheadSource source, OverheadKind kind) {
+    static Counter counter_list[OVERHEAD_SOURCE_COUNT][OVERHEAD_KIND_COUNT];
+    return counter_list[source][kind];
+  }
+
+  static const char* GetSourceName(uint32_t source) {
+    static const char* name_list[OVERHEAD_SOURCE_COUNT] = {
+        "L0 API", "L0 Kernel", "CL Kernel", "Metric", "Logger"};
+    return name_list[source];
+  }
+
+  static const char* GetKindName(uint32_t kind) {
+    static const char* name_list[OVERHEAD_KIND_COUNT] = {
+        "Callback", "Lock Wait", "Event Create", "Readback",
+        "Binary Read", "I/O"};
+    return name_list[kind];
+  }
+
+  static uint64_t& GetCallTicks() {
+    thread_local uint64_t ticks = 0;
+    return ticks;
+  }
+
+  static double GetNsPerTick() {
+    static const double ns_per_tick = Calibrate();
+    return ns_per_tick;
+  }
+
+  static double Calibrate() {
+#if defined(OVERHEAD_TSC)
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    uint64_t start_ticks = GetTicks();
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(OVERHEAD_CALIBRATION_TIME));
+    uint64_t end_ticks = GetTicks();
+    std::chrono::duration<double, std::nano> time =
+      std::chrono::steady_clock::now() - start;
+    if (end_ticks > start_ticks) {
+      return time.count() / (end_ticks - start_ticks);
+    }
+#endif
+    return 1.0;
+  }
+
+ private: // Data
+  static const uint32_t kSourceLength = 10;
+  static const uint32_t kKindLength = 12;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kBytesLength = 20;
+};
+
+// Times the enclosing block if the overhead is collected. Nested callback
+// scopes of the same thread (e.g. a tool callback calling a traced API)
+// are not counted again
+class OverheadScope {
+ public: // Interface
+  OverheadScope(OverheadSource source, OverheadKind kind, uint64_t bytes = 0)
+      : source_(source), kind_(kind), bytes_(bytes) {
+    if (!Overhead::IsEnabled()) {
+      return;
+    }
+    if (kind_ == OVERHEAD_CALLBACK) {
+      uint32_t& depth = Overhead::GetCallbackDepth();
+      ++depth;
+      if (depth > 1) {
+        return;
+      }
+    }
+    active_ = true;
+    start_ = Overhead::GetTicks();
+  }
+
+  ~OverheadScope() {
+    if (active_) {
+      uint64_t ticks = Overhead::GetTicks() - start_;
+      Overhead::Add(source_, kind_, ticks, bytes_);
+      if (kind_ == OVERHEAD_CALLBACK) {
+        Overhead::AddCallTicks(ticks);
+      }
+    }
+    if (kind_ == OVERHEAD_CALLBACK && Overhead::IsEnabled()) {
+      --Overhead::GetCallbackDepth();
+    }
+  }
+
+  // True for the scope that is not nested into another callback scope
+  bool IsOutermost() const {
+    return active_;
+  }
+
+  // For the blocks that learn the number of bytes at the end
+  void SetBytes(uint64_t bytes) {
+    bytes_ = bytes;
+  }
+
+  OverheadScope(const OverheadScope& copy) = delete;
+  OverheadScope& operator=(const OverheadScope& copy) = delete;
+
+ private: // Data
+  OverheadSource source_;
+  OverheadKind kind_;
+  uint64_t bytes_ = 0;
+  uint64_t start_ = 0;
+  bool active_ = false;
+};
+
+// Lock guard that times the wait for a contended lock, the uncontended
+// path is a single try_lock
+class OverheadLockGuard {
+ public: // Interface
+  OverheadLockGuard(std::mutex& lock, OverheadSource source) : lock_(lock) {
+    if (!Overhead::IsEnabled()) {
+      lock_.lock();
+      return;
+    }
+    if (lock_.try_lock()) {
+      return;
+    }
+    uint64_t start = Overhead::GetTicks();
+    lock_.lock();
+    Overhead::Add(source, OVERHEAD_LOCK_WAIT, Overhead::GetTicks() - start);
+  }
+
+  ~OverheadLockGuard() {
+    lock_.unlock();
+  }
+
+  OverheadLockGuard(const OverheadLockGuard& copy) = delete;
+  OverheadLockGuard& operator=(const OverheadLockGuard& copy) = delete;
+
+ private: // Data
+  std::mutex& lock_;
+};
+
+#endif // PTI_TOOLS_UTILS_OVERHEAD_H_
@@ -0,0 +1,156 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_OVERHEAD_GOVERNOR_H_
+#define PTI_TOOLS_UTILS_OVERHEAD_GOVERNOR_H_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "overhead.h"
+#include "pti_assert.h"
+
+#define OVERHEAD_GOVERNOR_INTERVAL 200 // ms
+#define OVERHEAD_GOVERNOR_HOLD 5 // Calm windows before detail is restored
+
+// Level 0 is the full detail, overhead is the share of the last window
+typedef void (*OnOverheadLevelCallback)(
+    void* data, uint32_t level, double overhead);
+
+// Keeps the tool within the overhead budget, given as the share of wall
+// time the tool spends on itself (see Overhead). The time is taken per
+// window, so a window over the budget steps the detail level down at once,
+// while the level goes back up only after several windows in a row under
+// half the budget, to keep it from bouncing. The owner tells what each
+// level switches off and is notified on the governor thread
+class OverheadGovernor {
+ public: // Interface
+  static OverheadGovernor* Create(
+      double budget, uint32_t max_level,
+      OnOverheadLevelCallback callback, void* callback_data,
+      uint32_t interval = OVERHEAD_GOVERNOR_INTERVAL) {
+    PTI_ASSERT(budget > 0.0);
+    PTI_ASSERT(max_level > 0);
+    PTI_ASSERT(callback != nullptr);
+    PTI_ASSERT(interval > 0);
+    if (!Overhead::IsEnabled()) {
+      std::cerr << "[WARNING] Overhead budget is ignored since " <<
+        "the tool overhead is not collected" << std::endl;
+      return nullptr;
+    }
+
+    OverheadGovernor* governor = new OverheadGovernor(
+        budget, max_level, callback, callback_data, interval);
+    PTI_ASSERT(governor != nullptr);
+    return governor;
+  }
+
+  ~OverheadGovernor() {
+    Stop();
+  }
+
+  void Stop() {
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      stop_ = true;
+    }
+    wakeup_.notify_one();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  OverheadGovernor(const OverheadGovernor& copy) = delete;
+  OverheadGovernor& operator=(const OverheadGovernor& copy) = delete;
+
+ private: // Implementation
+  OverheadGovernor(
+      double budget, uint32_t max_level,
+      OnOverheadLevelCallback callback, void* callback_data,
+      uint32_t interval)
+      : budget_(budget), max_level_(max_level),
+        callback_(callback), callback_data_(callback_data),
+        interval_(interval) {
+    thread_ = std::thread(&OverheadGovernor::Run, this);
+  }
+
+  void Run() {
+    uint64_t last_tool_time = Overhead::GetTotalTime();
+    std::chrono::steady_clock::time_point last_time =
+      std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!stop_) {
+      wakeup_.wait_for(
+          lock, std::chrono::milliseconds(interval_),
+          [this] { return stop_; });
+      if (stop_) {
+        break;
+      }
+      lock.unlock();
+
+      uint64_t tool_time = Overhead::GetTotalTime();
+      std::chrono::steady_clock::time_point time =
+        std::chrono::steady_clock::now();
+      std::chrono::duration<double, std::nano> window = time - last_time;
+      double overhead = (window.count() > 0) ?
+        (tool_time - last_tool_time) / window.count() : 0.0;
+      last_tool_time = tool_time;
+      last_time = time;
+
+      Update(overhead);
+      lock.lock();
+    }
+  }
+
+  void Update(double overhead) {
+    if (overhead > budget_) {
+      calm_count_ = 0;
+      if (level_ < max_level_) {
+        SetLevel(level_ + 1, overhead);
+      }
+    } else if (overhead < budget_ / 2 && level_ > 0) {
+      ++calm_count_;
+      if (calm_count_ >= OVERHEAD_GOVERNOR_HOLD) {
+        calm_count_ = 0;
+        SetLevel(level_ - 1, overhead);
+      }
+    } else {
+      calm_count_ = 0;
+    }
+  }
+
+  void SetLevel(uint32_t level, double overhead) {
+    PTI_ASSERT(level <= max_level_);
+    level_ = level;
+    callback_(callback_data_, level_, overhead);
+  }
+
+ private: // Data
+  double budget_ = 0.0;
+  uint32_t max_level_ = 0;
+
+  OnOverheadLevelCallback callback_ = nullptr;
+  void* callback_data_ = nullptr;
+
+  uint32_t interval_ = OVERHEAD_GOVERNOR_INTERVAL;
+
+  // Governor thread only
+  uint32_t level_ = 0;
+  uint32_t calm_count_ = 0;
+
+  std::thread thread_;
+  std::mutex lock_;
+  std::condition_variable wakeup_;
+  bool stop_ = false;
+};
+
+#endif // PTI_TOOLS_UTILS_OVERHEAD_GOVERNOR_H_
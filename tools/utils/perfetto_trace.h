@@ -0,0 +1,305 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_PERFETTO_TRACE_H_
+#define PTI_TOOLS_UTILS_PERFETTO_TRACE_H_
+
+#include <stdint.h>
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pti_assert.h"
+#include "string_table.h"
+
+// Writes Perfetto protobuf trace (perfetto.protos.Trace) using TrackEvent
+// packets: one track per device queue and one per host thread, event names
+// are interned on a single packet sequence. Only the fields used here are
+// encoded, so no protobuf library is required.
+class PerfettoTraceWriter {
+ public: // Interface
+  PerfettoTraceWriter(
+      const std::string& filename, uint32_t pid,
+      const std::string& process_name)
+      : pid_(pid), process_uuid_(GetTrackUuid(0)) {
+    PTI_ASSERT(!filename.empty());
+    file_.open(filename, std::ios::out | std::ios::binary);
+    PTI_ASSERT(file_.is_open());
+    buffer_.reserve(kBufferSize);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+
+    std::string process;
+    AddUint(process, kProcessDescriptorPid, pid_);
+    AddString(process, kProcessDescriptorName, process_name);
+
+    std::string track;
+    AddUint(track, kTrackDescriptorUuid, process_uuid_);
+    AddString(track, kTrackDescriptorProcess, process);
+
+    packet_.clear();
+    AddUint(packet_, kPacketSequenceId, kSequenceId);
+    AddUint(packet_, kPacketSequenceFlags, kSequenceStateCleared);
+    AddString(packet_, kPacketTrackDescriptor, track);
+    AddPacket();
+  }
+
+  ~PerfettoTraceWriter() {
+    const std::lock_guard<std::mutex> lock(lock_);
+    Flush();
+    file_.close();
+  }
+
+  void WriteDeviceEvent(
+      void* queue, const std::string& id, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    uint64_t track_uuid = GetQueueTrack(reinterpret_cast<uint64_t>(queue));
+    AddSlice(track_uuid, id, name, started, ended);
+  }
+
+  void WriteDeviceEvent(
+      void* queue, uint64_t id, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    WriteDeviceEvent(queue, std::to_string(id), name, started, ended);
+  }
+
+  void WriteHostEvent(
+      uint32_t tid, const std::string& id, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    uint64_t track_uuid = GetThreadTrack(tid);
+    AddSlice(track_uuid, id, name, started, ended);
+  }
+
+  void WriteHostEvent(
+      uint32_t tid, uint64_t id, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    WriteHostEvent(tid, std::to_string(id), name, started, ended);
+  }
+
+  PerfettoTraceWriter(const PerfettoTraceWriter& copy) = delete;
+  PerfettoTraceWriter& operator=(const PerfettoTraceWriter& copy) = delete;
+
+ private: // Implementation
+  // Track UUIDs have to be unique across all processes of one trace
+  uint64_t GetTrackUuid(uint32_t index) const {
+    return (static_cast<uint64_t>(pid_) << 32) | index;
+  }
+
+  uint64_t GetQueueTrack(uint64_t queue) {
+    auto it = queue_track_map_.find(queue);
+    if (it != queue_track_map_.end()) {
+      return it->second;
+    }
+
+    uint64_t track_uuid = GetTrackUuid(++track_count_);
+    queue_track_map_[queue] = track_uuid;
+
+    std::stringstream name;
+    name << "Queue 0x" << std::hex << queue;
+
+    std::string track;
+    AddUint(track, kTrackDescriptorUuid, track_uuid);
+    AddString(track, kTrackDescriptorName, name.str());
+    AddUint(track, kTrackDescriptorParentUuid, process_uuid_);
+
+    packet_.clear();
+    AddUint(packet_, kPacketSequenceId, kSequenceId);
+    AddString(packet_, kPacketTrackDescriptor, track);
+    AddPacket();
+
+    return track_uuid;
+  }
+
+  uint64_t GetThreadTrack(uint32_t tid) {
+    auto it = thread_track_map_.find(tid);
+    if (it != thread_track_map_.end()) {
+      return it->second;
+    }
+
+    uint64_t track_uuid = GetTrackUuid(++track_count_);
+    thread_track_map_[tid] = track_uuid;
+
+    std::string thread;
+    AddUint(thread, kThreadDescriptorPid, pid_);
+    AddUint(thread, kThreadDescriptorTid, tid);
+
+    std::string track;
+    AddUint(track, kTrackDescriptorUuid, track_uuid);
+    AddString(track, kTrackDescriptorThread, thread);
+
+    packet_.clear();
+    AddUint(packet_, kPacketSequenceId, kSequenceId);
+    AddString(packet_, kPacketTrackDescriptor, track);
+    AddPacket();
+
+    return track_uuid;
+  }
+
+  // Event name IDs are StringTable IDs shifted by one: zero is not a valid
+  // interning ID in Perfetto
+  uint64_t GetNameIid(const std::string& name, std::string& interned_data) {
+    uint32_t id = StringTable::Add(name);
+    if (id >= interned_.size()) {
+      interned_.resize(id + 1, false);
+    }
+
+    uint64_t iid = static_cast<uint64_t>(id) + 1;
+    if (!interned_[id]) {
+      std::string event_name;
+      AddUint(event_name, kEventNameIid, iid);
+      AddString(event_name, kEventNameName, name);
+      AddString(interned_data, kInternedDataEventNames, event_name);
+      interned_[id] = true;
+    }
+
+    return iid;
+  }
+
+  void AddSlice(
+      uint64_t track_uuid, const std::string& id, const std::string& name,
+      uint64_t started, uint64_t ended) {
+    interned_data_.clear();
+    uint64_t name_iid = GetNameIid(name, interned_data_);
+
+    annotation_.clear();
+    AddString(annotation_, kDebugAnnotationName, "id");
+    AddString(annotation_, kDebugAnnotationStringValue, id);
+
+    event_.clear();
+    AddUint(event_, kTrackEventType, kTypeSliceBegin);
+    AddUint(event_, kTrackEventTrackUuid, track_uuid);
+    AddUint(event_, kTrackEventNameIid, name_iid);
+    AddString(event_, kTrackEventDebugAnnotations, annotation_);
+
+    packet_.clear();
+    AddUint(packet_, kPacketTimestamp, started);
+    AddUint(packet_, kPacketSequenceId, kSequenceId);
+    AddUint(packet_, kPacketSequenceFlags, kSequenceNeedsState);
+    if (!interned_data_.empty()) {
+      AddString(packet_, kPacketInternedData, interned_data_);
+    }
+    AddString(packet_, kPacketTrackEvent, event_);
+    AddPacket();
+
+    event_.clear();
+    AddUint(event_, kTrackEventType, kTypeSliceEnd);
+    AddUint(event_, kTrackEventTrackUuid, track_uuid);
+
+    packet_.clear();
+    AddUint(packet_, kPacketTimestamp, ended);
+    AddUint(packet_, kPacketSequenceId, kSequenceId);
+    AddString(packet_, kPacketTrackEvent, event_);
+    AddPacket();
+  }
+
+  static void AddVarint(std::string& output, uint64_t value) {
+    while (value >= 0x80) {
+      output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    output.push_back(static_cast<char>(value));
+  }
+
+  static void AddUint(std::string& output, uint32_t field, uint64_t value) {
+    AddVarint(output, (field << 3) | kWireTypeVarint);
+    AddVarint(output, value);
+  }
+
+  // Used for both strings and nested messages
+  static void AddString(
+      std::string& output, uint32_t field, const std::string& value) {
+    AddVarint(output, (field << 3) | kWireTypeLength);
+    AddVarint(output, value.size());
+    output.append(value);
+  }
+
+  void AddPacket() {
+    AddString(buffer_, kTracePacket, packet_);
+    if (buffer_.size() >= kBufferSize) {
+      Flush();
+    }
+  }
+
+  void Flush() {
+    if (!buffer_.empty()) {
+      file_.write(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+  }
+
+ private: // Data
+  static const size_t kBufferSize = 1024 * 1024;
+  static const uint32_t kSequenceId = 1;
+
+  static const uint32_t kWireTypeVarint = 0;
+  static const uint32_t kWireTypeLength = 2;
+
+  // Field numbers from perfetto/protos/perfetto/trace
+  static const uint32_t kTracePacket = 1;
+
+  static const uint32_t kPacketTimestamp = 8;
+  static const uint32_t kPacketSequenceId = 10;
+  static const uint32_t kPacketTrackEvent = 11;
+  static const uint32_t kPacketInternedData = 12;
+  static const uint32_t kPacketSequenceFlags = 13;
+  static const uint32_t kPacketTrackDescriptor = 60;
+
+  static const uint32_t kSequenceStateCleared = 1;
+  static const uint32_t kSequenceNeedsState = 2;
+
+  static const uint32_t kTrackEventDebugAnnotations = 4;
+  static const uint32_t kTrackEventType = 9;
+  static const uint32_t kTrackEventNameIid = 10;
+  static const uint32_t kTrackEventTrackUuid = 11;
+
+  static const uint32_t kTypeSliceBegin = 1;
+  static const uint32_t kTypeSliceEnd = 2;
+
+  static const uint32_t kDebugAnnotationStringValue = 6;
+  static const uint32_t kDebugAnnotationName = 10;
+
+  static const uint32_t kTrackDescriptorUuid = 1;
+  static const uint32_t kTrackDescriptorName = 2;
+  static const uint32_t kTrackDescriptorProcess = 3;
+  static const uint32_t kTrackDescriptorThread = 4;
+  static const uint32_t kTrackDescriptorParentUuid = 5;
+
+  static const uint32_t kProcessDescriptorPid = 1;
+  static const uint32_t kProcessDescriptorName = 6;
+
+  static const uint32_t kThreadDescriptorPid = 1;
+  static const uint32_t kThreadDescriptorTid = 2;
+
+  static const uint32_t kInternedDataEventNames = 2;
+
+  static const uint32_t kEventNameIid = 1;
+  static const uint32_t kEventNameName = 2;
+
+  uint32_t pid_ = 0;
+  uint64_t process_uuid_ = 0;
+  uint32_t track_count_ = 0;
+
+  std::mutex lock_;
+  std::ofstream file_;
+  std::string buffer_;
+
+  std::string packet_;
+  std::string event_;
+  std::string annotation_;
+  std::string interned_data_;
+
+  std::vector<bool> interned_;
+  std::unordered_map<uint64_t, uint64_t> queue_track_map_;
+  std::unordered_map<uint32_t, uint64_t> thread_track_map_;
+};
+
+#endif // PTI_TOOLS_UTILS_PERFETTO_TRACE_H_
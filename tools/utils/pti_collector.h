@@ -0,0 +1,78 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_PTI_COLLECTOR_H_
+#define PTI_TOOLS_UTILS_PTI_COLLECTOR_H_
+
+// Control of onetrace collection from the application itself, available
+// while the application runs under "onetrace --collector-api". The entry
+// points are exported by the tool library, so the application (or a
+// framework) takes them with dlsym(RTLD_DEFAULT, "ptiCollectorStart") and
+// the like and does nothing if they are not found. Functions may be called
+// from any thread, ranges are nested within a thread
+
+#include <stdint.h>
+
+#define PTI_COLLECTOR_API_VERSION 1
+#define PTI_COLLECTOR_NAME_SIZE 256
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum _pti_collector_result_t {
+  PTI_COLLECTOR_SUCCESS = 0,
+  PTI_COLLECTOR_ERROR_NOT_ENABLED = 1, // Tool is finalized or not set up
+  PTI_COLLECTOR_ERROR_INVALID_ARGUMENT = 2
+} pti_collector_result_t;
+
+// Aggregate of one kernel (or transfer) or one API function, times in ns
+typedef struct _pti_collector_stats_t {
+  char name[PTI_COLLECTOR_NAME_SIZE]; // Truncated, always null-terminated
+  uint64_t call_count;
+  uint64_t total_time;
+  uint64_t min_time;
+  uint64_t max_time;
+} pti_collector_stats_t;
+
+// Version of the interface the tool implements
+uint32_t ptiCollectorGetVersion(void);
+
+// Collection is off at start, nothing is traced outside of start/stop
+pti_collector_result_t ptiCollectorStart(void);
+pti_collector_result_t ptiCollectorStop(void);
+
+// Named range on the calling thread, reported in ITT Region Results
+// together with the kernels launched inside it
+pti_collector_result_t ptiCollectorPushRange(const char* name);
+pti_collector_result_t ptiCollectorPopRange(void);
+
+// Returns once the device work completed so far is taken into the stats
+pti_collector_result_t ptiCollectorFlush(void);
+
+// If stats_list is null, the number of entries is returned in count,
+// otherwise up to count entries are written and count is set to the
+// number of entries written
+pti_collector_result_t ptiCollectorGetKernelStats(
+    pti_collector_stats_t* stats_list, uint32_t* count);
+pti_collector_result_t ptiCollectorGetApiStats(
+    pti_collector_stats_t* stats_list, uint32_t* count);
+
+typedef uint32_t (*pti_collector_get_version_t)(void);
+typedef pti_collector_result_t (*pti_collector_start_t)(void);
+typedef pti_collector_result_t (*pti_collector_stop_t)(void);
+typedef pti_collector_result_t (*pti_collector_push_range_t)(
+    const char* name);
+typedef pti_collector_result_t (*pti_collector_pop_range_t)(void);
+typedef pti_collector_result_t (*pti_collector_flush_t)(void);
+typedef pti_collector_result_t (*pti_collector_get_stats_t)(
+    pti_collector_stats_t* stats_list, uint32_t* count);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // PTI_TOOLS_UTILS_PTI_COLLECTOR_H_
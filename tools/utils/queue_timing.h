@@ -0,0 +1,290 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_QUEUE_TIMING_H_
+#define PTI_TOOLS_UTILS_QUEUE_TIMING_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "latency_histogram.h"
+#include "pti_assert.h"
+
+#define QUEUE_TIMING_REORDER_WINDOW 1024
+
+// Busy time of an execution resource as the union of its command
+// intervals. Commands come roughly in completion order, so they are kept
+// in a small window ordered by start time and merged in that order once
+// the window is full. A command started before the commands merged
+// already still extends the busy time, but may hide a part of a gap
+class BusyTimeTracker {
+ public: // Interface
+  void Add(uint64_t start, uint64_t end) {
+    PTI_ASSERT(start <= end);
+    window_.emplace(start, end);
+    if (window_.size() > QUEUE_TIMING_REORDER_WINDOW) {
+      Merge(window_.top().first, window_.top().second);
+      window_.pop();
+    }
+  }
+
+  // Merges the commands left in the window
+  void Flush() {
+    while (!window_.empty()) {
+      Merge(window_.top().first, window_.top().second);
+      window_.pop();
+    }
+  }
+
+  bool IsEmpty() const {
+    return !started_ && window_.empty();
+  }
+
+  // All the getters expect the tracker to be flushed
+  uint64_t GetSpan() const {
+    PTI_ASSERT(window_.empty());
+    return started_ ? current_end_ - first_start_ : 0;
+  }
+
+  uint64_t GetBusyTime() const {
+    PTI_ASSERT(window_.empty());
+    return started_ ? busy_time_ + (current_end_ - current_start_) : 0;
+  }
+
+  uint64_t GetIdleTime() const {
+    PTI_ASSERT(window_.empty());
+    return idle_time_;
+  }
+
+  uint64_t GetGapCount() const {
+    PTI_ASSERT(window_.empty());
+    return gap_count_;
+  }
+
+  uint64_t GetMaxGap() const {
+    PTI_ASSERT(window_.empty());
+    return max_gap_;
+  }
+
+ private: // Implementation
+  void Merge(uint64_t start, uint64_t end) {
+    if (!started_) {
+      started_ = true;
+      first_start_ = current_start_ = start;
+      current_end_ = end;
+      return;
+    }
+
+    if (start <= current_end_) {
+      if (end > current_end_) {
+        current_end_ = end;
+      }
+      return;
+    }
+
+    uint64_t gap = start - current_end_;
+    busy_time_ += current_end_ - current_start_;
+    idle_time_ += gap;
+    ++gap_count_;
+    if (gap > max_gap_) {
+      max_gap_ = gap;
+    }
+    current_start_ = start;
+    current_end_ = end;
+  }
+
+ private: // Data
+  using Interval = std::pair<uint64_t, uint64_t>;
+  std::priority_queue<
+      Interval, std::vector<Interval>, std::greater<Interval> > window_;
+
+  bool started_ = false;
+  uint64_t first_start_ = 0;
+  uint64_t current_start_ = 0;
+  uint64_t current_end_ = 0;
+  uint64_t busy_time_ = 0;
+  uint64_t idle_time_ = 0;
+  uint64_t gap_count_ = 0;
+  uint64_t max_gap_ = 0;
+};
+
+struct QueueTimingInfo {
+  std::string engine;
+  uint64_t command_count = 0;
+  uint64_t total_latency = 0;
+  uint64_t min_latency = 0;
+  uint64_t max_latency = 0;
+  LatencyHistogram latency_histogram; // Submission to start
+  BusyTimeTracker busy_time;
+  BusyTimeTracker* engine_busy_time = nullptr; // Kept by the engine map
+};
+
+// Per-queue and per-engine breakdown of device activity: busy and idle
+// time of each queue, submission to start latency of its commands, and
+// overlap of the queues that share an engine. Engine is any label the
+// backend can give (e.g. device and queue group), commands of queues
+// with the same label are merged. Memory is fixed per queue, the class
+// is not thread-safe, commands are expected from a single thread
+class QueueTiming {
+ public: // Interface
+  void AddCommand(const void* queue, const std::string& engine,
+                  uint64_t submitted, uint64_t started, uint64_t ended) {
+    PTI_ASSERT(queue != nullptr);
+    PTI_ASSERT(started <= ended);
+    uint64_t latency = (started > submitted) ? started - submitted : 0;
+
+    QueueTimingInfo& info = queue_map_[queue];
+    if (info.command_count == 0) {
+      info.engine = engine;
+      info.engine_busy_time = &engine_map_[engine];
+      info.min_latency = latency;
+      info.max_latency = latency;
+    }
+    ++info.command_count;
+    info.total_latency += latency;
+    if (latency < info.min_latency) {
+      info.min_latency = latency;
+    }
+    if (latency > info.max_latency) {
+      info.max_latency = latency;
+    }
+    info.latency_histogram.Add(latency);
+    info.busy_time.Add(started, ended);
+
+    PTI_ASSERT(info.engine_busy_time != nullptr);
+    info.engine_busy_time->Add(started, ended);
+  }
+
+  bool IsEmpty() const {
+    return queue_map_.empty();
+  }
+
+  void PrintTables(std::ostream& stream) const {
+    if (queue_map_.empty()) {
+      return;
+    }
+
+    std::map<const void*, QueueTimingInfo> queue_map = queue_map_;
+    std::map<std::string, BusyTimeTracker> engine_map = engine_map_;
+
+    size_t max_engine_length = kEngineLength;
+    for (auto& value : queue_map) {
+      value.second.busy_time.Flush();
+      if (value.second.engine.size() > max_engine_length) {
+        max_engine_length = value.second.engine.size();
+      }
+    }
+    for (auto& value : engine_map) {
+      value.second.Flush();
+    }
+
+    stream << std::setw(kQueueLength) << "Queue" << "," <<
+      std::setw(max_engine_length) << "Engine" << "," <<
+      std::setw(kCountLength) << "Commands" << "," <<
+      std::setw(kTimeLength) << "Span (ns)" << "," <<
+      std::setw(kTimeLength) << "Busy (ns)" << "," <<
+      std::setw(kPercentLength) << "Busy (%)" << "," <<
+      std::setw(kTimeLength) << "Idle (ns)" << "," <<
+      std::setw(kCountLength) << "Gaps" << "," <<
+      std::setw(kTimeLength) << "Max Gap (ns)" << "," <<
+      std::setw(kTimeLength) << "Latency Avg (ns)" << "," <<
+      std::setw(kTimeLength) << "Latency P50 (ns)" << "," <<
+      std::setw(kTimeLength) << "Latency P99 (ns)" << "," <<
+      std::setw(kTimeLength) << "Latency Max (ns)" << std::endl;
+
+    for (auto& value : queue_map) {
+      const QueueTimingInfo& info = value.second;
+      const BusyTimeTracker& busy_time = info.busy_time;
+      uint64_t span = busy_time.GetSpan();
+      float busy_percent = (span > 0) ?
+        100.0f * busy_time.GetBusyTime() / span : 100.0f;
+
+      std::stringstream queue;
+      queue << value.first;
+      stream << std::setw(kQueueLength) << queue.str() << "," <<
+        std::setw(max_engine_length) << info.engine << "," <<
+        std::setw(kCountLength) << info.command_count << "," <<
+        std::setw(kTimeLength) << span << "," <<
+        std::setw(kTimeLength) << busy_time.GetBusyTime() << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << busy_percent << "," <<
+        std::setw(kTimeLength) << busy_time.GetIdleTime() << "," <<
+        std::setw(kCountLength) << busy_time.GetGapCount() << "," <<
+        std::setw(kTimeLength) << busy_time.GetMaxGap() << "," <<
+        std::setw(kTimeLength) <<
+          info.total_latency / info.command_count << "," <<
+        std::setw(kTimeLength) << info.latency_histogram.GetPercentile(
+            50.0, info.min_latency, info.max_latency) << "," <<
+        std::setw(kTimeLength) << info.latency_histogram.GetPercentile(
+            99.0, info.min_latency, info.max_latency) << "," <<
+        std::setw(kTimeLength) << info.max_latency << std::endl;
+    }
+
+    // Overlap is the time the queues of the engine ran concurrently,
+    // counted once for each extra queue
+    std::map<std::string, uint64_t> queue_count_map;
+    std::map<std::string, uint64_t> queue_busy_map;
+    for (auto& value : queue_map) {
+      const QueueTimingInfo& info = value.second;
+      ++queue_count_map[info.engine];
+      queue_busy_map[info.engine] += info.busy_time.GetBusyTime();
+    }
+
+    stream << std::endl;
+    stream << std::setw(max_engine_length) << "Engine" << "," <<
+      std::setw(kCountLength) << "Queues" << "," <<
+      std::setw(kTimeLength) << "Span (ns)" << "," <<
+      std::setw(kTimeLength) << "Busy (ns)" << "," <<
+      std::setw(kPercentLength) << "Busy (%)" << "," <<
+      std::setw(kTimeLength) << "Idle (ns)" << "," <<
+      std::setw(kCountLength) << "Gaps" << "," <<
+      std::setw(kTimeLength) << "Max Gap (ns)" << "," <<
+      std::setw(kTimeLength) << "Overlap (ns)" << std::endl;
+
+    for (auto& value : engine_map) {
+      const std::string& engine = value.first;
+      const BusyTimeTracker& busy_time = value.second;
+      uint64_t span = busy_time.GetSpan();
+      float busy_percent = (span > 0) ?
+        100.0f * busy_time.GetBusyTime() / span : 100.0f;
+      uint64_t queue_busy = queue_busy_map[engine];
+      uint64_t overlap = (queue_busy > busy_time.GetBusyTime()) ?
+        queue_busy - busy_time.GetBusyTime() : 0;
+
+      stream << std::setw(max_engine_length) << engine << "," <<
+        std::setw(kCountLength) << queue_count_map[engine] << "," <<
+        std::setw(kTimeLength) << span << "," <<
+        std::setw(kTimeLength) << busy_time.GetBusyTime() << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << busy_percent << "," <<
+        std::setw(kTimeLength) << busy_time.GetIdleTime() << "," <<
+        std::setw(kCountLength) << busy_time.GetGapCount() << "," <<
+        std::setw(kTimeLength) << busy_time.GetMaxGap() << "," <<
+        std::setw(kTimeLength) << overlap << std::endl;
+    }
+  }
+
+ private: // Data
+  std::map<const void*, QueueTimingInfo> queue_map_;
+  std::map<std::string, BusyTimeTracker> engine_map_;
+
+  static const uint32_t kQueueLength = 18;
+  static const uint32_t kEngineLength = 6;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kPercentLength = 10;
+};
+
+#endif // PTI_TOOLS_UTILS_QUEUE_TIMING_H_
@@ -0,0 +1,211 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_RECORD_POOL_H_
+#define PTI_TOOLS_UTILS_RECORD_POOL_H_
+
+#include <stddef.h>
+
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "pti_assert.h"
+
+#define RECORD_POOL_SLAB_SIZE  256 // Records allocated at once
+#define RECORD_POOL_BATCH_SIZE 64 // Records moved between thread and depot
+
+// Allocator of fixed-size tracer records (commands, calls, instances),
+// shared by all the collectors of the process. Each thread keeps its own
+// free list, so allocation and release take no lock and never reach the
+// global heap on the hot path. Records released by another thread (e.g.
+// the processing one) pile up on its list and go back to the shared depot
+// in batches, from where the submitting threads take them again. Memory
+// is carved from slabs and is only returned at process exit
+template <typename T>
+class RecordPool {
+ public: // Interface
+  template <typename... Args>
+  static T* Create(Args&&... args) {
+    Cache* cache = GetCache();
+    void* memory = (cache == nullptr) ?
+      GetDepot().TakeNode()->storage : cache->Pop();
+    return new (memory) T{std::forward<Args>(args)...};
+  }
+
+  static void Destroy(T* record) {
+    if (record == nullptr) {
+      return;
+    }
+    record->~T();
+    Cache* cache = GetCache();
+    if (cache == nullptr) {
+      GetDepot().PutNode(reinterpret_cast<Node*>(record));
+    } else {
+      cache->Push(reinterpret_cast<Node*>(record));
+    }
+  }
+
+  RecordPool() = delete;
+
+ private: // Implementation
+  union Node {
+    Node* next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  // Lists of free records of the same size, moved as a whole
+  struct Batch {
+    Node* head;
+    size_t count;
+  };
+
+  class Depot {
+   public:
+    // Returns false if there is no free batch, a new slab is made then
+    bool TakeBatch(Batch* batch) {
+      PTI_ASSERT(batch != nullptr);
+      const std::lock_guard<std::mutex> lock(lock_);
+      if (batch_list_.empty()) {
+        return false;
+      }
+      *batch = batch_list_.back();
+      batch_list_.pop_back();
+      return true;
+    }
+
+    void PutBatch(const Batch& batch) {
+      const std::lock_guard<std::mutex> lock(lock_);
+      batch_list_.push_back(batch);
+    }
+
+    // Single records go through the depot for the threads whose cache is
+    // destroyed already
+    Node* TakeNode() {
+      Batch batch{nullptr, 0};
+      if (!TakeBatch(&batch)) {
+        batch = Batch{AllocateSlab(), RECORD_POOL_SLAB_SIZE};
+      }
+      Node* node = batch.head;
+      PTI_ASSERT(node != nullptr && batch.count > 0);
+      batch.head = node->next;
+      --batch.count;
+      if (batch.count > 0) {
+        PutBatch(batch);
+      }
+      return node;
+    }
+
+    void PutNode(Node* node) {
+      PTI_ASSERT(node != nullptr);
+      node->next = nullptr;
+      PutBatch(Batch{node, 1});
+    }
+
+    Node* AllocateSlab() {
+      Node* slab = new Node[RECORD_POOL_SLAB_SIZE];
+      PTI_ASSERT(slab != nullptr);
+      for (size_t i = 0; i + 1 < RECORD_POOL_SLAB_SIZE; ++i) {
+        slab[i].next = &slab[i + 1];
+      }
+      slab[RECORD_POOL_SLAB_SIZE - 1].next = nullptr;
+      return slab;
+    }
+
+   private:
+    std::mutex lock_;
+    std::vector<Batch> batch_list_;
+  };
+
+  class Cache {
+   public:
+    // Records of an exiting thread are left to the other threads
+    ~Cache() {
+      while (count_ > 0) {
+        Release();
+      }
+      IsCacheDestroyed() = true;
+    }
+
+    void* Pop() {
+      if (head_ == nullptr) {
+        Refill();
+      }
+      PTI_ASSERT(head_ != nullptr);
+      Node* node = head_;
+      head_ = node->next;
+      --count_;
+      return node->storage;
+    }
+
+    void Push(Node* node) {
+      PTI_ASSERT(node != nullptr);
+      node->next = head_;
+      head_ = node;
+      ++count_;
+      if (count_ >= 2 * RECORD_POOL_BATCH_SIZE) {
+        Release();
+      }
+    }
+
+   private:
+    void Refill() {
+      Batch batch{nullptr, 0};
+      if (GetDepot().TakeBatch(&batch)) {
+        head_ = batch.head;
+        count_ = batch.count;
+      } else {
+        head_ = GetDepot().AllocateSlab();
+        count_ = RECORD_POOL_SLAB_SIZE;
+      }
+    }
+
+    // Hands over up to one batch from the head of the list
+    void Release() {
+      Batch batch{head_, 0};
+      Node* tail = nullptr;
+      while (head_ != nullptr && batch.count < RECORD_POOL_BATCH_SIZE) {
+        tail = head_;
+        head_ = head_->next;
+        ++batch.count;
+      }
+      PTI_ASSERT(tail != nullptr);
+      tail->next = nullptr;
+      count_ -= batch.count;
+      GetDepot().PutBatch(batch);
+    }
+
+    Node* head_ = nullptr;
+    size_t count_ = 0;
+  };
+
+  // Never destroyed, records may be released by the tracer destructors
+  // after the static objects are gone
+  static Depot& GetDepot() {
+    static Depot* depot = new Depot;
+    return *depot;
+  }
+
+  // Thread-local objects of the main thread are destroyed before the
+  // tools are unloaded at exit, the records released by the collector
+  // destructors then go to the depot directly
+  static Cache* GetCache() {
+    if (IsCacheDestroyed()) {
+      return nullptr;
+    }
+    thread_local Cache cache;
+    return &cache;
+  }
+
+  // Has no destructor, so stays valid until the thread is gone
+  static bool& IsCacheDestroyed() {
+    thread_local bool destroyed = false;
+    return destroyed;
+  }
+};
+
+#endif // PTI_TOOLS_UTILS_RECORD_POOL_H_
@@ -0,0 +1,324 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_SHM_TRACE_RING_H_
+#define PTI_TOOLS_UTILS_SHM_TRACE_RING_H_
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pti_assert.h"
+
+// Node trace protocol: each traced process owns a shared memory ring
+// named SHM_TRACE_PREFIX.<uid>.<pid> and streams binary trace bytes (see
+// binary_trace.h) into it. The node trace daemon publishes its PID in
+// SHM_TRACE_DAEMON.<uid>, drains the rings and writes them into a single
+// node trace file: NodeTraceHeader, then NodeTraceChunk entries each
+// followed by a piece of one process stream. Concatenated pieces of a
+// stream make a regular binary trace
+
+#define SHM_TRACE_PREFIX "pti_trace."
+#define SHM_TRACE_DAEMON "pti_trace_daemon."
+#define SHM_TRACE_RING_SIZE (64 * 1024 * 1024)
+#define SHM_TRACE_VERSION 1
+
+const char kShmTraceMagic[8] = {'P', 'T', 'I', 'S', 'H', 'M', 'R', 'B'};
+const char kNodeTraceMagic[8] = {'P', 'T', 'I', 'N', 'O', 'D', 'E', '\0'};
+
+struct NodeTraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+
+struct NodeTraceChunk {
+  uint32_t stream; // Stream index, assigned by the daemon per ring
+  uint32_t size;
+};
+
+static_assert(sizeof(NodeTraceHeader) == 16,
+              "Unexpected node trace header size");
+static_assert(sizeof(NodeTraceChunk) == 8,
+              "Unexpected node trace chunk size");
+
+struct ShmTraceRingHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t pid;
+  uint64_t capacity;
+  std::atomic<uint64_t> head; // Bytes written by the process
+  std::atomic<uint64_t> tail; // Bytes read by the daemon
+  std::atomic<uint64_t> dropped; // Bytes the process failed to write
+  std::atomic<uint32_t> closed;
+  std::atomic<uint32_t> ready; // Set once the header is complete
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "Shared memory ring needs lock-free atomics");
+
+// Single-producer single-consumer byte ring in shared memory, the
+// process side creates it, the daemon side opens it by name. Writes are
+// all-or-nothing, so the stream never has partial records
+class ShmTraceRing {
+ public: // User Interface
+  // Returns nullptr if the daemon does not run or the ring can't be made
+  static ShmTraceRing* Create(uint32_t pid, size_t capacity) {
+#if defined(_WIN32)
+    std::cerr << "[WARNING] Node trace is not supported on Windows" <<
+      std::endl;
+    return nullptr;
+#else
+    PTI_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+    if (GetDaemonPid() == 0) {
+      std::cerr << "[INFO] Node trace daemon is not running, " <<
+        "binary trace will be stored to file" << std::endl;
+      return nullptr;
+    }
+
+    std::string name = GetRingName(pid);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      std::cerr << "[WARNING] Unable to create shared memory " << name <<
+        std::endl;
+      return nullptr;
+    }
+
+    size_t size = kDataOffset + capacity;
+    if (ftruncate(fd, size) != 0) {
+      std::cerr << "[WARNING] Unable to allocate shared memory " << name <<
+        std::endl;
+      close(fd);
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      std::cerr << "[WARNING] Unable to map shared memory " << name <<
+        std::endl;
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+
+    ShmTraceRing* ring = new ShmTraceRing(name, data, size, true);
+    PTI_ASSERT(ring != nullptr);
+
+    ShmTraceRingHeader* header = ring->header_;
+    memcpy(header->magic, kShmTraceMagic, sizeof(header->magic));
+    header->version = SHM_TRACE_VERSION;
+    header->pid = pid;
+    header->capacity = capacity;
+    header->head.store(0, std::memory_order_relaxed);
+    header->tail.store(0, std::memory_order_relaxed);
+    header->dropped.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    header->ready.store(1, std::memory_order_release);
+    return ring;
+#endif
+  }
+
+  ~ShmTraceRing() {
+#if !defined(_WIN32)
+    if (owner_) {
+      header_->closed.store(1, std::memory_order_release);
+    }
+    munmap(header_, size_);
+#endif
+  }
+
+  const std::string& GetName() const {
+    return name_;
+  }
+
+  uint32_t GetPid() const {
+    return header_->pid;
+  }
+
+  // False if there is no space, the data is not written at all then
+  bool Write(const char* data, size_t size) {
+    PTI_ASSERT(owner_);
+    uint64_t capacity = header_->capacity;
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+    uint64_t tail = header_->tail.load(std::memory_order_acquire);
+    if (capacity - (head - tail) < size) {
+      return false;
+    }
+
+    CopyToRing(head & (capacity - 1), data, size);
+    header_->head.store(head + size, std::memory_order_release);
+    return true;
+  }
+
+  void AddDropped(uint64_t size) {
+    header_->dropped.fetch_add(size, std::memory_order_relaxed);
+  }
+
+ public: // Daemon Interface
+  // Returns nullptr if the ring is not complete yet
+  static ShmTraceRing* Open(const std::string& name) {
+#if defined(_WIN32)
+    return nullptr;
+#else
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+      return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        static_cast<size_t>(info.st_size) < kDataOffset) {
+      close(fd);
+      return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      return nullptr;
+    }
+
+    ShmTraceRingHeader* header = reinterpret_cast<ShmTraceRingHeader*>(data);
+    if (header->ready.load(std::memory_order_acquire) == 0 ||
+        memcmp(header->magic, kShmTraceMagic, sizeof(header->magic)) != 0 ||
+        header->version != SHM_TRACE_VERSION ||
+        kDataOffset + header->capacity != size) {
+      munmap(data, size);
+      return nullptr;
+    }
+
+    ShmTraceRing* ring = new ShmTraceRing(name, data, size, false);
+    PTI_ASSERT(ring != nullptr);
+    return ring;
+#endif
+  }
+
+  // Appends all the available bytes, returns their count
+  size_t Read(std::vector<char>* data) {
+    PTI_ASSERT(!owner_);
+    PTI_ASSERT(data != nullptr);
+    uint64_t capacity = header_->capacity;
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+    size_t size = static_cast<size_t>(head - tail);
+    if (size == 0) {
+      return 0;
+    }
+
+    size_t offset = data->size();
+    data->resize(offset + size);
+    CopyFromRing(data->data() + offset, tail & (capacity - 1), size);
+    header_->tail.store(head, std::memory_order_release);
+    return size;
+  }
+
+  bool IsClosed() const {
+    return header_->closed.load(std::memory_order_acquire) != 0;
+  }
+
+  uint64_t GetDropped() const {
+    return header_->dropped.load(std::memory_order_relaxed);
+  }
+
+  void Unlink() {
+#if !defined(_WIN32)
+    shm_unlink(name_.c_str());
+#endif
+  }
+
+  static std::string GetRingName(uint32_t pid) {
+    return "/" + std::string(SHM_TRACE_PREFIX) + GetUid() + "." +
+      std::to_string(pid);
+  }
+
+  static std::string GetDaemonName() {
+    return "/" + std::string(SHM_TRACE_DAEMON) + GetUid();
+  }
+
+  // Returns 0 if the daemon does not run
+  static uint32_t GetDaemonPid() {
+#if defined(_WIN32)
+    return 0;
+#else
+    std::string name = GetDaemonName();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0600);
+    if (fd < 0) {
+      return 0;
+    }
+
+    uint32_t pid = 0;
+    ssize_t size = read(fd, &pid, sizeof(pid));
+    close(fd);
+    if (size != sizeof(pid) || pid == 0 || kill(pid, 0) != 0) {
+      return 0;
+    }
+    return pid;
+#endif
+  }
+
+  ShmTraceRing(const ShmTraceRing& copy) = delete;
+  ShmTraceRing& operator=(const ShmTraceRing& copy) = delete;
+
+ private: // Implementation
+  ShmTraceRing(const std::string& name, void* data, size_t size, bool owner)
+      : name_(name), size_(size), owner_(owner),
+        header_(reinterpret_cast<ShmTraceRingHeader*>(data)),
+        data_(reinterpret_cast<char*>(data) + kDataOffset) {}
+
+  static std::string GetUid() {
+#if defined(_WIN32)
+    return "0";
+#else
+    return std::to_string(getuid());
+#endif
+  }
+
+  // Both copies wrap at the ring end
+  void CopyToRing(uint64_t position, const char* data, size_t size) {
+    size_t first = GetFirstPart(position, size);
+    memcpy(data_ + position, data, first);
+    memcpy(data_, data + first, size - first);
+  }
+
+  void CopyFromRing(char* data, uint64_t position, size_t size) const {
+    size_t first = GetFirstPart(position, size);
+    memcpy(data, data_ + position, first);
+    memcpy(data + first, data_, size - first);
+  }
+
+  size_t GetFirstPart(uint64_t position, size_t size) const {
+    PTI_ASSERT(position < header_->capacity);
+    uint64_t first = header_->capacity - position;
+    return (first < size) ? static_cast<size_t>(first) : size;
+  }
+
+ private: // Data
+  static const size_t kDataOffset = 4096;
+
+  std::string name_;
+  size_t size_ = 0;
+  bool owner_ = false;
+  ShmTraceRingHeader* header_ = nullptr;
+  char* data_ = nullptr;
+};
+
+#endif // PTI_TOOLS_UTILS_SHM_TRACE_RING_H_
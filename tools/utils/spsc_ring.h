@@ -0,0 +1,169 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_SPSC_RING_H_
+#define PTI_TOOLS_UTILS_SPSC_RING_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "pti_assert.h"
+
+#define SPSC_RING_LINE_SIZE 64
+
+// Fixed-size lock-free queue for exactly one producer and one consumer
+// thread. Capacity is rounded up to the power of two
+template <typename T>
+class SpscRing {
+ public: // Interface
+  explicit SpscRing(size_t capacity) {
+    PTI_ASSERT(capacity > 0);
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    buffer_.resize(size);
+    mask_ = size - 1;
+  }
+
+  // Producer side, returns false if the ring is full
+  bool Push(const T& value) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ > mask_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ > mask_) {
+        return false;
+      }
+    }
+    buffer_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side, returns false if the ring is empty
+  bool Pop(T* value) {
+    PTI_ASSERT(value != nullptr);
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) {
+        return false;
+      }
+    }
+    *value = buffer_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t GetCapacity() const {
+    return buffer_.size();
+  }
+
+  SpscRing(const SpscRing& copy) = delete;
+  SpscRing& operator=(const SpscRing& copy) = delete;
+
+ private: // Data
+  std::vector<T> buffer_;
+  size_t mask_ = 0;
+
+  // Each side keeps a cached copy of the other side's index, so that
+  // shared cache lines are touched only when the cached value is stale
+  alignas(SPSC_RING_LINE_SIZE) std::atomic<size_t> head_{0};
+  size_t tail_cache_ = 0;
+  alignas(SPSC_RING_LINE_SIZE) std::atomic<size_t> tail_{0};
+  size_t head_cache_ = 0;
+};
+
+// Set of rings with one ring per producer thread and a single consumer.
+// A thread registers its ring on the first push, later pushes from the
+// same thread go to that ring without any locking
+template <typename T>
+class SpscRingGroup {
+ public: // Interface
+  explicit SpscRingGroup(size_t ring_capacity)
+      : ring_capacity_(ring_capacity),
+        group_id_(GetNextGroupId()) {
+    PTI_ASSERT(ring_capacity_ > 0);
+  }
+
+  // Returns false if the ring of the calling thread is full
+  bool Push(const T& value) {
+    return GetLocalRing()->Push(value);
+  }
+
+  // Consumer side, calls f for each record taken from the rings. Records
+  // of one producer are passed in the order they were pushed
+  template <typename F>
+  size_t Drain(F f) {
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      if (consumer_ring_list_.size() < ring_list_.size()) {
+        for (size_t i = consumer_ring_list_.size();
+             i < ring_list_.size(); ++i) {
+          consumer_ring_list_.push_back(ring_list_[i].get());
+        }
+      }
+    }
+
+    size_t count = 0;
+    T value;
+    for (SpscRing<T>* ring : consumer_ring_list_) {
+      while (ring->Pop(&value)) {
+        f(value);
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  SpscRingGroup(const SpscRingGroup& copy) = delete;
+  SpscRingGroup& operator=(const SpscRingGroup& copy) = delete;
+
+ private: // Implementation
+  struct LocalRing {
+    uint64_t group_id = 0;
+    SpscRing<T>* ring = nullptr;
+  };
+
+  static uint64_t GetNextGroupId() {
+    static std::atomic<uint64_t> group_id{1};
+    return group_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Rings are never removed while the group is alive, so a ring of
+  // a finished thread is simply drained by the consumer
+  SpscRing<T>* GetLocalRing() {
+    thread_local std::vector<LocalRing> local_ring_list;
+    for (const LocalRing& local_ring : local_ring_list) {
+      if (local_ring.group_id == group_id_) {
+        return local_ring.ring;
+      }
+    }
+
+    SpscRing<T>* ring = new SpscRing<T>(ring_capacity_);
+    PTI_ASSERT(ring != nullptr);
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      ring_list_.emplace_back(ring);
+    }
+    local_ring_list.push_back({group_id_, ring});
+    return ring;
+  }
+
+ private: // Data
+  size_t ring_capacity_ = 0;
+  uint64_t group_id_ = 0;
+
+  std::mutex lock_;
+  std::vector<std::unique_ptr<SpscRing<T> > > ring_list_;
+  std::vector<SpscRing<T>*> consumer_ring_list_;
+};
+
+#endif // PTI_TOOLS_UTILS_SPSC_RING_H_
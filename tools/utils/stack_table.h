@@ -0,0 +1,286 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_STACK_TABLE_H_
+#define PTI_TOOLS_UTILS_STACK_TABLE_H_
+
+#if !defined(_WIN32)
+#include <execinfo.h>
+#endif
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "callsite_cache.h"
+#include "pti_assert.h"
+#include "string_table.h"
+
+#define STACK_TABLE_MAX_DEPTH 64 // Frames captured per stack
+#define STACK_TABLE_ENTRY_COUNT 32 // Rows of the kernel stacks table
+
+struct StackRecord {
+  uint32_t offset; // First frame in the frame pool
+  uint32_t count;
+  uint32_t next; // Next stack with the same hash, zero for none
+};
+
+struct StackKernelInfo {
+  uint64_t call_count = 0;
+  uint64_t total_time = 0;
+  uint64_t min_time = 0;
+  uint64_t max_time = 0;
+};
+
+// Kernel name id and stack id
+using StackKernelKey = std::pair<uint32_t, uint32_t>;
+using StackKernelInfoMap = std::map<StackKernelKey, StackKernelInfo>;
+
+// Host call stacks of the runtime calls that launch kernels. Stacks are
+// captured as raw return addresses (up to STACK_TABLE_MAX_DEPTH frames)
+// and deduplicated by hash, so that each distinct call path is kept once
+// and is referred to by a small stack id. Frames are resolved to names
+// only when the table is printed, the tool and runtime frames are left
+// out there (see CallsiteCache). Thread-safe
+class StackTable {
+ public: // Interface
+  // Stack of the calling thread, zero if not known
+  uint32_t Capture() {
+#if !defined(_WIN32)
+    void* frame_list[STACK_TABLE_MAX_DEPTH];
+    int count = backtrace(frame_list, STACK_TABLE_MAX_DEPTH);
+    if (count <= 1) {
+      return 0;
+    }
+
+    // The first frame is the capture itself
+    void* const* frame_begin = frame_list + 1;
+    uint32_t frame_count = static_cast<uint32_t>(count - 1);
+    uint64_t hash = GetHash(frame_begin, frame_count);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    ++capture_count_;
+
+    uint32_t head_id = 0;
+    auto it = hash_map_.find(hash);
+    if (it != hash_map_.end()) {
+      head_id = it->second;
+    }
+
+    for (uint32_t stack_id = head_id; stack_id != 0;) {
+      const StackRecord& record = stack_list_[stack_id - 1];
+      if (record.count == frame_count &&
+          std::equal(frame_begin, frame_begin + frame_count,
+                     frame_pool_.begin() + record.offset)) {
+        return stack_id;
+      }
+      stack_id = record.next;
+    }
+
+    StackRecord record{
+        static_cast<uint32_t>(frame_pool_.size()), frame_count, head_id};
+    frame_pool_.insert(
+        frame_pool_.end(), frame_begin, frame_begin + frame_count);
+    stack_list_.push_back(record);
+
+    uint32_t stack_id = static_cast<uint32_t>(stack_list_.size());
+    hash_map_[hash] = stack_id;
+    return stack_id;
+#else
+    return 0;
+#endif
+  }
+
+  void AddTime(uint32_t stack_id, uint32_t name_id, uint64_t time) {
+    const std::lock_guard<std::mutex> lock(info_lock_);
+    StackKernelInfo& info = info_map_[std::make_pair(name_id, stack_id)];
+    if (info.call_count == 0 || time < info.min_time) {
+      info.min_time = time;
+    }
+    if (time > info.max_time) {
+      info.max_time = time;
+    }
+    info.total_time += time;
+    ++info.call_count;
+  }
+
+  bool IsEmpty() const {
+    const std::lock_guard<std::mutex> lock(info_lock_);
+    return info_map_.empty();
+  }
+
+  // Kernels by total time per launching stack, followed by the stacks
+  // of the listed rows
+  void PrintTables(std::ostream& stream) const {
+    StackKernelInfoMap info_map;
+    {
+      const std::lock_guard<std::mutex> lock(info_lock_);
+      info_map = info_map_;
+    }
+    if (info_map.empty()) {
+      return;
+    }
+
+    uint64_t total_time = 0;
+    std::vector<std::pair<uint64_t, StackKernelKey> > sorted_list;
+    for (auto& value : info_map) {
+      total_time += value.second.total_time;
+      sorted_list.emplace_back(value.second.total_time, value.first);
+    }
+
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              [](const std::pair<uint64_t, StackKernelKey>& left,
+                 const std::pair<uint64_t, StackKernelKey>& right) {
+                if (left.first != right.first) {
+                  return left.first > right.first;
+                }
+                return left.second < right.second;
+              });
+    if (sorted_list.size() > STACK_TABLE_ENTRY_COUNT) {
+      sorted_list.resize(STACK_TABLE_ENTRY_COUNT);
+    }
+
+    size_t max_name_length = kKernelLength;
+    for (auto& value : sorted_list) {
+      const std::string& name = StringTable::Get(value.second.first);
+      if (name.size() > max_name_length) {
+        max_name_length = name.size();
+      }
+    }
+
+    stream << std::setw(max_name_length) << "Kernel" << "," <<
+      std::setw(kStackLength) << "Stack" << "," <<
+      std::setw(kCallsLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kPercentLength) << "Time (%)" << "," <<
+      std::setw(kTimeLength) << "Average (ns)" << "," <<
+      std::setw(kTimeLength) << "Min (ns)" << "," <<
+      std::setw(kTimeLength) << "Max (ns)" << std::endl;
+
+    std::vector<uint32_t> stack_id_list;
+    for (auto& value : sorted_list) {
+      const StackKernelInfo& info = info_map.at(value.second);
+      uint32_t stack_id = value.second.second;
+      if (stack_id != 0) {
+        stack_id_list.push_back(stack_id);
+      }
+
+      float percent = (total_time == 0) ? 0.0f :
+        100.0f * info.total_time / total_time;
+      stream << std::setw(max_name_length) <<
+          StringTable::Get(value.second.first) << "," <<
+        std::setw(kStackLength) << GetLabel(stack_id) << "," <<
+        std::setw(kCallsLength) << info.call_count << "," <<
+        std::setw(kTimeLength) << info.total_time << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << percent << "," <<
+        std::setw(kTimeLength) << info.total_time / info.call_count << "," <<
+        std::setw(kTimeLength) << info.min_time << "," <<
+        std::setw(kTimeLength) << info.max_time << std::endl;
+    }
+
+    std::sort(stack_id_list.begin(), stack_id_list.end());
+    stack_id_list.erase(
+        std::unique(stack_id_list.begin(), stack_id_list.end()),
+        stack_id_list.end());
+    PrintStacks(stack_id_list, stream);
+  }
+
+  StackTable() = default;
+  StackTable(const StackTable& copy) = delete;
+  StackTable& operator=(const StackTable& copy) = delete;
+
+ private: // Implementation
+  static uint64_t GetHash(void* const* frame_list, uint32_t frame_count) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint32_t i = 0; i < frame_count; ++i) {
+      uint64_t address = reinterpret_cast<uintptr_t>(frame_list[i]);
+      for (int j = 0; j < 8; ++j) {
+        hash ^= (address >> (j * 8)) & 0xFF;
+        hash *= 0x100000001b3ULL;
+      }
+    }
+    return hash;
+  }
+
+  static std::string GetLabel(uint32_t stack_id) {
+    return (stack_id == 0) ? "<unknown>" : "#" + std::to_string(stack_id);
+  }
+
+  // Symbolization is done here only, once per frame
+  void PrintStacks(
+      const std::vector<uint32_t>& stack_id_list,
+      std::ostream& stream) const {
+    std::vector<std::vector<void*> > frame_table;
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      stream << std::endl;
+      stream << "Captured " << capture_count_ << " stacks, " <<
+        stack_list_.size() << " unique" << std::endl;
+
+      for (uint32_t stack_id : stack_id_list) {
+        PTI_ASSERT(stack_id > 0 && stack_id <= stack_list_.size());
+        const StackRecord& record = stack_list_[stack_id - 1];
+        frame_table.emplace_back(
+            frame_pool_.begin() + record.offset,
+            frame_pool_.begin() + record.offset + record.count);
+      }
+    }
+
+#if !defined(_WIN32)
+    const char* tool = CallsiteCache::GetToolModule();
+    std::unordered_map<void*, uint32_t> name_map;
+    for (size_t i = 0; i < stack_id_list.size(); ++i) {
+      stream << std::endl;
+      stream << "Stack " << GetLabel(stack_id_list[i]) << ":" << std::endl;
+
+      uint32_t depth = 0;
+      for (void* frame : frame_table[i]) {
+        auto it = name_map.find(frame);
+        if (it == name_map.end()) {
+          it = name_map.emplace(
+              frame, CallsiteCache::GetFrameName(frame, tool)).first;
+        }
+        if (it->second == CallsiteCache::kSkippedFrame) {
+          continue;
+        }
+        stream << "  " << depth << ": " <<
+          StringTable::Get(it->second) << std::endl;
+        ++depth;
+      }
+      if (depth == 0) {
+        stream << "  <unknown>" << std::endl;
+      }
+    }
+#endif
+  }
+
+ private: // Data
+  std::vector<StackRecord> stack_list_; // Stack id is index plus one
+  std::vector<void*> frame_pool_;
+  std::unordered_map<uint64_t, uint32_t> hash_map_; // Latest stack id
+  uint64_t capture_count_ = 0;
+  mutable std::mutex lock_;
+
+  StackKernelInfoMap info_map_;
+  mutable std::mutex info_lock_;
+
+  static const uint32_t kKernelLength = 10;
+  static const uint32_t kStackLength = 9;
+  static const uint32_t kCallsLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kPercentLength = 10;
+};
+
+#endif // PTI_TOOLS_UTILS_STACK_TABLE_H_
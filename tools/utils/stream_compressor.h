@@ -0,0 +1,186 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_STREAM_COMPRESSOR_H_
+#define PTI_TOOLS_UTILS_STREAM_COMPRESSOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pti_assert.h"
+#include "shared_library.h"
+
+#define STREAM_COMPRESSOR_ZSTD_LEVEL 3
+#define STREAM_COMPRESSOR_SKIPPABLE_MAGIC 0x184D2A5E
+#define STREAM_COMPRESSOR_SEEKABLE_MAGIC 0x8F92EAB1
+
+#if defined(_WIN32)
+#define STREAM_COMPRESSOR_ZSTD_LIB "libzstd.dll"
+#define STREAM_COMPRESSOR_LZ4_LIB "liblz4.dll"
+#else
+#define STREAM_COMPRESSOR_ZSTD_LIB "libzstd.so.1"
+#define STREAM_COMPRESSOR_LZ4_LIB "liblz4.so.1"
+#endif
+
+// Compresses output as a sequence of independent zstd or lz4 frames, the
+// library is loaded at runtime, so the tools have no build dependency on
+// it. The file is closed with a skippable frame in zstd seekable format
+// that lists the compressed and original size of every frame, so readers
+// can get to any part of a large trace without decoding what precedes it.
+// Standard zstd and lz4 tools skip the table and decode the whole file
+class StreamCompressor {
+ public: // Interface
+  static bool IsMethod(const std::string& method) {
+    return method == "zstd" || method == "lz4";
+  }
+
+  // Returns nullptr if the method is unknown or its library is not found
+  static StreamCompressor* Create(const std::string& method) {
+    if (!IsMethod(method)) {
+      std::cerr << "[WARNING] Unknown compression method " << method <<
+        std::endl;
+      return nullptr;
+    }
+
+    bool zstd = (method == "zstd");
+    const char* name =
+      zstd ? STREAM_COMPRESSOR_ZSTD_LIB : STREAM_COMPRESSOR_LZ4_LIB;
+    SharedLibrary* library = SharedLibrary::Create(name);
+    if (library == nullptr) {
+      std::cerr << "[WARNING] Unable to load " << name <<
+        ", output is not compressed" << std::endl;
+      return nullptr;
+    }
+
+    StreamCompressor* compressor = new StreamCompressor(library, zstd);
+    PTI_ASSERT(compressor != nullptr);
+    if (!compressor->IsLoaded()) {
+      std::cerr << "[WARNING] Unable to find " << method <<
+        " functions in " << name << ", output is not compressed" <<
+        std::endl;
+      delete compressor;
+      return nullptr;
+    }
+    return compressor;
+  }
+
+  ~StreamCompressor() {
+    delete library_;
+  }
+
+  const char* GetFileExt() const {
+    return zstd_ ? ".zst" : ".lz4";
+  }
+
+  // Data is appended to the output as one frame
+  void AddFrame(const char* data, size_t size, std::vector<char>* output) {
+    PTI_ASSERT(data != nullptr && size > 0);
+    PTI_ASSERT(output != nullptr);
+
+    size_t offset = output->size();
+    size_t bound = zstd_ ? zstd_bound_(size) : lz4_bound_(size, nullptr);
+    output->resize(offset + bound);
+
+    size_t compressed_size = 0;
+    if (zstd_) {
+      compressed_size = zstd_compress_(output->data() + offset, bound,
+                                       data, size,
+                                       STREAM_COMPRESSOR_ZSTD_LEVEL);
+      PTI_ASSERT(!zstd_is_error_(compressed_size));
+    } else {
+      compressed_size = lz4_compress_(output->data() + offset, bound,
+                                      data, size, nullptr);
+      PTI_ASSERT(!lz4_is_error_(compressed_size));
+    }
+    output->resize(offset + compressed_size);
+
+    PTI_ASSERT(compressed_size <= UINT32_MAX && size <= UINT32_MAX);
+    frame_list_.push_back({static_cast<uint32_t>(compressed_size),
+                           static_cast<uint32_t>(size)});
+  }
+
+  // Seek table of all the frames added so far, goes last in the file
+  void AddSeekTable(std::vector<char>* output) const {
+    PTI_ASSERT(output != nullptr);
+    uint32_t size = static_cast<uint32_t>(frame_list_.size() * 8 + 9);
+    AddValue(STREAM_COMPRESSOR_SKIPPABLE_MAGIC, output);
+    AddValue(size, output);
+    for (const Frame& frame : frame_list_) {
+      AddValue(frame.compressed_size, output);
+      AddValue(frame.size, output);
+    }
+    AddValue(static_cast<uint32_t>(frame_list_.size()), output);
+    output->push_back(0); // No checksums
+    AddValue(STREAM_COMPRESSOR_SEEKABLE_MAGIC, output);
+  }
+
+  StreamCompressor(const StreamCompressor& copy) = delete;
+  StreamCompressor& operator=(const StreamCompressor& copy) = delete;
+
+ private: // Implementation
+  using ZstdBound = size_t (*)(size_t);
+  using ZstdCompress = size_t (*)(void*, size_t, const void*, size_t, int);
+  using ZstdIsError = unsigned (*)(size_t);
+  // Frame preferences are never given, the defaults are taken
+  using Lz4Bound = size_t (*)(size_t, const void*);
+  using Lz4Compress =
+    size_t (*)(void*, size_t, const void*, size_t, const void*);
+  using Lz4IsError = unsigned (*)(size_t);
+
+  struct Frame {
+    uint32_t compressed_size;
+    uint32_t size;
+  };
+
+  StreamCompressor(SharedLibrary* library, bool zstd)
+      : library_(library), zstd_(zstd) {
+    PTI_ASSERT(library_ != nullptr);
+    if (zstd_) {
+      zstd_bound_ = library_->GetSym<ZstdBound>("ZSTD_compressBound");
+      zstd_compress_ = library_->GetSym<ZstdCompress>("ZSTD_compress");
+      zstd_is_error_ = library_->GetSym<ZstdIsError>("ZSTD_isError");
+    } else {
+      lz4_bound_ = library_->GetSym<Lz4Bound>("LZ4F_compressFrameBound");
+      lz4_compress_ = library_->GetSym<Lz4Compress>("LZ4F_compressFrame");
+      lz4_is_error_ = library_->GetSym<Lz4IsError>("LZ4F_isError");
+    }
+  }
+
+  bool IsLoaded() const {
+    if (zstd_) {
+      return zstd_bound_ != nullptr && zstd_compress_ != nullptr &&
+        zstd_is_error_ != nullptr;
+    }
+    return lz4_bound_ != nullptr && lz4_compress_ != nullptr &&
+      lz4_is_error_ != nullptr;
+  }
+
+  // Both formats are little-endian
+  static void AddValue(uint32_t value, std::vector<char>* output) {
+    for (uint32_t i = 0; i < sizeof(value); ++i) {
+      output->push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+  }
+
+ private: // Data
+  SharedLibrary* library_ = nullptr;
+  bool zstd_ = false;
+
+  ZstdBound zstd_bound_ = nullptr;
+  ZstdCompress zstd_compress_ = nullptr;
+  ZstdIsError zstd_is_error_ = nullptr;
+  Lz4Bound lz4_bound_ = nullptr;
+  Lz4Compress lz4_compress_ = nullptr;
+  Lz4IsError lz4_is_error_ = nullptr;
+
+  std::vector<Frame> frame_list_;
+};
+
+#endif // PTI_TOOLS_UTILS_STREAM_COMPRESSOR_H_
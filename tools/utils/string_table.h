@@ -0,0 +1,66 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_STRING_TABLE_H_
+#define PTI_TOOLS_UTILS_STRING_TABLE_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "pti_assert.h"
+
+// Process-wide intern table: every distinct string is stored once and
+// referred to by a 32-bit ID, which is resolved back to text at report time
+class StringTable {
+ public: // Interface
+  static uint32_t Add(const std::string& str) {
+    StringTable& table = GetInstance();
+    const std::lock_guard<std::mutex> lock(table.lock_);
+
+    auto it = table.id_map_.find(str);
+    if (it != table.id_map_.end()) {
+      return it->second;
+    }
+
+    PTI_ASSERT(table.string_list_.size() <
+               (std::numeric_limits<uint32_t>::max)());
+    uint32_t id = static_cast<uint32_t>(table.string_list_.size());
+    table.string_list_.push_back(str);
+    table.id_map_.emplace(str, id);
+    return id;
+  }
+
+  // Stored strings are never moved, so the reference stays valid
+  static const std::string& Get(uint32_t id) {
+    StringTable& table = GetInstance();
+    const std::lock_guard<std::mutex> lock(table.lock_);
+    PTI_ASSERT(id < table.string_list_.size());
+    return table.string_list_[id];
+  }
+
+  StringTable(const StringTable& copy) = delete;
+  StringTable& operator=(const StringTable& copy) = delete;
+
+ private: // Implementation
+  StringTable() {}
+
+  static StringTable& GetInstance() {
+    static StringTable table;
+    return table;
+  }
+
+ private: // Data
+  std::mutex lock_;
+  std::deque<std::string> string_list_;
+  std::unordered_map<std::string, uint32_t> id_map_;
+};
+
+#endif // PTI_TOOLS_UTILS_STRING_TABLE_H_
@@ -0,0 +1,170 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#include "sycl_collector.h"
+#include "utils.h"
+
+#if defined(PTI_XPTI)
+
+#include <dlfcn.h>
+#include <string.h>
+
+#include <xpti/xpti_trace_framework.h>
+
+// SYCL runtime loads the dispatcher named by the first variable if the
+// second one is set, and the dispatcher loads all the subscribers listed
+// in the third one and calls their xptiTraceInit for each stream
+#define XPTI_FRAMEWORK_DISPATCHER_ENV "XPTI_FRAMEWORK_DISPATCHER"
+#define XPTI_TRACE_ENABLE_ENV "XPTI_TRACE_ENABLE"
+#define XPTI_SUBSCRIBERS_ENV "XPTI_SUBSCRIBERS"
+
+#define XPTI_FRAMEWORK_LIBRARY "libxptifw.so"
+#define XPTI_SYCL_STREAM "sycl"
+
+namespace {
+
+// Framework entry points are taken from the dispatcher that is already
+// loaded into the process, so the tool has no link dependency on it
+typedef uint8_t (*XptiRegisterStream)(const char* stream_name);
+typedef xpti::result_t (*XptiRegisterCallback)(
+    uint8_t stream_id, uint16_t trace_type,
+    xpti::tracepoint_callback_api_t callback);
+typedef xpti::payload_t* (*XptiQueryPayload)(xpti::trace_event_data_t* event);
+
+XptiQueryPayload query_payload = nullptr;
+
+template <typename T>
+T Lookup(const char* name) {
+  return reinterpret_cast<T>(dlsym(RTLD_DEFAULT, name));
+}
+
+const char* GetName(xpti::trace_event_data_t* event) {
+  if (event == nullptr || query_payload == nullptr) {
+    return nullptr;
+  }
+  xpti::payload_t* payload = query_payload(event);
+  if (payload == nullptr || payload->name == nullptr ||
+      strlen(payload->name) == 0) {
+    return nullptr;
+  }
+  return payload->name;
+}
+
+// Unique ID names the command group, and instance tells its submissions
+// apart, so the pair identifies one run of the task
+uint64_t GetCorrelationId(
+    xpti::trace_event_data_t* event, uint64_t instance, bool wait) {
+  uint64_t id = (event == nullptr) ? 0 : event->unique_id;
+  id ^= instance * 0x9e3779b97f4a7c15ULL;
+  return (id << 1) | (wait ? 1 : 0);
+}
+
+void OnTracePoint(
+    uint16_t trace_type, xpti::trace_event_data_t* parent,
+    xpti::trace_event_data_t* event, uint64_t instance,
+    const void* user_data) {
+  if (!SyclCollector::IsEnabled()) {
+    return;
+  }
+
+  switch (trace_type) {
+    case static_cast<uint16_t>(xpti::trace_point_type_t::task_begin):
+      SyclCollector::OnBegin(GetCorrelationId(event, instance, false),
+                             GetName(event), SYCL_EVENT_TASK);
+      break;
+    case static_cast<uint16_t>(xpti::trace_point_type_t::task_end):
+      SyclCollector::OnEnd(GetCorrelationId(event, instance, false));
+      break;
+    case static_cast<uint16_t>(xpti::trace_point_type_t::wait_begin):
+      SyclCollector::OnBegin(GetCorrelationId(event, instance, true),
+                             GetName(event), SYCL_EVENT_WAIT);
+      break;
+    case static_cast<uint16_t>(xpti::trace_point_type_t::wait_end):
+      SyclCollector::OnEnd(GetCorrelationId(event, instance, true));
+      break;
+    default:
+      break;
+  }
+}
+
+} // namespace
+
+bool SyclCollector::IsSupported() {
+  return true;
+}
+
+bool SyclCollector::SetSubscriberLibrary() {
+  Dl_info info{};
+  int status = dladdr(
+      reinterpret_cast<void*>(&SyclCollector::SetSubscriberLibrary), &info);
+  if (status == 0 || info.dli_fname == nullptr) {
+    return false;
+  }
+
+  std::string subscribers = utils::GetEnv(XPTI_SUBSCRIBERS_ENV);
+  if (subscribers.find(info.dli_fname) == std::string::npos) {
+    if (!subscribers.empty()) {
+      subscribers += ",";
+    }
+    subscribers += info.dli_fname;
+    utils::SetEnv(XPTI_SUBSCRIBERS_ENV, subscribers.c_str());
+  }
+
+  if (utils::GetEnv(XPTI_FRAMEWORK_DISPATCHER_ENV).empty()) {
+    utils::SetEnv(XPTI_FRAMEWORK_DISPATCHER_ENV, XPTI_FRAMEWORK_LIBRARY);
+  }
+  utils::SetEnv(XPTI_TRACE_ENABLE_ENV, "1");
+  return true;
+}
+
+extern "C" {
+
+__attribute__((visibility("default")))
+void xptiTraceInit(
+    unsigned int major_version, unsigned int minor_version,
+    const char* version_str, const char* stream_name) {
+  if (stream_name == nullptr || strcmp(stream_name, XPTI_SYCL_STREAM) != 0) {
+    return;
+  }
+
+  XptiRegisterStream register_stream =
+    Lookup<XptiRegisterStream>("xptiRegisterStream");
+  XptiRegisterCallback register_callback =
+    Lookup<XptiRegisterCallback>("xptiRegisterCallback");
+  query_payload = Lookup<XptiQueryPayload>("xptiQueryPayload");
+  if (register_stream == nullptr || register_callback == nullptr) {
+    std::cerr << "[WARNING] Unable to subscribe to SYCL stream" << std::endl;
+    return;
+  }
+
+  uint8_t stream_id = register_stream(stream_name);
+  const xpti::trace_point_type_t trace_point_list[] = {
+      xpti::trace_point_type_t::task_begin,
+      xpti::trace_point_type_t::task_end,
+      xpti::trace_point_type_t::wait_begin,
+      xpti::trace_point_type_t::wait_end};
+  for (xpti::trace_point_type_t trace_point : trace_point_list) {
+    register_callback(
+        stream_id, static_cast<uint16_t>(trace_point), OnTracePoint);
+  }
+}
+
+__attribute__((visibility("default")))
+void xptiTraceFinish(const char* stream_name) {}
+
+} // extern "C"
+
+#else
+
+bool SyclCollector::IsSupported() {
+  return false;
+}
+
+bool SyclCollector::SetSubscriberLibrary() {
+  return false;
+}
+
+#endif
\ No newline at end of file
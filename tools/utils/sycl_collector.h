@@ -0,0 +1,296 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_SYCL_COLLECTOR_H_
+#define PTI_TOOLS_UTILS_SYCL_COLLECTOR_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "correlator.h"
+#include "pti_assert.h"
+#include "string_table.h"
+
+enum SyclEventType {
+  SYCL_EVENT_TASK = 0, // Command group execution by SYCL runtime
+  SYCL_EVENT_WAIT = 1  // Host waiting for SYCL events or queues
+};
+
+struct SyclTaskInfo {
+  uint64_t call_count;
+  uint64_t host_time;   // From task begin to task end
+  uint64_t api_time;    // Level Zero and OpenCL calls made by the task
+  uint64_t kernel_count;
+  uint64_t device_time; // Device commands appended by the task
+};
+
+using SyclTaskKey = std::pair<uint32_t, SyclEventType>; // Name ID, type
+using SyclTaskInfoMap = std::map<SyclTaskKey, SyclTaskInfo>;
+
+typedef void (*OnSyclTaskFinishCallback)(
+    void* data, const std::string& domain, const std::string& name,
+    uint64_t started, uint64_t ended);
+
+// Subscriber side of XPTI: the tool library exports xptiTraceInit and
+// xptiTraceFinish (see sycl_collector.cc) and SYCL runtime loads it as a
+// subscriber of "sycl" stream. Tasks and waits are timed on the host,
+// and each Level Zero or OpenCL call is attributed to the innermost task
+// running on the calling thread. Device commands are linked to the task
+// through the kernel ID of the call that appended them, so the time of
+// SYCL runtime itself is the task time not spent in the calls
+class SyclCollector {
+ public: // User Interface
+  static SyclCollector* Create(
+      Correlator* correlator,
+      OnSyclTaskFinishCallback callback = nullptr,
+      void* callback_data = nullptr) {
+    PTI_ASSERT(correlator != nullptr);
+    if (!IsSupported()) {
+      std::cerr << "[WARNING] SYCL tracing is not supported" << std::endl;
+      return nullptr;
+    }
+
+    SyclCollector* collector = new SyclCollector(
+        correlator, callback, callback_data);
+    PTI_ASSERT(collector != nullptr);
+
+    SyclCollector* previous = nullptr;
+    bool registered = GetInstance().compare_exchange_strong(
+        previous, collector, std::memory_order_acq_rel);
+    PTI_ASSERT(registered);
+    return collector;
+  }
+
+  // Points SYCL runtime of the application to the tool library, is to be
+  // called before the application starts, defined in sycl_collector.cc
+  static bool SetSubscriberLibrary();
+
+  ~SyclCollector() {
+    DisableTracing();
+  }
+
+  void DisableTracing() {
+    SyclCollector* collector = this;
+    GetInstance().compare_exchange_strong(
+        collector, nullptr, std::memory_order_acq_rel);
+  }
+
+  // Called at the end of each Level Zero or OpenCL call on the calling
+  // thread, kernel ID is zero if the call appended no device command
+  void AddCall(uint64_t kernel_id, uint64_t started, uint64_t ended) {
+    std::vector<Frame>& stack = GetStack();
+    if (stack.empty()) {
+      return;
+    }
+    Frame& frame = stack.back();
+    PTI_ASSERT(started <= ended);
+    frame.api_time += ended - started;
+
+    if (kernel_id != 0) {
+      const std::lock_guard<std::mutex> lock(lock_);
+      kernel_map_[kernel_id] = frame.key;
+    }
+  }
+
+  // Called for each finished device command with its kernel ID
+  void AddKernel(uint64_t kernel_id, uint64_t started, uint64_t ended) {
+    PTI_ASSERT(started <= ended);
+    const std::lock_guard<std::mutex> lock(lock_);
+    auto it = kernel_map_.find(kernel_id);
+    if (it == kernel_map_.end()) {
+      return;
+    }
+    SyclTaskInfo& info = task_info_map_[it->second];
+    ++info.kernel_count;
+    info.device_time += ended - started;
+  }
+
+  SyclTaskInfoMap GetTaskInfoMap() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return task_info_map_;
+  }
+
+  void PrintTasksTable() const {
+    SyclTaskInfoMap task_info_map = GetTaskInfoMap();
+    if (task_info_map.empty()) {
+      return;
+    }
+
+    std::vector< std::pair<std::string, SyclTaskKey> > sorted_list;
+    size_t max_name_length = kTaskLength;
+    for (auto& value : task_info_map) {
+      if (value.second.call_count == 0) { // Kernels of a running task
+        continue;
+      }
+      const std::string& name = StringTable::Get(value.first.first);
+      sorted_list.emplace_back(name, value.first);
+      if (name.size() > max_name_length) {
+        max_name_length = name.size();
+      }
+    }
+    std::sort(sorted_list.begin(), sorted_list.end(),
+              [&task_info_map](
+                  const std::pair<std::string, SyclTaskKey>& left,
+                  const std::pair<std::string, SyclTaskKey>& right) {
+                uint64_t left_time = task_info_map.at(left.second).host_time;
+                uint64_t right_time =
+                  task_info_map.at(right.second).host_time;
+                if (left_time != right_time) {
+                  return left_time > right_time;
+                }
+                return left < right;
+              });
+
+    std::stringstream stream;
+    stream << std::setw(max_name_length) << "Task" << "," <<
+      std::setw(kTypeLength) << "Type" << "," <<
+      std::setw(kCallsLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Host Time (ns)" << "," <<
+      std::setw(kTimeLength) << "API Time (ns)" << "," <<
+      std::setw(kTimeLength) << "Runtime Time (ns)" << "," <<
+      std::setw(kCallsLength) << "Kernels" << "," <<
+      std::setw(kTimeLength) << "Device Time (ns)" << std::endl;
+
+    for (auto& value : sorted_list) {
+      const SyclTaskInfo& info = task_info_map.at(value.second);
+      uint64_t runtime_time = (info.api_time < info.host_time) ?
+        info.host_time - info.api_time : 0;
+      stream << std::setw(max_name_length) << value.first << "," <<
+        std::setw(kTypeLength) <<
+          (value.second.second == SYCL_EVENT_TASK ? "Task" : "Wait") <<
+          "," <<
+        std::setw(kCallsLength) << info.call_count << "," <<
+        std::setw(kTimeLength) << info.host_time << "," <<
+        std::setw(kTimeLength) << info.api_time << "," <<
+        std::setw(kTimeLength) << runtime_time << "," <<
+        std::setw(kCallsLength) << info.kernel_count << "," <<
+        std::setw(kTimeLength) << info.device_time << std::endl;
+    }
+
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  SyclCollector(const SyclCollector& copy) = delete;
+  SyclCollector& operator=(const SyclCollector& copy) = delete;
+
+ public: // XPTI Interface
+  static bool IsEnabled() {
+    return GetInstance().load(std::memory_order_acquire) != nullptr;
+  }
+
+  // Correlation ID identifies the task or wait instance, so begin and
+  // end are matched even if some ends are missing
+  static void OnBegin(
+      uint64_t correlation_id, const char* name, SyclEventType type) {
+    SyclCollector* collector = GetInstance().load(std::memory_order_acquire);
+    if (collector != nullptr) {
+      collector->Begin(correlation_id, name, type);
+    }
+  }
+
+  static void OnEnd(uint64_t correlation_id) {
+    SyclCollector* collector = GetInstance().load(std::memory_order_acquire);
+    if (collector != nullptr) {
+      collector->End(correlation_id);
+    }
+  }
+
+ private: // Implementation Details
+  struct Frame {
+    uint64_t correlation_id;
+    SyclTaskKey key;
+    uint64_t start;
+    uint64_t api_time;
+  };
+
+  SyclCollector(
+      Correlator* correlator,
+      OnSyclTaskFinishCallback callback,
+      void* callback_data)
+      : correlator_(correlator),
+        callback_(callback),
+        callback_data_(callback_data) {}
+
+  // Defined in sycl_collector.cc, depends on XPTI headers at build time
+  static bool IsSupported();
+
+  static std::atomic<SyclCollector*>& GetInstance() {
+    static std::atomic<SyclCollector*> instance{nullptr};
+    return instance;
+  }
+
+  static std::vector<Frame>& GetStack() {
+    thread_local std::vector<Frame> stack;
+    return stack;
+  }
+
+  void Begin(uint64_t correlation_id, const char* name, SyclEventType type) {
+    uint32_t name_id = StringTable::Add(
+        (name == nullptr) ? "<unknown>" : name);
+    PTI_ASSERT(correlator_ != nullptr);
+    GetStack().push_back(
+        {correlation_id, {name_id, type}, correlator_->GetTimestamp(), 0});
+  }
+
+  void End(uint64_t correlation_id) {
+    PTI_ASSERT(correlator_ != nullptr);
+    uint64_t end = correlator_->GetTimestamp();
+
+    std::vector<Frame>& stack = GetStack();
+    auto it = std::find_if(
+        stack.rbegin(), stack.rend(),
+        [correlation_id](const Frame& frame) {
+          return frame.correlation_id == correlation_id;
+        });
+    if (it == stack.rend()) {
+      return;
+    }
+    Frame frame = *it;
+    stack.erase(std::next(it).base(), stack.end());
+
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      SyclTaskInfo& info = task_info_map_[frame.key];
+      ++info.call_count;
+      info.host_time += end - frame.start;
+      info.api_time += frame.api_time;
+    }
+
+    if (callback_ != nullptr) {
+      callback_(callback_data_, "SYCL", StringTable::Get(frame.key.first),
+                frame.start, end);
+    }
+  }
+
+ private: // Data
+  Correlator* correlator_ = nullptr;
+
+  OnSyclTaskFinishCallback callback_ = nullptr;
+  void* callback_data_ = nullptr;
+
+  SyclTaskInfoMap task_info_map_;
+  std::unordered_map<uint64_t, SyclTaskKey> kernel_map_;
+  mutable std::mutex lock_;
+
+  static const uint32_t kTaskLength = 10;
+  static const uint32_t kTypeLength = 6;
+  static const uint32_t kCallsLength = 12;
+  static const uint32_t kTimeLength = 20;
+};
+
+#endif // PTI_TOOLS_UTILS_SYCL_COLLECTOR_H_
\ No newline at end of file
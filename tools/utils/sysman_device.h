@@ -0,0 +1,335 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_SYSMAN_DEVICE_H_
+#define PTI_TOOLS_UTILS_SYSMAN_DEVICE_H_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <level_zero/zes_api.h>
+
+#include "pti_assert.h"
+
+#define SYSMAN_UNKNOWN -1.0
+
+struct SysmanEngine {
+  zes_engine_handle_t handle;
+  zes_engine_group_t type;
+  bool on_subdevice;
+  uint32_t subdevice_id;
+};
+
+struct SysmanPower {
+  zes_pwr_handle_t handle;
+  bool on_subdevice;
+  uint32_t subdevice_id;
+};
+
+// Counters are in the order of the device engines and power domains,
+// a counter with zero timestamp is unavailable
+struct SysmanSample {
+  uint64_t timestamp = 0; // Host steady clock, ns
+  double frequency = SYSMAN_UNKNOWN; // MHz
+  double temperature = SYSMAN_UNKNOWN; // Celsius
+  zes_freq_throttle_reason_flags_t throttle_reasons = 0;
+  uint64_t memory_size = 0; // Bytes, zero if unknown
+  uint64_t memory_free = 0;
+  std::vector<zes_engine_stats_t> engine_list;
+  std::vector<zes_power_energy_counter_t> energy_list;
+};
+
+// Sysman handles of the device are enumerated once, sampling then goes
+// through the state and counter queries only. Rates are computed from
+// two samples of the same device
+class SysmanDevice {
+ public: // Interface
+  explicit SysmanDevice(zes_device_handle_t device) : device_(device) {
+    PTI_ASSERT(device_ != nullptr);
+    EnumerateFrequency();
+    EnumerateTemperature();
+    EnumerateMemory();
+    EnumerateEngines();
+    EnumeratePower();
+  }
+
+  zes_device_handle_t GetDevice() const {
+    return device_;
+  }
+
+  const std::vector<SysmanEngine>& GetEngineList() const {
+    return engine_list_;
+  }
+
+  const std::vector<SysmanPower>& GetPowerList() const {
+    return power_list_;
+  }
+
+  void Sample(SysmanSample* sample) const {
+    PTI_ASSERT(sample != nullptr);
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    sample->timestamp = GetTimestamp();
+
+    sample->frequency = SYSMAN_UNKNOWN;
+    sample->throttle_reasons = 0;
+    if (frequency_ != nullptr) {
+      zes_freq_state_t state{ZES_STRUCTURE_TYPE_FREQ_STATE, };
+      status = zesFrequencyGetState(frequency_, &state);
+      if (status == ZE_RESULT_SUCCESS) {
+        sample->frequency = (state.actual < frequency_min_) ?
+          frequency_min_ : state.actual;
+        sample->throttle_reasons = state.throttleReasons;
+      }
+    }
+
+    sample->temperature = SYSMAN_UNKNOWN;
+    if (temperature_ != nullptr) {
+      double temperature = 0.0;
+      status = zesTemperatureGetState(temperature_, &temperature);
+      if (status == ZE_RESULT_SUCCESS) {
+        sample->temperature = temperature;
+      }
+    }
+
+    sample->memory_size = 0;
+    sample->memory_free = 0;
+    for (auto memory : memory_list_) {
+      zes_mem_state_t state{ZES_STRUCTURE_TYPE_MEM_STATE, };
+      status = zesMemoryGetState(memory, &state);
+      if (status == ZE_RESULT_SUCCESS) {
+        sample->memory_size += state.size;
+        sample->memory_free += state.free;
+      }
+    }
+
+    sample->engine_list.resize(engine_list_.size());
+    for (size_t i = 0; i < engine_list_.size(); ++i) {
+      zes_engine_stats_t& stats = sample->engine_list[i];
+      status = zesEngineGetActivity(engine_list_[i].handle, &stats);
+      if (status != ZE_RESULT_SUCCESS) {
+        stats = zes_engine_stats_t{};
+      }
+    }
+
+    sample->energy_list.resize(power_list_.size());
+    for (size_t i = 0; i < power_list_.size(); ++i) {
+      SampleEnergy(i, &sample->energy_list[i]);
+    }
+  }
+
+  // Counter of the power domain is reset if it can't be read
+  bool SampleEnergy(size_t power_id,
+                    zes_power_energy_counter_t* energy) const {
+    PTI_ASSERT(power_id < power_list_.size());
+    PTI_ASSERT(energy != nullptr);
+    ze_result_t status =
+      zesPowerGetEnergyCounter(power_list_[power_id].handle, energy);
+    if (status != ZE_RESULT_SUCCESS) {
+      *energy = zes_power_energy_counter_t{};
+      return false;
+    }
+    return true;
+  }
+
+  // Percent of time the engine was busy between the samples
+  static double GetBusy(
+      const zes_engine_stats_t& prev, const zes_engine_stats_t& next) {
+    if (prev.timestamp == 0 || next.timestamp <= prev.timestamp ||
+        next.activeTime < prev.activeTime) {
+      return SYSMAN_UNKNOWN;
+    }
+    double busy = 100.0 * (next.activeTime - prev.activeTime) /
+      (next.timestamp - prev.timestamp);
+    return (busy > 100.0) ? 100.0 : busy;
+  }
+
+  // Average power between the samples, W
+  static double GetPower(
+      const zes_power_energy_counter_t& prev,
+      const zes_power_energy_counter_t& next) {
+    if (prev.timestamp == 0 || next.timestamp <= prev.timestamp ||
+        next.energy < prev.energy) {
+      return SYSMAN_UNKNOWN;
+    }
+    // Both energy (uJ) and timestamp (us) are in micro units
+    return static_cast<double>(next.energy - prev.energy) /
+      (next.timestamp - prev.timestamp);
+  }
+
+  static std::string GetEngineName(zes_engine_group_t type) {
+    switch (type) {
+      case ZES_ENGINE_GROUP_ALL:
+        return "ALL";
+      case ZES_ENGINE_GROUP_COMPUTE_ALL:
+        return "COMPUTE_ALL";
+      case ZES_ENGINE_GROUP_MEDIA_ALL:
+        return "MEDIA_ALL";
+      case ZES_ENGINE_GROUP_COPY_ALL:
+        return "COPY_ALL";
+      case ZES_ENGINE_GROUP_COMPUTE_SINGLE:
+        return "COMPUTE_SINGLE";
+      case ZES_ENGINE_GROUP_RENDER_SINGLE:
+        return "RENDER_SINGLE";
+      case ZES_ENGINE_GROUP_MEDIA_DECODE_SINGLE:
+        return "MEDIA_DECODE_SINGLE";
+      case ZES_ENGINE_GROUP_MEDIA_ENCODE_SINGLE:
+        return "MEDIA_ENCODE_SINGLE";
+      case ZES_ENGINE_GROUP_COPY_SINGLE:
+        return "COPY_SINGLE";
+      case ZES_ENGINE_GROUP_MEDIA_ENHANCEMENT_SINGLE:
+        return "MEDIA_ENHANCEMENT_SINGLE";
+      case ZES_ENGINE_GROUP_3D_SINGLE:
+        return "3D_SINGLE";
+      case ZES_ENGINE_GROUP_3D_RENDER_COMPUTE_ALL:
+        return "3D_RENDER_COMPUTE_ALL";
+      case ZES_ENGINE_GROUP_RENDER_ALL:
+        return "GROUP_RENDER_ALL";
+      case ZES_ENGINE_GROUP_3D_ALL:
+        return "3D_ALL";
+      default:
+        break;
+    }
+    return "UNKNOWN";
+  }
+
+  SysmanDevice(const SysmanDevice& copy) = delete;
+  SysmanDevice& operator=(const SysmanDevice& copy) = delete;
+
+ private: // Implementation
+  static uint64_t GetTimestamp() {
+    std::chrono::duration<uint64_t, std::nano> timestamp =
+      std::chrono::steady_clock::now().time_since_epoch();
+    return timestamp.count();
+  }
+
+  void EnumerateFrequency() {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    uint32_t count = 0;
+    status = zesDeviceEnumFrequencyDomains(device_, &count, nullptr);
+    if (status != ZE_RESULT_SUCCESS || count == 0) {
+      return;
+    }
+
+    std::vector<zes_freq_handle_t> domain_list(count);
+    status = zesDeviceEnumFrequencyDomains(
+        device_, &count, domain_list.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    for (auto domain : domain_list) {
+      zes_freq_properties_t props{ZES_STRUCTURE_TYPE_FREQ_PROPERTIES, };
+      status = zesFrequencyGetProperties(domain, &props);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      if (props.type == ZES_FREQ_DOMAIN_GPU) {
+        frequency_ = domain;
+        frequency_min_ = props.min;
+        break;
+      }
+    }
+  }
+
+  void EnumerateTemperature() {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    uint32_t count = 0;
+    status = zesDeviceEnumTemperatureSensors(device_, &count, nullptr);
+    if (status != ZE_RESULT_SUCCESS || count == 0) {
+      return;
+    }
+
+    std::vector<zes_temp_handle_t> sensor_list(count);
+    status = zesDeviceEnumTemperatureSensors(
+        device_, &count, sensor_list.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    for (auto sensor : sensor_list) {
+      zes_temp_properties_t props{ZES_STRUCTURE_TYPE_TEMP_PROPERTIES, };
+      status = zesTemperatureGetProperties(sensor, &props);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      if (props.type == ZES_TEMP_SENSORS_GPU) {
+        temperature_ = sensor;
+        break;
+      }
+    }
+  }
+
+  void EnumerateMemory() {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    uint32_t count = 0;
+    status = zesDeviceEnumMemoryModules(device_, &count, nullptr);
+    if (status != ZE_RESULT_SUCCESS || count == 0) {
+      return;
+    }
+
+    std::vector<zes_mem_handle_t> module_list(count);
+    status = zesDeviceEnumMemoryModules(device_, &count, module_list.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    for (auto module : module_list) {
+      zes_mem_properties_t props{ZES_STRUCTURE_TYPE_MEM_PROPERTIES, };
+      status = zesMemoryGetProperties(module, &props);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      if (props.location == ZES_MEM_LOC_DEVICE) {
+        memory_list_.push_back(module);
+      }
+    }
+  }
+
+  void EnumerateEngines() {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    uint32_t count = 0;
+    status = zesDeviceEnumEngineGroups(device_, &count, nullptr);
+    if (status != ZE_RESULT_SUCCESS || count == 0) {
+      return;
+    }
+
+    std::vector<zes_engine_handle_t> engine_list(count);
+    status = zesDeviceEnumEngineGroups(device_, &count, engine_list.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    for (auto engine : engine_list) {
+      zes_engine_properties_t props{ZES_STRUCTURE_TYPE_ENGINE_PROPERTIES, };
+      status = zesEngineGetProperties(engine, &props);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      engine_list_.push_back(
+          {engine, props.type, props.onSubdevice != 0, props.subdeviceId});
+    }
+  }
+
+  void EnumeratePower() {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    uint32_t count = 0;
+    status = zesDeviceEnumPowerDomains(device_, &count, nullptr);
+    if (status != ZE_RESULT_SUCCESS || count == 0) {
+      return;
+    }
+
+    std::vector<zes_pwr_handle_t> domain_list(count);
+    status = zesDeviceEnumPowerDomains(device_, &count, domain_list.data());
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    for (auto domain : domain_list) {
+      zes_power_properties_t props{ZES_STRUCTURE_TYPE_POWER_PROPERTIES, };
+      status = zesPowerGetProperties(domain, &props);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      power_list_.push_back(
+          {domain, props.onSubdevice != 0, props.subdeviceId});
+    }
+  }
+
+ private: // Data
+  zes_device_handle_t device_ = nullptr;
+  zes_freq_handle_t frequency_ = nullptr;
+  double frequency_min_ = 0.0;
+  zes_temp_handle_t temperature_ = nullptr;
+  std::vector<zes_mem_handle_t> memory_list_;
+  std::vector<SysmanEngine> engine_list_;
+  std::vector<SysmanPower> power_list_;
+};
+
+#endif // PTI_TOOLS_UTILS_SYSMAN_DEVICE_H_
\ No newline at end of file
@@ -0,0 +1,212 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_SYSMAN_SAMPLER_H_
+#define PTI_TOOLS_UTILS_SYSMAN_SAMPLER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pti_assert.h"
+#include "sysman_device.h"
+#include "ze_utils.h"
+
+#define SYSMAN_SAMPLER_INTERVAL 10 // ms
+
+struct SysmanCounterSample {
+  uint64_t timestamp; // In the time domain of the sampler clock, ns
+  double frequency; // MHz
+  double power; // W, average since the previous sample
+  double temperature; // Celsius
+  uint32_t throttle_reasons;
+};
+
+using SysmanCounterList = std::vector<SysmanCounterSample>;
+typedef uint64_t (*OnSysmanTimestamp)(void* data);
+
+// Background thread that polls frequency, power, temperature and throttle
+// reasons of every device, so the samples may be correlated with the
+// kernels. Timestamps come from the tool clock to share its time domain
+class SysmanSampler {
+ public: // Interface
+  static SysmanSampler* Create(
+      OnSysmanTimestamp clock, void* clock_data,
+      uint32_t interval = SYSMAN_SAMPLER_INTERVAL) {
+    PTI_ASSERT(clock != nullptr);
+    PTI_ASSERT(interval > 0);
+
+    std::vector<SysmanDevice*> device_list;
+    for (auto device : utils::ze::GetDeviceList()) {
+      device_list.push_back(new SysmanDevice(device));
+    }
+
+    if (device_list.empty()) {
+      std::cerr << "[WARNING] Unable to find devices for Sysman sampling" <<
+        std::endl;
+      return nullptr;
+    }
+
+    SysmanSampler* sampler = new SysmanSampler(
+        device_list, clock, clock_data, interval);
+    PTI_ASSERT(sampler != nullptr);
+    return sampler;
+  }
+
+  ~SysmanSampler() {
+    Stop();
+    for (auto device : device_list_) {
+      delete device;
+    }
+  }
+
+  void Stop() {
+    stop_.store(true, std::memory_order_release);
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  // Samples are taken that many times less often from the next one on,
+  // e.g. to keep the tool overhead down
+  void SetIntervalScale(uint32_t scale) {
+    PTI_ASSERT(scale > 0);
+    interval_scale_.store(scale, std::memory_order_relaxed);
+  }
+
+  uint32_t GetDeviceCount() const {
+    return device_list_.size();
+  }
+
+  SysmanCounterList GetCounterList(uint32_t device_id) const {
+    PTI_ASSERT(device_id < counter_list_.size());
+    const std::lock_guard<std::mutex> lock(lock_);
+    return counter_list_[device_id];
+  }
+
+  // Averages the known values of the samples taken inside the interval,
+  // if there are none (short kernel) the closest sample before its end
+  // is taken. Returns SYSMAN_UNKNOWN if nothing is sampled yet
+  double GetAverage(
+      uint32_t device_id, double SysmanCounterSample::* counter,
+      uint64_t start, uint64_t end) const {
+    PTI_ASSERT(device_id < counter_list_.size());
+    PTI_ASSERT(start <= end);
+    const std::lock_guard<std::mutex> lock(lock_);
+    const SysmanCounterList& counter_list = counter_list_[device_id];
+
+    auto first = std::lower_bound(
+        counter_list.begin(), counter_list.end(), start,
+        [](const SysmanCounterSample& sample, uint64_t timestamp) {
+          return sample.timestamp < timestamp;
+        });
+
+    double total = 0.0;
+    uint32_t count = 0;
+    for (auto it = first;
+         it != counter_list.end() && it->timestamp <= end; ++it) {
+      if ((*it).*counter >= 0) {
+        total += (*it).*counter;
+        ++count;
+      }
+    }
+
+    if (count > 0) {
+      return total / count;
+    }
+    if (first == counter_list.begin()) {
+      return SYSMAN_UNKNOWN;
+    }
+    return (*(first - 1)).*counter;
+  }
+
+  SysmanSampler(const SysmanSampler& copy) = delete;
+  SysmanSampler& operator=(const SysmanSampler& copy) = delete;
+
+ private: // Implementation
+  SysmanSampler(
+      const std::vector<SysmanDevice*>& device_list,
+      OnSysmanTimestamp clock, void* clock_data, uint32_t interval)
+      : device_list_(device_list), clock_(clock), clock_data_(clock_data),
+        interval_(interval), counter_list_(device_list.size()) {
+    thread_ = std::thread(&SysmanSampler::Run, this);
+  }
+
+  // Device level power domains are preferred, otherwise subdevice domains
+  // are summed up
+  static double GetPower(
+      const SysmanDevice* device,
+      const SysmanSample& prev, const SysmanSample& next) {
+    const std::vector<SysmanPower>& power_list = device->GetPowerList();
+    for (bool on_subdevice : {false, true}) {
+      double total = SYSMAN_UNKNOWN;
+      for (size_t i = 0; i < power_list.size(); ++i) {
+        if (power_list[i].on_subdevice != on_subdevice) {
+          continue;
+        }
+        double power = SysmanDevice::GetPower(
+            prev.energy_list[i], next.energy_list[i]);
+        if (power >= 0) {
+          total = (total < 0) ? power : total + power;
+        }
+      }
+      if (total >= 0) {
+        return total;
+      }
+    }
+    return SYSMAN_UNKNOWN;
+  }
+
+  void Run() {
+    std::vector<SysmanSample> prev_list(device_list_.size());
+    std::vector<SysmanSample> next_list(device_list_.size());
+    for (size_t i = 0; i < device_list_.size(); ++i) {
+      device_list_[i]->Sample(&prev_list[i]);
+    }
+
+    std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now();
+    while (!stop_.load(std::memory_order_acquire)) {
+      deadline += std::chrono::milliseconds(
+          interval_ * interval_scale_.load(std::memory_order_relaxed));
+      std::this_thread::sleep_until(deadline);
+
+      for (size_t i = 0; i < device_list_.size(); ++i) {
+        uint64_t timestamp = clock_(clock_data_);
+        device_list_[i]->Sample(&next_list[i]);
+
+        SysmanCounterSample sample{
+            timestamp, next_list[i].frequency,
+            GetPower(device_list_[i], prev_list[i], next_list[i]),
+            next_list[i].temperature, next_list[i].throttle_reasons};
+
+        const std::lock_guard<std::mutex> lock(lock_);
+        counter_list_[i].push_back(sample);
+      }
+      prev_list.swap(next_list);
+    }
+  }
+
+ private: // Data
+  std::vector<SysmanDevice*> device_list_;
+  OnSysmanTimestamp clock_ = nullptr;
+  void* clock_data_ = nullptr;
+  uint32_t interval_ = SYSMAN_SAMPLER_INTERVAL;
+
+  std::atomic<uint32_t> interval_scale_{1};
+
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+
+  mutable std::mutex lock_;
+  std::vector<SysmanCounterList> counter_list_;
+};
+
+#endif // PTI_TOOLS_UTILS_SYSMAN_SAMPLER_H_
\ No newline at end of file
@@ -0,0 +1,223 @@
+#==============================================================
+# Copyright (C) Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+# =============================================================
+
+# Compares timing tables stored with --save-tables option of
+# onetrace/ze_tracer/cl_tracer between two runs. Kernels and API functions
+# are matched by backend and name, a change of time per call is reported
+# if it is both large enough (--threshold) and statistically significant
+# by two-sample Kolmogorov-Smirnov test over the stored duration
+# histograms (--alpha), a change of call count is reported if it is
+# larger than the threshold. Exit status is 1 if something got slower
+#
+# Usage: python table_diff.py [--threshold <percent>] [--alpha <level>]
+#   [--all] <base.tables.json> <new.tables.json>
+
+import json
+import math
+import sys
+
+SCHEMA = "pti-tables"
+VERSION = 1
+
+# Critical values of Kolmogorov distribution
+KS_COEFFICIENTS = {0.1 : 1.224, 0.05 : 1.358, 0.01 : 1.628, 0.001 : 1.949}
+
+DEFAULT_THRESHOLD = 5.0 # %
+DEFAULT_ALPHA = 0.01
+
+NAME_LENGTH = 10
+BACKEND_LENGTH = 8
+COUNT_LENGTH = 12
+TIME_LENGTH = 14
+PERCENT_LENGTH = 10
+STATUS_LENGTH = 8
+
+def read_tables(filename):
+  with open(filename, "r") as f:
+    tables = json.load(f)
+  if tables.get("schema") != SCHEMA:
+    raise ValueError(filename + " is not a timing tables file")
+  if tables.get("version", 0) > VERSION:
+    raise ValueError("Unsupported timing tables version " +
+      str(tables["version"]) + " of " + filename)
+  return tables
+
+def get_entries(tables, section):
+  return dict(((entry["backend"], entry["name"]), entry)
+              for entry in tables.get(section, []))
+
+# Same estimate as LatencyHistogram::GetPercentile(): bucket midpoint
+# bounded by the exact minimum and maximum
+def get_percentile(entry, percent):
+  count = sum(bucket[2] for bucket in entry["histogram"])
+  if count == 0:
+    return 0
+  rank = max(int(math.ceil(percent * count / 100.0)), 1)
+  value = entry["max"]
+  current = 0
+  for lower, upper, bucket in entry["histogram"]:
+    current += bucket
+    if current >= rank:
+      value = lower + (upper - lower) // 2
+      break
+  return min(max(value, entry["min"]), entry["max"])
+
+# Largest distance between the two empirical distributions, evaluated at
+# the bucket bounds. Both runs share the histogram layout, so the bounds
+# match and the statistic only loses the resolution within a bucket
+def get_ks_statistic(base, new):
+  base_count = sum(bucket[2] for bucket in base["histogram"])
+  new_count = sum(bucket[2] for bucket in new["histogram"])
+  if base_count == 0 or new_count == 0:
+    return 0.0, base_count, new_count
+
+  base_map = dict((bucket[0], bucket[2]) for bucket in base["histogram"])
+  new_map = dict((bucket[0], bucket[2]) for bucket in new["histogram"])
+
+  statistic = 0.0
+  base_total = 0
+  new_total = 0
+  for lower in sorted(set(base_map) | set(new_map)):
+    base_total += base_map.get(lower, 0)
+    new_total += new_map.get(lower, 0)
+    distance = abs(float(base_total) / base_count -
+                   float(new_total) / new_count)
+    statistic = max(statistic, distance)
+  return statistic, base_count, new_count
+
+def get_critical_value(alpha, base_count, new_count):
+  return KS_COEFFICIENTS[alpha] * math.sqrt(
+    float(base_count + new_count) / (base_count * new_count))
+
+def compare(base, new, threshold, alpha):
+  row = {"base" : base, "new" : new, "change" : None, "ks" : None,
+         "status" : ""}
+  if base is None:
+    row["status"] = "NEW"
+    return row
+  if new is None:
+    row["status"] = "MISSING"
+    return row
+
+  base_mean = float(base["total"]) / max(base["calls"], 1)
+  new_mean = float(new["total"]) / max(new["calls"], 1)
+  if base_mean > 0:
+    row["change"] = 100.0 * (new_mean - base_mean) / base_mean
+
+  statistic, base_count, new_count = get_ks_statistic(base, new)
+  row["ks"] = statistic
+  if (row["change"] is not None and abs(row["change"]) >= threshold and
+      base_count > 0 and new_count > 0 and
+      statistic > get_critical_value(alpha, base_count, new_count)):
+    row["status"] = "SLOWER" if row["change"] > 0 else "FASTER"
+  elif abs(new["calls"] - base["calls"]) * 100.0 > \
+      threshold * max(base["calls"], 1):
+    row["status"] = "CALLS"
+  return row
+
+def get_rows(base_tables, new_tables, section, threshold, alpha):
+  base_entries = get_entries(base_tables, section)
+  new_entries = get_entries(new_tables, section)
+  rows = []
+  for key in set(base_entries) | set(new_entries):
+    row = compare(base_entries.get(key), new_entries.get(key),
+                  threshold, alpha)
+    row["key"] = key
+    rows.append(row)
+
+  # The largest change of total time goes first
+  def get_delta(row):
+    base_total = row["base"]["total"] if row["base"] else 0
+    new_total = row["new"]["total"] if row["new"] else 0
+    return abs(new_total - base_total)
+  rows.sort(key = get_delta, reverse = True)
+  return rows
+
+def get_value(entry, function):
+  return str(function(entry)) if entry else "-"
+
+def write_table(title, column, rows, output):
+  if not rows:
+    return
+
+  output.write("\n=== " + title + ": ===\n\n")
+  name_length = max([NAME_LENGTH] + [len(row["key"][1]) for row in rows])
+  header = [(column, name_length), ("Backend", BACKEND_LENGTH),
+    ("Calls (A)", COUNT_LENGTH), ("Calls (B)", COUNT_LENGTH),
+    ("Mean A (ns)", TIME_LENGTH), ("Mean B (ns)", TIME_LENGTH),
+    ("Change (%)", PERCENT_LENGTH),
+    ("P50 A (ns)", TIME_LENGTH), ("P50 B (ns)", TIME_LENGTH),
+    ("P99 A (ns)", TIME_LENGTH), ("P99 B (ns)", TIME_LENGTH),
+    ("KS D", PERCENT_LENGTH), ("Status", STATUS_LENGTH)]
+  output.write(",".join(value.rjust(length)
+                        for value, length in header) + "\n")
+
+  for row in rows:
+    base = row["base"]
+    new = row["new"]
+    mean = lambda entry : entry["total"] // max(entry["calls"], 1)
+    values = [row["key"][1], row["key"][0],
+      get_value(base, lambda entry : entry["calls"]),
+      get_value(new, lambda entry : entry["calls"]),
+      get_value(base, mean), get_value(new, mean),
+      "-" if row["change"] is None else "%.2f" % row["change"],
+      get_value(base, lambda entry : get_percentile(entry, 50.0)),
+      get_value(new, lambda entry : get_percentile(entry, 50.0)),
+      get_value(base, lambda entry : get_percentile(entry, 99.0)),
+      get_value(new, lambda entry : get_percentile(entry, 99.0)),
+      "-" if row["ks"] is None else "%.4f" % row["ks"],
+      row["status"]]
+    output.write(",".join(value.rjust(length) for value, (title, length)
+                          in zip(values, header)) + "\n")
+
+def get_option(args, name, default):
+  if name in args:
+    i = args.index(name)
+    if i + 1 >= len(args):
+      raise ValueError("Value of " + name + " is missing")
+    value = args[i + 1]
+    del args[i:i + 2]
+    return value
+  return default
+
+def main():
+  args = sys.argv[1:]
+  try:
+    threshold = float(get_option(args, "--threshold", DEFAULT_THRESHOLD))
+    alpha = float(get_option(args, "--alpha", DEFAULT_ALPHA))
+  except ValueError as error:
+    print("[ERROR] " + str(error))
+    return 2
+  show_all = "--all" in args
+  args = [arg for arg in args if arg != "--all"]
+
+  if len(args) != 2 or alpha not in KS_COEFFICIENTS:
+    print("Usage: python table_diff.py [--threshold <percent>] " +
+      "[--alpha <" + "|".join(str(value) for value in
+      sorted(KS_COEFFICIENTS)) + ">] [--all] " +
+      "<base.tables.json> <new.tables.json>")
+    return 2
+
+  base_tables = read_tables(args[0])
+  new_tables = read_tables(args[1])
+
+  regression = False
+  for section, title, column in [("kernels", "Kernel Changes", "Kernel"),
+                                 ("functions", "API Changes", "Function")]:
+    rows = get_rows(base_tables, new_tables, section, threshold, alpha)
+    regression = regression or any(row["status"] == "SLOWER" for row in rows)
+    if not show_all:
+      rows = [row for row in rows if row["status"]]
+    write_table(title, column, rows, sys.stdout)
+
+  sys.stdout.write("\nA: " + args[0] + "\nB: " + args[1] + "\n")
+  sys.stdout.write("Threshold: " + str(threshold) + "%, alpha: " +
+    str(alpha) + ", " + ("regressions found" if regression else
+    "no regressions") + "\n")
+  return 1 if regression else 0
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,157 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_TABLE_STORE_H_
+#define PTI_TOOLS_UTILS_TABLE_STORE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "kernel_statistics.h"
+#include "latency_histogram.h"
+#include "pti_assert.h"
+#include "string_table.h"
+#include "utils.h"
+
+#define TABLE_STORE_SCHEMA "pti-tables"
+#define TABLE_STORE_VERSION 1
+
+// Kernel and API timing tables in a stable JSON schema, to be compared
+// between runs with table_diff.py:
+//   {"schema": "pti-tables", "version": 1, "tool": <name>, "pid": <pid>,
+//    "rank": <PMI_RANK or null>,
+//    "kernels": [<entry>, ...], "functions": [<entry>, ...]}
+// where each entry is
+//   {"backend": <"L0", "CL CPU" or "CL GPU">, "name": <name>,
+//    "calls": N, "total": ns, "min": ns, "max": ns,
+//    "histogram": [[lower, upper, count], ...]}
+// and histogram keeps non-empty LatencyHistogram buckets of the call
+// durations with values in [lower, upper). New fields may be added
+// within the version, existing ones are never changed
+class TableStore {
+ public: // Interface
+  explicit TableStore(const std::string& tool) : tool_(tool) {}
+
+  void AddKernels(const std::string& backend,
+                  const KernelInfoMap& info_map) {
+    for (auto& value : info_map) {
+      const KernelInfo& info = value.second;
+      kernel_list_.push_back(MakeEntry(
+          backend, StringTable::Get(value.first), info.call_count,
+          info.total_time, info.min_time, info.max_time,
+          info.time_histogram));
+    }
+  }
+
+  // Function info maps of the API collectors are keyed by the name
+  template <class FunctionInfoMap>
+  void AddFunctions(const std::string& backend,
+                    const FunctionInfoMap& info_map) {
+    for (auto& value : info_map) {
+      function_list_.push_back(MakeEntry(
+          backend, value.first, value.second.call_count,
+          value.second.total_time, value.second.min_time,
+          value.second.max_time, value.second.time_histogram));
+    }
+  }
+
+  bool IsEmpty() const {
+    return kernel_list_.empty() && function_list_.empty();
+  }
+
+  bool Write(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+      std::cerr << "[WARNING] Unable to create " << filename << std::endl;
+      return false;
+    }
+
+    std::string rank = utils::GetEnv("PMI_RANK");
+    file << "{\"schema\": \"" << TABLE_STORE_SCHEMA << "\", " <<
+      "\"version\": " << TABLE_STORE_VERSION << ", " <<
+      "\"tool\": \"" << Escape(tool_) << "\", " <<
+      "\"pid\": " << utils::GetPid() << ", " <<
+      "\"rank\": " << (rank.empty() ? "null" : rank) << ",\n";
+    WriteList("kernels", kernel_list_, file);
+    file << ",\n";
+    WriteList("functions", function_list_, file);
+    file << "\n}\n";
+    return true;
+  }
+
+  TableStore(const TableStore& copy) = delete;
+  TableStore& operator=(const TableStore& copy) = delete;
+
+ private: // Implementation
+  static std::string MakeEntry(
+      const std::string& backend, const std::string& name,
+      uint64_t call_count, uint64_t total_time, uint64_t min_time,
+      uint64_t max_time, const LatencyHistogram& histogram) {
+    std::stringstream stream;
+    stream << "{\"backend\": \"" << Escape(backend) << "\", " <<
+      "\"name\": \"" << Escape(name) << "\", " <<
+      "\"calls\": " << call_count << ", " <<
+      "\"total\": " << total_time << ", " <<
+      "\"min\": " << min_time << ", " <<
+      "\"max\": " << max_time << ", " <<
+      "\"histogram\": [";
+
+    bool first = true;
+    for (auto& bucket : histogram.GetBucketList()) {
+      uint64_t lower = 0, upper = 0;
+      LatencyHistogram::GetBucketBounds(bucket.first, &lower, &upper);
+      // The last bucket holds all the larger values
+      upper = (std::min)(upper, (std::max)(max_time, lower) + 1);
+      stream << (first ? "" : ", ") << "[" << lower << ", " << upper <<
+        ", " << bucket.second << "]";
+      first = false;
+    }
+
+    stream << "]}";
+    return stream.str();
+  }
+
+  static void WriteList(const char* title,
+                        const std::vector<std::string>& entry_list,
+                        std::ostream& stream) {
+    stream << "\"" << title << "\": [";
+    for (size_t i = 0; i < entry_list.size(); ++i) {
+      stream << (i == 0 ? "\n  " : ",\n  ") << entry_list[i];
+    }
+    stream << "]";
+  }
+
+  static std::string Escape(const std::string& str) {
+    std::string result;
+    for (char symbol : str) {
+      if (symbol == '"' || symbol == '\\') {
+        result += '\\';
+        result += symbol;
+      } else if (static_cast<unsigned char>(symbol) < 0x20) {
+        char code[8];
+        snprintf(code, sizeof(code), "\\u%04x", symbol);
+        result += code;
+      } else {
+        result += symbol;
+      }
+    }
+    return result;
+  }
+
+ private: // Data
+  std::string tool_;
+  std::vector<std::string> kernel_list_;
+  std::vector<std::string> function_list_;
+};
+
+#endif // PTI_TOOLS_UTILS_TABLE_STORE_H_
@@ -0,0 +1,331 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_TELEMETRY_SERVER_H_
+#define PTI_TOOLS_UTILS_TELEMETRY_SERVER_H_
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atomic_stat_table.h"
+#include "pti_assert.h"
+#include "utils.h"
+
+#define TELEMETRY_SCHEMA "pti-telemetry"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_DEFAULT_INTERVAL 1000 // ms
+#define TELEMETRY_POLL_TIMEOUT 100 // ms
+
+// Streams kernel, transfer and API aggregates to TCP subscribers. Every
+// interval the publishing thread takes a snapshot of the tables and sends
+// the difference from the previous one (count, total time and duration
+// histogram of each name that changed) as a single line of JSON. Counters
+// of one name are read one by one, so a histogram may lag its count by the
+// calls that finished during the read, the next delta makes it up. Slow
+// subscribers are disconnected instead of being buffered for
+class TelemetryServer {
+ public: // Interface
+  // Returns nullptr if the port can't be listened, zero port picks a free
+  // one, zero interval takes the default. The data is not authenticated,
+  // so only local subscribers are accepted unless another address is given
+  static TelemetryServer* Create(const std::string& tool, uint16_t port,
+                                 uint32_t interval,
+                                 const std::string& host = std::string()) {
+#if defined(_WIN32)
+    std::cerr << "[WARNING] Telemetry is not supported on Windows" <<
+      std::endl;
+    return nullptr;
+#else
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (!host.empty() &&
+        inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+      std::cerr << "[WARNING] Invalid telemetry address " << host <<
+        std::endl;
+      return nullptr;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      std::cerr << "[WARNING] Unable to create telemetry socket" <<
+        std::endl;
+      return nullptr;
+    }
+
+    int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    socklen_t size = sizeof(address);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&address),
+                    &size) != 0) {
+      std::cerr << "[WARNING] Unable to listen telemetry port " << port <<
+        std::endl;
+      close(fd);
+      return nullptr;
+    }
+
+    TelemetryServer* server = new TelemetryServer(
+        tool, fd, ntohs(address.sin_port),
+        (interval == 0) ? TELEMETRY_DEFAULT_INTERVAL : interval);
+    PTI_ASSERT(server != nullptr);
+    return server;
+#endif
+  }
+
+  // The last delta is sent to the subscribers before they are closed
+  ~TelemetryServer() {
+    stop_.store(true, std::memory_order_release);
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+#if !defined(_WIN32)
+    for (int client : client_list_) {
+      close(client);
+    }
+    close(fd_);
+#endif
+  }
+
+  // Memory transfers and the other non-kernel commands are told by the
+  // name of the API call that appended or enqueued them
+  void AddDeviceCommand(const std::string& name, uint64_t time) {
+    if (name.compare(0, 19, "zeCommandListAppend") == 0 ||
+        name.compare(0, 9, "clEnqueue") == 0) {
+      transfer_table_.Add(name, time);
+    } else {
+      kernel_table_.Add(name, time);
+    }
+  }
+
+  void AddFunction(const std::string& name, uint64_t time) {
+    function_table_.Add(name, time);
+  }
+
+  uint16_t GetPort() const {
+    return port_;
+  }
+
+  TelemetryServer(const TelemetryServer& copy) = delete;
+  TelemetryServer& operator=(const TelemetryServer& copy) = delete;
+
+ private: // Implementation
+  using SnapshotList = std::vector<AtomicStatTable::Snapshot>;
+
+  TelemetryServer(const std::string& tool, int fd, uint16_t port,
+                  uint32_t interval)
+      : tool_(tool), fd_(fd), port_(port), interval_(interval),
+        kernel_list_(ATOMIC_STAT_TABLE_SIZE),
+        transfer_list_(ATOMIC_STAT_TABLE_SIZE),
+        function_list_(ATOMIC_STAT_TABLE_SIZE) {
+    start_ = std::chrono::steady_clock::now();
+    thread_ = std::thread(&TelemetryServer::Run, this);
+  }
+
+  void Run() {
+#if !defined(_WIN32)
+    auto tick = start_ + std::chrono::milliseconds(interval_);
+    pollfd listener{fd_, POLLIN, 0};
+    while (!stop_.load(std::memory_order_acquire)) {
+      auto now = std::chrono::steady_clock::now();
+      if (now >= tick) {
+        Publish(now);
+        tick += std::chrono::milliseconds(interval_);
+        if (tick < now) {
+          tick = now + std::chrono::milliseconds(interval_);
+        }
+        continue;
+      }
+
+      int timeout = static_cast<int>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              tick - now).count());
+      listener.revents = 0;
+      if (poll(&listener, 1, (std::min)(timeout + 1,
+                                        TELEMETRY_POLL_TIMEOUT)) > 0) {
+        Accept();
+      }
+    }
+    Publish(std::chrono::steady_clock::now());
+#endif
+  }
+
+  void Accept() {
+#if !defined(_WIN32)
+    int client = accept(fd_, nullptr, nullptr);
+    if (client < 0) {
+      return;
+    }
+    fcntl(client, F_SETFL, fcntl(client, F_GETFL, 0) | O_NONBLOCK);
+
+    std::stringstream stream;
+    stream << "{\"schema\": \"" << TELEMETRY_SCHEMA << "\", " <<
+      "\"version\": " << TELEMETRY_VERSION << ", " <<
+      "\"tool\": \"" << tool_ << "\", " <<
+      "\"pid\": " << utils::GetPid() << ", " <<
+      "\"interval\": " << interval_ << "}\n";
+    if (Send(client, stream.str())) {
+      client_list_.push_back(client);
+    } else {
+      close(client);
+    }
+#endif
+  }
+
+  // Deltas are taken on every tick to keep the previous snapshot current,
+  // new subscribers get the intervals after they connected only
+  void Publish(std::chrono::steady_clock::time_point now) {
+    std::stringstream stream;
+    stream << "{\"time\": " <<
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          now - start_).count() << ", ";
+    bool changed = WriteDeltas("kernels", kernel_table_, &kernel_list_,
+                               stream);
+    stream << ", ";
+    changed = WriteDeltas("transfers", transfer_table_, &transfer_list_,
+                          stream) || changed;
+    stream << ", ";
+    changed = WriteDeltas("functions", function_table_, &function_list_,
+                          stream) || changed;
+
+    uint64_t dropped_count = kernel_table_.GetDroppedCount() +
+      transfer_table_.GetDroppedCount() + function_table_.GetDroppedCount();
+    stream << ", \"dropped\": " << dropped_count - dropped_count_ << "}\n";
+    changed = changed || dropped_count != dropped_count_;
+    dropped_count_ = dropped_count;
+
+    if (!changed || client_list_.empty()) {
+      return;
+    }
+
+    std::string message = stream.str();
+    std::vector<int> client_list;
+    for (int client : client_list_) {
+      if (Send(client, message)) {
+        client_list.push_back(client);
+      } else {
+#if !defined(_WIN32)
+        close(client);
+#endif
+      }
+    }
+    client_list_.swap(client_list);
+  }
+
+  static bool WriteDeltas(const char* title, const AtomicStatTable& table,
+                          SnapshotList* previous_list,
+                          std::ostream& stream) {
+    PTI_ASSERT(previous_list != nullptr);
+    PTI_ASSERT(previous_list->size() == ATOMIC_STAT_TABLE_SIZE);
+
+    bool first = true;
+    stream << "\"" << title << "\": [";
+    for (uint32_t i = 0; i < ATOMIC_STAT_TABLE_SIZE; ++i) {
+      AtomicStatTable::Snapshot current;
+      const std::string* name = table.Read(i, &current);
+      AtomicStatTable::Snapshot& previous = (*previous_list)[i];
+      if (name == nullptr || current.call_count == previous.call_count) {
+        continue;
+      }
+
+      stream << (first ? "" : ", ") << "{\"name\": \"" <<
+        Escape(*name) << "\", " <<
+        "\"calls\": " << current.call_count - previous.call_count << ", " <<
+        "\"total\": " << current.total_time - previous.total_time << ", " <<
+        "\"histogram\": [";
+      bool first_bucket = true;
+      for (uint32_t j = 0; j < ATOMIC_STAT_BUCKET_COUNT; ++j) {
+        uint64_t count = current.bucket_list[j] - previous.bucket_list[j];
+        if (count == 0) {
+          continue;
+        }
+        uint64_t lower = 0, upper = 0;
+        AtomicStatTable::GetBucketBounds(j, &lower, &upper);
+        stream << (first_bucket ? "" : ", ") << "[" << lower << ", " <<
+          upper << ", " << count << "]";
+        first_bucket = false;
+      }
+      stream << "]}";
+
+      previous = current;
+      first = false;
+    }
+    stream << "]";
+    return !first;
+  }
+
+  // Partial write means the subscriber does not keep up
+  static bool Send(int client, const std::string& data) {
+#if defined(_WIN32)
+    return false;
+#else
+    ssize_t size = send(client, data.data(), data.size(),
+                        MSG_NOSIGNAL | MSG_DONTWAIT);
+    return size == static_cast<ssize_t>(data.size());
+#endif
+  }
+
+  static std::string Escape(const std::string& str) {
+    std::string result;
+    for (char symbol : str) {
+      if (symbol == '"' || symbol == '\\') {
+        result += '\\';
+        result += symbol;
+      } else if (static_cast<unsigned char>(symbol) < 0x20) {
+        char code[8];
+        snprintf(code, sizeof(code), "\\u%04x", symbol);
+        result += code;
+      } else {
+        result += symbol;
+      }
+    }
+    return result;
+  }
+
+ private: // Data
+  std::string tool_;
+  int fd_ = -1;
+  uint16_t port_ = 0;
+  uint32_t interval_ = 0; // ms
+  std::chrono::steady_clock::time_point start_;
+
+  AtomicStatTable kernel_table_;
+  AtomicStatTable transfer_table_;
+  AtomicStatTable function_table_;
+
+  // Owned by the publishing thread
+  SnapshotList kernel_list_;
+  SnapshotList transfer_list_;
+  SnapshotList function_list_;
+  uint64_t dropped_count_ = 0;
+  std::vector<int> client_list_;
+
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+#endif // PTI_TOOLS_UTILS_TELEMETRY_SERVER_H_
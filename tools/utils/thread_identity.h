@@ -0,0 +1,109 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_THREAD_IDENTITY_H_
+#define PTI_TOOLS_UTILS_THREAD_IDENTITY_H_
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <string>
+
+#include "utils.h"
+
+// Identity of the calling thread, it is queried from the system once per
+// thread (and once again in the child process after fork), so that the
+// tracing callbacks do not pay for a system call each time
+class ThreadIdentity {
+ public:
+  static uint32_t GetPid() {
+    return Get().pid;
+  }
+
+  static uint32_t GetTid() {
+    return Get().tid;
+  }
+
+  // MPI rank taken from the process manager environment, -1 if not set
+  static int32_t GetRank() {
+    return Get().rank;
+  }
+
+  // Sequential number of the thread within the process starting from 0,
+  // e.g. to name thread tracks compactly
+  static uint32_t GetIndex() {
+    return Get().index;
+  }
+
+ private:
+  struct Identity {
+    uint64_t generation = 0;
+    uint32_t pid = 0;
+    uint32_t tid = 0;
+    uint32_t index = 0;
+    int32_t rank = -1;
+  };
+
+  static std::atomic<uint64_t>& GetGeneration() {
+    static std::atomic<uint64_t> generation{1};
+    return generation;
+  }
+
+  static std::atomic<uint32_t>& GetNextIndex() {
+    static std::atomic<uint32_t> next_index{0};
+    return next_index;
+  }
+
+  static const Identity& Get() {
+    thread_local Identity identity;
+    uint64_t generation = GetGeneration().load(std::memory_order_relaxed);
+    if (identity.generation != generation) {
+      Update(identity, generation);
+    }
+    return identity;
+  }
+
+  static void Update(Identity& identity, uint64_t generation) {
+    RegisterForkHandler();
+    identity.pid = utils::GetPid();
+    identity.tid = utils::GetTid();
+    identity.index = GetNextIndex().fetch_add(1, std::memory_order_relaxed);
+    identity.rank = GetRankFromEnv();
+    identity.generation = generation;
+  }
+
+  static int32_t GetRankFromEnv() {
+    std::string rank = utils::GetEnv("PMI_RANK");
+    if (rank.empty()) {
+      rank = utils::GetEnv("PMIX_RANK");
+    }
+    if (rank.empty()) {
+      return -1;
+    }
+    return static_cast<int32_t>(strtol(rank.c_str(), nullptr, 10));
+  }
+
+  // Child process gets a copy of the cached values of the forking
+  // thread, so all the cached identities are invalidated in it
+  static void RegisterForkHandler() {
+#if !defined(_WIN32)
+    static int status = pthread_atfork(nullptr, nullptr, OnFork);
+    (void)status;
+#endif
+  }
+
+  static void OnFork() {
+    GetNextIndex().store(0, std::memory_order_relaxed);
+    GetGeneration().fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+#endif // PTI_TOOLS_UTILS_THREAD_IDENTITY_H_
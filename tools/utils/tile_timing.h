@@ -0,0 +1,174 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_TILE_TIMING_H_
+#define PTI_TOOLS_UTILS_TILE_TIMING_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pti_assert.h"
+
+struct TileInterval {
+  uint64_t start;
+  uint64_t end;
+};
+
+struct TileKernelInfo {
+  uint64_t call_count = 0;
+  uint32_t tile_count = 0; // Most tiles a single launch ran on
+  uint64_t span_time = 0; // First tile start to last tile end
+  uint64_t busy_time = 0; // Summed over the tiles
+  uint64_t idle_time = 0; // Tiles waiting for the slowest one
+  uint64_t max_busy_time = 0; // Of the slowest tile of each launch
+};
+
+struct TileInfo {
+  uint64_t call_count = 0;
+  uint64_t busy_time = 0;
+};
+
+// Accounting of kernels split by implicit scaling over the tiles of a
+// root device, from the per-tile timestamps of each launch. A launch
+// takes as long as its slowest tile, the rest of the tiles are idle for
+// the remainder of the span, so the idle share of all the tile time is
+// the load imbalance. The class is not thread-safe, launches are expected
+// from a single thread
+class TileTiming {
+ public: // Interface
+  void AddLaunch(const std::string& name, uint32_t device,
+                 const std::vector<TileInterval>& tile_list) {
+    PTI_ASSERT(!name.empty());
+    PTI_ASSERT(!tile_list.empty());
+
+    uint64_t start = tile_list.front().start;
+    uint64_t end = tile_list.front().end;
+    uint64_t busy_time = 0, max_busy_time = 0;
+    for (size_t i = 0; i < tile_list.size(); ++i) {
+      const TileInterval& tile = tile_list[i];
+      PTI_ASSERT(tile.start <= tile.end);
+      start = (std::min)(start, tile.start);
+      end = (std::max)(end, tile.end);
+
+      uint64_t tile_time = tile.end - tile.start;
+      busy_time += tile_time;
+      max_busy_time = (std::max)(max_busy_time, tile_time);
+
+      PTI_ASSERT(i < (std::numeric_limits<uint32_t>::max)());
+      TileInfo& info = tile_map_[std::make_pair(
+          device, static_cast<uint32_t>(i))];
+      ++info.call_count;
+      info.busy_time += tile_time;
+    }
+
+    uint64_t span = end - start;
+    uint32_t tile_count = static_cast<uint32_t>(tile_list.size());
+    TileKernelInfo& info = kernel_map_[name];
+    ++info.call_count;
+    info.tile_count = (std::max)(info.tile_count, tile_count);
+    info.span_time += span;
+    info.busy_time += busy_time;
+    info.idle_time += span * tile_count - busy_time;
+    info.max_busy_time += max_busy_time;
+  }
+
+  bool IsEmpty() const {
+    return kernel_map_.empty();
+  }
+
+  void PrintTables(std::ostream& stream) const {
+    if (kernel_map_.empty()) {
+      return;
+    }
+
+    std::vector<std::pair<std::string, TileKernelInfo> > kernel_list(
+        kernel_map_.begin(), kernel_map_.end());
+    std::sort(kernel_list.begin(), kernel_list.end(),
+              [](const std::pair<std::string, TileKernelInfo>& left,
+                 const std::pair<std::string, TileKernelInfo>& right) {
+                return left.second.span_time > right.second.span_time;
+              });
+
+    size_t max_name_length = kKernelLength;
+    for (auto& value : kernel_list) {
+      if (value.first.size() > max_name_length) {
+        max_name_length = value.first.size();
+      }
+    }
+
+    stream << std::setw(max_name_length) << "Kernel" << "," <<
+      std::setw(kCountLength) << "Calls" << "," <<
+      std::setw(kCountLength) << "Tiles" << "," <<
+      std::setw(kTimeLength) << "Span (ns)" << "," <<
+      std::setw(kTimeLength) << "Tile Busy (ns)" << "," <<
+      std::setw(kTimeLength) << "Slowest Tile (ns)" << "," <<
+      std::setw(kTimeLength) << "Tile Idle (ns)" << "," <<
+      std::setw(kPercentLength) << "Imbalance (%)" << std::endl;
+
+    for (auto& value : kernel_list) {
+      const TileKernelInfo& info = value.second;
+      uint64_t tile_time = info.busy_time + info.idle_time;
+      float imbalance = (tile_time > 0) ?
+        100.0f * info.idle_time / tile_time : 0.0f;
+
+      stream << std::setw(max_name_length) << value.first << "," <<
+        std::setw(kCountLength) << info.call_count << "," <<
+        std::setw(kCountLength) << info.tile_count << "," <<
+        std::setw(kTimeLength) << info.span_time << "," <<
+        std::setw(kTimeLength) << info.busy_time << "," <<
+        std::setw(kTimeLength) << info.max_busy_time << "," <<
+        std::setw(kTimeLength) << info.idle_time << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << imbalance << std::endl;
+    }
+
+    // Share is the part of the busy time of all the tiles of the device
+    std::map<uint32_t, uint64_t> device_busy_map;
+    for (auto& value : tile_map_) {
+      device_busy_map[value.first.first] += value.second.busy_time;
+    }
+
+    stream << std::endl;
+    stream << std::setw(kCountLength) << "Device" << "," <<
+      std::setw(kCountLength) << "Tile" << "," <<
+      std::setw(kCountLength) << "Calls" << "," <<
+      std::setw(kTimeLength) << "Busy (ns)" << "," <<
+      std::setw(kPercentLength) << "Share (%)" << std::endl;
+
+    for (auto& value : tile_map_) {
+      const TileInfo& info = value.second;
+      uint64_t device_busy = device_busy_map[value.first.first];
+      float share = (device_busy > 0) ?
+        100.0f * info.busy_time / device_busy : 0.0f;
+
+      stream << std::setw(kCountLength) << value.first.first << "," <<
+        std::setw(kCountLength) << value.first.second << "," <<
+        std::setw(kCountLength) << info.call_count << "," <<
+        std::setw(kTimeLength) << info.busy_time << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << share << std::endl;
+    }
+  }
+
+ private: // Data
+  std::map<std::string, TileKernelInfo> kernel_map_;
+  std::map<std::pair<uint32_t, uint32_t>, TileInfo> tile_map_;
+
+  static const uint32_t kKernelLength = 6;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kPercentLength = 14;
+};
+
+#endif // PTI_TOOLS_UTILS_TILE_TIMING_H_
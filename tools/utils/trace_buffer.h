@@ -0,0 +1,79 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_TRACE_BUFFER_H_
+#define PTI_TOOLS_UTILS_TRACE_BUFFER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <type_traits>
+
+// Per-thread text buffer to format trace records: keeps its capacity
+// between records and converts integers to text without iostreams
+class TraceBuffer {
+ public: // Interface
+  // Returns empty buffer of the calling thread
+  static TraceBuffer& Get() {
+    thread_local TraceBuffer buffer;
+    buffer.Clear();
+    return buffer;
+  }
+
+  void Clear() {
+    data_.clear();
+  }
+
+  const std::string& GetText() const {
+    return data_;
+  }
+
+  TraceBuffer& operator<<(const char* text) {
+    data_.append(text);
+    return *this;
+  }
+
+  TraceBuffer& operator<<(const std::string& text) {
+    data_.append(text);
+    return *this;
+  }
+
+  TraceBuffer& operator<<(char symbol) {
+    data_.push_back(symbol);
+    return *this;
+  }
+
+  template <typename T, typename std::enable_if<
+      std::is_integral<T>::value && std::is_unsigned<T>::value,
+      int>::type = 0>
+  TraceBuffer& operator<<(T value) {
+    char digits[kMaxDigitCount];
+    char* end = digits + kMaxDigitCount;
+    char* begin = end;
+    do {
+      *(--begin) = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value != 0);
+    data_.append(begin, end - begin);
+    return *this;
+  }
+
+  TraceBuffer(const TraceBuffer& copy) = delete;
+  TraceBuffer& operator=(const TraceBuffer& copy) = delete;
+
+ private: // Implementation
+  TraceBuffer() {
+    data_.reserve(kInitialSize);
+  }
+
+ private: // Data
+  static const size_t kInitialSize = 4096;
+  static const size_t kMaxDigitCount = 20; // Enough for UINT64_MAX
+
+  std::string data_;
+};
+
+#endif // PTI_TOOLS_UTILS_TRACE_BUFFER_H_
@@ -10,6 +10,8 @@
 #include <sstream>
 #include <string>
 
+#include "capture_control.h"
+#include "logger.h"
 #include "pti_assert.h"
 #include "utils.h"
 
@@ -25,24 +27,203 @@
 #define TRACE_TID                    9
 #define TRACE_PID                    10
 #define TRACE_LOG_TO_FILE            11
+#define TRACE_ASYNC_LOGGING          12
+#define TRACE_BINARY_TRACE           13
+#define TRACE_PERFETTO_TRACE         14
+#define TRACE_RING_BUFFER            15
+#define TRACE_BATCH_TIMESTAMPS       16
+#define TRACE_ITT                    17
+#define TRACE_QUEUE_TIMING           18
+#define TRACE_CRITICAL_PATH          19
+#define TRACE_NODE_TRACE             20
+#define TRACE_SYSMAN_COUNTERS        21
+#define TRACE_OMP_DEVICE             22
+#define TRACE_SYCL                   23
+#define TRACE_TRANSFER_TIMING        24
+#define TRACE_MEMORY_TRACKING        25
+#define TRACE_ALLOC_CHURN            26
+#define TRACE_SAVE_TABLES            27
+#define TRACE_TELEMETRY              28
+#define TRACE_INTERVAL_STATS         29
+#define TRACE_SUBMISSION_SPANS       30
+#define TRACE_WAIT_ANALYSIS          31
+#define TRACE_KERNEL_ENERGY          32
+#define TRACE_COLLECTOR_API          33
+#define TRACE_OVERHEAD_BUDGET        34
+#define TRACE_TILE_TIMING            35
+#define TRACE_MODULE_DUMP            36
+#define TRACE_DEPENDENCY_GRAPH       37
+#define TRACE_CALL_STACKS            38
 
 const char* kChromeTraceFileExt = "json";
+const char* kBinaryTraceFileExt = "bin";
+const char* kPerfettoTraceFileExt = "pftrace";
+const char* kTablesFileExt = "tables.json";
+const char* kIntervalsFileExt = "intervals.csv";
 
 class TraceOptions {
  public:
-  TraceOptions(uint32_t flags, const std::string& log_file)
-      : flags_(flags), log_file_(log_file) {
+  TraceOptions(uint64_t flags, const std::string& log_file,
+               uint32_t log_buffer_size = 0,
+               uint32_t ring_buffer_size = 0,
+               uint32_t ring_buffer_trigger = 0,
+               uint32_t poll_interval = 0,
+               const std::string& include_api = std::string(),
+               const std::string& exclude_api = std::string(),
+               const std::string& kernel_sampling = std::string(),
+               const CaptureOptions& capture = CaptureOptions(),
+               uint32_t telemetry_port = 0,
+               uint32_t telemetry_interval = 0,
+               uint32_t stats_interval = 0,
+               const std::string& kernel_grouping = std::string(),
+               const std::string& compression = std::string(),
+               double overhead_budget = 0.0,
+               const std::string& module_dump_path = std::string(),
+               const std::string& telemetry_address = std::string())
+      : flags_(flags), log_file_(log_file),
+        log_buffer_size_(log_buffer_size),
+        ring_buffer_size_(ring_buffer_size),
+        ring_buffer_trigger_(ring_buffer_trigger),
+        poll_interval_(poll_interval),
+        include_api_(include_api),
+        exclude_api_(exclude_api),
+        kernel_sampling_(kernel_sampling),
+        capture_(capture),
+        telemetry_port_(telemetry_port),
+        telemetry_interval_(telemetry_interval),
+        stats_interval_(stats_interval),
+        kernel_grouping_(kernel_grouping),
+        compression_(compression),
+        overhead_budget_(overhead_budget),
+        module_dump_path_(module_dump_path),
+        telemetry_address_(telemetry_address) {
     if (CheckFlag(TRACE_LOG_TO_FILE)) {
       PTI_ASSERT(!log_file_.empty());
     }
-    if (flags_ == 0) {
-      flags_ |= (1 << TRACE_HOST_TIMING);
-      flags_ |= (1 << TRACE_DEVICE_TIMING);
+    if (CheckFlag(TRACE_RING_BUFFER)) {
+      PTI_ASSERT(ring_buffer_size_ > 0);
     }
+    if (CheckFlag(TRACE_INTERVAL_STATS)) {
+      PTI_ASSERT(stats_interval_ > 0);
+    }
+    if (CheckFlag(TRACE_OVERHEAD_BUDGET)) {
+      PTI_ASSERT(overhead_budget_ > 0.0 && overhead_budget_ < 100.0);
+    }
+    if (CheckFlag(TRACE_MODULE_DUMP)) {
+      PTI_ASSERT(!module_dump_path_.empty());
+    }
+    // Modifiers only, no tracing mode is selected
+    if ((flags_ & ~((1ull << TRACE_ASYNC_LOGGING) |
+                    (1ull << TRACE_BATCH_TIMESTAMPS) |
+                    (1ull << TRACE_ITT) |
+                    (1ull << TRACE_COLLECTOR_API) |
+                    (1ull << TRACE_OVERHEAD_BUDGET) |
+                    (1ull << TRACE_MODULE_DUMP) |
+                    (1ull << TRACE_OMP_DEVICE) |
+                    (1ull << TRACE_SYCL) |
+                    (1ull << TRACE_SAVE_TABLES) |
+                    (1ull << TRACE_TELEMETRY) |
+                    (1ull << TRACE_INTERVAL_STATS))) == 0) {
+      flags_ |= (1ull << TRACE_HOST_TIMING);
+      flags_ |= (1ull << TRACE_DEVICE_TIMING);
+    }
+  }
+
+  // Per-thread buffer size for asynchronous logging, in bytes
+  size_t GetLogBufferSize() const {
+    if (log_buffer_size_ == 0) {
+      return Logger::kDefaultBufferSize;
+    }
+    return static_cast<size_t>(log_buffer_size_) * 1024;
+  }
+
+  // Size of in-memory ring for flight recorder mode, in bytes
+  size_t GetRingBufferSize() const {
+    return static_cast<size_t>(ring_buffer_size_) * 1024 * 1024;
+  }
+
+  // Kernel duration that triggers ring buffer dump, in nanoseconds,
+  // zero if the trigger is disabled
+  uint64_t GetRingBufferTrigger() const {
+    return static_cast<uint64_t>(ring_buffer_trigger_) * 1000;
+  }
+
+  // Period of background readout of finished kernels, in microseconds,
+  // zero if kernels are read out at application sync points only
+  uint32_t GetPollInterval() const {
+    return poll_interval_;
+  }
+
+  // Comma-separated patterns of API functions to trace and to skip
+  const std::string& GetIncludeApi() const {
+    return include_api_;
+  }
+
+  const std::string& GetExcludeApi() const {
+    return exclude_api_;
+  }
+
+  // Period or rate of traced kernel launches, see KernelSampler,
+  // empty if all the launches are traced
+  const std::string& GetKernelSampling() const {
+    return kernel_sampling_;
+  }
+
+  // Conditions of the capture window, see CaptureControl
+  const CaptureOptions& GetCaptureOptions() const {
+    return capture_;
+  }
+
+  // TCP port to stream live aggregates to, zero picks a free one
+  uint16_t GetTelemetryPort() const {
+    return static_cast<uint16_t>(telemetry_port_);
+  }
+
+  // IPv4 address to listen for telemetry subscribers on, empty if only
+  // local ones are accepted
+  const std::string& GetTelemetryAddress() const {
+    return telemetry_address_;
+  }
+
+  // Period of live aggregate updates, in milliseconds, zero if the
+  // default period is used
+  uint32_t GetTelemetryInterval() const {
+    return telemetry_interval_;
+  }
+
+  // Length of a window of interval statistics, in seconds
+  uint32_t GetStatsInterval() const {
+    return stats_interval_;
+  }
+
+  // Launch config parts the kernel table rows are told by, see
+  // KernelStatistics::ParseGrouping, verbose mode takes the full config
+  // unless the grouping is given
+  std::string GetKernelGrouping() const {
+    if (!kernel_grouping_.empty()) {
+      return kernel_grouping_;
+    }
+    return CheckFlag(TRACE_DEVICE_TIMING_VERBOSE) ? "config" : "name";
+  }
+
+  // Method of log and timeline file compression, see StreamCompressor,
+  // empty if the files are written as is
+  const std::string& GetCompression() const {
+    return compression_;
+  }
+
+  // Share of wall time the tool may spend on itself, see OverheadGovernor
+  double GetOverheadBudget() const {
+    return overhead_budget_ / 100.0;
+  }
+
+  // Directory the module binaries are dumped to, see ZeModuleCollector
+  const std::string& GetModuleDumpPath() const {
+    return module_dump_path_;
   }
 
   bool CheckFlag(uint32_t flag) const {
-    return (flags_ & (1 << flag));
+    return (flags_ & (1ull << flag));
   }
 
   std::string GetLogFileName() const {
@@ -76,23 +257,59 @@ class TraceOptions {
   }
 
   static std::string GetChromeTraceFileName(const char* filename) {
+    return GetTraceFileName(filename, kChromeTraceFileExt);
+  }
+
+  static std::string GetBinaryTraceFileName(const char* filename) {
+    return GetTraceFileName(filename, kBinaryTraceFileExt);
+  }
+
+  static std::string GetPerfettoTraceFileName(const char* filename) {
+    return GetTraceFileName(filename, kPerfettoTraceFileExt);
+  }
+
+  static std::string GetTablesFileName(const char* filename) {
+    return GetTraceFileName(filename, kTablesFileExt);
+  }
+
+  static std::string GetIntervalsFileName(const char* filename) {
+    return GetTraceFileName(filename, kIntervalsFileExt);
+  }
+
+ private:
+  static std::string GetTraceFileName(const char* filename, const char* ext) {
     std::string rank = utils::GetEnv("PMI_RANK");
     if (!rank.empty()) {
       return
         std::string(filename) +
         "." + std::to_string(utils::GetPid()) +
         "." + rank +
-        "." + kChromeTraceFileExt;
+        "." + ext;
     }
     return
         std::string(filename) +
         "." + std::to_string(utils::GetPid()) +
-        "." + kChromeTraceFileExt;
+        "." + ext;
   }
 
- private:
-  uint32_t flags_;
+  uint64_t flags_;
   std::string log_file_;
+  uint32_t log_buffer_size_; // KB
+  uint32_t ring_buffer_size_; // MB
+  uint32_t ring_buffer_trigger_; // us
+  uint32_t poll_interval_; // us
+  std::string include_api_;
+  std::string exclude_api_;
+  std::string kernel_sampling_;
+  CaptureOptions capture_;
+  uint32_t telemetry_port_;
+  uint32_t telemetry_interval_; // ms
+  uint32_t stats_interval_; // s
+  std::string kernel_grouping_;
+  std::string compression_;
+  double overhead_budget_; // %
+  std::string module_dump_path_;
+  std::string telemetry_address_;
 };
 
 #endif // PTI_TOOLS_UTILS_TRACE_OPTIONS_H_
\ No newline at end of file
@@ -0,0 +1,444 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_TRACE_SINK_H_
+#define PTI_TOOLS_UTILS_TRACE_SINK_H_
+
+#include <stdint.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "binary_trace.h"
+#include "collector_api.h"
+#include "correlator.h"
+#include "interval_statistics.h"
+#include "logger.h"
+#include "perfetto_trace.h"
+#include "pti_assert.h"
+#include "telemetry_server.h"
+#include "thread_identity.h"
+#include "trace_buffer.h"
+#include "utils.h"
+#include "wait_analysis.h"
+
+// Completed device command, Id is std::string for L0 ("<kernel>.<call>")
+// and uint64_t for OpenCL. The record only refers to the data of the
+// collector callback and is valid during the call
+template <typename Id>
+struct DeviceRecord {
+  void* queue;
+  const Id& id;
+  const std::string& name;
+  uint64_t queued; // Appended for L0, ns
+  uint64_t submitted; // ns
+  uint64_t started; // ns
+  uint64_t ended; // ns
+};
+
+// Completed API call of the given thread
+template <typename Id>
+struct HostRecord {
+  uint32_t tid;
+  const Id& id;
+  const std::string& name;
+  uint64_t started; // ns
+  uint64_t ended; // ns
+};
+
+// Output of the tracer: takes each record once and formats, buffers or
+// aggregates it in its own way. Sinks are called from the application and
+// collector threads at the same time and have to be thread-safe
+template <typename Id>
+class TraceSink {
+ public: // Interface
+  virtual ~TraceSink() {}
+  virtual void AddDeviceRecord(const DeviceRecord<Id>& record) {}
+  virtual void AddHostRecord(const HostRecord<Id>& record) {}
+};
+
+// Set of sinks enabled by the tracer options. Records are passed to each
+// of them in the order of addition. If there is only one sink of a kind
+// (the usual case), its type is kept in the dispatch function, so the call
+// is direct and inlined instead of going through the sink list
+template <typename Id>
+class TraceSinkPipeline {
+ public: // Interface
+  TraceSinkPipeline() = default;
+
+  ~TraceSinkPipeline() {
+    for (TraceSink<Id>* sink : sink_list_) {
+      delete sink;
+    }
+  }
+
+  // Pipeline takes the ownership of the sink, which gets device commands,
+  // host calls or both
+  template <typename Sink>
+  void AddSink(Sink* sink, bool device, bool host) {
+    PTI_ASSERT(sink != nullptr);
+    PTI_ASSERT(device || host);
+    sink_list_.push_back(sink);
+
+    if (device) {
+      device_sink_list_.push_back(sink);
+      device_dispatch_ = (device_sink_list_.size() == 1) ?
+        DispatchDeviceRecord<Sink> : DispatchDeviceRecords;
+    }
+    if (host) {
+      host_sink_list_.push_back(sink);
+      host_dispatch_ = (host_sink_list_.size() == 1) ?
+        DispatchHostRecord<Sink> : DispatchHostRecords;
+    }
+  }
+
+  bool HasDeviceSinks() const {
+    return !device_sink_list_.empty();
+  }
+
+  bool HasHostSinks() const {
+    return !host_sink_list_.empty();
+  }
+
+  void AddDeviceRecord(const DeviceRecord<Id>& record) const {
+    PTI_ASSERT(device_dispatch_ != nullptr);
+    device_dispatch_(this, record);
+  }
+
+  void AddHostRecord(const HostRecord<Id>& record) const {
+    PTI_ASSERT(host_dispatch_ != nullptr);
+    host_dispatch_(this, record);
+  }
+
+  TraceSinkPipeline(const TraceSinkPipeline& copy) = delete;
+  TraceSinkPipeline& operator=(const TraceSinkPipeline& copy) = delete;
+
+ private: // Implementation
+  using DeviceDispatch =
+    void (*)(const TraceSinkPipeline*, const DeviceRecord<Id>&);
+  using HostDispatch =
+    void (*)(const TraceSinkPipeline*, const HostRecord<Id>&);
+
+  template <typename Sink>
+  static void DispatchDeviceRecord(
+      const TraceSinkPipeline* pipeline, const DeviceRecord<Id>& record) {
+    Sink* sink = static_cast<Sink*>(pipeline->device_sink_list_.front());
+    sink->Sink::AddDeviceRecord(record);
+  }
+
+  static void DispatchDeviceRecords(
+      const TraceSinkPipeline* pipeline, const DeviceRecord<Id>& record) {
+    for (TraceSink<Id>* sink : pipeline->device_sink_list_) {
+      sink->AddDeviceRecord(record);
+    }
+  }
+
+  template <typename Sink>
+  static void DispatchHostRecord(
+      const TraceSinkPipeline* pipeline, const HostRecord<Id>& record) {
+    Sink* sink = static_cast<Sink*>(pipeline->host_sink_list_.front());
+    sink->Sink::AddHostRecord(record);
+  }
+
+  static void DispatchHostRecords(
+      const TraceSinkPipeline* pipeline, const HostRecord<Id>& record) {
+    for (TraceSink<Id>* sink : pipeline->host_sink_list_) {
+      sink->AddHostRecord(record);
+    }
+  }
+
+ private: // Data
+  std::vector<TraceSink<Id>*> sink_list_;
+  std::vector<TraceSink<Id>*> device_sink_list_;
+  std::vector<TraceSink<Id>*> host_sink_list_;
+  DeviceDispatch device_dispatch_ = nullptr;
+  HostDispatch host_dispatch_ = nullptr;
+};
+
+// Host thread tracks are named by the compact thread index, metadata
+// goes into the trace right before the first event of the thread
+inline void AddChromeThreadName(TraceBuffer& buffer) {
+  thread_local bool named = false;
+  if (named) {
+    return;
+  }
+  buffer << "{\"ph\":\"M\", \"name\":\"thread_name\", \"pid\":\"" <<
+    ThreadIdentity::GetPid() << "\", \"tid\":\"" <<
+    ThreadIdentity::GetTid() << "\", \"args\":{\"name\":\"Thread " <<
+    ThreadIdentity::GetIndex() << "\"}},\n";
+  buffer << "{\"ph\":\"M\", \"name\":\"thread_sort_index\", " <<
+    "\"pid\":\"" << ThreadIdentity::GetPid() << "\", \"tid\":\"" <<
+    ThreadIdentity::GetTid() << "\", \"args\":{\"sort_index\":" <<
+    ThreadIdentity::GetIndex() << "}},\n";
+  named = true;
+}
+
+// Text device timeline of the tool log, the first timestamp is labeled
+// as "append" for L0 and "queued" for OpenCL
+template <typename Id>
+class DeviceTimelineSink final : public TraceSink<Id> {
+ public: // Interface
+  DeviceTimelineSink(Correlator* correlator, const char* queued_label,
+                     bool show_id, bool show_pid)
+      : correlator_(correlator), queued_label_(queued_label),
+        show_id_(show_id), show_pid_(show_pid) {
+    PTI_ASSERT(correlator_ != nullptr);
+    PTI_ASSERT(queued_label_ != nullptr);
+  }
+
+  void AddDeviceRecord(const DeviceRecord<Id>& record) override {
+    std::stringstream stream;
+    if (show_pid_) {
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
+    }
+    stream << "Device Timeline (queue: " << record.queue <<
+      "): " << record.name;
+    if (show_id_) {
+      stream << "(" << record.id << ")";
+    }
+    stream << " [ns] = " <<
+      record.queued << " (" << queued_label_ << ") " <<
+      record.submitted << " (submit) " <<
+      record.started << " (start) " <<
+      record.ended << " (end)" << std::endl;
+    correlator_->Log(stream.str());
+  }
+
+ private: // Data
+  Correlator* correlator_ = nullptr;
+  const char* queued_label_ = nullptr;
+  bool show_id_ = false;
+  bool show_pid_ = false;
+};
+
+// Device commands of the Chrome trace. Tracks are either queues or kernel
+// names, in stage mode each command is split into the queued, submitted
+// and execution parts that go to the "<id>.<queue>" track or the kernel
+// one
+template <typename Id>
+class ChromeDeviceSink final : public TraceSink<Id> {
+ public: // Interface
+  ChromeDeviceSink(Logger* logger, const char* queued_stage,
+                   bool kernel_tracks, bool stages)
+      : logger_(logger), queued_stage_(queued_stage),
+        kernel_tracks_(kernel_tracks), stages_(stages) {
+    PTI_ASSERT(logger_ != nullptr);
+    PTI_ASSERT(queued_stage_ != nullptr);
+  }
+
+  void AddDeviceRecord(const DeviceRecord<Id>& record) override {
+    if (stages_) {
+      AddStages(record);
+      return;
+    }
+
+    TraceBuffer& buffer = TraceBuffer::Get();
+    buffer << "{\"ph\":\"X\", \"pid\":\"" << ThreadIdentity::GetPid() <<
+      "\", \"tid\":\"";
+    if (kernel_tracks_) {
+      buffer << record.name;
+    } else {
+      buffer << reinterpret_cast<uint64_t>(record.queue);
+    }
+    buffer << "\", \"name\":\"" << record.name <<
+      "\", \"ts\": " << record.started / NSEC_IN_USEC <<
+      ", \"dur\":" << (record.ended - record.started) / NSEC_IN_USEC <<
+      ", \"args\": {\"id\": \"" << record.id << "\"}"
+      "},\n";
+    logger_->Log(buffer.GetText());
+  }
+
+ private: // Implementation
+  void AddStages(const DeviceRecord<Id>& record) {
+    PTI_ASSERT(record.submitted > record.queued);
+    AddStage(record, queued_stage_, record.queued, record.submitted,
+             "thread_state_runnable");
+    PTI_ASSERT(record.started > record.submitted);
+    AddStage(record, "Submitted", record.submitted, record.started,
+             "cq_build_running");
+    PTI_ASSERT(record.ended > record.started);
+    AddStage(record, "Execution", record.started, record.ended,
+             "thread_state_iowait");
+  }
+
+  void AddStage(const DeviceRecord<Id>& record, const char* stage,
+                uint64_t started, uint64_t ended, const char* color) {
+    TraceBuffer& buffer = TraceBuffer::Get();
+    buffer << "{\"ph\":\"X\", \"pid\":\"" << ThreadIdentity::GetPid() <<
+      "\", \"tid\":\"";
+    if (kernel_tracks_) {
+      buffer << record.name;
+    } else {
+      buffer << record.id << '.' << reinterpret_cast<uint64_t>(record.queue);
+    }
+    buffer << "\", \"name\":\"" << record.name << " (" << stage << ")" <<
+      "\", \"ts\": " << started / NSEC_IN_USEC <<
+      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
+      ", \"cname\":\"" << color << "\"" <<
+      ", \"args\": {\"id\": \"" << record.id << "\"}"
+      "},\n";
+    logger_->Log(buffer.GetText());
+  }
+
+ private: // Data
+  Logger* logger_ = nullptr;
+  const char* queued_stage_ = nullptr;
+  bool kernel_tracks_ = false;
+  bool stages_ = false;
+};
+
+// API calls of the Chrome trace, one track per host thread
+template <typename Id>
+class ChromeHostSink final : public TraceSink<Id> {
+ public: // Interface
+  explicit ChromeHostSink(Logger* logger) : logger_(logger) {
+    PTI_ASSERT(logger_ != nullptr);
+  }
+
+  void AddHostRecord(const HostRecord<Id>& record) override {
+    TraceBuffer& buffer = TraceBuffer::Get();
+    AddChromeThreadName(buffer);
+    buffer << "{\"ph\":\"X\", \"pid\":\"" <<
+      ThreadIdentity::GetPid() << "\", \"tid\":\"" <<
+      record.tid << "\", \"name\":\"" << record.name <<
+      "\", \"ts\": " << record.started / NSEC_IN_USEC <<
+      ", \"dur\":" << (record.ended - record.started) / NSEC_IN_USEC <<
+      ", \"args\": {\"id\": \"" << record.id << "\"}"
+      "},\n";
+    logger_->Log(buffer.GetText());
+  }
+
+ private: // Data
+  Logger* logger_ = nullptr;
+};
+
+template <typename Id>
+class BinaryTraceSink final : public TraceSink<Id> {
+ public: // Interface
+  explicit BinaryTraceSink(BinaryTraceWriter* writer) : writer_(writer) {
+    PTI_ASSERT(writer_ != nullptr);
+  }
+
+  void AddDeviceRecord(const DeviceRecord<Id>& record) override {
+    writer_->WriteDeviceRecord(
+        record.queue, record.id, record.name, record.queued,
+        record.submitted, record.started, record.ended);
+  }
+
+  void AddHostRecord(const HostRecord<Id>& record) override {
+    writer_->WriteHostRecord(
+        record.tid, record.id, record.name, record.started, record.ended);
+  }
+
+ private: // Data
+  BinaryTraceWriter* writer_ = nullptr;
+};
+
+template <typename Id>
+class PerfettoTraceSink final : public TraceSink<Id> {
+ public: // Interface
+  explicit PerfettoTraceSink(PerfettoTraceWriter* writer) : writer_(writer) {
+    PTI_ASSERT(writer_ != nullptr);
+  }
+
+  void AddDeviceRecord(const DeviceRecord<Id>& record) override {
+    writer_->WriteDeviceEvent(
+        record.queue, record.id, record.name, record.started, record.ended);
+  }
+
+  void AddHostRecord(const HostRecord<Id>& record) override {
+    writer_->WriteHostEvent(
+        record.tid, record.id, record.name, record.started, record.ended);
+  }
+
+ private: // Data
+  PerfettoTraceWriter* writer_ = nullptr;
+};
+
+// Per-window aggregation into the interval statistics file
+template <typename Id>
+class IntervalStatisticsSink final : public TraceSink<Id> {
+ public: // Interface
+  explicit IntervalStatisticsSink(IntervalStatistics* statistics)
+      : statistics_(statistics) {
+    PTI_ASSERT(statistics_ != nullptr);
+  }
+
+  void AddDeviceRecord(const DeviceRecord<Id>& record) override {
+    statistics_->AddKernel(record.name, record.ended - record.started);
+  }
+
+  void AddHostRecord(const HostRecord<Id>& record) override {
+    statistics_->AddFunction(record.name, record.ended - record.started);
+  }
+
+ private: // Data
+  IntervalStatistics* statistics_ = nullptr;
+};
+
+// Live stream of aggregates to the telemetry subscribers
+template <typename Id>
+class TelemetrySink final : public TraceSink<Id> {
+ public: // Interface
+  explicit TelemetrySink(TelemetryServer* server) : server_(server) {
+    PTI_ASSERT(server_ != nullptr);
+  }
+
+  void AddDeviceRecord(const DeviceRecord<Id>& record) override {
+    server_->AddDeviceCommand(record.name, record.ended - record.started);
+  }
+
+  void AddHostRecord(const HostRecord<Id>& record) override {
+    server_->AddFunction(record.name, record.ended - record.started);
+  }
+
+ private: // Data
+  TelemetryServer* server_ = nullptr;
+};
+
+// Aggregates the application reads through the collector API
+template <typename Id>
+class CollectorApiSink final : public TraceSink<Id> {
+ public: // Interface
+  explicit CollectorApiSink(CollectorApi* api) : api_(api) {
+    PTI_ASSERT(api_ != nullptr);
+  }
+
+  void AddDeviceRecord(const DeviceRecord<Id>& record) override {
+    api_->AddKernel(record.name, record.ended - record.started);
+  }
+
+  void AddHostRecord(const HostRecord<Id>& record) override {
+    api_->AddFunction(record.name, record.ended - record.started);
+  }
+
+ private: // Data
+  CollectorApi* api_ = nullptr;
+};
+
+// Synchronization calls and the device commands they may wait for
+template <typename Id>
+class WaitAnalysisSink final : public TraceSink<Id> {
+ public: // Interface
+  explicit WaitAnalysisSink(WaitAnalysis* analysis) : analysis_(analysis) {
+    PTI_ASSERT(analysis_ != nullptr);
+  }
+
+  void AddDeviceRecord(const DeviceRecord<Id>& record) override {
+    analysis_->AddCommand(record.name, record.started, record.ended);
+  }
+
+  void AddHostRecord(const HostRecord<Id>& record) override {
+    analysis_->AddWait(
+        record.tid, record.name, record.started, record.ended);
+  }
+
+ private: // Data
+  WaitAnalysis* analysis_ = nullptr;
+};
+
+#endif // PTI_TOOLS_UTILS_TRACE_SINK_H_
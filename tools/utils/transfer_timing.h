@@ -0,0 +1,246 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_TRANSFER_TIMING_H_
+#define PTI_TOOLS_UTILS_TRANSFER_TIMING_H_
+
+#include <stdint.h>
+
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "latency_histogram.h"
+#include "pti_assert.h"
+
+#define TRANSFER_TIMING_SMALL_SIZE   65536 // bytes
+#define TRANSFER_TIMING_BATCH_COUNT  16
+#define TRANSFER_TIMING_BATCH_SHARE  25.0f // % of transfer time
+
+enum TransferMemoryType {
+  TRANSFER_MEMORY_UNKNOWN = 0, // Not a transfer or not classified
+  TRANSFER_MEMORY_HOST,        // Pinned host allocation
+  TRANSFER_MEMORY_SYSTEM,      // Pageable memory not known to the runtime
+  TRANSFER_MEMORY_DEVICE,
+  TRANSFER_MEMORY_SHARED
+};
+
+struct TransferTimingInfo {
+  uint64_t transfer_count = 0;
+  uint64_t pageable_count = 0; // Host side is pageable system memory
+  uint64_t total_bytes = 0;
+  uint64_t total_time = 0;
+  uint64_t min_bandwidth = 0; // MB/s
+  uint64_t max_bandwidth = 0;
+  LatencyHistogram bandwidth_histogram; // MB/s, not ns
+  uint64_t small_count = 0;
+  uint64_t small_bytes = 0;
+  uint64_t small_time = 0;
+};
+
+// Achieved bandwidth of memory transfers by direction (H2D, D2H, D2D and
+// the ones with shared memory) overall and per engine, the engine is any
+// label the backend gives (as for QueueTiming). Transfers below
+// TRANSFER_TIMING_SMALL_SIZE are counted apart, and the directions that
+// spend a large share of their time in many small transfers are listed
+// as batching candidates. The class is not thread-safe, transfers are
+// expected from a single thread
+class TransferTiming {
+ public: // Interface
+  void AddTransfer(const std::string& engine,
+                   TransferMemoryType src_type, TransferMemoryType dst_type,
+                   uint64_t bytes, uint64_t time) {
+    if (bytes == 0 || src_type == TRANSFER_MEMORY_UNKNOWN ||
+        dst_type == TRANSFER_MEMORY_UNKNOWN) {
+      return;
+    }
+
+    std::string direction = GetDirection(src_type, dst_type);
+    bool pageable = (src_type == TRANSFER_MEMORY_SYSTEM ||
+                     dst_type == TRANSFER_MEMORY_SYSTEM);
+    Add(direction_map_[direction], bytes, time, pageable);
+    Add(engine_map_[std::make_pair(engine, direction)],
+        bytes, time, pageable);
+  }
+
+  bool IsEmpty() const {
+    return direction_map_.empty();
+  }
+
+  void PrintTables(std::ostream& stream) const {
+    if (direction_map_.empty()) {
+      return;
+    }
+
+    size_t max_engine_length = kEngineLength;
+    for (auto& value : engine_map_) {
+      if (value.first.first.size() > max_engine_length) {
+        max_engine_length = value.first.first.size();
+      }
+    }
+
+    PrintHeader(stream, kDirectionLength, "Direction");
+    for (auto& value : direction_map_) {
+      stream << std::setw(kDirectionLength) << value.first << ",";
+      PrintRow(stream, value.second);
+    }
+
+    stream << std::endl;
+    stream << std::setw(max_engine_length) << "Engine" << ",";
+    PrintHeader(stream, kDirectionLength, "Direction");
+    for (auto& value : engine_map_) {
+      stream << std::setw(max_engine_length) << value.first.first << "," <<
+        std::setw(kDirectionLength) << value.first.second << ",";
+      PrintRow(stream, value.second);
+    }
+
+    bool title = false;
+    for (auto& value : engine_map_) {
+      const TransferTimingInfo& info = value.second;
+      if (info.small_count < TRANSFER_TIMING_BATCH_COUNT ||
+          info.total_time == 0) {
+        continue;
+      }
+      float share = 100.0f * info.small_time / info.total_time;
+      if (share < TRANSFER_TIMING_BATCH_SHARE) {
+        continue;
+      }
+
+      if (!title) {
+        stream << std::endl;
+        stream << "Batching candidates (transfers under " <<
+          TRANSFER_TIMING_SMALL_SIZE << " bytes):" << std::endl;
+        title = true;
+      }
+      stream << "  " << value.first.second << " on " << value.first.first <<
+        ": " << info.small_count << " transfers of " <<
+        info.small_bytes / info.small_count << " bytes on average take " <<
+        std::setprecision(2) << std::fixed << share <<
+        "% of transfer time at " <<
+        GetBandwidth(info.small_bytes, info.small_time) << " GB/s vs " <<
+        GetBandwidth(info.total_bytes, info.total_time) << " GB/s overall" <<
+        std::endl;
+    }
+  }
+
+ private: // Implementation
+  static char GetTypeLetter(TransferMemoryType type) {
+    switch (type) {
+      case TRANSFER_MEMORY_HOST:
+      case TRANSFER_MEMORY_SYSTEM:
+        return 'H';
+      case TRANSFER_MEMORY_DEVICE:
+        return 'D';
+      case TRANSFER_MEMORY_SHARED:
+        return 'S';
+      default:
+        break;
+    }
+    return '?';
+  }
+
+  static std::string GetDirection(
+      TransferMemoryType src_type, TransferMemoryType dst_type) {
+    std::string direction;
+    direction += GetTypeLetter(src_type);
+    direction += "2";
+    direction += GetTypeLetter(dst_type);
+    return direction;
+  }
+
+  // Bytes per ns are GB/s
+  static double GetBandwidth(uint64_t bytes, uint64_t time) {
+    return (time > 0) ? static_cast<double>(bytes) / time : 0.0;
+  }
+
+  static void Add(TransferTimingInfo& info, uint64_t bytes,
+                  uint64_t time, bool pageable) {
+    uint64_t bandwidth = static_cast<uint64_t>(
+        GetBandwidth(bytes, time) * 1000.0);
+    if (info.transfer_count == 0) {
+      info.min_bandwidth = bandwidth;
+      info.max_bandwidth = bandwidth;
+    }
+    ++info.transfer_count;
+    if (pageable) {
+      ++info.pageable_count;
+    }
+    info.total_bytes += bytes;
+    info.total_time += time;
+    if (bandwidth < info.min_bandwidth) {
+      info.min_bandwidth = bandwidth;
+    }
+    if (bandwidth > info.max_bandwidth) {
+      info.max_bandwidth = bandwidth;
+    }
+    info.bandwidth_histogram.Add(bandwidth);
+
+    if (bytes < TRANSFER_TIMING_SMALL_SIZE) {
+      ++info.small_count;
+      info.small_bytes += bytes;
+      info.small_time += time;
+    }
+  }
+
+  static void PrintHeader(
+      std::ostream& stream, size_t length, const char* title) {
+    stream << std::setw(length) << title << "," <<
+      std::setw(kCountLength) << "Transfers" << "," <<
+      std::setw(kCountLength) << "Pageable" << "," <<
+      std::setw(kBytesLength) << "Bytes" << "," <<
+      std::setw(kTimeLength) << "Time (ns)" << "," <<
+      std::setw(kBandwidthLength) << "Avg (GB/s)" << "," <<
+      std::setw(kBandwidthLength) << "Min (GB/s)" << "," <<
+      std::setw(kBandwidthLength) << "P10 (GB/s)" << "," <<
+      std::setw(kBandwidthLength) << "P50 (GB/s)" << "," <<
+      std::setw(kBandwidthLength) << "P90 (GB/s)" << "," <<
+      std::setw(kBandwidthLength) << "Max (GB/s)" << "," <<
+      std::setw(kCountLength) << "Small" << "," <<
+      std::setw(kPercentLength) << "Small (%)" << std::endl;
+  }
+
+  static void PrintRow(std::ostream& stream, const TransferTimingInfo& info) {
+    PTI_ASSERT(info.transfer_count > 0);
+    float small_share = (info.total_time > 0) ?
+      100.0f * info.small_time / info.total_time : 0.0f;
+    stream << std::setw(kCountLength) << info.transfer_count << "," <<
+      std::setw(kCountLength) << info.pageable_count << "," <<
+      std::setw(kBytesLength) << info.total_bytes << "," <<
+      std::setw(kTimeLength) << info.total_time << "," <<
+      std::setprecision(2) << std::fixed <<
+      std::setw(kBandwidthLength) <<
+        GetBandwidth(info.total_bytes, info.total_time) << "," <<
+      std::setw(kBandwidthLength) << info.min_bandwidth / 1000.0 << "," <<
+      std::setw(kBandwidthLength) << GetPercentile(info, 10.0) << "," <<
+      std::setw(kBandwidthLength) << GetPercentile(info, 50.0) << "," <<
+      std::setw(kBandwidthLength) << GetPercentile(info, 90.0) << "," <<
+      std::setw(kBandwidthLength) << info.max_bandwidth / 1000.0 << "," <<
+      std::setw(kCountLength) << info.small_count << "," <<
+      std::setw(kPercentLength) << small_share << std::endl;
+  }
+
+  static double GetPercentile(const TransferTimingInfo& info, double percent) {
+    return info.bandwidth_histogram.GetPercentile(
+        percent, info.min_bandwidth, info.max_bandwidth) / 1000.0;
+  }
+
+ private: // Data
+  std::map<std::string, TransferTimingInfo> direction_map_;
+  std::map<std::pair<std::string, std::string>, TransferTimingInfo>
+    engine_map_;
+
+  static const uint32_t kDirectionLength = 10;
+  static const uint32_t kEngineLength = 6;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kBytesLength = 20;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kBandwidthLength = 12;
+  static const uint32_t kPercentLength = 10;
+};
+
+#endif // PTI_TOOLS_UTILS_TRANSFER_TIMING_H_
\ No newline at end of file
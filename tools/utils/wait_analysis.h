@@ -0,0 +1,276 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_WAIT_ANALYSIS_H_
+#define PTI_TOOLS_UTILS_WAIT_ANALYSIS_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "kernel_interval_store.h"
+#include "pti_assert.h"
+#include "string_table.h"
+
+#define WAIT_ANALYSIS_MAX_COMMANDS 20 // Commands listed in the report
+
+// Splits the time of each host synchronization call into the part spent
+// blocked on the device and the driver overhead. All the device commands
+// are kept in a compact store, at report time each wait is matched with
+// the commands that ran during it: the host is blocked from the start of
+// the wait until the last of them completes, the rest of the call is
+// overhead (waking up, event and fence handling), and the whole blocked
+// time goes to that last command. A wait that overlaps no command found
+// the work done already. Thread-safe
+class WaitAnalysis {
+ public: // Interface
+  static bool IsWaitFunction(const std::string& name) {
+    return GetFunctionIndex(name) < kFunctionCount;
+  }
+
+  // Calls of other functions are ignored
+  void AddWait(uint32_t tid, const std::string& name,
+               uint64_t started, uint64_t ended) {
+    uint32_t function = GetFunctionIndex(name);
+    if (function == kFunctionCount) {
+      return;
+    }
+    PTI_ASSERT(started <= ended);
+    const std::lock_guard<std::mutex> lock(lock_);
+    // Calls of a thread go one after another, so waits of each thread
+    // never overlap and come sorted by time
+    wait_map_[tid].push_back({started, ended, function});
+  }
+
+  void AddCommand(const std::string& name, uint64_t started, uint64_t ended) {
+    PTI_ASSERT(started <= ended);
+    uint32_t name_id = StringTable::Add(name);
+    const std::lock_guard<std::mutex> lock(lock_);
+    command_store_.AddLaunch(name_id, 0, started, ended, 0, 1);
+  }
+
+  bool IsEmpty() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return wait_map_.empty();
+  }
+
+  void PrintTables(std::ostream& stream) const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    if (wait_map_.empty()) {
+      return;
+    }
+
+    std::map<uint32_t, std::vector<Blocker> > blocker_map;
+    for (const auto& value : wait_map_) {
+      blocker_map[value.first].resize(value.second.size(), {0, 0});
+    }
+
+    command_store_.ForEachLaunch(
+        [&](const KernelIntervalRecord* interval_list, uint32_t) {
+          AddBlocker(interval_list[0], &blocker_map);
+        });
+
+    std::map<uint32_t, WaitInfo> thread_map;
+    WaitInfo function_list[kFunctionCount];
+    std::map<uint32_t, CommandInfo> command_map;
+    uint64_t total_blocked = 0;
+
+    for (const auto& value : wait_map_) {
+      const std::vector<Wait>& wait_list = value.second;
+      const std::vector<Blocker>& blocker_list = blocker_map[value.first];
+      WaitInfo& thread = thread_map[value.first];
+      for (size_t i = 0; i < wait_list.size(); ++i) {
+        const Wait& wait = wait_list[i];
+        const Blocker& blocker = blocker_list[i];
+        uint64_t blocked = (blocker.ended > wait.started) ?
+          blocker.ended - wait.started : 0;
+        thread.Add(wait.ended - wait.started, blocked);
+        function_list[wait.function].Add(wait.ended - wait.started, blocked);
+        if (blocked > 0) {
+          CommandInfo& command = command_map[blocker.name_id];
+          ++command.wait_count;
+          command.blocked_time += blocked;
+          total_blocked += blocked;
+        }
+      }
+    }
+
+    stream << std::setw(kThreadLength) << "Thread" << ",";
+    PrintHeader(stream);
+    for (const auto& value : thread_map) {
+      stream << std::setw(kThreadLength) << value.first << ",";
+      PrintWaitInfo(value.second, stream);
+    }
+
+    stream << std::endl;
+    stream << std::setw(kFunctionLength) << "Function" << ",";
+    PrintHeader(stream);
+    for (uint32_t i = 0; i < kFunctionCount; ++i) {
+      if (function_list[i].wait_count > 0) {
+        stream << std::setw(kFunctionLength) << GetFunctionName(i) << ",";
+        PrintWaitInfo(function_list[i], stream);
+      }
+    }
+
+    if (command_map.empty()) {
+      return;
+    }
+
+    std::vector<std::pair<uint32_t, CommandInfo> > command_list(
+        command_map.begin(), command_map.end());
+    std::sort(command_list.begin(), command_list.end(),
+              [](const std::pair<uint32_t, CommandInfo>& left,
+                 const std::pair<uint32_t, CommandInfo>& right) {
+                return left.second.blocked_time > right.second.blocked_time;
+              });
+    if (command_list.size() > WAIT_ANALYSIS_MAX_COMMANDS) {
+      command_list.resize(WAIT_ANALYSIS_MAX_COMMANDS);
+    }
+
+    size_t max_name_length = kCommandLength;
+    for (const auto& value : command_list) {
+      size_t length = StringTable::Get(value.first).size();
+      if (length > max_name_length) {
+        max_name_length = length;
+      }
+    }
+
+    stream << std::endl;
+    stream << std::setw(max_name_length) << "Command" << "," <<
+      std::setw(kCountLength) << "Waits" << "," <<
+      std::setw(kTimeLength) << "Blocked (ns)" << "," <<
+      std::setw(kPercentLength) << "Blocked (%)" << std::endl;
+    for (const auto& value : command_list) {
+      const CommandInfo& command = value.second;
+      float percent = 100.0f * command.blocked_time / total_blocked;
+      stream << std::setw(max_name_length) <<
+        StringTable::Get(value.first) << "," <<
+        std::setw(kCountLength) << command.wait_count << "," <<
+        std::setw(kTimeLength) << command.blocked_time << "," <<
+        std::setw(kPercentLength) << std::setprecision(2) <<
+          std::fixed << percent << std::endl;
+    }
+  }
+
+ private: // Implementation
+  struct Wait {
+    uint64_t started;
+    uint64_t ended;
+    uint32_t function; // See GetFunctionName
+  };
+
+  // Command of the wait that completed last, within the wait
+  struct Blocker {
+    uint64_t ended;
+    uint32_t name_id;
+  };
+
+  struct WaitInfo {
+    uint64_t wait_count = 0;
+    uint64_t wait_time = 0;
+    uint64_t blocked_time = 0;
+    uint64_t idle_count = 0; // Waits that overlap no command
+
+    void Add(uint64_t time, uint64_t blocked) {
+      ++wait_count;
+      wait_time += time;
+      blocked_time += blocked;
+      if (blocked == 0) {
+        ++idle_count;
+      }
+    }
+  };
+
+  struct CommandInfo {
+    uint64_t wait_count = 0;
+    uint64_t blocked_time = 0;
+  };
+
+  static const char* GetFunctionName(uint32_t function) {
+    static const char* function_list[kFunctionCount] = {
+      "zeEventHostSynchronize",
+      "zeFenceHostSynchronize",
+      "zeCommandQueueSynchronize",
+      "zeCommandListHostSynchronize",
+      "clFinish",
+      "clWaitForEvents"
+    };
+    PTI_ASSERT(function < kFunctionCount);
+    return function_list[function];
+  }
+
+  static uint32_t GetFunctionIndex(const std::string& name) {
+    uint32_t i = 0;
+    while (i < kFunctionCount && name != GetFunctionName(i)) {
+      ++i;
+    }
+    return i;
+  }
+
+  // Waits of each thread are sorted and disjoint, so the ones that
+  // overlap the command are found by binary search
+  void AddBlocker(
+      const KernelIntervalRecord& command,
+      std::map<uint32_t, std::vector<Blocker> >* blocker_map) const {
+    PTI_ASSERT(blocker_map != nullptr);
+    for (const auto& value : wait_map_) {
+      const std::vector<Wait>& wait_list = value.second;
+      std::vector<Blocker>& blocker_list = (*blocker_map)[value.first];
+      auto it = std::upper_bound(
+          wait_list.begin(), wait_list.end(), command.start,
+          [](uint64_t time, const Wait& wait) { return time < wait.ended; });
+      for (; it != wait_list.end() && it->started < command.end; ++it) {
+        Blocker& blocker = blocker_list[it - wait_list.begin()];
+        uint64_t ended = (std::min)(command.end, it->ended);
+        if (ended > blocker.ended) {
+          blocker = {ended, command.name_id};
+        }
+      }
+    }
+  }
+
+  static void PrintHeader(std::ostream& stream) {
+    stream << std::setw(kCountLength) << "Waits" << "," <<
+      std::setw(kTimeLength) << "Wait Time (ns)" << "," <<
+      std::setw(kTimeLength) << "Blocked (ns)" << "," <<
+      std::setw(kPercentLength) << "Blocked (%)" << "," <<
+      std::setw(kTimeLength) << "Overhead (ns)" << "," <<
+      std::setw(kCountLength) << "No Work" << std::endl;
+  }
+
+  static void PrintWaitInfo(const WaitInfo& info, std::ostream& stream) {
+    float percent = (info.wait_time > 0) ?
+      100.0f * info.blocked_time / info.wait_time : 0.0f;
+    stream << std::setw(kCountLength) << info.wait_count << "," <<
+      std::setw(kTimeLength) << info.wait_time << "," <<
+      std::setw(kTimeLength) << info.blocked_time << "," <<
+      std::setw(kPercentLength) << std::setprecision(2) <<
+        std::fixed << percent << "," <<
+      std::setw(kTimeLength) << info.wait_time - info.blocked_time << "," <<
+      std::setw(kCountLength) << info.idle_count << std::endl;
+  }
+
+ private: // Data
+  mutable std::mutex lock_;
+  std::map<uint32_t, std::vector<Wait> > wait_map_;
+  KernelIntervalStore<uint32_t> command_store_;
+
+  static const uint32_t kFunctionCount = 6;
+  static const uint32_t kThreadLength = 12;
+  static const uint32_t kFunctionLength = 28;
+  static const uint32_t kCommandLength = 7;
+  static const uint32_t kCountLength = 12;
+  static const uint32_t kTimeLength = 20;
+  static const uint32_t kPercentLength = 12;
+};
+
+#endif // PTI_TOOLS_UTILS_WAIT_ANALYSIS_H_
@@ -0,0 +1,164 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_UTILS_WORK_STEALING_POOL_H_
+#define PTI_TOOLS_UTILS_WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pti_assert.h"
+
+// Runs batches of independent tasks on a fixed set of threads. Each thread
+// takes tasks from the back of its own queue and steals from the front of
+// the other queues once its own is empty, so uneven tasks are balanced
+// without a single shared queue. The calling thread works as well.
+class WorkStealingPool {
+ public: // Interface
+  // Zero means one thread per hardware thread
+  explicit WorkStealingPool(uint32_t thread_count = 0) {
+    if (thread_count == 0) {
+      thread_count = std::thread::hardware_concurrency();
+    }
+    if (thread_count == 0) {
+      thread_count = 1;
+    }
+
+    // The last queue belongs to the calling thread
+    queue_list_ = std::vector<TaskQueue>(thread_count);
+    for (uint32_t i = 0; i + 1 < thread_count; ++i) {
+      thread_list_.emplace_back(&WorkStealingPool::Work, this, i);
+    }
+  }
+
+  ~WorkStealingPool() {
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      stop_ = true;
+    }
+    wakeup_.notify_all();
+    for (auto& thread : thread_list_) {
+      thread.join();
+    }
+  }
+
+  uint32_t GetThreadCount() const {
+    return queue_list_.size();
+  }
+
+  // Returns once all the tasks are completed
+  void Run(const std::vector<std::function<void()> >& task_list) {
+    if (task_list.empty()) {
+      return;
+    }
+
+    task_list_ = &task_list;
+    pending_count_.store(task_list.size(), std::memory_order_release);
+    for (size_t i = 0; i < task_list.size(); ++i) {
+      TaskQueue& queue = queue_list_[i % queue_list_.size()];
+      const std::lock_guard<std::mutex> lock(queue.lock);
+      queue.task_id_list.push_back(i);
+    }
+
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      ++generation_;
+    }
+    wakeup_.notify_all();
+
+    Process(queue_list_.size() - 1);
+
+    std::unique_lock<std::mutex> lock(lock_);
+    done_.wait(lock, [this] {
+      return pending_count_.load(std::memory_order_acquire) == 0;
+    });
+    task_list_ = nullptr;
+  }
+
+  WorkStealingPool(const WorkStealingPool& copy) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool& copy) = delete;
+
+ private: // Implementation
+  struct TaskQueue {
+    std::mutex lock;
+    std::deque<size_t> task_id_list;
+  };
+
+  void Work(uint32_t queue_id) {
+    uint64_t generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(lock_);
+        wakeup_.wait(lock, [this, generation] {
+          return stop_ || generation_ != generation;
+        });
+        if (stop_) {
+          break;
+        }
+        generation = generation_;
+      }
+      Process(queue_id);
+    }
+  }
+
+  void Process(uint32_t queue_id) {
+    size_t task_id = 0;
+    while (Pop(queue_id, &task_id) || Steal(queue_id, &task_id)) {
+      PTI_ASSERT(task_list_ != nullptr);
+      PTI_ASSERT(task_id < task_list_->size());
+      (*task_list_)[task_id]();
+
+      if (pending_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        const std::lock_guard<std::mutex> lock(lock_);
+        done_.notify_all();
+      }
+    }
+  }
+
+  bool Pop(uint32_t queue_id, size_t* task_id) {
+    TaskQueue& queue = queue_list_[queue_id];
+    const std::lock_guard<std::mutex> lock(queue.lock);
+    if (queue.task_id_list.empty()) {
+      return false;
+    }
+    *task_id = queue.task_id_list.back();
+    queue.task_id_list.pop_back();
+    return true;
+  }
+
+  bool Steal(uint32_t queue_id, size_t* task_id) {
+    for (size_t i = 1; i < queue_list_.size(); ++i) {
+      TaskQueue& queue = queue_list_[(queue_id + i) % queue_list_.size()];
+      const std::lock_guard<std::mutex> lock(queue.lock);
+      if (!queue.task_id_list.empty()) {
+        *task_id = queue.task_id_list.front();
+        queue.task_id_list.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private: // Data
+  std::vector<TaskQueue> queue_list_;
+  std::vector<std::thread> thread_list_;
+
+  const std::vector<std::function<void()> >* task_list_ = nullptr;
+  std::atomic<size_t> pending_count_{0};
+
+  std::mutex lock_;
+  std::condition_variable wakeup_;
+  std::condition_variable done_;
+  uint64_t generation_ = 0;
+  bool stop_ = false;
+};
+
+#endif // PTI_TOOLS_UTILS_WORK_STEALING_POOL_H_
@@ -237,8 +237,26 @@ def get_enum_map(include_path):
 
 # Generate Callbacks ##########################################################
 
+# Functions of each API subset (see API_SUBSET_* in api_filter.h), the modes
+# that need only these get no callbacks for the rest of the API. Wait list
+# is the Level Zero part of WaitAnalysis functions
+subset_map = {
+  "API_SUBSET_ALLOC": ["zeMemAllocDevice", "zeMemAllocHost",
+                       "zeMemAllocShared", "zeMemFree"],
+  "API_SUBSET_WAIT": ["zeEventHostSynchronize", "zeFenceHostSynchronize",
+                      "zeCommandQueueSynchronize",
+                      "zeCommandListHostSynchronize"]}
+
+def get_subsets(func):
+  subset_list = []
+  for subset in sorted(subset_map.keys()):
+    if func in subset_map[subset]:
+      subset_list.append(subset)
+  return " | ".join(subset_list)
+
 def gen_api(f, func_list, group_map):
-  f.write("static void SetTracingAPIs(zel_tracer_handle_t tracer) {\n")
+  f.write("static void SetTracingAPIs(\n")
+  f.write("    zel_tracer_handle_t tracer, const ApiFilter& filter) {\n")
   f.write("  zet_core_callbacks_t prologue = {};\n")
   f.write("  zet_core_callbacks_t epilogue = {};\n")
   f.write("\n")
@@ -252,8 +270,14 @@ def gen_api(f, func_list, group_map):
     callback_cond = callback[1]
     if callback_cond:
       f.write("#if " + callback_cond + "\n")
-    f.write("  prologue." + group_name + "." + callback_name + " = " + func + "OnEnter;\n")
-    f.write("  epilogue." + group_name + "." + callback_name + " = " + func + "OnExit;\n")
+    subsets = get_subsets(func)
+    if subsets:
+      f.write("  if (filter.IsEnabled(\"" + func + "\", " + subsets + ")) {\n")
+    else:
+      f.write("  if (filter.IsEnabled(\"" + func + "\")) {\n")
+    f.write("    prologue." + group_name + "." + callback_name + " = " + func + "OnEnter;\n")
+    f.write("    epilogue." + group_name + "." + callback_name + " = " + func + "OnExit;\n")
+    f.write("  }\n")
     if callback_cond:
       f.write("#endif //" + callback_cond + "\n")
   f.write("\n")
@@ -314,6 +338,7 @@ def gen_enum(f, enum_map, enum_name, param_name):
   f.write("    }\n")
 
 def gen_enter_callback(f, func, params, enum_map):
+  f.write("  OverheadScope overhead(OVERHEAD_ZE_API, OVERHEAD_CALLBACK);\n")
   f.write("  PTI_ASSERT(global_user_data != nullptr);\n")
   f.write("  ZeApiCollector* collector =\n")
   f.write("    reinterpret_cast<ZeApiCollector*>(global_user_data);\n")
@@ -321,14 +346,17 @@ def gen_enter_callback(f, func, params, enum_map):
   f.write("\n")
   f.write("  uint64_t& start_time = *reinterpret_cast<uint64_t*>(instance_user_data);\n")
   f.write("  start_time = collector->GetTimestamp();\n")
-  f.write("  if (collector->options_.call_tracing) {\n")
+  f.write("  if (overhead.IsOutermost()) {\n")
+  f.write("    Overhead::ResetCallTicks();\n")
+  f.write("  }\n")
+  f.write("  if (collector->IsCallLogging()) {\n")
   f.write("    std::stringstream stream;\n")
   f.write("    stream << \">>>> [\" << start_time << \"] \";\n")
   f.write("    if (collector->options_.need_pid) {\n")
-  f.write("      stream << \"<PID:\" << utils::GetPid() << \"> \";\n")
+  f.write("      stream << \"<PID:\" << ThreadIdentity::GetPid() << \"> \";\n")
   f.write("    }\n")
   f.write("    if (collector->options_.need_tid) {\n")
-  f.write("      stream << \"<TID:\" << utils::GetTid() << \"> \";\n")
+  f.write("      stream << \"<TID:\" << ThreadIdentity::GetTid() << \"> \";\n")
   f.write("    }\n")
   f.write("    stream << \"" + func + "\" << \":\";\n")
   for name, type in params:
@@ -505,6 +533,7 @@ def gen_enter_callback(f, func, params, enum_map):
   f.write("  }\n")
 
 def gen_exit_callback(f, func, params, enum_map):
+  f.write("  OverheadScope overhead(OVERHEAD_ZE_API, OVERHEAD_CALLBACK);\n")
   f.write("  PTI_ASSERT(global_user_data != nullptr);\n")
   f.write("  ZeApiCollector* collector =\n")
   f.write("    reinterpret_cast<ZeApiCollector*>(global_user_data);\n")
@@ -516,15 +545,34 @@ def gen_exit_callback(f, func, params, enum_map):
   f.write("  PTI_ASSERT(start_time > 0);\n")
   f.write("  PTI_ASSERT(start_time < end_time);\n")
   f.write("  uint64_t time = end_time - start_time;\n")
+  f.write("  if (overhead.IsOutermost() && Overhead::IsSubtractEnabled()) {\n")
+  f.write("    uint64_t own_time = Overhead::TakeCallTime();\n")
+  f.write("    time = (own_time < time) ? time - own_time : 0;\n")
+  f.write("  }\n")
   f.write("  collector->AddFunctionTime(\"" + func + "\", time);\n")
-  f.write("  if (collector->options_.call_tracing) {\n")
+  if func == "zeMemAllocDevice" or func == "zeMemAllocHost" or\
+     func == "zeMemAllocShared":
+    memory_type = {"zeMemAllocDevice": "TRANSFER_MEMORY_DEVICE",
+                   "zeMemAllocHost": "TRANSFER_MEMORY_HOST",
+                   "zeMemAllocShared": "TRANSFER_MEMORY_SHARED"}[func]
+    f.write("  if (collector->churn_ != nullptr && result == ZE_RESULT_SUCCESS) {\n")
+    f.write("    collector->churn_->AddAllocation(\n")
+    f.write("        **(params->ppptr), *(params->psize),\n")
+    f.write("        " + memory_type + ", start_time, end_time);\n")
+    f.write("  }\n")
+  elif func == "zeMemFree":
+    f.write("  if (collector->churn_ != nullptr && result == ZE_RESULT_SUCCESS) {\n")
+    f.write("    collector->churn_->AddFree(\n")
+    f.write("        *(params->pptr), start_time, end_time);\n")
+    f.write("  }\n")
+  f.write("  if (collector->IsCallLogging()) {\n")
   f.write("    std::stringstream stream;\n")
   f.write("    stream << \"<<<< [\" << end_time << \"] \";\n")
   f.write("    if (collector->options_.need_pid) {\n")
-  f.write("      stream << \"<PID:\" << utils::GetPid() << \"> \";\n")
+  f.write("      stream << \"<PID:\" << ThreadIdentity::GetPid() << \"> \";\n")
   f.write("    }\n")
   f.write("    if (collector->options_.need_tid) {\n")
-  f.write("      stream << \"<TID:\" << utils::GetTid() << \"> \";\n")
+  f.write("      stream << \"<TID:\" << ThreadIdentity::GetTid() << \"> \";\n")
   f.write("    }\n")
   f.write("    stream << \"" + func + "\";\n")
   if func == "zeCommandListAppendLaunchKernel" or\
@@ -550,15 +598,12 @@ def gen_exit_callback(f, func, params, enum_map):
     f.write("    std::string kernel_call_id;\n")
     f.write("    if (command_lists != nullptr) {\n")
     f.write("      for (uint32_t i = 0; i < command_list_count; ++i) {\n")
-    f.write("        std::vector<uint64_t> kernel_id_list =\n")
-    f.write("          collector->correlator_->GetKernelId(command_lists[i]);\n")
-    f.write("        std::vector<uint64_t> call_id_list =\n")
-    f.write("          collector->correlator_->GetCallId(command_lists[i]);\n")
-    f.write("        PTI_ASSERT(kernel_id_list.size() == call_id_list.size());\n")
-    f.write("        for (size_t j = 0; j < kernel_id_list.size(); ++j) {\n")
-    f.write("          kernel_call_id += std::to_string(kernel_id_list[j]) + \".\"\n")
-    f.write("            + std::to_string(call_id_list[j]) + \",\";\n")
-    f.write("        }\n")
+    f.write("        collector->correlator_->ForEachKernelCall(\n")
+    f.write("            command_lists[i],\n")
+    f.write("            [&kernel_call_id](uint64_t kernel_id, uint64_t call_id) {\n")
+    f.write("              kernel_call_id += std::to_string(kernel_id) + \".\" +\n")
+    f.write("                std::to_string(call_id) + \",\";\n")
+    f.write("            });\n")
     f.write("      }\n")
     f.write("    }\n")
     f.write("    \n")
@@ -627,15 +672,12 @@ def gen_exit_callback(f, func, params, enum_map):
     f.write("    std::string kernel_call_id;\n")
     f.write("    if (command_lists != nullptr) {\n")
     f.write("      for (uint32_t i = 0; i < command_list_count; ++i) {\n")
-    f.write("        std::vector<uint64_t> kernel_id_list =\n")
-    f.write("          collector->correlator_->GetKernelId(command_lists[i]);\n")
-    f.write("        std::vector<uint64_t> call_id_list =\n")
-    f.write("          collector->correlator_->GetCallId(command_lists[i]);\n")
-    f.write("        PTI_ASSERT(kernel_id_list.size() == call_id_list.size());\n")
-    f.write("        for (size_t j = 0; j < kernel_id_list.size(); ++j) {\n")
-    f.write("          kernel_call_id += std::to_string(kernel_id_list[j]) + \".\"\n")
-    f.write("            + std::to_string(call_id_list[j]) + \",\";\n")
-    f.write("        }\n")
+    f.write("        collector->correlator_->ForEachKernelCall(\n")
+    f.write("            command_lists[i],\n")
+    f.write("            [&kernel_call_id](uint64_t kernel_id, uint64_t call_id) {\n")
+    f.write("              kernel_call_id += std::to_string(kernel_id) + \".\" +\n")
+    f.write("                std::to_string(call_id) + \",\";\n")
+    f.write("            });\n")
     f.write("      }\n")
     f.write("    }\n")
     f.write("    \n")
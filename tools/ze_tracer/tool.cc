@@ -36,6 +36,42 @@ void Usage() {
     "--device-timing-verbose [-v]   " <<
     "Report kernels execution time with SIMD width and global/local sizes" <<
     std::endl;
+  std::cout <<
+    "--queue-timing                 " <<
+    "Report busy/idle time and submission latency per queue and engine" <<
+    std::endl;
+  std::cout <<
+    "--dependency-graph             " <<
+    "Report critical path and unused parallelism of command dependencies" <<
+    std::endl;
+  std::cout <<
+    "--call-stacks                  " <<
+    "Report kernel time per host call stack of the launch" <<
+    std::endl;
+  std::cout <<
+    "--submission-spans             " <<
+    "Report GPU busy/idle time per queue from command list executions" <<
+    std::endl;
+  std::cout <<
+    "--wait-analysis                " <<
+    "Report host time blocked in synchronization calls and its commands" <<
+    std::endl;
+  std::cout <<
+    "--transfer-timing              " <<
+    "Report memory transfer bandwidth per direction and engine" <<
+    std::endl;
+  std::cout <<
+    "--tile-timing                  " <<
+    "Report per-tile busy time and load imbalance of kernels" <<
+    std::endl;
+  std::cout <<
+    "--memory-tracking              " <<
+    "Track USM allocations and report peak footprint per device" <<
+    std::endl;
+  std::cout <<
+    "--alloc-churn                  " <<
+    "Report short-lived allocations and pooling savings" <<
+    std::endl;
   std::cout <<
     "--device-timeline [-t]         " <<
     "Trace device activities" <<
@@ -68,6 +104,99 @@ void Usage() {
     "--pid                          " <<
     "Print process ID into host API and device activity trace" <<
     std::endl;
+  std::cout <<
+    "--async-logging                " <<
+    "Write logs and traces from a background thread" <<
+    std::endl;
+  std::cout <<
+    "--log-buffer-size <KB>         " <<
+    "Per-thread buffer size for asynchronous logging" <<
+    std::endl;
+  std::cout <<
+    "--compress <method>            " <<
+    "Compress log and timeline files in frames (zstd|lz4)" <<
+    std::endl;
+  std::cout <<
+    "--binary-trace                 " <<
+    "Dump host and device activities to binary file" <<
+    std::endl;
+  std::cout <<
+    "--node-trace                   " <<
+    "Send binary trace to node trace daemon if it runs" <<
+    std::endl;
+  std::cout <<
+    "--perfetto-trace               " <<
+    "Dump host and device activities to Perfetto file" <<
+    std::endl;
+  std::cout <<
+    "--poll-interval <us>           " <<
+    "Read out finished kernels every given time" <<
+    std::endl;
+  std::cout <<
+    "--batch-timestamps             " <<
+    "Read kernel timestamps of command list at once" <<
+    std::endl;
+  std::cout <<
+    "--include-api <patterns>       " <<
+    "Trace only API functions matching the patterns" <<
+    std::endl;
+  std::cout <<
+    "--exclude-api <patterns>       " <<
+    "Do not trace API functions matching the patterns" <<
+    std::endl;
+  std::cout <<
+    "--kernel-sampling <N|rate>     " <<
+    "Trace every N-th or random share of kernel launches" <<
+    std::endl;
+  std::cout <<
+    "--module-dump <directory>      " <<
+    "Dump binaries and debug info of built modules into the directory" <<
+    std::endl;
+  std::cout <<
+    "--kernel-grouping <mode>       " <<
+    "Group kernel table rows by name, local size or full launch config " <<
+    "(name|local|config)" <<
+    std::endl;
+  std::cout <<
+    "--capture-delay <ms>           " <<
+    "Start capture after the given delay" <<
+    std::endl;
+  std::cout <<
+    "--capture-duration <ms>        " <<
+    "Stop capture after the given duration" <<
+    std::endl;
+  std::cout <<
+    "--capture-kernel <name>        " <<
+    "Start capture after the kernel launch" <<
+    std::endl;
+  std::cout <<
+    "--capture-kernel-count <N>     " <<
+    "Start capture after N-th kernel launch" <<
+    std::endl;
+  std::cout <<
+    "--capture-file <path>          " <<
+    "Capture while the given file exists" <<
+    std::endl;
+  std::cout <<
+    "--capture-signal               " <<
+    "Start/stop capture on SIGUSR1/SIGUSR2" <<
+    std::endl;
+  std::cout <<
+    "--interval <sec>               " <<
+    "Store timing statistics per time window to CSV file" <<
+    std::endl;
+  std::cout <<
+    "--save-tables                  " <<
+    "Store timing tables to JSON file for run-to-run comparison" <<
+    std::endl;
+  std::cout <<
+    "--overhead                     " <<
+    "Report time spent by the tool itself" <<
+    std::endl;
+  std::cout <<
+    "--subtract-overhead            " <<
+    "Report tool overhead and take it out of host API timings" <<
+    std::endl;
   std::cout <<
     "--version                      " <<
     "Print version" <<
@@ -97,6 +226,33 @@ int ParseArgs(int argc, char* argv[]) {
                strcmp(argv[i], "-v") == 0) {
       utils::SetEnv("ZET_DeviceTimingVerbose", "1");
       ++app_index;
+    } else if (strcmp(argv[i], "--queue-timing") == 0) {
+      utils::SetEnv("ZET_QueueTiming", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--dependency-graph") == 0) {
+      utils::SetEnv("ZET_DependencyGraph", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--call-stacks") == 0) {
+      utils::SetEnv("ZET_CallStacks", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--submission-spans") == 0) {
+      utils::SetEnv("ZET_SubmissionSpans", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--wait-analysis") == 0) {
+      utils::SetEnv("ZET_WaitAnalysis", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--transfer-timing") == 0) {
+      utils::SetEnv("ZET_TransferTiming", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--tile-timing") == 0) {
+      utils::SetEnv("ZET_TileTiming", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--memory-tracking") == 0) {
+      utils::SetEnv("ZET_MemoryTracking", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--alloc-churn") == 0) {
+      utils::SetEnv("ZET_AllocChurn", "1");
+      ++app_index;
     } else if (strcmp(argv[i], "--device-timeline") == 0 ||
                strcmp(argv[i], "-t") == 0) {
       utils::SetEnv("ZET_DeviceTimeline", "1");
@@ -129,6 +285,188 @@ int ParseArgs(int argc, char* argv[]) {
     } else if (strcmp(argv[i], "--pid") == 0) {
       utils::SetEnv("ZET_Pid", "1");
       ++app_index;
+    } else if (strcmp(argv[i], "--async-logging") == 0) {
+      utils::SetEnv("ZET_AsyncLogging", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--log-buffer-size") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Log buffer size is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Log buffer size is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_LogBufferSize", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--compress") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Compression method is not specified" <<
+          std::endl;
+        return -1;
+      }
+      if (!StreamCompressor::IsMethod(argv[i])) {
+        std::cout << "[ERROR] Compression method is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_Compression", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--binary-trace") == 0) {
+      utils::SetEnv("ZET_BinaryTrace", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--node-trace") == 0) {
+      utils::SetEnv("ZET_BinaryTrace", "1");
+      utils::SetEnv("ZET_NodeTrace", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--perfetto-trace") == 0) {
+      utils::SetEnv("ZET_PerfettoTrace", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--poll-interval") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Poll interval is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Poll interval is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_PollInterval", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--batch-timestamps") == 0) {
+      utils::SetEnv("ZET_BatchTimestamps", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--include-api") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Included API patterns are not specified" <<
+          std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_IncludeApi", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--exclude-api") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Excluded API patterns are not specified" <<
+          std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_ExcludeApi", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--kernel-sampling") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Kernel sampling is not specified" << std::endl;
+        return -1;
+      }
+      if (!KernelSampler::IsValid(argv[i])) {
+        std::cout << "[ERROR] Kernel sampling is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_KernelSampling", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--module-dump") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Module dump directory is not specified" <<
+          std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_ModuleDump", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--kernel-grouping") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Kernel grouping is not specified" << std::endl;
+        return -1;
+      }
+      KernelGrouping grouping = KERNEL_GROUPING_NAME;
+      if (!KernelStatistics::ParseGrouping(argv[i], &grouping)) {
+        std::cout << "[ERROR] Kernel grouping is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_KernelGrouping", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-delay") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture delay is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture delay is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_CaptureDelay", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-duration") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture duration is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture duration is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_CaptureDuration", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-kernel") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture kernel is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_CaptureKernel", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-kernel-count") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture kernel count is not specified" <<
+          std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Capture kernel count is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_CaptureKernelCount", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-file") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Capture file is not specified" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_CaptureFile", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--capture-signal") == 0) {
+      utils::SetEnv("ZET_CaptureSignal", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--interval") == 0) {
+      ++i;
+      if (i >= argc) {
+        std::cout << "[ERROR] Interval is not specified" << std::endl;
+        return -1;
+      }
+      if (atoi(argv[i]) <= 0) {
+        std::cout << "[ERROR] Interval is invalid" << std::endl;
+        return -1;
+      }
+      utils::SetEnv("ZET_Interval", argv[i]);
+      app_index += 2;
+    } else if (strcmp(argv[i], "--save-tables") == 0) {
+      utils::SetEnv("ZET_SaveTables", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--overhead") == 0) {
+      utils::SetEnv("PTI_OVERHEAD", "1");
+      ++app_index;
+    } else if (strcmp(argv[i], "--subtract-overhead") == 0) {
+      utils::SetEnv("PTI_OVERHEAD", "subtract");
+      ++app_index;
     } else if (strcmp(argv[i], "--version") == 0) {
 #ifdef PTI_VERSION
       std::cout << TOSTRING(PTI_VERSION) << std::endl;
@@ -171,72 +509,207 @@ void SetToolEnv() {
 
 static TraceOptions ReadArgs() {
   std::string value;
-  uint32_t flags = 0;
+  uint64_t flags = 0;
   std::string log_file;
+  std::string include_api;
+  std::string exclude_api;
+  std::string kernel_sampling;
+  std::string module_dump_path;
+  std::string kernel_grouping;
+  std::string compression;
+  uint32_t log_buffer_size = 0;
+  uint32_t poll_interval = 0;
+  uint32_t stats_interval = 0;
 
   value = utils::GetEnv("ZET_CallLogging");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CALL_LOGGING);
+    flags |= (1ull << TRACE_CALL_LOGGING);
   }
 
   value = utils::GetEnv("ZET_HostTiming");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_HOST_TIMING);
+    flags |= (1ull << TRACE_HOST_TIMING);
   }
 
   value = utils::GetEnv("ZET_DeviceTiming");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_DEVICE_TIMING);
+    flags |= (1ull << TRACE_DEVICE_TIMING);
   }
 
   value = utils::GetEnv("ZET_DeviceTimingVerbose");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_DEVICE_TIMING_VERBOSE);
+    flags |= (1ull << TRACE_DEVICE_TIMING_VERBOSE);
+  }
+
+  value = utils::GetEnv("ZET_QueueTiming");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_QUEUE_TIMING);
+  }
+
+  value = utils::GetEnv("ZET_DependencyGraph");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_DEPENDENCY_GRAPH);
+  }
+
+  value = utils::GetEnv("ZET_CallStacks");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_CALL_STACKS);
+  }
+
+  value = utils::GetEnv("ZET_SubmissionSpans");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_SUBMISSION_SPANS);
+  }
+
+  value = utils::GetEnv("ZET_WaitAnalysis");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_WAIT_ANALYSIS);
+  }
+
+  value = utils::GetEnv("ZET_TransferTiming");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_TRANSFER_TIMING);
+  }
+
+  value = utils::GetEnv("ZET_TileTiming");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_TILE_TIMING);
+  }
+
+  value = utils::GetEnv("ZET_MemoryTracking");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_MEMORY_TRACKING);
+  }
+
+  value = utils::GetEnv("ZET_AllocChurn");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_ALLOC_CHURN);
+  }
+
+  value = utils::GetEnv("ZET_Interval");
+  if (!value.empty()) {
+    flags |= (1ull << TRACE_INTERVAL_STATS);
+    stats_interval = std::stoul(value);
+  }
+
+  value = utils::GetEnv("ZET_SaveTables");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_SAVE_TABLES);
   }
 
   value = utils::GetEnv("ZET_DeviceTimeline");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_DEVICE_TIMELINE);
+    flags |= (1ull << TRACE_DEVICE_TIMELINE);
   }
 
   value = utils::GetEnv("ZET_LogToFile");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_LOG_TO_FILE);
+    flags |= (1ull << TRACE_LOG_TO_FILE);
     log_file = utils::GetEnv("ZET_LogFilename");
     PTI_ASSERT(!log_file.empty());
   }
 
   value = utils::GetEnv("ZET_ChromeCallLogging");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_CALL_LOGGING);
+    flags |= (1ull << TRACE_CHROME_CALL_LOGGING);
   }
 
   value = utils::GetEnv("ZET_ChromeDeviceTimeline");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_DEVICE_TIMELINE);
+    flags |= (1ull << TRACE_CHROME_DEVICE_TIMELINE);
   }
 
   value = utils::GetEnv("ZET_ChromeKernelTimeline");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_KERNEL_TIMELINE);
+    flags |= (1ull << TRACE_CHROME_KERNEL_TIMELINE);
   }
 
   value = utils::GetEnv("ZET_ChromeDeviceStages");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_CHROME_DEVICE_STAGES);
+    flags |= (1ull << TRACE_CHROME_DEVICE_STAGES);
   }
 
   value = utils::GetEnv("ZET_Tid");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_TID);
+    flags |= (1ull << TRACE_TID);
   }
 
   value = utils::GetEnv("ZET_Pid");
   if (!value.empty() && value == "1") {
-    flags |= (1 << TRACE_PID);
+    flags |= (1ull << TRACE_PID);
+  }
+
+  value = utils::GetEnv("ZET_AsyncLogging");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_ASYNC_LOGGING);
+  }
+
+  value = utils::GetEnv("ZET_LogBufferSize");
+  if (!value.empty()) {
+    log_buffer_size = std::stoul(value);
+  }
+
+  value = utils::GetEnv("ZET_Compression");
+  if (!value.empty()) {
+    compression = value;
+  }
+
+  value = utils::GetEnv("ZET_BinaryTrace");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_BINARY_TRACE);
+  }
+
+  value = utils::GetEnv("ZET_NodeTrace");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_NODE_TRACE);
+  }
+
+  value = utils::GetEnv("ZET_PerfettoTrace");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_PERFETTO_TRACE);
+  }
+
+  value = utils::GetEnv("ZET_PollInterval");
+  if (!value.empty()) {
+    poll_interval = std::stoul(value);
+  }
+
+  value = utils::GetEnv("ZET_BatchTimestamps");
+  if (!value.empty() && value == "1") {
+    flags |= (1ull << TRACE_BATCH_TIMESTAMPS);
+  }
+
+  value = utils::GetEnv("ZET_IncludeApi");
+  if (!value.empty()) {
+    include_api = value;
+  }
+
+  value = utils::GetEnv("ZET_ExcludeApi");
+  if (!value.empty()) {
+    exclude_api = value;
+  }
+
+  value = utils::GetEnv("ZET_KernelSampling");
+  if (!value.empty()) {
+    kernel_sampling = value;
+  }
+
+  value = utils::GetEnv("ZET_ModuleDump");
+  if (!value.empty()) {
+    flags |= (1ull << TRACE_MODULE_DUMP);
+    module_dump_path = value;
+  }
+
+  value = utils::GetEnv("ZET_KernelGrouping");
+  if (!value.empty()) {
+    kernel_grouping = value;
   }
 
-  return TraceOptions(flags, log_file);
+  return TraceOptions(
+      flags, log_file, log_buffer_size, 0, 0, poll_interval,
+      include_api, exclude_api, kernel_sampling,
+      CaptureOptions::Read("ZET_"), 0, 0, stats_interval,
+      kernel_grouping, compression, 0.0, module_dump_path);
 }
 
 void EnableProfiling() {
@@ -7,16 +7,24 @@
 #ifndef PTI_TOOLS_ZE_TRACER_ZE_API_COLLECTOR_H_
 #define PTI_TOOLS_ZE_TRACER_ZE_API_COLLECTOR_H_
 
+#include <atomic>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <mutex>
 #include <set>
+#include <thread>
+#include <unordered_map>
 
 #include <level_zero/layers/zel_tracing_api.h>
 
+#include "allocation_churn.h"
+#include "api_filter.h"
 #include "correlator.h"
+#include "latency_histogram.h"
+#include "overhead.h"
+#include "thread_identity.h"
 #include "utils.h"
 #include "ze_utils.h"
 
@@ -25,6 +33,7 @@ struct ZeFunction {
   uint64_t min_time;
   uint64_t max_time;
   uint64_t call_count;
+  LatencyHistogram time_histogram;
 
   bool operator>(const ZeFunction& r) const {
     if (total_time != r.total_time) {
@@ -43,20 +52,33 @@ struct ZeFunction {
 
 using ZeFunctionInfoMap = std::map<std::string, ZeFunction>;
 
+// Function names are string literals, so per-thread statistics are keyed
+// by pointer and merged by name only at report time
+struct ZeThreadFunctionInfo {
+  std::mutex lock;
+  std::unordered_map<const char*, ZeFunction> function_map;
+};
+
+using ZeThreadFunctionInfoMap = std::map<
+    std::thread::id, ZeThreadFunctionInfo*>;
+
 typedef void (*OnZeFunctionFinishCallback)(
     void* data, const std::string& id, const std::string& name,
     uint64_t started, uint64_t ended);
 
 class ZeApiCollector {
  public: // User Interface
+  // Churn tracking mode pairs zeMemAlloc* and zeMemFree calls of each
+  // pointer to find the allocations that a pool would serve
   static ZeApiCollector* Create(
       Correlator* correlator,
       ApiCollectorOptions options = {false, false, false},
       OnZeFunctionFinishCallback callback = nullptr,
-      void* callback_data = nullptr) {
+      void* callback_data = nullptr,
+      bool churn_tracking = false) {
     PTI_ASSERT(correlator != nullptr);
     ZeApiCollector* collector = new ZeApiCollector(
-        correlator, options, callback, callback_data);
+        correlator, options, callback, callback_data, churn_tracking);
     PTI_ASSERT(collector != nullptr);
 
     ze_result_t status = ZE_RESULT_SUCCESS;
@@ -72,7 +94,11 @@ class ZeApiCollector {
     }
 
     collector->tracer_ = tracer;
-    SetTracingAPIs(tracer);
+
+    // Filtered out functions get no callbacks at all
+    ApiFilter filter(
+        options.include_api, options.exclude_api, options.api_subsets);
+    SetTracingAPIs(tracer, filter);
 
     status = zelTracerSetEnabled(tracer, true);
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
@@ -81,20 +107,62 @@ class ZeApiCollector {
   }
 
   void DisableTracing() {
+    SetTracingEnabled(false);
+  }
+
+  // Pauses and resumes tracing of API calls, e.g. outside the capture
+  // window, collected statistics are kept
+  void SetTracingEnabled(bool enabled) {
     PTI_ASSERT(tracer_ != nullptr);
     ze_result_t status = ZE_RESULT_SUCCESS;
-    status = zelTracerSetEnabled(tracer_, false);
+    status = zelTracerSetEnabled(tracer_, enabled);
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
   }
 
-  const ZeFunctionInfoMap& GetFunctionInfoMap() const {
-    return function_info_map_;
+  // Switches call logging off and back on while tracing goes on, e.g. to
+  // keep the tool overhead down, no effect if call logging is not enabled
+  void SetCallLogging(bool enabled) {
+    call_logging_.store(
+        enabled && options_.call_tracing, std::memory_order_relaxed);
+  }
+
+  ZeFunctionInfoMap GetFunctionInfoMap() const {
+    ZeFunctionInfoMap function_info_map;
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    for (auto& thread_info : thread_info_map_) {
+      ZeThreadFunctionInfo* info = thread_info.second;
+      PTI_ASSERT(info != nullptr);
+
+      const std::lock_guard<std::mutex> thread_lock(info->lock);
+      for (auto& value : info->function_map) {
+        const ZeFunction& function = value.second;
+        auto it = function_info_map.find(value.first);
+        if (it == function_info_map.end()) {
+          function_info_map[value.first] = function;
+        } else {
+          ZeFunction& total = it->second;
+          total.total_time += function.total_time;
+          if (function.min_time < total.min_time) {
+            total.min_time = function.min_time;
+          }
+          if (function.max_time > total.max_time) {
+            total.max_time = function.max_time;
+          }
+          total.call_count += function.call_count;
+          total.time_histogram.Merge(function.time_histogram);
+        }
+      }
+    }
+
+    return function_info_map;
   }
 
   void PrintFunctionsTable() const {
+    ZeFunctionInfoMap function_info_map = GetFunctionInfoMap();
     std::set< std::pair<std::string, ZeFunction>,
               utils::Comparator > sorted_list(
-        function_info_map_.begin(), function_info_map_.end());
+        function_info_map.begin(), function_info_map.end());
 
     uint64_t total_duration = 0;
     size_t max_name_length = kFunctionLength;
@@ -116,7 +184,11 @@ class ZeApiCollector {
       std::setw(kPercentLength) << "Time (%)" << "," <<
       std::setw(kTimeLength) << "Average (ns)" << "," <<
       std::setw(kTimeLength) << "Min (ns)" << "," <<
-      std::setw(kTimeLength) << "Max (ns)" << std::endl;
+      std::setw(kTimeLength) << "Max (ns)" << "," <<
+      std::setw(kTimeLength) << "P50 (ns)" << "," <<
+      std::setw(kTimeLength) << "P90 (ns)" << "," <<
+      std::setw(kTimeLength) << "P99 (ns)" << "," <<
+      std::setw(kTimeLength) << "P99.9 (ns)" << std::endl;
 
     for (auto& value : sorted_list) {
       const std::string& function = value.first;
@@ -125,6 +197,7 @@ class ZeApiCollector {
       uint64_t avg_duration = duration / call_count;
       uint64_t min_duration = value.second.min_time;
       uint64_t max_duration = value.second.max_time;
+      const LatencyHistogram& histogram = value.second.time_histogram;
       float percent_duration = 100.0f * duration / total_duration;
       stream << std::setw(max_name_length) << function << "," <<
         std::setw(kCallsLength) << call_count << "," <<
@@ -133,9 +206,29 @@ class ZeApiCollector {
           std::fixed << percent_duration << "," <<
         std::setw(kTimeLength) << avg_duration << "," <<
         std::setw(kTimeLength) << min_duration << "," <<
-        std::setw(kTimeLength) << max_duration << std::endl;
+        std::setw(kTimeLength) << max_duration << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(50.0, min_duration, max_duration) << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(90.0, min_duration, max_duration) << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(99.0, min_duration, max_duration) << "," <<
+        std::setw(kTimeLength) <<
+          histogram.GetPercentile(99.9, min_duration, max_duration) <<
+          std::endl;
+    }
+
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  void PrintChurnTable() const {
+    if (churn_ == nullptr || churn_->IsEmpty()) {
+      return;
     }
 
+    std::stringstream stream;
+    churn_->PrintTable(stream);
     PTI_ASSERT(correlator_ != nullptr);
     correlator_->Log(stream.str());
   }
@@ -145,6 +238,14 @@ class ZeApiCollector {
       ze_result_t status = zelTracerDestroy(tracer_);
       PTI_ASSERT(status == ZE_RESULT_SUCCESS);
     }
+
+    if (churn_ != nullptr) {
+      delete churn_;
+    }
+
+    for (auto& value : thread_info_map_) {
+      delete value.second;
+    }
   }
 
  private: // Tracing Interface
@@ -153,12 +254,21 @@ class ZeApiCollector {
     return correlator_->GetTimestamp();
   }
 
-  void AddFunctionTime(const std::string& name, uint64_t time) {
-    const std::lock_guard<std::mutex> lock(lock_);
-    if (function_info_map_.count(name) == 0) {
-      function_info_map_[name] = {time, time, time, 1};
+  // Each thread accumulates into its own buffer, so the lock taken here
+  // is contended only by a concurrent report
+  void AddFunctionTime(const char* name, uint64_t time) {
+    PTI_ASSERT(name != nullptr);
+    ZeThreadFunctionInfo* info = GetThreadFunctionInfo();
+    PTI_ASSERT(info != nullptr);
+
+    const OverheadLockGuard lock(info->lock, OVERHEAD_ZE_API);
+    auto it = info->function_map.find(name);
+    if (it == info->function_map.end()) {
+      ZeFunction& function = info->function_map[name];
+      function = ZeFunction{time, time, time, 1, {}};
+      function.time_histogram.Add(time);
     } else {
-      ZeFunction& function = function_info_map_[name];
+      ZeFunction& function = it->second;
       function.total_time += time;
       if (time < function.min_time) {
         function.min_time = time;
@@ -167,16 +277,61 @@ class ZeApiCollector {
         function.max_time = time;
       }
       ++function.call_count;
+      function.time_histogram.Add(time);
+    }
+  }
+
+  // Collector IDs are never reused, so entries left by destroyed
+  // collectors are never hit again
+  ZeThreadFunctionInfo* GetThreadFunctionInfo() {
+    thread_local std::unordered_map<uint64_t, ZeThreadFunctionInfo*>
+      info_cache;
+    auto cached = info_cache.find(collector_id_);
+    if (cached != info_cache.end()) {
+      return cached->second;
+    }
+
+    ZeThreadFunctionInfo* info = nullptr;
+    std::thread::id thread_id = std::this_thread::get_id();
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      auto it = thread_info_map_.find(thread_id);
+      if (it == thread_info_map_.end()) {
+        info = new ZeThreadFunctionInfo;
+        PTI_ASSERT(info != nullptr);
+        thread_info_map_[thread_id] = info;
+      } else {
+        info = it->second;
+      }
     }
+
+    info_cache[collector_id_] = info;
+    return info;
+  }
+
+  static uint64_t GetNextCollectorId() {
+    static std::atomic<uint64_t> next_id(1);
+    return next_id.fetch_add(1, std::memory_order_relaxed);
   }
 
  private: // Implementation Details
   ZeApiCollector(
       Correlator* correlator, ApiCollectorOptions options,
-      OnZeFunctionFinishCallback callback, void* callback_data)
+      OnZeFunctionFinishCallback callback, void* callback_data,
+      bool churn_tracking)
       : correlator_(correlator), options_(options),
-        callback_(callback), callback_data_(callback_data) {
+        callback_(callback), callback_data_(callback_data),
+        collector_id_(GetNextCollectorId()),
+        call_logging_(options.call_tracing) {
     PTI_ASSERT(correlator_ != nullptr);
+    if (churn_tracking) {
+      churn_ = new AllocationChurn;
+      PTI_ASSERT(churn_ != nullptr);
+    }
+  }
+
+  bool IsCallLogging() const {
+    return call_logging_.load(std::memory_order_relaxed);
   }
 
   #include <tracing.gen> // Auto-generated callbacks
@@ -184,15 +339,18 @@ class ZeApiCollector {
  private: // Data
   zel_tracer_handle_t tracer_ = nullptr;
 
-  ZeFunctionInfoMap function_info_map_;
-  std::mutex lock_;
-
   Correlator* correlator_ = nullptr;
   ApiCollectorOptions options_{false, false, false};
 
   OnZeFunctionFinishCallback callback_ = nullptr;
   void* callback_data_ = nullptr;
 
+  uint64_t collector_id_ = 0;
+  std::atomic<bool> call_logging_{false};
+  AllocationChurn* churn_ = nullptr;
+  ZeThreadFunctionInfoMap thread_info_map_;
+  mutable std::mutex lock_;
+
   static const uint32_t kFunctionLength = 10;
   static const uint32_t kCallsLength = 12;
   static const uint32_t kTimeLength = 20;
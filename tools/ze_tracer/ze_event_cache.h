@@ -0,0 +1,221 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ZE_TRACER_ZE_EVENT_CACHE_H_
+#define PTI_TOOLS_ZE_TRACER_ZE_EVENT_CACHE_H_
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <level_zero/ze_api.h>
+
+#include "overhead.h"
+#include "pti_assert.h"
+
+struct ZeEventPool {
+  ze_event_pool_handle_t handle;
+  ze_context_handle_t context;
+  uint32_t live_count; // Events handed out and not released yet
+  bool retired; // Context was released, pool waits for its events
+};
+
+struct ZeEventPoolList {
+  std::vector<ZeEventPool*> event_pool_list;
+  std::vector<ze_event_handle_t> free_event_list;
+  uint32_t next_pool_size;
+};
+
+// Slab allocator of host-visible timestamp events: hands out events from
+// large per-context pools and takes them back once the timestamp was read
+class ZeEventCache {
+ public: // Interface
+  explicit ZeEventCache(ze_event_pool_flags_t flags) : flags_(flags) {}
+
+  // Events still in use are destroyed before their pools
+  ~ZeEventCache() {
+    const std::lock_guard<std::mutex> lock(lock_);
+    for (auto& value : context_map_) {
+      RetirePools(value.second);
+    }
+    context_map_.clear();
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    for (auto& value : event_map_) {
+      status = zeEventDestroy(value.first);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    }
+    event_map_.clear();
+
+    for (ZeEventPool* event_pool : retired_pool_list_) {
+      DestroyPool(event_pool);
+    }
+    retired_pool_list_.clear();
+  }
+
+  ze_event_handle_t GetEvent(ze_context_handle_t context) {
+    PTI_ASSERT(context != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+
+    auto it = context_map_.find(context);
+    if (it == context_map_.end()) {
+      it = context_map_.emplace(
+          context, ZeEventPoolList{
+              std::vector<ZeEventPool*>(),
+              std::vector<ze_event_handle_t>(),
+              kInitialPoolSize}).first;
+    }
+
+    ZeEventPoolList& pool_list = it->second;
+    if (pool_list.free_event_list.empty()) {
+      CreatePool(context, pool_list);
+    }
+    PTI_ASSERT(!pool_list.free_event_list.empty());
+
+    ze_event_handle_t event = pool_list.free_event_list.back();
+    pool_list.free_event_list.pop_back();
+
+    PTI_ASSERT(event_map_.count(event) == 1);
+    ++event_map_[event]->live_count;
+    return event;
+  }
+
+  // Events of retired pools are destroyed, and the pool goes away
+  // together with its last event
+  void ReleaseEvent(ze_event_handle_t event) {
+    PTI_ASSERT(event != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    auto it = event_map_.find(event);
+    PTI_ASSERT(it != event_map_.end());
+    ZeEventPool* event_pool = it->second;
+    PTI_ASSERT(event_pool->live_count > 0);
+    --event_pool->live_count;
+
+    if (event_pool->retired) {
+      status = zeEventDestroy(event);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      event_map_.erase(it);
+
+      if (event_pool->live_count == 0) {
+        auto pool = std::find(retired_pool_list_.begin(),
+                              retired_pool_list_.end(), event_pool);
+        PTI_ASSERT(pool != retired_pool_list_.end());
+        retired_pool_list_.erase(pool);
+        DestroyPool(event_pool);
+      }
+      return;
+    }
+
+    PTI_ASSERT(context_map_.count(event_pool->context) == 1);
+    status = zeEventHostReset(event);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    context_map_[event_pool->context].free_event_list.push_back(event);
+  }
+
+  // Pools with events in use stay alive until these events are released
+  void ReleaseContext(ze_context_handle_t context) {
+    PTI_ASSERT(context != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+
+    auto it = context_map_.find(context);
+    if (it != context_map_.end()) {
+      RetirePools(it->second);
+      context_map_.erase(it);
+
+      for (auto pool = retired_pool_list_.begin();
+           pool != retired_pool_list_.end();) {
+        if ((*pool)->live_count == 0) {
+          DestroyPool(*pool);
+          pool = retired_pool_list_.erase(pool);
+        } else {
+          ++pool;
+        }
+      }
+    }
+  }
+
+  ZeEventCache(const ZeEventCache& copy) = delete;
+  ZeEventCache& operator=(const ZeEventCache& copy) = delete;
+
+ private: // Implementation
+  void CreatePool(ze_context_handle_t context, ZeEventPoolList& pool_list) {
+    PTI_ASSERT(context != nullptr);
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_EVENT_CREATE);
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    uint32_t pool_size = pool_list.next_pool_size;
+    PTI_ASSERT(pool_size > 0);
+
+    ze_event_pool_desc_t event_pool_desc = {
+        ZE_STRUCTURE_TYPE_EVENT_POOL_DESC, nullptr, flags_, pool_size};
+    ze_event_pool_handle_t handle = nullptr;
+    status = zeEventPoolCreate(
+        context, &event_pool_desc, 0, nullptr, &handle);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    ZeEventPool* event_pool = new ZeEventPool{handle, context, 0, false};
+    pool_list.event_pool_list.push_back(event_pool);
+
+    for (uint32_t i = 0; i < pool_size; ++i) {
+      ze_event_desc_t event_desc = {
+          ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+          ZE_EVENT_SCOPE_FLAG_HOST, ZE_EVENT_SCOPE_FLAG_HOST};
+      ze_event_handle_t event = nullptr;
+      status = zeEventCreate(handle, &event_desc, &event);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+      PTI_ASSERT(event_map_.count(event) == 0);
+      event_map_[event] = event_pool;
+      pool_list.free_event_list.push_back(event);
+    }
+
+    if (pool_size < kMaxPoolSize) {
+      pool_list.next_pool_size = pool_size * 2;
+    }
+  }
+
+  // Free events are destroyed, the pools are moved to the retired list
+  void RetirePools(ZeEventPoolList& pool_list) {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    for (auto event : pool_list.free_event_list) {
+      status = zeEventDestroy(event);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      PTI_ASSERT(event_map_.count(event) == 1);
+      event_map_.erase(event);
+    }
+    pool_list.free_event_list.clear();
+
+    for (ZeEventPool* event_pool : pool_list.event_pool_list) {
+      event_pool->retired = true;
+      retired_pool_list_.push_back(event_pool);
+    }
+    pool_list.event_pool_list.clear();
+  }
+
+  static void DestroyPool(ZeEventPool* event_pool) {
+    PTI_ASSERT(event_pool != nullptr);
+    ze_result_t status = zeEventPoolDestroy(event_pool->handle);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    delete event_pool;
+  }
+
+ private: // Data
+  ze_event_pool_flags_t flags_;
+
+  std::mutex lock_;
+  std::map<ze_context_handle_t, ZeEventPoolList> context_map_;
+  std::map<ze_event_handle_t, ZeEventPool*> event_map_;
+  std::vector<ZeEventPool*> retired_pool_list_;
+
+  static const uint32_t kInitialPoolSize = 128;
+  static const uint32_t kMaxPoolSize = 16384;
+};
+
+#endif // PTI_TOOLS_ZE_TRACER_ZE_EVENT_CACHE_H_
@@ -7,22 +7,47 @@
 #ifndef PTI_TOOLS_ZE_TRACER_ZE_KERNEL_COLLECTOR_H_
 #define PTI_TOOLS_ZE_TRACER_ZE_KERNEL_COLLECTOR_H_
 
+#include <algorithm>
 #include <atomic>
-#include <iomanip>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <list>
 #include <map>
 #include <mutex>
-#include <set>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <level_zero/layers/zel_tracing_api.h>
 
+#include "capture_control.h"
+#include "clock_domain.h"
+#include "kernel_sampler.h"
+#include "kernel_interval_store.h"
+#include "kernel_statistics.h"
 #include "correlator.h"
+#include "dependency_graph.h"
+#include "flat_hash_map.h"
+#include "memory_tracker.h"
+#include "overhead.h"
+#include "queue_timing.h"
+#include "record_pool.h"
+#include "spsc_ring.h"
+#include "stack_table.h"
+#include "string_table.h"
+#include "tile_timing.h"
+#include "transfer_timing.h"
 #include "utils.h"
+#include "ze_event_cache.h"
 #include "ze_utils.h"
 
+#define ZE_CALL_RING_SIZE      4096
+#define ZE_CALL_DRAIN_INTERVAL 10000 // us
+#define ZE_CLOCK_SYNC_INTERVAL 100000000 // ns
+
 struct ZeSubmitData {
   uint64_t host_sync;
   uint64_t device_sync;
@@ -34,23 +59,53 @@ struct ZeKernelGroupSize {
   uint32_t z;
 };
 
+struct ZeKernelData {
+  uint32_t name_id;
+  size_t simd_width;
+  ZeKernelGroupSize group_size;
+};
+
+struct ZeDeviceData {
+  uint64_t timer_frequency;
+  uint64_t timestamp_mask;
+};
+
 struct ZeKernelProps {
-  std::string name;
+  uint32_t name_id;
   size_t simd_width;
   size_t bytes_transferred;
   uint32_t group_count[3];
   uint32_t group_size[3];
+  TransferMemoryType src_type; // Copies only, with transfer timing
+  TransferMemoryType dst_type;
+};
+
+// Kernel timestamps of a closed command list, copied into one host buffer
+// by a single query command appended at the end of the list
+struct ZeTimestampBatch {
+  ze_context_handle_t context;
+  ze_event_handle_t event; // Signaled once all the timestamps are copied
+  ze_kernel_timestamp_result_t* result_list;
+  uint32_t count;
 };
 
 struct ZeKernelCommand {
   ZeKernelProps props;
-  ze_event_pool_handle_t event_pool = nullptr;
   ze_event_handle_t event = nullptr;
+  bool own_event = false;
+  bool immediate = false;
   ze_device_handle_t device = nullptr;
   uint64_t kernel_id = 0;
   uint64_t append_time = 0;
   uint64_t timer_frequency = 0;
+  uint64_t timestamp_mask = 0; // Kernel timestamps wrap around it
   uint64_t call_count = 0;
+  const ZeTimestampBatch* batch = nullptr;
+  uint32_t batch_index = 0;
+  uint32_t stack_id = 0; // Host stack of the append, see StackTable
+  // Valid during the append only
+  const ze_event_handle_t* wait_event_list = nullptr;
+  uint32_t wait_event_count = 0;
 };
 
 struct ZeKernelCall {
@@ -61,58 +116,70 @@ struct ZeKernelCall {
   uint64_t call_id;
 };
 
-struct ZeKernelInfo {
-  uint64_t total_time;
-  uint64_t min_time;
-  uint64_t max_time;
-  uint64_t call_count;
-
-  bool operator>(const ZeKernelInfo& r) const {
-    if (total_time != r.total_time) {
-      return total_time > r.total_time;
-    }
-    return call_count > r.call_count;
-  }
+// Execution of a regular command list. Calls of all its commands are
+// kept in one array, allocated once per slot and reused by the next
+// executions once all the calls are processed. If the list is executed
+// again before that, both executions signal the same events
+struct ZeReplay {
+  ze_command_list_handle_t command_list;
+  uint64_t replay_index; // Number of the execution of the list
+  std::vector<ZeKernelCall> call_list; // Processed or untraced have no command
+  uint32_t pending_count; // Calls left to process
+  bool busy; // Slot is taken by the processing thread, guarded by lock_
+  // Device submit time of the next execution of the list if it came
+  // before this one was processed, events may hold its results then
+  std::atomic<uint64_t> superseded_time;
+  std::atomic<bool> orphan; // List was reset or destroyed meanwhile
+};
 
-  bool operator!=(const ZeKernelInfo& r) const {
-    if (total_time == r.total_time) {
-      return call_count != r.call_count;
-    }
-    return true;
-  }
+// Submission record passed to the processing thread, either a call of
+// an immediate command list or an execution of a regular one
+struct ZeCallRecord {
+  ZeKernelCall* call;
+  ZeReplay* replay;
 };
 
-struct ZeCommandListInfo {
-  std::vector<ZeKernelCommand*> kernel_command_list;
+using ZeKernelInfo = KernelInfo;
+
+// Everything an append needs to know about its command list, fetched
+// with a single lookup
+struct ZeCommandListProps {
   ze_context_handle_t context;
   ze_device_handle_t device;
   bool immediate;
+  uint64_t timer_frequency;
+  uint64_t timestamp_mask;
 };
 
-#ifdef PTI_KERNEL_INTERVALS
-
-struct ZeDeviceInterval {
-  uint64_t start;
-  uint64_t end;
-  uint32_t sub_device_id;
-};
-
-struct ZeKernelInterval {
-  std::string kernel_name;
-  ze_device_handle_t device;
-  std::vector<ZeDeviceInterval> device_interval_list;
+struct ZeCommandListInfo {
+  std::vector<ZeKernelCommand*> kernel_command_list;
+  ZeCommandListProps props;
+  std::vector<ZeTimestampBatch*> timestamp_batch_list;
+  std::vector<ZeReplay*> replay_list; // All the slots of the list
+  std::vector<ZeReplay*> free_replay_list;
+  uint64_t replay_count;
 };
 
-using ZeKernelIntervalList = std::vector<ZeKernelInterval>;
-using ZeDeviceMap = std::map<
+// Intervals are kept for root devices, in device time
+using ZeKernelIntervalStore = KernelIntervalStore<ze_device_handle_t>;
+using ZeDeviceMap = FlatHashMap<
     ze_device_handle_t, std::vector<ze_device_handle_t> >;
 
-#endif // PTI_KERNEL_INTERVALS
-
-using ZeKernelGroupSizeMap = std::map<ze_kernel_handle_t, ZeKernelGroupSize>;
-using ZeKernelInfoMap = std::map<std::string, ZeKernelInfo>;
-using ZeCommandListMap = std::map<ze_command_list_handle_t, ZeCommandListInfo>;
-using ZeImageSizeMap = std::map<ze_image_handle_t, size_t>;
+using ZeKernelDataMap = FlatHashMap<ze_kernel_handle_t, ZeKernelData>;
+using ZeDeviceDataMap = FlatHashMap<ze_device_handle_t, ZeDeviceData>;
+using ZeClockDomainMap = std::unordered_map<ze_device_handle_t, ClockDomain>;
+using ZeKernelInfoMap = KernelInfoMap;
+using ZeCommandListMap =
+  FlatHashMap<ze_command_list_handle_t, ZeCommandListInfo>;
+using ZeImageSizeMap = FlatHashMap<ze_image_handle_t, size_t>;
+using ZeKernelCallList = std::list<ZeKernelCall*>;
+using ZeKernelCallMap = std::unordered_map<
+    ze_event_handle_t, std::vector<ZeKernelCallList::iterator> >;
+
+// Per-tile timestamps of an event, an experimental extension
+typedef ze_result_t (ZE_APICALL *ZeEventQueryTimestampsExpFunction)(
+    ze_event_handle_t event, ze_device_handle_t device,
+    uint32_t* count, ze_kernel_timestamp_result_t* timestamps);
 
 typedef void (*OnZeKernelFinishCallback)(
     void* data, void* queue,
@@ -123,16 +190,54 @@ typedef void (*OnZeKernelFinishCallback)(
 class ZeKernelCollector {
  public: // Interface
 
+  // Non-zero poll interval (in us) makes the processing thread read out
+  // finished kernels periodically, not only at application sync points.
+  // Batch timestamps mode reads all the kernel timestamps of a regular
+  // command list at once from the buffer filled at the end of the list.
+  // Non-empty kernel sampling spec (see KernelSampler) makes the collector
+  // trace only a subset of launches of each kernel. If capture control is
+  // given, only launches inside the capture window are traced. Queue
+  // timing mode keeps busy and idle time of each queue and engine.
+  // Transfer timing mode classifies copies by source and destination
+  // memory and keeps achieved bandwidth per direction and engine.
+  // Memory tracking mode keeps live USM allocations with their callsites
+  // and the footprint of each device, which is passed to the memory
+  // callback on each change. Kernel intervals mode keeps the execution
+  // interval of every launch on each sub-device (see KernelIntervalStore).
+  // Tile timing mode reads per-tile timestamps of launches on root devices
+  // with sub-devices (implicit scaling) and keeps the busy time of each
+  // tile and the load imbalance of each kernel (see TileTiming).
+  // Dependency graph mode keeps the event dependencies of the commands of
+  // each command list and reports its critical path (see DependencyGraph).
+  // Call stacks mode captures the host stack of each append and keeps
+  // kernel time per launching stack (see StackTable).
+  // Grouping selects the launch config parts the kernel table rows are
+  // told by
   static ZeKernelCollector* Create(
       Correlator* correlator,
-      bool verbose,
+      KernelGrouping grouping,
       OnZeKernelFinishCallback callback = nullptr,
-      void* callback_data = nullptr) {
+      void* callback_data = nullptr,
+      uint32_t poll_interval = 0,
+      bool batch_timestamps = false,
+      const std::string& kernel_sampling = std::string(),
+      CaptureControl* capture = nullptr,
+      bool queue_timing = false,
+      bool transfer_timing = false,
+      bool memory_tracking = false,
+      OnMemoryUsageCallback memory_callback = nullptr,
+      bool kernel_intervals = false,
+      bool tile_timing = false,
+      bool dependency_graph = false,
+      bool call_stacks = false) {
     PTI_ASSERT(utils::ze::GetVersion() != ZE_API_VERSION_1_0);
 
     PTI_ASSERT(correlator != nullptr);
     ZeKernelCollector* collector = new ZeKernelCollector(
-        correlator, verbose, callback, callback_data);
+        correlator, grouping, callback, callback_data,
+        poll_interval, batch_timestamps, kernel_sampling, capture,
+        queue_timing, transfer_timing, memory_tracking, memory_callback,
+        kernel_intervals, tile_timing, dependency_graph, call_stacks);
     PTI_ASSERT(collector != nullptr);
 
     ze_result_t status = ZE_RESULT_SUCCESS;
@@ -155,53 +260,101 @@ class ZeKernelCollector {
       ze_result_t status = zelTracerDestroy(tracer_);
       PTI_ASSERT(status == ZE_RESULT_SUCCESS);
     }
+
+    {
+      const std::lock_guard<std::mutex> lock(flush_lock_);
+      stop_ = true;
+    }
+    flush_wakeup_.notify_one();
+    processing_thread_.join();
+
+    if (wait_thread_.joinable()) {
+      {
+        const std::lock_guard<std::mutex> lock(wait_lock_);
+        wait_stop_ = true;
+      }
+      wait_wakeup_.notify_one();
+      wait_thread_.join();
+    }
+
+    if (lost_call_count_ > 0) {
+      std::cerr << "[WARNING] " << lost_call_count_ <<
+        " kernel calls of command lists executed again before " <<
+        "the previous results were read are not reported" << std::endl;
+    }
   }
 
   void PrintKernelsTable() const {
-    std::set< std::pair<std::string, ZeKernelInfo>,
-              utils::Comparator > sorted_list(
-        kernel_info_map_.begin(), kernel_info_map_.end());
-
-    uint64_t total_duration = 0;
-    size_t max_name_length = kKernelLength;
-    for (auto& value : sorted_list) {
-      total_duration += value.second.total_time;
-      if (value.first.size() > max_name_length) {
-        max_name_length = value.first.size();
-      }
+    std::stringstream stream;
+    KernelStatistics::PrintTable(GetKernelInfoMap(), stream);
+    if (stream.tellp() > 0) {
+      PTI_ASSERT(correlator_ != nullptr);
+      correlator_->Log(stream.str());
     }
+  }
 
-    if (total_duration == 0) {
+  void PrintQueuesTable() const {
+    if (queue_timing_.IsEmpty()) {
       return;
     }
 
     std::stringstream stream;
-    stream << std::setw(max_name_length) << "Kernel" << "," <<
-      std::setw(kCallsLength) << "Calls" << "," <<
-      std::setw(kTimeLength) << "Time (ns)" << "," <<
-      std::setw(kPercentLength) << "Time (%)" << "," <<
-      std::setw(kTimeLength) << "Average (ns)" << "," <<
-      std::setw(kTimeLength) << "Min (ns)" << "," <<
-      std::setw(kTimeLength) << "Max (ns)" << std::endl;
-
-    for (auto& value : sorted_list) {
-      const std::string& function = value.first;
-      uint64_t call_count = value.second.call_count;
-      uint64_t duration = value.second.total_time;
-      uint64_t avg_duration = duration / call_count;
-      uint64_t min_duration = value.second.min_time;
-      uint64_t max_duration = value.second.max_time;
-      float percent_duration = 100.0f * duration / total_duration;
-      stream << std::setw(max_name_length) << function << "," <<
-        std::setw(kCallsLength) << call_count << "," <<
-        std::setw(kTimeLength) << duration << "," <<
-        std::setw(kPercentLength) << std::setprecision(2) <<
-          std::fixed << percent_duration << "," <<
-        std::setw(kTimeLength) << avg_duration << "," <<
-        std::setw(kTimeLength) << min_duration << "," <<
-        std::setw(kTimeLength) << max_duration << std::endl;
+    queue_timing_.PrintTables(stream);
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  void PrintTransfersTable() const {
+    if (transfer_timing_.IsEmpty()) {
+      return;
     }
 
+    std::stringstream stream;
+    transfer_timing_.PrintTables(stream);
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  void PrintTilesTable() const {
+    if (tile_timing_.IsEmpty()) {
+      return;
+    }
+
+    std::stringstream stream;
+    tile_timing_.PrintTables(stream);
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  void PrintDependencyTable() {
+    if (dependency_graph_.IsEmpty()) {
+      return;
+    }
+
+    std::stringstream stream;
+    dependency_graph_.PrintTables(stream);
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  void PrintStacksTable() const {
+    if (stack_table_.IsEmpty()) {
+      return;
+    }
+
+    std::stringstream stream;
+    stack_table_.PrintTables(stream);
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  void PrintMemoryTable() const {
+    if (memory_tracker_.IsEmpty()) {
+      return;
+    }
+
+    std::stringstream stream;
+    memory_tracker_.PrintTables(stream);
     PTI_ASSERT(correlator_ != nullptr);
     correlator_->Log(stream.str());
   }
@@ -211,58 +364,224 @@ class ZeKernelCollector {
     ze_result_t status = ZE_RESULT_SUCCESS;
     status = zelTracerSetEnabled(tracer_, false);
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    ProcessCalls();
+  }
+
+  // Returns once all the completed calls submitted so far are reported
+  void Flush() {
+    ProcessCalls();
   }
 
-  const ZeKernelInfoMap& GetKernelInfoMap() const {
-    return kernel_info_map_;
+  // Thins the traced launches at run time, see KernelSampler::SetThrottle
+  void SetKernelThrottle(uint32_t period) {
+    sampler_.SetThrottle(period);
   }
 
-#ifdef PTI_KERNEL_INTERVALS
-  const ZeKernelIntervalList& GetKernelIntervalList() const {
-    return kernel_interval_list_;
+  // Statistics of sampled kernels are scaled to all their launches
+  ZeKernelInfoMap GetKernelInfoMap() const {
+    return kernel_statistics_.GetInfoMap(sampler_, grouping_, FormatConfig);
+  }
+
+  // Empty unless kernel intervals are enabled, should not be called
+  // while the intervals are still added
+  const ZeKernelIntervalStore& GetKernelIntervalStore() const {
+    return kernel_interval_store_;
+  }
+
+  // Moves the intervals collected so far to the end of the given store,
+  // so that they can be processed while the application is still running
+  void TakeKernelIntervals(ZeKernelIntervalStore* store) {
+    PTI_ASSERT(store != nullptr);
+    const std::lock_guard<std::mutex> lock(interval_lock_);
+    store->Splice(&kernel_interval_store_);
   }
-#endif // PTI_KERNEL_INTERVALS
 
  private: // Implementation
 
   ZeKernelCollector(
       Correlator* correlator,
-      bool verbose,
+      KernelGrouping grouping,
       OnZeKernelFinishCallback callback,
-      void* callback_data)
+      void* callback_data,
+      uint32_t poll_interval,
+      bool batch_timestamps,
+      const std::string& kernel_sampling,
+      CaptureControl* capture,
+      bool queue_timing,
+      bool transfer_timing,
+      bool memory_tracking,
+      OnMemoryUsageCallback memory_callback,
+      bool kernel_intervals,
+      bool tile_timing,
+      bool dependency_graph,
+      bool call_stacks)
       : correlator_(correlator),
-        verbose_(verbose),
+        grouping_(grouping),
         callback_(callback),
         callback_data_(callback_data),
-        kernel_id_(1) {
+        kernel_id_(1),
+        poll_interval_(poll_interval),
+        batch_timestamps_(batch_timestamps),
+        sampler_(kernel_sampling),
+        capture_(capture),
+        queue_timing_enabled_(queue_timing),
+        transfer_timing_enabled_(transfer_timing),
+        memory_tracking_enabled_(memory_tracking),
+        kernel_intervals_enabled_(kernel_intervals),
+        call_ring_group_(ZE_CALL_RING_SIZE),
+        memory_tracker_(memory_callback, callback_data),
+        event_cache_(ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP |
+                     ZE_EVENT_POOL_FLAG_HOST_VISIBLE),
+        tile_timing_enabled_(tile_timing),
+        dependency_graph_enabled_(dependency_graph),
+        dependency_graph_("List"),
+        call_stacks_enabled_(call_stacks) {
     PTI_ASSERT(correlator_ != nullptr);
-#ifdef PTI_KERNEL_INTERVALS
-    CreateDeviceMap();
-#endif // PTI_KERNEL_INTERVALS
+    if (dependency_graph_enabled_) {
+      barrier_name_id_ = StringTable::Add("zeCommandListAppendBarrier");
+      ranges_barrier_name_id_ =
+        StringTable::Add("zeCommandListAppendMemoryRangesBarrier");
+    }
+    if (tile_timing_enabled_) {
+      EnableTileTiming();
+    }
+    if (kernel_intervals_enabled_ || tile_timing_enabled_) {
+      CreateDeviceMap();
+    }
+    processing_thread_ = std::thread(&ZeKernelCollector::Process, this);
+    if (poll_interval_ > 0) {
+      wait_thread_ = std::thread(&ZeKernelCollector::Wait, this);
+    }
+  }
+
+  void EnableTileTiming() {
+    if (batch_timestamps_) {
+      std::cerr << "[INFO] Tile timing needs kernel events and is " <<
+        "not collected in batch timestamps mode" << std::endl;
+      tile_timing_enabled_ = false;
+      return;
+    }
+
+    query_timestamps_ = reinterpret_cast<ZeEventQueryTimestampsExpFunction>(
+        utils::ze::GetExtensionFunction("zeEventQueryTimestampsExp"));
+    if (query_timestamps_ == nullptr) {
+      std::cerr << "[INFO] Per-tile timestamps are not supported " <<
+        "by the driver, tile timing is not collected" << std::endl;
+      tile_timing_enabled_ = false;
+    }
   }
 
-#ifdef PTI_KERNEL_INTERVALS
   void CreateDeviceMap() {
     std::vector<ze_device_handle_t> device_list =
       utils::ze::GetDeviceList();
     for (auto device : device_list) {
       std::vector<ze_device_handle_t> sub_device_list =
         utils::ze::GetSubDeviceList(device);
-      PTI_ASSERT(device_map_.count(device) == 0);
+      PTI_ASSERT(device_map_.Find(device) == nullptr);
       device_map_[device] = sub_device_list;
     }
   }
-#endif // PTI_KERNEL_INTERVALS
 
   uint64_t GetHostTimestamp() const {
     PTI_ASSERT(correlator_ != nullptr);
     return correlator_->GetTimestamp();
   }
 
-  uint64_t GetDeviceTimestamp(ze_device_handle_t device) const {
+  // Launch is traced if it is inside the capture window and sampled
+  bool TraceLaunch(uint32_t name_id) {
+    if (capture_ != nullptr && !capture_->CheckLaunch(name_id)) {
+      return false;
+    }
+    return sampler_.Sample(name_id);
+  }
+
+  // Device time for the given host time comes from the clock model of
+  // the device, the device itself is queried only once per sync interval
+  uint64_t EstimateDeviceTimestamp(
+      ze_device_handle_t device, uint64_t host_time) {
+    PTI_ASSERT(device != nullptr);
+    ZeDeviceData data = GetDeviceData(device);
+
+    {
+      const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+      auto it = clock_domain_map_.find(device);
+      if (it != clock_domain_map_.end() &&
+          host_time < it->second.GetLastSampleTime() +
+            ZE_CLOCK_SYNC_INTERVAL) {
+        return it->second.ToDevice(host_time) & data.timestamp_mask;
+      }
+    }
+
+    uint64_t host_start = GetHostTimestamp();
+    uint64_t device_sync = utils::ze::GetDeviceTimestamp(device);
+    uint64_t host_end = GetHostTimestamp();
+    PTI_ASSERT(host_start <= host_end);
+    uint64_t host_sync = host_start + (host_end - host_start) / 2;
+
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    auto it = clock_domain_map_.find(device);
+    if (it == clock_domain_map_.end()) {
+      it = clock_domain_map_.emplace(
+          device,
+          ClockDomain(data.timer_frequency, data.timestamp_mask)).first;
+      it->second.AddSample(host_sync, device_sync);
+    } else if (host_sync >= it->second.GetLastSampleTime() +
+                 ZE_CLOCK_SYNC_INTERVAL / 2) {
+      // Samples taken by concurrent threads at the same time are
+      // dropped, they would make the fit less precise
+      it->second.AddSample(host_sync, device_sync);
+    }
+
+    return it->second.ToDevice(host_time) & data.timestamp_mask;
+  }
+
+  // Kernel start is never placed before the submission, as the submit
+  // time on the device is estimated
+  void ConvertKernelTimestamp(
+      const ZeKernelCall* call,
+      const ze_kernel_timestamp_result_t& timestamp,
+      uint64_t* host_start, uint64_t* host_end) {
+    PTI_ASSERT(call != nullptr);
+    PTI_ASSERT(call->command != nullptr);
+    PTI_ASSERT(host_start != nullptr && host_end != nullptr);
+
+    {
+      const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+      auto it = clock_domain_map_.find(call->command->device);
+      PTI_ASSERT(it != clock_domain_map_.end());
+      const ClockDomain& domain = it->second;
+
+      uint64_t device_start = domain.Unwrap(
+          timestamp.global.kernelStart, call->submit_time);
+      uint64_t device_end = device_start +
+        ((timestamp.global.kernelEnd - timestamp.global.kernelStart) &
+         domain.GetTimestampMask());
+      *host_start = domain.ToHost(device_start);
+      *host_end = domain.ToHost(device_end);
+    }
+
+    PTI_ASSERT(*host_start <= *host_end);
+    if (*host_start < call->submit_time) {
+      *host_end += call->submit_time - *host_start;
+      *host_start = call->submit_time;
+    }
+  }
+
+  ZeDeviceData GetDeviceData(ze_device_handle_t device) {
     PTI_ASSERT(device != nullptr);
-    return utils::ze::GetDeviceTimestamp(device) &
-      utils::ze::GetDeviceTimestampMask(device);
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+
+    const ZeDeviceData* found = device_data_map_.Find(device);
+    if (found != nullptr) {
+      return *found;
+    }
+
+    ZeDeviceData data{
+        utils::ze::GetDeviceTimerFrequency(device),
+        utils::ze::GetDeviceTimestampMask(device)};
+    PTI_ASSERT(data.timer_frequency > 0);
+    device_data_map_[device] = data;
+    return data;
   }
 
   void EnableTracing(zel_tracer_handle_t tracer) {
@@ -279,6 +598,10 @@ class ZeKernelCollector {
     prologue_callbacks.EventPool.pfnCreateCb = OnEnterEventPoolCreate;
     epilogue_callbacks.EventPool.pfnCreateCb = OnExitEventPoolCreate;
 
+    prologue_callbacks.Context.pfnDestroyCb = OnEnterContextDestroy;
+
+    epilogue_callbacks.Kernel.pfnCreateCb = OnExitKernelCreate;
+
     prologue_callbacks.CommandList.pfnAppendLaunchKernelCb =
       OnEnterCommandListAppendLaunchKernel;
     epilogue_callbacks.CommandList.pfnAppendLaunchKernelCb =
@@ -355,6 +678,9 @@ class ZeKernelCollector {
       OnExitCommandListCreateImmediate;
     epilogue_callbacks.CommandList.pfnDestroyCb =
       OnExitCommandListDestroy;
+    if (batch_timestamps_) {
+      prologue_callbacks.CommandList.pfnCloseCb = OnEnterCommandListClose;
+    }
     epilogue_callbacks.CommandList.pfnResetCb =
       OnExitCommandListReset;
 
@@ -362,6 +688,18 @@ class ZeKernelCollector {
       OnExitCommandQueueSynchronize;
     epilogue_callbacks.CommandQueue.pfnDestroyCb =
       OnExitCommandQueueDestroy;
+    if (queue_timing_enabled_ || transfer_timing_enabled_) {
+      epilogue_callbacks.CommandQueue.pfnCreateCb =
+        OnExitCommandQueueCreate;
+    }
+    if (transfer_timing_enabled_ || memory_tracking_enabled_) {
+      prologue_callbacks.Mem.pfnFreeCb = OnEnterMemFree;
+    }
+    if (memory_tracking_enabled_) {
+      epilogue_callbacks.Mem.pfnAllocDeviceCb = OnExitMemAllocDevice;
+      epilogue_callbacks.Mem.pfnAllocHostCb = OnExitMemAllocHost;
+      epilogue_callbacks.Mem.pfnAllocSharedCb = OnExitMemAllocShared;
+    }
 
     epilogue_callbacks.Image.pfnCreateCb =
       OnExitImageCreate;
@@ -385,12 +723,15 @@ class ZeKernelCollector {
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
   }
 
+  // Submit paths (append, execute) still take lock_ for the command list
+  // map and the correlator id lists: the append and API callbacks read
+  // them on the calling thread, so only the call processing is handed off
   void AddKernelCommand(
       ze_command_list_handle_t command_list, ZeKernelCommand* command) {
     PTI_ASSERT(command_list != nullptr);
     PTI_ASSERT(command != nullptr);
 
-    const std::lock_guard<std::mutex> lock(lock_);
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
 
     command->kernel_id =
       kernel_id_.fetch_add(1, std::memory_order::memory_order_relaxed);
@@ -398,9 +739,19 @@ class ZeKernelCollector {
     correlator_->SetKernelId(command->kernel_id);
     correlator_->AddKernelId(command_list, command->kernel_id);
 
-    PTI_ASSERT(command_list_map_.count(command_list) == 1);
-    ZeCommandListInfo& command_list_info = command_list_map_[command_list];
-    command_list_info.kernel_command_list.push_back(command);
+    GetCommandListInfoLocked(command_list).kernel_command_list.push_back(
+        command);
+
+    if (dependency_graph_enabled_) {
+      uint32_t name_id = command->props.name_id;
+      dependency_graph_.AddNode(
+          command_list, command->kernel_id, name_id, command->event,
+          reinterpret_cast<const void* const*>(command->wait_event_list),
+          command->wait_event_count, false,
+          name_id == barrier_name_id_ || name_id == ranges_barrier_name_id_);
+    }
+    command->wait_event_list = nullptr;
+    command->wait_event_count = 0;
   }
 
   void AddKernelCall(
@@ -408,106 +759,181 @@ class ZeKernelCollector {
     PTI_ASSERT(command_list != nullptr);
     PTI_ASSERT(call != nullptr);
 
-    const std::lock_guard<std::mutex> lock(lock_);
+    {
+      const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
 
-    ZeKernelCommand* command = call->command;
-    PTI_ASSERT(command != nullptr);
-    ++(command->call_count);
-    call->call_id = command->call_count;
+      ZeKernelCommand* command = call->command;
+      PTI_ASSERT(command != nullptr);
+      ++(command->call_count);
+      call->call_id = command->call_count;
 
-    kernel_call_list_.push_back(call);
+      PTI_ASSERT(correlator_ != nullptr);
+      correlator_->AddCallId(command_list, call->call_id);
+    }
 
-    PTI_ASSERT(correlator_ != nullptr);
-    correlator_->AddCallId(command_list, call->call_id);
+    PushKernelCall(call);
   }
 
-  void ProcessCall(ze_event_handle_t event) {
-    PTI_ASSERT(event != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
+  // Submitted calls are passed to the processing thread through the ring
+  // of the calling thread, so that submissions from different threads
+  // never wait for each other or for the call processing
+  void PushKernelCall(ZeKernelCall* call) {
+    PTI_ASSERT(call != nullptr);
+    PTI_ASSERT(call->command != nullptr);
+    PTI_ASSERT(call->command->event != nullptr);
 
-    ze_result_t status = ZE_RESULT_SUCCESS;
-    status = zeEventQueryStatus(event);
-    if (status != ZE_RESULT_SUCCESS) {
-      return;
+    while (!call_ring_group_.Push({call, nullptr})) {
+      flush_wakeup_.notify_one();
+      std::this_thread::yield();
     }
+  }
 
-    for (auto it = kernel_call_list_.begin();
-         it != kernel_call_list_.end(); ++it) {
-      ZeKernelCall* call = *it;
-      PTI_ASSERT(call != nullptr);
-      ZeKernelCommand* command = call->command;
-      PTI_ASSERT(command != nullptr);
+  void PushReplay(ZeReplay* replay) {
+    PTI_ASSERT(replay != nullptr);
+    PTI_ASSERT(replay->pending_count > 0);
+
+    while (!call_ring_group_.Push({nullptr, replay})) {
+      flush_wakeup_.notify_one();
+      std::this_thread::yield();
+    }
+  }
+
+  // The following helpers are called on the processing thread only
+  void InsertKernelCall(ZeKernelCall* call) {
+    PTI_ASSERT(call != nullptr);
+    PTI_ASSERT(call->command != nullptr);
+    PTI_ASSERT(call->command->event != nullptr);
+
+    auto it = kernel_call_list_.insert(kernel_call_list_.end(), call);
+    kernel_call_map_[call->command->event].push_back(it);
+  }
+
+  ZeKernelCallList::iterator EraseKernelCall(
+      ZeKernelCallList::iterator it, ze_event_handle_t event) {
+    PTI_ASSERT(event != nullptr);
 
-      if (command->event == event) {
-        ProcessCall(call);
-        kernel_call_list_.erase(it);
+    auto result = kernel_call_map_.find(event);
+    PTI_ASSERT(result != kernel_call_map_.end());
+
+    std::vector<ZeKernelCallList::iterator>& call_list = result->second;
+    for (auto call = call_list.begin(); call != call_list.end(); ++call) {
+      if (*call == it) {
+        call_list.erase(call);
         break;
       }
     }
+    if (call_list.empty()) {
+      kernel_call_map_.erase(result);
+    }
+
+    return kernel_call_list_.erase(it);
   }
 
-  void ProcessCall(const ZeKernelCall* call) {
-    PTI_ASSERT(call != nullptr);
-    ZeKernelCommand* command = call->command;
+  // Returns false if the kernel is not finished yet
+  static bool QueryKernelTimestamp(
+      const ZeKernelCommand* command,
+      ze_kernel_timestamp_result_t* timestamp) {
     PTI_ASSERT(command != nullptr);
-
+    PTI_ASSERT(timestamp != nullptr);
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_TIMESTAMP_READ);
     ze_result_t status = ZE_RESULT_SUCCESS;
+
+    const ZeTimestampBatch* batch = command->batch;
+    if (batch != nullptr) {
+      status = zeEventQueryStatus(batch->event);
+      if (status == ZE_RESULT_NOT_READY) {
+        return false;
+      }
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      PTI_ASSERT(command->batch_index < batch->count);
+      *timestamp = batch->result_list[command->batch_index];
+      return true;
+    }
+
+    PTI_ASSERT(command->event != nullptr);
     status = zeEventQueryStatus(command->event);
+    if (status == ZE_RESULT_NOT_READY) {
+      return false;
+    }
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-
-    ze_kernel_timestamp_result_t timestamp{};
-    status = zeEventQueryKernelTimestamp(command->event, &timestamp);
+    status = zeEventQueryKernelTimestamp(command->event, timestamp);
     PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    return true;
+  }
 
-    uint64_t start = timestamp.global.kernelStart;
-    uint64_t end = timestamp.global.kernelEnd;
-    uint64_t freq = command->timer_frequency;
-    PTI_ASSERT(freq > 0);
-
-    uint64_t duration = 0;
-    if (start < end) {
-      duration = (end - start) *
-        static_cast<uint64_t>(NSEC_IN_SEC) / freq;
-    } else { // 32-bit timer overflow
-      duration = ((1ull << 32) + end - start) *
-        static_cast<uint64_t>(NSEC_IN_SEC) / freq;
-    }
+  void ProcessCall(
+      const ZeKernelCall* call,
+      const ze_kernel_timestamp_result_t& timestamp) {
+    PTI_ASSERT(call != nullptr);
+    ZeKernelCommand* command = call->command;
+    PTI_ASSERT(command != nullptr);
 
     PTI_ASSERT(call->submit_time > 0);
     PTI_ASSERT(call->device_submit_time > 0);
-    PTI_ASSERT(start > call->device_submit_time);
-    uint64_t time_shift = (start - call->device_submit_time) *
-      static_cast<uint64_t>(NSEC_IN_SEC) / freq;
-    uint64_t host_start = call->submit_time + time_shift;
-    uint64_t host_end = host_start + duration;
+    uint64_t host_start = 0, host_end = 0;
+    ConvertKernelTimestamp(call, timestamp, &host_start, &host_end);
+
+    kernel_statistics_.Add(GetConfig(command->props), host_end - host_start);
+    if (kernel_intervals_enabled_) {
+      const std::lock_guard<std::mutex> lock(interval_lock_);
+      AddKernelInterval(command, timestamp);
+    }
+    if (tile_timing_enabled_) {
+      AddTileTiming(call);
+    }
+    if (dependency_graph_enabled_) {
+      // Executions of a regular command list are told by submission
+      dependency_graph_.AddTime(
+          command->kernel_id, command->immediate ? 0 : call->submit_time,
+          host_start, host_end);
+    }
+    if (call_stacks_enabled_) {
+      stack_table_.AddTime(
+          command->stack_id, command->props.name_id, host_end - host_start);
+    }
+
+    if (queue_timing_enabled_) {
+      PTI_ASSERT(call->queue != nullptr);
+      queue_timing_.AddCommand(
+          call->queue, GetQueueEngine(call->queue),
+          call->submit_time, host_start, host_end);
+    }
 
-    AddKernelInfo(host_end - host_start, &command->props);
-#ifdef PTI_KERNEL_INTERVALS
-    AddKernelInterval(command);
-#endif // PTI_KERNEL_INTERVALS
+    if (transfer_timing_enabled_ &&
+        command->props.src_type != TRANSFER_MEMORY_UNKNOWN) {
+      PTI_ASSERT(call->queue != nullptr);
+      transfer_timing_.AddTransfer(
+          GetQueueEngine(call->queue),
+          command->props.src_type, command->props.dst_type,
+          command->props.bytes_transferred, host_end - host_start);
+    }
 
     if (callback_ != nullptr) {
       PTI_ASSERT(command->append_time > 0);
       PTI_ASSERT(command->append_time <= call->submit_time);
 
       PTI_ASSERT(call->queue != nullptr);
-      PTI_ASSERT(!command->props.name.empty());
+      const std::string& name = StringTable::Get(command->props.name_id);
+      PTI_ASSERT(!name.empty());
       std::string id = std::to_string(command->kernel_id) + "." +
         std::to_string(call->call_id);
       callback_(
           callback_data_, call->queue,
-          id, command->props.name,
+          id, name,
           command->append_time, call->submit_time,
           host_start, host_end);
     }
 
-    delete call;
+    // Commands of immediate command lists are executed only once,
+    // so their events can be reused right after the readout
+    if (command->immediate && command->own_event) {
+      event_cache_.ReleaseEvent(command->event);
+      command->event = nullptr;
+      command->own_event = false;
+    }
   }
 
-  void ProcessCalls() {
-    ze_result_t status = ZE_RESULT_SUCCESS;
-    const std::lock_guard<std::mutex> lock(lock_);
-
+  void ProcessKernelCalls(bool polling = false) {
     auto it = kernel_call_list_.begin();
     while (it != kernel_call_list_.end()) {
       ZeKernelCall* call = *it;
@@ -515,164 +941,542 @@ class ZeKernelCollector {
       ZeKernelCommand* command = call->command;
       PTI_ASSERT(command != nullptr);
 
-      PTI_ASSERT(command->event != nullptr);
-      status = zeEventQueryStatus(command->event);
-      if (status == ZE_RESULT_NOT_READY) {
+      ze_event_handle_t event = command->event;
+      PTI_ASSERT(event != nullptr);
+      ze_kernel_timestamp_result_t timestamp{};
+      if (!QueryKernelTimestamp(command, &timestamp) ||
+          (polling && IsCallOutdated(call, timestamp))) {
         ++it;
-      } else if (status == ZE_RESULT_SUCCESS) {
-        ProcessCall(call);
-        it = kernel_call_list_.erase(it);
       } else {
-        PTI_ASSERT(0);
+        ProcessCall(call, timestamp);
+        RecordPool<ZeKernelCall>::Destroy(call);
+        it = EraseKernelCall(it, event);
+      }
+    }
+
+    ProcessReplays(polling);
+  }
+
+  void ProcessReplays(bool polling) {
+    size_t count = 0;
+    for (size_t i = 0; i < replay_list_.size(); ++i) {
+      if (!ProcessReplay(replay_list_[i], polling)) {
+        replay_list_[count++] = replay_list_[i];
+      }
+    }
+    replay_list_.resize(count);
+  }
+
+  // Calls of one execution may finish in any order, the slot is given
+  // back to the command list once all of them are processed. Returns
+  // true if the slot is released
+  bool ProcessReplay(ZeReplay* replay, bool polling) {
+    PTI_ASSERT(replay != nullptr);
+
+    if (!replay->orphan.load(std::memory_order_acquire)) {
+      for (ZeKernelCall& call : replay->call_list) {
+        if (call.command == nullptr) {
+          continue;
+        }
+
+        ze_kernel_timestamp_result_t timestamp{};
+        if (!QueryKernelTimestamp(call.command, &timestamp) ||
+            (polling && IsCallOutdated(&call, timestamp))) {
+          continue;
+        }
+
+        if (IsCallSuperseded(replay, &call, timestamp)) {
+          ++lost_call_count_;
+        } else {
+          ProcessCall(&call, timestamp);
+        }
+        call.command = nullptr;
+        PTI_ASSERT(replay->pending_count > 0);
+        --(replay->pending_count);
+      }
+
+      if (replay->pending_count > 0) {
+        return false;
+      }
+    }
+
+    ReleaseReplay(replay);
+    return true;
+  }
+
+  // Calls are taken in the order of submission while they are finished,
+  // so the work is proportional to the number of finished calls. Calls
+  // that finished behind an unfinished one are left to the next full pass
+  void ProcessReadyCalls() {
+    while (!kernel_call_list_.empty()) {
+      auto it = kernel_call_list_.begin();
+      ZeKernelCall* call = *it;
+      PTI_ASSERT(call != nullptr);
+      ZeKernelCommand* command = call->command;
+      PTI_ASSERT(command != nullptr);
+
+      ze_event_handle_t event = command->event;
+      PTI_ASSERT(event != nullptr);
+      ze_kernel_timestamp_result_t timestamp{};
+      if (!QueryKernelTimestamp(command, &timestamp)) {
+        break;
+      }
+
+      ProcessCall(call, timestamp);
+      RecordPool<ZeKernelCall>::Destroy(call);
+      EraseKernelCall(it, event);
+    }
+
+    size_t count = 0;
+    while (count < replay_list_.size() &&
+           ProcessReplay(replay_list_[count], true)) {
+      ++count;
+    }
+    replay_list_.erase(replay_list_.begin(), replay_list_.begin() + count);
+  }
+
+  // Own event of the oldest unfinished call, either of an immediate
+  // command list or the last one of a regular list execution. Nullptr if
+  // the call signals an application event, as it may be destroyed at any
+  // time by the application
+  ze_event_handle_t GetOldestEvent() const {
+    const ZeKernelCall* oldest = nullptr;
+    if (!kernel_call_list_.empty()) {
+      oldest = kernel_call_list_.front();
+    }
+
+    if (!replay_list_.empty()) {
+      const ZeReplay* replay = replay_list_.front();
+      PTI_ASSERT(replay != nullptr);
+      if (!replay->orphan.load(std::memory_order_acquire)) {
+        const ZeKernelCall* last = nullptr;
+        for (const ZeKernelCall& call : replay->call_list) {
+          if (call.command != nullptr) {
+            last = &call;
+          }
+        }
+        if (last != nullptr &&
+            (oldest == nullptr || last->submit_time < oldest->submit_time)) {
+          oldest = last;
+        }
+      }
+    }
+
+    if (oldest == nullptr) {
+      return nullptr;
+    }
+
+    const ZeKernelCommand* command = oldest->command;
+    PTI_ASSERT(command != nullptr);
+    if (command->batch != nullptr) {
+      return command->batch->event;
+    }
+    return command->own_event ? command->event : nullptr;
+  }
+
+  // Gives the oldest event to the waiter thread. The event that was
+  // signaled while its call is still not finished (e.g. by the previous
+  // execution of the list) is not given again until the oldest call
+  // changes, timed passes take care of the calls meanwhile
+  void UpdateWaitEvent(bool signaled) {
+    ze_event_handle_t event = GetOldestEvent();
+    if (signaled && event == wait_event_handed_) {
+      stale_event_ = event;
+    }
+    if (event == stale_event_) {
+      event = nullptr;
+    } else {
+      stale_event_ = nullptr;
+    }
+
+    bool changed = false;
+    {
+      const std::lock_guard<std::mutex> lock(wait_lock_);
+      if (wait_pause_count_ > 0) {
+        event = nullptr;
+      }
+      if (wait_event_ != event) {
+        wait_event_ = event;
+        changed = true;
+      }
+    }
+    wait_event_handed_ = event;
+
+    if (changed && event != nullptr) {
+      wait_wakeup_.notify_one();
+    }
+  }
+
+  // Device timestamps are compared modulo the timestamp mask, the time
+  // is taken to be after the reference if it is less than half a period
+  // ahead of it
+  static bool IsTimestampAfter(
+      uint64_t time, uint64_t reference, uint64_t mask) {
+    PTI_ASSERT(mask > 0);
+    uint64_t delta = (time - reference) & mask;
+    return delta != 0 && delta <= (mask >> 1);
+  }
+
+  // Results of a superseded execution are known to be its own only if
+  // the command started before the next execution was submitted,
+  // otherwise they are left to the latest execution of the list
+  static bool IsCallSuperseded(
+      const ZeReplay* replay, const ZeKernelCall* call,
+      const ze_kernel_timestamp_result_t& timestamp) {
+    PTI_ASSERT(replay != nullptr);
+    PTI_ASSERT(call != nullptr);
+    PTI_ASSERT(call->command != nullptr);
+    uint64_t superseded_time =
+      replay->superseded_time.load(std::memory_order_acquire);
+    if (superseded_time == 0) {
+      return false;
+    }
+    return IsTimestampAfter(
+        timestamp.global.kernelStart, superseded_time,
+        call->command->timestamp_mask);
+  }
+
+  // Polling may find the event of a resubmitted command list still
+  // signaled by the previous execution, such a call is not finished yet
+  static bool IsCallOutdated(
+      const ZeKernelCall* call,
+      const ze_kernel_timestamp_result_t& timestamp) {
+    PTI_ASSERT(call != nullptr);
+    PTI_ASSERT(call->command != nullptr);
+    if (call->command->immediate) {
+      return false;
+    }
+    return !IsTimestampAfter(
+        timestamp.global.kernelStart, call->device_submit_time,
+        call->command->timestamp_mask);
+  }
+
+  void DrainKernelCalls() {
+    call_ring_group_.Drain([this](const ZeCallRecord& record) {
+      if (record.call != nullptr) {
+        InsertKernelCall(record.call);
+      } else {
+        PTI_ASSERT(record.replay != nullptr);
+        replay_list_.push_back(record.replay);
+      }
+    });
+  }
+
+  // Processing thread owns the call list and kernel statistics. It takes
+  // new calls from the rings periodically and processes completed calls
+  // on request, the request is served after all the calls pushed before
+  // it are taken from the rings. In polling mode completed calls are also
+  // processed once the waiter thread sees the oldest event signaled (or
+  // every poll interval if there is no event to wait for), so the call
+  // list stays short even if the application never synchronizes on its
+  // events
+  void Process() {
+    uint32_t interval = ZE_CALL_DRAIN_INTERVAL;
+    if (poll_interval_ > 0 && poll_interval_ < interval) {
+      interval = poll_interval_;
+    }
+    std::chrono::steady_clock::time_point poll_time =
+      std::chrono::steady_clock::now();
+
+    uint64_t flush_count = 0;
+    while (true) {
+      uint64_t flush_request = 0;
+      bool signaled = false;
+      bool stop = false;
+      {
+        std::unique_lock<std::mutex> lock(flush_lock_);
+        flush_wakeup_.wait_for(
+            lock, std::chrono::microseconds(interval),
+            [this, flush_count] {
+              return stop_ || wait_signaled_ || flush_request_ != flush_count;
+            });
+        flush_request = flush_request_;
+        signaled = wait_signaled_;
+        wait_signaled_ = false;
+        stop = stop_;
+      }
+
+      DrainKernelCalls();
+
+      if (flush_request != flush_count) {
+        ProcessKernelCalls();
+      } else if (signaled) {
+        ProcessReadyCalls();
+      } else if (poll_interval_ > 0 && wait_event_handed_ == nullptr &&
+                 std::chrono::steady_clock::now() - poll_time >=
+                 std::chrono::microseconds(poll_interval_)) {
+        ProcessKernelCalls(true);
+        poll_time = std::chrono::steady_clock::now();
+      }
+
+      if (poll_interval_ > 0) {
+        UpdateWaitEvent(signaled);
+      }
+
+      if (flush_request != flush_count) {
+        flush_count = flush_request;
+        {
+          const std::lock_guard<std::mutex> lock(flush_lock_);
+          flush_count_ = flush_count;
+        }
+        flush_done_.notify_all();
+      }
+
+      if (stop) {
+        break;
+      }
+    }
+  }
+
+  // Waiter thread blocks on the event given by the processing thread and
+  // wakes that thread up once the event is signaled. The wait is bounded
+  // by the poll interval, so the event may be taken away at any time
+  void Wait() {
+    uint64_t timeout = static_cast<uint64_t>(poll_interval_) * 1000; // ns
+    while (true) {
+      ze_event_handle_t event = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(wait_lock_);
+        wait_wakeup_.wait(lock, [this] {
+          return wait_stop_ || wait_event_ != nullptr;
+        });
+        if (wait_stop_) {
+          break;
+        }
+        event = wait_event_;
+        wait_busy_ = true;
+      }
+
+      ze_result_t status = zeEventHostSynchronize(event, timeout);
+
+      bool signaled = false;
+      {
+        const std::lock_guard<std::mutex> lock(wait_lock_);
+        wait_busy_ = false;
+        if (status != ZE_RESULT_NOT_READY && wait_event_ == event) {
+          wait_event_ = nullptr;
+          signaled = true;
+        }
+      }
+      wait_idle_.notify_all();
+
+      if (signaled) {
+        {
+          const std::lock_guard<std::mutex> lock(flush_lock_);
+          wait_signaled_ = true;
+        }
+        flush_wakeup_.notify_one();
+      }
+    }
+  }
+
+  // Event pools of a context are destroyed right after the pause, so
+  // the waiter should not block on any of their events till the resume
+  void PauseWaiter() {
+    std::unique_lock<std::mutex> lock(wait_lock_);
+    ++wait_pause_count_;
+    wait_event_ = nullptr;
+    wait_idle_.wait(lock, [this] { return !wait_busy_; });
+  }
+
+  void ResumeWaiter() {
+    const std::lock_guard<std::mutex> lock(wait_lock_);
+    PTI_ASSERT(wait_pause_count_ > 0);
+    --wait_pause_count_;
+  }
+
+  // Returns once all the completed calls submitted so far are processed.
+  // Calls made by the processing and waiter threads themselves (e.g.
+  // event reset on release) are traced as well and must not wait for
+  // the processing thread
+  void ProcessCalls() {
+    if (std::this_thread::get_id() == processing_thread_.get_id() ||
+        std::this_thread::get_id() == wait_thread_.get_id()) {
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock(flush_lock_);
+    uint64_t flush_request = ++flush_request_;
+    flush_wakeup_.notify_one();
+    flush_done_.wait(lock, [this, flush_request] {
+      return flush_count_ >= flush_request;
+    });
+  }
+
+  // Sizes are only taken from kernels, copies are told by their size
+  static KernelConfig GetConfig(const ZeKernelProps& props) {
+    KernelConfig config{};
+    config.name_id = props.name_id;
+    if (props.simd_width > 0) {
+      config.simd_width = static_cast<uint32_t>(props.simd_width);
+      for (int i = 0; i < 3; ++i) {
+        config.global_size[i] = props.group_count[i];
+        config.local_size[i] = props.group_size[i];
       }
+    } else {
+      config.bytes_transferred = props.bytes_transferred;
     }
+    return config;
   }
 
-  static std::string GetVerboseName(
-      const std::string& name, const ZeKernelProps* props) {
+  static std::string FormatConfig(
+      const KernelConfig& config, KernelGrouping grouping) {
+    const std::string& name = StringTable::Get(config.name_id);
     PTI_ASSERT(!name.empty());
-    PTI_ASSERT(props != nullptr);
 
     std::stringstream sstream;
     sstream << name;
-    if (props->simd_width > 0) {
-      sstream << "[SIMD" << props->simd_width << " {" <<
-        props->group_count[0] << "; " <<
-        props->group_count[1] << "; " <<
-        props->group_count[2] << "} {" <<
-        props->group_size[0] << "; " <<
-        props->group_size[1] << "; " <<
-        props->group_size[2] << "}]";
-    } else if (props->bytes_transferred > 0) {
-      sstream << "[" << props->bytes_transferred << " bytes]";
+    if (config.simd_width > 0) {
+      sstream << "[SIMD" << config.simd_width << " {";
+      if (grouping == KERNEL_GROUPING_CONFIG) {
+        sstream <<
+          config.global_size[0] << "; " <<
+          config.global_size[1] << "; " <<
+          config.global_size[2] << "} {";
+      }
+      sstream <<
+        config.local_size[0] << "; " <<
+        config.local_size[1] << "; " <<
+        config.local_size[2] << "}]";
+    } else if (config.bytes_transferred > 0) {
+      sstream << "[" << config.bytes_transferred << " bytes]";
     }
 
     return sstream.str();
   }
 
-  void AddKernelInfo(uint64_t time, const ZeKernelProps* props) {
-    PTI_ASSERT(props != nullptr);
+  // Grouped names are formatted once per launch config
+  uint32_t GetIntervalNameId(const ZeKernelProps& props) {
+    if (grouping_ == KERNEL_GROUPING_NAME) {
+      return props.name_id;
+    }
 
-    std::string name = props->name;
-    PTI_ASSERT(!name.empty());
+    KernelConfig config =
+      KernelStatistics::GetGroup(GetConfig(props), grouping_);
+    uint32_t* name_id = interval_name_map_.Find(config);
+    if (name_id != nullptr) {
+      return *name_id;
+    }
+    uint32_t id = StringTable::Add(FormatConfig(config, grouping_));
+    interval_name_map_[config] = id;
+    return id;
+  }
+
+  void AddKernelInterval(
+      const ZeKernelCommand* command,
+      const ze_kernel_timestamp_result_t& timestamp) {
+    PTI_ASSERT(command != nullptr);
+
+    uint32_t name_id = GetIntervalNameId(command->props);
+    PTI_ASSERT(!StringTable::Get(name_id).empty());
+
+    // Whole launch interval, per-tile ones are read by AddTileTiming
+    uint64_t start = timestamp.global.kernelStart;
+    uint64_t end = timestamp.global.kernelEnd;
+    uint64_t freq = command->timer_frequency;
+    PTI_ASSERT(freq > 0);
 
-    if (verbose_) {
-      name = GetVerboseName(name, props);
+    uint64_t duration = 0;
+    if (start < end) {
+      duration = (end - start) *
+        static_cast<uint64_t>(NSEC_IN_SEC) / freq;
+    } else { // 32-bit timer overflow
+      duration = ((1ull << 32) + end - start) *
+        static_cast<uint64_t>(NSEC_IN_SEC) / freq;
     }
 
-    if (kernel_info_map_.count(name) == 0) {
-      kernel_info_map_[name] = {time, time, time, 1};
-    } else {
-      ZeKernelInfo& kernel = kernel_info_map_[name];
-      kernel.total_time += time;
-      if (time > kernel.max_time) {
-        kernel.max_time = time;
-      }
-      if (time < kernel.min_time) {
-        kernel.min_time = time;
+    uint64_t start_ns = start *
+      static_cast<uint64_t>(NSEC_IN_SEC) / freq;
+    uint64_t end_ns = start_ns + duration;
+    PTI_ASSERT(start_ns < end_ns);
+
+    const std::vector<ze_device_handle_t>* sub_device_list =
+      device_map_.Find(command->device);
+    if (sub_device_list != nullptr &&
+        !sub_device_list->empty()) { // Implicit Scaling
+      PTI_ASSERT(sub_device_list->size() <
+                 (std::numeric_limits<uint32_t>::max)());
+      kernel_interval_store_.AddLaunch(
+          name_id, command->device, start_ns, end_ns, 0,
+          static_cast<uint32_t>(sub_device_list->size()));
+    } else if (sub_device_list == nullptr) { // Subdevice
+      for (auto& it : device_map_) {
+        const std::vector<ze_device_handle_t>& device_list = it.second;
+        for (size_t i = 0; i < device_list.size(); ++i) {
+          if (device_list[i] == command->device) {
+            PTI_ASSERT(i < (std::numeric_limits<uint32_t>::max)());
+            kernel_interval_store_.AddLaunch(
+                name_id, it.first, start_ns, end_ns,
+                static_cast<uint32_t>(i), 1);
+            return;
+          }
+        }
       }
-      kernel.call_count += 1;
+      PTI_ASSERT(0);
+    } else { // Device with no subdevices
+      kernel_interval_store_.AddLaunch(
+          name_id, command->device, start_ns, end_ns, 0, 1);
     }
   }
 
-#ifdef PTI_KERNEL_INTERVALS
-  void AddKernelInterval(const ZeKernelCommand* command) {
+  // Launches on a root device with sub-devices are split over its tiles,
+  // which report their timestamps one by one. Tile times are converted
+  // with the clock domain of the root device, they share its timer
+  void AddTileTiming(const ZeKernelCall* call) {
+    PTI_ASSERT(call != nullptr);
+    const ZeKernelCommand* command = call->command;
     PTI_ASSERT(command != nullptr);
+    PTI_ASSERT(query_timestamps_ != nullptr);
 
-    std::string name = command->props.name;
-    PTI_ASSERT(!name.empty());
-
-    if (verbose_) {
-      name = GetVerboseName(name, &command->props);
+    const std::vector<ze_device_handle_t>* sub_device_list =
+      device_map_.Find(command->device);
+    if (sub_device_list == nullptr || sub_device_list->size() < 2 ||
+        command->event == nullptr) {
+      return;
     }
 
-    ze_result_t status = zeEventQueryStatus(command->event);
-    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-
-    if (device_map_.count(command->device) == 1 &&
-        !device_map_[command->device].empty()) { // Implicit Scaling
-      // TODO: Use zeEventQueryTimestampsExp for better results
-      ze_kernel_timestamp_result_t timestamp{};
-      status = zeEventQueryKernelTimestamp(command->event, &timestamp);
-      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-
-      uint64_t start = timestamp.global.kernelStart;
-      uint64_t end = timestamp.global.kernelEnd;
-      uint64_t freq = command->timer_frequency;
-      PTI_ASSERT(freq > 0);
-
-      uint64_t duration = 0;
-      if (start < end) {
-        duration = (end - start) *
-          static_cast<uint64_t>(NSEC_IN_SEC) / freq;
-      } else { // 32-bit timer overflow
-        duration = ((1ull << 32) + end - start) *
-          static_cast<uint64_t>(NSEC_IN_SEC) / freq;
-      }
-
-      uint64_t start_ns = start *
-        static_cast<uint64_t>(NSEC_IN_SEC) / freq;
-      uint64_t end_ns = start_ns + duration;
-      PTI_ASSERT(start_ns < end_ns);
-
-      ZeKernelInterval kernel_interval{
-          name, command->device, std::vector<ZeDeviceInterval>()};
-      for (size_t i = 0; i < device_map_[command->device].size(); ++i) {
-        PTI_ASSERT(i < (std::numeric_limits<uint32_t>::max)());
-        kernel_interval.device_interval_list.push_back(
-            {start_ns, end_ns, static_cast<uint32_t>(i)});
+    {
+      OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_TIMESTAMP_READ);
+      uint32_t count = 0;
+      ze_result_t status = query_timestamps_(
+          command->event, command->device, &count, nullptr);
+      if (status != ZE_RESULT_SUCCESS || count < 2) {
+        return;
       }
-      kernel_interval_list_.push_back(kernel_interval);
-    } else { // Explicit scaling
-      ze_kernel_timestamp_result_t timestamp{};
-      status = zeEventQueryKernelTimestamp(command->event, &timestamp);
-      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-
-      uint64_t start = timestamp.global.kernelStart;
-      uint64_t end = timestamp.global.kernelEnd;
-      uint64_t freq = command->timer_frequency;
-      PTI_ASSERT(freq > 0);
-
-      uint64_t duration = 0;
-      if (start < end) {
-        duration = (end - start) *
-          static_cast<uint64_t>(NSEC_IN_SEC) / freq;
-      } else { // 32-bit timer overflow
-        duration = ((1ull << 32) + end - start) *
-          static_cast<uint64_t>(NSEC_IN_SEC) / freq;
+      tile_timestamp_list_.resize(count);
+      status = query_timestamps_(
+          command->event, command->device, &count,
+          tile_timestamp_list_.data());
+      if (status != ZE_RESULT_SUCCESS || count < 2) {
+        return;
       }
+      tile_timestamp_list_.resize(count);
+    }
 
-      uint64_t start_ns = start *
-        static_cast<uint64_t>(NSEC_IN_SEC) / freq;
-      uint64_t end_ns = start_ns + duration;
-      PTI_ASSERT(start_ns < end_ns);
-
-      if (device_map_.count(command->device) == 0) { // Subdevice
-        for (auto it : device_map_) {
-          std::vector<ze_device_handle_t> sub_device_list = it.second;
-          for (size_t i = 0; i < sub_device_list.size(); ++i) {
-            if (sub_device_list[i] == command->device) {
-              ZeKernelInterval kernel_interval{
-                  name, it.first, std::vector<ZeDeviceInterval>()};
-              PTI_ASSERT(i < (std::numeric_limits<uint32_t>::max)());
-              kernel_interval.device_interval_list.push_back(
-                  {start_ns, end_ns, static_cast<uint32_t>(i)});
-              kernel_interval_list_.push_back(kernel_interval);
-              return;
-            }
-          }
-        }
-        PTI_ASSERT(0);
-      } else { // Device with no subdevices
-        PTI_ASSERT(device_map_[command->device].empty());
-        ZeKernelInterval kernel_interval{
-            name, command->device, std::vector<ZeDeviceInterval>()};
-        kernel_interval.device_interval_list.push_back({start_ns, end_ns, 0});
-        kernel_interval_list_.push_back(kernel_interval);
+    std::vector<TileInterval> tile_list(tile_timestamp_list_.size());
+    {
+      const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+      auto it = clock_domain_map_.find(command->device);
+      PTI_ASSERT(it != clock_domain_map_.end());
+      const ClockDomain& domain = it->second;
+
+      for (size_t i = 0; i < tile_timestamp_list_.size(); ++i) {
+        const ze_kernel_timestamp_result_t& timestamp =
+          tile_timestamp_list_[i];
+        uint64_t device_start = domain.Unwrap(
+            timestamp.global.kernelStart, call->submit_time);
+        uint64_t device_end = device_start +
+          ((timestamp.global.kernelEnd - timestamp.global.kernelStart) &
+           domain.GetTimestampMask());
+        tile_list[i].start = domain.ToHost(device_start);
+        tile_list[i].end = domain.ToHost(device_end);
       }
     }
+
+    tile_timing_.AddLaunch(
+        StringTable::Get(command->props.name_id),
+        GetDeviceIndex(command->device), tile_list);
   }
-#endif // PTI_KERNEL_INTERVALS
 
   void AddCommandList(
       ze_command_list_handle_t command_list,
@@ -681,164 +1485,468 @@ class ZeKernelCollector {
       bool immediate) {
     PTI_ASSERT(command_list != nullptr);
     PTI_ASSERT(context != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(command_list_map_.count(command_list) == 0);
-    command_list_map_[command_list] =
-      {std::vector<ZeKernelCommand*>(), context, device, immediate};
+    ZeDeviceData data = GetDeviceData(device);
+
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    PTI_ASSERT(command_list_map_.Find(command_list) == nullptr);
+    command_list_map_[command_list].props =
+      {context, device, immediate, data.timer_frequency, data.timestamp_mask};
 
     PTI_ASSERT(correlator_ != nullptr);
-    correlator_->CreateKernelIdList(command_list);
-    correlator_->CreateCallIdList(command_list);
+    correlator_->CreateIdList(command_list);
+  }
+
+  // Engine is given by the device (or sub-device) and the queue group
+  // ordinal and index the queue or immediate command list is created for
+  void AddQueueEngine(
+      void* queue, ze_device_handle_t device,
+      const ze_command_queue_desc_t* desc) {
+    PTI_ASSERT(queue != nullptr);
+    PTI_ASSERT(device != nullptr);
+    PTI_ASSERT(desc != nullptr);
+
+    std::stringstream engine;
+    engine << "Device " << utils::ze::GetDeviceLabel(device) <<
+      " Engine " << desc->ordinal << "." << desc->index;
+
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    queue_engine_map_[queue] = engine.str();
+  }
+
+  std::string GetQueueEngine(void* queue) {
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    const std::string* engine = queue_engine_map_.Find(queue);
+    if (engine == nullptr) {
+      return "Unknown";
+    }
+    return *engine;
   }
 
   void RemoveKernelCommands(ze_command_list_handle_t command_list) {
     PTI_ASSERT(command_list != nullptr);
 
-    PTI_ASSERT(command_list_map_.count(command_list) == 1);
-    ZeCommandListInfo& info = command_list_map_[command_list];
+    ZeCommandListInfo& info = GetCommandListInfoLocked(command_list);
     for (ZeKernelCommand* command : info.kernel_command_list) {
-      if (command->event_pool != nullptr) {
-        ze_result_t status = ZE_RESULT_SUCCESS;
-        status = zeEventDestroy(command->event);
-        PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-        status = zeEventPoolDestroy(command->event_pool);
-        PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      if (command->own_event) {
+        event_cache_.ReleaseEvent(command->event);
+      }
+      RecordPool<ZeKernelCommand>::Destroy(command);
+    }
+    info.kernel_command_list.clear();
+
+    for (ZeTimestampBatch* batch : info.timestamp_batch_list) {
+      ReleaseTimestampBatch(batch);
+    }
+    info.timestamp_batch_list.clear();
+
+    // Slots still taken are freed by the processing thread
+    for (ZeReplay* replay : info.replay_list) {
+      if (replay->busy) {
+        replay->orphan.store(true, std::memory_order_release);
+      } else {
+        delete replay;
+      }
+    }
+    info.replay_list.clear();
+    info.free_replay_list.clear();
+    info.replay_count = 0;
+  }
+
+  // Kernels with own events are queried together once the command list
+  // is closed, the others keep per-event readout. If the query can't be
+  // appended, all the kernels of the list fall back to per-event readout
+  void AppendTimestampQuery(ze_command_list_handle_t command_list) {
+    PTI_ASSERT(command_list != nullptr);
+
+    ze_context_handle_t context = nullptr;
+    std::vector<ZeKernelCommand*> batch_command_list;
+    {
+      const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+      ZeCommandListInfo& info = GetCommandListInfoLocked(command_list);
+      if (info.props.immediate) {
+        return;
       }
 
-      for (ZeKernelCall* call : kernel_call_list_) {
-        PTI_ASSERT(call->command != command);
+      context = info.props.context;
+      for (ZeKernelCommand* command : info.kernel_command_list) {
+        if (command->own_event && command->batch == nullptr) {
+          batch_command_list.push_back(command);
+        }
       }
+    }
 
-      delete command;
+    if (batch_command_list.empty()) {
+      return;
     }
-    info.kernel_command_list.clear();
+
+    std::vector<ze_event_handle_t> event_list;
+    for (ZeKernelCommand* command : batch_command_list) {
+      event_list.push_back(command->event);
+    }
+    PTI_ASSERT(event_list.size() < (std::numeric_limits<uint32_t>::max)());
+    uint32_t count = static_cast<uint32_t>(event_list.size());
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    ze_host_mem_alloc_desc_t alloc_desc = {
+        ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC, nullptr, 0};
+    void* buffer = nullptr;
+    status = zeMemAllocHost(
+        context, &alloc_desc, count * sizeof(ze_kernel_timestamp_result_t),
+        sizeof(uint64_t), &buffer);
+    if (status != ZE_RESULT_SUCCESS) {
+      return;
+    }
+
+    ZeTimestampBatch* batch = new ZeTimestampBatch{
+        context, event_cache_.GetEvent(context),
+        static_cast<ze_kernel_timestamp_result_t*>(buffer), count};
+    PTI_ASSERT(batch != nullptr);
+
+    status = zeCommandListAppendQueryKernelTimestamps(
+        command_list, count, event_list.data(), buffer,
+        nullptr, batch->event, 0, nullptr);
+    if (status != ZE_RESULT_SUCCESS) {
+      ReleaseTimestampBatch(batch);
+      return;
+    }
+
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    GetCommandListInfoLocked(command_list).timestamp_batch_list.push_back(
+        batch);
+    for (uint32_t i = 0; i < count; ++i) {
+      batch_command_list[i]->batch = batch;
+      batch_command_list[i]->batch_index = i;
+    }
+  }
+
+  void ReleaseTimestampBatch(ZeTimestampBatch* batch) {
+    PTI_ASSERT(batch != nullptr);
+    event_cache_.ReleaseEvent(batch->event);
+    ze_result_t status = zeMemFree(batch->context, batch->result_list);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    delete batch;
   }
 
   void RemoveCommandList(ze_command_list_handle_t command_list) {
     PTI_ASSERT(command_list != nullptr);
 
-    const std::lock_guard<std::mutex> lock(lock_);
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
 
     RemoveKernelCommands(command_list);
-    command_list_map_.erase(command_list);
+    command_list_map_.Erase(command_list);
 
     PTI_ASSERT(correlator_ != nullptr);
-    correlator_->RemoveKernelIdList(command_list);
-    correlator_->RemoveCallIdList(command_list);
+    correlator_->RemoveIdList(command_list);
   }
 
   void ResetCommandList(ze_command_list_handle_t command_list) {
     PTI_ASSERT(command_list != nullptr);
 
-    const std::lock_guard<std::mutex> lock(lock_);
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
 
     RemoveKernelCommands(command_list);
 
     PTI_ASSERT(correlator_ != nullptr);
-    correlator_->ResetKernelIdList(command_list);
-    correlator_->ResetCallIdList(command_list);
+    correlator_->ResetIdList(command_list);
+  }
+
+  // Takes a free slot of the command list or adds a new one if all the
+  // slots are still being processed, so the number of slots is bounded
+  // by the number of executions of the list in flight
+  static ZeReplay* AcquireReplay(
+      ze_command_list_handle_t command_list, ZeCommandListInfo& info) {
+    PTI_ASSERT(command_list != nullptr);
+
+    ZeReplay* replay = nullptr;
+    if (info.free_replay_list.empty()) {
+      replay = new ZeReplay;
+      PTI_ASSERT(replay != nullptr);
+      replay->command_list = command_list;
+      replay->orphan.store(false, std::memory_order_relaxed);
+      info.replay_list.push_back(replay);
+    } else {
+      replay = info.free_replay_list.back();
+      info.free_replay_list.pop_back();
+    }
+
+    replay->replay_index = ++info.replay_count;
+    replay->call_list.resize(info.kernel_command_list.size());
+    replay->pending_count = 0;
+    replay->busy = true;
+    replay->superseded_time.store(0, std::memory_order_relaxed);
+    return replay;
+  }
+
+  void ReleaseReplay(ZeReplay* replay) {
+    PTI_ASSERT(replay != nullptr);
+
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    if (replay->orphan.load(std::memory_order_acquire)) {
+      delete replay;
+      return;
+    }
+
+    replay->busy = false;
+    ZeCommandListInfo& info = GetCommandListInfoLocked(replay->command_list);
+    info.free_replay_list.push_back(replay);
   }
 
+  // Each execution of a regular command list fills the preallocated
+  // calls of a replay slot and passes the slot as a whole, the slot is
+  // taken under lock_ (see AddKernelCommand)
   void AddKernelCalls(
       ze_command_list_handle_t command_list,
       ze_command_queue_handle_t queue, const ZeSubmitData* submit_data) {
     PTI_ASSERT(command_list != nullptr);
+    PTI_ASSERT(submit_data != nullptr);
 
-    const std::lock_guard<std::mutex> lock(lock_);
+    ZeReplay* replay = nullptr;
+    {
+      const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
 
-    PTI_ASSERT(command_list_map_.count(command_list) == 1);
-    ZeCommandListInfo& info = command_list_map_[command_list];
-    PTI_ASSERT(!info.immediate);
+      ZeCommandListInfo& info = GetCommandListInfoLocked(command_list);
+      PTI_ASSERT(!info.props.immediate);
 
-    PTI_ASSERT(correlator_ != nullptr);
-    correlator_->ResetCallIdList(command_list);
+      PTI_ASSERT(correlator_ != nullptr);
+      correlator_->ResetCallIdList(command_list);
 
-    for (ZeKernelCommand* command : info.kernel_command_list) {
-      ZeKernelCall* call = new ZeKernelCall;
-      PTI_ASSERT(call != nullptr);
+      // Executions still in flight share the events with this one
+      for (ZeReplay* previous : info.replay_list) {
+        if (previous->busy &&
+            previous->superseded_time.load(std::memory_order_relaxed) == 0) {
+          previous->superseded_time.store(
+              submit_data->device_sync, std::memory_order_release);
+        }
+      }
 
-      call->command = command;
-      call->queue = queue;
-      call->submit_time = submit_data->host_sync;
-      call->device_submit_time = submit_data->device_sync;
-      PTI_ASSERT(command->append_time <= call->submit_time);
-      ++(command->call_count);
-      call->call_id = command->call_count;
+      replay = AcquireReplay(command_list, info);
+      for (size_t i = 0; i < info.kernel_command_list.size(); ++i) {
+        ZeKernelCommand* command = info.kernel_command_list[i];
+        ++(command->call_count);
+        correlator_->AddCallId(command_list, command->call_count);
+
+        // Event of the command is signaled anyway, it's just not read
+        ZeKernelCall& call = replay->call_list[i];
+        if (!TraceLaunch(command->props.name_id)) {
+          call.command = nullptr;
+          continue;
+        }
 
-      kernel_call_list_.push_back(call);
-      correlator_->AddCallId(command_list, call->call_id);
+        PTI_ASSERT(command->append_time <= submit_data->host_sync);
+        PTI_ASSERT(command->call_count == replay->replay_index);
+        call = {command, queue, submit_data->host_sync,
+                submit_data->device_sync, replay->replay_index};
+        ++(replay->pending_count);
+      }
+
+      if (replay->pending_count == 0) {
+        replay->busy = false;
+        info.free_replay_list.push_back(replay);
+        replay = nullptr;
+      }
+    }
+
+    if (replay != nullptr) {
+      PushReplay(replay);
     }
   }
 
-  ze_context_handle_t GetCommandListContext(
+  ZeCommandListProps GetCommandListProps(
       ze_command_list_handle_t command_list) {
     PTI_ASSERT(command_list != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(command_list_map_.count(command_list) == 1);
-    ZeCommandListInfo& command_list_info = command_list_map_[command_list];
-    return command_list_info.context;
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    return GetCommandListInfoLocked(command_list).props;
   }
 
-  ze_device_handle_t GetCommandListDevice(
+  ZeCommandListInfo& GetCommandListInfoLocked(
       ze_command_list_handle_t command_list) {
-    PTI_ASSERT(command_list != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(command_list_map_.count(command_list) == 1);
-    ZeCommandListInfo& command_list_info = command_list_map_[command_list];
-    return command_list_info.device;
+    ZeCommandListInfo* info = command_list_map_.Find(command_list);
+    PTI_ASSERT(info != nullptr);
+    return *info;
+  }
+
+  // Pointers into the allocations traced or seen before are classified
+  // by the memory tracker, the driver is asked once for the others (made
+  // before tracing started). Pageable memory has no range, so it is asked
+  // for on each transfer
+  TransferMemoryType GetMemoryType(
+      ze_context_handle_t context, const void* ptr) {
+    if (!transfer_timing_enabled_ || context == nullptr || ptr == nullptr) {
+      return TRANSFER_MEMORY_UNKNOWN;
+    }
+
+    MemoryAllocation allocation{};
+    if (memory_tracker_.Find(ptr, &allocation)) {
+      return allocation.type;
+    }
+
+    ze_memory_allocation_properties_t props{
+        ZE_STRUCTURE_TYPE_MEMORY_ALLOCATION_PROPERTIES, };
+    ze_result_t status = zeMemGetAllocProperties(
+        context, ptr, &props, nullptr);
+    if (status != ZE_RESULT_SUCCESS) {
+      return TRANSFER_MEMORY_UNKNOWN;
+    }
+
+    TransferMemoryType type = GetMemoryType(props.type);
+    if (type == TRANSFER_MEMORY_SYSTEM) {
+      return type;
+    }
+
+    void* base = nullptr;
+    size_t size = 0;
+    status = zeMemGetAddressRange(context, ptr, &base, &size);
+    if (status == ZE_RESULT_SUCCESS) {
+      memory_tracker_.AddRange(base, size, type);
+    }
+    return type;
+  }
+
+  static TransferMemoryType GetMemoryType(ze_memory_type_t type) {
+    switch (type) {
+      case ZE_MEMORY_TYPE_HOST:
+        return TRANSFER_MEMORY_HOST;
+      case ZE_MEMORY_TYPE_DEVICE:
+        return TRANSFER_MEMORY_DEVICE;
+      case ZE_MEMORY_TYPE_SHARED:
+        return TRANSFER_MEMORY_SHARED;
+      default:
+        break;
+    }
+    return TRANSFER_MEMORY_SYSTEM;
   }
 
-  bool IsCommandListImmediate(ze_command_list_handle_t command_list) {
-    PTI_ASSERT(command_list != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(command_list_map_.count(command_list) == 1);
-    ZeCommandListInfo& command_list_info = command_list_map_[command_list];
-    return command_list_info.immediate;
+  TransferMemoryType GetMemoryType(
+      ze_command_list_handle_t command_list, const void* ptr) {
+    if (!transfer_timing_enabled_ || command_list == nullptr) {
+      return TRANSFER_MEMORY_UNKNOWN;
+    }
+    return GetMemoryType(GetCommandListProps(command_list).context, ptr);
+  }
+
+  // Images are always placed on the device
+  TransferMemoryType GetImageMemoryType() const {
+    return transfer_timing_enabled_ ?
+      TRANSFER_MEMORY_DEVICE : TRANSFER_MEMORY_UNKNOWN;
+  }
+
+  // Footprint is kept per root device, shared allocations with no device
+  // are counted as host ones
+  void AddAllocation(
+      const void* ptr, size_t size, TransferMemoryType type,
+      ze_device_handle_t device) {
+    uint32_t pool = (device == nullptr) ?
+      MEMORY_TRACKER_HOST_POOL : GetDeviceIndex(device);
+    memory_tracker_.AddAllocation(
+        ptr, size, type, pool, memory_tracker_.GetCallsite(),
+        GetHostTimestamp());
+  }
+
+  void RemoveAllocation(const void* ptr) {
+    memory_tracker_.RemoveAllocation(ptr, GetHostTimestamp());
+  }
+
+  uint32_t GetDeviceIndex(ze_device_handle_t device) {
+    PTI_ASSERT(device != nullptr);
+    {
+      const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+      auto it = device_index_map_.find(device);
+      if (it != device_index_map_.end()) {
+        return it->second;
+      }
+    }
+
+    uint32_t index = MEMORY_TRACKER_HOST_POOL;
+    std::vector<ze_device_handle_t> device_list =
+      utils::ze::GetDeviceList();
+    for (size_t i = 0; i < device_list.size(); ++i) {
+      if (device_list[i] == device) {
+        index = static_cast<uint32_t>(i);
+        break;
+      }
+      std::vector<ze_device_handle_t> sub_device_list =
+        utils::ze::GetSubDeviceList(device_list[i]);
+      if (std::find(sub_device_list.begin(), sub_device_list.end(),
+                    device) != sub_device_list.end()) {
+        index = static_cast<uint32_t>(i);
+        break;
+      }
+    }
+
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    device_index_map_[device] = index;
+    return index;
   }
 
   void AddImage(ze_image_handle_t image, size_t size) {
     PTI_ASSERT(image != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(image_size_map_.count(image) == 0);
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    PTI_ASSERT(image_size_map_.Find(image) == nullptr);
     image_size_map_[image] = size;
   }
 
   void RemoveImage(ze_image_handle_t image) {
     PTI_ASSERT(image != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    PTI_ASSERT(image_size_map_.count(image) == 1);
-    image_size_map_.erase(image);
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    bool removed = image_size_map_.Erase(image);
+    PTI_ASSERT(removed);
   }
 
   size_t GetImageSize(ze_image_handle_t image) {
     PTI_ASSERT(image != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    if (image_size_map_.count(image) == 1) {
-      return image_size_map_[image];
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    const size_t* size = image_size_map_.Find(image);
+    return (size == nullptr) ? 0 : *size;
+  }
+
+  // Kernels created before tracing was enabled are queried on first use,
+  // all the others are filled in at creation time
+  ZeKernelData& GetKernelDataLocked(ze_kernel_handle_t kernel) {
+    PTI_ASSERT(kernel != nullptr);
+
+    ZeKernelData* found = kernel_data_map_.Find(kernel);
+    if (found != nullptr) {
+      return *found;
     }
-    return 0;
+
+    ZeKernelData& data = kernel_data_map_[kernel];
+    data.name_id = StringTable::Add(utils::ze::GetKernelName(kernel));
+    data.simd_width = utils::ze::GetKernelMaxSubgroupSize(kernel);
+    data.group_size = {0, 0, 0};
+    return data;
   }
 
-  void AddKernelGroupSize(
-      ze_kernel_handle_t kernel, const ZeKernelGroupSize& group_size) {
+  void AddKernel(ze_kernel_handle_t kernel) {
+    PTI_ASSERT(kernel != nullptr);
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    kernel_data_map_.Erase(kernel);
+    GetKernelDataLocked(kernel);
+  }
+
+  void RemoveKernel(ze_kernel_handle_t kernel) {
     PTI_ASSERT(kernel != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    kernel_group_size_map_[kernel] = group_size;
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    kernel_data_map_.Erase(kernel);
   }
 
-  void RemoveKernelGroupSize(ze_kernel_handle_t kernel) {
+  void SetKernelGroupSize(
+      ze_kernel_handle_t kernel, const ZeKernelGroupSize& group_size) {
     PTI_ASSERT(kernel != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    kernel_group_size_map_.erase(kernel);
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+    GetKernelDataLocked(kernel).group_size = group_size;
   }
 
-  ZeKernelGroupSize GetKernelGroupSize(ze_kernel_handle_t kernel) {
+  void GetKernelData(ze_kernel_handle_t kernel, ZeKernelProps* props) {
     PTI_ASSERT(kernel != nullptr);
-    const std::lock_guard<std::mutex> lock(lock_);
-    if (kernel_group_size_map_.count(kernel) == 0) {
-      return {0, 0, 0};
-    }
-    return kernel_group_size_map_[kernel];
+    PTI_ASSERT(props != nullptr);
+    const OverheadLockGuard lock(lock_, OVERHEAD_ZE_KERNEL);
+
+    const ZeKernelData& data = GetKernelDataLocked(kernel);
+    props->name_id = data.name_id;
+    props->simd_width = data.simd_width;
+    props->group_size[0] = data.group_size.x;
+    props->group_size[1] = data.group_size.y;
+    props->group_size[2] = data.group_size.z;
   }
 
  private: // Callbacks
@@ -847,6 +1955,7 @@ class ZeKernelCollector {
                                      ze_result_t result,
                                      void *global_data,
                                      void **instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     const ze_event_pool_desc_t* desc = *(params->pdesc);
     if (desc == nullptr) {
       return;
@@ -873,6 +1982,7 @@ class ZeKernelCollector {
                                     ze_result_t result,
                                     void *global_data,
                                     void **instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     ze_event_pool_desc_t* desc =
       static_cast<ze_event_pool_desc_t*>(*instance_data);
     if (desc != nullptr) {
@@ -883,40 +1993,44 @@ class ZeKernelCollector {
   static void OnEnterEventDestroy(
       ze_event_destroy_params_t *params,
       ze_result_t result, void *global_data, void **instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (*(params->phEvent) != nullptr) {
       ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
       PTI_ASSERT(collector != nullptr);
-      collector->ProcessCall(*(params->phEvent));
+      collector->ProcessCalls();
     }
   }
 
   static void OnEnterEventHostReset(
       ze_event_host_reset_params_t *params, ze_result_t result,
       void *global_data, void **instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (*(params->phEvent) != nullptr) {
       ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
       PTI_ASSERT(collector != nullptr);
-      collector->ProcessCall(*(params->phEvent));
+      collector->ProcessCalls();
     }
   }
 
   static void OnExitEventHostSynchronize(
       ze_event_host_synchronize_params_t *params,
       ze_result_t result, void *global_data, void **instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       PTI_ASSERT(*(params->phEvent) != nullptr);
       ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
       PTI_ASSERT(collector != nullptr);
-      collector->ProcessCall(*(params->phEvent));
+      collector->ProcessCalls();
     }
   }
 
   static void OnExitImageCreate(
       ze_image_create_params_t *params, ze_result_t result,
       void *global_data, void **instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       ZeKernelCollector* collector =
           reinterpret_cast<ZeKernelCollector*>(global_data);
@@ -956,6 +2070,7 @@ class ZeKernelCollector {
   static void OnExitImageDestroy(
       ze_image_destroy_params_t *params, ze_result_t result,
       void *global_data, void **instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
@@ -964,30 +2079,26 @@ class ZeKernelCollector {
     }
   }
 
-  static void CreateEvent(ze_context_handle_t context,
-                          ze_event_pool_handle_t& event_pool,
-                          ze_event_handle_t& event) {
-    PTI_ASSERT(context != nullptr);
-    ze_result_t status = ZE_RESULT_SUCCESS;
-
-    ze_event_pool_desc_t event_pool_desc = {
-        ZE_STRUCTURE_TYPE_EVENT_POOL_DESC, nullptr,
-        ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP | ZE_EVENT_POOL_FLAG_HOST_VISIBLE,
-        1};
-    status = zeEventPoolCreate(
-        context, &event_pool_desc, 0, nullptr, &event_pool);
-    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-
-    ze_event_desc_t event_desc = {
-        ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
-        ZE_EVENT_SCOPE_FLAG_HOST, ZE_EVENT_SCOPE_FLAG_HOST};
-    zeEventCreate(event_pool, &event_desc, &event);
-    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  static void OnEnterContextDestroy(
+      ze_context_destroy_params_t *params,
+      ze_result_t result, void *global_data, void **instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (*(params->phContext) != nullptr) {
+      ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->ProcessCalls();
+      collector->PauseWaiter();
+      collector->event_cache_.ReleaseContext(*(params->phContext));
+      collector->ResumeWaiter();
+    }
   }
 
   static void OnEnterKernelAppend(
       const ZeKernelProps& props,
       ze_event_handle_t& signal_event,
+      uint32_t wait_event_count,
+      const ze_event_handle_t* wait_event_list,
       ze_command_list_handle_t command_list,
       void* global_data,
       void** instance_data) {
@@ -999,34 +2110,55 @@ class ZeKernelCollector {
       return;
     }
 
-    ZeKernelCommand* command = new ZeKernelCommand;
+    // Each append to immediate command list is a launch, so untraced
+    // ones are not instrumented at all and correlated to no kernel
+    ZeCommandListProps list_props =
+      collector->GetCommandListProps(command_list);
+    bool immediate = list_props.immediate;
+    if (immediate && !collector->TraceLaunch(props.name_id)) {
+      PTI_ASSERT(collector->correlator_ != nullptr);
+      collector->correlator_->SetKernelId(0);
+      return;
+    }
+
+    ZeKernelCommand* command = RecordPool<ZeKernelCommand>::Create();
     PTI_ASSERT(command != nullptr);
     command->props = props;
     command->append_time = collector->GetHostTimestamp();
 
-    ze_device_handle_t device = collector->GetCommandListDevice(command_list);
+    ze_device_handle_t device = list_props.device;
     PTI_ASSERT(device != nullptr);
     command->device = device;
-    command->timer_frequency = utils::ze::GetDeviceTimerFrequency(device);
+    command->timer_frequency = list_props.timer_frequency;
     PTI_ASSERT(command->timer_frequency > 0);
+    command->timestamp_mask = list_props.timestamp_mask;
+    PTI_ASSERT(command->timestamp_mask > 0);
+    if (collector->dependency_graph_enabled_) {
+      command->wait_event_list = wait_event_list;
+      command->wait_event_count = wait_event_count;
+    }
+    if (collector->call_stacks_enabled_) {
+      command->stack_id = collector->stack_table_.Capture();
+    }
 
     if (signal_event == nullptr) {
-      ze_context_handle_t context =
-        collector->GetCommandListContext(command_list);
-      CreateEvent(context, command->event_pool, command->event);
+      command->event = collector->event_cache_.GetEvent(list_props.context);
+      command->own_event = true;
       signal_event = command->event;
     } else {
-      command->event_pool = nullptr;
       command->event = signal_event;
+      command->own_event = false;
     }
 
-    ZeKernelCall* call = new ZeKernelCall{nullptr, nullptr, 0, 0};
+    ZeKernelCall* call = RecordPool<ZeKernelCall>::Create();
     PTI_ASSERT(call != nullptr);
     call->command = command;
 
-    if (collector->IsCommandListImmediate(command_list)) {
+    command->immediate = immediate;
+    if (command->immediate) {
       call->submit_time = command->append_time;
-      call->device_submit_time = collector->GetDeviceTimestamp(device);
+      call->device_submit_time = collector->EstimateDeviceTimestamp(
+          device, command->append_time);
       call->queue = reinterpret_cast<ze_command_queue_handle_t>(command_list);
     }
 
@@ -1048,16 +2180,15 @@ class ZeKernelCollector {
     PTI_ASSERT(command != nullptr);
 
     if (result != ZE_RESULT_SUCCESS) {
-      if (command->event_pool != nullptr) {
-        ze_result_t status = ZE_RESULT_SUCCESS;
-        status = zeEventDestroy(command->event);
-        PTI_ASSERT(status == ZE_RESULT_SUCCESS);
-        status = zeEventPoolDestroy(command->event_pool);
-        PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      if (command->own_event) {
+        ZeKernelCollector* collector =
+          reinterpret_cast<ZeKernelCollector*>(global_data);
+        PTI_ASSERT(collector != nullptr);
+        collector->event_cache_.ReleaseEvent(command->event);
       }
 
-      delete call;
-      delete command;
+      RecordPool<ZeKernelCall>::Destroy(call);
+      RecordPool<ZeKernelCommand>::Destroy(command);
     } else {
       ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
@@ -1066,7 +2197,7 @@ class ZeKernelCollector {
       if (call->queue != nullptr) {
         collector->AddKernelCall(command_list, call);
       } else {
-        delete call;
+        RecordPool<ZeKernelCall>::Destroy(call);
       }
     }
   }
@@ -1078,20 +2209,12 @@ class ZeKernelCollector {
     PTI_ASSERT(kernel != nullptr);
 
     ZeKernelProps props{};
-
-    props.name = utils::ze::GetKernelName(kernel);
-    props.simd_width =
-      utils::ze::GetKernelMaxSubgroupSize(kernel);
     props.bytes_transferred = 0;
 
     ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
     PTI_ASSERT(collector != nullptr);
-    ZeKernelGroupSize group_size = collector->GetKernelGroupSize(kernel);
-
-    props.group_size[0] = group_size.x;
-    props.group_size[1] = group_size.y;
-    props.group_size[2] = group_size.z;
+    collector->GetKernelData(kernel, &props);
 
     if (group_count != nullptr) {
       props.group_count[0] = group_count->groupCountX;
@@ -1103,22 +2226,29 @@ class ZeKernelCollector {
   }
 
   static ZeKernelProps GetTransferProps(
-      std::string name, size_t bytes_transferred) {
+      std::string name, size_t bytes_transferred,
+      TransferMemoryType src_type = TRANSFER_MEMORY_UNKNOWN,
+      TransferMemoryType dst_type = TRANSFER_MEMORY_UNKNOWN) {
     ZeKernelProps props{};
-    props.name = name;
+    props.name_id = StringTable::Add(name);
     props.bytes_transferred = bytes_transferred;
+    props.src_type = src_type;
+    props.dst_type = dst_type;
     return props;
   }
 
   static void OnEnterCommandListAppendLaunchKernel(
       ze_command_list_append_launch_kernel_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     OnEnterKernelAppend(
         GetKernelProps(
             *(params->phKernel),
             *(params->ppLaunchFuncArgs),
             global_data),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1127,12 +2257,15 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendLaunchCooperativeKernel(
       ze_command_list_append_launch_cooperative_kernel_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     OnEnterKernelAppend(
         GetKernelProps(
             *(params->phKernel),
             *(params->ppLaunchFuncArgs),
             global_data),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1141,12 +2274,15 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendLaunchKernelIndirect(
       ze_command_list_append_launch_kernel_indirect_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     OnEnterKernelAppend(
         GetKernelProps(
             *(params->phKernel),
             *(params->ppLaunchArgumentsBuffer),
             global_data),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1155,9 +2291,20 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendMemoryCopy(
       ze_command_list_append_memory_copy_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+    ze_command_list_handle_t command_list = *(params->phCommandList);
+
     OnEnterKernelAppend(
-        GetTransferProps("zeCommandListAppendMemoryCopy", *(params->psize)),
+        GetTransferProps(
+            "zeCommandListAppendMemoryCopy", *(params->psize),
+            collector->GetMemoryType(command_list, *(params->psrcptr)),
+            collector->GetMemoryType(command_list, *(params->pdstptr))),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1166,9 +2313,12 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendMemoryFill(
       ze_command_list_append_memory_fill_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     OnEnterKernelAppend(
         GetTransferProps("zeCommandListAppendMemoryFill", *(params->psize)),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1177,10 +2327,21 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendMemoryCopyFromContext(
       ze_command_list_append_memory_copy_from_context_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+
     OnEnterKernelAppend(
         GetTransferProps(
-            "zeCommandListAppendMemoryCopyFromContext", *(params->psize)),
+            "zeCommandListAppendMemoryCopyFromContext", *(params->psize),
+            collector->GetMemoryType(
+                *(params->phContextSrc), *(params->psrcptr)),
+            collector->GetMemoryType(
+                *(params->phCommandList), *(params->pdstptr))),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1189,9 +2350,12 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendBarrier(
       ze_command_list_append_barrier_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     OnEnterKernelAppend(
         GetTransferProps("zeCommandListAppendBarrier", 0),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1200,9 +2364,12 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendMemoryRangesBarrier(
       ze_command_list_append_memory_ranges_barrier_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     OnEnterKernelAppend(
         GetTransferProps("zeCommandListAppendMemoryRangesBarrier", 0),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1211,12 +2378,18 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendMemoryCopyRegion(
       ze_command_list_append_memory_copy_region_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+    ze_command_list_handle_t command_list = *(params->phCommandList);
+
+    // Region width is given in bytes
     size_t bytes_transferred = 0;
     const ze_copy_region_t* region = *(params->psrcRegion);
 
     if (region != nullptr) {
-      size_t bytes_transferred =
-        region->width * region->height * (*(params->psrcPitch));
+      bytes_transferred = region->width * region->height;
       if (region->depth != 0) {
         bytes_transferred *= region->depth;
       }
@@ -1224,8 +2397,12 @@ class ZeKernelCollector {
 
     OnEnterKernelAppend(
         GetTransferProps(
-            "zeCommandListAppendMemoryCopyRegion", bytes_transferred),
+            "zeCommandListAppendMemoryCopyRegion", bytes_transferred,
+            collector->GetMemoryType(command_list, *(params->psrcptr)),
+            collector->GetMemoryType(command_list, *(params->pdstptr))),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1234,14 +2411,20 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendImageCopy(
       ze_command_list_append_image_copy_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
     PTI_ASSERT(collector != nullptr);
     size_t bytes_transferred = collector->GetImageSize(*(params->phSrcImage));
 
     OnEnterKernelAppend(
-        GetTransferProps("zeCommandListAppendImageCopy", bytes_transferred),
+        GetTransferProps(
+            "zeCommandListAppendImageCopy", bytes_transferred,
+            collector->GetImageMemoryType(),
+            collector->GetImageMemoryType()),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1250,6 +2433,7 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendImageCopyRegion(
       ze_command_list_append_image_copy_region_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
     PTI_ASSERT(collector != nullptr);
@@ -1257,8 +2441,12 @@ class ZeKernelCollector {
 
     OnEnterKernelAppend(
         GetTransferProps(
-            "zeCommandListAppendImageCopyRegion", bytes_transferred),
+            "zeCommandListAppendImageCopyRegion", bytes_transferred,
+            collector->GetImageMemoryType(),
+            collector->GetImageMemoryType()),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1267,6 +2455,7 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendImageCopyToMemory(
       ze_command_list_append_image_copy_to_memory_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
     PTI_ASSERT(collector != nullptr);
@@ -1274,8 +2463,13 @@ class ZeKernelCollector {
 
     OnEnterKernelAppend(
         GetTransferProps(
-            "zeCommandListAppendImageCopyToMemory", bytes_transferred),
+            "zeCommandListAppendImageCopyToMemory", bytes_transferred,
+            collector->GetImageMemoryType(),
+            collector->GetMemoryType(
+                *(params->phCommandList), *(params->pdstptr))),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1284,6 +2478,11 @@ class ZeKernelCollector {
   static void OnEnterCommandListAppendImageCopyFromMemory(
       ze_command_list_append_image_copy_from_memory_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+
     size_t bytes_transferred = 0;
     const ze_image_region_t* region = *(params->ppDstRegion);
 
@@ -1296,8 +2495,13 @@ class ZeKernelCollector {
 
     OnEnterKernelAppend(
         GetTransferProps(
-            "zeCommandListAppendImageCopyFromMemory", bytes_transferred),
+            "zeCommandListAppendImageCopyFromMemory", bytes_transferred,
+            collector->GetMemoryType(
+                *(params->phCommandList), *(params->psrcptr)),
+            collector->GetImageMemoryType()),
         *(params->phSignalEvent),
+        *(params->pnumWaitEvents),
+        *(params->pphWaitEvents),
         *(params->phCommandList),
         global_data,
         instance_data);
@@ -1306,6 +2510,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendLaunchKernel(
       ze_command_list_append_launch_kernel_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1314,6 +2519,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendLaunchCooperativeKernel(
       ze_command_list_append_launch_cooperative_kernel_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1322,6 +2528,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendLaunchKernelIndirect(
       ze_command_list_append_launch_kernel_indirect_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1330,6 +2537,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendMemoryCopy(
       ze_command_list_append_memory_copy_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1338,6 +2546,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendMemoryFill(
       ze_command_list_append_memory_fill_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1346,6 +2555,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendBarrier(
       ze_command_list_append_barrier_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1354,6 +2564,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendMemoryRangesBarrier(
       ze_command_list_append_memory_ranges_barrier_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1362,6 +2573,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendMemoryCopyRegion(
       ze_command_list_append_memory_copy_region_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1370,6 +2582,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendMemoryCopyFromContext(
       ze_command_list_append_memory_copy_from_context_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1378,6 +2591,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendImageCopy(
       ze_command_list_append_image_copy_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1386,6 +2600,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendImageCopyRegion(
       ze_command_list_append_image_copy_region_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1394,6 +2609,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendImageCopyToMemory(
       ze_command_list_append_image_copy_to_memory_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1402,6 +2618,7 @@ class ZeKernelCollector {
   static void OnExitCommandListAppendImageCopyFromMemory(
       ze_command_list_append_image_copy_from_memory_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     PTI_ASSERT(*(params->phSignalEvent) != nullptr);
     OnExitKernelAppend(*params->phCommandList, global_data,
                        instance_data, result);
@@ -1410,6 +2627,7 @@ class ZeKernelCollector {
   static void OnExitCommandListCreate(
       ze_command_list_create_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       PTI_ASSERT(**params->pphCommandList != nullptr);
       ZeKernelCollector* collector =
@@ -1426,6 +2644,7 @@ class ZeKernelCollector {
   static void OnExitCommandListCreateImmediate(
       ze_command_list_create_immediate_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       PTI_ASSERT(**params->pphCommandList != nullptr);
       ZeKernelCollector* collector =
@@ -1436,12 +2655,20 @@ class ZeKernelCollector {
           *(params->phContext),
           *(params->phDevice),
           true);
+      if (collector->queue_timing_enabled_ ||
+          collector->transfer_timing_enabled_) {
+        collector->AddQueueEngine(
+            **(params->pphCommandList),
+            *(params->phDevice),
+            *(params->paltdesc));
+      }
     }
   }
 
   static void OnExitCommandListDestroy(
       ze_command_list_destroy_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       PTI_ASSERT(*params->phCommandList != nullptr);
       ZeKernelCollector* collector =
@@ -1449,12 +2676,28 @@ class ZeKernelCollector {
       PTI_ASSERT(collector != nullptr);
       collector->ProcessCalls();
       collector->RemoveCommandList(*params->phCommandList);
+      if (collector->dependency_graph_enabled_) {
+        collector->dependency_graph_.ResetGraph(*params->phCommandList);
+      }
+    }
+  }
+
+  static void OnEnterCommandListClose(
+      ze_command_list_close_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (*params->phCommandList != nullptr) {
+      ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->AppendTimestampQuery(*params->phCommandList);
     }
   }
 
   static void OnExitCommandListReset(
       ze_command_list_reset_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       PTI_ASSERT(*params->phCommandList != nullptr);
       ZeKernelCollector* collector =
@@ -1462,12 +2705,16 @@ class ZeKernelCollector {
       PTI_ASSERT(collector != nullptr);
       collector->ProcessCalls();
       collector->ResetCommandList(*params->phCommandList);
+      if (collector->dependency_graph_enabled_) {
+        collector->dependency_graph_.ResetGraph(*params->phCommandList);
+      }
     }
   }
 
   static void OnEnterCommandQueueExecuteCommandLists(
       ze_command_queue_execute_command_lists_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     ZeKernelCollector* collector =
       reinterpret_cast<ZeKernelCollector*>(global_data);
     PTI_ASSERT(collector != nullptr);
@@ -1488,12 +2735,13 @@ class ZeKernelCollector {
 
     for (uint32_t i = 0; i < command_list_count; ++i) {
       ze_device_handle_t device =
-        collector->GetCommandListDevice(command_lists[i]);
+        collector->GetCommandListProps(command_lists[i]).device;
       PTI_ASSERT(device != nullptr);
 
+      uint64_t host_sync = collector->GetHostTimestamp();
       submit_data_list->push_back({
-          collector->GetHostTimestamp(),
-          collector->GetDeviceTimestamp(device)});
+          host_sync,
+          collector->EstimateDeviceTimestamp(device, host_sync)});
     }
 
     *reinterpret_cast<std::vector<ZeSubmitData>**>(instance_data) =
@@ -1503,6 +2751,7 @@ class ZeKernelCollector {
   static void OnExitCommandQueueExecuteCommandLists(
       ze_command_queue_execute_command_lists_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     std::vector<ZeSubmitData>* submit_data_list =
       *reinterpret_cast<std::vector<ZeSubmitData>**>(instance_data);
     PTI_ASSERT(submit_data_list != nullptr);
@@ -1515,7 +2764,7 @@ class ZeKernelCollector {
       uint32_t command_list_count = *params->pnumCommandLists;
       ze_command_list_handle_t* command_lists = *params->pphCommandLists;
       for (uint32_t i = 0; i < command_list_count; ++i) {
-        if (!collector->IsCommandListImmediate(command_lists[i])) {
+        if (!collector->GetCommandListProps(command_lists[i]).immediate) {
           collector->AddKernelCalls(
               command_lists[i],
               *(params->phCommandQueue),
@@ -1530,6 +2779,7 @@ class ZeKernelCollector {
   static void OnExitCommandQueueSynchronize(
       ze_command_queue_synchronize_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
@@ -1538,9 +2788,80 @@ class ZeKernelCollector {
     }
   }
 
+  static void OnExitCommandQueueCreate(
+      ze_command_queue_create_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (result == ZE_RESULT_SUCCESS) {
+      PTI_ASSERT(**params->pphCommandQueue != nullptr);
+      ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->AddQueueEngine(
+          **(params->pphCommandQueue),
+          *(params->phDevice),
+          *(params->pdesc));
+    }
+  }
+
+  // Allocation may be given back before its transfers are processed, but
+  // those are classified already
+  static void OnEnterMemFree(
+      ze_mem_free_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    ZeKernelCollector* collector =
+      reinterpret_cast<ZeKernelCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+    collector->RemoveAllocation(*(params->pptr));
+  }
+
+  static void OnExitMemAllocDevice(
+      ze_mem_alloc_device_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (result == ZE_RESULT_SUCCESS) {
+      ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->AddAllocation(
+          **(params->ppptr), *(params->psize),
+          TRANSFER_MEMORY_DEVICE, *(params->phDevice));
+    }
+  }
+
+  static void OnExitMemAllocHost(
+      ze_mem_alloc_host_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (result == ZE_RESULT_SUCCESS) {
+      ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->AddAllocation(
+          **(params->ppptr), *(params->psize),
+          TRANSFER_MEMORY_HOST, nullptr);
+    }
+  }
+
+  static void OnExitMemAllocShared(
+      ze_mem_alloc_shared_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (result == ZE_RESULT_SUCCESS) {
+      ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->AddAllocation(
+          **(params->ppptr), *(params->psize),
+          TRANSFER_MEMORY_SHARED, *(params->phDevice));
+    }
+  }
+
   static void OnExitCommandQueueDestroy(
       ze_command_queue_destroy_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
@@ -1552,6 +2873,7 @@ class ZeKernelCollector {
   static void OnExitKernelSetGroupSize(
       ze_kernel_set_group_size_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
@@ -1560,48 +2882,116 @@ class ZeKernelCollector {
           *(params->pgroupSizeX),
           *(params->pgroupSizeY),
           *(params->pgroupSizeZ)};
-      collector->AddKernelGroupSize(*(params->phKernel), group_size);
+      collector->SetKernelGroupSize(*(params->phKernel), group_size);
+    }
+  }
+
+  static void OnExitKernelCreate(
+      ze_kernel_create_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (result == ZE_RESULT_SUCCESS) {
+      ZeKernelCollector* collector =
+        reinterpret_cast<ZeKernelCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->AddKernel(**(params->pphKernel));
     }
   }
 
   static void OnExitKernelDestroy(
       ze_kernel_destroy_params_t* params,
       ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
     if (result == ZE_RESULT_SUCCESS) {
       ZeKernelCollector* collector =
         reinterpret_cast<ZeKernelCollector*>(global_data);
       PTI_ASSERT(collector != nullptr);
-      collector->RemoveKernelGroupSize(*(params->phKernel));
+      collector->RemoveKernel(*(params->phKernel));
     }
   }
 
  private: // Data
   zel_tracer_handle_t tracer_ = nullptr;
 
-  bool verbose_ = false;
+  KernelGrouping grouping_ = KERNEL_GROUPING_NAME;
 
   Correlator* correlator_ = nullptr;
   std::atomic<uint64_t> kernel_id_;
+  uint32_t poll_interval_ = 0;
+  bool batch_timestamps_ = false;
+  KernelSampler sampler_;
+  CaptureControl* capture_ = nullptr;
+  bool queue_timing_enabled_ = false;
+  bool transfer_timing_enabled_ = false;
+  bool memory_tracking_enabled_ = false;
 
   OnZeKernelFinishCallback callback_ = nullptr;
   void* callback_data_ = nullptr;
 
+  // Protects the state that is needed synchronously on the append and
+  // submission paths, the call list and kernel statistics are owned by
+  // the processing thread
   std::mutex lock_;
-  ZeKernelInfoMap kernel_info_map_;
-  std::list<ZeKernelCall*> kernel_call_list_;
   ZeCommandListMap command_list_map_;
   ZeImageSizeMap image_size_map_;
-  ZeKernelGroupSizeMap kernel_group_size_map_;
-
-#ifdef PTI_KERNEL_INTERVALS
-  ZeKernelIntervalList kernel_interval_list_;
+  ZeKernelDataMap kernel_data_map_;
+  ZeDeviceDataMap device_data_map_;
+  ZeClockDomainMap clock_domain_map_;
+  FlatHashMap<void*, std::string> queue_engine_map_;
+  std::map<ze_device_handle_t, uint32_t> device_index_map_;
+
+  SpscRingGroup<ZeCallRecord> call_ring_group_;
+  KernelStatistics kernel_statistics_;
+  QueueTiming queue_timing_;
+  TransferTiming transfer_timing_;
+  TileTiming tile_timing_;
+  MemoryTracker memory_tracker_;
+  ZeKernelCallList kernel_call_list_;
+  ZeKernelCallMap kernel_call_map_;
+  std::vector<ZeReplay*> replay_list_;
+  uint64_t lost_call_count_ = 0;
+
+  std::thread processing_thread_;
+  std::mutex flush_lock_;
+  std::condition_variable flush_wakeup_;
+  std::condition_variable flush_done_;
+  uint64_t flush_request_ = 0;
+  uint64_t flush_count_ = 0;
+  bool stop_ = false;
+  bool wait_signaled_ = false; // Guarded by flush_lock_
+
+  // Waiter state, the handed and stale events are owned by the
+  // processing thread
+  std::thread wait_thread_;
+  std::mutex wait_lock_;
+  std::condition_variable wait_wakeup_;
+  std::condition_variable wait_idle_;
+  ze_event_handle_t wait_event_ = nullptr;
+  uint32_t wait_pause_count_ = 0;
+  bool wait_busy_ = false;
+  bool wait_stop_ = false;
+  ze_event_handle_t wait_event_handed_ = nullptr;
+  ze_event_handle_t stale_event_ = nullptr;
+
+  ZeEventCache event_cache_;
+
+  bool kernel_intervals_enabled_ = false;
+  std::mutex interval_lock_;
+  ZeKernelIntervalStore kernel_interval_store_;
+  FlatHashMap<KernelConfig, uint32_t, KernelConfigHash> interval_name_map_;
   ZeDeviceMap device_map_;
-#endif // PTI_KERNEL_INTERVALS
 
-  static const uint32_t kKernelLength = 10;
-  static const uint32_t kCallsLength = 12;
-  static const uint32_t kTimeLength = 20;
-  static const uint32_t kPercentLength = 10;
+  bool tile_timing_enabled_ = false;
+  ZeEventQueryTimestampsExpFunction query_timestamps_ = nullptr;
+  std::vector<ze_kernel_timestamp_result_t> tile_timestamp_list_;
+
+  bool dependency_graph_enabled_ = false;
+  DependencyGraph dependency_graph_;
+  uint32_t barrier_name_id_ = 0;
+  uint32_t ranges_barrier_name_id_ = 0;
+
+  bool call_stacks_enabled_ = false;
+  StackTable stack_table_;
 };
 
 #endif // PTI_TOOLS_ZE_TRACER_ZE_KERNEL_COLLECTOR_H_
\ No newline at end of file
@@ -0,0 +1,406 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ZE_TRACER_ZE_MODULE_COLLECTOR_H_
+#define PTI_TOOLS_ZE_TRACER_ZE_MODULE_COLLECTOR_H_
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <level_zero/layers/zel_tracing_api.h>
+
+#include "overhead.h"
+#include "pti_assert.h"
+#include "utils.h"
+
+#define ZE_MODULE_HASH_SEED  0xcbf29ce484222325ull
+#define ZE_MODULE_HASH_PRIME 0x100000001b3ull
+
+// Dumps native binary, debug info and kernel names of every module the
+// application builds into the given directory for offline source
+// correlation and disassembly. Module creation only hashes the input
+// (IL, format, build flags and device), so the modules built again with
+// the same input are skipped at once, the rest is queued to a background
+// thread that reads the module back from the driver and writes it out.
+// Files are named by the hash of the native binary:
+//   module_<hash>.bin - native binary, written last
+//   module_<hash>.dbg - ELF/DWARF debug info, if the module has it
+//   module_<hash>.txt - kernel names, one per line
+// so a module is stored once, across runs as well. Destruction of a
+// module still in the queue dumps it right away. Modules with
+// specialization constants are never skipped at creation, their values
+// can't be hashed
+class ZeModuleCollector {
+ public: // Interface
+  // Directory should exist
+  static ZeModuleCollector* Create(const std::string& path) {
+    PTI_ASSERT(!path.empty());
+    ZeModuleCollector* collector = new ZeModuleCollector(path);
+    PTI_ASSERT(collector != nullptr);
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    zel_tracer_desc_t tracer_desc = {
+        ZEL_STRUCTURE_TYPE_TRACER_EXP_DESC, nullptr, collector};
+    zel_tracer_handle_t tracer = nullptr;
+    status = zelTracerCreate(&tracer_desc, &tracer);
+    if (status != ZE_RESULT_SUCCESS) {
+      std::cerr << "[WARNING] Unable to create Level Zero tracer" << std::endl;
+      delete collector;
+      return nullptr;
+    }
+
+    collector->EnableTracing(tracer);
+    return collector;
+  }
+
+  ~ZeModuleCollector() {
+    if (tracer_ != nullptr) {
+      ze_result_t status = zelTracerDestroy(tracer_);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    }
+
+    Flush();
+
+    if (failed_count_ > 0) {
+      std::cerr << "[WARNING] " << failed_count_ << " modules were not " <<
+        "stored to " << path_ << std::endl;
+    }
+    if (module_count_ > 0) {
+      std::cerr << "[INFO] " << module_count_ << " modules (" <<
+        stored_count_ << " new, " << found_count_ << " stored before) " <<
+        "were dumped to " << path_ << std::endl;
+    }
+  }
+
+  void DisableTracing() {
+    PTI_ASSERT(tracer_ != nullptr);
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    status = zelTracerSetEnabled(tracer_, false);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    Flush();
+  }
+
+  ZeModuleCollector(const ZeModuleCollector& copy) = delete;
+  ZeModuleCollector& operator=(const ZeModuleCollector& copy) = delete;
+
+ private: // Implementation
+  explicit ZeModuleCollector(const std::string& path) : path_(path) {
+    thread_ = std::thread(&ZeModuleCollector::Run, this);
+  }
+
+  void EnableTracing(zel_tracer_handle_t tracer) {
+    PTI_ASSERT(tracer != nullptr);
+    tracer_ = tracer;
+
+    zet_core_callbacks_t prologue_callbacks{};
+    zet_core_callbacks_t epilogue_callbacks{};
+
+    epilogue_callbacks.Module.pfnCreateCb = OnExitModuleCreate;
+    prologue_callbacks.Module.pfnDestroyCb = OnEnterModuleDestroy;
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    status = zelTracerSetPrologues(tracer_, &prologue_callbacks);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zelTracerSetEpilogues(tracer_, &epilogue_callbacks);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zelTracerSetEnabled(tracer_, true);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+
+  static uint64_t Hash(const void* data, size_t size, uint64_t hash) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * ZE_MODULE_HASH_PRIME;
+    }
+    return hash;
+  }
+
+  // Zero if the module can't be told by its input
+  static uint64_t GetModuleKey(
+      const ze_module_desc_t* desc, ze_device_handle_t device) {
+    PTI_ASSERT(desc != nullptr);
+    if (desc->pInputModule == nullptr || desc->inputSize == 0 ||
+        (desc->pConstants != nullptr &&
+         desc->pConstants->numConstants > 0)) {
+      return 0;
+    }
+
+    uint64_t hash = ZE_MODULE_HASH_SEED;
+    hash = Hash(desc->pInputModule, desc->inputSize, hash);
+    hash = Hash(&desc->format, sizeof(desc->format), hash);
+    if (desc->pBuildFlags != nullptr) {
+      hash = Hash(desc->pBuildFlags, strlen(desc->pBuildFlags), hash);
+    }
+    hash = Hash(&device, sizeof(device), hash);
+    return (hash == 0) ? 1 : hash;
+  }
+
+  void AddModule(
+      ze_module_handle_t module,
+      const ze_module_desc_t* desc,
+      ze_device_handle_t device) {
+    PTI_ASSERT(module != nullptr);
+    uint64_t key = GetModuleKey(desc, device);
+
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      ++module_count_;
+      if (key != 0 && !key_set_.insert(key).second) {
+        return;
+      }
+      queue_.push_back(module);
+    }
+    wakeup_.notify_one();
+  }
+
+  // Module can't be destroyed while it is read back
+  void RemoveModule(ze_module_handle_t module) {
+    PTI_ASSERT(module != nullptr);
+    std::unique_lock<std::mutex> lock(lock_);
+    auto it = std::find(queue_.begin(), queue_.end(), module);
+    if (it != queue_.end()) {
+      queue_.erase(it);
+      lock.unlock();
+      DumpModule(module);
+      return;
+    }
+    done_.wait(lock, [this, module] { return current_ != module; });
+  }
+
+  // Modules left in the queue are dumped before the call returns
+  void Flush() {
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      stop_ = true;
+    }
+    wakeup_.notify_one();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+
+    // Modules queued by callbacks that were in flight on disabling
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!queue_.empty()) {
+      ze_module_handle_t module = queue_.front();
+      queue_.pop_front();
+      current_ = module;
+      lock.unlock();
+
+      DumpModule(module);
+
+      lock.lock();
+      current_ = nullptr;
+      done_.notify_all();
+    }
+  }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+      wakeup_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        break;
+      }
+
+      ze_module_handle_t module = queue_.front();
+      queue_.pop_front();
+      current_ = module;
+      lock.unlock();
+
+      DumpModule(module);
+
+      lock.lock();
+      current_ = nullptr;
+      done_.notify_all();
+    }
+  }
+
+  void DumpModule(ze_module_handle_t module) {
+    PTI_ASSERT(module != nullptr);
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    std::vector<uint8_t> binary;
+    std::vector<uint8_t> debug_info;
+    std::string kernel_names;
+    uint64_t hash = ZE_MODULE_HASH_SEED;
+    {
+      OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_BINARY_READ);
+
+      size_t size = 0;
+      status = zeModuleGetNativeBinary(module, &size, nullptr);
+      if (status != ZE_RESULT_SUCCESS || size == 0) {
+        AddFailed();
+        return;
+      }
+      binary.resize(size);
+      status = zeModuleGetNativeBinary(module, &size, binary.data());
+      if (status != ZE_RESULT_SUCCESS) {
+        AddFailed();
+        return;
+      }
+      binary.resize(size);
+
+      hash = Hash(binary.data(), binary.size(), hash);
+      {
+        const std::lock_guard<std::mutex> lock(lock_);
+        if (!binary_set_.insert(hash).second) {
+          return;
+        }
+      }
+
+      size = 0;
+      status = zeModuleGetDebugInfo(
+          module, ZE_MODULE_DEBUG_INFO_FORMAT_ELF_DWARF, &size, nullptr);
+      if (status == ZE_RESULT_SUCCESS && size > 0) {
+        debug_info.resize(size);
+        status = zeModuleGetDebugInfo(
+            module, ZE_MODULE_DEBUG_INFO_FORMAT_ELF_DWARF,
+            &size, debug_info.data());
+        debug_info.resize((status == ZE_RESULT_SUCCESS) ? size : 0);
+      }
+
+      uint32_t count = 0;
+      status = zeModuleGetKernelNames(module, &count, nullptr);
+      if (status == ZE_RESULT_SUCCESS && count > 0) {
+        std::vector<const char*> name_list(count, nullptr);
+        status = zeModuleGetKernelNames(module, &count, name_list.data());
+        if (status == ZE_RESULT_SUCCESS) {
+          for (uint32_t i = 0; i < count; ++i) {
+            PTI_ASSERT(name_list[i] != nullptr);
+            kernel_names += name_list[i];
+            kernel_names += '\n';
+          }
+        }
+      }
+    }
+
+    std::string prefix = GetPathPrefix(hash);
+    if (IsFileStored(prefix + ".bin")) {
+      const std::lock_guard<std::mutex> lock(lock_);
+      ++found_count_;
+      return;
+    }
+
+    bool stored = true;
+    if (!debug_info.empty()) {
+      stored = stored &&
+        StoreFile(prefix + ".dbg", debug_info.data(), debug_info.size());
+    }
+    if (!kernel_names.empty()) {
+      stored = stored &&
+        StoreFile(prefix + ".txt", kernel_names.data(), kernel_names.size());
+    }
+    stored = stored && StoreFile(prefix + ".bin", binary.data(), binary.size());
+
+    if (!stored) {
+      AddFailed();
+      return;
+    }
+    const std::lock_guard<std::mutex> lock(lock_);
+    ++stored_count_;
+  }
+
+  void AddFailed() {
+    const std::lock_guard<std::mutex> lock(lock_);
+    ++failed_count_;
+  }
+
+  std::string GetPathPrefix(uint64_t hash) const {
+    std::stringstream stream;
+    stream << path_ << "/module_" << std::hex << std::setw(16) <<
+      std::setfill('0') << hash;
+    return stream.str();
+  }
+
+  static bool IsFileStored(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    return file.is_open();
+  }
+
+  // Written to a temporary file first, so concurrent processes never see
+  // a partial one
+  static bool StoreFile(
+      const std::string& path, const void* data, size_t size) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_IO, size);
+    std::string temp_path = path + "." + std::to_string(utils::GetPid());
+    std::ofstream file(temp_path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+      return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(data), size);
+    file.close();
+
+    if (!file.good() || rename(temp_path.c_str(), path.c_str()) != 0) {
+      remove(temp_path.c_str());
+      return false;
+    }
+    return true;
+  }
+
+ private: // Callbacks
+  static void OnExitModuleCreate(
+      ze_module_create_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (result == ZE_RESULT_SUCCESS) {
+      PTI_ASSERT(**params->pphModule != nullptr);
+      ZeModuleCollector* collector =
+        reinterpret_cast<ZeModuleCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->AddModule(
+          **(params->pphModule), *(params->pdesc), *(params->phDevice));
+    }
+  }
+
+  static void OnEnterModuleDestroy(
+      ze_module_destroy_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (*(params->phModule) != nullptr) {
+      ZeModuleCollector* collector =
+        reinterpret_cast<ZeModuleCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->RemoveModule(*(params->phModule));
+    }
+  }
+
+ private: // Data
+  zel_tracer_handle_t tracer_ = nullptr;
+  std::string path_;
+
+  std::thread thread_;
+  std::mutex lock_;
+  std::condition_variable wakeup_;
+  std::condition_variable done_;
+  std::deque<ze_module_handle_t> queue_;
+  ze_module_handle_t current_ = nullptr; // Read back by the thread
+  bool stop_ = false;
+
+  std::unordered_set<uint64_t> key_set_; // Module inputs
+  std::unordered_set<uint64_t> binary_set_; // Native binaries
+
+  uint64_t module_count_ = 0;
+  uint64_t stored_count_ = 0;
+  uint64_t found_count_ = 0;
+  uint64_t failed_count_ = 0;
+};
+
+#endif // PTI_TOOLS_ZE_TRACER_ZE_MODULE_COLLECTOR_H_
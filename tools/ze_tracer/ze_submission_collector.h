@@ -0,0 +1,551 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_TOOLS_ZE_TRACER_ZE_SUBMISSION_COLLECTOR_H_
+#define PTI_TOOLS_ZE_TRACER_ZE_SUBMISSION_COLLECTOR_H_
+
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <level_zero/layers/zel_tracing_api.h>
+
+#include "clock_domain.h"
+#include "correlator.h"
+#include "flat_hash_map.h"
+#include "overhead.h"
+#include "pti_assert.h"
+#include "queue_timing.h"
+#include "ze_utils.h"
+
+#define ZE_SUBMISSION_RING_SIZE 256 // Submissions in flight per queue
+#define ZE_SUBMISSION_SYNC_INTERVAL 100000000 // ns
+
+typedef void (*OnZeSubmissionFinishCallback)(
+    void* data, void* queue,
+    uint64_t submitted, uint64_t started, uint64_t ended);
+
+// GPU start and end of each command queue execution, with no events and
+// no per-kernel work. Every zeCommandQueueExecuteCommandLists is put
+// between two tiny command lists of the tool, submitted to the same queue
+// right before and after it, that write the global timestamp into the
+// slot of the execution in a ring of host memory, so a submission costs
+// two timestamp writes on the device. Queues are expected to run their
+// submissions in order. Slots are read on queue synchronization and
+// before they are reused, executions that find the ring full are counted
+// but not traced. Immediate command lists have no executions and are not
+// covered
+class ZeSubmissionCollector {
+ public: // Interface
+  static ZeSubmissionCollector* Create(
+      Correlator* correlator,
+      OnZeSubmissionFinishCallback callback = nullptr,
+      void* callback_data = nullptr) {
+    PTI_ASSERT(correlator != nullptr);
+    ZeSubmissionCollector* collector =
+      new ZeSubmissionCollector(correlator, callback, callback_data);
+    PTI_ASSERT(collector != nullptr);
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    zel_tracer_desc_t tracer_desc = {
+        ZEL_STRUCTURE_TYPE_TRACER_EXP_DESC, nullptr, collector};
+    zel_tracer_handle_t tracer = nullptr;
+    status = zelTracerCreate(&tracer_desc, &tracer);
+    if (status != ZE_RESULT_SUCCESS) {
+      std::cerr << "[WARNING] Unable to create Level Zero tracer" << std::endl;
+      delete collector;
+      return nullptr;
+    }
+
+    collector->EnableTracing(tracer);
+    return collector;
+  }
+
+  ~ZeSubmissionCollector() {
+    if (tracer_ != nullptr) {
+      ze_result_t status = zelTracerDestroy(tracer_);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    }
+
+    for (auto& value : queue_map_) {
+      ReleaseQueue(value.second);
+    }
+
+    if (dropped_count_ > 0) {
+      std::cerr << "[WARNING] " << dropped_count_ << " command queue " <<
+        "executions were not traced since " << ZE_SUBMISSION_RING_SIZE <<
+        " executions of the queue were still in flight" << std::endl;
+    }
+  }
+
+  // Executions finished so far are read, the ones still running are not
+  void DisableTracing() {
+    PTI_ASSERT(tracer_ != nullptr);
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    status = zelTracerSetEnabled(tracer_, false);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    for (auto& value : queue_map_) {
+      ReadSlotsLocked(value.first, value.second);
+    }
+  }
+
+  void PrintSubmissionsTable() const {
+    const std::lock_guard<std::mutex> lock(lock_);
+    if (queue_timing_.IsEmpty()) {
+      return;
+    }
+
+    std::stringstream stream;
+    queue_timing_.PrintTables(stream);
+    PTI_ASSERT(correlator_ != nullptr);
+    correlator_->Log(stream.str());
+  }
+
+  ZeSubmissionCollector(const ZeSubmissionCollector& copy) = delete;
+  ZeSubmissionCollector& operator=(const ZeSubmissionCollector& copy) = delete;
+
+ private: // Implementation
+  // Start and end timestamps of one execution, written by the device
+  struct Slot {
+    uint64_t start;
+    uint64_t end;
+  };
+
+  struct SlotInfo {
+    ze_command_list_handle_t begin_list;
+    ze_command_list_handle_t end_list;
+    uint64_t submit_time; // Host time, ns
+    bool failed; // Execution was rejected, its timestamps are skipped
+  };
+
+  struct QueueInfo {
+    ze_context_handle_t context;
+    ze_device_handle_t device;
+    uint32_t ordinal;
+    std::string engine;
+    Slot* slot_list; // Host memory, ZE_SUBMISSION_RING_SIZE slots
+    std::vector<SlotInfo> slot_info_list;
+    uint64_t submit_count; // Slots taken so far
+    uint64_t read_count; // Slots read so far
+    // Held from the start to the end of an execution, so that the
+    // executions of concurrent threads are not interleaved with the
+    // timestamp writes of each other
+    std::mutex* submit_lock;
+  };
+
+  // Passed from the prologue to the epilogue of an execution
+  struct Submission {
+    ze_command_queue_handle_t queue;
+    std::mutex* submit_lock;
+    ze_command_list_handle_t end_list; // nullptr if not traced
+    uint32_t slot;
+  };
+
+  ZeSubmissionCollector(
+      Correlator* correlator,
+      OnZeSubmissionFinishCallback callback,
+      void* callback_data)
+      : correlator_(correlator),
+        callback_(callback),
+        callback_data_(callback_data) {
+    PTI_ASSERT(correlator_ != nullptr);
+  }
+
+  void EnableTracing(zel_tracer_handle_t tracer) {
+    PTI_ASSERT(tracer != nullptr);
+    tracer_ = tracer;
+
+    zet_core_callbacks_t prologue_callbacks{};
+    zet_core_callbacks_t epilogue_callbacks{};
+
+    epilogue_callbacks.CommandQueue.pfnCreateCb = OnExitCommandQueueCreate;
+    prologue_callbacks.CommandQueue.pfnDestroyCb = OnEnterCommandQueueDestroy;
+    prologue_callbacks.CommandQueue.pfnExecuteCommandListsCb =
+      OnEnterCommandQueueExecuteCommandLists;
+    epilogue_callbacks.CommandQueue.pfnExecuteCommandListsCb =
+      OnExitCommandQueueExecuteCommandLists;
+    epilogue_callbacks.CommandQueue.pfnSynchronizeCb =
+      OnExitCommandQueueSynchronize;
+
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    status = zelTracerSetPrologues(tracer_, &prologue_callbacks);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zelTracerSetEpilogues(tracer_, &epilogue_callbacks);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zelTracerSetEnabled(tracer_, true);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+
+  uint64_t GetHostTimestamp() const {
+    PTI_ASSERT(correlator_ != nullptr);
+    return correlator_->GetTimestamp();
+  }
+
+  void AddQueue(ze_command_queue_handle_t queue, ze_context_handle_t context,
+                ze_device_handle_t device,
+                const ze_command_queue_desc_t* desc) {
+    PTI_ASSERT(queue != nullptr);
+    PTI_ASSERT(context != nullptr && device != nullptr);
+    PTI_ASSERT(desc != nullptr);
+
+    void* memory = nullptr;
+    ze_host_mem_alloc_desc_t alloc_desc{
+        ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC, nullptr, 0};
+    ze_result_t status = zeMemAllocHost(
+        context, &alloc_desc, ZE_SUBMISSION_RING_SIZE * sizeof(Slot),
+        sizeof(uint64_t), &memory);
+    if (status != ZE_RESULT_SUCCESS) {
+      std::cerr << "[WARNING] Unable to allocate timestamp ring, " <<
+        "executions of queue " << queue << " are not traced" << std::endl;
+      return;
+    }
+
+    std::stringstream engine;
+    engine << "Device " << utils::ze::GetDeviceLabel(device) <<
+      " Engine " << desc->ordinal << "." << desc->index;
+
+    QueueInfo info{context, device, desc->ordinal, engine.str(),
+                   static_cast<Slot*>(memory),
+                   std::vector<SlotInfo>(ZE_SUBMISSION_RING_SIZE),
+                   0, 0, new std::mutex};
+    PTI_ASSERT(info.submit_lock != nullptr);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    PTI_ASSERT(queue_map_.Find(queue) == nullptr);
+    queue_map_[queue] = std::move(info);
+
+    if (clock_domain_map_.count(device) == 0) {
+      clock_domain_map_.emplace(
+          device,
+          ClockDomain(utils::ze::GetDeviceTimerFrequency(device),
+                      utils::ze::GetDeviceGlobalTimestampMask(device)));
+    }
+  }
+
+  // Executions that are still running are dropped, the queue is not
+  // expected to be destroyed while it works
+  void RemoveQueue(ze_command_queue_handle_t queue) {
+    PTI_ASSERT(queue != nullptr);
+    const std::lock_guard<std::mutex> lock(lock_);
+    QueueInfo* info = queue_map_.Find(queue);
+    if (info == nullptr) {
+      return;
+    }
+    ReadSlotsLocked(queue, *info);
+    ReleaseQueue(*info);
+    queue_map_.Erase(queue);
+  }
+
+  static void ReleaseQueue(QueueInfo& info) {
+    ze_result_t status = ZE_RESULT_SUCCESS;
+    for (const SlotInfo& slot_info : info.slot_info_list) {
+      if (slot_info.begin_list != nullptr) {
+        status = zeCommandListDestroy(slot_info.begin_list);
+        PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      }
+      if (slot_info.end_list != nullptr) {
+        status = zeCommandListDestroy(slot_info.end_list);
+        PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      }
+    }
+    info.slot_info_list.clear();
+
+    if (info.slot_list != nullptr) {
+      status = zeMemFree(info.context, info.slot_list);
+      PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+      info.slot_list = nullptr;
+    }
+
+    delete info.submit_lock;
+    info.submit_lock = nullptr;
+  }
+
+  // Regular command list of the queue group that writes the global
+  // timestamp to the given address
+  static ze_command_list_handle_t CreateTimestampList(
+      const QueueInfo& info, uint64_t* timestamp) {
+    PTI_ASSERT(timestamp != nullptr);
+    ze_result_t status = ZE_RESULT_SUCCESS;
+
+    ze_command_list_desc_t desc{
+        ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC, nullptr, info.ordinal, 0};
+    ze_command_list_handle_t command_list = nullptr;
+    status = zeCommandListCreate(
+        info.context, info.device, &desc, &command_list);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+    status = zeCommandListAppendWriteGlobalTimestamp(
+        command_list, timestamp, nullptr, 0, nullptr);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    status = zeCommandListClose(command_list);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    return command_list;
+  }
+
+  // Takes the next slot of the queue and submits its begin list, returns
+  // false if the queue is unknown or all its slots are in flight
+  bool BeginSubmission(ze_command_queue_handle_t queue,
+                       Submission* submission) {
+    PTI_ASSERT(queue != nullptr);
+    PTI_ASSERT(submission != nullptr);
+
+    ze_command_list_handle_t begin_list = nullptr;
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      QueueInfo* info = queue_map_.Find(queue);
+      if (info == nullptr) {
+        return false;
+      }
+      PTI_ASSERT(info->submit_lock != nullptr);
+      submission->submit_lock = info->submit_lock;
+    }
+
+    // Lock order is the submit lock first, then the collector one
+    submission->submit_lock->lock();
+
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      QueueInfo* info = queue_map_.Find(queue);
+      PTI_ASSERT(info != nullptr);
+
+      if (info->submit_count - info->read_count == ZE_SUBMISSION_RING_SIZE) {
+        ReadSlotsLocked(queue, *info);
+      }
+      if (info->submit_count - info->read_count == ZE_SUBMISSION_RING_SIZE) {
+        ++dropped_count_;
+        submission->end_list = nullptr;
+        return true;
+      }
+
+      uint32_t slot =
+        static_cast<uint32_t>(info->submit_count % ZE_SUBMISSION_RING_SIZE);
+      SlotInfo& slot_info = info->slot_info_list[slot];
+      if (slot_info.begin_list == nullptr) {
+        slot_info.begin_list =
+          CreateTimestampList(*info, &info->slot_list[slot].start);
+        slot_info.end_list =
+          CreateTimestampList(*info, &info->slot_list[slot].end);
+      }
+
+      // Slot is not touched by the device until the begin list runs
+      info->slot_list[slot] = {0, 0};
+      slot_info.submit_time = GetHostTimestamp();
+      slot_info.failed = false;
+      SyncClockLocked(info->device, slot_info.submit_time);
+      ++(info->submit_count);
+
+      begin_list = slot_info.begin_list;
+      submission->end_list = slot_info.end_list;
+      submission->slot = slot;
+    }
+
+    ExecuteTimestampList(queue, begin_list);
+    return true;
+  }
+
+  void EndSubmission(const Submission& submission, bool succeeded) {
+    PTI_ASSERT(submission.submit_lock != nullptr);
+    if (submission.end_list != nullptr) {
+      if (!succeeded) {
+        const std::lock_guard<std::mutex> lock(lock_);
+        QueueInfo* info = queue_map_.Find(submission.queue);
+        PTI_ASSERT(info != nullptr);
+        info->slot_info_list[submission.slot].failed = true;
+      }
+      // The slot is closed even for a failed execution to keep the order
+      ExecuteTimestampList(submission.queue, submission.end_list);
+    }
+    submission.submit_lock->unlock();
+  }
+
+  // Submissions of the tool go through the tracing layer as well, the
+  // collector itself skips them
+  static void ExecuteTimestampList(
+      ze_command_queue_handle_t queue, ze_command_list_handle_t command_list) {
+    PTI_ASSERT(command_list != nullptr);
+    InternalSubmission() = true;
+    ze_result_t status = zeCommandQueueExecuteCommandLists(
+        queue, 1, &command_list, nullptr);
+    InternalSubmission() = false;
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  }
+
+  static bool& InternalSubmission() {
+    thread_local bool internal = false;
+    return internal;
+  }
+
+  // Device is sampled once per sync interval, since the execution spans
+  // are much longer than the clock drift over that time
+  void SyncClockLocked(ze_device_handle_t device, uint64_t host_time) {
+    auto it = clock_domain_map_.find(device);
+    PTI_ASSERT(it != clock_domain_map_.end());
+    ClockDomain& domain = it->second;
+    if (domain.GetSampleCount() > 0 &&
+        host_time < domain.GetLastSampleTime() +
+          ZE_SUBMISSION_SYNC_INTERVAL) {
+      return;
+    }
+
+    uint64_t host_start = GetHostTimestamp();
+    uint64_t device_sync = utils::ze::GetDeviceTimestamp(device);
+    uint64_t host_end = GetHostTimestamp();
+    PTI_ASSERT(host_start <= host_end);
+    domain.AddSample(host_start + (host_end - host_start) / 2, device_sync);
+  }
+
+  // Slots are read in the submission order up to the first one the
+  // device has not closed yet
+  void ReadSlotsLocked(ze_command_queue_handle_t queue, QueueInfo& info) {
+    auto it = clock_domain_map_.find(info.device);
+    PTI_ASSERT(it != clock_domain_map_.end());
+    const ClockDomain& domain = it->second;
+
+    while (info.read_count < info.submit_count) {
+      uint32_t slot =
+        static_cast<uint32_t>(info.read_count % ZE_SUBMISSION_RING_SIZE);
+      const volatile Slot& timestamps = info.slot_list[slot];
+      uint64_t device_end = timestamps.end;
+      if (device_end == 0) {
+        break;
+      }
+      uint64_t device_start = timestamps.start;
+      ++info.read_count;
+
+      const SlotInfo& slot_info = info.slot_info_list[slot];
+      if (slot_info.failed) {
+        continue;
+      }
+
+      uint64_t start = domain.Unwrap(device_start, slot_info.submit_time);
+      uint64_t end = start +
+        ((device_end - device_start) & domain.GetTimestampMask());
+      uint64_t started = domain.ToHost(start);
+      uint64_t ended = domain.ToHost(end);
+      if (started < slot_info.submit_time) {
+        ended += slot_info.submit_time - started;
+        started = slot_info.submit_time;
+      }
+
+      queue_timing_.AddCommand(
+          queue, info.engine, slot_info.submit_time, started, ended);
+      if (callback_ != nullptr) {
+        callback_(callback_data_, queue, slot_info.submit_time,
+                  started, ended);
+      }
+    }
+  }
+
+  void ReadSlots(ze_command_queue_handle_t queue) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    QueueInfo* info = queue_map_.Find(queue);
+    if (info != nullptr) {
+      ReadSlotsLocked(queue, *info);
+    }
+  }
+
+ private: // Callbacks
+  static void OnExitCommandQueueCreate(
+      ze_command_queue_create_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (result == ZE_RESULT_SUCCESS) {
+      PTI_ASSERT(**params->pphCommandQueue != nullptr);
+      ZeSubmissionCollector* collector =
+        reinterpret_cast<ZeSubmissionCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->AddQueue(
+          **(params->pphCommandQueue), *(params->phContext),
+          *(params->phDevice), *(params->pdesc));
+    }
+  }
+
+  static void OnEnterCommandQueueDestroy(
+      ze_command_queue_destroy_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    ZeSubmissionCollector* collector =
+      reinterpret_cast<ZeSubmissionCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+    collector->RemoveQueue(*(params->phCommandQueue));
+  }
+
+  static void OnEnterCommandQueueExecuteCommandLists(
+      ze_command_queue_execute_command_lists_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    *reinterpret_cast<Submission**>(instance_data) = nullptr;
+    if (InternalSubmission()) {
+      return;
+    }
+
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    ZeSubmissionCollector* collector =
+      reinterpret_cast<ZeSubmissionCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+
+    ze_command_queue_handle_t queue = *(params->phCommandQueue);
+    if (queue == nullptr || *(params->pnumCommandLists) == 0) {
+      return;
+    }
+
+    Submission* submission = new Submission{queue, nullptr, nullptr, 0};
+    PTI_ASSERT(submission != nullptr);
+    if (!collector->BeginSubmission(queue, submission)) {
+      delete submission;
+      return;
+    }
+    *reinterpret_cast<Submission**>(instance_data) = submission;
+  }
+
+  static void OnExitCommandQueueExecuteCommandLists(
+      ze_command_queue_execute_command_lists_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    Submission* submission =
+      *reinterpret_cast<Submission**>(instance_data);
+    if (submission == nullptr) {
+      return;
+    }
+
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    ZeSubmissionCollector* collector =
+      reinterpret_cast<ZeSubmissionCollector*>(global_data);
+    PTI_ASSERT(collector != nullptr);
+    collector->EndSubmission(*submission, result == ZE_RESULT_SUCCESS);
+    delete submission;
+  }
+
+  static void OnExitCommandQueueSynchronize(
+      ze_command_queue_synchronize_params_t* params,
+      ze_result_t result, void* global_data, void** instance_data) {
+    OverheadScope overhead(OVERHEAD_ZE_KERNEL, OVERHEAD_CALLBACK);
+    if (result == ZE_RESULT_SUCCESS) {
+      ZeSubmissionCollector* collector =
+        reinterpret_cast<ZeSubmissionCollector*>(global_data);
+      PTI_ASSERT(collector != nullptr);
+      collector->ReadSlots(*(params->phCommandQueue));
+    }
+  }
+
+ private: // Data
+  zel_tracer_handle_t tracer_ = nullptr;
+  Correlator* correlator_ = nullptr;
+
+  OnZeSubmissionFinishCallback callback_ = nullptr;
+  void* callback_data_ = nullptr;
+
+  mutable std::mutex lock_;
+  FlatHashMap<ze_command_queue_handle_t, QueueInfo> queue_map_;
+  std::unordered_map<ze_device_handle_t, ClockDomain> clock_domain_map_;
+  QueueTiming queue_timing_;
+  uint64_t dropped_count_ = 0;
+};
+
+#endif // PTI_TOOLS_ZE_TRACER_ZE_SUBMISSION_COLLECTOR_H_
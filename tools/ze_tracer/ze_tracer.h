@@ -13,11 +13,21 @@
 #include <sstream>
 #include <string>
 
+#include "binary_trace.h"
+#include "capture_control.h"
 #include "correlator.h"
+#include "interval_statistics.h"
+#include "overhead.h"
+#include "perfetto_trace.h"
+#include "table_store.h"
+#include "thread_identity.h"
 #include "trace_options.h"
+#include "trace_sink.h"
 #include "utils.h"
 #include "ze_api_collector.h"
 #include "ze_kernel_collector.h"
+#include "ze_module_collector.h"
+#include "ze_submission_collector.h"
 
 const char* kChromeTraceFileName = "zet_trace";
 
@@ -27,13 +37,51 @@ class ZeTracer {
     ZeTracer* tracer = new ZeTracer(options);
     PTI_ASSERT(tracer != nullptr);
 
+    tracer->capture_ = CaptureControl::Create(options.GetCaptureOptions());
+
+    if (tracer->CheckOption(TRACE_INTERVAL_STATS)) {
+      tracer->interval_file_name_ =
+        TraceOptions::GetIntervalsFileName(kChromeTraceFileName);
+      tracer->interval_statistics_ = IntervalStatistics::Create(
+          tracer->interval_file_name_, options.GetStatsInterval());
+    }
+
+    if (tracer->CheckOption(TRACE_WAIT_ANALYSIS)) {
+      tracer->wait_analysis_ = new WaitAnalysis;
+      PTI_ASSERT(tracer->wait_analysis_ != nullptr);
+    }
+
+    if (tracer->CheckOption(TRACE_MODULE_DUMP)) {
+      ZeModuleCollector* module_collector =
+        ZeModuleCollector::Create(options.GetModuleDumpPath());
+      if (module_collector == nullptr) {
+        std::cerr << "[WARNING] Unable to create module collector" <<
+          std::endl;
+        delete tracer;
+        return nullptr;
+      }
+      tracer->module_collector_ = module_collector;
+    }
+
+    tracer->CreateSinks();
+
     ZeKernelCollector* kernel_collector = nullptr;
     if (tracer->CheckOption(TRACE_DEVICE_TIMING) ||
         tracer->CheckOption(TRACE_DEVICE_TIMING_VERBOSE) ||
+        tracer->CheckOption(TRACE_QUEUE_TIMING) ||
+        tracer->CheckOption(TRACE_DEPENDENCY_GRAPH) ||
+        tracer->CheckOption(TRACE_CALL_STACKS) ||
+        tracer->CheckOption(TRACE_TRANSFER_TIMING) ||
+        tracer->CheckOption(TRACE_TILE_TIMING) ||
+        tracer->CheckOption(TRACE_MEMORY_TRACKING) ||
         tracer->CheckOption(TRACE_DEVICE_TIMELINE) ||
         tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE) ||
         tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE) ||
-        tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
+        tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES) ||
+        tracer->CheckOption(TRACE_BINARY_TRACE) ||
+        tracer->CheckOption(TRACE_PERFETTO_TRACE) ||
+        tracer->CheckOption(TRACE_INTERVAL_STATS) ||
+        tracer->CheckOption(TRACE_WAIT_ANALYSIS)) {
 
       PTI_ASSERT(!(tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE) &&
                    tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)));
@@ -41,36 +89,27 @@ class ZeTracer {
                    tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE)));
 
       OnZeKernelFinishCallback callback = nullptr;
-      if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-          tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE) &&
-          tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        callback = DeviceAndChromeKernelStagesCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE)) {
-        callback = DeviceAndChromeDeviceCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE)) {
-        callback = DeviceAndChromeKernelCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        callback = DeviceAndChromeStagesCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE) &&
-                 tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        callback = ChromeKernelStagesCallback;
-      } else if (tracer->CheckOption(TRACE_DEVICE_TIMELINE)) {
-        callback = DeviceTimelineCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_DEVICE_TIMELINE)) {
-        callback = ChromeDeviceCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_KERNEL_TIMELINE)) {
-        callback = ChromeKernelCallback;
-      } else if (tracer->CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
-        callback = ChromeStagesCallback;
+      if (tracer->pipeline_.HasDeviceSinks()) {
+        callback = OnKernelFinish;
       }
 
+      KernelGrouping grouping = KERNEL_GROUPING_NAME;
+      bool parsed = KernelStatistics::ParseGrouping(
+          tracer->options_.GetKernelGrouping(), &grouping);
+      PTI_ASSERT(parsed);
+
       kernel_collector = ZeKernelCollector::Create(
-          &(tracer->correlator_),
-          tracer->CheckOption(TRACE_DEVICE_TIMING_VERBOSE),
-          callback, tracer);
+          &(tracer->correlator_), grouping,
+          callback, tracer, tracer->options_.GetPollInterval(),
+          tracer->CheckOption(TRACE_BATCH_TIMESTAMPS),
+          tracer->options_.GetKernelSampling(), tracer->capture_,
+          tracer->CheckOption(TRACE_QUEUE_TIMING),
+          tracer->CheckOption(TRACE_TRANSFER_TIMING),
+          tracer->CheckOption(TRACE_MEMORY_TRACKING),
+          OnMemoryUsage, false,
+          tracer->CheckOption(TRACE_TILE_TIMING),
+          tracer->CheckOption(TRACE_DEPENDENCY_GRAPH),
+          tracer->CheckOption(TRACE_CALL_STACKS));
       if (kernel_collector == nullptr) {
         std::cerr << "[WARNING] Unable to create kernel collector" <<
           std::endl;
@@ -80,23 +119,42 @@ class ZeTracer {
       tracer->kernel_collector_ = kernel_collector;
     }
 
+    if (tracer->CheckOption(TRACE_SUBMISSION_SPANS)) {
+      OnZeSubmissionFinishCallback callback = nullptr;
+      if (tracer->CheckOption(TRACE_DEVICE_TIMELINE)) {
+        callback = OnSubmissionFinish;
+      }
+
+      ZeSubmissionCollector* submission_collector =
+        ZeSubmissionCollector::Create(&(tracer->correlator_), callback, tracer);
+      if (submission_collector == nullptr) {
+        std::cerr << "[WARNING] Unable to create submission collector" <<
+          std::endl;
+        delete tracer;
+        return nullptr;
+      }
+      tracer->submission_collector_ = submission_collector;
+    }
+
     ZeApiCollector* api_collector = nullptr;
-    if (tracer->CheckOption(TRACE_CALL_LOGGING) ||
-        tracer->CheckOption(TRACE_CHROME_CALL_LOGGING) ||
-        tracer->CheckOption(TRACE_HOST_TIMING)) {
+    if (tracer->NeedsFullApi() || tracer->GetApiSubsets() != 0) {
 
       OnZeFunctionFinishCallback callback = nullptr;
-      if (tracer->CheckOption(TRACE_CHROME_CALL_LOGGING)) {
-        callback = ChromeLoggingCallback;
+      if (tracer->pipeline_.HasHostSinks()) {
+        callback = OnFunctionFinish;
       }
 
       ApiCollectorOptions options{false, false, false};
       options.call_tracing = tracer->CheckOption(TRACE_CALL_LOGGING);
       options.need_tid = tracer->CheckOption(TRACE_TID);
       options.need_pid = tracer->CheckOption(TRACE_PID);
+      options.include_api = tracer->options_.GetIncludeApi();
+      options.exclude_api = tracer->options_.GetExcludeApi();
+      options.api_subsets = tracer->GetApiSubsets();
 
       api_collector = ZeApiCollector::Create(
-          &(tracer->correlator_), options, callback, tracer);
+          &(tracer->correlator_), options, callback, tracer,
+          tracer->CheckOption(TRACE_ALLOC_CHURN));
       if (api_collector == nullptr) {
         std::cerr << "[WARNING] Unable to create API collector" << std::endl;
         delete tracer;
@@ -105,18 +163,32 @@ class ZeTracer {
       tracer->api_collector_ = api_collector;
     }
 
+    if (tracer->capture_ != nullptr) {
+      tracer->capture_->Start(OnCaptureChange, tracer);
+    }
+
     return tracer;
   }
 
   ~ZeTracer() {
     total_execution_time_ = correlator_.GetTimestamp();
 
+    if (capture_ != nullptr) {
+      delete capture_;
+    }
+
     if (api_collector_ != nullptr) {
       api_collector_->DisableTracing();
     }
     if (kernel_collector_ != nullptr) {
       kernel_collector_->DisableTracing();
     }
+    if (submission_collector_ != nullptr) {
+      submission_collector_->DisableTracing();
+    }
+    if (module_collector_ != nullptr) {
+      module_collector_->DisableTracing();
+    }
 
     Report();
 
@@ -126,10 +198,26 @@ class ZeTracer {
     if (kernel_collector_ != nullptr) {
       delete kernel_collector_;
     }
+    if (submission_collector_ != nullptr) {
+      delete submission_collector_;
+    }
+    if (module_collector_ != nullptr) {
+      delete module_collector_;
+    }
+
+    if (wait_analysis_ != nullptr) {
+      delete wait_analysis_;
+    }
+
+    if (interval_statistics_ != nullptr) {
+      delete interval_statistics_;
+      std::cerr << "[INFO] Interval statistics were stored to " <<
+        interval_file_name_ << std::endl;
+    }
 
     if (CheckOption(TRACE_LOG_TO_FILE)) {
       std::cerr << "[INFO] Log was stored to " <<
-        options_.GetLogFileName() << std::endl;
+        correlator_.GetLogFileName() << std::endl;
     }
 
     if (chrome_logger_ != nullptr) {
@@ -137,38 +225,122 @@ class ZeTracer {
       std::cerr << "[INFO] Timeline was stored to " <<
         chrome_trace_file_name_ << std::endl;
     }
+
+    if (binary_writer_ != nullptr) {
+      delete binary_writer_;
+      std::cerr << "[INFO] Binary trace was stored to " <<
+        binary_trace_file_name_ << std::endl;
+    }
+
+    if (perfetto_writer_ != nullptr) {
+      delete perfetto_writer_;
+      std::cerr << "[INFO] Perfetto trace was stored to " <<
+        perfetto_trace_file_name_ << std::endl;
+    }
   }
 
   bool CheckOption(unsigned option) {
     return options_.CheckFlag(option);
   }
 
+  // Modes that trace every API call, the others get callbacks for the
+  // subsets they need only
+  bool NeedsFullApi() {
+    return CheckOption(TRACE_CALL_LOGGING) ||
+           CheckOption(TRACE_CHROME_CALL_LOGGING) ||
+           CheckOption(TRACE_HOST_TIMING) ||
+           CheckOption(TRACE_BINARY_TRACE) ||
+           CheckOption(TRACE_PERFETTO_TRACE) ||
+           CheckOption(TRACE_INTERVAL_STATS);
+  }
+
+  // Zero if any of the enabled modes needs the whole API
+  uint32_t GetApiSubsets() {
+    if (NeedsFullApi()) {
+      return 0;
+    }
+
+    uint32_t subsets = 0;
+    if (CheckOption(TRACE_ALLOC_CHURN)) {
+      subsets |= API_SUBSET_ALLOC;
+    }
+    if (CheckOption(TRACE_WAIT_ANALYSIS)) {
+      subsets |= API_SUBSET_WAIT;
+    }
+    return subsets;
+  }
+
   ZeTracer(const ZeTracer& copy) = delete;
   ZeTracer& operator=(const ZeTracer& copy) = delete;
 
  private:
   ZeTracer(const TraceOptions& options)
-      : options_(options), correlator_(options.GetLogFileName()) {
+      : options_(options),
+        correlator_(
+            options.GetLogFileName(),
+            options.CheckFlag(TRACE_ASYNC_LOGGING),
+            options.GetLogBufferSize(),
+            options.GetCompression()) {
     if (CheckOption(TRACE_CHROME_CALL_LOGGING) ||
         CheckOption(TRACE_CHROME_DEVICE_TIMELINE) ||
         CheckOption(TRACE_CHROME_KERNEL_TIMELINE) ||
         CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
       chrome_trace_file_name_ =
         TraceOptions::GetChromeTraceFileName(kChromeTraceFileName);
-      chrome_logger_ = new Logger(chrome_trace_file_name_.c_str());
+      chrome_logger_ = new Logger(
+          chrome_trace_file_name_.c_str(),
+          CheckOption(TRACE_ASYNC_LOGGING),
+          options_.GetLogBufferSize(),
+          options_.GetCompression());
       PTI_ASSERT(chrome_logger_ != nullptr);
+      chrome_trace_file_name_ = chrome_logger_->GetFileName();
 
       std::stringstream stream;
       stream << "[" << std::endl;
       stream << "{\"ph\":\"M\", \"name\":\"process_name\", \"pid\":\"" <<
-        utils::GetPid() << "\", \"tid\":0, \"args\":{\"name\":\"" <<
+        ThreadIdentity::GetPid() << "\", \"tid\":0, \"args\":{\"name\":\"" <<
         utils::GetExecutableName() << "\"}}," << std::endl;
       stream << "{\"ph\":\"M\", \"name\":\"ze_tracer_start_time\", \"pid\":\"" <<
-        utils::GetPid() << "\", \"tid\":0, \"args\":{\"start_time\":\"" <<
+        ThreadIdentity::GetPid() <<
+        "\", \"tid\":0, \"args\":{\"start_time\":\"" <<
         correlator_.GetStartPoint() << "\"}}," << std::endl;
 
       chrome_logger_->Log(stream.str());
     }
+
+    if (CheckOption(TRACE_BINARY_TRACE)) {
+      ShmTraceRing* ring = nullptr;
+      if (CheckOption(TRACE_NODE_TRACE)) {
+        ring = ShmTraceRing::Create(
+            ThreadIdentity::GetPid(), SHM_TRACE_RING_SIZE);
+      }
+
+      if (ring != nullptr) {
+        binary_trace_file_name_ =
+          "node trace daemon (" + ring->GetName() + ")";
+        binary_writer_ = new BinaryTraceWriter(
+            ring, ThreadIdentity::GetPid(),
+            correlator_.GetStartPoint(), correlator_.GetEpochPoint(),
+            utils::GetExecutableName());
+      } else {
+        binary_trace_file_name_ =
+          TraceOptions::GetBinaryTraceFileName(kChromeTraceFileName);
+        binary_writer_ = new BinaryTraceWriter(
+            binary_trace_file_name_, ThreadIdentity::GetPid(),
+            correlator_.GetStartPoint(), correlator_.GetEpochPoint(),
+            utils::GetExecutableName());
+      }
+      PTI_ASSERT(binary_writer_ != nullptr);
+    }
+
+    if (CheckOption(TRACE_PERFETTO_TRACE)) {
+      perfetto_trace_file_name_ =
+        TraceOptions::GetPerfettoTraceFileName(kChromeTraceFileName);
+      perfetto_writer_ = new PerfettoTraceWriter(
+          perfetto_trace_file_name_, ThreadIdentity::GetPid(),
+          utils::GetExecutableName());
+      PTI_ASSERT(perfetto_writer_ != nullptr);
+    }
   }
 
   void ReportHostTiming() {
@@ -239,6 +411,124 @@ class ZeTracer {
     }
   }
   
+  void ReportQueueTiming() {
+    PTI_ASSERT(kernel_collector_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Queue Timing Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    kernel_collector_->PrintQueuesTable();
+  }
+
+  void ReportSubmissionTiming() {
+    PTI_ASSERT(submission_collector_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Submission Timing Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    submission_collector_->PrintSubmissionsTable();
+  }
+
+  void ReportTransferTiming() {
+    PTI_ASSERT(kernel_collector_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Transfer Timing Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    kernel_collector_->PrintTransfersTable();
+  }
+
+  void ReportDependencyGraph() {
+    PTI_ASSERT(kernel_collector_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Dependency Graph Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    kernel_collector_->PrintDependencyTable();
+  }
+
+  void ReportCallStacks() {
+    PTI_ASSERT(kernel_collector_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Call Stack Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    kernel_collector_->PrintStacksTable();
+  }
+
+  void ReportTileTiming() {
+    PTI_ASSERT(kernel_collector_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Tile Timing Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    kernel_collector_->PrintTilesTable();
+  }
+
+  void ReportMemoryTracking() {
+    PTI_ASSERT(kernel_collector_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Memory Tracking Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    kernel_collector_->PrintMemoryTable();
+  }
+
+  void ReportWaitAnalysis() {
+    PTI_ASSERT(wait_analysis_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Wait Analysis Results: ===" << std::endl;
+    stream << std::endl;
+    wait_analysis_->PrintTables(stream);
+    correlator_.Log(stream.str());
+  }
+
+  void ReportAllocChurn() {
+    PTI_ASSERT(api_collector_ != nullptr);
+
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Allocation Churn Results: ===" << std::endl;
+    stream << std::endl;
+    correlator_.Log(stream.str());
+
+    api_collector_->PrintChurnTable();
+  }
+
+  // Collected by all the tool collectors of the process when the
+  // PTI_OVERHEAD environment variable is set
+  void ReportOverhead() {
+    std::stringstream stream;
+    stream << std::endl;
+    stream << "=== Overhead Summary: ===" << std::endl;
+    stream << std::endl;
+    Overhead::PrintTable(stream);
+    correlator_.Log(stream.str());
+  }
+
   void Report() {
     if (CheckOption(TRACE_HOST_TIMING)) {
       ReportHostTiming();
@@ -247,225 +537,170 @@ class ZeTracer {
         CheckOption(TRACE_DEVICE_TIMING_VERBOSE)) {
       ReportDeviceTiming();
     }
+    if (CheckOption(TRACE_QUEUE_TIMING)) {
+      ReportQueueTiming();
+    }
+    if (CheckOption(TRACE_DEPENDENCY_GRAPH)) {
+      ReportDependencyGraph();
+    }
+    if (CheckOption(TRACE_CALL_STACKS)) {
+      ReportCallStacks();
+    }
+    if (CheckOption(TRACE_SUBMISSION_SPANS)) {
+      ReportSubmissionTiming();
+    }
+    if (CheckOption(TRACE_TRANSFER_TIMING)) {
+      ReportTransferTiming();
+    }
+    if (CheckOption(TRACE_TILE_TIMING)) {
+      ReportTileTiming();
+    }
+    if (CheckOption(TRACE_MEMORY_TRACKING)) {
+      ReportMemoryTracking();
+    }
+    if (CheckOption(TRACE_WAIT_ANALYSIS)) {
+      ReportWaitAnalysis();
+    }
+    if (CheckOption(TRACE_ALLOC_CHURN)) {
+      ReportAllocChurn();
+    }
+    if (Overhead::IsEnabled()) {
+      ReportOverhead();
+    }
+    if (CheckOption(TRACE_SAVE_TABLES)) {
+      SaveTables();
+    }
     correlator_.Log("\n");
   }
 
-  static void DeviceTimelineCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    ZeTracer* tracer = reinterpret_cast<ZeTracer*>(data);
-    PTI_ASSERT(tracer != nullptr);
-    std::stringstream stream;
-    if (tracer->CheckOption(TRACE_PID)) {
-      stream << "<PID:" << utils::GetPid() << "> ";
+  // Timing tables are stored for run-to-run comparison with table_diff.py
+  void SaveTables() {
+    TableStore store("ze_tracer");
+    if (kernel_collector_ != nullptr) {
+      store.AddKernels("L0", kernel_collector_->GetKernelInfoMap());
+    }
+    if (api_collector_ != nullptr) {
+      store.AddFunctions("L0", api_collector_->GetFunctionInfoMap());
+    }
+
+    std::string filename =
+      TraceOptions::GetTablesFileName(kChromeTraceFileName);
+    if (store.Write(filename)) {
+      std::cerr << "[INFO] Timing tables were stored to " << filename <<
+        std::endl;
     }
-    stream << "Device Timeline (queue: " << queue <<
-      "): " << name << "(" << id << ") [ns] = " <<
-      appended << " (append) " <<
-      submitted << " (submit) " <<
-      started << " (start) " <<
-      ended << " (end)" << std::endl;
-    tracer->correlator_.Log(stream.str());
   }
 
-  static void ChromeDeviceCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
+  // Footprint counter track of the device (or host) pool, called on each
+  // allocation and free from the application thread
+  static void OnMemoryUsage(
+      void* data, uint32_t pool, uint64_t timestamp, uint64_t bytes) {
     ZeTracer* tracer = reinterpret_cast<ZeTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
+    double value = static_cast<double>(bytes) / BYTES_IN_MBYTES;
 
-    std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << reinterpret_cast<uint64_t>(queue) <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    if (tracer->chrome_logger_ != nullptr) {
+      std::stringstream stream;
+      stream << "{\"ph\":\"C\", \"pid\":\"" << ThreadIdentity::GetPid() <<
+        "\", \"name\":\"" << MemoryTracker::GetPoolName(pool) <<
+        " Memory (MB)\", \"ts\": " << timestamp / NSEC_IN_USEC <<
+        ", \"args\": {\"value\": " << value << "}},\n";
+      tracer->chrome_logger_->Log(stream.str());
+    }
+
+    if (tracer->binary_writer_ != nullptr) {
+      tracer->binary_writer_->WriteCounterRecord(
+          pool, "Memory (MB)", timestamp, value);
+    }
   }
 
-  static void ChromeKernelCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
+  // API calls are not traced at all outside the capture window, while
+  // kernels are filtered by the collector itself
+  static void OnCaptureChange(void* data, bool active) {
     ZeTracer* tracer = reinterpret_cast<ZeTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
+    if (tracer->api_collector_ != nullptr) {
+      tracer->api_collector_->SetTracingEnabled(active);
+    }
+  }
 
-    std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+  // Outputs of completed kernels and API calls, each record goes to them
+  // in the order of addition
+  void CreateSinks() {
+    if (binary_writer_ != nullptr) {
+      pipeline_.AddSink(
+          new BinaryTraceSink<std::string>(binary_writer_), true, true);
+    }
+    if (perfetto_writer_ != nullptr) {
+      pipeline_.AddSink(
+          new PerfettoTraceSink<std::string>(perfetto_writer_), true, true);
+    }
+    if (interval_statistics_ != nullptr) {
+      pipeline_.AddSink(
+          new IntervalStatisticsSink<std::string>(interval_statistics_),
+          true, true);
+    }
+    if (wait_analysis_ != nullptr) {
+      pipeline_.AddSink(
+          new WaitAnalysisSink<std::string>(wait_analysis_), true, true);
+    }
+    if (CheckOption(TRACE_DEVICE_TIMELINE)) {
+      pipeline_.AddSink(
+          new DeviceTimelineSink<std::string>(
+              &correlator_, "append", true, CheckOption(TRACE_PID)),
+          true, false);
+    }
+    if (CheckOption(TRACE_CHROME_DEVICE_TIMELINE) ||
+        CheckOption(TRACE_CHROME_KERNEL_TIMELINE) ||
+        CheckOption(TRACE_CHROME_DEVICE_STAGES)) {
+      pipeline_.AddSink(
+          new ChromeDeviceSink<std::string>(
+              chrome_logger_, "Appended",
+              CheckOption(TRACE_CHROME_KERNEL_TIMELINE),
+              CheckOption(TRACE_CHROME_DEVICE_STAGES)),
+          true, false);
+    }
+    if (CheckOption(TRACE_CHROME_CALL_LOGGING)) {
+      pipeline_.AddSink(
+          new ChromeHostSink<std::string>(chrome_logger_), false, true);
+    }
   }
 
-  static void ChromeStagesCallback(
+  static void OnKernelFinish(
       void* data, void* queue,
       const std::string& id, const std::string& name,
       uint64_t appended, uint64_t submitted,
       uint64_t started, uint64_t ended) {
     ZeTracer* tracer = reinterpret_cast<ZeTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    std::stringstream stream;
-
-    std::string tid = id + "." +
-      std::to_string(reinterpret_cast<uint64_t>(queue));
-
-    PTI_ASSERT(submitted > appended);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Appended)" <<
-      "\", \"ts\": " << appended / NSEC_IN_USEC <<
-      ", \"dur\":" << (submitted - appended) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_runnable\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(started > submitted);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Submitted)" <<
-      "\", \"ts\": " << submitted / NSEC_IN_USEC <<
-      ", \"dur\":" << (started - submitted) / NSEC_IN_USEC <<
-      ", \"cname\":\"cq_build_running\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(ended > started);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << tid <<
-      "\", \"name\":\"" << name << " (Execution)" <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_iowait\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
+    tracer->pipeline_.AddDeviceRecord(
+        {queue, id, name, appended, submitted, started, ended});
   }
 
-  static void ChromeKernelStagesCallback(
+  static void OnSubmissionFinish(
       void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
+      uint64_t submitted, uint64_t started, uint64_t ended) {
     ZeTracer* tracer = reinterpret_cast<ZeTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    std::stringstream stream;
-
-    PTI_ASSERT(submitted > appended);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Appended)" <<
-      "\", \"ts\": " << appended / NSEC_IN_USEC <<
-      ", \"dur\":" << (submitted - appended) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_runnable\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(started > submitted);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Submitted)" <<
-      "\", \"ts\": " << submitted / NSEC_IN_USEC <<
-      ", \"dur\":" << (started - submitted) / NSEC_IN_USEC <<
-      ", \"cname\":\"cq_build_running\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-    stream.str(std::string());
-
-    PTI_ASSERT(ended > started);
-    stream << "{\"ph\":\"X\", \"pid\":\"" << utils::GetPid() <<
-      "\", \"tid\":\"" << name <<
-      "\", \"name\":\"" << name << " (Execution)" <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"cname\":\"thread_state_iowait\"" <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    tracer->chrome_logger_->Log(stream.str());
-  }
-
-  static void DeviceAndChromeDeviceCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    DeviceTimelineCallback(
-        data, queue, id, name, appended, submitted, started, ended);
-    ChromeDeviceCallback(
-        data, queue, id, name, appended, submitted, started, ended);
-  }
 
-  static void DeviceAndChromeKernelCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    DeviceTimelineCallback(
-        data, queue, id, name, appended, submitted, started, ended);
-    ChromeKernelCallback(
-        data, queue, id, name, appended, submitted, started, ended);
-  }
-
-  static void DeviceAndChromeStagesCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    DeviceTimelineCallback(
-        data, queue, id, name, appended, submitted, started, ended);
-    ChromeStagesCallback(
-        data, queue, id, name, appended, submitted, started, ended);
-  }
-
-  static void DeviceAndChromeKernelStagesCallback(
-      void* data, void* queue,
-      const std::string& id, const std::string& name,
-      uint64_t appended, uint64_t submitted,
-      uint64_t started, uint64_t ended) {
-    DeviceTimelineCallback(
-        data, queue, id, name, appended, submitted, started, ended);
-    ChromeKernelStagesCallback(
-        data, queue, id, name, appended, submitted, started, ended);
+    std::stringstream stream;
+    if (tracer->CheckOption(TRACE_PID)) {
+      stream << "<PID:" << ThreadIdentity::GetPid() << "> ";
+    }
+    stream << "Submission Timeline (queue: " << queue << ") [ns] = " <<
+      submitted << " (submit) " <<
+      started << " (start) " <<
+      ended << " (end)" << std::endl;
+    tracer->correlator_.Log(stream.str());
   }
 
-  static void ChromeLoggingCallback(
+  static void OnFunctionFinish(
       void* data, const std::string& id, const std::string& name,
       uint64_t started, uint64_t ended) {
     ZeTracer* tracer = reinterpret_cast<ZeTracer*>(data);
     PTI_ASSERT(tracer != nullptr);
-    std::stringstream stream;
-    stream << "{\"ph\":\"X\", \"pid\":\"" <<
-      utils::GetPid() << "\", \"tid\":\"" << utils::GetTid() <<
-      "\", \"name\":\"" << name <<
-      "\", \"ts\": " << started / NSEC_IN_USEC <<
-      ", \"dur\":" << (ended - started) / NSEC_IN_USEC <<
-      ", \"args\": {\"id\": \"" << id << "\"}"
-      "}," << std::endl;
-    PTI_ASSERT(tracer->chrome_logger_ != nullptr);
-    tracer->chrome_logger_->Log(stream.str());
+    tracer->pipeline_.AddHostRecord(
+        {ThreadIdentity::GetTid(), id, name, started, ended});
   }
 
  private:
@@ -474,11 +709,27 @@ class ZeTracer {
   std::string chrome_trace_file_name_;
   Logger* chrome_logger_ = nullptr;
 
+  std::string binary_trace_file_name_;
+  BinaryTraceWriter* binary_writer_ = nullptr;
+
+  std::string perfetto_trace_file_name_;
+  PerfettoTraceWriter* perfetto_writer_ = nullptr;
+
+  TraceSinkPipeline<std::string> pipeline_;
+
   Correlator correlator_;
   uint64_t total_execution_time_ = 0;
 
   ZeApiCollector* api_collector_ = nullptr;
   ZeKernelCollector* kernel_collector_ = nullptr;
+  ZeSubmissionCollector* submission_collector_ = nullptr;
+  ZeModuleCollector* module_collector_ = nullptr;
+  CaptureControl* capture_ = nullptr;
+
+  std::string interval_file_name_;
+  IntervalStatistics* interval_statistics_ = nullptr;
+
+  WaitAnalysis* wait_analysis_ = nullptr;
 };
 
 #endif // PTI_TOOLS_ZE_TRACER_ZE_TRACER_H_
\ No newline at end of file
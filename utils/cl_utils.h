@@ -331,6 +331,19 @@ inline cl_device_id GetDevice(cl_command_queue queue) {
   return device;
 }
 
+inline bool IsCommandQueueInOrder(cl_command_queue queue) {
+  PTI_ASSERT(queue != nullptr);
+
+  cl_int status = CL_SUCCESS;
+  cl_command_queue_properties properties = 0;
+  status = clGetCommandQueueInfo(queue, CL_QUEUE_PROPERTIES,
+                                 sizeof(cl_command_queue_properties),
+                                 &properties, nullptr);
+  PTI_ASSERT(status == CL_SUCCESS);
+
+  return (properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) == 0;
+}
+
 inline cl_ulong GetEventTimestamp(cl_event event, cl_profiling_info info) {
   PTI_ASSERT(event != nullptr);
 
@@ -7,18 +7,37 @@
 #ifndef PTI_UTILS_DEBUG_LINE_PARSER_H_
 #define PTI_UTILS_DEBUG_LINE_PARSER_H_
 
+#include <stddef.h>
 #include <string.h>
 
-#include <string>
+#include <limits>
 #include <vector>
 
 #include "dwarf_state_machine.h"
 
+// File and directory names point into .debug_line section, so the parser
+// should not outlive the binary
 struct FileInfo {
-  std::string name;
+  const char* name;
   uint32_t path_index;
 };
 
+struct DwarfLineUnit {
+  const Dwarf32LineNumberProgramHeader* header;
+  const uint8_t* data;
+  uint32_t size; // With the header
+};
+
+struct DwarfLineUnitInfo {
+  bool processed;
+  const uint8_t* program;
+  std::vector<const char*> dir_list;
+  std::vector<FileInfo> file_list;
+};
+
+// Units of the section are located on the first request and the header of
+// each unit is processed once, only the requested unit line program is
+// decoded
 class DebugLineParser {
  public:
   DebugLineParser(const uint8_t* data, uint32_t size) :
@@ -38,50 +57,88 @@ class DebugLineParser {
     return true;
   }
 
-  std::vector<FileInfo> GetFileList() const {
+  uint32_t GetUnitCount() const {
     if (!IsValid()) {
-      return std::vector<FileInfo>();
+      return 0;
     }
-    std::vector<FileInfo> file_list;
-    ProcessHeader(&file_list, nullptr);
-    return file_list;
+    return GetUnitList().size();
   }
 
-  std::vector<std::string> GetDirList() const {
-    if (!IsValid()) {
-      return std::vector<std::string>();
-    }
-    std::vector<std::string> dir_list;
-    ProcessHeader(nullptr, &dir_list);
-    return dir_list;
+  const std::vector<FileInfo>& GetFileList(uint32_t unit = 0) const {
+    return GetUnitInfo(unit).file_list;
   }
 
-  std::vector<LineInfo> GetLineInfo() const {
-    if (!IsValid()) {
+  const std::vector<const char*>& GetDirList(uint32_t unit = 0) const {
+    return GetUnitInfo(unit).dir_list;
+  }
+
+  std::vector<LineInfo> GetLineInfo(uint32_t unit = 0) const {
+    if (unit >= GetUnitCount()) {
       return std::vector<LineInfo>();
     }
 
-    const uint8_t* ptr = ProcessHeader(nullptr, nullptr);
-    PTI_ASSERT(ptr < data_ + size_);
-    const uint8_t* line_number_program = ptr;
-    PTI_ASSERT(data_ + size_ - line_number_program <
-        (std::numeric_limits<uint32_t>::max)());
-    uint32_t line_number_program_size =
-      static_cast<uint32_t>(data_ + size_ - line_number_program);
-    std::vector<LineInfo> line_info = DwarfStateMachine(
-        line_number_program, line_number_program_size,
-        reinterpret_cast<const Dwarf32LineNumberProgramHeader*>(data_)).Run();
-    if (line_info.size() == 0) {
+    const DwarfLineUnitInfo& unit_info = GetUnitInfo(unit);
+    const DwarfLineUnit& line_unit = GetUnitList()[unit];
+    const uint8_t* end = line_unit.data + line_unit.size;
+    if (unit_info.program == nullptr || unit_info.program >= end) {
       return std::vector<LineInfo>();
     }
 
-    return line_info;
+    PTI_ASSERT(end - unit_info.program <
+        (std::numeric_limits<uint32_t>::max)());
+    uint32_t line_number_program_size =
+      static_cast<uint32_t>(end - unit_info.program);
+    return DwarfStateMachine(
+        unit_info.program, line_number_program_size,
+        line_unit.header).Run();
   }
 
  private:
-  const uint8_t* ProcessHeader(std::vector<FileInfo>* file_list,
-                               std::vector<std::string>* dir_list) const {
-    const uint8_t* ptr = data_;
+  const std::vector<DwarfLineUnit>& GetUnitList() const {
+    if (unit_list_.empty()) {
+      const uint8_t* ptr = data_;
+      const uint8_t* end = data_ + size_;
+      while (end - ptr >=
+             static_cast<ptrdiff_t>(sizeof(Dwarf32LineNumberProgramHeader))) {
+        const Dwarf32LineNumberProgramHeader* header =
+          reinterpret_cast<const Dwarf32LineNumberProgramHeader*>(ptr);
+        if (header->version != DWARF_VERSION) {
+          break;
+        }
+
+        uint64_t size = static_cast<uint64_t>(header->unit_length) +
+          sizeof(header->unit_length);
+        if (size > static_cast<uint64_t>(end - ptr)) {
+          size = end - ptr;
+        }
+
+        unit_list_.push_back({header, ptr, static_cast<uint32_t>(size)});
+        ptr += size;
+      }
+      unit_info_list_.resize(unit_list_.size());
+    }
+    return unit_list_;
+  }
+
+  const DwarfLineUnitInfo& GetUnitInfo(uint32_t unit) const {
+    static const DwarfLineUnitInfo empty{};
+    if (unit >= GetUnitCount()) {
+      return empty;
+    }
+
+    DwarfLineUnitInfo& unit_info = unit_info_list_[unit];
+    if (!unit_info.processed) {
+      unit_info.program = ProcessHeader(
+          unit_list_[unit].data, &unit_info.file_list, &unit_info.dir_list);
+      unit_info.processed = true;
+    }
+    return unit_info;
+  }
+
+  static const uint8_t* ProcessHeader(const uint8_t* ptr,
+                                      std::vector<FileInfo>* file_list,
+                                      std::vector<const char*>* dir_list) {
+    PTI_ASSERT(file_list != nullptr && dir_list != nullptr);
     const Dwarf32LineNumberProgramHeader* header =
       reinterpret_cast<const Dwarf32LineNumberProgramHeader*>(ptr);
 
@@ -98,9 +155,7 @@ class DebugLineParser {
     // include_directories
     while (*ptr != 0) {
       const char* include_directory = reinterpret_cast<const char*>(ptr);
-      if (dir_list != nullptr) {
-        dir_list->push_back(include_directory);
-      }
+      dir_list->push_back(include_directory);
       ptr += strlen(include_directory) + 1;
     }
     ++ptr;
@@ -108,8 +163,8 @@ class DebugLineParser {
     // file_names
     PTI_ASSERT(*ptr != 0);
     while (*ptr != 0) {
-      std::string file_name(reinterpret_cast<const char*>(ptr));
-      ptr += file_name.size() + 1;
+      const char* file_name = reinterpret_cast<const char*>(ptr);
+      ptr += strlen(file_name) + 1;
 
       bool done = false;
       uint32_t directory_index = 0;
@@ -124,9 +179,7 @@ class DebugLineParser {
       ptr = utils::leb128::Decode32(ptr, size, done);
       PTI_ASSERT(done);
 
-      if (file_list != nullptr) {
-        file_list->push_back({file_name, directory_index});
-      }
+      file_list->push_back({file_name, directory_index});
     }
 
     ++ptr;
@@ -135,6 +188,9 @@ class DebugLineParser {
 
   const uint8_t* data_;
   uint32_t size_;
+
+  mutable std::vector<DwarfLineUnit> unit_list_;
+  mutable std::vector<DwarfLineUnitInfo> unit_info_list_;
 };
 
 #endif // PTI_UTILS_DEBUG_LINE_PARSER_H_
\ No newline at end of file
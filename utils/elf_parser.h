@@ -9,6 +9,8 @@
 
 #include <string.h>
 
+#include <limits>
+#include <string>
 #include <vector>
 
 #include "elf.h"
@@ -16,9 +18,21 @@
 #include "debug_info_parser.h"
 #include "debug_abbrev_parser.h"
 
+struct ElfSection {
+  const char* name;
+  const uint8_t* data;
+  uint64_t size;
+};
+
+// Section table is built once per binary, DWARF sections are only touched
+// by the queries that need them
 class ElfParser {
  public:
-  ElfParser(const uint8_t* data, uint32_t size) : data_(data), size_(size) {}
+  ElfParser(const uint8_t* data, uint32_t size) : data_(data), size_(size) {
+    if (IsValid()) {
+      ReadSectionTable();
+    }
+  }
 
   bool IsValid() const {
     if (data_ == nullptr || size_ < sizeof(Elf64Header)) {
@@ -59,48 +73,32 @@ class ElfParser {
       return std::vector<std::string>();
     }
 
-    GetSection(".debug_abbrev", &section, &section_size);
-    if (section == nullptr || section_size == 0) {
-      return std::vector<std::string>();
-    }
+    const std::vector<FileInfo>& file_list = line_parser.GetFileList();
+    const std::vector<const char*>& dir_list = line_parser.GetDirList();
 
-    PTI_ASSERT(section_size < (std::numeric_limits<uint32_t>::max)());
-    DebugAbbrevParser abbrev_parser(section, static_cast<uint32_t>(section_size));
-    if (!abbrev_parser.IsValid()) {
-      return std::vector<std::string>();
-    }
-
-    DwarfCompUnitMap comp_unit_map = abbrev_parser.GetCompUnitMap();
-    if (comp_unit_map.size() == 0) {
-      return std::vector<std::string>();
-    }
-
-    GetSection(".debug_info", &section, &section_size);
-    if (section == nullptr || section_size == 0) {
-      return std::vector<std::string>();
-    }
-
-    PTI_ASSERT(section_size < (std::numeric_limits<uint32_t>::max)());
-    DebugInfoParser info_parser(section, static_cast<uint32_t>(section_size));
-    if (!info_parser.IsValid()) {
-      return std::vector<std::string>();
+    // Compilation directory is only needed for the files without
+    // include directory
+    std::string comp_dir;
+    for (size_t i = 0; i < file_list.size(); ++i) {
+      if (file_list[i].path_index == 0) {
+        comp_dir = GetCompDir();
+        break;
+      }
     }
 
     std::vector<std::string> file_path_list;
-    std::vector<FileInfo> file_list = line_parser.GetFileList();
-    std::vector<std::string> dir_list = line_parser.GetDirList();
     for (size_t i = 0; i < file_list.size(); ++i) {
       uint32_t path_index = file_list[i].path_index;
       PTI_ASSERT(path_index <= dir_list.size());
       if (path_index == 0) {
-        std::string comp_dir = info_parser.GetCompDir(comp_unit_map);
         if (!comp_dir.empty()) {
           file_path_list.push_back(comp_dir + "/" + file_list[i].name);
         } else {
           file_path_list.push_back(file_list[i].name);
         }
       } else {
-        file_path_list.push_back(dir_list[path_index - 1] + "/" + file_list[i].name);
+        file_path_list.push_back(
+            std::string(dir_list[path_index - 1]) + "/" + file_list[i].name);
       }
     }
 
@@ -145,23 +143,48 @@ class ElfParser {
     return binary;
   }
 
- private:
-  void GetSection(const char* name,
-                  const uint8_t** section,
-                  uint64_t* section_size) const {
-    PTI_ASSERT(section != nullptr && section_size != nullptr);
+  const std::vector<ElfSection>& GetSectionList() const {
+    return section_list_;
+  }
 
+ private:
+  void ReadSectionTable() {
     const Elf64Header* header = reinterpret_cast<const Elf64Header*>(data_);
+    uint64_t table_size =
+      static_cast<uint64_t>(header->shnum) * sizeof(Elf64SectionHeader);
+    if (header->shoff + table_size > size_ ||
+        header->shstrndx >= header->shnum) {
+      return;
+    }
+
     const Elf64SectionHeader* section_header =
       reinterpret_cast<const Elf64SectionHeader*>(data_ + header->shoff);
+    if (section_header[header->shstrndx].offset >= size_) {
+      return;
+    }
     const char* name_section = reinterpret_cast<const char*>(
         data_ + section_header[header->shstrndx].offset);
-    
+
     for (uint32_t i = 1; i < header->shnum; ++i) {
-      const char* section_name = name_section + section_header[i].name;
-      if (strcmp(section_name, name) == 0) {
-        *section = data_ + section_header[i].offset;
-        *section_size = section_header[i].size;
+      if (section_header[i].offset + section_header[i].size > size_) {
+        continue;
+      }
+      section_list_.push_back({
+          name_section + section_header[i].name,
+          data_ + section_header[i].offset,
+          section_header[i].size});
+    }
+  }
+
+  void GetSection(const char* name,
+                  const uint8_t** section,
+                  uint64_t* section_size) const {
+    PTI_ASSERT(section != nullptr && section_size != nullptr);
+
+    for (const ElfSection& elf_section : section_list_) {
+      if (strcmp(elf_section.name, name) == 0) {
+        *section = elf_section.data;
+        *section_size = elf_section.size;
         return;
       }
     }
@@ -170,9 +193,44 @@ class ElfParser {
     *section_size = 0;
   }
 
+  std::string GetCompDir() const {
+    const uint8_t* section = nullptr;
+    uint64_t section_size = 0;
+    GetSection(".debug_abbrev", &section, &section_size);
+    if (section == nullptr || section_size == 0) {
+      return std::string();
+    }
+
+    PTI_ASSERT(section_size < (std::numeric_limits<uint32_t>::max)());
+    DebugAbbrevParser abbrev_parser(
+        section, static_cast<uint32_t>(section_size));
+    if (!abbrev_parser.IsValid()) {
+      return std::string();
+    }
+
+    DwarfCompUnitMap comp_unit_map = abbrev_parser.GetCompUnitMap();
+    if (comp_unit_map.size() == 0) {
+      return std::string();
+    }
+
+    GetSection(".debug_info", &section, &section_size);
+    if (section == nullptr || section_size == 0) {
+      return std::string();
+    }
+
+    PTI_ASSERT(section_size < (std::numeric_limits<uint32_t>::max)());
+    DebugInfoParser info_parser(section, static_cast<uint32_t>(section_size));
+    if (!info_parser.IsValid()) {
+      return std::string();
+    }
+
+    return info_parser.GetCompDir(comp_unit_map);
+  }
+
  private:
   const uint8_t* data_ = nullptr;
   uint32_t size_ = 0;
+  std::vector<ElfSection> section_list_;
 };
 
 #endif // PTI_UTILS_ELF_PARSER_H_
\ No newline at end of file
@@ -0,0 +1,161 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_UTILS_GTPIN_READBACK_H_
+#define PTI_UTILS_GTPIN_READBACK_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtpin_utils.h"
+
+#define GTPIN_READBACK_MAX_PENDING 64
+
+struct GTPinSnapshot {
+  void* owner;
+  std::vector<uint32_t> thread_count_list; // Per block
+  std::vector<uint8_t> data; // Records of all the threads of all the blocks
+};
+
+typedef void (*OnGTPinSnapshot)(const GTPinSnapshot& snapshot, void* data);
+
+// Moves reduction of GTPin profiling buffers off the application thread.
+// GTPin reuses the buffers once the completion callback returns, so raw
+// records are copied into a snapshot there, and the snapshot is reduced by
+// the worker thread later. Snapshots are recycled, so the next dispatch
+// fills a free one while the previous one is still being reduced; if all
+// of them are pending, the application thread waits for the worker
+class GTPinReadback {
+ public: // Interface
+  static GTPinReadback* Create(
+      uint32_t record_size, OnGTPinSnapshot callback, void* data) {
+    PTI_ASSERT(record_size > 0);
+    PTI_ASSERT(callback != nullptr);
+    GTPinReadback* readback = new GTPinReadback(record_size, callback, data);
+    PTI_ASSERT(readback != nullptr);
+    return readback;
+  }
+
+  ~GTPinReadback() {
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+
+    PTI_ASSERT(queue_.empty());
+    for (auto snapshot : free_list_) {
+      delete snapshot;
+    }
+  }
+
+  // Should be called from GTPin completion callback
+  void Enqueue(void* owner, const std::vector<GTPinMem>& memory_list) {
+    GTPinSnapshot* snapshot = Acquire();
+    PTI_ASSERT(snapshot != nullptr);
+
+    snapshot->owner = owner;
+    snapshot->thread_count_list.resize(memory_list.size());
+    size_t size = 0;
+    for (size_t i = 0; i < memory_list.size(); ++i) {
+      uint32_t thread_count = GTPin_MemSampleLength(memory_list[i]);
+      PTI_ASSERT(thread_count > 0);
+      snapshot->thread_count_list[i] = thread_count;
+      size += thread_count;
+    }
+    snapshot->data.resize(size * record_size_);
+
+    uint8_t* record = snapshot->data.data();
+    for (size_t i = 0; i < memory_list.size(); ++i) {
+      for (uint32_t tid = 0; tid < snapshot->thread_count_list[i]; ++tid) {
+        GTPINTOOL_STATUS status = GTPin_MemRead(
+            memory_list[i], tid, record_size_,
+            reinterpret_cast<char*>(record), nullptr);
+        PTI_ASSERT(status == GTPINTOOL_STATUS_SUCCESS);
+        record += record_size_;
+      }
+    }
+
+    {
+      const std::lock_guard<std::mutex> lock(lock_);
+      queue_.push_back(snapshot);
+    }
+    cv_.notify_all();
+  }
+
+  // Waits till all the queued snapshots are reduced
+  void Flush() {
+    std::unique_lock<std::mutex> lock(lock_);
+    cv_.wait(lock, [this]{ return queue_.empty() && !busy_; });
+  }
+
+  GTPinReadback(const GTPinReadback& copy) = delete;
+  GTPinReadback& operator=(const GTPinReadback& copy) = delete;
+
+ private: // Implementation
+  GTPinReadback(uint32_t record_size, OnGTPinSnapshot callback, void* data)
+      : record_size_(record_size), callback_(callback), data_(data) {
+    thread_ = std::thread(&GTPinReadback::Run, this);
+  }
+
+  GTPinSnapshot* Acquire() {
+    std::unique_lock<std::mutex> lock(lock_);
+    if (free_list_.empty() && snapshot_count_ < GTPIN_READBACK_MAX_PENDING) {
+      ++snapshot_count_;
+      return new GTPinSnapshot;
+    }
+
+    cv_.wait(lock, [this]{ return !free_list_.empty(); });
+    GTPinSnapshot* snapshot = free_list_.back();
+    free_list_.pop_back();
+    return snapshot;
+  }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+      cv_.wait(lock, [this]{ return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        break;
+      }
+
+      GTPinSnapshot* snapshot = queue_.front();
+      queue_.pop_front();
+      busy_ = true;
+
+      lock.unlock();
+      callback_(*snapshot, data_);
+      lock.lock();
+
+      free_list_.push_back(snapshot);
+      busy_ = false;
+      cv_.notify_all();
+    }
+  }
+
+ private: // Data
+  uint32_t record_size_ = 0;
+  OnGTPinSnapshot callback_ = nullptr;
+  void* data_ = nullptr;
+
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::thread thread_;
+  bool stop_ = false;
+  bool busy_ = false;
+
+  uint32_t snapshot_count_ = 0;
+  std::deque<GTPinSnapshot*> queue_;
+  std::vector<GTPinSnapshot*> free_list_;
+};
+
+#endif // PTI_UTILS_GTPIN_READBACK_H_
\ No newline at end of file
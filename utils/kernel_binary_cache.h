@@ -0,0 +1,243 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_UTILS_KERNEL_BINARY_CACHE_H_
+#define PTI_UTILS_KERNEL_BINARY_CACHE_H_
+
+#include <stdio.h>
+#include <string.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dwarf_state_machine.h"
+#include "gen_binary_decoder.h"
+#include "pti_assert.h"
+#include "utils.h"
+
+#define KERNEL_CACHE_DIR_ENV "PTI_KERNEL_CACHE_DIR"
+#define KERNEL_CACHE_VERSION 1
+
+const char kKernelCacheMagic[] = {'P', 'T', 'I', 'K', 'C', 'A', 'C', 'H'};
+
+// Entry file layout, all the parts are 8 bytes aligned so the file can be
+// mapped as is:
+//   KernelCacheHeader
+//   KernelCacheInstruction[instruction_count]
+//   KernelCacheLine[line_count]
+//   KernelCacheString[file_count]
+//   char[string_size] - instruction texts and file names, not terminated
+#pragma pack(push, 1)
+struct KernelCacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t instruction_count;
+  uint32_t line_count;
+  uint32_t file_count;
+  uint64_t string_size;
+};
+
+struct KernelCacheString {
+  uint32_t offset;
+  uint32_t size;
+};
+
+struct KernelCacheInstruction {
+  int32_t offset;
+  uint32_t reserved;
+  KernelCacheString text;
+};
+
+struct KernelCacheLine {
+  uint64_t address;
+  uint32_t file;
+  uint32_t line;
+};
+#pragma pack(pop)
+
+struct KernelBinaryEntry {
+  std::vector<Instruction> instruction_list;
+  std::vector<LineInfo> line_info_list;
+  std::vector<std::string> file_list;
+};
+
+// Decoded kernels keyed by the hash of the binary they come from, so the
+// modules the application JITs on every start are disassembled and their
+// DWARF is parsed once. Enabled by PTI_KERNEL_CACHE_DIR variable, that
+// should point to an existing directory
+class KernelBinaryCache {
+ public:
+  // Returns nullptr if the cache is not enabled
+  static KernelBinaryCache* Create() {
+    std::string path = utils::GetEnv(KERNEL_CACHE_DIR_ENV);
+    if (path.empty()) {
+      return nullptr;
+    }
+
+    KernelBinaryCache* cache = new KernelBinaryCache(path);
+    PTI_ASSERT(cache != nullptr);
+    return cache;
+  }
+
+  // FNV-1a over the binary and the kernel name
+  static uint64_t GetKey(const std::vector<uint8_t>& binary,
+                         const std::string& kernel_name) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint8_t value : binary) {
+      hash = (hash ^ value) * 0x100000001b3ull;
+    }
+    for (char value : kernel_name) {
+      hash = (hash ^ static_cast<uint8_t>(value)) * 0x100000001b3ull;
+    }
+    return hash;
+  }
+
+  bool Load(uint64_t key, KernelBinaryEntry* entry) const {
+    PTI_ASSERT(entry != nullptr);
+
+    std::vector<uint8_t> data = utils::LoadBinaryFile(GetEntryPath(key));
+    if (data.size() < sizeof(KernelCacheHeader)) {
+      return false;
+    }
+
+    const KernelCacheHeader* header =
+      reinterpret_cast<const KernelCacheHeader*>(data.data());
+    if (memcmp(header->magic, kKernelCacheMagic, sizeof(header->magic)) != 0 ||
+        header->version != KERNEL_CACHE_VERSION) {
+      return false;
+    }
+
+    uint64_t size = sizeof(KernelCacheHeader) +
+      header->instruction_count * sizeof(KernelCacheInstruction) +
+      header->line_count * sizeof(KernelCacheLine) +
+      header->file_count * sizeof(KernelCacheString) +
+      header->string_size;
+    if (size != data.size()) {
+      return false;
+    }
+
+    const uint8_t* ptr = data.data() + sizeof(KernelCacheHeader);
+    const KernelCacheInstruction* instruction_list =
+      reinterpret_cast<const KernelCacheInstruction*>(ptr);
+    ptr += header->instruction_count * sizeof(KernelCacheInstruction);
+    const KernelCacheLine* line_list =
+      reinterpret_cast<const KernelCacheLine*>(ptr);
+    ptr += header->line_count * sizeof(KernelCacheLine);
+    const KernelCacheString* file_list =
+      reinterpret_cast<const KernelCacheString*>(ptr);
+    ptr += header->file_count * sizeof(KernelCacheString);
+    const char* string_data = reinterpret_cast<const char*>(ptr);
+
+    KernelBinaryEntry result;
+    for (uint32_t i = 0; i < header->instruction_count; ++i) {
+      const KernelCacheString& text = instruction_list[i].text;
+      if (!IsValidString(text, header->string_size)) {
+        return false;
+      }
+      result.instruction_list.push_back({
+          instruction_list[i].offset,
+          std::string(string_data + text.offset, text.size)});
+    }
+    for (uint32_t i = 0; i < header->line_count; ++i) {
+      result.line_info_list.push_back(
+          {line_list[i].address, line_list[i].file, line_list[i].line});
+    }
+    for (uint32_t i = 0; i < header->file_count; ++i) {
+      if (!IsValidString(file_list[i], header->string_size)) {
+        return false;
+      }
+      result.file_list.push_back(
+          std::string(string_data + file_list[i].offset, file_list[i].size));
+    }
+
+    *entry = std::move(result);
+    return true;
+  }
+
+  // Entry is written to a temporary file first, so concurrent processes
+  // never see a partial one
+  void Store(uint64_t key, const KernelBinaryEntry& entry) const {
+    std::string strings;
+    std::vector<KernelCacheInstruction> instruction_list;
+    for (const Instruction& instruction : entry.instruction_list) {
+      instruction_list.push_back(
+          {instruction.offset, 0, AddString(&strings, instruction.text)});
+    }
+    std::vector<KernelCacheLine> line_list;
+    for (const LineInfo& line_info : entry.line_info_list) {
+      line_list.push_back(
+          {line_info.address, line_info.file, line_info.line});
+    }
+    std::vector<KernelCacheString> file_list;
+    for (const std::string& file : entry.file_list) {
+      file_list.push_back(AddString(&strings, file));
+    }
+
+    KernelCacheHeader header{};
+    memcpy(header.magic, kKernelCacheMagic, sizeof(header.magic));
+    header.version = KERNEL_CACHE_VERSION;
+    header.instruction_count = static_cast<uint32_t>(instruction_list.size());
+    header.line_count = static_cast<uint32_t>(line_list.size());
+    header.file_count = static_cast<uint32_t>(file_list.size());
+    header.string_size = strings.size();
+
+    std::string path = GetEntryPath(key);
+    std::string temp_path = path + "." + std::to_string(utils::GetPid());
+    std::ofstream file(temp_path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+      return;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(instruction_list.data()),
+               instruction_list.size() * sizeof(KernelCacheInstruction));
+    file.write(reinterpret_cast<const char*>(line_list.data()),
+               line_list.size() * sizeof(KernelCacheLine));
+    file.write(reinterpret_cast<const char*>(file_list.data()),
+               file_list.size() * sizeof(KernelCacheString));
+    file.write(strings.data(), strings.size());
+    file.close();
+
+    if (!file.good() || rename(temp_path.c_str(), path.c_str()) != 0) {
+      remove(temp_path.c_str());
+    }
+  }
+
+  KernelBinaryCache(const KernelBinaryCache& copy) = delete;
+  KernelBinaryCache& operator=(const KernelBinaryCache& copy) = delete;
+
+ private:
+  explicit KernelBinaryCache(const std::string& path) : path_(path) {}
+
+  std::string GetEntryPath(uint64_t key) const {
+    std::stringstream stream;
+    stream << path_ << "/kernel_" << std::hex << std::setw(16) <<
+      std::setfill('0') << key << ".bin";
+    return stream.str();
+  }
+
+  static KernelCacheString AddString(std::string* strings,
+                                     const std::string& value) {
+    PTI_ASSERT(strings != nullptr);
+    KernelCacheString result{
+        static_cast<uint32_t>(strings->size()),
+        static_cast<uint32_t>(value.size())};
+    strings->append(value);
+    return result;
+  }
+
+  static bool IsValidString(const KernelCacheString& value, uint64_t size) {
+    return static_cast<uint64_t>(value.offset) + value.size <= size;
+  }
+
+ private:
+  std::string path_;
+};
+
+#endif // PTI_UTILS_KERNEL_BINARY_CACHE_H_
\ No newline at end of file
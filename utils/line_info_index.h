@@ -0,0 +1,75 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_UTILS_LINE_INFO_INDEX_H_
+#define PTI_UTILS_LINE_INFO_INDEX_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "dwarf_state_machine.h"
+#include "pti_assert.h"
+
+struct LineRange {
+  uint64_t start; // Inclusive
+  uint64_t end; // Exclusive
+  LineInfo line_info;
+};
+
+// Address to source line index built once from .debug_line rows. Each row
+// covers the addresses up to the next row (or up to the end address for
+// the last one), the ranges are sorted by start address, so any address
+// is resolved in O(log n)
+class LineInfoIndex {
+ public:
+  LineInfoIndex(const std::vector<LineInfo>& line_info_list,
+                uint64_t end_address) {
+    for (size_t i = 0; i < line_info_list.size(); ++i) {
+      uint64_t start = line_info_list[i].address;
+      uint64_t end = (i + 1 < line_info_list.size()) ?
+                     line_info_list[i + 1].address : end_address;
+      if (start < end) {
+        range_list_.push_back({start, end, line_info_list[i]});
+      }
+    }
+
+    std::stable_sort(range_list_.begin(), range_list_.end(),
+        [](const LineRange& left, const LineRange& right) {
+          return left.start < right.start;
+        });
+  }
+
+  // Returns nullptr if the address is not covered by any row
+  const LineInfo* Find(uint64_t address) const {
+    auto it = std::upper_bound(
+        range_list_.begin(), range_list_.end(), address,
+        [](uint64_t value, const LineRange& range) {
+          return value < range.start;
+        });
+    if (it == range_list_.begin()) {
+      return nullptr;
+    }
+
+    --it;
+    if (address >= it->end) {
+      return nullptr;
+    }
+    return &(it->line_info);
+  }
+
+  const std::vector<LineRange>& GetRangeList() const {
+    return range_list_;
+  }
+
+  bool IsEmpty() const {
+    return range_list_.empty();
+  }
+
+ private:
+  std::vector<LineRange> range_list_;
+};
+
+#endif // PTI_UTILS_LINE_INFO_INDEX_H_
\ No newline at end of file
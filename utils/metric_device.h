@@ -7,7 +7,9 @@
 #ifndef PTI_UTILS_METRIC_DEVICE_H_
 #define PTI_UTILS_METRIC_DEVICE_H_
 
-#include <string.h>
+#include <map>
+#include <mutex>
+#include <string>
 
 #include "metric_utils.h"
 #include "pti_assert.h"
@@ -16,109 +18,186 @@
 
 namespace md = MetricsDiscovery;
 
-class MetricDevice {
- public:
-  static uint32_t GetDeviceCount() {
-    SharedLibrary* lib = OpenMetricsLibrary();
-    if (lib == nullptr) {
+struct MetricSetIndex {
+  uint32_t group_id;
+  uint32_t set_id;
+};
+
+using MetricSetIndexMap = std::map<std::string, MetricSetIndex>;
+
+// Process-wide metrics discovery state: the library, the adapter group and
+// the metrics devices are opened on the first request and kept open for
+// reuse. The context is never destroyed, since metric devices may be
+// released from static destructors at exit
+class MetricContext {
+ public: // Interface
+  // Returns nullptr if metrics discovery library is not available
+  static MetricContext* Get() {
+    static MetricContext* context = Create();
+    return context;
+  }
+
+  uint32_t GetDeviceCount() const {
+    return adapter_group_->GetParams()->AdapterCount;
+  }
+
+  uint32_t GetSubDeviceCount(uint32_t device_id) const {
+    if (device_id >= GetDeviceCount()) {
       return 0;
     }
+    return GetAdapter(device_id)->GetParams()->SubDevicesCount;
+  }
 
-    md::OpenAdapterGroup_fn OpenAdapterGroup =
-      lib->GetSym<md::OpenAdapterGroup_fn>("OpenAdapterGroup");
-    PTI_ASSERT(OpenAdapterGroup != nullptr);
+  md::IAdapter_1_9* GetAdapter(uint32_t device_id) const {
+    PTI_ASSERT(device_id < GetDeviceCount());
+    md::IAdapter_1_9* adapter = adapter_group_->GetAdapter(device_id);
+    PTI_ASSERT(adapter != nullptr);
+    return adapter;
+  }
 
-    md::IAdapterGroup_1_9* adapter_group = nullptr;
-    md::TCompletionCode status = OpenAdapterGroup(&adapter_group);
-    PTI_ASSERT(status == md::CC_OK);
-    PTI_ASSERT(adapter_group != nullptr);
+  md::IMetricsDevice_1_5* GetDevice(
+      uint32_t device_id, uint32_t sub_device_id) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    DeviceKey key(device_id, sub_device_id);
+    auto it = device_map_.find(key);
+    if (it != device_map_.end()) {
+      return it->second;
+    }
+
+    md::IAdapter_1_9* adapter = GetAdapter(device_id);
+    md::IMetricsDevice_1_5* device = nullptr;
+    md::TCompletionCode status = md::CC_OK;
+
+    uint32_t sub_device_count = adapter->GetParams()->SubDevicesCount;
+    if (sub_device_count == 0) {
+      status = adapter->OpenMetricsDevice(&device);
+    } else {
+      PTI_ASSERT(sub_device_id < sub_device_count);
+      status = adapter->OpenMetricsSubDevice(sub_device_id, &device);
+    }
+    PTI_ASSERT(status == md::CC_OK || status == md::CC_ALREADY_INITIALIZED);
+    PTI_ASSERT(device != nullptr);
 
-    uint32_t device_count = adapter_group->GetParams()->AdapterCount;
-    delete lib;
-    return device_count;
+    device_map_[key] = device;
+    return device;
   }
 
-  static uint32_t GetSubDeviceCount(uint32_t device_id) {
-    SharedLibrary* lib = OpenMetricsLibrary();
-    if (lib == nullptr) {
-      return 0;
+  // Metric sets are enumerated once per device
+  const MetricSetIndexMap& GetSetIndexMap(
+      uint32_t device_id, uint32_t sub_device_id) {
+    md::IMetricsDevice_1_5* device = GetDevice(device_id, sub_device_id);
+
+    const std::lock_guard<std::mutex> lock(lock_);
+    DeviceKey key(device_id, sub_device_id);
+    auto it = set_map_.find(key);
+    if (it != set_map_.end()) {
+      return it->second;
     }
 
-    md::OpenAdapterGroup_fn OpenAdapterGroup =
-      lib->GetSym<md::OpenAdapterGroup_fn>("OpenAdapterGroup");
-    PTI_ASSERT(OpenAdapterGroup != nullptr);
+    MetricSetIndexMap& index_map = set_map_[key];
+    uint32_t group_count = device->GetParams()->ConcurrentGroupsCount;
+    for (uint32_t gid = 0; gid < group_count; ++gid) {
+      md::IConcurrentGroup_1_5* group = device->GetConcurrentGroup(gid);
+      PTI_ASSERT(group != nullptr);
 
-    md::IAdapterGroup_1_9* adapter_group = nullptr;
-    md::TCompletionCode status = OpenAdapterGroup(&adapter_group);
-    PTI_ASSERT(status == md::CC_OK);
-    PTI_ASSERT(adapter_group != nullptr);
+      uint32_t set_count = group->GetParams()->MetricSetsCount;
+      for (uint32_t sid = 0; sid < set_count; ++sid) {
+        md::IMetricSet_1_5* set = group->GetMetricSet(sid);
+        PTI_ASSERT(set != nullptr);
 
-    uint32_t sub_device_count = 0;
-    if (device_id < adapter_group->GetParams()->AdapterCount) {
-      md::IAdapter_1_9* adapter = adapter_group->GetAdapter(device_id);
-      PTI_ASSERT(adapter != nullptr);
-      sub_device_count = adapter->GetParams()->SubDevicesCount;
+        // The first set with the name wins, as with the linear search
+        index_map.emplace(
+            set->GetParams()->SymbolName, MetricSetIndex{gid, sid});
+      }
     }
 
-    delete lib;
-    return sub_device_count;
+    return index_map;
   }
 
-  static MetricDevice* Create(uint32_t device_id, uint32_t sub_device_id) {
+  MetricContext(const MetricContext& copy) = delete;
+  MetricContext& operator=(const MetricContext& copy) = delete;
+
+ private: // Implementation
+  using DeviceKey = std::pair<uint32_t, uint32_t>;
+
+  static MetricContext* Create() {
     SharedLibrary* lib = OpenMetricsLibrary();
     if (lib == nullptr) {
       return nullptr;
     }
 
-    md::IMetricsDevice_1_5* device = nullptr;
-    md::TCompletionCode status = md::CC_OK;
-
     md::OpenAdapterGroup_fn OpenAdapterGroup =
       lib->GetSym<md::OpenAdapterGroup_fn>("OpenAdapterGroup");
     PTI_ASSERT(OpenAdapterGroup != nullptr);
 
     md::IAdapterGroup_1_9* adapter_group = nullptr;
-    status = OpenAdapterGroup(&adapter_group);
+    md::TCompletionCode status = OpenAdapterGroup(&adapter_group);
     PTI_ASSERT(status == md::CC_OK);
     PTI_ASSERT(adapter_group != nullptr);
 
-    if (adapter_group->GetParams()->AdapterCount == 0) {
-      delete lib;
-      return nullptr;
+    return new MetricContext(adapter_group, lib);
+  }
+
+  static SharedLibrary* OpenMetricsLibrary() {
+    SharedLibrary* lib = nullptr;
+    for (auto& path : utils::metrics::GetMDLibraryPossiblePaths()) {
+      lib = SharedLibrary::Create(path);
+      if (lib != nullptr) {
+        break;
+      }
     }
+    return lib;
+  }
 
-    PTI_ASSERT(device_id < adapter_group->GetParams()->AdapterCount);
-    md::IAdapter_1_9* adapter = adapter_group->GetAdapter(device_id);
-    PTI_ASSERT(adapter != nullptr);
+  MetricContext(md::IAdapterGroup_1_9* adapter_group, SharedLibrary* lib)
+      : adapter_group_(adapter_group), lib_(lib) {}
 
-    uint32_t sub_device_count = adapter->GetParams()->SubDevicesCount;
-    if (sub_device_count == 0) {
-      status = adapter->OpenMetricsDevice(&device);
-    } else {
-      PTI_ASSERT(sub_device_id < sub_device_count);
-      status = adapter->OpenMetricsSubDevice(sub_device_id, &device);
-    }
-    PTI_ASSERT(status == md::CC_OK || status == md::CC_ALREADY_INITIALIZED);
+ private: // Data
+  md::IAdapterGroup_1_9* adapter_group_ = nullptr;
+  SharedLibrary* lib_ = nullptr;
 
-    return new MetricDevice(adapter_group, adapter, device, lib);
+  std::mutex lock_;
+  std::map<DeviceKey, md::IMetricsDevice_1_5*> device_map_;
+  std::map<DeviceKey, MetricSetIndexMap> set_map_;
+};
+
+class MetricDevice {
+ public:
+  static uint32_t GetDeviceCount() {
+    MetricContext* context = MetricContext::Get();
+    if (context == nullptr) {
+      return 0;
+    }
+    return context->GetDeviceCount();
   }
 
-  ~MetricDevice() {
-    PTI_ASSERT(adapter_group_ != nullptr);
-    PTI_ASSERT(adapter_ != nullptr);
-    PTI_ASSERT(device_ != nullptr);
-    PTI_ASSERT(lib_ != nullptr);
+  static uint32_t GetSubDeviceCount(uint32_t device_id) {
+    MetricContext* context = MetricContext::Get();
+    if (context == nullptr) {
+      return 0;
+    }
+    return context->GetSubDeviceCount(device_id);
+  }
 
-    md::TCompletionCode status = md::CC_OK;
+  static MetricDevice* Create(uint32_t device_id, uint32_t sub_device_id) {
+    MetricContext* context = MetricContext::Get();
+    if (context == nullptr) {
+      return nullptr;
+    }
 
-    status = adapter_->CloseMetricsDevice(device_);
-    PTI_ASSERT(status == md::CC_OK);
-    status = adapter_group_->Close();
-    PTI_ASSERT(status == md::CC_OK);
+    if (context->GetDeviceCount() == 0) {
+      return nullptr;
+    }
 
-    delete lib_;
+    PTI_ASSERT(device_id < context->GetDeviceCount());
+    md::IMetricsDevice_1_5* device =
+      context->GetDevice(device_id, sub_device_id);
+    return new MetricDevice(context, device_id, sub_device_id, device);
   }
 
+  // Metrics device itself stays open in the context for the next user
+  ~MetricDevice() {}
+
   md::IMetricsDevice_1_5* operator->() const {
     return device_;
   }
@@ -127,71 +206,56 @@ class MetricDevice {
   MetricDevice& operator=(const MetricDevice& copy) = delete;
 
   md::IConcurrentGroup_1_5* FindMetricGroup(const char* set_name) {
-    PTI_ASSERT(set_name != nullptr);
-
-    uint32_t group_count = device_->GetParams()->ConcurrentGroupsCount;
-    for (uint32_t gid = 0; gid < group_count; ++gid) {
-      md::IConcurrentGroup_1_5* group = device_->GetConcurrentGroup(gid);
-      PTI_ASSERT(group != nullptr);
-
-      uint32_t set_count = group->GetParams()->MetricSetsCount;
-      for (uint32_t sid = 0; sid < set_count; ++sid) {
-        md::IMetricSet_1_5* set = group->GetMetricSet(sid);
-        PTI_ASSERT(set != nullptr);
-
-        if (strcmp(set_name, set->GetParams()->SymbolName) == 0) {
-          return group;
-        }
-      }
+    const MetricSetIndex* index = FindIndex(set_name);
+    if (index == nullptr) {
+      return nullptr;
     }
 
-    return nullptr;
+    md::IConcurrentGroup_1_5* group =
+      device_->GetConcurrentGroup(index->group_id);
+    PTI_ASSERT(group != nullptr);
+    return group;
   }
 
   md::IMetricSet_1_5* FindMetricSet(const char* set_name) {
-    PTI_ASSERT(set_name != nullptr);
-
-    uint32_t group_count = device_->GetParams()->ConcurrentGroupsCount;
-    for (uint32_t gid = 0; gid < group_count; ++gid) {
-      md::IConcurrentGroup_1_5* group = device_->GetConcurrentGroup(gid);
-      PTI_ASSERT(group != nullptr);
-
-      uint32_t set_count = group->GetParams()->MetricSetsCount;
-      for (uint32_t sid = 0; sid < set_count; ++sid) {
-        md::IMetricSet_1_5* set = group->GetMetricSet(sid);
-        PTI_ASSERT(set != nullptr);
-
-        if (strcmp(set_name, set->GetParams()->SymbolName) == 0) {
-          return set;
-        }
-      }
+    const MetricSetIndex* index = FindIndex(set_name);
+    if (index == nullptr) {
+      return nullptr;
     }
 
-    return nullptr;
+    md::IConcurrentGroup_1_5* group =
+      device_->GetConcurrentGroup(index->group_id);
+    PTI_ASSERT(group != nullptr);
+    md::IMetricSet_1_5* set = group->GetMetricSet(index->set_id);
+    PTI_ASSERT(set != nullptr);
+    return set;
   }
 
 private:
-  static SharedLibrary* OpenMetricsLibrary() {
-    SharedLibrary* lib = nullptr;
-    for (auto& path : utils::metrics::GetMDLibraryPossiblePaths()) {
-      lib = SharedLibrary::Create(path);
-      if (lib != nullptr) {
-        break;
-      }
-    }
-    return lib;
+  MetricDevice(
+      MetricContext* context, uint32_t device_id, uint32_t sub_device_id,
+      md::IMetricsDevice_1_5* device)
+      : context_(context), device_id_(device_id),
+        sub_device_id_(sub_device_id), device_(device) {
+    PTI_ASSERT(context_ != nullptr);
+    PTI_ASSERT(device_ != nullptr);
   }
 
-  MetricDevice(
-      md::IAdapterGroup_1_9* adapter_group, md::IAdapter_1_9* adapter,
-      md::IMetricsDevice_1_5* device, SharedLibrary* lib)
-      : adapter_group_(adapter_group), adapter_(adapter),
-        device_(device), lib_(lib) {}
+  const MetricSetIndex* FindIndex(const char* set_name) const {
+    PTI_ASSERT(set_name != nullptr);
+    const MetricSetIndexMap& index_map =
+      context_->GetSetIndexMap(device_id_, sub_device_id_);
+    auto it = index_map.find(set_name);
+    if (it == index_map.end()) {
+      return nullptr;
+    }
+    return &(it->second);
+  }
 
-  md::IAdapterGroup_1_9* adapter_group_ = nullptr;
-  md::IAdapter_1_9* adapter_ = nullptr;
+  MetricContext* context_ = nullptr;
+  uint32_t device_id_ = 0;
+  uint32_t sub_device_id_ = 0;
   md::IMetricsDevice_1_5* device_ = nullptr;
-  SharedLibrary* lib_ = nullptr;
 };
 
 #endif // PTI_UTILS_METRIC_DEVICE_H_
\ No newline at end of file
@@ -0,0 +1,384 @@
+//==============================================================
+// Copyright (C) Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+// =============================================================
+
+#ifndef PTI_UTILS_ZE_DEVICE_CACHE_H_
+#define PTI_UTILS_ZE_DEVICE_CACHE_H_
+
+#include <stdio.h>
+#include <string.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+
+#include "pti_assert.h"
+#include "utils.h"
+#include "ze_utils.h"
+
+#define DEVICE_CACHE_DIR_ENV "PTI_DEVICE_CACHE_DIR"
+#define DEVICE_CACHE_VERSION 1
+
+#define DEVICE_CACHE_FLAG_METRICS 0x1
+
+const char kDeviceCacheMagic[] = {'P', 'T', 'I', 'D', 'C', 'A', 'C', 'H'};
+
+// Driver build and device UUID, a new driver may report other values for
+// the same device, so both of them identify the entry
+struct ZeDeviceId {
+  uint32_t driver_version;
+  uint8_t uuid[ZE_MAX_DEVICE_UUID_SIZE];
+};
+
+struct ZeMetricGroupInfo {
+  std::string name;
+  uint32_t sampling_type;
+};
+
+struct ZeDeviceCapabilities {
+  uint64_t timer_frequency = 0;
+  uint64_t timestamp_mask = 0;
+  uint64_t global_timestamp_mask = 0;
+  uint32_t core_clock_rate = 0; // MHz
+  double flop_per_clock = 0.0;
+  double peak_compute = 0.0; // FLOP/s
+  double peak_bandwidth = 0.0; // Bytes/s
+  bool has_metric_groups = false;
+  // In zetMetricGroupGet order, so the position is the group index
+  std::vector<ZeMetricGroupInfo> metric_group_list;
+};
+
+// Entry file layout, all the parts are 8 bytes aligned:
+//   DeviceCacheHeader
+//   DeviceCacheMetricGroup[metric_group_count]
+//   char[string_size] - metric group names, not terminated
+#pragma pack(push, 1)
+struct DeviceCacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  ZeDeviceId id;
+  uint32_t core_clock_rate;
+  uint32_t metric_group_count;
+  uint32_t reserved;
+  uint64_t timer_frequency;
+  uint64_t timestamp_mask;
+  uint64_t global_timestamp_mask;
+  double flop_per_clock;
+  double peak_compute;
+  double peak_bandwidth;
+  uint64_t string_size;
+};
+
+struct DeviceCacheMetricGroup {
+  uint32_t sampling_type;
+  uint32_t reserved;
+  uint32_t offset;
+  uint32_t size;
+};
+#pragma pack(pop)
+
+// Device properties the tools query on every start, stored per node keyed
+// by the driver version and the device UUID. Enabled by PTI_DEVICE_CACHE_DIR
+// variable, that should point to an existing directory
+class ZeDeviceCache {
+ public:
+  // Returns nullptr if the cache is not enabled
+  static ZeDeviceCache* Create() {
+    std::string path = utils::GetEnv(DEVICE_CACHE_DIR_ENV);
+    if (path.empty()) {
+      return nullptr;
+    }
+
+    ZeDeviceCache* cache = new ZeDeviceCache(path);
+    PTI_ASSERT(cache != nullptr);
+    return cache;
+  }
+
+  // FNV-1a over the driver version and the device UUID
+  static uint64_t GetKey(const ZeDeviceId& id) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&id);
+    for (size_t i = 0; i < sizeof(ZeDeviceId); ++i) {
+      hash = (hash ^ data[i]) * 0x100000001b3ull;
+    }
+    return hash;
+  }
+
+  bool Load(const ZeDeviceId& id, ZeDeviceCapabilities* capabilities) const {
+    PTI_ASSERT(capabilities != nullptr);
+
+    std::vector<uint8_t> data = utils::LoadBinaryFile(GetEntryPath(id));
+    if (data.size() < sizeof(DeviceCacheHeader)) {
+      return false;
+    }
+
+    const DeviceCacheHeader* header =
+      reinterpret_cast<const DeviceCacheHeader*>(data.data());
+    if (memcmp(header->magic, kDeviceCacheMagic, sizeof(header->magic)) != 0 ||
+        header->version != DEVICE_CACHE_VERSION ||
+        memcmp(&header->id, &id, sizeof(ZeDeviceId)) != 0) {
+      return false;
+    }
+
+    uint64_t size = sizeof(DeviceCacheHeader) +
+      header->metric_group_count * sizeof(DeviceCacheMetricGroup) +
+      header->string_size;
+    if (size != data.size()) {
+      return false;
+    }
+
+    const DeviceCacheMetricGroup* group_list =
+      reinterpret_cast<const DeviceCacheMetricGroup*>(
+          data.data() + sizeof(DeviceCacheHeader));
+    const char* string_data = reinterpret_cast<const char*>(
+        group_list + header->metric_group_count);
+
+    ZeDeviceCapabilities result;
+    result.timer_frequency = header->timer_frequency;
+    result.timestamp_mask = header->timestamp_mask;
+    result.global_timestamp_mask = header->global_timestamp_mask;
+    result.core_clock_rate = header->core_clock_rate;
+    result.flop_per_clock = header->flop_per_clock;
+    result.peak_compute = header->peak_compute;
+    result.peak_bandwidth = header->peak_bandwidth;
+    result.has_metric_groups =
+      (header->flags & DEVICE_CACHE_FLAG_METRICS) != 0;
+    for (uint32_t i = 0; i < header->metric_group_count; ++i) {
+      const DeviceCacheMetricGroup& group = group_list[i];
+      if (static_cast<uint64_t>(group.offset) + group.size >
+          header->string_size) {
+        return false;
+      }
+      result.metric_group_list.push_back(
+          {std::string(string_data + group.offset, group.size),
+           group.sampling_type});
+    }
+
+    *capabilities = std::move(result);
+    return true;
+  }
+
+  // Entry is written to a temporary file first, so concurrent processes
+  // never see a partial one
+  void Store(const ZeDeviceId& id,
+             const ZeDeviceCapabilities& capabilities) const {
+    std::string strings;
+    std::vector<DeviceCacheMetricGroup> group_list;
+    for (const ZeMetricGroupInfo& group : capabilities.metric_group_list) {
+      group_list.push_back(
+          {group.sampling_type, 0,
+           static_cast<uint32_t>(strings.size()),
+           static_cast<uint32_t>(group.name.size())});
+      strings.append(group.name);
+    }
+
+    DeviceCacheHeader header{};
+    memcpy(header.magic, kDeviceCacheMagic, sizeof(header.magic));
+    header.version = DEVICE_CACHE_VERSION;
+    header.flags =
+      capabilities.has_metric_groups ? DEVICE_CACHE_FLAG_METRICS : 0;
+    header.id = id;
+    header.core_clock_rate = capabilities.core_clock_rate;
+    header.metric_group_count = static_cast<uint32_t>(group_list.size());
+    header.timer_frequency = capabilities.timer_frequency;
+    header.timestamp_mask = capabilities.timestamp_mask;
+    header.global_timestamp_mask = capabilities.global_timestamp_mask;
+    header.flop_per_clock = capabilities.flop_per_clock;
+    header.peak_compute = capabilities.peak_compute;
+    header.peak_bandwidth = capabilities.peak_bandwidth;
+    header.string_size = strings.size();
+
+    std::string path = GetEntryPath(id);
+    std::string temp_path = path + "." + std::to_string(utils::GetPid());
+    std::ofstream file(temp_path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+      return;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(group_list.data()),
+               group_list.size() * sizeof(DeviceCacheMetricGroup));
+    file.write(strings.data(), strings.size());
+    file.close();
+
+    if (!file.good() || rename(temp_path.c_str(), path.c_str()) != 0) {
+      remove(temp_path.c_str());
+    }
+  }
+
+  ZeDeviceCache(const ZeDeviceCache& copy) = delete;
+  ZeDeviceCache& operator=(const ZeDeviceCache& copy) = delete;
+
+ private:
+  explicit ZeDeviceCache(const std::string& path) : path_(path) {}
+
+  std::string GetEntryPath(const ZeDeviceId& id) const {
+    std::stringstream stream;
+    stream << path_ << "/device_" << std::hex << std::setw(16) <<
+      std::setfill('0') << GetKey(id) << ".bin";
+    return stream.str();
+  }
+
+ private:
+  std::string path_;
+};
+
+namespace utils {
+namespace ze {
+
+inline ZeDeviceId GetDeviceId(ze_driver_handle_t driver,
+                              ze_device_handle_t device) {
+  PTI_ASSERT(driver != nullptr);
+  PTI_ASSERT(device != nullptr);
+
+  ze_driver_properties_t driver_props{
+      ZE_STRUCTURE_TYPE_DRIVER_PROPERTIES, };
+  ze_result_t status = zeDriverGetProperties(driver, &driver_props);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  ze_device_properties_t device_props{
+      ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, };
+  status = zeDeviceGetProperties(device, &device_props);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  ZeDeviceId id{};
+  id.driver_version = driver_props.driverVersion;
+  memcpy(id.uuid, device_props.uuid.id, ZE_MAX_DEVICE_UUID_SIZE);
+  return id;
+}
+
+// Metric groups are only reported if metrics were enabled (by
+// ZET_ENABLE_METRICS=1) before zeInit
+inline std::vector<ZeMetricGroupInfo> GetMetricGroupList(
+    ze_device_handle_t device, bool* enabled) {
+  PTI_ASSERT(device != nullptr);
+  PTI_ASSERT(enabled != nullptr);
+
+  std::vector<ZeMetricGroupInfo> info_list;
+  *enabled = false;
+
+  uint32_t group_count = 0;
+  ze_result_t status = zetMetricGroupGet(device, &group_count, nullptr);
+  if (status != ZE_RESULT_SUCCESS) {
+    return info_list;
+  }
+
+  std::vector<zet_metric_group_handle_t> group_list(group_count, nullptr);
+  status = zetMetricGroupGet(device, &group_count, group_list.data());
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  for (uint32_t i = 0; i < group_count; ++i) {
+    zet_metric_group_properties_t group_props{
+        ZET_STRUCTURE_TYPE_METRIC_GROUP_PROPERTIES, };
+    status = zetMetricGroupGetProperties(group_list[i], &group_props);
+    PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+    info_list.push_back({group_props.name, group_props.samplingType});
+  }
+
+  *enabled = (group_count > 0);
+  return info_list;
+}
+
+inline ZeDeviceCapabilities QueryDeviceCapabilities(
+    ze_device_handle_t device, bool metrics) {
+  PTI_ASSERT(device != nullptr);
+
+  ze_device_properties_t props{ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, };
+  ze_result_t status = zeDeviceGetProperties(device, &props);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  ZeDeviceCapabilities capabilities;
+  capabilities.timer_frequency = GetDeviceTimerFrequency(device);
+  capabilities.timestamp_mask = GetDeviceTimestampMask(device);
+  capabilities.global_timestamp_mask = GetDeviceGlobalTimestampMask(device);
+  capabilities.core_clock_rate = props.coreClockRate;
+  capabilities.flop_per_clock = GetDeviceFlopPerClock(device);
+  capabilities.peak_compute = GetDevicePeakCompute(device);
+  capabilities.peak_bandwidth = GetDevicePeakBandwidth(device);
+  if (metrics) {
+    capabilities.metric_group_list =
+      GetMetricGroupList(device, &capabilities.has_metric_groups);
+  }
+  return capabilities;
+}
+
+// Loads the capabilities from the cache if it is enabled, otherwise (or on
+// a miss) queries the device and fills the cache entry. Metric groups are
+// enumerated only if asked and only to be stored, without the cache a
+// single group is cheaper to look up by its name
+inline ZeDeviceCapabilities GetDeviceCapabilities(
+    ze_driver_handle_t driver, ze_device_handle_t device,
+    bool metrics = false) {
+  PTI_ASSERT(driver != nullptr);
+  PTI_ASSERT(device != nullptr);
+
+  ZeDeviceCache* cache = ZeDeviceCache::Create();
+  if (cache == nullptr) {
+    return QueryDeviceCapabilities(device, false);
+  }
+
+  ZeDeviceCapabilities capabilities;
+  ZeDeviceId id = GetDeviceId(driver, device);
+  if (!cache->Load(id, &capabilities) ||
+      (metrics && !capabilities.has_metric_groups)) {
+    capabilities = QueryDeviceCapabilities(device, metrics);
+    cache->Store(id, capabilities);
+  }
+
+  delete cache;
+  return capabilities;
+}
+
+// Group is taken by its index in the cached list, its name is still checked
+// to fall back to the full search if the list is stale
+inline zet_metric_group_handle_t FindMetricGroup(
+    const ZeDeviceCapabilities& capabilities, ze_device_handle_t device,
+    std::string name, zet_metric_group_sampling_type_flag_t type) {
+  PTI_ASSERT(device != nullptr);
+
+  const std::vector<ZeMetricGroupInfo>& info_list =
+    capabilities.metric_group_list;
+  uint32_t index = 0;
+  while (index < info_list.size() &&
+         (info_list[index].name != name ||
+          (info_list[index].sampling_type & type) == 0)) {
+    ++index;
+  }
+  if (index == info_list.size()) {
+    return FindMetricGroup(device, name, type);
+  }
+
+  uint32_t group_count = 0;
+  ze_result_t status = zetMetricGroupGet(device, &group_count, nullptr);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  if (index >= group_count) {
+    return FindMetricGroup(device, name, type);
+  }
+
+  std::vector<zet_metric_group_handle_t> group_list(group_count, nullptr);
+  status = zetMetricGroupGet(device, &group_count, group_list.data());
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  zet_metric_group_properties_t group_props{
+      ZET_STRUCTURE_TYPE_METRIC_GROUP_PROPERTIES, };
+  status = zetMetricGroupGetProperties(group_list[index], &group_props);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  if (name != group_props.name || (group_props.samplingType & type) == 0) {
+    return FindMetricGroup(device, name, type);
+  }
+
+  return group_list[index];
+}
+
+} // namespace ze
+} // namespace utils
+
+#endif // PTI_UTILS_ZE_DEVICE_CACHE_H_
@@ -10,6 +10,8 @@
 #include <string.h>
 
 #include <chrono>
+#include <iomanip>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
@@ -176,6 +178,43 @@ inline std::string GetDeviceName(ze_device_handle_t device) {
   return props.name;
 }
 
+// Hex string of the device UUID, the same for all the processes that use
+// the device whatever the device order is
+inline std::string GetDeviceUuid(ze_device_handle_t device) {
+  PTI_ASSERT(device != nullptr);
+  ze_result_t status = ZE_RESULT_SUCCESS;
+  ze_device_properties_t props{};
+  props.stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
+  status = zeDeviceGetProperties(device, &props);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  std::stringstream stream;
+  stream << std::hex << std::setfill('0');
+  for (uint32_t i = 0; i < ZE_MAX_DEVICE_UUID_SIZE; ++i) {
+    stream << std::setw(2) << static_cast<uint32_t>(props.uuid.id[i]);
+  }
+  return stream.str();
+}
+
+// Device index in the driver order, sub-device index after the dot
+inline std::string GetDeviceLabel(ze_device_handle_t device) {
+  PTI_ASSERT(device != nullptr);
+  std::vector<ze_device_handle_t> device_list = GetDeviceList();
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    if (device_list[i] == device) {
+      return std::to_string(i);
+    }
+    std::vector<ze_device_handle_t> sub_device_list =
+      GetSubDeviceList(device_list[i]);
+    for (size_t j = 0; j < sub_device_list.size(); ++j) {
+      if (sub_device_list[j] == device) {
+        return std::to_string(i) + "." + std::to_string(j);
+      }
+    }
+  }
+  return "?";
+}
+
 inline int GetMetricId(zet_metric_group_handle_t group, std::string name) {
   PTI_ASSERT(group != nullptr);
 
@@ -331,6 +370,64 @@ uint64_t GetDeviceTimestampMask(ze_device_handle_t device) {
   return (1ull << props.kernelTimestampValidBits) - 1ull;
 }
 
+// Mask of the global timer values, e.g. written by
+// zeCommandListAppendWriteGlobalTimestamp
+inline uint64_t GetDeviceGlobalTimestampMask(ze_device_handle_t device) {
+  PTI_ASSERT(device != nullptr);
+  ze_device_properties_t props{ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, };
+  ze_result_t status = zeDeviceGetProperties(device, &props);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  if (props.timestampValidBits >= 64) {
+    return UINT64_MAX;
+  }
+  return (1ull << props.timestampValidBits) - 1ull;
+}
+
+// FLOP per clock of all the EUs of the device, with FMA on every lane
+inline double GetDeviceFlopPerClock(ze_device_handle_t device) {
+  PTI_ASSERT(device != nullptr);
+  ze_device_properties_t props{ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, };
+  ze_result_t status = zeDeviceGetProperties(device, &props);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  uint32_t eu_count = props.numSlices * props.numSubslicesPerSlice *
+    props.numEUsPerSubslice;
+  return 2.0 * eu_count * props.physicalEUSimdWidth;
+}
+
+// FLOP/s at the maximum core clock, zero if unknown
+inline double GetDevicePeakCompute(ze_device_handle_t device) {
+  PTI_ASSERT(device != nullptr);
+  ze_device_properties_t props{ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, };
+  ze_result_t status = zeDeviceGetProperties(device, &props);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  return GetDeviceFlopPerClock(device) * props.coreClockRate * 1e6;
+}
+
+// Bytes/s of all the device memories at their maximum clock and bus
+// width, zero if unknown (e.g. for system memory of integrated GPUs)
+inline double GetDevicePeakBandwidth(ze_device_handle_t device) {
+  PTI_ASSERT(device != nullptr);
+
+  uint32_t props_count = 0;
+  ze_result_t status =
+    zeDeviceGetMemoryProperties(device, &props_count, nullptr);
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+  if (props_count == 0) {
+    return 0.0;
+  }
+
+  std::vector<ze_device_memory_properties_t> props_list(
+      props_count, {ZE_STRUCTURE_TYPE_DEVICE_MEMORY_PROPERTIES, });
+  status = zeDeviceGetMemoryProperties(device, &props_count, props_list.data());
+  PTI_ASSERT(status == ZE_RESULT_SUCCESS);
+
+  double bandwidth = 0.0;
+  for (auto& props : props_list) {
+    bandwidth += props.maxClockRate * 1e6 * props.maxBusWidth / 8;
+  }
+  return bandwidth;
+}
+
 inline ze_api_version_t GetDriverVersion(ze_driver_handle_t driver) {
   PTI_ASSERT(driver != nullptr);
 
@@ -349,6 +446,20 @@ inline ze_api_version_t GetVersion() {
   return GetDriverVersion(driver_list.front());
 }
 
+// Returns nullptr if none of the drivers provides the function
+inline void* GetExtensionFunction(const char* name) {
+  PTI_ASSERT(name != nullptr);
+  for (auto driver : GetDriverList()) {
+    void* function = nullptr;
+    ze_result_t status =
+      zeDriverGetExtensionFunctionAddress(driver, name, &function);
+    if (status == ZE_RESULT_SUCCESS && function != nullptr) {
+      return function;
+    }
+  }
+  return nullptr;
+}
+
 } // namespace ze
 } // namespace utils
 